@@ -0,0 +1,90 @@
+#include "benchmark/benchmark.h"
+#include "llvm/ADT/APInt.h"
+#include "llvm/ADT/SmallVector.h"
+#include <random>
+#include <vector>
+
+using namespace llvm;
+
+// Build N random values of the given width, the way constant folding and
+// known-bits analysis see them. A width of 64 or less stays inline; wider
+// values take the heap path of every operation.
+static std::vector<APInt> makeValues(unsigned N, unsigned BitWidth,
+                                     unsigned Seed) {
+  std::mt19937_64 Rand(Seed);
+  std::vector<APInt> Values;
+  Values.reserve(N);
+  for (unsigned I = 0; I != N; ++I) {
+    SmallVector<uint64_t, 16> Words;
+    for (unsigned W = 0, E = APInt::getNumWords(BitWidth); W != E; ++W)
+      Words.push_back(Rand());
+    APInt V(BitWidth, Words);
+    // Keep divisors non-zero.
+    V.setBit(0);
+    Values.push_back(V);
+  }
+  return Values;
+}
+
+static const unsigned NumValues = 256;
+
+template <typename OpT>
+static void runBinaryOp(benchmark::State &State, const std::vector<APInt> &LHS,
+                        const std::vector<APInt> &RHS, OpT Op) {
+  for (auto _ : State)
+    for (unsigned I = 0; I != NumValues; ++I) {
+      APInt R = Op(LHS[I], RHS[I]);
+      benchmark::DoNotOptimize(R.getRawData());
+    }
+  State.SetItemsProcessed(State.iterations() * NumValues);
+}
+
+static void BM_APIntAdd(benchmark::State &State) {
+  runBinaryOp(State, makeValues(NumValues, State.range(0), 0),
+              makeValues(NumValues, State.range(0), 1),
+              [](const APInt &A, const APInt &B) { return A + B; });
+}
+BENCHMARK(BM_APIntAdd)->Arg(32)->Arg(64)->Arg(128)->Arg(1024);
+
+static void BM_APIntMul(benchmark::State &State) {
+  runBinaryOp(State, makeValues(NumValues, State.range(0), 0),
+              makeValues(NumValues, State.range(0), 1),
+              [](const APInt &A, const APInt &B) { return A * B; });
+}
+BENCHMARK(BM_APIntMul)->Arg(32)->Arg(64)->Arg(128)->Arg(1024);
+
+// Divisors have half the width of the dividends, so that the quotients are
+// not all 0 or 1.
+static void BM_APIntUDiv(benchmark::State &State) {
+  unsigned BitWidth = State.range(0);
+  std::vector<APInt> Divisors;
+  for (const APInt &V : makeValues(NumValues, BitWidth / 2, 1))
+    Divisors.push_back(V.zext(BitWidth));
+  runBinaryOp(State, makeValues(NumValues, BitWidth, 0), Divisors,
+              [](const APInt &A, const APInt &B) { return A.udiv(B); });
+}
+BENCHMARK(BM_APIntUDiv)->Arg(32)->Arg(64)->Arg(128)->Arg(1024);
+
+static void BM_APIntShl(benchmark::State &State) {
+  unsigned BitWidth = State.range(0);
+  std::vector<APInt> Amounts;
+  for (const APInt &V : makeValues(NumValues, BitWidth, 1))
+    Amounts.push_back(APInt(BitWidth, V.urem(BitWidth)));
+  runBinaryOp(State, makeValues(NumValues, BitWidth, 0), Amounts,
+              [](const APInt &A, const APInt &B) { return A.shl(B); });
+}
+BENCHMARK(BM_APIntShl)->Arg(32)->Arg(64)->Arg(128)->Arg(1024);
+
+static void BM_APIntCountBits(benchmark::State &State) {
+  std::vector<APInt> Values = makeValues(NumValues, State.range(0), 0);
+  for (auto _ : State) {
+    unsigned Sum = 0;
+    for (const APInt &V : Values)
+      Sum += V.countLeadingZeros() + V.countPopulation();
+    benchmark::DoNotOptimize(Sum);
+  }
+  State.SetItemsProcessed(State.iterations() * NumValues);
+}
+BENCHMARK(BM_APIntCountBits)->Arg(64)->Arg(128)->Arg(1024);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,52 @@
+#include "benchmark/benchmark.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/ADT/Twine.h"
+#include "llvm/BinaryFormat/Dwarf.h"
+#include "llvm/CodeGen/AccelTable.h"
+#include "llvm/CodeGen/DwarfStringPoolEntry.h"
+#include "llvm/Support/Allocator.h"
+#include <memory>
+
+using namespace llvm;
+
+// Build a string pool of N distinct names shaped like mangled C++ symbols.
+static void buildNames(StringMap<DwarfStringPoolEntry, BumpPtrAllocator> &Pool,
+                       unsigned N) {
+  for (unsigned I = 0; I != N; ++I) {
+    DwarfStringPoolEntry Entry = {nullptr, I, DwarfStringPoolEntry::NotIndexed};
+    Pool.try_emplace(("_ZN4llvm9namespace" + Twine(I % 97) + "8function" +
+                      Twine(I) + "Ev")
+                         .str(),
+                     Entry);
+  }
+}
+
+// Hash, unique and bucket a .debug_names table of N names, each referenced
+// from two DIEs. Adding the names to the table is not timed.
+static void BM_DWARF5AccelTableBuckets(benchmark::State &State) {
+  StringMap<DwarfStringPoolEntry, BumpPtrAllocator> Pool;
+  buildNames(Pool, State.range(0));
+
+  for (auto _ : State) {
+    State.PauseTiming();
+    auto Table = llvm::make_unique<AccelTable<DWARF5AccelTableStaticData>>();
+    for (const auto &Entry : Pool) {
+      DwarfStringPoolEntryRef Ref(Entry, /*Indexed=*/false);
+      uint64_t Offset = Entry.second.Offset;
+      Table->addName(Ref, Offset * 16, dwarf::DW_TAG_subprogram, 0);
+      Table->addName(Ref, Offset * 16 + 8, dwarf::DW_TAG_subprogram, 0);
+    }
+    State.ResumeTiming();
+
+    Table->computeBuckets();
+    benchmark::DoNotOptimize(Table->getBucketCount());
+
+    State.PauseTiming();
+    Table.reset();
+    State.ResumeTiming();
+  }
+  State.SetItemsProcessed(int64_t(State.iterations()) * State.range(0));
+}
+BENCHMARK(BM_DWARF5AccelTableBuckets)->Range(1 << 10, 1 << 20);
+
+BENCHMARK_MAIN();
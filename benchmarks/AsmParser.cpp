@@ -0,0 +1,55 @@
+#include "benchmark/benchmark.h"
+#include "llvm/AsmParser/Parser.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Support/raw_ostream.h"
+#include <string>
+
+using namespace llvm;
+
+// Build the text of a module of N functions, each with a loop that uses a mix
+// of keywords, types, numbered and named values.
+static std::string buildModuleText(unsigned N) {
+  std::string Text;
+  raw_string_ostream OS(Text);
+  OS << "@g = global [16 x i32] zeroinitializer\n";
+  for (unsigned I = 0; I != N; ++I) {
+    OS << "define internal i32 @f" << I << "(i32 %n, i32* nocapture %p) {\n"
+       << "entry:\n"
+       << "  br label %loop\n"
+       << "loop:\n"
+       << "  %i = phi i32 [ 0, %entry ], [ %i.next, %loop ]\n"
+       << "  %acc = phi i32 [ " << I << ", %entry ], [ %4, %loop ]\n"
+       << "  %0 = getelementptr inbounds [16 x i32], [16 x i32]* @g, i32 0, "
+          "i32 %i\n"
+       << "  %1 = load i32, i32* %0, align 4\n"
+       << "  %2 = mul nsw i32 %1, 3\n"
+       << "  %3 = xor i32 %2, %acc\n"
+       << "  %4 = add i32 %3, " << I * 7 + 1 << "\n"
+       << "  store volatile i32 %4, i32* %p, align 4\n"
+       << "  %i.next = add nuw nsw i32 %i, 1\n"
+       << "  %cmp = icmp slt i32 %i.next, %n\n"
+       << "  br i1 %cmp, label %loop, label %exit\n"
+       << "exit:\n"
+       << "  ret i32 %4\n"
+       << "}\n";
+  }
+  return OS.str();
+}
+
+static void BM_ParseAssembly(benchmark::State &State) {
+  std::string Text = buildModuleText(State.range(0));
+  for (auto _ : State) {
+    LLVMContext Ctx;
+    SMDiagnostic Err;
+    std::unique_ptr<Module> M = parseAssemblyString(Text, Err, Ctx);
+    if (!M)
+      State.SkipWithError("invalid assembly");
+    benchmark::DoNotOptimize(M.get());
+  }
+  State.SetBytesProcessed(int64_t(State.iterations()) * Text.size());
+}
+BENCHMARK(BM_ParseAssembly)->Range(64, 4096);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,101 @@
+#include "benchmark/benchmark.h"
+#include "llvm/Bitcode/BitstreamReader.h"
+#include "llvm/Bitcode/BitstreamWriter.h"
+#include <memory>
+
+using namespace llvm;
+
+static const unsigned BlockID = 8;
+static const unsigned RecordCode = 1;
+
+// Write a stream of one block per 64 records; each record has eight operands
+// of mixed magnitude, the shape of the instruction records in a function
+// block. With Abbreviated, the records use an array-of-VBR6 abbreviation.
+static SmallVector<char, 0> writeStream(unsigned NumRecords,
+                                        bool Abbreviated) {
+  SmallVector<char, 0> Buffer;
+  BitstreamWriter W(Buffer);
+  SmallVector<uint64_t, 8> Vals;
+  for (unsigned I = 0; I < NumRecords; I += 64) {
+    W.EnterSubblock(BlockID, 3);
+    unsigned Abbrev = 0;
+    if (Abbreviated) {
+      auto Abbv = std::make_shared<BitCodeAbbrev>();
+      Abbv->Add(BitCodeAbbrevOp(RecordCode));
+      Abbv->Add(BitCodeAbbrevOp(BitCodeAbbrevOp::Array));
+      Abbv->Add(BitCodeAbbrevOp(BitCodeAbbrevOp::VBR, 6));
+      Abbrev = W.EmitAbbrev(std::move(Abbv));
+    }
+    for (unsigned J = I; J != I + 64 && J != NumRecords; ++J) {
+      Vals.clear();
+      for (unsigned K = 0; K != 8; ++K)
+        Vals.push_back((J * 31 + K) << (K * 3));
+      W.EmitRecord(RecordCode, Vals, Abbrev);
+    }
+    W.ExitBlock();
+  }
+  return Buffer;
+}
+
+// Read every record of every block, or skip the blocks without reading them
+// as the lazy bitcode reader does for function bodies.
+static void readStream(benchmark::State &State, ArrayRef<char> Buffer,
+                       bool SkipBlocks) {
+  BitstreamCursor Cursor(ArrayRef<uint8_t>(
+      reinterpret_cast<const uint8_t *>(Buffer.data()), Buffer.size()));
+  SmallVector<uint64_t, 8> Vals;
+  uint64_t Sum = 0;
+  while (!Cursor.AtEndOfStream()) {
+    BitstreamEntry Entry = Cursor.advance();
+    if (Entry.Kind != BitstreamEntry::SubBlock) {
+      State.SkipWithError("malformed stream");
+      return;
+    }
+    if (SkipBlocks) {
+      if (Cursor.SkipBlock()) {
+        State.SkipWithError("malformed block");
+        return;
+      }
+      continue;
+    }
+    if (Cursor.EnterSubBlock(Entry.ID)) {
+      State.SkipWithError("malformed block");
+      return;
+    }
+    while (true) {
+      Entry = Cursor.advance();
+      if (Entry.Kind == BitstreamEntry::EndBlock)
+        break;
+      if (Entry.Kind != BitstreamEntry::Record) {
+        State.SkipWithError("malformed record");
+        return;
+      }
+      Vals.clear();
+      Sum += Cursor.readRecord(Entry.ID, Vals);
+      Sum += Vals.back();
+    }
+  }
+  benchmark::DoNotOptimize(Sum);
+}
+
+static void BM_ReadRecords(benchmark::State &State) {
+  SmallVector<char, 0> Buffer = writeStream(State.range(0), State.range(1));
+  for (auto _ : State)
+    readStream(State, Buffer, /*SkipBlocks=*/false);
+  State.SetBytesProcessed(State.iterations() * Buffer.size());
+}
+BENCHMARK(BM_ReadRecords)
+    ->Args({1 << 10, 0})
+    ->Args({1 << 16, 0})
+    ->Args({1 << 10, 1})
+    ->Args({1 << 16, 1});
+
+static void BM_SkipBlocks(benchmark::State &State) {
+  SmallVector<char, 0> Buffer = writeStream(State.range(0), true);
+  for (auto _ : State)
+    readStream(State, Buffer, /*SkipBlocks=*/true);
+  State.SetBytesProcessed(State.iterations() * Buffer.size());
+}
+BENCHMARK(BM_SkipBlocks)->Arg(1 << 10)->Arg(1 << 16);
+
+BENCHMARK_MAIN();
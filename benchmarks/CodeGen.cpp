@@ -0,0 +1,159 @@
+#include "benchmark/benchmark.h"
+#include "llvm/AsmParser/Parser.h"
+#include "llvm/CodeGen/MachineFunction.h"
+#include "llvm/CodeGen/MachineModuleInfo.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/LegacyPassManager.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Support/TargetRegistry.h"
+#include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Target/TargetMachine.h"
+#include "llvm/Target/TargetOptions.h"
+#include <memory>
+#include <string>
+
+using namespace llvm;
+
+static const char TripleName[] = "x86_64-unknown-linux-gnu";
+
+// Build a module of N small functions, the kind of input a JIT hands to the
+// code generator one at a time.
+static std::string buildModuleText(unsigned N) {
+  std::string Text;
+  raw_string_ostream OS(Text);
+  OS << "target triple = \"" << TripleName << "\"\n";
+  for (unsigned I = 0; I != N; ++I)
+    OS << "define i32 @f" << I << "(i32 %a, i32 %b) {\n"
+       << "entry:\n"
+       << "  %c = icmp slt i32 %a, %b\n"
+       << "  br i1 %c, label %then, label %exit\n"
+       << "then:\n"
+       << "  %m = mul i32 %a, " << I << "\n"
+       << "  br label %exit\n"
+       << "exit:\n"
+       << "  %r = phi i32 [ %m, %then ], [ %b, %entry ]\n"
+       << "  ret i32 %r\n"
+       << "}\n";
+  return OS.str();
+}
+
+static std::unique_ptr<TargetMachine>
+createTargetMachine(benchmark::State &State, CodeGenOpt::Level OptLevel) {
+  InitializeAllTargetInfos();
+  InitializeAllTargets();
+  InitializeAllTargetMCs();
+  InitializeAllAsmPrinters();
+
+  std::string Error;
+  const Target *TheTarget = TargetRegistry::lookupTarget(TripleName, Error);
+  if (!TheTarget) {
+    State.SkipWithError(Error.c_str());
+    return nullptr;
+  }
+  return std::unique_ptr<TargetMachine>(TheTarget->createTargetMachine(
+      TripleName, "", "", TargetOptions(), None, None, OptLevel));
+}
+
+static std::unique_ptr<Module> parseModule(benchmark::State &State,
+                                           StringRef Text,
+                                           LLVMContext &Ctx) {
+  SMDiagnostic Err;
+  std::unique_ptr<Module> M = parseAssemblyString(Text, Err, Ctx);
+  if (!M)
+    State.SkipWithError("invalid module");
+  return M;
+}
+
+// The fixed cost of building the -O0 pass pipeline for one module, without
+// running it.
+static void BM_AddPassesToEmitFile(benchmark::State &State) {
+  std::unique_ptr<TargetMachine> TM =
+      createTargetMachine(State, CodeGenOpt::None);
+  if (!TM)
+    return;
+  for (auto _ : State) {
+    legacy::PassManager PM;
+    raw_null_ostream OS;
+    if (TM->addPassesToEmitFile(PM, OS, nullptr,
+                                TargetMachine::CGFT_ObjectFile))
+      State.SkipWithError("target does not support object emission");
+  }
+}
+BENCHMARK(BM_AddPassesToEmitFile);
+
+// A function-info type standing in for the one each target allocates on the
+// first use.
+struct BenchFunctionInfo : MachineFunctionInfo {
+  explicit BenchFunctionInfo(MachineFunction &) {}
+  unsigned VarArgsFrameIndex = 0;
+  unsigned BytesToPopOnReturn = 0;
+};
+
+// The cost of creating (and deleting) a MachineFunction and its function info
+// for each of N functions.
+static void BM_CreateMachineFunction(benchmark::State &State) {
+  std::unique_ptr<TargetMachine> TM =
+      createTargetMachine(State, CodeGenOpt::None);
+  if (!TM)
+    return;
+  LLVMContext Ctx;
+  std::unique_ptr<Module> M =
+      parseModule(State, buildModuleText(State.range(0)), Ctx);
+  if (!M)
+    return;
+  MachineModuleInfo MMI(static_cast<LLVMTargetMachine *>(TM.get()));
+  MMI.doInitialization(*M);
+  for (auto _ : State)
+    for (Function &F : *M) {
+      MachineFunction &MF = MMI.getOrCreateMachineFunction(F);
+      benchmark::DoNotOptimize(MF.getInfo<BenchFunctionInfo>());
+      MMI.deleteMachineFunctionFor(F);
+    }
+  MMI.doFinalization(*M);
+  State.SetItemsProcessed(int64_t(State.iterations()) * State.range(0));
+}
+BENCHMARK(BM_CreateMachineFunction)->Range(1, 1024);
+
+// Generate an object file for a module of N functions at the optimization
+// level given by the second argument. The items are functions, so the rate
+// shows the per-function cost once the setup is amortized.
+static void BM_EmitObject(benchmark::State &State) {
+  std::unique_ptr<TargetMachine> TM = createTargetMachine(
+      State, static_cast<CodeGenOpt::Level>(State.range(1)));
+  if (!TM)
+    return;
+  std::string Text = buildModuleText(State.range(0));
+  for (auto _ : State) {
+    State.PauseTiming();
+    LLVMContext Ctx;
+    std::unique_ptr<Module> M = parseModule(State, Text, Ctx);
+    State.ResumeTiming();
+    if (!M)
+      break;
+    M->setDataLayout(TM->createDataLayout());
+
+    SmallString<4096> Object;
+    raw_svector_ostream OS(Object);
+    legacy::PassManager PM;
+    if (TM->addPassesToEmitFile(PM, OS, nullptr,
+                                TargetMachine::CGFT_ObjectFile)) {
+      State.SkipWithError("target does not support object emission");
+      break;
+    }
+    PM.run(*M);
+    benchmark::DoNotOptimize(Object.data());
+  }
+  State.SetItemsProcessed(int64_t(State.iterations()) * State.range(0));
+}
+BENCHMARK(BM_EmitObject)
+    ->Args({1, CodeGenOpt::None})
+    ->Args({64, CodeGenOpt::None})
+    ->Args({1024, CodeGenOpt::None})
+    ->Args({1, CodeGenOpt::Default})
+    ->Args({64, CodeGenOpt::Default})
+    ->Args({1024, CodeGenOpt::Default})
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,71 @@
+#include "benchmark/benchmark.h"
+#include "llvm/ADT/Twine.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/raw_ostream.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace llvm;
+
+namespace {
+// An option that unregisters itself, so that each iteration starts from an
+// empty parser.
+class BenchOption : public cl::opt<bool> {
+public:
+  explicit BenchOption(StringRef Name)
+      : cl::opt<bool>(Name, cl::desc("benchmark option"), cl::Hidden) {}
+  ~BenchOption() override { removeArgument(); }
+};
+} // end anonymous namespace
+
+static std::vector<std::string> makeNames(unsigned N) {
+  std::vector<std::string> Names;
+  Names.reserve(N);
+  for (unsigned I = 0; I != N; ++I)
+    Names.push_back(("bench-option-" + Twine(I)).str());
+  return Names;
+}
+
+// The cost of constructing N options, as the static constructors of a tool
+// do before main.
+static void BM_ConstructOptions(benchmark::State &State) {
+  std::vector<std::string> Names = makeNames(State.range(0));
+  for (auto _ : State) {
+    std::vector<std::unique_ptr<BenchOption>> Options;
+    Options.reserve(Names.size());
+    for (const std::string &Name : Names)
+      Options.push_back(llvm::make_unique<BenchOption>(Name));
+    State.PauseTiming();
+    Options.clear();
+    State.ResumeTiming();
+  }
+  State.SetItemsProcessed(int64_t(State.iterations()) * Names.size());
+}
+BENCHMARK(BM_ConstructOptions)->Range(64, 8192);
+
+// The cost of constructing N options and parsing a command line that sets one
+// of them: the command-line part of the startup of a tool.
+static void BM_ConstructAndParse(benchmark::State &State) {
+  std::vector<std::string> Names = makeNames(State.range(0));
+  std::string Arg = "-" + Names.back();
+  const char *Args[] = {"bench", Arg.c_str()};
+  for (auto _ : State) {
+    std::vector<std::unique_ptr<BenchOption>> Options;
+    Options.reserve(Names.size());
+    for (const std::string &Name : Names)
+      Options.push_back(llvm::make_unique<BenchOption>(Name));
+    if (!cl::ParseCommandLineOptions(2, Args, "", &nulls())) {
+      State.SkipWithError("cannot parse the command line");
+      break;
+    }
+    benchmark::DoNotOptimize(bool(*Options.back()));
+    State.PauseTiming();
+    Options.clear();
+    State.ResumeTiming();
+  }
+  State.SetItemsProcessed(int64_t(State.iterations()) * Names.size());
+}
+BENCHMARK(BM_ConstructAndParse)->Range(64, 8192);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,131 @@
+#include "benchmark/benchmark.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/BinaryFormat/Dwarf.h"
+#include "llvm/DebugInfo/DWARF/DWARFContext.h"
+#include "llvm/DebugInfo/DWARF/DWARFDebugLine.h"
+#include "llvm/Support/EndianStream.h"
+#include "llvm/Support/LEB128.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/raw_ostream.h"
+#include <memory>
+#include <string>
+
+using namespace llvm;
+
+// Write a DWARF v4 line table with NumSequences sequences of NumRows rows,
+// each address 4 bytes after the previous one, the way the compiler emits
+// them for one function each.
+static std::string buildLineTable(unsigned NumSequences, unsigned NumRows) {
+  const int8_t LineBase = -5;
+  const uint8_t LineRange = 14, OpcodeBase = 13;
+
+  std::string Header;
+  raw_string_ostream HS(Header);
+  HS << char(1)                   // minimum_instruction_length
+     << char(1)                   // maximum_operations_per_instruction
+     << char(1)                   // default_is_stmt
+     << char(LineBase) << char(LineRange) << char(OpcodeBase);
+  for (char Length : {0, 1, 1, 1, 1, 0, 0, 0, 1, 0, 0, 1})
+    HS << Length;
+  HS << "lib" << '\0' << '\0'; // include_directories
+  for (unsigned I = 0; I != 8; ++I) {
+    HS << "file" << I << ".cpp" << '\0';
+    encodeULEB128(1, HS); // directory
+    encodeULEB128(0, HS); // modification time
+    encodeULEB128(0, HS); // length
+  }
+  HS << '\0';
+  HS.flush();
+
+  std::string Program;
+  raw_string_ostream PS(Program);
+  support::endian::Writer PW(PS, support::little);
+  for (unsigned S = 0; S != NumSequences; ++S) {
+    PS << char(0) << char(9) << char(dwarf::DW_LNE_set_address);
+    PW.write<uint64_t>(0x10000 + uint64_t(S) * NumRows * 4);
+    PS << char(dwarf::DW_LNS_set_file);
+    encodeULEB128(S % 8 + 1, PS);
+    PS << char(dwarf::DW_LNS_advance_line);
+    encodeSLEB128(S * 10, PS);
+    PS << char(dwarf::DW_LNS_copy);
+    for (unsigned R = 1; R != NumRows; ++R) {
+      // A special opcode advancing the line by 1 and the address by 4.
+      PS << char((1 - LineBase) + LineRange * 4 + OpcodeBase);
+    }
+    PS << char(dwarf::DW_LNS_advance_pc);
+    encodeULEB128(4, PS);
+    PS << char(0) << char(1) << char(dwarf::DW_LNE_end_sequence);
+  }
+  PS.flush();
+
+  std::string Table;
+  raw_string_ostream TS(Table);
+  support::endian::Writer TW(TS, support::little);
+  TW.write<uint32_t>(2 + 4 + Header.size() + Program.size()); // unit_length
+  TW.write<uint16_t>(4);                                        // version
+  TW.write<uint32_t>(Header.size());                            // header_length
+  TS << Header << Program;
+  return TS.str();
+}
+
+static std::unique_ptr<DWARFContext> createContext() {
+  StringMap<std::unique_ptr<MemoryBuffer>> Sections;
+  return DWARFContext::create(Sections, /*AddrSize=*/8);
+}
+
+static void parseTable(benchmark::State &State, StringRef Data,
+                       const DWARFContext &Ctx,
+                       DWARFDebugLine::LineTable &Table) {
+  DWARFDataExtractor Extractor(Data, /*IsLittleEndian=*/true,
+                               /*AddressSize=*/8);
+  uint32_t Offset = 0;
+  bool Failed = false;
+  Error Err = Table.parse(Extractor, &Offset, Ctx, nullptr,
+                          [&](Error E) {
+                            consumeError(std::move(E));
+                            Failed = true;
+                          });
+  if (Err || Failed) {
+    consumeError(std::move(Err));
+    State.SkipWithError("invalid line table");
+  }
+}
+
+// Parse the prologue and run the line-number program into rows.
+static void BM_ParseLineTable(benchmark::State &State) {
+  std::string Data = buildLineTable(State.range(0), State.range(1));
+  std::unique_ptr<DWARFContext> Ctx = createContext();
+  for (auto _ : State) {
+    DWARFDebugLine::LineTable Table;
+    parseTable(State, Data, *Ctx, Table);
+    benchmark::DoNotOptimize(Table.Rows.data());
+  }
+  State.SetBytesProcessed(State.iterations() * Data.size());
+  State.SetItemsProcessed(State.iterations() * State.range(0) *
+                          State.range(1));
+}
+BENCHMARK(BM_ParseLineTable)
+    ->Args({16, 64})
+    ->Args({1024, 64})
+    ->Args({16, 4096});
+
+// Look up addresses spread over all the sequences of a parsed table, as
+// symbolizers do.
+static void BM_LookupAddress(benchmark::State &State) {
+  unsigned NumSequences = State.range(0), NumRows = State.range(1);
+  std::string Data = buildLineTable(NumSequences, NumRows);
+  std::unique_ptr<DWARFContext> Ctx = createContext();
+  DWARFDebugLine::LineTable Table;
+  parseTable(State, Data, *Ctx, Table);
+  uint64_t End = 0x10000 + uint64_t(NumSequences) * NumRows * 4;
+  for (auto _ : State) {
+    uint32_t Sum = 0;
+    for (uint64_t Address = 0x10000; Address < End; Address += 4 * 61)
+      Sum += Table.lookupAddress(Address);
+    benchmark::DoNotOptimize(Sum);
+  }
+  State.SetItemsProcessed(State.iterations() * ((End - 0x10000) / (4 * 61)));
+}
+BENCHMARK(BM_LookupAddress)->Args({16, 64})->Args({1024, 64});
+
+BENCHMARK_MAIN();
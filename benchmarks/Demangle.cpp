@@ -0,0 +1,65 @@
+#include "benchmark/benchmark.h"
+#include "llvm/Demangle/Demangle.h"
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace llvm;
+
+// Names of the shape of the C++ symbols of a large binary. Each name gets
+// ExtraParams more function pointer parameters, to model the long names of
+// template-heavy code.
+static std::vector<std::string> buildNames(unsigned N, unsigned ExtraParams) {
+  static const char *const Templates[] = {
+      "_ZN4llvm12DenseMapBaseINS_8DenseMapIPKNS_5ValueEjEES4_jE6insertE",
+      "_ZNSt6vectorIN4llvm9StringRefESaIS1_EE9push_backERKS1_",
+      "_ZN5clang4Sema25ActOnCallExprForFunctionEPNS_4ExprE",
+      "_ZNK4llvm12FunctionPass17createPrinterPassERNS_11raw_ostreamE"};
+  std::vector<std::string> Names;
+  std::string Extra;
+  for (unsigned I = 0; I != ExtraParams; ++I)
+    Extra += "PFvPiE";
+  for (unsigned I = 0; I != N; ++I)
+    Names.push_back(Templates[I % 4] + std::string(I % 5, 'j') + Extra);
+  return Names;
+}
+
+static void BM_ItaniumDemangle(benchmark::State &State) {
+  std::vector<std::string> Names = buildNames(1024, State.range(0));
+  for (auto _ : State)
+    for (const std::string &Name : Names) {
+      int Status;
+      char *Demangled =
+          itaniumDemangle(Name.c_str(), nullptr, nullptr, &Status);
+      benchmark::DoNotOptimize(Demangled);
+      std::free(Demangled);
+    }
+  State.SetItemsProcessed(State.iterations() * Names.size());
+}
+BENCHMARK(BM_ItaniumDemangle)->Arg(0)->Arg(100);
+
+static void BM_DemangleContext(benchmark::State &State) {
+  std::vector<std::string> Names = buildNames(1024, State.range(0));
+  ItaniumDemangleContext Demangler;
+  for (auto _ : State)
+    for (const std::string &Name : Names)
+      benchmark::DoNotOptimize(Demangler.demangle(Name.c_str()));
+  State.SetItemsProcessed(State.iterations() * Names.size());
+}
+BENCHMARK(BM_DemangleContext)->Arg(0)->Arg(100);
+
+static void BM_DemangleBatch(benchmark::State &State) {
+  std::vector<std::string> Names = buildNames(1024, State.range(0));
+  std::vector<const char *> NamePtrs;
+  for (const std::string &Name : Names)
+    NamePtrs.push_back(Name.c_str());
+  std::vector<size_t> Offsets(Names.size());
+  ItaniumDemangleContext Demangler;
+  for (auto _ : State)
+    benchmark::DoNotOptimize(
+        Demangler.demangle(NamePtrs.data(), NamePtrs.size(), Offsets.data()));
+  State.SetItemsProcessed(State.iterations() * Names.size());
+}
+BENCHMARK(BM_DemangleBatch)->Arg(0)->Arg(100);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,94 @@
+#include "benchmark/benchmark.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/FlatDenseMap.h"
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace llvm;
+
+// Pointer keys, shuffled so that lookups do not follow insertion order. If
+// Scattered is false, they are 16 bytes apart like consecutive allocations,
+// which DenseMapInfo hashes without any collision. Otherwise they are spread
+// over 32MB like the objects of a long-running compilation. Keys with
+// different seeds are distinct.
+static std::vector<int *> makeKeys(size_t N, bool Scattered, unsigned Seed) {
+  static std::vector<int> Storage(1 << 23);
+  std::vector<int *> Keys;
+  Keys.reserve(N);
+  for (size_t I = 0; I != N; ++I) {
+    size_t Slot = Scattered ? (I * 2654435761U) % (1 << 20) : I;
+    Keys.push_back(&Storage[Slot * 8 + Seed]);
+  }
+  std::shuffle(Keys.begin(), Keys.end(), std::mt19937(Seed));
+  return Keys;
+}
+
+template <typename MapT> static void BM_Insert(benchmark::State &State) {
+  std::vector<int *> Keys = makeKeys(State.range(0), State.range(1), 0);
+  for (auto _ : State) {
+    MapT M;
+    for (int *K : Keys)
+      M[K] = 0;
+    benchmark::DoNotOptimize(M.size());
+  }
+  State.SetItemsProcessed(State.iterations() * Keys.size());
+}
+
+template <typename MapT> static void BM_FindHit(benchmark::State &State) {
+  std::vector<int *> Keys = makeKeys(State.range(0), State.range(1), 0);
+  MapT M;
+  for (int *K : Keys)
+    M[K] = 1;
+  std::shuffle(Keys.begin(), Keys.end(), std::mt19937(1));
+  for (auto _ : State) {
+    unsigned Sum = 0;
+    for (int *K : Keys)
+      Sum += M.find(K)->second;
+    benchmark::DoNotOptimize(Sum);
+  }
+  State.SetItemsProcessed(State.iterations() * Keys.size());
+}
+
+template <typename MapT> static void BM_FindMiss(benchmark::State &State) {
+  std::vector<int *> Keys = makeKeys(State.range(0), State.range(1), 0);
+  std::vector<int *> Misses = makeKeys(State.range(0), State.range(1), 4);
+  MapT M;
+  for (int *K : Keys)
+    M[K] = 1;
+  for (auto _ : State) {
+    unsigned Count = 0;
+    for (int *K : Misses)
+      Count += M.count(K);
+    benchmark::DoNotOptimize(Count);
+  }
+  State.SetItemsProcessed(State.iterations() * Misses.size());
+}
+
+template <typename MapT> static void BM_EraseInsert(benchmark::State &State) {
+  std::vector<int *> Keys = makeKeys(State.range(0), State.range(1), 0);
+  MapT M;
+  for (int *K : Keys)
+    M[K] = 1;
+  for (auto _ : State) {
+    for (int *K : Keys) {
+      M.erase(K);
+      M[K] = 1;
+    }
+  }
+  State.SetItemsProcessed(State.iterations() * Keys.size());
+}
+
+using DenseMapT = DenseMap<int *, unsigned>;
+using FlatDenseMapT = FlatDenseMap<int *, unsigned>;
+
+#define MAP_BENCHMARKS(Bench)                                                  \
+  BENCHMARK_TEMPLATE(Bench, DenseMapT)->Ranges({{1 << 6, 1 << 20}, {0, 1}});  \
+  BENCHMARK_TEMPLATE(Bench, FlatDenseMapT)->Ranges({{1 << 6, 1 << 20}, {0, 1}})
+
+MAP_BENCHMARKS(BM_Insert);
+MAP_BENCHMARKS(BM_FindHit);
+MAP_BENCHMARKS(BM_FindMiss);
+MAP_BENCHMARKS(BM_EraseInsert);
+
+BENCHMARK_MAIN();
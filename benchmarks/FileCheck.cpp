@@ -0,0 +1,93 @@
+#include "benchmark/benchmark.h"
+#include "llvm/Support/FileCheck.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Support/raw_ostream.h"
+#include <string>
+
+using namespace llvm;
+
+// Build the assembly of N small functions, the kind of input that FileCheck
+// reads from llc.
+static std::string buildInput(unsigned N) {
+  std::string Input;
+  raw_string_ostream OS(Input);
+  for (unsigned I = 0; I != N; ++I)
+    OS << "\t.globl\tfunc" << I << "\n"
+       << "func" << I << ":\n"
+       << "\tmovl\t%edi, %eax\n"
+       << "\timull\t$" << I << ", %eax, %ecx\n"
+       << "\taddl\t%esi, %ecx\n"
+       << "\tmovl\t%ecx, %eax\n"
+       << "\tretq\n";
+  return OS.str();
+}
+
+// Build the checks for every 16th function: a label, regex checks that start
+// with fixed text, a variable and a negative check.
+static std::string buildChecks(unsigned N) {
+  std::string Checks;
+  raw_string_ostream OS(Checks);
+  for (unsigned I = 0; I < N; I += 16)
+    OS << "CHECK-LABEL: func" << I << ":\n"
+       << "CHECK: imull {{\\$[0-9]+}}, %eax, [[REG:%[a-z]+]]\n"
+       << "CHECK-NEXT: addl %esi, [[REG]]\n"
+       << "CHECK-NOT: call{{q?}}\n"
+       << "CHECK: retq{{$}}\n";
+  return OS.str();
+}
+
+// Read the check file and match it against the input, as one run of the
+// FileCheck tool does.
+static void runFileCheck(benchmark::State &State, const FileCheckRequest &Req,
+                         StringRef Input, StringRef Checks) {
+  FileCheck FC(Req);
+  Regex PrefixRE = FC.buildCheckPrefixRegex();
+  SourceMgr SM;
+
+  auto CheckFile = MemoryBuffer::getMemBuffer(Checks, "checks");
+  SmallString<4096> CheckFileBuffer;
+  StringRef CheckFileText = FC.CanonicalizeFile(*CheckFile, CheckFileBuffer);
+  SM.AddNewSourceBuffer(MemoryBuffer::getMemBuffer(CheckFileText, "checks"),
+                        SMLoc());
+  std::vector<FileCheckString> CheckStrings;
+  if (FC.ReadCheckFile(SM, CheckFileText, PrefixRE, CheckStrings))
+    State.SkipWithError("invalid checks");
+
+  auto InputFile = MemoryBuffer::getMemBuffer(Input, "input");
+  SmallString<4096> InputFileBuffer;
+  StringRef InputFileText = FC.CanonicalizeFile(*InputFile, InputFileBuffer);
+  SM.AddNewSourceBuffer(MemoryBuffer::getMemBuffer(InputFileText, "input"),
+                        SMLoc());
+  if (!FC.CheckInput(SM, InputFileText, CheckStrings))
+    State.SkipWithError("checks failed");
+}
+
+static void BM_FileCheck(benchmark::State &State) {
+  std::string Input = buildInput(State.range(0));
+  std::string Checks = buildChecks(State.range(0));
+  FileCheckRequest Req;
+  Req.CheckPrefixes.push_back("CHECK");
+  for (auto _ : State)
+    runFileCheck(State, Req, Input, Checks);
+  State.SetBytesProcessed(State.iterations() * Input.size());
+}
+BENCHMARK(BM_FileCheck)->Arg(1 << 10)->Arg(1 << 14)->Unit(
+    benchmark::kMillisecond);
+
+// The same with an --implicit-check-not regex, which is matched between every
+// two checks.
+static void BM_FileCheckImplicitNot(benchmark::State &State) {
+  std::string Input = buildInput(State.range(0));
+  std::string Checks = buildChecks(State.range(0));
+  FileCheckRequest Req;
+  Req.CheckPrefixes.push_back("CHECK");
+  Req.ImplicitCheckNot.push_back("call{{q?}} {{_?}}abort");
+  for (auto _ : State)
+    runFileCheck(State, Req, Input, Checks);
+  State.SetBytesProcessed(State.iterations() * Input.size());
+}
+BENCHMARK(BM_FileCheckImplicitNot)->Arg(1 << 10)->Arg(1 << 14)->Unit(
+    benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
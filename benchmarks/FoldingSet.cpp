@@ -0,0 +1,76 @@
+#include "benchmark/benchmark.h"
+#include "llvm/ADT/FoldingSet.h"
+#include "llvm/ADT/STLExtras.h"
+#include <memory>
+#include <vector>
+
+using namespace llvm;
+
+namespace {
+// A node shaped like a binary expression: an opcode and two operands.
+struct ExprNode : FoldingSetNode {
+  unsigned Opcode;
+  const void *LHS, *RHS;
+
+  ExprNode(unsigned Opcode, const void *LHS, const void *RHS)
+      : Opcode(Opcode), LHS(LHS), RHS(RHS) {}
+
+  void Profile(FoldingSetNodeID &ID) const {
+    ID.AddInteger(Opcode);
+    ID.AddPointer(LHS);
+    ID.AddPointer(RHS);
+  }
+};
+
+struct ExprSet {
+  FoldingSet<ExprNode> Set;
+  std::vector<std::unique_ptr<ExprNode>> Nodes;
+
+  explicit ExprSet(int64_t N) {
+    for (int64_t I = 0; I != N; ++I) {
+      Nodes.push_back(llvm::make_unique<ExprNode>(
+          I % 16, Nodes.empty() ? nullptr : Nodes[I / 2].get(),
+          Nodes.empty() ? nullptr : Nodes.back().get()));
+      Set.InsertNode(Nodes.back().get());
+    }
+  }
+};
+} // end anonymous namespace
+
+static void BM_FindWithID(benchmark::State &State) {
+  ExprSet S(State.range(0));
+  for (auto _ : State) {
+    for (const auto &N : S.Nodes) {
+      FoldingSetNodeID ID;
+      N->Profile(ID);
+      void *InsertPos;
+      benchmark::DoNotOptimize(S.Set.FindNodeOrInsertPos(ID, InsertPos));
+    }
+  }
+  State.SetItemsProcessed(State.iterations() * State.range(0));
+}
+BENCHMARK(BM_FindWithID)->Range(1 << 8, 1 << 16);
+
+static void BM_FindWithHashBuilder(benchmark::State &State) {
+  ExprSet S(State.range(0));
+  for (auto _ : State) {
+    for (const auto &N : S.Nodes) {
+      FoldingSetHashBuilder Hash;
+      Hash.AddInteger(N->Opcode);
+      Hash.AddPointer(N->LHS);
+      Hash.AddPointer(N->RHS);
+      void *InsertPos;
+      benchmark::DoNotOptimize(S.Set.FindNodeOrInsertPos(
+          Hash.ComputeHash(),
+          [&](ExprNode *E) {
+            return E->Opcode == N->Opcode && E->LHS == N->LHS &&
+                   E->RHS == N->RHS;
+          },
+          InsertPos));
+    }
+  }
+  State.SetItemsProcessed(State.iterations() * State.range(0));
+}
+BENCHMARK(BM_FindWithHashBuilder)->Range(1 << 8, 1 << 16);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,61 @@
+#include "benchmark/benchmark.h"
+#include "../lib/AsmParser/LLLexer.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Support/raw_ostream.h"
+#include <string>
+
+using namespace llvm;
+
+// Build the text of N functions with the tokens the parser spends most of its
+// lexing time on: keywords, types, local and global names, integer and
+// floating-point constants, strings, metadata and comments.
+static std::string buildText(unsigned N) {
+  std::string Text;
+  raw_string_ostream OS(Text);
+  OS << "@str = private unnamed_addr constant [13 x i8] c\"hello world\\0A\\00\""
+     << "\n";
+  for (unsigned I = 0; I != N; ++I)
+    OS << "; Function Attrs: nounwind uwtable\n"
+       << "define dso_local double @func" << I
+       << "(i32 %n, double* nocapture readonly %p) #0 !dbg !" << I << " {\n"
+       << "entry:\n"
+       << "  %cmp = icmp sgt i32 %n, " << I << ", !dbg !" << I + 1 << "\n"
+       << "  br i1 %cmp, label %for.body, label %exit\n"
+       << "for.body:\n"
+       << "  %0 = load double, double* %p, align 8, !tbaa !" << I + 2 << "\n"
+       << "  %mul = fmul fast double %0, 0x3FF0000000000000\n"
+       << "  %add = fadd double %mul, 2.500000e+00\n"
+       << "  %call = tail call i32 (i8*, ...) @printf(i8* getelementptr "
+          "inbounds ([13 x i8], [13 x i8]* @str, i64 0, i64 0))\n"
+       << "  br label %exit\n"
+       << "exit:\n"
+       << "  %r = phi double [ %add, %for.body ], [ 0.000000e+00, %entry ]\n"
+       << "  ret double %r\n"
+       << "}\n";
+  return OS.str();
+}
+
+static void BM_Lex(benchmark::State &State) {
+  std::string Text = buildText(State.range(0));
+  LLVMContext Ctx;
+  SourceMgr SM;
+  SMDiagnostic Err;
+  for (auto _ : State) {
+    LLLexer Lexer(Text, SM, Err, Ctx);
+    unsigned NumTokens = 0;
+    for (lltok::Kind Kind = Lexer.Lex(); Kind != lltok::Eof;
+         Kind = Lexer.Lex()) {
+      if (Kind == lltok::Error) {
+        State.SkipWithError("lexer error");
+        break;
+      }
+      ++NumTokens;
+    }
+    benchmark::DoNotOptimize(NumTokens);
+  }
+  State.SetBytesProcessed(State.iterations() * Text.size());
+}
+BENCHMARK(BM_Lex)->Range(64, 4096);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,67 @@
+#include "benchmark/benchmark.h"
+#include "llvm/ADT/Triple.h"
+#include "llvm/Analysis/LazyCallGraph.h"
+#include "llvm/Analysis/TargetLibraryInfo.h"
+#include "llvm/IR/Constants.h"
+#include "llvm/IR/DerivedTypes.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/GlobalVariable.h"
+#include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+#include <memory>
+
+using namespace llvm;
+
+// Build a module of N functions in which every function takes the address of
+// the next one. This forms a single RefSCC of N trivial SCCs.
+static std::unique_ptr<Module> buildRefCycle(LLVMContext &Ctx, unsigned N) {
+  auto M = make_unique<Module>("lcg", Ctx);
+  auto *FTy = FunctionType::get(Type::getVoidTy(Ctx), false);
+  auto *PtrTy = PointerType::getUnqual(FTy);
+  auto *Sink = new GlobalVariable(*M, PtrTy, false, GlobalValue::ExternalLinkage,
+                                  nullptr, "sink");
+  SmallVector<Function *, 64> Fs;
+  for (unsigned I = 0; I != N; ++I)
+    Fs.push_back(Function::Create(FTy, GlobalValue::ExternalLinkage,
+                                  "f" + Twine(I), M.get()));
+  for (unsigned I = 0; I != N; ++I) {
+    IRBuilder<> B(BasicBlock::Create(Ctx, "entry", Fs[I]));
+    B.CreateStore(Fs[(I + 1) % N], Sink);
+    B.CreateRetVoid();
+  }
+  return M;
+}
+
+// Turn every ref edge of the cycle into a call edge. The SCCs are reordered
+// along the way until the final edge merges all of them.
+static void BM_SwitchInternalEdgeToCall(benchmark::State &State) {
+  LLVMContext Ctx;
+  unsigned N = State.range(0);
+  std::unique_ptr<Module> M = buildRefCycle(Ctx, N);
+  TargetLibraryInfoImpl TLII(Triple(M->getTargetTriple()));
+  TargetLibraryInfo TLI(TLII);
+
+  for (auto _ : State) {
+    State.PauseTiming();
+    LazyCallGraph CG(*M, TLI);
+    CG.buildRefSCCs();
+    LazyCallGraph::RefSCC &RC = *CG.postorder_ref_scc_begin();
+    SmallVector<LazyCallGraph::Node *, 64> Nodes;
+    for (Function &F : *M)
+      if (!F.isDeclaration())
+        Nodes.push_back(CG.lookup(F));
+    State.ResumeTiming();
+
+    // Walk the cycle with a stride so that the updates hit both the
+    // reordering and the trivial paths.
+    for (unsigned I = 0; I != N; ++I) {
+      unsigned Idx = (I * 7) % N;
+      RC.switchInternalEdgeToCall(*Nodes[Idx], *Nodes[(Idx + 1) % N]);
+    }
+    benchmark::DoNotOptimize(RC.size());
+  }
+}
+BENCHMARK(BM_SwitchInternalEdgeToCall)->Range(64, 4096);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,141 @@
+#include "benchmark/benchmark.h"
+#include "llvm/MC/MCAsmInfo.h"
+#include "llvm/MC/MCContext.h"
+#include "llvm/MC/MCInstrAnalysis.h"
+#include "llvm/MC/MCInstrInfo.h"
+#include "llvm/MC/MCObjectFileInfo.h"
+#include "llvm/MC/MCParser/MCAsmParser.h"
+#include "llvm/MC/MCParser/MCTargetAsmParser.h"
+#include "llvm/MC/MCRegisterInfo.h"
+#include "llvm/MC/MCStreamer.h"
+#include "llvm/MC/MCSubtargetInfo.h"
+#include "llvm/MC/MCTargetOptions.h"
+#include "llvm/MCA/Context.h"
+#include "llvm/MCA/InstrBuilder.h"
+#include "llvm/MCA/Pipeline.h"
+#include "llvm/MCA/SourceMgr.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Support/TargetRegistry.h"
+#include "llvm/Support/TargetSelect.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace llvm;
+
+static const char TripleName[] = "x86_64-unknown-linux-gnu";
+
+// The body of a dot product loop, with loads, FP arithmetic and a loop
+// carried dependency, which keeps the scheduler queues busy.
+static const char LoopText[] = "vmovaps (%rdi,%rax), %ymm1\n"
+                               "vmulps  (%rsi,%rax), %ymm1, %ymm1\n"
+                               "vaddps  %ymm1, %ymm0, %ymm0\n"
+                               "vmovaps 32(%rdi,%rax), %ymm2\n"
+                               "vmulps  32(%rsi,%rax), %ymm2, %ymm2\n"
+                               "vaddps  %ymm2, %ymm3, %ymm3\n"
+                               "movl    %eax, (%rdx,%rcx,4)\n"
+                               "addq    $64, %rax\n"
+                               "cmpq    %rax, %r8\n";
+
+namespace {
+
+// Collects the instructions parsed from the loop text.
+class InstCollector final : public MCStreamer {
+public:
+  std::vector<MCInst> Insts;
+
+  InstCollector(MCContext &Context) : MCStreamer(Context) {}
+
+  void EmitInstruction(const MCInst &Inst, const MCSubtargetInfo &,
+                       bool) override {
+    Insts.push_back(Inst);
+  }
+
+  bool EmitSymbolAttribute(MCSymbol *, MCSymbolAttr) override { return true; }
+  void EmitCommonSymbol(MCSymbol *, uint64_t, unsigned) override {}
+  void EmitZerofill(MCSection *, MCSymbol *, uint64_t, unsigned,
+                    SMLoc) override {}
+};
+
+} // end anonymous namespace
+
+// Simulate State.range(0) iterations of the loop on a CPU with a large out of
+// order window.
+static void BM_SimulateLoop(benchmark::State &State) {
+  InitializeAllTargetInfos();
+  InitializeAllTargetMCs();
+  InitializeAllAsmParsers();
+
+  std::string Error;
+  const Target *TheTarget = TargetRegistry::lookupTarget(TripleName, Error);
+  if (!TheTarget) {
+    State.SkipWithError(Error.c_str());
+    return;
+  }
+
+  Triple TheTriple(TripleName);
+  MCTargetOptions MCOptions;
+  std::unique_ptr<MCRegisterInfo> MRI(TheTarget->createMCRegInfo(TripleName));
+  std::unique_ptr<MCAsmInfo> MAI(TheTarget->createMCAsmInfo(*MRI, TripleName));
+  std::unique_ptr<MCInstrInfo> MCII(TheTarget->createMCInstrInfo());
+  std::unique_ptr<MCInstrAnalysis> MCIA(
+      TheTarget->createMCInstrAnalysis(MCII.get()));
+  std::unique_ptr<MCSubtargetInfo> STI(
+      TheTarget->createMCSubtargetInfo(TripleName, "skylake", ""));
+
+  SourceMgr SrcMgr;
+  SrcMgr.AddNewSourceBuffer(
+      MemoryBuffer::getMemBuffer(LoopText, "<bench>", false), SMLoc());
+  MCObjectFileInfo MOFI;
+  MCContext Ctx(MAI.get(), MRI.get(), &MOFI, &SrcMgr);
+  MOFI.InitMCObjectFileInfo(TheTriple, /*PIC=*/false, Ctx);
+  InstCollector Str(Ctx);
+  std::unique_ptr<MCAsmParser> Parser(
+      createMCAsmParser(SrcMgr, Ctx, Str, *MAI));
+  std::unique_ptr<MCTargetAsmParser> TAP(
+      TheTarget->createMCAsmParser(*STI, *Parser, *MCII, MCOptions));
+  Parser->setTargetParser(*TAP);
+  if (Parser->Run(/*NoInitialTextSection=*/false)) {
+    State.SkipWithError("invalid assembly");
+    return;
+  }
+
+  mca::InstrBuilder IB(*STI, *MCII, *MRI, MCIA.get());
+  std::vector<std::unique_ptr<mca::Instruction>> Lowered;
+  for (const MCInst &MCI : Str.Insts) {
+    Expected<std::unique_ptr<mca::Instruction>> Inst =
+        IB.createInstruction(MCI);
+    if (!Inst) {
+      consumeError(Inst.takeError());
+      State.SkipWithError("unsupported instruction");
+      return;
+    }
+    Lowered.emplace_back(std::move(*Inst));
+  }
+
+  unsigned Iterations = State.range(0);
+  mca::PipelineOptions PO(STI->getSchedModel().IssueWidth,
+                          /*RegisterFileSize=*/0, /*LoadQueueSize=*/0,
+                          /*StoreQueueSize=*/0, /*AssumeNoAlias=*/true);
+  uint64_t Cycles = 0;
+  for (auto _ : State) {
+    mca::Context MCA(*MRI, *STI);
+    mca::SourceMgr S(Lowered, Iterations);
+    std::unique_ptr<mca::Pipeline> P = MCA.createDefaultPipeline(PO, IB, S);
+    Expected<unsigned> Result = P->run();
+    if (!Result) {
+      consumeError(Result.takeError());
+      State.SkipWithError("simulation failed");
+      return;
+    }
+    Cycles += *Result;
+  }
+  State.SetItemsProcessed(int64_t(State.iterations()) * Iterations *
+                          Lowered.size());
+  State.counters["cycles"] =
+      benchmark::Counter(double(Cycles), benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_SimulateLoop)->Range(100, 10000);
+
+BENCHMARK_MAIN();
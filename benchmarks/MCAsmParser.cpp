@@ -0,0 +1,124 @@
+#include "benchmark/benchmark.h"
+#include "llvm/MC/MCAsmBackend.h"
+#include "llvm/MC/MCAsmInfo.h"
+#include "llvm/MC/MCCodeEmitter.h"
+#include "llvm/MC/MCContext.h"
+#include "llvm/MC/MCInstrInfo.h"
+#include "llvm/MC/MCObjectFileInfo.h"
+#include "llvm/MC/MCObjectWriter.h"
+#include "llvm/MC/MCParser/MCAsmParser.h"
+#include "llvm/MC/MCParser/MCTargetAsmParser.h"
+#include "llvm/MC/MCRegisterInfo.h"
+#include "llvm/MC/MCStreamer.h"
+#include "llvm/MC/MCSubtargetInfo.h"
+#include "llvm/MC/MCTargetOptions.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Support/TargetRegistry.h"
+#include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/raw_ostream.h"
+#include <string>
+
+using namespace llvm;
+
+static const char TripleName[] = "x86_64-unknown-linux-gnu";
+
+// Build an assembly file of N functions in the shape compilers emit: labels,
+// a mix of instructions and directives, and label differences for sizes and
+// a jump table. Returns the number of lines in \p Lines.
+static std::string buildAsmText(unsigned N, unsigned &Lines) {
+  std::string Text;
+  raw_string_ostream OS(Text);
+  OS << "\t.text\n";
+  Lines = 1;
+  for (unsigned I = 0; I != N; ++I) {
+    OS << "\t.globl\tf" << I << "\n"
+       << "\t.p2align\t4, 0x90\n"
+       << "\t.type\tf" << I << ",@function\n"
+       << "f" << I << ":\n"
+       << "\t.cfi_startproc\n"
+       << "\tpushq\t%rbp\n"
+       << "\t.cfi_def_cfa_offset 16\n"
+       << "\tmovq\t%rsp, %rbp\n"
+       << "\tmovl\t%edi, %eax\n"
+       << "\tleaq\t.LJTI" << I << "(%rip), %rcx\n"
+       << "\tmovslq\t(%rcx,%rax,4), %rax\n"
+       << "\taddq\t%rcx, %rax\n"
+       << "\tjmpq\t*%rax\n"
+       << ".LBB" << I << "_1:\n"
+       << "\taddl\t$" << I << ", %esi\n"
+       << "\tjmp\t.LBB" << I << "_3\n"
+       << ".LBB" << I << "_2:\n"
+       << "\timull\t%esi, %esi\n"
+       << ".LBB" << I << "_3:\n"
+       << "\tmovl\t%esi, %eax\n"
+       << "\tpopq\t%rbp\n"
+       << "\tretq\n"
+       << ".Lfunc_end" << I << ":\n"
+       << "\t.size\tf" << I << ", .Lfunc_end" << I << "-f" << I << "\n"
+       << "\t.cfi_endproc\n"
+       << "\t.section\t.rodata,\"a\",@progbits\n"
+       << "\t.p2align\t2\n"
+       << ".LJTI" << I << ":\n"
+       << "\t.long\t.LBB" << I << "_1-.LJTI" << I << "\n"
+       << "\t.long\t.LBB" << I << "_2-.LJTI" << I << "\n"
+       << "\t.text\n";
+    Lines += 31;
+  }
+  return OS.str();
+}
+
+static void BM_AssembleObject(benchmark::State &State) {
+  InitializeAllTargetInfos();
+  InitializeAllTargetMCs();
+  InitializeAllAsmParsers();
+
+  std::string Error;
+  const Target *TheTarget = TargetRegistry::lookupTarget(TripleName, Error);
+  if (!TheTarget) {
+    State.SkipWithError(Error.c_str());
+    return;
+  }
+
+  unsigned Lines;
+  std::string Text = buildAsmText(State.range(0), Lines);
+  Triple TheTriple(TripleName);
+  MCTargetOptions MCOptions;
+  std::unique_ptr<MCRegisterInfo> MRI(TheTarget->createMCRegInfo(TripleName));
+  std::unique_ptr<MCAsmInfo> MAI(TheTarget->createMCAsmInfo(*MRI, TripleName));
+  std::unique_ptr<MCInstrInfo> MCII(TheTarget->createMCInstrInfo());
+  std::unique_ptr<MCSubtargetInfo> STI(
+      TheTarget->createMCSubtargetInfo(TripleName, "", ""));
+
+  for (auto _ : State) {
+    SourceMgr SrcMgr;
+    SrcMgr.AddNewSourceBuffer(
+        MemoryBuffer::getMemBuffer(Text, "<bench>", false), SMLoc());
+    MCObjectFileInfo MOFI;
+    MCContext Ctx(MAI.get(), MRI.get(), &MOFI, &SrcMgr);
+    MOFI.InitMCObjectFileInfo(TheTriple, /*PIC=*/false, Ctx);
+
+    raw_null_ostream OS;
+    MCCodeEmitter *CE = TheTarget->createMCCodeEmitter(*MCII, *MRI, Ctx);
+    MCAsmBackend *MAB = TheTarget->createMCAsmBackend(*STI, *MRI, MCOptions);
+    std::unique_ptr<MCStreamer> Str(TheTarget->createMCObjectStreamer(
+        TheTriple, Ctx, std::unique_ptr<MCAsmBackend>(MAB),
+        MAB->createObjectWriter(OS), std::unique_ptr<MCCodeEmitter>(CE), *STI,
+        /*RelaxAll=*/false, /*IncrementalLinkerCompatible=*/false,
+        /*DWARFMustBeAtTheEnd=*/false));
+
+    std::unique_ptr<MCAsmParser> Parser(
+        createMCAsmParser(SrcMgr, Ctx, *Str, *MAI));
+    std::unique_ptr<MCTargetAsmParser> TAP(
+        TheTarget->createMCAsmParser(*STI, *Parser, *MCII, MCOptions));
+    Parser->setTargetParser(*TAP);
+    if (Parser->Run(/*NoInitialTextSection=*/false))
+      State.SkipWithError("invalid assembly");
+  }
+  State.SetBytesProcessed(int64_t(State.iterations()) * Text.size());
+  State.counters["lines"] = benchmark::Counter(
+      double(State.iterations()) * Lines, benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_AssembleObject)->Range(64, 4096);
+
+BENCHMARK_MAIN();
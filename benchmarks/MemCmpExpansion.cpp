@@ -0,0 +1,99 @@
+#include "benchmark/benchmark.h"
+#include "llvm/AsmParser/Parser.h"
+#include "llvm/ExecutionEngine/ExecutionEngine.h"
+#include "llvm/ExecutionEngine/MCJIT.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/raw_ostream.h"
+#include <cstring>
+#include <memory>
+#include <string>
+
+using namespace llvm;
+
+using EqualFn = bool (*)(const char *, const char *);
+
+// Define @eq<N> and @eq<N>_call, both testing memcmp(a, b, N) == 0. The calls
+// in the second are nobuiltin, so they are left to the library.
+static std::string buildModuleText(unsigned Size) {
+  std::string Text;
+  raw_string_ostream OS(Text);
+  OS << "declare i32 @memcmp(i8*, i8*, i64)\n";
+  for (const char *Suffix : {"", "_call"}) {
+    OS << "define i1 @eq" << Size << Suffix << "(i8* %a, i8* %b) {\n"
+       << "  %c = call i32 @memcmp(i8* %a, i8* %b, i64 " << Size << ")";
+    if (*Suffix)
+      OS << " nobuiltin";
+    OS << "\n"
+       << "  %r = icmp eq i32 %c, 0\n"
+       << "  ret i1 %r\n"
+       << "}\n";
+  }
+  return OS.str();
+}
+
+namespace {
+// Compiles the two functions of buildModuleText for the host with MCJIT.
+struct MemCmpJIT {
+  LLVMContext Ctx;
+  std::unique_ptr<ExecutionEngine> EE;
+  EqualFn Expanded = nullptr;
+  EqualFn Call = nullptr;
+
+  MemCmpJIT(benchmark::State &State, unsigned Size) {
+    InitializeNativeTarget();
+    InitializeNativeTargetAsmPrinter();
+
+    SMDiagnostic Err;
+    std::unique_ptr<Module> M =
+        parseAssemblyString(buildModuleText(Size), Err, Ctx);
+    if (!M) {
+      State.SkipWithError("invalid module");
+      return;
+    }
+    std::string Error;
+    EE.reset(EngineBuilder(std::move(M))
+                 .setErrorStr(&Error)
+                 .setEngineKind(EngineKind::JIT)
+                 .setOptLevel(CodeGenOpt::Default)
+                 .create());
+    if (!EE) {
+      State.SkipWithError(Error.c_str());
+      return;
+    }
+    std::string Name = "eq" + std::to_string(Size);
+    Expanded = reinterpret_cast<EqualFn>(EE->getFunctionAddress(Name));
+    Call = reinterpret_cast<EqualFn>(EE->getFunctionAddress(Name + "_call"));
+    if (!Expanded || !Call)
+      State.SkipWithError("cannot compile the functions");
+  }
+};
+} // end anonymous namespace
+
+// Compare two equal buffers of N bytes, so that every load of the expansion
+// is executed, with the function chosen by the second argument: the inline
+// expansion (0) or the library call (1).
+static void BM_MemCmpEq(benchmark::State &State) {
+  unsigned Size = State.range(0);
+  MemCmpJIT JIT(State, Size);
+  EqualFn Fn = State.range(1) ? JIT.Call : JIT.Expanded;
+  if (!Fn)
+    return;
+  char A[64], B[64];
+  std::memset(A, 'x', sizeof(A));
+  std::memset(B, 'x', sizeof(B));
+  for (auto _ : State) {
+    benchmark::DoNotOptimize(A);
+    benchmark::DoNotOptimize(Fn(A, B));
+  }
+  State.SetBytesProcessed(int64_t(State.iterations()) * Size);
+}
+BENCHMARK(BM_MemCmpEq)
+    ->Args({24, 0})
+    ->Args({24, 1})
+    ->Args({40, 0})
+    ->Args({40, 1});
+
+BENCHMARK_MAIN();
@@ -0,0 +1,41 @@
+#include "benchmark/benchmark.h"
+#include "llvm/Support/Parallel.h"
+#include <atomic>
+
+using namespace llvm;
+
+#if LLVM_ENABLE_THREADS
+
+// Spawn many tiny tasks directly, to measure the per-task overhead of the
+// executor.
+static void BM_TaskGroupSpawn(benchmark::State &State) {
+  std::atomic<uint64_t> Sum{0};
+  for (auto _ : State) {
+    parallel::detail::TaskGroup TG;
+    for (int64_t I = 0, E = State.range(0); I != E; ++I)
+      TG.spawn([&Sum, I] { Sum.fetch_add(I, std::memory_order_relaxed); });
+  }
+  benchmark::DoNotOptimize(Sum.load());
+  State.SetItemsProcessed(State.iterations() * State.range(0));
+}
+BENCHMARK(BM_TaskGroupSpawn)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+
+// Run a parallel loop from every task of another one.
+static void BM_NestedForEachN(benchmark::State &State) {
+  std::atomic<uint64_t> Sum{0};
+  const size_t N = State.range(0);
+  for (auto _ : State)
+    for_each_n(parallel::par, size_t(0), N, [&](size_t I) {
+      for_each_n(parallel::par, size_t(0), N, [&](size_t J) {
+        Sum.fetch_add(I ^ J, std::memory_order_relaxed);
+      });
+    });
+  benchmark::DoNotOptimize(Sum.load());
+  State.SetItemsProcessed(State.iterations() * State.range(0) *
+                          State.range(0));
+}
+BENCHMARK(BM_NestedForEachN)->Arg(1 << 10)->Unit(benchmark::kMillisecond);
+
+#endif
+
+BENCHMARK_MAIN();
@@ -0,0 +1,29 @@
+#include "benchmark/benchmark.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SmallVector.h"
+#include <memory>
+
+using namespace llvm;
+
+namespace {
+// A unique_ptr that does not opt into isTriviallyRelocatable, to compare the
+// element-wise growth against the memcpy one.
+struct OwnedInt {
+  std::unique_ptr<int> Ptr;
+  explicit OwnedInt(int *P) : Ptr(P) {}
+};
+} // end anonymous namespace
+
+template <typename T> static void BM_PushBackGrow(benchmark::State &State) {
+  for (auto _ : State) {
+    SmallVector<T, 4> V;
+    for (int64_t I = 0, E = State.range(0); I != E; ++I)
+      V.emplace_back(nullptr);
+    benchmark::DoNotOptimize(V.data());
+  }
+  State.SetItemsProcessed(State.iterations() * State.range(0));
+}
+BENCHMARK_TEMPLATE(BM_PushBackGrow, std::unique_ptr<int>)->Range(16, 1 << 16);
+BENCHMARK_TEMPLATE(BM_PushBackGrow, OwnedInt)->Range(16, 1 << 16);
+
+BENCHMARK_MAIN();
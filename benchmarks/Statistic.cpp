@@ -0,0 +1,22 @@
+#include "benchmark/benchmark.h"
+#include "llvm/ADT/Statistic.h"
+
+using namespace llvm;
+
+#define DEBUG_TYPE "bench"
+STATISTIC(NumIncrements, "Number of increments");
+
+// Increment one statistic from every thread, as a hot counter of a pass run
+// in parallel is.
+static void BM_StatisticIncrement(benchmark::State &State) {
+#if LLVM_ENABLE_STATS
+  for (auto _ : State)
+    ++NumIncrements;
+  State.SetItemsProcessed(State.iterations());
+#else
+  State.SkipWithError("statistics are disabled in this build");
+#endif
+}
+BENCHMARK(BM_StatisticIncrement)->ThreadRange(1, 8);
+
+BENCHMARK_MAIN();
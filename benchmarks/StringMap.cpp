@@ -0,0 +1,72 @@
+#include "benchmark/benchmark.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/ADT/Twine.h"
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace llvm;
+
+// Build N distinct names shaped like the mangled symbols and section names
+// that StringMap holds in the middle end and MC, shuffled so that lookups do
+// not follow insertion order.
+static std::vector<std::string> makeNames(size_t N, StringRef Prefix,
+                                          unsigned Seed) {
+  std::vector<std::string> Names;
+  Names.reserve(N);
+  for (size_t I = 0; I != N; ++I)
+    Names.push_back(
+        (Prefix + "ZN4llvm" + Twine(I % 97) + "Namespace" + Twine(I) + "Ev")
+            .str());
+  std::shuffle(Names.begin(), Names.end(), std::mt19937(Seed));
+  return Names;
+}
+
+static void BM_StringMapInsert(benchmark::State &State) {
+  std::vector<std::string> Names = makeNames(State.range(0), "_", 0);
+  for (auto _ : State) {
+    StringMap<unsigned> M;
+    for (const std::string &Name : Names)
+      M[Name] = 0;
+    benchmark::DoNotOptimize(M.size());
+  }
+  State.SetItemsProcessed(State.iterations() * Names.size());
+}
+BENCHMARK(BM_StringMapInsert)->Range(1 << 6, 1 << 18);
+
+static void BM_StringMapFindHit(benchmark::State &State) {
+  std::vector<std::string> Names = makeNames(State.range(0), "_", 0);
+  StringMap<unsigned> M;
+  for (const std::string &Name : Names)
+    M[Name] = 1;
+  std::shuffle(Names.begin(), Names.end(), std::mt19937(1));
+  for (auto _ : State) {
+    unsigned Sum = 0;
+    for (const std::string &Name : Names)
+      Sum += M.find(Name)->second;
+    benchmark::DoNotOptimize(Sum);
+  }
+  State.SetItemsProcessed(State.iterations() * Names.size());
+}
+BENCHMARK(BM_StringMapFindHit)->Range(1 << 6, 1 << 18);
+
+// Misses share the suffix of the keys, so they hash to full buckets and are
+// only told apart by the string compare.
+static void BM_StringMapFindMiss(benchmark::State &State) {
+  std::vector<std::string> Names = makeNames(State.range(0), "_", 0);
+  std::vector<std::string> Misses = makeNames(State.range(0), "__", 2);
+  StringMap<unsigned> M;
+  for (const std::string &Name : Names)
+    M[Name] = 1;
+  for (auto _ : State) {
+    unsigned Count = 0;
+    for (const std::string &Name : Misses)
+      Count += M.count(Name);
+    benchmark::DoNotOptimize(Count);
+  }
+  State.SetItemsProcessed(State.iterations() * Misses.size());
+}
+BENCHMARK(BM_StringMapFindMiss)->Range(1 << 6, 1 << 18);
+
+BENCHMARK_MAIN();
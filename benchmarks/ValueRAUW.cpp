@@ -0,0 +1,60 @@
+#include "benchmark/benchmark.h"
+#include "llvm/IR/Constants.h"
+#include "llvm/IR/DerivedTypes.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/GlobalVariable.h"
+#include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+#include <memory>
+
+using namespace llvm;
+
+// Build a function that loads N times from each of @a and @b. Every
+// ConstantGEPStride-th load goes through a constant GEP, so the globals also
+// have constant users.
+static std::unique_ptr<Module> buildLoads(LLVMContext &Ctx, unsigned N,
+                                          unsigned ConstantGEPStride) {
+  auto M = make_unique<Module>("rauw", Ctx);
+  auto *ArrayTy = ArrayType::get(Type::getInt32Ty(Ctx), N);
+  for (const char *Name : {"a", "b"})
+    new GlobalVariable(*M, ArrayTy, false, GlobalValue::ExternalLinkage,
+                       nullptr, Name);
+  auto *FTy = FunctionType::get(Type::getVoidTy(Ctx), false);
+  auto *F = Function::Create(FTy, GlobalValue::ExternalLinkage, "f", M.get());
+  IRBuilder<> B(BasicBlock::Create(Ctx, "entry", F));
+  for (unsigned I = 0; I != N; ++I)
+    for (GlobalVariable *GV : {M->getNamedGlobal("a"), M->getNamedGlobal("b")})
+      B.CreateLoad(ConstantGEPStride && I % ConstantGEPStride == 0
+                       ? B.CreateConstInBoundsGEP2_32(ArrayTy, GV, 0, I)
+                       : GV);
+  B.CreateRetVoid();
+  return M;
+}
+
+// Swap all uses of @a and @b back and forth.
+static void runRAUW(benchmark::State &State, unsigned ConstantGEPStride) {
+  LLVMContext Ctx;
+  std::unique_ptr<Module> M =
+      buildLoads(Ctx, State.range(0), ConstantGEPStride);
+  GlobalVariable *A = M->getNamedGlobal("a");
+  GlobalVariable *B = M->getNamedGlobal("b");
+  auto *Tmp = new GlobalVariable(*M, A->getValueType(), false,
+                                 GlobalValue::ExternalLinkage, nullptr, "tmp");
+  for (auto _ : State) {
+    A->replaceAllUsesWith(Tmp);
+    B->replaceAllUsesWith(A);
+    Tmp->replaceAllUsesWith(B);
+  }
+  State.SetItemsProcessed(int64_t(State.iterations()) * 3 * State.range(0));
+}
+
+static void BM_RAUWInstructionUsers(benchmark::State &State) {
+  runRAUW(State, 0);
+}
+BENCHMARK(BM_RAUWInstructionUsers)->Range(64, 65536);
+
+static void BM_RAUWMixedUsers(benchmark::State &State) { runRAUW(State, 16); }
+BENCHMARK(BM_RAUWMixedUsers)->Range(64, 65536);
+
+BENCHMARK_MAIN();
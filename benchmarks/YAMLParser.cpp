@@ -0,0 +1,148 @@
+#include "benchmark/benchmark.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Support/YAMLParser.h"
+#include "llvm/Support/YAMLTraits.h"
+#include "llvm/Support/raw_ostream.h"
+#include <string>
+#include <vector>
+
+using namespace llvm;
+
+// Build a document of N entries shaped like the optimization remarks and MIR
+// that LLVM reads: a sequence of mappings with flow sequences, quoted and
+// block scalars.
+static std::string buildDocument(unsigned N) {
+  std::string Text;
+  raw_string_ostream OS(Text);
+  OS << "---\n";
+  for (unsigned I = 0; I != N; ++I)
+    OS << "- Pass:            inline\n"
+       << "  Name:            Inlined\n"
+       << "  DebugLoc:        { File: 'lib/File" << I % 17
+       << ".cpp', Line: " << I << ", Column: " << I % 80 << " }\n"
+       << "  Function:        '_ZN4llvm8function" << I << "Ev'\n"
+       << "  Args:\n"
+       << "    - Callee:      \"callee" << I << "\"\n"
+       << "    - Cost:        '" << I * 3 << "'\n"
+       << "  Body:            |\n"
+       << "    bb.0.entry:\n"
+       << "      $w0 = MOVi32imm " << I << "\n";
+  OS << "...\n";
+  return OS.str();
+}
+
+// Parse every node of the document.
+static void BM_YAMLParse(benchmark::State &State) {
+  std::string Text = buildDocument(State.range(0));
+  for (auto _ : State) {
+    SourceMgr SM;
+    yaml::Stream Stream(Text, SM);
+    for (yaml::Document &Doc : Stream)
+      Doc.skip();
+    if (Stream.failed())
+      State.SkipWithError("invalid document");
+  }
+  State.SetBytesProcessed(State.iterations() * Text.size());
+}
+BENCHMARK(BM_YAMLParse)->Range(64, 4096);
+
+// Only run the scanner over the document.
+static void BM_YAMLScan(benchmark::State &State) {
+  std::string Text = buildDocument(State.range(0));
+  for (auto _ : State)
+    if (!yaml::scanTokens(Text))
+      State.SkipWithError("invalid document");
+  State.SetBytesProcessed(State.iterations() * Text.size());
+}
+BENCHMARK(BM_YAMLScan)->Range(64, 4096);
+
+// The scalar classification that YAMLTraits does for every unquoted value.
+static void BM_YAMLIsNumeric(benchmark::State &State) {
+  const StringRef Scalars[] = {"hello", "42", "-0x1F", "3.25e+10", ".inf",
+                               "0o17", "inline", "1_000"};
+  for (auto _ : State)
+    for (StringRef S : Scalars)
+      benchmark::DoNotOptimize(yaml::isNumeric(S));
+  State.SetItemsProcessed(State.iterations() * array_lengthof(Scalars));
+}
+BENCHMARK(BM_YAMLIsNumeric);
+
+namespace {
+struct BenchLoc {
+  StringRef File;
+  unsigned Line;
+  unsigned Column;
+};
+
+struct BenchRemark {
+  StringRef Pass;
+  StringRef Name;
+  BenchLoc DebugLoc;
+  StringRef Function;
+  std::vector<BenchLoc> Args;
+};
+} // end anonymous namespace
+
+namespace llvm {
+namespace yaml {
+template <> struct MappingTraits<BenchLoc> {
+  static void mapping(IO &IO, BenchLoc &Loc) {
+    IO.mapRequired("File", Loc.File);
+    IO.mapRequired("Line", Loc.Line);
+    IO.mapRequired("Column", Loc.Column);
+  }
+};
+
+template <> struct MappingTraits<BenchRemark> {
+  static void mapping(IO &IO, BenchRemark &R) {
+    IO.mapRequired("Pass", R.Pass);
+    IO.mapRequired("Name", R.Name);
+    IO.mapRequired("DebugLoc", R.DebugLoc);
+    IO.mapRequired("Function", R.Function);
+    IO.mapOptional("Args", R.Args);
+  }
+};
+} // end namespace yaml
+} // end namespace llvm
+
+LLVM_YAML_IS_SEQUENCE_VECTOR(BenchLoc)
+LLVM_YAML_IS_DOCUMENT_LIST_VECTOR(BenchRemark)
+
+// Build a stream of N documents shaped like a remarks file.
+static std::string buildRemarks(unsigned N) {
+  std::string Text;
+  raw_string_ostream OS(Text);
+  for (unsigned I = 0; I != N; ++I) {
+    OS << "--- !Missed\n"
+       << "Pass:            inline\n"
+       << "Name:            NoDefinition\n"
+       << "DebugLoc:        { File: lib/Transforms/File" << I % 17
+       << ".cpp, Line: " << I << ", Column: " << I % 80 << " }\n"
+       << "Function:        _ZN4llvm8function" << I << "Ev\n"
+       << "Args:\n";
+    for (unsigned J = 0; J != 3; ++J)
+      OS << "  - { File: include/llvm/Header" << J << ".h, Line: " << I + J
+         << ", Column: " << J << " }\n";
+    OS << "...\n";
+  }
+  return OS.str();
+}
+
+// Map every document of a remarks file with YAMLTraits.
+static void BM_YAMLInput(benchmark::State &State) {
+  std::string Text = buildRemarks(State.range(0));
+  for (auto _ : State) {
+    std::vector<BenchRemark> Remarks;
+    yaml::Input YIn(Text);
+    YIn >> Remarks;
+    if (YIn.error()) {
+      State.SkipWithError("invalid document");
+      break;
+    }
+    benchmark::DoNotOptimize(Remarks.data());
+  }
+  State.SetBytesProcessed(State.iterations() * Text.size());
+}
+BENCHMARK(BM_YAMLInput)->Range(64, 4096);
+
+BENCHMARK_MAIN();
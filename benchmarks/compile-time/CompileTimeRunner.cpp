@@ -0,0 +1,384 @@
+//===-- CompileTimeRunner.cpp - Compile-time regression harness -----------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This program runs opt and llc at -O2 over a corpus of IR files and records,
+// for each run, the wall time, the instructions retired by the compiler and
+// the time of each pass from the -time-passes report. The results are written
+// as JSON. Given the results of an earlier run as a baseline, it reports the
+// benchmarks that got slower by more than a threshold, with the passes that
+// account for the difference, and exits with an error.
+//
+// An input may add arguments for either tool with lines of the form
+//   ; OPT-ARGS: <arguments>
+//   ; LLC-ARGS: <arguments>
+// in its leading comments.
+//
+//===----------------------------------------------------------------------===//
+
+#include "PerfHelper.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Error.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/FileUtilities.h"
+#include "llvm/Support/FormatVariadic.h"
+#include "llvm/Support/InitLLVM.h"
+#include "llvm/Support/JSON.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/Program.h"
+#include "llvm/Support/ToolOutputFile.h"
+#include "llvm/Support/raw_ostream.h"
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace llvm;
+using namespace llvm::exegesis;
+
+static cl::list<std::string> InputFilenames(cl::Positional, cl::OneOrMore,
+                                            cl::desc("<input .ll files>"));
+
+static cl::opt<std::string> OptPath("opt", cl::desc("Path to opt"),
+                                    cl::value_desc("path"), cl::Required);
+
+static cl::opt<std::string> LlcPath("llc", cl::desc("Path to llc"),
+                                    cl::value_desc("path"), cl::Required);
+
+static cl::opt<std::string> OutputFilename("o", cl::desc("Output JSON file"),
+                                           cl::value_desc("filename"),
+                                           cl::init("-"));
+
+static cl::opt<std::string>
+    BaselineFilename("baseline",
+                     cl::desc("JSON results of an earlier run to compare to"),
+                     cl::value_desc("filename"));
+
+static cl::opt<double>
+    Threshold("threshold",
+              cl::desc("Slowdown over the baseline, in percent, that counts "
+                       "as a regression (default: 5)"),
+              cl::init(5.0));
+
+static cl::opt<unsigned>
+    Repetitions("repetitions",
+                cl::desc("Number of runs of each benchmark; the fastest one "
+                         "is kept (default: 3)"),
+                cl::init(3));
+
+static cl::opt<std::string>
+    CounterName("counter",
+                cl::desc("libpfm event counted in the compiler process "
+                         "(default: INSTRUCTIONS_RETIRED)"),
+                cl::init("INSTRUCTIONS_RETIRED"));
+
+static ExitOnError ExitOnErr("compile-time-runner: ");
+
+namespace {
+
+struct Measurement {
+  double WallTime = 0;
+  // The count of CounterName, or -1 when it could not be measured.
+  int64_t Instructions = -1;
+  // Wall time per pass, summed over all the instances of the pass.
+  StringMap<double> PassTimes;
+};
+
+struct Benchmark {
+  std::string Name;
+  std::string Program;
+  std::vector<std::string> Args;
+  Measurement Result;
+};
+
+} // end anonymous namespace
+
+// Passes that run more than once are reported as "<name> #<n>"; drop the
+// instance number so that they are attributed to one entry.
+static StringRef stripInstanceNumber(StringRef Name) {
+  size_t Pos = Name.rfind(" #");
+  if (Pos == StringRef::npos)
+    return Name;
+  StringRef Number = Name.drop_front(Pos + 2);
+  if (Number.empty() || !all_of(Number, isDigit))
+    return Name;
+  return Name.take_front(Pos);
+}
+
+// Parse the "Pass execution timing report" groups of a -time-passes report,
+// as printed by TimerGroup::PrintQueuedTimers. Every time column is 18
+// characters wide, and the wall time is the last of them.
+static void parsePassTimes(StringRef Report, StringMap<double> &PassTimes) {
+  const size_t ColumnWidth = 18;
+  SmallVector<StringRef, 0> Lines;
+  Report.split(Lines, '\n');
+
+  bool InPassGroup = false;
+  size_t NumTimeColumns = 0;
+  size_t NameColumn = 0;
+  for (StringRef Line : Lines) {
+    if (Line.trim() == "... Pass execution timing report ...") {
+      InPassGroup = true;
+      NameColumn = 0;
+      continue;
+    }
+    if (!InPassGroup)
+      continue;
+    if (NameColumn == 0) {
+      if (!Line.contains("--- Name ---"))
+        continue;
+      NumTimeColumns = Line.count("Time--") + Line.count("User+System");
+      NameColumn = NumTimeColumns * ColumnWidth + 2;
+      if (Line.contains("---Mem---"))
+        NameColumn += 11;
+      continue;
+    }
+    if (Line.size() <= NameColumn) {
+      InPassGroup = false;
+      continue;
+    }
+    StringRef Name = Line.drop_front(NameColumn);
+    if (Name == "Total") {
+      InPassGroup = false;
+      continue;
+    }
+    StringRef Wall = Line.substr((NumTimeColumns - 1) * ColumnWidth,
+                                 ColumnWidth).ltrim().split(' ').first;
+    double Seconds;
+    if (Wall.getAsDouble(Seconds))
+      continue;
+    PassTimes[stripInstanceNumber(Name)] += Seconds;
+  }
+}
+
+// Collect the arguments given on "; <Prefix>:" lines before the first
+// non-comment line of the input.
+static std::vector<std::string> getInputArgs(StringRef Filename,
+                                             StringRef Prefix) {
+  auto BufferOrErr = MemoryBuffer::getFile(Filename);
+  if (!BufferOrErr)
+    ExitOnErr(errorCodeToError(BufferOrErr.getError()));
+
+  std::vector<std::string> Args;
+  SmallVector<StringRef, 0> Lines;
+  (*BufferOrErr)->getBuffer().split(Lines, '\n');
+  for (StringRef Line : Lines) {
+    Line = Line.trim();
+    if (Line.empty())
+      continue;
+    if (!Line.consume_front(";"))
+      break;
+    Line = Line.ltrim();
+    if (!Line.consume_front(Prefix) || !Line.consume_front(":"))
+      continue;
+    SmallVector<StringRef, 4> Words;
+    Line.split(Words, ' ', -1, /*KeepEmpty=*/false);
+    for (StringRef Word : Words)
+      Args.push_back(Word);
+  }
+  return Args;
+}
+
+// Run the compiler once with -time-passes, counting Event in it and its
+// children when Event is not null.
+static Measurement runOnce(const Benchmark &B, const pfm::PerfEvent *Event) {
+  SmallString<128> ReportPath;
+  ExitOnErr(errorCodeToError(
+      sys::fs::createTemporaryFile("compile-time", "txt", ReportPath)));
+  FileRemover RemoveReport(ReportPath);
+
+  std::string InfoOutput = ("-info-output-file=" + ReportPath).str();
+  SmallVector<StringRef, 16> Args;
+  Args.push_back(B.Program);
+  for (const std::string &Arg : B.Args)
+    Args.push_back(Arg);
+  Args.push_back("-time-passes");
+  Args.push_back(InfoOutput);
+  Optional<StringRef> Redirects[] = {None, StringRef(), None};
+
+  Measurement M;
+  std::unique_ptr<pfm::Counter> Counter;
+  if (Event) {
+    Counter = llvm::make_unique<pfm::Counter>(*Event,
+                                              /*IncludeChildren=*/true);
+    Counter->start();
+  }
+  auto Start = std::chrono::steady_clock::now();
+  std::string ErrMsg;
+  int Result = sys::ExecuteAndWait(B.Program, Args, None, Redirects,
+                                   /*SecondsToWait=*/0, /*MemoryLimit=*/0,
+                                   &ErrMsg);
+  auto End = std::chrono::steady_clock::now();
+  if (Counter) {
+    Counter->stop();
+    M.Instructions = Counter->read();
+  }
+  if (Result != 0)
+    ExitOnErr(make_error<StringError>(
+        B.Name + " failed" + (ErrMsg.empty() ? "" : ": " + ErrMsg),
+        inconvertibleErrorCode()));
+  M.WallTime = std::chrono::duration<double>(End - Start).count();
+
+  auto ReportOrErr = MemoryBuffer::getFile(ReportPath);
+  if (!ReportOrErr)
+    ExitOnErr(errorCodeToError(ReportOrErr.getError()));
+  parsePassTimes((*ReportOrErr)->getBuffer(), M.PassTimes);
+  return M;
+}
+
+// Keep the fastest of the runs; the instruction count is the lowest one seen,
+// as the runs only differ by noise.
+static Measurement run(const Benchmark &B, const pfm::PerfEvent *Event) {
+  Measurement Best = runOnce(B, Event);
+  for (unsigned I = 1; I < Repetitions; ++I) {
+    Measurement M = runOnce(B, Event);
+    int64_t Instructions = std::min(Best.Instructions, M.Instructions);
+    if (M.WallTime < Best.WallTime)
+      Best = std::move(M);
+    Best.Instructions = Instructions;
+  }
+  return Best;
+}
+
+static json::Value toJSON(const Benchmark &B) {
+  json::Object Passes;
+  for (const auto &P : B.Result.PassTimes)
+    Passes[P.getKey()] = P.getValue();
+  json::Object O{{"name", B.Name},
+                 {"wall_time", B.Result.WallTime},
+                 {"passes", std::move(Passes)}};
+  if (B.Result.Instructions >= 0)
+    O["instructions"] = B.Result.Instructions;
+  return std::move(O);
+}
+
+// Print the passes whose time grew the most over the baseline.
+static void printPassDeltas(const Benchmark &B, const json::Object *Baseline) {
+  std::vector<std::pair<double, StringRef>> Deltas;
+  for (const auto &P : B.Result.PassTimes) {
+    double Old = 0;
+    if (Baseline)
+      if (Optional<double> T = Baseline->getNumber(P.getKey()))
+        Old = *T;
+    if (P.getValue() > Old)
+      Deltas.emplace_back(P.getValue() - Old, P.getKey());
+  }
+  llvm::sort(Deltas, [](const std::pair<double, StringRef> &A,
+                        const std::pair<double, StringRef> &B) {
+    return A.first > B.first;
+  });
+  for (const auto &D : makeArrayRef(Deltas).take_front(5))
+    errs() << formatv("    {0,-40} +{1:f4}s\n", D.second, D.first);
+}
+
+// Compare the results with the baseline. The instruction count is compared
+// when both runs have one, as it is much less noisy than the wall time.
+static bool compareToBaseline(ArrayRef<Benchmark> Benchmarks,
+                              const json::Value &Baseline) {
+  StringMap<const json::Object *> BaselineResults;
+  if (const json::Object *Root = Baseline.getAsObject())
+    if (const json::Array *Results = Root->getArray("benchmarks"))
+      for (const json::Value &V : *Results)
+        if (const json::Object *O = V.getAsObject())
+          if (Optional<StringRef> Name = O->getString("name"))
+            BaselineResults[*Name] = O;
+
+  bool Regressed = false;
+  for (const Benchmark &B : Benchmarks) {
+    const json::Object *Old = BaselineResults.lookup(B.Name);
+    if (!Old) {
+      errs() << B.Name << ": not in the baseline\n";
+      continue;
+    }
+    StringRef Metric = "wall_time";
+    double OldValue = Old->getNumber("wall_time").getValueOr(0);
+    double NewValue = B.Result.WallTime;
+    Optional<int64_t> OldInstructions = Old->getInteger("instructions");
+    if (OldInstructions && B.Result.Instructions >= 0) {
+      Metric = "instructions";
+      OldValue = *OldInstructions;
+      NewValue = B.Result.Instructions;
+    }
+    if (OldValue <= 0)
+      continue;
+    double Change = (NewValue - OldValue) * 100 / OldValue;
+    if (Change <= Threshold)
+      continue;
+    Regressed = true;
+    errs() << formatv("{0}: {1} regressed by {2:f1}% ({3} -> {4})\n", B.Name,
+                      Metric, Change, OldValue, NewValue);
+    printPassDeltas(B, Old->getObject("passes"));
+  }
+  return !Regressed;
+}
+
+int main(int argc, char **argv) {
+  InitLLVM X(argc, argv);
+  cl::ParseCommandLineOptions(argc, argv,
+                              "LLVM compile-time regression harness\n");
+
+  std::vector<Benchmark> Benchmarks;
+  for (const std::string &Input : InputFilenames) {
+    StringRef Stem = sys::path::stem(Input);
+    Benchmark Opt{(Stem + ".opt").str(), OptPath, {"-O2"}, {}};
+    for (std::string &Arg : getInputArgs(Input, "OPT-ARGS"))
+      Opt.Args.push_back(std::move(Arg));
+    Opt.Args.insert(Opt.Args.end(), {Input, "-disable-output"});
+    Benchmarks.push_back(std::move(Opt));
+
+    Benchmark Llc{(Stem + ".llc").str(), LlcPath, {"-O2"}, {}};
+    for (std::string &Arg : getInputArgs(Input, "LLC-ARGS"))
+      Llc.Args.push_back(std::move(Arg));
+    Llc.Args.insert(Llc.Args.end(), {Input, "-o", "-"});
+    Benchmarks.push_back(std::move(Llc));
+  }
+
+  // Without libpfm, or on a host where the event is unknown, only the wall
+  // time is recorded.
+  std::unique_ptr<pfm::PerfEvent> Event;
+  bool HavePfm = !pfm::pfmInitialize();
+  if (HavePfm) {
+    Event = llvm::make_unique<pfm::PerfEvent>(CounterName);
+    if (!Event->valid())
+      Event.reset();
+  }
+
+  json::Array Results;
+  for (Benchmark &B : Benchmarks) {
+    B.Result = run(B, Event.get());
+    Results.push_back(toJSON(B));
+  }
+  Event.reset();
+  if (HavePfm)
+    pfm::pfmTerminate();
+
+  std::error_code EC;
+  ToolOutputFile Out(OutputFilename, EC, sys::fs::F_Text);
+  if (EC)
+    ExitOnErr(errorCodeToError(EC));
+  Out.os() << formatv("{0:2}", json::Value(json::Object{
+                                   {"counter", CounterName},
+                                   {"benchmarks", std::move(Results)}}))
+           << '\n';
+  Out.keep();
+
+  if (BaselineFilename.empty())
+    return 0;
+  auto BaselineOrErr = MemoryBuffer::getFile(BaselineFilename);
+  if (!BaselineOrErr)
+    ExitOnErr(errorCodeToError(BaselineOrErr.getError()));
+  json::Value Baseline = ExitOnErr(json::parse((*BaselineOrErr)->getBuffer()));
+  return compareToBaseline(Benchmarks, Baseline) ? 0 : 1;
+}
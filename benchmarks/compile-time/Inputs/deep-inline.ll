@@ -0,0 +1,2169 @@
+; A deep chain of small internal functions, each calling the next one, so
+; the inliner walks a long call chain and the function simplification
+; pipeline runs on every level.
+
+declare void @sink(i32)
+
+define internal i32 @level0(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 3
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 0
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level1(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  call void @sink(i32 %c)
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level1(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 5
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 13
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level2(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level2(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 7
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 26
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level3(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level3(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 9
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 39
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level4(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level4(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 11
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 52
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level5(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level5(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 13
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 65
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level6(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level6(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 15
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 78
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level7(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level7(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 17
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 91
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level8(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level8(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 19
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 104
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level9(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  call void @sink(i32 %c)
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level9(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 21
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 117
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level10(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level10(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 23
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 130
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level11(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level11(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 25
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 143
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level12(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level12(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 27
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 156
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level13(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level13(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 29
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 169
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level14(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level14(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 31
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 182
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level15(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level15(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 33
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 195
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level16(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level16(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 35
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 208
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level17(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  call void @sink(i32 %c)
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level17(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 37
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 221
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level18(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level18(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 39
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 234
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level19(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level19(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 41
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 247
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level20(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level20(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 43
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 260
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level21(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level21(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 45
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 273
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level22(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level22(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 47
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 286
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level23(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level23(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 49
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 299
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level24(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level24(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 51
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 312
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level25(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  call void @sink(i32 %c)
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level25(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 53
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 325
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level26(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level26(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 55
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 338
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level27(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level27(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 57
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 351
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level28(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level28(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 59
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 364
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level29(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level29(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 61
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 377
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level30(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level30(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 63
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 390
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level31(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level31(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 65
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 403
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level32(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level32(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 67
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 416
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level33(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  call void @sink(i32 %c)
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level33(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 69
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 429
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level34(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level34(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 71
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 442
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level35(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level35(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 73
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 455
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level36(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level36(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 75
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 468
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level37(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level37(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 77
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 481
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level38(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level38(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 79
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 494
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level39(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level39(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 81
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 507
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level40(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level40(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 83
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 520
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level41(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  call void @sink(i32 %c)
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level41(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 85
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 533
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level42(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level42(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 87
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 546
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level43(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level43(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 89
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 559
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level44(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level44(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 91
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 572
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level45(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level45(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 93
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 585
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level46(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level46(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 95
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 598
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level47(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level47(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 97
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 611
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level48(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level48(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 99
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 624
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level49(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  call void @sink(i32 %c)
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level49(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 101
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 637
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level50(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level50(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 103
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 650
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level51(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level51(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 105
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 663
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level52(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level52(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 107
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 676
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level53(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level53(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 109
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 689
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level54(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level54(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 111
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 702
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level55(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level55(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 113
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 715
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level56(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level56(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 115
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 728
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level57(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  call void @sink(i32 %c)
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level57(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 117
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 741
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level58(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level58(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 119
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 754
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level59(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level59(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 121
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 767
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level60(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level60(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 123
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 780
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level61(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level61(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 125
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 793
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level62(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level62(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 127
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 806
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level63(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level63(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 129
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 819
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level64(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level64(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 131
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 832
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level65(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  call void @sink(i32 %c)
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level65(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 133
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 845
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level66(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level66(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 135
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 858
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level67(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level67(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 137
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 871
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level68(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level68(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 139
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 884
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level69(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level69(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 141
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 897
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level70(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level70(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 143
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 910
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level71(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level71(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 145
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 923
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level72(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level72(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 147
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 936
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level73(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  call void @sink(i32 %c)
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level73(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 149
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 949
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level74(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level74(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 151
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 962
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level75(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level75(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 153
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 975
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level76(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level76(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 155
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 988
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level77(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level77(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 157
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 1001
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level78(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level78(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 159
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 1014
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level79(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level79(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 161
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 1027
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level80(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level80(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 163
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 1040
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level81(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  call void @sink(i32 %c)
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level81(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 165
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 1053
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level82(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level82(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 167
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 1066
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level83(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level83(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 169
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 1079
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level84(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level84(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 171
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 1092
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level85(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level85(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 173
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 1105
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level86(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level86(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 175
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 1118
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level87(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level87(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 177
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 1131
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level88(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level88(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 179
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 1144
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level89(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  call void @sink(i32 %c)
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level89(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 181
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 1157
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level90(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level90(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 183
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 1170
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level91(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level91(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 185
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 1183
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level92(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level92(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 187
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 1196
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level93(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level93(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 189
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 1209
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level94(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level94(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 191
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 1222
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = call i32 @level95(i32 %c, i32* %p)
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define internal i32 @level95(i32 %x, i32* %p) {
+entry:
+  %a = mul i32 %x, 193
+  %b = load i32, i32* %p, align 4
+  %c = add i32 %a, %b
+  %cmp = icmp slt i32 %c, 1235
+  br i1 %cmp, label %then, label %else
+
+then:
+  %r1 = add i32 %c, 1
+  br label %join
+
+else:
+  store i32 %c, i32* %p, align 4
+  %r2 = sub i32 %c, %x
+  br label %join
+
+join:
+  %r = phi i32 [ %r1, %then ], [ %r2, %else ]
+  ret i32 %r
+}
+
+define i32 @entry0(i32 %x, i32* %p) {
+  %r = call i32 @level0(i32 %x, i32* %p)
+  ret i32 %r
+}
+
+define i32 @entry1(i32 %x, i32* %p) {
+  %r = call i32 @level12(i32 %x, i32* %p)
+  ret i32 %r
+}
+
+define i32 @entry2(i32 %x, i32* %p) {
+  %r = call i32 @level24(i32 %x, i32* %p)
+  ret i32 %r
+}
+
+define i32 @entry3(i32 %x, i32* %p) {
+  %r = call i32 @level36(i32 %x, i32* %p)
+  ret i32 %r
+}
+
+define i32 @entry4(i32 %x, i32* %p) {
+  %r = call i32 @level48(i32 %x, i32* %p)
+  ret i32 %r
+}
+
+define i32 @entry5(i32 %x, i32* %p) {
+  %r = call i32 @level60(i32 %x, i32* %p)
+  ret i32 %r
+}
+
+define i32 @entry6(i32 %x, i32* %p) {
+  %r = call i32 @level72(i32 %x, i32* %p)
+  ret i32 %r
+}
+
+define i32 @entry7(i32 %x, i32* %p) {
+  %r = call i32 @level84(i32 %x, i32* %p)
+  ret i32 %r
+}
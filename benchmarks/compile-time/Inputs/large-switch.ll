@@ -0,0 +1,2434 @@
+; A bytecode interpreter loop dispatching on a switch of 384 cases, the
+; shape that stresses SimplifyCFG, jump threading and switch lowering.
+
+define i64 @interpret(i16* %code, i64 %len, i64* %regs) {
+entry:
+  br label %loop
+
+loop:
+  %pc = phi i64 [ 0, %entry ], [ %pc.next, %latch ]
+  %acc = phi i64 [ 0, %entry ], [ %acc.next, %latch ]
+  %op.addr = getelementptr inbounds i16, i16* %code, i64 %pc
+  %opcode = load i16, i16* %op.addr, align 2
+  %op = zext i16 %opcode to i32
+  %arg.pc = add i64 %pc, 1
+  %arg.addr = getelementptr inbounds i16, i16* %code, i64 %arg.pc
+  %arg16 = load i16, i16* %arg.addr, align 2
+  %arg = zext i16 %arg16 to i64
+  %reg.addr = getelementptr inbounds i64, i64* %regs, i64 %arg
+  %reg = load i64, i64* %reg.addr, align 8
+  switch i32 %op, label %default [
+    i32 0, label %op0
+    i32 3, label %op1
+    i32 6, label %op2
+    i32 9, label %op3
+    i32 12, label %op4
+    i32 15, label %op5
+    i32 18, label %op6
+    i32 21, label %op7
+    i32 24, label %op8
+    i32 27, label %op9
+    i32 30, label %op10
+    i32 33, label %op11
+    i32 36, label %op12
+    i32 39, label %op13
+    i32 42, label %op14
+    i32 45, label %op15
+    i32 48, label %op16
+    i32 51, label %op17
+    i32 54, label %op18
+    i32 57, label %op19
+    i32 60, label %op20
+    i32 63, label %op21
+    i32 66, label %op22
+    i32 69, label %op23
+    i32 72, label %op24
+    i32 75, label %op25
+    i32 78, label %op26
+    i32 81, label %op27
+    i32 84, label %op28
+    i32 87, label %op29
+    i32 90, label %op30
+    i32 93, label %op31
+    i32 96, label %op32
+    i32 99, label %op33
+    i32 102, label %op34
+    i32 105, label %op35
+    i32 108, label %op36
+    i32 111, label %op37
+    i32 114, label %op38
+    i32 117, label %op39
+    i32 120, label %op40
+    i32 123, label %op41
+    i32 126, label %op42
+    i32 129, label %op43
+    i32 132, label %op44
+    i32 135, label %op45
+    i32 138, label %op46
+    i32 141, label %op47
+    i32 144, label %op48
+    i32 147, label %op49
+    i32 150, label %op50
+    i32 153, label %op51
+    i32 156, label %op52
+    i32 159, label %op53
+    i32 162, label %op54
+    i32 165, label %op55
+    i32 168, label %op56
+    i32 171, label %op57
+    i32 174, label %op58
+    i32 177, label %op59
+    i32 180, label %op60
+    i32 183, label %op61
+    i32 186, label %op62
+    i32 189, label %op63
+    i32 192, label %op64
+    i32 195, label %op65
+    i32 198, label %op66
+    i32 201, label %op67
+    i32 204, label %op68
+    i32 207, label %op69
+    i32 210, label %op70
+    i32 213, label %op71
+    i32 216, label %op72
+    i32 219, label %op73
+    i32 222, label %op74
+    i32 225, label %op75
+    i32 228, label %op76
+    i32 231, label %op77
+    i32 234, label %op78
+    i32 237, label %op79
+    i32 240, label %op80
+    i32 243, label %op81
+    i32 246, label %op82
+    i32 249, label %op83
+    i32 252, label %op84
+    i32 255, label %op85
+    i32 258, label %op86
+    i32 261, label %op87
+    i32 264, label %op88
+    i32 267, label %op89
+    i32 270, label %op90
+    i32 273, label %op91
+    i32 276, label %op92
+    i32 279, label %op93
+    i32 282, label %op94
+    i32 285, label %op95
+    i32 288, label %op96
+    i32 291, label %op97
+    i32 294, label %op98
+    i32 297, label %op99
+    i32 300, label %op100
+    i32 303, label %op101
+    i32 306, label %op102
+    i32 309, label %op103
+    i32 312, label %op104
+    i32 315, label %op105
+    i32 318, label %op106
+    i32 321, label %op107
+    i32 324, label %op108
+    i32 327, label %op109
+    i32 330, label %op110
+    i32 333, label %op111
+    i32 336, label %op112
+    i32 339, label %op113
+    i32 342, label %op114
+    i32 345, label %op115
+    i32 348, label %op116
+    i32 351, label %op117
+    i32 354, label %op118
+    i32 357, label %op119
+    i32 360, label %op120
+    i32 363, label %op121
+    i32 366, label %op122
+    i32 369, label %op123
+    i32 372, label %op124
+    i32 375, label %op125
+    i32 378, label %op126
+    i32 381, label %op127
+    i32 384, label %op128
+    i32 387, label %op129
+    i32 390, label %op130
+    i32 393, label %op131
+    i32 396, label %op132
+    i32 399, label %op133
+    i32 402, label %op134
+    i32 405, label %op135
+    i32 408, label %op136
+    i32 411, label %op137
+    i32 414, label %op138
+    i32 417, label %op139
+    i32 420, label %op140
+    i32 423, label %op141
+    i32 426, label %op142
+    i32 429, label %op143
+    i32 432, label %op144
+    i32 435, label %op145
+    i32 438, label %op146
+    i32 441, label %op147
+    i32 444, label %op148
+    i32 447, label %op149
+    i32 450, label %op150
+    i32 453, label %op151
+    i32 456, label %op152
+    i32 459, label %op153
+    i32 462, label %op154
+    i32 465, label %op155
+    i32 468, label %op156
+    i32 471, label %op157
+    i32 474, label %op158
+    i32 477, label %op159
+    i32 480, label %op160
+    i32 483, label %op161
+    i32 486, label %op162
+    i32 489, label %op163
+    i32 492, label %op164
+    i32 495, label %op165
+    i32 498, label %op166
+    i32 501, label %op167
+    i32 504, label %op168
+    i32 507, label %op169
+    i32 510, label %op170
+    i32 513, label %op171
+    i32 516, label %op172
+    i32 519, label %op173
+    i32 522, label %op174
+    i32 525, label %op175
+    i32 528, label %op176
+    i32 531, label %op177
+    i32 534, label %op178
+    i32 537, label %op179
+    i32 540, label %op180
+    i32 543, label %op181
+    i32 546, label %op182
+    i32 549, label %op183
+    i32 552, label %op184
+    i32 555, label %op185
+    i32 558, label %op186
+    i32 561, label %op187
+    i32 564, label %op188
+    i32 567, label %op189
+    i32 570, label %op190
+    i32 573, label %op191
+    i32 576, label %op192
+    i32 579, label %op193
+    i32 582, label %op194
+    i32 585, label %op195
+    i32 588, label %op196
+    i32 591, label %op197
+    i32 594, label %op198
+    i32 597, label %op199
+    i32 600, label %op200
+    i32 603, label %op201
+    i32 606, label %op202
+    i32 609, label %op203
+    i32 612, label %op204
+    i32 615, label %op205
+    i32 618, label %op206
+    i32 621, label %op207
+    i32 624, label %op208
+    i32 627, label %op209
+    i32 630, label %op210
+    i32 633, label %op211
+    i32 636, label %op212
+    i32 639, label %op213
+    i32 642, label %op214
+    i32 645, label %op215
+    i32 648, label %op216
+    i32 651, label %op217
+    i32 654, label %op218
+    i32 657, label %op219
+    i32 660, label %op220
+    i32 663, label %op221
+    i32 666, label %op222
+    i32 669, label %op223
+    i32 672, label %op224
+    i32 675, label %op225
+    i32 678, label %op226
+    i32 681, label %op227
+    i32 684, label %op228
+    i32 687, label %op229
+    i32 690, label %op230
+    i32 693, label %op231
+    i32 696, label %op232
+    i32 699, label %op233
+    i32 702, label %op234
+    i32 705, label %op235
+    i32 708, label %op236
+    i32 711, label %op237
+    i32 714, label %op238
+    i32 717, label %op239
+    i32 720, label %op240
+    i32 723, label %op241
+    i32 726, label %op242
+    i32 729, label %op243
+    i32 732, label %op244
+    i32 735, label %op245
+    i32 738, label %op246
+    i32 741, label %op247
+    i32 744, label %op248
+    i32 747, label %op249
+    i32 750, label %op250
+    i32 753, label %op251
+    i32 756, label %op252
+    i32 759, label %op253
+    i32 762, label %op254
+    i32 765, label %op255
+    i32 768, label %op256
+    i32 771, label %op257
+    i32 774, label %op258
+    i32 777, label %op259
+    i32 780, label %op260
+    i32 783, label %op261
+    i32 786, label %op262
+    i32 789, label %op263
+    i32 792, label %op264
+    i32 795, label %op265
+    i32 798, label %op266
+    i32 801, label %op267
+    i32 804, label %op268
+    i32 807, label %op269
+    i32 810, label %op270
+    i32 813, label %op271
+    i32 816, label %op272
+    i32 819, label %op273
+    i32 822, label %op274
+    i32 825, label %op275
+    i32 828, label %op276
+    i32 831, label %op277
+    i32 834, label %op278
+    i32 837, label %op279
+    i32 840, label %op280
+    i32 843, label %op281
+    i32 846, label %op282
+    i32 849, label %op283
+    i32 852, label %op284
+    i32 855, label %op285
+    i32 858, label %op286
+    i32 861, label %op287
+    i32 864, label %op288
+    i32 867, label %op289
+    i32 870, label %op290
+    i32 873, label %op291
+    i32 876, label %op292
+    i32 879, label %op293
+    i32 882, label %op294
+    i32 885, label %op295
+    i32 888, label %op296
+    i32 891, label %op297
+    i32 894, label %op298
+    i32 897, label %op299
+    i32 900, label %op300
+    i32 903, label %op301
+    i32 906, label %op302
+    i32 909, label %op303
+    i32 912, label %op304
+    i32 915, label %op305
+    i32 918, label %op306
+    i32 921, label %op307
+    i32 924, label %op308
+    i32 927, label %op309
+    i32 930, label %op310
+    i32 933, label %op311
+    i32 936, label %op312
+    i32 939, label %op313
+    i32 942, label %op314
+    i32 945, label %op315
+    i32 948, label %op316
+    i32 951, label %op317
+    i32 954, label %op318
+    i32 957, label %op319
+    i32 960, label %op320
+    i32 963, label %op321
+    i32 966, label %op322
+    i32 969, label %op323
+    i32 972, label %op324
+    i32 975, label %op325
+    i32 978, label %op326
+    i32 981, label %op327
+    i32 984, label %op328
+    i32 987, label %op329
+    i32 990, label %op330
+    i32 993, label %op331
+    i32 996, label %op332
+    i32 999, label %op333
+    i32 1002, label %op334
+    i32 1005, label %op335
+    i32 1008, label %op336
+    i32 1011, label %op337
+    i32 1014, label %op338
+    i32 1017, label %op339
+    i32 1020, label %op340
+    i32 2, label %op341
+    i32 5, label %op342
+    i32 8, label %op343
+    i32 11, label %op344
+    i32 14, label %op345
+    i32 17, label %op346
+    i32 20, label %op347
+    i32 23, label %op348
+    i32 26, label %op349
+    i32 29, label %op350
+    i32 32, label %op351
+    i32 35, label %op352
+    i32 38, label %op353
+    i32 41, label %op354
+    i32 44, label %op355
+    i32 47, label %op356
+    i32 50, label %op357
+    i32 53, label %op358
+    i32 56, label %op359
+    i32 59, label %op360
+    i32 62, label %op361
+    i32 65, label %op362
+    i32 68, label %op363
+    i32 71, label %op364
+    i32 74, label %op365
+    i32 77, label %op366
+    i32 80, label %op367
+    i32 83, label %op368
+    i32 86, label %op369
+    i32 89, label %op370
+    i32 92, label %op371
+    i32 95, label %op372
+    i32 98, label %op373
+    i32 101, label %op374
+    i32 104, label %op375
+    i32 107, label %op376
+    i32 110, label %op377
+    i32 113, label %op378
+    i32 116, label %op379
+    i32 119, label %op380
+    i32 122, label %op381
+    i32 125, label %op382
+    i32 128, label %op383
+  ]
+
+op0:
+  %v0.0 = add i64 %reg, 3
+  %v0 = add i64 %acc, %v0.0
+  store i64 %v0, i64* %reg.addr, align 8
+  br label %latch
+
+op1:
+  %v1.0 = sub i64 %reg, 10
+  %v1 = add i64 %acc, %v1.0
+  br label %latch
+
+op2:
+  %v2.0 = mul i64 %reg, 17
+  %v2 = add i64 %acc, %v2.0
+  br label %latch
+
+op3:
+  %v3.0 = xor i64 %reg, 24
+  %v3 = add i64 %acc, %v3.0
+  br label %latch
+
+op4:
+  %v4.0 = and i64 %reg, 31
+  %v4 = add i64 %acc, %v4.0
+  store i64 %v4, i64* %reg.addr, align 8
+  br label %latch
+
+op5:
+  %v5.0 = or i64 %reg, 38
+  %v5 = add i64 %acc, %v5.0
+  br label %latch
+
+op6:
+  %v6.0 = shl i64 %reg, 7
+  %v6 = add i64 %acc, %v6.0
+  br label %latch
+
+op7:
+  %v7.0 = lshr i64 %reg, 8
+  %v7 = add i64 %acc, %v7.0
+  br label %latch
+
+op8:
+  %v8.0 = add i64 %reg, 59
+  %v8 = add i64 %acc, %v8.0
+  store i64 %v8, i64* %reg.addr, align 8
+  br label %latch
+
+op9:
+  %v9.0 = sub i64 %reg, 66
+  %v9 = add i64 %acc, %v9.0
+  br label %latch
+
+op10:
+  %v10.0 = mul i64 %reg, 73
+  %v10 = add i64 %acc, %v10.0
+  br label %latch
+
+op11:
+  %v11.0 = xor i64 %reg, 80
+  %v11 = add i64 %acc, %v11.0
+  br label %latch
+
+op12:
+  %v12.0 = and i64 %reg, 87
+  %v12 = add i64 %acc, %v12.0
+  store i64 %v12, i64* %reg.addr, align 8
+  br label %latch
+
+op13:
+  %v13.0 = or i64 %reg, 94
+  %v13 = add i64 %acc, %v13.0
+  br label %latch
+
+op14:
+  %v14.0 = shl i64 %reg, 15
+  %v14 = add i64 %acc, %v14.0
+  br label %latch
+
+op15:
+  %v15.0 = lshr i64 %reg, 16
+  %v15 = add i64 %acc, %v15.0
+  br label %latch
+
+op16:
+  %v16.0 = add i64 %reg, 115
+  %v16 = add i64 %acc, %v16.0
+  store i64 %v16, i64* %reg.addr, align 8
+  br label %latch
+
+op17:
+  %v17.0 = sub i64 %reg, 122
+  %v17 = add i64 %acc, %v17.0
+  br label %latch
+
+op18:
+  %v18.0 = mul i64 %reg, 129
+  %v18 = add i64 %acc, %v18.0
+  br label %latch
+
+op19:
+  %v19.0 = xor i64 %reg, 136
+  %v19 = add i64 %acc, %v19.0
+  br label %latch
+
+op20:
+  %v20.0 = and i64 %reg, 143
+  %v20 = add i64 %acc, %v20.0
+  store i64 %v20, i64* %reg.addr, align 8
+  br label %latch
+
+op21:
+  %v21.0 = or i64 %reg, 150
+  %v21 = add i64 %acc, %v21.0
+  br label %latch
+
+op22:
+  %v22.0 = shl i64 %reg, 23
+  %v22 = add i64 %acc, %v22.0
+  br label %latch
+
+op23:
+  %v23.0 = lshr i64 %reg, 24
+  %v23 = add i64 %acc, %v23.0
+  br label %latch
+
+op24:
+  %v24.0 = add i64 %reg, 171
+  %v24 = add i64 %acc, %v24.0
+  store i64 %v24, i64* %reg.addr, align 8
+  br label %latch
+
+op25:
+  %v25.0 = sub i64 %reg, 178
+  %v25 = add i64 %acc, %v25.0
+  br label %latch
+
+op26:
+  %v26.0 = mul i64 %reg, 185
+  %v26 = add i64 %acc, %v26.0
+  br label %latch
+
+op27:
+  %v27.0 = xor i64 %reg, 192
+  %v27 = add i64 %acc, %v27.0
+  br label %latch
+
+op28:
+  %v28.0 = and i64 %reg, 199
+  %v28 = add i64 %acc, %v28.0
+  store i64 %v28, i64* %reg.addr, align 8
+  br label %latch
+
+op29:
+  %v29.0 = or i64 %reg, 206
+  %v29 = add i64 %acc, %v29.0
+  br label %latch
+
+op30:
+  %v30.0 = shl i64 %reg, 31
+  %v30 = add i64 %acc, %v30.0
+  br label %latch
+
+op31:
+  %v31.0 = lshr i64 %reg, 32
+  %v31 = add i64 %acc, %v31.0
+  br label %latch
+
+op32:
+  %v32.0 = add i64 %reg, 227
+  %v32 = add i64 %acc, %v32.0
+  store i64 %v32, i64* %reg.addr, align 8
+  br label %latch
+
+op33:
+  %v33.0 = sub i64 %reg, 234
+  %v33 = add i64 %acc, %v33.0
+  br label %latch
+
+op34:
+  %v34.0 = mul i64 %reg, 241
+  %v34 = add i64 %acc, %v34.0
+  br label %latch
+
+op35:
+  %v35.0 = xor i64 %reg, 248
+  %v35 = add i64 %acc, %v35.0
+  br label %latch
+
+op36:
+  %v36.0 = and i64 %reg, 255
+  %v36 = add i64 %acc, %v36.0
+  store i64 %v36, i64* %reg.addr, align 8
+  br label %latch
+
+op37:
+  %v37.0 = or i64 %reg, 262
+  %v37 = add i64 %acc, %v37.0
+  br label %latch
+
+op38:
+  %v38.0 = shl i64 %reg, 39
+  %v38 = add i64 %acc, %v38.0
+  br label %latch
+
+op39:
+  %v39.0 = lshr i64 %reg, 40
+  %v39 = add i64 %acc, %v39.0
+  br label %latch
+
+op40:
+  %v40.0 = add i64 %reg, 283
+  %v40 = add i64 %acc, %v40.0
+  store i64 %v40, i64* %reg.addr, align 8
+  br label %latch
+
+op41:
+  %v41.0 = sub i64 %reg, 290
+  %v41 = add i64 %acc, %v41.0
+  br label %latch
+
+op42:
+  %v42.0 = mul i64 %reg, 297
+  %v42 = add i64 %acc, %v42.0
+  br label %latch
+
+op43:
+  %v43.0 = xor i64 %reg, 304
+  %v43 = add i64 %acc, %v43.0
+  br label %latch
+
+op44:
+  %v44.0 = and i64 %reg, 311
+  %v44 = add i64 %acc, %v44.0
+  store i64 %v44, i64* %reg.addr, align 8
+  br label %latch
+
+op45:
+  %v45.0 = or i64 %reg, 318
+  %v45 = add i64 %acc, %v45.0
+  br label %latch
+
+op46:
+  %v46.0 = shl i64 %reg, 47
+  %v46 = add i64 %acc, %v46.0
+  br label %latch
+
+op47:
+  %v47.0 = lshr i64 %reg, 48
+  %v47 = add i64 %acc, %v47.0
+  br label %latch
+
+op48:
+  %v48.0 = add i64 %reg, 339
+  %v48 = add i64 %acc, %v48.0
+  store i64 %v48, i64* %reg.addr, align 8
+  br label %latch
+
+op49:
+  %v49.0 = sub i64 %reg, 346
+  %v49 = add i64 %acc, %v49.0
+  br label %latch
+
+op50:
+  %v50.0 = mul i64 %reg, 353
+  %v50 = add i64 %acc, %v50.0
+  br label %latch
+
+op51:
+  %v51.0 = xor i64 %reg, 360
+  %v51 = add i64 %acc, %v51.0
+  br label %latch
+
+op52:
+  %v52.0 = and i64 %reg, 367
+  %v52 = add i64 %acc, %v52.0
+  store i64 %v52, i64* %reg.addr, align 8
+  br label %latch
+
+op53:
+  %v53.0 = or i64 %reg, 374
+  %v53 = add i64 %acc, %v53.0
+  br label %latch
+
+op54:
+  %v54.0 = shl i64 %reg, 55
+  %v54 = add i64 %acc, %v54.0
+  br label %latch
+
+op55:
+  %v55.0 = lshr i64 %reg, 56
+  %v55 = add i64 %acc, %v55.0
+  br label %latch
+
+op56:
+  %v56.0 = add i64 %reg, 395
+  %v56 = add i64 %acc, %v56.0
+  store i64 %v56, i64* %reg.addr, align 8
+  br label %latch
+
+op57:
+  %v57.0 = sub i64 %reg, 402
+  %v57 = add i64 %acc, %v57.0
+  br label %latch
+
+op58:
+  %v58.0 = mul i64 %reg, 409
+  %v58 = add i64 %acc, %v58.0
+  br label %latch
+
+op59:
+  %v59.0 = xor i64 %reg, 416
+  %v59 = add i64 %acc, %v59.0
+  br label %latch
+
+op60:
+  %v60.0 = and i64 %reg, 423
+  %v60 = add i64 %acc, %v60.0
+  store i64 %v60, i64* %reg.addr, align 8
+  br label %latch
+
+op61:
+  %v61.0 = or i64 %reg, 430
+  %v61 = add i64 %acc, %v61.0
+  br label %latch
+
+op62:
+  %v62.0 = shl i64 %reg, 63
+  %v62 = add i64 %acc, %v62.0
+  br label %latch
+
+op63:
+  %v63.0 = lshr i64 %reg, 1
+  %v63 = add i64 %acc, %v63.0
+  br label %latch
+
+op64:
+  %v64.0 = add i64 %reg, 451
+  %v64 = add i64 %acc, %v64.0
+  store i64 %v64, i64* %reg.addr, align 8
+  br label %latch
+
+op65:
+  %v65.0 = sub i64 %reg, 458
+  %v65 = add i64 %acc, %v65.0
+  br label %latch
+
+op66:
+  %v66.0 = mul i64 %reg, 465
+  %v66 = add i64 %acc, %v66.0
+  br label %latch
+
+op67:
+  %v67.0 = xor i64 %reg, 472
+  %v67 = add i64 %acc, %v67.0
+  br label %latch
+
+op68:
+  %v68.0 = and i64 %reg, 479
+  %v68 = add i64 %acc, %v68.0
+  store i64 %v68, i64* %reg.addr, align 8
+  br label %latch
+
+op69:
+  %v69.0 = or i64 %reg, 486
+  %v69 = add i64 %acc, %v69.0
+  br label %latch
+
+op70:
+  %v70.0 = shl i64 %reg, 8
+  %v70 = add i64 %acc, %v70.0
+  br label %latch
+
+op71:
+  %v71.0 = lshr i64 %reg, 9
+  %v71 = add i64 %acc, %v71.0
+  br label %latch
+
+op72:
+  %v72.0 = add i64 %reg, 507
+  %v72 = add i64 %acc, %v72.0
+  store i64 %v72, i64* %reg.addr, align 8
+  br label %latch
+
+op73:
+  %v73.0 = sub i64 %reg, 514
+  %v73 = add i64 %acc, %v73.0
+  br label %latch
+
+op74:
+  %v74.0 = mul i64 %reg, 521
+  %v74 = add i64 %acc, %v74.0
+  br label %latch
+
+op75:
+  %v75.0 = xor i64 %reg, 528
+  %v75 = add i64 %acc, %v75.0
+  br label %latch
+
+op76:
+  %v76.0 = and i64 %reg, 535
+  %v76 = add i64 %acc, %v76.0
+  store i64 %v76, i64* %reg.addr, align 8
+  br label %latch
+
+op77:
+  %v77.0 = or i64 %reg, 542
+  %v77 = add i64 %acc, %v77.0
+  br label %latch
+
+op78:
+  %v78.0 = shl i64 %reg, 16
+  %v78 = add i64 %acc, %v78.0
+  br label %latch
+
+op79:
+  %v79.0 = lshr i64 %reg, 17
+  %v79 = add i64 %acc, %v79.0
+  br label %latch
+
+op80:
+  %v80.0 = add i64 %reg, 563
+  %v80 = add i64 %acc, %v80.0
+  store i64 %v80, i64* %reg.addr, align 8
+  br label %latch
+
+op81:
+  %v81.0 = sub i64 %reg, 570
+  %v81 = add i64 %acc, %v81.0
+  br label %latch
+
+op82:
+  %v82.0 = mul i64 %reg, 577
+  %v82 = add i64 %acc, %v82.0
+  br label %latch
+
+op83:
+  %v83.0 = xor i64 %reg, 584
+  %v83 = add i64 %acc, %v83.0
+  br label %latch
+
+op84:
+  %v84.0 = and i64 %reg, 591
+  %v84 = add i64 %acc, %v84.0
+  store i64 %v84, i64* %reg.addr, align 8
+  br label %latch
+
+op85:
+  %v85.0 = or i64 %reg, 598
+  %v85 = add i64 %acc, %v85.0
+  br label %latch
+
+op86:
+  %v86.0 = shl i64 %reg, 24
+  %v86 = add i64 %acc, %v86.0
+  br label %latch
+
+op87:
+  %v87.0 = lshr i64 %reg, 25
+  %v87 = add i64 %acc, %v87.0
+  br label %latch
+
+op88:
+  %v88.0 = add i64 %reg, 619
+  %v88 = add i64 %acc, %v88.0
+  store i64 %v88, i64* %reg.addr, align 8
+  br label %latch
+
+op89:
+  %v89.0 = sub i64 %reg, 626
+  %v89 = add i64 %acc, %v89.0
+  br label %latch
+
+op90:
+  %v90.0 = mul i64 %reg, 633
+  %v90 = add i64 %acc, %v90.0
+  br label %latch
+
+op91:
+  %v91.0 = xor i64 %reg, 640
+  %v91 = add i64 %acc, %v91.0
+  br label %latch
+
+op92:
+  %v92.0 = and i64 %reg, 647
+  %v92 = add i64 %acc, %v92.0
+  store i64 %v92, i64* %reg.addr, align 8
+  br label %latch
+
+op93:
+  %v93.0 = or i64 %reg, 654
+  %v93 = add i64 %acc, %v93.0
+  br label %latch
+
+op94:
+  %v94.0 = shl i64 %reg, 32
+  %v94 = add i64 %acc, %v94.0
+  br label %latch
+
+op95:
+  %v95.0 = lshr i64 %reg, 33
+  %v95 = add i64 %acc, %v95.0
+  br label %latch
+
+op96:
+  %v96.0 = add i64 %reg, 675
+  %v96 = add i64 %acc, %v96.0
+  store i64 %v96, i64* %reg.addr, align 8
+  br label %latch
+
+op97:
+  %v97.0 = sub i64 %reg, 682
+  %v97 = add i64 %acc, %v97.0
+  br label %latch
+
+op98:
+  %v98.0 = mul i64 %reg, 689
+  %v98 = add i64 %acc, %v98.0
+  br label %latch
+
+op99:
+  %v99.0 = xor i64 %reg, 696
+  %v99 = add i64 %acc, %v99.0
+  br label %latch
+
+op100:
+  %v100.0 = and i64 %reg, 703
+  %v100 = add i64 %acc, %v100.0
+  store i64 %v100, i64* %reg.addr, align 8
+  br label %latch
+
+op101:
+  %v101.0 = or i64 %reg, 710
+  %v101 = add i64 %acc, %v101.0
+  br label %latch
+
+op102:
+  %v102.0 = shl i64 %reg, 40
+  %v102 = add i64 %acc, %v102.0
+  br label %latch
+
+op103:
+  %v103.0 = lshr i64 %reg, 41
+  %v103 = add i64 %acc, %v103.0
+  br label %latch
+
+op104:
+  %v104.0 = add i64 %reg, 731
+  %v104 = add i64 %acc, %v104.0
+  store i64 %v104, i64* %reg.addr, align 8
+  br label %latch
+
+op105:
+  %v105.0 = sub i64 %reg, 738
+  %v105 = add i64 %acc, %v105.0
+  br label %latch
+
+op106:
+  %v106.0 = mul i64 %reg, 745
+  %v106 = add i64 %acc, %v106.0
+  br label %latch
+
+op107:
+  %v107.0 = xor i64 %reg, 752
+  %v107 = add i64 %acc, %v107.0
+  br label %latch
+
+op108:
+  %v108.0 = and i64 %reg, 759
+  %v108 = add i64 %acc, %v108.0
+  store i64 %v108, i64* %reg.addr, align 8
+  br label %latch
+
+op109:
+  %v109.0 = or i64 %reg, 766
+  %v109 = add i64 %acc, %v109.0
+  br label %latch
+
+op110:
+  %v110.0 = shl i64 %reg, 48
+  %v110 = add i64 %acc, %v110.0
+  br label %latch
+
+op111:
+  %v111.0 = lshr i64 %reg, 49
+  %v111 = add i64 %acc, %v111.0
+  br label %latch
+
+op112:
+  %v112.0 = add i64 %reg, 787
+  %v112 = add i64 %acc, %v112.0
+  store i64 %v112, i64* %reg.addr, align 8
+  br label %latch
+
+op113:
+  %v113.0 = sub i64 %reg, 794
+  %v113 = add i64 %acc, %v113.0
+  br label %latch
+
+op114:
+  %v114.0 = mul i64 %reg, 801
+  %v114 = add i64 %acc, %v114.0
+  br label %latch
+
+op115:
+  %v115.0 = xor i64 %reg, 808
+  %v115 = add i64 %acc, %v115.0
+  br label %latch
+
+op116:
+  %v116.0 = and i64 %reg, 815
+  %v116 = add i64 %acc, %v116.0
+  store i64 %v116, i64* %reg.addr, align 8
+  br label %latch
+
+op117:
+  %v117.0 = or i64 %reg, 822
+  %v117 = add i64 %acc, %v117.0
+  br label %latch
+
+op118:
+  %v118.0 = shl i64 %reg, 56
+  %v118 = add i64 %acc, %v118.0
+  br label %latch
+
+op119:
+  %v119.0 = lshr i64 %reg, 57
+  %v119 = add i64 %acc, %v119.0
+  br label %latch
+
+op120:
+  %v120.0 = add i64 %reg, 843
+  %v120 = add i64 %acc, %v120.0
+  store i64 %v120, i64* %reg.addr, align 8
+  br label %latch
+
+op121:
+  %v121.0 = sub i64 %reg, 850
+  %v121 = add i64 %acc, %v121.0
+  br label %latch
+
+op122:
+  %v122.0 = mul i64 %reg, 857
+  %v122 = add i64 %acc, %v122.0
+  br label %latch
+
+op123:
+  %v123.0 = xor i64 %reg, 864
+  %v123 = add i64 %acc, %v123.0
+  br label %latch
+
+op124:
+  %v124.0 = and i64 %reg, 871
+  %v124 = add i64 %acc, %v124.0
+  store i64 %v124, i64* %reg.addr, align 8
+  br label %latch
+
+op125:
+  %v125.0 = or i64 %reg, 878
+  %v125 = add i64 %acc, %v125.0
+  br label %latch
+
+op126:
+  %v126.0 = shl i64 %reg, 1
+  %v126 = add i64 %acc, %v126.0
+  br label %latch
+
+op127:
+  %v127.0 = lshr i64 %reg, 2
+  %v127 = add i64 %acc, %v127.0
+  br label %latch
+
+op128:
+  %v128.0 = add i64 %reg, 899
+  %v128 = add i64 %acc, %v128.0
+  store i64 %v128, i64* %reg.addr, align 8
+  br label %latch
+
+op129:
+  %v129.0 = sub i64 %reg, 906
+  %v129 = add i64 %acc, %v129.0
+  br label %latch
+
+op130:
+  %v130.0 = mul i64 %reg, 913
+  %v130 = add i64 %acc, %v130.0
+  br label %latch
+
+op131:
+  %v131.0 = xor i64 %reg, 920
+  %v131 = add i64 %acc, %v131.0
+  br label %latch
+
+op132:
+  %v132.0 = and i64 %reg, 927
+  %v132 = add i64 %acc, %v132.0
+  store i64 %v132, i64* %reg.addr, align 8
+  br label %latch
+
+op133:
+  %v133.0 = or i64 %reg, 934
+  %v133 = add i64 %acc, %v133.0
+  br label %latch
+
+op134:
+  %v134.0 = shl i64 %reg, 9
+  %v134 = add i64 %acc, %v134.0
+  br label %latch
+
+op135:
+  %v135.0 = lshr i64 %reg, 10
+  %v135 = add i64 %acc, %v135.0
+  br label %latch
+
+op136:
+  %v136.0 = add i64 %reg, 955
+  %v136 = add i64 %acc, %v136.0
+  store i64 %v136, i64* %reg.addr, align 8
+  br label %latch
+
+op137:
+  %v137.0 = sub i64 %reg, 962
+  %v137 = add i64 %acc, %v137.0
+  br label %latch
+
+op138:
+  %v138.0 = mul i64 %reg, 969
+  %v138 = add i64 %acc, %v138.0
+  br label %latch
+
+op139:
+  %v139.0 = xor i64 %reg, 976
+  %v139 = add i64 %acc, %v139.0
+  br label %latch
+
+op140:
+  %v140.0 = and i64 %reg, 983
+  %v140 = add i64 %acc, %v140.0
+  store i64 %v140, i64* %reg.addr, align 8
+  br label %latch
+
+op141:
+  %v141.0 = or i64 %reg, 990
+  %v141 = add i64 %acc, %v141.0
+  br label %latch
+
+op142:
+  %v142.0 = shl i64 %reg, 17
+  %v142 = add i64 %acc, %v142.0
+  br label %latch
+
+op143:
+  %v143.0 = lshr i64 %reg, 18
+  %v143 = add i64 %acc, %v143.0
+  br label %latch
+
+op144:
+  %v144.0 = add i64 %reg, 1011
+  %v144 = add i64 %acc, %v144.0
+  store i64 %v144, i64* %reg.addr, align 8
+  br label %latch
+
+op145:
+  %v145.0 = sub i64 %reg, 1018
+  %v145 = add i64 %acc, %v145.0
+  br label %latch
+
+op146:
+  %v146.0 = mul i64 %reg, 1025
+  %v146 = add i64 %acc, %v146.0
+  br label %latch
+
+op147:
+  %v147.0 = xor i64 %reg, 1032
+  %v147 = add i64 %acc, %v147.0
+  br label %latch
+
+op148:
+  %v148.0 = and i64 %reg, 1039
+  %v148 = add i64 %acc, %v148.0
+  store i64 %v148, i64* %reg.addr, align 8
+  br label %latch
+
+op149:
+  %v149.0 = or i64 %reg, 1046
+  %v149 = add i64 %acc, %v149.0
+  br label %latch
+
+op150:
+  %v150.0 = shl i64 %reg, 25
+  %v150 = add i64 %acc, %v150.0
+  br label %latch
+
+op151:
+  %v151.0 = lshr i64 %reg, 26
+  %v151 = add i64 %acc, %v151.0
+  br label %latch
+
+op152:
+  %v152.0 = add i64 %reg, 1067
+  %v152 = add i64 %acc, %v152.0
+  store i64 %v152, i64* %reg.addr, align 8
+  br label %latch
+
+op153:
+  %v153.0 = sub i64 %reg, 1074
+  %v153 = add i64 %acc, %v153.0
+  br label %latch
+
+op154:
+  %v154.0 = mul i64 %reg, 1081
+  %v154 = add i64 %acc, %v154.0
+  br label %latch
+
+op155:
+  %v155.0 = xor i64 %reg, 1088
+  %v155 = add i64 %acc, %v155.0
+  br label %latch
+
+op156:
+  %v156.0 = and i64 %reg, 1095
+  %v156 = add i64 %acc, %v156.0
+  store i64 %v156, i64* %reg.addr, align 8
+  br label %latch
+
+op157:
+  %v157.0 = or i64 %reg, 1102
+  %v157 = add i64 %acc, %v157.0
+  br label %latch
+
+op158:
+  %v158.0 = shl i64 %reg, 33
+  %v158 = add i64 %acc, %v158.0
+  br label %latch
+
+op159:
+  %v159.0 = lshr i64 %reg, 34
+  %v159 = add i64 %acc, %v159.0
+  br label %latch
+
+op160:
+  %v160.0 = add i64 %reg, 1123
+  %v160 = add i64 %acc, %v160.0
+  store i64 %v160, i64* %reg.addr, align 8
+  br label %latch
+
+op161:
+  %v161.0 = sub i64 %reg, 1130
+  %v161 = add i64 %acc, %v161.0
+  br label %latch
+
+op162:
+  %v162.0 = mul i64 %reg, 1137
+  %v162 = add i64 %acc, %v162.0
+  br label %latch
+
+op163:
+  %v163.0 = xor i64 %reg, 1144
+  %v163 = add i64 %acc, %v163.0
+  br label %latch
+
+op164:
+  %v164.0 = and i64 %reg, 1151
+  %v164 = add i64 %acc, %v164.0
+  store i64 %v164, i64* %reg.addr, align 8
+  br label %latch
+
+op165:
+  %v165.0 = or i64 %reg, 1158
+  %v165 = add i64 %acc, %v165.0
+  br label %latch
+
+op166:
+  %v166.0 = shl i64 %reg, 41
+  %v166 = add i64 %acc, %v166.0
+  br label %latch
+
+op167:
+  %v167.0 = lshr i64 %reg, 42
+  %v167 = add i64 %acc, %v167.0
+  br label %latch
+
+op168:
+  %v168.0 = add i64 %reg, 1179
+  %v168 = add i64 %acc, %v168.0
+  store i64 %v168, i64* %reg.addr, align 8
+  br label %latch
+
+op169:
+  %v169.0 = sub i64 %reg, 1186
+  %v169 = add i64 %acc, %v169.0
+  br label %latch
+
+op170:
+  %v170.0 = mul i64 %reg, 1193
+  %v170 = add i64 %acc, %v170.0
+  br label %latch
+
+op171:
+  %v171.0 = xor i64 %reg, 1200
+  %v171 = add i64 %acc, %v171.0
+  br label %latch
+
+op172:
+  %v172.0 = and i64 %reg, 1207
+  %v172 = add i64 %acc, %v172.0
+  store i64 %v172, i64* %reg.addr, align 8
+  br label %latch
+
+op173:
+  %v173.0 = or i64 %reg, 1214
+  %v173 = add i64 %acc, %v173.0
+  br label %latch
+
+op174:
+  %v174.0 = shl i64 %reg, 49
+  %v174 = add i64 %acc, %v174.0
+  br label %latch
+
+op175:
+  %v175.0 = lshr i64 %reg, 50
+  %v175 = add i64 %acc, %v175.0
+  br label %latch
+
+op176:
+  %v176.0 = add i64 %reg, 1235
+  %v176 = add i64 %acc, %v176.0
+  store i64 %v176, i64* %reg.addr, align 8
+  br label %latch
+
+op177:
+  %v177.0 = sub i64 %reg, 1242
+  %v177 = add i64 %acc, %v177.0
+  br label %latch
+
+op178:
+  %v178.0 = mul i64 %reg, 1249
+  %v178 = add i64 %acc, %v178.0
+  br label %latch
+
+op179:
+  %v179.0 = xor i64 %reg, 1256
+  %v179 = add i64 %acc, %v179.0
+  br label %latch
+
+op180:
+  %v180.0 = and i64 %reg, 1263
+  %v180 = add i64 %acc, %v180.0
+  store i64 %v180, i64* %reg.addr, align 8
+  br label %latch
+
+op181:
+  %v181.0 = or i64 %reg, 1270
+  %v181 = add i64 %acc, %v181.0
+  br label %latch
+
+op182:
+  %v182.0 = shl i64 %reg, 57
+  %v182 = add i64 %acc, %v182.0
+  br label %latch
+
+op183:
+  %v183.0 = lshr i64 %reg, 58
+  %v183 = add i64 %acc, %v183.0
+  br label %latch
+
+op184:
+  %v184.0 = add i64 %reg, 1291
+  %v184 = add i64 %acc, %v184.0
+  store i64 %v184, i64* %reg.addr, align 8
+  br label %latch
+
+op185:
+  %v185.0 = sub i64 %reg, 1298
+  %v185 = add i64 %acc, %v185.0
+  br label %latch
+
+op186:
+  %v186.0 = mul i64 %reg, 1305
+  %v186 = add i64 %acc, %v186.0
+  br label %latch
+
+op187:
+  %v187.0 = xor i64 %reg, 1312
+  %v187 = add i64 %acc, %v187.0
+  br label %latch
+
+op188:
+  %v188.0 = and i64 %reg, 1319
+  %v188 = add i64 %acc, %v188.0
+  store i64 %v188, i64* %reg.addr, align 8
+  br label %latch
+
+op189:
+  %v189.0 = or i64 %reg, 1326
+  %v189 = add i64 %acc, %v189.0
+  br label %latch
+
+op190:
+  %v190.0 = shl i64 %reg, 2
+  %v190 = add i64 %acc, %v190.0
+  br label %latch
+
+op191:
+  %v191.0 = lshr i64 %reg, 3
+  %v191 = add i64 %acc, %v191.0
+  br label %latch
+
+op192:
+  %v192.0 = add i64 %reg, 1347
+  %v192 = add i64 %acc, %v192.0
+  store i64 %v192, i64* %reg.addr, align 8
+  br label %latch
+
+op193:
+  %v193.0 = sub i64 %reg, 1354
+  %v193 = add i64 %acc, %v193.0
+  br label %latch
+
+op194:
+  %v194.0 = mul i64 %reg, 1361
+  %v194 = add i64 %acc, %v194.0
+  br label %latch
+
+op195:
+  %v195.0 = xor i64 %reg, 1368
+  %v195 = add i64 %acc, %v195.0
+  br label %latch
+
+op196:
+  %v196.0 = and i64 %reg, 1375
+  %v196 = add i64 %acc, %v196.0
+  store i64 %v196, i64* %reg.addr, align 8
+  br label %latch
+
+op197:
+  %v197.0 = or i64 %reg, 1382
+  %v197 = add i64 %acc, %v197.0
+  br label %latch
+
+op198:
+  %v198.0 = shl i64 %reg, 10
+  %v198 = add i64 %acc, %v198.0
+  br label %latch
+
+op199:
+  %v199.0 = lshr i64 %reg, 11
+  %v199 = add i64 %acc, %v199.0
+  br label %latch
+
+op200:
+  %v200.0 = add i64 %reg, 1403
+  %v200 = add i64 %acc, %v200.0
+  store i64 %v200, i64* %reg.addr, align 8
+  br label %latch
+
+op201:
+  %v201.0 = sub i64 %reg, 1410
+  %v201 = add i64 %acc, %v201.0
+  br label %latch
+
+op202:
+  %v202.0 = mul i64 %reg, 1417
+  %v202 = add i64 %acc, %v202.0
+  br label %latch
+
+op203:
+  %v203.0 = xor i64 %reg, 1424
+  %v203 = add i64 %acc, %v203.0
+  br label %latch
+
+op204:
+  %v204.0 = and i64 %reg, 1431
+  %v204 = add i64 %acc, %v204.0
+  store i64 %v204, i64* %reg.addr, align 8
+  br label %latch
+
+op205:
+  %v205.0 = or i64 %reg, 1438
+  %v205 = add i64 %acc, %v205.0
+  br label %latch
+
+op206:
+  %v206.0 = shl i64 %reg, 18
+  %v206 = add i64 %acc, %v206.0
+  br label %latch
+
+op207:
+  %v207.0 = lshr i64 %reg, 19
+  %v207 = add i64 %acc, %v207.0
+  br label %latch
+
+op208:
+  %v208.0 = add i64 %reg, 1459
+  %v208 = add i64 %acc, %v208.0
+  store i64 %v208, i64* %reg.addr, align 8
+  br label %latch
+
+op209:
+  %v209.0 = sub i64 %reg, 1466
+  %v209 = add i64 %acc, %v209.0
+  br label %latch
+
+op210:
+  %v210.0 = mul i64 %reg, 1473
+  %v210 = add i64 %acc, %v210.0
+  br label %latch
+
+op211:
+  %v211.0 = xor i64 %reg, 1480
+  %v211 = add i64 %acc, %v211.0
+  br label %latch
+
+op212:
+  %v212.0 = and i64 %reg, 1487
+  %v212 = add i64 %acc, %v212.0
+  store i64 %v212, i64* %reg.addr, align 8
+  br label %latch
+
+op213:
+  %v213.0 = or i64 %reg, 1494
+  %v213 = add i64 %acc, %v213.0
+  br label %latch
+
+op214:
+  %v214.0 = shl i64 %reg, 26
+  %v214 = add i64 %acc, %v214.0
+  br label %latch
+
+op215:
+  %v215.0 = lshr i64 %reg, 27
+  %v215 = add i64 %acc, %v215.0
+  br label %latch
+
+op216:
+  %v216.0 = add i64 %reg, 1515
+  %v216 = add i64 %acc, %v216.0
+  store i64 %v216, i64* %reg.addr, align 8
+  br label %latch
+
+op217:
+  %v217.0 = sub i64 %reg, 1522
+  %v217 = add i64 %acc, %v217.0
+  br label %latch
+
+op218:
+  %v218.0 = mul i64 %reg, 1529
+  %v218 = add i64 %acc, %v218.0
+  br label %latch
+
+op219:
+  %v219.0 = xor i64 %reg, 1536
+  %v219 = add i64 %acc, %v219.0
+  br label %latch
+
+op220:
+  %v220.0 = and i64 %reg, 1543
+  %v220 = add i64 %acc, %v220.0
+  store i64 %v220, i64* %reg.addr, align 8
+  br label %latch
+
+op221:
+  %v221.0 = or i64 %reg, 1550
+  %v221 = add i64 %acc, %v221.0
+  br label %latch
+
+op222:
+  %v222.0 = shl i64 %reg, 34
+  %v222 = add i64 %acc, %v222.0
+  br label %latch
+
+op223:
+  %v223.0 = lshr i64 %reg, 35
+  %v223 = add i64 %acc, %v223.0
+  br label %latch
+
+op224:
+  %v224.0 = add i64 %reg, 1571
+  %v224 = add i64 %acc, %v224.0
+  store i64 %v224, i64* %reg.addr, align 8
+  br label %latch
+
+op225:
+  %v225.0 = sub i64 %reg, 1578
+  %v225 = add i64 %acc, %v225.0
+  br label %latch
+
+op226:
+  %v226.0 = mul i64 %reg, 1585
+  %v226 = add i64 %acc, %v226.0
+  br label %latch
+
+op227:
+  %v227.0 = xor i64 %reg, 1592
+  %v227 = add i64 %acc, %v227.0
+  br label %latch
+
+op228:
+  %v228.0 = and i64 %reg, 1599
+  %v228 = add i64 %acc, %v228.0
+  store i64 %v228, i64* %reg.addr, align 8
+  br label %latch
+
+op229:
+  %v229.0 = or i64 %reg, 1606
+  %v229 = add i64 %acc, %v229.0
+  br label %latch
+
+op230:
+  %v230.0 = shl i64 %reg, 42
+  %v230 = add i64 %acc, %v230.0
+  br label %latch
+
+op231:
+  %v231.0 = lshr i64 %reg, 43
+  %v231 = add i64 %acc, %v231.0
+  br label %latch
+
+op232:
+  %v232.0 = add i64 %reg, 1627
+  %v232 = add i64 %acc, %v232.0
+  store i64 %v232, i64* %reg.addr, align 8
+  br label %latch
+
+op233:
+  %v233.0 = sub i64 %reg, 1634
+  %v233 = add i64 %acc, %v233.0
+  br label %latch
+
+op234:
+  %v234.0 = mul i64 %reg, 1641
+  %v234 = add i64 %acc, %v234.0
+  br label %latch
+
+op235:
+  %v235.0 = xor i64 %reg, 1648
+  %v235 = add i64 %acc, %v235.0
+  br label %latch
+
+op236:
+  %v236.0 = and i64 %reg, 1655
+  %v236 = add i64 %acc, %v236.0
+  store i64 %v236, i64* %reg.addr, align 8
+  br label %latch
+
+op237:
+  %v237.0 = or i64 %reg, 1662
+  %v237 = add i64 %acc, %v237.0
+  br label %latch
+
+op238:
+  %v238.0 = shl i64 %reg, 50
+  %v238 = add i64 %acc, %v238.0
+  br label %latch
+
+op239:
+  %v239.0 = lshr i64 %reg, 51
+  %v239 = add i64 %acc, %v239.0
+  br label %latch
+
+op240:
+  %v240.0 = add i64 %reg, 1683
+  %v240 = add i64 %acc, %v240.0
+  store i64 %v240, i64* %reg.addr, align 8
+  br label %latch
+
+op241:
+  %v241.0 = sub i64 %reg, 1690
+  %v241 = add i64 %acc, %v241.0
+  br label %latch
+
+op242:
+  %v242.0 = mul i64 %reg, 1697
+  %v242 = add i64 %acc, %v242.0
+  br label %latch
+
+op243:
+  %v243.0 = xor i64 %reg, 1704
+  %v243 = add i64 %acc, %v243.0
+  br label %latch
+
+op244:
+  %v244.0 = and i64 %reg, 1711
+  %v244 = add i64 %acc, %v244.0
+  store i64 %v244, i64* %reg.addr, align 8
+  br label %latch
+
+op245:
+  %v245.0 = or i64 %reg, 1718
+  %v245 = add i64 %acc, %v245.0
+  br label %latch
+
+op246:
+  %v246.0 = shl i64 %reg, 58
+  %v246 = add i64 %acc, %v246.0
+  br label %latch
+
+op247:
+  %v247.0 = lshr i64 %reg, 59
+  %v247 = add i64 %acc, %v247.0
+  br label %latch
+
+op248:
+  %v248.0 = add i64 %reg, 1739
+  %v248 = add i64 %acc, %v248.0
+  store i64 %v248, i64* %reg.addr, align 8
+  br label %latch
+
+op249:
+  %v249.0 = sub i64 %reg, 1746
+  %v249 = add i64 %acc, %v249.0
+  br label %latch
+
+op250:
+  %v250.0 = mul i64 %reg, 1753
+  %v250 = add i64 %acc, %v250.0
+  br label %latch
+
+op251:
+  %v251.0 = xor i64 %reg, 1760
+  %v251 = add i64 %acc, %v251.0
+  br label %latch
+
+op252:
+  %v252.0 = and i64 %reg, 1767
+  %v252 = add i64 %acc, %v252.0
+  store i64 %v252, i64* %reg.addr, align 8
+  br label %latch
+
+op253:
+  %v253.0 = or i64 %reg, 1774
+  %v253 = add i64 %acc, %v253.0
+  br label %latch
+
+op254:
+  %v254.0 = shl i64 %reg, 3
+  %v254 = add i64 %acc, %v254.0
+  br label %latch
+
+op255:
+  %v255.0 = lshr i64 %reg, 4
+  %v255 = add i64 %acc, %v255.0
+  br label %latch
+
+op256:
+  %v256.0 = add i64 %reg, 1795
+  %v256 = add i64 %acc, %v256.0
+  store i64 %v256, i64* %reg.addr, align 8
+  br label %latch
+
+op257:
+  %v257.0 = sub i64 %reg, 1802
+  %v257 = add i64 %acc, %v257.0
+  br label %latch
+
+op258:
+  %v258.0 = mul i64 %reg, 1809
+  %v258 = add i64 %acc, %v258.0
+  br label %latch
+
+op259:
+  %v259.0 = xor i64 %reg, 1816
+  %v259 = add i64 %acc, %v259.0
+  br label %latch
+
+op260:
+  %v260.0 = and i64 %reg, 1823
+  %v260 = add i64 %acc, %v260.0
+  store i64 %v260, i64* %reg.addr, align 8
+  br label %latch
+
+op261:
+  %v261.0 = or i64 %reg, 1830
+  %v261 = add i64 %acc, %v261.0
+  br label %latch
+
+op262:
+  %v262.0 = shl i64 %reg, 11
+  %v262 = add i64 %acc, %v262.0
+  br label %latch
+
+op263:
+  %v263.0 = lshr i64 %reg, 12
+  %v263 = add i64 %acc, %v263.0
+  br label %latch
+
+op264:
+  %v264.0 = add i64 %reg, 1851
+  %v264 = add i64 %acc, %v264.0
+  store i64 %v264, i64* %reg.addr, align 8
+  br label %latch
+
+op265:
+  %v265.0 = sub i64 %reg, 1858
+  %v265 = add i64 %acc, %v265.0
+  br label %latch
+
+op266:
+  %v266.0 = mul i64 %reg, 1865
+  %v266 = add i64 %acc, %v266.0
+  br label %latch
+
+op267:
+  %v267.0 = xor i64 %reg, 1872
+  %v267 = add i64 %acc, %v267.0
+  br label %latch
+
+op268:
+  %v268.0 = and i64 %reg, 1879
+  %v268 = add i64 %acc, %v268.0
+  store i64 %v268, i64* %reg.addr, align 8
+  br label %latch
+
+op269:
+  %v269.0 = or i64 %reg, 1886
+  %v269 = add i64 %acc, %v269.0
+  br label %latch
+
+op270:
+  %v270.0 = shl i64 %reg, 19
+  %v270 = add i64 %acc, %v270.0
+  br label %latch
+
+op271:
+  %v271.0 = lshr i64 %reg, 20
+  %v271 = add i64 %acc, %v271.0
+  br label %latch
+
+op272:
+  %v272.0 = add i64 %reg, 1907
+  %v272 = add i64 %acc, %v272.0
+  store i64 %v272, i64* %reg.addr, align 8
+  br label %latch
+
+op273:
+  %v273.0 = sub i64 %reg, 1914
+  %v273 = add i64 %acc, %v273.0
+  br label %latch
+
+op274:
+  %v274.0 = mul i64 %reg, 1921
+  %v274 = add i64 %acc, %v274.0
+  br label %latch
+
+op275:
+  %v275.0 = xor i64 %reg, 1928
+  %v275 = add i64 %acc, %v275.0
+  br label %latch
+
+op276:
+  %v276.0 = and i64 %reg, 1935
+  %v276 = add i64 %acc, %v276.0
+  store i64 %v276, i64* %reg.addr, align 8
+  br label %latch
+
+op277:
+  %v277.0 = or i64 %reg, 1942
+  %v277 = add i64 %acc, %v277.0
+  br label %latch
+
+op278:
+  %v278.0 = shl i64 %reg, 27
+  %v278 = add i64 %acc, %v278.0
+  br label %latch
+
+op279:
+  %v279.0 = lshr i64 %reg, 28
+  %v279 = add i64 %acc, %v279.0
+  br label %latch
+
+op280:
+  %v280.0 = add i64 %reg, 1963
+  %v280 = add i64 %acc, %v280.0
+  store i64 %v280, i64* %reg.addr, align 8
+  br label %latch
+
+op281:
+  %v281.0 = sub i64 %reg, 1970
+  %v281 = add i64 %acc, %v281.0
+  br label %latch
+
+op282:
+  %v282.0 = mul i64 %reg, 1977
+  %v282 = add i64 %acc, %v282.0
+  br label %latch
+
+op283:
+  %v283.0 = xor i64 %reg, 1984
+  %v283 = add i64 %acc, %v283.0
+  br label %latch
+
+op284:
+  %v284.0 = and i64 %reg, 1991
+  %v284 = add i64 %acc, %v284.0
+  store i64 %v284, i64* %reg.addr, align 8
+  br label %latch
+
+op285:
+  %v285.0 = or i64 %reg, 1998
+  %v285 = add i64 %acc, %v285.0
+  br label %latch
+
+op286:
+  %v286.0 = shl i64 %reg, 35
+  %v286 = add i64 %acc, %v286.0
+  br label %latch
+
+op287:
+  %v287.0 = lshr i64 %reg, 36
+  %v287 = add i64 %acc, %v287.0
+  br label %latch
+
+op288:
+  %v288.0 = add i64 %reg, 2019
+  %v288 = add i64 %acc, %v288.0
+  store i64 %v288, i64* %reg.addr, align 8
+  br label %latch
+
+op289:
+  %v289.0 = sub i64 %reg, 2026
+  %v289 = add i64 %acc, %v289.0
+  br label %latch
+
+op290:
+  %v290.0 = mul i64 %reg, 2033
+  %v290 = add i64 %acc, %v290.0
+  br label %latch
+
+op291:
+  %v291.0 = xor i64 %reg, 2040
+  %v291 = add i64 %acc, %v291.0
+  br label %latch
+
+op292:
+  %v292.0 = and i64 %reg, 2047
+  %v292 = add i64 %acc, %v292.0
+  store i64 %v292, i64* %reg.addr, align 8
+  br label %latch
+
+op293:
+  %v293.0 = or i64 %reg, 2054
+  %v293 = add i64 %acc, %v293.0
+  br label %latch
+
+op294:
+  %v294.0 = shl i64 %reg, 43
+  %v294 = add i64 %acc, %v294.0
+  br label %latch
+
+op295:
+  %v295.0 = lshr i64 %reg, 44
+  %v295 = add i64 %acc, %v295.0
+  br label %latch
+
+op296:
+  %v296.0 = add i64 %reg, 2075
+  %v296 = add i64 %acc, %v296.0
+  store i64 %v296, i64* %reg.addr, align 8
+  br label %latch
+
+op297:
+  %v297.0 = sub i64 %reg, 2082
+  %v297 = add i64 %acc, %v297.0
+  br label %latch
+
+op298:
+  %v298.0 = mul i64 %reg, 2089
+  %v298 = add i64 %acc, %v298.0
+  br label %latch
+
+op299:
+  %v299.0 = xor i64 %reg, 2096
+  %v299 = add i64 %acc, %v299.0
+  br label %latch
+
+op300:
+  %v300.0 = and i64 %reg, 2103
+  %v300 = add i64 %acc, %v300.0
+  store i64 %v300, i64* %reg.addr, align 8
+  br label %latch
+
+op301:
+  %v301.0 = or i64 %reg, 2110
+  %v301 = add i64 %acc, %v301.0
+  br label %latch
+
+op302:
+  %v302.0 = shl i64 %reg, 51
+  %v302 = add i64 %acc, %v302.0
+  br label %latch
+
+op303:
+  %v303.0 = lshr i64 %reg, 52
+  %v303 = add i64 %acc, %v303.0
+  br label %latch
+
+op304:
+  %v304.0 = add i64 %reg, 2131
+  %v304 = add i64 %acc, %v304.0
+  store i64 %v304, i64* %reg.addr, align 8
+  br label %latch
+
+op305:
+  %v305.0 = sub i64 %reg, 2138
+  %v305 = add i64 %acc, %v305.0
+  br label %latch
+
+op306:
+  %v306.0 = mul i64 %reg, 2145
+  %v306 = add i64 %acc, %v306.0
+  br label %latch
+
+op307:
+  %v307.0 = xor i64 %reg, 2152
+  %v307 = add i64 %acc, %v307.0
+  br label %latch
+
+op308:
+  %v308.0 = and i64 %reg, 2159
+  %v308 = add i64 %acc, %v308.0
+  store i64 %v308, i64* %reg.addr, align 8
+  br label %latch
+
+op309:
+  %v309.0 = or i64 %reg, 2166
+  %v309 = add i64 %acc, %v309.0
+  br label %latch
+
+op310:
+  %v310.0 = shl i64 %reg, 59
+  %v310 = add i64 %acc, %v310.0
+  br label %latch
+
+op311:
+  %v311.0 = lshr i64 %reg, 60
+  %v311 = add i64 %acc, %v311.0
+  br label %latch
+
+op312:
+  %v312.0 = add i64 %reg, 2187
+  %v312 = add i64 %acc, %v312.0
+  store i64 %v312, i64* %reg.addr, align 8
+  br label %latch
+
+op313:
+  %v313.0 = sub i64 %reg, 2194
+  %v313 = add i64 %acc, %v313.0
+  br label %latch
+
+op314:
+  %v314.0 = mul i64 %reg, 2201
+  %v314 = add i64 %acc, %v314.0
+  br label %latch
+
+op315:
+  %v315.0 = xor i64 %reg, 2208
+  %v315 = add i64 %acc, %v315.0
+  br label %latch
+
+op316:
+  %v316.0 = and i64 %reg, 2215
+  %v316 = add i64 %acc, %v316.0
+  store i64 %v316, i64* %reg.addr, align 8
+  br label %latch
+
+op317:
+  %v317.0 = or i64 %reg, 2222
+  %v317 = add i64 %acc, %v317.0
+  br label %latch
+
+op318:
+  %v318.0 = shl i64 %reg, 4
+  %v318 = add i64 %acc, %v318.0
+  br label %latch
+
+op319:
+  %v319.0 = lshr i64 %reg, 5
+  %v319 = add i64 %acc, %v319.0
+  br label %latch
+
+op320:
+  %v320.0 = add i64 %reg, 2243
+  %v320 = add i64 %acc, %v320.0
+  store i64 %v320, i64* %reg.addr, align 8
+  br label %latch
+
+op321:
+  %v321.0 = sub i64 %reg, 2250
+  %v321 = add i64 %acc, %v321.0
+  br label %latch
+
+op322:
+  %v322.0 = mul i64 %reg, 2257
+  %v322 = add i64 %acc, %v322.0
+  br label %latch
+
+op323:
+  %v323.0 = xor i64 %reg, 2264
+  %v323 = add i64 %acc, %v323.0
+  br label %latch
+
+op324:
+  %v324.0 = and i64 %reg, 2271
+  %v324 = add i64 %acc, %v324.0
+  store i64 %v324, i64* %reg.addr, align 8
+  br label %latch
+
+op325:
+  %v325.0 = or i64 %reg, 2278
+  %v325 = add i64 %acc, %v325.0
+  br label %latch
+
+op326:
+  %v326.0 = shl i64 %reg, 12
+  %v326 = add i64 %acc, %v326.0
+  br label %latch
+
+op327:
+  %v327.0 = lshr i64 %reg, 13
+  %v327 = add i64 %acc, %v327.0
+  br label %latch
+
+op328:
+  %v328.0 = add i64 %reg, 2299
+  %v328 = add i64 %acc, %v328.0
+  store i64 %v328, i64* %reg.addr, align 8
+  br label %latch
+
+op329:
+  %v329.0 = sub i64 %reg, 2306
+  %v329 = add i64 %acc, %v329.0
+  br label %latch
+
+op330:
+  %v330.0 = mul i64 %reg, 2313
+  %v330 = add i64 %acc, %v330.0
+  br label %latch
+
+op331:
+  %v331.0 = xor i64 %reg, 2320
+  %v331 = add i64 %acc, %v331.0
+  br label %latch
+
+op332:
+  %v332.0 = and i64 %reg, 2327
+  %v332 = add i64 %acc, %v332.0
+  store i64 %v332, i64* %reg.addr, align 8
+  br label %latch
+
+op333:
+  %v333.0 = or i64 %reg, 2334
+  %v333 = add i64 %acc, %v333.0
+  br label %latch
+
+op334:
+  %v334.0 = shl i64 %reg, 20
+  %v334 = add i64 %acc, %v334.0
+  br label %latch
+
+op335:
+  %v335.0 = lshr i64 %reg, 21
+  %v335 = add i64 %acc, %v335.0
+  br label %latch
+
+op336:
+  %v336.0 = add i64 %reg, 2355
+  %v336 = add i64 %acc, %v336.0
+  store i64 %v336, i64* %reg.addr, align 8
+  br label %latch
+
+op337:
+  %v337.0 = sub i64 %reg, 2362
+  %v337 = add i64 %acc, %v337.0
+  br label %latch
+
+op338:
+  %v338.0 = mul i64 %reg, 2369
+  %v338 = add i64 %acc, %v338.0
+  br label %latch
+
+op339:
+  %v339.0 = xor i64 %reg, 2376
+  %v339 = add i64 %acc, %v339.0
+  br label %latch
+
+op340:
+  %v340.0 = and i64 %reg, 2383
+  %v340 = add i64 %acc, %v340.0
+  store i64 %v340, i64* %reg.addr, align 8
+  br label %latch
+
+op341:
+  %v341.0 = or i64 %reg, 2390
+  %v341 = add i64 %acc, %v341.0
+  br label %latch
+
+op342:
+  %v342.0 = shl i64 %reg, 28
+  %v342 = add i64 %acc, %v342.0
+  br label %latch
+
+op343:
+  %v343.0 = lshr i64 %reg, 29
+  %v343 = add i64 %acc, %v343.0
+  br label %latch
+
+op344:
+  %v344.0 = add i64 %reg, 2411
+  %v344 = add i64 %acc, %v344.0
+  store i64 %v344, i64* %reg.addr, align 8
+  br label %latch
+
+op345:
+  %v345.0 = sub i64 %reg, 2418
+  %v345 = add i64 %acc, %v345.0
+  br label %latch
+
+op346:
+  %v346.0 = mul i64 %reg, 2425
+  %v346 = add i64 %acc, %v346.0
+  br label %latch
+
+op347:
+  %v347.0 = xor i64 %reg, 2432
+  %v347 = add i64 %acc, %v347.0
+  br label %latch
+
+op348:
+  %v348.0 = and i64 %reg, 2439
+  %v348 = add i64 %acc, %v348.0
+  store i64 %v348, i64* %reg.addr, align 8
+  br label %latch
+
+op349:
+  %v349.0 = or i64 %reg, 2446
+  %v349 = add i64 %acc, %v349.0
+  br label %latch
+
+op350:
+  %v350.0 = shl i64 %reg, 36
+  %v350 = add i64 %acc, %v350.0
+  br label %latch
+
+op351:
+  %v351.0 = lshr i64 %reg, 37
+  %v351 = add i64 %acc, %v351.0
+  br label %latch
+
+op352:
+  %v352.0 = add i64 %reg, 2467
+  %v352 = add i64 %acc, %v352.0
+  store i64 %v352, i64* %reg.addr, align 8
+  br label %latch
+
+op353:
+  %v353.0 = sub i64 %reg, 2474
+  %v353 = add i64 %acc, %v353.0
+  br label %latch
+
+op354:
+  %v354.0 = mul i64 %reg, 2481
+  %v354 = add i64 %acc, %v354.0
+  br label %latch
+
+op355:
+  %v355.0 = xor i64 %reg, 2488
+  %v355 = add i64 %acc, %v355.0
+  br label %latch
+
+op356:
+  %v356.0 = and i64 %reg, 2495
+  %v356 = add i64 %acc, %v356.0
+  store i64 %v356, i64* %reg.addr, align 8
+  br label %latch
+
+op357:
+  %v357.0 = or i64 %reg, 2502
+  %v357 = add i64 %acc, %v357.0
+  br label %latch
+
+op358:
+  %v358.0 = shl i64 %reg, 44
+  %v358 = add i64 %acc, %v358.0
+  br label %latch
+
+op359:
+  %v359.0 = lshr i64 %reg, 45
+  %v359 = add i64 %acc, %v359.0
+  br label %latch
+
+op360:
+  %v360.0 = add i64 %reg, 2523
+  %v360 = add i64 %acc, %v360.0
+  store i64 %v360, i64* %reg.addr, align 8
+  br label %latch
+
+op361:
+  %v361.0 = sub i64 %reg, 2530
+  %v361 = add i64 %acc, %v361.0
+  br label %latch
+
+op362:
+  %v362.0 = mul i64 %reg, 2537
+  %v362 = add i64 %acc, %v362.0
+  br label %latch
+
+op363:
+  %v363.0 = xor i64 %reg, 2544
+  %v363 = add i64 %acc, %v363.0
+  br label %latch
+
+op364:
+  %v364.0 = and i64 %reg, 2551
+  %v364 = add i64 %acc, %v364.0
+  store i64 %v364, i64* %reg.addr, align 8
+  br label %latch
+
+op365:
+  %v365.0 = or i64 %reg, 2558
+  %v365 = add i64 %acc, %v365.0
+  br label %latch
+
+op366:
+  %v366.0 = shl i64 %reg, 52
+  %v366 = add i64 %acc, %v366.0
+  br label %latch
+
+op367:
+  %v367.0 = lshr i64 %reg, 53
+  %v367 = add i64 %acc, %v367.0
+  br label %latch
+
+op368:
+  %v368.0 = add i64 %reg, 2579
+  %v368 = add i64 %acc, %v368.0
+  store i64 %v368, i64* %reg.addr, align 8
+  br label %latch
+
+op369:
+  %v369.0 = sub i64 %reg, 2586
+  %v369 = add i64 %acc, %v369.0
+  br label %latch
+
+op370:
+  %v370.0 = mul i64 %reg, 2593
+  %v370 = add i64 %acc, %v370.0
+  br label %latch
+
+op371:
+  %v371.0 = xor i64 %reg, 2600
+  %v371 = add i64 %acc, %v371.0
+  br label %latch
+
+op372:
+  %v372.0 = and i64 %reg, 2607
+  %v372 = add i64 %acc, %v372.0
+  store i64 %v372, i64* %reg.addr, align 8
+  br label %latch
+
+op373:
+  %v373.0 = or i64 %reg, 2614
+  %v373 = add i64 %acc, %v373.0
+  br label %latch
+
+op374:
+  %v374.0 = shl i64 %reg, 60
+  %v374 = add i64 %acc, %v374.0
+  br label %latch
+
+op375:
+  %v375.0 = lshr i64 %reg, 61
+  %v375 = add i64 %acc, %v375.0
+  br label %latch
+
+op376:
+  %v376.0 = add i64 %reg, 2635
+  %v376 = add i64 %acc, %v376.0
+  store i64 %v376, i64* %reg.addr, align 8
+  br label %latch
+
+op377:
+  %v377.0 = sub i64 %reg, 2642
+  %v377 = add i64 %acc, %v377.0
+  br label %latch
+
+op378:
+  %v378.0 = mul i64 %reg, 2649
+  %v378 = add i64 %acc, %v378.0
+  br label %latch
+
+op379:
+  %v379.0 = xor i64 %reg, 2656
+  %v379 = add i64 %acc, %v379.0
+  br label %latch
+
+op380:
+  %v380.0 = and i64 %reg, 2663
+  %v380 = add i64 %acc, %v380.0
+  store i64 %v380, i64* %reg.addr, align 8
+  br label %latch
+
+op381:
+  %v381.0 = or i64 %reg, 2670
+  %v381 = add i64 %acc, %v381.0
+  br label %latch
+
+op382:
+  %v382.0 = shl i64 %reg, 5
+  %v382 = add i64 %acc, %v382.0
+  br label %latch
+
+op383:
+  %v383.0 = lshr i64 %reg, 6
+  %v383 = add i64 %acc, %v383.0
+  br label %latch
+
+default:
+  br label %latch
+
+latch:
+  %acc.next = phi i64 [ %v0, %op0 ], [ %v1, %op1 ], [ %v2, %op2 ], [ %v3, %op3 ], [ %v4, %op4 ], [ %v5, %op5 ], [ %v6, %op6 ], [ %v7, %op7 ], [ %v8, %op8 ], [ %v9, %op9 ], [ %v10, %op10 ], [ %v11, %op11 ], [ %v12, %op12 ], [ %v13, %op13 ], [ %v14, %op14 ], [ %v15, %op15 ], [ %v16, %op16 ], [ %v17, %op17 ], [ %v18, %op18 ], [ %v19, %op19 ], [ %v20, %op20 ], [ %v21, %op21 ], [ %v22, %op22 ], [ %v23, %op23 ], [ %v24, %op24 ], [ %v25, %op25 ], [ %v26, %op26 ], [ %v27, %op27 ], [ %v28, %op28 ], [ %v29, %op29 ], [ %v30, %op30 ], [ %v31, %op31 ], [ %v32, %op32 ], [ %v33, %op33 ], [ %v34, %op34 ], [ %v35, %op35 ], [ %v36, %op36 ], [ %v37, %op37 ], [ %v38, %op38 ], [ %v39, %op39 ], [ %v40, %op40 ], [ %v41, %op41 ], [ %v42, %op42 ], [ %v43, %op43 ], [ %v44, %op44 ], [ %v45, %op45 ], [ %v46, %op46 ], [ %v47, %op47 ], [ %v48, %op48 ], [ %v49, %op49 ], [ %v50, %op50 ], [ %v51, %op51 ], [ %v52, %op52 ], [ %v53, %op53 ], [ %v54, %op54 ], [ %v55, %op55 ], [ %v56, %op56 ], [ %v57, %op57 ], [ %v58, %op58 ], [ %v59, %op59 ], [ %v60, %op60 ], [ %v61, %op61 ], [ %v62, %op62 ], [ %v63, %op63 ], [ %v64, %op64 ], [ %v65, %op65 ], [ %v66, %op66 ], [ %v67, %op67 ], [ %v68, %op68 ], [ %v69, %op69 ], [ %v70, %op70 ], [ %v71, %op71 ], [ %v72, %op72 ], [ %v73, %op73 ], [ %v74, %op74 ], [ %v75, %op75 ], [ %v76, %op76 ], [ %v77, %op77 ], [ %v78, %op78 ], [ %v79, %op79 ], [ %v80, %op80 ], [ %v81, %op81 ], [ %v82, %op82 ], [ %v83, %op83 ], [ %v84, %op84 ], [ %v85, %op85 ], [ %v86, %op86 ], [ %v87, %op87 ], [ %v88, %op88 ], [ %v89, %op89 ], [ %v90, %op90 ], [ %v91, %op91 ], [ %v92, %op92 ], [ %v93, %op93 ], [ %v94, %op94 ], [ %v95, %op95 ], [ %v96, %op96 ], [ %v97, %op97 ], [ %v98, %op98 ], [ %v99, %op99 ], [ %v100, %op100 ], [ %v101, %op101 ], [ %v102, %op102 ], [ %v103, %op103 ], [ %v104, %op104 ], [ %v105, %op105 ], [ %v106, %op106 ], [ %v107, %op107 ], [ %v108, %op108 ], [ %v109, %op109 ], [ %v110, %op110 ], [ %v111, %op111 ], [ %v112, %op112 ], [ %v113, %op113 ], [ %v114, %op114 ], [ %v115, %op115 ], [ %v116, %op116 ], [ %v117, %op117 ], [ %v118, %op118 ], [ %v119, %op119 ], [ %v120, %op120 ], [ %v121, %op121 ], [ %v122, %op122 ], [ %v123, %op123 ], [ %v124, %op124 ], [ %v125, %op125 ], [ %v126, %op126 ], [ %v127, %op127 ], [ %v128, %op128 ], [ %v129, %op129 ], [ %v130, %op130 ], [ %v131, %op131 ], [ %v132, %op132 ], [ %v133, %op133 ], [ %v134, %op134 ], [ %v135, %op135 ], [ %v136, %op136 ], [ %v137, %op137 ], [ %v138, %op138 ], [ %v139, %op139 ], [ %v140, %op140 ], [ %v141, %op141 ], [ %v142, %op142 ], [ %v143, %op143 ], [ %v144, %op144 ], [ %v145, %op145 ], [ %v146, %op146 ], [ %v147, %op147 ], [ %v148, %op148 ], [ %v149, %op149 ], [ %v150, %op150 ], [ %v151, %op151 ], [ %v152, %op152 ], [ %v153, %op153 ], [ %v154, %op154 ], [ %v155, %op155 ], [ %v156, %op156 ], [ %v157, %op157 ], [ %v158, %op158 ], [ %v159, %op159 ], [ %v160, %op160 ], [ %v161, %op161 ], [ %v162, %op162 ], [ %v163, %op163 ], [ %v164, %op164 ], [ %v165, %op165 ], [ %v166, %op166 ], [ %v167, %op167 ], [ %v168, %op168 ], [ %v169, %op169 ], [ %v170, %op170 ], [ %v171, %op171 ], [ %v172, %op172 ], [ %v173, %op173 ], [ %v174, %op174 ], [ %v175, %op175 ], [ %v176, %op176 ], [ %v177, %op177 ], [ %v178, %op178 ], [ %v179, %op179 ], [ %v180, %op180 ], [ %v181, %op181 ], [ %v182, %op182 ], [ %v183, %op183 ], [ %v184, %op184 ], [ %v185, %op185 ], [ %v186, %op186 ], [ %v187, %op187 ], [ %v188, %op188 ], [ %v189, %op189 ], [ %v190, %op190 ], [ %v191, %op191 ], [ %v192, %op192 ], [ %v193, %op193 ], [ %v194, %op194 ], [ %v195, %op195 ], [ %v196, %op196 ], [ %v197, %op197 ], [ %v198, %op198 ], [ %v199, %op199 ], [ %v200, %op200 ], [ %v201, %op201 ], [ %v202, %op202 ], [ %v203, %op203 ], [ %v204, %op204 ], [ %v205, %op205 ], [ %v206, %op206 ], [ %v207, %op207 ], [ %v208, %op208 ], [ %v209, %op209 ], [ %v210, %op210 ], [ %v211, %op211 ], [ %v212, %op212 ], [ %v213, %op213 ], [ %v214, %op214 ], [ %v215, %op215 ], [ %v216, %op216 ], [ %v217, %op217 ], [ %v218, %op218 ], [ %v219, %op219 ], [ %v220, %op220 ], [ %v221, %op221 ], [ %v222, %op222 ], [ %v223, %op223 ], [ %v224, %op224 ], [ %v225, %op225 ], [ %v226, %op226 ], [ %v227, %op227 ], [ %v228, %op228 ], [ %v229, %op229 ], [ %v230, %op230 ], [ %v231, %op231 ], [ %v232, %op232 ], [ %v233, %op233 ], [ %v234, %op234 ], [ %v235, %op235 ], [ %v236, %op236 ], [ %v237, %op237 ], [ %v238, %op238 ], [ %v239, %op239 ], [ %v240, %op240 ], [ %v241, %op241 ], [ %v242, %op242 ], [ %v243, %op243 ], [ %v244, %op244 ], [ %v245, %op245 ], [ %v246, %op246 ], [ %v247, %op247 ], [ %v248, %op248 ], [ %v249, %op249 ], [ %v250, %op250 ], [ %v251, %op251 ], [ %v252, %op252 ], [ %v253, %op253 ], [ %v254, %op254 ], [ %v255, %op255 ], [ %v256, %op256 ], [ %v257, %op257 ], [ %v258, %op258 ], [ %v259, %op259 ], [ %v260, %op260 ], [ %v261, %op261 ], [ %v262, %op262 ], [ %v263, %op263 ], [ %v264, %op264 ], [ %v265, %op265 ], [ %v266, %op266 ], [ %v267, %op267 ], [ %v268, %op268 ], [ %v269, %op269 ], [ %v270, %op270 ], [ %v271, %op271 ], [ %v272, %op272 ], [ %v273, %op273 ], [ %v274, %op274 ], [ %v275, %op275 ], [ %v276, %op276 ], [ %v277, %op277 ], [ %v278, %op278 ], [ %v279, %op279 ], [ %v280, %op280 ], [ %v281, %op281 ], [ %v282, %op282 ], [ %v283, %op283 ], [ %v284, %op284 ], [ %v285, %op285 ], [ %v286, %op286 ], [ %v287, %op287 ], [ %v288, %op288 ], [ %v289, %op289 ], [ %v290, %op290 ], [ %v291, %op291 ], [ %v292, %op292 ], [ %v293, %op293 ], [ %v294, %op294 ], [ %v295, %op295 ], [ %v296, %op296 ], [ %v297, %op297 ], [ %v298, %op298 ], [ %v299, %op299 ], [ %v300, %op300 ], [ %v301, %op301 ], [ %v302, %op302 ], [ %v303, %op303 ], [ %v304, %op304 ], [ %v305, %op305 ], [ %v306, %op306 ], [ %v307, %op307 ], [ %v308, %op308 ], [ %v309, %op309 ], [ %v310, %op310 ], [ %v311, %op311 ], [ %v312, %op312 ], [ %v313, %op313 ], [ %v314, %op314 ], [ %v315, %op315 ], [ %v316, %op316 ], [ %v317, %op317 ], [ %v318, %op318 ], [ %v319, %op319 ], [ %v320, %op320 ], [ %v321, %op321 ], [ %v322, %op322 ], [ %v323, %op323 ], [ %v324, %op324 ], [ %v325, %op325 ], [ %v326, %op326 ], [ %v327, %op327 ], [ %v328, %op328 ], [ %v329, %op329 ], [ %v330, %op330 ], [ %v331, %op331 ], [ %v332, %op332 ], [ %v333, %op333 ], [ %v334, %op334 ], [ %v335, %op335 ], [ %v336, %op336 ], [ %v337, %op337 ], [ %v338, %op338 ], [ %v339, %op339 ], [ %v340, %op340 ], [ %v341, %op341 ], [ %v342, %op342 ], [ %v343, %op343 ], [ %v344, %op344 ], [ %v345, %op345 ], [ %v346, %op346 ], [ %v347, %op347 ], [ %v348, %op348 ], [ %v349, %op349 ], [ %v350, %op350 ], [ %v351, %op351 ], [ %v352, %op352 ], [ %v353, %op353 ], [ %v354, %op354 ], [ %v355, %op355 ], [ %v356, %op356 ], [ %v357, %op357 ], [ %v358, %op358 ], [ %v359, %op359 ], [ %v360, %op360 ], [ %v361, %op361 ], [ %v362, %op362 ], [ %v363, %op363 ], [ %v364, %op364 ], [ %v365, %op365 ], [ %v366, %op366 ], [ %v367, %op367 ], [ %v368, %op368 ], [ %v369, %op369 ], [ %v370, %op370 ], [ %v371, %op371 ], [ %v372, %op372 ], [ %v373, %op373 ], [ %v374, %op374 ], [ %v375, %op375 ], [ %v376, %op376 ], [ %v377, %op377 ], [ %v378, %op378 ], [ %v379, %op379 ], [ %v380, %op380 ], [ %v381, %op381 ], [ %v382, %op382 ], [ %v383, %op383 ], [ %acc, %default ]
+  %pc.next = add i64 %pc, 2
+  %done = icmp uge i64 %pc.next, %len
+  br i1 %done, label %exit, label %loop
+
+exit:
+  ret i64 %acc.next
+}
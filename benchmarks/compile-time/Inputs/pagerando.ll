@@ -0,0 +1,1196 @@
+; OPT-ARGS: -pagerando-wrappers
+; LLC-ARGS: -relocation-model=pip
+
+; A Pagerando module: every function is binned, most calls cross bins
+; through the page offset table, and some functions are address-taken so
+; that they need wrappers.
+
+target datalayout = "e-m:e-i8:8:32-i16:16:32-i64:64-i128:128-n32:64-S128"
+target triple = "aarch64-unknown-linux-android"
+
+@table = global [8 x i32 (i32)*] [i32 (i32)* @fn0, i32 (i32)* @fn8, i32 (i32)* @fn16, i32 (i32)* @fn24, i32 (i32)* @fn32, i32 (i32)* @fn40, i32 (i32)* @fn48, i32 (i32)* @fn56]
+@counter = global i32 0, align 4
+
+define i32 @fn0(i32 %x) pagerando {
+entry:
+  %c = load i32, i32* @counter, align 4
+  %a = add i32 %x, %c
+  %cmp = icmp sgt i32 %a, 0
+  br i1 %cmp, label %call, label %done
+
+call:
+  %r1 = call i32 @fn1(i32 %a)
+  %slot = getelementptr [8 x i32 (i32)*], [8 x i32 (i32)*]* @table, i32 0, i32 0
+  %fp = load i32 (i32)*, i32 (i32)** %slot, align 8
+  %r2 = call i32 %fp(i32 %r1)
+  store i32 %r2, i32* @counter, align 4
+  br label %done
+
+done:
+  %r = phi i32 [ %r2, %call ], [ %a, %entry ]
+  ret i32 %r
+}
+
+define internal i32 @fn1(i32 %x) pagerando {
+entry:
+  %c = load i32, i32* @counter, align 4
+  %a = add i32 %x, %c
+  %cmp = icmp sgt i32 %a, 5
+  br i1 %cmp, label %call, label %done
+
+call:
+  %r1 = call i32 @fn2(i32 %a)
+  %r2 = mul i32 %r1, 3
+  store i32 %r2, i32* @counter, align 4
+  br label %done
+
+done:
+  %r = phi i32 [ %r2, %call ], [ %a, %entry ]
+  ret i32 %r
+}
+
+define hidden i32 @fn2(i32 %x) pagerando {
+entry:
+  %c = load i32, i32* @counter, align 4
+  %a = add i32 %x, %c
+  %cmp = icmp sgt i32 %a, 10
+  br i1 %cmp, label %call, label %done
+
+call:
+  %r1 = call i32 @fn3(i32 %a)
+  %r2 = mul i32 %r1, 3
+  store i32 %r2, i32* @counter, align 4
+  br label %done
+
+done:
+  %r = phi i32 [ %r2, %call ], [ %a, %entry ]
+  ret i32 %r
+}
+
+define i32 @fn3(i32 %x) pagerando {
+entry:
+  %c = load i32, i32* @counter, align 4
+  %a = add i32 %x, %c
+  %cmp = icmp sgt i32 %a, 15
+  br i1 %cmp, label %call, label %done
+
+call:
+  %r1 = call i32 @fn4(i32 %a)
+  %r2 = mul i32 %r1, 3
+  store i32 %r2, i32* @counter, align 4
+  br label %done
+
+done:
+  %r = phi i32 [ %r2, %call ], [ %a, %entry ]
+  ret i32 %r
+}
+
+define internal i32 @fn4(i32 %x) pagerando {
+entry:
+  %c = load i32, i32* @counter, align 4
+  %a = add i32 %x, %c
+  %cmp = icmp sgt i32 %a, 20
+  br i1 %cmp, label %call, label %done
+
+call:
+  %r1 = call i32 @fn5(i32 %a)
+  %slot = getelementptr [8 x i32 (i32)*], [8 x i32 (i32)*]* @table, i32 0, i32 0
+  %fp = load i32 (i32)*, i32 (i32)** %slot, align 8
+  %r2 = call i32 %fp(i32 %r1)
+  store i32 %r2, i32* @counter, align 4
+  br label %done
+
+done:
+  %r = phi i32 [ %r2, %call ], [ %a, %entry ]
+  ret i32 %r
+}
+
+define hidden i32 @fn5(i32 %x) pagerando {
+entry:
+  %c = load i32, i32* @counter, align 4
+  %a = add i32 %x, %c
+  %cmp = icmp sgt i32 %a, 25
+  br i1 %cmp, label %call, label %done
+
+call:
+  %r1 = call i32 @fn6(i32 %a)
+  %r2 = mul i32 %r1, 3
+  store i32 %r2, i32* @counter, align 4
+  br label %done
+
+done:
+  %r = phi i32 [ %r2, %call ], [ %a, %entry ]
+  ret i32 %r
+}
+
+define i32 @fn6(i32 %x) pagerando {
+entry:
+  %c = load i32, i32* @counter, align 4
+  %a = add i32 %x, %c
+  %cmp = icmp sgt i32 %a, 30
+  br i1 %cmp, label %call, label %done
+
+call:
+  %r1 = call i32 @fn7(i32 %a)
+  %r2 = mul i32 %r1, 3
+  store i32 %r2, i32* @counter, align 4
+  br label %done
+
+done:
+  %r = phi i32 [ %r2, %call ], [ %a, %entry ]
+  ret i32 %r
+}
+
+define internal i32 @fn7(i32 %x) pagerando {
+entry:
+  %c = load i32, i32* @counter, align 4
+  %a = add i32 %x, %c
+  %cmp = icmp sgt i32 %a, 35
+  br i1 %cmp, label %call, label %done
+
+call:
+  %r1 = call i32 @fn8(i32 %a)
+  %r2 = mul i32 %r1, 3
+  store i32 %r2, i32* @counter, align 4
+  br label %done
+
+done:
+  %r = phi i32 [ %r2, %call ], [ %a, %entry ]
+  ret i32 %r
+}
+
+define hidden i32 @fn8(i32 %x) pagerando {
+entry:
+  %c = load i32, i32* @counter, align 4
+  %a = add i32 %x, %c
+  %cmp = icmp sgt i32 %a, 40
+  br i1 %cmp, label %call, label %done
+
+call:
+  %r1 = call i32 @fn9(i32 %a)
+  %slot = getelementptr [8 x i32 (i32)*], [8 x i32 (i32)*]* @table, i32 0, i32 1
+  %fp = load i32 (i32)*, i32 (i32)** %slot, align 8
+  %r2 = call i32 %fp(i32 %r1)
+  store i32 %r2, i32* @counter, align 4
+  br label %done
+
+done:
+  %r = phi i32 [ %r2, %call ], [ %a, %entry ]
+  ret i32 %r
+}
+
+define i32 @fn9(i32 %x) pagerando {
+entry:
+  %c = load i32, i32* @counter, align 4
+  %a = add i32 %x, %c
+  %cmp = icmp sgt i32 %a, 45
+  br i1 %cmp, label %call, label %done
+
+call:
+  %r1 = call i32 @fn10(i32 %a)
+  %r2 = mul i32 %r1, 3
+  store i32 %r2, i32* @counter, align 4
+  br label %done
+
+done:
+  %r = phi i32 [ %r2, %call ], [ %a, %entry ]
+  ret i32 %r
+}
+
+define internal i32 @fn10(i32 %x) pagerando {
+entry:
+  %c = load i32, i32* @counter, align 4
+  %a = add i32 %x, %c
+  %cmp = icmp sgt i32 %a, 50
+  br i1 %cmp, label %call, label %done
+
+call:
+  %r1 = call i32 @fn11(i32 %a)
+  %r2 = mul i32 %r1, 3
+  store i32 %r2, i32* @counter, align 4
+  br label %done
+
+done:
+  %r = phi i32 [ %r2, %call ], [ %a, %entry ]
+  ret i32 %r
+}
+
+define hidden i32 @fn11(i32 %x) pagerando {
+entry:
+  %c = load i32, i32* @counter, align 4
+  %a = add i32 %x, %c
+  %cmp = icmp sgt i32 %a, 55
+  br i1 %cmp, label %call, label %done
+
+call:
+  %r1 = call i32 @fn12(i32 %a)
+  %r2 = mul i32 %r1, 3
+  store i32 %r2, i32* @counter, align 4
+  br label %done
+
+done:
+  %r = phi i32 [ %r2, %call ], [ %a, %entry ]
+  ret i32 %r
+}
+
+define i32 @fn12(i32 %x) pagerando {
+entry:
+  %c = load i32, i32* @counter, align 4
+  %a = add i32 %x, %c
+  %cmp = icmp sgt i32 %a, 60
+  br i1 %cmp, label %call, label %done
+
+call:
+  %r1 = call i32 @fn13(i32 %a)
+  %slot = getelementptr [8 x i32 (i32)*], [8 x i32 (i32)*]* @table, i32 0, i32 1
+  %fp = load i32 (i32)*, i32 (i32)** %slot, align 8
+  %r2 = call i32 %fp(i32 %r1)
+  store i32 %r2, i32* @counter, align 4
+  br label %done
+
+done:
+  %r = phi i32 [ %r2, %call ], [ %a, %entry ]
+  ret i32 %r
+}
+
+define internal i32 @fn13(i32 %x) pagerando {
+entry:
+  %c = load i32, i32* @counter, align 4
+  %a = add i32 %x, %c
+  %cmp = icmp sgt i32 %a, 65
+  br i1 %cmp, label %call, label %done
+
+call:
+  %r1 = call i32 @fn14(i32 %a)
+  %r2 = mul i32 %r1, 3
+  store i32 %r2, i32* @counter, align 4
+  br label %done
+
+done:
+  %r = phi i32 [ %r2, %call ], [ %a, %entry ]
+  ret i32 %r
+}
+
+define hidden i32 @fn14(i32 %x) pagerando {
+entry:
+  %c = load i32, i32* @counter, align 4
+  %a = add i32 %x, %c
+  %cmp = icmp sgt i32 %a, 70
+  br i1 %cmp, label %call, label %done
+
+call:
+  %r1 = call i32 @fn15(i32 %a)
+  %r2 = mul i32 %r1, 3
+  store i32 %r2, i32* @counter, align 4
+  br label %done
+
+done:
+  %r = phi i32 [ %r2, %call ], [ %a, %entry ]
+  ret i32 %r
+}
+
+define i32 @fn15(i32 %x) pagerando {
+entry:
+  %c = load i32, i32* @counter, align 4
+  %a = add i32 %x, %c
+  %cmp = icmp sgt i32 %a, 75
+  br i1 %cmp, label %call, label %done
+
+call:
+  %r1 = call i32 @fn16(i32 %a)
+  %r2 = mul i32 %r1, 3
+  store i32 %r2, i32* @counter, align 4
+  br label %done
+
+done:
+  %r = phi i32 [ %r2, %call ], [ %a, %entry ]
+  ret i32 %r
+}
+
+define internal i32 @fn16(i32 %x) pagerando {
+entry:
+  %c = load i32, i32* @counter, align 4
+  %a = add i32 %x, %c
+  %cmp = icmp sgt i32 %a, 80
+  br i1 %cmp, label %call, label %done
+
+call:
+  %r1 = call i32 @fn17(i32 %a)
+  %slot = getelementptr [8 x i32 (i32)*], [8 x i32 (i32)*]* @table, i32 0, i32 2
+  %fp = load i32 (i32)*, i32 (i32)** %slot, align 8
+  %r2 = call i32 %fp(i32 %r1)
+  store i32 %r2, i32* @counter, align 4
+  br label %done
+
+done:
+  %r = phi i32 [ %r2, %call ], [ %a, %entry ]
+  ret i32 %r
+}
+
+define hidden i32 @fn17(i32 %x) pagerando {
+entry:
+  %c = load i32, i32* @counter, align 4
+  %a = add i32 %x, %c
+  %cmp = icmp sgt i32 %a, 85
+  br i1 %cmp, label %call, label %done
+
+call:
+  %r1 = call i32 @fn18(i32 %a)
+  %r2 = mul i32 %r1, 3
+  store i32 %r2, i32* @counter, align 4
+  br label %done
+
+done:
+  %r = phi i32 [ %r2, %call ], [ %a, %entry ]
+  ret i32 %r
+}
+
+define i32 @fn18(i32 %x) pagerando {
+entry:
+  %c = load i32, i32* @counter, align 4
+  %a = add i32 %x, %c
+  %cmp = icmp sgt i32 %a, 90
+  br i1 %cmp, label %call, label %done
+
+call:
+  %r1 = call i32 @fn19(i32 %a)
+  %r2 = mul i32 %r1, 3
+  store i32 %r2, i32* @counter, align 4
+  br label %done
+
+done:
+  %r = phi i32 [ %r2, %call ], [ %a, %entry ]
+  ret i32 %r
+}
+
+define internal i32 @fn19(i32 %x) pagerando {
+entry:
+  %c = load i32, i32* @counter, align 4
+  %a = add i32 %x, %c
+  %cmp = icmp sgt i32 %a, 95
+  br i1 %cmp, label %call, label %done
+
+call:
+  %r1 = call i32 @fn20(i32 %a)
+  %r2 = mul i32 %r1, 3
+  store i32 %r2, i32* @counter, align 4
+  br label %done
+
+done:
+  %r = phi i32 [ %r2, %call ], [ %a, %entry ]
+  ret i32 %r
+}
+
+define hidden i32 @fn20(i32 %x) pagerando {
+entry:
+  %c = load i32, i32* @counter, align 4
+  %a = add i32 %x, %c
+  %cmp = icmp sgt i32 %a, 100
+  br i1 %cmp, label %call, label %done
+
+call:
+  %r1 = call i32 @fn21(i32 %a)
+  %slot = getelementptr [8 x i32 (i32)*], [8 x i32 (i32)*]* @table, i32 0, i32 2
+  %fp = load i32 (i32)*, i32 (i32)** %slot, align 8
+  %r2 = call i32 %fp(i32 %r1)
+  store i32 %r2, i32* @counter, align 4
+  br label %done
+
+done:
+  %r = phi i32 [ %r2, %call ], [ %a, %entry ]
+  ret i32 %r
+}
+
+define i32 @fn21(i32 %x) pagerando {
+entry:
+  %c = load i32, i32* @counter, align 4
+  %a = add i32 %x, %c
+  %cmp = icmp sgt i32 %a, 105
+  br i1 %cmp, label %call, label %done
+
+call:
+  %r1 = call i32 @fn22(i32 %a)
+  %r2 = mul i32 %r1, 3
+  store i32 %r2, i32* @counter, align 4
+  br label %done
+
+done:
+  %r = phi i32 [ %r2, %call ], [ %a, %entry ]
+  ret i32 %r
+}
+
+define internal i32 @fn22(i32 %x) pagerando {
+entry:
+  %c = load i32, i32* @counter, align 4
+  %a = add i32 %x, %c
+  %cmp = icmp sgt i32 %a, 110
+  br i1 %cmp, label %call, label %done
+
+call:
+  %r1 = call i32 @fn23(i32 %a)
+  %r2 = mul i32 %r1, 3
+  store i32 %r2, i32* @counter, align 4
+  br label %done
+
+done:
+  %r = phi i32 [ %r2, %call ], [ %a, %entry ]
+  ret i32 %r
+}
+
+define hidden i32 @fn23(i32 %x) pagerando {
+entry:
+  %c = load i32, i32* @counter, align 4
+  %a = add i32 %x, %c
+  %cmp = icmp sgt i32 %a, 115
+  br i1 %cmp, label %call, label %done
+
+call:
+  %r1 = call i32 @fn24(i32 %a)
+  %r2 = mul i32 %r1, 3
+  store i32 %r2, i32* @counter, align 4
+  br label %done
+
+done:
+  %r = phi i32 [ %r2, %call ], [ %a, %entry ]
+  ret i32 %r
+}
+
+define i32 @fn24(i32 %x) pagerando {
+entry:
+  %c = load i32, i32* @counter, align 4
+  %a = add i32 %x, %c
+  %cmp = icmp sgt i32 %a, 120
+  br i1 %cmp, label %call, label %done
+
+call:
+  %r1 = call i32 @fn25(i32 %a)
+  %slot = getelementptr [8 x i32 (i32)*], [8 x i32 (i32)*]* @table, i32 0, i32 3
+  %fp = load i32 (i32)*, i32 (i32)** %slot, align 8
+  %r2 = call i32 %fp(i32 %r1)
+  store i32 %r2, i32* @counter, align 4
+  br label %done
+
+done:
+  %r = phi i32 [ %r2, %call ], [ %a, %entry ]
+  ret i32 %r
+}
+
+define internal i32 @fn25(i32 %x) pagerando {
+entry:
+  %c = load i32, i32* @counter, align 4
+  %a = add i32 %x, %c
+  %cmp = icmp sgt i32 %a, 125
+  br i1 %cmp, label %call, label %done
+
+call:
+  %r1 = call i32 @fn26(i32 %a)
+  %r2 = mul i32 %r1, 3
+  store i32 %r2, i32* @counter, align 4
+  br label %done
+
+done:
+  %r = phi i32 [ %r2, %call ], [ %a, %entry ]
+  ret i32 %r
+}
+
+define hidden i32 @fn26(i32 %x) pagerando {
+entry:
+  %c = load i32, i32* @counter, align 4
+  %a = add i32 %x, %c
+  %cmp = icmp sgt i32 %a, 130
+  br i1 %cmp, label %call, label %done
+
+call:
+  %r1 = call i32 @fn27(i32 %a)
+  %r2 = mul i32 %r1, 3
+  store i32 %r2, i32* @counter, align 4
+  br label %done
+
+done:
+  %r = phi i32 [ %r2, %call ], [ %a, %entry ]
+  ret i32 %r
+}
+
+define i32 @fn27(i32 %x) pagerando {
+entry:
+  %c = load i32, i32* @counter, align 4
+  %a = add i32 %x, %c
+  %cmp = icmp sgt i32 %a, 135
+  br i1 %cmp, label %call, label %done
+
+call:
+  %r1 = call i32 @fn28(i32 %a)
+  %r2 = mul i32 %r1, 3
+  store i32 %r2, i32* @counter, align 4
+  br label %done
+
+done:
+  %r = phi i32 [ %r2, %call ], [ %a, %entry ]
+  ret i32 %r
+}
+
+define internal i32 @fn28(i32 %x) pagerando {
+entry:
+  %c = load i32, i32* @counter, align 4
+  %a = add i32 %x, %c
+  %cmp = icmp sgt i32 %a, 140
+  br i1 %cmp, label %call, label %done
+
+call:
+  %r1 = call i32 @fn29(i32 %a)
+  %slot = getelementptr [8 x i32 (i32)*], [8 x i32 (i32)*]* @table, i32 0, i32 3
+  %fp = load i32 (i32)*, i32 (i32)** %slot, align 8
+  %r2 = call i32 %fp(i32 %r1)
+  store i32 %r2, i32* @counter, align 4
+  br label %done
+
+done:
+  %r = phi i32 [ %r2, %call ], [ %a, %entry ]
+  ret i32 %r
+}
+
+define hidden i32 @fn29(i32 %x) pagerando {
+entry:
+  %c = load i32, i32* @counter, align 4
+  %a = add i32 %x, %c
+  %cmp = icmp sgt i32 %a, 145
+  br i1 %cmp, label %call, label %done
+
+call:
+  %r1 = call i32 @fn30(i32 %a)
+  %r2 = mul i32 %r1, 3
+  store i32 %r2, i32* @counter, align 4
+  br label %done
+
+done:
+  %r = phi i32 [ %r2, %call ], [ %a, %entry ]
+  ret i32 %r
+}
+
+define i32 @fn30(i32 %x) pagerando {
+entry:
+  %c = load i32, i32* @counter, align 4
+  %a = add i32 %x, %c
+  %cmp = icmp sgt i32 %a, 150
+  br i1 %cmp, label %call, label %done
+
+call:
+  %r1 = call i32 @fn31(i32 %a)
+  %r2 = mul i32 %r1, 3
+  store i32 %r2, i32* @counter, align 4
+  br label %done
+
+done:
+  %r = phi i32 [ %r2, %call ], [ %a, %entry ]
+  ret i32 %r
+}
+
+define internal i32 @fn31(i32 %x) pagerando {
+entry:
+  %c = load i32, i32* @counter, align 4
+  %a = add i32 %x, %c
+  %cmp = icmp sgt i32 %a, 155
+  br i1 %cmp, label %call, label %done
+
+call:
+  %r1 = call i32 @fn32(i32 %a)
+  %r2 = mul i32 %r1, 3
+  store i32 %r2, i32* @counter, align 4
+  br label %done
+
+done:
+  %r = phi i32 [ %r2, %call ], [ %a, %entry ]
+  ret i32 %r
+}
+
+define hidden i32 @fn32(i32 %x) pagerando {
+entry:
+  %c = load i32, i32* @counter, align 4
+  %a = add i32 %x, %c
+  %cmp = icmp sgt i32 %a, 160
+  br i1 %cmp, label %call, label %done
+
+call:
+  %r1 = call i32 @fn33(i32 %a)
+  %slot = getelementptr [8 x i32 (i32)*], [8 x i32 (i32)*]* @table, i32 0, i32 4
+  %fp = load i32 (i32)*, i32 (i32)** %slot, align 8
+  %r2 = call i32 %fp(i32 %r1)
+  store i32 %r2, i32* @counter, align 4
+  br label %done
+
+done:
+  %r = phi i32 [ %r2, %call ], [ %a, %entry ]
+  ret i32 %r
+}
+
+define i32 @fn33(i32 %x) pagerando {
+entry:
+  %c = load i32, i32* @counter, align 4
+  %a = add i32 %x, %c
+  %cmp = icmp sgt i32 %a, 165
+  br i1 %cmp, label %call, label %done
+
+call:
+  %r1 = call i32 @fn34(i32 %a)
+  %r2 = mul i32 %r1, 3
+  store i32 %r2, i32* @counter, align 4
+  br label %done
+
+done:
+  %r = phi i32 [ %r2, %call ], [ %a, %entry ]
+  ret i32 %r
+}
+
+define internal i32 @fn34(i32 %x) pagerando {
+entry:
+  %c = load i32, i32* @counter, align 4
+  %a = add i32 %x, %c
+  %cmp = icmp sgt i32 %a, 170
+  br i1 %cmp, label %call, label %done
+
+call:
+  %r1 = call i32 @fn35(i32 %a)
+  %r2 = mul i32 %r1, 3
+  store i32 %r2, i32* @counter, align 4
+  br label %done
+
+done:
+  %r = phi i32 [ %r2, %call ], [ %a, %entry ]
+  ret i32 %r
+}
+
+define hidden i32 @fn35(i32 %x) pagerando {
+entry:
+  %c = load i32, i32* @counter, align 4
+  %a = add i32 %x, %c
+  %cmp = icmp sgt i32 %a, 175
+  br i1 %cmp, label %call, label %done
+
+call:
+  %r1 = call i32 @fn36(i32 %a)
+  %r2 = mul i32 %r1, 3
+  store i32 %r2, i32* @counter, align 4
+  br label %done
+
+done:
+  %r = phi i32 [ %r2, %call ], [ %a, %entry ]
+  ret i32 %r
+}
+
+define i32 @fn36(i32 %x) pagerando {
+entry:
+  %c = load i32, i32* @counter, align 4
+  %a = add i32 %x, %c
+  %cmp = icmp sgt i32 %a, 180
+  br i1 %cmp, label %call, label %done
+
+call:
+  %r1 = call i32 @fn37(i32 %a)
+  %slot = getelementptr [8 x i32 (i32)*], [8 x i32 (i32)*]* @table, i32 0, i32 4
+  %fp = load i32 (i32)*, i32 (i32)** %slot, align 8
+  %r2 = call i32 %fp(i32 %r1)
+  store i32 %r2, i32* @counter, align 4
+  br label %done
+
+done:
+  %r = phi i32 [ %r2, %call ], [ %a, %entry ]
+  ret i32 %r
+}
+
+define internal i32 @fn37(i32 %x) pagerando {
+entry:
+  %c = load i32, i32* @counter, align 4
+  %a = add i32 %x, %c
+  %cmp = icmp sgt i32 %a, 185
+  br i1 %cmp, label %call, label %done
+
+call:
+  %r1 = call i32 @fn38(i32 %a)
+  %r2 = mul i32 %r1, 3
+  store i32 %r2, i32* @counter, align 4
+  br label %done
+
+done:
+  %r = phi i32 [ %r2, %call ], [ %a, %entry ]
+  ret i32 %r
+}
+
+define hidden i32 @fn38(i32 %x) pagerando {
+entry:
+  %c = load i32, i32* @counter, align 4
+  %a = add i32 %x, %c
+  %cmp = icmp sgt i32 %a, 190
+  br i1 %cmp, label %call, label %done
+
+call:
+  %r1 = call i32 @fn39(i32 %a)
+  %r2 = mul i32 %r1, 3
+  store i32 %r2, i32* @counter, align 4
+  br label %done
+
+done:
+  %r = phi i32 [ %r2, %call ], [ %a, %entry ]
+  ret i32 %r
+}
+
+define i32 @fn39(i32 %x) pagerando {
+entry:
+  %c = load i32, i32* @counter, align 4
+  %a = add i32 %x, %c
+  %cmp = icmp sgt i32 %a, 195
+  br i1 %cmp, label %call, label %done
+
+call:
+  %r1 = call i32 @fn40(i32 %a)
+  %r2 = mul i32 %r1, 3
+  store i32 %r2, i32* @counter, align 4
+  br label %done
+
+done:
+  %r = phi i32 [ %r2, %call ], [ %a, %entry ]
+  ret i32 %r
+}
+
+define internal i32 @fn40(i32 %x) pagerando {
+entry:
+  %c = load i32, i32* @counter, align 4
+  %a = add i32 %x, %c
+  %cmp = icmp sgt i32 %a, 200
+  br i1 %cmp, label %call, label %done
+
+call:
+  %r1 = call i32 @fn41(i32 %a)
+  %slot = getelementptr [8 x i32 (i32)*], [8 x i32 (i32)*]* @table, i32 0, i32 5
+  %fp = load i32 (i32)*, i32 (i32)** %slot, align 8
+  %r2 = call i32 %fp(i32 %r1)
+  store i32 %r2, i32* @counter, align 4
+  br label %done
+
+done:
+  %r = phi i32 [ %r2, %call ], [ %a, %entry ]
+  ret i32 %r
+}
+
+define hidden i32 @fn41(i32 %x) pagerando {
+entry:
+  %c = load i32, i32* @counter, align 4
+  %a = add i32 %x, %c
+  %cmp = icmp sgt i32 %a, 205
+  br i1 %cmp, label %call, label %done
+
+call:
+  %r1 = call i32 @fn42(i32 %a)
+  %r2 = mul i32 %r1, 3
+  store i32 %r2, i32* @counter, align 4
+  br label %done
+
+done:
+  %r = phi i32 [ %r2, %call ], [ %a, %entry ]
+  ret i32 %r
+}
+
+define i32 @fn42(i32 %x) pagerando {
+entry:
+  %c = load i32, i32* @counter, align 4
+  %a = add i32 %x, %c
+  %cmp = icmp sgt i32 %a, 210
+  br i1 %cmp, label %call, label %done
+
+call:
+  %r1 = call i32 @fn43(i32 %a)
+  %r2 = mul i32 %r1, 3
+  store i32 %r2, i32* @counter, align 4
+  br label %done
+
+done:
+  %r = phi i32 [ %r2, %call ], [ %a, %entry ]
+  ret i32 %r
+}
+
+define internal i32 @fn43(i32 %x) pagerando {
+entry:
+  %c = load i32, i32* @counter, align 4
+  %a = add i32 %x, %c
+  %cmp = icmp sgt i32 %a, 215
+  br i1 %cmp, label %call, label %done
+
+call:
+  %r1 = call i32 @fn44(i32 %a)
+  %r2 = mul i32 %r1, 3
+  store i32 %r2, i32* @counter, align 4
+  br label %done
+
+done:
+  %r = phi i32 [ %r2, %call ], [ %a, %entry ]
+  ret i32 %r
+}
+
+define hidden i32 @fn44(i32 %x) pagerando {
+entry:
+  %c = load i32, i32* @counter, align 4
+  %a = add i32 %x, %c
+  %cmp = icmp sgt i32 %a, 220
+  br i1 %cmp, label %call, label %done
+
+call:
+  %r1 = call i32 @fn45(i32 %a)
+  %slot = getelementptr [8 x i32 (i32)*], [8 x i32 (i32)*]* @table, i32 0, i32 5
+  %fp = load i32 (i32)*, i32 (i32)** %slot, align 8
+  %r2 = call i32 %fp(i32 %r1)
+  store i32 %r2, i32* @counter, align 4
+  br label %done
+
+done:
+  %r = phi i32 [ %r2, %call ], [ %a, %entry ]
+  ret i32 %r
+}
+
+define i32 @fn45(i32 %x) pagerando {
+entry:
+  %c = load i32, i32* @counter, align 4
+  %a = add i32 %x, %c
+  %cmp = icmp sgt i32 %a, 225
+  br i1 %cmp, label %call, label %done
+
+call:
+  %r1 = call i32 @fn46(i32 %a)
+  %r2 = mul i32 %r1, 3
+  store i32 %r2, i32* @counter, align 4
+  br label %done
+
+done:
+  %r = phi i32 [ %r2, %call ], [ %a, %entry ]
+  ret i32 %r
+}
+
+define internal i32 @fn46(i32 %x) pagerando {
+entry:
+  %c = load i32, i32* @counter, align 4
+  %a = add i32 %x, %c
+  %cmp = icmp sgt i32 %a, 230
+  br i1 %cmp, label %call, label %done
+
+call:
+  %r1 = call i32 @fn47(i32 %a)
+  %r2 = mul i32 %r1, 3
+  store i32 %r2, i32* @counter, align 4
+  br label %done
+
+done:
+  %r = phi i32 [ %r2, %call ], [ %a, %entry ]
+  ret i32 %r
+}
+
+define hidden i32 @fn47(i32 %x) pagerando {
+entry:
+  %c = load i32, i32* @counter, align 4
+  %a = add i32 %x, %c
+  %cmp = icmp sgt i32 %a, 235
+  br i1 %cmp, label %call, label %done
+
+call:
+  %r1 = call i32 @fn48(i32 %a)
+  %r2 = mul i32 %r1, 3
+  store i32 %r2, i32* @counter, align 4
+  br label %done
+
+done:
+  %r = phi i32 [ %r2, %call ], [ %a, %entry ]
+  ret i32 %r
+}
+
+define i32 @fn48(i32 %x) pagerando {
+entry:
+  %c = load i32, i32* @counter, align 4
+  %a = add i32 %x, %c
+  %cmp = icmp sgt i32 %a, 240
+  br i1 %cmp, label %call, label %done
+
+call:
+  %r1 = call i32 @fn49(i32 %a)
+  %slot = getelementptr [8 x i32 (i32)*], [8 x i32 (i32)*]* @table, i32 0, i32 6
+  %fp = load i32 (i32)*, i32 (i32)** %slot, align 8
+  %r2 = call i32 %fp(i32 %r1)
+  store i32 %r2, i32* @counter, align 4
+  br label %done
+
+done:
+  %r = phi i32 [ %r2, %call ], [ %a, %entry ]
+  ret i32 %r
+}
+
+define internal i32 @fn49(i32 %x) pagerando {
+entry:
+  %c = load i32, i32* @counter, align 4
+  %a = add i32 %x, %c
+  %cmp = icmp sgt i32 %a, 245
+  br i1 %cmp, label %call, label %done
+
+call:
+  %r1 = call i32 @fn50(i32 %a)
+  %r2 = mul i32 %r1, 3
+  store i32 %r2, i32* @counter, align 4
+  br label %done
+
+done:
+  %r = phi i32 [ %r2, %call ], [ %a, %entry ]
+  ret i32 %r
+}
+
+define hidden i32 @fn50(i32 %x) pagerando {
+entry:
+  %c = load i32, i32* @counter, align 4
+  %a = add i32 %x, %c
+  %cmp = icmp sgt i32 %a, 250
+  br i1 %cmp, label %call, label %done
+
+call:
+  %r1 = call i32 @fn51(i32 %a)
+  %r2 = mul i32 %r1, 3
+  store i32 %r2, i32* @counter, align 4
+  br label %done
+
+done:
+  %r = phi i32 [ %r2, %call ], [ %a, %entry ]
+  ret i32 %r
+}
+
+define i32 @fn51(i32 %x) pagerando {
+entry:
+  %c = load i32, i32* @counter, align 4
+  %a = add i32 %x, %c
+  %cmp = icmp sgt i32 %a, 255
+  br i1 %cmp, label %call, label %done
+
+call:
+  %r1 = call i32 @fn52(i32 %a)
+  %r2 = mul i32 %r1, 3
+  store i32 %r2, i32* @counter, align 4
+  br label %done
+
+done:
+  %r = phi i32 [ %r2, %call ], [ %a, %entry ]
+  ret i32 %r
+}
+
+define internal i32 @fn52(i32 %x) pagerando {
+entry:
+  %c = load i32, i32* @counter, align 4
+  %a = add i32 %x, %c
+  %cmp = icmp sgt i32 %a, 260
+  br i1 %cmp, label %call, label %done
+
+call:
+  %r1 = call i32 @fn53(i32 %a)
+  %slot = getelementptr [8 x i32 (i32)*], [8 x i32 (i32)*]* @table, i32 0, i32 6
+  %fp = load i32 (i32)*, i32 (i32)** %slot, align 8
+  %r2 = call i32 %fp(i32 %r1)
+  store i32 %r2, i32* @counter, align 4
+  br label %done
+
+done:
+  %r = phi i32 [ %r2, %call ], [ %a, %entry ]
+  ret i32 %r
+}
+
+define hidden i32 @fn53(i32 %x) pagerando {
+entry:
+  %c = load i32, i32* @counter, align 4
+  %a = add i32 %x, %c
+  %cmp = icmp sgt i32 %a, 265
+  br i1 %cmp, label %call, label %done
+
+call:
+  %r1 = call i32 @fn54(i32 %a)
+  %r2 = mul i32 %r1, 3
+  store i32 %r2, i32* @counter, align 4
+  br label %done
+
+done:
+  %r = phi i32 [ %r2, %call ], [ %a, %entry ]
+  ret i32 %r
+}
+
+define i32 @fn54(i32 %x) pagerando {
+entry:
+  %c = load i32, i32* @counter, align 4
+  %a = add i32 %x, %c
+  %cmp = icmp sgt i32 %a, 270
+  br i1 %cmp, label %call, label %done
+
+call:
+  %r1 = call i32 @fn55(i32 %a)
+  %r2 = mul i32 %r1, 3
+  store i32 %r2, i32* @counter, align 4
+  br label %done
+
+done:
+  %r = phi i32 [ %r2, %call ], [ %a, %entry ]
+  ret i32 %r
+}
+
+define internal i32 @fn55(i32 %x) pagerando {
+entry:
+  %c = load i32, i32* @counter, align 4
+  %a = add i32 %x, %c
+  %cmp = icmp sgt i32 %a, 275
+  br i1 %cmp, label %call, label %done
+
+call:
+  %r1 = call i32 @fn56(i32 %a)
+  %r2 = mul i32 %r1, 3
+  store i32 %r2, i32* @counter, align 4
+  br label %done
+
+done:
+  %r = phi i32 [ %r2, %call ], [ %a, %entry ]
+  ret i32 %r
+}
+
+define hidden i32 @fn56(i32 %x) pagerando {
+entry:
+  %c = load i32, i32* @counter, align 4
+  %a = add i32 %x, %c
+  %cmp = icmp sgt i32 %a, 280
+  br i1 %cmp, label %call, label %done
+
+call:
+  %r1 = call i32 @fn57(i32 %a)
+  %slot = getelementptr [8 x i32 (i32)*], [8 x i32 (i32)*]* @table, i32 0, i32 7
+  %fp = load i32 (i32)*, i32 (i32)** %slot, align 8
+  %r2 = call i32 %fp(i32 %r1)
+  store i32 %r2, i32* @counter, align 4
+  br label %done
+
+done:
+  %r = phi i32 [ %r2, %call ], [ %a, %entry ]
+  ret i32 %r
+}
+
+define i32 @fn57(i32 %x) pagerando {
+entry:
+  %c = load i32, i32* @counter, align 4
+  %a = add i32 %x, %c
+  %cmp = icmp sgt i32 %a, 285
+  br i1 %cmp, label %call, label %done
+
+call:
+  %r1 = call i32 @fn58(i32 %a)
+  %r2 = mul i32 %r1, 3
+  store i32 %r2, i32* @counter, align 4
+  br label %done
+
+done:
+  %r = phi i32 [ %r2, %call ], [ %a, %entry ]
+  ret i32 %r
+}
+
+define internal i32 @fn58(i32 %x) pagerando {
+entry:
+  %c = load i32, i32* @counter, align 4
+  %a = add i32 %x, %c
+  %cmp = icmp sgt i32 %a, 290
+  br i1 %cmp, label %call, label %done
+
+call:
+  %r1 = call i32 @fn59(i32 %a)
+  %r2 = mul i32 %r1, 3
+  store i32 %r2, i32* @counter, align 4
+  br label %done
+
+done:
+  %r = phi i32 [ %r2, %call ], [ %a, %entry ]
+  ret i32 %r
+}
+
+define hidden i32 @fn59(i32 %x) pagerando {
+entry:
+  %c = load i32, i32* @counter, align 4
+  %a = add i32 %x, %c
+  %cmp = icmp sgt i32 %a, 295
+  br i1 %cmp, label %call, label %done
+
+call:
+  %r1 = call i32 @fn60(i32 %a)
+  %r2 = mul i32 %r1, 3
+  store i32 %r2, i32* @counter, align 4
+  br label %done
+
+done:
+  %r = phi i32 [ %r2, %call ], [ %a, %entry ]
+  ret i32 %r
+}
+
+define i32 @fn60(i32 %x) pagerando {
+entry:
+  %c = load i32, i32* @counter, align 4
+  %a = add i32 %x, %c
+  %cmp = icmp sgt i32 %a, 300
+  br i1 %cmp, label %call, label %done
+
+call:
+  %r1 = call i32 @fn61(i32 %a)
+  %slot = getelementptr [8 x i32 (i32)*], [8 x i32 (i32)*]* @table, i32 0, i32 7
+  %fp = load i32 (i32)*, i32 (i32)** %slot, align 8
+  %r2 = call i32 %fp(i32 %r1)
+  store i32 %r2, i32* @counter, align 4
+  br label %done
+
+done:
+  %r = phi i32 [ %r2, %call ], [ %a, %entry ]
+  ret i32 %r
+}
+
+define internal i32 @fn61(i32 %x) pagerando {
+entry:
+  %c = load i32, i32* @counter, align 4
+  %a = add i32 %x, %c
+  %cmp = icmp sgt i32 %a, 305
+  br i1 %cmp, label %call, label %done
+
+call:
+  %r1 = call i32 @fn62(i32 %a)
+  %r2 = mul i32 %r1, 3
+  store i32 %r2, i32* @counter, align 4
+  br label %done
+
+done:
+  %r = phi i32 [ %r2, %call ], [ %a, %entry ]
+  ret i32 %r
+}
+
+define hidden i32 @fn62(i32 %x) pagerando {
+entry:
+  %c = load i32, i32* @counter, align 4
+  %a = add i32 %x, %c
+  %cmp = icmp sgt i32 %a, 310
+  br i1 %cmp, label %call, label %done
+
+call:
+  %r1 = call i32 @fn63(i32 %a)
+  %r2 = mul i32 %r1, 3
+  store i32 %r2, i32* @counter, align 4
+  br label %done
+
+done:
+  %r = phi i32 [ %r2, %call ], [ %a, %entry ]
+  ret i32 %r
+}
+
+define i32 @fn63(i32 %x) pagerando {
+entry:
+  %c = load i32, i32* @counter, align 4
+  %a = add i32 %x, %c
+  %cmp = icmp sgt i32 %a, 315
+  br i1 %cmp, label %call, label %done
+
+call:
+  %r1 = add i32 %a, 1
+  %r2 = mul i32 %r1, 3
+  store i32 %r2, i32* @counter, align 4
+  br label %done
+
+done:
+  %r = phi i32 [ %r2, %call ], [ %a, %entry ]
+  ret i32 %r
+}
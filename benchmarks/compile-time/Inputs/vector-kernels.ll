@@ -0,0 +1,162 @@
+; Numeric loops that the loop vectorizer and SLP vectorizer transform at -O2:
+; a saxpy, a reduction, a stencil, a matrix multiply and a straight-line
+; complex multiply.
+
+define void @saxpy(float* noalias %y, float* noalias %x, float %a, i64 %n) {
+entry:
+  %empty = icmp eq i64 %n, 0
+  br i1 %empty, label %exit, label %loop
+
+loop:
+  %i = phi i64 [ 0, %entry ], [ %i.next, %loop ]
+  %x.addr = getelementptr inbounds float, float* %x, i64 %i
+  %y.addr = getelementptr inbounds float, float* %y, i64 %i
+  %xv = load float, float* %x.addr, align 4
+  %yv = load float, float* %y.addr, align 4
+  %mul = fmul float %xv, %a
+  %add = fadd float %mul, %yv
+  store float %add, float* %y.addr, align 4
+  %i.next = add nuw i64 %i, 1
+  %done = icmp eq i64 %i.next, %n
+  br i1 %done, label %exit, label %loop
+
+exit:
+  ret void
+}
+
+define i32 @dot(i32* %a, i32* %b, i64 %n) {
+entry:
+  %empty = icmp eq i64 %n, 0
+  br i1 %empty, label %exit, label %loop
+
+loop:
+  %i = phi i64 [ 0, %entry ], [ %i.next, %loop ]
+  %sum = phi i32 [ 0, %entry ], [ %sum.next, %loop ]
+  %a.addr = getelementptr inbounds i32, i32* %a, i64 %i
+  %b.addr = getelementptr inbounds i32, i32* %b, i64 %i
+  %av = load i32, i32* %a.addr, align 4
+  %bv = load i32, i32* %b.addr, align 4
+  %mul = mul nsw i32 %av, %bv
+  %sum.next = add nsw i32 %sum, %mul
+  %i.next = add nuw i64 %i, 1
+  %done = icmp eq i64 %i.next, %n
+  br i1 %done, label %exit, label %loop
+
+exit:
+  %r = phi i32 [ 0, %entry ], [ %sum.next, %loop ]
+  ret i32 %r
+}
+
+define void @stencil(double* noalias %out, double* noalias %in, i64 %n) {
+entry:
+  %small = icmp ult i64 %n, 3
+  br i1 %small, label %exit, label %preheader
+
+preheader:
+  %end = sub i64 %n, 1
+  br label %loop
+
+loop:
+  %i = phi i64 [ 1, %preheader ], [ %i.next, %loop ]
+  %prev = sub nuw i64 %i, 1
+  %i.next = add nuw i64 %i, 1
+  %l.addr = getelementptr inbounds double, double* %in, i64 %prev
+  %c.addr = getelementptr inbounds double, double* %in, i64 %i
+  %r.addr = getelementptr inbounds double, double* %in, i64 %i.next
+  %l = load double, double* %l.addr, align 8
+  %c = load double, double* %c.addr, align 8
+  %r = load double, double* %r.addr, align 8
+  %lr = fadd double %l, %r
+  %c2 = fmul double %c, 2.000000e+00
+  %s = fadd double %lr, %c2
+  %avg = fmul double %s, 2.500000e-01
+  %o.addr = getelementptr inbounds double, double* %out, i64 %i
+  store double %avg, double* %o.addr, align 8
+  %done = icmp eq i64 %i.next, %end
+  br i1 %done, label %exit, label %loop
+
+exit:
+  ret void
+}
+
+; C[i][j] += A[i][k] * B[k][j] over 64x64 matrices, with j innermost.
+define void @matmul([64 x float]* noalias %c, [64 x float]* noalias %a,
+                    [64 x float]* noalias %b) {
+entry:
+  br label %loop.i
+
+loop.i:
+  %i = phi i64 [ 0, %entry ], [ %i.next, %latch.i ]
+  br label %loop.k
+
+loop.k:
+  %k = phi i64 [ 0, %loop.i ], [ %k.next, %latch.k ]
+  %a.addr = getelementptr inbounds [64 x float], [64 x float]* %a, i64 %i, i64 %k
+  %av = load float, float* %a.addr, align 4
+  br label %loop.j
+
+loop.j:
+  %j = phi i64 [ 0, %loop.k ], [ %j.next, %loop.j ]
+  %b.addr = getelementptr inbounds [64 x float], [64 x float]* %b, i64 %k, i64 %j
+  %c.addr = getelementptr inbounds [64 x float], [64 x float]* %c, i64 %i, i64 %j
+  %bv = load float, float* %b.addr, align 4
+  %cv = load float, float* %c.addr, align 4
+  %mul = fmul float %av, %bv
+  %add = fadd float %cv, %mul
+  store float %add, float* %c.addr, align 4
+  %j.next = add nuw nsw i64 %j, 1
+  %done.j = icmp eq i64 %j.next, 64
+  br i1 %done.j, label %latch.k, label %loop.j
+
+latch.k:
+  %k.next = add nuw nsw i64 %k, 1
+  %done.k = icmp eq i64 %k.next, 64
+  br i1 %done.k, label %latch.i, label %loop.k
+
+latch.i:
+  %i.next = add nuw nsw i64 %i, 1
+  %done.i = icmp eq i64 %i.next, 64
+  br i1 %done.i, label %exit, label %loop.i
+
+exit:
+  ret void
+}
+
+; Two complex multiplies written out element by element, for SLP.
+define void @cmul2(double* noalias %out, double* noalias %x, double* noalias %y) {
+entry:
+  %x1.addr = getelementptr inbounds double, double* %x, i64 1
+  %x2.addr = getelementptr inbounds double, double* %x, i64 2
+  %x3.addr = getelementptr inbounds double, double* %x, i64 3
+  %y1.addr = getelementptr inbounds double, double* %y, i64 1
+  %y2.addr = getelementptr inbounds double, double* %y, i64 2
+  %y3.addr = getelementptr inbounds double, double* %y, i64 3
+  %x0 = load double, double* %x, align 8
+  %x1 = load double, double* %x1.addr, align 8
+  %x2 = load double, double* %x2.addr, align 8
+  %x3 = load double, double* %x3.addr, align 8
+  %y0 = load double, double* %y, align 8
+  %y1 = load double, double* %y1.addr, align 8
+  %y2 = load double, double* %y2.addr, align 8
+  %y3 = load double, double* %y3.addr, align 8
+  %re0.a = fmul double %x0, %y0
+  %re0.b = fmul double %x1, %y1
+  %re0 = fsub double %re0.a, %re0.b
+  %im0.a = fmul double %x0, %y1
+  %im0.b = fmul double %x1, %y0
+  %im0 = fadd double %im0.a, %im0.b
+  %re1.a = fmul double %x2, %y2
+  %re1.b = fmul double %x3, %y3
+  %re1 = fsub double %re1.a, %re1.b
+  %im1.a = fmul double %x2, %y3
+  %im1.b = fmul double %x3, %y2
+  %im1 = fadd double %im1.a, %im1.b
+  %o1.addr = getelementptr inbounds double, double* %out, i64 1
+  %o2.addr = getelementptr inbounds double, double* %out, i64 2
+  %o3.addr = getelementptr inbounds double, double* %out, i64 3
+  store double %re0, double* %out, align 8
+  store double %im0, double* %o1.addr, align 8
+  store double %re1, double* %o2.addr, align 8
+  store double %im1, double* %o3.addr, align 8
+  ret void
+}
@@ -105,7 +105,10 @@ typedef struct LLVMOptRemarkOpaqueParser *LLVMOptRemarkParserRef;
  * Creates a remark parser that can be used to read and parse the buffer located
  * in \p Buf of size \p Size.
  *
- * \p Buf cannot be NULL.
+ * \p Buf cannot be NULL. It may hold remarks in YAML or in the binary format
+ * written by -pass-remarks-format=binary, which is parsed one record at a time
+ * without building a document tree. The strings of the remarks returned for a
+ * binary buffer point into \p Buf.
  *
  * This function should be paired with LLVMOptRemarkParserDispose() to avoid
  * leaking resources.
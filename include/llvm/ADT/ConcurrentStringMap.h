@@ -0,0 +1,137 @@
+//===- ConcurrentStringMap.h - Thread-safe sharded StringMap ----*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines the ConcurrentStringMap class, a StringMap that can be
+// used from several threads at once.
+//
+// The keys are spread over NumShards StringMaps by the high bits of their
+// hash, each with its own lock, so threads working on different keys rarely
+// contend. A key is hashed once per operation and the hash is reused for the
+// lookup in its shard. Entries never move, so the entry pointers returned
+// stay valid until the entry is erased or the map is destroyed; accessing the
+// value through them is up to the caller to synchronize.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_ADT_CONCURRENTSTRINGMAP_H
+#define LLVM_ADT_CONCURRENTSTRINGMAP_H
+
+#include "llvm/ADT/StringMap.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/Allocator.h"
+#include <cstdint>
+#include <mutex>
+#include <utility>
+
+namespace llvm {
+
+template <typename ValueTy, unsigned NumShards = 64,
+          typename AllocatorTy = MallocAllocator>
+class ConcurrentStringMap {
+  static_assert(NumShards > 0, "need at least one shard");
+
+public:
+  using MapEntryTy = StringMapEntry<ValueTy>;
+
+  ConcurrentStringMap() = default;
+  ConcurrentStringMap(const ConcurrentStringMap &) = delete;
+  ConcurrentStringMap &operator=(const ConcurrentStringMap &) = delete;
+
+  /// Emplace a new entry for \p Key if there is none. Returns the entry for
+  /// \p Key, and whether it was inserted.
+  template <typename... ArgsTy>
+  std::pair<MapEntryTy *, bool> try_emplace(StringRef Key, ArgsTy &&... Args) {
+    uint32_t FullHashValue = StringMapImpl::hash(Key);
+    Shard &S = getShard(FullHashValue);
+    std::lock_guard<std::mutex> Lock(S.Mutex);
+    auto R = S.Map.try_emplace_with_hash(Key, FullHashValue,
+                                         std::forward<ArgsTy>(Args)...);
+    return std::make_pair(&*R.first, R.second);
+  }
+
+  /// Returns the entry for \p Key, or null if there is none.
+  MapEntryTy *find(StringRef Key) {
+    uint32_t FullHashValue = StringMapImpl::hash(Key);
+    Shard &S = getShard(FullHashValue);
+    std::lock_guard<std::mutex> Lock(S.Mutex);
+    auto I = S.Map.find(Key, FullHashValue);
+    return I == S.Map.end() ? nullptr : &*I;
+  }
+
+  /// Returns a copy of the value for \p Key, or a default constructed value
+  /// if there is none.
+  ValueTy lookup(StringRef Key) {
+    uint32_t FullHashValue = StringMapImpl::hash(Key);
+    Shard &S = getShard(FullHashValue);
+    std::lock_guard<std::mutex> Lock(S.Mutex);
+    auto I = S.Map.find(Key, FullHashValue);
+    return I == S.Map.end() ? ValueTy() : I->second;
+  }
+
+  size_t count(StringRef Key) { return find(Key) ? 1 : 0; }
+
+  bool erase(StringRef Key) {
+    uint32_t FullHashValue = StringMapImpl::hash(Key);
+    Shard &S = getShard(FullHashValue);
+    std::lock_guard<std::mutex> Lock(S.Mutex);
+    auto I = S.Map.find(Key, FullHashValue);
+    if (I == S.Map.end())
+      return false;
+    S.Map.erase(I);
+    return true;
+  }
+
+  /// Returns the number of entries. This is only a snapshot if other threads
+  /// modify the map.
+  size_t size() {
+    size_t Size = 0;
+    for (Shard &S : Shards) {
+      std::lock_guard<std::mutex> Lock(S.Mutex);
+      Size += S.Map.size();
+    }
+    return Size;
+  }
+
+  bool empty() { return size() == 0; }
+
+  /// Calls \p F on every entry, one shard at a time, with the lock of the
+  /// shard held: \p F must not use the map.
+  template <typename FnTy> void forEach(FnTy F) {
+    for (Shard &S : Shards) {
+      std::lock_guard<std::mutex> Lock(S.Mutex);
+      for (MapEntryTy &E : S.Map)
+        F(E);
+    }
+  }
+
+  void clear() {
+    for (Shard &S : Shards) {
+      std::lock_guard<std::mutex> Lock(S.Mutex);
+      S.Map.clear();
+    }
+  }
+
+private:
+  struct Shard {
+    std::mutex Mutex;
+    StringMap<ValueTy, AllocatorTy> Map;
+  };
+
+  // StringMap picks buckets with the low bits of the hash, so use the high
+  // bits to pick the shard.
+  Shard &getShard(uint32_t FullHashValue) {
+    return Shards[(uint64_t(FullHashValue) * NumShards) >> 32];
+  }
+
+  Shard Shards[NumShards];
+};
+
+} // end namespace llvm
+
+#endif // LLVM_ADT_CONCURRENTSTRINGMAP_H
@@ -9,6 +9,7 @@
 #ifndef LLVM_ADT_DELTAALGORITHM_H
 #define LLVM_ADT_DELTAALGORITHM_H
 
+#include <map>
 #include <set>
 #include <vector>
 
@@ -33,6 +34,12 @@ namespace llvm {
 /// requirements, and the algorithm will generally produce reasonable
 /// results. However, it may run substantially more tests than with a good
 /// predicate.
+///
+/// With a thread count above one (\see setThreadCount()), the tests that the
+/// next steps of the search may need are run speculatively in parallel, and
+/// the search then proceeds exactly as it would serially, reading their
+/// results from the cache. The result is therefore the same for any thread
+/// count, at the price of some tests whose results end up unused.
 class DeltaAlgorithm {
 public:
   using change_ty = unsigned;
@@ -41,9 +48,11 @@ public:
   using changesetlist_ty = std::vector<changeset_ty>;
 
 private:
-  /// Cache of failed test results. Successful test results are never cached
-  /// since we always reduce following a success.
-  std::set<changeset_ty> FailedTestsCache;
+  /// Cache of test results, keyed by the tested change set.
+  std::map<changeset_ty, bool> TestResultCache;
+
+  /// The number of tests to run at once.
+  unsigned ThreadCount = 1;
 
   /// GetTestResult - Get the test result for the \p Changes from the
   /// cache, executing the test if necessary.
@@ -69,12 +78,19 @@ private:
   bool Search(const changeset_ty &Changes, const changesetlist_ty &Sets,
               changeset_ty &Res);
 
+  /// Speculate - Run the tests that searching \p Sets, and failing that,
+  /// the partitions they split into, may need, in parallel, and cache the
+  /// results.
+  void Speculate(const changeset_ty &Changes, const changesetlist_ty &Sets);
+
 protected:
   /// UpdatedSearchState - Callback used when the search state changes.
   virtual void UpdatedSearchState(const changeset_ty &Changes,
                                   const changesetlist_ty &Sets) {}
 
   /// ExecuteOneTest - Execute a single test predicate on the change set \p S.
+  /// With a thread count above one, this is called from several threads at
+  /// once.
   virtual bool ExecuteOneTest(const changeset_ty &S) = 0;
 
   DeltaAlgorithm& operator=(const DeltaAlgorithm&) = default;
@@ -82,6 +98,10 @@ protected:
 public:
   virtual ~DeltaAlgorithm();
 
+  /// setThreadCount - Run up to \p N tests at once. \see ExecuteOneTest()
+  /// must then be thread-safe.
+  void setThreadCount(unsigned N) { ThreadCount = N ? N : 1; }
+
   /// Run - Minimize the set \p Changes by executing \see ExecuteOneTest() on
   /// subsets of changes and returning the smallest set which still satisfies
   /// the test predicate.
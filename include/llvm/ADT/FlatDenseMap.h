@@ -0,0 +1,530 @@
+//===- llvm/ADT/FlatDenseMap.h - Group-probed hash table --------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines the FlatDenseMap class, an open-addressing hash table with
+// the interface of DenseMap that probes its buckets 16 at a time.
+//
+// Each bucket has a control byte that says whether the bucket is empty, erased
+// or full, and for full buckets holds 7 bits of the hash of the key. Lookups
+// compare the control bytes of a group of buckets at once (with SSE2 where
+// available) and only compare the keys whose hash bits match, so a lookup
+// usually touches one cache line of control bytes and one key. As the state of
+// a bucket lives in its control byte, keys need no empty or tombstone value:
+// KeyInfoT only needs getHashValue() and isEqual().
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_ADT_FLATDENSEMAP_H
+#define LLVM_ADT_FLATDENSEMAP_H
+
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/DenseMapInfo.h"
+#include "llvm/Support/Compiler.h"
+#include "llvm/Support/MathExtras.h"
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) ||                                    \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define LLVM_FLATDENSEMAP_USE_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace llvm {
+
+namespace detail {
+
+/// Control byte values. A full bucket holds the low 7 bits of the hash of its
+/// key, so only empty and erased buckets have the sign bit set.
+enum : int8_t { FlatCtrlEmpty = -128, FlatCtrlErased = -2 };
+
+/// The number of buckets whose control bytes are probed together.
+constexpr unsigned FlatGroupWidth = 16;
+
+/// The control bytes of a group of buckets. The match functions return a
+/// mask with bit I set if bucket I of the group matches.
+class FlatGroup {
+public:
+  explicit FlatGroup(const int8_t *Pos) {
+#ifdef LLVM_FLATDENSEMAP_USE_SSE2
+    Ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i *>(Pos));
+#else
+    memcpy(Ctrl, Pos, FlatGroupWidth);
+#endif
+  }
+
+  /// Full buckets with hash bits \p H2.
+  uint32_t match(int8_t H2) const {
+#ifdef LLVM_FLATDENSEMAP_USE_SSE2
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(H2), Ctrl));
+#else
+    uint32_t Mask = 0;
+    for (unsigned I = 0; I != FlatGroupWidth; ++I)
+      Mask |= uint32_t(Ctrl[I] == H2) << I;
+    return Mask;
+#endif
+  }
+
+  uint32_t matchEmpty() const { return match(FlatCtrlEmpty); }
+
+  uint32_t matchEmptyOrErased() const {
+#ifdef LLVM_FLATDENSEMAP_USE_SSE2
+    return _mm_movemask_epi8(Ctrl);
+#else
+    uint32_t Mask = 0;
+    for (unsigned I = 0; I != FlatGroupWidth; ++I)
+      Mask |= uint32_t(Ctrl[I] < 0) << I;
+    return Mask;
+#endif
+  }
+
+private:
+#ifdef LLVM_FLATDENSEMAP_USE_SSE2
+  __m128i Ctrl;
+#else
+  int8_t Ctrl[FlatGroupWidth];
+#endif
+};
+
+} // end namespace detail
+
+template <typename KeyT, typename ValueT,
+          typename KeyInfoT = DenseMapInfo<KeyT>>
+class FlatDenseMap {
+  using BucketT = detail::DenseMapPair<KeyT, ValueT>;
+
+  template <bool IsConst> class Iterator {
+    friend class FlatDenseMap;
+    template <bool> friend class Iterator;
+
+  public:
+    using difference_type = ptrdiff_t;
+    using value_type =
+        typename std::conditional<IsConst, const BucketT, BucketT>::type;
+    using pointer = value_type *;
+    using reference = value_type &;
+    using iterator_category = std::forward_iterator_tag;
+
+    Iterator() = default;
+
+    // Allow conversion from iterator to const_iterator.
+    template <bool IsConstSrc,
+              typename = typename std::enable_if<!IsConstSrc && IsConst>::type>
+    Iterator(const Iterator<IsConstSrc> &I)
+        : Ctrl(I.Ctrl), End(I.End), Bucket(I.Bucket) {}
+
+    reference operator*() const { return *Bucket; }
+    pointer operator->() const { return Bucket; }
+
+    bool operator==(const Iterator &RHS) const { return Bucket == RHS.Bucket; }
+    bool operator!=(const Iterator &RHS) const { return Bucket != RHS.Bucket; }
+
+    Iterator &operator++() {
+      ++Ctrl;
+      ++Bucket;
+      skipNonFull();
+      return *this;
+    }
+    Iterator operator++(int) {
+      Iterator Tmp = *this;
+      ++*this;
+      return Tmp;
+    }
+
+  private:
+    Iterator(const int8_t *Ctrl, const int8_t *End, pointer Bucket,
+             bool NoAdvance = false)
+        : Ctrl(Ctrl), End(End), Bucket(Bucket) {
+      if (!NoAdvance)
+        skipNonFull();
+    }
+
+    void skipNonFull() {
+      while (Ctrl != End && *Ctrl < 0) {
+        ++Ctrl;
+        ++Bucket;
+      }
+    }
+
+    const int8_t *Ctrl = nullptr;
+    const int8_t *End = nullptr;
+    pointer Bucket = nullptr;
+  };
+
+public:
+  using size_type = unsigned;
+  using key_type = KeyT;
+  using mapped_type = ValueT;
+  using value_type = BucketT;
+  using iterator = Iterator<false>;
+  using const_iterator = Iterator<true>;
+
+  /// Create a map that can hold \p InitialReserve entries without growing.
+  explicit FlatDenseMap(unsigned InitialReserve = 0) {
+    if (InitialReserve)
+      allocateBuckets(getMinBucketsToReserve(InitialReserve));
+  }
+
+  FlatDenseMap(const FlatDenseMap &Other) { copyFrom(Other); }
+
+  FlatDenseMap(FlatDenseMap &&Other) { swap(Other); }
+
+  template <typename InputIt> FlatDenseMap(const InputIt &I, const InputIt &E) {
+    insert(I, E);
+  }
+
+  FlatDenseMap(std::initializer_list<std::pair<KeyT, ValueT>> Vals) {
+    reserve(Vals.size());
+    insert(Vals.begin(), Vals.end());
+  }
+
+  ~FlatDenseMap() {
+    destroyAll();
+    deallocateBuckets();
+  }
+
+  FlatDenseMap &operator=(const FlatDenseMap &Other) {
+    if (&Other != this) {
+      FlatDenseMap Tmp(Other);
+      swap(Tmp);
+    }
+    return *this;
+  }
+
+  FlatDenseMap &operator=(FlatDenseMap &&Other) {
+    destroyAll();
+    deallocateBuckets();
+    Buckets = nullptr;
+    Ctrl = nullptr;
+    NumBuckets = NumEntries = GrowthLeft = 0;
+    swap(Other);
+    return *this;
+  }
+
+  void swap(FlatDenseMap &RHS) {
+    std::swap(Buckets, RHS.Buckets);
+    std::swap(Ctrl, RHS.Ctrl);
+    std::swap(NumBuckets, RHS.NumBuckets);
+    std::swap(NumEntries, RHS.NumEntries);
+    std::swap(GrowthLeft, RHS.GrowthLeft);
+  }
+
+  iterator begin() { return makeIterator(0); }
+  iterator end() { return makeIterator(NumBuckets); }
+  const_iterator begin() const { return makeIterator(0); }
+  const_iterator end() const { return makeIterator(NumBuckets); }
+
+  LLVM_NODISCARD bool empty() const { return NumEntries == 0; }
+  unsigned size() const { return NumEntries; }
+
+  /// Grow the map so that it can hold \p NumEntries entries without growing.
+  void reserve(size_type NumEntries) {
+    unsigned MinBuckets = getMinBucketsToReserve(NumEntries);
+    if (MinBuckets > NumBuckets)
+      rehash(MinBuckets);
+  }
+
+  /// Remove all the entries, keeping the buckets.
+  void clear() {
+    if (!NumEntries && GrowthLeft == getMaxLoad(NumBuckets))
+      return;
+    destroyAll();
+    if (NumBuckets)
+      memset(Ctrl, detail::FlatCtrlEmpty, NumBuckets);
+    NumEntries = 0;
+    GrowthLeft = getMaxLoad(NumBuckets);
+  }
+
+  /// Return 1 if the specified key is in the map, 0 otherwise.
+  size_type count(const KeyT &Key) const {
+    return findIndex(Key, getHash(Key)) != NumBuckets;
+  }
+
+  iterator find(const KeyT &Key) {
+    return makeIterator(findIndex(Key, getHash(Key)), /*NoAdvance=*/true);
+  }
+  const_iterator find(const KeyT &Key) const {
+    return makeIterator(findIndex(Key, getHash(Key)), /*NoAdvance=*/true);
+  }
+
+  /// Return the entry for the specified key, or a default constructed value
+  /// if no such entry exists.
+  ValueT lookup(const KeyT &Key) const {
+    unsigned I = findIndex(Key, getHash(Key));
+    if (I != NumBuckets)
+      return Buckets[I].getSecond();
+    return ValueT();
+  }
+
+  // Inserts key,value pair into the map if the key isn't already in the map.
+  // If the key is already in the map, it returns false and doesn't update the
+  // value.
+  std::pair<iterator, bool> insert(const std::pair<KeyT, ValueT> &KV) {
+    return try_emplace(KV.first, KV.second);
+  }
+
+  std::pair<iterator, bool> insert(std::pair<KeyT, ValueT> &&KV) {
+    return try_emplace(std::move(KV.first), std::move(KV.second));
+  }
+
+  /// Insert a range of elements into the map.
+  template <typename InputIt> void insert(InputIt I, InputIt E) {
+    for (; I != E; ++I)
+      insert(*I);
+  }
+
+  // Inserts key,value pair into the map if the key isn't already in the map.
+  // The value is constructed in-place if the key is not in the map, otherwise
+  // it is not moved.
+  template <typename KeyArgT, typename... Ts>
+  std::pair<iterator, bool> try_emplace(KeyArgT &&Key, Ts &&... Args) {
+    uint64_t Hash = getHash(Key);
+    unsigned I = findIndex(Key, Hash);
+    if (I != NumBuckets)
+      return std::make_pair(makeIterator(I, /*NoAdvance=*/true), false);
+    I = prepareInsert(Hash);
+    ::new (&Buckets[I].getFirst()) KeyT(std::forward<KeyArgT>(Key));
+    ::new (&Buckets[I].getSecond()) ValueT(std::forward<Ts>(Args)...);
+    return std::make_pair(makeIterator(I, /*NoAdvance=*/true), true);
+  }
+
+  ValueT &operator[](const KeyT &Key) {
+    return try_emplace(Key).first->getSecond();
+  }
+
+  ValueT &operator[](KeyT &&Key) {
+    return try_emplace(std::move(Key)).first->getSecond();
+  }
+
+  bool erase(const KeyT &Key) {
+    unsigned I = findIndex(Key, getHash(Key));
+    if (I == NumBuckets)
+      return false;
+    eraseIndex(I);
+    return true;
+  }
+
+  void erase(iterator I) { eraseIndex(I.Bucket - Buckets); }
+
+  /// Return the approximate size (in bytes) of the actual map.
+  size_t getMemorySize() const {
+    return NumBuckets * (sizeof(BucketT) + sizeof(int8_t));
+  }
+
+private:
+  /// The largest number of entries in \p NumBuckets buckets.
+  static unsigned getMaxLoad(unsigned NumBuckets) {
+    return NumBuckets - NumBuckets / 8;
+  }
+
+  static unsigned getMinBucketsToReserve(unsigned NumEntries) {
+    unsigned NumBuckets = detail::FlatGroupWidth;
+    while (getMaxLoad(NumBuckets) < NumEntries)
+      NumBuckets *= 2;
+    return NumBuckets;
+  }
+
+  /// Mix the hash of \p Key: the low 7 bits go in the control byte and the
+  /// others select the first group to probe.
+  static uint64_t getHash(const KeyT &Key) {
+    uint64_t Hash =
+        uint64_t(KeyInfoT::getHashValue(Key)) * 0x9E3779B97F4A7C15ULL;
+    return Hash ^ (Hash >> 32);
+  }
+
+  static int8_t getH2(uint64_t Hash) { return Hash & 0x7f; }
+
+  /// Calls \p Probe on the groups in the probe sequence of \p Hash until it
+  /// returns true. There always is an empty bucket, so the probe sequence,
+  /// which visits every group, ends.
+  template <typename ProbeT>
+  unsigned probe(uint64_t Hash, ProbeT Probe) const {
+    const unsigned GroupMask = NumBuckets / detail::FlatGroupWidth - 1;
+    unsigned Group = (Hash >> 7) & GroupMask;
+    for (unsigned Step = 1;; ++Step) {
+      unsigned Result;
+      if (Probe(Group * detail::FlatGroupWidth, Result))
+        return Result;
+      Group = (Group + Step) & GroupMask;
+    }
+  }
+
+  /// Return the bucket of \p Key, or NumBuckets if it isn't in the map.
+  unsigned findIndex(const KeyT &Key, uint64_t Hash) const {
+    if (!NumBuckets)
+      return 0;
+    const int8_t H2 = getH2(Hash);
+    return probe(Hash, [&](unsigned First, unsigned &Result) {
+      detail::FlatGroup Group(Ctrl + First);
+      for (uint32_t Mask = Group.match(H2); Mask; Mask &= Mask - 1) {
+        unsigned I = First + countTrailingZeros(Mask);
+        if (LLVM_LIKELY(KeyInfoT::isEqual(Key, Buckets[I].getFirst()))) {
+          Result = I;
+          return true;
+        }
+      }
+      // No probe sequence goes on past a group with an empty bucket.
+      Result = NumBuckets;
+      return Group.matchEmpty() != 0;
+    });
+  }
+
+  /// Return the first empty or erased bucket in the probe sequence of \p Hash.
+  unsigned findFirstNonFull(uint64_t Hash) const {
+    return probe(Hash, [&](unsigned First, unsigned &Result) {
+      uint32_t Mask = detail::FlatGroup(Ctrl + First).matchEmptyOrErased();
+      if (!Mask)
+        return false;
+      Result = First + countTrailingZeros(Mask);
+      return true;
+    });
+  }
+
+  /// Pick the bucket for a new key with \p Hash, growing the map if needed,
+  /// and mark it full.
+  unsigned prepareInsert(uint64_t Hash) {
+    unsigned I = NumBuckets ? findFirstNonFull(Hash) : 0;
+    // Reusing an erased bucket leaves the number of empty buckets unchanged.
+    if (!GrowthLeft && (!NumBuckets || Ctrl[I] != detail::FlatCtrlErased)) {
+      grow();
+      I = findFirstNonFull(Hash);
+    }
+    GrowthLeft -= Ctrl[I] == detail::FlatCtrlEmpty;
+    Ctrl[I] = getH2(Hash);
+    ++NumEntries;
+    return I;
+  }
+
+  void eraseIndex(unsigned I) {
+    assert(I < NumBuckets && Ctrl[I] >= 0 && "erasing a non-existent entry");
+    Buckets[I].getSecond().~ValueT();
+    Buckets[I].getFirst().~KeyT();
+    --NumEntries;
+    // A group with an empty bucket ends all the probe sequences that reach it,
+    // so the bucket can become empty again rather than erased.
+    unsigned First = I & ~(detail::FlatGroupWidth - 1);
+    if (detail::FlatGroup(Ctrl + First).matchEmpty()) {
+      Ctrl[I] = detail::FlatCtrlEmpty;
+      ++GrowthLeft;
+    } else {
+      Ctrl[I] = detail::FlatCtrlErased;
+    }
+  }
+
+  /// Make room for a new entry: double the buckets, unless most of the used
+  /// buckets are erased ones, which rehashing at the same size reclaims.
+  void grow() {
+    if (!NumBuckets)
+      return allocateBuckets(detail::FlatGroupWidth);
+    rehash(NumEntries >= getMaxLoad(NumBuckets) / 2 ? NumBuckets * 2
+                                                    : NumBuckets);
+  }
+
+  void rehash(unsigned NewNumBuckets) {
+    BucketT *OldBuckets = Buckets;
+    int8_t *OldCtrl = Ctrl;
+    unsigned OldNumBuckets = NumBuckets;
+    unsigned OldNumEntries = NumEntries;
+    allocateBuckets(NewNumBuckets);
+
+    for (unsigned I = 0; I != OldNumBuckets; ++I) {
+      if (OldCtrl[I] < 0)
+        continue;
+      BucketT &B = OldBuckets[I];
+      uint64_t Hash = getHash(B.getFirst());
+      unsigned J = findFirstNonFull(Hash);
+      Ctrl[J] = getH2(Hash);
+      ::new (&Buckets[J].getFirst()) KeyT(std::move(B.getFirst()));
+      ::new (&Buckets[J].getSecond()) ValueT(std::move(B.getSecond()));
+      B.getSecond().~ValueT();
+      B.getFirst().~KeyT();
+    }
+    NumEntries = OldNumEntries;
+    GrowthLeft = getMaxLoad(NumBuckets) - NumEntries;
+
+    operator delete(OldBuckets);
+    delete[] OldCtrl;
+  }
+
+  /// Allocate \p Num empty buckets. The old ones must already be freed or
+  /// saved by the caller.
+  void allocateBuckets(unsigned Num) {
+    assert(Num % detail::FlatGroupWidth == 0 &&
+           isPowerOf2_32(Num / detail::FlatGroupWidth) &&
+           "bad number of buckets");
+    NumBuckets = Num;
+    Buckets = static_cast<BucketT *>(operator new(sizeof(BucketT) * Num));
+    Ctrl = new int8_t[Num];
+    memset(Ctrl, detail::FlatCtrlEmpty, Num);
+    NumEntries = 0;
+    GrowthLeft = getMaxLoad(Num);
+  }
+
+  void deallocateBuckets() {
+    operator delete(Buckets);
+    delete[] Ctrl;
+  }
+
+  void destroyAll() {
+    if (!NumEntries)
+      return;
+    for (unsigned I = 0; I != NumBuckets; ++I) {
+      if (Ctrl[I] < 0)
+        continue;
+      Buckets[I].getSecond().~ValueT();
+      Buckets[I].getFirst().~KeyT();
+    }
+  }
+
+  void copyFrom(const FlatDenseMap &Other) {
+    if (!Other.NumBuckets)
+      return;
+    allocateBuckets(Other.NumBuckets);
+    memcpy(Ctrl, Other.Ctrl, NumBuckets);
+    for (unsigned I = 0; I != NumBuckets; ++I) {
+      if (Ctrl[I] < 0)
+        continue;
+      ::new (&Buckets[I].getFirst()) KeyT(Other.Buckets[I].getFirst());
+      ::new (&Buckets[I].getSecond()) ValueT(Other.Buckets[I].getSecond());
+    }
+    NumEntries = Other.NumEntries;
+    GrowthLeft = Other.GrowthLeft;
+  }
+
+  /// Return an iterator to bucket \p I, or to the next full one unless
+  /// \p NoAdvance.
+  iterator makeIterator(unsigned I, bool NoAdvance = false) {
+    return iterator(Ctrl + I, Ctrl + NumBuckets, Buckets + I, NoAdvance);
+  }
+  const_iterator makeIterator(unsigned I, bool NoAdvance = false) const {
+    return const_iterator(Ctrl + I, Ctrl + NumBuckets, Buckets + I,
+                          NoAdvance);
+  }
+
+  BucketT *Buckets = nullptr;
+  /// One control byte per bucket.
+  int8_t *Ctrl = nullptr;
+  /// A multiple of FlatGroupWidth, with a power of two number of groups.
+  unsigned NumBuckets = 0;
+  unsigned NumEntries = 0;
+  /// How many more entries can go in empty buckets before the map grows.
+  unsigned GrowthLeft = 0;
+};
+
+} // end namespace llvm
+
+#endif // LLVM_ADT_FLATDENSEMAP_H
@@ -16,6 +16,8 @@
 #ifndef LLVM_ADT_FOLDINGSET_H
 #define LLVM_ADT_FOLDINGSET_H
 
+#include "llvm/ADT/Hashing.h"
+#include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/iterator.h"
 #include "llvm/Support/Allocator.h"
@@ -134,10 +136,19 @@ public:
   /// Node - This class is used to maintain the singly linked bucket list in
   /// a folding set.
   class Node {
+    friend class FoldingSetBase;
+
   private:
     // NextInFoldingSetBucket - next link in the bucket list.
     void *NextInFoldingSetBucket = nullptr;
 
+    // CachedHash - the hash of the node's profile, if HasCachedHash is set.
+    // It is computed at most once while the node is in a folding set, so
+    // that lookups can skip nodes of other hashes and rehashing does not
+    // profile the nodes again.
+    unsigned CachedHash = 0;
+    bool HasCachedHash = false;
+
   public:
     Node() = default;
 
@@ -177,6 +188,14 @@ private:
   /// bucket count.
   void GrowBucketCount(unsigned NewBucketCount);
 
+  /// GetCachedNodeHash - Return the hash of a node in the folding set,
+  /// computing it with TempID the first time.
+  unsigned GetCachedNodeHash(Node *N, FoldingSetNodeID &TempID) const;
+
+  /// InsertNodeImpl - Link N into the folding set, whose hash is cached if
+  /// it is known.
+  void InsertNodeImpl(Node *N, void *InsertPos);
+
 protected:
   /// GetNodeProfile - Instantiations of the FoldingSet template implement
   /// this function to gather data bits for the given node.
@@ -208,10 +227,20 @@ protected:
   /// faster.
   Node *FindNodeOrInsertPos(const FoldingSetNodeID &ID, void *&InsertPos);
 
+  /// FindNodeOrInsertPos - Look up the node whose profile has the hash IDHash
+  /// and for which Equals returns true.  Equals is only called with nodes of
+  /// that hash.
+  Node *FindNodeOrInsertPos(unsigned IDHash, function_ref<bool(Node *)> Equals,
+                            void *&InsertPos);
+
   /// InsertNode - Insert the specified node into the folding set, knowing that
   /// it is not already in the folding set.  InsertPos must be obtained from
   /// FindNodeOrInsertPos.
   void InsertNode(Node *N, void *InsertPos);
+
+  /// InsertNode - Like above, with the hash of the node's profile already
+  /// known, so that it doesn't have to be computed again.
+  void InsertNode(Node *N, void *InsertPos, unsigned Hash);
 };
 
 //===----------------------------------------------------------------------===//
@@ -355,6 +384,70 @@ public:
   FoldingSetNodeIDRef Intern(BumpPtrAllocator &Allocator) const;
 };
 
+//===--------------------------------------------------------------------===//
+/// FoldingSetHashBuilder - This class computes the same hash as a
+/// FoldingSetNodeID to which the same integers and pointers are added, but
+/// without storing them.  Lookups that can compare a node with what they look
+/// for without its profile can use it to find a node cheaply:
+///
+///   FoldingSetHashBuilder Hash;
+///   Hash.AddInteger(Kind);
+///   Hash.AddPointer(Operand);
+///   void *InsertPos;
+///   MyNode *N = Set.FindNodeOrInsertPos(
+///       Hash.ComputeHash(),
+///       [&](MyNode *N) { return N->Kind == Kind && N->Operand == Operand; },
+///       InsertPos);
+class FoldingSetHashBuilder {
+  // The data is hashed 64 bytes at a time like hash_combine_range does.  The
+  // block being filled is kept after the previous block, because the last 64
+  // bytes of the data are hashed again if it ends in the middle of a block.
+  static constexpr unsigned WordsPerBlock = 64 / sizeof(unsigned);
+
+  unsigned Buffer[2 * WordsPerBlock];
+  /// NumWords - Number of words in the current block.
+  unsigned NumWords = 0;
+  /// NumBlocks - Number of full blocks before the current block.
+  size_t NumBlocks = 0;
+  hashing::detail::hash_state State;
+
+  void AddWord(unsigned V) {
+    if (LLVM_UNLIKELY(NumWords == WordsPerBlock))
+      MixBlock();
+    Buffer[WordsPerBlock + NumWords++] = V;
+  }
+
+  void MixBlock();
+
+public:
+  void AddPointer(const void *Ptr) {
+    AddInteger(static_cast<unsigned long long>(
+        reinterpret_cast<uintptr_t>(Ptr)));
+  }
+  void AddInteger(signed I) { AddWord(I); }
+  void AddInteger(unsigned I) { AddWord(I); }
+  void AddInteger(long I) { AddInteger((unsigned long)I); }
+  void AddInteger(unsigned long I) {
+    static_assert(sizeof(long) == sizeof(int) ||
+                      sizeof(long) == sizeof(long long),
+                  "unexpected sizeof(long)");
+    if (sizeof(long) == sizeof(int))
+      AddInteger(unsigned(I));
+    else
+      AddInteger((unsigned long long)I);
+  }
+  void AddInteger(long long I) { AddInteger((unsigned long long)I); }
+  void AddInteger(unsigned long long I) {
+    AddInteger(unsigned(I));
+    AddInteger(unsigned(I >> 32));
+  }
+  void AddBoolean(bool B) { AddInteger(B ? 1U : 0U); }
+
+  /// ComputeHash - Return the hash of the data added so far.  It is equal to
+  /// FoldingSetNodeID::ComputeHash() for the same data.
+  unsigned ComputeHash() const;
+};
+
 // Convenience type to hide the implementation of the folding set.
 using FoldingSetNode = FoldingSetBase::Node;
 template<class T> class FoldingSetIterator;
@@ -446,6 +539,18 @@ public:
     return static_cast<T *>(FoldingSetBase::FindNodeOrInsertPos(ID, InsertPos));
   }
 
+  /// FindNodeOrInsertPos - Look up the node whose profile has the hash Hash,
+  /// typically computed with a FoldingSetHashBuilder, and for which Equals
+  /// returns true.  Equals is only called with nodes of that hash, so it
+  /// only has to tell apart nodes whose profiles differ.  If the node is not
+  /// found, return the insertion token for InsertNode.
+  template <typename EqualsTy>
+  T *FindNodeOrInsertPos(unsigned Hash, EqualsTy Equals, void *&InsertPos) {
+    return static_cast<T *>(FoldingSetBase::FindNodeOrInsertPos(
+        Hash, [&](Node *N) { return Equals(static_cast<T *>(N)); },
+        InsertPos));
+  }
+
   /// InsertNode - Insert the specified node into the folding set, knowing that
   /// it is not already in the folding set.  InsertPos must be obtained from
   /// FindNodeOrInsertPos.
@@ -453,6 +558,12 @@ public:
     FoldingSetBase::InsertNode(N, InsertPos);
   }
 
+  /// InsertNode - Like above, with the hash that was used to obtain
+  /// InsertPos, which must be the hash of the profile of N.
+  void InsertNode(T *N, void *InsertPos, unsigned Hash) {
+    FoldingSetBase::InsertNode(N, InsertPos, Hash);
+  }
+
   /// InsertNode - Insert the specified node into the folding set, knowing that
   /// it is not already in the folding set.
   void InsertNode(T *N) {
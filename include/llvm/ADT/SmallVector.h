@@ -211,7 +211,8 @@ protected:
 
   /// Grow the allocated memory (without initializing new elements), doubling
   /// the size of the allocated memory. Guarantees space for at least one more
-  /// element, or MinSize more elements if specified.
+  /// element, or MinSize more elements if specified. Trivially relocatable
+  /// elements are moved with memcpy or realloc.
   void grow(size_t MinSize = 0);
 
 public:
@@ -238,6 +239,11 @@ public:
 // Define this out-of-line to dissuade the C++ compiler from inlining it.
 template <typename T, bool isPodLike>
 void SmallVectorTemplateBase<T, isPodLike>::grow(size_t MinSize) {
+  if (isTriviallyRelocatable<T>::value) {
+    this->grow_pod(MinSize, sizeof(T));
+    return;
+  }
+
   if (MinSize > UINT32_MAX)
     report_bad_alloc_error("SmallVector capacity overflow during allocation");
 
@@ -44,16 +44,34 @@ namespace llvm {
 class raw_ostream;
 class raw_fd_ostream;
 class StringRef;
+namespace json {
+class Object;
+}
 
+/// A counter reported with -stats.
+///
+/// Updates to a statistic do not contend between threads: each thread counts
+/// in a counter of its own, and the value of the statistic is the sum of Value
+/// and of the counters of all threads. Reading it is accordingly slower than
+/// updating it.
 class Statistic {
 public:
   const char *DebugType;
   const char *Name;
   const char *Desc;
+  /// The part of the value not held in the per-thread counters.
   std::atomic<unsigned> Value;
   std::atomic<bool> Initialized;
+  /// One more than the index of the per-thread counters of this statistic, or
+  /// 0 if it has none, in which case updates go to Value.
+  std::atomic<unsigned> ShardIndex;
+
+  unsigned getValue() const;
+
+  /// Set the value without registering the statistic, accounting for the
+  /// per-thread counters.
+  void setValue(unsigned V);
 
-  unsigned getValue() const { return Value.load(std::memory_order_relaxed); }
   const char *getDebugType() const { return DebugType; }
   const char *getName() const { return Name; }
   const char *getDesc() const { return Desc; }
@@ -65,51 +83,54 @@ public:
     Desc = desc;
     Value = 0;
     Initialized = false;
+    ShardIndex = 0;
   }
 
   // Allow use of this class as the value itself.
   operator unsigned() const { return getValue(); }
 
 #if LLVM_ENABLE_STATS
-   const Statistic &operator=(unsigned Val) {
-    Value.store(Val, std::memory_order_relaxed);
-    return init();
+  const Statistic &operator=(unsigned Val) {
+    init().setValue(Val);
+    return *this;
   }
 
   const Statistic &operator++() {
-    Value.fetch_add(1, std::memory_order_relaxed);
-    return init();
+    init().add(1);
+    return *this;
   }
 
+  // The postfix operators return the value before the update as seen by this
+  // thread, which does not include updates from other threads in flight.
   unsigned operator++(int) {
-    init();
-    return Value.fetch_add(1, std::memory_order_relaxed);
+    return init().add(1);
   }
 
   const Statistic &operator--() {
-    Value.fetch_sub(1, std::memory_order_relaxed);
-    return init();
+    init().add(-1u);
+    return *this;
   }
 
   unsigned operator--(int) {
-    init();
-    return Value.fetch_sub(1, std::memory_order_relaxed);
+    return init().add(-1u);
   }
 
   const Statistic &operator+=(unsigned V) {
     if (V == 0)
       return *this;
-    Value.fetch_add(V, std::memory_order_relaxed);
-    return init();
+    init().add(V);
+    return *this;
   }
 
   const Statistic &operator-=(unsigned V) {
     if (V == 0)
       return *this;
-    Value.fetch_sub(V, std::memory_order_relaxed);
-    return init();
+    init().add(-V);
+    return *this;
   }
 
+  /// Raise the statistic to \p V if it is lower. This updates Value directly,
+  /// so a statistic tracking a maximum should not also be incremented.
   void updateMax(unsigned V) {
     unsigned PrevMax = Value.load(std::memory_order_relaxed);
     // Keep trying to update max until we succeed or another thread produces
@@ -162,12 +183,17 @@ protected:
   }
 
   void RegisterStatistic();
+
+  /// Add \p V to the counter of the calling thread, and return the value of
+  /// the statistic before the update as seen by this thread.
+  unsigned add(unsigned V);
 };
 
 // STATISTIC - A macro to make definition of statistics really simple.  This
 // automatically passes the DEBUG_TYPE of the file into the statistic.
 #define STATISTIC(VARNAME, DESC)                                               \
-  static llvm::Statistic VARNAME = {DEBUG_TYPE, #VARNAME, DESC, {0}, {false}}
+  static llvm::Statistic VARNAME = {                                           \
+      DEBUG_TYPE, #VARNAME, DESC, {0}, {false}, {0}}
 
 /// Enable the collection and printing of statistics.
 void EnableStatistics(bool PrintOnExit = true);
@@ -199,6 +225,12 @@ void PrintStatisticsJSON(raw_ostream &OS);
 /// completes.
 const std::vector<std::pair<StringRef, unsigned>> GetStatistics();
 
+/// Get the statistics as a JSON object mapping "<debug type>.<name>" to the
+/// value of each statistic, as PrintStatisticsJSON() prints them but without
+/// the timers. Unlike PrintStatisticsJSON(), this has no side effects, so a
+/// long-running process such as a JIT can call it as often as it likes.
+json::Object GetStatisticsJSON();
+
 /// Reset the statistics. This can be used to zero and de-register the
 /// statistics in order to measure a compilation.
 ///
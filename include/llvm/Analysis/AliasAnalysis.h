@@ -38,6 +38,7 @@
 #ifndef LLVM_ANALYSIS_ALIASANALYSIS_H
 #define LLVM_ANALYSIS_ALIASANALYSIS_H
 
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/None.h"
 #include "llvm/ADT/Optional.h"
 #include "llvm/ADT/SmallVector.h"
@@ -733,6 +734,48 @@ private:
 /// pointer or reference.
 using AliasAnalysis = AAResults;
 
+/// A wrapper around \c AAResults for a batch of queries during which the IR
+/// is not modified.
+///
+/// The alias analyses only cache results for the duration of one query, so a
+/// client that asks the same questions repeatedly pays for them every time.
+/// This wrapper remembers the results of top-level queries until it is
+/// destroyed. It must not be used across any change to the IR, since cached
+/// results are keyed on the values involved.
+class BatchAAResults {
+public:
+  BatchAAResults(AAResults &AAR) : AA(AAR) {}
+
+  AliasResult alias(const MemoryLocation &LocA, const MemoryLocation &LocB);
+  bool isNoAlias(const MemoryLocation &LocA, const MemoryLocation &LocB) {
+    return alias(LocA, LocB) == NoAlias;
+  }
+  bool isMustAlias(const MemoryLocation &LocA, const MemoryLocation &LocB) {
+    return alias(LocA, LocB) == MustAlias;
+  }
+  bool pointsToConstantMemory(const MemoryLocation &Loc,
+                              bool OrLocal = false) {
+    return AA.pointsToConstantMemory(Loc, OrLocal);
+  }
+  bool pointsToConstantMemory(const Value *P, bool OrLocal = false) {
+    return AA.pointsToConstantMemory(P, OrLocal);
+  }
+  FunctionModRefBehavior getModRefBehavior(ImmutableCallSite CS) {
+    return AA.getModRefBehavior(CS);
+  }
+  ModRefInfo getModRefInfo(const Instruction *I,
+                           const Optional<MemoryLocation> &OptLoc);
+  ModRefInfo getModRefInfo(Instruction *I, ImmutableCallSite Call);
+
+private:
+  AAResults &AA;
+  DenseMap<std::pair<MemoryLocation, MemoryLocation>, AliasResult> AliasCache;
+  DenseMap<std::pair<const Instruction *, MemoryLocation>, ModRefInfo>
+      LocModRefCache;
+  DenseMap<std::pair<const Instruction *, const Instruction *>, ModRefInfo>
+      CallModRefCache;
+};
+
 /// A private abstract base class describing the concept of an individual alias
 /// analysis implementation.
 ///
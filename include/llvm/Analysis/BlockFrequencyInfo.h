@@ -14,6 +14,7 @@
 #ifndef LLVM_ANALYSIS_BLOCKFREQUENCYINFO_H
 #define LLVM_ANALYSIS_BLOCKFREQUENCYINFO_H
 
+#include "llvm/ADT/Hashing.h"
 #include "llvm/ADT/Optional.h"
 #include "llvm/IR/PassManager.h"
 #include "llvm/Pass.h"
@@ -40,6 +41,10 @@ class BlockFrequencyInfo {
 
   std::unique_ptr<ImplType> BFI;
 
+  /// The CFG hash of the function when the frequencies were computed, if
+  /// results are reused for unchanged CFGs.
+  Optional<hash_code> CFGHash;
+
 public:
   BlockFrequencyInfo();
   BlockFrequencyInfo(const Function &F, const BranchProbabilityInfo &BPI,
@@ -17,6 +17,8 @@
 #include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/DenseMapInfo.h"
 #include "llvm/ADT/DenseSet.h"
+#include "llvm/ADT/Hashing.h"
+#include "llvm/ADT/Optional.h"
 #include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/IR/BasicBlock.h"
 #include "llvm/IR/CFG.h"
@@ -60,7 +62,7 @@ public:
   }
 
   BranchProbabilityInfo(BranchProbabilityInfo &&Arg)
-      : Probs(std::move(Arg.Probs)), LastF(Arg.LastF),
+      : Probs(std::move(Arg.Probs)), LastF(Arg.LastF), CFGHash(Arg.CFGHash),
         PostDominatedByUnreachable(std::move(Arg.PostDominatedByUnreachable)),
         PostDominatedByColdCall(std::move(Arg.PostDominatedByColdCall)) {}
 
@@ -70,6 +72,7 @@ public:
   BranchProbabilityInfo &operator=(BranchProbabilityInfo &&RHS) {
     releaseMemory();
     Probs = std::move(RHS.Probs);
+    CFGHash = RHS.CFGHash;
     PostDominatedByColdCall = std::move(RHS.PostDominatedByColdCall);
     PostDominatedByUnreachable = std::move(RHS.PostDominatedByUnreachable);
     return *this;
@@ -77,6 +80,16 @@ public:
 
   void releaseMemory();
 
+  /// Handle invalidation explicitly.
+  bool invalidate(Function &F, const PreservedAnalyses &PA,
+                  FunctionAnalysisManager::Invalidator &);
+
+  /// Return a hash of the parts of \p F that the probability heuristics look
+  /// at: the CFG, the terminators with their profile metadata and conditions,
+  /// and the calls. Results computed for a function with the same hash can be
+  /// reused.
+  static hash_code getCFGHash(const Function &F);
+
   void print(raw_ostream &OS) const;
 
   /// Get an edge's probability, relative to other out-edges of the Src.
@@ -182,6 +195,10 @@ private:
   /// Track the last function we run over for printing.
   const Function *LastF;
 
+  /// The CFG hash of LastF when the probabilities were computed, if results
+  /// are reused for unchanged CFGs.
+  Optional<hash_code> CFGHash;
+
   /// Track the set of blocks directly succeeded by a returning block.
   SmallPtrSet<const BasicBlock *, 16> PostDominatedByUnreachable;
 
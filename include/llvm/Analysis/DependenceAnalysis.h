@@ -40,6 +40,8 @@
 #ifndef LLVM_ANALYSIS_DEPENDENCEANALYSIS_H
 #define LLVM_ANALYSIS_DEPENDENCEANALYSIS_H
 
+#include "llvm/ADT/APInt.h"
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/SmallBitVector.h"
 #include "llvm/Analysis/AliasAnalysis.h"
 #include "llvm/IR/Instructions.h"
@@ -507,6 +509,31 @@ template <typename T> class ArrayRef;
 
     unsigned CommonLevels, SrcLevels, MaxLevels;
 
+    /// The decomposition of a pointer of the form {Base + Offset,+,Step}<L>,
+    /// with constant Offset and Step, used by the fast path of depends().
+    /// L is null for pointers of any other form.
+    struct AffineAccess {
+      const Loop *L = nullptr;
+      const SCEV *Base = nullptr;
+      APInt Offset, Step;
+    };
+
+    /// The decompositions computed so far, keyed by the pointer SCEV. Queries
+    /// come in pairs, so every pointer is usually decomposed many times.
+    DenseMap<const SCEV *, AffineAccess> AffineAccesses;
+
+    /// getAffineAccess - Returns the (cached) decomposition of Ptr.
+    AffineAccess getAffineAccess(const SCEV *Ptr);
+
+    /// tryAffineFastPath - Answers a query about two accesses in the same
+    /// outermost loop whose pointers are affine with the same constant
+    /// stride and a constant distance, without running the subscript tests.
+    /// Gives the same answer as the strong SIV test. Returns false if the fast
+    /// path does not apply, and otherwise sets Independent or fills in
+    /// Result.
+    bool tryAffineFastPath(const SCEV *SrcSCEV, const SCEV *DstSCEV,
+                           FullDependence &Result, bool &Independent);
+
     /// mapSrcLoop - Given one of the loops containing the source, return
     /// its level index in our numbering scheme.
     unsigned mapSrcLoop(const Loop *SrcLoop) const;
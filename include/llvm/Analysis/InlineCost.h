@@ -14,6 +14,7 @@
 #ifndef LLVM_ANALYSIS_INLINECOST_H
 #define LLVM_ANALYSIS_INLINECOST_H
 
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/Analysis/AssumptionCache.h"
 #include "llvm/Analysis/CallGraphSCCPass.h"
 #include "llvm/Analysis/OptimizationRemarkEmitter.h"
@@ -198,6 +199,42 @@ InlineParams getInlineParams(int Threshold);
 /// the -Oz flag.
 InlineParams getInlineParams(unsigned OptLevel, unsigned SizeOptLevel);
 
+/// Caches the part of the inline cost analysis that only depends on the
+/// callee. Call sites whose arguments enable no simplification in the callee
+/// (no constant or alloca-derived arguments and no extra parameter attributes)
+/// all walk the callee body in the same way, so the result of the first walk
+/// can be reused by the others. The owner must invalidate the summary of a
+/// function whenever its body changes.
+class InlineCostSummaryCache {
+public:
+  struct Summary {
+    /// The result of the walk, failing if an uninlinable pattern was found.
+    InlineResult Result;
+    /// The cost of the live instructions of the callee.
+    int Cost;
+    /// The number of bytes allocated statically by the callee.
+    uint64_t AllocatedSize;
+    unsigned NumInstructions;
+    unsigned NumVectorInstructions;
+    /// True if only one basic block of the callee is live.
+    bool SingleBB;
+    bool ContainsNoDuplicateCall;
+  };
+
+  const Summary *lookup(const Function &F) const {
+    auto I = Summaries.find(&F);
+    return I == Summaries.end() ? nullptr : &I->second;
+  }
+  void insert(const Function &F, const Summary &S) {
+    Summaries.insert({&F, S});
+  }
+  void invalidate(const Function &F) { Summaries.erase(&F); }
+  void clear() { Summaries.clear(); }
+
+private:
+  DenseMap<const Function *, Summary> Summaries;
+};
+
 /// Return the cost associated with a callsite, including parameter passing
 /// and the call/return instruction.
 int getCallsiteCost(CallSite CS, const DataLayout &DL);
@@ -213,11 +250,15 @@ int getCallsiteCost(CallSite CS, const DataLayout &DL);
 ///
 /// Also note that calling this function *dynamically* computes the cost of
 /// inlining the callsite. It is an expensive, heavyweight call.
+///
+/// If \p Summaries is given, call sites that do not depend on their arguments
+/// share one walk of the callee body.
 InlineCost getInlineCost(
     CallSite CS, const InlineParams &Params, TargetTransformInfo &CalleeTTI,
     std::function<AssumptionCache &(Function &)> &GetAssumptionCache,
     Optional<function_ref<BlockFrequencyInfo &(Function &)>> GetBFI,
-    ProfileSummaryInfo *PSI, OptimizationRemarkEmitter *ORE = nullptr);
+    ProfileSummaryInfo *PSI, OptimizationRemarkEmitter *ORE = nullptr,
+    InlineCostSummaryCache *Summaries = nullptr);
 
 /// Get an InlineCost with the callee explicitly specified.
 /// This allows you to calculate the cost of inlining a function via a
@@ -229,7 +270,8 @@ getInlineCost(CallSite CS, Function *Callee, const InlineParams &Params,
               TargetTransformInfo &CalleeTTI,
               std::function<AssumptionCache &(Function &)> &GetAssumptionCache,
               Optional<function_ref<BlockFrequencyInfo &(Function &)>> GetBFI,
-              ProfileSummaryInfo *PSI, OptimizationRemarkEmitter *ORE);
+              ProfileSummaryInfo *PSI, OptimizationRemarkEmitter *ORE,
+              InlineCostSummaryCache *Summaries = nullptr);
 
 /// Minimal filter to detect invalid constructs for inlining.
 bool isInlineViable(Function &Callee);
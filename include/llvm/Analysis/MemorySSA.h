@@ -884,6 +884,10 @@ private:
   // Memory SSA building info
   std::unique_ptr<CachingWalker> Walker;
   unsigned NextID;
+
+  // Bumped whenever accesses are added, moved, removed or renamed, so that the
+  // walker can tell when its cached clobbers are stale.
+  unsigned ModificationEpoch = 0;
 };
 
 // Internal MemorySSA utils, for use by MemorySSA classes and walkers
@@ -1432,6 +1432,12 @@ private:
   /// expression.
   const SCEV *createSCEV(Value *V);
 
+  /// Drop every memoized value mapping, backedge-taken count and per-SCEV
+  /// result. Called by getSCEV when the number of cached values exceeds
+  /// -scev-max-cached-values. The uniqued SCEV nodes themselves are kept, so
+  /// SCEV pointers held by clients stay valid.
+  void flushCaches();
+
   /// Provide the special handling we need to analyze PHI SCEVs.
   const SCEV *createNodeForPHI(PHINode *PN);
 
@@ -1871,6 +1877,18 @@ private:
   /// allocated. This is used by releaseMemory to locate them all and call
   /// their destructors.
   SCEVUnknown *FirstUnknown = nullptr;
+
+  /// Nesting depth of createSCEV and backedge-taken count computations. The
+  /// caches are only flushed when none of them is in progress.
+  unsigned CacheUseDepth = 0;
+
+  /// Number of getSCEV queries and how many of them were answered from
+  /// ValueExprMap, reported with -scev-cache-report.
+  unsigned NumQueries = 0;
+  unsigned NumCacheHits = 0;
+
+  /// Number of calls to flushCaches.
+  unsigned NumCacheFlushes = 0;
 };
 
 /// Analysis pass that exposes the \c ScalarEvolution for a function.
@@ -538,6 +538,8 @@ public:
 
   unsigned getLoadStoreVecRegBitWidth(unsigned AddrSpace) const { return 128; }
 
+  unsigned getMaxInlineSizeForMemIntrinsic(bool IsMemset) const { return 0; }
+
   bool isLegalToVectorizeLoad(LoadInst *LI) const { return true; }
 
   bool isLegalToVectorizeStore(StoreInst *SI) const { return true; }
@@ -20,7 +20,9 @@
 
 namespace llvm {
 
+class Constant;
 class DominatorTree;
+class Module;
 
 /// The type of CFI jumptable needed for a function.
 enum CfiFunctionLinkage {
@@ -51,6 +53,11 @@ void findDevirtualizableCallsForTypeCheckedLoad(
     SmallVectorImpl<Instruction *> &LoadedPtrs,
     SmallVectorImpl<Instruction *> &Preds, bool &HasNonCallUses,
     const CallInst *CI, DominatorTree &DT);
+
+/// Return the pointer stored at \p Offset bytes into the constant \p I, such
+/// as the initializer of a virtual table, or null if there is no pointer
+/// there.
+Constant *getPointerAtOffset(Constant *I, uint64_t Offset, const Module &M);
 }
 
 #endif
@@ -0,0 +1,59 @@
+//===- llvm/BinaryFormat/Pagerando.h - Pagerando POT encoding ---*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines the packed encoding of the Pagerando page offset table
+// (POT) and a reference implementation of its expansion by the loader.
+//
+// By default every POT entry refers to the start of its bin and needs a
+// dynamic relocation. With -pagerando-packed-pot, the bin entries of the POT
+// are zero-initialized and described by a packed table in the .pot.packed
+// section instead. For every module, the table holds a 32-bit bin count N
+// followed by N 32-bit offsets, one per POT entry after the leading GOT entry.
+// Each offset is relative to its own address, so the table is resolved by the
+// static linker and needs no dynamic relocations. The linker concatenates the
+// .pot and .pot.packed sections of all modules in the same order.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_BINARYFORMAT_PAGERANDO_H
+#define LLVM_BINARYFORMAT_PAGERANDO_H
+
+#include <cstdint>
+
+namespace llvm {
+namespace pagerando {
+
+/// Name of the section that holds the packed POT tables.
+static const char PackedPOTSectionName[] = ".pot.packed";
+
+/// Expand the packed POT tables in [Packed, End) into the POT starting at
+/// \p POT. The expanded entries hold the linked bin addresses and are then
+/// rebased by the loader like relative relocations. Returns the entry after
+/// the last one written.
+template <typename AddrT>
+AddrT *expandPackedPOT(AddrT *POT, const int32_t *Packed,
+                       const int32_t *End) {
+  while (Packed < End) {
+    uint32_t NumBins = static_cast<uint32_t>(*Packed++);
+    // Entry 0 of every module's POT refers to the GOT and is relocated
+    // normally.
+    ++POT;
+    uintptr_t Base = reinterpret_cast<uintptr_t>(Packed);
+    for (uint32_t I = 0; I != NumBins; ++I)
+      POT[I] = static_cast<AddrT>(Base + I * sizeof(int32_t) + Packed[I]);
+    POT += NumBins;
+    Packed += NumBins;
+  }
+  return POT;
+}
+
+} // end namespace pagerando
+} // end namespace llvm
+
+#endif // LLVM_BINARYFORMAT_PAGERANDO_H
@@ -248,6 +248,18 @@ public:
     BlockScope.pop_back();
   }
 
+  /// Emit a block that was encoded by another writer. \p Body holds the words
+  /// of that block that follow its header, starting with the block size.
+  void EmitEncodedBlock(unsigned BlockID, unsigned CodeLen,
+                        ArrayRef<char> Body) {
+    EmitCode(bitc::ENTER_SUBBLOCK);
+    EmitVBR(BlockID, bitc::BlockIDWidth);
+    EmitVBR(CodeLen, bitc::CodeLenWidth);
+    FlushToWord();
+    assert((Body.size() & 3) == 0 && "Not 32-bit aligned");
+    Out.append(Body.begin(), Body.end());
+  }
+
   //===--------------------------------------------------------------------===//
   // Record Emission
   //===--------------------------------------------------------------------===//
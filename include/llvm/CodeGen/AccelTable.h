@@ -146,8 +146,9 @@ public:
     std::vector<AccelTableData *> Values;
     MCSymbol *Sym;
 
-    HashData(DwarfStringPoolEntryRef Name, HashFn *Hash)
-        : Name(Name), HashValue(Hash(Name.getString())) {}
+    /// The hash value is computed when the table is finalized, so that the
+    /// names of large tables can be hashed in parallel.
+    HashData(DwarfStringPoolEntryRef Name) : Name(Name), HashValue(0) {}
 
 #ifndef NDEBUG
     void print(raw_ostream &OS) const;
@@ -176,6 +177,10 @@ protected:
   AccelTableBase(HashFn *Hash) : Entries(Allocator), Hash(Hash) {}
 
 public:
+  /// Hash the names, unique their values and compute the sorted contents of
+  /// the buckets. This is the part of finalize() that does not need an
+  /// AsmPrinter; large tables are processed in parallel.
+  void computeBuckets();
   void finalize(AsmPrinter *Asm, StringRef Prefix);
   ArrayRef<HashList> getBuckets() const { return Buckets; }
   uint32_t getBucketCount() const { return BucketCount; }
@@ -211,7 +216,7 @@ void AccelTable<AccelTableDataT>::addName(DwarfStringPoolEntryRef Name,
   assert(Buckets.empty() && "Already finalized!");
   // If the string is in the list already then add this die to the list
   // otherwise add a new one.
-  auto Iter = Entries.try_emplace(Name.getString(), Name, Hash).first;
+  auto Iter = Entries.try_emplace(Name.getString(), Name).first;
   assert(Iter->second.Name == Name);
   Iter->second.Values.push_back(
       new (Allocator) AccelTableDataT(std::forward<Types>(Args)...));
@@ -71,6 +71,7 @@ class MCSymbol;
 class MCTargetOptions;
 class MDNode;
 class Module;
+class PagerandoSizeFeedback;
 class raw_ostream;
 class StackMaps;
 class TargetLoweringObjectFile;
@@ -142,6 +143,9 @@ private:
   /// Sections that need to be referenced in the POT
   std::vector<const MCSection*> POT;
 
+  /// Final Pagerando function sizes, recorded if size feedback is requested.
+  std::unique_ptr<PagerandoSizeFeedback> PagerandoSizes;
+
 protected:
   /// Protected struct HandlerInfo and Handlers permit target extended
   /// AsmPrinter adds their own handlers.
@@ -681,6 +685,7 @@ private:
   void EmitJumpTableEntry(const MachineJumpTableInfo *MJTI,
                           const MachineBasicBlock *MBB, unsigned uid) const;
   void EmitPOT();
+  void EmitPackedPOT();
   void EmitLLVMUsedList(const ConstantArray *InitList);
   /// Emit llvm.ident metadata in an '.ident' directive.
   void EmitModuleIdents(Module &M);
@@ -204,6 +204,17 @@ public:
     return getTLI()->allowsMisalignedMemoryAccesses(E, AddressSpace, Alignment, Fast);
   }
 
+  unsigned getMaxInlineSizeForMemIntrinsic(bool IsMemset) const {
+    // SelectionDAG expands up to MaxStoresPerMem* stores of the widest legal
+    // integer type; wider vector stores only make the real limit larger.
+    const TargetLoweringBase *TLI = getTLI();
+    unsigned MaxStores = IsMemset ? TLI->getMaxStoresPerMemset(false)
+                                  : TLI->getMaxStoresPerMemcpy(false);
+    unsigned StoreSize =
+        this->getDataLayout().getLargestLegalIntTypeSizeInBits() / 8;
+    return MaxStores * std::max(1U, StoreSize);
+  }
+
   bool hasBranchDivergence() { return false; }
 
   bool isSourceOfDivergence(const Value *V) { return false; }
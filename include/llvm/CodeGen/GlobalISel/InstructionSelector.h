@@ -358,6 +358,11 @@ public:
   ///       !isPreISelGenericOpcode(I.getOpcode())
   virtual bool select(MachineInstr &I, CodeGenCoverage &CoverageInfo) const = 0;
 
+  /// Set up the state that depends on the function \p MF, such as the
+  /// function-level features, before its instructions are selected. This is
+  /// called once per function instead of once per selected instruction.
+  virtual void setupMF(const MachineFunction &MF) const {}
+
 protected:
   using ComplexRendererFns =
       Optional<SmallVector<std::function<void(MachineInstrBuilder &)>, 4>>;
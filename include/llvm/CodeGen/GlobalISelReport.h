@@ -0,0 +1,66 @@
+//===-- GlobalISelReport.h - GlobalISel fallback report ---------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+/// \file
+/// This file declares the report written with -global-isel-report. It lists
+/// every function that went through the GlobalISel pipeline, the time spent
+/// from IRTranslator to the end of instruction selection and, for functions
+/// that fell back to SelectionDAG, the pass and reason of the first failure.
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_CODEGEN_GLOBALISELREPORT_H
+#define LLVM_CODEGEN_GLOBALISELREPORT_H
+
+#include "llvm/ADT/StringMap.h"
+#include "llvm/Pass.h"
+#include "llvm/Support/Error.h"
+#include <string>
+
+namespace llvm {
+
+class MachineFunction;
+
+/// Per-function GlobalISel outcome, collected while the pipeline runs and
+/// written as JSON once the pass manager finishes. The pass is only added to
+/// the pipeline when a report was requested, GlobalISel passes look it up with
+/// getAnalysisIfAvailable.
+class GlobalISelReport : public ImmutablePass {
+public:
+  static char ID;
+  GlobalISelReport(StringRef Path = "");
+
+  /// Called by IRTranslator when it starts on \p MF.
+  void startFunction(const MachineFunction &MF);
+  /// Record the first GlobalISel failure in \p MF.
+  void recordFailure(const MachineFunction &MF, StringRef PassName,
+                     StringRef Reason);
+  /// Called once instruction selection of \p MF is finished or abandoned.
+  void finishFunction(const MachineFunction &MF);
+
+  bool doFinalization(Module &M) override;
+
+private:
+  struct FunctionStats {
+    double StartTime = 0;
+    double Time = 0;
+    bool FellBack = false;
+    std::string PassName;
+    std::string Reason;
+  };
+
+  Error writeToFile(StringRef Path) const;
+
+  std::string Path;
+  StringMap<FunctionStats> Functions;
+};
+
+ImmutablePass *createGlobalISelReportPass(StringRef Path);
+
+} // end namespace llvm
+
+#endif // LLVM_CODEGEN_GLOBALISELREPORT_H
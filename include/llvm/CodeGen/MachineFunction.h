@@ -303,6 +303,13 @@ class MachineFunction {
   // Allocation management for pseudo source values.
   std::unique_ptr<PseudoSourceValueManager> PSVManager;
 
+  /// Cached results of alias queries between pairs of memory operands. Memory
+  /// operands live as long as the function, so the results can be shared by
+  /// all schedulers that run on it.
+  DenseMap<std::pair<const MachineMemOperand *, const MachineMemOperand *>,
+           bool>
+      MemOperandAliasCache;
+
   /// List of moves done by a function's prolog.  Used to construct frame maps
   /// by debug and exception handling consumers.
   std::vector<MCCFIInstruction> FrameInstructions;
@@ -739,6 +746,14 @@ public:
   MachineMemOperand *getMachineMemOperand(const MachineMemOperand *MMO,
                                           const AAMDNodes &AAInfo);
 
+  /// Return the cache of alias query results between memory operands of this
+  /// function, see ScheduleDAGInstrs.
+  DenseMap<std::pair<const MachineMemOperand *, const MachineMemOperand *>,
+           bool> &
+  getMemOperandAliasCache() {
+    return MemOperandAliasCache;
+  }
+
   using OperandCapacity = ArrayRecycler<MachineOperand>::Capacity;
 
   /// Allocate an array of MachineOperands. This is only intended for use by
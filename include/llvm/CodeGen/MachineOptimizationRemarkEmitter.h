@@ -159,7 +159,7 @@ public:
   /// (1) to filter trivial false positives or (2) to provide more context so
   /// that non-trivial false positives can be quickly detected by the user.
   bool allowExtraAnalysis(StringRef PassName) const {
-    return (MF.getFunction().getContext().getDiagnosticsOutputFile() ||
+    return (MF.getFunction().getContext().hasDiagnosticsOutputFile() ||
             MF.getFunction().getContext()
             .getDiagHandlerPtr()->isAnyRemarkEnabled(PassName));
   }
@@ -172,7 +172,7 @@ public:
     // remarks enabled. We can't currently check whether remarks are requested
     // for the calling pass since that requires actually building the remark.
 
-    if (MF.getFunction().getContext().getDiagnosticsOutputFile() ||
+    if (MF.getFunction().getContext().hasDiagnosticsOutputFile() ||
         MF.getFunction().getContext().getDiagHandlerPtr()->isAnyRemarkEnabled()) {
       auto R = RemarkBuilder();
       emit((DiagnosticInfoOptimizationBase &)R);
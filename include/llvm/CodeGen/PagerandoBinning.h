@@ -15,11 +15,75 @@
 #ifndef LLVM_CODEGEN_PAGERANDOBINNING_H
 #define LLVM_CODEGEN_PAGERANDOBINNING_H
 
+#include "llvm/ADT/Optional.h"
+#include "llvm/ADT/StringMap.h"
 #include "llvm/Pass.h"
+#include "llvm/Support/Error.h"
 #include <map>
 
 namespace llvm {
 
+class MachineFunction;
+class ModuleSummaryIndex;
+
+/// Function sizes recorded after code generation. The AsmPrinter records the
+/// size of every Pagerando function once all size-changing machine passes
+/// (branch relaxation, constant islands, Pagerando optimizer) have run, so a
+/// subsequent compile can bin with final sizes instead of pre-RA estimates.
+/// The file format is one "<function name> <size>" pair per line, which allows
+/// files produced by separate compiles to be concatenated.
+class PagerandoSizeFeedback {
+public:
+  void recordSize(StringRef FnName, unsigned Size) { Sizes[FnName] = Size; }
+  Optional<unsigned> lookupSize(StringRef FnName) const;
+  bool empty() const { return Sizes.empty(); }
+
+  Error readFromFile(StringRef Path);
+  Error writeToFile(StringRef Path) const;
+
+private:
+  StringMap<unsigned> Sizes;
+};
+
+/// Bin packing statistics for -pagerando-bin-report. The binning pass records
+/// the bin and estimated size of every function and the call edges that cross
+/// bin boundaries, the AsmPrinter adds the final function sizes. The report is
+/// written as JSON once the pass manager finishes.
+class PagerandoBinReport : public ImmutablePass {
+public:
+  static char ID;
+  PagerandoBinReport();
+
+  /// True if a report was requested.
+  bool isEnabled() const;
+
+  void recordFunction(const Function &F, unsigned EstimatedSize);
+  void recordFinalSize(const Function &F, unsigned FinalSize);
+  void recordIslandSize(const Function &F, unsigned IslandSize);
+  void recordCrossBinCall(const Function &Caller, uint64_t Weight);
+  void setBinSize(unsigned Size) { BinSize = Size; }
+
+  bool doFinalization(Module &M) override;
+
+private:
+  struct FunctionStats {
+    std::string Bin;
+    unsigned EstimatedSize = 0;
+    unsigned FinalSize = 0;
+    unsigned IslandSize = 0;
+  };
+  struct CrossBinStats {
+    unsigned Calls = 0;
+    uint64_t Weight = 0;
+  };
+
+  StringMap<FunctionStats> Functions;
+  std::map<std::string, CrossBinStats> CrossBinCalls;
+  unsigned BinSize = 0;
+
+  Error writeToFile(StringRef Path) const;
+};
+
 class PagerandoBinnerBase : public ModulePass {
 public:
   explicit PagerandoBinnerBase(char &ID);
@@ -29,12 +93,25 @@ public:
   typedef unsigned Bin;
   static constexpr unsigned MinFnSize = 2;  // 'bx lr' on ARM thumb
   static constexpr auto SectionPrefix = ".bin_";
+  /// Function attribute that carries a bin assigned before code generation,
+  /// e.g., during the ThinLTO thin link.
+  static constexpr auto BinAttr = "pagerando-bin";
 
   bool runOnModule(Module &M) override;
 
+  /// Compute the size of a MachineFunction in bytes, including basic block
+  /// alignment padding and padding up to the function alignment. This is
+  /// shared by binning (size estimate) and the AsmPrinter (size feedback).
+  static unsigned computeFunctionSize(const MachineFunction &MF);
+
+  /// Return the bin preassigned via BinAttr, or 0 if there is none.
+  static Bin getPresetBin(const Function &F);
+
   class FirstFitAlgo {
   public:
-    Bin assignToBin(unsigned FnSize);
+    Bin assignToBin(unsigned FnSize, unsigned BinSize);
+    /// Do not place any further functions into the bins created so far.
+    void closeBins() { Bins.clear(); }
 
   private:
     // <free space  ->  bin numbers>
@@ -45,13 +122,34 @@ public:
 protected:
   virtual bool initializeBinning(Module &M);
   virtual Bin getBinAssignment(Function &F) = 0;
+  /// Called after all functions have been assigned to bins.
+  virtual bool finalizeBinning(Module &M);
 
   unsigned estimateFunctionSize(const Function &F);
 
+  /// Bin size in bytes, see TargetOptions::PagerandoBinSize.
+  unsigned BinSize = 0;
+
 private:
-  static void setBin(Function &F, Bin Bin);
+  PagerandoSizeFeedback SizeFeedback;
+
+  static void setBin(Function &F, Bin Bin, StringRef Suffix = "");
+  void reportBins(Module &M, PagerandoBinReport &Report);
 };
 
+/// Assign bins to all live Pagerando functions in a combined ThinLTO index.
+/// Bins are packed across module boundaries using the summary instruction
+/// counts as size estimates and call edge hotness to keep callers and callees
+/// together. The assignment is recorded in the index. \p BinSize must match
+/// TargetOptions::PagerandoBinSize of the backends.
+void computePagerandoBins(ModuleSummaryIndex &Index, unsigned BinSize);
+
+/// Attach the bins assigned by computePagerandoBins to the Pagerando functions
+/// defined in \p M, so that binning during code generation honors them, and to
+/// the declarations of functions defined in other modules.
+/// Must run before the module is renamed for ThinLTO promotion.
+void applyPagerandoBins(Module &M, const ModuleSummaryIndex &Index);
+
 } // end namespace llvm
 
 #endif
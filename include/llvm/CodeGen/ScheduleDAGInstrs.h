@@ -201,6 +201,11 @@ namespace llvm {
     void reduceHugeMemNodeMaps(Value2SUsMap &stores,
                                Value2SUsMap &loads, unsigned N);
 
+    /// Returns true if the memory accesses of MIa and MIb may alias. With
+    /// -sched-reuse-alias-queries, results of alias queries are cached in the
+    /// MachineFunction and reused by later scheduling passes.
+    bool mayAlias(MachineInstr &MIa, MachineInstr &MIb);
+
     /// Adds a chain edge between SUa and SUb, but only if both
     /// AliasAnalysis and Target fail to deny the dependency.
     void addChainDependency(SUnit *SUa, SUnit *SUb,
@@ -258,7 +258,9 @@ class SelectionDAG {
   /// CSE with existing nodes when a duplicate is requested.
   FoldingSet<SDNode> CSEMap;
 
-  /// Pool allocation for machine-opcode SDNode operands.
+  /// Pool allocation for machine-opcode SDNode operands. Operand lists freed
+  /// by clear() are recycled by the following blocks of the same function;
+  /// the arena is reset by init().
   BumpPtrAllocator OperandAllocator;
   ArrayRecycler<SDUse> OperandRecycler;
 
@@ -127,11 +127,21 @@ public:
     OPC_MoveChild0, OPC_MoveChild1, OPC_MoveChild2, OPC_MoveChild3,
     OPC_MoveChild4, OPC_MoveChild5, OPC_MoveChild6, OPC_MoveChild7,
     OPC_MoveParent,
+    OPC_MoveSibling,
+    OPC_MoveSibling0, OPC_MoveSibling1, OPC_MoveSibling2, OPC_MoveSibling3,
+    OPC_MoveSibling4, OPC_MoveSibling5, OPC_MoveSibling6, OPC_MoveSibling7,
     OPC_CheckSame,
     OPC_CheckChild0Same, OPC_CheckChild1Same,
     OPC_CheckChild2Same, OPC_CheckChild3Same,
     OPC_CheckPatternPredicate,
+    OPC_CheckPatternPredicate0, OPC_CheckPatternPredicate1,
+    OPC_CheckPatternPredicate2, OPC_CheckPatternPredicate3,
+    OPC_CheckPatternPredicate4, OPC_CheckPatternPredicate5,
+    OPC_CheckPatternPredicate6, OPC_CheckPatternPredicate7,
     OPC_CheckPredicate,
+    OPC_CheckPredicate0, OPC_CheckPredicate1, OPC_CheckPredicate2,
+    OPC_CheckPredicate3, OPC_CheckPredicate4, OPC_CheckPredicate5,
+    OPC_CheckPredicate6, OPC_CheckPredicate7,
     OPC_CheckPredicateWithOperands,
     OPC_CheckOpcode,
     OPC_SwitchOpcode,
@@ -350,6 +360,13 @@ private:
   /// state machines that start with a OPC_SwitchOpcode node.
   std::vector<unsigned> OpcodeOffset;
 
+  /// SwitchOpcodeCases - This caches the case that an OPC_SwitchOpcode node
+  /// with many cases dispatches to, keyed by the index of the node in the
+  /// matcher table and the opcode.  The value is the index of the case, or 0
+  /// if no case matches the opcode.  This saves the linear scan over the
+  /// cases of the large opcode switches nested in the state machine.
+  DenseMap<std::pair<unsigned, unsigned>, unsigned> SwitchOpcodeCases;
+
   void UpdateChains(SDNode *NodeToMatch, SDValue InputChain,
                     SmallVectorImpl<SDNode *> &ChainNodesMatched,
                     bool isMorphNodeTo);
@@ -324,6 +324,14 @@ public:
     return ~0U;
   }
 
+  /// Returns an estimate of the bytes of constant pool and jump table data
+  /// that the target will place inside the code of \p MF, for targets that
+  /// emit them as islands between the instructions. Used to estimate function
+  /// sizes before the islands exist.
+  virtual unsigned getInlineDataSizeEstimate(const MachineFunction &MF) const {
+    return 0;
+  }
+
   /// Return true if the instruction is as cheap as a move instruction.
   ///
   /// Targets for different archs need to override this, and different
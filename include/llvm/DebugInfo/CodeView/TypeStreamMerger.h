@@ -104,6 +104,34 @@ Error mergeIdRecords(GlobalTypeTableBuilder &Dest, ArrayRef<TypeIndex> Types,
                      const CVTypeArray &Ids,
                      ArrayRef<GloballyHashedType> Hashes);
 
+/// A unified set of type and id records along with their global hashes.
+struct GloballyHashedTypeSource {
+  const CVTypeArray *IdsAndTypes;
+  ArrayRef<GloballyHashedType> Hashes;
+};
+
+/// Merge several unified sets of type and id records at once, splitting them
+/// into separate output streams.
+///
+/// The global hashes of all records are first inserted into a concurrent hash
+/// table from \p NumThreads threads, which elects the first occurrence of
+/// every hash. Only those records are added to the destination tables, and
+/// their type indices are re-written in parallel. The result is the same as
+/// calling the global hashing mergeTypeAndIdRecords for each source in turn.
+///
+/// \param SourceToDest One vector per source, indexed by the TypeIndex in the
+/// source stream, that receives the index of the corresponding record in the
+/// destination streams.
+///
+/// \returns Error::success() if the operation succeeded, otherwise an
+/// appropriate error code. Sources with precompiled types are not supported.
+Error mergeTypeAndIdRecords(GlobalTypeTableBuilder &DestIds,
+                            GlobalTypeTableBuilder &DestTypes,
+                            MutableArrayRef<SmallVector<TypeIndex, 0>>
+                                SourceToDest,
+                            ArrayRef<GloballyHashedTypeSource> Sources,
+                            unsigned NumThreads);
+
 } // end namespace codeview
 } // end namespace llvm
 
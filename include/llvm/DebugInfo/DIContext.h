@@ -15,6 +15,7 @@
 #ifndef LLVM_DEBUGINFO_DICONTEXT_H
 #define LLVM_DEBUGINFO_DICONTEXT_H
 
+#include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/Object/ObjectFile.h"
 #include "llvm/Support/raw_ostream.h"
@@ -24,6 +25,7 @@
 #include <string>
 #include <tuple>
 #include <utility>
+#include <vector>
 
 namespace llvm {
 
@@ -206,6 +208,17 @@ public:
   virtual DIInliningInfo getInliningInfoForAddress(uint64_t Address,
       DILineInfoSpecifier Specifier = DILineInfoSpecifier()) = 0;
 
+  /// Returns the line info for each of the ascending \p Addresses.
+  virtual std::vector<DILineInfo> getLineInfoForAddresses(
+      ArrayRef<uint64_t> Addresses,
+      DILineInfoSpecifier Specifier = DILineInfoSpecifier()) {
+    std::vector<DILineInfo> Result;
+    Result.reserve(Addresses.size());
+    for (uint64_t Address : Addresses)
+      Result.push_back(getLineInfoForAddress(Address, Specifier));
+    return Result;
+  }
+
 private:
   const DIContextKind Kind;
 };
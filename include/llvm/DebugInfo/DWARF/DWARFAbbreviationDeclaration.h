@@ -177,6 +177,11 @@ private:
   /// If this abbreviation has a fixed byte size then FixedAttributeSize member
   /// variable below will have a value.
   Optional<FixedSizeInfo> FixedAttributeSize;
+  /// The offsets of the leading attributes from the end of the abbreviation
+  /// code, up to and including the first attribute that follows a variable
+  /// size form. Attributes such as DW_AT_name and DW_AT_low_pc usually come
+  /// first, so lookups of them don't need to skip any attribute data.
+  SmallVector<FixedSizeInfo, 8> AttributeOffsets;
 };
 
 } // end namespace llvm
@@ -187,6 +187,18 @@ public:
     return unit_iterator_range(DWOUnits.begin(), DWOUnits.end());
   }
 
+  /// Extract the DIEs of all units, including the units in the DWO sections
+  /// of this object, using \p NumThreads threads. Later queries then find the
+  /// DIEs extracted already. Units are extracted on the calling thread if
+  /// \p NumThreads is 0.
+  void extractAllDIEs(unsigned NumThreads);
+
+  /// Like the member function, but extracts the units of all \p Contexts on a
+  /// single set of threads, which also balances the work of many contexts
+  /// that only have a few units each.
+  static void extractAllDIEs(ArrayRef<DWARFContext *> Contexts,
+                             unsigned NumThreads);
+
   /// Get the number of compile units in this context.
   unsigned getNumCompileUnits() {
     parseNormalUnits();
@@ -326,6 +338,10 @@ public:
       DILineInfoSpecifier Specifier = DILineInfoSpecifier()) override;
   DIInliningInfo getInliningInfoForAddress(uint64_t Address,
       DILineInfoSpecifier Specifier = DILineInfoSpecifier()) override;
+  /// Looks up the addresses in a single pass over the address ranges and the
+  /// line table of each unit, instead of searching them for every address.
+  std::vector<DILineInfo> getLineInfoForAddresses(ArrayRef<uint64_t> Addresses,
+      DILineInfoSpecifier Specifier = DILineInfoSpecifier()) override;
 
   bool isLittleEndian() const { return DObj->isLittleEndian(); }
   static bool isSupportedVersion(unsigned version) {
@@ -23,6 +23,10 @@ class DWARFDebugAranges {
 public:
   void generate(DWARFContext *CTX);
   uint32_t findAddress(uint64_t Address) const;
+  /// Like findAddress, but walks the ranges from \p Hint, which is updated to
+  /// the position of this lookup. Addresses must be looked up in ascending
+  /// order, starting with a Hint of zero.
+  uint32_t findAddress(uint64_t Address, size_t &Hint) const;
 
 private:
   void clear();
@@ -25,9 +25,10 @@ class DWARFDebugInfoEntry {
   /// Offset within the .debug_info of the start of this entry.
   uint32_t Offset = 0;
 
-  /// The integer depth of this DIE within the compile unit DIEs where the
-  /// compile/type unit DIE has a depth of zero.
-  uint32_t Depth = 0;
+  /// The index of the parent of this DIE in the DIE array of its unit. The
+  /// parent of a NULL DIE is the DIE whose children it terminates. The
+  /// compile/type unit DIE has no parent and uses zero.
+  uint32_t ParentIdx = 0;
 
   const DWARFAbbreviationDeclaration *AbbrevDecl = nullptr;
 
@@ -42,10 +43,10 @@ public:
   /// High performance extraction should use this call.
   bool extractFast(const DWARFUnit &U, uint32_t *OffsetPtr,
                    const DWARFDataExtractor &DebugInfoData, uint32_t UEndOffset,
-                   uint32_t Depth);
+                   uint32_t ParentIdx);
 
   uint32_t getOffset() const { return Offset; }
-  uint32_t getDepth() const { return Depth; }
+  uint32_t getParentIdx() const { return ParentIdx; }
 
   dwarf::Tag getTag() const {
     return AbbrevDecl ? AbbrevDecl->getTag() : dwarf::DW_TAG_null;
@@ -226,6 +226,17 @@ public:
     /// or UnknownRowIndex if there is no such row.
     uint32_t lookupAddress(uint64_t Address) const;
 
+    /// The position of the previous lookup of a sequence of lookups.
+    struct Cursor {
+      const Sequence *Seq = nullptr;
+      uint32_t Row = 0;
+    };
+
+    /// Like lookupAddress, but if \p Address is in the sequence of the
+    /// previous lookup through \p C, walks the rows from its position instead
+    /// of searching them. Addresses must be looked up in ascending order.
+    uint32_t lookupAddress(uint64_t Address, Cursor &C) const;
+
     bool lookupAddressRange(uint64_t Address, uint64_t Size,
                             std::vector<uint32_t> &Result) const;
 
@@ -242,6 +253,9 @@ public:
     bool getFileLineInfoForAddress(uint64_t Address, const char *CompDir,
                                    DILineInfoSpecifier::FileLineInfoKind Kind,
                                    DILineInfo &Result) const;
+    bool getFileLineInfoForAddress(uint64_t Address, const char *CompDir,
+                                   DILineInfoSpecifier::FileLineInfoKind Kind,
+                                   DILineInfo &Result, Cursor &C) const;
 
     void dump(raw_ostream &OS, DIDumpOptions DumpOptions) const;
     void clear();
@@ -263,11 +277,40 @@ public:
     SequenceVector Sequences;
 
   private:
+    const Sequence *findSequence(uint64_t Address) const;
     uint32_t findRowInSeq(const DWARFDebugLine::Sequence &Seq,
                           uint64_t Address) const;
+    bool getFileLineInfoForRow(uint32_t RowIndex, const char *CompDir,
+                               DILineInfoSpecifier::FileLineInfoKind Kind,
+                               DILineInfo &Result) const;
+    bool getCachedFileName(uint64_t FileIndex, const char *CompDir,
+                           DILineInfoSpecifier::FileLineInfoKind Kind,
+                           std::string &Result) const;
     Optional<StringRef>
     getSourceByIndex(uint64_t FileIndex,
                      DILineInfoSpecifier::FileLineInfoKind Kind) const;
+
+    /// Builds the lookup index below unless it is up to date. Returns false
+    /// if there is nothing to index.
+    bool buildLookupIndex() const;
+
+    /// The start addresses of the sequences, followed by the row addresses of
+    /// each sequence, each laid out in Eytzinger (breadth-first) order so
+    /// that the nodes visited first by a search share cache lines. Built on
+    /// the first lookup.
+    mutable std::vector<uint64_t> LookupKeys;
+    /// The position in the sorted order of each node of LookupKeys.
+    mutable std::vector<uint32_t> LookupRanks;
+    /// Where the row addresses of each sequence start in LookupKeys.
+    mutable std::vector<uint32_t> SeqLookupOffsets;
+    mutable size_t LookupNumRows = 0;
+
+    /// The file names resolved for the last kind and compilation directory
+    /// rows were looked up with.
+    mutable std::vector<Optional<std::string>> FileNameCache;
+    mutable std::string FileNameCacheCompDir;
+    mutable DILineInfoSpecifier::FileLineInfoKind FileNameCacheKind =
+        DILineInfoSpecifier::FileLineInfoKind::None;
   };
 
   const LineTable *getLineTable(uint32_t Offset) const;
@@ -13,8 +13,10 @@
 #ifndef LLVM_DEBUGINFO_SYMBOLIZE_SYMBOLIZABLEMODULE_H
 #define LLVM_DEBUGINFO_SYMBOLIZE_SYMBOLIZABLEMODULE_H
 
+#include "llvm/ADT/ArrayRef.h"
 #include "llvm/DebugInfo/DIContext.h"
 #include <cstdint>
+#include <vector>
 
 namespace llvm {
 namespace symbolize {
@@ -33,6 +35,17 @@ public:
                                               bool UseSymbolTable) const = 0;
   virtual DIGlobal symbolizeData(uint64_t ModuleOffset) const = 0;
 
+  // Symbolize each of the ascending ModuleOffsets like symbolizeCode.
+  virtual std::vector<DILineInfo>
+  symbolizeCodeBatch(ArrayRef<uint64_t> ModuleOffsets, FunctionNameKind FNKind,
+                     bool UseSymbolTable) const {
+    std::vector<DILineInfo> Result;
+    Result.reserve(ModuleOffsets.size());
+    for (uint64_t ModuleOffset : ModuleOffsets)
+      Result.push_back(symbolizeCode(ModuleOffset, FNKind, UseSymbolTable));
+    return Result;
+  }
+
   // Return true if this is a 32-bit x86 PE COFF module.
   virtual bool isWin32Module() const = 0;
 
@@ -42,6 +42,9 @@ public:
     bool RelativeAddresses : 1;
     std::string DefaultArch;
     std::vector<std::string> DsymHints;
+    // If not empty, code queries for ELF modules with a build ID are answered
+    // from an address index that is kept in this directory.
+    std::string CacheDir;
 
     Options(FunctionNameKind PrintFunctions = FunctionNameKind::LinkageName,
             bool UseSymbolTable = true, bool Demangle = true,
@@ -60,6 +63,12 @@ public:
   Expected<DILineInfo> symbolizeCode(const std::string &ModuleName,
                                      uint64_t ModuleOffset,
                                      StringRef DWPName = "");
+  /// Symbolize each of \p ModuleOffsets like symbolizeCode, returning the
+  /// results in the same order. Ascending offsets are looked up in a single
+  /// pass over the debug info of the module.
+  Expected<std::vector<DILineInfo>>
+  symbolizeCodeBatch(const std::string &ModuleName,
+                     ArrayRef<uint64_t> ModuleOffsets, StringRef DWPName = "");
   Expected<DIInliningInfo> symbolizeInlinedCode(const std::string &ModuleName,
                                                 uint64_t ModuleOffset,
                                                 StringRef DWPName = "");
@@ -83,6 +92,13 @@ private:
   Expected<SymbolizableModule *>
   getOrCreateModuleInfo(const std::string &ModuleName, StringRef DWPName = "");
 
+  /// Returns a module that answers code queries for \p Obj from its address
+  /// index in Opts.CacheDir, creating the index if needed, or \p Module if
+  /// \p Obj can't be indexed.
+  std::unique_ptr<SymbolizableModule>
+  createAddressIndex(const ObjectFile &Obj, DIContext *DICtx,
+                     std::unique_ptr<SymbolizableModule> Module);
+
   ObjectFile *lookUpDsymFile(const std::string &Path,
                              const MachOObjectFile *ExeObj,
                              const std::string &ArchName);
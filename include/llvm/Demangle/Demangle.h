@@ -31,6 +31,36 @@ enum : int {
 char *itaniumDemangle(const char *mangled_name, char *buf, size_t *n,
                       int *status);
 
+/// Demangles Itanium names one after another. Unlike itaniumDemangle, which
+/// allocates a parser and an output buffer for every name, it keeps the
+/// memory of both from one name to the next. Tools that demangle every symbol
+/// they print should use one, but not from several threads at once.
+class ItaniumDemangleContext {
+public:
+  ItaniumDemangleContext();
+  ~ItaniumDemangleContext();
+
+  ItaniumDemangleContext(const ItaniumDemangleContext &) = delete;
+  ItaniumDemangleContext &operator=(const ItaniumDemangleContext &) = delete;
+
+  /// Demangle MangledName. Return the demangled name, which is valid until
+  /// the next call, or nullptr if MangledName is not a valid mangled name.
+  const char *demangle(const char *MangledName);
+
+  /// Demangle the N names of MangledNames into a single buffer, each result
+  /// followed by a '\0'. A name that is not a valid mangled name is copied
+  /// unchanged. Set Offsets[I] to the offset of the result for
+  /// MangledNames[I] in the buffer, and return the buffer, which is valid
+  /// until the next call.
+  const char *demangle(const char *const *MangledNames, size_t N,
+                       size_t *Offsets);
+
+private:
+  void *Context;
+  char *Buf;
+  size_t Capacity;
+};
+
 
 enum MSDemangleFlags { MSDF_None = 0, MSDF_DumpBackrefs = 1 << 0 };
 char *microsoftDemangle(const char *mangled_name, char *buf, size_t *n,
@@ -94,6 +94,9 @@ public:
 
   /// Emits the given module. This should not be called by clients: it will be
   /// called by the JIT when a definition added via the add method is requested.
+  ///
+  /// The module may be loaded lazily (see loadLazyBitcodeModule), in which
+  /// case the function bodies are only read when their partition is emitted.
   void emit(MaterializationResponsibility R, ThreadSafeModule TSM) override;
 
 private:
@@ -28,6 +28,8 @@
 #include "llvm/Target/TargetMachine.h"
 #include <algorithm>
 #include <memory>
+#include <mutex>
+#include <vector>
 
 namespace llvm {
 
@@ -103,25 +105,55 @@ private:
 
 /// A thread-safe version of SimpleCompiler.
 ///
-/// This class creates a new TargetMachine and SimpleCompiler instance for each
-/// compile.
+/// This class gives each compile a TargetMachine of its own. TargetMachines
+/// are created as needed and reused by later compiles, so that there are only
+/// as many as there are concurrent compiles. Copies of a ConcurrentIRCompiler
+/// share their TargetMachines.
 class ConcurrentIRCompiler {
 public:
   ConcurrentIRCompiler(JITTargetMachineBuilder JTMB,
                        ObjectCache *ObjCache = nullptr)
-      : JTMB(std::move(JTMB)), ObjCache(ObjCache) {}
+      : JTMB(std::move(JTMB)), ObjCache(ObjCache),
+        IdleTMs(std::make_shared<TargetMachinePool>()) {}
 
   void setObjectCache(ObjectCache *ObjCache) { this->ObjCache = ObjCache; }
 
   std::unique_ptr<MemoryBuffer> operator()(Module &M) {
-    auto TM = cantFail(JTMB.createTargetMachine());
-    SimpleCompiler C(*TM, ObjCache);
-    return C(M);
+    auto TM = IdleTMs->take(JTMB);
+    auto Obj = SimpleCompiler(*TM, ObjCache)(M);
+    IdleTMs->put(std::move(TM));
+    return Obj;
   }
 
 private:
+  /// The TargetMachines that no compile is using.
+  class TargetMachinePool {
+  public:
+    std::unique_ptr<TargetMachine> take(JITTargetMachineBuilder &JTMB) {
+      {
+        std::lock_guard<std::mutex> Lock(Mutex);
+        if (!TMs.empty()) {
+          auto TM = std::move(TMs.back());
+          TMs.pop_back();
+          return TM;
+        }
+      }
+      return cantFail(JTMB.createTargetMachine());
+    }
+
+    void put(std::unique_ptr<TargetMachine> TM) {
+      std::lock_guard<std::mutex> Lock(Mutex);
+      TMs.push_back(std::move(TM));
+    }
+
+  private:
+    std::mutex Mutex;
+    std::vector<std::unique_ptr<TargetMachine>> TMs;
+  };
+
   JITTargetMachineBuilder JTMB;
   ObjectCache *ObjCache = nullptr;
+  std::shared_ptr<TargetMachinePool> IdleTMs;
 };
 
 } // end namespace orc
@@ -114,6 +114,18 @@ public:
   /// Access Triple.
   const Triple &getTargetTriple() const { return TT; }
 
+  /// Get the CPU string.
+  const std::string &getCPU() const { return CPU; }
+
+  /// Get the relocation model.
+  const Optional<Reloc::Model> &getRelocationModel() const { return RM; }
+
+  /// Get the code model.
+  const Optional<CodeModel::Model> &getCodeModel() const { return CM; }
+
+  /// Get the LLVM CodeGen optimization level.
+  CodeGenOpt::Level getCodeGenOptLevel() const { return OptLevel; }
+
 private:
   Triple TT;
   std::string CPU;
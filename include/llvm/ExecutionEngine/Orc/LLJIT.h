@@ -39,9 +39,11 @@ public:
   /// Create an LLJIT instance.
   /// If NumCompileThreads is not equal to zero, creates a multi-threaded
   /// LLJIT with the given number of compile threads.
+  /// If ObjCache is not null, compiles query it first and store their objects
+  /// in it. It must outlive the instance.
   static Expected<std::unique_ptr<LLJIT>>
   Create(JITTargetMachineBuilder JTMB, DataLayout DL,
-         unsigned NumCompileThreads = 0);
+         unsigned NumCompileThreads = 0, ObjectCache *ObjCache = nullptr);
 
   /// Returns the ExecutionSession for this instance.
   ExecutionSession &getExecutionSession() { return *ES; }
@@ -110,11 +112,11 @@ protected:
 
   /// Create an LLJIT instance with a single compile thread.
   LLJIT(std::unique_ptr<ExecutionSession> ES, std::unique_ptr<TargetMachine> TM,
-        DataLayout DL);
+        DataLayout DL, ObjectCache *ObjCache);
 
   /// Create an LLJIT instance with multiple compile threads.
   LLJIT(std::unique_ptr<ExecutionSession> ES, JITTargetMachineBuilder JTMB,
-        DataLayout DL, unsigned NumCompileThreads);
+        DataLayout DL, unsigned NumCompileThreads, ObjectCache *ObjCache);
 
   std::string mangle(StringRef UnmangledName);
 
@@ -142,9 +144,12 @@ public:
   /// Create an LLLazyJIT instance.
   /// If NumCompileThreads is not equal to zero, creates a multi-threaded
   /// LLLazyJIT with the given number of compile threads.
+  /// If ObjCache is not null, compiles query it first and store their objects
+  /// in it. It must outlive the instance.
   static Expected<std::unique_ptr<LLLazyJIT>>
   Create(JITTargetMachineBuilder JTMB, DataLayout DL,
-         JITTargetAddress ErrorAddr, unsigned NumCompileThreads = 0);
+         JITTargetAddress ErrorAddr, unsigned NumCompileThreads = 0,
+         ObjectCache *ObjCache = nullptr);
 
   /// Set an IR transform (e.g. pass manager pipeline) to run on each function
   /// when it is compiled.
@@ -171,12 +176,13 @@ private:
   // Create a single-threaded LLLazyJIT instance.
   LLLazyJIT(std::unique_ptr<ExecutionSession> ES,
             std::unique_ptr<TargetMachine> TM, DataLayout DL,
+            ObjectCache *ObjCache,
             std::unique_ptr<LazyCallThroughManager> LCTMgr,
             std::function<std::unique_ptr<IndirectStubsManager>()> ISMBuilder);
 
   // Create a multi-threaded LLLazyJIT instance.
   LLLazyJIT(std::unique_ptr<ExecutionSession> ES, JITTargetMachineBuilder JTMB,
-            DataLayout DL, unsigned NumCompileThreads,
+            DataLayout DL, unsigned NumCompileThreads, ObjectCache *ObjCache,
             std::unique_ptr<LazyCallThroughManager> LCTMgr,
             std::function<std::unique_ptr<IndirectStubsManager>()> ISMBuilder);
 
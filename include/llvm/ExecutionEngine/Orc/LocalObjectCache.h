@@ -0,0 +1,99 @@
+//===- LocalObjectCache.h - Persistent on-disk object cache -----*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// An ObjectCache that keeps the objects compiled by a JIT in a directory, so
+// that later runs of the same JIT can load them instead of compiling again.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_EXECUTIONENGINE_ORC_LOCALOBJECTCACHE_H
+#define LLVM_EXECUTIONENGINE_ORC_LOCALOBJECTCACHE_H
+
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/ExecutionEngine/ObjectCache.h"
+#include "llvm/Support/CachePruning.h"
+#include "llvm/Support/Error.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace llvm {
+
+class Module;
+
+namespace orc {
+
+class JITTargetMachineBuilder;
+
+/// A content-addressed object cache in a local directory.
+///
+///   Objects are keyed by a hash of the module's bitcode, the LLVM version and
+/// the target configuration they were compiled for, so a module is only ever
+/// given an object compiled from identical IR with identical settings. The
+/// entries are named like the ThinLTO cache entries ("llvmcache-<key>"): they
+/// are written to a temporary file first and then renamed, so concurrent JITs
+/// may share the directory, and the directory can be pruned with
+/// CachePruning.
+///
+///   Failing to read or write an entry only makes the lookup a miss, so an
+/// unusable directory slows the JIT down but never breaks it.
+///
+///   The cache can be used from several compile threads at once.
+class LocalObjectCache : public ObjectCache {
+public:
+  /// Create a cache in \p CacheDir, creating the directory if needed, for
+  /// objects compiled with TargetMachines built by \p JTMB. Of the
+  /// TargetOptions, only those that the JIT commonly sets (EmulatedTLS,
+  /// ExplicitEmulatedTLS, FunctionSections and DataSections) are part of the
+  /// key: JITs that change other options must not share a directory.
+  ///
+  /// The directory is pruned with \p Policy once now, and again on each call
+  /// to prune().
+  static Expected<std::unique_ptr<LocalObjectCache>>
+  Create(StringRef CacheDir, const JITTargetMachineBuilder &JTMB,
+         CachePruningPolicy Policy = CachePruningPolicy());
+
+  void notifyObjectCompiled(const Module *M, MemoryBufferRef Obj) override;
+
+  std::unique_ptr<MemoryBuffer> getObject(const Module *M) override;
+
+  /// Prune the directory if the pruning interval of the policy has expired.
+  /// Returns true if it was pruned.
+  bool prune();
+
+  /// Returns the key that the object for \p M is stored under.
+  std::string getKey(const Module &M) const;
+
+private:
+  LocalObjectCache(std::string CacheDir, std::string ConfigKey,
+                   CachePruningPolicy Policy)
+      : CacheDir(std::move(CacheDir)), ConfigKey(std::move(ConfigKey)),
+        Policy(std::move(Policy)) {}
+
+  SmallString<128> getEntryPath(StringRef Key) const;
+
+  std::string CacheDir;
+  /// The part of every key that depends on the target configuration.
+  std::string ConfigKey;
+  CachePruningPolicy Policy;
+
+  /// The keys computed by getObject for the modules that missed. Code
+  /// generation modifies the module, so notifyObjectCompiled can not hash it
+  /// again.
+  std::mutex PendingKeysMutex;
+  DenseMap<const Module *, std::string> PendingKeys;
+};
+
+} // End namespace orc
+} // End namespace llvm
+
+#endif // LLVM_EXECUTIONENGINE_ORC_LOCALOBJECTCACHE_H
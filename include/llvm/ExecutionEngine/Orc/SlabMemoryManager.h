@@ -0,0 +1,196 @@
+//===- SlabMemoryManager.h - Pack JIT'd sections into slabs -----*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// A RuntimeDyld memory manager that allocates the sections of many objects
+// from a shared pool of large, huge-page-backed slabs.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_EXECUTIONENGINE_ORC_SLABMEMORYMANAGER_H
+#define LLVM_EXECUTIONENGINE_ORC_SLABMEMORYMANAGER_H
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ExecutionEngine/RuntimeDyld.h"
+#include "llvm/Support/Memory.h"
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace llvm {
+
+class raw_ostream;
+
+namespace orc {
+
+/// A pool of slabs that the sections of JIT'd objects are allocated from.
+///
+///   SectionMemoryManager maps whole pages for every section, so a JIT that
+/// loads thousands of small objects spreads their code over thousands of
+/// pages. This pool instead packs the sections of all the objects it serves
+/// into a few large slabs, and advises the system to back the slabs with
+/// huge pages, so the code of many objects shares a few i-TLB entries.
+///
+///   Code and read-only data are kept W^X by mapping their slabs twice: the
+/// sections are written through a read-write mapping, and are run and read
+/// through a second mapping that is never writable. Objects can therefore be
+/// finalized one at a time while they share pages. Where the system can not
+/// map memory twice, code and read-only data sections are padded to whole
+/// pages instead, so that each can be protected on its own.
+///
+///   Freed sections go back to the pool to be reused; the slabs themselves
+/// are only unmapped when the pool is destroyed, which the memory managers of
+/// the pool must not outlive. The pool can be used from several threads.
+class SlabMemoryPool {
+public:
+  /// The kinds of memory, each of which has its own slabs.
+  enum class AllocationPurpose { Code, ROData, RWData };
+
+  struct Options {
+    /// The size of a slab. Sections larger than this get a slab of their own.
+    size_t SlabSize = 2 * 1024 * 1024;
+    /// Advise the system to back the slabs with (transparent) huge pages.
+    bool UseHugePages = true;
+    /// Map the code and read-only data slabs twice, if the system supports
+    /// it. If this is false, those sections are padded to whole pages.
+    bool UseDualMapping = true;
+  };
+
+  /// How well the slabs of one kind of memory are used.
+  struct Statistics {
+    /// The number of slabs, and the bytes mapped for them.
+    unsigned NumSlabs = 0;
+    uint64_t MappedBytes = 0;
+    /// The bytes allocated to live sections, including the padding of
+    /// sections that are padded to whole pages.
+    uint64_t AllocatedBytes = 0;
+    /// The free ranges of the slabs, their total size and the largest one.
+    unsigned NumFreeRanges = 0;
+    uint64_t FreeBytes = 0;
+    uint64_t LargestFreeRange = 0;
+
+    /// Returns the part of the free bytes that is not in the largest free
+    /// range: 0 if the free memory is contiguous, approaching 1 as it gets
+    /// scattered over many small ranges.
+    double getFragmentation() const;
+  };
+
+  SlabMemoryPool() : SlabMemoryPool(Options()) {}
+  explicit SlabMemoryPool(Options Opts);
+  SlabMemoryPool(const SlabMemoryPool &) = delete;
+  SlabMemoryPool &operator=(const SlabMemoryPool &) = delete;
+  ~SlabMemoryPool();
+
+  /// Returns the statistics of the slabs for \p Purpose.
+  Statistics getStatistics(AllocationPurpose Purpose) const;
+
+  /// Prints the statistics of all the slabs of this pool.
+  void printStatistics(raw_ostream &OS) const;
+
+private:
+  friend class SlabMemoryManager;
+
+  struct Slab;
+
+  /// A section allocated from a slab.
+  struct Block {
+    Slab *S;
+    AllocationPurpose Purpose;
+    /// The address the section is written through.
+    uint8_t *Working;
+    /// The address the section is run and read through.
+    uint8_t *Target;
+    size_t Size;
+  };
+
+  /// Allocates \p Size bytes aligned to \p Alignment, or returns a block with
+  /// null addresses if no memory could be mapped.
+  Block allocate(AllocationPurpose Purpose, size_t Size, unsigned Alignment);
+
+  /// Gives the final protection to the sections of \p Blocks. Returns true if
+  /// an error occurred.
+  bool finalize(ArrayRef<Block> Blocks, std::string *ErrMsg);
+
+  /// Returns the sections of \p Blocks to their slabs.
+  void release(ArrayRef<Block> Blocks);
+
+  Slab *createSlab(AllocationPurpose Purpose, size_t MinSize);
+
+  Options Opts;
+  mutable std::mutex PoolMutex;
+  std::vector<std::unique_ptr<Slab>> Slabs[3];
+  uint64_t AllocatedBytes[3] = {0, 0, 0};
+  bool DualMappingFailed = false;
+};
+
+/// Memory manager for one RuntimeDyld instance, which allocates the sections
+/// of its object from a SlabMemoryPool and returns them when it is destroyed.
+/// For example:
+///
+/// \code{.cpp}
+///   SlabMemoryPool Pool;
+///   RTDyldObjectLinkingLayer ObjLayer(ES, [&Pool]() {
+///     return llvm::make_unique<SlabMemoryManager>(Pool);
+///   });
+/// \endcode
+///
+/// The code runs in the process of the JIT, at the addresses that the
+/// RuntimeDyld instance reports for the symbols.
+class SlabMemoryManager : public RuntimeDyld::MemoryManager {
+public:
+  explicit SlabMemoryManager(SlabMemoryPool &Pool) : Pool(Pool) {}
+  ~SlabMemoryManager() override;
+
+  uint8_t *allocateCodeSection(uintptr_t Size, unsigned Alignment,
+                               unsigned SectionID,
+                               StringRef SectionName) override;
+
+  uint8_t *allocateDataSection(uintptr_t Size, unsigned Alignment,
+                               unsigned SectionID, StringRef SectionName,
+                               bool IsReadOnly) override;
+
+  /// Maps the sections to the addresses they run at.
+  void notifyObjectLoaded(RuntimeDyld &RTDyld,
+                          const object::ObjectFile &Obj) override;
+
+  void registerEHFrames(uint8_t *Addr, uint64_t LoadAddr,
+                        size_t Size) override;
+  void deregisterEHFrames() override;
+
+  bool finalizeMemory(std::string *ErrMsg = nullptr) override;
+
+  /// Returns the address that the section allocated at \p LocalAddress runs
+  /// at, or 0 if this memory manager did not allocate it.
+  uint64_t getTargetAddress(const void *LocalAddress) const;
+
+private:
+  uint8_t *allocateSection(SlabMemoryPool::AllocationPurpose Purpose,
+                           uintptr_t Size, unsigned Alignment);
+
+  struct EHFrame {
+    uint8_t *Addr;
+    size_t Size;
+  };
+
+  SlabMemoryPool &Pool;
+  std::vector<SlabMemoryPool::Block> Blocks;
+  /// Blocks[0, NumMapped) have been mapped to their target addresses, and
+  /// Blocks[0, NumFinalized) have been finalized.
+  size_t NumMapped = 0;
+  size_t NumFinalized = 0;
+  std::vector<EHFrame> EHFrames;
+};
+
+} // end namespace orc
+} // end namespace llvm
+
+#endif // LLVM_EXECUTIONENGINE_ORC_SLABMEMORYMANAGER_H
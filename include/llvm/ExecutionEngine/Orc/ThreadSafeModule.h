@@ -17,6 +17,8 @@
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/Module.h"
 #include "llvm/Support/Compiler.h"
+#include "llvm/Support/Error.h"
+#include "llvm/Support/MemoryBuffer.h"
 
 #include <functional>
 #include <memory>
@@ -75,6 +77,11 @@ public:
     return Lock(S);
   }
 
+  /// Returns true if other ThreadSafeContexts, ThreadSafeModules or locks
+  /// refer to the same LLVMContext. If this returns false, only the owner of
+  /// this instance can use the context, so it can do so without contention.
+  bool isShared() const { return S && S.use_count() > 1; }
+
 private:
   std::shared_ptr<State> S;
 };
@@ -132,6 +139,10 @@ public:
   /// Take out a lock on the ThreadSafeContext for this module.
   ThreadSafeContext::Lock getContextLock() { return TSCtx.getLock(); }
 
+  /// Returns the context of this module.
+  ThreadSafeContext &getContext() { return TSCtx; }
+  const ThreadSafeContext &getContext() const { return TSCtx; }
+
   /// Boolean conversion: This ThreadSafeModule will evaluate to true if it
   /// wraps a non-null module.
   explicit operator bool() {
@@ -157,6 +168,14 @@ cloneToNewContext(ThreadSafeModule &TSMW,
                   GVPredicate ShouldCloneDef = GVPredicate(),
                   GVModifier UpdateClonedDefSource = GVModifier());
 
+/// Loads the bitcode module in \p Buffer lazily into \p TSCtx: only the
+/// global declarations are read now, and the body of each function is read
+/// when the function is materialized. Added to a CompileOnDemandLayer, the
+/// module only ever has the bodies of the functions that are called read.
+Expected<ThreadSafeModule>
+loadLazyBitcodeModule(std::unique_ptr<MemoryBuffer> Buffer,
+                      ThreadSafeContext TSCtx);
+
 } // End namespace orc
 } // End namespace llvm
 
@@ -0,0 +1,136 @@
+//===- TieredCompileLayer.h - Recompile hot functions -----------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// JIT layer that compiles modules quickly first, counts the calls to each of
+// their functions, and recompiles the functions that get hot with a second,
+// optimizing layer.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_EXECUTIONENGINE_ORC_TIEREDCOMPILELAYER_H
+#define LLVM_EXECUTIONENGINE_ORC_TIEREDCOMPILELAYER_H
+
+#include "llvm/ExecutionEngine/Orc/IndirectionUtils.h"
+#include "llvm/ExecutionEngine/Orc/Layer.h"
+#include "llvm/ExecutionEngine/Orc/LazyReexports.h"
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace llvm {
+
+class Function;
+class Module;
+
+namespace orc {
+
+/// Tiered compilation layer.
+///
+///   Each module added to this layer is emitted through the Tier1Layer (which
+/// would usually compile at -O0) into an implementation dylib, behind one
+/// indirect stub per function. Every function of the tier 1 code counts its
+/// calls. When the count of a function reaches the hot threshold, the function
+/// is extracted from a copy of the original module, emitted through the
+/// Tier2Layer (which would usually optimize and compile at -O2), and its stub
+/// is pointed at the new code. Calls that are already in the tier 1 code
+/// finish there; all the calls made through the stub after the update run the
+/// tier 2 code. Calls between functions of the same module go through the
+/// stubs too. Functions that have aliases are never recompiled.
+///
+///   The tier 1 code calls back into this layer directly, so the JIT'd code
+/// must run in the process of the JIT.
+class TieredCompileLayer : public IRLayer {
+public:
+  /// Builder for IndirectStubsManagers.
+  using IndirectStubsManagerBuilder =
+      std::function<std::unique_ptr<IndirectStubsManager>()>;
+
+  /// Runs a recompilation. The default runs it right away, on the thread that
+  /// made the call that got the function hot.
+  using DispatchFunction = std::function<void(std::function<void()>)>;
+
+  /// Construct a TieredCompileLayer.
+  TieredCompileLayer(ExecutionSession &ES, IRLayer &Tier1Layer,
+                     IRLayer &Tier2Layer, LazyCallThroughManager &LCTMgr,
+                     IndirectStubsManagerBuilder BuildIndirectStubsManager,
+                     uint64_t HotThreshold = 1000);
+
+  /// Sets the function used to run recompilations, for example on a
+  /// ThreadPool so that the JIT'd code never waits for the tier 2 compiler.
+  /// The recompilations must finish before this layer is destroyed.
+  void setDispatchFunction(DispatchFunction Dispatch);
+
+  /// Returns the number of functions whose tier 2 code has been installed.
+  unsigned getNumRecompiledFunctions() const;
+
+  /// Emits the given module. This should not be called by clients: it will be
+  /// called by the JIT when a definition added via the add method is requested.
+  void emit(MaterializationResponsibility R, ThreadSafeModule TSM) override;
+
+private:
+  struct PerDylibResources {
+  public:
+    PerDylibResources(JITDylib &ImplD,
+                      std::unique_ptr<IndirectStubsManager> ISMgr)
+        : ImplD(ImplD), ISMgr(std::move(ISMgr)) {}
+    JITDylib &getImplDylib() { return ImplD; }
+    IndirectStubsManager &getISManager() { return *ISMgr; }
+
+  private:
+    JITDylib &ImplD;
+    std::unique_ptr<IndirectStubsManager> ISMgr;
+  };
+
+  using PerDylibResourcesMap = std::map<const JITDylib *, PerDylibResources>;
+
+  /// Everything needed to recompile one function.
+  struct TieredFunction {
+    PerDylibResources *PDR;
+    /// The module the function came from, before instrumentation.
+    std::shared_ptr<ThreadSafeModule> Source;
+    std::string IRName;
+    /// The name of the stub.
+    SymbolStringPtr Name;
+    /// The name of the tier 2 definition.
+    SymbolStringPtr Tier2Name;
+  };
+
+  PerDylibResources &getPerDylibResources(JITDylib &TargetD);
+
+  void cleanUpModule(Module &M);
+
+  void addCallCounter(Function &F, uint64_t Index);
+
+  /// Called by the tier 1 code of function \p Index when it gets hot.
+  static void notifyHot(TieredCompileLayer *Layer, uint64_t Index);
+
+  void recompile(const TieredFunction &TF);
+
+  mutable std::mutex TieredLayerMutex;
+
+  IRLayer &Tier1Layer;
+  IRLayer &Tier2Layer;
+  LazyCallThroughManager &LCTMgr;
+  IndirectStubsManagerBuilder BuildIndirectStubsManager;
+  uint64_t HotThreshold;
+  DispatchFunction Dispatch;
+  PerDylibResourcesMap DylibResources;
+  std::vector<TieredFunction> Functions;
+  unsigned NumRecompiled = 0;
+  SymbolLinkagePromoter PromoteSymbols;
+};
+
+} // End namespace orc
+} // End namespace llvm
+
+#endif // LLVM_EXECUTIONENGINE_ORC_TIEREDCOMPILELAYER_H
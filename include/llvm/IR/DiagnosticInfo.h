@@ -39,6 +39,10 @@ class LLVMContext;
 class Module;
 class SMDiagnostic;
 
+namespace remarks {
+class BinaryRemarkWriter;
+} // end namespace remarks
+
 /// Defines the different supported severity of a diagnostic.
 enum DiagnosticSeverity : char {
   DS_Error,
@@ -455,6 +459,9 @@ public:
   /// \see DiagnosticInfo::print.
   void print(DiagnosticPrinter &DP) const override;
 
+  /// Write this remark to a file in the binary remark format.
+  void writeBinary(remarks::BinaryRemarkWriter &W) const;
+
   /// Return true if this optimization remark is enabled by one of
   /// of the LLVM command line flags (-pass-remarks, -pass-remarks-missed,
   /// or -pass-remarks-analysis). Note that this only handles the LLVM
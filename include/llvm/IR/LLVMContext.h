@@ -37,6 +37,12 @@ class SMDiagnostic;
 class StringRef;
 class Twine;
 
+namespace remarks {
+
+class BinaryRemarkWriter;
+
+} // end namespace remarks
+
 namespace yaml {
 
 class Output;
@@ -256,6 +262,18 @@ public:
   /// set, the handler is invoked for each diagnostic message.
   void setDiagnosticsOutputFile(std::unique_ptr<yaml::Output> F);
 
+  /// Return the writer used by the backend to save optimization diagnostics
+  /// in the binary remark format, or null if they are not saved in it.
+  remarks::BinaryRemarkWriter *getDiagnosticsBinaryOutputFile();
+  /// Set the writer used to save optimization diagnostics in the binary
+  /// remark format. It can be set together with the YAML output file.
+  void setDiagnosticsBinaryOutputFile(
+      std::unique_ptr<remarks::BinaryRemarkWriter> W);
+
+  /// Return true if optimization diagnostics are saved to a file, in either
+  /// format.
+  bool hasDiagnosticsOutputFile();
+
   /// Get the prefix that should be printed in front of a diagnostic of
   ///        the given \p Severity
   static const char *getDiagnosticMessagePrefix(DiagnosticSeverity Severity);
@@ -326,6 +344,24 @@ public:
   /// LLVMContext is used by compilation.
   void setOptPassGate(OptPassGate&);
 
+  /// Destroy the constants owned by this context that are no longer
+  /// referenced by a use, by metadata or by a value handle. Constants are
+  /// uniqued for the whole life of the context otherwise, so a long-lived
+  /// context that keeps creating modules should call this after destroying
+  /// some of them. Any other pointer to a destroyed constant dangles, so this
+  /// can only be called where all uses of the context are understood.
+  ///
+  /// Returns the number of constants destroyed.
+  unsigned sweepUnusedConstants();
+
+  /// Return the number of constants owned by this context.
+  size_t getNumUniquedConstants() const;
+
+  /// Return the number of uniqued metadata nodes owned by this context.
+  /// Uniqued nodes do not track their users, so they are only freed with the
+  /// context.
+  size_t getNumUniquedMDNodes() const;
+
 private:
   // Module needs access to the add/removeModule methods.
   friend class Module;
@@ -20,6 +20,7 @@
 #include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/StringExtras.h"
 #include "llvm/ADT/StringMap.h"
 #include "llvm/ADT/StringRef.h"
@@ -118,7 +119,10 @@ inline const char *getHotnessName(CalleeInfo::HotnessType HT) {
 
 class GlobalValueSummary;
 
-using GlobalValueSummaryList = std::vector<std::unique_ptr<GlobalValueSummary>>;
+/// Almost all GUIDs have a single summary, so keep it inline rather than in a
+/// separate allocation per GUID.
+using GlobalValueSummaryList =
+    SmallVector<std::unique_ptr<GlobalValueSummary>, 1>;
 
 struct GlobalValueSummaryInfo {
   union NameOrGV {
@@ -491,6 +495,9 @@ public:
 
     // Indicate if the global value cannot be inlined.
     unsigned NoInline : 1;
+
+    // Indicate if the function is placed in a Pagerando bin.
+    unsigned Pagerando : 1;
   };
 
   /// Create an empty FunctionSummary (with specified call edges).
@@ -834,6 +841,10 @@ private:
   std::set<std::string> CfiFunctionDefs;
   std::set<std::string> CfiFunctionDecls;
 
+  /// Pagerando bin assignments computed during the thin link, mapping function
+  /// GUIDs to bin numbers. Only populated for in-process ThinLTO backends.
+  std::map<GlobalValue::GUID, unsigned> PagerandoBins;
+
   // Used in cases where we want to record the name of a global, but
   // don't have the string owned elsewhere (e.g. the Strtab on a module).
   StringSaver Saver;
@@ -995,6 +1006,20 @@ public:
   std::set<std::string> &cfiFunctionDecls() { return CfiFunctionDecls; }
   const std::set<std::string> &cfiFunctionDecls() const { return CfiFunctionDecls; }
 
+  /// Record the Pagerando bin assigned to the function with \p GUID.
+  void setPagerandoBin(GlobalValue::GUID GUID, unsigned Bin) {
+    PagerandoBins[GUID] = Bin;
+  }
+
+  /// Return the Pagerando bin assigned to the function with \p GUID, or 0 if
+  /// the function was not assigned a bin during the thin link.
+  unsigned getPagerandoBin(GlobalValue::GUID GUID) const {
+    auto I = PagerandoBins.find(GUID);
+    return I == PagerandoBins.end() ? 0 : I->second;
+  }
+
+  bool hasPagerandoBins() const { return !PagerandoBins.empty(); }
+
   /// Add a global value summary for a value.
   void addGlobalValueSummary(const GlobalValue &GV,
                              std::unique_ptr<GlobalValueSummary> Summary) {
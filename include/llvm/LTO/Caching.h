@@ -8,7 +8,8 @@
 //===----------------------------------------------------------------------===//
 //
 // This file defines the localCache function, which allows clients to add a
-// filesystem cache to ThinLTO.
+// filesystem cache to ThinLTO, and the CacheBackend interface for caches in
+// other storage, e.g., an object store shared by several machines.
 //
 //===----------------------------------------------------------------------===//
 
@@ -34,6 +35,38 @@ typedef std::function<void(unsigned Task, std::unique_ptr<MemoryBuffer> MB)>
 Expected<NativeObjectCache> localCache(StringRef CacheDirectoryPath,
                                        AddBufferFn AddBuffer);
 
+/// Storage for cached native objects. Objects are keyed by the cache key
+/// computed by computeLTOCacheKey, which only depends on the content of the
+/// inputs, so a store may be shared by several machines.
+///
+/// Implementations must be thread safe.
+class CacheBackend {
+public:
+  virtual ~CacheBackend() = default;
+
+  /// Return the object stored under \p Key, or nullptr if there is none.
+  virtual Expected<std::unique_ptr<MemoryBuffer>> lookup(StringRef Key) = 0;
+
+  /// Store \p Object under \p Key. Objects with the same key are
+  /// interchangeable, so concurrent stores of a key may replace each other.
+  virtual Error store(StringRef Key, MemoryBufferRef Object) = 0;
+};
+
+/// Create a cache which uses the given backend and buffer callback. Lookup
+/// and store errors are reported as warnings and treated like cache misses,
+/// so an unavailable backend does not fail the link.
+NativeObjectCache backendCache(std::shared_ptr<CacheBackend> Backend,
+                               AddBufferFn AddBuffer);
+
+/// Create a backend for a content-addressed object store in a directory that
+/// may be shared by several machines, e.g., on a network file system. Objects
+/// are stored as <path>/<first two characters of key>/<key>. They are written
+/// to a temporary file first and then renamed, so readers never see partial
+/// objects. This function also creates the directory if it does not already
+/// exist.
+Expected<std::unique_ptr<CacheBackend>>
+createSharedDirectoryCacheBackend(StringRef Path);
+
 } // namespace lto
 } // namespace llvm
 
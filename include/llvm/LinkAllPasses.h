@@ -150,6 +150,7 @@ namespace {
       (void) llvm::createObjCARCOptPass();
       (void) llvm::createPAEvalPass();
       (void) llvm::createPagerandoWrappersPass();
+      (void) llvm::createPagerandoWrapperEliminationPass();
       (void) llvm::createPromoteMemoryToRegisterPass();
       (void) llvm::createDemoteRegisterToMemoryPass();
       (void) llvm::createPruneEHPass();
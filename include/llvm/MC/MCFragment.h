@@ -19,6 +19,7 @@
 #include "llvm/MC/MCInst.h"
 #include "llvm/Support/Casting.h"
 #include "llvm/Support/SMLoc.h"
+#include <algorithm>
 #include <cstdint>
 #include <utility>
 
@@ -197,6 +198,14 @@ protected:
 public:
   SmallVectorImpl<char> &getContents() { return Contents; }
   const SmallVectorImpl<char> &getContents() const { return Contents; }
+
+  /// Release the capacity of the contents beyond their size. Used once no
+  /// more data will be appended to the fragment.
+  void shrinkContents() {
+    if (Contents.capacity() > std::max<size_t>(Contents.size(), ContentsSize))
+      SmallVector<char, ContentsSize>(Contents.begin(), Contents.end())
+          .swap(Contents);
+  }
 };
 
 /// Interface implemented by fragments that contain encoded instructions and/or
@@ -230,6 +239,14 @@ public:
   fixup_iterator fixup_end() { return Fixups.end(); }
   const_fixup_iterator fixup_end() const { return Fixups.end(); }
 
+  /// Release the capacity of the contents and fixups beyond their size.
+  void shrinkToFit() {
+    this->shrinkContents();
+    if (Fixups.capacity() > std::max<size_t>(Fixups.size(), FixupsSize))
+      SmallVector<MCFixup, FixupsSize>(Fixups.begin(), Fixups.end())
+          .swap(Fixups);
+  }
+
   static bool classof(const MCFragment *F) {
     MCFragment::FragmentType Kind = F->getKind();
     return Kind == MCFragment::FT_Relaxable || Kind == MCFragment::FT_Data ||
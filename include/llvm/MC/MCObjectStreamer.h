@@ -55,6 +55,10 @@ class MCObjectStreamer : public MCStreamer {
   void EmitInstructionImpl(const MCInst &Inst, const MCSubtargetInfo &STI);
   void resolvePendingFixups();
 
+  /// Called before a new fragment is inserted after the current one, which
+  /// no more data is appended to from then on.
+  void finishCurrentFragment();
+
 protected:
   MCObjectStreamer(MCContext &Context, std::unique_ptr<MCAsmBackend> TAB,
                    std::unique_ptr<MCObjectWriter> OW,
@@ -75,6 +79,7 @@ public:
 
   void insert(MCFragment *F) {
     flushPendingLabels(F);
+    finishCurrentFragment();
     MCSection *CurSection = getCurrentSectionOnly();
     CurSection->getFragmentList().insert(CurInsertionPoint, F);
     F->setParent(CurSection);
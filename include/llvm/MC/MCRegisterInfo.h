@@ -167,6 +167,10 @@ private:
   unsigned NumSubRegIndices;                  // Number of subreg indices.
   const uint16_t *RegEncodingTable;           // Pointer to array of register
                                               // encodings.
+  const MCPhysReg *SubRegDeltas;              // Pointer to the direct subreg
+                                              // lookup rows, or null.
+  const uint16_t *SubRegDeltaRows;            // Offset of each register's row
+                                              // in SubRegDeltas.
 
   unsigned L2DwarfRegsSize;
   unsigned EHL2DwarfRegsSize;
@@ -248,7 +252,9 @@ public:
                           const uint16_t *SubIndices,
                           unsigned NumIndices,
                           const SubRegCoveredBits *SubIdxRanges,
-                          const uint16_t *RET) {
+                          const uint16_t *RET,
+                          const MCPhysReg *SRDeltas = nullptr,
+                          const uint16_t *SRDeltaRows = nullptr) {
     Desc = D;
     NumRegs = NR;
     RAReg = RA;
@@ -265,6 +271,8 @@ public:
     NumSubRegIndices = NumIndices;
     SubRegIdxRanges = SubIdxRanges;
     RegEncodingTable = RET;
+    SubRegDeltas = SRDeltas;
+    SubRegDeltaRows = SRDeltaRows;
 
     // Initialize DWARF register mapping variables
     EHL2DwarfRegs = nullptr;
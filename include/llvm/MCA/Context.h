@@ -59,9 +59,12 @@ public:
 
   /// Construct a basic pipeline for simulating an out-of-order pipeline.
   /// This pipeline consists of Fetch, Dispatch, Execute, and Retire stages.
-  std::unique_ptr<Pipeline> createDefaultPipeline(const PipelineOptions &Opts,
-                                                  InstrBuilder &IB,
-                                                  SourceMgr &SrcMgr);
+  /// If \p MemoryStage is set, it is inserted between the Dispatch and the
+  /// Execute stages to model the memory hierarchy.
+  std::unique_ptr<Pipeline>
+  createDefaultPipeline(const PipelineOptions &Opts, InstrBuilder &IB,
+                        SourceMgr &SrcMgr,
+                        std::unique_ptr<Stage> MemoryStage = nullptr);
 };
 
 } // namespace mca
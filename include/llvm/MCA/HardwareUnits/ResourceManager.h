@@ -281,6 +281,11 @@ class ResourceManager {
   std::vector<std::unique_ptr<ResourceState>> Resources;
   std::vector<std::unique_ptr<ResourceStrategy>> Strategies;
 
+  // For every resource, a mask of the groups that contain it. Bit N - 1 is set
+  // for the group at index N of Resources. Used to update only the affected
+  // groups when a unit is used or released.
+  SmallVector<uint64_t, 8> Resource2Groups;
+
   // Keeps track of which resources are busy, and how many cycles are left
   // before those become usable again.
   SmallDenseMap<ResourceRef, unsigned> BusyResources;
@@ -188,7 +188,9 @@ public:
 
   // On every cycle, update CyclesLeft and notify dependent users.
   void cycleEvent();
-  void onInstructionIssued();
+  // On instruction issue, the write latency is adjusted by |LatencyAdjustment|
+  // cycles (see Instruction::setLatencyAdjustment).
+  void onInstructionIssued(int LatencyAdjustment = 0);
 
 #ifndef NDEBUG
   void dump() const;
@@ -417,14 +419,26 @@ class Instruction : public InstructionBase {
   // Retire Unit token ID for this instruction.
   unsigned RCUTokenID;
 
+  // Number of cycles added to the latency of this instruction and of its
+  // writes when it is issued. This is set by stages that model effects the
+  // scheduling model doesn't know about, like cache misses.
+  int LatencyAdjustment;
+
 public:
   Instruction(const InstrDesc &D)
       : InstructionBase(D), Stage(IS_INVALID), CyclesLeft(UNKNOWN_CYCLES),
-        RCUTokenID(0) {}
+        RCUTokenID(0), LatencyAdjustment(0) {}
 
   unsigned getRCUTokenID() const { return RCUTokenID; }
   int getCyclesLeft() const { return CyclesLeft; }
 
+  int getLatencyAdjustment() const { return LatencyAdjustment; }
+  void setLatencyAdjustment(int Cycles) {
+    assert(Stage != IS_EXECUTING && Stage != IS_EXECUTED &&
+           Stage != IS_RETIRED && "Instruction already issued!");
+    LatencyAdjustment = Cycles;
+  }
+
   // Transition to the dispatch stage, and assign a RCUToken to this
   // instruction. The RCUToken is used to track the completion of every
   // register write performed by this instruction.
@@ -0,0 +1,91 @@
+//===---------------------- MemoryModelStage.h ------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+/// \file
+///
+/// This file defines an optional stage that models the memory hierarchy.
+/// It sits between the dispatch and the execute stages, and adjusts the
+/// latency of every dispatched load according to a simple cache model.
+///
+/// The simulated code has no addresses, so the model is static:
+///  * A load forwards from the most recent store to the same address operands
+///    if no instruction in between writes the registers of the address.
+///  * Otherwise, one in every L1MissInterval iterations of each load misses
+///    the L1 cache and hits the L2 cache instead.
+///  * Every other load hits the L1 cache.
+///
+/// The scheduling model already accounts for an L1 hit of
+/// MCSchedModel::LoadLatency cycles; the stage only adds the difference.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_MCA_MEMORY_MODEL_STAGE_H
+#define LLVM_MCA_MEMORY_MODEL_STAGE_H
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/MC/MCInst.h"
+#include "llvm/MC/MCInstrInfo.h"
+#include "llvm/MC/MCRegisterInfo.h"
+#include "llvm/MC/MCSchedule.h"
+#include "llvm/MCA/Stages/Stage.h"
+
+namespace llvm {
+namespace mca {
+
+/// The parameters of the memory hierarchy model. A latency of zero means that
+/// the corresponding effect is not modelled.
+struct MemoryModelOptions {
+  /// Latency of a load that hits the L1 cache. Zero means the LoadLatency of
+  /// the scheduling model.
+  unsigned L1Latency = 0;
+  /// Latency of a load that misses the L1 cache and hits the L2 cache.
+  unsigned L2Latency = 0;
+  /// One in every L1MissInterval iterations of a load misses the L1 cache.
+  unsigned L1MissInterval = 0;
+  /// Latency of a load that is forwarded the data of an older store.
+  unsigned StoreForwardLatency = 0;
+};
+
+class MemoryModelStage final : public Stage {
+  const MemoryModelOptions Opts;
+  const MCSchedModel &SM;
+  const unsigned NumSourceInsts;
+
+  // For every instruction of the source, the distance (in instructions) to
+  // the store it forwards from, or zero if it doesn't forward from a store.
+  SmallVector<unsigned, 16> ForwardingDistance;
+
+  MemoryModelStage(const MemoryModelStage &Other) = delete;
+  MemoryModelStage &operator=(const MemoryModelStage &Other) = delete;
+
+  void computeForwardingDistances(ArrayRef<MCInst> Source,
+                                  const MCInstrInfo &MCII,
+                                  const MCRegisterInfo &MRI);
+
+public:
+  /// \p Source is the instruction sequence simulated by the pipeline.
+  MemoryModelStage(const MemoryModelOptions &Options, const MCSchedModel &Model,
+                   ArrayRef<MCInst> Source, const MCInstrInfo &MCII,
+                   const MCRegisterInfo &MRI);
+
+  bool isAvailable(const InstRef &IR) const override {
+    return checkNextStage(IR);
+  }
+  bool hasWorkToComplete() const override { return false; }
+  Error execute(InstRef &IR) override;
+
+  /// Returns the latency of the load at \p SourceIndex in the simulated
+  /// instruction stream.
+  unsigned getLoadLatency(unsigned SourceIndex) const;
+};
+
+} // namespace mca
+} // namespace llvm
+
+#endif // LLVM_MCA_MEMORY_MODEL_STAGE_H
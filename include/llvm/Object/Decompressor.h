@@ -55,10 +55,13 @@ private:
   Decompressor(StringRef Data);
 
   Error consumeCompressedGnuHeader();
-  Error consumeCompressedZLibHeader(bool Is64Bit, bool IsLittleEndian);
+  Error consumeCompressedELFHeader(bool Is64Bit, bool IsLittleEndian);
 
   StringRef SectionData;
   uint64_t DecompressedSize;
+  /// The ELFCOMPRESS_* algorithm of the section. GNU style sections are
+  /// always compressed with zlib.
+  uint64_t CompressionType;
 };
 
 } // end namespace object
@@ -160,6 +160,11 @@ public:
 
   Expected<std::vector<Elf_Rela>> decode_relrs(Elf_Relr_Range relrs) const;
 
+  /// Encode the sorted, word-aligned relative relocation offsets \p Offsets
+  /// as the contents of an SHT_RELR section. This is the inverse of
+  /// decode_relrs.
+  static std::vector<Elf_Relr> encode_relrs(ArrayRef<uintX_t> Offsets);
+
   Expected<std::vector<Elf_Rela>> android_relas(const Elf_Shdr *Sec) const;
 
   /// Iterate over program header table.
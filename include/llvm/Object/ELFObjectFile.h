@@ -44,6 +44,19 @@ namespace object {
 
 class elf_symbol_iterator;
 
+/// A symbol of an ELF symbol table, as decoded in batch by
+/// ELFObjectFileBase::readSymbolTable().
+struct ELFSymbolEntry {
+  /// The address that SymbolRef::getAddress() returns for the symbol.
+  uint64_t Address;
+  uint64_t Size;
+  /// The offset of the name of the symbol in the string table.
+  uint32_t NameOffset;
+  uint8_t Type;
+  uint8_t Binding;
+  uint16_t SectionIndex;
+};
+
 class ELFObjectFileBase : public ObjectFile {
   friend class ELFRelocationRef;
   friend class ELFSectionRef;
@@ -71,6 +84,15 @@ public:
   /// Returns platform-specific object flags, if any.
   virtual unsigned getPlatformFlags() const = 0;
 
+  /// Decode all symbols of the static symbol table, or of the dynamic one if
+  /// \p Dynamic is set, in one pass over the mapped table. The entries are in
+  /// the order of symbols() or getDynamicSymbolIterators(), and their names
+  /// are offsets into \p StringTable. Leaves \p Symbols empty if there is no
+  /// such table.
+  virtual Error readSymbolTable(bool Dynamic,
+                                std::vector<ELFSymbolEntry> &Symbols,
+                                StringRef &StringTable) const = 0;
+
   elf_symbol_iterator_range symbols() const;
 
   static bool classof(const Binary *v) { return v->isELF(); }
@@ -414,6 +436,9 @@ public:
 
   elf_symbol_iterator_range getDynamicSymbolIterators() const override;
 
+  Error readSymbolTable(bool Dynamic, std::vector<ELFSymbolEntry> &Symbols,
+                        StringRef &StringTable) const override;
+
   bool isRelocatableObject() const override;
 };
 
@@ -505,6 +530,68 @@ ELFObjectFile<ELFT>::getSymbolAddress(DataRefImpl Symb) const {
   return Result;
 }
 
+template <class ELFT>
+Error ELFObjectFile<ELFT>::readSymbolTable(bool Dynamic,
+                                           std::vector<ELFSymbolEntry> &Symbols,
+                                           StringRef &StringTable) const {
+  Symbols.clear();
+  StringTable = StringRef();
+  const Elf_Shdr *SymTab = Dynamic ? DotDynSymSec : DotSymtabSec;
+  if (!SymTab)
+    return Error::success();
+  auto SymsOrErr = EF.symbols(SymTab);
+  if (!SymsOrErr)
+    return SymsOrErr.takeError();
+  auto StrTabOrErr = EF.getStringTableForSymtab(*SymTab);
+  if (!StrTabOrErr)
+    return StrTabOrErr.takeError();
+  StringTable = *StrTabOrErr;
+
+  // Symbol values are relative to their section in relocatable objects.
+  const Elf_Ehdr *Header = EF.getHeader();
+  ArrayRef<Elf_Shdr> Sections;
+  if (Header->e_type == ELF::ET_REL) {
+    auto SectionsOrErr = EF.sections();
+    if (!SectionsOrErr)
+      return SectionsOrErr.takeError();
+    Sections = *SectionsOrErr;
+  }
+  bool ClearCodeBit =
+      Header->e_machine == ELF::EM_ARM || Header->e_machine == ELF::EM_MIPS;
+
+  Symbols.reserve(SymsOrErr->size());
+  for (const Elf_Sym &Sym : *SymsOrErr) {
+    uint64_t Address = Sym.st_value;
+    switch (Sym.st_shndx) {
+    case ELF::SHN_COMMON:
+      Address = Sym.st_size;
+      break;
+    case ELF::SHN_ABS:
+      break;
+    default:
+      // Clear the ARM/Thumb or microMIPS indicator flag.
+      if (ClearCodeBit && Sym.getType() == ELF::STT_FUNC)
+        Address &= ~1;
+      if (Sections.empty() || Sym.st_shndx == ELF::SHN_UNDEF)
+        break;
+      if (Sym.st_shndx < ELF::SHN_LORESERVE) {
+        if (Sym.st_shndx < Sections.size())
+          Address += Sections[Sym.st_shndx].sh_addr;
+        break;
+      }
+      auto SectionOrErr = EF.getSection(&Sym, SymTab, ShndxTable);
+      if (!SectionOrErr)
+        return SectionOrErr.takeError();
+      if (*SectionOrErr)
+        Address += (*SectionOrErr)->sh_addr;
+      break;
+    }
+    Symbols.push_back({Address, Sym.st_size, Sym.st_name, Sym.getType(),
+                       Sym.getBinding(), Sym.st_shndx});
+  }
+  return Error::success();
+}
+
 template <class ELFT>
 uint32_t ELFObjectFile<ELFT>::getSymbolAlignment(DataRefImpl Symb) const {
   const Elf_Sym *Sym = getSymbol(Symb);
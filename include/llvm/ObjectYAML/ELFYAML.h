@@ -17,6 +17,7 @@
 #define LLVM_OBJECTYAML_ELFYAML_H
 
 #include "llvm/ADT/StringRef.h"
+#include "llvm/ObjectYAML/DWARFYAML.h"
 #include "llvm/ObjectYAML/YAML.h"
 #include "llvm/Support/YAMLTraits.h"
 #include <cstdint>
@@ -113,7 +114,8 @@ struct Section {
     RawContent,
     Relocation,
     NoBits,
-    MipsABIFlags
+    MipsABIFlags,
+    Relr
   };
   SectionKind Kind;
   StringRef Name;
@@ -178,6 +180,20 @@ struct RelocationSection : Section {
   }
 };
 
+// Represents an SHT_RELR section. The relative relocations are given either as
+// a list of offsets, which is encoded the way a linker would, or as the raw
+// section contents.
+struct RelrSection : Section {
+  std::vector<llvm::yaml::Hex64> Offsets;
+  Optional<yaml::BinaryRef> Content;
+
+  RelrSection() : Section(SectionKind::Relr) {}
+
+  static bool classof(const Section *S) {
+    return S->Kind == SectionKind::Relr;
+  }
+};
+
 // Represents .MIPS.abiflags section
 struct MipsABIFlags : Section {
   llvm::yaml::Hex16 Version;
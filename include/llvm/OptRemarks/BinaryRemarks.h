@@ -0,0 +1,129 @@
+//===- BinaryRemarks.h - Binary optimization remark format ------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines a compact binary serialization of optimization remarks,
+// and a writer and a streaming parser for it.
+//
+// A file starts with the magic "RMRK" and a version byte, followed by
+// records, each introduced by a kind byte:
+//
+//   String: ULEB128 length, bytes. Defines the next string ID, from 0 up.
+//   Remark: ULEB128 string IDs of the type tag, pass, name and function;
+//           a flags byte; the debug location (ULEB128 file ID, line and
+//           column) if it has one; the hotness (ULEB128) if it has one;
+//           ULEB128 argument count, and for each argument the key and value
+//           string IDs, a flags byte and the debug location if it has one.
+//
+// Each string is written once, just before the first remark that uses it, so
+// the file can be written and read in a single pass. The strings a parser
+// returns point into the buffer it was given.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_OPTREMARKS_BINARYREMARKS_H
+#define LLVM_OPTREMARKS_BINARYREMARKS_H
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/Optional.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/Error.h"
+#include <cstdint>
+#include <vector>
+
+namespace llvm {
+
+class raw_ostream;
+
+namespace remarks {
+
+/// The current version of the binary remark format.
+constexpr uint8_t BinaryRemarkVersion = 0;
+
+/// Return true if \p Buf holds remarks in the binary format.
+bool isBinaryRemarkBuffer(StringRef Buf);
+
+/// A source location of a remark or of one of its arguments.
+struct RemarkLocation {
+  StringRef File;
+  unsigned Line = 0;
+  unsigned Column = 0;
+};
+
+/// One of the key-value pairs of a remark.
+struct RemarkArg {
+  StringRef Key;
+  StringRef Value;
+  Optional<RemarkLocation> Loc;
+};
+
+/// An optimization remark. The strings are not owned.
+struct Remark {
+  /// The YAML tag of the remark kind, e.g. "!Missed".
+  StringRef Type;
+  StringRef PassName;
+  StringRef RemarkName;
+  StringRef FunctionName;
+  Optional<RemarkLocation> Loc;
+  Optional<uint64_t> Hotness;
+  ArrayRef<RemarkArg> Args;
+};
+
+/// Serializes remarks to a stream in the binary format.
+class BinaryRemarkWriter {
+public:
+  /// Write the file header to \p OS.
+  explicit BinaryRemarkWriter(raw_ostream &OS);
+
+  /// Write \p R, preceded by any of its strings not written yet.
+  void write(const Remark &R);
+
+private:
+  raw_ostream &OS;
+  /// The ID of each string written so far.
+  StringMap<uint64_t> StringIDs;
+  /// The encoding of the remark being written, which cannot go to OS until
+  /// its new strings have.
+  SmallVector<char, 256> RecordBuffer;
+
+  uint64_t getStringID(StringRef S);
+};
+
+/// Parses a buffer in the binary format one remark at a time.
+class BinaryRemarkParser {
+public:
+  /// \p Buf must outlive the parser and the remarks it returns.
+  explicit BinaryRemarkParser(StringRef Buf);
+
+  /// Parse the next remark into \p R. Return false at the end of the buffer.
+  /// The arguments of \p R are valid until the next call.
+  Expected<bool> parseNext(Remark &R);
+
+private:
+  StringRef Buf;
+  uint64_t Offset;
+  /// The strings defined so far, indexed by ID.
+  std::vector<StringRef> Strings;
+  SmallVector<RemarkArg, 8> Args;
+
+  Error parseHeader();
+  Error parseULEB128(uint64_t &Result);
+  Error parseByte(uint8_t &Result);
+  Error parseString(StringRef &Result);
+  Error parseStringRecord();
+  Error parseLocation(RemarkLocation &Loc);
+  Error parseRemark(Remark &R);
+  Error makeError(const Twine &Message) const;
+};
+
+} // end namespace remarks
+} // end namespace llvm
+
+#endif // LLVM_OPTREMARKS_BINARYREMARKS_H
@@ -16,15 +16,68 @@
 #ifndef LLVM_PASSES_STANDARDINSTRUMENTATIONS_H
 #define LLVM_PASSES_STANDARDINSTRUMENTATIONS_H
 
+#include "llvm/ADT/SmallVector.h"
 #include "llvm/IR/PassInstrumentation.h"
 #include "llvm/IR/PassTimingInfo.h"
+#include <chrono>
+#include <string>
+#include <vector>
 
 namespace llvm {
 
+class raw_ostream;
+
+/// This class implements -pass-trace for the new pass manager. It records an
+/// event for every pass and analysis run, with its wall time, the number of
+/// instructions in the IR unit it ran on and the heap usage around it. The
+/// events are written in the Chrome trace event format when the handler is
+/// destroyed. Recording an event only reads a clock and the heap usage, so
+/// the handler is cheap enough to be left enabled.
+class PassTraceHandler {
+  struct Event {
+    std::string Name;
+    uint64_t StartUs;
+    uint64_t DurationUs = 0;
+    unsigned NumInstructions;
+    size_t MallocBefore;
+    size_t MallocAfter = 0;
+    size_t MallocPeak = 0;
+  };
+
+  std::string OutputFile;
+  std::chrono::steady_clock::time_point Origin;
+  std::vector<Event> Events;
+
+  /// Indices of the events of the passes that are running.
+  SmallVector<size_t, 8> EventStack;
+
+public:
+  /// Trace to the file given by -pass-trace; nothing is traced if it is not
+  /// given.
+  PassTraceHandler();
+  explicit PassTraceHandler(StringRef OutputFile);
+
+  /// Writes the trace if it has not been written before.
+  ~PassTraceHandler();
+
+  PassTraceHandler(const PassTraceHandler &) = delete;
+  void operator=(const PassTraceHandler &) = delete;
+
+  void registerCallbacks(PassInstrumentationCallbacks &PIC);
+
+  /// Writes the recorded events to \p OS and forgets them.
+  void write(raw_ostream &OS);
+
+private:
+  void runBeforePass(StringRef PassID, Any IR);
+  void runAfterPass(StringRef PassID);
+};
+
 /// This class provides an interface to register all the standard pass
 /// instrumentations and manages their state (if any).
 class StandardInstrumentations {
   TimePassesHandler TimePasses;
+  PassTraceHandler PassTrace;
 
 public:
   StandardInstrumentations() = default;
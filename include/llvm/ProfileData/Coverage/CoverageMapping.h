@@ -509,10 +509,18 @@ public:
 class CoverageMapping {
   DenseMap<size_t, DenseSet<size_t>> RecordProvenance;
   std::vector<FunctionRecord> Functions;
+  /// The indices of the function records that mention a file, by the hash of
+  /// the file name. Hash collisions only add records to filter out.
+  DenseMap<size_t, SmallVector<unsigned, 0>> FilenameHash2RecordIndices;
   std::vector<std::pair<std::string, uint64_t>> FuncHashMismatches;
 
   CoverageMapping() = default;
 
+  /// Return the indices of the function records that may mention
+  /// \p Filename, in load order.
+  ArrayRef<unsigned> getImpreciseRecordIndicesForFilename(
+      StringRef Filename) const;
+
   /// Add a function record corresponding to \p Record.
   Error loadFunctionRecord(const CoverageMappingRecord &Record,
                            IndexedInstrProfReader &ProfileReader);
@@ -528,9 +536,11 @@ public:
 
   /// Load the coverage mapping from the given object files and profile. If
   /// \p Arches is non-empty, it must specify an architecture for each object.
+  /// The objects are opened and their coverage mapping headers parsed on
+  /// \p NumThreads threads; the result does not depend on the thread count.
   static Expected<std::unique_ptr<CoverageMapping>>
   load(ArrayRef<StringRef> ObjectFilenames, StringRef ProfileFilename,
-       ArrayRef<StringRef> Arches = None);
+       ArrayRef<StringRef> Arches = None, unsigned NumThreads = 1);
 
   /// The number of functions that couldn't have their profiles mapped.
   ///
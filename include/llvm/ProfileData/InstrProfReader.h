@@ -16,6 +16,7 @@
 #define LLVM_PROFILEDATA_INSTRPROFREADER_H
 
 #include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/IR/ProfileSummary.h"
 #include "llvm/ProfileData/InstrProf.h"
@@ -78,6 +79,9 @@ public:
 
   virtual bool isIRLevelProfile() const = 0;
 
+  /// Return true if the profile holds context-sensitive records.
+  virtual bool hasCSIRLevelProfile() const = 0;
+
   /// Return the PGO symtab. There are three different readers:
   /// Raw, Text, and Indexed profile readers. The first two types
   /// of readers are used only by llvm-profdata tool, while the indexed
@@ -143,6 +147,7 @@ private:
   /// Iterator over the profile data.
   line_iterator Line;
   bool IsIRLevelProfile = false;
+  bool HasCSIRLevelProfile = false;
 
   Error readValueProfileData(InstrProfRecord &Record);
 
@@ -157,6 +162,8 @@ public:
 
   bool isIRLevelProfile() const override { return IsIRLevelProfile; }
 
+  bool hasCSIRLevelProfile() const override { return HasCSIRLevelProfile; }
+
   /// Read the header.
   Error readHeader() override;
 
@@ -213,6 +220,10 @@ public:
     return (Version & VARIANT_MASK_IR_PROF) != 0;
   }
 
+  bool hasCSIRLevelProfile() const override {
+    return (Version & VARIANT_MASK_CSIR_PROF) != 0;
+  }
+
   InstrProfSymtab &getSymtab() override {
     assert(Symtab.get());
     return *Symtab.get();
@@ -276,6 +287,15 @@ enum class HashT : uint32_t;
 
 } // end namespace IndexedInstrProf
 
+/// The profile of one function in an indexed profile, referring directly to
+/// the profile data rather than decoding it.
+struct InstrProfRecordRef {
+  uint64_t Hash;
+  ArrayRef<support::ulittle64_t> Counts;
+  /// The serialized value profile data of the function, if any.
+  ArrayRef<uint8_t> ValueData;
+};
+
 /// Trait for lookups into the on-disk hash table for the binary instrprof
 /// format.
 class InstrProfLookupTrait {
@@ -321,6 +341,14 @@ public:
                               const unsigned char *const End);
   data_type ReadData(StringRef K, const unsigned char *D, offset_type N);
 
+  /// Split the data of a key into the records it holds without decoding
+  /// them. Return false if the data is malformed.
+  bool readRecordRefs(const unsigned char *D, offset_type N,
+                      SmallVectorImpl<InstrProfRecordRef> &Refs) const;
+  /// Decode the value profile data \p Data of a record into \p Record.
+  Error readValueProfData(ArrayRef<uint8_t> Data,
+                          InstrProfRecord &Record) const;
+
   // Used for testing purpose only.
   void setValueProfDataEndianness(support::endianness Endianness) {
     ValueProfDataEndianness = Endianness;
@@ -337,11 +365,19 @@ struct InstrProfReaderIndexBase {
   // Read all the profile records with the key equal to FuncName
   virtual Error getRecords(StringRef FuncName,
                                      ArrayRef<NamedInstrProfRecord> &Data) = 0;
+
+  // Find the profile records with the key equal to FuncName without decoding
+  // them.
+  virtual Error getRecordRefs(StringRef FuncName,
+                              SmallVectorImpl<InstrProfRecordRef> &Refs) = 0;
+  virtual Error readValueProfData(ArrayRef<uint8_t> Data,
+                                  InstrProfRecord &Record) = 0;
   virtual void advanceToNextKey() = 0;
   virtual bool atEnd() const = 0;
   virtual void setValueProfDataEndianness(support::endianness Endianness) = 0;
   virtual uint64_t getVersion() const = 0;
   virtual bool isIRLevelProfile() const = 0;
+  virtual bool hasCSIRLevelProfile() const = 0;
   virtual Error populateSymtab(InstrProfSymtab &) = 0;
 };
 
@@ -370,6 +406,12 @@ public:
   Error getRecords(ArrayRef<NamedInstrProfRecord> &Data) override;
   Error getRecords(StringRef FuncName,
                    ArrayRef<NamedInstrProfRecord> &Data) override;
+  Error getRecordRefs(StringRef FuncName,
+                      SmallVectorImpl<InstrProfRecordRef> &Refs) override;
+  Error readValueProfData(ArrayRef<uint8_t> Data,
+                          InstrProfRecord &Record) override {
+    return HashTable->getInfoObj().readValueProfData(Data, Record);
+  }
   void advanceToNextKey() override { RecordIterator++; }
 
   bool atEnd() const override {
@@ -386,6 +428,10 @@ public:
     return (FormatVersion & VARIANT_MASK_IR_PROF) != 0;
   }
 
+  bool hasCSIRLevelProfile() const override {
+    return (FormatVersion & VARIANT_MASK_CSIR_PROF) != 0;
+  }
+
   Error populateSymtab(InstrProfSymtab &Symtab) override {
     return Symtab.create(HashTable->keys());
   }
@@ -398,6 +444,8 @@ public:
   virtual Error populateRemappings() { return Error::success(); }
   virtual Error getRecords(StringRef FuncName,
                            ArrayRef<NamedInstrProfRecord> &Data) = 0;
+  virtual Error getRecordRefs(StringRef FuncName,
+                              SmallVectorImpl<InstrProfRecordRef> &Refs) = 0;
 };
 
 /// Reader for the indexed binary instrprof format.
@@ -433,6 +481,9 @@ public:
   /// Return the profile version.
   uint64_t getVersion() const { return Index->getVersion(); }
   bool isIRLevelProfile() const override { return Index->isIRLevelProfile(); }
+  bool hasCSIRLevelProfile() const override {
+    return Index->hasCSIRLevelProfile();
+  }
 
   /// Return true if the given buffer is in an indexed instrprof format.
   static bool hasFormat(const MemoryBuffer &DataBuffer);
@@ -450,6 +501,16 @@ public:
   Error getFunctionCounts(StringRef FuncName, uint64_t FuncHash,
                           std::vector<uint64_t> &Counts);
 
+  /// Find the profile of FuncName with FuncHash without decoding or copying
+  /// it. The counters in \p Ref point into the profile data and stay valid as
+  /// long as the reader.
+  Error getInstrProfRecordRef(StringRef FuncName, uint64_t FuncHash,
+                              InstrProfRecordRef &Ref);
+
+  /// Decode the value profile data of \p Ref into \p Record.
+  Error readValueProfData(const InstrProfRecordRef &Ref,
+                          InstrProfRecord &Record);
+
   /// Return the maximum of all known function counts.
   uint64_t getMaximumFunctionCount() { return Summary->getMaxFunctionCount(); }
 
@@ -34,7 +34,7 @@ class raw_fd_ostream;
 class InstrProfWriter {
 public:
   using ProfilingData = SmallDenseMap<uint64_t, InstrProfRecord>;
-  enum ProfKind { PF_Unknown = 0, PF_FE, PF_IRLevel };
+  enum ProfKind { PF_Unknown = 0, PF_FE, PF_IRLevel, PF_IRLevelWithCS };
 
 private:
   bool Sparse;
@@ -60,6 +60,17 @@ public:
   void mergeRecordsFromWriter(InstrProfWriter &&IPW,
                               function_ref<void(Error)> Warn);
 
+  /// Merge the function counts of \p IPW whose names fall in shard \p Shard
+  /// of \p NumShards, moving them out of \p IPW. Shards partition the
+  /// function names, so different writers may take different shards of the
+  /// same source concurrently.
+  void mergeRecordShardFromWriter(InstrProfWriter &IPW, unsigned Shard,
+                                  unsigned NumShards,
+                                  function_ref<void(Error)> Warn);
+
+  /// Return the shard of \p NumShards that function \p Name belongs to.
+  static unsigned getRecordShard(StringRef Name, unsigned NumShards);
+
   /// Write the profile to \c OS
   void write(raw_fd_ostream &OS);
 
@@ -75,17 +86,25 @@ public:
   std::unique_ptr<MemoryBuffer> writeBuffer();
 
   /// Set the ProfileKind. Report error if mixing FE and IR level profiles.
-  Error setIsIRLevelProfile(bool IsIRLevel) {
+  /// IR level profiles with context-sensitive records (\p WithCS) may be
+  /// merged with ones without; the result has context-sensitive records.
+  Error setIsIRLevelProfile(bool IsIRLevel, bool WithCS = false) {
     if (ProfileKind == PF_Unknown) {
-      ProfileKind = IsIRLevel ? PF_IRLevel: PF_FE;
+      if (IsIRLevel)
+        ProfileKind = WithCS ? PF_IRLevelWithCS : PF_IRLevel;
+      else
+        ProfileKind = PF_FE;
       return Error::success();
     }
-    return (IsIRLevel == (ProfileKind == PF_IRLevel))
-               ? Error::success()
-               : make_error<InstrProfError>(
-                     instrprof_error::unsupported_version);
+    if (IsIRLevel != (ProfileKind != PF_FE))
+      return make_error<InstrProfError>(instrprof_error::unsupported_version);
+    if (WithCS)
+      ProfileKind = PF_IRLevelWithCS;
+    return Error::success();
   }
 
+  ProfKind getProfileKind() const { return ProfileKind; }
+
   // Internal interface for testing purpose only.
   void setValueProfDataEndianness(support::endianness Endianness);
   void setOutputSparse(bool Sparse);
@@ -222,6 +222,7 @@
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/ErrorOr.h"
 #include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/StringSaver.h"
 #include "llvm/Support/SymbolRemappingReader.h"
 #include <algorithm>
 #include <cstdint>
@@ -455,13 +456,21 @@ public:
 
 class SampleProfileReaderCompactBinary : public SampleProfileReaderBinary {
 private:
-  /// Function name table.
-  std::vector<std::string> NameTable;
-  /// The table mapping from function name to the offset of its FunctionSample
-  /// towards file start.
-  DenseMap<StringRef, uint64_t> FuncOffsetTable;
+  /// Function name table, holding the MD5 hashes of the names.
+  std::vector<uint64_t> NameTable;
+  /// The names of the entries of NameTable, created when first read. Only the
+  /// names used by the functions that are read are ever created.
+  std::vector<StringRef> NameStrings;
+  BumpPtrAllocator NameAllocator;
+  StringSaver NameSaver{NameAllocator};
+  /// The start of the table mapping from function name to the offset of its
+  /// FunctionSample towards file start. The table is searched only for the
+  /// functions to use, when they are read.
+  const uint8_t *FuncOffsetTableStart = nullptr;
   /// The set containing the functions to use when compiling a module.
   DenseSet<StringRef> FuncsToUse;
+  /// Read all the functions until collectFuncsToUse is called.
+  bool UseAllFuncs = true;
   virtual std::error_code verifySPMagic(uint64_t Magic) override;
   virtual std::error_code readNameTable() override;
   /// Read a string indirectly via the name table.
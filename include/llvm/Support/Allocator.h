@@ -38,6 +38,17 @@
 
 namespace llvm {
 
+class raw_ostream;
+
+/// Record the number of bytes every call site allocates from BumpPtrAllocators
+/// from now on, and print them on llvm_shutdown. -profile-bump-ptr-allocations
+/// enables this from the command line.
+void EnableBumpPtrAllocationProfiling();
+
+/// Print the bytes allocated from BumpPtrAllocators per call site, most bytes
+/// first, as recorded since profiling was enabled.
+void PrintBumpPtrAllocationProfile(raw_ostream &OS);
+
 /// CRTP base class providing obvious overloads for the core \c
 /// Allocate() methods of LLVM-style allocators.
 ///
@@ -120,6 +131,13 @@ namespace detail {
 void printBumpPtrAllocatorStats(unsigned NumSlabs, size_t BytesAllocated,
                                 size_t TotalMemory);
 
+/// Whether BumpPtrAllocator allocations are recorded per call site.
+extern bool ProfileBumpPtrAllocations;
+
+/// Record an allocation of \p Size bytes at the call site of this function,
+/// which is the caller of BumpPtrAllocatorImpl::Allocate once that is inlined.
+LLVM_ATTRIBUTE_NOINLINE void recordBumpPtrAllocation(size_t Size);
+
 } // end namespace detail
 
 /// Allocate memory in an ever growing pool, as if by bump-pointer.
@@ -217,6 +235,8 @@ public:
 
     // Keep track of how many bytes we've allocated.
     BytesAllocated += Size;
+    if (LLVM_UNLIKELY(detail::ProfileBumpPtrAllocations))
+      detail::recordBumpPtrAllocation(Size);
 
     size_t Adjustment = alignmentAdjustment(CurPtr, Alignment);
     assert(Adjustment + Size >= Size && "Adjustment + Size must not overflow");
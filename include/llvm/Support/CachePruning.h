@@ -58,6 +58,13 @@ struct CachePruningPolicy {
   /// 4096 and large_dir disabled), there is a per-directory entry limit of
   /// 508*510*floor(4096/(40+8))~=20M for average filename length of 40.
   uint64_t MaxSizeFiles = 1000000;
+
+  /// Whether to prune from the cache journal instead of scanning the cache
+  /// directory. The journal records the size and time of last use of each
+  /// entry, so pruning does not need to list and stat every file. It is
+  /// created by the first pruning that enables it, and is kept up to date by
+  /// recordCacheEntryUse() from then on.
+  bool UseJournal = false;
 };
 
 /// Parse the given string as a cache pruning policy. Defaults are taken from a
@@ -67,12 +74,22 @@ struct CachePruningPolicy {
 /// and maximum cache size of 50% of available disk space.
 Expected<CachePruningPolicy> parseCachePruningPolicy(StringRef PolicyStr);
 
+/// Record that the entry EntryName of Size bytes was added to or used from the
+/// cache directory Path. This appends a line to the cache journal if the
+/// directory has one, and does nothing otherwise. It is safe to call from
+/// several processes at once.
+void recordCacheEntryUse(StringRef Path, StringRef EntryName, uint64_t Size);
+
 /// Peform pruning using the supplied policy, returns true if pruning
 /// occurred, i.e. if Policy.Interval was expired.
 ///
 /// As a safeguard against data loss if the user specifies the wrong directory
 /// as their cache directory, this function will ignore files not matching the
 /// pattern "llvmcache-*".
+///
+/// With Policy.UseJournal, the cache journal is read instead of the directory.
+/// If there is no journal yet, or another process is pruning at the same
+/// time, the directory is scanned and a new journal is written.
 bool pruneCache(StringRef Path, CachePruningPolicy Policy);
 
 } // namespace llvm
@@ -13,6 +13,7 @@
 #define LLVM_SUPPORT_CODEGENCOVERAGE_H
 
 #include "llvm/ADT/BitVector.h"
+#include <vector>
 
 namespace llvm {
 class LLVMContext;
@@ -21,6 +22,8 @@ class MemoryBuffer;
 class CodeGenCoverage {
 protected:
   BitVector RuleCoverage;
+  /// The number of times each rule was applied.
+  std::vector<uint64_t> RuleHits;
 
 public:
   using const_covered_iterator = BitVector::const_set_bits_iterator;
@@ -29,6 +32,8 @@ public:
 
   void setCovered(uint64_t RuleID);
   bool isCovered(uint64_t RuleID) const;
+  /// Returns the number of times the rule \p RuleID was applied.
+  uint64_t getHitCount(uint64_t RuleID) const;
   iterator_range<const_covered_iterator> covered() const;
 
   bool parse(MemoryBuffer &Buffer, StringRef BackendName);
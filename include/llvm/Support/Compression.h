@@ -33,6 +33,15 @@ bool isAvailable();
 Error compress(StringRef InputBuffer, SmallVectorImpl<char> &CompressedBuffer,
                int Level = DefaultCompression);
 
+/// Compress \p InputBuffer into a single zlib stream whose deflate blocks are
+/// produced independently for every \p ChunkSize bytes of input, in parallel
+/// when LLVM is built with threads. Each chunk is primed with the data that
+/// precedes it, so the result is only slightly larger than with compress(),
+/// and it does not depend on the number of threads.
+Error compressInChunks(StringRef InputBuffer,
+                       SmallVectorImpl<char> &CompressedBuffer,
+                       size_t ChunkSize, int Level = DefaultCompression);
+
 Error uncompress(StringRef InputBuffer, char *UncompressedBuffer,
                  size_t &UncompressedSize);
 
@@ -44,6 +53,34 @@ uint32_t crc32(StringRef Buffer);
 
 }  // End of namespace zlib
 
+namespace zstd {
+
+static constexpr int BestSpeedCompression = 1;
+static constexpr int DefaultCompression = 5;
+static constexpr int BestSizeCompression = 12;
+
+bool isAvailable();
+
+/// Compress \p InputBuffer into a single zstd frame that records the size of
+/// the input. When \p NumThreads is not zero and zstd is built with threads,
+/// the input is compressed by that many worker threads; the result is the
+/// same for any number of workers.
+Error compress(StringRef InputBuffer, SmallVectorImpl<char> &CompressedBuffer,
+               int Level = DefaultCompression, unsigned NumThreads = 0);
+
+Error uncompress(StringRef InputBuffer, char *UncompressedBuffer,
+                 size_t &UncompressedSize);
+
+Error uncompress(StringRef InputBuffer,
+                 SmallVectorImpl<char> &UncompressedBuffer,
+                 size_t UncompressedSize);
+
+/// Return true if \p Buffer starts with the magic number of a zstd frame.
+/// This does not need zstd to be available.
+bool isFrame(StringRef Buffer);
+
+}  // End of namespace zstd
+
 } // End of namespace llvm
 
 #endif
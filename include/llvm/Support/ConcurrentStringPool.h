@@ -0,0 +1,89 @@
+//===- llvm/Support/ConcurrentStringPool.h ----------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file declares ConcurrentStringPool, a string table that many threads
+// can add strings to, and that assigns the string offsets deterministically
+// once all strings were added.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_SUPPORT_CONCURRENTSTRINGPOOL_H
+#define LLVM_SUPPORT_CONCURRENTSTRINGPOOL_H
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/Allocator.h"
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace llvm {
+
+/// A table of unique, null-terminated strings that can be filled from many
+/// threads at once.
+///
+/// The strings are spread over shards by hash, each with its own lock and
+/// arena. Every string that is added comes with an order key, and finalize()
+/// lays the strings out by the smallest key each was added with. Offsets thus
+/// do not depend on how the threads were scheduled: keys that number the
+/// strings in the order a serial producer would add them reproduce its
+/// layout exactly.
+class ConcurrentStringPool {
+public:
+  struct EntryValue {
+    /// The smallest order key the string was added with, or NotAdded if it
+    /// was only interned.
+    uint64_t Key;
+    /// The offset of the string in the table, once finalized.
+    uint64_t Offset = 0;
+
+    explicit EntryValue(uint64_t Key) : Key(Key) {}
+  };
+  using Entry = StringMapEntry<EntryValue>;
+
+  static const uint64_t NotAdded = UINT64_MAX;
+
+  /// Get permanent storage for \p S without adding it to the table. Interning
+  /// the same string again yields the same storage. Thread-safe.
+  StringRef intern(StringRef S);
+
+  /// Add \p S to the table with order key \p Key. Thread-safe.
+  ///
+  /// \returns The entry of \p S, whose offset is valid after finalize().
+  const Entry &add(StringRef S, uint64_t Key);
+
+  /// Lay out the added strings and assign their offsets. Must be called once,
+  /// after all strings were added.
+  ///
+  /// \returns The size of the table.
+  uint64_t finalize();
+
+  /// The added strings, in the order of their offsets. Only valid after
+  /// finalize().
+  ArrayRef<const Entry *> getEntriesInOrder() const { return Finalized; }
+
+private:
+  static const unsigned NumShards = 64;
+
+  struct Shard {
+    std::mutex Mutex;
+    StringMap<EntryValue, BumpPtrAllocator> Strings;
+  };
+
+  Shard &getShard(StringRef S);
+
+  Shard Shards[NumShards];
+  std::vector<const Entry *> Finalized;
+  bool IsFinalized = false;
+};
+
+} // end namespace llvm
+
+#endif // LLVM_SUPPORT_CONCURRENTSTRINGPOOL_H
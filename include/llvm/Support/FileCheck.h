@@ -18,8 +18,9 @@
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Regex.h"
 #include "llvm/Support/SourceMgr.h"
-#include <vector>
 #include <map>
+#include <memory>
+#include <vector>
 
 namespace llvm {
 
@@ -95,6 +96,14 @@ class FileCheckPattern {
   /// a fixed string to match.
   std::string RegExStr;
 
+  /// The regex compiled from RegExStr, if it does not depend on the values of
+  /// variables. Copies of the pattern share it.
+  std::shared_ptr<Regex> CompiledRegEx;
+
+  /// The fixed text that a regex pattern starts with, if any. Matches can only
+  /// start on lines where it occurs, which are found without the regex.
+  StringRef LiteralPrefix;
+
   /// Entries in this vector map to uses of a variable in the pattern, e.g.
   /// "foo[[bar]]baz".  In this case, the RegExStr will contain "foobaz" and
   /// we'll get an entry in this vector that tells us to insert the value of
@@ -140,6 +149,9 @@ public:
 
 private:
   bool AddRegExToRegEx(StringRef RS, unsigned &CurParen, SourceMgr &SM);
+  size_t MatchSucceeded(StringRef Buffer, ArrayRef<StringRef> MatchInfo,
+                        size_t &MatchLen,
+                        StringMap<StringRef> &VariableTable) const;
   void AddBackrefToRegEx(unsigned BackrefNum);
   unsigned
   ComputeMatchDistance(StringRef Buffer,
@@ -435,6 +435,17 @@ std::error_code copy_file(const Twine &From, int ToFD);
 ///          platform-specific error_code.
 std::error_code resize_file(int FD, uint64_t Size);
 
+/// Advise the system how the range [Offset, Offset + Length) of an open file
+/// is going to be read. Only AH_Sequential, AH_Random and AH_WillNeed apply to
+/// files.
+///
+/// @param FD Input file descriptor.
+/// @param Hints A combination of AccessHints.
+/// @returns errc::success if the advice was taken or the system does not take
+///          such advice, otherwise a platform-specific error_code.
+std::error_code adviseFile(int FD, uint64_t Offset, uint64_t Length,
+                           unsigned Hints);
+
 /// Compute an MD5 hash of a file's contents.
 ///
 /// @param FD Input file descriptor.
@@ -768,6 +779,26 @@ enum OpenFlags : unsigned {
   OF_UpdateAtime = 16,
 };
 
+/// Hints on how the data of an open file, or of a mapping of it, is going to
+/// be read. They are only advice: systems that cannot take them ignore them.
+enum AccessHints : unsigned {
+  AH_None = 0,
+
+  /// The data is read front to back, so read ahead aggressively.
+  AH_Sequential = 1,
+
+  /// The data is read in no particular order, so do not read ahead.
+  AH_Random = 2,
+
+  /// All the data is needed soon: start reading it in now, without waiting
+  /// for it.
+  AH_WillNeed = 4,
+
+  /// Back the data with transparent huge pages where possible, to save TLB
+  /// misses on large buffers.
+  AH_HugePages = 8,
+};
+
 /// Create a uniquely named file.
 ///
 /// Generates a unique path suitable for a temporary file and then opens it as a
@@ -1114,6 +1145,10 @@ public:
   /// behavior.
   const char *const_data() const;
 
+  /// Advise the system how the mapping is going to be read. \p Hints is a
+  /// combination of AccessHints.
+  std::error_code advise(unsigned Hints) const;
+
   /// \returns The minimum alignment offset must be.
   static int alignment();
 };
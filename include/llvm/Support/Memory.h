@@ -91,6 +91,27 @@ namespace sys {
     /// Release mapped memory.
     static std::error_code releaseMappedMemory(MemoryBlock &Block);
 
+    /// This method allocates \p NumBytes of memory, rounded up to whole pages,
+    /// that is mapped at two addresses: \p Writable is mapped with
+    /// MF_READ | MF_WRITE and \p Target with \p TargetFlags. What is written
+    /// through \p Writable can be read through \p Target, so that a JIT can
+    /// emit code into memory that is never writable and executable at the same
+    /// address. Both blocks start at a multiple of \p Alignment, which must be
+    /// a power of two.
+    ///
+    /// Both blocks are released with the releaseMappedMemory method.
+    ///
+    /// \r error_success if the function was successful, otherwise an
+    /// error_code describing the failure (errc::not_supported if the system
+    /// can not map memory twice), with both blocks left null.
+    ///
+    /// Allocate dual mapped memory.
+    static std::error_code allocateDualMappedMemory(size_t NumBytes,
+                                                    size_t Alignment,
+                                                    unsigned TargetFlags,
+                                                    MemoryBlock &Writable,
+                                                    MemoryBlock &Target);
+
     /// This method sets the protection flags for a block of memory to the
     /// state specified by /p Flags.  The behavior is not specified if the
     /// memory was not allocated using the allocateMappedMemory method.
@@ -113,6 +134,11 @@ namespace sys {
     /// that has been emitted it must invalidate the instruction cache on some
     /// platforms.
     static void InvalidateInstructionCache(const void *Addr, size_t Len);
+
+    /// Advise the system to back the whole huge pages inside the block of
+    /// memory at \p Addr with transparent huge pages, if it supports them. The
+    /// block may be allocated in any way; this is only advice.
+    static void adviseHugePages(void *Addr, size_t Len);
   };
 
   /// Owning version of MemoryBlock.
@@ -24,6 +24,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <vector>
 
 namespace llvm {
 
@@ -77,9 +78,26 @@ public:
   /// \param IsVolatile Set to true to indicate that the contents of the file
   /// can change outside the user's control, e.g. when libclang tries to parse
   /// while the user is editing/updating the file or if the file is on an NFS.
+  ///
+  /// \param Hints A combination of sys::fs::AccessHints describing how the
+  /// buffer is going to be read. AH_HugePages makes the file be read into
+  /// memory rather than mapped.
   static ErrorOr<std::unique_ptr<MemoryBuffer>>
   getFile(const Twine &Filename, int64_t FileSize = -1,
-          bool RequiresNullTerminator = true, bool IsVolatile = false);
+          bool RequiresNullTerminator = true, bool IsVolatile = false,
+          unsigned Hints = sys::fs::AH_None);
+
+  /// The default number of files getFiles() reads at once: enough requests in
+  /// flight to hide the latency of network storage.
+  static constexpr unsigned DefaultGetFilesThreads = 16;
+
+  /// Open all of \p Filenames as with getFile(), reading up to \p NumThreads
+  /// of them at once. Returns the buffer or the error for each file, in the
+  /// order of \p Filenames.
+  static std::vector<ErrorOr<std::unique_ptr<MemoryBuffer>>>
+  getFiles(ArrayRef<StringRef> Filenames, bool RequiresNullTerminator = true,
+           unsigned Hints = sys::fs::AH_None,
+           unsigned NumThreads = DefaultGetFilesThreads);
 
   /// Read all of the specified file into a MemoryBuffer as a stream
   /// (i.e. until EOF reached). This is useful for special files that
@@ -102,7 +120,8 @@ public:
   /// while the user is editing/updating the file or if the file is on an NFS.
   static ErrorOr<std::unique_ptr<MemoryBuffer>>
   getOpenFile(int FD, const Twine &Filename, uint64_t FileSize,
-              bool RequiresNullTerminator = true, bool IsVolatile = false);
+              bool RequiresNullTerminator = true, bool IsVolatile = false,
+              unsigned Hints = sys::fs::AH_None);
 
   /// Open the specified memory range as a MemoryBuffer. Note that InputData
   /// must be null terminated if RequiresNullTerminator is true.
@@ -70,15 +70,24 @@ public:
     std::unique_lock<std::mutex> lock(Mutex);
     Cond.wait(lock, [&] { return Count == 0; });
   }
+
+  bool isDone() const {
+    std::lock_guard<std::mutex> lock(Mutex);
+    return Count == 0;
+  }
 };
 
 class TaskGroup {
   Latch L;
 
 public:
+  ~TaskGroup() { sync(); }
+
   void spawn(std::function<void()> f);
 
-  void sync() const { L.sync(); }
+  /// Waits for all the spawned tasks. When called from a task, this runs
+  /// other pending tasks in the meantime.
+  void sync() const;
 };
 
 #if defined(_MSC_VER)
@@ -0,0 +1,98 @@
+//===- ThreadLocalBumpPtrAllocator.h - Per-thread allocator -----*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+/// \file
+///
+/// This file defines ThreadLocalBumpPtrAllocator, a BumpPtrAllocator that can
+/// be shared by the threads of a parallel pass.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_SUPPORT_THREADLOCALBUMPPTRALLOCATOR_H
+#define LLVM_SUPPORT_THREADLOCALBUMPPTRALLOCATOR_H
+
+#include "llvm/Support/Allocator.h"
+#include "llvm/Support/Compiler.h"
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace llvm {
+
+namespace detail {
+
+/// The per-thread allocator that the calling thread used last, and the ID of
+/// the ThreadLocalBumpPtrAllocator it belongs to.
+struct ThreadLocalAllocatorCache {
+  uint64_t OwnerID;
+  BumpPtrAllocator *Allocator;
+};
+extern LLVM_THREAD_LOCAL ThreadLocalAllocatorCache CurrentThreadAllocator;
+
+} // end namespace detail
+
+/// An allocator that gives each thread its own BumpPtrAllocator, so that
+/// threads allocate without locking.
+///
+/// Memory allocated by any thread can be used by all threads, and all of it is
+/// freed at once by Reset() or the destructor, which must not run while other
+/// threads use the allocator.
+class ThreadLocalBumpPtrAllocator
+    : public AllocatorBase<ThreadLocalBumpPtrAllocator> {
+public:
+  ThreadLocalBumpPtrAllocator();
+  ThreadLocalBumpPtrAllocator(const ThreadLocalBumpPtrAllocator &) = delete;
+  ThreadLocalBumpPtrAllocator &
+  operator=(const ThreadLocalBumpPtrAllocator &) = delete;
+
+  LLVM_ATTRIBUTE_RETURNS_NONNULL LLVM_ATTRIBUTE_RETURNS_NOALIAS void *
+  Allocate(size_t Size, size_t Alignment) {
+    return getThreadAllocator().Allocate(Size, Alignment);
+  }
+
+  // Pull in base class overloads.
+  using AllocatorBase<ThreadLocalBumpPtrAllocator>::Allocate;
+
+  void Deallocate(const void *Ptr, size_t Size) {}
+
+  // Pull in base class overloads.
+  using AllocatorBase<ThreadLocalBumpPtrAllocator>::Deallocate;
+
+  /// Return the BumpPtrAllocator of the calling thread.
+  BumpPtrAllocator &getThreadAllocator() {
+    detail::ThreadLocalAllocatorCache &Cache = detail::CurrentThreadAllocator;
+    if (LLVM_LIKELY(Cache.OwnerID == ID))
+      return *Cache.Allocator;
+    return getThreadAllocatorSlow();
+  }
+
+  /// Deallocate all the memory of all the threads.
+  void Reset();
+
+  size_t getTotalMemory() const;
+  size_t getBytesAllocated() const;
+  void PrintStats() const;
+
+private:
+  BumpPtrAllocator &getThreadAllocatorSlow();
+
+  /// Unique among all the allocators ever created, so that a thread never
+  /// mistakes a new allocator for a destroyed one at the same address.
+  const uint64_t ID;
+  mutable std::mutex Mutex;
+  /// The allocator of each thread that allocated, guarded by Mutex.
+  std::vector<std::pair<std::thread::id, std::unique_ptr<BumpPtrAllocator>>>
+      Allocators;
+};
+
+} // end namespace llvm
+
+#endif // LLVM_SUPPORT_THREADLOCALBUMPPTRALLOCATOR_H
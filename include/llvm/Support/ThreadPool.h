@@ -24,16 +24,19 @@
 #include <functional>
 #include <memory>
 #include <mutex>
-#include <queue>
 #include <utility>
+#include <vector>
 
 namespace llvm {
 
+class ThreadPoolTaskGroup;
+
 /// A ThreadPool for asynchronous parallel execution on a defined number of
 /// threads.
 ///
 /// The pool keeps a vector of threads alive, waiting on a condition variable
-/// for some work to become available.
+/// for some work to become available. Queued tasks run in order of decreasing
+/// priority, and in submission order within a priority.
 class ThreadPool {
 public:
   using TaskTy = std::function<void()>;
@@ -55,30 +58,69 @@ public:
   inline std::shared_future<void> async(Function &&F, Args &&... ArgList) {
     auto Task =
         std::bind(std::forward<Function>(F), std::forward<Args>(ArgList)...);
-    return asyncImpl(std::move(Task));
+    return asyncImpl(std::move(Task), 0, nullptr);
   }
 
   /// Asynchronous submission of a task to the pool. The returned future can be
   /// used to wait for the task to finish and is *non-blocking* on destruction.
   template <typename Function>
   inline std::shared_future<void> async(Function &&F) {
-    return asyncImpl(std::forward<Function>(F));
+    return asyncImpl(std::forward<Function>(F), 0, nullptr);
+  }
+
+  /// Asynchronous submission of a task that runs before all the queued tasks
+  /// of lower \p Priority, e.g. the largest jobs first.
+  template <typename Function>
+  inline std::shared_future<void> asyncWithPriority(unsigned Priority,
+                                                    Function &&F) {
+    return asyncImpl(std::forward<Function>(F), Priority, nullptr);
   }
 
   /// Blocking wait for all the threads to complete and the queue to be empty.
   /// It is an error to try to add new tasks while blocking on this call.
   void wait();
 
+  /// Blocking wait for the tasks of \p Group to complete. Other tasks may be
+  /// added meanwhile, including to \p Group by its own tasks. This must not
+  /// be called from a task of the pool.
+  void wait(ThreadPoolTaskGroup &Group);
+
 private:
+  friend class ThreadPoolTaskGroup;
+
+  struct QueuedTask {
+    PackagedTaskTy Task;
+    unsigned Priority;
+    /// Submission order, to run tasks of the same priority in FIFO order.
+    uint64_t Sequence;
+    ThreadPoolTaskGroup *Group;
+
+    /// The task to run next compares greatest.
+    bool operator<(const QueuedTask &Other) const {
+      if (Priority != Other.Priority)
+        return Priority < Other.Priority;
+      return Sequence > Other.Sequence;
+    }
+  };
+
   /// Asynchronous submission of a task to the pool. The returned future can be
   /// used to wait for the task to finish and is *non-blocking* on destruction.
-  std::shared_future<void> asyncImpl(TaskTy F);
+  std::shared_future<void> asyncImpl(TaskTy F, unsigned Priority,
+                                     ThreadPoolTaskGroup *Group);
+
+  /// Adds \p Task to the heap of queued tasks. Requires QueueLock.
+  void pushTask(QueuedTask Task);
+  /// Removes the queued task with the highest priority. Requires QueueLock.
+  QueuedTask popTask();
+  /// Marks a task of \p Group as done. Requires CompletionLock.
+  void finishTask(ThreadPoolTaskGroup *Group);
 
   /// Threads in flight
   std::vector<llvm::thread> Threads;
 
-  /// Tasks waiting for execution in the pool.
-  std::queue<PackagedTaskTy> Tasks;
+  /// Tasks waiting for execution in the pool, as a heap ordered by priority.
+  std::vector<QueuedTask> Tasks;
+  uint64_t NextSequence = 0;
 
   /// Locking and signaling for accessing the Tasks queue.
   std::mutex QueueLock;
@@ -96,6 +138,73 @@ private:
   bool EnableFlag;
 #endif
 };
+
+/// A set of tasks of a ThreadPool that can be waited for and cancelled
+/// together.
+///
+/// Cancelling a group drops its tasks that have not started yet; running tasks
+/// can poll isCancelled() to stop early, e.g. after another task of the group
+/// failed.
+class ThreadPoolTaskGroup {
+public:
+  explicit ThreadPoolTaskGroup(ThreadPool &Pool) : Pool(Pool) {}
+
+  /// Blocking destructor: waits for the tasks of the group to complete.
+  ~ThreadPoolTaskGroup() { wait(); }
+
+  /// Asynchronous submission of a task of the group with \p Priority. The
+  /// returned future is ready once the task ran or was dropped.
+  template <typename Function>
+  inline std::shared_future<void> async(Function &&F, unsigned Priority = 0) {
+    return Pool.asyncImpl(std::forward<Function>(F), Priority, this);
+  }
+
+  /// Blocking wait for the tasks of the group to complete.
+  void wait() { Pool.wait(*this); }
+
+  /// Drops the tasks of the group that have not started yet, including the
+  /// ones added after this call.
+  void cancel() { Cancelled = true; }
+
+  bool isCancelled() const { return Cancelled; }
+
+private:
+  friend class ThreadPool;
+
+  ThreadPool &Pool;
+  std::atomic<bool> Cancelled{false};
+  /// The number of tasks of the group that are queued or running. Guarded by
+  /// the CompletionLock of the pool.
+  unsigned Pending = 0;
+};
+
+/// A graph of tasks to run on a ThreadPool, each after all the tasks it
+/// depends on.
+class ThreadPoolTaskGraph {
+public:
+  using TaskID = unsigned;
+
+  /// Adds a task to the graph. Among the tasks that are ready to run, the ones
+  /// with a higher \p Priority run first.
+  TaskID addTask(ThreadPool::TaskTy F, unsigned Priority = 0);
+
+  /// Makes task \p After wait for task \p Before to complete.
+  void addDependency(TaskID Before, TaskID After);
+
+  /// Runs all the tasks in \p Group and waits for them. The graph must be
+  /// acyclic. Once \p Group is cancelled, no further task of the graph starts.
+  void run(ThreadPoolTaskGroup &Group);
+
+private:
+  struct Node {
+    ThreadPool::TaskTy F;
+    unsigned Priority;
+    unsigned NumPredecessors;
+    std::vector<TaskID> Successors;
+  };
+
+  std::vector<Node> Nodes;
+};
 }
 
 #endif // LLVM_SUPPORT_THREAD_POOL_H
@@ -19,6 +19,7 @@
 #include "llvm/ADT/None.h"
 #include "llvm/ADT/Optional.h"
 #include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringMap.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/ADT/Twine.h"
 #include "llvm/Support/Chrono.h"
@@ -29,6 +30,7 @@
 #include <cstdint>
 #include <ctime>
 #include <memory>
+#include <mutex>
 #include <stack>
 #include <string>
 #include <system_error>
@@ -385,6 +387,49 @@ private:
   IntrusiveRefCntPtr<FileSystem> FS;
 };
 
+/// A file system that remembers the results of status() and dir_begin() on
+/// another, for tools that look up the same paths many times. Failed lookups
+/// are remembered too, and openFileForRead() fails without asking the
+/// underlying file system for a path known not to exist.
+///
+/// Paths are made absolute before being looked up, so the cache stays valid
+/// across changes of the working directory. Changes to the underlying file
+/// system are not noticed: call invalidate() or invalidateAll() after making
+/// some. It is safe to use from several threads.
+class CachingFileSystem : public ProxyFileSystem {
+public:
+  explicit CachingFileSystem(IntrusiveRefCntPtr<FileSystem> FS)
+      : ProxyFileSystem(std::move(FS)) {}
+
+  llvm::ErrorOr<Status> status(const Twine &Path) override;
+  llvm::ErrorOr<std::unique_ptr<File>>
+  openFileForRead(const Twine &Path) override;
+  directory_iterator dir_begin(const Twine &Dir, std::error_code &EC) override;
+
+  /// Forget the status of \p Path, its listing if it is a directory, and the
+  /// listing of its parent directory.
+  void invalidate(const Twine &Path);
+
+  /// Forget everything.
+  void invalidateAll();
+
+private:
+  struct DirEntry {
+    std::string Name;
+    llvm::sys::fs::file_type Type;
+  };
+  using DirListing = std::vector<DirEntry>;
+  class CachedDirIterImpl;
+
+  std::mutex Mutex;
+  StringMap<llvm::ErrorOr<Status>> StatusCache;
+  StringMap<std::shared_ptr<const DirListing>> DirCache;
+
+  /// Set \p Key to the absolute form of \p Path that the caches are indexed
+  /// by.
+  std::error_code getKey(const Twine &Path, SmallVectorImpl<char> &Key) const;
+};
+
 namespace detail {
 
 class InMemoryDirectory;
@@ -1350,6 +1350,11 @@ private:
 /// the mapRequired() method calls may not be in the same order
 /// as the keys in the document.
 ///
+/// The HNodes of a document are bump-allocated and released when the next
+/// document is read, so a stream of many small documents, such as a remarks
+/// file, reuses the same memory. Scalars refer to the input buffer unless
+/// they had to be unescaped.
+///
 class Input : public IO {
 public:
   // Construct a yaml Input object from a StringRef and optional
@@ -1454,10 +1459,12 @@ private:
 
     static bool classof(const MapHNode *) { return true; }
 
-    using NameToNode = StringMap<std::unique_ptr<HNode>>;
+    using NameToNode = StringMap<HNode *>;
 
     NameToNode Mapping;
-    SmallVector<std::string, 6> ValidKeys;
+    /// The keys of Mapping looked up while mapping this node, owned by
+    /// Mapping.
+    SmallVector<StringRef, 6> ValidKeys;
   };
 
   class SequenceHNode : public HNode {
@@ -1472,10 +1479,12 @@ private:
 
     static bool classof(const SequenceHNode *) { return true; }
 
-    std::vector<std::unique_ptr<HNode>> Entries;
+    std::vector<HNode *> Entries;
   };
 
-  std::unique_ptr<Input::HNode> createHNodes(Node *node);
+  Input::HNode *createHNodes(Node *node);
+  /// Destroy the HNodes of the current document.
+  void releaseHNodes();
   void setError(HNode *hnode, const Twine &message);
   void setError(Node *node, const Twine &message);
 
@@ -1491,9 +1500,13 @@ public:
 private:
   SourceMgr                           SrcMgr; // must be before Strm
   std::unique_ptr<llvm::yaml::Stream> Strm;
-  std::unique_ptr<HNode>              TopNode;
+  HNode *TopNode = nullptr;
   std::error_code                     EC;
   BumpPtrAllocator                    StringAllocator;
+  SpecificBumpPtrAllocator<EmptyHNode>    EmptyHNodeAllocator;
+  SpecificBumpPtrAllocator<ScalarHNode>   ScalarHNodeAllocator;
+  SpecificBumpPtrAllocator<MapHNode>      MapHNodeAllocator;
+  SpecificBumpPtrAllocator<SequenceHNode> SequenceHNodeAllocator;
   document_iterator                   DocIterator;
   std::vector<bool>                   BitValuesUsed;
   HNode *CurrentNode = nullptr;
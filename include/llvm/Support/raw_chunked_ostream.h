@@ -0,0 +1,113 @@
+//===- raw_chunked_ostream.h - Output assembled from chunks -----*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines the raw_chunked_ostream class, which lets several threads
+// format the pieces of one output at once.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_SUPPORT_RAW_CHUNKED_OSTREAM_H
+#define LLVM_SUPPORT_RAW_CHUNKED_OSTREAM_H
+
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/Support/raw_ostream.h"
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <system_error>
+#include <vector>
+
+namespace llvm {
+
+/// Assembles an output from chunks that are formatted independently, possibly
+/// on different threads, and written out in the order they were added.
+///
+/// Each chunk is a raw_pwrite_stream backed by its own buffer, so it can be
+/// handed to any code that writes to a raw_pwrite_stream, including code that
+/// patches earlier parts of its output. Once a chunk is committed, it is
+/// written as soon as all the chunks before it are committed, and its memory
+/// is released.
+///
+/// When the output is a seekable raw_fd_ostream, the position of a chunk is
+/// fixed as soon as the chunks before it are committed, and the chunk is then
+/// written with pwrite outside of any lock, so the writes of different chunks
+/// overlap. Otherwise the chunks are written to the output in order, one at a
+/// time.
+///
+/// The output must not be used between the construction of the
+/// raw_chunked_ostream and the call to finish().
+class raw_chunked_ostream {
+public:
+  class Chunk : public raw_svector_ostream {
+    friend class raw_chunked_ostream;
+
+    SmallVector<char, 0> Buffer;
+    bool Committed = false;
+
+  public:
+    Chunk() : raw_svector_ostream(Buffer) {}
+  };
+
+  /// Write the chunks to \p OS, in order.
+  explicit raw_chunked_ostream(raw_ostream &OS);
+
+  /// Write the chunks to \p OS, with pwrite if it supports seeking.
+  explicit raw_chunked_ostream(raw_fd_ostream &OS);
+
+  raw_chunked_ostream(const raw_chunked_ostream &) = delete;
+  raw_chunked_ostream &operator=(const raw_chunked_ostream &) = delete;
+
+  /// Calls finish() if it has not been called.
+  ~raw_chunked_ostream();
+
+  /// Add a chunk after all the chunks added so far. This is thread safe, but
+  /// the order of the chunks is then the order of the calls.
+  Chunk &addChunk();
+
+  /// Declare that \p C is complete. It must not be used afterwards. Can be
+  /// called from any thread, and does the writes that this makes possible.
+  void commit(Chunk &C);
+
+  /// Wait for all the chunks to be written, and leave the output positioned
+  /// after them. All the chunks must have been committed.
+  void finish();
+
+  /// Returns the first error hit while writing with pwrite. Errors in the
+  /// ordered mode are reported by the output stream itself.
+  std::error_code error() const { return EC; }
+
+private:
+  void writeChunk(Chunk &C, uint64_t Offset);
+
+  raw_ostream &OS;
+  /// The file output, if the chunks are written to it with pwrite.
+  raw_fd_ostream *FileOS = nullptr;
+  /// The file descriptor to pwrite to, or -1 to write to OS in order.
+  int FD = -1;
+  /// Where the first chunk goes in the file.
+  uint64_t StartOffset = 0;
+  bool Finished = false;
+
+  // Everything below is guarded by Mutex.
+  std::mutex Mutex;
+  std::condition_variable WritesDone;
+  std::vector<std::unique_ptr<Chunk>> Chunks;
+  /// The first chunk whose position is not known yet.
+  size_t NextToPlace = 0;
+  /// The size of all the chunks before NextToPlace.
+  uint64_t PlacedSize = 0;
+  /// How many placed chunks are still being written.
+  unsigned PendingWrites = 0;
+  std::error_code EC;
+};
+
+} // end namespace llvm
+
+#endif // LLVM_SUPPORT_RAW_CHUNKED_OSTREAM_H
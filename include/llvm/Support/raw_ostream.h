@@ -429,6 +429,9 @@ public:
 
   bool supportsSeeking() { return SupportsSeeking; }
 
+  /// Return the file descriptor this writes to.
+  int get_fd() const { return FD; }
+
   /// Flushes the stream and repositions the underlying file descriptor position
   /// to the offset specified from the beginning of the file.
   uint64_t seek(uint64_t off);
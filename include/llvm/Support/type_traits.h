@@ -15,6 +15,7 @@
 #define LLVM_SUPPORT_TYPE_TRAITS_H
 
 #include "llvm/Support/Compiler.h"
+#include <memory>
 #include <type_traits>
 #include <utility>
 
@@ -55,6 +56,28 @@ struct isPodLike<std::pair<T, U>> {
   static const bool value = isPodLike<T>::value && isPodLike<U>::value;
 };
 
+/// isTriviallyRelocatable - This is a type trait that is used to determine
+/// whether an object of a given type can be moved to a new address with memcpy,
+/// without running its move constructor or its destructor on the old copy.
+/// This holds for all pod-like types, and for types which do not point into
+/// themselves and do not register their address anywhere. Types opt in by
+/// specializing this trait.
+template <typename T> struct isTriviallyRelocatable {
+  static const bool value = isPodLike<T>::value;
+};
+
+template <typename T, typename U>
+struct isTriviallyRelocatable<std::pair<T, U>> {
+  static const bool value =
+      isTriviallyRelocatable<T>::value && isTriviallyRelocatable<U>::value;
+};
+
+// std::unique_ptr is a single pointer, plus the (empty) default deleter.
+template <typename T>
+struct isTriviallyRelocatable<std::unique_ptr<T>> {
+  static const bool value = true;
+};
+
 /// Metafunction that determines whether the given type is either an
 /// integral type or an enumeration type, including enum classes.
 ///
@@ -14,6 +14,8 @@
 #ifndef LLVM_TABLEGEN_MAIN_H
 #define LLVM_TABLEGEN_MAIN_H
 
+#include "llvm/ADT/StringRef.h"
+
 namespace llvm {
 
 class raw_ostream;
@@ -23,7 +25,18 @@ class RecordKeeper;
 /// Returns true on error, false otherwise.
 using TableGenMainFn = bool (raw_ostream &OS, RecordKeeper &Records);
 
-int TableGenMain(char *argv0, TableGenMainFn *MainFn);
+/// Select the action named Action for the next call of the TableGenMainFn.
+/// Returns true if there is no such action, false otherwise.
+using TableGenSelectFn = bool (StringRef Action);
+
+/// Parse the input file and run MainFn on its records.
+///
+/// If SelectFn is given, the tool also accepts -emit=<action>=<file> options,
+/// each of which runs MainFn for one action on the same parsed records and
+/// writes its output to a file of its own. The backends of the actions run in
+/// parallel processes where the system supports it.
+int TableGenMain(char *argv0, TableGenMainFn *MainFn,
+                 TableGenSelectFn *SelectFn = nullptr);
 
 } // end namespace llvm
 
@@ -296,6 +296,10 @@ namespace llvm {
     /// What exception model to use
     ExceptionHandling ExceptionModel = ExceptionHandling::None;
 
+    /// Size of a Pagerando bin in bytes. Every bin is randomized separately,
+    /// so this must be a multiple of the page size of the target system.
+    unsigned PagerandoBinSize = 4096;
+
     /// Machine level options.
     MCTargetOptions MCOptions;
   };
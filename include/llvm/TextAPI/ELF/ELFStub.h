@@ -15,10 +15,13 @@
 #ifndef LLVM_TEXTAPI_ELF_ELFSTUB_H
 #define LLVM_TEXTAPI_ELF_ELFSTUB_H
 
+#include "llvm/ADT/Optional.h"
 #include "llvm/BinaryFormat/ELF.h"
 #include "llvm/Support/VersionTuple.h"
-#include <vector>
 #include <set>
+#include <string>
+#include <tuple>
+#include <vector>
 
 namespace llvm {
 namespace elfabi {
@@ -43,15 +46,19 @@ struct ELFSymbol {
   bool Undefined;
   bool Weak;
   Optional<std::string> Warning;
+  /// The version the symbol is bound to, if any. A library may define the
+  /// same name in several versions, only one of which is the default that
+  /// new links bind to.
+  Optional<std::string> Version;
+  bool DefaultVersion = false;
   bool operator<(const ELFSymbol &RHS) const {
-    return Name < RHS.Name;
+    return std::tie(Name, Version) < std::tie(RHS.Name, RHS.Version);
   }
 };
 
 // A cumulative representation of ELF stubs.
 // Both textual and binary stubs will read into and write from this object.
 class ELFStub {
-// TODO: Add support for symbol versioning.
 public:
   VersionTuple TbeVersion;
   Optional<std::string> SoName;
@@ -39,6 +39,12 @@ Expected<std::unique_ptr<ELFStub>> readTBEFromBuffer(StringRef Buf);
 /// Attempts to write an ELF interface file to a raw_ostream.
 Error writeTBEToOutputStream(raw_ostream &OS, const ELFStub &Stub);
 
+/// Attempts to write an ELF interface file to \p FilePath, leaving the file
+/// and its modification time alone if it already has the same contents. This
+/// lets build systems skip relinking the dependents of a library whose
+/// interface did not change.
+Error writeTBEToFileIfChanged(StringRef FilePath, const ELFStub &Stub);
+
 } // end namespace elfabi
 } // end namespace llvm
 
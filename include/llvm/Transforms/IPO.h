@@ -275,6 +275,10 @@ ModulePass *createWriteThinLTOBitcodePass(raw_ostream &Str,
 /// POT base register.
 ModulePass *createPagerandoWrappersPass();
 
+/// \brief This pass redirects calls to Pagerando wrappers with known callers
+/// to the wrapped functions and deletes wrappers that become unused.
+ModulePass *createPagerandoWrapperEliminationPass();
+
 } // End llvm namespace
 
 #endif
@@ -72,10 +72,16 @@ private:
   // Insert @llvm.lifetime intrinsics.
   bool InsertLifetime = true;
 
+  InlineCostSummaryCache CalleeSummaryCache;
+
 protected:
   AssumptionCacheTracker *ACT;
   ProfileSummaryInfo *PSI;
   ImportedFunctionsInliningStatistics ImportedFunctionsStats;
+
+  /// The callee summaries shared by the cost queries of the current SCC, or
+  /// null if they are disabled.
+  InlineCostSummaryCache *CalleeSummaries = nullptr;
 };
 
 /// The inliner pass for the new pass manager.
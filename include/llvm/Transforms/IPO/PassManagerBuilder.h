@@ -160,6 +160,12 @@ public:
 
   /// Enable profile instrumentation pass.
   bool EnablePGOInstrGen;
+  /// Enable the context-sensitive profile instrumentation pass, which runs
+  /// after inlining and writes to PGOInstrGen.
+  bool EnablePGOCSInstrGen;
+  /// Enable the context-sensitive profile use pass, which reads the
+  /// context-sensitive records of PGOInstrUse after inlining.
+  bool EnablePGOCSInstrUse;
   /// Profile data file name that the instrumentation will be written to.
   std::string PGOInstrGen;
   /// Path of the profile data file.
@@ -186,9 +192,10 @@ private:
   void addInitialAliasAnalysisPasses(legacy::PassManagerBase &PM) const;
   void addLTOOptimizationPasses(legacy::PassManagerBase &PM);
   void addLateLTOOptimizationPasses(legacy::PassManagerBase &PM);
-  void addPGOInstrPasses(legacy::PassManagerBase &MPM);
+  void addPGOInstrPasses(legacy::PassManagerBase &MPM, bool IsCS = false);
   void addFunctionSimplificationPasses(legacy::PassManagerBase &MPM);
   void addInstructionCombiningPass(legacy::PassManagerBase &MPM) const;
+  void addGVNPasses(legacy::PassManagerBase &PM) const;
 
 public:
   /// populateFunctionPassManager - This fills in the function pass manager,
@@ -54,6 +54,7 @@ public:
 
   void getAnalysisUsage(AnalysisUsage &AU) const override;
   bool runOnFunction(Function &F) override;
+  bool doFinalization(Module &M) override;
 };
 
 //===----------------------------------------------------------------------===//
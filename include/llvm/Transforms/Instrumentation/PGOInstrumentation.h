@@ -27,23 +27,33 @@ class Function;
 class Instruction;
 class Module;
 
-/// The instrumentation (profile-instr-gen) pass for IR based PGO.
+/// The instrumentation (profile-instr-gen) pass for IR based PGO. With
+/// \p IsCS, this is the context-sensitive instrumentation that runs after
+/// inlining, whose records share the function names of the regular ones and
+/// carry a flag in their hash.
 class PGOInstrumentationGen : public PassInfoMixin<PGOInstrumentationGen> {
 public:
+  PGOInstrumentationGen(bool IsCS = false) : IsCS(IsCS) {}
   PreservedAnalyses run(Module &M, ModuleAnalysisManager &AM);
+
+private:
+  bool IsCS;
 };
 
-/// The profile annotation (profile-instr-use) pass for IR based PGO.
+/// The profile annotation (profile-instr-use) pass for IR based PGO. With
+/// \p IsCS, this reads the context-sensitive records of the profile after
+/// inlining.
 class PGOInstrumentationUse : public PassInfoMixin<PGOInstrumentationUse> {
 public:
   PGOInstrumentationUse(std::string Filename = "",
-                        std::string RemappingFilename = "");
+                        std::string RemappingFilename = "", bool IsCS = false);
 
   PreservedAnalyses run(Module &M, ModuleAnalysisManager &AM);
 
 private:
   std::string ProfileFileName;
   std::string ProfileRemappingFileName;
+  bool IsCS;
 };
 
 /// The indirect function call promotion pass.
@@ -310,9 +310,10 @@ FunctionPass *createMergedLoadStoreMotionPass();
 //===----------------------------------------------------------------------===//
 //
 // GVN - This pass performs global value numbering and redundant load
-// elimination cotemporaneously.
+// elimination cotemporaneously. Functions with fewer than MinFunctionSize
+// instructions are skipped.
 //
-FunctionPass *createNewGVNPass();
+FunctionPass *createNewGVNPass(unsigned MinFunctionSize = 0);
 
 //===----------------------------------------------------------------------===//
 //
@@ -37,12 +37,14 @@
 #ifndef LLVM_TRANSFORMS_SCALAR_CONSTANTHOISTING_H
 #define LLVM_TRANSFORMS_SCALAR_CONSTANTHOISTING_H
 
+#include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/PointerUnion.h"
 #include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/IR/PassManager.h"
 #include <algorithm>
+#include <tuple>
 #include <vector>
 
 namespace llvm {
@@ -56,6 +58,7 @@ class DominatorTree;
 class Function;
 class GlobalVariable;
 class Instruction;
+class OptimizationRemarkEmitter;
 class TargetTransformInfo;
 
 /// A private "module" namespace for types and utilities used by
@@ -125,7 +128,8 @@ public:
 
   // Glue for old PM.
   bool runImpl(Function &F, TargetTransformInfo &TTI, DominatorTree &DT,
-               BlockFrequencyInfo *BFI, BasicBlock &Entry);
+               BlockFrequencyInfo *BFI, BasicBlock &Entry,
+               OptimizationRemarkEmitter *ORE = nullptr);
 
   void releaseMemory() {
     ClonedCastMap.clear();
@@ -137,6 +141,7 @@ public:
     for (auto MapEntry : ConstGEPInfoMap)
       MapEntry.second.clear();
     ConstGEPInfoMap.clear();
+    BlockPressure.clear();
   }
 
 private:
@@ -146,6 +151,7 @@ private:
   const TargetTransformInfo *TTI;
   DominatorTree *DT;
   BlockFrequencyInfo *BFI;
+  OptimizationRemarkEmitter *ORE;
   LLVMContext *Ctx;
   const DataLayout *DL;
   BasicBlock *Entry;
@@ -165,6 +171,13 @@ private:
   /// Keep track of cast instructions we already cloned.
   SmallDenseMap<Instruction *, Instruction *> ClonedCastMap;
 
+  /// The estimated register pressure of the blocks seen so far.
+  DenseMap<BasicBlock *, unsigned> BlockPressure;
+
+  /// A use of a constant to rebase: the offset from the base, the type of a
+  /// constant expression, and the user.
+  using RebasedUse = std::tuple<Constant *, Type *, consthoist::ConstantUser>;
+
   Instruction *findMatInsertPt(Instruction *Inst, unsigned Idx = ~0U) const;
   SmallPtrSet<Instruction *, 8>
   findConstantInsertionPoint(const consthoist::ConstantInfo &ConstInfo) const;
@@ -190,6 +203,12 @@ private:
   void findBaseConstants(GlobalVariable *BaseGV);
   void emitBaseConstants(Instruction *Base, Constant *Offset, Type *Ty,
                          const consthoist::ConstantUser &ConstUser);
+  unsigned estimateRegisterPressure(BasicBlock *BB);
+  bool shouldRematerialize(const consthoist::ConstantInfo &ConstInfo,
+                           Instruction *IP, ArrayRef<RebasedUse> Uses);
+  unsigned emitBaseConstant(const consthoist::ConstantInfo &ConstInfo,
+                            GlobalVariable *BaseGV, Instruction *IP,
+                            ArrayRef<RebasedUse> Uses);
   // If BaseGV is nullptr, emit Constant Integer base; otherwise emit
   // constant GEP base.
   bool emitBaseConstants(GlobalVariable *BaseGV);
@@ -285,8 +285,10 @@ private:
 };
 
 /// Create a legacy GVN pass. This also allows parameterizing whether or not
-/// loads are eliminated by the pass.
-FunctionPass *createGVNPass(bool NoLoads = false);
+/// loads are eliminated by the pass. If \p MaxFunctionSize is non-zero,
+/// functions with at least that many instructions are skipped.
+FunctionPass *createGVNPass(bool NoLoads = false,
+                            unsigned MaxFunctionSize = 0);
 
 /// A simple and fast domtree-based GVN pass to hoist common expressions
 /// from sibling branches.
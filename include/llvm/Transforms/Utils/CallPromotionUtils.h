@@ -15,10 +15,13 @@
 #ifndef LLVM_TRANSFORMS_UTILS_CALLPROMOTIONUTILS_H
 #define LLVM_TRANSFORMS_UTILS_CALLPROMOTIONUTILS_H
 
+#include "llvm/ADT/ArrayRef.h"
 #include "llvm/IR/CallSite.h"
 
 namespace llvm {
 
+class Constant;
+
 /// Return true if the given indirect call site can be made to call \p Callee.
 ///
 /// This function ensures that the number and type of the call site's arguments
@@ -49,6 +52,19 @@ Instruction *promoteCall(CallSite CS, Function *Callee,
 Instruction *promoteCallWithIfThenElse(CallSite CS, Function *Callee,
                                        MDNode *BranchWeights = nullptr);
 
+/// Promote the given virtual call site to conditionally call \p Callee.
+///
+/// This is like promoteCallWithIfThenElse, except that the "if" condition
+/// compares the vtable pointer \p VTable, from which the call site loads its
+/// called value, with \p AddressPoints, the address points of the vtables
+/// that hold \p Callee in the loaded slot. The load of the called value is
+/// moved into the "else" block when nothing else uses it, so that the direct
+/// call does not wait for it.
+Instruction *promoteCallWithVTableCmp(CallSite CS, Function *Callee,
+                                      Value *VTable,
+                                      ArrayRef<Constant *> AddressPoints,
+                                      MDNode *BranchWeights = nullptr);
+
 } // end namespace llvm
 
 #endif // LLVM_TRANSFORMS_UTILS_CALLPROMOTIONUTILS_H
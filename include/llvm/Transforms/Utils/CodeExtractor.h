@@ -17,12 +17,15 @@
 
 #include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/DenseSet.h"
 #include "llvm/ADT/SetVector.h"
 #include "llvm/ADT/SmallPtrSet.h"
+#include "llvm/ADT/SmallVector.h"
 #include <limits>
 
 namespace llvm {
 
+class AllocaInst;
 class BasicBlock;
 class BlockFrequency;
 class BlockFrequencyInfo;
@@ -35,6 +38,36 @@ class Module;
 class Type;
 class Value;
 
+  /// A summary of a function used by the CodeExtractor to decide which allocas
+  /// it may move into an extracted function.
+  ///
+  /// Computing it takes time linear in the size of the function, which would
+  /// otherwise be spent on every region extracted from it. Extracting regions
+  /// with extractCodeRegion() does not invalidate it, but any other change to
+  /// the function does.
+  class CodeExtractorAnalysisCache {
+    /// The allocas of the function.
+    SmallVector<AllocaInst *, 16> Allocas;
+
+    /// For each block of the function, the allocas its loads and stores
+    /// access. Blocks created after the summary are not in the map.
+    DenseMap<BasicBlock *, SmallPtrSet<AllocaInst *, 2>> BaseMemAddrs;
+
+    /// The blocks with instructions that may access memory other than
+    /// through an alloca.
+    DenseSet<BasicBlock *> SideEffectingBlocks;
+
+  public:
+    CodeExtractorAnalysisCache(Function &F);
+
+    /// The allocas of the function, some of which may have been moved out
+    /// of it by the extraction of a region since.
+    ArrayRef<AllocaInst *> getAllocas() const { return Allocas; }
+
+    /// Whether \p BB may access \p Addr, other than through lifetime markers.
+    bool doesBlockContainClobberOfAddr(BasicBlock &BB, AllocaInst *Addr) const;
+  };
+
   /// Utility class for extracting code into a new function.
   ///
   /// This utility provides a simple interface for extracting some sequence of
@@ -102,6 +135,10 @@ class Value;
     /// returns false.
     Function *extractCodeRegion();
 
+    /// Perform the extraction, using \p CEAC to summarize the function. Use
+    /// this to extract several regions from the same function.
+    Function *extractCodeRegion(const CodeExtractorAnalysisCache &CEAC);
+
     /// Test whether this code extractor is eligible.
     ///
     /// Based on the blocks used when constructing the code extractor,
@@ -123,7 +160,8 @@ class Value;
     /// region.
     ///
     /// Returns true if it is safe to do the code motion.
-    bool isLegalToShrinkwrapLifetimeMarkers(Instruction *AllocaAddr) const;
+    bool isLegalToShrinkwrapLifetimeMarkers(
+        const CodeExtractorAnalysisCache &CEAC, Instruction *AllocaAddr) const;
 
     /// Find the set of allocas whose life ranges are contained within the
     /// outlined region.
@@ -133,7 +171,8 @@ class Value;
     /// are used by the lifetime markers are also candidates for shrink-
     /// wrapping. The instructions that need to be sunk are collected in
     /// 'Allocas'.
-    void findAllocas(ValueSet &SinkCands, ValueSet &HoistCands,
+    void findAllocas(const CodeExtractorAnalysisCache &CEAC,
+                     ValueSet &SinkCands, ValueSet &HoistCands,
                      BasicBlock *&ExitBlock) const;
 
     /// Find or create a block within the outline region for placing hoisted
@@ -248,8 +248,16 @@ public:
   bool canVectorize(bool UseVPlanNativePath);
 
   /// Return true if we can vectorize this loop while folding its tail by
-  /// masking.
-  bool canFoldTailByMasking();
+  /// masking. Loads from \p SafePointers are known to be dereferenceable in
+  /// the masked-off iterations and don't need a mask.
+  bool canFoldTailByMasking(SmallPtrSetImpl<Value *> &SafePointers);
+
+  /// Collect in \p SafePointers the pointers of consecutive loads that stay
+  /// dereferenceable and aligned if the loop runs for \p NumIterations
+  /// iterations, e.g., its constant trip count padded to a multiple of the
+  /// VF. Such loads can be widened without a mask when the tail is folded.
+  void collectPaddedSafePointers(uint64_t NumIterations,
+                                 SmallPtrSetImpl<Value *> &SafePointers);
 
   /// Returns the primary induction variable.
   PHINode *getPrimaryInduction() { return PrimaryInduction; }
@@ -374,6 +382,10 @@ private:
   /// specific checks for outer loop vectorization.
   bool canVectorizeOuterLoop();
 
+  /// Return true if all the instructions of this outer loop nest can be
+  /// widened by the VPlan-native path.
+  bool canVectorizeOuterLoopInstrs();
+
   /// Return true if all of the instructions in the block can be speculatively
   /// executed. \p SafePtrs is a list of addresses that are known to be legal
   /// and we know that we can read from them without segfault.
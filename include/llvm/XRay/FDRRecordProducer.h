@@ -36,13 +36,19 @@ class FileBasedRecordProducer : public RecordProducer {
   Expected<std::unique_ptr<Record>> findNextBufferExtent();
 
 public:
+  /// \p BufferBytes is the number of bytes left in the buffer at \p OP, for
+  /// a producer that resumes reading where another one stopped.
   FileBasedRecordProducer(const XRayFileHeader &FH, DataExtractor &DE,
-                          uint32_t &OP)
-      : Header(FH), E(DE), OffsetPtr(OP) {}
+                          uint32_t &OP, uint32_t BufferBytes = 0)
+      : Header(FH), E(DE), OffsetPtr(OP), CurrentBufferBytes(BufferBytes) {}
 
   /// This producer encapsulates the logic for loading a File-backed
   /// RecordProducer hidden behind a DataExtractor.
   Expected<std::unique_ptr<Record>> produce() override;
+
+  /// The number of bytes left in the current buffer, as described by the last
+  /// BufferExtents record.
+  uint32_t currentBufferBytes() const { return CurrentBufferBytes; }
 };
 
 } // namespace xray
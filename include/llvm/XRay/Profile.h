@@ -14,9 +14,11 @@
 #ifndef LLVM_XRAY_PROFILE_H
 #define LLVM_XRAY_PROFILE_H
 
+#include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/StringRef.h"
+#include "llvm/Support/Allocator.h"
 #include "llvm/Support/Error.h"
 #include <list>
 #include <utility>
@@ -45,6 +47,15 @@ Profile mergeProfilesByThread(const Profile &L, const Profile &R);
 /// instance, aggregating blocks by function call stack.
 Profile mergeProfilesByStack(const Profile &L, const Profile &R);
 
+/// Merges all the |Profiles| at once, aggregating blocks by Thread ID. This
+/// gives the same result as folding them with the two-profile version, without
+/// re-creating the intermediate profiles.
+Profile mergeAllProfilesByThread(ArrayRef<Profile> Profiles);
+
+/// Merges all the |Profiles| at once, aggregating blocks by function call
+/// stack.
+Profile mergeAllProfilesByStack(ArrayRef<Profile> Profiles);
+
 /// This function takes a Trace and creates a Profile instance from it.
 Expected<Profile> profileFromTrace(const Trace &T);
 
@@ -75,6 +86,10 @@ public:
   /// will always return the same PathID for |P| that has the same sequence.
   PathID internPath(ArrayRef<FuncID> P);
 
+  /// Interns into this Profile the path that |P| identifies in |O|, and
+  /// returns its PathID in this Profile. |P| must have been interned in |O|.
+  PathID internPath(const Profile &O, PathID P);
+
   /// Appends a fully-formed Block instance into the Profile.
   ///
   /// Returns an error condition in the following cases:
@@ -87,16 +102,14 @@ public:
   ~Profile() = default;
 
   Profile(Profile &&O) noexcept
-      : Blocks(std::move(O.Blocks)), NodeStorage(std::move(O.NodeStorage)),
-        Roots(std::move(O.Roots)), PathIDMap(std::move(O.PathIDMap)),
-        NextID(O.NextID) {}
+      : Blocks(std::move(O.Blocks)), NodeAllocator(std::move(O.NodeAllocator)),
+        Nodes(std::move(O.Nodes)), PathNodes(std::move(O.PathNodes)) {}
 
   Profile &operator=(Profile &&O) noexcept {
     Blocks = std::move(O.Blocks);
-    NodeStorage = std::move(O.NodeStorage);
-    Roots = std::move(O.Roots);
-    PathIDMap = std::move(O.PathIDMap);
-    NextID = O.NextID;
+    NodeAllocator = std::move(O.NodeAllocator);
+    Nodes = std::move(O.Nodes);
+    PathNodes = std::move(O.PathNodes);
     return *this;
   }
 
@@ -106,36 +119,37 @@ public:
   friend void swap(Profile &L, Profile &R) {
     using std::swap;
     swap(L.Blocks, R.Blocks);
-    swap(L.NodeStorage, R.NodeStorage);
-    swap(L.Roots, R.Roots);
-    swap(L.PathIDMap, R.PathIDMap);
-    swap(L.NextID, R.NextID);
+    swap(L.NodeAllocator, R.NodeAllocator);
+    swap(L.Nodes, R.Nodes);
+    swap(L.PathNodes, R.PathNodes);
   }
 
 private:
   using BlockList = std::list<Block>;
 
+  // A node of the trie stands for the call stack from a root to itself. Nodes
+  // are hash-consed on (Caller, Func), so every stack has exactly one node and
+  // one PathID.
   struct TrieNode {
-    FuncID Func = 0;
-    std::vector<TrieNode *> Callees{};
-    TrieNode *Caller = nullptr;
-    PathID ID = 0;
+    FuncID Func;
+    TrieNode *Caller;
+    PathID ID;
   };
 
+  TrieNode *getNode(TrieNode *Caller, FuncID Func);
+
   // List of blocks associated with a Profile.
   BlockList Blocks;
 
-  // List of TrieNode elements we've seen.
-  std::list<TrieNode> NodeStorage;
-
-  // List of call stack roots.
-  SmallVector<TrieNode *, 4> Roots;
+  // Storage for all the TrieNode elements we've seen. Nodes are trivially
+  // destructible and are only freed with the Profile.
+  BumpPtrAllocator NodeAllocator;
 
-  // Reverse mapping between a PathID to a TrieNode*.
-  DenseMap<PathID, TrieNode *> PathIDMap;
+  // The node for each (Caller, Func) pair, where roots have no caller.
+  DenseMap<std::pair<TrieNode *, FuncID>, TrieNode *> Nodes;
 
-  // Used to identify paths.
-  PathID NextID = 1;
+  // Mapping between a PathID and its TrieNode*, indexed by PathID - 1.
+  std::vector<TrieNode *> PathNodes;
 
 public:
   using const_iterator = BlockList::const_iterator;
@@ -16,6 +16,7 @@
 #include <cstdint>
 #include <vector>
 
+#include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Support/DataExtractor.h"
 #include "llvm/Support/Error.h"
@@ -51,7 +52,7 @@ class Trace {
 
   typedef std::vector<XRayRecord>::const_iterator citerator;
 
-  friend Expected<Trace> loadTrace(const DataExtractor &, bool);
+  friend Expected<Trace> loadTrace(const DataExtractor &, bool, unsigned);
 
 public:
   using size_type = RecordVector::size_type;
@@ -68,12 +69,44 @@ public:
 };
 
 /// This function will attempt to load XRay trace records from the provided
-/// |Filename|.
-Expected<Trace> loadTraceFile(StringRef Filename, bool Sort = false);
+/// |Filename|. FDR mode logs are expanded on up to \p Threads threads.
+Expected<Trace> loadTraceFile(StringRef Filename, bool Sort = false,
+                              unsigned Threads = 1);
 
 /// This function will attempt to load XRay trace records from the provided
 /// DataExtractor.
-Expected<Trace> loadTrace(const DataExtractor &Extractor, bool Sort = false);
+Expected<Trace> loadTrace(const DataExtractor &Extractor, bool Sort = false,
+                          unsigned Threads = 1);
+
+/// This function calls \p Callback with each record of the XRay trace in the
+/// provided |Filename|, in the order loadTraceFile would load them, and sets
+/// \p FileHeader before the first call. FDR mode logs are read one block at a
+/// time from the mapped file and never held in memory as a whole; logs in the
+/// other formats are loaded in full first. An error returned by \p Callback
+/// stops the traversal and is returned.
+Error streamTraceFile(StringRef Filename, XRayFileHeader &FileHeader,
+                      function_ref<Error(const XRayRecord &)> Callback);
+
+/// This function streams the XRay trace records from the provided
+/// DataExtractor, like streamTraceFile.
+Error streamTrace(const DataExtractor &Extractor, XRayFileHeader &FileHeader,
+                  function_ref<Error(const XRayRecord &)> Callback);
+
+/// This function is like streamTraceFile, but expands the blocks of up to
+/// \p Threads threads of an FDR mode log concurrently. The records of each
+/// process and thread are passed to \p Callback in order, together with the
+/// index of the worker expanding them, which is below \p Threads. Calls for
+/// different workers may run concurrently, and the threads of the log are
+/// handed out to the workers in no particular order.
+Error streamTraceFile(StringRef Filename, XRayFileHeader &FileHeader,
+                      unsigned Threads,
+                      function_ref<Error(unsigned, const XRayRecord &)> Callback);
+
+/// This function streams the XRay trace records from the provided
+/// DataExtractor on up to \p Threads threads, like streamTraceFile.
+Error streamTrace(const DataExtractor &Extractor, XRayFileHeader &FileHeader,
+                  unsigned Threads,
+                  function_ref<Error(unsigned, const XRayRecord &)> Callback);
 
 } // namespace xray
 } // namespace llvm
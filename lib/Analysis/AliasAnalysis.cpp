@@ -632,6 +632,50 @@ bool AAResults::canInstructionRangeModRef(const Instruction &I1,
   return false;
 }
 
+//===----------------------------------------------------------------------===//
+// BatchAAResults implementation
+//===----------------------------------------------------------------------===//
+
+AliasResult BatchAAResults::alias(const MemoryLocation &LocA,
+                                  const MemoryLocation &LocB) {
+  // Alias queries are symmetric, so only cache one order of the locations.
+  std::pair<MemoryLocation, MemoryLocation> Key(LocA, LocB);
+  if (LocB.Ptr < LocA.Ptr)
+    std::swap(Key.first, Key.second);
+  auto It = AliasCache.find(Key);
+  if (It != AliasCache.end())
+    return It->second;
+  AliasResult Result = AA.alias(LocA, LocB);
+  AliasCache.insert({Key, Result});
+  return Result;
+}
+
+ModRefInfo
+BatchAAResults::getModRefInfo(const Instruction *I,
+                              const Optional<MemoryLocation> &OptLoc) {
+  if (!OptLoc)
+    return AA.getModRefInfo(I, OptLoc);
+  std::pair<const Instruction *, MemoryLocation> Key(I, *OptLoc);
+  auto It = LocModRefCache.find(Key);
+  if (It != LocModRefCache.end())
+    return It->second;
+  ModRefInfo Result = AA.getModRefInfo(I, OptLoc);
+  LocModRefCache.insert({Key, Result});
+  return Result;
+}
+
+ModRefInfo BatchAAResults::getModRefInfo(Instruction *I,
+                                         ImmutableCallSite Call) {
+  std::pair<const Instruction *, const Instruction *> Key(
+      I, Call.getInstruction());
+  auto It = CallModRefCache.find(Key);
+  if (It != CallModRefCache.end())
+    return It->second;
+  ModRefInfo Result = AA.getModRefInfo(I, Call);
+  CallModRefCache.insert({Key, Result});
+  return Result;
+}
+
 // Provide a definition for the root virtual destructor.
 AAResults::Concept::~Concept() = default;
 
@@ -14,6 +14,7 @@
 #include "llvm/Analysis/BlockFrequencyInfo.h"
 #include "llvm/ADT/APInt.h"
 #include "llvm/ADT/None.h"
+#include "llvm/ADT/Statistic.h"
 #include "llvm/ADT/iterator.h"
 #include "llvm/Analysis/BlockFrequencyInfoImpl.h"
 #include "llvm/Analysis/BranchProbabilityInfo.h"
@@ -33,6 +34,10 @@ using namespace llvm;
 
 #define DEBUG_TYPE "block-freq"
 
+STATISTIC(NumBFIReused, "Number of times block frequencies were reused");
+
+extern cl::opt<bool> ReuseUnchangedCFGAnalyses;
+
 static cl::opt<GVDAGType> ViewBlockFreqPropagationDAG(
     "view-block-freq-propagation-dags", cl::Hidden,
     cl::desc("Pop up a window to show a dag displaying how block "
@@ -158,11 +163,12 @@ BlockFrequencyInfo::BlockFrequencyInfo(const Function &F,
 }
 
 BlockFrequencyInfo::BlockFrequencyInfo(BlockFrequencyInfo &&Arg)
-    : BFI(std::move(Arg.BFI)) {}
+    : BFI(std::move(Arg.BFI)), CFGHash(Arg.CFGHash) {}
 
 BlockFrequencyInfo &BlockFrequencyInfo::operator=(BlockFrequencyInfo &&RHS) {
   releaseMemory();
   BFI = std::move(RHS.BFI);
+  CFGHash = RHS.CFGHash;
   return *this;
 }
 
@@ -173,12 +179,22 @@ BlockFrequencyInfo &BlockFrequencyInfo::operator=(BlockFrequencyInfo &&RHS) {
 BlockFrequencyInfo::~BlockFrequencyInfo() = default;
 
 bool BlockFrequencyInfo::invalidate(Function &F, const PreservedAnalyses &PA,
-                                    FunctionAnalysisManager::Invalidator &) {
+                                    FunctionAnalysisManager::Invalidator &Inv) {
   // Check whether the analysis, all analyses on functions, or the function's
   // CFG have been preserved.
   auto PAC = PA.getChecker<BlockFrequencyAnalysis>();
-  return !(PAC.preserved() || PAC.preservedSet<AllAnalysesOn<Function>>() ||
-           PAC.preservedSet<CFGAnalyses>());
+  if (PAC.preserved() || PAC.preservedSet<AllAnalysesOn<Function>>() ||
+      PAC.preservedSet<CFGAnalyses>())
+    return false;
+
+  // Otherwise the frequencies are still valid if the probabilities they were
+  // computed from survive and the CFG did not change after all.
+  if (CFGHash && !Inv.invalidate<BranchProbabilityAnalysis>(F, PA) &&
+      *CFGHash == BranchProbabilityInfo::getCFGHash(F)) {
+    ++NumBFIReused;
+    return false;
+  }
+  return true;
 }
 
 void BlockFrequencyInfo::calculate(const Function &F,
@@ -187,6 +203,8 @@ void BlockFrequencyInfo::calculate(const Function &F,
   if (!BFI)
     BFI.reset(new ImplType);
   BFI->calculate(F, BPI, LI);
+  if (ReuseUnchangedCFGAnalyses)
+    CFGHash = BranchProbabilityInfo::getCFGHash(F);
   if (ViewBlockFreqPropagationDAG != GVDT_None &&
       (ViewBlockFreqFuncName.empty() ||
        F.getName().equals(ViewBlockFreqFuncName))) {
@@ -279,7 +297,10 @@ uint64_t BlockFrequencyInfo::getEntryFreq() const {
   return BFI ? BFI->getEntryFreq() : 0;
 }
 
-void BlockFrequencyInfo::releaseMemory() { BFI.reset(); }
+void BlockFrequencyInfo::releaseMemory() {
+  BFI.reset();
+  CFGHash = None;
+}
 
 void BlockFrequencyInfo::print(raw_ostream &OS) const {
   if (BFI)
@@ -16,11 +16,13 @@
 #include "llvm/ADT/SCCIterator.h"
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/Statistic.h"
 #include "llvm/Analysis/LoopInfo.h"
 #include "llvm/Analysis/TargetLibraryInfo.h"
 #include "llvm/IR/Attributes.h"
 #include "llvm/IR/BasicBlock.h"
 #include "llvm/IR/CFG.h"
+#include "llvm/IR/CallSite.h"
 #include "llvm/IR/Constants.h"
 #include "llvm/IR/Dominators.h"
 #include "llvm/IR/Function.h"
@@ -46,6 +48,8 @@ using namespace llvm;
 
 #define DEBUG_TYPE "branch-prob"
 
+STATISTIC(NumBPIReused, "Number of times branch probabilities were reused");
+
 static cl::opt<bool> PrintBranchProb(
     "print-bpi", cl::init(false), cl::Hidden,
     cl::desc("Print the branch probability info."));
@@ -55,6 +59,11 @@ cl::opt<std::string> PrintBranchProbFuncName(
     cl::desc("The option to specify the name of the function "
              "whose branch probability info is printed."));
 
+cl::opt<bool> ReuseUnchangedCFGAnalyses(
+    "reuse-unchanged-cfg-analyses", cl::init(false), cl::Hidden,
+    cl::desc("Keep branch probabilities and block frequencies across passes "
+             "that do not preserve them but leave the CFG unchanged."));
+
 INITIALIZE_PASS_BEGIN(BranchProbabilityInfoWrapperPass, "branch-prob",
                       "Branch Probability Analysis", false, true)
 INITIALIZE_PASS_DEPENDENCY(LoopInfoWrapperPass)
@@ -814,6 +823,48 @@ bool BranchProbabilityInfo::calcInvokeHeuristics(const BasicBlock *BB) {
 
 void BranchProbabilityInfo::releaseMemory() {
   Probs.clear();
+  CFGHash = None;
+}
+
+bool BranchProbabilityInfo::invalidate(Function &F, const PreservedAnalyses &PA,
+                                       FunctionAnalysisManager::Invalidator &) {
+  auto PAC = PA.getChecker<BranchProbabilityAnalysis>();
+  if (PAC.preserved() || PAC.preservedSet<AllAnalysesOn<Function>>())
+    return false;
+  if (CFGHash && *CFGHash == getCFGHash(F)) {
+    ++NumBPIReused;
+    return false;
+  }
+  return true;
+}
+
+hash_code BranchProbabilityInfo::getCFGHash(const Function &F) {
+  hash_code H = hash_value(F.size());
+  for (const BasicBlock &BB : F) {
+    const Instruction *TI = BB.getTerminator();
+    if (!TI) {
+      H = hash_combine(H, &BB);
+      continue;
+    }
+    H = hash_combine(H, &BB, TI->getOpcode(),
+                     TI->getMetadata(LLVMContext::MD_prof));
+    for (const BasicBlock *Succ : successors(&BB))
+      H = hash_combine(H, Succ);
+    if (const auto *BI = dyn_cast<BranchInst>(TI))
+      if (BI->isConditional()) {
+        const Value *Cond = BI->getCondition();
+        H = hash_combine(H, Cond);
+        if (const auto *CI = dyn_cast<CmpInst>(Cond))
+          H = hash_combine(H, CI->getPredicate(), CI->getOperand(0),
+                           CI->getOperand(1));
+      }
+    // Calls decide the cold call and unreachable heuristics.
+    for (const Instruction &I : BB)
+      if (ImmutableCallSite CS = ImmutableCallSite(&I))
+        H = hash_combine(H, CS.getCalledValue(),
+                         CS.hasFnAttr(Attribute::Cold));
+  }
+  return H;
 }
 
 void BranchProbabilityInfo::print(raw_ostream &OS) const {
@@ -989,6 +1040,9 @@ void BranchProbabilityInfo::calculate(const Function &F, const LoopInfo &LI,
   PostDominatedByUnreachable.clear();
   PostDominatedByColdCall.clear();
 
+  if (ReuseUnchangedCFGAnalyses)
+    CFGHash = getCFGHash(F);
+
   if (PrintBranchProb &&
       (PrintBranchProbFuncName.empty() ||
        F.getName().equals(PrintBranchProbFuncName))) {
@@ -106,11 +106,17 @@ STATISTIC(GCDindependence, "GCD independence");
 STATISTIC(BanerjeeApplications, "Banerjee applications");
 STATISTIC(BanerjeeIndependence, "Banerjee independence");
 STATISTIC(BanerjeeSuccesses, "Banerjee successes");
+STATISTIC(AffineFastPathPairs, "Array pairs answered by the affine fast path");
 
 static cl::opt<bool>
     Delinearize("da-delinearize", cl::init(true), cl::Hidden, cl::ZeroOrMore,
                 cl::desc("Try to delinearize array references."));
 
+static cl::opt<bool> AffineFastPath(
+    "da-affine-fast-path", cl::init(true), cl::Hidden,
+    cl::desc("Answer queries about affine accesses with the same constant "
+             "stride in a single loop without the full subscript tests."));
+
 //===----------------------------------------------------------------------===//
 // basics
 
@@ -3362,6 +3368,90 @@ static void dumpSmallBitVector(SmallBitVector &BV) {
 }
 #endif
 
+DependenceInfo::AffineAccess DependenceInfo::getAffineAccess(const SCEV *Ptr) {
+  auto It = AffineAccesses.find(Ptr);
+  if (It != AffineAccesses.end())
+    return It->second;
+
+  AffineAccess A;
+  const auto *AR = dyn_cast<SCEVAddRecExpr>(Ptr);
+  if (AR && AR->isAffine())
+    if (const auto *Step = dyn_cast<SCEVConstant>(AR->getStepRecurrence(*SE))) {
+      unsigned Width = Step->getAPInt().getBitWidth();
+      A.L = AR->getLoop();
+      A.Base = AR->getStart();
+      A.Offset = APInt(Width, 0);
+      A.Step = Step->getAPInt();
+      // Split a constant offset off the start, so that accesses to different
+      // fields or elements of the same base share it.
+      if (const auto *Add = dyn_cast<SCEVAddExpr>(A.Base))
+        if (Add->getNumOperands() == 2)
+          if (const auto *C = dyn_cast<SCEVConstant>(Add->getOperand(0)))
+            if (C->getAPInt().getBitWidth() == Width) {
+              A.Base = Add->getOperand(1);
+              A.Offset = C->getAPInt();
+            }
+    }
+  AffineAccesses[Ptr] = A;
+  return A;
+}
+
+bool DependenceInfo::tryAffineFastPath(const SCEV *SrcSCEV,
+                                       const SCEV *DstSCEV,
+                                       FullDependence &Result,
+                                       bool &Independent) {
+  if (CommonLevels != 1 || MaxLevels != 1)
+    return false;
+
+  AffineAccess SrcA = getAffineAccess(SrcSCEV);
+  if (!SrcA.L || SrcA.L->getParentLoop())
+    return false;
+  AffineAccess DstA = getAffineAccess(DstSCEV);
+  if (DstA.L != SrcA.L || DstA.Base != SrcA.Base || DstA.Step != SrcA.Step)
+    return false;
+
+  // From here on this mirrors the strong SIV test on constants. Give up
+  // where the distance could wrap, so that the answers always agree.
+  bool Overflow;
+  APInt Delta = SrcA.Offset.ssub_ov(DstA.Offset, Overflow);
+  if (Overflow || Delta.isMinSignedValue() || SrcA.Step.isMinSignedValue())
+    return false;
+
+  // check that |Delta| < iteration count
+  const SCEV *DeltaSCEV = SE->getConstant(Delta);
+  if (const SCEV *UpperBound =
+          collectUpperBound(SrcA.L, DeltaSCEV->getType())) {
+    const SCEV *AbsDelta = SE->getConstant(Delta.abs());
+    const SCEV *AbsCoeff = SE->getConstant(SrcA.Step.abs());
+    const SCEV *Product = SE->getMulExpr(UpperBound, AbsCoeff);
+    if (isKnownPredicate(CmpInst::ICMP_SGT, AbsDelta, Product)) {
+      // Distance greater than trip count - no dependence
+      Independent = true;
+      return true;
+    }
+  }
+
+  APInt Distance, Remainder;
+  APInt::sdivrem(Delta, SrcA.Step, Distance, Remainder);
+  if (Remainder != 0) {
+    // Step doesn't divide the distance between the accesses, no dependence
+    Independent = true;
+    return true;
+  }
+
+  Independent = false;
+  Dependence::DVEntry &DV = Result.DV[0];
+  DV.Distance = SE->getConstant(Distance);
+  if (Distance.sgt(0))
+    DV.Direction = Dependence::DVEntry::LT;
+  else if (Distance.slt(0))
+    DV.Direction = Dependence::DVEntry::GT;
+  else
+    DV.Direction = Dependence::DVEntry::EQ;
+  DV.Scalar = false;
+  return true;
+}
+
 // depends -
 // Returns NULL if there is no dependence.
 // Otherwise, return a Dependence with as many details as possible.
@@ -3428,6 +3518,23 @@ DependenceInfo::depends(Instruction *Src, Instruction *Dst,
   Pair[0].Src = SrcSCEV;
   Pair[0].Dst = DstSCEV;
 
+  bool Independent;
+  if (AffineFastPath &&
+      tryAffineFastPath(SrcSCEV, DstSCEV, Result, Independent)) {
+    LLVM_DEBUG(dbgs() << "    answered by the affine fast path\n");
+    ++AffineFastPathPairs;
+    if (Independent)
+      return nullptr;
+    unsigned Direction = Result.getDirection(1);
+    if (PossiblyLoopIndependent) {
+      if (!(Direction & Dependence::DVEntry::EQ))
+        Result.LoopIndependent = false;
+    } else if (Direction == Dependence::DVEntry::EQ) {
+      return nullptr;
+    }
+    return make_unique<FullDependence>(std::move(Result));
+  }
+
   if (Delinearize) {
     if (tryDelinearize(Src, Dst, Pair)) {
       LLVM_DEBUG(dbgs() << "    delinearized\n");
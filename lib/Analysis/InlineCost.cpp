@@ -45,6 +45,8 @@ using namespace llvm;
 #define DEBUG_TYPE "inline-cost"
 
 STATISTIC(NumCallsAnalyzed, "Number of call sites analyzed");
+STATISTIC(NumCalleeSummariesReused,
+          "Number of call sites analyzed with a cached callee summary");
 
 static cl::opt<int> InlineThreshold(
     "inline-threshold", cl::Hidden, cl::init(225), cl::ZeroOrMore,
@@ -231,6 +233,8 @@ class CallAnalyzer : public InstVisitor<CallAnalyzer, bool> {
   // Custom analysis routines.
   InlineResult analyzeBlock(BasicBlock *BB,
                             SmallPtrSetImpl<const Value *> &EphValues);
+  bool isIndependentOfCallSite(CallSite CS, Function &Caller);
+  InlineResult analyzeCallee(CallSite CS, bool &SingleBB);
 
   // Disable several entry points to the visitor so we don't accidentally use
   // them by declaring but not defining them here.
@@ -293,7 +297,8 @@ public:
         NumInstructionsSimplified(0), SROACostSavings(0),
         SROACostSavingsLost(0) {}
 
-  InlineResult analyzeCall(CallSite CS);
+  InlineResult analyzeCall(CallSite CS,
+                           InlineCostSummaryCache *Summaries = nullptr);
 
   int getThreshold() { return Threshold; }
   int getCost() { return Cost; }
@@ -1712,59 +1717,33 @@ void CallAnalyzer::findDeadBlocks(BasicBlock *CurrBB, BasicBlock *NextBB) {
 /// factors and heuristics. If this method returns false but the computed cost
 /// is below the computed threshold, then inlining was forcibly disabled by
 /// some artifact of the routine.
-InlineResult CallAnalyzer::analyzeCall(CallSite CS) {
-  ++NumCallsAnalyzed;
-
-  // Perform some tweaks to the cost and threshold based on the direct
-  // callsite information.
-
-  // We want to more aggressively inline vector-dense kernels, so up the
-  // threshold, and we'll lower it if the % of vector instructions gets too
-  // low. Note that these bonuses are some what arbitrary and evolved over time
-  // by accident as much as because they are principled bonuses.
-  //
-  // FIXME: It would be nice to remove all such bonuses. At least it would be
-  // nice to base the bonus values on something more scientific.
-  assert(NumInstructions == 0);
-  assert(NumVectorInstructions == 0);
-
-  // Update the threshold based on callsite properties
-  updateThreshold(CS, F);
-
-  // Speculatively apply all possible bonuses to Threshold. If cost exceeds
-  // this Threshold any time, and cost cannot decrease, we can stop processing
-  // the rest of the function body.
-  Threshold += (SingleBBBonus + VectorBonus);
-
-  // Give out bonuses for the callsite, as the instructions setting them up
-  // will be gone after inlining.
-  Cost -= getCallsiteCost(CS, DL);
-
-  // If this function uses the coldcc calling convention, prefer not to inline
-  // it.
-  if (F.getCallingConv() == CallingConv::Cold)
-    Cost += InlineConstants::ColdccPenalty;
-
-  // Check if we're done. This can happen due to bonuses and penalties.
-  if (Cost >= Threshold && !ComputeFullInlineCost)
-    return "high cost";
-
-  if (F.empty())
-    return true;
+/// Return true if the arguments of \p CS enable no simplification in the
+/// callee, so that the walk of the callee body does not depend on the call
+/// site.
+bool CallAnalyzer::isIndependentOfCallSite(CallSite CS, Function &Caller) {
+  // The loop penalty for minsize callers depends on the dead blocks.
+  if (Caller.optForMinSize())
+    return false;
 
-  Function *Caller = CS.getInstruction()->getFunction();
-  // Check if the caller function is recursive itself.
-  for (User *U : Caller->users()) {
-    CallSite Site(U);
-    if (!Site)
-      continue;
-    Instruction *I = Site.getInstruction();
-    if (I->getFunction() == Caller) {
-      IsCallerRecursive = true;
-      break;
-    }
+  AttributeList CalleeAttrs = F.getAttributes();
+  SmallPtrSet<Value *, 8> PtrBases;
+  for (unsigned I = 0, E = CS.arg_size(); I != E; ++I) {
+    Value *V = CS.getArgument(I);
+    if (isa<Constant>(V))
+      return false;
+    if (CS.getAttributes().getParamAttributes(I) !=
+        CalleeAttrs.getParamAttributes(I))
+      return false;
+    if (stripAndComputeInBoundsConstantOffsets(V) &&
+        (isa<Constant>(V) || isa<AllocaInst>(V) || !PtrBases.insert(V).second))
+      return false;
   }
+  return true;
+}
 
+/// Walk the blocks of the callee that are live for \p CS and accumulate the
+/// cost of inlining them. \p SingleBB is set if only one block is live.
+InlineResult CallAnalyzer::analyzeCallee(CallSite CS, bool &SingleBB) {
   // Populate our simplified values by mapping from function arguments to call
   // arguments with known important simplifications.
   CallSite::arg_iterator CAI = CS.arg_begin();
@@ -1807,7 +1786,7 @@ InlineResult CallAnalyzer::analyzeCall(CallSite CS) {
       BBSetVector;
   BBSetVector BBWorklist;
   BBWorklist.insert(&F.getEntryBlock());
-  bool SingleBB = true;
+  SingleBB = true;
   // Note that we *must not* cache the size, this loop grows the worklist.
   for (unsigned Idx = 0; Idx != BBWorklist.size(); ++Idx) {
     // Bail out the moment we cross the threshold. This means we'll under-count
@@ -1879,6 +1858,107 @@ InlineResult CallAnalyzer::analyzeCall(CallSite CS) {
     }
   }
 
+  return true;
+}
+
+InlineResult CallAnalyzer::analyzeCall(CallSite CS,
+                                       InlineCostSummaryCache *Summaries) {
+  ++NumCallsAnalyzed;
+
+  // Perform some tweaks to the cost and threshold based on the direct
+  // callsite information.
+
+  // We want to more aggressively inline vector-dense kernels, so up the
+  // threshold, and we'll lower it if the % of vector instructions gets too
+  // low. Note that these bonuses are some what arbitrary and evolved over time
+  // by accident as much as because they are principled bonuses.
+  //
+  // FIXME: It would be nice to remove all such bonuses. At least it would be
+  // nice to base the bonus values on something more scientific.
+  assert(NumInstructions == 0);
+  assert(NumVectorInstructions == 0);
+
+  // Update the threshold based on callsite properties
+  updateThreshold(CS, F);
+
+  // Speculatively apply all possible bonuses to Threshold. If cost exceeds
+  // this Threshold any time, and cost cannot decrease, we can stop processing
+  // the rest of the function body.
+  Threshold += (SingleBBBonus + VectorBonus);
+
+  // Give out bonuses for the callsite, as the instructions setting them up
+  // will be gone after inlining.
+  Cost -= getCallsiteCost(CS, DL);
+
+  // If this function uses the coldcc calling convention, prefer not to inline
+  // it.
+  if (F.getCallingConv() == CallingConv::Cold)
+    Cost += InlineConstants::ColdccPenalty;
+
+  // Check if we're done. This can happen due to bonuses and penalties.
+  if (Cost >= Threshold && !ComputeFullInlineCost)
+    return "high cost";
+
+  if (F.empty())
+    return true;
+
+  Function *Caller = CS.getInstruction()->getFunction();
+  // Check if the caller function is recursive itself.
+  for (User *U : Caller->users()) {
+    CallSite Site(U);
+    if (!Site)
+      continue;
+    Instruction *I = Site.getInstruction();
+    if (I->getFunction() == Caller) {
+      IsCallerRecursive = true;
+      break;
+    }
+  }
+
+  // Walk the callee body, or reuse the result of an earlier walk when this
+  // call site cannot simplify anything in the callee.
+  const InlineCostSummaryCache::Summary *Summary = nullptr;
+  bool Summarize = Summaries && isIndependentOfCallSite(CS, *Caller);
+  if (Summarize) {
+    Summary = Summaries->lookup(F);
+    // The walk would have stopped early for a recursive caller.
+    if (Summary && IsCallerRecursive &&
+        Summary->AllocatedSize >
+            InlineConstants::TotalAllocaSizeRecursiveCaller)
+      Summarize = false;
+  }
+
+  if (Summarize && Summary) {
+    ++NumCalleeSummariesReused;
+    Cost += Summary->Cost;
+    AllocatedSize = Summary->AllocatedSize;
+    NumInstructions = Summary->NumInstructions;
+    NumVectorInstructions = Summary->NumVectorInstructions;
+    ContainsNoDuplicateCall = Summary->ContainsNoDuplicateCall;
+    if (!Summary->SingleBB)
+      Threshold -= SingleBBBonus;
+    if (!Summary->Result)
+      return Summary->Result;
+  } else {
+    // A summary must not depend on the threshold of the call site that
+    // computes it, so the walk cannot stop early.
+    int CostBefore = Cost;
+    bool SavedComputeFullInlineCost = ComputeFullInlineCost;
+    if (Summarize)
+      ComputeFullInlineCost = true;
+    bool SingleBB;
+    InlineResult IR = analyzeCallee(CS, SingleBB);
+    ComputeFullInlineCost = SavedComputeFullInlineCost;
+    if (Summarize &&
+        !(IsCallerRecursive &&
+          AllocatedSize > InlineConstants::TotalAllocaSizeRecursiveCaller))
+      Summaries->insert(F, {IR, Cost - CostBefore, AllocatedSize,
+                            NumInstructions, NumVectorInstructions, SingleBB,
+                            ContainsNoDuplicateCall});
+    if (!IR)
+      return IR;
+  }
+
   bool OnlyOneCallAndLocalLinkage =
       F.hasLocalLinkage() && F.hasOneUse() && &F == CS.getCalledFunction();
   // If this is a noduplicate call, we can still inline as long as
@@ -1983,9 +2063,10 @@ InlineCost llvm::getInlineCost(
     CallSite CS, const InlineParams &Params, TargetTransformInfo &CalleeTTI,
     std::function<AssumptionCache &(Function &)> &GetAssumptionCache,
     Optional<function_ref<BlockFrequencyInfo &(Function &)>> GetBFI,
-    ProfileSummaryInfo *PSI, OptimizationRemarkEmitter *ORE) {
+    ProfileSummaryInfo *PSI, OptimizationRemarkEmitter *ORE,
+    InlineCostSummaryCache *Summaries) {
   return getInlineCost(CS, CS.getCalledFunction(), Params, CalleeTTI,
-                       GetAssumptionCache, GetBFI, PSI, ORE);
+                       GetAssumptionCache, GetBFI, PSI, ORE, Summaries);
 }
 
 InlineCost llvm::getInlineCost(
@@ -1993,7 +2074,8 @@ InlineCost llvm::getInlineCost(
     TargetTransformInfo &CalleeTTI,
     std::function<AssumptionCache &(Function &)> &GetAssumptionCache,
     Optional<function_ref<BlockFrequencyInfo &(Function &)>> GetBFI,
-    ProfileSummaryInfo *PSI, OptimizationRemarkEmitter *ORE) {
+    ProfileSummaryInfo *PSI, OptimizationRemarkEmitter *ORE,
+    InlineCostSummaryCache *Summaries) {
 
   // Cannot inline indirect calls.
   if (!Callee)
@@ -2053,7 +2135,7 @@ InlineCost llvm::getInlineCost(
 
   CallAnalyzer CA(CalleeTTI, GetAssumptionCache, GetBFI, PSI, ORE, *Callee, CS,
                   Params);
-  InlineResult ShouldInline = CA.analyzeCall(CS);
+  InlineResult ShouldInline = CA.analyzeCall(CS, Summaries);
 
   LLVM_DEBUG(CA.dump());
 
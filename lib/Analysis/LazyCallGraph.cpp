@@ -377,6 +377,27 @@ bool LazyCallGraph::RefSCC::isAncestorOf(const RefSCC &RC) const {
   return false;
 }
 
+/// Stable-partition the SCCs of the postorder sequence in [BeginIdx, EndIdx)
+/// so that those satisfying \p Pred come first, and update the indices of the
+/// SCCs that moved. SCCs ahead of the first one failing \p Pred and behind the
+/// last one satisfying it keep their positions, so only the SCCs in between
+/// are renumbered.
+template <typename PostorderSequenceT, typename SCCIndexMapT, typename PredT>
+static typename PostorderSequenceT::iterator
+partitionPostorderSequence(PostorderSequenceT &SCCs, SCCIndexMapT &SCCIndices,
+                           int BeginIdx, int EndIdx, PredT Pred) {
+  auto Begin = SCCs.begin() + BeginIdx, End = SCCs.begin() + EndIdx;
+  auto FirstMoved = std::find_if_not(Begin, End, Pred);
+  auto LastMoved = std::find_if(std::reverse_iterator<decltype(End)>(End),
+                                std::reverse_iterator<decltype(End)>(FirstMoved),
+                                Pred)
+                       .base();
+  auto PartitionI = std::stable_partition(FirstMoved, LastMoved, Pred);
+  for (auto I = FirstMoved; I != LastMoved; ++I)
+    SCCIndices.find(*I)->second = I - SCCs.begin();
+  return PartitionI;
+}
+
 /// Generic helper that updates a postorder sequence of SCCs for a potentially
 /// cycle-introducing edge insertion.
 ///
@@ -460,11 +481,9 @@ updatePostorderSequenceForEdgeInsertion(
   // Partition the SCCs in this part of the port-order sequence so only SCCs
   // connecting to the source remain between it and the target. This is
   // a benign partition as it preserves postorder.
-  auto SourceI = std::stable_partition(
-      SCCs.begin() + SourceIdx, SCCs.begin() + TargetIdx + 1,
+  auto SourceI = partitionPostorderSequence(
+      SCCs, SCCIndices, SourceIdx, TargetIdx + 1,
       [&ConnectedSet](SCCT *C) { return !ConnectedSet.count(C); });
-  for (int i = SourceIdx, e = TargetIdx + 1; i < e; ++i)
-    SCCIndices.find(SCCs[i])->second = i;
 
   // If the target doesn't connect to the source, then we've corrected the
   // post-order and there are no cycles formed.
@@ -495,11 +514,9 @@ updatePostorderSequenceForEdgeInsertion(
 
     // Partition SCCs so that only SCCs reached from the target remain between
     // the source and the target. This preserves postorder.
-    auto TargetI = std::stable_partition(
-        SCCs.begin() + SourceIdx + 1, SCCs.begin() + TargetIdx + 1,
+    auto TargetI = partitionPostorderSequence(
+        SCCs, SCCIndices, SourceIdx + 1, TargetIdx + 1,
         [&ConnectedSet](SCCT *C) { return ConnectedSet.count(C); });
-    for (int i = SourceIdx + 1, e = TargetIdx + 1; i < e; ++i)
-      SCCIndices.find(SCCs[i])->second = i;
     TargetIdx = std::prev(TargetI) - SCCs.begin();
     assert(SCCs[TargetIdx] == &TargetSCC &&
            "Should always end with the target!");
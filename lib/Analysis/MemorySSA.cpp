@@ -22,6 +22,7 @@
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/Statistic.h"
 #include "llvm/ADT/iterator.h"
 #include "llvm/ADT/iterator_range.h"
 #include "llvm/Analysis/AliasAnalysis.h"
@@ -72,11 +73,27 @@ INITIALIZE_PASS_DEPENDENCY(MemorySSAWrapperPass)
 INITIALIZE_PASS_END(MemorySSAPrinterLegacyPass, "print-memoryssa",
                     "Memory SSA Printer", false, false)
 
+STATISTIC(NumClobberWalkSteps, "Number of defs visited by clobber walks");
+STATISTIC(NumClobberWalkLimitHits,
+          "Number of clobber walks stopped by the walk limit");
+STATISTIC(NumClobberCacheHits,
+          "Number of clobber queries answered from the walker cache");
+
 static cl::opt<unsigned> MaxCheckLimit(
     "memssa-check-limit", cl::Hidden, cl::init(100),
     cl::desc("The maximum number of stores/phis MemorySSA"
              "will consider trying to walk past (default = 100)"));
 
+static cl::opt<bool> LazyUseOptimization(
+    "memssa-lazy-use-optimization", cl::Hidden, cl::init(false),
+    cl::desc("Do not optimize uses while building MemorySSA; optimize them "
+             "when the walker is queried instead"));
+
+static cl::opt<unsigned> MaxWalkSteps(
+    "memssa-walk-limit", cl::Hidden, cl::init(0),
+    cl::desc("The maximum number of defs a single clobber walk checks "
+             "before giving up conservatively (0 = unlimited)"));
+
 // Always verify MemorySSA if expensive checking is enabled.
 #ifdef EXPENSIVE_CHECKS
 bool llvm::VerifyMemorySSA = true;
@@ -252,10 +269,11 @@ struct ClobberAlias {
 
 // Return a pair of {IsClobber (bool), AR (AliasResult)}. It relies on AR being
 // ignored if IsClobber = false.
+template <typename AliasAnalysisType>
 static ClobberAlias instructionClobbersQuery(const MemoryDef *MD,
                                              const MemoryLocation &UseLoc,
                                              const Instruction *UseInst,
-                                             AliasAnalysis &AA) {
+                                             AliasAnalysisType &AA) {
   Instruction *DefInst = MD->getMemoryInst();
   assert(DefInst && "Defining instruction not actually an instruction");
   ImmutableCallSite UseCS(UseInst);
@@ -300,10 +318,11 @@ static ClobberAlias instructionClobbersQuery(const MemoryDef *MD,
   return {isModSet(I), AR};
 }
 
+template <typename AliasAnalysisType>
 static ClobberAlias instructionClobbersQuery(MemoryDef *MD,
                                              const MemoryUseOrDef *MU,
                                              const MemoryLocOrCall &UseMLOC,
-                                             AliasAnalysis &AA) {
+                                             AliasAnalysisType &AA) {
   // FIXME: This is a temporary hack to allow a single instructionClobbersQuery
   // to exist while MemoryLocOrCall is pushed through places.
   if (UseMLOC.IsCall)
@@ -344,8 +363,9 @@ struct UpwardsMemoryQuery {
 
 } // end anonymous namespace
 
+template <typename AliasAnalysisType>
 static bool lifetimeEndsAt(MemoryDef *MD, const MemoryLocation &Loc,
-                           AliasAnalysis &AA) {
+                           AliasAnalysisType &AA) {
   Instruction *Inst = MD->getMemoryInst();
   if (IntrinsicInst *II = dyn_cast<IntrinsicInst>(Inst)) {
     switch (II->getIntrinsicID()) {
@@ -358,7 +378,8 @@ static bool lifetimeEndsAt(MemoryDef *MD, const MemoryLocation &Loc,
   return false;
 }
 
-static bool isUseTriviallyOptimizableToLiveOnEntry(AliasAnalysis &AA,
+template <typename AliasAnalysisType>
+static bool isUseTriviallyOptimizableToLiveOnEntry(AliasAnalysisType &AA,
                                                    const Instruction *I) {
   // If the memory can't be changed, then loads of the memory can't be
   // clobbered.
@@ -547,6 +568,13 @@ class ClobberWalker {
       if (auto *MD = dyn_cast<MemoryDef>(Current)) {
         if (MSSA.isLiveOnEntryDef(MD))
           return {MD, true, MustAlias};
+        // Once the walk is out of steps, every def is a clobber.
+        if (!WalkStepsLeft) {
+          WalkLimitHit = true;
+          return {MD, true, MayAlias};
+        }
+        --WalkStepsLeft;
+        ++NumClobberWalkSteps;
         ClobberAlias CA =
             instructionClobbersQuery(MD, Desc.Loc, Query->Inst, AA);
         if (CA.IsClobber)
@@ -875,6 +903,11 @@ class ClobberWalker {
     VisitedPhis.clear();
   }
 
+  /// The number of defs the current query may still check, and whether it
+  /// ran out of them.
+  mutable unsigned WalkStepsLeft = 0;
+  mutable bool WalkLimitHit = false;
+
 public:
   ClobberWalker(const MemorySSA &MSSA, AliasAnalysis &AA, DominatorTree &DT)
       : MSSA(MSSA), AA(AA), DT(DT) {}
@@ -883,6 +916,8 @@ public:
   /// possible.
   MemoryAccess *findClobber(MemoryAccess *Start, UpwardsMemoryQuery &Q) {
     Query = &Q;
+    WalkStepsLeft = MaxWalkSteps ? unsigned(MaxWalkSteps) : ~0U;
+    WalkLimitHit = false;
 
     MemoryAccess *Current = Start;
     // This walker pretends uses don't exist. If we're handed one, silently grab
@@ -906,8 +941,11 @@ public:
       Result = OptRes.PrimaryClobber.Clobber;
     }
 
+    if (WalkLimitHit)
+      ++NumClobberWalkLimitHits;
 #ifdef EXPENSIVE_CHECKS
-    checkClobberSanity(Current, Result, Q.StartingLoc, MSSA, Q, AA);
+    else
+      checkClobberSanity(Current, Result, Q.StartingLoc, MSSA, Q, AA);
 #endif
     return Result;
   }
@@ -941,6 +979,12 @@ namespace llvm {
 class MemorySSA::CachingWalker final : public MemorySSAWalker {
   ClobberWalker Walker;
 
+  /// Clobbers found for explicit locations, keyed by the starting access.
+  /// The cache is dropped whenever MemorySSA changes.
+  DenseMap<std::pair<const MemoryAccess *, MemoryLocation>, MemoryAccess *>
+      LocationClobbers;
+  unsigned LocationClobbersEpoch = 0;
+
   MemoryAccess *getClobberingMemoryAccess(MemoryAccess *, UpwardsMemoryQuery &);
 
 public:
@@ -1018,6 +1062,7 @@ void MemorySSA::renamePass(DomTreeNode *Root, MemoryAccess *IncomingVal,
   bool AlreadyVisited = !Visited.insert(Root->getBlock()).second;
   if (SkipVisited && AlreadyVisited)
     return;
+  ++ModificationEpoch;
 
   IncomingVal = renameBlock(Root->getBlock(), IncomingVal, RenameAllUses);
   renameSuccessorPhis(Root->getBlock(), IncomingVal, RenameAllUses);
@@ -1133,7 +1178,7 @@ namespace llvm {
 /// which is walking bottom-up.
 class MemorySSA::OptimizeUses {
 public:
-  OptimizeUses(MemorySSA *MSSA, MemorySSAWalker *Walker, AliasAnalysis *AA,
+  OptimizeUses(MemorySSA *MSSA, MemorySSAWalker *Walker, BatchAAResults *AA,
                DominatorTree *DT)
       : MSSA(MSSA), Walker(Walker), AA(AA), DT(DT) {
     Walker = MSSA->getWalker();
@@ -1166,7 +1211,7 @@ private:
 
   MemorySSA *MSSA;
   MemorySSAWalker *Walker;
-  AliasAnalysis *AA;
+  BatchAAResults *AA;
   DominatorTree *DT;
 };
 
@@ -1411,7 +1456,14 @@ void MemorySSA::buildMemorySSA() {
 
   CachingWalker *Walker = getWalkerImpl();
 
-  OptimizeUses(this, Walker, AA, DT).optimizeUses();
+  // With lazy use optimization, the walker optimizes each use the first time
+  // it is queried instead.
+  if (!LazyUseOptimization) {
+    // The IR does not change while the uses are optimized, so alias results
+    // can be shared by all the queries.
+    BatchAAResults BatchAA(*AA);
+    OptimizeUses(this, Walker, &BatchAA, DT).optimizeUses();
+  }
 
   // Mark the uses in unreachable blocks as live on entry, so that they go
   // somewhere.
@@ -1463,6 +1515,7 @@ void MemorySSA::insertIntoListsForBlock(MemoryAccess *NewAccess,
     }
   }
   BlockNumberingValid.erase(BB);
+  ++ModificationEpoch;
 }
 
 void MemorySSA::insertIntoListsBefore(MemoryAccess *What, const BasicBlock *BB,
@@ -1491,6 +1544,7 @@ void MemorySSA::insertIntoListsBefore(MemoryAccess *What, const BasicBlock *BB,
     }
   }
   BlockNumberingValid.erase(BB);
+  ++ModificationEpoch;
 }
 
 void MemorySSA::prepareForMoveTo(MemoryAccess *What, BasicBlock *BB) {
@@ -1639,6 +1693,7 @@ void MemorySSA::removeFromLookups(MemoryAccess *MA) {
   assert(MA->use_empty() &&
          "Trying to remove memory access that still has uses");
   BlockNumbering.erase(MA);
+  ++ModificationEpoch;
   if (auto *MUD = dyn_cast<MemoryUseOrDef>(MA))
     MUD->setDefiningAccess(nullptr);
   // Invalidate our walker's cache if necessary
@@ -1664,6 +1719,7 @@ void MemorySSA::removeFromLookups(MemoryAccess *MA) {
 /// deleted, not just removed.
 void MemorySSA::removeFromLists(MemoryAccess *MA, bool ShouldDelete) {
   BasicBlock *BB = MA->getBlock();
+  ++ModificationEpoch;
   // The access list owns the reference, so we erase it from the non-owning list
   // first.
   if (!isa<MemoryUse>(MA)) {
@@ -2138,6 +2194,7 @@ MemorySSA::CachingWalker::CachingWalker(MemorySSA *M, AliasAnalysis *A,
 void MemorySSA::CachingWalker::invalidateInfo(MemoryAccess *MA) {
   if (auto *MUD = dyn_cast<MemoryUseOrDef>(MA))
     MUD->resetOptimized();
+  LocationClobbers.clear();
 }
 
 /// Walk the use-def chains starting at \p MA and find
@@ -2177,7 +2234,20 @@ MemoryAccess *MemorySSA::CachingWalker::getClobberingMemoryAccess(
                                      ? StartingUseOrDef->getDefiningAccess()
                                      : StartingUseOrDef;
 
+  if (LocationClobbersEpoch != MSSA->ModificationEpoch) {
+    LocationClobbers.clear();
+    LocationClobbersEpoch = MSSA->ModificationEpoch;
+  }
+  MemoryAccess *&CachedClobber = LocationClobbers[{StartingUseOrDef, Loc}];
+  if (CachedClobber) {
+    ++NumClobberCacheHits;
+    return CachedClobber;
+  }
+
   MemoryAccess *Clobber = getClobberingMemoryAccess(DefiningAccess, Q);
+  // The walk cannot invalidate the reference, since it does not touch the
+  // cache.
+  CachedClobber = Clobber;
   LLVM_DEBUG(dbgs() << "Starting Memory SSA clobber for " << *I << " is ");
   LLVM_DEBUG(dbgs() << *StartingUseOrDef << "\n");
   LLVM_DEBUG(dbgs() << "Final Memory SSA clobber for " << *I << " is ");
@@ -50,9 +50,11 @@
 #include "llvm/Pass.h"
 #include "llvm/Support/Casting.h"
 #include "llvm/Support/CommandLine.h"
+#include "llvm/Support/ThreadPool.h"
 #include <algorithm>
 #include <cassert>
 #include <cstdint>
+#include <mutex>
 #include <vector>
 
 using namespace llvm;
@@ -71,6 +73,32 @@ cl::opt<FunctionSummary::ForceSummaryHotnessType, true> FSEC(
                           "all-non-critical", "All non-critical edges."),
                clEnumValN(FunctionSummary::FSHT_All, "all", "All edges.")));
 
+// Mark the edges to the promotion candidates of a hot indirect call hot, so
+// that the thin link imports them at the hot threshold and the call can be
+// promoted and inlined in the importing module.
+static cl::opt<bool> HotICallTargets(
+    "summary-hot-icall-targets", cl::Hidden, cl::init(true),
+    cl::desc("Mark the edges to the promotion candidates of a hot indirect "
+             "call hot in the function summary"));
+
+static cl::opt<unsigned> SummaryThreads(
+    "module-summary-threads", cl::Hidden, cl::init(0),
+    cl::desc("Number of threads used to compute the function summaries of a "
+             "module (0 computes them serially)"));
+
+// Return the ValueInfo of \p V in \p Index. When the function summaries are
+// computed in parallel, all threads share the index and \p IndexLock
+// serializes the updates. The ValueInfos only depend on the GUIDs, so the
+// order of the updates does not affect the resulting index.
+template <typename ValueT>
+static ValueInfo getOrInsertValueInfo(ModuleSummaryIndex &Index, ValueT V,
+                                      std::mutex *IndexLock) {
+  if (!IndexLock)
+    return Index.getOrInsertValueInfo(V);
+  std::lock_guard<std::mutex> Guard(*IndexLock);
+  return Index.getOrInsertValueInfo(V);
+}
+
 // Walk through the operands of a given User via worklist iteration and populate
 // the set of GlobalValue references encountered. Invoked either on an
 // Instruction or a GlobalVariable (which walks its initializer).
@@ -83,7 +111,8 @@ cl::opt<FunctionSummary::ForceSummaryHotnessType, true> FSEC(
 // can only take an address of basic block located in the same function.
 static bool findRefEdges(ModuleSummaryIndex &Index, const User *CurUser,
                          SetVector<ValueInfo> &RefEdges,
-                         SmallPtrSet<const User *, 8> &Visited) {
+                         SmallPtrSet<const User *, 8> &Visited,
+                         std::mutex *IndexLock = nullptr) {
   bool HasBlockAddress = false;
   SmallVector<const User *, 32> Worklist;
   Worklist.push_back(CurUser);
@@ -109,7 +138,7 @@ static bool findRefEdges(ModuleSummaryIndex &Index, const User *CurUser,
         // the reference set unless it is a callee. Callees are handled
         // specially by WriteFunction and are added to a separate list.
         if (!(CS && CS.isCallee(&OI)))
-          RefEdges.insert(Index.getOrInsertValueInfo(GV));
+          RefEdges.insert(getOrInsertValueInfo(Index, GV, IndexLock));
         continue;
       }
       Worklist.push_back(Operand);
@@ -232,7 +261,8 @@ static void computeFunctionSummary(ModuleSummaryIndex &Index, const Module &M,
                                    ProfileSummaryInfo *PSI, DominatorTree &DT,
                                    bool HasLocalsInUsedOrAsm,
                                    DenseSet<GlobalValue::GUID> &CantBePromoted,
-                                   bool IsThinLTO) {
+                                   bool IsThinLTO,
+                                   std::mutex *IndexLock = nullptr) {
   // Summary not currently supported for anonymous functions, they should
   // have been named.
   assert(F.hasName());
@@ -252,7 +282,7 @@ static void computeFunctionSummary(ModuleSummaryIndex &Index, const Module &M,
 
   // Add personality function, prefix data and prologue data to function's ref
   // list.
-  findRefEdges(Index, &F, RefEdges, Visited);
+  findRefEdges(Index, &F, RefEdges, Visited, IndexLock);
   std::vector<const Instruction *> NonVolatileLoads;
 
   bool HasInlineAsmMaybeReferencingInternal = false;
@@ -268,7 +298,7 @@ static void computeFunctionSummary(ModuleSummaryIndex &Index, const Module &M,
         NonVolatileLoads.push_back(&I);
         continue;
       }
-      findRefEdges(Index, &I, RefEdges, Visited);
+      findRefEdges(Index, &I, RefEdges, Visited, IndexLock);
       auto CS = ImmutableCallSite(&I);
       if (!CS)
         continue;
@@ -316,8 +346,8 @@ static void computeFunctionSummary(ModuleSummaryIndex &Index, const Module &M,
         // to record the call edge to the alias in that case. Eventually
         // an alias summary will be created to associate the alias and
         // aliasee.
-        auto &ValueInfo = CallGraphEdges[Index.getOrInsertValueInfo(
-            cast<GlobalValue>(CalledValue))];
+        auto &ValueInfo = CallGraphEdges[getOrInsertValueInfo(
+            Index, cast<GlobalValue>(CalledValue), IndexLock)];
         ValueInfo.updateHotness(Hotness);
         // Add the relative block frequency to CalleeInfo if there is no profile
         // information.
@@ -342,7 +372,7 @@ static void computeFunctionSummary(ModuleSummaryIndex &Index, const Module &M,
           for (auto &Op : MD->operands()) {
             Function *Callee = mdconst::extract_or_null<Function>(Op);
             if (Callee)
-              CallGraphEdges[Index.getOrInsertValueInfo(Callee)];
+              CallGraphEdges[getOrInsertValueInfo(Index, Callee, IndexLock)];
           }
         }
 
@@ -351,9 +381,12 @@ static void computeFunctionSummary(ModuleSummaryIndex &Index, const Module &M,
         auto CandidateProfileData =
             ICallAnalysis.getPromotionCandidatesForInstruction(
                 &I, NumVals, TotalCount, NumCandidates);
+        bool HotSite = HotICallTargets && PSI && PSI->isHotCount(TotalCount);
         for (auto &Candidate : CandidateProfileData)
-          CallGraphEdges[Index.getOrInsertValueInfo(Candidate.Value)]
-              .updateHotness(getHotness(Candidate.Count, PSI));
+          CallGraphEdges[getOrInsertValueInfo(Index, Candidate.Value,
+                                              IndexLock)]
+              .updateHotness(HotSite ? CalleeInfo::HotnessType::Hot
+                                     : getHotness(Candidate.Count, PSI));
       }
     }
 
@@ -365,7 +398,7 @@ static void computeFunctionSummary(ModuleSummaryIndex &Index, const Module &M,
   unsigned RefCnt = RefEdges.size();
   for (const Instruction *I : NonVolatileLoads) {
     Visited.erase(I);
-    findRefEdges(Index, I, RefEdges, Visited);
+    findRefEdges(Index, I, RefEdges, Visited, IndexLock);
   }
   std::vector<ValueInfo> Refs = RefEdges.takeVector();
   // Regular LTO module doesn't participate in ThinLTO import,
@@ -378,7 +411,7 @@ static void computeFunctionSummary(ModuleSummaryIndex &Index, const Module &M,
   // Explicit add hot edges to enforce importing for designated GUIDs for
   // sample PGO, to enable the same inlines as the profiled optimized binary.
   for (auto &I : F.getImportGUIDs())
-    CallGraphEdges[Index.getOrInsertValueInfo(I)].updateHotness(
+    CallGraphEdges[getOrInsertValueInfo(Index, I, IndexLock)].updateHotness(
         ForceSummaryEdgesCold == FunctionSummary::FSHT_All
             ? CalleeInfo::HotnessType::Cold
             : CalleeInfo::HotnessType::Critical);
@@ -394,18 +427,65 @@ static void computeFunctionSummary(ModuleSummaryIndex &Index, const Module &M,
       F.hasFnAttribute(Attribute::NoRecurse), F.returnDoesNotAlias(),
       // FIXME: refactor this to use the same code that inliner is using.
       // Don't try to import functions with noinline attribute.
-      F.getAttributes().hasFnAttribute(Attribute::NoInline)};
+      F.getAttributes().hasFnAttribute(Attribute::NoInline),
+      F.isPagerando()};
   auto FuncSummary = llvm::make_unique<FunctionSummary>(
       Flags, NumInsts, FunFlags, /*EntryCount=*/0, std::move(Refs),
       CallGraphEdges.takeVector(), TypeTests.takeVector(),
       TypeTestAssumeVCalls.takeVector(), TypeCheckedLoadVCalls.takeVector(),
       TypeTestAssumeConstVCalls.takeVector(),
       TypeCheckedLoadConstVCalls.takeVector());
+  std::unique_lock<std::mutex> Guard;
+  if (IndexLock)
+    Guard = std::unique_lock<std::mutex>(*IndexLock);
   if (NonRenamableLocal)
     CantBePromoted.insert(F.getGUID());
   Index.addGlobalValueSummary(F, std::move(FuncSummary));
 }
 
+// Compute the summaries of the functions defined in \p M on \p NumThreads
+// threads. The profile-based block frequencies are computed up front, since
+// creating the branch probabilities registers value handles, which is not
+// thread-safe.
+static void computeFunctionSummariesInParallel(
+    ModuleSummaryIndex &Index, const Module &M, ProfileSummaryInfo *PSI,
+    bool HasLocalsInUsedOrAsm, DenseSet<GlobalValue::GUID> &CantBePromoted,
+    bool IsThinLTO, unsigned NumThreads) {
+  std::vector<std::pair<const Function *, std::unique_ptr<BlockFrequencyInfo>>>
+      Functions;
+  for (auto &F : M) {
+    if (F.isDeclaration())
+      continue;
+    std::unique_ptr<BlockFrequencyInfo> BFI;
+    if (F.hasProfileData()) {
+      DominatorTree DT(const_cast<Function &>(F));
+      LoopInfo LI{DT};
+      BranchProbabilityInfo BPI{F, LI};
+      BFI = llvm::make_unique<BlockFrequencyInfo>(F, BPI, LI);
+    }
+    Functions.emplace_back(&F, std::move(BFI));
+  }
+
+  // Compute the lazily initialized hotness thresholds before sharing PSI.
+  if (PSI) {
+    PSI->isHotCount(0);
+    PSI->isColdCount(0);
+  }
+
+  std::mutex IndexLock;
+  ThreadPool Pool(NumThreads);
+  for (auto &FI : Functions) {
+    const Function *F = FI.first;
+    BlockFrequencyInfo *BFI = FI.second.get();
+    Pool.async([&, F, BFI]() {
+      DominatorTree DT(const_cast<Function &>(*F));
+      computeFunctionSummary(Index, M, *F, BFI, PSI, DT, HasLocalsInUsedOrAsm,
+                             CantBePromoted, IsThinLTO, &IndexLock);
+    });
+  }
+  Pool.wait();
+}
+
 static void
 computeVariableSummary(ModuleSummaryIndex &Index, const GlobalVariable &V,
                        DenseSet<GlobalValue::GUID> &CantBePromoted) {
@@ -515,7 +595,8 @@ ModuleSummaryIndex llvm::buildModuleSummaryIndex(
                         F->hasFnAttribute(Attribute::ReadOnly),
                         F->hasFnAttribute(Attribute::NoRecurse),
                         F->returnDoesNotAlias(),
-                        /* NoInline = */ false},
+                        /* NoInline = */ false,
+                        F->isPagerando()},
                     /*EntryCount=*/0, ArrayRef<ValueInfo>{},
                     ArrayRef<FunctionSummary::EdgeTy>{},
                     ArrayRef<GlobalValue::GUID>{},
@@ -540,27 +621,33 @@ ModuleSummaryIndex llvm::buildModuleSummaryIndex(
     IsThinLTO = MD->getZExtValue();
 
   // Compute summaries for all functions defined in module, and save in the
-  // index.
-  for (auto &F : M) {
-    if (F.isDeclaration())
-      continue;
+  // index. The parallel computation cannot use the callback, which runs
+  // analyses through a pass manager.
+  if (SummaryThreads > 1 && !GetBFICallback)
+    computeFunctionSummariesInParallel(
+        Index, M, PSI, !LocalsUsed.empty() || HasLocalInlineAsmSymbol,
+        CantBePromoted, IsThinLTO, SummaryThreads);
+  else
+    for (auto &F : M) {
+      if (F.isDeclaration())
+        continue;
 
-    DominatorTree DT(const_cast<Function &>(F));
-    BlockFrequencyInfo *BFI = nullptr;
-    std::unique_ptr<BlockFrequencyInfo> BFIPtr;
-    if (GetBFICallback)
-      BFI = GetBFICallback(F);
-    else if (F.hasProfileData()) {
-      LoopInfo LI{DT};
-      BranchProbabilityInfo BPI{F, LI};
-      BFIPtr = llvm::make_unique<BlockFrequencyInfo>(F, BPI, LI);
-      BFI = BFIPtr.get();
-    }
+      DominatorTree DT(const_cast<Function &>(F));
+      BlockFrequencyInfo *BFI = nullptr;
+      std::unique_ptr<BlockFrequencyInfo> BFIPtr;
+      if (GetBFICallback)
+        BFI = GetBFICallback(F);
+      else if (F.hasProfileData()) {
+        LoopInfo LI{DT};
+        BranchProbabilityInfo BPI{F, LI};
+        BFIPtr = llvm::make_unique<BlockFrequencyInfo>(F, BPI, LI);
+        BFI = BFIPtr.get();
+      }
 
-    computeFunctionSummary(Index, M, F, BFI, PSI, DT,
-                           !LocalsUsed.empty() || HasLocalInlineAsmSymbol,
-                           CantBePromoted, IsThinLTO);
-  }
+      computeFunctionSummary(Index, M, F, BFI, PSI, DT,
+                             !LocalsUsed.empty() || HasLocalInlineAsmSymbol,
+                             CantBePromoted, IsThinLTO);
+    }
 
   // Compute summaries for all variables defined in module, and save in the
   // index.
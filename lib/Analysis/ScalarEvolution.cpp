@@ -119,6 +119,7 @@
 #include "llvm/Support/Compiler.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/Format.h"
 #include "llvm/Support/KnownBits.h"
 #include "llvm/Support/SaveAndRestore.h"
 #include "llvm/Support/raw_ostream.h"
@@ -146,6 +147,8 @@ STATISTIC(NumTripCountsNotComputed,
           "Number of loops without predictable loop counts");
 STATISTIC(NumBruteForceTripCountsComputed,
           "Number of loops with trip counts computed by force");
+STATISTIC(NumSCEVCacheFlushes,
+          "Number of times the SCEV caches were flushed to cap their size");
 
 static cl::opt<unsigned>
 MaxBruteForceIterations("scalar-evolution-max-iterations", cl::ReallyHidden,
@@ -212,6 +215,17 @@ static cl::opt<unsigned>
                   cl::desc("Max coefficients in AddRec during evolving"),
                   cl::init(8));
 
+static cl::opt<unsigned> MaxCachedValues(
+    "scev-max-cached-values", cl::Hidden,
+    cl::desc("Flush the memoized SCEV results of a function once this many "
+             "values are cached (0 = unlimited)"),
+    cl::init(0));
+
+static cl::opt<bool> ReportCache(
+    "scev-cache-report", cl::Hidden,
+    cl::desc("Print SCEV node counts and cache hit rates for each function"),
+    cl::init(false));
+
 //===----------------------------------------------------------------------===//
 //                           SCEV class definitions
 //===----------------------------------------------------------------------===//
@@ -3914,8 +3928,13 @@ static bool SCEVLostPoisonFlags(const SCEV *S, const Value *V) {
 const SCEV *ScalarEvolution::getSCEV(Value *V) {
   assert(isSCEVable(V->getType()) && "Value is not SCEVable!");
 
+  ++NumQueries;
   const SCEV *S = getExistingSCEV(V);
   if (S == nullptr) {
+    if (MaxCachedValues && !CacheUseDepth &&
+        ValueExprMap.size() >= MaxCachedValues)
+      flushCaches();
+    SaveAndRestore<unsigned> InUse(CacheUseDepth, CacheUseDepth + 1);
     S = createSCEV(V);
     // During PHI resolution, it is possible to create two SCEVs for the same
     // V, so it is needed to double check whether V->S is inserted into
@@ -3939,10 +3958,37 @@ const SCEV *ScalarEvolution::getSCEV(Value *V) {
           !isa<GetElementPtrInst>(V))
         ExprValueMap[Stripped].insert({V, Offset});
     }
+  } else {
+    ++NumCacheHits;
   }
   return S;
 }
 
+void ScalarEvolution::flushCaches() {
+  assert(!CacheUseDepth && "Flushing caches that are in use!");
+  ++NumCacheFlushes;
+  ++NumSCEVCacheFlushes;
+
+  ExprValueMap.clear();
+  ValueExprMap.clear();
+  HasRecMap.clear();
+  MinTrailingZerosCache.clear();
+  for (auto &BTCI : BackedgeTakenCounts)
+    BTCI.second.clear();
+  BackedgeTakenCounts.clear();
+  for (auto &BTCI : PredicatedBackedgeTakenCounts)
+    BTCI.second.clear();
+  PredicatedBackedgeTakenCounts.clear();
+  ConstantEvolutionLoopExitValue.clear();
+  ValuesAtScopes.clear();
+  LoopDispositions.clear();
+  BlockDispositions.clear();
+  UnsignedRanges.clear();
+  SignedRanges.clear();
+  PredicatedSCEVRewrites.clear();
+  LoopUsers.clear();
+}
+
 const SCEV *ScalarEvolution::getExistingSCEV(Value *V) {
   assert(isSCEVable(V->getType()) && "Value is not SCEVable!");
 
@@ -6635,6 +6681,7 @@ ScalarEvolution::getPredicatedBackedgeTakenInfo(const Loop *L) {
   if (!Pair.second)
     return Pair.first->second;
 
+  SaveAndRestore<unsigned> InUse(CacheUseDepth, CacheUseDepth + 1);
   BackedgeTakenInfo Result =
       computeBackedgeTakenCount(L, /*AllowPredicates=*/true);
 
@@ -6656,6 +6703,7 @@ ScalarEvolution::getBackedgeTakenInfo(const Loop *L) {
   // computeBackedgeTakenCount may allocate memory for its result. Inserting it
   // into the BackedgeTakenCounts map transfers ownership. Otherwise, the result
   // must be cleared in this scope.
+  SaveAndRestore<unsigned> InUse(CacheUseDepth, CacheUseDepth + 1);
   BackedgeTakenInfo Result = computeBackedgeTakenCount(L);
 
   // In product build, there are no usage of statistic.
@@ -11356,11 +11404,22 @@ ScalarEvolution::ScalarEvolution(ScalarEvolution &&Arg)
       SCEVAllocator(std::move(Arg.SCEVAllocator)),
       LoopUsers(std::move(Arg.LoopUsers)),
       PredicatedSCEVRewrites(std::move(Arg.PredicatedSCEVRewrites)),
-      FirstUnknown(Arg.FirstUnknown) {
+      FirstUnknown(Arg.FirstUnknown), NumQueries(Arg.NumQueries),
+      NumCacheHits(Arg.NumCacheHits), NumCacheFlushes(Arg.NumCacheFlushes) {
   Arg.FirstUnknown = nullptr;
 }
 
 ScalarEvolution::~ScalarEvolution() {
+  if (ReportCache && CouldNotCompute)
+    errs() << "SCEV cache report for '" << F.getName()
+           << "': " << UniqueSCEVs.size() << " nodes, "
+           << ValueExprMap.size() << " cached values, " << NumQueries
+           << " queries, " << NumCacheHits << " hits ("
+           << format("%.1f", NumQueries ? 100.0 * NumCacheHits / NumQueries
+                                        : 0.0)
+           << "%), " << NumCacheFlushes << " flushes, "
+           << SCEVAllocator.getTotalMemory() << " bytes\n";
+
   // Iterate through all the SCEVUnknown instances and call their
   // destructors, so that they release their references to their values.
   for (SCEVUnknown *U = FirstUnknown; U;) {
@@ -639,6 +639,11 @@ unsigned TargetTransformInfo::getLoadStoreVecRegBitWidth(unsigned AS) const {
   return TTIImpl->getLoadStoreVecRegBitWidth(AS);
 }
 
+unsigned
+TargetTransformInfo::getMaxInlineSizeForMemIntrinsic(bool IsMemset) const {
+  return TTIImpl->getMaxInlineSizeForMemIntrinsic(IsMemset);
+}
+
 bool TargetTransformInfo::isLegalToVectorizeLoad(LoadInst *LI) const {
   return TTIImpl->isLegalToVectorizeLoad(LI);
 }
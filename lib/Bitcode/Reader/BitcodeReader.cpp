@@ -877,6 +877,7 @@ static FunctionSummary::FFlags getDecodedFFlags(uint64_t RawFlags) {
   Flags.NoRecurse = (RawFlags >> 2) & 0x1;
   Flags.ReturnDoesNotAlias = (RawFlags >> 3) & 0x1;
   Flags.NoInline = (RawFlags >> 4) & 0x1;
+  Flags.Pagerando = (RawFlags >> 5) & 0x1;
   return Flags;
 }
 
@@ -4827,7 +4828,11 @@ Error BitcodeReader::materializeModule() {
   WillMaterializeAllForwardRefs = true;
 
   // Iterate over the module, deserializing any functions that are still on
-  // disk.
+  // disk. The bodies are parsed one at a time: although the function blocks
+  // are independent in the stream, parsing them creates constants, types and
+  // metadata in the shared LLVMContext, resolves forward references through
+  // the module-level value list, and updates the use lists of globals, none
+  // of which is thread-safe.
   for (Function &F : *TheModule) {
     if (Error Err = materialize(&F))
       return Err;
@@ -5158,8 +5163,15 @@ std::vector<FunctionSummary::EdgeTy>
 ModuleSummaryIndexBitcodeReader::makeCallList(ArrayRef<uint64_t> Record,
                                               bool IsOldProfileFormat,
                                               bool HasProfile, bool HasRelBF) {
+  // Each edge takes one record field for the callee plus the profile fields.
+  unsigned FieldsPerEdge = 1;
+  if (IsOldProfileFormat)
+    FieldsPerEdge += HasProfile ? 2 : 1;
+  else if (HasProfile || HasRelBF)
+    FieldsPerEdge += 1;
+
   std::vector<FunctionSummary::EdgeTy> Ret;
-  Ret.reserve(Record.size());
+  Ret.reserve(Record.size() / FieldsPerEdge);
   for (unsigned I = 0, E = Record.size(); I != E; ++I) {
     CalleeInfo::HotnessType Hotness = CalleeInfo::HotnessType::Unknown;
     uint64_t RelBF = 0;
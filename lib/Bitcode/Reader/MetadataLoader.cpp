@@ -102,6 +102,11 @@ static cl::opt<bool> DisableLazyLoading(
     cl::desc("Force disable the lazy-loading on-demand of metadata when "
              "loading bitcode for importing."));
 
+static cl::opt<bool> LazyLoadModuleMetadata(
+    "lazy-load-module-metadata", cl::init(false), cl::Hidden,
+    cl::desc("Lazy-load the module-level metadata on-demand also when the "
+             "bitcode is not loaded for importing."));
+
 namespace {
 
 static int64_t unrotateSign(uint64_t U) { return U & 1 ? ~(U >> 1) : U >> 1; }
@@ -853,8 +858,10 @@ Error MetadataLoader::MetadataLoaderImpl::parseMetadata(bool ModuleLevel) {
 
   // We lazy-load module-level metadata: we build an index for each record, and
   // then load individual record as needed, starting with the named metadata.
-  if (ModuleLevel && IsImporting && MetadataList.empty() &&
-      !DisableLazyLoading) {
+  // Debug info that is only reachable from the function bodies, such as the
+  // subprograms and most types, is then loaded when a body is materialized.
+  if (ModuleLevel && (IsImporting || LazyLoadModuleMetadata) &&
+      MetadataList.empty() && !DisableLazyLoading) {
     auto SuccessOrErr = lazyLoadModuleMetadataBlock();
     if (!SuccessOrErr)
       return SuccessOrErr.takeError();
@@ -68,6 +68,7 @@
 #include "llvm/Support/MathExtras.h"
 #include "llvm/Support/SHA1.h"
 #include "llvm/Support/TargetRegistry.h"
+#include "llvm/Support/ThreadPool.h"
 #include "llvm/Support/raw_ostream.h"
 #include <algorithm>
 #include <cassert>
@@ -87,6 +88,11 @@ static cl::opt<unsigned>
                    cl::desc("Number of metadatas above which we emit an index "
                             "to enable lazy-loading"));
 
+static cl::opt<unsigned> WriterThreads(
+    "bitcode-writer-threads", cl::Hidden, cl::init(0),
+    cl::desc("Number of threads used to encode the function blocks of a "
+             "module (0 encodes them serially)"));
+
 cl::opt<bool> WriteRelBFToSummary(
     "write-relbf-to-summary", cl::Hidden, cl::init(false),
     cl::desc("Write relative block frequency to function summary "));
@@ -386,6 +392,8 @@ private:
   void
   writeFunction(const Function &F,
                 DenseMap<const Function *, uint64_t> &FunctionToBitcodeIndex);
+  void writeFunctionsInParallel(
+      DenseMap<const Function *, uint64_t> &FunctionToBitcodeIndex);
   void writeBlockInfo();
   void writeModuleHash(size_t BlockStartPos);
 
@@ -983,6 +991,7 @@ static uint64_t getEncodedFFlags(FunctionSummary::FFlags Flags) {
   RawFlags |= (Flags.NoRecurse << 2);
   RawFlags |= (Flags.ReturnDoesNotAlias << 3);
   RawFlags |= (Flags.NoInline << 4);
+  RawFlags |= (Flags.Pagerando << 5);
   return RawFlags;
 }
 
@@ -3151,6 +3160,64 @@ void ModuleBitcodeWriter::writeFunction(
   Stream.ExitBlock();
 }
 
+void ModuleBitcodeWriter::writeFunctionsInParallel(
+    DenseMap<const Function *, uint64_t> &FunctionToBitcodeIndex) {
+  std::vector<const Function *> Functions;
+  DenseMap<const Function *, size_t> FunctionNumbers;
+  for (const Function &F : M)
+    if (!F.isDeclaration()) {
+      FunctionNumbers[&F] = Functions.size();
+      Functions.push_back(&F);
+    }
+  if (Functions.empty())
+    return;
+
+  // Every worker enumerates the module again, which assigns the same value
+  // ids, and emits the same block info abbreviations, so it encodes the same
+  // blocks as this writer. A function block only refers to its own start
+  // through its size field, so it is encoded at the start of a scratch stream
+  // and then spliced into this one after its header.
+  unsigned NumThreads = std::min<size_t>(WriterThreads, Functions.size());
+  bool PreserveUseListOrder = VE.shouldPreserveUseListOrder();
+  std::vector<SmallVector<char, 0>> Blocks(Functions.size());
+  ThreadPool Pool(NumThreads);
+  for (unsigned T = 0; T != NumThreads; ++T) {
+    size_t Begin = Functions.size() * T / NumThreads;
+    size_t End = Functions.size() * (T + 1) / NumThreads;
+    Pool.async([&, Begin, End]() {
+      SmallVector<char, 0> WorkerBuffer;
+      StringTableBuilder WorkerStrtab(StringTableBuilder::RAW);
+      BitstreamWriter WorkerStream(WorkerBuffer);
+      ModuleBitcodeWriter Worker(M, WorkerBuffer, WorkerStrtab, WorkerStream,
+                                 PreserveUseListOrder, /*Index=*/nullptr,
+                                 /*GenerateHash=*/false);
+      Worker.writeBlockInfo();
+      DenseMap<const Function *, uint64_t> WorkerIndex;
+      UseListOrderStack &Orders = Worker.VE.UseListOrders;
+      for (size_t I = Begin; I != End; ++I) {
+        // Drop the use-list orders of the functions written by other workers.
+        while (!Orders.empty() && Orders.back().F &&
+               FunctionNumbers.lookup(Orders.back().F) < I)
+          Orders.pop_back();
+        WorkerBuffer.clear();
+        Worker.writeFunction(*Functions[I], WorkerIndex);
+        // Skip the header, which fits in the first word.
+        Blocks[I].assign(WorkerBuffer.begin() + 4, WorkerBuffer.end());
+      }
+    });
+  }
+  Pool.wait();
+
+  for (size_t I = 0, E = Functions.size(); I != E; ++I) {
+    FunctionToBitcodeIndex[Functions[I]] = Stream.GetCurrentBitNo();
+    Stream.EmitEncodedBlock(bitc::FUNCTION_BLOCK_ID, 4, Blocks[I]);
+  }
+
+  // Leave the module-level use-list orders for this writer.
+  while (!VE.UseListOrders.empty() && VE.UseListOrders.back().F)
+    VE.UseListOrders.pop_back();
+}
+
 // Emit blockinfo, which defines the standard abbreviations etc.
 void ModuleBitcodeWriter::writeBlockInfo() {
   // We only want to emit block info records for blocks that have multiple
@@ -4079,9 +4146,12 @@ void ModuleBitcodeWriter::write() {
 
   // Emit function bodies.
   DenseMap<const Function *, uint64_t> FunctionToBitcodeIndex;
-  for (Module::const_iterator F = M.begin(), E = M.end(); F != E; ++F)
-    if (!F->isDeclaration())
-      writeFunction(*F, FunctionToBitcodeIndex);
+  if (WriterThreads > 1)
+    writeFunctionsInParallel(FunctionToBitcodeIndex);
+  else
+    for (Module::const_iterator F = M.begin(), E = M.end(); F != E; ++F)
+      if (!F->isDeclaration())
+        writeFunction(*F, FunctionToBitcodeIndex);
 
   // Need to write after the above call to WriteFunction which populates
   // the summary information in the index.
@@ -22,6 +22,7 @@
 #include "llvm/MC/MCExpr.h"
 #include "llvm/MC/MCStreamer.h"
 #include "llvm/MC/MCSymbol.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Target/TargetLoweringObjectFile.h"
 #include <algorithm>
@@ -32,13 +33,43 @@
 
 using namespace llvm;
 
+/// Tables with fewer names than this are finalized serially; below it the
+/// cost of dispatching work to threads outweighs the hashing and sorting.
+static const size_t ParallelThreshold = 1 << 14;
+
+/// Run \p Fn on every index in [0, N), in parallel if \p Parallel is set.
+template <typename FuncTy>
+static void forEachIndex(bool Parallel, size_t N, FuncTy Fn) {
+#if LLVM_ENABLE_THREADS
+  if (Parallel) {
+    parallel::for_each_n(parallel::par, size_t(0), N, Fn);
+    return;
+  }
+#endif
+  for (size_t I = 0; I != N; ++I)
+    Fn(I);
+}
+
+template <typename RandomAccessIterator, typename Comparator>
+static void sortRange(bool Parallel, RandomAccessIterator Start,
+                      RandomAccessIterator End, const Comparator &Comp) {
+#if LLVM_ENABLE_THREADS
+  if (Parallel) {
+    parallel::sort(parallel::par, Start, End, Comp);
+    return;
+  }
+#endif
+  llvm::sort(Start, End, Comp);
+}
+
 void AccelTableBase::computeBucketCount() {
   // First get the number of unique hashes.
   std::vector<uint32_t> Uniques;
   Uniques.reserve(Entries.size());
   for (const auto &E : Entries)
     Uniques.push_back(E.second.HashValue);
-  array_pod_sort(Uniques.begin(), Uniques.end());
+  sortRange(Entries.size() >= ParallelThreshold, Uniques.begin(),
+            Uniques.end(), std::less<uint32_t>());
   std::vector<uint32_t>::iterator P =
       std::unique(Uniques.begin(), Uniques.end());
 
@@ -52,40 +83,57 @@ void AccelTableBase::computeBucketCount() {
     BucketCount = std::max<uint32_t>(UniqueHashCount, 1);
 }
 
-void AccelTableBase::finalize(AsmPrinter *Asm, StringRef Prefix) {
-  // Create the individual hash data outputs.
-  for (auto &E : Entries) {
+void AccelTableBase::computeBuckets() {
+  assert(Buckets.empty() && "Already finalized!");
+  bool Parallel = Entries.size() >= ParallelThreshold;
+
+  // Create the individual hash data outputs. Every entry is independent, so
+  // large tables hash and unique their entries in parallel.
+  std::vector<HashData *> Data;
+  Data.reserve(Entries.size());
+  for (auto &E : Entries)
+    Data.push_back(&E.second);
+  forEachIndex(Parallel, Data.size(), [&](size_t I) {
+    HashData &HD = *Data[I];
+    HD.HashValue = Hash(HD.Name.getString());
     // Unique the entries.
-    std::stable_sort(E.second.Values.begin(), E.second.Values.end(),
+    std::stable_sort(HD.Values.begin(), HD.Values.end(),
                      [](const AccelTableData *A, const AccelTableData *B) {
                        return *A < *B;
                      });
-    E.second.Values.erase(
-        std::unique(E.second.Values.begin(), E.second.Values.end()),
-        E.second.Values.end());
-  }
+    HD.Values.erase(std::unique(HD.Values.begin(), HD.Values.end()),
+                    HD.Values.end());
+  });
 
   // Figure out how many buckets we need, then compute the bucket contents and
   // the final ordering. The hashes and offsets can be emitted by walking these
-  // data structures. We add temporary symbols to the data so they can be
-  // referenced when emitting the offsets.
+  // data structures.
   computeBucketCount();
 
   // Compute bucket contents and final ordering.
   Buckets.resize(BucketCount);
-  for (auto &E : Entries) {
-    uint32_t Bucket = E.second.HashValue % BucketCount;
-    Buckets[Bucket].push_back(&E.second);
-    E.second.Sym = Asm->createTempSymbol(Prefix);
-  }
+  for (HashData *HD : Data)
+    Buckets[HD->HashValue % BucketCount].push_back(HD);
 
   // Sort the contents of the buckets by hash value so that hash collisions end
   // up together. Stable sort makes testing easier and doesn't cost much more.
-  for (auto &Bucket : Buckets)
-    std::stable_sort(Bucket.begin(), Bucket.end(),
+  // Buckets are sorted independently, so the result does not depend on
+  // whether they are sorted in parallel.
+  forEachIndex(Parallel, Buckets.size(), [&](size_t I) {
+    std::stable_sort(Buckets[I].begin(), Buckets[I].end(),
                      [](HashData *LHS, HashData *RHS) {
                        return LHS->HashValue < RHS->HashValue;
                      });
+  });
+}
+
+void AccelTableBase::finalize(AsmPrinter *Asm, StringRef Prefix) {
+  computeBuckets();
+
+  // Add temporary symbols to the data so they can be referenced when emitting
+  // the offsets. Symbol creation is not thread-safe and stays serial.
+  for (auto &E : Entries)
+    E.second.Sym = Asm->createTempSymbol(Prefix);
 }
 
 namespace {
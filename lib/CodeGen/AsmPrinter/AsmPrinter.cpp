@@ -35,6 +35,7 @@
 #include "llvm/BinaryFormat/COFF.h"
 #include "llvm/BinaryFormat/Dwarf.h"
 #include "llvm/BinaryFormat/ELF.h"
+#include "llvm/BinaryFormat/Pagerando.h"
 #include "llvm/CodeGen/AsmPrinterHandler.h"
 #include "llvm/CodeGen/GCMetadata.h"
 #include "llvm/CodeGen/GCMetadataPrinter.h"
@@ -54,6 +55,7 @@
 #include "llvm/CodeGen/MachineModuleInfoImpls.h"
 #include "llvm/CodeGen/MachineOperand.h"
 #include "llvm/CodeGen/MachineOptimizationRemarkEmitter.h"
+#include "llvm/CodeGen/PagerandoBinning.h"
 #include "llvm/CodeGen/StackMaps.h"
 #include "llvm/CodeGen/TargetFrameLowering.h"
 #include "llvm/CodeGen/TargetInstrInfo.h"
@@ -147,6 +149,16 @@ static cl::opt<bool>
     PrintSchedule("print-schedule", cl::Hidden, cl::init(false),
                   cl::desc("Print 'sched: [latency:throughput]' in .s output"));
 
+static cl::opt<std::string> PagerandoSizeFeedbackOutput(
+    "pagerando-size-feedback-output", cl::Hidden, cl::value_desc("filename"),
+    cl::desc("Record final Pagerando function sizes for use with "
+             "-pagerando-size-feedback"));
+
+static cl::opt<bool> PagerandoPackedPOT(
+    "pagerando-packed-pot", cl::Hidden, cl::init(false),
+    cl::desc("Describe Pagerando POT bin entries by a packed table that needs "
+             "no dynamic relocations"));
+
 char AsmPrinter::ID = 0;
 
 using gcp_map_type = DenseMap<GCStrategy *, std::unique_ptr<GCMetadataPrinter>>;
@@ -254,6 +266,9 @@ bool AsmPrinter::doInitialization(Module &M) {
 
   OutStreamer->InitSections(false);
 
+  if (TM.isPagerando() && !PagerandoSizeFeedbackOutput.empty())
+    PagerandoSizes = make_unique<PagerandoSizeFeedback>();
+
   // Emit the version-min deployment target directive if needed.
   //
   // FIXME: If we end up with a collection of these sorts of Darwin-specific
@@ -1256,6 +1271,21 @@ void AsmPrinter::EmitFunctionBody() {
   // Emit section containing stack size metadata.
   emitStackSizeSection(*MF);
 
+  // Record the final function size for Pagerando binning feedback and the bin
+  // report. All passes that change code size have run by now.
+  if (F.isPagerando()) {
+    auto *BinReport = getAnalysisIfAvailable<PagerandoBinReport>();
+    if (BinReport && !BinReport->isEnabled())
+      BinReport = nullptr;
+    if (PagerandoSizes || BinReport) {
+      unsigned Size = PagerandoBinnerBase::computeFunctionSize(*MF);
+      if (PagerandoSizes)
+        PagerandoSizes->recordSize(F.getName(), Size);
+      if (BinReport)
+        BinReport->recordFinalSize(F, Size);
+    }
+  }
+
   if (isVerbose())
     OutStreamer->GetCommentOS() << "-- End function\n";
 
@@ -1409,6 +1439,12 @@ bool AsmPrinter::doFinalization(Module &M) {
   if (TM.isPagerando())
     EmitPOT();
 
+  if (PagerandoSizes) {
+    if (Error E = PagerandoSizes->writeToFile(PagerandoSizeFeedbackOutput))
+      M.getContext().emitError(toString(std::move(E)));
+    PagerandoSizes.reset();
+  }
+
   // Emit visibility info for declarations
   for (const Function &F : M) {
     if (!F.isDeclarationForLinker())
@@ -1953,16 +1989,38 @@ void AsmPrinter::EmitPOT() {
   EmitLabelReference(GOTSym, PtrSize);
 
   // Emit Bin references
-  for (auto *Bin : POT)
-    EmitLabelReference(Bin->getBeginSymbol(), PtrSize);
+  if (PagerandoPackedPOT)
+    OutStreamer->EmitZeros(POT.size() * PtrSize);
+  else
+    for (auto *Bin : POT)
+      EmitLabelReference(Bin->getBeginSymbol(), PtrSize);
 
   // Emit POT end label
   auto *POTEndSym = OutContext.getOrCreateSymbol("_PAGE_OFFSET_TABLE_END_");
   OutStreamer->EmitLabel(POTEndSym);
 
+  if (PagerandoPackedPOT)
+    EmitPackedPOT();
+
   OutStreamer->AddBlankLine();
 }
 
+/// Emit the packed description of the POT bin entries (see
+/// llvm/BinaryFormat/Pagerando.h). Every offset is relative to its own
+/// address, so the static linker resolves it.
+void AsmPrinter::EmitPackedPOT() {
+  auto *Section = OutContext.getELFSection(pagerando::PackedPOTSectionName,
+                                           ELF::SHT_PROGBITS, ELF::SHF_ALLOC);
+  OutStreamer->SwitchSection(Section);
+  OutStreamer->EmitValueToAlignment(4);
+  OutStreamer->EmitIntValue(POT.size(), 4);
+  for (auto *Bin : POT) {
+    MCSymbol *Entry = OutContext.createTempSymbol();
+    OutStreamer->EmitLabel(Entry);
+    EmitLabelDifference(Bin->getBeginSymbol(), Entry, 4);
+  }
+}
+
 /// EmitLLVMUsedList - For targets that define a MAI::UsedDirective, mark each
 /// global in the specified llvm.used list for which emitUsedDirectiveFor
 /// is true, as being used with this directive.
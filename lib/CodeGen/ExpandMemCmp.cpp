@@ -55,7 +55,7 @@ class MemCmpExpansion {
   ResultBlock ResBlock;
   const uint64_t Size;
   unsigned MaxLoadSize;
-  uint64_t NumLoadsNonOneByte;
+  unsigned NumLoadsNonOneByte;
   const uint64_t NumLoadsPerBlockForZeroCmp;
   std::vector<BasicBlock *> LoadCmpBlocks;
   BasicBlock *EndBlock;
@@ -66,24 +66,29 @@ class MemCmpExpansion {
   // Represents the decomposition in blocks of the expansion. For example,
   // comparing 33 bytes on X86+sse can be done with 2x16-byte loads and
   // 1x1-byte load, which would be represented as [{16, 0}, {16, 16}, {32, 1}.
-  // TODO(courbet): Involve the target more in this computation. On X86, 7
-  // bytes can be done more efficiently with two overlaping 4-byte loads than
-  // covering the interval with [{4, 0},{2, 4},{1, 6}}.
+  // When the target allows overlapping loads, the last load may start before
+  // the end of the previous one: 7 bytes can be compared with [{4, 0}, {4, 3}].
   struct LoadEntry {
     LoadEntry(unsigned LoadSize, uint64_t Offset)
-        : LoadSize(LoadSize), Offset(Offset) {
-      assert(Offset % LoadSize == 0 && "invalid load entry");
-    }
-
-    uint64_t getGEPIndex() const { return Offset / LoadSize; }
+        : LoadSize(LoadSize), Offset(Offset) {}
 
     // The size of the load for this block, in bytes.
-    const unsigned LoadSize;
+    unsigned LoadSize;
     // The offset of this load WRT the base pointer, in bytes.
-    const uint64_t Offset;
+    uint64_t Offset;
   };
-  SmallVector<LoadEntry, 8> LoadSequence;
-
+  using LoadEntryVector = SmallVector<LoadEntry, 8>;
+  LoadEntryVector LoadSequence;
+
+  static LoadEntryVector
+  computeGreedyLoadSequence(uint64_t Size, llvm::ArrayRef<unsigned> LoadSizes,
+                            unsigned MaxNumLoads, unsigned &NumLoadsNonOneByte);
+  static LoadEntryVector
+  computeOverlappingLoadSequence(uint64_t Size, unsigned MaxLoadSize,
+                                 unsigned MaxNumLoads,
+                                 unsigned &NumLoadsNonOneByte);
+
+  Value *getPtrToLoad(Value *Source, Type *LoadSizeType, uint64_t Offset);
   void createLoadCmpBlocks();
   void createResultBlock();
   void setupResultBlockPHINodes();
@@ -133,40 +138,136 @@ MemCmpExpansion::MemCmpExpansion(
       Builder(CI) {
   assert(Size > 0 && "zero blocks");
   // Scale the max size down if the target can load more bytes than we need.
-  size_t LoadSizeIndex = 0;
-  while (LoadSizeIndex < Options.LoadSizes.size() &&
-         Options.LoadSizes[LoadSizeIndex] > Size) {
-    ++LoadSizeIndex;
+  llvm::ArrayRef<unsigned> LoadSizes(Options.LoadSizes);
+  while (!LoadSizes.empty() && LoadSizes.front() > Size) {
+    LoadSizes = LoadSizes.drop_front();
   }
-  this->MaxLoadSize = Options.LoadSizes[LoadSizeIndex];
+  assert(!LoadSizes.empty() && "cannot load Size bytes");
+  MaxLoadSize = LoadSizes.front();
   // Compute the decomposition.
-  uint64_t CurSize = Size;
+  unsigned GreedyNumLoadsNonOneByte = 0;
+  LoadSequence = computeGreedyLoadSequence(Size, LoadSizes, MaxNumLoads,
+                                           GreedyNumLoadsNonOneByte);
+  NumLoadsNonOneByte = GreedyNumLoadsNonOneByte;
+  assert(LoadSequence.size() <= MaxNumLoads && "broken invariant");
+  // If we allow overlapping loads and the load sequence is not already optimal,
+  // use overlapping loads.
+  if (Options.AllowOverlappingLoads &&
+      (LoadSequence.empty() || LoadSequence.size() > 2)) {
+    unsigned OverlappingNumLoadsNonOneByte = 0;
+    auto OverlappingLoads = computeOverlappingLoadSequence(
+        Size, MaxLoadSize, MaxNumLoads, OverlappingNumLoadsNonOneByte);
+    if (!OverlappingLoads.empty() &&
+        (LoadSequence.empty() ||
+         OverlappingLoads.size() < LoadSequence.size())) {
+      LoadSequence = OverlappingLoads;
+      NumLoadsNonOneByte = OverlappingNumLoadsNonOneByte;
+    }
+  }
+  assert(LoadSequence.size() <= MaxNumLoads && "broken invariant");
+}
+
+// Cover [0, Size) with non-overlapping loads, largest first. Returns an empty
+// sequence if that takes more than MaxNumLoads loads.
+MemCmpExpansion::LoadEntryVector MemCmpExpansion::computeGreedyLoadSequence(
+    uint64_t Size, llvm::ArrayRef<unsigned> LoadSizes,
+    const unsigned MaxNumLoads, unsigned &NumLoadsNonOneByte) {
+  NumLoadsNonOneByte = 0;
+  LoadEntryVector LoadSequence;
   uint64_t Offset = 0;
-  while (CurSize && LoadSizeIndex < Options.LoadSizes.size()) {
-    const unsigned LoadSize = Options.LoadSizes[LoadSizeIndex];
+  while (Size && !LoadSizes.empty()) {
+    const unsigned LoadSize = LoadSizes.front();
     assert(LoadSize > 0 && "zero load size");
-    const uint64_t NumLoadsForThisSize = CurSize / LoadSize;
+    const uint64_t NumLoadsForThisSize = Size / LoadSize;
     if (LoadSequence.size() + NumLoadsForThisSize > MaxNumLoads) {
       // Do not expand if the total number of loads is larger than what the
       // target allows. Note that it's important that we exit before completing
       // the expansion to avoid using a ton of memory to store the expansion for
       // large sizes.
-      LoadSequence.clear();
-      return;
+      return {};
     }
     if (NumLoadsForThisSize > 0) {
       for (uint64_t I = 0; I < NumLoadsForThisSize; ++I) {
         LoadSequence.push_back({LoadSize, Offset});
         Offset += LoadSize;
       }
-      if (LoadSize > 1) {
+      if (LoadSize > 1)
         ++NumLoadsNonOneByte;
-      }
-      CurSize = CurSize % LoadSize;
+      Size = Size % LoadSize;
     }
-    ++LoadSizeIndex;
+    LoadSizes = LoadSizes.drop_front();
   }
-  assert(LoadSequence.size() <= MaxNumLoads && "broken invariant");
+  return LoadSequence;
+}
+
+// Cover [0, Size) with loads of MaxLoadSize bytes, the last of which ends at
+// Size and overlaps the one before it. Returns an empty sequence if the greedy
+// decomposition needs no tail, or if this takes more than MaxNumLoads loads.
+MemCmpExpansion::LoadEntryVector
+MemCmpExpansion::computeOverlappingLoadSequence(uint64_t Size,
+                                                const unsigned MaxLoadSize,
+                                                const unsigned MaxNumLoads,
+                                                unsigned &NumLoadsNonOneByte) {
+  // These are already handled by the greedy approach.
+  if (Size < 2 || MaxLoadSize < 2)
+    return {};
+
+  // We try to do as many non-overlapping loads as possible starting from the
+  // beginning.
+  const uint64_t NumNonOverlappingLoads = Size / MaxLoadSize;
+  assert(NumNonOverlappingLoads && "there must be at least one load");
+  // There remain 0 to (MaxLoadSize - 1) bytes to load, this will be done with
+  // an overlapping load.
+  Size = Size - NumNonOverlappingLoads * MaxLoadSize;
+  // Bail if we do not need an overlapping load, this is already handled by
+  // the greedy approach.
+  if (Size == 0)
+    return {};
+  // Bail if the number of loads (non-overlapping + overlapping one) is larger
+  // than the max allowed.
+  if ((NumNonOverlappingLoads + 1) > MaxNumLoads)
+    return {};
+
+  // Add non-overlapping loads.
+  LoadEntryVector LoadSequence;
+  uint64_t Offset = 0;
+  for (uint64_t I = 0; I < NumNonOverlappingLoads; ++I) {
+    LoadSequence.push_back({MaxLoadSize, Offset});
+    Offset += MaxLoadSize;
+  }
+
+  // Add the last overlapping load.
+  assert(Size > 0 && Size < MaxLoadSize && "broken invariant");
+  LoadSequence.push_back({MaxLoadSize, Offset - (MaxLoadSize - Size)});
+  NumLoadsNonOneByte = 1;
+  return LoadSequence;
+}
+
+// Return a pointer to the LoadSizeType value at byte offset Offset of Source.
+// Offsets that are a multiple of the load size are indexed in units of
+// LoadSizeType; the tail load of an overlapping sequence is addressed in
+// bytes.
+Value *MemCmpExpansion::getPtrToLoad(Value *Source, Type *LoadSizeType,
+                                     uint64_t Offset) {
+  const uint64_t LoadSize = DL.getTypeStoreSize(LoadSizeType);
+  if (Offset % LoadSize != 0) {
+    Type *ByteType = Builder.getInt8Ty();
+    if (Source->getType() != ByteType->getPointerTo())
+      Source = Builder.CreateBitCast(Source, ByteType->getPointerTo());
+    Source = Builder.CreateGEP(ByteType, Source,
+                               ConstantInt::get(Builder.getInt64Ty(), Offset));
+    return Builder.CreateBitCast(Source, LoadSizeType->getPointerTo());
+  }
+
+  // Cast source to LoadSizeType*.
+  if (Source->getType() != LoadSizeType)
+    Source = Builder.CreateBitCast(Source, LoadSizeType->getPointerTo());
+
+  // Get the base address using a GEP.
+  if (Offset != 0)
+    Source = Builder.CreateGEP(
+        LoadSizeType, Source, ConstantInt::get(LoadSizeType, Offset / LoadSize));
+  return Source;
 }
 
 unsigned MemCmpExpansion::getNumBlocks() {
@@ -270,24 +371,10 @@ Value *MemCmpExpansion::getCompareLoadPairs(unsigned BlockIndex,
     IntegerType *LoadSizeType =
         IntegerType::get(CI->getContext(), CurLoadEntry.LoadSize * 8);
 
-    Value *Source1 = CI->getArgOperand(0);
-    Value *Source2 = CI->getArgOperand(1);
-
-    // Cast source to LoadSizeType*.
-    if (Source1->getType() != LoadSizeType)
-      Source1 = Builder.CreateBitCast(Source1, LoadSizeType->getPointerTo());
-    if (Source2->getType() != LoadSizeType)
-      Source2 = Builder.CreateBitCast(Source2, LoadSizeType->getPointerTo());
-
-    // Get the base address using a GEP.
-    if (CurLoadEntry.Offset != 0) {
-      Source1 = Builder.CreateGEP(
-          LoadSizeType, Source1,
-          ConstantInt::get(LoadSizeType, CurLoadEntry.getGEPIndex()));
-      Source2 = Builder.CreateGEP(
-          LoadSizeType, Source2,
-          ConstantInt::get(LoadSizeType, CurLoadEntry.getGEPIndex()));
-    }
+    Value *Source1 = getPtrToLoad(CI->getArgOperand(0), LoadSizeType,
+                                  CurLoadEntry.Offset);
+    Value *Source2 = getPtrToLoad(CI->getArgOperand(1), LoadSizeType,
+                                  CurLoadEntry.Offset);
 
     // Get a constant or load a value for each source address.
     Value *LoadSrc1 = nullptr;
@@ -379,7 +466,7 @@ void MemCmpExpansion::emitLoadCompareBlock(unsigned BlockIndex) {
 
   if (CurLoadEntry.LoadSize == 1) {
     MemCmpExpansion::emitLoadCompareByteBlock(BlockIndex,
-                                              CurLoadEntry.getGEPIndex());
+                                              CurLoadEntry.Offset);
     return;
   }
 
@@ -388,25 +475,11 @@ void MemCmpExpansion::emitLoadCompareBlock(unsigned BlockIndex) {
   Type *MaxLoadType = IntegerType::get(CI->getContext(), MaxLoadSize * 8);
   assert(CurLoadEntry.LoadSize <= MaxLoadSize && "Unexpected load type");
 
-  Value *Source1 = CI->getArgOperand(0);
-  Value *Source2 = CI->getArgOperand(1);
-
   Builder.SetInsertPoint(LoadCmpBlocks[BlockIndex]);
-  // Cast source to LoadSizeType*.
-  if (Source1->getType() != LoadSizeType)
-    Source1 = Builder.CreateBitCast(Source1, LoadSizeType->getPointerTo());
-  if (Source2->getType() != LoadSizeType)
-    Source2 = Builder.CreateBitCast(Source2, LoadSizeType->getPointerTo());
-
-  // Get the base address using a GEP.
-  if (CurLoadEntry.Offset != 0) {
-    Source1 = Builder.CreateGEP(
-        LoadSizeType, Source1,
-        ConstantInt::get(LoadSizeType, CurLoadEntry.getGEPIndex()));
-    Source2 = Builder.CreateGEP(
-        LoadSizeType, Source2,
-        ConstantInt::get(LoadSizeType, CurLoadEntry.getGEPIndex()));
-  }
+  Value *Source1 = getPtrToLoad(CI->getArgOperand(0), LoadSizeType,
+                                CurLoadEntry.Offset);
+  Value *Source2 = getPtrToLoad(CI->getArgOperand(1), LoadSizeType,
+                                CurLoadEntry.Offset);
 
   // Load LoadSizeType from the base address.
   Value *LoadSrc1 = Builder.CreateLoad(LoadSizeType, Source1);
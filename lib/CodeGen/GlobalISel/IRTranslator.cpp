@@ -19,6 +19,7 @@
 #include "llvm/Analysis/OptimizationRemarkEmitter.h"
 #include "llvm/CodeGen/Analysis.h"
 #include "llvm/CodeGen/GlobalISel/CallLowering.h"
+#include "llvm/CodeGen/GlobalISelReport.h"
 #include "llvm/CodeGen/LowLevelType.h"
 #include "llvm/CodeGen/MachineBasicBlock.h"
 #include "llvm/CodeGen/MachineFrameInfo.h"
@@ -96,8 +97,10 @@ static void reportTranslationError(MachineFunction &MF,
 
   if (TPC.isGlobalISelAbortEnabled())
     report_fatal_error(R.getMsg());
-  else
-    ORE.emit(R);
+
+  if (auto *Report = TPC.getAnalysisIfAvailable<GlobalISelReport>())
+    Report->recordFailure(MF, R.getPassName(), R.getMsg());
+  ORE.emit(R);
 }
 
 IRTranslator::IRTranslator() : MachineFunctionPass(ID) {
@@ -1685,6 +1688,8 @@ bool IRTranslator::runOnMachineFunction(MachineFunction &CurMF) {
   const Function &F = MF->getFunction();
   if (F.empty())
     return false;
+  if (auto *Report = getAnalysisIfAvailable<GlobalISelReport>())
+    Report->startFunction(CurMF);
   CLI = MF->getSubtarget().getCallLowering();
   CurBuilder.setMF(*MF);
   EntryBuilder.setMF(*MF);
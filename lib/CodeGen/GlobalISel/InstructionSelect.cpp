@@ -95,6 +95,8 @@ bool InstructionSelect::runOnMachineFunction(MachineFunction &MF) {
   // Until then, keep track of the number of blocks to assert that we don't.
   const size_t NumBlocks = MF.size();
 
+  ISel->setupMF(MF);
+
   for (MachineBasicBlock *MBB : post_order(&MF)) {
     if (MBB->empty())
       continue;
@@ -223,7 +225,8 @@ bool InstructionSelect::runOnMachineFunction(MachineFunction &MF) {
   LLVM_DEBUG({
     dbgs() << "Rules covered by selecting function: " << MF.getName() << ":";
     for (auto RuleID : CoverageInfo.covered())
-      dbgs() << " id" << RuleID;
+      dbgs() << " id" << RuleID << "(x" << CoverageInfo.getHitCount(RuleID)
+             << ")";
     dbgs() << "\n\n";
   });
   CoverageInfo.emit(CoveragePrefix,
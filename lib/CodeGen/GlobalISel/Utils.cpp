@@ -14,6 +14,7 @@
 #include "llvm/ADT/APFloat.h"
 #include "llvm/ADT/Twine.h"
 #include "llvm/CodeGen/GlobalISel/RegisterBankInfo.h"
+#include "llvm/CodeGen/GlobalISelReport.h"
 #include "llvm/CodeGen/MachineInstr.h"
 #include "llvm/CodeGen/MachineInstrBuilder.h"
 #include "llvm/CodeGen/MachineOptimizationRemarkEmitter.h"
@@ -165,8 +166,10 @@ void llvm::reportGISelFailure(MachineFunction &MF, const TargetPassConfig &TPC,
 
   if (TPC.isGlobalISelAbortEnabled())
     report_fatal_error(R.getMsg());
-  else
-    MORE.emit(R);
+
+  if (auto *Report = TPC.getAnalysisIfAvailable<GlobalISelReport>())
+    Report->recordFailure(MF, R.getPassName(), R.getMsg());
+  MORE.emit(R);
 }
 
 void llvm::reportGISelFailure(MachineFunction &MF, const TargetPassConfig &TPC,
@@ -0,0 +1,113 @@
+//===-- GlobalISelReport.cpp - GlobalISel fallback report ----------------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+/// \file
+/// This file implements the report written with -global-isel-report.
+//===----------------------------------------------------------------------===//
+
+#include "llvm/CodeGen/GlobalISelReport.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/CodeGen/MachineFunction.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/FormatVariadic.h"
+#include "llvm/Support/JSON.h"
+#include "llvm/Support/Timer.h"
+#include "llvm/Support/raw_ostream.h"
+#include <vector>
+
+using namespace llvm;
+
+char GlobalISelReport::ID = 0;
+INITIALIZE_PASS(GlobalISelReport, "global-isel-report-info",
+                "GlobalISel Fallback Report", false, true)
+
+GlobalISelReport::GlobalISelReport(StringRef Path)
+    : ImmutablePass(ID), Path(Path) {
+  initializeGlobalISelReportPass(*PassRegistry::getPassRegistry());
+}
+
+ImmutablePass *llvm::createGlobalISelReportPass(StringRef Path) {
+  return new GlobalISelReport(Path);
+}
+
+static double getWallTime() {
+  return TimeRecord::getCurrentTime(/*Start=*/true).getWallTime();
+}
+
+void GlobalISelReport::startFunction(const MachineFunction &MF) {
+  FunctionStats &Stats = Functions[MF.getName()];
+  Stats = FunctionStats();
+  Stats.StartTime = getWallTime();
+}
+
+void GlobalISelReport::recordFailure(const MachineFunction &MF,
+                                     StringRef PassName, StringRef Reason) {
+  FunctionStats &Stats = Functions[MF.getName()];
+  if (Stats.FellBack)
+    return;
+  Stats.FellBack = true;
+  Stats.PassName = PassName;
+  Stats.Reason = Reason;
+}
+
+void GlobalISelReport::finishFunction(const MachineFunction &MF) {
+  auto It = Functions.find(MF.getName());
+  if (It != Functions.end())
+    It->second.Time = getWallTime() - It->second.StartTime;
+}
+
+bool GlobalISelReport::doFinalization(Module &M) {
+  if (!Path.empty() && !Functions.empty()) {
+    if (Error E = writeToFile(Path))
+      M.getContext().emitError(toString(std::move(E)));
+  }
+  Functions.clear();
+  return false;
+}
+
+Error GlobalISelReport::writeToFile(StringRef Path) const {
+  std::error_code EC;
+  raw_fd_ostream OS(Path, EC, sys::fs::F_Text);
+  if (EC)
+    return createFileError(Path, errorCodeToError(EC));
+
+  // Sort by name to keep the output deterministic.
+  std::vector<const StringMapEntry<FunctionStats> *> Entries;
+  for (auto &E : Functions)
+    Entries.push_back(&E);
+  llvm::sort(Entries, [](const StringMapEntry<FunctionStats> *A,
+                         const StringMapEntry<FunctionStats> *B) {
+    return A->getKey() < B->getKey();
+  });
+
+  json::Array FnArray;
+  unsigned NumFallbacks = 0;
+  double TotalTime = 0;
+  for (auto *E : Entries) {
+    const FunctionStats &Stats = E->getValue();
+    json::Object Fn{{"name", E->getKey()},
+                    {"fallback", Stats.FellBack},
+                    {"time_ms", Stats.Time * 1000}};
+    if (Stats.FellBack) {
+      Fn["pass"] = Stats.PassName;
+      Fn["reason"] = Stats.Reason;
+      ++NumFallbacks;
+    }
+    TotalTime += Stats.Time;
+    FnArray.push_back(std::move(Fn));
+  }
+
+  json::Object Report{{"functions", std::move(FnArray)},
+                      {"num_fallbacks", NumFallbacks},
+                      {"num_functions", int64_t(Entries.size())},
+                      {"total_time_ms", TotalTime * 1000}};
+  OS << formatv("{0:2}", json::Value(std::move(Report))) << '\n';
+  return Error::success();
+}
@@ -357,7 +357,13 @@ LiveRange::iterator LiveRange::find(SlotIndex Pos) {
   if (empty() || Pos >= endIndex())
     return end();
   iterator I = begin();
-  size_t Len = size();
+  // Interference and overlap queries usually start at the beginning of one of
+  // the ranges, check the first segment before searching. Every SlotIndex
+  // comparison has to load the index list entries of both operands.
+  if (Pos < I->end)
+    return I;
+  ++I;
+  size_t Len = size() - 1;
   do {
     size_t Mid = Len >> 1;
     if (Pos < I[Mid].end) {
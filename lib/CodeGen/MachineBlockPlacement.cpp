@@ -79,6 +79,8 @@ STATISTIC(CondBranchTakenFreq,
           "Potential frequency of taking conditional branches");
 STATISTIC(UncondBranchTakenFreq,
           "Potential frequency of taking unconditional branches");
+STATISTIC(NumExtTspLayouts,
+          "Number of functions reordered for the extended TSP objective");
 
 static cl::opt<unsigned> AlignAllBlock("align-all-blocks",
                                        cl::desc("Force the alignment of all "
@@ -182,6 +184,19 @@ static cl::opt<unsigned> TriangleChainCount(
     cl::init(2),
     cl::Hidden);
 
+static cl::opt<bool> EnableExtTspBlockPlacement(
+    "enable-ext-tsp-block-placement",
+    cl::desc("Reorder the blocks of functions with profile data to maximize "
+             "the extended TSP score of the layout. Functions with the "
+             "\"ext-tsp-block-placement\" attribute are always reordered."),
+    cl::init(false), cl::Hidden);
+
+static cl::opt<unsigned> ExtTspBlockPlacementMaxBlocks(
+    "ext-tsp-block-placement-max-blocks",
+    cl::desc("Maximum number of blocks in a function reordered for the "
+             "extended TSP objective."),
+    cl::init(1000), cl::Hidden);
+
 extern cl::opt<unsigned> StaticLikelyProb;
 extern cl::opt<unsigned> ProfileLikelyProb;
 
@@ -292,6 +307,13 @@ public:
     }
   }
 
+  /// Replace the sequence of blocks in this chain with \p NewBlocks, which
+  /// must be a permutation of them.
+  void reorder(ArrayRef<MachineBasicBlock *> NewBlocks) {
+    assert(NewBlocks.size() == Blocks.size() && "Not a permutation.");
+    Blocks.assign(NewBlocks.begin(), NewBlocks.end());
+  }
+
 #ifndef NDEBUG
   /// Dump the blocks in this chain.
   LLVM_DUMP_METHOD void dump() {
@@ -312,6 +334,262 @@ public:
   unsigned UnscheduledPredecessors = 0;
 };
 
+/// A block layout that maximizes the extended TSP score.
+///
+/// The score of a layout is the weight of every edge whose destination
+/// directly follows its source, plus a fraction of the weight of every short
+/// forward or backward jump that decreases linearly with the jump distance.
+/// Nodes are numbered in the order of an initial layout that starts with the
+/// entry node. Starting from chains of the nodes that must stay together, the
+/// pair of chains whose merge increases the score the most is merged until no
+/// merge improves it. A merge either concatenates the two chains or inserts
+/// one of them into a split point of the other.
+class ExtTspLayout {
+  /// Maximum distance in bytes of a forward jump that contributes to the
+  /// score.
+  static constexpr uint64_t ForwardDistance = 1024;
+  /// Maximum distance in bytes of a backward jump that contributes to the
+  /// score.
+  static constexpr uint64_t BackwardDistance = 640;
+  /// Fraction of the weight of a jump of distance zero that is scored.
+  static constexpr double JumpWeight = 0.1;
+  /// Chains longer than this are not split to insert another chain.
+  static constexpr unsigned SplitThreshold = 128;
+
+  enum MergeKind { MergeXY, MergeYX, MergeX1YX2 };
+
+  struct MergeResult {
+    double Gain = 0;
+    MergeKind Kind = MergeXY;
+    /// The position in X at which Y is inserted for MergeX1YX2.
+    unsigned Split = 0;
+  };
+
+  struct Chain {
+    std::vector<unsigned> Nodes;
+    uint64_t Size = 0;
+    uint64_t Freq = 0;
+    double Score = 0;
+  };
+
+  std::vector<uint64_t> Sizes;
+  std::vector<uint64_t> Freqs;
+  /// Whether a node must directly precede the next node in the initial
+  /// layout.
+  std::vector<bool> GlueWithNext;
+  std::vector<SmallVector<std::pair<unsigned, uint64_t>, 2>> Succs;
+  std::vector<SmallVector<unsigned, 2>> Preds;
+
+  std::vector<Chain> Chains;
+  std::vector<unsigned> NodeToChain;
+  /// Whether a chain may be split before a node.
+  std::vector<bool> CanSplitBefore;
+
+  /// Scratch space for score().
+  std::vector<uint64_t> Addr;
+  std::vector<unsigned> Stamp;
+  unsigned CurStamp = 0;
+
+  static double edgeScore(uint64_t SrcEnd, uint64_t DstAddr, uint64_t Weight) {
+    if (SrcEnd == DstAddr)
+      return Weight;
+    if (SrcEnd < DstAddr) {
+      uint64_t Dist = DstAddr - SrcEnd;
+      if (Dist >= ForwardDistance)
+        return 0;
+      return JumpWeight * Weight * (1.0 - double(Dist) / ForwardDistance);
+    }
+    uint64_t Dist = SrcEnd - DstAddr;
+    if (Dist >= BackwardDistance)
+      return 0;
+    return JumpWeight * Weight * (1.0 - double(Dist) / BackwardDistance);
+  }
+
+  /// Return the score of the edges between the nodes of the concatenation of
+  /// \p Parts.
+  double score(ArrayRef<ArrayRef<unsigned>> Parts) {
+    ++CurStamp;
+    uint64_t Offset = 0;
+    for (ArrayRef<unsigned> Part : Parts)
+      for (unsigned N : Part) {
+        Addr[N] = Offset;
+        Stamp[N] = CurStamp;
+        Offset += Sizes[N];
+      }
+    double Score = 0;
+    for (ArrayRef<unsigned> Part : Parts)
+      for (unsigned N : Part)
+        for (const auto &E : Succs[N])
+          if (Stamp[E.first] == CurStamp)
+            Score += edgeScore(Addr[N] + Sizes[N], Addr[E.first], E.second);
+    return Score;
+  }
+
+  /// Find the best way to merge chain \p Y into chain \p X. The first node of
+  /// chain 0 is the entry, which must stay in front.
+  MergeResult evaluateMerge(unsigned X, unsigned Y) {
+    ArrayRef<unsigned> XNodes = Chains[X].Nodes, YNodes = Chains[Y].Nodes;
+    double Base = Chains[X].Score + Chains[Y].Score;
+    MergeResult Best;
+    Best.Gain = score({XNodes, YNodes}) - Base;
+    if (X != 0) {
+      double Gain = score({YNodes, XNodes}) - Base;
+      if (Gain > Best.Gain) {
+        Best.Gain = Gain;
+        Best.Kind = MergeYX;
+      }
+    }
+    if (XNodes.size() > SplitThreshold)
+      return Best;
+    for (unsigned I = 1, E = XNodes.size(); I != E; ++I) {
+      if (!CanSplitBefore[XNodes[I]])
+        continue;
+      double Gain =
+          score({XNodes.take_front(I), YNodes, XNodes.drop_front(I)}) - Base;
+      if (Gain > Best.Gain) {
+        Best.Gain = Gain;
+        Best.Kind = MergeX1YX2;
+        Best.Split = I;
+      }
+    }
+    return Best;
+  }
+
+  void mergeChains(unsigned X, unsigned Y, const MergeResult &R) {
+    Chain &CX = Chains[X], &CY = Chains[Y];
+    std::vector<unsigned> Nodes;
+    Nodes.reserve(CX.Nodes.size() + CY.Nodes.size());
+    switch (R.Kind) {
+    case MergeXY:
+      Nodes = CX.Nodes;
+      Nodes.insert(Nodes.end(), CY.Nodes.begin(), CY.Nodes.end());
+      break;
+    case MergeYX:
+      Nodes = CY.Nodes;
+      Nodes.insert(Nodes.end(), CX.Nodes.begin(), CX.Nodes.end());
+      break;
+    case MergeX1YX2:
+      Nodes.assign(CX.Nodes.begin(), CX.Nodes.begin() + R.Split);
+      Nodes.insert(Nodes.end(), CY.Nodes.begin(), CY.Nodes.end());
+      Nodes.insert(Nodes.end(), CX.Nodes.begin() + R.Split, CX.Nodes.end());
+      break;
+    }
+    for (unsigned N : CY.Nodes)
+      NodeToChain[N] = X;
+    CX.Nodes = std::move(Nodes);
+    CX.Size += CY.Size;
+    CX.Freq += CY.Freq;
+    CX.Score += CY.Score + R.Gain;
+    CY.Nodes.clear();
+  }
+
+public:
+  explicit ExtTspLayout(unsigned NumNodes)
+      : Sizes(NumNodes), Freqs(NumNodes), GlueWithNext(NumNodes),
+        Succs(NumNodes), Preds(NumNodes), NodeToChain(NumNodes),
+        CanSplitBefore(NumNodes), Addr(NumNodes), Stamp(NumNodes) {}
+
+  /// Set the size in bytes and the execution frequency of node \p N. If
+  /// \p Glue is set, \p N always directly precedes node N + 1.
+  void setNode(unsigned N, uint64_t Size, uint64_t Freq, bool Glue) {
+    Sizes[N] = std::max<uint64_t>(Size, 1);
+    Freqs[N] = Freq;
+    GlueWithNext[N] = Glue;
+  }
+
+  void addEdge(unsigned Src, unsigned Dst, uint64_t Weight) {
+    if (!Weight)
+      return;
+    Succs[Src].push_back({Dst, Weight});
+    Preds[Dst].push_back(Src);
+  }
+
+  /// Compute the layout in \p Order. Returns false if it does not score
+  /// better than the initial layout.
+  bool run(SmallVectorImpl<unsigned> &Order) {
+    unsigned NumNodes = Sizes.size();
+    std::vector<unsigned> Initial(NumNodes);
+    for (unsigned N = 0; N != NumNodes; ++N)
+      Initial[N] = N;
+    double InitialScore = score(makeArrayRef(Initial));
+
+    for (unsigned N = 0; N != NumNodes; ++N) {
+      CanSplitBefore[N] = N == 0 || !GlueWithNext[N - 1];
+      if (CanSplitBefore[N])
+        Chains.emplace_back();
+      Chain &C = Chains.back();
+      C.Nodes.push_back(N);
+      C.Size += Sizes[N];
+      C.Freq += Freqs[N];
+      NodeToChain[N] = Chains.size() - 1;
+    }
+    for (unsigned I = 0, E = Chains.size(); I != E; ++I)
+      Chains[I].Score = score(makeArrayRef(Chains[I].Nodes));
+
+    // Merge gains only change when one of the chains changes, so they are
+    // cached by chain pair, with the lower chain id first.
+    DenseMap<std::pair<unsigned, unsigned>, MergeResult> Gains;
+    SmallVector<unsigned, 8> Adjacent;
+    while (true) {
+      MergeResult Best;
+      unsigned BestX = 0, BestY = 0;
+      for (unsigned X = 0, E = Chains.size(); X != E; ++X) {
+        if (Chains[X].Nodes.empty())
+          continue;
+        Adjacent.clear();
+        for (unsigned N : Chains[X].Nodes) {
+          for (const auto &Succ : Succs[N])
+            Adjacent.push_back(NodeToChain[Succ.first]);
+          for (unsigned Pred : Preds[N])
+            Adjacent.push_back(NodeToChain[Pred]);
+        }
+        llvm::sort(Adjacent);
+        Adjacent.erase(std::unique(Adjacent.begin(), Adjacent.end()),
+                       Adjacent.end());
+        for (unsigned Y : Adjacent) {
+          if (Y <= X)
+            continue;
+          auto It = Gains.find({X, Y});
+          if (It == Gains.end())
+            It = Gains.insert({{X, Y}, evaluateMerge(X, Y)}).first;
+          if (It->second.Gain > Best.Gain) {
+            Best = It->second;
+            BestX = X;
+            BestY = Y;
+          }
+        }
+      }
+      if (BestX == BestY)
+        break;
+
+      mergeChains(BestX, BestY, Best);
+      for (auto It = Gains.begin(), E = Gains.end(); It != E; ++It) {
+        unsigned X = It->first.first, Y = It->first.second;
+        if (X == BestX || X == BestY || Y == BestX || Y == BestY)
+          Gains.erase(It);
+      }
+    }
+
+    // Keep the entry chain first and order the remaining chains by
+    // decreasing execution density.
+    SmallVector<unsigned, 16> Remaining;
+    for (unsigned I = 1, E = Chains.size(); I != E; ++I)
+      if (!Chains[I].Nodes.empty())
+        Remaining.push_back(I);
+    std::stable_sort(Remaining.begin(), Remaining.end(),
+                     [&](unsigned A, unsigned B) {
+                       return double(Chains[A].Freq) * Chains[B].Size >
+                              double(Chains[B].Freq) * Chains[A].Size;
+                     });
+
+    Order.clear();
+    Order.append(Chains[0].Nodes.begin(), Chains[0].Nodes.end());
+    for (unsigned I : Remaining)
+      Order.append(Chains[I].Nodes.begin(), Chains[I].Nodes.end());
+    return score(makeArrayRef(Order)) > InitialScore;
+  }
+};
+
 class MachineBlockPlacement : public MachineFunctionPass {
   /// A type for a block filter set.
   using BlockFilterSet = SmallSetVector<const MachineBasicBlock *, 16>;
@@ -362,6 +640,10 @@ class MachineBlockPlacement : public MachineFunctionPass {
   /// A handle to the post dominator tree.
   MachinePostDominatorTree *MPDT;
 
+  /// Whether the final function chain is reordered for the extended TSP
+  /// objective.
+  bool UseExtTspLayout = false;
+
   /// Duplicator used to duplicate tails during placement.
   ///
   /// Placement decisions can open up new tail duplication opportunities, but
@@ -465,6 +747,7 @@ class MachineBlockPlacement : public MachineFunctionPass {
       BlockChain &LoopChain, const MachineLoop &L,
       const BlockFilterSet &LoopBlockSet);
   void buildCFGChains();
+  void applyExtTspLayout(BlockChain &FunctionChain);
   void optimizeBranches();
   void alignBlocks();
   /// Returns true if a block should be tail-duplicated to increase fallthrough
@@ -2359,6 +2642,8 @@ void MachineBlockPlacement::buildCFGChains() {
 
   BlockChain &FunctionChain = *BlockToChain[&F->front()];
   buildChain(&F->front(), FunctionChain);
+  if (UseExtTspLayout)
+    applyExtTspLayout(FunctionChain);
 
 #ifndef NDEBUG
   using FunctionBlockSetType = SmallPtrSet<MachineBasicBlock *, 16>;
@@ -2457,6 +2742,58 @@ void MachineBlockPlacement::buildCFGChains() {
   EHPadWorkList.clear();
 }
 
+/// Reorder the blocks of \p FunctionChain to maximize the extended TSP score
+/// of the layout, using the chain-based layout as the initial order.
+void MachineBlockPlacement::applyExtTspLayout(BlockChain &FunctionChain) {
+  SmallVector<MachineBasicBlock *, 16> Blocks(FunctionChain.begin(),
+                                              FunctionChain.end());
+  DenseMap<const MachineBasicBlock *, unsigned> BlockIndex;
+  for (unsigned I = 0, E = Blocks.size(); I != E; ++I)
+    BlockIndex[Blocks[I]] = I;
+
+  ExtTspLayout Layout(Blocks.size());
+  SmallVector<MachineOperand, 4> Cond; // For AnalyzeBranch.
+  for (unsigned I = 0, E = Blocks.size(); I != E; ++I) {
+    MachineBasicBlock *MBB = Blocks[I];
+    // Targets that do not report instruction sizes get a nominal size for
+    // every instruction.
+    uint64_t Size = 0;
+    for (const MachineInstr &MI : *MBB) {
+      if (MI.isMetaInstruction())
+        continue;
+      unsigned InstSize = TII->getInstSizeInBytes(MI);
+      Size += InstSize ? InstSize : 4;
+    }
+
+    // Blocks with an unanalyzable fallthrough were merged with their layout
+    // successor when the chains were built, and must stay in front of it.
+    Cond.clear();
+    MachineBasicBlock *TBB = nullptr, *FBB = nullptr; // For AnalyzeBranch.
+    bool Glue = I + 1 != E && TII->analyzeBranch(*MBB, TBB, FBB, Cond) &&
+                MBB->canFallThrough();
+    BlockFrequency Freq = MBFI->getBlockFreq(MBB);
+    Layout.setNode(I, Size, Freq.getFrequency(), Glue);
+
+    for (MachineBasicBlock *Succ : MBB->successors()) {
+      auto It = BlockIndex.find(Succ);
+      if (It != BlockIndex.end())
+        Layout.addEdge(I, It->second,
+                       (Freq * MBPI->getEdgeProbability(MBB, Succ))
+                           .getFrequency());
+    }
+  }
+
+  SmallVector<unsigned, 16> Order;
+  if (!Layout.run(Order))
+    return;
+
+  SmallVector<MachineBasicBlock *, 16> NewBlocks;
+  for (unsigned I : Order)
+    NewBlocks.push_back(Blocks[I]);
+  FunctionChain.reorder(NewBlocks);
+  ++NumExtTspLayouts;
+}
+
 void MachineBlockPlacement::optimizeBranches() {
   BlockChain &FunctionChain = *BlockToChain[&F->front()];
   SmallVector<MachineOperand, 4> Cond; // For AnalyzeBranch.
@@ -2744,6 +3081,12 @@ bool MachineBlockPlacement::runOnMachineFunction(MachineFunction &MF) {
   TLI = MF.getSubtarget().getTargetLowering();
   MPDT = nullptr;
 
+  const Function &Fn = MF.getFunction();
+  UseExtTspLayout = (Fn.hasFnAttribute("ext-tsp-block-placement") ||
+                     (EnableExtTspBlockPlacement && Fn.hasProfileData())) &&
+                    !MF.getTarget().requiresStructuredCFG() &&
+                    MF.size() <= ExtTspBlockPlacementMaxBlocks;
+
   // Initialize PreferredLoopExit to nullptr here since it may never be set if
   // there are no MachineLoops.
   PreferredLoopExit = nullptr;
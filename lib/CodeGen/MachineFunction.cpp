@@ -218,6 +218,7 @@ void MachineFunction::clear() {
     I->Insts.clearAndLeakNodesUnsafely();
   MBBNumbering.clear();
 
+  MemOperandAliasCache.clear();
   InstructionRecycler.clear(Allocator);
   OperandRecycler.clear(Allocator);
   BasicBlockRecycler.clear(Allocator);
@@ -886,8 +886,8 @@ MachineLICMBase::calcRegisterCost(const MachineInstr *MI, bool ConsiderSeen,
   return Cost;
 }
 
-/// Return true if this machine instruction loads from global offset table or
-/// constant pool.
+/// Return true if this machine instruction loads from global offset table,
+/// Pagerando page offset table or constant pool.
 static bool mayLoadFromGOTOrConstantPool(MachineInstr &MI) {
   assert(MI.mayLoad() && "Expected MI that loads!");
 
@@ -898,7 +898,7 @@ static bool mayLoadFromGOTOrConstantPool(MachineInstr &MI) {
 
   for (MachineMemOperand *MemOp : MI.memoperands())
     if (const PseudoSourceValue *PSV = MemOp->getPseudoValue())
-      if (PSV->isGOT() || PSV->isConstantPool())
+      if (PSV->isGOT() || PSV->isPOT() || PSV->isConstantPool())
         return true;
 
   return false;
@@ -72,6 +72,7 @@
 #include "llvm/Support/Allocator.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/raw_ostream.h"
 #include <functional>
 #include <map>
@@ -99,6 +100,16 @@ static cl::opt<bool> EnableLinkOnceODROutlining(
     cl::desc("Enable the machine outliner on linkonceodr functions"),
     cl::init(false));
 
+// Split the instruction mapping into shards of about this many instructions,
+// each with its own suffix tree. The trees are built in parallel and bound the
+// memory needed for huge modules, at the cost of missing sequences that occur
+// only once per shard.
+static cl::opt<unsigned> OutlinerShardSize(
+    "outliner-shard-size", cl::Hidden,
+    cl::desc("Build a separate suffix tree for every N mapped instructions "
+             "(0 = one tree for the whole module)"),
+    cl::init(0));
+
 namespace {
 
 /// Represents an undefined index in the suffix tree.
@@ -469,7 +480,7 @@ public:
   /// Construct a suffix tree from a sequence of unsigned integers.
   ///
   /// \param Str The string to construct the suffix tree for.
-  SuffixTree(const std::vector<unsigned> &Str) : Str(Str) {
+  SuffixTree(ArrayRef<unsigned> Str) : Str(Str) {
     Root = insertInternalNode(nullptr, EmptyIdx, EmptyIdx, 0);
     Active.Node = Root;
 
@@ -1006,18 +1017,81 @@ void MachineOutliner::emitOutlinedFunctionRemark(OutlinedFunction &OF) {
   MORE.emit(R);
 }
 
+/// Append the repeated substrings of \p Str to \p Result, with
+/// start indices offset by \p Offset.
+static void
+collectRepeatedSubstrings(ArrayRef<unsigned> Str, unsigned Offset,
+                          std::vector<SuffixTree::RepeatedSubstring> &Result) {
+  SuffixTree ST(Str);
+  for (auto It = ST.begin(), Et = ST.end(); It != Et; ++It) {
+    Result.push_back(*It);
+    for (unsigned &StartIdx : Result.back().StartIndices)
+      StartIdx += Offset;
+  }
+}
+
+/// Find the repeated substrings of the module mapping. With
+/// -outliner-shard-size, the mapping is split after instructions that cannot
+/// be outlined, so no sequence crosses a shard boundary. The shards are
+/// searched in parallel and occurrences of the same sequence in different
+/// shards are merged.
+static std::vector<SuffixTree::RepeatedSubstring>
+findRepeatedSubstrings(const InstructionMapper &Mapper) {
+  ArrayRef<unsigned> Str = Mapper.UnsignedVec;
+  std::vector<SuffixTree::RepeatedSubstring> Result;
+  if (!OutlinerShardSize || Str.size() <= OutlinerShardSize) {
+    collectRepeatedSubstrings(Str, 0, Result);
+    return Result;
+  }
+
+  std::vector<std::pair<unsigned, unsigned>> Shards;
+  unsigned Begin = 0;
+  for (unsigned I = 0, E = Str.size(); I != E; ++I) {
+    if (I + 1 - Begin >= OutlinerShardSize &&
+        Str[I] >= Mapper.LegalInstrNumber) {
+      Shards.emplace_back(Begin, I + 1);
+      Begin = I + 1;
+    }
+  }
+  if (Begin != Str.size())
+    Shards.emplace_back(Begin, Str.size());
+
+  std::vector<std::vector<SuffixTree::RepeatedSubstring>> ShardResults(
+      Shards.size());
+  parallel::for_each_n(parallel::par, size_t(0), Shards.size(), [&](size_t I) {
+    unsigned ShardBegin = Shards[I].first, ShardEnd = Shards[I].second;
+    collectRepeatedSubstrings(Str.slice(ShardBegin, ShardEnd - ShardBegin),
+                              ShardBegin, ShardResults[I]);
+  });
+
+  // Merge in shard order to keep the result deterministic.
+  DenseMap<ArrayRef<unsigned>, unsigned> SeqToResult;
+  for (auto &ShardResult : ShardResults) {
+    for (auto &RS : ShardResult) {
+      ArrayRef<unsigned> Seq = Str.slice(RS.StartIndices.front(), RS.Length);
+      auto Ins = SeqToResult.insert(std::make_pair(Seq, Result.size()));
+      if (Ins.second) {
+        Result.push_back(std::move(RS));
+        continue;
+      }
+      auto &StartIndices = Result[Ins.first->second].StartIndices;
+      StartIndices.insert(StartIndices.end(), RS.StartIndices.begin(),
+                          RS.StartIndices.end());
+    }
+  }
+  return Result;
+}
+
 void
 MachineOutliner::findCandidates(InstructionMapper &Mapper,
                                 std::vector<OutlinedFunction> &FunctionList) {
   FunctionList.clear();
-  SuffixTree ST(Mapper.UnsignedVec);
 
   // First, find dall of the repeated substrings in the tree of minimum length
   // 2.
   std::vector<Candidate> CandidatesForRepeatedSeq;
-  for (auto It = ST.begin(), Et = ST.end(); It != Et; ++It) {
+  for (SuffixTree::RepeatedSubstring &RS : findRepeatedSubstrings(Mapper)) {
     CandidatesForRepeatedSeq.clear();
-    SuffixTree::RepeatedSubstring RS = *It;
     unsigned StringLen = RS.Length;
     for (const unsigned &StartIdx : RS.StartIndices) {
       unsigned EndIdx = StartIdx + StringLen - 1;
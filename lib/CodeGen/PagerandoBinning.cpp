@@ -9,11 +9,22 @@
 //
 // This pass assigns Pagerando-enabled functions to bins. Normal functions
 // (and currently also Pagerando wrappers) are not assigned to a bin. The bin
-// size is 4KB.
+// size is configured via TargetOptions::PagerandoBinSize (-pagerando-bin-size)
+// and defaults to 4KB. Systems with larger pages, e.g., AArch64 kernels with
+// 16KB or 64KB pages, use bins of the page size, which also reduces the number
+// of POT entries and their dynamic relocations.
 // Function sizes are estimated by adding up the size of all instructions
 // of the corresponding MachineFunction. To improve estimate accuracy this pass
 // should run as late as possible, but must run before the Pagerando optimizer
 // passes (since they rely on bin assignments).
+// Since branch relaxation, constant islands and the Pagerando optimizer still
+// change function sizes after binning, the AsmPrinter can record the final
+// sizes (-pagerando-size-feedback-output) which are then used instead of the
+// estimates on a subsequent compile (-pagerando-size-feedback).
+// Under ThinLTO, bins with the same name from different backends end up in the
+// same segment, so bins are assigned globally during the thin link (see
+// computePagerandoBins) and only functions unknown to the thin link are binned
+// per module, into bins with a module-specific name.
 //
 // Binning strategies:
 // -) Simple: a greedy algorithm that, for every function, picks the bin with
@@ -26,11 +37,28 @@
 // caller with the hottest call site. Based on the C3 algorithm presented in
 // "Optimizing Function Placement for Large-Scale Data-Center Applications,"
 // Ottoni and Maher, CGO 2017.
+// The PGO strategy also lays out the functions inside each bin in cluster
+// order (callers before their hot callees) and aligns the entry of every
+// cluster to a cache line, so that hot call chains touch as few cache lines as
+// possible.
+// -) HotCold: functions are split into hot, normal and cold tiers according to
+// the profile summary. Cold functions also include regions outlined by
+// HotColdSplitting (cold calling convention) and functions marked cold. Every
+// tier gets its own bins, hot ones first, and each tier is packed first-fit
+// decreasing, so the hot working set occupies as few pages as possible and
+// never shares a page with cold code.
+//
+// With -pagerando-bin-report=<file>, a JSON report of the resulting bins is
+// written at the end of code generation: the functions of every bin with their
+// estimated and final sizes and the bytes they keep in constant islands, the
+// page fill ratio and the number and profile weight of calls leaving the bin.
 //
 //===----------------------------------------------------------------------===//
 
 #include "llvm/CodeGen/PagerandoBinning.h"
 #include "llvm/ADT/SCCIterator.h"
+#include "llvm/ADT/SmallPtrSet.h"
+#include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/StringExtras.h"
 #include "llvm/Analysis/CallGraph.h"
 #include "llvm/Analysis/ProfileSummaryInfo.h"
@@ -38,24 +66,58 @@
 #include "llvm/CodeGen/MachineFunction.h"
 #include "llvm/CodeGen/MachineModuleInfo.h"
 #include "llvm/CodeGen/TargetInstrInfo.h"
+#include "llvm/CodeGen/TargetPassConfig.h"
 #include "llvm/CodeGen/TargetSubtargetInfo.h"
+#include "llvm/IR/CallSite.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/ModuleSummaryIndex.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/FormatVariadic.h"
+#include "llvm/Support/JSON.h"
+#include "llvm/Support/MD5.h"
+#include "llvm/Support/MathExtras.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Target/TargetMachine.h"
 #include <algorithm>
 
 using namespace llvm;
 
 #define DEBUG_TYPE "pagerando-binning"
 
-enum class BStrat { Simple, PGO };
+enum class BStrat { Simple, PGO, HotCold };
 static cl::opt<BStrat> BinningStrategy(
     "pagerando-binning-strategy", cl::Hidden, cl::init(BStrat::Simple),
     cl::desc("Binning strategy for Pagerando"), cl::values(
         clEnumValN(BStrat::Simple, "simple", "Simple greedy strategy"),
-        clEnumValN(BStrat::PGO, "pgo", "Profile-guided strategy")));
-
-static cl::opt<unsigned> BinSize(
-    "pagerando-bin-size", cl::Hidden, cl::init(4096),
-    cl::desc("Target size for pagerando bins"));
-
+        clEnumValN(BStrat::PGO, "pgo", "Profile-guided strategy"),
+        clEnumValN(BStrat::HotCold, "hotcold",
+                   "Separate bins for hot and cold functions")));
+
+static cl::opt<bool> IntraBinLayout(
+    "pagerando-intra-bin-layout", cl::Hidden, cl::init(true),
+    cl::desc("Order functions inside Pagerando bins by call-graph hotness "
+             "(PGO strategy only)"));
+
+static cl::opt<unsigned> HotEntryAlignment(
+    "pagerando-hot-entry-align", cl::Hidden, cl::init(64),
+    cl::desc("Alignment in bytes of hot cluster entries inside Pagerando bins "
+             "(PGO strategy only)"));
+
+static cl::opt<std::string> SizeFeedbackFile(
+    "pagerando-size-feedback", cl::Hidden, cl::value_desc("filename"),
+    cl::desc("Use function sizes recorded by a previous compile (see "
+             "-pagerando-size-feedback-output) for Pagerando binning"));
+
+static cl::opt<unsigned> SummaryBytesPerInst(
+    "pagerando-summary-bytes-per-inst", cl::Hidden, cl::init(4),
+    cl::desc("Estimated code size per IR instruction when assigning Pagerando "
+             "bins from the ThinLTO summary"));
+
+static cl::opt<std::string> BinReportFile(
+    "pagerando-bin-report", cl::Hidden, cl::value_desc("filename"),
+    cl::desc("Write a JSON report of Pagerando bin assignments, sizes and "
+             "cross-bin calls"));
 
 namespace {
 
@@ -89,6 +151,8 @@ public:
 
   Bin getBinAssignment(Function &F) override;
 
+  bool finalizeBinning(Module &M) override;
+
 private:
   struct Cluster {
     unsigned Size = 0;
@@ -118,12 +182,38 @@ private:
   std::map<Function*, CallerWeights> RevCG;
   DenseMap<Function*, std::shared_ptr<Cluster>> FnToCluster;
 
+  // Functions in order of decreasing entry count
+  std::vector<Function*> HotOrder;
+
   std::shared_ptr<Cluster> getCluster(Function *F);
   void mergeClusters(std::shared_ptr<Cluster> C1, std::shared_ptr<Cluster> C2);
 
   void createReverseWeightedCallGraph(CallGraph &CG);
 };
 
+class HotColdBinner : public PagerandoBinnerBase {
+public:
+  HotColdBinner() : PagerandoBinnerBase(ID) {
+    initializeHotColdBinnerPass(*PassRegistry::getPassRegistry());
+  }
+
+  static char ID; // Pass identification, replacement for typeid
+
+  void getAnalysisUsage(AnalysisUsage &AU) const override;
+
+  bool initializeBinning(Module &M) override;
+
+  Bin getBinAssignment(Function &F) override;
+
+private:
+  enum Tier { Hot, Normal, Cold, NumTiers };
+
+  FirstFitAlgo FitAlgo;
+  DenseMap<Function*, Bin> Assignment;
+
+  Tier getTier(const Function &F, ProfileSummaryInfo *PSI);
+};
+
 } // end anonymous namespace
 
 
@@ -132,6 +222,11 @@ PagerandoBinnerBase::PagerandoBinnerBase(char &ID) : ModulePass(ID) {}
 void PagerandoBinnerBase::getAnalysisUsage(AnalysisUsage &AU) const {
   AU.addRequired<MachineModuleInfo>();
   AU.addPreserved<MachineModuleInfo>();
+  AU.addRequired<TargetPassConfig>();
+  // Only used to weight cross-bin calls in the bin report
+  AU.addRequired<PagerandoBinReport>();
+  AU.addRequired<ProfileSummaryInfoWrapperPass>();
+  AU.addRequired<BlockFrequencyInfoWrapperPass>();
   ModulePass::getAnalysisUsage(AU);
 }
 
@@ -139,47 +234,303 @@ bool PagerandoBinnerBase::initializeBinning(Module &M) {
   return false;
 }
 
+bool PagerandoBinnerBase::finalizeBinning(Module &M) {
+  return false;
+}
+
 bool PagerandoBinnerBase::runOnModule(Module &M) {
+  auto &TM = getAnalysis<TargetPassConfig>().getTM<TargetMachine>();
+  BinSize = TM.Options.PagerandoBinSize;
+
+  if (!SizeFeedbackFile.empty() && SizeFeedback.empty()) {
+    if (Error E = SizeFeedback.readFromFile(SizeFeedbackFile))
+      M.getContext().emitError(toString(std::move(E)));
+  }
+
   bool Modified = initializeBinning(M);
 
+  // Bins assigned before code generation are shared with other modules. Bins
+  // created here must not collide with them, so give them a module-specific
+  // name in that case.
+  std::string LocalSuffix;
+  if (any_of(M, [](const Function &F) { return getPresetBin(F) != 0; }))
+    LocalSuffix = "." + utohexstr(MD5Hash(M.getModuleIdentifier()));
+
   for (auto &F : M) {
     if (F.isPagerando()) {
-      Bin B = getBinAssignment(F);
-      setBin(F, B);
+      if (Bin B = getPresetBin(F)) {
+        setBin(F, B);
+      } else {
+        B = getBinAssignment(F);
+        setBin(F, B, LocalSuffix);
+      }
       Modified = true;
     }
   }
+
+  Modified |= finalizeBinning(M);
+
+  auto &Report = getAnalysis<PagerandoBinReport>();
+  if (Report.isEnabled()) {
+    Report.setBinSize(BinSize);
+    reportBins(M, Report);
+  }
+
   return Modified;
 }
 
-void PagerandoBinnerBase::setBin(Function &F, Bin Bin) {
+void PagerandoBinnerBase::reportBins(Module &M, PagerandoBinReport &Report) {
+  auto &PSI = getAnalysis<ProfileSummaryInfoWrapperPass>().getPSI();
+  bool HaveProfile = PSI.hasProfileSummary();
+
+  for (auto &F : M) {
+    if (!F.isPagerando() || F.isDeclaration())
+      continue;
+    Report.recordFunction(F, estimateFunctionSize(F));
+
+    BlockFrequencyInfo *BFI = nullptr;
+    if (HaveProfile)
+      BFI = &getAnalysis<BlockFrequencyInfoWrapperPass>(F).getBFI();
+    for (auto &BB : F) {
+      for (auto &I : BB) {
+        ImmutableCallSite CS(&I);
+        if (!CS)
+          continue;
+        auto *Callee = CS.getCalledFunction();
+        if (!Callee || !Callee->isPagerando() ||
+            Callee->getSectionPrefix() == F.getSectionPrefix())
+          continue;
+        uint64_t Weight = 0;
+        if (BFI) {
+          if (auto Count = PSI.getProfileCount(&I, BFI))
+            Weight = *Count;
+        }
+        Report.recordCrossBinCall(F, Weight);
+      }
+    }
+  }
+}
+
+void PagerandoBinnerBase::setBin(Function &F, Bin Bin, StringRef Suffix) {
   // Note: overwrites an existing section prefix
-  F.setSectionPrefix(SectionPrefix + utostr(Bin));
+  F.setSectionPrefix(SectionPrefix + utostr(Bin) + Suffix.str());
 }
 
-unsigned PagerandoBinnerBase::estimateFunctionSize(const Function &F) {
-  auto &MF = *getAnalysis<MachineModuleInfo>().getMachineFunction(F);
+PagerandoBinnerBase::Bin PagerandoBinnerBase::getPresetBin(const Function &F) {
+  if (!F.hasFnAttribute(BinAttr))
+    return 0;
+  Bin B;
+  if (F.getFnAttribute(BinAttr).getValueAsString().getAsInteger(10, B))
+    return 0;
+  return B;
+}
+
+unsigned PagerandoBinnerBase::computeFunctionSize(const MachineFunction &MF) {
   auto *TII = MF.getSubtarget().getInstrInfo();
+  unsigned FnAlign = MF.getAlignment();
 
   unsigned Size = 0;
-  for (auto &MBB : MF)
+  for (auto &MBB : MF) {
+    unsigned Align = MBB.getAlignment();
+    if (Align) {
+      // Padding is exact up to the function alignment; beyond that, assume the
+      // worst case.
+      Size = alignTo(Size, 1u << Align);
+      if (Align > FnAlign)
+        Size += (1u << Align) - (1u << FnAlign);
+    }
     for (auto &MI : MBB)
       Size += TII->getInstSizeInBytes(MI);
+  }
 
+  // The next function in the bin starts at the next aligned address.
+  Size = alignTo(Size, 1u << FnAlign);
   return std::max(Size, MinFnSize+0);
 }
 
+unsigned PagerandoBinnerBase::estimateFunctionSize(const Function &F) {
+  if (auto Size = SizeFeedback.lookupSize(F.getName()))
+    return std::max(*Size, MinFnSize+0);
+
+  // Targets that place constants in islands inside the code only create the
+  // islands after binning, so add an estimate of their data.
+  auto &MF = *getAnalysis<MachineModuleInfo>().getMachineFunction(F);
+  unsigned Size = computeFunctionSize(MF) +
+      MF.getSubtarget().getInstrInfo()->getInlineDataSizeEstimate(MF);
+  return alignTo(Size, 1u << MF.getAlignment());
+}
+
+Optional<unsigned> PagerandoSizeFeedback::lookupSize(StringRef FnName) const {
+  auto I = Sizes.find(FnName);
+  if (I == Sizes.end())
+    return None;
+  return I->second;
+}
+
+Error PagerandoSizeFeedback::readFromFile(StringRef Path) {
+  auto BufOrErr = MemoryBuffer::getFile(Path);
+  if (std::error_code EC = BufOrErr.getError())
+    return createFileError(Path, errorCodeToError(EC));
+
+  SmallVector<StringRef, 64> Lines;
+  (*BufOrErr)->getBuffer().split(Lines, '\n', /*MaxSplit=*/-1,
+                                 /*KeepEmpty=*/false);
+  for (StringRef Line : Lines) {
+    StringRef Name, SizeStr;
+    std::tie(Name, SizeStr) = Line.trim().rsplit(' ');
+    unsigned Size;
+    if (Name.empty() || SizeStr.getAsInteger(10, Size))
+      return createStringError(inconvertibleErrorCode(),
+                               "%s: malformed size feedback entry '%s'",
+                               Path.str().c_str(), Line.str().c_str());
+    // When several compiles emitted the same function, keep the largest size
+    // so that bins never overflow.
+    unsigned &Entry = Sizes[Name];
+    Entry = std::max(Entry, Size);
+  }
+  return Error::success();
+}
+
+Error PagerandoSizeFeedback::writeToFile(StringRef Path) const {
+  std::error_code EC;
+  raw_fd_ostream OS(Path, EC, sys::fs::F_Text);
+  if (EC)
+    return createFileError(Path, errorCodeToError(EC));
+
+  // Sort by name to keep the output deterministic.
+  std::vector<const StringMapEntry<unsigned>*> Entries;
+  for (auto &E : Sizes)
+    Entries.push_back(&E);
+  llvm::sort(Entries, [](const StringMapEntry<unsigned> *A,
+                         const StringMapEntry<unsigned> *B) {
+    return A->getKey() < B->getKey();
+  });
+
+  for (auto *E : Entries)
+    OS << E->getKey() << ' ' << E->getValue() << '\n';
+  return Error::success();
+}
+
+
+char PagerandoBinReport::ID = 0;
+INITIALIZE_PASS(PagerandoBinReport, "pagerando-bin-report-info",
+                "Pagerando Bin Report", false, true)
+
+PagerandoBinReport::PagerandoBinReport() : ImmutablePass(ID) {
+  initializePagerandoBinReportPass(*PassRegistry::getPassRegistry());
+}
+
+bool PagerandoBinReport::isEnabled() const { return !BinReportFile.empty(); }
+
+void PagerandoBinReport::recordFunction(const Function &F,
+                                        unsigned EstimatedSize) {
+  auto &Stats = Functions[F.getName()];
+  Stats.Bin = F.getSectionPrefix().getValueOr("");
+  Stats.EstimatedSize = EstimatedSize;
+}
+
+void PagerandoBinReport::recordFinalSize(const Function &F,
+                                         unsigned FinalSize) {
+  Functions[F.getName()].FinalSize = FinalSize;
+}
+
+void PagerandoBinReport::recordIslandSize(const Function &F,
+                                          unsigned IslandSize) {
+  Functions[F.getName()].IslandSize = IslandSize;
+}
+
+void PagerandoBinReport::recordCrossBinCall(const Function &Caller,
+                                            uint64_t Weight) {
+  auto &Stats = CrossBinCalls[Caller.getSectionPrefix().getValueOr("")];
+  Stats.Calls++;
+  Stats.Weight += Weight;
+}
+
+bool PagerandoBinReport::doFinalization(Module &M) {
+  if (isEnabled() && !Functions.empty()) {
+    if (Error E = writeToFile(BinReportFile))
+      M.getContext().emitError(toString(std::move(E)));
+  }
+  Functions.clear();
+  CrossBinCalls.clear();
+  return false;
+}
+
+Error PagerandoBinReport::writeToFile(StringRef Path) const {
+  std::error_code EC;
+  raw_fd_ostream OS(Path, EC, sys::fs::F_Text);
+  if (EC)
+    return createFileError(Path, errorCodeToError(EC));
+
+  // Group functions by bin, sorted by name to keep the output deterministic.
+  std::map<std::string, std::vector<const StringMapEntry<FunctionStats>*>>
+      Bins;
+  for (auto &E : Functions)
+    Bins[E.getValue().Bin].push_back(&E);
+
+  json::Array BinArray;
+  for (auto &B : Bins) {
+    auto &Entries = B.second;
+    llvm::sort(Entries, [](const StringMapEntry<FunctionStats> *A,
+                           const StringMapEntry<FunctionStats> *B) {
+      return A->getKey() < B->getKey();
+    });
+
+    json::Array FnArray;
+    int64_t EstimatedSize = 0, FinalSize = 0;
+    bool HaveFinalSizes = true;
+    for (auto *E : Entries) {
+      const FunctionStats &Stats = E->getValue();
+      json::Object Fn{{"name", E->getKey()},
+                      {"estimated_size", Stats.EstimatedSize}};
+      if (Stats.FinalSize)
+        Fn["final_size"] = Stats.FinalSize;
+      else
+        HaveFinalSizes = false;
+      if (Stats.IslandSize)
+        Fn["island_bytes"] = Stats.IslandSize;
+      FnArray.push_back(std::move(Fn));
+      EstimatedSize += Stats.EstimatedSize;
+      FinalSize += Stats.FinalSize;
+    }
+
+    // Bins larger than a page are expanded to whole pages.
+    int64_t Size = HaveFinalSizes ? FinalSize : EstimatedSize;
+    int64_t Pages = std::max<int64_t>(divideCeil(Size, BinSize), 1);
+
+    json::Object BinObj{{"name", B.first},
+                        {"functions", std::move(FnArray)},
+                        {"estimated_size", EstimatedSize},
+                        {"fill_ratio", double(Size) / (Pages * BinSize)}};
+    if (HaveFinalSizes)
+      BinObj["final_size"] = FinalSize;
+    CrossBinStats Cross;
+    auto I = CrossBinCalls.find(B.first);
+    if (I != CrossBinCalls.end())
+      Cross = I->second;
+    BinObj["cross_bin_calls"] = Cross.Calls;
+    BinObj["cross_bin_weight"] = int64_t(Cross.Weight);
+    BinArray.push_back(std::move(BinObj));
+  }
+
+  json::Object Report{{"bin_size", BinSize},
+                      {"bins", std::move(BinArray)}};
+  OS << formatv("{0:2}", json::Value(std::move(Report))) << '\n';
+  return Error::success();
+}
+
 
 char SimpleBinner::ID = 0;
 INITIALIZE_PASS_BEGIN(SimpleBinner, "pagerando-binning-simple", "Simple Function Binning",
                       false, false)
 INITIALIZE_PASS_DEPENDENCY(MachineModuleInfo)
+INITIALIZE_PASS_DEPENDENCY(TargetPassConfig)
 INITIALIZE_PASS_END(SimpleBinner, "pagerando-binning-simple", "Simple Function Binning",
                     false, false)
 
 PagerandoBinnerBase::Bin SimpleBinner::getBinAssignment(Function &F) {
   auto FnSize = estimateFunctionSize(F);
-  return FitAlgo.assignToBin(FnSize);
+  return FitAlgo.assignToBin(FnSize, BinSize);
 }
 
 void SimpleBinner::getAnalysisUsage(AnalysisUsage &AU) const {
@@ -188,7 +539,8 @@ void SimpleBinner::getAnalysisUsage(AnalysisUsage &AU) const {
 }
 
 
-PagerandoBinnerBase::Bin PagerandoBinnerBase::FirstFitAlgo::assignToBin(unsigned FnSize) {
+PagerandoBinnerBase::Bin PagerandoBinnerBase::FirstFitAlgo::assignToBin(unsigned FnSize,
+                                                                      unsigned BinSize) {
   unsigned Bin, FreeSpace;
 
   auto I = Bins.lower_bound(FnSize);
@@ -216,6 +568,7 @@ INITIALIZE_PASS_DEPENDENCY(CallGraphWrapperPass)
 INITIALIZE_PASS_DEPENDENCY(ProfileSummaryInfoWrapperPass)
 INITIALIZE_PASS_DEPENDENCY(BlockFrequencyInfoWrapperPass)
 INITIALIZE_PASS_DEPENDENCY(MachineModuleInfo)
+INITIALIZE_PASS_DEPENDENCY(TargetPassConfig)
 INITIALIZE_PASS_END(PGOBinner, "pagerando-binning-pgo", "PGO Function Binning",
                     false, false)
 
@@ -232,7 +585,7 @@ bool PGOBinner::initializeBinning(Module &M) {
 
   std::vector<Function*> Worklist;
   for (auto &F : M) {
-    if (F.isPagerando())
+    if (F.isPagerando() && !getPresetBin(F))
       Worklist.push_back(&F);
   }
   std::stable_sort(Worklist.begin(), Worklist.end(),
@@ -270,6 +623,7 @@ bool PGOBinner::initializeBinning(Module &M) {
     WeightedCallers.clear();
   }
 
+  HotOrder = std::move(Worklist);
   return false;
 }
 
@@ -316,15 +670,51 @@ PagerandoBinnerBase::Bin PGOBinner::getBinAssignment(Function &F) {
   if (!HaveProfileInfo) {
     // Fall back to simple binning
     auto FnSize = estimateFunctionSize(F);
-    return FitAlgo.assignToBin(FnSize);
+    return FitAlgo.assignToBin(FnSize, BinSize);
   }
 
   auto Cluster = FnToCluster[&F];
-  if (Cluster->Bin == 0)
-    Cluster->Bin = FitAlgo.assignToBin(Cluster->Size);
+  if (Cluster->Bin == 0) {
+    // Reserve space for aligning the cluster entry to a cache line.
+    unsigned Padding = IntraBinLayout ? HotEntryAlignment - 1 : 0;
+    Cluster->Bin = FitAlgo.assignToBin(Cluster->Size + Padding, BinSize);
+  }
   return Cluster->Bin;
 }
 
+// Lay out the functions of each bin in cluster order. Clusters are merged by
+// appending the callee cluster to its caller's cluster, so this places hot
+// callees right after their callers (as in C3). Clusters of a bin are ordered
+// by their hottest function, and each cluster entry is aligned to a cache
+// line. Functions are emitted in module order, so moving them to the end of
+// the module (after all non-binned code) determines the layout in the bin
+// sections.
+bool PGOBinner::finalizeBinning(Module &M) {
+  if (!HaveProfileInfo || !IntraBinLayout)
+    return false;
+
+  std::map<Bin, std::vector<Cluster*>> BinClusters;
+  SmallPtrSet<Cluster*, 32> Seen;
+  for (auto *F : HotOrder) {
+    auto *C = FnToCluster[F].get();
+    if (Seen.insert(C).second)
+      BinClusters[C->Bin].push_back(C);
+  }
+
+  auto &MMI = getAnalysis<MachineModuleInfo>();
+  unsigned EntryAlign = Log2_32(HotEntryAlignment);
+  auto &FnList = M.getFunctionList();
+  for (auto &B : BinClusters) {
+    for (auto *C : B.second) {
+      if (auto *MF = MMI.getMachineFunction(*C->Functions.front()))
+        MF->ensureAlignment(EntryAlign);
+      for (auto *F : C->Functions)
+        FnList.splice(FnList.end(), FnList, F->getIterator());
+    }
+  }
+  return true;
+}
+
 void PGOBinner::getAnalysisUsage(AnalysisUsage &AU) const {
   AU.addRequired<CallGraphWrapperPass>();
   AU.addRequired<ProfileSummaryInfoWrapperPass>();
@@ -334,10 +724,192 @@ void PGOBinner::getAnalysisUsage(AnalysisUsage &AU) const {
 }
 
 
+char HotColdBinner::ID = 0;
+INITIALIZE_PASS_BEGIN(HotColdBinner, "pagerando-binning-hotcold",
+                      "Hot/Cold Function Binning", false, false)
+INITIALIZE_PASS_DEPENDENCY(ProfileSummaryInfoWrapperPass)
+INITIALIZE_PASS_DEPENDENCY(MachineModuleInfo)
+INITIALIZE_PASS_DEPENDENCY(TargetPassConfig)
+INITIALIZE_PASS_END(HotColdBinner, "pagerando-binning-hotcold",
+                    "Hot/Cold Function Binning", false, false)
+
+HotColdBinner::Tier HotColdBinner::getTier(const Function &F,
+                                           ProfileSummaryInfo *PSI) {
+  // Regions outlined by HotColdSplitting use the cold calling convention
+  if (F.getCallingConv() == CallingConv::Cold ||
+      F.hasFnAttribute(Attribute::Cold))
+    return Cold;
+  if (!PSI || !PSI->hasProfileSummary())
+    return Normal;
+  if (PSI->isFunctionEntryHot(&F))
+    return Hot;
+  if (PSI->isFunctionEntryCold(&F))
+    return Cold;
+  return Normal;
+}
+
+bool HotColdBinner::initializeBinning(Module &M) {
+  auto *PSI = &getAnalysis<ProfileSummaryInfoWrapperPass>().getPSI();
+
+  using SizedFn = std::pair<unsigned, Function*>;
+  std::vector<SizedFn> Tiers[NumTiers];
+  for (auto &F : M) {
+    if (F.isPagerando() && !getPresetBin(F))
+      Tiers[getTier(F, PSI)].emplace_back(estimateFunctionSize(F), &F);
+  }
+
+  // First-fit decreasing within each tier; bins are not shared across tiers.
+  for (auto &Fns : Tiers) {
+    std::stable_sort(Fns.begin(), Fns.end(),
+                     [](const SizedFn &A, const SizedFn &B) {
+                       return A.first > B.first;
+                     });
+    for (auto &SF : Fns)
+      Assignment[SF.second] = FitAlgo.assignToBin(SF.first, BinSize);
+    FitAlgo.closeBins();
+  }
+  return false;
+}
+
+PagerandoBinnerBase::Bin HotColdBinner::getBinAssignment(Function &F) {
+  return Assignment.lookup(&F);
+}
+
+void HotColdBinner::getAnalysisUsage(AnalysisUsage &AU) const {
+  AU.addRequired<ProfileSummaryInfoWrapperPass>();
+  AU.setPreservesAll();
+  PagerandoBinnerBase::getAnalysisUsage(AU);
+}
+
+
+// Relative weight of a summary call edge. Relative block frequencies are only
+// available with -write-relbf-to-summary; fall back to profile hotness.
+static uint64_t getEdgeWeight(const CalleeInfo &CI) {
+  if (CI.RelBlockFreq)
+    return CI.RelBlockFreq;
+
+  uint64_t One = 1 << CalleeInfo::ScaleShift;
+  switch (CI.getHotness()) {
+  case CalleeInfo::HotnessType::Cold:     return 0;
+  case CalleeInfo::HotnessType::Unknown:
+  case CalleeInfo::HotnessType::None:     return One;
+  case CalleeInfo::HotnessType::Hot:      return 100 * One;
+  case CalleeInfo::HotnessType::Critical: return 1000 * One;
+  }
+  llvm_unreachable("Unexpected hotness type");
+}
+
+void llvm::computePagerandoBins(ModuleSummaryIndex &Index, unsigned BinSize) {
+  using GUID = GlobalValue::GUID;
+  using CallerWeights = std::vector<std::pair<GUID, uint64_t>>;
+
+  // Collect size estimates and reverse call edges of all live Pagerando
+  // functions. Copies of linkonce functions share a GUID and only one of them
+  // is emitted, so they are accounted for once.
+  std::map<GUID, unsigned> Sizes;
+  std::map<GUID, CallerWeights> RevCG;
+  for (auto &I : Index) {
+    for (auto &S : I.second.SummaryList) {
+      auto *FS = dyn_cast<FunctionSummary>(S.get());
+      if (!FS || !FS->fflags().Pagerando || !Index.isGlobalValueLive(FS))
+        continue;
+
+      unsigned Size = std::max(FS->instCount() * SummaryBytesPerInst,
+                               PagerandoBinnerBase::MinFnSize + 0);
+      unsigned &Entry = Sizes[I.first];
+      Entry = std::max(Entry, Size);
+
+      for (auto &Call : FS->calls())
+        if (uint64_t Weight = getEdgeWeight(Call.second))
+          RevCG[Call.first.getGUID()].emplace_back(I.first, Weight);
+    }
+  }
+
+  // Visit callees in order of decreasing incoming edge weight.
+  std::vector<std::pair<GUID, uint64_t>> Worklist;
+  for (auto &E : Sizes) {
+    uint64_t Weight = 0;
+    for (auto &C : RevCG[E.first])
+      Weight += C.second;
+    Worklist.emplace_back(E.first, Weight);
+  }
+  std::stable_sort(Worklist.begin(), Worklist.end(),
+                   [](const std::pair<GUID, uint64_t> &W1,
+                      const std::pair<GUID, uint64_t> &W2) {
+                     return W1.second > W2.second;
+                   });
+
+  // Merge each callee into the cluster of its hottest caller that still has
+  // room, as done by PGOBinner for a single module.
+  struct Cluster {
+    unsigned Size;
+    std::vector<GUID> Functions;
+    PagerandoBinnerBase::Bin Bin;
+  };
+  std::vector<Cluster> Clusters;
+  DenseMap<GUID, unsigned> FnToCluster;
+  for (auto &E : Sizes) {
+    FnToCluster[E.first] = Clusters.size();
+    Clusters.push_back(Cluster{E.second, {E.first}, 0});
+  }
+
+  for (auto &W : Worklist) {
+    CallerWeights &Callers = RevCG[W.first];
+    std::stable_sort(Callers.begin(), Callers.end(),
+                     [](const std::pair<GUID, uint64_t> &C1,
+                        const std::pair<GUID, uint64_t> &C2) {
+                       return C1.second > C2.second;
+                     });
+
+    unsigned CalleeCluster = FnToCluster[W.first];
+    for (auto &C : Callers) {
+      auto I = FnToCluster.find(C.first);
+      if (I == FnToCluster.end())
+        continue;
+      unsigned CallerCluster = I->second;
+      if (CallerCluster == CalleeCluster)
+        break;
+      Cluster &To = Clusters[CallerCluster];
+      Cluster &From = Clusters[CalleeCluster];
+      if (To.Size + From.Size <= BinSize) {
+        To.Size += From.Size;
+        for (GUID F : From.Functions) {
+          To.Functions.push_back(F);
+          FnToCluster[F] = CallerCluster;
+        }
+        From.Functions.clear();
+        From.Size = 0;
+        break;
+      }
+    }
+  }
+
+  // Pack clusters into bins, hottest functions first.
+  PagerandoBinnerBase::FirstFitAlgo FitAlgo;
+  for (auto &W : Worklist) {
+    Cluster &C = Clusters[FnToCluster[W.first]];
+    if (C.Bin == 0)
+      C.Bin = FitAlgo.assignToBin(C.Size, BinSize);
+    Index.setPagerandoBin(W.first, C.Bin);
+  }
+}
+
+void llvm::applyPagerandoBins(Module &M, const ModuleSummaryIndex &Index) {
+  for (auto &F : M) {
+    // Declarations are annotated as well, so that code generation can tell
+    // which cross-module calls target the caller's own bin.
+    if (!F.isPagerando() && !F.isDeclarationForLinker())
+      continue;
+    if (unsigned Bin = Index.getPagerandoBin(F.getGUID()))
+      F.addFnAttr(PagerandoBinnerBase::BinAttr, utostr(Bin));
+  }
+}
+
 ModulePass *llvm::createPagerandoBinningPass() {
   switch (BinningStrategy.getValue()) {
   case BStrat::Simple:    return new SimpleBinner();
   case BStrat::PGO:       return new PGOBinner();
+  case BStrat::HotCold:   return new HotColdBinner();
   }
   llvm_unreachable("Unexpected binning strategy");
 }
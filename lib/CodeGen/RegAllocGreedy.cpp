@@ -85,6 +85,7 @@ using namespace llvm;
 STATISTIC(NumGlobalSplits, "Number of split global live ranges");
 STATISTIC(NumLocalSplits,  "Number of split local live ranges");
 STATISTIC(NumEvicted,      "Number of interferences evicted");
+STATISTIC(NumOverSplitBudget, "Number of functions over the split budget");
 
 static cl::opt<SplitEditor::ComplementSpillMode> SplitSpillMode(
     "split-spill-mode", cl::Hidden,
@@ -131,6 +132,13 @@ static cl::opt<unsigned>
                               "high compile time cost in global splitting."),
                      cl::init(5000));
 
+static cl::opt<unsigned> SplitBudget(
+    "regalloc-split-budget", cl::Hidden,
+    cl::desc("Maximum number of live range split attempts per function. "
+             "Once exceeded, the remaining live ranges are spilled without "
+             "splitting (0 = unlimited)"),
+    cl::init(0));
+
 // FIXME: Find a good default for this flag and remove the flag.
 static cl::opt<unsigned>
 CSRFirstTimeCost("regalloc-csr-first-time-cost",
@@ -412,6 +420,10 @@ class RAGreedy : public MachineFunctionPass,
   /// Set of broken hints that may be reconciled later because of eviction.
   SmallSetVector<LiveInterval *, 8> SetOfBrokenHints;
 
+  /// Number of split attempts in the current function, checked against
+  /// -regalloc-split-budget.
+  unsigned NumSplitAttempts;
+
 public:
   RAGreedy();
 
@@ -3076,8 +3088,19 @@ unsigned RAGreedy::selectOrSplitImpl(LiveInterval &VirtReg,
     return 0;
   }
 
+  // Bound the time spent in region and local splitting on huge functions by
+  // falling back to plain spilling once the split budget is used up.
+  if (Stage < RS_Spill && SplitBudget && NumSplitAttempts >= SplitBudget) {
+    if (NumSplitAttempts++ == SplitBudget) {
+      LLVM_DEBUG(dbgs() << "split budget exceeded, spilling from now on\n");
+      ++NumOverSplitBudget;
+    }
+    Stage = RS_Spill;
+  }
+
   if (Stage < RS_Spill) {
     // Try splitting VirtReg or interferences.
+    ++NumSplitAttempts;
     unsigned NewVRegSizeBefore = NewVRegs.size();
     unsigned PhysReg = trySplit(VirtReg, Order, NewVRegs);
     if (PhysReg || (NewVRegs.size() - NewVRegSizeBefore)) {
@@ -3238,6 +3261,7 @@ bool RAGreedy::runOnMachineFunction(MachineFunction &mf) {
   GlobalCand.resize(32);  // This will grow as needed.
   SetOfBrokenHints.clear();
   LastEvicted.clear();
+  NumSplitAttempts = 0;
 
   allocatePhysRegs();
   tryHintsRecoloring();
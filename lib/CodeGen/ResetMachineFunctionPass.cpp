@@ -15,6 +15,7 @@
 
 #include "llvm/ADT/ScopeExit.h"
 #include "llvm/ADT/Statistic.h"
+#include "llvm/CodeGen/GlobalISelReport.h"
 #include "llvm/CodeGen/MachineFunction.h"
 #include "llvm/CodeGen/MachineFunctionPass.h"
 #include "llvm/CodeGen/MachineRegisterInfo.h"
@@ -57,6 +58,9 @@ namespace {
       auto ClearVRegTypesOnReturn =
           make_scope_exit([&MF]() { MF.getRegInfo().clearVirtRegTypes(); });
 
+      if (auto *Report = getAnalysisIfAvailable<GlobalISelReport>())
+        Report->finishFunction(MF);
+
       if (MF.getProperties().hasProperty(
               MachineFunctionProperties::Property::FailedISel)) {
         if (AbortOnFailedISel)
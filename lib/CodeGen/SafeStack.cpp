@@ -19,6 +19,8 @@
 #include "SafeStackLayout.h"
 #include "llvm/ADT/APInt.h"
 #include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/PostOrderIterator.h"
 #include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/Statistic.h"
@@ -87,6 +89,8 @@ STATISTIC(NumUnsafeStaticAllocas, "Number of unsafe static allocas");
 STATISTIC(NumUnsafeDynamicAllocas, "Number of unsafe dynamic allocas");
 STATISTIC(NumUnsafeByValArguments, "Number of unsafe byval arguments");
 STATISTIC(NumUnsafeStackRestorePoints, "Number of setjmps and landingpads");
+STATISTIC(NumUnsafeStackPtrLoadsForwarded,
+          "Number of unsafe stack pointer loads replaced by a known value");
 
 } // namespace llvm
 
@@ -193,6 +197,14 @@ class SafeStack {
                                        AllocaInst *DynamicTop,
                                        ArrayRef<AllocaInst *> DynamicAllocas);
 
+  /// Replace the loads of the unsafe stack pointer whose value is known from
+  /// an earlier load or store in the same block or in a chain of single
+  /// predecessors, e.g. those of the dynamic allocas and stacksaves of inlined
+  /// callees.
+  /// Calls preserve the unsafe stack pointer, and the program itself never
+  /// writes it, so only our stores change it.
+  void forwardUnsafeStackPtr(Function &F);
+
   bool IsSafeStackAlloca(const Value *AllocaPtr, uint64_t AllocaSize);
 
   bool IsMemIntrinsicSafe(const MemIntrinsic *MI, const Use &U,
@@ -716,6 +728,43 @@ void SafeStack::moveDynamicAllocasToUnsafeStack(
   }
 }
 
+void SafeStack::forwardUnsafeStackPtr(Function &F) {
+  DenseMap<BasicBlock *, Value *> KnownAtEnd;
+  ReversePostOrderTraversal<Function *> RPOT(&F);
+  for (BasicBlock *BB : RPOT) {
+    // A block inherits the value from its only predecessor, which dominates
+    // it, unless it is entered by unwinding.
+    Value *Known = nullptr;
+    if (!BB->isEHPad())
+      if (BasicBlock *Pred = BB->getSinglePredecessor())
+        Known = KnownAtEnd.lookup(Pred);
+
+    for (auto It = BB->begin(), E = BB->end(); It != E;) {
+      Instruction *I = &*It++;
+      if (auto *SI = dyn_cast<StoreInst>(I)) {
+        if (SI->getPointerOperand() == UnsafeStackPtr)
+          Known = SI->getValueOperand();
+      } else if (auto *LI = dyn_cast<LoadInst>(I)) {
+        if (LI->getPointerOperand() != UnsafeStackPtr || !LI->isSimple())
+          continue;
+        if (!Known) {
+          Known = LI;
+          continue;
+        }
+        LI->replaceAllUsesWith(Known);
+        LI->eraseFromParent();
+        ++NumUnsafeStackPtrLoadsForwarded;
+      } else if (auto CS = CallSite(I)) {
+        // Callees restore the unsafe stack pointer before returning, but a
+        // second return from setjmp or inline assembly may leave it anything.
+        if (CS.isInlineAsm() || CS.hasFnAttr(Attribute::ReturnsTwice))
+          Known = nullptr;
+      }
+    }
+    KnownAtEnd[BB] = Known;
+  }
+}
+
 bool SafeStack::ShouldInlinePointerAddress(CallSite &CS) {
   Function *Callee = CS.getCalledFunction();
   if (CS.hasFnAttr(Attribute::AlwaysInline) && isInlineViable(*Callee))
@@ -839,6 +888,8 @@ bool SafeStack::run() {
     IRB.CreateStore(BasePointer, UnsafeStackPtr);
   }
 
+  forwardUnsafeStackPtr(F);
+
   TryInlinePointerAddress();
 
   LLVM_DEBUG(dbgs() << "[SafeStack]     safestack applied\n");
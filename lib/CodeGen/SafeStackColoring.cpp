@@ -11,6 +11,7 @@
 #include "llvm/ADT/BitVector.h"
 #include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/DepthFirstIterator.h"
+#include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/Config/llvm-config.h"
 #include "llvm/IR/BasicBlock.h"
@@ -253,6 +254,81 @@ void StackColoring::calculateLiveIntervals() {
   }
 }
 
+bool StackColoring::isUsedOnlyBetween(AllocaInst *AI, Instruction *Start,
+                                      Instruction *End) {
+  BasicBlock *BB = Start->getParent();
+  if (LocalOrder.find(Start) == LocalOrder.end()) {
+    unsigned Pos = 0;
+    for (Instruction &I : *BB)
+      LocalOrder[&I] = Pos++;
+  }
+  unsigned StartPos = LocalOrder[Start], EndPos = LocalOrder[End];
+
+  SmallVector<Instruction *, 8> WorkList;
+  SmallPtrSet<Instruction *, 8> Visited;
+  WorkList.push_back(AI);
+  while (!WorkList.empty()) {
+    Instruction *I = WorkList.pop_back_val();
+    for (User *U : I->users()) {
+      auto *UI = cast<Instruction>(U);
+      if (UI == Start || UI == End)
+        continue;
+      // Address computations do not access the object; their users do.
+      if (isa<BitCastInst>(UI) || isa<GetElementPtrInst>(UI)) {
+        if (Visited.insert(UI).second)
+          WorkList.push_back(UI);
+        continue;
+      }
+      if (UI->getParent() != BB)
+        return false;
+      unsigned Pos = LocalOrder[UI];
+      if (Pos <= StartPos || Pos >= EndPos)
+        return false;
+    }
+  }
+  return true;
+}
+
+void StackColoring::calculateBlockLocalRanges() {
+  // The start and end markers of each alloca, and how many there are.
+  struct Bounds {
+    Instruction *Start = nullptr;
+    Instruction *End = nullptr;
+    unsigned NumStarts = 0;
+    unsigned NumEnds = 0;
+  };
+  SmallVector<Bounds, 8> AllocaBounds(NumAllocas);
+  for (auto &It : InstructionNumbering) {
+    Instruction *I = It.first;
+    bool IsStart;
+    readMarker(I, &IsStart);
+    auto *AI = cast<AllocaInst>(I->getOperand(1)->stripPointerCasts());
+    Bounds &B = AllocaBounds[AllocaNumbering[AI]];
+    if (IsStart) {
+      B.Start = I;
+      ++B.NumStarts;
+    } else {
+      B.End = I;
+      ++B.NumEnds;
+    }
+  }
+
+  for (unsigned AllocaNo = 0; AllocaNo < NumAllocas; ++AllocaNo) {
+    LiveRange &R = LiveRanges[AllocaNo];
+    R.SetMaximum(NumInst);
+    const Bounds &B = AllocaBounds[AllocaNo];
+    Instruction *Start = B.Start, *End = B.End;
+    if (B.NumStarts != 1 || B.NumEnds != 1 ||
+        Start->getParent() != End->getParent() ||
+        InstructionNumbering[Start] >= InstructionNumbering[End] ||
+        !isUsedOnlyBetween(Allocas[AllocaNo], Start, End)) {
+      R.AddRange(0, NumInst);
+      continue;
+    }
+    R.AddRange(InstructionNumbering[Start], InstructionNumbering[End]);
+  }
+}
+
 #if !defined(NDEBUG) || defined(LLVM_ENABLE_DUMP)
 LLVM_DUMP_METHOD void StackColoring::dumpAllocas() {
   dbgs() << "Allocas:\n";
@@ -292,10 +368,8 @@ void StackColoring::run() {
   collectMarkers();
 
   if (!ClColoring) {
-    for (auto &R : LiveRanges) {
-      R.SetMaximum(1);
-      R.AddRange(0, 1);
-    }
+    calculateBlockLocalRanges();
+    LLVM_DEBUG(dumpLiveRanges());
     return;
   }
 
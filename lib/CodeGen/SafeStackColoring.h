@@ -35,6 +35,12 @@ namespace safestack {
 /// * first instruction of any basic block
 /// Interesting instructions are numbered in the depth-first walk of the CFG,
 /// and in the program order inside each basic block.
+///
+/// Unless full coloring is enabled with -safe-stack-coloring, only allocas
+/// whose lifetime is confined to one basic block get a precise live range:
+/// those with a single lifetime.start and a single lifetime.end in the same
+/// block and no uses outside of them. All other allocas are live throughout
+/// the function.
 class StackColoring {
   /// A class representing liveness information for a single basic block.
   /// Each bit in the BitVector represents the liveness property
@@ -114,6 +120,14 @@ private:
   void collectMarkers();
   void calculateLocalLiveness();
   void calculateLiveIntervals();
+  void calculateBlockLocalRanges();
+
+  /// Position of the instructions of the blocks visited by isUsedOnlyBetween.
+  DenseMap<const Instruction *, unsigned> LocalOrder;
+
+  /// Return true if every use of \p AI, through casts and GEPs, is strictly
+  /// between \p Start and \p End, which are in the same basic block.
+  bool isUsedOnlyBetween(AllocaInst *AI, Instruction *Start, Instruction *End);
 
 public:
   StackColoring(Function &F, ArrayRef<AllocaInst *> Allocas)
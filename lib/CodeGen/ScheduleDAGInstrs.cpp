@@ -18,6 +18,7 @@
 #include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/SparseSet.h"
+#include "llvm/ADT/Statistic.h"
 #include "llvm/ADT/iterator_range.h"
 #include "llvm/Analysis/AliasAnalysis.h"
 #include "llvm/Analysis/ValueTracking.h"
@@ -36,6 +37,7 @@
 #include "llvm/CodeGen/ScheduleDAG.h"
 #include "llvm/CodeGen/ScheduleDFS.h"
 #include "llvm/CodeGen/SlotIndexes.h"
+#include "llvm/CodeGen/TargetInstrInfo.h"
 #include "llvm/CodeGen/TargetRegisterInfo.h"
 #include "llvm/CodeGen/TargetSubtargetInfo.h"
 #include "llvm/Config/llvm-config.h"
@@ -73,6 +75,13 @@ static cl::opt<bool> EnableAASchedMI("enable-aa-sched-mi", cl::Hidden,
 static cl::opt<bool> UseTBAA("use-tbaa-in-sched-mi", cl::Hidden,
     cl::init(true), cl::desc("Enable use of TBAA during MI DAG construction"));
 
+static cl::opt<bool> ReuseAliasQueries("sched-reuse-alias-queries", cl::Hidden,
+    cl::init(false),
+    cl::desc("Share alias query results between the scheduling passes that "
+             "run on a function"));
+
+STATISTIC(NumAliasQueriesReused, "Number of memory dependences reused");
+
 // Note: the two options below might be used in tuning compile time vs
 // output quality. Setting HugeRegion so large that it will never be
 // reached means best-effort, but may be slow.
@@ -519,9 +528,36 @@ static inline bool isGlobalMemoryObject(AliasAnalysis *AA, MachineInstr *MI) {
          (MI->hasOrderedMemoryRef() && !MI->isDereferenceableInvariantLoad(AA));
 }
 
+bool ScheduleDAGInstrs::mayAlias(MachineInstr &MIa, MachineInstr &MIb) {
+  if (!ReuseAliasQueries || !AAForDep)
+    return MIa.mayAlias(AAForDep, MIb, UseTBAA);
+
+  // Only the part of MachineInstr::mayAlias that looks at the memory operands
+  // is a function of the operand pair. The checks on the instructions
+  // themselves are cheap and are not cached.
+  if (!MIa.mayStore() && !MIb.mayStore())
+    return false;
+  if (TII->areMemAccessesTriviallyDisjoint(MIa, MIb, AAForDep))
+    return false;
+  if (!MIa.hasOneMemOperand() || !MIb.hasOneMemOperand())
+    return true;
+
+  auto Key = std::make_pair(*MIa.memoperands_begin(),
+                            *MIb.memoperands_begin());
+  auto &Cache = MF.getMemOperandAliasCache();
+  auto It = Cache.find(Key);
+  if (It != Cache.end()) {
+    ++NumAliasQueriesReused;
+    return It->second;
+  }
+  bool Result = MIa.mayAlias(AAForDep, MIb, UseTBAA);
+  Cache[Key] = Result;
+  return Result;
+}
+
 void ScheduleDAGInstrs::addChainDependency (SUnit *SUa, SUnit *SUb,
                                             unsigned Latency) {
-  if (SUa->getInstr()->mayAlias(AAForDep, *SUb->getInstr(), UseTBAA)) {
+  if (mayAlias(*SUa->getInstr(), *SUb->getInstr())) {
     SDep Dep(SUa, SDep::MayAliasMem);
     Dep.setLatency(Latency);
     SUb->addPred(Dep);
@@ -20,6 +20,7 @@
 #include "llvm/ADT/APInt.h"
 #include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/Hashing.h"
 #include "llvm/ADT/IntervalMap.h"
 #include "llvm/ADT/None.h"
 #include "llvm/ADT/Optional.h"
@@ -79,6 +80,8 @@ using namespace llvm;
 #define DEBUG_TYPE "dagcombine"
 
 STATISTIC(NodesCombined   , "Number of dag nodes combined");
+STATISTIC(CombinesAttempted, "Number of dag nodes visited by the combiner");
+STATISTIC(CombinesSkipped, "Number of unchanged dag nodes not revisited");
 STATISTIC(PreIndexedNodes , "Number of pre-indexed nodes created");
 STATISTIC(PostIndexedNodes, "Number of post-indexed nodes created");
 STATISTIC(OpsNarrowed     , "Number of load/op/store narrowed");
@@ -112,6 +115,14 @@ static cl::opt<bool>
   MaySplitLoadIndex("combiner-split-load-index", cl::Hidden, cl::init(true),
                     cl::desc("DAG combiner may split indexing from loads"));
 
+/// Skip nodes that were already visited without being combined if neither
+/// they nor their operands changed since. Combines that depend on nodes more
+/// than two levels away may be missed.
+static cl::opt<bool>
+SkipUnchanged("combiner-skip-unchanged", cl::Hidden, cl::init(false),
+              cl::desc("Do not revisit dag nodes whose operands did not "
+                       "change since they were last combined"));
+
 namespace {
 
   class DAGCombiner {
@@ -145,6 +156,12 @@ namespace {
     /// which have not yet been combined to the worklist.
     SmallPtrSet<SDNode *, 32> CombinedNodes;
 
+    /// Fingerprints of nodes that were visited without being combined.
+    ///
+    /// With -combiner-skip-unchanged, a node is only visited again once its
+    /// fingerprint changes.
+    DenseMap<SDNode *, size_t> UnchangedNodes;
+
     // AA - Used for DAG load/store alias analysis.
     AliasAnalysis *AA;
 
@@ -190,6 +207,7 @@ namespace {
     /// Remove all instances of N from the worklist.
     void removeFromWorklist(SDNode *N) {
       CombinedNodes.erase(N);
+      UnchangedNodes.erase(N);
 
       auto It = WorklistMap.find(N);
       if (It == WorklistMap.end())
@@ -1373,6 +1391,20 @@ bool DAGCombiner::recursivelyDeleteUnusedNodes(SDNode *N) {
 //  Main DAG Combiner implementation
 //===----------------------------------------------------------------------===//
 
+/// Return a hash of the parts of the DAG around \p N that the combines of N
+/// usually inspect: the node itself, its operands and their operands.
+static size_t getCombineFingerprint(SDNode *N) {
+  hash_code H = hash_combine(N->getOpcode(), N->use_empty(), N->hasOneUse());
+  for (const SDValue &Op : N->op_values()) {
+    SDNode *OpN = Op.getNode();
+    H = hash_combine(H, OpN, Op.getResNo(), OpN->getOpcode(),
+                     OpN->hasOneUse());
+    for (const SDValue &OpOp : OpN->op_values())
+      H = hash_combine(H, OpOp.getNode(), OpOp.getResNo());
+  }
+  return H;
+}
+
 void DAGCombiner::Run(CombineLevel AtLevel) {
   // set the instance variables, so that the various visit routines may use it.
   Level = AtLevel;
@@ -1433,12 +1465,27 @@ void DAGCombiner::Run(CombineLevel AtLevel) {
       if (!CombinedNodes.count(ChildN.getNode()))
         AddToWorklist(ChildN.getNode());
 
+    size_t Fingerprint = 0;
+    if (SkipUnchanged) {
+      Fingerprint = getCombineFingerprint(N);
+      auto It = UnchangedNodes.find(N);
+      if (It != UnchangedNodes.end() && It->second == Fingerprint) {
+        ++CombinesSkipped;
+        continue;
+      }
+    }
+
+    ++CombinesAttempted;
     SDValue RV = combine(N);
 
-    if (!RV.getNode())
+    if (!RV.getNode()) {
+      if (SkipUnchanged)
+        UnchangedNodes[N] = Fingerprint;
       continue;
+    }
 
     ++NodesCombined;
+    UnchangedNodes.erase(N);
 
     // If we get back the same node we passed in, rather than a new node or
     // zero, we know that the node must have defined multiple values and
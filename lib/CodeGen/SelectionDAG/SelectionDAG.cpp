@@ -23,6 +23,7 @@
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/Statistic.h"
 #include "llvm/ADT/Triple.h"
 #include "llvm/ADT/Twine.h"
 #include "llvm/Analysis/ValueTracking.h"
@@ -89,6 +90,12 @@ void SelectionDAG::DAGUpdateListener::NodeUpdated(SDNode*) {}
 
 #define DEBUG_TYPE "selectiondag"
 
+STATISTIC(NumSDNodesCreated, "Number of SDNodes created");
+STATISTIC(MaxSDNodesInBlock, "Maximum number of SDNodes in a block");
+STATISTIC(NumOperandListsAllocated, "Number of SDNode operand lists allocated");
+STATISTIC(NumOperandListsReused, "Number of SDNode operand lists reused");
+STATISTIC(MaxOperandBytes, "Maximum bytes allocated for SDNode operands");
+
 static cl::opt<bool> EnableMemCpyDAGOpt("enable-memcpy-dag-opt",
        cl::Hidden, cl::init(true),
        cl::desc("Gang up loads and stores generated by inlining of memcpy"));
@@ -812,6 +819,7 @@ static void VerifySDNode(SDNode *N) {
 /// verification and other common operations when a new node is allocated.
 void SelectionDAG::InsertNode(SDNode *N) {
   AllNodes.push_back(N);
+  ++NumSDNodesCreated;
 #ifndef NDEBUG
   N->PersistentId = NextPersistentId++;
   VerifySDNode(N);
@@ -993,6 +1001,11 @@ void SelectionDAG::init(MachineFunction &NewMF,
   LibInfo = LibraryInfo;
   Context = &MF->getFunction().getContext();
   DA = Divergence;
+
+  // Operand storage is recycled across the blocks of a function, start the
+  // new function with an empty arena.
+  OperandRecycler.clear(OperandAllocator);
+  OperandAllocator.Reset();
 }
 
 SelectionDAG::~SelectionDAG() {
@@ -1053,9 +1066,14 @@ SDNode *SelectionDAG::FindNodeOrInsertPos(const FoldingSetNodeID &ID,
 }
 
 void SelectionDAG::clear() {
+  if (AreStatisticsEnabled()) {
+    MaxSDNodesInBlock.updateMax(AllNodes.size());
+    MaxOperandBytes.updateMax(OperandAllocator.getBytesAllocated());
+  }
+
+  // Deallocating the nodes returns their operand lists to OperandRecycler,
+  // where they are kept for the next block of the function.
   allnodes_clear();
-  OperandRecycler.clear(OperandAllocator);
-  OperandAllocator.Reset();
   CSEMap.clear();
 
   ExtendedValueTypeNodes.clear();
@@ -9163,8 +9181,13 @@ void SelectionDAG::createOperands(SDNode *Node, ArrayRef<SDValue> Vals) {
   assert(std::numeric_limits<decltype(SDNode::NumOperands)>::max() >
              Vals.size() &&
          "too many operands to fit into SDNode");
+  size_t BytesAllocated = OperandAllocator.getBytesAllocated();
   SDUse *Ops = OperandRecycler.allocate(
       ArrayRecycler<SDUse>::Capacity::get(Vals.size()), OperandAllocator);
+  if (OperandAllocator.getBytesAllocated() == BytesAllocated)
+    ++NumOperandListsReused;
+  else
+    ++NumOperandListsAllocated;
 
   bool IsDivergent = false;
   for (unsigned I = 0; I != Vals.size(); ++I) {
@@ -33,6 +33,7 @@
 #include "llvm/Analysis/EHPersonalities.h"
 #include "llvm/Analysis/Loads.h"
 #include "llvm/Analysis/MemoryLocation.h"
+#include "llvm/Analysis/OptimizationRemarkEmitter.h"
 #include "llvm/Analysis/TargetLibraryInfo.h"
 #include "llvm/Analysis/ValueTracking.h"
 #include "llvm/Analysis/VectorUtils.h"
@@ -10310,6 +10311,15 @@ MachineBasicBlock *SelectionDAGBuilder::peelDominantCaseCluster(
 
   LLVM_DEBUG(dbgs() << "Peeled one top case in switch stmt, prob: "
                     << TopCaseProb << "\n");
+  DAG.getORE().emit([&]() {
+    const CaseCluster &CC = Clusters[PeeledCaseIndex];
+    OptimizationRemarkAnalysis R("sdagisel", "SwitchCasePeeled", &SI);
+    R << "peeled switch case " << ore::NV("Case", CC.Low->getSExtValue());
+    if (CC.Low != CC.High)
+      R << "-" << ore::NV("CaseHigh", CC.High->getSExtValue());
+    return R << " with probability "
+             << ore::NV("Probability", TopCaseProb.scale(100)) << "%";
+  });
 
   // Record the MBB for the peeled switch statement.
   MachineFunction::iterator BBI(SwitchMBB);
@@ -10409,6 +10419,29 @@ void SelectionDAGBuilder::visitSwitch(const SwitchInst &SI) {
   findJumpTables(Clusters, &SI, DefaultMBB);
   findBitTestClusters(Clusters, &SI);
 
+  bool BuildSearchTree = Clusters.size() > 3 &&
+                         TM.getOptLevel() != CodeGenOpt::None &&
+                         !DefaultMBB->getParent()->getFunction().optForMinSize();
+  DAG.getORE().emit([&]() {
+    unsigned NumJumpTables = 0, NumBitTests = 0, NumRanges = 0;
+    for (const CaseCluster &C : Clusters) {
+      if (C.Kind == CC_JumpTable)
+        ++NumJumpTables;
+      else if (C.Kind == CC_BitTests)
+        ++NumBitTests;
+      else
+        ++NumRanges;
+    }
+    OptimizationRemarkAnalysis R("sdagisel", "SwitchLowering", &SI);
+    R << "lowered switch to " << ore::NV("NumJumpTables", NumJumpTables)
+      << " jump tables, " << ore::NV("NumBitTests", NumBitTests)
+      << " bit tests and " << ore::NV("NumRanges", NumRanges) << " ranges";
+    if (BuildSearchTree)
+      R << " in a " << (FuncInfo.BPI ? "probability-weighted" : "balanced")
+        << " binary search tree";
+    return R;
+  });
+
   LLVM_DEBUG({
     dbgs() << "Case clusters: ";
     for (const CaseCluster &C : Clusters) {
@@ -10445,8 +10478,7 @@ void SelectionDAGBuilder::visitSwitch(const SwitchInst &SI) {
     WorkList.pop_back();
     unsigned NumClusters = W.LastCluster - W.FirstCluster + 1;
 
-    if (NumClusters > 3 && TM.getOptLevel() != CodeGenOpt::None &&
-        !DefaultMBB->getParent()->getFunction().optForMinSize()) {
+    if (NumClusters > 3 && BuildSearchTree) {
       // For optimized builds, lower large range as a balanced binary tree.
       splitWorkItem(WorkList, W, SI.getCondition(), SwitchMBB);
       continue;
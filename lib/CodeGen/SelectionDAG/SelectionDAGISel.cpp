@@ -2813,9 +2813,31 @@ static unsigned IsPredicateKnownToFail(const unsigned char *Table,
   case SelectionDAGISel::OPC_CheckPatternPredicate:
     Result = !::CheckPatternPredicate(Table, Index, SDISel);
     return Index;
+  case SelectionDAGISel::OPC_CheckPatternPredicate0:
+  case SelectionDAGISel::OPC_CheckPatternPredicate1:
+  case SelectionDAGISel::OPC_CheckPatternPredicate2:
+  case SelectionDAGISel::OPC_CheckPatternPredicate3:
+  case SelectionDAGISel::OPC_CheckPatternPredicate4:
+  case SelectionDAGISel::OPC_CheckPatternPredicate5:
+  case SelectionDAGISel::OPC_CheckPatternPredicate6:
+  case SelectionDAGISel::OPC_CheckPatternPredicate7:
+    Result = !SDISel.CheckPatternPredicate(
+        Table[Index - 1] - SelectionDAGISel::OPC_CheckPatternPredicate0);
+    return Index;
   case SelectionDAGISel::OPC_CheckPredicate:
     Result = !::CheckNodePredicate(Table, Index, SDISel, N.getNode());
     return Index;
+  case SelectionDAGISel::OPC_CheckPredicate0:
+  case SelectionDAGISel::OPC_CheckPredicate1:
+  case SelectionDAGISel::OPC_CheckPredicate2:
+  case SelectionDAGISel::OPC_CheckPredicate3:
+  case SelectionDAGISel::OPC_CheckPredicate4:
+  case SelectionDAGISel::OPC_CheckPredicate5:
+  case SelectionDAGISel::OPC_CheckPredicate6:
+  case SelectionDAGISel::OPC_CheckPredicate7:
+    Result = !SDISel.CheckNodePredicate(
+        N.getNode(), Table[Index - 1] - SelectionDAGISel::OPC_CheckPredicate0);
+    return Index;
   case SelectionDAGISel::OPC_CheckOpcode:
     Result = !::CheckOpcode(Table, Index, N.getNode());
     return Index;
@@ -3188,6 +3210,26 @@ void SelectionDAGISel::SelectCodeCommon(SDNode *NodeToMatch,
       N = NodeStack.back();
       continue;
 
+    case OPC_MoveSibling:
+    case OPC_MoveSibling0: case OPC_MoveSibling1:
+    case OPC_MoveSibling2: case OPC_MoveSibling3:
+    case OPC_MoveSibling4: case OPC_MoveSibling5:
+    case OPC_MoveSibling6: case OPC_MoveSibling7: {
+      // Pop the current node off the NodeStack, then move to the specified
+      // child of the parent.
+      unsigned SiblingNo = Opcode == OPC_MoveSibling
+                               ? MatcherTable[MatcherIndex++]
+                               : Opcode - OPC_MoveSibling0;
+      NodeStack.pop_back();
+      assert(!NodeStack.empty() && "Node stack imbalance!");
+      N = NodeStack.back();
+      if (SiblingNo >= N.getNumOperands())
+        break;  // Match fails if out of range child #.
+      N = N.getOperand(SiblingNo);
+      NodeStack.push_back(N);
+      continue;
+    }
+
     case OPC_CheckSame:
       if (!::CheckSame(MatcherTable, MatcherIndex, N, RecordedNodes)) break;
       continue;
@@ -3202,11 +3244,24 @@ void SelectionDAGISel::SelectCodeCommon(SDNode *NodeToMatch,
     case OPC_CheckPatternPredicate:
       if (!::CheckPatternPredicate(MatcherTable, MatcherIndex, *this)) break;
       continue;
+    case OPC_CheckPatternPredicate0: case OPC_CheckPatternPredicate1:
+    case OPC_CheckPatternPredicate2: case OPC_CheckPatternPredicate3:
+    case OPC_CheckPatternPredicate4: case OPC_CheckPatternPredicate5:
+    case OPC_CheckPatternPredicate6: case OPC_CheckPatternPredicate7:
+      if (!CheckPatternPredicate(Opcode - OPC_CheckPatternPredicate0)) break;
+      continue;
     case OPC_CheckPredicate:
       if (!::CheckNodePredicate(MatcherTable, MatcherIndex, *this,
                                 N.getNode()))
         break;
       continue;
+    case OPC_CheckPredicate0: case OPC_CheckPredicate1:
+    case OPC_CheckPredicate2: case OPC_CheckPredicate3:
+    case OPC_CheckPredicate4: case OPC_CheckPredicate5:
+    case OPC_CheckPredicate6: case OPC_CheckPredicate7:
+      if (!CheckNodePredicate(N.getNode(), Opcode - OPC_CheckPredicate0))
+        break;
+      continue;
     case OPC_CheckPredicateWithOperands: {
       unsigned OpNum = MatcherTable[MatcherIndex++];
       SmallVector<SDValue, 8> Operands;
@@ -3257,8 +3312,20 @@ void SelectionDAGISel::SelectCodeCommon(SDNode *NodeToMatch,
 
     case OPC_SwitchOpcode: {
       unsigned CurNodeOpcode = N.getOpcode();
-      unsigned SwitchStart = MatcherIndex-1; (void)SwitchStart;
+      unsigned SwitchStart = MatcherIndex-1;
+
+      // Large switches remember which case each opcode dispatches to.
+      auto CachedCase =
+          SwitchOpcodeCases.find(std::make_pair(SwitchStart, CurNodeOpcode));
+      if (CachedCase != SwitchOpcodeCases.end()) {
+        if (CachedCase->second == 0)
+          break;
+        MatcherIndex = CachedCase->second;
+        continue;
+      }
+
       unsigned CaseSize;
+      unsigned NumSkippedCases = 0;
       while (true) {
         // Get the size of this case.
         CaseSize = MatcherTable[MatcherIndex++];
@@ -3275,8 +3342,14 @@ void SelectionDAGISel::SelectCodeCommon(SDNode *NodeToMatch,
 
         // Otherwise, skip over this case.
         MatcherIndex += CaseSize;
+        ++NumSkippedCases;
       }
 
+      // Scanning a few cases is cheaper than a lookup in the cache.
+      if (NumSkippedCases >= 8)
+        SwitchOpcodeCases[std::make_pair(SwitchStart, CurNodeOpcode)] =
+            CaseSize == 0 ? 0 : MatcherIndex;
+
       // If no cases matched, bail out.
       if (CaseSize == 0) break;
 
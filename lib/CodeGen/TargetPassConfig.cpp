@@ -23,6 +23,7 @@
 #include "llvm/Analysis/ScopedNoAliasAA.h"
 #include "llvm/Analysis/TargetTransformInfo.h"
 #include "llvm/Analysis/TypeBasedAliasAnalysis.h"
+#include "llvm/CodeGen/GlobalISelReport.h"
 #include "llvm/CodeGen/MachineFunctionPass.h"
 #include "llvm/CodeGen/MachinePassRegistry.h"
 #include "llvm/CodeGen/Passes.h"
@@ -147,6 +148,11 @@ static cl::opt<GlobalISelAbortMode> EnableGlobalISelAbort(
         clEnumValN(GlobalISelAbortMode::DisableWithDiag, "2",
                    "Disable the abort but emit a diagnostic on failure")));
 
+static cl::opt<std::string> GlobalISelReportFile(
+    "global-isel-report", cl::Hidden, cl::value_desc("filename"),
+    cl::desc("Write a JSON report of the GlobalISel time and fallback reason "
+             "of every function to this file"));
+
 // Temporary option to allow experimenting with MachineScheduler as a post-RA
 // scheduler. Targets can "properly" enable this with
 // substitutePass(&PostRASchedulerID, &PostMachineSchedulerID).
@@ -626,7 +632,11 @@ void TargetPassConfig::addIRPasses() {
   // support "obvious" type-punning idioms.
   addPass(createTypeBasedAAWrapperPass());
   addPass(createScopedNoAliasAAWrapperPass());
-  addPass(createBasicAAWrapperPass());
+  // At -O0 nothing queries alias analysis by default, so don't compute BasicAA
+  // and the dominator tree it needs for every function up front; a pass that
+  // does ask for AA still gets it scheduled on demand.
+  if (getOptLevel() != CodeGenOpt::None)
+    addPass(createBasicAAWrapperPass());
 
   // Before running any passes, run the verifier to determine if the input
   // coming from the front-end and/or optimizer is valid.
@@ -771,6 +781,9 @@ bool TargetPassConfig::addCoreISelPasses() {
     TM->setGlobalISel(true);
     TM->setFastISel(false);
 
+    if (!GlobalISelReportFile.empty())
+      addPass(createGlobalISelReportPass(GlobalISelReportFile));
+
     SaveAndRestore<bool> SavedAddingMachinePasses(AddingMachinePasses, true);
     if (addIRTranslator())
       return true;
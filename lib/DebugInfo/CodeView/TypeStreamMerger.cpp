@@ -17,6 +17,10 @@
 #include "llvm/DebugInfo/CodeView/TypeIndexDiscovery.h"
 #include "llvm/DebugInfo/CodeView/TypeRecord.h"
 #include "llvm/Support/Error.h"
+#include "llvm/Support/MathExtras.h"
+#include "llvm/Support/ThreadPool.h"
+#include <atomic>
+#include <memory>
 
 using namespace llvm;
 using namespace llvm::codeview;
@@ -492,3 +496,223 @@ Expected<bool> TypeStreamMerger::shouldRemapType(const CVType &Type) {
   }
   return true;
 }
+
+namespace {
+
+/// A lock-free hash table that maps the global hashes of the records of
+/// several sources to the first record they occur at.
+///
+/// A cell holds the position (Source + 1) << 32 | Record of a record, so
+/// cells compare like the records of the concatenated sources and 0 marks an
+/// empty cell. Cells are keyed by the hash of the record they point to, and
+/// only ever change to a smaller position with the same hash, which makes
+/// the final contents independent of the order of insertion.
+class GHashTable {
+public:
+  GHashTable(ArrayRef<GloballyHashedTypeSource> Sources, size_t NumRecords)
+      : Sources(Sources),
+        Mask(PowerOf2Ceil(std::max<size_t>(2 * NumRecords, 16)) - 1),
+        Cells(new std::atomic<uint64_t>[Mask + 1]) {
+    for (size_t I = 0; I <= Mask; ++I)
+      Cells[I].store(0, std::memory_order_relaxed);
+  }
+
+  static uint64_t getPosition(uint32_t Source, uint32_t Record) {
+    return (uint64_t(Source) + 1) << 32 | Record;
+  }
+
+  /// Record that the record at \p Pos has global hash \p H.
+  void insert(const GloballyHashedType &H, uint64_t Pos) {
+    for (size_t Idx = getSlot(H);; Idx = (Idx + 1) & Mask) {
+      uint64_t Cur = Cells[Idx].load(std::memory_order_acquire);
+      while (Cur == 0 && !Cells[Idx].compare_exchange_weak(Cur, Pos))
+        ;
+      if (Cur == 0)
+        return;
+      if (getHash(Cur).Hash != H.Hash)
+        continue;
+      while (Pos < Cur && !Cells[Idx].compare_exchange_weak(Cur, Pos))
+        ;
+      return;
+    }
+  }
+
+  /// Returns the position of the first record with global hash \p H, which
+  /// must have been inserted.
+  uint64_t lookup(const GloballyHashedType &H) const {
+    for (size_t Idx = getSlot(H);; Idx = (Idx + 1) & Mask) {
+      uint64_t Cur = Cells[Idx].load(std::memory_order_acquire);
+      assert(Cur != 0 && "Hash was not inserted");
+      if (getHash(Cur).Hash == H.Hash)
+        return Cur;
+    }
+  }
+
+private:
+  size_t getSlot(const GloballyHashedType &H) const {
+    // Global hashes are truncated SHA1 hashes, so any of their bits will do.
+    uint64_t Bits;
+    ::memcpy(&Bits, H.Hash.data(), sizeof(Bits));
+    return Bits & Mask;
+  }
+
+  const GloballyHashedType &getHash(uint64_t Pos) const {
+    return Sources[(Pos >> 32) - 1].Hashes[uint32_t(Pos)];
+  }
+
+  ArrayRef<GloballyHashedTypeSource> Sources;
+  size_t Mask;
+  std::unique_ptr<std::atomic<uint64_t>[]> Cells;
+};
+
+} // end anonymous namespace
+
+Error llvm::codeview::mergeTypeAndIdRecords(
+    GlobalTypeTableBuilder &DestIds, GlobalTypeTableBuilder &DestTypes,
+    MutableArrayRef<SmallVector<TypeIndex, 0>> SourceToDest,
+    ArrayRef<GloballyHashedTypeSource> Sources, unsigned NumThreads) {
+  assert(SourceToDest.size() == Sources.size() &&
+         "One index map per source expected");
+  Optional<ThreadPool> Pool;
+  if (NumThreads > 1)
+    Pool.emplace(NumThreads);
+  auto ForEachSource = [&](function_ref<void(uint32_t)> Fn) {
+    for (uint32_t I = 0, E = Sources.size(); I != E; ++I) {
+      if (Pool)
+        Pool->async([=] { Fn(I); });
+      else
+        Fn(I);
+    }
+    if (Pool)
+      Pool->wait();
+  };
+
+  // Split the sources into their records.
+  std::vector<std::vector<CVType>> Records(Sources.size());
+  std::vector<Optional<Error>> Errors(Sources.size());
+  ForEachSource([&](uint32_t I) {
+    BinaryStreamRef Stream = Sources[I].IdsAndTypes->getUnderlyingStream();
+    ArrayRef<uint8_t> Buffer;
+    cantFail(Stream.readBytes(0, Stream.getLength(), Buffer));
+    Error E = forEachCodeViewRecord<CVType>(
+        Buffer, [&](const CVType &Type) -> Error {
+          switch (Type.kind()) {
+          case LF_PRECOMP:
+          case LF_ENDPRECOMP:
+          case LF_TYPESERVER2:
+            return make_error<CodeViewError>(
+                cv_error_code::operation_unsupported,
+                "precompiled types must be merged one source at a time");
+          default:
+            Records[I].push_back(Type);
+            return Error::success();
+          }
+        });
+    if (!E && Records[I].size() != Sources[I].Hashes.size())
+      E = make_error<CodeViewError>(
+          cv_error_code::corrupt_record,
+          "the number of global hashes does not match the number of records");
+    if (E)
+      Errors[I] = std::move(E);
+  });
+  Error Err = Error::success();
+  for (Optional<Error> &E : Errors)
+    if (E)
+      Err = joinErrors(std::move(Err), std::move(*E));
+  if (Err)
+    return Err;
+
+  size_t NumRecords = 0;
+  for (const std::vector<CVType> &R : Records)
+    NumRecords += R.size();
+  GHashTable Table(Sources, NumRecords);
+  ForEachSource([&](uint32_t I) {
+    ArrayRef<GloballyHashedType> Hashes = Sources[I].Hashes;
+    for (uint32_t R = 0, E = Hashes.size(); R != E; ++R)
+      Table.insert(Hashes[R], GHashTable::getPosition(I, R));
+  });
+
+  std::vector<std::vector<uint64_t>> FirstPositions(Sources.size());
+  ForEachSource([&](uint32_t I) {
+    ArrayRef<GloballyHashedType> Hashes = Sources[I].Hashes;
+    FirstPositions[I].resize(Hashes.size());
+    for (uint32_t R = 0, E = Hashes.size(); R != E; ++R)
+      FirstPositions[I][R] = Table.lookup(Hashes[R]);
+  });
+
+  // Add the first occurrence of every record to its destination, in the order
+  // a merge of one source at a time would. The type indices of these records
+  // are re-written once the destination of every record is known.
+  struct PendingRecord {
+    uint32_t Source;
+    MutableArrayRef<uint8_t> Data;
+  };
+  std::vector<PendingRecord> Pending;
+  for (uint32_t I = 0, E = Sources.size(); I != E; ++I) {
+    SourceToDest[I].assign(Records[I].size(), TypeStreamMerger::Untranslated);
+    for (uint32_t R = 0, RE = Records[I].size(); R != RE; ++R) {
+      if (FirstPositions[I][R] != GHashTable::getPosition(I, R))
+        continue;
+      const CVType &Type = Records[I][R];
+      GlobalTypeTableBuilder &Dest =
+          isIdRecord(Type.kind()) ? DestIds : DestTypes;
+      SourceToDest[I][R] = Dest.insertRecordAs(
+          Sources[I].Hashes[R], Type.RecordData.size(),
+          [&](MutableArrayRef<uint8_t> Data) -> ArrayRef<uint8_t> {
+            ::memcpy(Data.data(), Type.RecordData.data(),
+                     Type.RecordData.size());
+            Pending.push_back({I, Data});
+            return Data;
+          });
+    }
+  }
+
+  // Forward every other record to its first occurrence.
+  ForEachSource([&](uint32_t I) {
+    for (uint32_t R = 0, E = Records[I].size(); R != E; ++R) {
+      uint64_t First = FirstPositions[I][R];
+      if (First != GHashTable::getPosition(I, R))
+        SourceToDest[I][R] = SourceToDest[(First >> 32) - 1][uint32_t(First)];
+    }
+  });
+
+  std::atomic<bool> Corrupt(false);
+  auto RemapRecords = [&](size_t Begin, size_t End) {
+    SmallVector<TiReference, 4> Refs;
+    for (size_t P = Begin; P != End; ++P) {
+      MutableArrayRef<uint8_t> Data = Pending[P].Data;
+      ArrayRef<TypeIndex> Map = SourceToDest[Pending[P].Source];
+      Refs.clear();
+      discoverTypeIndices(Data, Refs);
+      uint8_t *Content = Data.data() + sizeof(RecordPrefix);
+      for (const TiReference &Ref : Refs) {
+        TypeIndex *TIs = reinterpret_cast<TypeIndex *>(Content + Ref.Offset);
+        for (size_t K = 0; K != Ref.Count; ++K) {
+          TypeIndex &TI = TIs[K];
+          if (TI.isSimple())
+            continue;
+          if (LLVM_LIKELY(slotForIndex(TI) < Map.size())) {
+            TI = Map[slotForIndex(TI)];
+          } else {
+            TI = TypeStreamMerger::Untranslated;
+            Corrupt = true;
+          }
+        }
+      }
+    }
+  };
+  const size_t BatchSize = 1024;
+  for (size_t Begin = 0, E = Pending.size(); Begin < E; Begin += BatchSize) {
+    size_t End = std::min(Begin + BatchSize, E);
+    if (Pool)
+      Pool->async([=] { RemapRecords(Begin, End); });
+    else
+      RemapRecords(Begin, End);
+  }
+  if (Pool)
+    Pool->wait();
+
+  if (Corrupt)
+    return make_error<CodeViewError>(cv_error_code::corrupt_record);
+  return Error::success();
+}
@@ -9,6 +9,7 @@
 
 #include "llvm/DebugInfo/DWARF/DWARFAbbreviationDeclaration.h"
 
+#include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/None.h"
 #include "llvm/ADT/Optional.h"
 #include "llvm/BinaryFormat/Dwarf.h"
@@ -18,6 +19,7 @@
 #include "llvm/Support/Format.h"
 #include "llvm/Support/FormatVariadic.h"
 #include "llvm/Support/raw_ostream.h"
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 
@@ -31,6 +33,7 @@ void DWARFAbbreviationDeclaration::clear() {
   HasChildren = false;
   AttributeSpecs.clear();
   FixedAttributeSize.reset();
+  AttributeOffsets.clear();
 }
 
 DWARFAbbreviationDeclaration::DWARFAbbreviationDeclaration() {
@@ -64,6 +67,10 @@ DWARFAbbreviationDeclaration::extract(DataExtractor Data,
     auto A = static_cast<Attribute>(Data.getULEB128(OffsetPtr));
     auto F = static_cast<Form>(Data.getULEB128(OffsetPtr));
     if (A && F) {
+      // While all preceding attributes have a fixed size, so does the offset
+      // of this one.
+      if (FixedAttributeSize)
+        AttributeOffsets.push_back(*FixedAttributeSize);
       bool IsImplicitConst = (F == DW_FORM_implicit_const);
       if (IsImplicitConst) {
         int64_t V = Data.getSLEB128(OffsetPtr);
@@ -157,11 +164,15 @@ Optional<DWARFFormValue> DWARFAbbreviationDeclaration::getAttributeValue(
 
   auto DebugInfoData = U.getDebugInfoExtractor();
 
-  // Add the byte size of ULEB that for the abbrev Code so we can start
-  // skipping the attribute data.
-  uint32_t Offset = DIEOffset + CodeByteSize;
-  uint32_t AttrIndex = 0;
-  for (const auto &Spec : AttributeSpecs) {
+  // Add the byte size of ULEB that for the abbrev Code and the known offset of
+  // the attribute, or of the last attribute with a fixed offset before it, so
+  // we can start skipping the attribute data from there.
+  assert(!AttributeOffsets.empty() && "first attribute has no offset");
+  uint32_t AttrIndex =
+      std::min<uint32_t>(*MatchAttrIndex, AttributeOffsets.size() - 1);
+  uint32_t Offset =
+      DIEOffset + CodeByteSize + AttributeOffsets[AttrIndex].getByteSize(U);
+  for (const auto &Spec : makeArrayRef(AttributeSpecs).drop_front(AttrIndex)) {
     if (*MatchAttrIndex == AttrIndex) {
       // We have arrived at the attribute to extract, extract if from Offset.
       DWARFFormValue FormValue(Spec.Form);
@@ -45,6 +45,7 @@
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/TargetRegistry.h"
+#include "llvm/Support/ThreadPool.h"
 #include "llvm/Support/WithColor.h"
 #include "llvm/Support/raw_ostream.h"
 #include <algorithm>
@@ -647,6 +648,46 @@ DWARFDie DWARFContext::getDIEForOffset(uint32_t Offset) {
   return DWARFDie();
 }
 
+void DWARFContext::extractAllDIEs(unsigned NumThreads) {
+  DWARFContext *Context = this;
+  extractAllDIEs(Context, NumThreads);
+}
+
+void DWARFContext::extractAllDIEs(ArrayRef<DWARFContext *> Contexts,
+                                  unsigned NumThreads) {
+  std::vector<DWARFUnit *> Units;
+  for (DWARFContext *Context : Contexts) {
+    for (const auto &U : Context->normal_units())
+      Units.push_back(U.get());
+    for (const auto &U : Context->dwo_units())
+      Units.push_back(U.get());
+  }
+
+  // The abbreviation sets are parsed lazily into a map that is shared by all
+  // units of a context, so resolve them up front. The units do not share any
+  // other state while their DIEs are extracted.
+  std::vector<DWARFUnit *> ParallelUnits;
+  for (DWARFUnit *U : Units) {
+    if (NumThreads && U->getAbbreviations())
+      ParallelUnits.push_back(U);
+    else
+      U->getNumDIEs();
+  }
+  if (ParallelUnits.empty())
+    return;
+
+  // Hand out the units largest first, so one big unit that ends up last does
+  // not leave the other threads idle.
+  std::stable_sort(ParallelUnits.begin(), ParallelUnits.end(),
+                   [](const DWARFUnit *A, const DWARFUnit *B) {
+                     return A->getLength() > B->getLength();
+                   });
+  ThreadPool Pool(NumThreads);
+  for (DWARFUnit *U : ParallelUnits)
+    Pool.async([U] { U->getNumDIEs(); });
+  Pool.wait();
+}
+
 bool DWARFContext::verify(raw_ostream &OS, DIDumpOptions DumpOpts) {
   bool Success = true;
   DWARFVerifier verifier(OS, *this, DumpOpts);
@@ -985,6 +1026,43 @@ DILineInfo DWARFContext::getLineInfoForAddress(uint64_t Address,
   return Result;
 }
 
+std::vector<DILineInfo>
+DWARFContext::getLineInfoForAddresses(ArrayRef<uint64_t> Addresses,
+                                      DILineInfoSpecifier Spec) {
+  assert(std::is_sorted(Addresses.begin(), Addresses.end()) &&
+         "addresses must be ascending");
+  std::vector<DILineInfo> Results(Addresses.size());
+  const DWARFDebugAranges *Aranges = getDebugAranges();
+  size_t ArangeHint = 0;
+  uint32_t CUOffset = -1U;
+  DWARFCompileUnit *CU = nullptr;
+  const DWARFLineTable *LineTable = nullptr;
+  DWARFLineTable::Cursor LineCursor;
+
+  for (size_t I = 0, E = Addresses.size(); I != E; ++I) {
+    uint64_t Address = Addresses[I];
+    uint32_t Offset = Aranges->findAddress(Address, ArangeHint);
+    if (Offset != CUOffset) {
+      CUOffset = Offset;
+      CU = getCompileUnitForOffset(Offset);
+      LineTable = CU && Spec.FLIKind != FileLineInfoKind::None
+                      ? getLineTableForUnit(CU)
+                      : nullptr;
+      LineCursor = DWARFLineTable::Cursor();
+    }
+    if (!CU)
+      continue;
+    DILineInfo &Result = Results[I];
+    getFunctionNameAndStartLineForAddress(CU, Address, Spec.FNKind,
+                                          Result.FunctionName,
+                                          Result.StartLine);
+    if (LineTable)
+      LineTable->getFileLineInfoForAddress(Address, CU->getCompilationDir(),
+                                           Spec.FLIKind, Result, LineCursor);
+  }
+  return Results;
+}
+
 DILineInfoTable
 DWARFContext::getLineInfoForAddressRange(uint64_t Address, uint64_t Size,
                                          DILineInfoSpecifier Spec) {
@@ -129,3 +129,13 @@ uint32_t DWARFDebugAranges::findAddress(uint64_t Address) const {
   }
   return -1U;
 }
+
+uint32_t DWARFDebugAranges::findAddress(uint64_t Address, size_t &Hint) const {
+  if (Hint >= Aranges.size())
+    return -1U;
+  while (Hint + 1 < Aranges.size() && Aranges[Hint + 1].LowPC <= Address)
+    ++Hint;
+  if (Aranges[Hint].containsAddress(Address))
+    return Aranges[Hint].CUOffset;
+  return -1U;
+}
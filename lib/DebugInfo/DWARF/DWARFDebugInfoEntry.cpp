@@ -28,9 +28,9 @@ bool DWARFDebugInfoEntry::extractFast(const DWARFUnit &U,
 
 bool DWARFDebugInfoEntry::extractFast(const DWARFUnit &U, uint32_t *OffsetPtr,
                                       const DWARFDataExtractor &DebugInfoData,
-                                      uint32_t UEndOffset, uint32_t D) {
+                                      uint32_t UEndOffset, uint32_t P) {
   Offset = *OffsetPtr;
-  Depth = D;
+  ParentIdx = P;
   if (Offset >= UEndOffset || !DebugInfoData.isValidOffset(Offset))
     return false;
   uint64_t AbbrCode = DebugInfoData.getULEB128(OffsetPtr);
@@ -411,6 +411,12 @@ void DWARFDebugLine::LineTable::clear() {
   Prologue.clear();
   Rows.clear();
   Sequences.clear();
+  LookupKeys.clear();
+  LookupRanks.clear();
+  SeqLookupOffsets.clear();
+  LookupNumRows = 0;
+  FileNameCache.clear();
+  FileNameCacheKind = FileLineInfoKind::None;
 }
 
 DWARFDebugLine::ParsingState::ParsingState(struct LineTable *LT)
@@ -851,6 +857,66 @@ Error DWARFDebugLine::LineTable::parse(
   return Error::success();
 }
 
+/// Lays out the keys GetKey(0) <= ... <= GetKey(N - 1) in Eytzinger order
+/// starting at node \p K, where the children of node K are the nodes 2K and
+/// 2K + 1, and records the sorted position of each node in \p Ranks.
+static void fillEytzinger(function_ref<uint64_t(uint32_t)> GetKey, uint32_t N,
+                          uint64_t K, uint32_t &Next, uint64_t *Keys,
+                          uint32_t *Ranks) {
+  if (K > N)
+    return;
+  fillEytzinger(GetKey, N, 2 * K, Next, Keys, Ranks);
+  Keys[K - 1] = GetKey(Next);
+  Ranks[K - 1] = Next++;
+  fillEytzinger(GetKey, N, 2 * K + 1, Next, Keys, Ranks);
+}
+
+/// Returns the sorted position of the first of the \p N keys laid out by
+/// fillEytzinger that is not less than \p X, or N if there is none.
+static uint32_t eytzingerLowerBound(const uint64_t *Keys,
+                                    const uint32_t *Ranks, uint32_t N,
+                                    uint64_t X) {
+  uint64_t K = 1;
+  while (K <= N)
+    K = 2 * K + (Keys[K - 1] < X);
+  // The answer is the last node the search went left at, i.e. K without its
+  // trailing right turns and the left turn before them.
+  K >>= countTrailingOnes(K) + 1;
+  return K ? Ranks[K - 1] : N;
+}
+
+bool DWARFDebugLine::LineTable::buildLookupIndex() const {
+  if (Sequences.empty())
+    return false;
+  if (SeqLookupOffsets.size() == Sequences.size() &&
+      LookupNumRows == Rows.size())
+    return true;
+
+  size_t NumKeys = Sequences.size();
+  SeqLookupOffsets.clear();
+  for (const Sequence &Seq : Sequences) {
+    SeqLookupOffsets.push_back(NumKeys);
+    NumKeys += Seq.LastRowIndex - Seq.FirstRowIndex;
+  }
+  LookupKeys.resize(NumKeys);
+  LookupRanks.resize(NumKeys);
+  LookupNumRows = Rows.size();
+
+  uint32_t Next = 0;
+  fillEytzinger([&](uint32_t I) { return Sequences[I].LowPC; },
+                Sequences.size(), 1, Next, LookupKeys.data(),
+                LookupRanks.data());
+  for (size_t I = 0, E = Sequences.size(); I != E; ++I) {
+    const Sequence &Seq = Sequences[I];
+    Next = 0;
+    fillEytzinger(
+        [&](uint32_t J) { return Rows[Seq.FirstRowIndex + J].Address; },
+        Seq.LastRowIndex - Seq.FirstRowIndex, 1, Next,
+        &LookupKeys[SeqLookupOffsets[I]], &LookupRanks[SeqLookupOffsets[I]]);
+  }
+  return true;
+}
+
 uint32_t
 DWARFDebugLine::LineTable::findRowInSeq(const DWARFDebugLine::Sequence &Seq,
                                         uint64_t Address) const {
@@ -859,12 +925,23 @@ DWARFDebugLine::LineTable::findRowInSeq(const DWARFDebugLine::Sequence &Seq,
   // Search for instruction address in the rows describing the sequence.
   // Rows are stored in a vector, so we may use arithmetical operations with
   // iterators.
-  DWARFDebugLine::Row Row;
-  Row.Address = Address;
   RowIter FirstRow = Rows.begin() + Seq.FirstRowIndex;
   RowIter LastRow = Rows.begin() + Seq.LastRowIndex;
-  LineTable::RowIter RowPos = std::lower_bound(
-      FirstRow, LastRow, Row, DWARFDebugLine::Row::orderByAddress);
+  RowIter RowPos;
+  if (buildLookupIndex()) {
+    assert(&Seq >= Sequences.data() &&
+           &Seq < Sequences.data() + Sequences.size() &&
+           "Sequence not in this line table");
+    uint32_t Offset = SeqLookupOffsets[&Seq - Sequences.data()];
+    RowPos = FirstRow + eytzingerLowerBound(&LookupKeys[Offset],
+                                            &LookupRanks[Offset],
+                                            LastRow - FirstRow, Address);
+  } else {
+    DWARFDebugLine::Row Row;
+    Row.Address = Address;
+    RowPos = std::lower_bound(FirstRow, LastRow, Row,
+                              DWARFDebugLine::Row::orderByAddress);
+  }
   if (RowPos == LastRow) {
     return Seq.LastRowIndex - 1;
   }
@@ -878,27 +955,56 @@ DWARFDebugLine::LineTable::findRowInSeq(const DWARFDebugLine::Sequence &Seq,
   return Index;
 }
 
-uint32_t DWARFDebugLine::LineTable::lookupAddress(uint64_t Address) const {
-  if (Sequences.empty())
-    return UnknownRowIndex;
-  // First, find an instruction sequence containing the given address.
-  DWARFDebugLine::Sequence Sequence;
-  Sequence.LowPC = Address;
+const DWARFDebugLine::Sequence *
+DWARFDebugLine::LineTable::findSequence(uint64_t Address) const {
+  if (!buildLookupIndex())
+    return nullptr;
+  // Find the last instruction sequence starting at or before the address.
   SequenceIter FirstSeq = Sequences.begin();
   SequenceIter LastSeq = Sequences.end();
-  SequenceIter SeqPos = std::lower_bound(
-      FirstSeq, LastSeq, Sequence, DWARFDebugLine::Sequence::orderByLowPC);
-  DWARFDebugLine::Sequence FoundSeq;
-  if (SeqPos == LastSeq) {
-    FoundSeq = Sequences.back();
-  } else if (SeqPos->LowPC == Address) {
-    FoundSeq = *SeqPos;
-  } else {
-    if (SeqPos == FirstSeq)
-      return UnknownRowIndex;
-    FoundSeq = *(SeqPos - 1);
+  SequenceIter SeqPos =
+      FirstSeq + eytzingerLowerBound(LookupKeys.data(), LookupRanks.data(),
+                                     Sequences.size(), Address);
+  if (SeqPos == LastSeq)
+    return &Sequences.back();
+  if (SeqPos->LowPC == Address)
+    return &*SeqPos;
+  if (SeqPos == FirstSeq)
+    return nullptr;
+  return &*(SeqPos - 1);
+}
+
+uint32_t DWARFDebugLine::LineTable::lookupAddress(uint64_t Address) const {
+  const DWARFDebugLine::Sequence *Seq = findSequence(Address);
+  if (!Seq)
+    return UnknownRowIndex;
+  return findRowInSeq(*Seq, Address);
+}
+
+uint32_t DWARFDebugLine::LineTable::lookupAddress(uint64_t Address,
+                                                  Cursor &C) const {
+  if (C.Seq && C.Seq->containsPC(Address) && Rows[C.Row].Address <= Address) {
+    // Every row before C.Row has a lower address than Address, so the first
+    // row that is not lower is found by walking forward from it.
+    uint32_t Index = C.Row;
+    while (Index < C.Seq->LastRowIndex && Rows[Index].Address < Address)
+      ++Index;
+    if (Index == C.Seq->LastRowIndex || Rows[Index].Address > Address)
+      --Index;
+    C.Row = Index;
+    return Index;
   }
-  return findRowInSeq(FoundSeq, Address);
+
+  C = Cursor();
+  const DWARFDebugLine::Sequence *Seq = findSequence(Address);
+  if (!Seq)
+    return UnknownRowIndex;
+  uint32_t Index = findRowInSeq(*Seq, Address);
+  if (Index != UnknownRowIndex) {
+    C.Seq = Seq;
+    C.Row = Index;
+  }
+  return Index;
 }
 
 bool DWARFDebugLine::LineTable::lookupAddressRange(
@@ -1011,16 +1117,51 @@ bool DWARFDebugLine::LineTable::getFileNameByIndex(uint64_t FileIndex,
   return true;
 }
 
+bool DWARFDebugLine::LineTable::getCachedFileName(uint64_t FileIndex,
+                                                  const char *CompDir,
+                                                  FileLineInfoKind Kind,
+                                                  std::string &Result) const {
+  if (Kind == FileLineInfoKind::None || !hasFileAtIndex(FileIndex))
+    return false;
+  StringRef CompDirRef = CompDir ? CompDir : "";
+  if (Kind != FileNameCacheKind || CompDirRef != FileNameCacheCompDir) {
+    FileNameCache.clear();
+    FileNameCacheKind = Kind;
+    FileNameCacheCompDir = CompDirRef;
+  }
+  if (FileNameCache.size() != Prologue.FileNames.size())
+    FileNameCache.resize(Prologue.FileNames.size());
+  Optional<std::string> &Name = FileNameCache[FileIndex - 1];
+  if (!Name) {
+    Name.emplace();
+    getFileNameByIndex(FileIndex, CompDir, Kind, *Name);
+  }
+  Result = *Name;
+  return true;
+}
+
 bool DWARFDebugLine::LineTable::getFileLineInfoForAddress(
     uint64_t Address, const char *CompDir, FileLineInfoKind Kind,
     DILineInfo &Result) const {
   // Get the index of row we're looking for in the line table.
-  uint32_t RowIndex = lookupAddress(Address);
+  return getFileLineInfoForRow(lookupAddress(Address), CompDir, Kind, Result);
+}
+
+bool DWARFDebugLine::LineTable::getFileLineInfoForAddress(
+    uint64_t Address, const char *CompDir, FileLineInfoKind Kind,
+    DILineInfo &Result, Cursor &C) const {
+  return getFileLineInfoForRow(lookupAddress(Address, C), CompDir, Kind,
+                               Result);
+}
+
+bool DWARFDebugLine::LineTable::getFileLineInfoForRow(
+    uint32_t RowIndex, const char *CompDir, FileLineInfoKind Kind,
+    DILineInfo &Result) const {
   if (RowIndex == -1U)
     return false;
   // Take file number and line/column from the row.
   const auto &Row = Rows[RowIndex];
-  if (!getFileNameByIndex(Row.File, CompDir, Kind, Result.FileName))
+  if (!getCachedFileName(Row.File, CompDir, Kind, Result.FileName))
     return false;
   Result.Line = Row.Line;
   Result.Column = Row.Column;
@@ -355,16 +355,19 @@ void DWARFUnit::extractDIEsToVector(
   uint32_t NextCUOffset = getNextUnitOffset();
   DWARFDebugInfoEntry DIE;
   DWARFDataExtractor DebugInfoData = getDebugInfoExtractor();
-  uint32_t Depth = 0;
+  // The indices of the DIEs whose children are being extracted, innermost
+  // last. Without AppendCUDie, the unit DIE is expected at the back of Dies.
+  SmallVector<uint32_t, 16> Parents;
   bool IsCUDie = true;
 
   while (DIE.extractFast(*this, &DIEOffset, DebugInfoData, NextCUOffset,
-                         Depth)) {
+                         Parents.empty() ? 0 : Parents.back())) {
     if (IsCUDie) {
       if (AppendCUDie)
         Dies.push_back(DIE);
       if (!AppendNonCUDies)
         break;
+      assert(!Dies.empty() && "unit DIE was not extracted");
       // The average bytes per DIE entry has been seen to be
       // around 14-20 so let's pre-reserve the needed memory for
       // our DIE entries accordingly.
@@ -378,12 +381,12 @@ void DWARFUnit::extractDIEsToVector(
             DIE.getAbbreviationDeclarationPtr()) {
       // Normal DIE
       if (AbbrDecl->hasChildren())
-        ++Depth;
+        Parents.push_back(Dies.size() - 1);
     } else {
       // NULL DIE.
-      if (Depth > 0)
-        --Depth;
-      if (Depth == 0)
+      if (!Parents.empty())
+        Parents.pop_back();
+      if (Parents.empty())
         break;  // We are done with this compile unit!
     }
   }
@@ -404,6 +407,10 @@ size_t DWARFUnit::extractDIEsIfNeeded(bool CUDieOnly) {
 
   bool HasCUDie = !DieArray.empty();
   extractDIEsToVector(!HasCUDie, !CUDieOnly, DieArray);
+  // The array was reserved from an estimate of the number of DIEs; give back
+  // what the unit didn't need.
+  if (!CUDieOnly)
+    DieArray.shrink_to_fit();
 
   if (DieArray.empty())
     return 0;
@@ -682,37 +689,27 @@ const DWARFUnitIndex &llvm::getDWARFUnitIndex(DWARFContext &Context,
 DWARFDie DWARFUnit::getParent(const DWARFDebugInfoEntry *Die) {
   if (!Die)
     return DWARFDie();
-  const uint32_t Depth = Die->getDepth();
-  // Unit DIEs always have a depth of zero and never have parents.
-  if (Depth == 0)
+  // Unit DIEs are always first and never have parents.
+  if (getDIEIndex(Die) == 0)
     return DWARFDie();
-  // Depth of 1 always means parent is the compile/type unit.
-  if (Depth == 1)
-    return getUnitDIE();
-  // Look for previous DIE with a depth that is one less than the Die's depth.
-  const uint32_t ParentDepth = Depth - 1;
-  for (uint32_t I = getDIEIndex(Die) - 1; I > 0; --I) {
-    if (DieArray[I].getDepth() == ParentDepth)
-      return DWARFDie(this, &DieArray[I]);
-  }
-  return DWARFDie();
+  return DWARFDie(this, &DieArray[Die->getParentIdx()]);
 }
 
 DWARFDie DWARFUnit::getSibling(const DWARFDebugInfoEntry *Die) {
   if (!Die)
     return DWARFDie();
-  uint32_t Depth = Die->getDepth();
-  // Unit DIEs always have a depth of zero and never have siblings.
-  if (Depth == 0)
+  uint32_t Idx = getDIEIndex(Die);
+  // Unit DIEs are always first and never have siblings.
+  if (Idx == 0)
     return DWARFDie();
   // NULL DIEs don't have siblings.
   if (Die->getAbbreviationDeclarationPtr() == nullptr)
     return DWARFDie();
 
-  // Find the next DIE whose depth is the same as the Die's depth.
-  for (size_t I = getDIEIndex(Die) + 1, EndIdx = DieArray.size(); I < EndIdx;
-       ++I) {
-    if (DieArray[I].getDepth() == Depth)
+  // Find the next DIE with the same parent as Die.
+  uint32_t ParentIdx = Die->getParentIdx();
+  for (size_t I = Idx + 1, EndIdx = DieArray.size(); I < EndIdx; ++I) {
+    if (DieArray[I].getParentIdx() == ParentIdx)
       return DWARFDie(this, &DieArray[I]);
   }
   return DWARFDie();
@@ -721,17 +718,18 @@ DWARFDie DWARFUnit::getSibling(const DWARFDebugInfoEntry *Die) {
 DWARFDie DWARFUnit::getPreviousSibling(const DWARFDebugInfoEntry *Die) {
   if (!Die)
     return DWARFDie();
-  uint32_t Depth = Die->getDepth();
-  // Unit DIEs always have a depth of zero and never have siblings.
-  if (Depth == 0)
+  uint32_t Idx = getDIEIndex(Die);
+  // Unit DIEs are always first and never have siblings.
+  if (Idx == 0)
     return DWARFDie();
 
-  // Find the previous DIE whose depth is the same as the Die's depth.
-  for (size_t I = getDIEIndex(Die); I > 0;) {
+  // Find the previous DIE with the same parent as Die, stopping at the parent.
+  uint32_t ParentIdx = Die->getParentIdx();
+  for (size_t I = Idx; I > ParentIdx;) {
     --I;
-    if (DieArray[I].getDepth() == Depth - 1)
+    if (I == ParentIdx)
       return DWARFDie();
-    if (DieArray[I].getDepth() == Depth)
+    if (DieArray[I].getParentIdx() == ParentIdx)
       return DWARFDie(this, &DieArray[I]);
   }
   return DWARFDie();
@@ -752,13 +750,12 @@ DWARFDie DWARFUnit::getLastChild(const DWARFDebugInfoEntry *Die) {
   if (!Die->hasChildren())
     return DWARFDie();
 
-  uint32_t Depth = Die->getDepth();
-  for (size_t I = getDIEIndex(Die) + 1, EndIdx = DieArray.size(); I < EndIdx;
-       ++I) {
-    if (DieArray[I].getDepth() == Depth + 1 &&
+  uint32_t Idx = getDIEIndex(Die);
+  for (size_t I = Idx + 1, EndIdx = DieArray.size(); I < EndIdx; ++I) {
+    if (DieArray[I].getParentIdx() == Idx &&
         DieArray[I].getTag() == dwarf::DW_TAG_null)
       return DWARFDie(this, &DieArray[I]);
-    assert(DieArray[I].getDepth() > Depth && "Not processing children?");
+    assert(DieArray[I].getParentIdx() >= Idx && "Not processing children?");
   }
   return DWARFDie();
 }
@@ -0,0 +1,259 @@
+//===- SymbolizableAddressIndex.cpp ---------------------------------------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// Implementation of SymbolizableAddressIndex class.
+//
+//===----------------------------------------------------------------------===//
+
+#include "SymbolizableAddressIndex.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/Support/Errc.h"
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace llvm;
+using namespace symbolize;
+
+static const char IndexMagic[8] = {'L', 'L', 'V', 'M', 'S', 'Y', 'M', 'X'};
+static const uint32_t IndexVersion = 1;
+
+static uint32_t getFlags(FunctionNameKind FNKind, bool UseSymbolTable) {
+  return static_cast<uint32_t>(FNKind) | (UseSymbolTable ? 1U << 8 : 0);
+}
+
+static Error createIndexError(const Twine &Msg) {
+  return createStringError(errc::invalid_argument, "invalid address index: %s",
+                           Msg.str().c_str());
+}
+
+Expected<std::unique_ptr<SymbolizableAddressIndex>>
+SymbolizableAddressIndex::create(std::unique_ptr<MemoryBuffer> Buffer,
+                                 std::unique_ptr<SymbolizableModule> &Module,
+                                 FunctionNameKind FNKind, bool UseSymbolTable) {
+  StringRef Data = Buffer->getBuffer();
+  if (Data.size() < sizeof(Header))
+    return createIndexError("file too small");
+  const auto *H = reinterpret_cast<const Header *>(Data.data());
+  if (memcmp(H->Magic, IndexMagic, sizeof(IndexMagic)) != 0)
+    return createIndexError("bad magic");
+  if (H->Version != IndexVersion)
+    return createIndexError("unsupported version");
+  if (H->Flags != getFlags(FNKind, UseSymbolTable))
+    return createIndexError("written with different options");
+
+  uint64_t EntriesSize = uint64_t(H->NumEntries) * sizeof(Entry);
+  uint64_t FramesSize = uint64_t(H->NumFrames) * sizeof(Frame);
+  if (sizeof(Header) + EntriesSize + FramesSize + H->StringTableSize !=
+      Data.size())
+    return createIndexError("size mismatch");
+
+  std::unique_ptr<SymbolizableAddressIndex> Index(
+      new SymbolizableAddressIndex(std::move(Buffer), nullptr, H->Flags));
+  const char *Ptr = Data.data() + sizeof(Header);
+  Index->Entries = makeArrayRef(reinterpret_cast<const Entry *>(Ptr),
+                                H->NumEntries);
+  Ptr += EntriesSize;
+  Index->Frames =
+      makeArrayRef(reinterpret_cast<const Frame *>(Ptr), H->NumFrames);
+  Ptr += FramesSize;
+  Index->Strings = StringRef(Ptr, H->StringTableSize);
+
+  // Validate the index up front so that lookups need no checks.
+  if (Index->Strings.empty() || Index->Strings.back() != '\0')
+    return createIndexError("unterminated string table");
+  for (size_t I = 0, E = Index->Entries.size(); I != E; ++I) {
+    const Entry &En = Index->Entries[I];
+    if (I && En.Address <= Index->Entries[I - 1].Address)
+      return createIndexError("entries not sorted");
+    if (En.NumFrames < 2 ||
+        uint64_t(En.FirstFrame) + En.NumFrames > Index->Frames.size())
+      return createIndexError("frame index out of range");
+  }
+  for (const Frame &F : Index->Frames)
+    if (F.FunctionName >= Index->Strings.size() ||
+        F.FileName >= Index->Strings.size())
+      return createIndexError("string offset out of range");
+  Index->Module = std::move(Module);
+  return std::move(Index);
+}
+
+namespace {
+
+/// Builds the frame and string tables of an index.
+class IndexBuilder {
+public:
+  IndexBuilder() { Strings.push_back('\0'); }
+
+  void addEntry(uint64_t Address, const DILineInfo &Code,
+                const DIInliningInfo &Inlined) {
+    size_t First = Frames.size();
+    addFrame(Code);
+    for (uint32_t I = 0, E = Inlined.getNumberOfFrames(); I != E; ++I)
+      addFrame(Inlined.getFrame(I));
+
+    // Merge runs of addresses with the same result.
+    if (!Entries.empty()) {
+      const SymbolizableAddressIndex::Entry &Last = Entries.back();
+      if (Last.NumFrames == Frames.size() - First &&
+          std::equal(Frames.begin() + First, Frames.end(),
+                     Frames.begin() + Last.FirstFrame, sameFrame)) {
+        Frames.resize(First);
+        return;
+      }
+    }
+    SymbolizableAddressIndex::Entry En;
+    En.Address = Address;
+    En.FirstFrame = First;
+    En.NumFrames = Frames.size() - First;
+    Entries.push_back(En);
+  }
+
+  void write(raw_ostream &OS, uint32_t Flags) const {
+    SymbolizableAddressIndex::Header H;
+    memcpy(H.Magic, IndexMagic, sizeof(IndexMagic));
+    H.Version = IndexVersion;
+    H.Flags = Flags;
+    H.NumEntries = Entries.size();
+    H.NumFrames = Frames.size();
+    H.StringTableSize = Strings.size();
+    H.Reserved = 0;
+    OS.write(reinterpret_cast<const char *>(&H), sizeof(H));
+    OS.write(reinterpret_cast<const char *>(Entries.data()),
+             Entries.size() * sizeof(Entries[0]));
+    OS.write(reinterpret_cast<const char *>(Frames.data()),
+             Frames.size() * sizeof(Frames[0]));
+    OS.write(Strings.data(), Strings.size());
+  }
+
+private:
+  static bool sameFrame(const SymbolizableAddressIndex::Frame &A,
+                        const SymbolizableAddressIndex::Frame &B) {
+    return memcmp(&A, &B, sizeof(A)) == 0;
+  }
+
+  uint32_t addString(StringRef S) {
+    auto R = StringOffsets.insert(
+        std::make_pair(S.str(), static_cast<uint32_t>(Strings.size())));
+    if (R.second) {
+      Strings.insert(Strings.end(), S.begin(), S.end());
+      Strings.push_back('\0');
+    }
+    return R.first->second;
+  }
+
+  void addFrame(const DILineInfo &Info) {
+    SymbolizableAddressIndex::Frame F;
+    F.FunctionName = addString(Info.FunctionName);
+    F.FileName = addString(Info.FileName);
+    F.Line = Info.Line;
+    F.Column = Info.Column;
+    F.StartLine = Info.StartLine;
+    F.Discriminator = Info.Discriminator;
+    Frames.push_back(F);
+  }
+
+  std::vector<SymbolizableAddressIndex::Entry> Entries;
+  std::vector<SymbolizableAddressIndex::Frame> Frames;
+  std::vector<char> Strings;
+  std::map<std::string, uint32_t> StringOffsets;
+};
+
+} // end anonymous namespace
+
+void SymbolizableAddressIndex::write(raw_ostream &OS,
+                                     const SymbolizableModule &Module,
+                                     ArrayRef<uint64_t> Boundaries,
+                                     FunctionNameKind FNKind,
+                                     bool UseSymbolTable) {
+  std::vector<uint64_t> Addresses(Boundaries.begin(), Boundaries.end());
+  llvm::sort(Addresses);
+  Addresses.erase(std::unique(Addresses.begin(), Addresses.end()),
+                  Addresses.end());
+
+  IndexBuilder Builder;
+  for (uint64_t Address : Addresses)
+    Builder.addEntry(
+        Address, Module.symbolizeCode(Address, FNKind, UseSymbolTable),
+        Module.symbolizeInlinedCode(Address, FNKind, UseSymbolTable));
+  Builder.write(OS, getFlags(FNKind, UseSymbolTable));
+}
+
+SymbolizableAddressIndex::SymbolizableAddressIndex(
+    std::unique_ptr<MemoryBuffer> Buffer,
+    std::unique_ptr<SymbolizableModule> Module, uint32_t Flags)
+    : Buffer(std::move(Buffer)), Module(std::move(Module)), Flags(Flags) {}
+
+bool SymbolizableAddressIndex::matches(FunctionNameKind FNKind,
+                                       bool UseSymbolTable) const {
+  return Flags == getFlags(FNKind, UseSymbolTable);
+}
+
+const SymbolizableAddressIndex::Entry *
+SymbolizableAddressIndex::lookup(uint64_t ModuleOffset) const {
+  auto It = std::upper_bound(
+      Entries.begin(), Entries.end(), ModuleOffset,
+      [](uint64_t Address, const Entry &En) { return Address < En.Address; });
+  if (It == Entries.begin())
+    return nullptr;
+  return &*std::prev(It);
+}
+
+DILineInfo SymbolizableAddressIndex::getLineInfo(const Frame &F) const {
+  DILineInfo Info;
+  Info.FunctionName = Strings.data() + F.FunctionName;
+  Info.FileName = Strings.data() + F.FileName;
+  Info.Line = F.Line;
+  Info.Column = F.Column;
+  Info.StartLine = F.StartLine;
+  Info.Discriminator = F.Discriminator;
+  return Info;
+}
+
+DILineInfo SymbolizableAddressIndex::symbolizeCode(uint64_t ModuleOffset,
+                                                   FunctionNameKind FNKind,
+                                                   bool UseSymbolTable) const {
+  if (!matches(FNKind, UseSymbolTable))
+    return Module->symbolizeCode(ModuleOffset, FNKind, UseSymbolTable);
+  // Addresses below the first boundary have no debug info or symbol.
+  const Entry *En = lookup(ModuleOffset);
+  if (!En)
+    return DILineInfo();
+  return getLineInfo(Frames[En->FirstFrame]);
+}
+
+DIInliningInfo SymbolizableAddressIndex::symbolizeInlinedCode(
+    uint64_t ModuleOffset, FunctionNameKind FNKind, bool UseSymbolTable) const {
+  if (!matches(FNKind, UseSymbolTable))
+    return Module->symbolizeInlinedCode(ModuleOffset, FNKind, UseSymbolTable);
+  DIInliningInfo InlinedContext;
+  const Entry *En = lookup(ModuleOffset);
+  if (!En) {
+    InlinedContext.addFrame(DILineInfo());
+    return InlinedContext;
+  }
+  for (uint32_t I = En->FirstFrame + 1, E = En->FirstFrame + En->NumFrames;
+       I != E; ++I)
+    InlinedContext.addFrame(getLineInfo(Frames[I]));
+  return InlinedContext;
+}
+
+DIGlobal SymbolizableAddressIndex::symbolizeData(uint64_t ModuleOffset) const {
+  return Module->symbolizeData(ModuleOffset);
+}
+
+bool SymbolizableAddressIndex::isWin32Module() const {
+  return Module->isWin32Module();
+}
+
+uint64_t SymbolizableAddressIndex::getModulePreferredBase() const {
+  return Module->getModulePreferredBase();
+}
@@ -0,0 +1,114 @@
+//===- SymbolizableAddressIndex.h -------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file declares the SymbolizableAddressIndex class, which answers code
+// queries from a precomputed, memory-mappable index of a module.
+//
+// The index is a sorted array of addresses at which the symbolization result
+// may change, together with the result computed at each of them. An address
+// is symbolized by looking up the last entry at or below it, so code queries
+// never parse debug info once the index exists.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_LIB_DEBUGINFO_SYMBOLIZE_SYMBOLIZABLEADDRESSINDEX_H
+#define LLVM_LIB_DEBUGINFO_SYMBOLIZE_SYMBOLIZABLEADDRESSINDEX_H
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/DebugInfo/Symbolize/SymbolizableModule.h"
+#include "llvm/Support/Endian.h"
+#include "llvm/Support/Error.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/raw_ostream.h"
+#include <cstdint>
+#include <memory>
+
+namespace llvm {
+namespace symbolize {
+
+class SymbolizableAddressIndex : public SymbolizableModule {
+public:
+  /// Create an index module from the index in \p Buffer, which must have been
+  /// written for the same \p FNKind and \p UseSymbolTable. \p Module answers
+  /// data queries and code queries with other options; the index takes
+  /// ownership of it only on success.
+  static Expected<std::unique_ptr<SymbolizableAddressIndex>>
+  create(std::unique_ptr<MemoryBuffer> Buffer,
+         std::unique_ptr<SymbolizableModule> &Module, FunctionNameKind FNKind,
+         bool UseSymbolTable);
+
+  /// Write the index of \p Module to \p OS. \p Boundaries must contain every
+  /// address at which the result of a code query may change.
+  static void write(raw_ostream &OS, const SymbolizableModule &Module,
+                    ArrayRef<uint64_t> Boundaries, FunctionNameKind FNKind,
+                    bool UseSymbolTable);
+
+  DILineInfo symbolizeCode(uint64_t ModuleOffset, FunctionNameKind FNKind,
+                           bool UseSymbolTable) const override;
+  DIInliningInfo symbolizeInlinedCode(uint64_t ModuleOffset,
+                                      FunctionNameKind FNKind,
+                                      bool UseSymbolTable) const override;
+  DIGlobal symbolizeData(uint64_t ModuleOffset) const override;
+
+  bool isWin32Module() const override;
+  uint64_t getModulePreferredBase() const override;
+
+  /// The on-disk layout. All fields are little-endian.
+  struct Header {
+    char Magic[8];
+    support::ulittle32_t Version;
+    /// The FunctionNameKind of the results, and whether they were overridden
+    /// with names from the symbol table in bit 8.
+    support::ulittle32_t Flags;
+    support::ulittle32_t NumEntries;
+    support::ulittle32_t NumFrames;
+    support::ulittle32_t StringTableSize;
+    support::ulittle32_t Reserved;
+  };
+
+  struct Entry {
+    support::ulittle64_t Address;
+    /// The first frame is the result of symbolizeCode and is followed by the
+    /// NumFrames - 1 frames of symbolizeInlinedCode.
+    support::ulittle32_t FirstFrame;
+    support::ulittle32_t NumFrames;
+  };
+
+  struct Frame {
+    /// Offsets of the names in the string table.
+    support::ulittle32_t FunctionName;
+    support::ulittle32_t FileName;
+    support::ulittle32_t Line;
+    support::ulittle32_t Column;
+    support::ulittle32_t StartLine;
+    support::ulittle32_t Discriminator;
+  };
+
+private:
+  SymbolizableAddressIndex(std::unique_ptr<MemoryBuffer> Buffer,
+                           std::unique_ptr<SymbolizableModule> Module,
+                           uint32_t Flags);
+
+  bool matches(FunctionNameKind FNKind, bool UseSymbolTable) const;
+  const Entry *lookup(uint64_t ModuleOffset) const;
+  DILineInfo getLineInfo(const Frame &F) const;
+
+  std::unique_ptr<MemoryBuffer> Buffer;
+  std::unique_ptr<SymbolizableModule> Module;
+  uint32_t Flags;
+  ArrayRef<Entry> Entries;
+  ArrayRef<Frame> Frames;
+  StringRef Strings;
+};
+
+} // end namespace symbolize
+} // end namespace llvm
+
+#endif // LLVM_LIB_DEBUGINFO_SYMBOLIZE_SYMBOLIZABLEADDRESSINDEX_H
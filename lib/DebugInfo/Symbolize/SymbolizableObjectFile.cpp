@@ -19,6 +19,7 @@
 #include "llvm/DebugInfo/DWARF/DWARFContext.h"
 #include "llvm/DebugInfo/Symbolize/SymbolizableModule.h"
 #include "llvm/Object/COFF.h"
+#include "llvm/Object/ELFObjectFile.h"
 #include "llvm/Object/ObjectFile.h"
 #include "llvm/Object/SymbolSize.h"
 #include "llvm/Support/Casting.h"
@@ -67,6 +68,12 @@ SymbolizableObjectFile::create(object::ObjectFile *Obj,
       }
     }
   }
+  // Read the symbols of ELF files in one pass over the symbol table.
+  if (auto *ELFObj = dyn_cast<ELFObjectFileBase>(Obj)) {
+    if (!OpdExtractor && res->addELFSymbols(*ELFObj))
+      return std::move(res);
+  }
+
   std::vector<std::pair<SymbolRef, uint64_t>> Symbols =
       computeSymbolSizes(*Obj);
   for (auto &P : Symbols)
@@ -174,6 +181,27 @@ std::error_code SymbolizableObjectFile::addSymbol(const SymbolRef &Symbol,
   return std::error_code();
 }
 
+bool SymbolizableObjectFile::addELFSymbols(const ELFObjectFileBase &Obj) {
+  std::vector<ELFSymbolEntry> Symbols;
+  StringRef StringTable;
+  if (Error E = Obj.readSymbolTable(/*Dynamic=*/false, Symbols, StringTable)) {
+    consumeError(std::move(E));
+    return false;
+  }
+  for (const ELFSymbolEntry &Sym : Symbols) {
+    bool IsFunction = Sym.Type == ELF::STT_FUNC;
+    if (!IsFunction && Sym.Type != ELF::STT_OBJECT &&
+        Sym.Type != ELF::STT_COMMON && Sym.Type != ELF::STT_TLS)
+      continue;
+    if (Sym.NameOffset >= StringTable.size())
+      continue;
+    auto &M = IsFunction ? Functions : Objects;
+    SymbolDesc SD = {Sym.Address, Sym.Size};
+    M.insert(std::make_pair(SD, StringTable.data() + Sym.NameOffset));
+  }
+  return true;
+}
+
 // Return true if this is a 32-bit x86 PE COFF module.
 bool SymbolizableObjectFile::isWin32Module() const {
   auto *CoffObject = dyn_cast<COFFObjectFile>(Module);
@@ -238,6 +266,29 @@ DILineInfo SymbolizableObjectFile::symbolizeCode(uint64_t ModuleOffset,
   return LineInfo;
 }
 
+std::vector<DILineInfo>
+SymbolizableObjectFile::symbolizeCodeBatch(ArrayRef<uint64_t> ModuleOffsets,
+                                           FunctionNameKind FNKind,
+                                           bool UseSymbolTable) const {
+  std::vector<DILineInfo> Result;
+  if (DebugInfoContext)
+    Result = DebugInfoContext->getLineInfoForAddresses(
+        ModuleOffsets, getDILineInfoSpecifier(FNKind));
+  else
+    Result.resize(ModuleOffsets.size());
+  // Override function names from symbol table if necessary.
+  if (shouldOverrideWithSymbolTable(FNKind, UseSymbolTable)) {
+    for (size_t I = 0, E = ModuleOffsets.size(); I != E; ++I) {
+      std::string FunctionName;
+      uint64_t Start, Size;
+      if (getNameFromSymbolTable(SymbolRef::ST_Function, ModuleOffsets[I],
+                                 FunctionName, Start, Size))
+        Result[I].FunctionName = FunctionName;
+    }
+  }
+  return Result;
+}
+
 DIInliningInfo SymbolizableObjectFile::symbolizeInlinedCode(
     uint64_t ModuleOffset, FunctionNameKind FNKind, bool UseSymbolTable) const {
   DIInliningInfo InlinedContext;
@@ -27,6 +27,10 @@ namespace llvm {
 
 class DataExtractor;
 
+namespace object {
+class ELFObjectFileBase;
+} // end namespace object
+
 namespace symbolize {
 
 class SymbolizableObjectFile : public SymbolizableModule {
@@ -40,6 +44,9 @@ public:
                                       FunctionNameKind FNKind,
                                       bool UseSymbolTable) const override;
   DIGlobal symbolizeData(uint64_t ModuleOffset) const override;
+  std::vector<DILineInfo>
+  symbolizeCodeBatch(ArrayRef<uint64_t> ModuleOffsets, FunctionNameKind FNKind,
+                     bool UseSymbolTable) const override;
 
   // Return true if this is a 32-bit x86 PE COFF module.
   bool isWin32Module() const override;
@@ -62,6 +69,9 @@ private:
                             DataExtractor *OpdExtractor = nullptr,
                             uint64_t OpdAddress = 0);
   std::error_code addCoffExportSymbols(const object::COFFObjectFile *CoffObj);
+  // Add the symbols of an ELF file from a single pass over its symbol table.
+  // Returns false if the table could not be read.
+  bool addELFSymbols(const object::ELFObjectFileBase &Obj);
 
   object::ObjectFile *Module;
   std::unique_ptr<DIContext> DebugInfoContext;
@@ -13,9 +13,11 @@
 
 #include "llvm/DebugInfo/Symbolize/Symbolize.h"
 
+#include "SymbolizableAddressIndex.h"
 #include "SymbolizableObjectFile.h"
 
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/StringExtras.h"
 #include "llvm/BinaryFormat/COFF.h"
 #include "llvm/Config/config.h"
 #include "llvm/DebugInfo/DWARF/DWARFContext.h"
@@ -23,6 +25,7 @@
 #include "llvm/DebugInfo/PDB/PDBContext.h"
 #include "llvm/Demangle/Demangle.h"
 #include "llvm/Object/COFF.h"
+#include "llvm/Object/ELFObjectFile.h"
 #include "llvm/Object/MachO.h"
 #include "llvm/Object/MachOUniversal.h"
 #include "llvm/Support/Casting.h"
@@ -79,6 +82,48 @@ LLVMSymbolizer::symbolizeCode(const std::string &ModuleName,
   return LineInfo;
 }
 
+Expected<std::vector<DILineInfo>>
+LLVMSymbolizer::symbolizeCodeBatch(const std::string &ModuleName,
+                                   ArrayRef<uint64_t> ModuleOffsets,
+                                   StringRef DWPName) {
+  SymbolizableModule *Info;
+  if (auto InfoOrErr = getOrCreateModuleInfo(ModuleName, DWPName))
+    Info = InfoOrErr.get();
+  else
+    return InfoOrErr.takeError();
+
+  // A null module means an error has already been reported. Return empty
+  // results.
+  if (!Info)
+    return std::vector<DILineInfo>(ModuleOffsets.size());
+
+  // Look the offsets up in ascending order, adding the preferred base of the
+  // object if they are relative.
+  uint64_t Base = Opts.RelativeAddresses ? Info->getModulePreferredBase() : 0;
+  std::vector<uint32_t> Order(ModuleOffsets.size());
+  for (uint32_t I = 0, E = Order.size(); I != E; ++I)
+    Order[I] = I;
+  if (!std::is_sorted(ModuleOffsets.begin(), ModuleOffsets.end()))
+    std::stable_sort(Order.begin(), Order.end(), [&](uint32_t A, uint32_t B) {
+      return ModuleOffsets[A] < ModuleOffsets[B];
+    });
+  std::vector<uint64_t> Addresses;
+  Addresses.reserve(Order.size());
+  for (uint32_t I : Order)
+    Addresses.push_back(ModuleOffsets[I] + Base);
+
+  std::vector<DILineInfo> Sorted = Info->symbolizeCodeBatch(
+      Addresses, Opts.PrintFunctions, Opts.UseSymbolTable);
+  std::vector<DILineInfo> Result(Sorted.size());
+  for (uint32_t I = 0, E = Order.size(); I != E; ++I) {
+    DILineInfo &LineInfo = Result[Order[I]];
+    LineInfo = std::move(Sorted[I]);
+    if (Opts.Demangle)
+      LineInfo.FunctionName = DemangleName(LineInfo.FunctionName, Info);
+  }
+  return std::move(Result);
+}
+
 Expected<DIInliningInfo>
 LLVMSymbolizer::symbolizeInlinedCode(const std::string &ModuleName,
                                      uint64_t ModuleOffset, StringRef DWPName) {
@@ -420,11 +465,14 @@ LLVMSymbolizer::getOrCreateModuleInfo(const std::string &ModuleName,
     Context = DWARFContext::create(*Objects.second, nullptr,
                                    DWARFContext::defaultErrorHandler, DWPName);
   assert(Context);
+  DIContext *DICtx = Context.get();
   auto InfoOrErr =
       SymbolizableObjectFile::create(Objects.first, std::move(Context));
   std::unique_ptr<SymbolizableModule> SymMod;
   if (InfoOrErr)
     SymMod = std::move(InfoOrErr.get());
+  if (SymMod && !Opts.CacheDir.empty())
+    SymMod = createAddressIndex(*Objects.first, DICtx, std::move(SymMod));
   auto InsertResult =
       Modules.insert(std::make_pair(ModuleName, std::move(SymMod)));
   assert(InsertResult.second);
@@ -435,6 +483,142 @@ LLVMSymbolizer::getOrCreateModuleInfo(const std::string &ModuleName,
 
 namespace {
 
+template <typename ELFT>
+ArrayRef<uint8_t> getBuildID(const ELFFile<ELFT> &Obj) {
+  auto PhdrsOrErr = Obj.program_headers();
+  if (!PhdrsOrErr) {
+    consumeError(PhdrsOrErr.takeError());
+    return {};
+  }
+  for (const auto &Phdr : *PhdrsOrErr) {
+    if (Phdr.p_type != ELF::PT_NOTE)
+      continue;
+    Error Err = Error::success();
+    for (const auto &Note : Obj.notes(Phdr, Err))
+      if (Note.getType() == ELF::NT_GNU_BUILD_ID &&
+          Note.getName() == ELF::ELF_NOTE_GNU)
+        return Note.getDesc();
+    consumeError(std::move(Err));
+  }
+  return {};
+}
+
+// Returns the GNU build ID of an ELF executable or shared object, or an empty
+// array if it has none.
+ArrayRef<uint8_t> getBuildID(const ObjectFile &Obj) {
+  if (auto *O = dyn_cast<ELF32LEObjectFile>(&Obj))
+    return getBuildID(*O->getELFFile());
+  if (auto *O = dyn_cast<ELF32BEObjectFile>(&Obj))
+    return getBuildID(*O->getELFFile());
+  if (auto *O = dyn_cast<ELF64LEObjectFile>(&Obj))
+    return getBuildID(*O->getELFFile());
+  if (auto *O = dyn_cast<ELF64BEObjectFile>(&Obj))
+    return getBuildID(*O->getELFFile());
+  return {};
+}
+
+// Collect the addresses at which the result of a code query may change: the
+// start and end of every function symbol, every line table row, and the
+// bounds of every function and inlined call.
+std::vector<uint64_t> getCodeBoundaries(const ObjectFile &Obj,
+                                        DIContext *DICtx) {
+  std::vector<uint64_t> Boundaries;
+  for (ELFSymbolRef Sym : cast<ELFObjectFileBase>(Obj).symbols()) {
+    Expected<SymbolRef::Type> TypeOrErr = Sym.getType();
+    Expected<uint64_t> AddressOrErr = Sym.getAddress();
+    if (!TypeOrErr || !AddressOrErr) {
+      consumeError(TypeOrErr.takeError());
+      consumeError(AddressOrErr.takeError());
+      continue;
+    }
+    if (*TypeOrErr != SymbolRef::ST_Function)
+      continue;
+    Boundaries.push_back(*AddressOrErr);
+    Boundaries.push_back(*AddressOrErr + Sym.getSize());
+  }
+
+  auto *DCtx = dyn_cast_or_null<DWARFContext>(DICtx);
+  if (!DCtx)
+    return Boundaries;
+  for (const auto &CU : DCtx->compile_units()) {
+    if (const DWARFDebugLine::LineTable *LT =
+            DCtx->getLineTableForUnit(CU.get()))
+      for (const DWARFDebugLine::Row &Row : LT->Rows)
+        Boundaries.push_back(Row.Address);
+    for (const DWARFDebugInfoEntry &E : CU->dies()) {
+      DWARFDie Die(CU.get(), &E);
+      if (Die.getTag() != dwarf::DW_TAG_subprogram &&
+          Die.getTag() != dwarf::DW_TAG_inlined_subroutine &&
+          Die.getTag() != dwarf::DW_TAG_lexical_block)
+        continue;
+      auto RangesOrErr = Die.getAddressRanges();
+      if (!RangesOrErr) {
+        consumeError(RangesOrErr.takeError());
+        continue;
+      }
+      for (const DWARFAddressRange &R : *RangesOrErr) {
+        Boundaries.push_back(R.LowPC);
+        Boundaries.push_back(R.HighPC);
+      }
+    }
+  }
+  return Boundaries;
+}
+
+} // end anonymous namespace
+
+std::unique_ptr<SymbolizableModule>
+LLVMSymbolizer::createAddressIndex(const ObjectFile &Obj, DIContext *DICtx,
+                                   std::unique_ptr<SymbolizableModule> Module) {
+  ArrayRef<uint8_t> BuildID = getBuildID(Obj);
+  if (BuildID.empty())
+    return Module;
+  SmallString<128> Path(Opts.CacheDir);
+  sys::path::append(Path, toHex(BuildID, /*LowerCase=*/true) + ".symidx");
+
+  auto Load = [&]() -> bool {
+    auto BufOrErr = MemoryBuffer::getFile(Path, /*FileSize=*/-1,
+                                          /*RequiresNullTerminator=*/false);
+    if (!BufOrErr)
+      return false;
+    auto IndexOrErr = SymbolizableAddressIndex::create(
+        std::move(*BufOrErr), Module, Opts.PrintFunctions, Opts.UseSymbolTable);
+    if (!IndexOrErr) {
+      consumeError(IndexOrErr.takeError());
+      return false;
+    }
+    Module = std::move(*IndexOrErr);
+    return true;
+  };
+  if (Load())
+    return Module;
+
+  // Write the index to a temporary file and move it into place, so that
+  // concurrent symbolizers never see a partial index.
+  SmallString<128> TmpPath;
+  int FD;
+  if (sys::fs::create_directories(Opts.CacheDir) ||
+      sys::fs::createUniqueFile(Path + "-%%%%%%.tmp", FD, TmpPath))
+    return Module;
+  bool Failed;
+  {
+    raw_fd_ostream OS(FD, /*shouldClose=*/true);
+    SymbolizableAddressIndex::write(OS, *Module, getCodeBoundaries(Obj, DICtx),
+                                    Opts.PrintFunctions, Opts.UseSymbolTable);
+    OS.close();
+    Failed = OS.has_error();
+    OS.clear_error();
+  }
+  if (Failed || sys::fs::rename(TmpPath, Path)) {
+    sys::fs::remove(TmpPath);
+    return Module;
+  }
+  Load();
+  return Module;
+}
+
+namespace {
+
 // Undo these various manglings for Win32 extern "C" functions:
 // cdecl       - _foo
 // stdcall     - _foo@12
@@ -324,6 +324,74 @@ public:
 
 using Demangler = itanium_demangle::ManglingParser<DefaultAllocator>;
 
+namespace {
+// The allocator of a parser that demangles many names in a row. reset()
+// keeps the blocks allocated for one name to serve the next, where
+// BumpPointerAllocator returns them to malloc. Only the memory of
+// allocations larger than a block is freed.
+class RecyclingAllocator {
+  static constexpr size_t BlockSize = 4096;
+
+  std::vector<char *> Blocks;
+  std::vector<void *> Oversized;
+  // The number of blocks of Blocks in use, and the position in the last one.
+  size_t BlocksUsed = 0;
+  size_t Position = BlockSize;
+
+public:
+  RecyclingAllocator() = default;
+  RecyclingAllocator(const RecyclingAllocator &) = delete;
+  RecyclingAllocator &operator=(const RecyclingAllocator &) = delete;
+
+  ~RecyclingAllocator() {
+    reset();
+    for (char *Block : Blocks)
+      std::free(Block);
+  }
+
+  void *allocate(size_t N) {
+    N = (N + 15u) & ~size_t(15u);
+    if (N > BlockSize) {
+      void *Mem = std::malloc(N);
+      if (Mem == nullptr)
+        std::terminate();
+      Oversized.push_back(Mem);
+      return Mem;
+    }
+    if (Position + N > BlockSize) {
+      if (BlocksUsed == Blocks.size()) {
+        char *Block = static_cast<char *>(std::malloc(BlockSize));
+        if (Block == nullptr)
+          std::terminate();
+        Blocks.push_back(Block);
+      }
+      ++BlocksUsed;
+      Position = 0;
+    }
+    Position += N;
+    return Blocks[BlocksUsed - 1] + Position - N;
+  }
+
+  void reset() {
+    for (void *Mem : Oversized)
+      std::free(Mem);
+    Oversized.clear();
+    BlocksUsed = 0;
+    Position = BlockSize;
+  }
+
+  template<typename T, typename ...Args> T *makeNode(Args &&...args) {
+    return new (allocate(sizeof(T))) T(std::forward<Args>(args)...);
+  }
+
+  void *allocateNodeArray(size_t sz) {
+    return allocate(sizeof(Node *) * sz);
+  }
+};
+} // end anonymous namespace
+
+using RecyclingDemangler = itanium_demangle::ManglingParser<RecyclingAllocator>;
+
 char *llvm::itaniumDemangle(const char *MangledName, char *Buf,
                             size_t *N, int *Status) {
   if (MangledName == nullptr || (Buf != nullptr && N == nullptr)) {
@@ -356,6 +424,50 @@ char *llvm::itaniumDemangle(const char *MangledName, char *Buf,
   return InternalStatus == demangle_success ? Buf : nullptr;
 }
 
+ItaniumDemangleContext::ItaniumDemangleContext()
+    : Context(new RecyclingDemangler{nullptr, nullptr}), Buf(nullptr),
+      Capacity(0) {}
+
+ItaniumDemangleContext::~ItaniumDemangleContext() {
+  delete static_cast<RecyclingDemangler *>(Context);
+  std::free(Buf);
+}
+
+const char *ItaniumDemangleContext::demangle(const char *MangledName) {
+  RecyclingDemangler *Parser = static_cast<RecyclingDemangler *>(Context);
+  Parser->reset(MangledName, MangledName + std::strlen(MangledName));
+  Node *AST = Parser->parse();
+  if (AST == nullptr)
+    return nullptr;
+
+  OutputStream S(Buf, Capacity);
+  AST->print(S);
+  S += '\0';
+  Buf = S.getBuffer();
+  Capacity = S.getBufferCapacity();
+  return Buf;
+}
+
+const char *ItaniumDemangleContext::demangle(const char *const *MangledNames,
+                                             size_t N, size_t *Offsets) {
+  RecyclingDemangler *Parser = static_cast<RecyclingDemangler *>(Context);
+  OutputStream S(Buf, Capacity);
+  for (size_t I = 0; I != N; ++I) {
+    const char *Name = MangledNames[I];
+    const char *NameEnd = Name + std::strlen(Name);
+    Offsets[I] = S.getCurrentPosition();
+    Parser->reset(Name, NameEnd);
+    if (Node *AST = Parser->parse())
+      AST->print(S);
+    else
+      S += StringView(Name, NameEnd);
+    S += '\0';
+  }
+  Buf = S.getBuffer();
+  Capacity = S.getBufferCapacity();
+  return Buf;
+}
+
 ItaniumPartialDemangler::ItaniumPartialDemangler()
     : RootNode(nullptr), Context(new Demangler{nullptr, nullptr}) {}
 
@@ -254,6 +254,15 @@ void CompileOnDemandLayer::emitPartition(
   // unmodified to the base layer.
   if (GVsToExtract == None) {
     Defs.clear();
+    {
+      // The module may have been loaded lazily.
+      auto Lock = TSM.getContextLock();
+      if (auto Err = TSM.getModule()->materializeAll()) {
+        ES.reportError(std::move(Err));
+        R.failMaterialization();
+        return;
+      }
+    }
     BaseLayer.emit(std::move(R), std::move(TSM));
     return;
   }
@@ -286,6 +295,21 @@ void CompileOnDemandLayer::emitPartition(
 
   expandPartition(*GVsToExtract);
 
+  // If the module was loaded lazily, read the bodies of the functions in the
+  // partition, and of those only.
+  {
+    auto Lock = TSM.getContextLock();
+    for (auto &F : *TSM.getModule()) {
+      if (!F.isMaterializable() || !GVsToExtract->count(&F))
+        continue;
+      if (auto Err = F.materialize()) {
+        ES.reportError(std::move(Err));
+        R.failMaterialization();
+        return;
+      }
+    }
+  }
+
   // Extract the requested partiton (plus any necessary aliases) and
   // put the rest back into the impl dylib.
   auto ShouldExtract = [&](const GlobalValue &GV) -> bool {
@@ -17,8 +17,9 @@ namespace {
   // A SimpleCompiler that owns its TargetMachine.
   class TMOwningSimpleCompiler : public llvm::orc::SimpleCompiler {
   public:
-    TMOwningSimpleCompiler(std::unique_ptr<llvm::TargetMachine> TM)
-      : llvm::orc::SimpleCompiler(*TM), TM(std::move(TM)) {}
+    TMOwningSimpleCompiler(std::unique_ptr<llvm::TargetMachine> TM,
+                           llvm::ObjectCache *ObjCache)
+      : llvm::orc::SimpleCompiler(*TM, ObjCache), TM(std::move(TM)) {}
   private:
     // FIXME: shared because std::functions (and thus
     // IRCompileLayer::CompileFunction) are not moveable.
@@ -37,7 +38,7 @@ LLJIT::~LLJIT() {
 
 Expected<std::unique_ptr<LLJIT>>
 LLJIT::Create(JITTargetMachineBuilder JTMB, DataLayout DL,
-              unsigned NumCompileThreads) {
+              unsigned NumCompileThreads, ObjectCache *ObjCache) {
 
   if (NumCompileThreads == 0) {
     // If NumCompileThreads == 0 then create a single-threaded LLJIT instance.
@@ -45,12 +46,13 @@ LLJIT::Create(JITTargetMachineBuilder JTMB, DataLayout DL,
     if (!TM)
       return TM.takeError();
     return std::unique_ptr<LLJIT>(new LLJIT(llvm::make_unique<ExecutionSession>(),
-                                            std::move(*TM), std::move(DL)));
+                                            std::move(*TM), std::move(DL),
+                                            ObjCache));
   }
 
   return std::unique_ptr<LLJIT>(new LLJIT(llvm::make_unique<ExecutionSession>(),
                                           std::move(JTMB), std::move(DL),
-                                          NumCompileThreads));
+                                          NumCompileThreads, ObjCache));
 }
 
 Error LLJIT::defineAbsolute(StringRef Name, JITEvaluatedSymbol Sym) {
@@ -80,29 +82,32 @@ Expected<JITEvaluatedSymbol> LLJIT::lookupLinkerMangled(JITDylib &JD,
 }
 
 LLJIT::LLJIT(std::unique_ptr<ExecutionSession> ES,
-             std::unique_ptr<TargetMachine> TM, DataLayout DL)
+             std::unique_ptr<TargetMachine> TM, DataLayout DL,
+             ObjectCache *ObjCache)
     : ES(std::move(ES)), Main(this->ES->getMainJITDylib()), DL(std::move(DL)),
       ObjLinkingLayer(
           *this->ES,
           []() { return llvm::make_unique<SectionMemoryManager>(); }),
       CompileLayer(*this->ES, ObjLinkingLayer,
-                   TMOwningSimpleCompiler(std::move(TM))),
+                   TMOwningSimpleCompiler(std::move(TM), ObjCache)),
       CtorRunner(Main), DtorRunner(Main) {}
 
 LLJIT::LLJIT(std::unique_ptr<ExecutionSession> ES, JITTargetMachineBuilder JTMB,
-             DataLayout DL, unsigned NumCompileThreads)
+             DataLayout DL, unsigned NumCompileThreads,
+             ObjectCache *ObjCache)
     : ES(std::move(ES)), Main(this->ES->getMainJITDylib()), DL(std::move(DL)),
       ObjLinkingLayer(
           *this->ES,
           []() { return llvm::make_unique<SectionMemoryManager>(); }),
       CompileLayer(*this->ES, ObjLinkingLayer,
-                   ConcurrentIRCompiler(std::move(JTMB))),
+                   ConcurrentIRCompiler(std::move(JTMB), ObjCache)),
       CtorRunner(Main), DtorRunner(Main) {
   assert(NumCompileThreads != 0 &&
          "Multithreaded LLJIT instance can not be created with 0 threads");
 
-  // Move modules to new contexts when they're emitted so that we can compile
-  // them in parallel.
+  // Move modules whose context is shared to new contexts when they're emitted
+  // so that we can compile them in parallel. Modules with contexts of their
+  // own are compiled in parallel as they are.
   CompileLayer.setCloneToNewContextOnEmit(true);
 
   // Create a thread pool to compile on and set the execution session
@@ -145,7 +150,8 @@ void LLJIT::recordCtorDtors(Module &M) {
 
 Expected<std::unique_ptr<LLLazyJIT>>
 LLLazyJIT::Create(JITTargetMachineBuilder JTMB, DataLayout DL,
-                  JITTargetAddress ErrorAddr, unsigned NumCompileThreads) {
+                  JITTargetAddress ErrorAddr, unsigned NumCompileThreads,
+                  ObjectCache *ObjCache) {
   auto ES = llvm::make_unique<ExecutionSession>();
 
   const Triple &TT = JTMB.getTargetTriple();
@@ -165,13 +171,13 @@ LLLazyJIT::Create(JITTargetMachineBuilder JTMB, DataLayout DL,
     if (!TM)
       return TM.takeError();
     return std::unique_ptr<LLLazyJIT>(
-        new LLLazyJIT(std::move(ES), std::move(*TM), std::move(DL),
+        new LLLazyJIT(std::move(ES), std::move(*TM), std::move(DL), ObjCache,
                       std::move(*LCTMgr), std::move(ISMBuilder)));
   }
 
   return std::unique_ptr<LLLazyJIT>(new LLLazyJIT(
       std::move(ES), std::move(JTMB), std::move(DL), NumCompileThreads,
-      std::move(*LCTMgr), std::move(ISMBuilder)));
+      ObjCache, std::move(*LCTMgr), std::move(ISMBuilder)));
 }
 
 Error LLLazyJIT::addLazyIRModule(JITDylib &JD, ThreadSafeModule TSM) {
@@ -187,19 +193,21 @@ Error LLLazyJIT::addLazyIRModule(JITDylib &JD, ThreadSafeModule TSM) {
 
 LLLazyJIT::LLLazyJIT(
     std::unique_ptr<ExecutionSession> ES, std::unique_ptr<TargetMachine> TM,
-    DataLayout DL, std::unique_ptr<LazyCallThroughManager> LCTMgr,
+    DataLayout DL, ObjectCache *ObjCache,
+    std::unique_ptr<LazyCallThroughManager> LCTMgr,
     std::function<std::unique_ptr<IndirectStubsManager>()> ISMBuilder)
-    : LLJIT(std::move(ES), std::move(TM), std::move(DL)),
+    : LLJIT(std::move(ES), std::move(TM), std::move(DL), ObjCache),
       LCTMgr(std::move(LCTMgr)), TransformLayer(*this->ES, CompileLayer),
       CODLayer(*this->ES, TransformLayer, *this->LCTMgr,
                std::move(ISMBuilder)) {}
 
 LLLazyJIT::LLLazyJIT(
     std::unique_ptr<ExecutionSession> ES, JITTargetMachineBuilder JTMB,
-    DataLayout DL, unsigned NumCompileThreads,
+    DataLayout DL, unsigned NumCompileThreads, ObjectCache *ObjCache,
     std::unique_ptr<LazyCallThroughManager> LCTMgr,
     std::function<std::unique_ptr<IndirectStubsManager>()> ISMBuilder)
-    : LLJIT(std::move(ES), std::move(JTMB), std::move(DL), NumCompileThreads),
+    : LLJIT(std::move(ES), std::move(JTMB), std::move(DL), NumCompileThreads,
+            ObjCache),
       LCTMgr(std::move(LCTMgr)), TransformLayer(*this->ES, CompileLayer),
       CODLayer(*this->ES, TransformLayer, *this->LCTMgr,
                std::move(ISMBuilder)) {
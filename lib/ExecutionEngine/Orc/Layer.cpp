@@ -82,8 +82,10 @@ void BasicIRLayerMaterializationUnit::materialize(
   // off the module.
   SymbolToDefinition.clear();
 
-  // If cloneToNewContextOnEmit is set, clone the module now.
-  if (L.getCloneToNewContextOnEmit())
+  // If cloneToNewContextOnEmit is set, clone the module now, unless nothing
+  // else uses its context: the module can then be compiled concurrently with
+  // others as it is, under the lock of its context.
+  if (L.getCloneToNewContextOnEmit() && TSM.getContext().isShared())
     TSM = cloneToNewContext(TSM);
 
 #ifndef NDEBUG
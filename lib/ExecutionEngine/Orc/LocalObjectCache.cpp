@@ -0,0 +1,161 @@
+//===------ LocalObjectCache.cpp - Persistent on-disk object cache --------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ExecutionEngine/Orc/LocalObjectCache.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Bitcode/BitcodeWriter.h"
+#include "llvm/Config/llvm-config.h"
+#include "llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/Errc.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/SHA1.h"
+#include "llvm/Support/raw_ostream.h"
+
+#if !defined(_MSC_VER) && !defined(__MINGW32__)
+#include <unistd.h>
+#else
+#include <io.h>
+#endif
+
+using namespace llvm;
+using namespace llvm::orc;
+
+Expected<std::unique_ptr<LocalObjectCache>>
+LocalObjectCache::Create(StringRef CacheDir,
+                         const JITTargetMachineBuilder &JTMB,
+                         CachePruningPolicy Policy) {
+  if (std::error_code EC = sys::fs::create_directories(CacheDir))
+    return createFileError(CacheDir, errorCodeToError(EC));
+
+  // Everything that goes into creating the TargetMachine, one field per line.
+  std::string ConfigKey;
+  {
+    raw_string_ostream OS(ConfigKey);
+    OS << LLVM_VERSION_STRING << '\n';
+#ifdef LLVM_REVISION
+    OS << LLVM_REVISION << '\n';
+#endif
+    const TargetOptions &Options = JTMB.getOptions();
+    OS << JTMB.getTargetTriple().str() << '\n'
+       << JTMB.getCPU() << '\n'
+       << JTMB.getFeatures().getString() << '\n'
+       << (JTMB.getRelocationModel() ? int(*JTMB.getRelocationModel()) : -1)
+       << '\n'
+       << (JTMB.getCodeModel() ? int(*JTMB.getCodeModel()) : -1) << '\n'
+       << int(JTMB.getCodeGenOptLevel()) << '\n'
+       << Options.EmulatedTLS << Options.ExplicitEmulatedTLS
+       << Options.FunctionSections << Options.DataSections << '\n';
+  }
+
+  std::unique_ptr<LocalObjectCache> Cache(
+      new LocalObjectCache(CacheDir, std::move(ConfigKey), std::move(Policy)));
+  Cache->prune();
+  return std::move(Cache);
+}
+
+std::string LocalObjectCache::getKey(const Module &M) const {
+  SmallVector<char, 0> Bitcode;
+  {
+    raw_svector_ostream OS(Bitcode);
+    WriteBitcodeToFile(M, OS);
+  }
+
+  SHA1 Hasher;
+  Hasher.update(ConfigKey);
+  Hasher.update(StringRef(Bitcode.data(), Bitcode.size()));
+  return toHex(Hasher.result());
+}
+
+SmallString<128> LocalObjectCache::getEntryPath(StringRef Key) const {
+  // This choice of file name allows the cache to be pruned (see pruneCache()
+  // in include/llvm/Support/CachePruning.h).
+  SmallString<128> EntryPath;
+  sys::path::append(EntryPath, CacheDir, "llvmcache-" + Key);
+  return EntryPath;
+}
+
+std::unique_ptr<MemoryBuffer> LocalObjectCache::getObject(const Module *M) {
+  std::string Key = getKey(*M);
+  SmallString<128> EntryPath = getEntryPath(Key);
+
+  int FD;
+  if (!sys::fs::openFileForRead(Twine(EntryPath), FD,
+                                sys::fs::OF_UpdateAtime)) {
+    ErrorOr<std::unique_ptr<MemoryBuffer>> MBOrErr =
+        MemoryBuffer::getOpenFile(FD, EntryPath,
+                                  /*FileSize*/ -1,
+                                  /*RequiresNullTerminator*/ false);
+    close(FD);
+    if (MBOrErr) {
+      recordCacheEntryUse(CacheDir, sys::path::filename(EntryPath),
+                          (*MBOrErr)->getBufferSize());
+      std::lock_guard<std::mutex> Lock(PendingKeysMutex);
+      PendingKeys.erase(M);
+      return std::move(*MBOrErr);
+    }
+  }
+
+  std::lock_guard<std::mutex> Lock(PendingKeysMutex);
+  PendingKeys[M] = std::move(Key);
+  return nullptr;
+}
+
+void LocalObjectCache::notifyObjectCompiled(const Module *M,
+                                            MemoryBufferRef Obj) {
+  std::string Key;
+  {
+    std::lock_guard<std::mutex> Lock(PendingKeysMutex);
+    auto I = PendingKeys.find(M);
+    if (I != PendingKeys.end()) {
+      Key = std::move(I->second);
+      PendingKeys.erase(I);
+    }
+  }
+  if (Key.empty())
+    Key = getKey(*M);
+
+  // Write to a temporary file to avoid racing with other JITs, and rename it
+  // into place once it is complete.
+  SmallString<128> TempFilenameModel;
+  sys::path::append(TempFilenameModel, CacheDir, "Orc-%%%%%%.tmp.o");
+  Expected<sys::fs::TempFile> Temp = sys::fs::TempFile::create(
+      TempFilenameModel, sys::fs::owner_read | sys::fs::owner_write);
+  if (!Temp) {
+    consumeError(Temp.takeError());
+    return;
+  }
+
+  {
+    raw_fd_ostream OS(Temp->FD, /* ShouldClose */ false);
+    OS << Obj.getBuffer();
+    OS.flush();
+    if (OS.has_error()) {
+      OS.clear_error();
+      consumeError(Temp->discard());
+      return;
+    }
+  }
+
+  // On POSIX systems this atomically replaces an entry written by another
+  // JIT in the meantime, which has the same contents. If the rename fails
+  // (e.g. on Windows when the entry is open), keep the existing entry.
+  SmallString<128> EntryPath = getEntryPath(Key);
+  if (Error E = Temp->keep(EntryPath)) {
+    consumeError(std::move(E));
+    consumeError(Temp->discard());
+    return;
+  }
+
+  recordCacheEntryUse(CacheDir, sys::path::filename(EntryPath),
+                      Obj.getBufferSize());
+}
+
+bool LocalObjectCache::prune() { return pruneCache(CacheDir, Policy); }
@@ -0,0 +1,320 @@
+//===----- SlabMemoryManager.cpp - Pack JIT'd sections into slabs ---------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ExecutionEngine/Orc/SlabMemoryManager.h"
+#include "llvm/ExecutionEngine/RTDyldMemoryManager.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/MathExtras.h"
+#include "llvm/Support/Process.h"
+#include "llvm/Support/raw_ostream.h"
+#include <algorithm>
+#include <iterator>
+
+using namespace llvm;
+using namespace llvm::orc;
+
+// The size of a transparent huge page on the common 4K page targets.
+static const size_t HugePageSize = 2 * 1024 * 1024;
+
+struct SlabMemoryPool::Slab {
+  sys::OwningMemoryBlock Working;
+  /// The second mapping of a dual mapped slab, null otherwise.
+  sys::OwningMemoryBlock Target;
+  /// True if the sections are padded to whole pages, so that they can be
+  /// protected one at a time.
+  bool PageGranular = false;
+  /// The free ranges of the slab, by working address. Adjacent free ranges
+  /// are always merged.
+  std::map<uint8_t *, size_t> FreeRanges;
+
+  uint8_t *getTargetAddress(uint8_t *WorkingAddr) const {
+    if (!Target.base())
+      return WorkingAddr;
+    return static_cast<uint8_t *>(Target.base()) +
+           (WorkingAddr - static_cast<uint8_t *>(Working.base()));
+  }
+
+  /// Allocates from the first free range the section fits in, so that the
+  /// sections stay packed at the start of the slab.
+  uint8_t *allocate(size_t Size, size_t Alignment) {
+    for (auto I = FreeRanges.begin(), E = FreeRanges.end(); I != E; ++I) {
+      uint8_t *Start = I->first;
+      size_t Length = I->second;
+      uint8_t *Addr = reinterpret_cast<uint8_t *>(alignAddr(Start, Alignment));
+      size_t Padding = Addr - Start;
+      if (Padding + Size > Length)
+        continue;
+
+      FreeRanges.erase(I);
+      if (Padding)
+        FreeRanges[Start] = Padding;
+      if (Padding + Size != Length)
+        FreeRanges[Addr + Size] = Length - Padding - Size;
+      return Addr;
+    }
+    return nullptr;
+  }
+
+  void release(uint8_t *Addr, size_t Size) {
+    auto Next = FreeRanges.lower_bound(Addr);
+    if (Next != FreeRanges.end() && Addr + Size == Next->first) {
+      Size += Next->second;
+      Next = FreeRanges.erase(Next);
+    }
+    if (Next != FreeRanges.begin()) {
+      auto Prev = std::prev(Next);
+      if (Prev->first + Prev->second == Addr) {
+        Prev->second += Size;
+        return;
+      }
+    }
+    FreeRanges[Addr] = Size;
+  }
+};
+
+double SlabMemoryPool::Statistics::getFragmentation() const {
+  if (FreeBytes == 0)
+    return 0.0;
+  return 1.0 - double(LargestFreeRange) / double(FreeBytes);
+}
+
+SlabMemoryPool::SlabMemoryPool(Options Opts) : Opts(Opts) {}
+
+SlabMemoryPool::~SlabMemoryPool() {}
+
+SlabMemoryPool::Slab *SlabMemoryPool::createSlab(AllocationPurpose Purpose,
+                                                 size_t MinSize) {
+  static const size_t PageSize = sys::Process::getPageSize();
+  size_t Size = alignTo(MinSize, Opts.SlabSize);
+  auto S = llvm::make_unique<Slab>();
+  std::error_code EC;
+
+  if (Purpose != AllocationPurpose::RWData && Opts.UseDualMapping &&
+      !DualMappingFailed) {
+    unsigned TargetFlags = Purpose == AllocationPurpose::Code
+                               ? sys::Memory::MF_READ | sys::Memory::MF_EXEC
+                               : sys::Memory::MF_READ;
+    sys::MemoryBlock Working, Target;
+    EC = sys::Memory::allocateDualMappedMemory(
+        Size, Opts.UseHugePages ? HugePageSize : PageSize, TargetFlags, Working,
+        Target);
+    if (!EC) {
+      S->Working = sys::OwningMemoryBlock(Working);
+      S->Target = sys::OwningMemoryBlock(Target);
+    } else {
+      // Do not try again for every slab: pad the sections instead.
+      DualMappingFailed = true;
+    }
+  }
+
+  if (!S->Working.base()) {
+    S->Working = sys::OwningMemoryBlock(sys::Memory::allocateMappedMemory(
+        Size, nullptr, sys::Memory::MF_READ | sys::Memory::MF_WRITE, EC));
+    if (EC)
+      return nullptr;
+    S->PageGranular = Purpose != AllocationPurpose::RWData;
+  }
+
+  if (Opts.UseHugePages) {
+    sys::Memory::adviseHugePages(S->Working.base(), S->Working.size());
+    if (S->Target.base())
+      sys::Memory::adviseHugePages(S->Target.base(), S->Target.size());
+  }
+
+  S->FreeRanges[static_cast<uint8_t *>(S->Working.base())] = S->Working.size();
+  auto &PurposeSlabs = Slabs[unsigned(Purpose)];
+  PurposeSlabs.push_back(std::move(S));
+  return PurposeSlabs.back().get();
+}
+
+SlabMemoryPool::Block SlabMemoryPool::allocate(AllocationPurpose Purpose,
+                                               size_t Size,
+                                               unsigned Alignment) {
+  static const size_t PageSize = sys::Process::getPageSize();
+  // Every section gets an address of its own, even an empty one.
+  Size = std::max<size_t>(Size, 1);
+  size_t Align = std::max<size_t>(Alignment, 1);
+
+  auto TryAllocate = [&](Slab &S) -> Block {
+    size_t BlockSize = Size;
+    size_t BlockAlign = Align;
+    if (S.PageGranular) {
+      BlockSize = alignTo(Size, PageSize);
+      BlockAlign = std::max(Align, PageSize);
+    }
+    uint8_t *Working = S.allocate(BlockSize, BlockAlign);
+    if (!Working)
+      return {nullptr, Purpose, nullptr, nullptr, 0};
+    AllocatedBytes[unsigned(Purpose)] += BlockSize;
+    return {&S, Purpose, Working, S.getTargetAddress(Working), BlockSize};
+  };
+
+  std::lock_guard<std::mutex> Lock(PoolMutex);
+  for (auto &S : Slabs[unsigned(Purpose)]) {
+    Block B = TryAllocate(*S);
+    if (B.Working)
+      return B;
+  }
+
+  // Slabs start at a page boundary at least.
+  size_t MinSize = alignTo(Size, PageSize) + (Align > PageSize ? Align : 0);
+  if (Slab *S = createSlab(Purpose, MinSize))
+    return TryAllocate(*S);
+  return {nullptr, Purpose, nullptr, nullptr, 0};
+}
+
+bool SlabMemoryPool::finalize(ArrayRef<Block> Blocks, std::string *ErrMsg) {
+  for (const Block &B : Blocks) {
+    if (B.Purpose == AllocationPurpose::RWData)
+      continue;
+
+    // The target mapping of a dual mapped slab already has the final
+    // protection.
+    if (!B.S->PageGranular) {
+      if (B.Purpose == AllocationPurpose::Code)
+        sys::Memory::InvalidateInstructionCache(B.Target, B.Size);
+      continue;
+    }
+
+    unsigned Flags = B.Purpose == AllocationPurpose::Code
+                         ? sys::Memory::MF_READ | sys::Memory::MF_EXEC
+                         : sys::Memory::MF_READ;
+    if (std::error_code EC = sys::Memory::protectMappedMemory(
+            sys::MemoryBlock(B.Working, B.Size), Flags)) {
+      if (ErrMsg)
+        *ErrMsg = EC.message();
+      return true;
+    }
+  }
+  return false;
+}
+
+void SlabMemoryPool::release(ArrayRef<Block> Blocks) {
+  // Make the pages of padded sections writable again before they are reused.
+  for (const Block &B : Blocks)
+    if (B.S->PageGranular)
+      sys::Memory::protectMappedMemory(
+          sys::MemoryBlock(B.Working, B.Size),
+          sys::Memory::MF_READ | sys::Memory::MF_WRITE);
+
+  std::lock_guard<std::mutex> Lock(PoolMutex);
+  for (const Block &B : Blocks) {
+    B.S->release(B.Working, B.Size);
+    AllocatedBytes[unsigned(B.Purpose)] -= B.Size;
+  }
+}
+
+SlabMemoryPool::Statistics
+SlabMemoryPool::getStatistics(AllocationPurpose Purpose) const {
+  std::lock_guard<std::mutex> Lock(PoolMutex);
+  Statistics Stats;
+  Stats.AllocatedBytes = AllocatedBytes[unsigned(Purpose)];
+  for (auto &S : Slabs[unsigned(Purpose)]) {
+    ++Stats.NumSlabs;
+    Stats.MappedBytes += S->Working.size();
+    for (auto &KV : S->FreeRanges) {
+      ++Stats.NumFreeRanges;
+      Stats.FreeBytes += KV.second;
+      Stats.LargestFreeRange = std::max<uint64_t>(Stats.LargestFreeRange,
+                                                  KV.second);
+    }
+  }
+  return Stats;
+}
+
+void SlabMemoryPool::printStatistics(raw_ostream &OS) const {
+  static const struct {
+    AllocationPurpose Purpose;
+    const char *Name;
+  } Purposes[] = {{AllocationPurpose::Code, "code"},
+                  {AllocationPurpose::ROData, "read-only data"},
+                  {AllocationPurpose::RWData, "read-write data"}};
+
+  OS << "Slab memory pool:\n";
+  for (const auto &P : Purposes) {
+    Statistics Stats = getStatistics(P.Purpose);
+    OS << "  " << P.Name << ": " << Stats.NumSlabs << " slabs, "
+       << Stats.MappedBytes << " bytes mapped, " << Stats.AllocatedBytes
+       << " allocated, " << Stats.FreeBytes << " free in "
+       << Stats.NumFreeRanges << " ranges (largest " << Stats.LargestFreeRange
+       << "), fragmentation " << format("%.2f", Stats.getFragmentation())
+       << "\n";
+  }
+}
+
+SlabMemoryManager::~SlabMemoryManager() {
+  // The frames must not be found in memory that is reused.
+  deregisterEHFrames();
+  Pool.release(Blocks);
+}
+
+uint8_t *
+SlabMemoryManager::allocateSection(SlabMemoryPool::AllocationPurpose Purpose,
+                                   uintptr_t Size, unsigned Alignment) {
+  SlabMemoryPool::Block B = Pool.allocate(Purpose, Size, Alignment);
+  if (!B.Working)
+    return nullptr;
+  Blocks.push_back(B);
+  return B.Working;
+}
+
+uint8_t *SlabMemoryManager::allocateCodeSection(uintptr_t Size,
+                                                unsigned Alignment,
+                                                unsigned SectionID,
+                                                StringRef SectionName) {
+  return allocateSection(SlabMemoryPool::AllocationPurpose::Code, Size,
+                         Alignment);
+}
+
+uint8_t *SlabMemoryManager::allocateDataSection(uintptr_t Size,
+                                                unsigned Alignment,
+                                                unsigned SectionID,
+                                                StringRef SectionName,
+                                                bool IsReadOnly) {
+  return allocateSection(IsReadOnly ? SlabMemoryPool::AllocationPurpose::ROData
+                                    : SlabMemoryPool::AllocationPurpose::RWData,
+                         Size, Alignment);
+}
+
+void SlabMemoryManager::notifyObjectLoaded(RuntimeDyld &RTDyld,
+                                           const object::ObjectFile &Obj) {
+  for (size_t I = NumMapped, E = Blocks.size(); I != E; ++I)
+    if (Blocks[I].Working != Blocks[I].Target)
+      RTDyld.mapSectionAddress(Blocks[I].Working,
+                               pointerToJITTargetAddress(Blocks[I].Target));
+  NumMapped = Blocks.size();
+}
+
+void SlabMemoryManager::registerEHFrames(uint8_t *Addr, uint64_t LoadAddr,
+                                         size_t Size) {
+  // The unwinder reads the frames where the code runs.
+  uint8_t *TargetAddr = jitTargetAddressToPointer<uint8_t *>(LoadAddr);
+  RTDyldMemoryManager::registerEHFramesInProcess(TargetAddr, Size);
+  EHFrames.push_back({TargetAddr, Size});
+}
+
+void SlabMemoryManager::deregisterEHFrames() {
+  for (auto &Frame : EHFrames)
+    RTDyldMemoryManager::deregisterEHFramesInProcess(Frame.Addr, Frame.Size);
+  EHFrames.clear();
+}
+
+bool SlabMemoryManager::finalizeMemory(std::string *ErrMsg) {
+  bool HasError = Pool.finalize(
+      makeArrayRef(Blocks).slice(NumFinalized), ErrMsg);
+  NumFinalized = Blocks.size();
+  return HasError;
+}
+
+uint64_t SlabMemoryManager::getTargetAddress(const void *LocalAddress) const {
+  for (const auto &B : Blocks)
+    if (B.Working == LocalAddress)
+      return pointerToJITTargetAddress(B.Target);
+  return 0;
+}
@@ -61,5 +61,15 @@ ThreadSafeModule cloneToNewContext(ThreadSafeModule &TSM,
   return ThreadSafeModule(std::move(ClonedModule), std::move(NewTSCtx));
 }
 
+Expected<ThreadSafeModule>
+loadLazyBitcodeModule(std::unique_ptr<MemoryBuffer> Buffer,
+                      ThreadSafeContext TSCtx) {
+  auto Lock = TSCtx.getLock();
+  auto M = getOwningLazyBitcodeModule(std::move(Buffer), *TSCtx.getContext());
+  if (!M)
+    return M.takeError();
+  return ThreadSafeModule(std::move(*M), std::move(TSCtx));
+}
+
 } // end namespace orc
 } // end namespace llvm
@@ -0,0 +1,276 @@
+//===----- TieredCompileLayer.cpp - Recompile hot functions ---------------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ExecutionEngine/Orc/TieredCompileLayer.h"
+#include "llvm/IR/Constants.h"
+#include "llvm/IR/DerivedTypes.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/GlobalVariable.h"
+#include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/Instructions.h"
+#include "llvm/IR/MDBuilder.h"
+#include "llvm/IR/Mangler.h"
+#include "llvm/IR/Module.h"
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <set>
+
+using namespace llvm;
+using namespace llvm::orc;
+
+TieredCompileLayer::TieredCompileLayer(
+    ExecutionSession &ES, IRLayer &Tier1Layer, IRLayer &Tier2Layer,
+    LazyCallThroughManager &LCTMgr,
+    IndirectStubsManagerBuilder BuildIndirectStubsManager,
+    uint64_t HotThreshold)
+    : IRLayer(ES), Tier1Layer(Tier1Layer), Tier2Layer(Tier2Layer),
+      LCTMgr(LCTMgr),
+      BuildIndirectStubsManager(std::move(BuildIndirectStubsManager)),
+      HotThreshold(HotThreshold),
+      Dispatch([](std::function<void()> Recompile) { Recompile(); }) {
+  assert(HotThreshold > 0 && "A function can not be hot before its first call");
+}
+
+void TieredCompileLayer::setDispatchFunction(DispatchFunction Dispatch) {
+  this->Dispatch = std::move(Dispatch);
+}
+
+unsigned TieredCompileLayer::getNumRecompiledFunctions() const {
+  std::lock_guard<std::mutex> Lock(TieredLayerMutex);
+  return NumRecompiled;
+}
+
+void TieredCompileLayer::emit(MaterializationResponsibility R,
+                              ThreadSafeModule TSM) {
+  assert(TSM.getModule() && "Null module");
+
+  auto &ES = getExecutionSession();
+  auto &M = *TSM.getModule();
+
+  cleanUpModule(M);
+
+  // The tier 2 code of a function is compiled on its own, so everything it
+  // refers to must be reachable by name from another module.
+  std::vector<GlobalValue *> PromotedGlobals;
+  {
+    std::lock_guard<std::mutex> Lock(TieredLayerMutex);
+    PromotedGlobals = PromoteSymbols(M);
+  }
+  MangleAndInterner Mangle(ES, M.getDataLayout());
+  if (!PromotedGlobals.empty()) {
+    SymbolFlagsMap SymbolFlags;
+    for (auto &GV : PromotedGlobals)
+      SymbolFlags[Mangle(GV->getName())] = JITSymbolFlags::fromGlobalValue(*GV);
+    if (auto Err = R.defineMaterializing(SymbolFlags)) {
+      ES.reportError(std::move(Err));
+      R.failMaterialization();
+      return;
+    }
+  }
+
+  auto &PDR = getPerDylibResources(R.getTargetJITDylib());
+
+  // Aliases can not refer to the stub of their aliasee, so aliased functions
+  // keep their tier 1 code.
+  std::set<const GlobalObject *> Aliased;
+  for (auto &A : M.aliases())
+    Aliased.insert(A.getBaseObject());
+
+  SymbolAliasMap NonCallables;
+  SymbolAliasMap Callables;
+  std::vector<Function *> Tiered;
+  for (auto &GV : M.global_values()) {
+    if (GV.isDeclaration() || GV.hasLocalLinkage() || GV.hasAppendingLinkage())
+      continue;
+
+    auto Name = Mangle(GV.getName());
+    auto Flags = JITSymbolFlags::fromGlobalValue(GV);
+    auto *F = dyn_cast<Function>(&GV);
+    if (F && !F->hasFnAttribute(Attribute::Naked) && !Aliased.count(F)) {
+      Callables[Name] = SymbolAliasMapEntry(
+          Mangle((F->getName() + ".tier1").str()), Flags);
+      Tiered.push_back(F);
+    } else if (Flags.isCallable())
+      Callables[Name] = SymbolAliasMapEntry(Name, Flags);
+    else
+      NonCallables[Name] = SymbolAliasMapEntry(Name, Flags);
+  }
+
+  // Keep a copy of the module as it is now to recompile its hot functions
+  // from.
+  auto Source = std::make_shared<ThreadSafeModule>(cloneToNewContext(TSM));
+
+  // Rename the tier 1 code of each function and make all the references to
+  // the function, including those from the same module, go through its stub,
+  // so that they all reach the tier 2 code once it is installed. Then count
+  // the calls.
+  for (auto *F : Tiered) {
+    std::string IRName = F->getName();
+    F->setName(IRName + ".tier1");
+    Function *Decl = cloneFunctionDecl(M, *F);
+    Decl->setLinkage(GlobalValue::ExternalLinkage);
+    F->replaceAllUsesWith(Decl);
+    Decl->setName(IRName);
+
+    uint64_t Index;
+    {
+      std::lock_guard<std::mutex> Lock(TieredLayerMutex);
+      Index = Functions.size();
+      Functions.push_back({&PDR, Source, IRName, Mangle(IRName),
+                           Mangle(IRName + ".tier2")});
+    }
+    addCallCounter(*F, Index);
+  }
+
+  if (auto Err = Tier1Layer.add(PDR.getImplDylib(), std::move(TSM),
+                                R.getVModuleKey())) {
+    ES.reportError(std::move(Err));
+    R.failMaterialization();
+    return;
+  }
+
+  R.replace(reexports(PDR.getImplDylib(), std::move(NonCallables), true));
+  R.replace(lazyReexports(LCTMgr, PDR.getISManager(), PDR.getImplDylib(),
+                          std::move(Callables)));
+}
+
+TieredCompileLayer::PerDylibResources &
+TieredCompileLayer::getPerDylibResources(JITDylib &TargetD) {
+  std::lock_guard<std::mutex> Lock(TieredLayerMutex);
+  auto I = DylibResources.find(&TargetD);
+  if (I == DylibResources.end()) {
+    auto &ImplD = getExecutionSession().createJITDylib(
+        TargetD.getName() + ".impl", false);
+    TargetD.withSearchOrderDo([&](const JITDylibSearchList &TargetSearchOrder) {
+      auto NewSearchOrder = TargetSearchOrder;
+      assert(!NewSearchOrder.empty() &&
+             NewSearchOrder.front().first == &TargetD &&
+             NewSearchOrder.front().second == true &&
+             "TargetD must be at the front of its own search order and match "
+             "non-exported symbol");
+      NewSearchOrder.insert(std::next(NewSearchOrder.begin()), {&ImplD, true});
+      ImplD.setSearchOrder(std::move(NewSearchOrder), false);
+    });
+    PerDylibResources PDR(ImplD, BuildIndirectStubsManager());
+    I = DylibResources.insert(std::make_pair(&TargetD, std::move(PDR))).first;
+  }
+
+  return I->second;
+}
+
+void TieredCompileLayer::cleanUpModule(Module &M) {
+  for (auto &F : M.functions()) {
+    if (F.isDeclaration())
+      continue;
+
+    if (F.hasAvailableExternallyLinkage()) {
+      F.deleteBody();
+      F.setPersonalityFn(nullptr);
+      continue;
+    }
+  }
+}
+
+void TieredCompileLayer::addCallCounter(Function &F, uint64_t Index) {
+  Module &M = *F.getParent();
+  LLVMContext &Ctx = M.getContext();
+  Type *Int64Ty = Type::getInt64Ty(Ctx);
+  Type *IntPtrTy = M.getDataLayout().getIntPtrType(Ctx);
+
+  auto *Counter = new GlobalVariable(M, Int64Ty, false,
+                                     GlobalValue::PrivateLinkage,
+                                     ConstantInt::get(Int64Ty, 0),
+                                     F.getName() + ".calls");
+
+  // Count the call after the static allocas, so that they stay in the entry
+  // block.
+  BasicBlock &Entry = F.getEntryBlock();
+  BasicBlock::iterator IP = Entry.getFirstInsertionPt();
+  while (isa<AllocaInst>(IP))
+    ++IP;
+  BasicBlock *Body = Entry.splitBasicBlock(IP, "tiered.body");
+  Entry.getTerminator()->eraseFromParent();
+  BasicBlock *Hot = BasicBlock::Create(Ctx, "tiered.hot", &F, Body);
+
+  // The call that brings the count to the threshold, and only that one,
+  // reports the function as hot.
+  IRBuilder<> Builder(&Entry);
+  Value *Count = Builder.CreateAtomicRMW(AtomicRMWInst::Add, Counter,
+                                         ConstantInt::get(Int64Ty, 1),
+                                         AtomicOrdering::Monotonic);
+  Value *IsHot =
+      Builder.CreateICmpEQ(Count, ConstantInt::get(Int64Ty, HotThreshold - 1));
+  uint32_t ColdWeight = std::min<uint64_t>(
+      HotThreshold - 1, std::numeric_limits<uint32_t>::max());
+  Builder.CreateCondBr(IsHot, Hot, Body,
+                       MDBuilder(Ctx).createBranchWeights(1, ColdWeight));
+
+  Builder.SetInsertPoint(Hot);
+  auto *NotifyTy = FunctionType::get(Type::getVoidTy(Ctx), {IntPtrTy, Int64Ty},
+                                     false);
+  Constant *Notify = ConstantExpr::getIntToPtr(
+      ConstantInt::get(IntPtrTy, pointerToJITTargetAddress(&notifyHot)),
+      NotifyTy->getPointerTo());
+  Value *Self = ConstantInt::get(IntPtrTy, pointerToJITTargetAddress(this));
+  Builder.CreateCall(Notify, {Self, ConstantInt::get(Int64Ty, Index)});
+  Builder.CreateBr(Body);
+}
+
+void TieredCompileLayer::notifyHot(TieredCompileLayer *Layer,
+                                   uint64_t Index) {
+  TieredFunction TF;
+  {
+    std::lock_guard<std::mutex> Lock(Layer->TieredLayerMutex);
+    TF = Layer->Functions[Index];
+  }
+  Layer->Dispatch([Layer, TF]() { Layer->recompile(TF); });
+}
+
+void TieredCompileLayer::recompile(const TieredFunction &TF) {
+  auto &ES = getExecutionSession();
+  auto &ImplD = TF.PDR->getImplDylib();
+
+  // Extract the function alone. Its calls to the other functions of the
+  // module go through their stubs, and its references to global variables
+  // resolve to the tier 1 definitions.
+  auto TSM = cloneToNewContext(*TF.Source, [&](const GlobalValue &GV) {
+    return GV.getName() == TF.IRName;
+  });
+  auto &M = *TSM.getModule();
+  M.setModuleIdentifier(M.getModuleIdentifier() + ".tier2");
+  Function *F = M.getFunction(TF.IRName);
+  assert(F && !F->isDeclaration() && "Function was not extracted");
+  F->setName(TF.IRName + ".tier2");
+  F->setLinkage(GlobalValue::ExternalLinkage);
+  F->setVisibility(GlobalValue::DefaultVisibility);
+  F->setComdat(nullptr);
+
+  if (auto Err = Tier2Layer.add(ImplD, std::move(TSM), ES.allocateVModule())) {
+    ES.reportError(std::move(Err));
+    return;
+  }
+
+  auto Sym = ES.lookup(JITDylibSearchList({{&ImplD, true}}), TF.Tier2Name);
+  if (!Sym) {
+    ES.reportError(Sym.takeError());
+    return;
+  }
+
+  // Stub pointers are updated atomically, so the calls made concurrently go
+  // either to the tier 1 or to the tier 2 code.
+  if (auto Err = TF.PDR->getISManager().updatePointer(*TF.Name,
+                                                      Sym->getAddress())) {
+    ES.reportError(std::move(Err));
+    return;
+  }
+
+  std::lock_guard<std::mutex> Lock(TieredLayerMutex);
+  ++NumRecompiled;
+}
@@ -181,6 +181,9 @@ Expected<RuntimeDyldImpl::ObjSectionToIDMap>
 RuntimeDyldImpl::loadObjectImpl(const object::ObjectFile &Obj) {
   MutexGuard locked(lock);
 
+  // Forget the names of the last object, if loading it failed.
+  RelocationTargets.clear();
+
   // Save information about our target
   Arch = (Triple::ArchType)Obj.getArch();
   IsTargetLittleEndian = Obj.isLittleEndian();
@@ -386,6 +389,8 @@ RuntimeDyldImpl::loadObjectImpl(const object::ObjectFile &Obj) {
   if (auto Err = finalizeLoad(Obj, LocalSections))
     return std::move(Err);
 
+  RelocationTargets.clear();
+
 //   for (auto E : LocalSections)
 //     llvm::dbgs() << "Added: " << E.first.getRawDataRefImpl() << " -> " << E.second << "\n";
 
@@ -848,18 +853,35 @@ void RuntimeDyldImpl::addRelocationForSection(const RelocationEntry &RE,
   Relocations[SectionID].push_back(RE);
 }
 
+RuntimeDyldImpl::RelocationTarget &
+RuntimeDyldImpl::getRelocationTarget(StringRef SymbolName) {
+  auto I = RelocationTargets.find(SymbolName.data());
+  if (I != RelocationTargets.end())
+    return I->second;
+
+  // Symbols are only added to the global symbol table before the relocations
+  // are processed, so the result stays valid for the whole object.
+  RelocationTarget Target;
+  RTDyldSymbolTable::const_iterator Loc = GlobalSymbolTable.find(SymbolName);
+  if (Loc != GlobalSymbolTable.end())
+    Target.GlobalSymbol = &Loc->second;
+  return RelocationTargets[SymbolName.data()] = Target;
+}
+
 void RuntimeDyldImpl::addRelocationForSymbol(const RelocationEntry &RE,
                                              StringRef SymbolName) {
   // Relocation by symbol.  If the symbol is found in the global symbol table,
   // create an appropriate section relocation.  Otherwise, add it to
   // ExternalSymbolRelocations.
-  RTDyldSymbolTable::const_iterator Loc = GlobalSymbolTable.find(SymbolName);
-  if (Loc == GlobalSymbolTable.end()) {
-    ExternalSymbolRelocations[SymbolName].push_back(RE);
+  RelocationTarget &Target = getRelocationTarget(SymbolName);
+  if (!Target.GlobalSymbol) {
+    if (!Target.ExternalRelocations)
+      Target.ExternalRelocations = &ExternalSymbolRelocations[SymbolName];
+    Target.ExternalRelocations->push_back(RE);
   } else {
     // Copy the RE since we want to modify its addend.
     RelocationEntry RECopy = RE;
-    const auto &SymInfo = Loc->second;
+    const auto &SymInfo = *Target.GlobalSymbol;
     RECopy.Addend += SymInfo.getOffset();
     Relocations[SymInfo.getSectionID()].push_back(RECopy);
   }
@@ -1005,33 +1027,28 @@ void RuntimeDyldImpl::resolveRelocationList(const RelocationList &Relocs,
 
 void RuntimeDyldImpl::applyExternalSymbolRelocations(
     const StringMap<JITEvaluatedSymbol> ExternalSymbolMap) {
-  while (!ExternalSymbolRelocations.empty()) {
-
-    StringMap<RelocationList>::iterator i = ExternalSymbolRelocations.begin();
-
-    StringRef Name = i->first();
+  // All the symbols have been looked up already, and applying relocations
+  // does not add any, so a single pass over the relocations does.
+  for (auto &RelocKV : ExternalSymbolRelocations) {
+    StringRef Name = RelocKV.first();
+    RelocationList &Relocs = RelocKV.second;
     if (Name.size() == 0) {
       // This is an absolute symbol, use an address of zero.
       LLVM_DEBUG(dbgs() << "Resolving absolute relocations."
                         << "\n");
-      RelocationList &Relocs = i->second;
       resolveRelocationList(Relocs, 0);
     } else {
+      // Hash the name once for both symbol tables.
+      uint32_t FullHashValue = StringMapImpl::hash(Name);
       uint64_t Addr = 0;
       JITSymbolFlags Flags;
-      RTDyldSymbolTable::const_iterator Loc = GlobalSymbolTable.find(Name);
+      RTDyldSymbolTable::const_iterator Loc =
+          GlobalSymbolTable.find(Name, FullHashValue);
       if (Loc == GlobalSymbolTable.end()) {
-        auto RRI = ExternalSymbolMap.find(Name);
+        auto RRI = ExternalSymbolMap.find(Name, FullHashValue);
         assert(RRI != ExternalSymbolMap.end() && "No result for symbol");
         Addr = RRI->second.getAddress();
         Flags = RRI->second.getFlags();
-        // The call to getSymbolAddress may have caused additional modules to
-        // be loaded, which may have added new entries to the
-        // ExternalSymbolRelocations map.  Consquently, we need to update our
-        // iterator.  This is also why retrieval of the relocation list
-        // associated with this symbol is deferred until below this point.
-        // New entries may have been added to the relocation list.
-        i = ExternalSymbolRelocations.find(Name);
       } else {
         // We found the symbol in our global table.  It was probably in a
         // Module that we loaded previously.
@@ -1057,15 +1074,12 @@ void RuntimeDyldImpl::applyExternalSymbolRelocations(
 
         LLVM_DEBUG(dbgs() << "Resolving relocations Name: " << Name << "\t"
                           << format("0x%lx", Addr) << "\n");
-        // This list may have been updated when we called getSymbolAddress, so
-        // don't change this code to get the list earlier.
-        RelocationList &Relocs = i->second;
         resolveRelocationList(Relocs, Addr);
       }
     }
-
-    ExternalSymbolRelocations.erase(i);
   }
+
+  ExternalSymbolRelocations.clear();
 }
 
 Error RuntimeDyldImpl::resolveExternalSymbols() {
@@ -333,6 +333,67 @@ void RuntimeDyldELF::resolveX86_64Relocation(const SectionEntry &Section,
   }
 }
 
+namespace {
+/// Applies a single x86-64 relocation of a type known at compile time. Only
+/// the types handled here may be passed as \p Type.
+template <uint32_t Type>
+inline void applyX86_64Relocation(const SectionEntry &Section, uint64_t Offset,
+                                  uint64_t Value, int64_t Addend) {
+  static_assert(Type == ELF::R_X86_64_64 || Type == ELF::R_X86_64_PC32 ||
+                    Type == ELF::R_X86_64_32 || Type == ELF::R_X86_64_32S,
+                "Relocation type has no fast path");
+  if (Type == ELF::R_X86_64_64) {
+    support::ulittle64_t::ref(Section.getAddressWithOffset(Offset)) =
+        Value + Addend;
+  } else if (Type == ELF::R_X86_64_PC32) {
+    uint64_t FinalAddress = Section.getLoadAddressWithOffset(Offset);
+    int64_t RealOffset = Value + Addend - FinalAddress;
+    assert(isInt<32>(RealOffset));
+    support::ulittle32_t::ref(Section.getAddressWithOffset(Offset)) =
+        RealOffset & 0xFFFFFFFF;
+  } else {
+    Value += Addend;
+    assert((Type == ELF::R_X86_64_32 && (Value <= UINT32_MAX)) ||
+           (Type == ELF::R_X86_64_32S &&
+            ((int64_t)Value <= INT32_MAX && (int64_t)Value >= INT32_MIN)));
+    support::ulittle32_t::ref(Section.getAddressWithOffset(Offset)) =
+        Value & 0xFFFFFFFF;
+  }
+}
+} // end anonymous namespace
+
+void RuntimeDyldELF::resolveX86_64RelocationList(const RelocationList &Relocs,
+                                                 uint64_t Value) {
+  for (const RelocationEntry &RE : Relocs) {
+    const SectionEntry &Section = Sections[RE.SectionID];
+    // Ignore relocations for sections that were not loaded
+    if (Section.getAddress() == nullptr)
+      continue;
+    switch (RE.RelType) {
+    case ELF::R_X86_64_64:
+      applyX86_64Relocation<ELF::R_X86_64_64>(Section, RE.Offset, Value,
+                                              RE.Addend);
+      break;
+    case ELF::R_X86_64_PC32:
+      applyX86_64Relocation<ELF::R_X86_64_PC32>(Section, RE.Offset, Value,
+                                                RE.Addend);
+      break;
+    case ELF::R_X86_64_32:
+      applyX86_64Relocation<ELF::R_X86_64_32>(Section, RE.Offset, Value,
+                                              RE.Addend);
+      break;
+    case ELF::R_X86_64_32S:
+      applyX86_64Relocation<ELF::R_X86_64_32S>(Section, RE.Offset, Value,
+                                               RE.Addend);
+      break;
+    default:
+      resolveX86_64Relocation(Section, RE.Offset, Value, RE.RelType, RE.Addend,
+                              RE.SymOffset);
+      break;
+    }
+  }
+}
+
 void RuntimeDyldELF::resolveX86Relocation(const SectionEntry &Section,
                                           uint64_t Offset, uint32_t Value,
                                           uint32_t Type, int32_t Addend) {
@@ -921,6 +982,13 @@ void RuntimeDyldELF::resolveRelocation(const RelocationEntry &RE,
                            RE.SymOffset, RE.SectionID);
 }
 
+void RuntimeDyldELF::resolveRelocationList(const RelocationList &Relocs,
+                                           uint64_t Value) {
+  if (Arch == Triple::x86_64)
+    return resolveX86_64RelocationList(Relocs, Value);
+  RuntimeDyldImpl::resolveRelocationList(Relocs, Value);
+}
+
 void RuntimeDyldELF::resolveRelocation(const SectionEntry &Section,
                                        uint64_t Offset, uint64_t Value,
                                        uint32_t Type, int64_t Addend,
@@ -1123,9 +1191,9 @@ RuntimeDyldELF::processRelocationRef(
   SymbolRef::Type SymType = SymbolRef::ST_Unknown;
 
   // Search for the symbol in the global symbol table
-  RTDyldSymbolTable::const_iterator gsi = GlobalSymbolTable.end();
+  const SymbolTableEntry *GlobalSym = nullptr;
   if (Symbol != Obj.symbol_end()) {
-    gsi = GlobalSymbolTable.find(TargetName.data());
+    GlobalSym = getRelocationTarget(TargetName).GlobalSymbol;
     Expected<SymbolRef::Type> SymTypeOrErr = Symbol->getType();
     if (!SymTypeOrErr) {
       std::string Buf;
@@ -1136,8 +1204,8 @@ RuntimeDyldELF::processRelocationRef(
     }
     SymType = *SymTypeOrErr;
   }
-  if (gsi != GlobalSymbolTable.end()) {
-    const auto &SymInfo = gsi->second;
+  if (GlobalSym) {
+    const auto &SymInfo = *GlobalSym;
     Value.SectionID = SymInfo.getSectionID();
     Value.Offset = SymInfo.getOffset();
     Value.Addend = SymInfo.getOffset() + Addend;
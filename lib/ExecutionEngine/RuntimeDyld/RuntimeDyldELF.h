@@ -34,6 +34,11 @@ class RuntimeDyldELF : public RuntimeDyldImpl {
                                uint64_t Value, uint32_t Type, int64_t Addend,
                                uint64_t SymOffset);
 
+  /// Applies the relocations of \p Relocs to an x86-64 object, with the
+  /// common relocation types inlined into the loop.
+  void resolveX86_64RelocationList(const RelocationList &Relocs,
+                                   uint64_t Value);
+
   void resolveX86Relocation(const SectionEntry &Section, uint64_t Offset,
                             uint32_t Value, uint32_t Type, int32_t Addend);
 
@@ -174,6 +179,8 @@ public:
   loadObject(const object::ObjectFile &O) override;
 
   void resolveRelocation(const RelocationEntry &RE, uint64_t Value) override;
+  void resolveRelocationList(const RelocationList &Relocs,
+                             uint64_t Value) override;
   Expected<relocation_iterator>
   processRelocationRef(unsigned SectionID, relocation_iterator RelI,
                        const ObjectFile &Obj,
@@ -14,6 +14,7 @@
 #ifndef LLVM_LIB_EXECUTIONENGINE_RUNTIMEDYLD_RUNTIMEDYLDIMPL_H
 #define LLVM_LIB_EXECUTIONENGINE_RUNTIMEDYLD_RUNTIMEDYLDIMPL_H
 
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/StringMap.h"
 #include "llvm/ADT/Triple.h"
@@ -288,6 +289,19 @@ protected:
   // modules.  This map is indexed by symbol name.
   StringMap<RelocationList> ExternalSymbolRelocations;
 
+  // What the symbol names referenced by the relocations of the object being
+  // loaded resolve to, so that the symbol tables are searched once per symbol
+  // rather than once per relocation. The names are keyed by their address in
+  // the object, which tells the symbols apart, and the map is cleared after
+  // each object.
+  struct RelocationTarget {
+    // The entry for the symbol in GlobalSymbolTable, if it has one.
+    const SymbolTableEntry *GlobalSymbol = nullptr;
+    // The list in ExternalSymbolRelocations for the symbol, once one of its
+    // relocations has been added.
+    RelocationList *ExternalRelocations = nullptr;
+  };
+  DenseMap<const char *, RelocationTarget> RelocationTargets;
 
   typedef std::map<RelocationValueRef, uintptr_t> StubMap;
 
@@ -412,12 +426,18 @@ protected:
   // be found in the global symbol table, or it may be external.
   void addRelocationForSymbol(const RelocationEntry &RE, StringRef SymbolName);
 
+  // Returns what SymbolName, a name from the object being loaded, resolves to.
+  RelocationTarget &getRelocationTarget(StringRef SymbolName);
+
   /// Emits long jump instruction to Addr.
   /// \return Pointer to the memory area for emitting target address.
   uint8_t *createStubFunction(uint8_t *Addr, unsigned AbiVariant = 0);
 
-  /// Resolves relocations from Relocs list with address from Value.
-  void resolveRelocationList(const RelocationList &Relocs, uint64_t Value);
+  /// Resolves relocations from Relocs list with address from Value. Targets
+  /// may override this with a loop that applies their common relocation
+  /// types without going through resolveRelocation.
+  virtual void resolveRelocationList(const RelocationList &Relocs,
+                                     uint64_t Value);
 
   /// A object file specific relocation resolver
   /// \param RE The relocation to be resolved
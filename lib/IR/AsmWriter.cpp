@@ -24,6 +24,7 @@
 #include "llvm/ADT/Optional.h"
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/SetVector.h"
+#include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/SmallString.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/StringExtras.h"
@@ -52,6 +53,7 @@
 #include "llvm/IR/GlobalVariable.h"
 #include "llvm/IR/IRPrintingPasses.h"
 #include "llvm/IR/InlineAsm.h"
+#include "llvm/IR/InstIterator.h"
 #include "llvm/IR/InstrTypes.h"
 #include "llvm/IR/Instruction.h"
 #include "llvm/IR/Instructions.h"
@@ -70,11 +72,13 @@
 #include "llvm/IR/Value.h"
 #include "llvm/Support/AtomicOrdering.h"
 #include "llvm/Support/Casting.h"
+#include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Compiler.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/Format.h"
 #include "llvm/Support/FormattedStream.h"
+#include "llvm/Support/ThreadPool.h"
 #include "llvm/Support/raw_ostream.h"
 #include <algorithm>
 #include <cassert>
@@ -90,6 +94,11 @@
 
 using namespace llvm;
 
+static cl::opt<unsigned> AsmWriterThreads(
+    "asm-writer-threads", cl::Hidden, cl::init(0),
+    cl::desc("Number of threads used to print the function bodies of a "
+             "module (0 prints them serially)"));
+
 // Make virtual table appear in this compilation unit.
 AssemblyAnnotationWriter::~AssemblyAnnotationWriter() = default;
 
@@ -751,6 +760,10 @@ public:
 
   const Function *getFunction() const { return TheFunction; }
 
+  bool shouldInitializeAllMetadata() const {
+    return ShouldInitializeAllMetadata;
+  }
+
   /// After calling incorporateFunction, use this method to remove the
   /// most recently incorporated function from the SlotTracker. This
   /// will reset the state of the machine back to just the module contents.
@@ -2379,6 +2392,7 @@ public:
   void printIndirectSymbol(const GlobalIndirectSymbol *GIS);
   void printComdat(const Comdat *C);
   void printFunction(const Function *F);
+  void printFunctions(const Module *M);
   void printArgument(const Argument *FA, AttributeSet Attrs);
   void printBasicBlock(const BasicBlock *BB);
   void printInstructionLine(const Instruction &I);
@@ -2619,8 +2633,7 @@ void AssemblyWriter::printModule(const Module *M) {
   printUseLists(nullptr);
 
   // Output all of the functions.
-  for (const Function &F : *M)
-    printFunction(&F);
+  printFunctions(M);
   assert(UseListOrders.empty() && "All use-lists should have been consumed");
 
   // Output all attribute groups.
@@ -2891,13 +2904,14 @@ void AssemblyWriter::printFunctionSummary(const FunctionSummary *FS) {
 
   FunctionSummary::FFlags FFlags = FS->fflags();
   if (FFlags.ReadNone | FFlags.ReadOnly | FFlags.NoRecurse |
-      FFlags.ReturnDoesNotAlias) {
+      FFlags.ReturnDoesNotAlias | FFlags.Pagerando) {
     Out << ", funcFlags: (";
     Out << "readNone: " << FFlags.ReadNone;
     Out << ", readOnly: " << FFlags.ReadOnly;
     Out << ", noRecurse: " << FFlags.NoRecurse;
     Out << ", returnDoesNotAlias: " << FFlags.ReturnDoesNotAlias;
     Out << ", noInline: " << FFlags.NoInline;
+    Out << ", pagerando: " << FFlags.Pagerando;
     Out << ")";
   }
   if (!FS->calls().empty()) {
@@ -3460,6 +3474,86 @@ void AssemblyWriter::printFunction(const Function *F) {
   Machine.purgeFunction();
 }
 
+/// Create the elements of the constant data sequentials reachable from \p C.
+/// Printing creates them on demand, which would modify the context.
+static void
+createConstantDataElements(const Constant *C,
+                           SmallPtrSetImpl<const Constant *> &Visited) {
+  if (isa<GlobalValue>(C) || !Visited.insert(C).second)
+    return;
+  if (const auto *CDS = dyn_cast<ConstantDataSequential>(C)) {
+    if (!isa<ConstantDataArray>(CDS) || !CDS->isString())
+      for (unsigned I = 0, E = CDS->getNumElements(); I != E; ++I)
+        CDS->getElementAsConstant(I);
+    return;
+  }
+  for (const Value *Op : C->operands())
+    if (const auto *OpC = dyn_cast<Constant>(Op))
+      createConstantDataElements(OpC, Visited);
+}
+
+/// Print all of the functions of \p M. With -asm-writer-threads, the function
+/// bodies are formatted concurrently into separate buffers, which are then
+/// written in order.
+void AssemblyWriter::printFunctions(const Module *M) {
+  unsigned NumThreads = std::min<size_t>(AsmWriterThreads, M->size());
+  if (NumThreads <= 1 || AnnotationWriter || ShouldPreserveUseListOrder) {
+    for (const Function &F : *M)
+      printFunction(&F);
+    return;
+  }
+
+  std::vector<const Function *> Functions;
+  SmallPtrSet<const Constant *, 32> Visited;
+  for (const Function &F : *M) {
+    Functions.push_back(&F);
+    for (const Use &U : F.operands())
+      if (const auto *C = dyn_cast_or_null<Constant>(U.get()))
+        createConstantDataElements(C, Visited);
+    for (const Instruction &I : instructions(F))
+      for (const Value *Op : I.operands()) {
+        if (const auto *MV = dyn_cast<MetadataAsValue>(Op))
+          if (const auto *CM = dyn_cast<ConstantAsMetadata>(MV->getMetadata()))
+            Op = CM->getValue();
+        if (const auto *C = dyn_cast<Constant>(Op))
+          createConstantDataElements(C, Visited);
+      }
+  }
+
+  // Metadata and call site attribute sets are numbered in function order, so
+  // every worker numbers the functions before its range as well, and so does
+  // this writer for the metadata and attribute groups printed after them.
+  std::vector<std::string> Bodies(NumThreads);
+  ThreadPool Pool(NumThreads);
+  for (unsigned T = 0; T != NumThreads; ++T) {
+    size_t Begin = Functions.size() * T / NumThreads;
+    size_t End = Functions.size() * (T + 1) / NumThreads;
+    Pool.async([&, T, Begin, End]() {
+      SlotTracker WorkerMachine(M, Machine.shouldInitializeAllMetadata());
+      raw_string_ostream OS(Bodies[T]);
+      formatted_raw_ostream FOS(OS);
+      AssemblyWriter Worker(FOS, WorkerMachine, M, nullptr, IsForDebug);
+      WorkerMachine.initializeIfNeeded();
+      for (size_t I = 0; I != Begin; ++I) {
+        WorkerMachine.incorporateFunction(Functions[I]);
+        WorkerMachine.initializeIfNeeded();
+        WorkerMachine.purgeFunction();
+      }
+      for (size_t I = Begin; I != End; ++I)
+        Worker.printFunction(Functions[I]);
+    });
+  }
+  for (const Function *F : Functions) {
+    Machine.incorporateFunction(F);
+    Machine.initializeIfNeeded();
+    Machine.purgeFunction();
+  }
+  Pool.wait();
+
+  for (const std::string &Body : Bodies)
+    Out << Body;
+}
+
 /// printArgument - This member is called for every argument that is passed into
 /// the function.  Simply print it out
 void AssemblyWriter::printArgument(const Argument *Arg, AttributeSet Attrs) {
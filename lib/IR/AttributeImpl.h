@@ -252,6 +252,8 @@ public:
 
   void Profile(FoldingSetNodeID &ID) const;
   static void Profile(FoldingSetNodeID &ID, ArrayRef<AttributeSet> Nodes);
+  static void Profile(FoldingSetHashBuilder &Hash,
+                      ArrayRef<AttributeSet> Nodes);
 
   void dump() const;
 };
@@ -81,12 +81,18 @@ unpackAllocSizeArgs(uint64_t Num) {
 Attribute Attribute::get(LLVMContext &Context, Attribute::AttrKind Kind,
                          uint64_t Val) {
   LLVMContextImpl *pImpl = Context.pImpl;
-  FoldingSetNodeID ID;
-  ID.AddInteger(Kind);
-  if (Val) ID.AddInteger(Val);
+  FoldingSetHashBuilder Hash;
+  Hash.AddInteger(Kind);
+  if (Val) Hash.AddInteger(Val);
 
   void *InsertPoint;
-  AttributeImpl *PA = pImpl->AttrsSet.FindNodeOrInsertPos(ID, InsertPoint);
+  AttributeImpl *PA = pImpl->AttrsSet.FindNodeOrInsertPos(
+      Hash.ComputeHash(),
+      [&](AttributeImpl *A) {
+        return !A->isStringAttribute() && A->getKindAsEnum() == Kind &&
+               (A->isIntAttribute() ? A->getValueAsInt() : 0) == Val;
+      },
+      InsertPoint);
 
   if (!PA) {
     // If we didn't find any existing attributes of the same shape then create a
@@ -95,7 +101,7 @@ Attribute Attribute::get(LLVMContext &Context, Attribute::AttrKind Kind,
       PA = new EnumAttributeImpl(Kind);
     else
       PA = new IntAttributeImpl(Kind, Val);
-    pImpl->AttrsSet.InsertNode(PA, InsertPoint);
+    pImpl->AttrsSet.InsertNode(PA, InsertPoint, Hash.ComputeHash());
   }
 
   // Return the Attribute that we found or created.
@@ -657,17 +663,21 @@ AttributeSetNode *AttributeSetNode::get(LLVMContext &C,
 
   // Otherwise, build a key to look up the existing attributes.
   LLVMContextImpl *pImpl = C.pImpl;
-  FoldingSetNodeID ID;
+  FoldingSetHashBuilder Hash;
 
   SmallVector<Attribute, 8> SortedAttrs(Attrs.begin(), Attrs.end());
   llvm::sort(SortedAttrs);
 
   for (const auto Attr : SortedAttrs)
-    Attr.Profile(ID);
+    Hash.AddPointer(Attr.getRawPointer());
 
   void *InsertPoint;
-  AttributeSetNode *PA =
-    pImpl->AttrsSetNodes.FindNodeOrInsertPos(ID, InsertPoint);
+  AttributeSetNode *PA = pImpl->AttrsSetNodes.FindNodeOrInsertPos(
+      Hash.ComputeHash(),
+      [&](AttributeSetNode *N) {
+        return makeArrayRef(N->begin(), N->end()) == makeArrayRef(SortedAttrs);
+      },
+      InsertPoint);
 
   // If we didn't find any existing attributes of the same shape then create a
   // new one and insert it.
@@ -675,7 +685,7 @@ AttributeSetNode *AttributeSetNode::get(LLVMContext &C,
     // Coallocate entries after the AttributeSetNode itself.
     void *Mem = ::operator new(totalSizeToAlloc<Attribute>(SortedAttrs.size()));
     PA = new (Mem) AttributeSetNode(SortedAttrs);
-    pImpl->AttrsSetNodes.InsertNode(PA, InsertPoint);
+    pImpl->AttrsSetNodes.InsertNode(PA, InsertPoint, Hash.ComputeHash());
   }
 
   // Return the AttributeSetNode that we found or created.
@@ -835,6 +845,12 @@ void AttributeListImpl::Profile(FoldingSetNodeID &ID,
     ID.AddPointer(Set.SetNode);
 }
 
+void AttributeListImpl::Profile(FoldingSetHashBuilder &Hash,
+                                ArrayRef<AttributeSet> Sets) {
+  for (const auto &Set : Sets)
+    Hash.AddPointer(Set.SetNode);
+}
+
 #if !defined(NDEBUG) || defined(LLVM_ENABLE_DUMP)
 LLVM_DUMP_METHOD void AttributeListImpl::dump() const {
   AttributeList(const_cast<AttributeListImpl *>(this)).dump();
@@ -850,12 +866,16 @@ AttributeList AttributeList::getImpl(LLVMContext &C,
   assert(!AttrSets.empty() && "pointless AttributeListImpl");
 
   LLVMContextImpl *pImpl = C.pImpl;
-  FoldingSetNodeID ID;
-  AttributeListImpl::Profile(ID, AttrSets);
+  FoldingSetHashBuilder Hash;
+  AttributeListImpl::Profile(Hash, AttrSets);
 
   void *InsertPoint;
-  AttributeListImpl *PA =
-      pImpl->AttrsLists.FindNodeOrInsertPos(ID, InsertPoint);
+  AttributeListImpl *PA = pImpl->AttrsLists.FindNodeOrInsertPos(
+      Hash.ComputeHash(),
+      [&](AttributeListImpl *L) {
+        return makeArrayRef(L->begin(), L->end()) == AttrSets;
+      },
+      InsertPoint);
 
   // If we didn't find any existing attributes of the same shape then
   // create a new one and insert it.
@@ -864,7 +884,7 @@ AttributeList AttributeList::getImpl(LLVMContext &C,
     void *Mem = ::operator new(
         AttributeListImpl::totalSizeToAlloc<AttributeSet>(AttrSets.size()));
     PA = new (Mem) AttributeListImpl(C, AttrSets);
-    pImpl->AttrsLists.InsertNode(PA, InsertPoint);
+    pImpl->AttrsLists.InsertNode(PA, InsertPoint, Hash.ComputeHash());
   }
 
   // Return the AttributesList that we found or created.
@@ -30,6 +30,7 @@
 #include "llvm/IR/Module.h"
 #include "llvm/IR/Type.h"
 #include "llvm/IR/Value.h"
+#include "llvm/OptRemarks/BinaryRemarks.h"
 #include "llvm/Support/Casting.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/ErrorHandling.h"
@@ -366,6 +367,61 @@ std::string DiagnosticInfoOptimizationBase::getMsg() const {
   return OS.str();
 }
 
+/// The tag naming the kind of a remark in the YAML and binary formats.
+static StringRef getRemarkTypeTag(const DiagnosticInfoOptimizationBase &R) {
+  switch (R.getKind()) {
+  case DK_OptimizationRemark:
+  case DK_MachineOptimizationRemark:
+    return "!Passed";
+  case DK_OptimizationRemarkMissed:
+  case DK_MachineOptimizationRemarkMissed:
+    return "!Missed";
+  case DK_OptimizationRemarkAnalysis:
+  case DK_MachineOptimizationRemarkAnalysis:
+    return "!Analysis";
+  case DK_OptimizationRemarkAnalysisFPCommute:
+    return "!AnalysisFPCommute";
+  case DK_OptimizationRemarkAnalysisAliasing:
+    return "!AnalysisAliasing";
+  case DK_OptimizationFailure:
+    return "!Failure";
+  default:
+    llvm_unreachable("Unknown remark type");
+  }
+}
+
+static Optional<remarks::RemarkLocation>
+getRemarkLocation(const DiagnosticLocation &DL) {
+  if (!DL.isValid())
+    return None;
+  remarks::RemarkLocation Loc;
+  Loc.File = DL.getRelativePath();
+  Loc.Line = DL.getLine();
+  Loc.Column = DL.getColumn();
+  return Loc;
+}
+
+void DiagnosticInfoOptimizationBase::writeBinary(
+    remarks::BinaryRemarkWriter &W) const {
+  SmallVector<remarks::RemarkArg, 8> RemarkArgs;
+  for (const Argument &Arg : Args) {
+    RemarkArgs.emplace_back();
+    RemarkArgs.back().Key = Arg.Key;
+    RemarkArgs.back().Value = Arg.Val;
+    RemarkArgs.back().Loc = getRemarkLocation(Arg.Loc);
+  }
+
+  remarks::Remark R;
+  R.Type = getRemarkTypeTag(*this);
+  R.PassName = PassName;
+  R.RemarkName = RemarkName;
+  R.FunctionName = GlobalValue::dropLLVMManglingEscape(getFunction().getName());
+  R.Loc = getRemarkLocation(getLocation());
+  R.Hotness = Hotness;
+  R.Args = RemarkArgs;
+  W.write(R);
+}
+
 namespace llvm {
 namespace yaml {
 
@@ -373,32 +429,7 @@ void MappingTraits<DiagnosticInfoOptimizationBase *>::mapping(
     IO &io, DiagnosticInfoOptimizationBase *&OptDiag) {
   assert(io.outputting() && "input not yet implemented");
 
-  if (io.mapTag("!Passed",
-                (OptDiag->getKind() == DK_OptimizationRemark ||
-                 OptDiag->getKind() == DK_MachineOptimizationRemark)))
-    ;
-  else if (io.mapTag(
-               "!Missed",
-               (OptDiag->getKind() == DK_OptimizationRemarkMissed ||
-                OptDiag->getKind() == DK_MachineOptimizationRemarkMissed)))
-    ;
-  else if (io.mapTag(
-               "!Analysis",
-               (OptDiag->getKind() == DK_OptimizationRemarkAnalysis ||
-                OptDiag->getKind() == DK_MachineOptimizationRemarkAnalysis)))
-    ;
-  else if (io.mapTag("!AnalysisFPCommute",
-                     OptDiag->getKind() ==
-                         DK_OptimizationRemarkAnalysisFPCommute))
-    ;
-  else if (io.mapTag("!AnalysisAliasing",
-                     OptDiag->getKind() ==
-                         DK_OptimizationRemarkAnalysisAliasing))
-    ;
-  else if (io.mapTag("!Failure", OptDiag->getKind() == DK_OptimizationFailure))
-    ;
-  else
-    llvm_unreachable("Unknown remark type");
+  io.mapTag(getRemarkTypeTag(*OptDiag), true);
 
   // These are read-only for now.
   DiagnosticLocation DL = OptDiag->getLocation();
@@ -167,6 +167,19 @@ void LLVMContext::setDiagnosticsOutputFile(std::unique_ptr<yaml::Output> F) {
   pImpl->DiagnosticsOutputFile = std::move(F);
 }
 
+remarks::BinaryRemarkWriter *LLVMContext::getDiagnosticsBinaryOutputFile() {
+  return pImpl->DiagnosticsBinaryOutputFile.get();
+}
+
+void LLVMContext::setDiagnosticsBinaryOutputFile(
+    std::unique_ptr<remarks::BinaryRemarkWriter> W) {
+  pImpl->DiagnosticsBinaryOutputFile = std::move(W);
+}
+
+bool LLVMContext::hasDiagnosticsOutputFile() {
+  return getDiagnosticsOutputFile() || getDiagnosticsBinaryOutputFile();
+}
+
 DiagnosticHandler::DiagnosticHandlerTy
 LLVMContext::getDiagnosticHandlerCallBack() const {
   return pImpl->DiagHandler->DiagHandlerCallback;
@@ -234,6 +247,8 @@ void LLVMContext::diagnose(const DiagnosticInfo &DI) {
       auto *P = const_cast<DiagnosticInfoOptimizationBase *>(OptDiagBase);
       *Out << P;
     }
+    if (remarks::BinaryRemarkWriter *W = getDiagnosticsBinaryOutputFile())
+      OptDiagBase->writeBinary(*W);
   }
   // If there is a report handler, use it.
   if (pImpl->DiagHandler &&
@@ -340,6 +355,18 @@ void LLVMContext::setOptPassGate(OptPassGate& OPG) {
   pImpl->setOptPassGate(OPG);
 }
 
+unsigned LLVMContext::sweepUnusedConstants() {
+  return pImpl->sweepUnusedConstants();
+}
+
+size_t LLVMContext::getNumUniquedConstants() const {
+  return pImpl->getNumUniquedConstants();
+}
+
+size_t LLVMContext::getNumUniquedMDNodes() const {
+  return pImpl->getNumUniquedMDNodes();
+}
+
 const DiagnosticHandler *LLVMContext::getDiagHandlerPtr() const {
   return pImpl->DiagHandler.get();
 }
@@ -157,6 +157,87 @@ void LLVMContextImpl::dropTriviallyDeadConstantArrays() {
   } while (Changed);
 }
 
+/// Return true if nothing refers to \p C, so that it can be destroyed.
+static bool isUnreferencedConstant(const Constant *C) {
+  return C->use_empty() && !C->isUsedByMetadata() && !C->hasValueHandle();
+}
+
+template <class MapTy>
+static unsigned destroyUnreferencedConstants(MapTy &Map) {
+  unsigned NumDestroyed = 0;
+  for (auto I = Map.begin(), E = Map.end(); I != E;) {
+    auto *C = *I++;
+    if (isUnreferencedConstant(C)) {
+      C->destroyConstant();
+      ++NumDestroyed;
+    }
+  }
+  return NumDestroyed;
+}
+
+unsigned LLVMContextImpl::sweepUnusedConstants() {
+  unsigned NumDestroyed = 0;
+  unsigned NumDestroyedBefore;
+  // Destroying a constant drops the uses of its operands, so repeat until the
+  // aggregates and expressions do not change any more.
+  do {
+    NumDestroyedBefore = NumDestroyed;
+    NumDestroyed += destroyUnreferencedConstants(ExprConstants);
+    NumDestroyed += destroyUnreferencedConstants(ArrayConstants);
+    NumDestroyed += destroyUnreferencedConstants(StructConstants);
+    NumDestroyed += destroyUnreferencedConstants(VectorConstants);
+  } while (NumDestroyed != NumDestroyedBefore);
+
+  SmallVector<ConstantDataSequential *, 16> DeadCDS;
+  for (auto &Entry : CDSConstants)
+    for (ConstantDataSequential *CDS = Entry.getValue(); CDS; CDS = CDS->Next)
+      if (isUnreferencedConstant(CDS))
+        DeadCDS.push_back(CDS);
+  for (ConstantDataSequential *CDS : DeadCDS)
+    CDS->destroyConstant();
+  NumDestroyed += DeadCDS.size();
+
+  // Integers and floating point values have no operands, so they are swept
+  // last. The cached i1 values are kept.
+  for (auto I = IntConstants.begin(), E = IntConstants.end(); I != E;) {
+    auto Entry = I++;
+    ConstantInt *C = Entry->second.get();
+    if (C != TheTrueVal && C != TheFalseVal && isUnreferencedConstant(C)) {
+      IntConstants.erase(Entry);
+      ++NumDestroyed;
+    }
+  }
+  for (auto I = FPConstants.begin(), E = FPConstants.end(); I != E;) {
+    auto Entry = I++;
+    if (isUnreferencedConstant(Entry->second.get())) {
+      FPConstants.erase(Entry);
+      ++NumDestroyed;
+    }
+  }
+
+  // The zero, null and undef values are kept: there is at most one of each per
+  // type, and types live as long as the context.
+  return NumDestroyed;
+}
+
+size_t LLVMContextImpl::getNumUniquedConstants() const {
+  size_t NumCDS = 0;
+  for (auto &Entry : CDSConstants)
+    for (ConstantDataSequential *CDS = Entry.getValue(); CDS; CDS = CDS->Next)
+      ++NumCDS;
+  return IntConstants.size() + FPConstants.size() + CAZConstants.size() +
+         ArrayConstants.size() + StructConstants.size() +
+         VectorConstants.size() + CPNConstants.size() + UVConstants.size() +
+         NumCDS + BlockAddresses.size() + ExprConstants.size();
+}
+
+size_t LLVMContextImpl::getNumUniquedMDNodes() const {
+  size_t NumNodes = 0;
+#define HANDLE_MDNODE_LEAF_UNIQUABLE(CLASS) NumNodes += CLASS##s.size();
+#include "llvm/IR/Metadata.def"
+  return NumNodes;
+}
+
 void Module::dropTriviallyDeadConstantArrays() {
   Context.pImpl->dropTriviallyDeadConstantArrays();
 }
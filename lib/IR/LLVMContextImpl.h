@@ -39,6 +39,7 @@
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/Metadata.h"
 #include "llvm/IR/TrackingMDRef.h"
+#include "llvm/OptRemarks/BinaryRemarks.h"
 #include "llvm/Support/Allocator.h"
 #include "llvm/Support/Casting.h"
 #include "llvm/Support/YAMLTraits.h"
@@ -1228,6 +1229,7 @@ public:
   bool DiagnosticsHotnessRequested = false;
   uint64_t DiagnosticsHotnessThreshold = 0;
   std::unique_ptr<yaml::Output> DiagnosticsOutputFile;
+  std::unique_ptr<remarks::BinaryRemarkWriter> DiagnosticsBinaryOutputFile;
 
   LLVMContext::YieldCallbackTy YieldCallback = nullptr;
   void *YieldOpaqueHandle = nullptr;
@@ -1384,6 +1386,16 @@ public:
   /// Destroy the ConstantArrays if they are not used.
   void dropTriviallyDeadConstantArrays();
 
+  /// Destroy the uniqued constants that are not referenced. Returns the number
+  /// of constants destroyed.
+  unsigned sweepUnusedConstants();
+
+  /// Return the number of constants in the uniquing tables.
+  size_t getNumUniquedConstants() const;
+
+  /// Return the number of uniqued metadata nodes.
+  size_t getNumUniquedMDNodes() const;
+
   mutable OptPassGate *OPG = nullptr;
 
   /// Access the object which can disable optional passes and individual
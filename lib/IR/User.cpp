@@ -110,6 +110,13 @@ MutableArrayRef<uint8_t> User::getDescriptor() {
 //                         User operator new Implementations
 //===----------------------------------------------------------------------===//
 
+// Users are allocated individually, with their operands co-allocated in front
+// of them. They cannot come from a per-Function or per-Module arena: these
+// operators have no access to the parent, instructions are moved between
+// functions (e.g. by the CodeExtractor) and whole bodies are spliced across
+// modules by the IRMover, and erasing a single instruction must release its
+// memory in long-running clients.
+
 void *User::allocateFixedOperandUser(size_t Size, unsigned Us,
                                      unsigned DescBytes) {
   assert(Us < (1u << NumUserOperandsBits) && "Too many operands");
@@ -409,18 +409,32 @@ void Value::doRAUW(Value *New, ReplaceMetadataUses ReplaceMetaUses) {
   if (ReplaceMetaUses == ReplaceMetadataUses::Yes && isUsedByMetadata())
     ValueAsMetadata::handleRAUW(this, New);
 
+  // Must handle Constants specially, we cannot call replaceUsesOfWith on a
+  // constant because they are uniqued.
+  auto GetConstantUser = [](const Use &U) -> Constant * {
+    auto *C = dyn_cast<Constant>(U.getUser());
+    return C && !isa<GlobalValue>(C) ? C : nullptr;
+  };
+
   while (!materialized_use_empty()) {
-    Use &U = *UseList;
-    // Must handle Constants specially, we cannot call replaceUsesOfWith on a
-    // constant because they are uniqued.
-    if (auto *C = dyn_cast<Constant>(U.getUser())) {
-      if (!isa<GlobalValue>(C)) {
-        C->handleOperandChange(this, New);
-        continue;
-      }
+    if (Constant *C = GetConstantUser(*UseList)) {
+      C->handleOperandChange(this, New);
+      continue;
     }
 
-    U.set(New);
+    // Move the uses up to the next constant user to New in one go. They end up
+    // in the same order as if each of them was set to New, but they are not
+    // unlinked from this list one at a time.
+    Use *Next = UseList;
+    do {
+      Use *U = Next;
+      Next = U->Next;
+      U->Val = New;
+      U->addToList(&New->UseList);
+    } while (Next && !GetConstantUser(*Next));
+    UseList = Next;
+    if (Next)
+      Next->setPrev(&UseList);
   }
 
   if (BasicBlock *BB = dyn_cast<BasicBlock>(this))
@@ -105,6 +105,7 @@
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/MathExtras.h"
+#include "llvm/Support/ThreadPool.h"
 #include "llvm/Support/raw_ostream.h"
 #include <algorithm>
 #include <cassert>
@@ -115,6 +116,17 @@
 
 using namespace llvm;
 
+static cl::opt<unsigned> VerifierThreads(
+    "verifier-threads", cl::Hidden, cl::init(0),
+    cl::desc("Number of threads used to verify the functions of a module "
+             "(0 verifies them serially)"));
+
+static cl::opt<bool> VerifyDominance(
+    "verify-dominance", cl::Hidden, cl::init(true),
+    cl::desc("Check that instructions dominate their uses. Disabling this "
+             "leaves the structural checks, which do not need a dominator "
+             "tree"));
+
 namespace llvm {
 
 struct VerifierSupport {
@@ -331,7 +343,7 @@ public:
     // out-of-date dominator tree and makes it significantly more complex to run
     // this code outside of a pass manager.
     // FIXME: It's really gross that we have to cast away constness here.
-    if (!F.empty())
+    if (!F.empty() && VerifyDominance)
       DT.recalculate(const_cast<Function &>(F));
 
     for (const BasicBlock &BB : F) {
@@ -395,7 +407,18 @@ public:
     return !Broken;
   }
 
+  /// Verify all functions of the module on \p NumThreads threads, like
+  /// calling verify(const Function &) on each of them.
+  bool verifyFunctions(unsigned NumThreads);
+
 private:
+  /// Merge the state collected by \p Other while verifying functions, which
+  /// is checked across functions or by verify(). The functions that have the
+  /// same subprogram attached as a function already merged are added to
+  /// \p Conflicting.
+  void mergeFunctionState(const Verifier &Other,
+                          SmallPtrSetImpl<const Function *> &Conflicting);
+
   // Verification methods...
   void visitGlobalValue(const GlobalValue &GV);
   void visitGlobalVariable(const GlobalVariable &GV);
@@ -1618,9 +1641,12 @@ void Verifier::verifyParameterAttrs(AttributeSet Attrs, Type *Ty,
          V);
 
   AttrBuilder IncompatibleAttrs = AttributeFuncs::typeIncompatible(Ty);
+  // Only build the attribute set when it is printed: it is created in the
+  // context, which verifyFunctions() must not modify.
   Assert(!AttrBuilder(Attrs).overlaps(IncompatibleAttrs),
          "Wrong types for attribute: " +
-             AttributeSet::get(Context, IncompatibleAttrs).getAsString(),
+             (OS ? AttributeSet::get(Context, IncompatibleAttrs).getAsString()
+                 : std::string()),
          V);
 
   if (PointerType *PTy = dyn_cast<PointerType>(Ty)) {
@@ -3874,6 +3900,9 @@ void Verifier::visitCleanupReturnInst(CleanupReturnInst &CRI) {
 }
 
 void Verifier::verifyDominatesUse(Instruction &I, unsigned i) {
+  if (!VerifyDominance)
+    return;
+
   Instruction *Op = cast<Instruction>(I.getOperand(i));
   // If the we have an invalid invoke, don't try to compute the dominance.
   // We already reject it in the invoke specific checks and the dominance
@@ -3917,7 +3946,8 @@ void Verifier::visitInstruction(Instruction &I) {
   BasicBlock *BB = I.getParent();
   Assert(BB, "Instruction not embedded in basic block!", &I);
 
-  if (!isa<PHINode>(I)) {   // Check that non-phi nodes are not self referential
+  // Check that non-phi nodes are not self referential
+  if (!isa<PHINode>(I) && VerifyDominance) {
     for (User *U : I.users()) {
       Assert(U != (User *)&I || !DT.isReachableFromEntry(BB),
              "Only PHI nodes may reference their own value!", &I);
@@ -4801,6 +4831,99 @@ void Verifier::verifySourceDebugInfo(const DICompileUnit &U, const DIFile &F) {
            "inconsistent use of embedded source");
 }
 
+/// Create the types that matching the prototype of intrinsic \p F against its
+/// description creates, so that verifying calls to it does not modify the
+/// context.
+static void createIntrinsicTypes(const Function &F) {
+  SmallVector<Intrinsic::IITDescriptor, 8> Table;
+  Intrinsic::getIntrinsicInfoTableEntries(F.getIntrinsicID(), Table);
+  ArrayRef<Intrinsic::IITDescriptor> TableRef = Table;
+  SmallVector<Type *, 4> ArgTys;
+  FunctionType *FTy = F.getFunctionType();
+  if (Intrinsic::matchIntrinsicType(FTy->getReturnType(), TableRef, ArgTys))
+    return;
+  for (Type *ParamTy : FTy->params())
+    if (Intrinsic::matchIntrinsicType(ParamTy, TableRef, ArgTys))
+      return;
+}
+
+bool Verifier::verifyFunctions(unsigned NumThreads) {
+  std::vector<const Function *> Functions;
+  for (const Function &F : M) {
+    Functions.push_back(&F);
+    if (F.isIntrinsic())
+      createIntrinsicTypes(F);
+  }
+  ConstantTokenNone::get(Context);
+
+  // The workers do not print anything, since printing values may create
+  // constants. The functions they find broken are verified again below to
+  // print the failures in order.
+  NumThreads = std::min<size_t>(NumThreads, Functions.size());
+  std::vector<std::unique_ptr<Verifier>> Workers;
+  std::vector<char> Invalid(Functions.size()), Failed(Functions.size());
+  {
+    ThreadPool Pool(NumThreads);
+    for (unsigned T = 0; T != NumThreads; ++T) {
+      size_t Begin = Functions.size() * T / NumThreads;
+      size_t End = Functions.size() * (T + 1) / NumThreads;
+      Workers.push_back(llvm::make_unique<Verifier>(
+          nullptr, TreatBrokenDebugInfoAsError, M));
+      Verifier &W = *Workers.back();
+      Pool.async([&W, &Functions, &Invalid, &Failed, Begin, End]() {
+        for (size_t I = Begin; I != End; ++I) {
+          bool BrokenDebugInfoBefore = W.BrokenDebugInfo;
+          Invalid[I] = !W.verify(*Functions[I]);
+          Failed[I] = Invalid[I] || W.BrokenDebugInfo != BrokenDebugInfoBefore;
+        }
+      });
+    }
+  }
+
+  Broken = false;
+  SmallPtrSet<const Function *, 4> Conflicting;
+  for (const std::unique_ptr<Verifier> &W : Workers) {
+    mergeFunctionState(*W, Conflicting);
+    BrokenDebugInfo |= W->BrokenDebugInfo;
+  }
+  bool AllValid = !Broken;
+  for (size_t I = 0, E = Functions.size(); I != E; ++I) {
+    if (Conflicting.count(Functions[I])) {
+      Invalid[I] |= TreatBrokenDebugInfoAsError;
+      Failed[I] = true;
+      BrokenDebugInfo = true;
+    }
+    AllValid &= !Invalid[I];
+    // This verifier has the state of all workers, so it finds the same
+    // failures.
+    if (Failed[I] && OS)
+      verify(*Functions[I]);
+  }
+  return AllValid;
+}
+
+void Verifier::mergeFunctionState(
+    const Verifier &Other, SmallPtrSetImpl<const Function *> &Conflicting) {
+  for (const auto &Attachment : Other.DISubprogramAttachments) {
+    const Function *&AttachedTo = DISubprogramAttachments[Attachment.first];
+    if (AttachedTo && AttachedTo != Attachment.second)
+      Conflicting.insert(Attachment.second);
+    else
+      AttachedTo = Attachment.second;
+  }
+  CUVisited.insert(Other.CUVisited.begin(), Other.CUVisited.end());
+  for (const auto &CUSource : Other.HasSourceDebugInfo) {
+    auto Inserted = HasSourceDebugInfo.insert(CUSource);
+    if (!Inserted.second && Inserted.first->second != CUSource.second)
+      DebugInfoCheckFailed("inconsistent use of embedded source");
+  }
+  for (const auto &Counts : Other.FrameEscapeInfo) {
+    auto &Entry = FrameEscapeInfo[Counts.first];
+    Entry.first = std::max(Entry.first, Counts.second.first);
+    Entry.second = std::max(Entry.second, Counts.second.second);
+  }
+}
+
 //===----------------------------------------------------------------------===//
 //  Implement the public interfaces to this file...
 //===----------------------------------------------------------------------===//
@@ -4822,8 +4945,11 @@ bool llvm::verifyModule(const Module &M, raw_ostream *OS,
   Verifier V(OS, /*ShouldTreatBrokenDebugInfoAsError=*/!BrokenDebugInfo, M);
 
   bool Broken = false;
-  for (const Function &F : M)
-    Broken |= !V.verify(F);
+  if (VerifierThreads > 1)
+    Broken |= !V.verifyFunctions(VerifierThreads);
+  else
+    for (const Function &F : M)
+      Broken |= !V.verify(F);
 
   Broken |= !V.verify();
   if (BrokenDebugInfo)
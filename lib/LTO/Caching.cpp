@@ -13,10 +13,12 @@
 
 #include "llvm/LTO/Caching.h"
 #include "llvm/ADT/StringExtras.h"
+#include "llvm/Support/CachePruning.h"
 #include "llvm/Support/Errc.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/Process.h"
+#include "llvm/Support/SmallVectorMemoryBuffer.h"
 #include "llvm/Support/raw_ostream.h"
 
 #if !defined(_MSC_VER) && !defined(__MINGW32__)
@@ -50,6 +52,8 @@ Expected<NativeObjectCache> lto::localCache(StringRef CacheDirectoryPath,
                                     /*RequiresNullTerminator*/ false);
       close(FD);
       if (MBOrErr) {
+        recordCacheEntryUse(CacheDirectoryPath, "llvmcache-" + Key.str(),
+                            (*MBOrErr)->getBufferSize());
         AddBuffer(Task, std::move(*MBOrErr));
         return AddStreamFn();
       }
@@ -125,6 +129,9 @@ Expected<NativeObjectCache> lto::localCache(StringRef CacheDirectoryPath,
                              TempFile.TmpName + " to " + EntryPath + ": " +
                              toString(std::move(E)) + "\n");
 
+        recordCacheEntryUse(sys::path::parent_path(EntryPath),
+                            sys::path::filename(EntryPath),
+                            (*MBOrErr)->getBufferSize());
         AddBuffer(Task, std::move(*MBOrErr));
       }
     };
@@ -147,3 +154,130 @@ Expected<NativeObjectCache> lto::localCache(StringRef CacheDirectoryPath,
     };
   };
 }
+
+NativeObjectCache lto::backendCache(std::shared_ptr<CacheBackend> Backend,
+                                    AddBufferFn AddBuffer) {
+  return [=](unsigned Task, StringRef Key) -> AddStreamFn {
+    Expected<std::unique_ptr<MemoryBuffer>> MBOrErr = Backend->lookup(Key);
+    if (!MBOrErr) {
+      errs() << "warning: ThinLTO cache lookup failed: "
+             << toString(MBOrErr.takeError()) << "\n";
+    } else if (*MBOrErr) {
+      AddBuffer(Task, std::move(*MBOrErr));
+      return AddStreamFn();
+    }
+
+    // This native object stream collects the object in memory, stores it in
+    // the backend and calls AddBuffer to add it to the link.
+    struct BackendCacheStream : NativeObjectStream {
+      std::shared_ptr<CacheBackend> Backend;
+      AddBufferFn AddBuffer;
+      std::unique_ptr<SmallString<0>> Buffer;
+      std::string Key;
+      unsigned Task;
+
+      BackendCacheStream(std::unique_ptr<raw_pwrite_stream> OS,
+                         std::shared_ptr<CacheBackend> Backend,
+                         AddBufferFn AddBuffer,
+                         std::unique_ptr<SmallString<0>> Buffer,
+                         std::string Key, unsigned Task)
+          : NativeObjectStream(std::move(OS)), Backend(std::move(Backend)),
+            AddBuffer(std::move(AddBuffer)), Buffer(std::move(Buffer)),
+            Key(std::move(Key)), Task(Task) {}
+
+      ~BackendCacheStream() {
+        // Make sure the stream is flushed before storing the object.
+        OS.reset();
+
+        if (Error E = Backend->store(Key, MemoryBufferRef(*Buffer, Key)))
+          errs() << "warning: ThinLTO cache store failed: "
+                 << toString(std::move(E)) << "\n";
+
+        AddBuffer(Task, llvm::make_unique<SmallVectorMemoryBuffer>(
+                            std::move(*Buffer), Key));
+      }
+    };
+
+    std::string KeyStr = Key.str();
+    return [=](size_t Task) -> std::unique_ptr<NativeObjectStream> {
+      auto Buffer = llvm::make_unique<SmallString<0>>();
+      auto OS = llvm::make_unique<raw_svector_ostream>(*Buffer);
+      return llvm::make_unique<BackendCacheStream>(
+          std::move(OS), Backend, AddBuffer, std::move(Buffer), KeyStr, Task);
+    };
+  };
+}
+
+namespace {
+class SharedDirectoryCacheBackend : public CacheBackend {
+public:
+  explicit SharedDirectoryCacheBackend(StringRef Path) : Path(Path) {}
+
+  Expected<std::unique_ptr<MemoryBuffer>> lookup(StringRef Key) override;
+  Error store(StringRef Key, MemoryBufferRef Object) override;
+
+private:
+  std::string Path;
+
+  // Spread the objects over subdirectories to keep directories small for
+  // file systems with slow lookups in large directories.
+  SmallString<128> getShardPath(StringRef Key) const {
+    SmallString<128> ShardPath(Path);
+    sys::path::append(ShardPath, Key.take_front(2));
+    return ShardPath;
+  }
+};
+} // end anonymous namespace
+
+Expected<std::unique_ptr<MemoryBuffer>>
+SharedDirectoryCacheBackend::lookup(StringRef Key) {
+  SmallString<128> EntryPath = getShardPath(Key);
+  sys::path::append(EntryPath, Key);
+  ErrorOr<std::unique_ptr<MemoryBuffer>> MBOrErr =
+      MemoryBuffer::getFile(EntryPath, /*FileSize*/ -1,
+                            /*RequiresNullTerminator*/ false);
+  if (MBOrErr)
+    return std::move(*MBOrErr);
+  std::error_code EC = MBOrErr.getError();
+  if (EC == errc::no_such_file_or_directory)
+    return nullptr;
+  return createFileError(EntryPath.str(), errorCodeToError(EC));
+}
+
+Error SharedDirectoryCacheBackend::store(StringRef Key,
+                                         MemoryBufferRef Object) {
+  SmallString<128> ShardPath = getShardPath(Key);
+  if (std::error_code EC = sys::fs::create_directories(ShardPath))
+    return createFileError(ShardPath.str(), errorCodeToError(EC));
+
+  SmallString<128> TempFilenameModel(ShardPath);
+  sys::path::append(TempFilenameModel, "Thin-%%%%%%.tmp.o");
+  Expected<sys::fs::TempFile> Temp = sys::fs::TempFile::create(
+      TempFilenameModel, sys::fs::owner_read | sys::fs::owner_write |
+                             sys::fs::group_read | sys::fs::others_read);
+  if (!Temp)
+    return Temp.takeError();
+
+  {
+    raw_fd_ostream OS(Temp->FD, /* ShouldClose */ false);
+    OS << Object.getBuffer();
+    OS.flush();
+    if (OS.has_error()) {
+      OS.clear_error();
+      consumeError(Temp->discard());
+      return createStringError(errc::io_error, "failed to write %s",
+                               Temp->TmpName.c_str());
+    }
+  }
+
+  SmallString<128> EntryPath(ShardPath);
+  sys::path::append(EntryPath, Key);
+  return Temp->keep(EntryPath);
+}
+
+Expected<std::unique_ptr<CacheBackend>>
+lto::createSharedDirectoryCacheBackend(StringRef Path) {
+  if (std::error_code EC = sys::fs::create_directories(Path))
+    return errorCodeToError(EC);
+  return llvm::make_unique<SharedDirectoryCacheBackend>(Path);
+}
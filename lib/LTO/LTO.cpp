@@ -12,12 +12,14 @@
 //===----------------------------------------------------------------------===//
 
 #include "llvm/LTO/LTO.h"
+#include "llvm/ADT/DenseSet.h"
 #include "llvm/ADT/Statistic.h"
 #include "llvm/Analysis/TargetLibraryInfo.h"
 #include "llvm/Analysis/TargetTransformInfo.h"
 #include "llvm/Bitcode/BitcodeReader.h"
 #include "llvm/Bitcode/BitcodeWriter.h"
 #include "llvm/CodeGen/Analysis.h"
+#include "llvm/CodeGen/PagerandoBinning.h"
 #include "llvm/Config/llvm-config.h"
 #include "llvm/IR/AutoUpgrade.h"
 #include "llvm/IR/DiagnosticPrinter.h"
@@ -46,6 +48,7 @@
 #include "llvm/Transforms/Utils/FunctionImportUtils.h"
 #include "llvm/Transforms/Utils/SplitModule.h"
 
+#include <condition_variable>
 #include <set>
 
 using namespace llvm;
@@ -58,6 +61,22 @@ static cl::opt<bool>
     DumpThinCGSCCs("dump-thin-cg-sccs", cl::init(false), cl::Hidden,
                    cl::desc("Dump the SCCs in the ThinLTO index's callgraph"));
 
+static cl::opt<bool> PagerandoThinLTOBinning(
+    "pagerando-thinlto-binning", cl::init(true), cl::Hidden,
+    cl::desc("Assign Pagerando bins globally during the ThinLTO thin link"));
+
+static cl::opt<unsigned> ThinLTOBackendMemoryBudget(
+    "thinlto-backend-memory-budget", cl::init(0), cl::Hidden,
+    cl::value_desc("MB"),
+    cl::desc("Delay in-process ThinLTO backends so that their estimated "
+             "combined peak memory use stays within this many megabytes "
+             "(0 = no limit)"));
+
+static cl::opt<unsigned> ThinLTOBackendMemoryFactor(
+    "thinlto-backend-memory-factor", cl::init(20), cl::Hidden,
+    cl::desc("Estimated peak memory use of a ThinLTO backend, as a multiple "
+             "of the size of the bitcode it loads"));
+
 /// Enable global value internalization in LTO.
 cl::opt<bool> EnableLTOInternalization(
     "enable-lto-internalization", cl::init(true), cl::Hidden,
@@ -206,6 +225,9 @@ void llvm::computeLTOCacheKey(
       for (auto &ET : FS->calls()) {
         AddUnsigned(ET.first.isDSOLocal());
         AddUsedCfiGlobal(ET.first.getGUID());
+        // Calls into the caller's Pagerando bin are marked for relaxation.
+        if (Index.hasPagerandoBins())
+          AddUnsigned(Index.getPagerandoBin(ET.first.getGUID()));
       }
     }
   };
@@ -218,6 +240,8 @@ void llvm::computeLTOCacheKey(
         ArrayRef<uint8_t>((const uint8_t *)&Linkage, sizeof(Linkage)));
     AddUsedCfiGlobal(GS.first);
     AddUsedThings(GS.second);
+    if (Index.hasPagerandoBins())
+      AddUnsigned(Index.getPagerandoBin(GS.first));
   }
 
   // Imported functions may introduce new uses of type identifier resolutions,
@@ -941,6 +965,7 @@ public:
 namespace {
 class InProcessThinBackend : public ThinBackendProc {
   ThreadPool BackendThreadPool;
+  unsigned ThreadCount;
   AddStreamFn AddStream;
   NativeObjectCache Cache;
   std::set<GlobalValue::GUID> CfiFunctionDefs;
@@ -949,6 +974,28 @@ class InProcessThinBackend : public ThinBackendProc {
   Optional<Error> Err;
   std::mutex ErrMu;
 
+  /// A backend job, started by wait() once it fits in the memory budget.
+  struct BackendJob {
+    unsigned Task;
+    BitcodeModule BM;
+    const FunctionImporter::ImportMapTy *ImportList;
+    const FunctionImporter::ExportSetTy *ExportList;
+    const std::map<GlobalValue::GUID, GlobalValue::LinkageTypes> *ResolvedODR;
+    const GVSummaryMapTy *DefinedGlobals;
+    MapVector<StringRef, BitcodeModule> *ModuleMap;
+    uint64_t EstimatedMemory;
+  };
+  std::vector<BackendJob> Jobs;
+
+  /// Total number of instructions in the summaries of each module, used to
+  /// estimate the share of a module's bitcode loaded by importing.
+  StringMap<uint64_t> ModuleInstCounts;
+
+  std::mutex SchedulerMu;
+  std::condition_variable SchedulerCV;
+  uint64_t MemoryInUse = 0;
+  unsigned JobsRunning = 0;
+
 public:
   InProcessThinBackend(
       Config &Conf, ModuleSummaryIndex &CombinedIndex,
@@ -957,7 +1004,8 @@ public:
       AddStreamFn AddStream, NativeObjectCache Cache)
       : ThinBackendProc(Conf, CombinedIndex, ModuleToDefinedGVSummaries),
         BackendThreadPool(ThinLTOParallelismLevel),
-        AddStream(std::move(AddStream)), Cache(std::move(Cache)) {
+        ThreadCount(std::max(ThinLTOParallelismLevel, 1u)), AddStream(std::move(AddStream)),
+        Cache(std::move(Cache)) {
     for (auto &Name : CombinedIndex.cfiFunctionDefs())
       CfiFunctionDefs.insert(
           GlobalValue::getGUID(GlobalValue::dropLLVMManglingEscape(Name)));
@@ -1004,6 +1052,44 @@ public:
     return Error::success();
   }
 
+  uint64_t getModuleInstCount(StringRef ModulePath) {
+    auto Insert = ModuleInstCounts.insert({ModulePath, 0});
+    if (Insert.second) {
+      auto It = ModuleToDefinedGVSummaries.find(ModulePath);
+      if (It != ModuleToDefinedGVSummaries.end())
+        for (auto &GVS : It->second)
+          if (auto *FS = dyn_cast<FunctionSummary>(GVS.second))
+            Insert.first->second += FS->instCount();
+    }
+    return Insert.first->second;
+  }
+
+  /// Estimate the peak memory use of the backend for BM. The backend loads
+  /// the module and the imported functions, whose share of their source
+  /// module's bitcode is assumed to be proportional to their instruction
+  /// count. The in-memory IR and the code generator's data structures are
+  /// assumed to take a fixed multiple of that.
+  uint64_t
+  estimateBackendMemory(BitcodeModule &BM,
+                        const FunctionImporter::ImportMapTy &ImportList,
+                        MapVector<StringRef, BitcodeModule> &ModuleMap) {
+    uint64_t Bytes = BM.getBuffer().size();
+    for (auto &Src : ImportList) {
+      auto SrcBM = ModuleMap.find(Src.first());
+      uint64_t SrcInsts = getModuleInstCount(Src.first());
+      if (SrcBM == ModuleMap.end() || !SrcInsts)
+        continue;
+      uint64_t ImportedInsts = 0;
+      for (auto GUID : Src.second)
+        if (auto *S = CombinedIndex.findSummaryInModule(GUID, Src.first()))
+          if (auto *FS = dyn_cast<FunctionSummary>(S->getBaseObject()))
+            ImportedInsts += FS->instCount();
+      Bytes += SrcBM->second.getBuffer().size() *
+               std::min(ImportedInsts, SrcInsts) / SrcInsts;
+    }
+    return Bytes * ThinLTOBackendMemoryFactor;
+  }
+
   Error start(
       unsigned Task, BitcodeModule BM,
       const FunctionImporter::ImportMapTy &ImportList,
@@ -1014,32 +1100,81 @@ public:
     assert(ModuleToDefinedGVSummaries.count(ModulePath));
     const GVSummaryMapTy &DefinedGlobals =
         ModuleToDefinedGVSummaries.find(ModulePath)->second;
-    BackendThreadPool.async(
-        [=](BitcodeModule BM, ModuleSummaryIndex &CombinedIndex,
-            const FunctionImporter::ImportMapTy &ImportList,
-            const FunctionImporter::ExportSetTy &ExportList,
-            const std::map<GlobalValue::GUID, GlobalValue::LinkageTypes>
-                &ResolvedODR,
-            const GVSummaryMapTy &DefinedGlobals,
-            MapVector<StringRef, BitcodeModule> &ModuleMap) {
-          Error E = runThinLTOBackendThread(
-              AddStream, Cache, Task, BM, CombinedIndex, ImportList, ExportList,
-              ResolvedODR, DefinedGlobals, ModuleMap);
-          if (E) {
-            std::unique_lock<std::mutex> L(ErrMu);
-            if (Err)
-              Err = joinErrors(std::move(*Err), std::move(E));
-            else
-              Err = std::move(E);
-          }
-        },
-        BM, std::ref(CombinedIndex), std::ref(ImportList), std::ref(ExportList),
-        std::ref(ResolvedODR), std::ref(DefinedGlobals), std::ref(ModuleMap));
+    // Jobs are only started by wait(), once they are all known and can be
+    // ordered by size.
+    Jobs.push_back({Task, BM, &ImportList, &ExportList, &ResolvedODR,
+                    &DefinedGlobals, &ModuleMap,
+                    estimateBackendMemory(BM, ImportList, ModuleMap)});
     return Error::success();
   }
 
+  void runJob(const BackendJob &Job) {
+    Error E = runThinLTOBackendThread(
+        AddStream, Cache, Job.Task, Job.BM, CombinedIndex, *Job.ImportList,
+        *Job.ExportList, *Job.ResolvedODR, *Job.DefinedGlobals,
+        *Job.ModuleMap);
+    if (E) {
+      std::unique_lock<std::mutex> L(ErrMu);
+      if (Err)
+        Err = joinErrors(std::move(*Err), std::move(E));
+      else
+        Err = std::move(E);
+    }
+  }
+
+  /// Start the jobs largest first, which shortens the tail of the schedule.
+  /// With a memory budget, a job is only started while the estimated memory
+  /// use of all running jobs stays within the budget. A job that exceeds the
+  /// budget on its own is run when no other job is running.
+  void scheduleJobs() {
+    std::stable_sort(Jobs.begin(), Jobs.end(),
+                     [](const BackendJob &A, const BackendJob &B) {
+                       return A.EstimatedMemory > B.EstimatedMemory;
+                     });
+
+    uint64_t Budget = uint64_t(ThinLTOBackendMemoryBudget) << 20;
+    if (!Budget) {
+      for (const BackendJob &Job : Jobs)
+        BackendThreadPool.async([this, &Job]() { runJob(Job); });
+      return;
+    }
+
+    std::vector<bool> Started(Jobs.size());
+    for (size_t NumStarted = 0; NumStarted != Jobs.size(); ++NumStarted) {
+      std::unique_lock<std::mutex> L(SchedulerMu);
+      size_t Next;
+      SchedulerCV.wait(L, [&]() {
+        if (JobsRunning >= ThreadCount)
+          return false;
+        for (Next = 0; Next != Jobs.size(); ++Next)
+          if (!Started[Next] &&
+              (!JobsRunning ||
+               MemoryInUse + Jobs[Next].EstimatedMemory <= Budget))
+            return true;
+        return false;
+      });
+      const BackendJob &Job = Jobs[Next];
+      Started[Next] = true;
+      MemoryInUse += Job.EstimatedMemory;
+      ++JobsRunning;
+      LLVM_DEBUG(dbgs() << "Starting backend for "
+                        << Job.BM.getModuleIdentifier() << " (estimated "
+                        << (Job.EstimatedMemory >> 20) << " MB, "
+                        << (MemoryInUse >> 20) << " MB in use)\n");
+      BackendThreadPool.async([this, &Job]() {
+        runJob(Job);
+        std::unique_lock<std::mutex> L(SchedulerMu);
+        MemoryInUse -= Job.EstimatedMemory;
+        --JobsRunning;
+        SchedulerCV.notify_all();
+      });
+    }
+  }
+
   Error wait() override {
+    scheduleJobs();
     BackendThreadPool.wait();
+    Jobs.clear();
     if (Err)
       return std::move(*Err);
     else
@@ -1192,7 +1327,7 @@ Error LTO::runThinLTO(AddStreamFn AddStream, NativeObjectCache Cache) {
   // at -O0 because summary-based DCE is implemented using internalization, and
   // we must apply DCE consistently with the full LTO module in order to avoid
   // undefined references during the final link.
-  std::set<GlobalValue::GUID> ExportedGUIDs;
+  DenseSet<GlobalValue::GUID> ExportedGUIDs;
   for (auto &Res : GlobalResolutions) {
     // If the symbol does not have external references or it is not prevailing,
     // then not need to mark it as exported from a ThinLTO partition.
@@ -1232,6 +1367,12 @@ Error LTO::runThinLTO(AddStreamFn AddStream, NativeObjectCache Cache) {
   thinLTOResolvePrevailingInIndex(ThinLTO.CombinedIndex, isPrevailing,
                                   recordNewLinkage);
 
+  // The linker places all Pagerando bins with the same name into one segment,
+  // so bins must be assigned across all backends rather than per module.
+  if (Conf.RelocModel == Reloc::PIP && PagerandoThinLTOBinning)
+    computePagerandoBins(ThinLTO.CombinedIndex,
+                         Conf.Options.PagerandoBinSize);
+
   std::unique_ptr<ThinBackendProc> BackendProc =
       ThinLTO.Backend(Conf, ThinLTO.CombinedIndex, ModuleToDefinedGVSummaries,
                       AddStream, Cache);
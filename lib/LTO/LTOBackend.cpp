@@ -21,6 +21,7 @@
 #include "llvm/Analysis/TargetTransformInfo.h"
 #include "llvm/Bitcode/BitcodeReader.h"
 #include "llvm/Bitcode/BitcodeWriter.h"
+#include "llvm/CodeGen/PagerandoBinning.h"
 #include "llvm/IR/LegacyPassManager.h"
 #include "llvm/IR/PassManager.h"
 #include "llvm/IR/Verifier.h"
@@ -278,8 +279,12 @@ static void runOldPMPasses(Config &Conf, Module &Mod, TargetMachine *TM,
     PMB.populateThinLTOPassManager(passes);
   else
     PMB.populateLTOPassManager(passes);
-  if (TM->isPagerando())
+  if (TM->isPagerando()) {
     passes.add(createPagerandoWrappersPass());
+    // After internalization all callers of local wrappers are known
+    if (!IsThinLTO)
+      passes.add(createPagerandoWrapperEliminationPass());
+  }
   passes.run(Mod);
 }
 
@@ -488,6 +493,11 @@ Error lto::thinBackend(Config &Conf, unsigned Task, AddStreamFn AddStream,
   if (Conf.PreOptModuleHook && !Conf.PreOptModuleHook(Task, Mod))
     return finalizeOptimizationRemarks(std::move(DiagnosticOutputFile));
 
+  // Apply Pagerando bins assigned during the thin link. This needs the GUIDs
+  // from before promotion.
+  if (CombinedIndex.hasPagerandoBins())
+    applyPagerandoBins(Mod, CombinedIndex);
+
   renameModuleForThinLTO(Mod, CombinedIndex);
 
   dropDeadSymbols(Mod, DefinedGlobals, CombinedIndex);
@@ -79,6 +79,14 @@ namespace {
 static cl::opt<int>
     ThreadCount("threads", cl::init(llvm::heavyweight_hardware_concurrency()));
 
+// Hand newly generated objects to the linker from memory instead of mapping
+// them back from the cache. This trades memory for I/O when the cache lives
+// on a slow or remote file system.
+static cl::opt<bool> ReloadObjectsFromCache(
+    "thinlto-reload-objects-from-cache", cl::init(true), cl::Hidden,
+    cl::desc("Release generated objects and map them from the cache "
+             "directory when returning them in memory"));
+
 // Simple helper to save temporary files for debug.
 static void saveTempBitcode(const Module &TheModule, StringRef TempDir,
                             unsigned count, StringRef Suffix) {
@@ -348,6 +356,10 @@ public:
                                   /*FileSize*/ -1,
                                   /*RequiresNullTerminator*/ false);
     close(FD);
+    if (MBOrErr)
+      recordCacheEntryUse(sys::path::parent_path(EntryPath),
+                          sys::path::filename(EntryPath),
+                          (*MBOrErr)->getBufferSize());
     return MBOrErr;
   }
 
@@ -376,6 +388,9 @@ public:
     EC = sys::fs::rename(TempFilename, EntryPath);
     if (EC)
       sys::fs::remove(TempFilename);
+    else
+      recordCacheEntryUse(CachePath, sys::path::filename(EntryPath),
+                          OutputBuffer.getBufferSize());
   }
 };
 
@@ -1001,7 +1016,7 @@ void ThinLTOCodeGenerator::run() {
 
         if (SavedObjectsDirectoryPath.empty()) {
           // We need to generated a memory buffer for the linker.
-          if (!CacheEntryPath.empty()) {
+          if (!CacheEntryPath.empty() && ReloadObjectsFromCache) {
             // When cache is enabled, reload from the cache if possible.
             // Releasing the buffer from the heap and reloading it from the
             // cache file with mmap helps us to lower memory pressure.
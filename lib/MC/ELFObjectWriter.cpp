@@ -39,6 +39,7 @@
 #include "llvm/MC/StringTableBuilder.h"
 #include "llvm/Support/Allocator.h"
 #include "llvm/Support/Casting.h"
+#include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Compression.h"
 #include "llvm/Support/Endian.h"
 #include "llvm/Support/Error.h"
@@ -49,6 +50,7 @@
 #include "llvm/Support/SMLoc.h"
 #include "llvm/Support/StringSaver.h"
 #include "llvm/Support/SwapByteOrder.h"
+#include "llvm/Support/ThreadPool.h"
 #include "llvm/Support/raw_ostream.h"
 #include <algorithm>
 #include <cassert>
@@ -65,6 +67,11 @@ using namespace llvm;
 #undef  DEBUG_TYPE
 #define DEBUG_TYPE "reloc-info"
 
+static cl::opt<unsigned> WriterThreads(
+    "elf-writer-threads", cl::Hidden, cl::init(0),
+    cl::desc("Number of threads used to encode and compress the sections of "
+             "an ELF object (0 encodes them serially)"));
+
 namespace {
 
 using SectionIndexMapTy = DenseMap<const MCSectionELF *, uint32_t>;
@@ -160,7 +167,7 @@ struct ELFWriter {
 
   bool maybeWriteCompression(uint64_t Size,
                              SmallVectorImpl<char> &CompressedContents,
-                             bool ZLibStyle, unsigned Alignment);
+                             DebugCompressionType Type, unsigned Alignment);
 
 public:
   ELFWriter(ELFObjectWriter &OWriter, raw_pwrite_stream &OS,
@@ -212,8 +219,20 @@ public:
                           const SectionIndexMapTy &SectionIndexMap,
                           const SectionOffsetsTy &SectionOffsets);
 
+  /// The contents of a section, encoded before the section is written.
+  struct EncodedSection {
+    SmallVector<char, 0> Data;
+    SmallVector<char, 0> CompressedData;
+    bool Compressed = false;
+  };
+
+  bool shouldCompress(const MCAssembler &Asm,
+                      const MCSectionELF &Section) const;
+  void encodeSection(const MCAssembler &Asm, const MCSectionELF &Section,
+                     const MCAsmLayout &Layout, EncodedSection &Encoded) const;
   void writeSectionData(const MCAssembler &Asm, MCSection &Sec,
-                        const MCAsmLayout &Layout);
+                        const MCAsmLayout &Layout,
+                        EncodedSection *Encoded = nullptr);
 
   void WriteSecHdrEntry(uint32_t Name, uint32_t Type, uint64_t Flags,
                         uint64_t Address, uint64_t Offset, uint64_t Size,
@@ -806,9 +825,12 @@ MCSectionELF *ELFWriter::createRelocationSection(MCContext &Ctx,
 
 // Include the debug info compression header.
 bool ELFWriter::maybeWriteCompression(
-    uint64_t Size, SmallVectorImpl<char> &CompressedContents, bool ZLibStyle,
-    unsigned Alignment) {
-  if (ZLibStyle) {
+    uint64_t Size, SmallVectorImpl<char> &CompressedContents,
+    DebugCompressionType Type, unsigned Alignment) {
+  if (Type != DebugCompressionType::GNU) {
+    unsigned ChType = Type == DebugCompressionType::Zstd
+                          ? ELF::ELFCOMPRESS_ZSTD
+                          : ELF::ELFCOMPRESS_ZLIB;
     uint64_t HdrSize =
         is64Bit() ? sizeof(ELF::Elf32_Chdr) : sizeof(ELF::Elf64_Chdr);
     if (Size <= HdrSize + CompressedContents.size())
@@ -816,13 +838,13 @@ bool ELFWriter::maybeWriteCompression(
     // Platform specific header is followed by compressed data.
     if (is64Bit()) {
       // Write Elf64_Chdr header.
-      write(static_cast<ELF::Elf64_Word>(ELF::ELFCOMPRESS_ZLIB));
+      write(static_cast<ELF::Elf64_Word>(ChType));
       write(static_cast<ELF::Elf64_Word>(0)); // ch_reserved field.
       write(static_cast<ELF::Elf64_Xword>(Size));
       write(static_cast<ELF::Elf64_Xword>(Alignment));
     } else {
       // Write Elf32_Chdr header otherwise.
-      write(static_cast<ELF::Elf32_Word>(ELF::ELFCOMPRESS_ZLIB));
+      write(static_cast<ELF::Elf32_Word>(ChType));
       write(static_cast<ELF::Elf32_Word>(Size));
       write(static_cast<ELF::Elf32_Word>(Alignment));
     }
@@ -839,56 +861,87 @@ bool ELFWriter::maybeWriteCompression(
   return true;
 }
 
+bool ELFWriter::shouldCompress(const MCAssembler &Asm,
+                               const MCSectionELF &Section) const {
+  // Compressing debug_frame requires handling alignment fragments which is
+  // more work (possibly generalizing MCAssembler.cpp:writeFragment to allow
+  // for writing to arbitrary buffers) for little benefit.
+  StringRef SectionName = Section.getSectionName();
+  return Asm.getContext().getAsmInfo()->compressDebugSections() !=
+             DebugCompressionType::None &&
+         SectionName.startswith(".debug_") && SectionName != ".debug_frame";
+}
+
+/// Encode the contents of \p Section into \p Encoded, and compress them if
+/// the section is compressed. This does not modify the assembler, so it can
+/// run for several sections at once.
+void ELFWriter::encodeSection(const MCAssembler &Asm,
+                              const MCSectionELF &Section,
+                              const MCAsmLayout &Layout,
+                              EncodedSection &Encoded) const {
+  raw_svector_ostream VecOS(Encoded.Data);
+  Asm.writeSectionData(VecOS, &Section, Layout);
+  if (!shouldCompress(Asm, Section))
+    return;
+
+  StringRef Data(Encoded.Data.data(), Encoded.Data.size());
+  Error E = Asm.getContext().getAsmInfo()->compressDebugSections() ==
+                    DebugCompressionType::Zstd
+                ? zstd::compress(Data, Encoded.CompressedData)
+                : zlib::compress(Data, Encoded.CompressedData);
+  if (E)
+    consumeError(std::move(E));
+  else
+    Encoded.Compressed = true;
+}
+
 void ELFWriter::writeSectionData(const MCAssembler &Asm, MCSection &Sec,
-                                 const MCAsmLayout &Layout) {
+                                 const MCAsmLayout &Layout,
+                                 EncodedSection *Encoded) {
   MCSectionELF &Section = static_cast<MCSectionELF &>(Sec);
   StringRef SectionName = Section.getSectionName();
 
   auto &MC = Asm.getContext();
   const auto &MAI = MC.getAsmInfo();
 
-  // Compressing debug_frame requires handling alignment fragments which is
-  // more work (possibly generalizing MCAssembler.cpp:writeFragment to allow
-  // for writing to arbitrary buffers) for little benefit.
-  bool CompressionEnabled =
-      MAI->compressDebugSections() != DebugCompressionType::None;
-  if (!CompressionEnabled || !SectionName.startswith(".debug_") ||
-      SectionName == ".debug_frame") {
-    Asm.writeSectionData(W.OS, &Section, Layout);
+  if (!shouldCompress(Asm, Section)) {
+    if (Encoded)
+      W.OS << Encoded->Data;
+    else
+      Asm.writeSectionData(W.OS, &Section, Layout);
     return;
   }
 
-  assert((MAI->compressDebugSections() == DebugCompressionType::Z ||
-          MAI->compressDebugSections() == DebugCompressionType::GNU) &&
-         "expected zlib or zlib-gnu style compression");
-
-  SmallVector<char, 128> UncompressedData;
-  raw_svector_ostream VecOS(UncompressedData);
-  Asm.writeSectionData(VecOS, &Section, Layout);
+  DebugCompressionType CompressionType = MAI->compressDebugSections();
+  assert((CompressionType == DebugCompressionType::Z ||
+          CompressionType == DebugCompressionType::Zstd ||
+          CompressionType == DebugCompressionType::GNU) &&
+         "expected zlib, zstd or zlib-gnu style compression");
 
-  SmallVector<char, 128> CompressedContents;
-  if (Error E = zlib::compress(
-          StringRef(UncompressedData.data(), UncompressedData.size()),
-          CompressedContents)) {
-    consumeError(std::move(E));
+  EncodedSection LocalEncoded;
+  if (!Encoded) {
+    encodeSection(Asm, Section, Layout, LocalEncoded);
+    Encoded = &LocalEncoded;
+  }
+  SmallVectorImpl<char> &UncompressedData = Encoded->Data;
+  if (!Encoded->Compressed) {
     W.OS << UncompressedData;
     return;
   }
 
-  bool ZlibStyle = MAI->compressDebugSections() == DebugCompressionType::Z;
-  if (!maybeWriteCompression(UncompressedData.size(), CompressedContents,
-                             ZlibStyle, Sec.getAlignment())) {
+  if (!maybeWriteCompression(UncompressedData.size(), Encoded->CompressedData,
+                             CompressionType, Sec.getAlignment())) {
     W.OS << UncompressedData;
     return;
   }
 
-  if (ZlibStyle)
-    // Set the compressed flag. That is zlib style.
+  if (CompressionType != DebugCompressionType::GNU)
+    // Set the compressed flag. That is zlib or zstd style.
     Section.setFlags(Section.getFlags() | ELF::SHF_COMPRESSED);
   else
     // Add "z" prefix to section name. This is zlib-gnu style.
     MC.renameELFSection(&Section, (".z" + SectionName.drop_front(1)).str());
-  W.OS << CompressedContents;
+  W.OS << Encoded->CompressedData;
 }
 
 void ELFWriter::WriteSecHdrEntry(uint32_t Name, uint32_t Type, uint64_t Flags,
@@ -1081,20 +1134,49 @@ uint64_t ELFWriter::writeObject(MCAssembler &Asm, const MCAsmLayout &Layout) {
   SectionOffsetsTy SectionOffsets;
   std::vector<MCSectionELF *> Groups;
   std::vector<MCSectionELF *> Relocations;
+  std::vector<MCSectionELF *> Sections;
   for (MCSection &Sec : Asm) {
     MCSectionELF &Section = static_cast<MCSectionELF &>(Sec);
     if (Mode == NonDwoOnly && isDwoSection(Section))
       continue;
     if (Mode == DwoOnly && !isDwoSection(Section))
       continue;
+    Sections.push_back(&Section);
+  }
 
+  // With -elf-writer-threads, encode and compress the sections on worker
+  // threads first. They are still written one after another below, so the
+  // output is the same.
+  std::vector<EncodedSection> Encoded;
+  unsigned NumThreads = std::min<size_t>(WriterThreads, Sections.size());
+  if (NumThreads > 1) {
+    Encoded.resize(Sections.size());
+    ThreadPool Pool(NumThreads);
+    for (unsigned T = 0; T != NumThreads; ++T) {
+      size_t Begin = Sections.size() * T / NumThreads;
+      size_t End = Sections.size() * (T + 1) / NumThreads;
+      Pool.async([&, Begin, End]() {
+        for (size_t I = Begin; I != End; ++I)
+          encodeSection(Asm, *Sections[I], Layout, Encoded[I]);
+      });
+    }
+  }
+
+  for (size_t I = 0, E = Sections.size(); I != E; ++I) {
+    MCSectionELF &Section = *Sections[I];
     align(Section.getAlignment());
 
     // Remember the offset into the file for this section.
     uint64_t SecStart = W.OS.tell();
 
     const MCSymbolELF *SignatureSymbol = Section.getGroup();
-    writeSectionData(Asm, Section, Layout);
+    if (Encoded.empty()) {
+      writeSectionData(Asm, Section, Layout);
+    } else {
+      writeSectionData(Asm, Section, Layout, &Encoded[I]);
+      // Release the contents early, they can take a lot of memory.
+      Encoded[I] = EncodedSection();
+    }
 
     uint64_t SecEnd = W.OS.tell();
     SectionOffsets[&Section] = std::make_pair(SecStart, SecEnd);
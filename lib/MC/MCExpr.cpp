@@ -482,6 +482,11 @@ bool MCExpr::evaluateAsAbsolute(int64_t &Res, const MCAssembler *Asm,
   return evaluateAsAbsolute(Res, Asm, Layout, Addrs, Addrs);
 }
 
+static void AttemptToFoldSymbolOffsetDifference(
+    const MCAssembler *Asm, const MCAsmLayout *Layout,
+    const SectionAddrMap *Addrs, bool InSet, const MCSymbolRefExpr *&A,
+    const MCSymbolRefExpr *&B, int64_t &Addend);
+
 bool MCExpr::evaluateAsAbsolute(int64_t &Res, const MCAssembler *Asm,
                                 const MCAsmLayout *Layout,
                                 const SectionAddrMap *Addrs, bool InSet) const {
@@ -493,6 +498,27 @@ bool MCExpr::evaluateAsAbsolute(int64_t &Res, const MCAssembler *Asm,
     return true;
   }
 
+  // Fast path the difference of two labels, which is by far the most common
+  // non-constant expression in assembly input (.size, DWARF lengths, jump
+  // tables).
+  if (Asm && (InSet || !Asm->getBackend().requiresDiffExpressionRelocations()))
+    if (const MCBinaryExpr *BE = dyn_cast<MCBinaryExpr>(this))
+      if (BE->getOpcode() == MCBinaryExpr::Sub) {
+        const MCSymbolRefExpr *A = dyn_cast<MCSymbolRefExpr>(BE->getLHS());
+        const MCSymbolRefExpr *B = dyn_cast<MCSymbolRefExpr>(BE->getRHS());
+        if (A && B && A->getKind() == MCSymbolRefExpr::VK_None &&
+            B->getKind() == MCSymbolRefExpr::VK_None &&
+            !A->getSymbol().isVariable() && !B->getSymbol().isVariable()) {
+          int64_t Addend = 0;
+          AttemptToFoldSymbolOffsetDifference(Asm, Layout, Addrs, InSet, A, B,
+                                              Addend);
+          if (!A && !B) {
+            Res = Addend;
+            return true;
+          }
+        }
+      }
+
   bool IsRelocatable =
       evaluateAsRelocatableImpl(Value, Asm, Layout, nullptr, Addrs, InSet);
 
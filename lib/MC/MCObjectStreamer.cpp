@@ -19,10 +19,16 @@
 #include "llvm/MC/MCObjectWriter.h"
 #include "llvm/MC/MCSection.h"
 #include "llvm/MC/MCSymbol.h"
+#include "llvm/Support/CommandLine.h"
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/SourceMgr.h"
 using namespace llvm;
 
+static cl::opt<bool> CompactFragments(
+    "mc-compact-fragments", cl::Hidden, cl::init(false),
+    cl::desc("Release the unused storage of data fragments once they are "
+             "complete, to reduce the peak memory of the assembler"));
+
 MCObjectStreamer::MCObjectStreamer(MCContext &Context,
                                    std::unique_ptr<MCAsmBackend> TAB,
                                    std::unique_ptr<MCObjectWriter> OW,
@@ -43,6 +49,13 @@ MCAssembler *MCObjectStreamer::getAssemblerPtr() {
   return nullptr;
 }
 
+void MCObjectStreamer::finishCurrentFragment() {
+  if (!CompactFragments)
+    return;
+  if (auto *DF = dyn_cast_or_null<MCDataFragment>(getCurrentFragment()))
+    DF->shrinkToFit();
+}
+
 void MCObjectStreamer::flushPendingLabels(MCFragment *F, uint64_t FOffset) {
   if (PendingLabels.empty())
     return;
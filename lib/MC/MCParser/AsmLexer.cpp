@@ -136,8 +136,16 @@ AsmToken AsmLexer::LexHexFloatLiteral(bool NoIntDigits) {
 
 /// LexIdentifier: [a-zA-Z_.][a-zA-Z0-9_$.@?]*
 static bool IsIdentifierChar(char c, bool AllowAt) {
-  return isAlnum(c) || c == '_' || c == '$' || c == '.' ||
-         (c == '@' && AllowAt) || c == '?';
+  // Bitmap of [a-zA-Z0-9_$.?] over the ASCII range, so that scanning long
+  // identifiers costs a single load and test per character.
+  static const uint64_t IdentifierChars[2] = {0x83ff401000000000ULL,
+                                              0x07fffffe87fffffeULL};
+  unsigned char UC = static_cast<unsigned char>(c);
+  if (UC >= 128)
+    return false;
+  if (IdentifierChars[UC >> 6] & (1ULL << (UC & 63)))
+    return true;
+  return c == '@' && AllowAt;
 }
 
 AsmToken AsmLexer::LexIdentifier() {
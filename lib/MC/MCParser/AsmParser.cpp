@@ -199,6 +199,8 @@ public:
 
   void addAliasForDirective(StringRef Directive, StringRef Alias) override {
     DirectiveKindMap[Directive] = DirectiveKindMap[Alias];
+    if (!Directive.startswith("."))
+      HasUndottedDirective = true;
   }
 
   /// @name MCAsmParser Interface
@@ -519,6 +521,12 @@ private:
   /// directives parsed by this class.
   StringMap<DirectiveKind> DirectiveKindMap;
 
+  /// True if a target registered a directive alias that does not start with
+  /// a '.'. Otherwise only dotted identifiers are looked up in
+  /// DirectiveKindMap, which keeps the lookup off the path of every
+  /// instruction and label.
+  bool HasUndottedDirective = false;
+
   // ".ascii", ".asciz", ".string"
   bool parseDirectiveAscii(StringRef IDVal, bool ZeroTerminated);
   bool parseDirectiveReloc(SMLoc DirectiveLoc); // ".reloc"
@@ -1712,11 +1720,13 @@ bool AsmParser::parseStatement(ParseStatementInfo &Info,
   // Handle conditional assembly here before checking for skipping.  We
   // have to do this so that .endif isn't skipped in a ".if 0" block for
   // example.
-  StringMap<DirectiveKind>::const_iterator DirKindIt =
-      DirectiveKindMap.find(IDVal);
-  DirectiveKind DirKind = (DirKindIt == DirectiveKindMap.end())
-                              ? DK_NO_DIRECTIVE
-                              : DirKindIt->getValue();
+  DirectiveKind DirKind = DK_NO_DIRECTIVE;
+  if (IDVal.startswith(".") || HasUndottedDirective) {
+    StringMap<DirectiveKind>::const_iterator DirKindIt =
+        DirectiveKindMap.find(IDVal);
+    if (DirKindIt != DirectiveKindMap.end())
+      DirKind = DirKindIt->getValue();
+  }
   switch (DirKind) {
   default:
     break;
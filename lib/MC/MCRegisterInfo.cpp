@@ -32,6 +32,12 @@ unsigned MCRegisterInfo::getMatchingSuperReg(unsigned Reg, unsigned SubIdx,
 unsigned MCRegisterInfo::getSubReg(unsigned Reg, unsigned Idx) const {
   assert(Idx && Idx < getNumSubRegIndices() &&
          "This is not a subregister index");
+  // Look the sub-register up directly if TableGen emitted the table for it.
+  if (SubRegDeltas) {
+    assert(Reg < NumRegs && "This is not a register");
+    MCPhysReg Delta = SubRegDeltas[SubRegDeltaRows[Reg] + Idx];
+    return Delta ? MCPhysReg(Reg + Delta) : 0;
+  }
   // Get a pointer to the corresponding SubRegIndices list. This list has the
   // name of each sub-register in the same order as MCSubRegIterator.
   const uint16_t *SRI = SubRegIndices + get(Reg).SubRegIndices;
@@ -29,7 +29,8 @@ namespace mca {
 
 std::unique_ptr<Pipeline>
 Context::createDefaultPipeline(const PipelineOptions &Opts, InstrBuilder &IB,
-                               SourceMgr &SrcMgr) {
+                               SourceMgr &SrcMgr,
+                               std::unique_ptr<Stage> MemoryStage) {
   const MCSchedModel &SM = STI.getSchedModel();
 
   // Create the hardware units defining the backend.
@@ -56,6 +57,8 @@ Context::createDefaultPipeline(const PipelineOptions &Opts, InstrBuilder &IB,
   auto StagePipeline = llvm::make_unique<Pipeline>();
   StagePipeline->appendStage(std::move(Fetch));
   StagePipeline->appendStage(std::move(Dispatch));
+  if (MemoryStage)
+    StagePipeline->appendStage(std::move(MemoryStage));
   StagePipeline->appendStage(std::move(Execute));
   StagePipeline->appendStage(std::move(Retire));
   return StagePipeline;
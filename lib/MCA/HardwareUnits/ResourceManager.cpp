@@ -123,6 +123,19 @@ ResourceManager::ResourceManager(const MCSchedModel &SM) {
         llvm::make_unique<ResourceState>(*SM.getProcResource(I), I, Mask);
     Strategies[Index] = getStrategyFor(*Resources[Index]);
   }
+
+  Resource2Groups.resize(Resources.size(), 0);
+  for (unsigned GroupIndex = 1, E = Resources.size(); GroupIndex < E;
+       ++GroupIndex) {
+    const ResourceState &Group = *Resources[GroupIndex];
+    if (!Group.isAResourceGroup())
+      continue;
+    for (unsigned I = 0; I < E; ++I) {
+      uint64_t Mask = Resources[I]->getResourceMask();
+      if (I != GroupIndex && Group.containsResource(Mask))
+        Resource2Groups[I] |= 1ULL << (GroupIndex - 1);
+    }
+  }
 }
 
 void ResourceManager::setCustomStrategyImpl(std::unique_ptr<ResourceStrategy> S,
@@ -175,35 +188,25 @@ void ResourceManager::use(const ResourceRef &RR) {
   if (RS.isReady())
     return;
 
-  // Notify to other resources that RR.first is no longer available.
-  for (std::unique_ptr<ResourceState> &Res : Resources) {
-    ResourceState &Current = *Res;
-    if (!Current.isAResourceGroup() || Current.getResourceMask() == RR.first)
-      continue;
-
-    if (Current.containsResource(RR.first)) {
-      unsigned Index = getResourceStateIndex(Current.getResourceMask());
-      Current.markSubResourceAsUsed(RR.first);
-      Strategies[Index]->used(RR.first);
-    }
+  // Notify to the groups that contain RR.first that it is no longer
+  // available.
+  for (uint64_t Users = Resource2Groups[RSID]; Users; Users &= Users - 1) {
+    unsigned Index = countTrailingZeros(Users) + 1;
+    Resources[Index]->markSubResourceAsUsed(RR.first);
+    Strategies[Index]->used(RR.first);
   }
 }
 
 void ResourceManager::release(const ResourceRef &RR) {
-  ResourceState &RS = *Resources[getResourceStateIndex(RR.first)];
+  unsigned RSID = getResourceStateIndex(RR.first);
+  ResourceState &RS = *Resources[RSID];
   bool WasFullyUsed = !RS.isReady();
   RS.releaseSubResource(RR.second);
   if (!WasFullyUsed)
     return;
 
-  for (std::unique_ptr<ResourceState> &Res : Resources) {
-    ResourceState &Current = *Res;
-    if (!Current.isAResourceGroup() || Current.getResourceMask() == RR.first)
-      continue;
-
-    if (Current.containsResource(RR.first))
-      Current.releaseSubResource(RR.first);
-  }
+  for (uint64_t Users = Resource2Groups[RSID]; Users; Users &= Users - 1)
+    Resources[countTrailingZeros(Users) + 1]->releaseSubResource(RR.first);
 }
 
 ResourceStateEvent
@@ -37,10 +37,10 @@ void ReadState::writeStartEvent(unsigned Cycles) {
   }
 }
 
-void WriteState::onInstructionIssued() {
+void WriteState::onInstructionIssued(int LatencyAdjustment) {
   assert(CyclesLeft == UNKNOWN_CYCLES);
   // Update the number of cycles left based on the WriteDescriptor info.
-  CyclesLeft = getLatency();
+  CyclesLeft = std::max(0, static_cast<int>(getLatency()) + LatencyAdjustment);
 
   // Now that the time left before write-back is known, notify
   // all the users.
@@ -140,10 +140,10 @@ void Instruction::execute() {
   Stage = IS_EXECUTING;
 
   // Set the cycles left before the write-back stage.
-  CyclesLeft = getLatency();
+  CyclesLeft = std::max(0, static_cast<int>(getLatency()) + LatencyAdjustment);
 
   for (WriteState &WS : getDefs())
-    WS.onInstructionIssued();
+    WS.onInstructionIssued(LatencyAdjustment);
 
   // Transition to the "executed" stage if this is a zero-latency instruction.
   if (!CyclesLeft)
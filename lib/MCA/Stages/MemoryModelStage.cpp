@@ -0,0 +1,146 @@
+//===---------------------- MemoryModelStage.cpp ----------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+/// \file
+///
+/// This file defines the memory hierarchy model stage of an instruction
+/// pipeline.
+///
+//===----------------------------------------------------------------------===//
+
+#include "llvm/MCA/Stages/MemoryModelStage.h"
+#include "llvm/MCA/Instruction.h"
+#include "llvm/Support/Debug.h"
+
+#define DEBUG_TYPE "llvm-mca"
+
+namespace llvm {
+namespace mca {
+
+// Collects the address operands of MCI, which are the operands of memory
+// type in its descriptor.
+static void getAddressOperands(const MCInst &MCI, const MCInstrDesc &MCID,
+                               SmallVectorImpl<const MCOperand *> &Operands) {
+  for (unsigned I = 0, E = std::min<unsigned>(MCI.getNumOperands(), MCID.NumOperands);
+       I < E; ++I)
+    if (MCID.OpInfo[I].OperandType == MCOI::OPERAND_MEMORY)
+      Operands.push_back(&MCI.getOperand(I));
+}
+
+// Returns true if A and B provably compute the same address.
+static bool isSameAddress(ArrayRef<const MCOperand *> A,
+                          ArrayRef<const MCOperand *> B) {
+  if (A.empty() || A.size() != B.size())
+    return false;
+  for (unsigned I = 0, E = A.size(); I < E; ++I) {
+    const MCOperand &OpA = *A[I];
+    const MCOperand &OpB = *B[I];
+    if (OpA.isReg() && OpB.isReg() && OpA.getReg() == OpB.getReg())
+      continue;
+    if (OpA.isImm() && OpB.isImm() && OpA.getImm() == OpB.getImm())
+      continue;
+    return false;
+  }
+  return true;
+}
+
+// Returns true if MCI writes a register used by the address operands.
+static bool writesAddress(const MCInst &MCI, const MCInstrDesc &MCID,
+                          ArrayRef<const MCOperand *> Address,
+                          const MCRegisterInfo &MRI) {
+  auto Clobbers = [&](unsigned Def) {
+    return any_of(Address, [&](const MCOperand *Op) {
+      return Op->isReg() && Op->getReg() &&
+             MRI.isSuperOrSubRegisterEq(Def, Op->getReg());
+    });
+  };
+  for (unsigned I = 0, E = std::min(MCI.getNumOperands(), MCID.getNumDefs());
+       I < E; ++I) {
+    const MCOperand &Op = MCI.getOperand(I);
+    if (Op.isReg() && Op.getReg() && Clobbers(Op.getReg()))
+      return true;
+  }
+  for (unsigned I = 0, E = MCID.getNumImplicitDefs(); I < E; ++I)
+    if (Clobbers(MCID.getImplicitDefs()[I]))
+      return true;
+  return false;
+}
+
+void MemoryModelStage::computeForwardingDistances(ArrayRef<MCInst> Source,
+                                                  const MCInstrInfo &MCII,
+                                                  const MCRegisterInfo &MRI) {
+  ForwardingDistance.assign(NumSourceInsts, 0);
+  if (!Opts.StoreForwardLatency)
+    return;
+
+  for (unsigned J = 0; J < NumSourceInsts; ++J) {
+    const MCInstrDesc &LoadDesc = MCII.get(Source[J].getOpcode());
+    if (!LoadDesc.mayLoad())
+      continue;
+    SmallVector<const MCOperand *, 8> LoadAddress;
+    getAddressOperands(Source[J], LoadDesc, LoadAddress);
+    if (LoadAddress.empty())
+      continue;
+
+    // Walk back from the load, wrapping around into the previous iteration,
+    // until a store to the same address or a write to the address registers.
+    for (unsigned Distance = 1; Distance <= NumSourceInsts; ++Distance) {
+      const MCInst &MCI =
+          Source[(J + NumSourceInsts - Distance) % NumSourceInsts];
+      const MCInstrDesc &MCID = MCII.get(MCI.getOpcode());
+      if (MCID.mayStore()) {
+        SmallVector<const MCOperand *, 8> StoreAddress;
+        getAddressOperands(MCI, MCID, StoreAddress);
+        if (isSameAddress(LoadAddress, StoreAddress)) {
+          ForwardingDistance[J] = Distance;
+          break;
+        }
+      }
+      if (writesAddress(MCI, MCID, LoadAddress, MRI))
+        break;
+    }
+  }
+}
+
+MemoryModelStage::MemoryModelStage(const MemoryModelOptions &Options,
+                                   const MCSchedModel &Model,
+                                   ArrayRef<MCInst> Source,
+                                   const MCInstrInfo &MCII,
+                                   const MCRegisterInfo &MRI)
+    : Stage(), Opts(Options), SM(Model), NumSourceInsts(Source.size()) {
+  computeForwardingDistances(Source, MCII, MRI);
+}
+
+unsigned MemoryModelStage::getLoadLatency(unsigned SourceIndex) const {
+  unsigned Distance = ForwardingDistance[SourceIndex % NumSourceInsts];
+  if (Distance && SourceIndex >= Distance)
+    return Opts.StoreForwardLatency;
+
+  unsigned Iteration = SourceIndex / NumSourceInsts;
+  if (Opts.L2Latency && Opts.L1MissInterval &&
+      Iteration % Opts.L1MissInterval == 0)
+    return Opts.L2Latency;
+
+  return Opts.L1Latency ? Opts.L1Latency : SM.LoadLatency;
+}
+
+Error MemoryModelStage::execute(InstRef &IR) {
+  Instruction &IS = *IR.getInstruction();
+  if (IS.getDesc().MayLoad) {
+    int Adjustment = static_cast<int>(getLoadLatency(IR.getSourceIndex())) -
+                     static_cast<int>(SM.LoadLatency);
+    LLVM_DEBUG(if (Adjustment) dbgs()
+               << "[MemoryModel]: Load #" << IR << " latency adjusted by "
+               << Adjustment << " cycles\n");
+    IS.setLatencyAdjustment(Adjustment);
+  }
+  return moveToTheNextStage(IR);
+}
+
+} // namespace mca
+} // namespace llvm
@@ -13,8 +13,11 @@
 
 #include "llvm/Object/ArchiveWriter.h"
 #include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/Optional.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/BinaryFormat/Magic.h"
+#include "llvm/Config/llvm-config.h"
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/Object/Archive.h"
 #include "llvm/Object/ObjectFile.h"
@@ -23,6 +26,7 @@
 #include "llvm/Support/Errc.h"
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/Format.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/ToolOutputFile.h"
 #include "llvm/Support/raw_ostream.h"
@@ -420,10 +424,92 @@ getSymbols(MemoryBufferRef Buf, raw_ostream &SymNames, bool &HasObject) {
   return Ret;
 }
 
+namespace {
+/// The archive symbols of a single member, with the offsets of their names in
+/// Names.
+struct MemberSymbols {
+  std::vector<unsigned> Offsets;
+  std::string Names;
+  bool HasObject = false;
+  Optional<Error> Err;
+};
+} // namespace
+
+/// Map the start of the contents of every member of \p OldArchive that has
+/// symbols to the names of its symbols in the symbol table. Returns an empty
+/// map if the table can't be trusted or read.
+static DenseMap<const char *, std::vector<StringRef>>
+getOldMemberSymbols(const MemoryBuffer *OldArchiveBuf) {
+  DenseMap<const char *, std::vector<StringRef>> Ret;
+  if (!OldArchiveBuf)
+    return Ret;
+  Expected<std::unique_ptr<object::Archive>> OldArchiveOrErr =
+      object::Archive::create(OldArchiveBuf->getMemBufferRef());
+  if (!OldArchiveOrErr) {
+    consumeError(OldArchiveOrErr.takeError());
+    return Ret;
+  }
+  const object::Archive &OldArchive = **OldArchiveOrErr;
+  if (OldArchive.isThin() || !OldArchive.hasSymbolTable())
+    return Ret;
+  for (const object::Archive::Symbol &S : OldArchive.symbols()) {
+    Expected<object::Archive::Child> C = S.getMember();
+    Expected<StringRef> Buf =
+        C ? C->getBuffer() : Expected<StringRef>(C.takeError());
+    if (!Buf) {
+      consumeError(Buf.takeError());
+      Ret.clear();
+      return Ret;
+    }
+    Ret[Buf->data()].push_back(S.getName());
+  }
+  return Ret;
+}
+
+/// Compute the archive symbols of every member. Members are parsed in
+/// parallel, except for the unchanged members of the archive being updated,
+/// which reuse their entries of its symbol table.
+static std::vector<MemberSymbols>
+computeMemberSymbols(ArrayRef<NewArchiveMember> NewMembers,
+                     const MemoryBuffer *OldArchiveBuf) {
+  DenseMap<const char *, std::vector<StringRef>> OldSymbols =
+      getOldMemberSymbols(OldArchiveBuf);
+  std::vector<MemberSymbols> Ret(NewMembers.size());
+  auto ComputeSymbols = [&](size_t I) {
+    MemoryBufferRef Buf = NewMembers[I].Buf->getMemBufferRef();
+    MemberSymbols &Syms = Ret[I];
+    raw_string_ostream Names(Syms.Names);
+    auto It = OldSymbols.find(Buf.getBufferStart());
+    if (It != OldSymbols.end()) {
+      Syms.HasObject = true;
+      for (StringRef Name : It->second) {
+        Syms.Offsets.push_back(Names.tell());
+        Names << Name << '\0';
+      }
+      return;
+    }
+    Expected<std::vector<unsigned>> Symbols =
+        getSymbols(Buf, Names, Syms.HasObject);
+    if (Symbols)
+      Syms.Offsets = std::move(*Symbols);
+    else
+      Syms.Err = Symbols.takeError();
+  };
+#if LLVM_ENABLE_THREADS
+  parallel::for_each_n(parallel::par, size_t(0), NewMembers.size(),
+                       ComputeSymbols);
+#else
+  for (size_t I = 0, E = NewMembers.size(); I != E; ++I)
+    ComputeSymbols(I);
+#endif
+  return Ret;
+}
+
 static Expected<std::vector<MemberData>>
 computeMemberData(raw_ostream &StringTable, raw_ostream &SymNames,
                   object::Archive::Kind Kind, bool Thin, StringRef ArcName,
-                  bool Deterministic, ArrayRef<NewArchiveMember> NewMembers) {
+                  bool Deterministic, ArrayRef<NewArchiveMember> NewMembers,
+                  const MemoryBuffer *OldArchiveBuf) {
   static char PaddingData[8] = {'\n', '\n', '\n', '\n', '\n', '\n', '\n', '\n'};
 
   // This ignores the symbol table, but we only need the value mod 8 and the
@@ -483,7 +569,17 @@ computeMemberData(raw_ostream &StringTable, raw_ostream &SymNames,
       Entry.second = Entry.second > 1 ? 1 : 0;
   }
 
-  for (const NewArchiveMember &M : NewMembers) {
+  std::vector<MemberSymbols> Symbols =
+      computeMemberSymbols(NewMembers, OldArchiveBuf);
+  Error Err = Error::success();
+  for (MemberSymbols &Syms : Symbols)
+    if (Syms.Err)
+      Err = joinErrors(std::move(Err), std::move(*Syms.Err));
+  if (Err)
+    return std::move(Err);
+
+  for (size_t I = 0, E = NewMembers.size(); I != E; ++I) {
+    const NewArchiveMember &M = NewMembers[I];
     std::string Header;
     raw_string_ostream Out(Header);
 
@@ -509,13 +605,15 @@ computeMemberData(raw_ostream &StringTable, raw_ostream &SymNames,
                       Buf.getBufferSize() + MemberPadding);
     Out.flush();
 
-    Expected<std::vector<unsigned>> Symbols =
-        getSymbols(Buf, SymNames, HasObject);
-    if (auto E = Symbols.takeError())
-      return std::move(E);
+    MemberSymbols &Syms = Symbols[I];
+    HasObject |= Syms.HasObject;
+    uint64_t NamesOffset = SymNames.tell();
+    for (unsigned &Offset : Syms.Offsets)
+      Offset += NamesOffset;
+    SymNames << Syms.Names;
 
     Pos += Header.size() + Data.size() + Padding.size();
-    Ret.push_back({std::move(*Symbols), std::move(Header), Data, Padding});
+    Ret.push_back({std::move(Syms.Offsets), std::move(Header), Data, Padding});
   }
   // If there are no symbols, emit an empty symbol table, to satisfy Solaris
   // tools, older versions of which expect a symbol table in a non-empty
@@ -538,7 +636,8 @@ Error llvm::writeArchive(StringRef ArcName,
   raw_svector_ostream StringTable(StringTableBuf);
 
   Expected<std::vector<MemberData>> DataOrErr = computeMemberData(
-      StringTable, SymNames, Kind, Thin, ArcName, Deterministic, NewMembers);
+      StringTable, SymNames, Kind, Thin, ArcName, Deterministic, NewMembers,
+      OldArchiveBuf.get());
   if (Error E = DataOrErr.takeError())
     return E;
   std::vector<MemberData> &Data = *DataOrErr;
@@ -343,6 +343,40 @@ ELFFile<ELFT>::decode_relrs(Elf_Relr_Range relrs) const {
   return Relocs;
 }
 
+template <class ELFT>
+std::vector<typename ELFT::Relr>
+ELFFile<ELFT>::encode_relrs(ArrayRef<uintX_t> Offsets) {
+  // See decode_relrs for a description of the encoding. Every address entry
+  // is followed by as many bitmaps as are needed to cover the offsets that
+  // come after it before the next gap of more than NBits words.
+  typedef typename ELFT::uint Word;
+  const size_t WordSize = sizeof(Word);
+  const size_t NBits = 8*WordSize - 1;
+
+  std::vector<Elf_Relr> Relrs;
+  for (size_t I = 0, E = Offsets.size(); I != E;) {
+    assert(Offsets[I] % WordSize == 0 && "RELR offsets must be word aligned");
+    Relrs.push_back(Elf_Relr(Offsets[I]));
+    Word Base = Offsets[I] + WordSize;
+    ++I;
+    for (;;) {
+      Word Bitmap = 0;
+      for (; I != E; ++I) {
+        assert(Offsets[I] >= Base && "RELR offsets must be sorted and unique");
+        Word Delta = Offsets[I] - Base;
+        if (Delta >= NBits * WordSize || Delta % WordSize != 0)
+          break;
+        Bitmap |= Word(1) << (Delta / WordSize);
+      }
+      if (Bitmap == 0)
+        break;
+      Relrs.push_back(Elf_Relr((Bitmap << 1) | 1));
+      Base += NBits * WordSize;
+    }
+  }
+  return Relrs;
+}
+
 template <class ELFT>
 Expected<std::vector<typename ELFT::Rela>>
 ELFFile<ELFT>::android_relas(const Elf_Shdr *Sec) const {
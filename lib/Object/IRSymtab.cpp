@@ -13,6 +13,8 @@
 #include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/SmallString.h"
 #include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/Statistic.h"
+#include "llvm/ADT/StringExtras.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/ADT/Triple.h"
 #include "llvm/Config/llvm-config.h"
@@ -30,7 +32,13 @@
 #include "llvm/Object/SymbolicFile.h"
 #include "llvm/Support/Allocator.h"
 #include "llvm/Support/Casting.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/EndianStream.h"
 #include "llvm/Support/Error.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/SHA1.h"
 #include "llvm/Support/StringSaver.h"
 #include "llvm/Support/VCSRevision.h"
 #include "llvm/Support/raw_ostream.h"
@@ -42,6 +50,15 @@
 using namespace llvm;
 using namespace irsymtab;
 
+#define DEBUG_TYPE "irsymtab"
+
+STATISTIC(NumCacheHits, "Number of upgraded symbol tables read from the cache");
+
+static cl::opt<std::string> CacheDir(
+    "irsymtab-cache-dir", cl::Hidden,
+    cl::desc("Directory in which to cache the symbol tables of bitcode files "
+             "that need to be upgraded"));
+
 static const char *LibcallRoutineNames[] = {
 #define HANDLE_LIBCALL(code, name) name,
 #include "llvm/IR/RuntimeLibcalls.def"
@@ -359,6 +376,94 @@ static Expected<FileContents> upgrade(ArrayRef<BitcodeModule> BMs) {
   return std::move(FC);
 }
 
+// The cache key covers the modules and the format the symbol table is upgraded
+// to.
+static std::string getCacheKey(ArrayRef<BitcodeModule> BMs) {
+  SHA1 Hasher;
+  Hasher.update(kExpectedProducerName);
+  uint32_t Version = storage::Header::kCurrentVersion;
+  Hasher.update(ArrayRef<uint8_t>(reinterpret_cast<const uint8_t *>(&Version),
+                                  sizeof(Version)));
+  for (const BitcodeModule &BM : BMs) {
+    uint64_t Sizes[] = {BM.getBuffer().size(), BM.getStrtab().size()};
+    Hasher.update(ArrayRef<uint8_t>(reinterpret_cast<const uint8_t *>(Sizes),
+                                    sizeof(Sizes)));
+    Hasher.update(BM.getBuffer());
+    Hasher.update(BM.getStrtab());
+  }
+  return toHex(Hasher.result());
+}
+
+// A cache entry holds the size of the symbol table, the symbol table and then
+// its string table.
+static Optional<FileContents> readCacheEntry(StringRef Path,
+                                             size_t NumModules) {
+  ErrorOr<std::unique_ptr<MemoryBuffer>> MBOrErr =
+      MemoryBuffer::getFile(Path, /*FileSize=*/-1,
+                            /*RequiresNullTerminator=*/false);
+  if (!MBOrErr)
+    return None;
+  StringRef Data = (*MBOrErr)->getBuffer();
+  if (Data.size() < sizeof(uint64_t))
+    return None;
+  uint64_t SymtabSize = support::endian::read64le(Data.data());
+  Data = Data.drop_front(sizeof(uint64_t));
+  if (SymtabSize < sizeof(storage::Header) || SymtabSize > Data.size())
+    return None;
+
+  FileContents FC;
+  FC.Symtab.assign(Data.begin(), Data.begin() + SymtabSize);
+  FC.Strtab.assign(Data.begin() + SymtabSize, Data.end());
+  StringRef Strtab(FC.Strtab.data(), FC.Strtab.size());
+  auto *Hdr = reinterpret_cast<const storage::Header *>(FC.Symtab.data());
+  if (Hdr->Version != storage::Header::kCurrentVersion ||
+      uint64_t(Hdr->Producer.Offset) + Hdr->Producer.Size > Strtab.size() ||
+      Hdr->Producer.get(Strtab) != kExpectedProducerName)
+    return None;
+  FC.TheReader = {{FC.Symtab.data(), FC.Symtab.size()}, Strtab};
+  if (FC.TheReader.getNumModules() != NumModules)
+    return None;
+  return std::move(FC);
+}
+
+static void writeCacheEntry(StringRef Path, const FileContents &FC) {
+  Expected<sys::fs::TempFile> Temp =
+      sys::fs::TempFile::create(Path + ".tmp-%%%%%%%%");
+  if (!Temp) {
+    consumeError(Temp.takeError());
+    return;
+  }
+  raw_fd_ostream OS(Temp->FD, /*shouldClose=*/false);
+  support::endian::write<uint64_t>(OS, FC.Symtab.size(), support::little);
+  OS << StringRef(FC.Symtab.data(), FC.Symtab.size())
+     << StringRef(FC.Strtab.data(), FC.Strtab.size());
+  OS.flush();
+  // Renaming the entry into place makes it visible to other processes only
+  // once it is complete.
+  Error E = OS.has_error() ? Temp->discard() : Temp->keep(Path);
+  OS.clear_error();
+  consumeError(std::move(E));
+}
+
+// Upgrade BMs, reusing the result of an earlier upgrade of the same modules if
+// the symbol tables are cached.
+static Expected<FileContents> upgradeWithCache(ArrayRef<BitcodeModule> BMs) {
+  if (CacheDir.empty())
+    return upgrade(BMs);
+
+  SmallString<128> Path(CacheDir);
+  sys::path::append(Path, "irsymtab-" + getCacheKey(BMs));
+  if (Optional<FileContents> FC = readCacheEntry(Path, BMs.size())) {
+    ++NumCacheHits;
+    return std::move(*FC);
+  }
+
+  Expected<FileContents> FCOrErr = upgrade(BMs);
+  if (FCOrErr && !sys::fs::create_directories(CacheDir))
+    writeCacheEntry(Path, *FCOrErr);
+  return FCOrErr;
+}
+
 Expected<FileContents> irsymtab::readBitcode(const BitcodeFileContents &BFC) {
   if (BFC.Mods.empty())
     return make_error<StringError>("Bitcode file does not contain any modules",
@@ -366,7 +471,7 @@ Expected<FileContents> irsymtab::readBitcode(const BitcodeFileContents &BFC) {
 
   if (BFC.StrtabForSymtab.empty() ||
       BFC.Symtab.size() < sizeof(storage::Header))
-    return upgrade(BFC.Mods);
+    return upgradeWithCache(BFC.Mods);
 
   // We cannot use the regular reader to read the version and producer, because
   // it will expect the header to be in the current format. The only thing we
@@ -377,7 +482,7 @@ Expected<FileContents> irsymtab::readBitcode(const BitcodeFileContents &BFC) {
   StringRef Producer = Hdr->Producer.get(BFC.StrtabForSymtab);
   if (Version != storage::Header::kCurrentVersion ||
       Producer != kExpectedProducerName)
-    return upgrade(BFC.Mods);
+    return upgradeWithCache(BFC.Mods);
 
   FileContents FC;
   FC.TheReader = {{BFC.Symtab.data(), BFC.Symtab.size()},
@@ -388,7 +493,7 @@ Expected<FileContents> irsymtab::readBitcode(const BitcodeFileContents &BFC) {
   // the bitcode file was created by binary concatenation, so we need to create
   // a new symbol table from scratch.
   if (FC.TheReader.getNumModules() != BFC.Mods.size())
-    return upgrade(std::move(BFC.Mods));
+    return upgradeWithCache(std::move(BFC.Mods));
 
   return std::move(FC);
 }
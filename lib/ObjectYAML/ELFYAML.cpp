@@ -846,6 +846,12 @@ static void sectionMapping(IO &IO, ELFYAML::RelocationSection &Section) {
   IO.mapOptional("Relocations", Section.Relocations);
 }
 
+static void sectionMapping(IO &IO, ELFYAML::RelrSection &Section) {
+  commonSectionMapping(IO, Section);
+  IO.mapOptional("Offsets", Section.Offsets);
+  IO.mapOptional("Content", Section.Content);
+}
+
 static void groupSectionMapping(IO &IO, ELFYAML::Group &group) {
   commonSectionMapping(IO, group);
   IO.mapRequired("Members", group.Members);
@@ -906,6 +912,12 @@ void MappingTraits<std::unique_ptr<ELFYAML::Section>>::mapping(
       Section.reset(new ELFYAML::NoBitsSection());
     sectionMapping(IO, *cast<ELFYAML::NoBitsSection>(Section.get()));
     break;
+  case ELF::SHT_RELR:
+  case ELF::SHT_ANDROID_RELR:
+    if (!IO.outputting())
+      Section.reset(new ELFYAML::RelrSection());
+    sectionMapping(IO, *cast<ELFYAML::RelrSection>(Section.get()));
+    break;
   case ELF::SHT_MIPS_ABIFLAGS:
     if (!IO.outputting())
       Section.reset(new ELFYAML::MipsABIFlags());
@@ -920,6 +932,11 @@ void MappingTraits<std::unique_ptr<ELFYAML::Section>>::mapping(
 
 StringRef MappingTraits<std::unique_ptr<ELFYAML::Section>>::validate(
     IO &io, std::unique_ptr<ELFYAML::Section> &Section) {
+  if (const auto *Relr = dyn_cast<ELFYAML::RelrSection>(Section.get())) {
+    if (Relr->Content && !Relr->Offsets.empty())
+      return "\"Offsets\" and \"Content\" cannot be used together";
+    return StringRef();
+  }
   const auto *RawSection = dyn_cast<ELFYAML::RawContentSection>(Section.get());
   if (!RawSection || RawSection->Size >= RawSection->Content.binary_size())
     return StringRef();
@@ -0,0 +1,236 @@
+//===- BinaryRemarks.cpp --------------------------------------------------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is dual licensed under the MIT and the University of Illinois Open
+// Source Licenses. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements the writer and the parser of the binary format for
+// optimization remarks.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/OptRemarks/BinaryRemarks.h"
+#include "llvm/Support/LEB128.h"
+#include "llvm/Support/raw_ostream.h"
+
+using namespace llvm;
+using namespace llvm::remarks;
+
+static const char Magic[] = {'R', 'M', 'R', 'K'};
+
+namespace {
+enum RecordKind : uint8_t { RK_String = 1, RK_Remark = 2 };
+enum RecordFlags : uint8_t { RF_HasLocation = 1, RF_HasHotness = 2 };
+} // end anonymous namespace
+
+bool remarks::isBinaryRemarkBuffer(StringRef Buf) {
+  return Buf.startswith(StringRef(Magic, sizeof(Magic)));
+}
+
+//===----------------------------------------------------------------------===//
+// BinaryRemarkWriter
+//===----------------------------------------------------------------------===//
+
+BinaryRemarkWriter::BinaryRemarkWriter(raw_ostream &OS) : OS(OS) {
+  OS.write(Magic, sizeof(Magic));
+  OS << char(BinaryRemarkVersion);
+}
+
+uint64_t BinaryRemarkWriter::getStringID(StringRef S) {
+  auto Inserted = StringIDs.insert(std::make_pair(S, StringIDs.size()));
+  if (Inserted.second) {
+    OS << char(RK_String);
+    encodeULEB128(S.size(), OS);
+    OS << S;
+  }
+  return Inserted.first->second;
+}
+
+void BinaryRemarkWriter::write(const Remark &R) {
+  RecordBuffer.clear();
+  raw_svector_ostream Record(RecordBuffer);
+  auto WriteLocation = [&](const RemarkLocation &Loc) {
+    encodeULEB128(getStringID(Loc.File), Record);
+    encodeULEB128(Loc.Line, Record);
+    encodeULEB128(Loc.Column, Record);
+  };
+
+  Record << char(RK_Remark);
+  encodeULEB128(getStringID(R.Type), Record);
+  encodeULEB128(getStringID(R.PassName), Record);
+  encodeULEB128(getStringID(R.RemarkName), Record);
+  encodeULEB128(getStringID(R.FunctionName), Record);
+  Record << char((R.Loc ? RF_HasLocation : 0) |
+                 (R.Hotness ? RF_HasHotness : 0));
+  if (R.Loc)
+    WriteLocation(*R.Loc);
+  if (R.Hotness)
+    encodeULEB128(*R.Hotness, Record);
+
+  encodeULEB128(R.Args.size(), Record);
+  for (const RemarkArg &Arg : R.Args) {
+    encodeULEB128(getStringID(Arg.Key), Record);
+    encodeULEB128(getStringID(Arg.Value), Record);
+    Record << char(Arg.Loc ? RF_HasLocation : 0);
+    if (Arg.Loc)
+      WriteLocation(*Arg.Loc);
+  }
+  OS << Record.str();
+}
+
+//===----------------------------------------------------------------------===//
+// BinaryRemarkParser
+//===----------------------------------------------------------------------===//
+
+BinaryRemarkParser::BinaryRemarkParser(StringRef Buf) : Buf(Buf), Offset(0) {}
+
+Error BinaryRemarkParser::makeError(const Twine &Message) const {
+  return make_error<StringError>("binary remarks at offset " + Twine(Offset) +
+                                     ": " + Message,
+                                 inconvertibleErrorCode());
+}
+
+Error BinaryRemarkParser::parseHeader() {
+  if (!isBinaryRemarkBuffer(Buf))
+    return makeError("missing magic number");
+  Offset = sizeof(Magic);
+  uint8_t Version;
+  if (Error E = parseByte(Version))
+    return E;
+  if (Version != BinaryRemarkVersion)
+    return makeError("unsupported version " + Twine(unsigned(Version)));
+  return Error::success();
+}
+
+Error BinaryRemarkParser::parseByte(uint8_t &Result) {
+  if (Offset >= Buf.size())
+    return makeError("unexpected end of buffer");
+  Result = Buf[Offset++];
+  return Error::success();
+}
+
+Error BinaryRemarkParser::parseULEB128(uint64_t &Result) {
+  const char *ErrorMsg = nullptr;
+  unsigned Size;
+  Result = decodeULEB128(Buf.bytes_begin() + Offset, &Size, Buf.bytes_end(),
+                         &ErrorMsg);
+  if (ErrorMsg)
+    return makeError(ErrorMsg);
+  Offset += Size;
+  return Error::success();
+}
+
+Error BinaryRemarkParser::parseString(StringRef &Result) {
+  uint64_t ID;
+  if (Error E = parseULEB128(ID))
+    return E;
+  if (ID >= Strings.size())
+    return makeError("string ID " + Twine(ID) + " is not defined");
+  Result = Strings[ID];
+  return Error::success();
+}
+
+Error BinaryRemarkParser::parseStringRecord() {
+  uint64_t Size;
+  if (Error E = parseULEB128(Size))
+    return E;
+  if (Size > Buf.size() - Offset)
+    return makeError("string extends past the end of the buffer");
+  Strings.push_back(Buf.substr(Offset, Size));
+  Offset += Size;
+  return Error::success();
+}
+
+Error BinaryRemarkParser::parseLocation(RemarkLocation &Loc) {
+  uint64_t Line, Column;
+  if (Error E = parseString(Loc.File))
+    return E;
+  if (Error E = parseULEB128(Line))
+    return E;
+  if (Error E = parseULEB128(Column))
+    return E;
+  Loc.Line = Line;
+  Loc.Column = Column;
+  return Error::success();
+}
+
+Error BinaryRemarkParser::parseRemark(Remark &R) {
+  R = Remark();
+  Args.clear();
+  if (Error E = parseString(R.Type))
+    return E;
+  if (Error E = parseString(R.PassName))
+    return E;
+  if (Error E = parseString(R.RemarkName))
+    return E;
+  if (Error E = parseString(R.FunctionName))
+    return E;
+
+  uint8_t Flags;
+  if (Error E = parseByte(Flags))
+    return E;
+  if (Flags & RF_HasLocation) {
+    R.Loc.emplace();
+    if (Error E = parseLocation(*R.Loc))
+      return E;
+  }
+  if (Flags & RF_HasHotness) {
+    uint64_t Hotness;
+    if (Error E = parseULEB128(Hotness))
+      return E;
+    R.Hotness = Hotness;
+  }
+
+  uint64_t NumArgs;
+  if (Error E = parseULEB128(NumArgs))
+    return E;
+  // Each argument takes at least three bytes.
+  if (NumArgs > (Buf.size() - Offset) / 3)
+    return makeError("too many arguments");
+  for (uint64_t I = 0; I != NumArgs; ++I) {
+    Args.emplace_back();
+    RemarkArg &Arg = Args.back();
+    if (Error E = parseString(Arg.Key))
+      return E;
+    if (Error E = parseString(Arg.Value))
+      return E;
+    if (Error E = parseByte(Flags))
+      return E;
+    if (Flags & RF_HasLocation) {
+      Arg.Loc.emplace();
+      if (Error E = parseLocation(*Arg.Loc))
+        return E;
+    }
+  }
+  R.Args = Args;
+  return Error::success();
+}
+
+Expected<bool> BinaryRemarkParser::parseNext(Remark &R) {
+  if (Offset == 0)
+    if (Error E = parseHeader())
+      return std::move(E);
+
+  while (Offset < Buf.size()) {
+    uint8_t Kind;
+    if (Error E = parseByte(Kind))
+      return std::move(E);
+    switch (Kind) {
+    case RK_String:
+      if (Error E = parseStringRecord())
+        return std::move(E);
+      break;
+    case RK_Remark:
+      if (Error E = parseRemark(R))
+        return std::move(E);
+      return true;
+    default:
+      --Offset;
+      return makeError("unknown record kind " + Twine(unsigned(Kind)));
+    }
+  }
+  return false;
+}
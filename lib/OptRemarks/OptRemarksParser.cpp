@@ -14,6 +14,7 @@
 
 #include "llvm-c/OptRemarks.h"
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/OptRemarks/BinaryRemarks.h"
 #include "llvm/Support/SourceMgr.h"
 #include "llvm/Support/YAMLTraits.h"
 
@@ -60,15 +61,27 @@ struct RemarkParser {
   /// Set to `true` if we had any errors during parsing.
   bool HadAnyErrors = false;
 
+  /// The parser of the buffer if it is in the binary format. The YAML stream
+  /// is then empty.
+  Optional<remarks::BinaryRemarkParser> BinaryParser;
+
   RemarkParser(StringRef Buf)
-      : SM(), Stream(Buf, SM), ErrorString(), ErrorStream(ErrorString),
-        DI(Stream.begin()), LastRemark(), TmpArgs(), State(TmpArgs) {
+      : SM(),
+        Stream(remarks::isBinaryRemarkBuffer(Buf) ? StringRef("") : Buf, SM),
+        ErrorString(), ErrorStream(ErrorString), DI(Stream.begin()),
+        LastRemark(), TmpArgs(), State(TmpArgs) {
     SM.setDiagHandler(RemarkParser::HandleDiagnostic, this);
+    if (remarks::isBinaryRemarkBuffer(Buf))
+      BinaryParser.emplace(Buf);
   }
 
   /// Parse a YAML element.
   Error parseYAMLElement(yaml::Document &Remark);
 
+  /// Parse the next remark of a binary buffer. Return false at the end of the
+  /// buffer.
+  Expected<bool> parseBinaryElement();
+
 private:
   /// Parse one key to a string.
   /// otherwise.
@@ -319,6 +332,38 @@ Error RemarkParser::parseYAMLElement(yaml::Document &Remark) {
 }
 } // namespace
 
+Expected<bool> RemarkParser::parseBinaryElement() {
+  LastRemark = None;
+  TmpArgs.clear();
+
+  remarks::Remark R;
+  Expected<bool> Parsed = BinaryParser->parseNext(R);
+  if (!Parsed || !*Parsed)
+    return Parsed;
+
+  auto ToDebugLoc = [](const Optional<remarks::RemarkLocation> &Loc) {
+    if (!Loc)
+      return LLVMOptRemarkDebugLoc{toOptRemarkStr(StringRef()), 0, 0};
+    return LLVMOptRemarkDebugLoc{toOptRemarkStr(Loc->File), Loc->Line,
+                                 Loc->Column};
+  };
+  for (const remarks::RemarkArg &Arg : R.Args)
+    TmpArgs.push_back(LLVMOptRemarkArg{toOptRemarkStr(Arg.Key),
+                                       toOptRemarkStr(Arg.Value),
+                                       ToDebugLoc(Arg.Loc)});
+
+  LastRemark = LLVMOptRemarkEntry{
+      toOptRemarkStr(R.Type),
+      toOptRemarkStr(R.PassName),
+      toOptRemarkStr(R.RemarkName),
+      toOptRemarkStr(R.FunctionName),
+      ToDebugLoc(R.Loc),
+      static_cast<uint32_t>(R.Hotness.getValueOr(0)),
+      static_cast<uint32_t>(TmpArgs.size()),
+      TmpArgs.data()};
+  return true;
+}
+
 // Create wrappers for C Binding types (see CBindingWrapping.h).
 DEFINE_SIMPLE_CONVERSION_FUNCTIONS(RemarkParser, LLVMOptRemarkParserRef)
 
@@ -331,8 +376,22 @@ extern "C" LLVMOptRemarkParserRef LLVMOptRemarkParserCreate(const void *Buf,
 extern "C" LLVMOptRemarkEntry *
 LLVMOptRemarkParserGetNext(LLVMOptRemarkParserRef Parser) {
   RemarkParser &TheParser = *unwrap(Parser);
+  if (TheParser.HadAnyErrors)
+    return nullptr;
+
+  // Binary remarks are parsed one record at a time, straight from the buffer.
+  if (TheParser.BinaryParser) {
+    Expected<bool> Parsed = TheParser.parseBinaryElement();
+    if (!Parsed) {
+      TheParser.ErrorStream << toString(Parsed.takeError()) << '\n';
+      TheParser.HadAnyErrors = true;
+      return nullptr;
+    }
+    return *Parsed ? &*TheParser.LastRemark : nullptr;
+  }
+
   // Check for EOF.
-  if (TheParser.HadAnyErrors || TheParser.DI == TheParser.Stream.end())
+  if (TheParser.DI == TheParser.Stream.end())
     return nullptr;
 
   // Try to parse an entry.
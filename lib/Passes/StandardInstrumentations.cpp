@@ -21,12 +21,21 @@
 #include "llvm/IR/IRPrintingPasses.h"
 #include "llvm/IR/Module.h"
 #include "llvm/IR/PassInstrumentation.h"
+#include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
+#include "llvm/Support/FileSystem.h"
 #include "llvm/Support/FormatVariadic.h"
+#include "llvm/Support/JSON.h"
+#include "llvm/Support/Process.h"
 #include "llvm/Support/raw_ostream.h"
 
 using namespace llvm;
 
+static cl::opt<std::string> PassTraceFile(
+    "pass-trace", cl::Hidden, cl::value_desc("filename"),
+    cl::desc("Write a Chrome trace of the passes run by the new pass manager, "
+             "with the size of the IR and the heap usage of each pass"));
+
 namespace {
 namespace PrintIR {
 
@@ -129,6 +138,125 @@ void printAfterPass(StringRef PassID, Any IR) {
 } // namespace PrintIR
 } // namespace
 
+/// Return the number of instructions in the IR unit wrapped in \p IR.
+static unsigned getInstructionCount(Any IR) {
+  unsigned Count = 0;
+  if (any_isa<const Module *>(IR)) {
+    for (const Function &F : *any_cast<const Module *>(IR))
+      Count += F.getInstructionCount();
+  } else if (any_isa<const Function *>(IR)) {
+    Count = any_cast<const Function *>(IR)->getInstructionCount();
+  } else if (any_isa<const LazyCallGraph::SCC *>(IR)) {
+    const LazyCallGraph::SCC *C = any_cast<const LazyCallGraph::SCC *>(IR);
+    for (const LazyCallGraph::Node &N : *C)
+      Count += N.getFunction().getInstructionCount();
+  } else if (any_isa<const Loop *>(IR)) {
+    for (const BasicBlock *BB : any_cast<const Loop *>(IR)->blocks())
+      Count += BB->size();
+  }
+  return Count;
+}
+
+/// Return true if \p PassID names a pass manager, an adaptor or a proxy, which
+/// only run other passes.
+static bool isPassManager(StringRef PassID) {
+  return PassID.startswith("PassManager<") || PassID.contains("PassAdaptor<") ||
+         PassID.contains("AnalysisManagerProxy<");
+}
+
+PassTraceHandler::PassTraceHandler() : PassTraceHandler(PassTraceFile) {}
+
+PassTraceHandler::PassTraceHandler(StringRef OutputFile)
+    : OutputFile(OutputFile), Origin(std::chrono::steady_clock::now()) {}
+
+PassTraceHandler::~PassTraceHandler() {
+  if (OutputFile.empty() || Events.empty())
+    return;
+  std::error_code EC;
+  raw_fd_ostream OS(OutputFile, EC, sys::fs::F_Text);
+  if (EC) {
+    errs() << "error: could not open pass trace file '" << OutputFile
+           << "': " << EC.message() << '\n';
+    return;
+  }
+  write(OS);
+}
+
+void PassTraceHandler::runBeforePass(StringRef PassID, Any IR) {
+  if (isPassManager(PassID))
+    return;
+
+  auto Now = std::chrono::steady_clock::now();
+  Event E;
+  E.Name = PassID;
+  E.StartUs =
+      std::chrono::duration_cast<std::chrono::microseconds>(Now - Origin)
+          .count();
+  E.NumInstructions = getInstructionCount(IR);
+  E.MallocBefore = sys::Process::GetMallocUsage();
+  EventStack.push_back(Events.size());
+  Events.push_back(std::move(E));
+}
+
+void PassTraceHandler::runAfterPass(StringRef PassID) {
+  if (isPassManager(PassID))
+    return;
+
+  assert(!EventStack.empty() && "pass finished without starting");
+  auto Now = std::chrono::steady_clock::now();
+  Event &E = Events[EventStack.pop_back_val()];
+  E.DurationUs =
+      std::chrono::duration_cast<std::chrono::microseconds>(Now - Origin)
+          .count() -
+      E.StartUs;
+  E.MallocAfter = sys::Process::GetMallocUsage();
+  // The heap usage is only sampled at pass boundaries, so the peak of a pass
+  // is the largest sample taken while it was running.
+  E.MallocPeak = std::max({E.MallocPeak, E.MallocBefore, E.MallocAfter});
+  if (!EventStack.empty()) {
+    Event &Parent = Events[EventStack.back()];
+    Parent.MallocPeak = std::max(Parent.MallocPeak, E.MallocPeak);
+  }
+}
+
+void PassTraceHandler::write(raw_ostream &OS) {
+  json::Array TraceEvents;
+  for (const Event &E : Events)
+    TraceEvents.push_back(json::Object{
+        {"name", E.Name},
+        {"ph", "X"},
+        {"pid", 1},
+        {"tid", 0},
+        {"ts", int64_t(E.StartUs)},
+        {"dur", int64_t(E.DurationUs)},
+        {"args", json::Object{{"instructions", int64_t(E.NumInstructions)},
+                              {"malloc_before", int64_t(E.MallocBefore)},
+                              {"malloc_after", int64_t(E.MallocAfter)},
+                              {"malloc_peak", int64_t(E.MallocPeak)}}}});
+  OS << formatv("{0:2}", json::Value(json::Object{
+                             {"traceEvents", std::move(TraceEvents)}}))
+     << '\n';
+  Events.clear();
+}
+
+void PassTraceHandler::registerCallbacks(PassInstrumentationCallbacks &PIC) {
+  if (OutputFile.empty())
+    return;
+
+  PIC.registerBeforePassCallback([this](StringRef P, Any IR) {
+    this->runBeforePass(P, IR);
+    return true;
+  });
+  PIC.registerAfterPassCallback(
+      [this](StringRef P, Any) { this->runAfterPass(P); });
+  PIC.registerAfterPassInvalidatedCallback(
+      [this](StringRef P) { this->runAfterPass(P); });
+  PIC.registerBeforeAnalysisCallback(
+      [this](StringRef P, Any IR) { this->runBeforePass(P, IR); });
+  PIC.registerAfterAnalysisCallback(
+      [this](StringRef P, Any) { this->runAfterPass(P); });
+}
+
 void StandardInstrumentations::registerCallbacks(
     PassInstrumentationCallbacks &PIC) {
   if (llvm::shouldPrintBeforePass())
@@ -136,4 +264,5 @@ void StandardInstrumentations::registerCallbacks(
   if (llvm::shouldPrintAfterPass())
     PIC.registerAfterPassCallback(PrintIR::printAfterPass);
   TimePasses.registerCallbacks(PIC);
+  PassTrace.registerCallbacks(PIC);
 }
@@ -28,6 +28,7 @@
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/ManagedStatic.h"
 #include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/ThreadPool.h"
 #include "llvm/Support/raw_ostream.h"
 #include <algorithm>
 #include <cassert>
@@ -249,6 +250,14 @@ Error CoverageMapping::loadFunctionRecord(
   if (!RecordProvenance[FilenamesHash].insert(hash_value(OrigFuncName)).second)
     return Error::success();
 
+  // Index the record under each of the files it mentions.
+  unsigned RecordIndex = Functions.size();
+  for (StringRef Filename : Record.Filenames) {
+    auto &RecordIndices = FilenameHash2RecordIndices[hash_value(Filename)];
+    if (RecordIndices.empty() || RecordIndices.back() != RecordIndex)
+      RecordIndices.push_back(RecordIndex);
+  }
+
   Functions.push_back(std::move(Function));
   return Error::success();
 }
@@ -273,26 +282,53 @@ Expected<std::unique_ptr<CoverageMapping>> CoverageMapping::load(
 
 Expected<std::unique_ptr<CoverageMapping>>
 CoverageMapping::load(ArrayRef<StringRef> ObjectFilenames,
-                      StringRef ProfileFilename, ArrayRef<StringRef> Arches) {
+                      StringRef ProfileFilename, ArrayRef<StringRef> Arches,
+                      unsigned NumThreads) {
   auto ProfileReaderOrErr = IndexedInstrProfReader::create(ProfileFilename);
   if (Error E = ProfileReaderOrErr.takeError())
     return std::move(E);
   auto ProfileReader = std::move(ProfileReaderOrErr.get());
 
-  SmallVector<std::unique_ptr<CoverageMappingReader>, 4> Readers;
-  SmallVector<std::unique_ptr<MemoryBuffer>, 4> Buffers;
-  for (const auto &File : llvm::enumerate(ObjectFilenames)) {
-    auto CovMappingBufOrErr = MemoryBuffer::getFileOrSTDIN(File.value());
+  // Every object is opened and parsed independently. The readers are used in
+  // the order of the objects, so loading them in parallel changes nothing
+  // but the time it takes.
+  size_t NumObjects = ObjectFilenames.size();
+  std::vector<std::unique_ptr<CoverageMappingReader>> Readers(NumObjects);
+  std::vector<std::unique_ptr<MemoryBuffer>> Buffers(NumObjects);
+  std::vector<Optional<Error>> Errors(NumObjects);
+  auto OpenObject = [&](size_t I) -> Error {
+    auto CovMappingBufOrErr = MemoryBuffer::getFileOrSTDIN(ObjectFilenames[I]);
     if (std::error_code EC = CovMappingBufOrErr.getError())
       return errorCodeToError(EC);
-    StringRef Arch = Arches.empty() ? StringRef() : Arches[File.index()];
+    StringRef Arch = Arches.empty() ? StringRef() : Arches[I];
     auto CoverageReaderOrErr =
         BinaryCoverageReader::create(CovMappingBufOrErr.get(), Arch);
     if (Error E = CoverageReaderOrErr.takeError())
-      return std::move(E);
-    Readers.push_back(std::move(CoverageReaderOrErr.get()));
-    Buffers.push_back(std::move(CovMappingBufOrErr.get()));
+      return E;
+    Readers[I] = std::move(CoverageReaderOrErr.get());
+    Buffers[I] = std::move(CovMappingBufOrErr.get());
+    return Error::success();
+  };
+  if (NumThreads <= 1 || NumObjects <= 1) {
+    for (size_t I = 0; I != NumObjects; ++I)
+      Errors[I] = OpenObject(I);
+  } else {
+    ThreadPool Pool(std::min<size_t>(NumThreads, NumObjects));
+    for (size_t I = 0; I != NumObjects; ++I)
+      Pool.async([&, I] { Errors[I] = OpenObject(I); });
+    Pool.wait();
   }
+
+  // Report the error of the first object that failed.
+  Error Err = Error::success();
+  for (Optional<Error> &E : Errors) {
+    if (Err)
+      consumeError(std::move(*E));
+    else
+      Err = std::move(*E);
+  }
+  if (Err)
+    return std::move(Err);
   return load(Readers, *ProfileReader);
 }
 
@@ -601,11 +637,21 @@ static bool isExpansion(const CountedRegion &R, unsigned FileID) {
   return R.Kind == CounterMappingRegion::ExpansionRegion && R.FileID == FileID;
 }
 
+ArrayRef<unsigned> CoverageMapping::getImpreciseRecordIndicesForFilename(
+    StringRef Filename) const {
+  auto It = FilenameHash2RecordIndices.find(hash_value(Filename));
+  if (It == FilenameHash2RecordIndices.end())
+    return {};
+  return It->second;
+}
+
 CoverageData CoverageMapping::getCoverageForFile(StringRef Filename) const {
   CoverageData FileCoverage(Filename);
   std::vector<CountedRegion> Regions;
 
-  for (const auto &Function : Functions) {
+  // Only the functions that mention the file can contribute to it.
+  for (unsigned RecordIndex : getImpreciseRecordIndicesForFilename(Filename)) {
+    const FunctionRecord &Function = Functions[RecordIndex];
     auto MainFileID = findMainViewFileID(Filename, Function);
     auto FileIDs = gatherFileIDs(Filename, Function);
     for (const auto &CR : Function.CountedRegions)
@@ -625,7 +671,8 @@ CoverageData CoverageMapping::getCoverageForFile(StringRef Filename) const {
 std::vector<InstantiationGroup>
 CoverageMapping::getInstantiationGroups(StringRef Filename) const {
   FunctionInstantiationSetCollector InstantiationSetCollector;
-  for (const auto &Function : Functions) {
+  for (unsigned RecordIndex : getImpreciseRecordIndicesForFilename(Filename)) {
+    const FunctionRecord &Function = Functions[RecordIndex];
     auto MainFileID = findMainViewFileID(Filename, Function);
     if (!MainFileID)
       continue;
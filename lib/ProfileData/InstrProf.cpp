@@ -73,6 +73,13 @@ static cl::opt<unsigned> StaticFuncStripDirNamePrefix(
     cl::desc("Strip specified level of directory name from source path in "
              "the profile counter name for static functions."));
 
+// Readers built before zstd support cannot read names compressed with it, so
+// this is opt-in.
+static cl::opt<bool> CompressPGONamesWithZstd(
+    "compress-pgo-names-with-zstd", cl::init(false), cl::Hidden,
+    cl::desc("Compress the PGO function names with zstd instead of zlib, "
+             "when zstd is available."));
+
 static std::string getInstrProfErrString(instrprof_error Err) {
   switch (Err) {
   case instrprof_error::success:
@@ -113,6 +120,8 @@ static std::string getInstrProfErrString(instrprof_error Err) {
     return "Empty raw profile file";
   case instrprof_error::zlib_unavailable:
     return "Profile uses zlib compression but the profile reader was built without zlib support";
+  case instrprof_error::zstd_unavailable:
+    return "Profile uses zstd compression but the profile reader was built without zstd support";
   }
   llvm_unreachable("A value of instrprof_error has no message.");
 }
@@ -404,9 +413,16 @@ Error collectPGOFuncNameStrings(ArrayRef<std::string> NameStrs,
     return WriteStringToResult(0, UncompressedNameStrings);
   }
 
+  // The reader tells the two formats apart by the magic number of zstd
+  // frames, which cannot start a zlib stream.
   SmallString<128> CompressedNameStrings;
-  Error E = zlib::compress(StringRef(UncompressedNameStrings),
-                           CompressedNameStrings, zlib::BestSizeCompression);
+  Error E = CompressPGONamesWithZstd && zstd::isAvailable()
+                ? zstd::compress(StringRef(UncompressedNameStrings),
+                                 CompressedNameStrings,
+                                 zstd::BestSizeCompression)
+                : zlib::compress(StringRef(UncompressedNameStrings),
+                                 CompressedNameStrings,
+                                 zlib::BestSizeCompression);
   if (E) {
     consumeError(std::move(E));
     return make_error<InstrProfError>(instrprof_error::compress_failed);
@@ -429,8 +445,10 @@ Error collectPGOFuncNameStrings(ArrayRef<GlobalVariable *> NameVars,
   for (auto *NameVar : NameVars) {
     NameStrs.push_back(getPGOFuncNameVarInitializer(NameVar));
   }
-  return collectPGOFuncNameStrings(
-      NameStrs, zlib::isAvailable() && doCompression, Result);
+  bool CanCompress = zlib::isAvailable() ||
+                     (CompressPGONamesWithZstd && zstd::isAvailable());
+  return collectPGOFuncNameStrings(NameStrs, CanCompress && doCompression,
+                                   Result);
 }
 
 Error readPGOFuncNameStrings(StringRef NameStrings, InstrProfSymtab &Symtab) {
@@ -447,14 +465,20 @@ Error readPGOFuncNameStrings(StringRef NameStrings, InstrProfSymtab &Symtab) {
     SmallString<128> UncompressedNameStrings;
     StringRef NameStrings;
     if (isCompressed) {
-      if (!llvm::zlib::isAvailable())
-        return make_error<InstrProfError>(instrprof_error::zlib_unavailable);
-
       StringRef CompressedNameStrings(reinterpret_cast<const char *>(P),
                                       CompressedSize);
-      if (Error E =
-              zlib::uncompress(CompressedNameStrings, UncompressedNameStrings,
-                               UncompressedSize)) {
+      bool IsZstd = zstd::isFrame(CompressedNameStrings);
+      if (IsZstd ? !zstd::isAvailable() : !zlib::isAvailable())
+        return make_error<InstrProfError>(
+            IsZstd ? instrprof_error::zstd_unavailable
+                   : instrprof_error::zlib_unavailable);
+
+      if (Error E = IsZstd ? zstd::uncompress(CompressedNameStrings,
+                                              UncompressedNameStrings,
+                                              UncompressedSize)
+                           : zlib::uncompress(CompressedNameStrings,
+                                              UncompressedNameStrings,
+                                              UncompressedSize)) {
         consumeError(std::move(E));
         return make_error<InstrProfError>(instrprof_error::uncompress_failed);
       }
@@ -149,11 +149,13 @@ bool TextInstrProfReader::hasFormat(const MemoryBuffer &Buffer) {
 }
 
 // Read the profile variant flag from the header: ":FE" means this is a FE
-// generated profile. ":IR" means this is an IR level profile. Other strings
+// generated profile. ":IR" means this is an IR level profile. ":CSIR" means
+// this is an IR level profile with context-sensitive records. Other strings
 // with a leading ':' will be reported an error format.
 Error TextInstrProfReader::readHeader() {
   Symtab.reset(new InstrProfSymtab());
   bool IsIRInstr = false;
+  bool IsCS = false;
   if (!Line->startswith(":")) {
     IsIRLevelProfile = false;
     return success();
@@ -163,11 +165,15 @@ Error TextInstrProfReader::readHeader() {
     IsIRInstr = true;
   else if (Str.equals_lower("fe"))
     IsIRInstr = false;
-  else
+  else if (Str.equals_lower("csir")) {
+    IsIRInstr = true;
+    IsCS = true;
+  } else
     return error(instrprof_error::bad_header);
 
   ++Line;
   IsIRLevelProfile = IsIRInstr;
+  HasCSIRLevelProfile = IsCS;
   return success();
 }
 
@@ -563,6 +569,89 @@ data_type InstrProfLookupTrait::ReadData(StringRef K, const unsigned char *D,
   return DataBuffer;
 }
 
+bool InstrProfLookupTrait::readRecordRefs(
+    const unsigned char *D, offset_type N,
+    SmallVectorImpl<InstrProfRecordRef> &Refs) const {
+  using namespace support;
+
+  // This follows the layout checks of ReadData, but leaves the counters and
+  // the value profile data in place.
+  if (N % sizeof(uint64_t))
+    return false;
+
+  Refs.clear();
+  const unsigned char *End = D + N;
+  while (D < End) {
+    // Read hash.
+    if (D + sizeof(uint64_t) >= End)
+      return false;
+    InstrProfRecordRef Ref;
+    Ref.Hash = endian::readNext<uint64_t, little, unaligned>(D);
+
+    // Initialize number of counters for GET_VERSION(FormatVersion) == 1.
+    uint64_t CountsSize = N / sizeof(uint64_t) - 1;
+    // If format version is different then read the number of counters.
+    if (GET_VERSION(FormatVersion) != IndexedInstrProf::ProfVersion::Version1) {
+      if (D + sizeof(uint64_t) > End)
+        return false;
+      CountsSize = endian::readNext<uint64_t, little, unaligned>(D);
+    }
+    if (CountsSize > uint64_t(End - D) / sizeof(uint64_t))
+      return false;
+    Ref.Counts = makeArrayRef(reinterpret_cast<const ulittle64_t *>(D),
+                              CountsSize);
+    D += CountsSize * sizeof(uint64_t);
+
+    // The value profile data starts with its total size.
+    if (GET_VERSION(FormatVersion) > IndexedInstrProf::ProfVersion::Version2) {
+      if (D + sizeof(uint32_t) > End)
+        return false;
+      uint32_t TotalSize =
+          endian::read<uint32_t, unaligned>(D, ValueProfDataEndianness);
+      if (TotalSize > uint64_t(End - D))
+        return false;
+      Ref.ValueData = makeArrayRef(D, TotalSize);
+      D += TotalSize;
+    }
+    Refs.push_back(Ref);
+  }
+  return true;
+}
+
+Error InstrProfLookupTrait::readValueProfData(ArrayRef<uint8_t> Data,
+                                              InstrProfRecord &Record) const {
+  using namespace support;
+
+  // Most functions have no value sites; skip decoding their empty data.
+  if (Data.empty() ||
+      (Data.size() >= 2 * sizeof(uint32_t) &&
+       endian::read<uint32_t, unaligned>(Data.data() + sizeof(uint32_t),
+                                         ValueProfDataEndianness) == 0))
+    return Error::success();
+  Expected<std::unique_ptr<ValueProfData>> VDataPtrOrErr =
+      ValueProfData::getValueProfData(Data.begin(), Data.end(),
+                                      ValueProfDataEndianness);
+  if (Error E = VDataPtrOrErr.takeError())
+    return E;
+  VDataPtrOrErr.get()->deserializeTo(Record, nullptr);
+  return Error::success();
+}
+
+template <typename HashTableImpl>
+Error InstrProfReaderIndex<HashTableImpl>::getRecordRefs(
+    StringRef FuncName, SmallVectorImpl<InstrProfRecordRef> &Refs) {
+  auto Iter = HashTable->find(FuncName);
+  if (Iter == HashTable->end())
+    return make_error<InstrProfError>(instrprof_error::unknown_function);
+
+  if (!HashTable->getInfoObj().readRecordRefs(Iter.getDataPtr(),
+                                              Iter.getDataLen(), Refs) ||
+      Refs.empty())
+    return make_error<InstrProfError>(instrprof_error::malformed);
+
+  return Error::success();
+}
+
 template <typename HashTableImpl>
 Error InstrProfReaderIndex<HashTableImpl>::getRecords(
     StringRef FuncName, ArrayRef<NamedInstrProfRecord> &Data) {
@@ -616,6 +705,11 @@ public:
                    ArrayRef<NamedInstrProfRecord> &Data) override {
     return Underlying.getRecords(FuncName, Data);
   }
+
+  Error getRecordRefs(StringRef FuncName,
+                      SmallVectorImpl<InstrProfRecordRef> &Refs) override {
+    return Underlying.getRecordRefs(FuncName, Refs);
+  }
 };
 }
 
@@ -673,6 +767,22 @@ public:
 
   Error getRecords(StringRef FuncName,
                    ArrayRef<NamedInstrProfRecord> &Data) override {
+    return lookup(FuncName, [&](StringRef Name) {
+      return Underlying.getRecords(Name, Data);
+    });
+  }
+
+  Error getRecordRefs(StringRef FuncName,
+                      SmallVectorImpl<InstrProfRecordRef> &Refs) override {
+    return lookup(FuncName, [&](StringRef Name) {
+      return Underlying.getRecordRefs(Name, Refs);
+    });
+  }
+
+private:
+  /// Call \p Get with the name that FuncName is remapped to in the profile
+  /// data, falling back to FuncName itself.
+  Error lookup(StringRef FuncName, function_ref<Error(StringRef)> Get) {
     StringRef RealName = extractName(FuncName);
     if (auto Key = Remappings.lookup(RealName)) {
       StringRef Remapped = MappedNames.lookup(Key);
@@ -684,7 +794,7 @@ public:
           // Try rebuilding the name from the given remapping.
           SmallString<256> Reconstituted;
           reconstituteName(FuncName, RealName, Remapped, Reconstituted);
-          Error E = Underlying.getRecords(Reconstituted, Data);
+          Error E = Get(Reconstituted);
           if (!E)
             return E;
 
@@ -700,10 +810,9 @@ public:
         }
       }
     }
-    return Underlying.getRecords(FuncName, Data);
+    return Get(FuncName);
   }
 
-private:
   /// The memory buffer containing the remapping configuration. Remappings
   /// holds pointers into this buffer.
   std::unique_ptr<MemoryBuffer> RemapBuffer;
@@ -866,6 +975,27 @@ IndexedInstrProfReader::getInstrProfRecord(StringRef FuncName,
   return error(instrprof_error::hash_mismatch);
 }
 
+Error IndexedInstrProfReader::getInstrProfRecordRef(StringRef FuncName,
+                                                    uint64_t FuncHash,
+                                                    InstrProfRecordRef &Ref) {
+  SmallVector<InstrProfRecordRef, 2> Refs;
+  if (Error Err = Remapper->getRecordRefs(FuncName, Refs))
+    return Err;
+  // Found it. Look for counters with the right hash.
+  for (const InstrProfRecordRef &R : Refs) {
+    if (R.Hash == FuncHash) {
+      Ref = R;
+      return Error::success();
+    }
+  }
+  return error(instrprof_error::hash_mismatch);
+}
+
+Error IndexedInstrProfReader::readValueProfData(const InstrProfRecordRef &Ref,
+                                                InstrProfRecord &Record) {
+  return Index->readValueProfData(Ref.ValueData, Record);
+}
+
 Error IndexedInstrProfReader::getFunctionCounts(StringRef FuncName,
                                                 uint64_t FuncHash,
                                                 std::vector<uint64_t> &Counts) {
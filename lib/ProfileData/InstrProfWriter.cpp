@@ -18,6 +18,7 @@
 #include "llvm/IR/ProfileSummary.h"
 #include "llvm/ProfileData/InstrProf.h"
 #include "llvm/ProfileData/ProfileCommon.h"
+#include "llvm/Support/DJB.h"
 #include "llvm/Support/Endian.h"
 #include "llvm/Support/EndianStream.h"
 #include "llvm/Support/Error.h"
@@ -219,6 +220,21 @@ void InstrProfWriter::mergeRecordsFromWriter(InstrProfWriter &&IPW,
       addRecord(I.getKey(), Func.first, std::move(Func.second), 1, Warn);
 }
 
+unsigned InstrProfWriter::getRecordShard(StringRef Name, unsigned NumShards) {
+  return djbHash(Name) % NumShards;
+}
+
+void InstrProfWriter::mergeRecordShardFromWriter(
+    InstrProfWriter &IPW, unsigned Shard, unsigned NumShards,
+    function_ref<void(Error)> Warn) {
+  // Only the records of this shard are touched, and the map of IPW itself is
+  // not modified, so other shards of IPW can be taken at the same time.
+  for (auto &I : IPW.FunctionData)
+    if (getRecordShard(I.getKey(), NumShards) == Shard)
+      for (auto &Func : I.getValue())
+        addRecord(I.getKey(), Func.first, std::move(Func.second), 1, Warn);
+}
+
 bool InstrProfWriter::shouldEncodeData(const ProfilingData &PD) {
   if (!Sparse)
     return true;
@@ -263,8 +279,10 @@ void InstrProfWriter::writeImpl(ProfOStream &OS) {
   IndexedInstrProf::Header Header;
   Header.Magic = IndexedInstrProf::Magic;
   Header.Version = IndexedInstrProf::ProfVersion::CurrentVersion;
-  if (ProfileKind == PF_IRLevel)
+  if (ProfileKind == PF_IRLevel || ProfileKind == PF_IRLevelWithCS)
     Header.Version |= VARIANT_MASK_IR_PROF;
+  if (ProfileKind == PF_IRLevelWithCS)
+    Header.Version |= VARIANT_MASK_CSIR_PROF;
   Header.Unused = 0;
   Header.HashType = static_cast<uint64_t>(IndexedInstrProf::HashType);
   Header.HashOffset = 0;
@@ -376,6 +394,8 @@ void InstrProfWriter::writeRecordInText(StringRef Name, uint64_t Hash,
 Error InstrProfWriter::writeText(raw_fd_ostream &OS) {
   if (ProfileKind == PF_IRLevel)
     OS << "# IR level Instrumentation Flag\n:ir\n";
+  else if (ProfileKind == PF_IRLevelWithCS)
+    OS << "# CSIR level Instrumentation Flag\n:csir\n";
   InstrProfSymtab Symtab;
   for (const auto &I : FunctionData)
     if (shouldEncodeData(I.getValue()))
@@ -359,7 +359,10 @@ ErrorOr<StringRef> SampleProfileReaderCompactBinary::readStringFromTable() {
   if (std::error_code EC = Idx.getError())
     return EC;
 
-  return StringRef(NameTable[*Idx]);
+  StringRef &Name = NameStrings[*Idx];
+  if (Name.empty())
+    Name = NameSaver.save(std::to_string(NameTable[*Idx]));
+  return Name;
 }
 
 std::error_code
@@ -469,18 +472,45 @@ std::error_code SampleProfileReaderBinary::read() {
 }
 
 std::error_code SampleProfileReaderCompactBinary::read() {
-  for (auto Name : FuncsToUse) {
-    auto GUID = std::to_string(MD5Hash(Name));
-    auto iter = FuncOffsetTable.find(StringRef(GUID));
-    if (iter == FuncOffsetTable.end())
-      continue;
-    const uint8_t *SavedData = Data;
-    Data = reinterpret_cast<const uint8_t *>(Buffer->getBufferStart()) +
-           iter->second;
+  DenseSet<uint64_t> GUIDsToUse;
+  for (StringRef Name : FuncsToUse)
+    GUIDsToUse.insert(MD5Hash(Name));
+
+  // Scan the function offset table for the functions to use. A module uses
+  // few of the functions of a large profile, so this is cheaper than indexing
+  // the whole table.
+  const uint8_t *SavedData = Data;
+  const uint8_t *SavedEnd = End;
+  Data = FuncOffsetTableStart;
+  End = reinterpret_cast<const uint8_t *>(Buffer->getBufferEnd());
+  auto Size = readNumber<uint64_t>();
+  if (std::error_code EC = Size.getError())
+    return EC;
+  std::vector<uint64_t> OffsetsToUse;
+  for (uint64_t I = 0; I < *Size; ++I) {
+    auto Idx = readStringIndex(NameTable);
+    if (std::error_code EC = Idx.getError())
+      return EC;
+    auto Offset = readNumber<uint64_t>();
+    if (std::error_code EC = Offset.getError())
+      return EC;
+    if (UseAllFuncs || GUIDsToUse.count(NameTable[*Idx]))
+      OffsetsToUse.push_back(*Offset);
+  }
+  End = SavedEnd;
+
+  // Read the profiles in file order.
+  const uint8_t *Start =
+      reinterpret_cast<const uint8_t *>(Buffer->getBufferStart());
+  llvm::sort(OffsetsToUse);
+  for (uint64_t Offset : OffsetsToUse) {
+    if (Offset >= uint64_t(FuncOffsetTableStart - Start))
+      return sampleprof_error::malformed;
+    Data = Start + Offset;
     if (std::error_code EC = readFuncProfile())
       return EC;
-    Data = SavedData;
   }
+  Data = SavedData;
   return sampleprof_error::success;
 }
 
@@ -521,8 +551,9 @@ std::error_code SampleProfileReaderCompactBinary::readNameTable() {
     auto FID = readNumber<uint64_t>();
     if (std::error_code EC = FID.getError())
       return EC;
-    NameTable.push_back(std::to_string(*FID));
+    NameTable.push_back(*FID);
   }
+  NameStrings.resize(NameTable.size());
   return sampleprof_error::success;
 }
 
@@ -553,7 +584,8 @@ std::error_code SampleProfileReaderBinary::readHeader() {
 }
 
 std::error_code SampleProfileReaderCompactBinary::readHeader() {
-  SampleProfileReaderBinary::readHeader();
+  if (std::error_code EC = SampleProfileReaderBinary::readHeader())
+    return EC;
   if (std::error_code EC = readFuncOffsetTable())
     return EC;
   return sampleprof_error::success;
@@ -563,35 +595,20 @@ std::error_code SampleProfileReaderCompactBinary::readFuncOffsetTable() {
   auto TableOffset = readUnencodedNumber<uint64_t>();
   if (std::error_code EC = TableOffset.getError())
     return EC;
+  if (*TableOffset > Buffer->getBufferSize())
+    return sampleprof_error::malformed;
 
-  const uint8_t *SavedData = Data;
-  const uint8_t *TableStart =
+  // The table itself is only read by read(), once the functions to use are
+  // known.
+  FuncOffsetTableStart =
       reinterpret_cast<const uint8_t *>(Buffer->getBufferStart()) +
       *TableOffset;
-  Data = TableStart;
-
-  auto Size = readNumber<uint64_t>();
-  if (std::error_code EC = Size.getError())
-    return EC;
-
-  FuncOffsetTable.reserve(*Size);
-  for (uint32_t I = 0; I < *Size; ++I) {
-    auto FName(readStringFromTable());
-    if (std::error_code EC = FName.getError())
-      return EC;
-
-    auto Offset = readNumber<uint64_t>();
-    if (std::error_code EC = Offset.getError())
-      return EC;
-
-    FuncOffsetTable[*FName] = *Offset;
-  }
-  End = TableStart;
-  Data = SavedData;
+  End = FuncOffsetTableStart;
   return sampleprof_error::success;
 }
 
 void SampleProfileReaderCompactBinary::collectFuncsToUse(const Module &M) {
+  UseAllFuncs = false;
   FuncsToUse.clear();
   for (auto &F : M) {
     StringRef Fname = F.getName().split('.').first;
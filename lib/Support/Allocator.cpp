@@ -12,12 +12,175 @@
 //===----------------------------------------------------------------------===//
 
 #include "llvm/Support/Allocator.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/Config/config.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/ManagedStatic.h"
+#include "llvm/Support/Mutex.h"
+#include "llvm/Support/ThreadLocalBumpPtrAllocator.h"
 #include "llvm/Support/raw_ostream.h"
+#include <atomic>
+#include <string>
+#include <vector>
+
+#if defined(HAVE_LINK_H)
+#include <link.h>
+#endif
 
 namespace llvm {
 
 namespace detail {
 
+bool ProfileBumpPtrAllocations = false;
+
+} // End namespace detail.
+
+static cl::opt<bool, true> ProfileBumpPtrAllocationsOpt(
+    "profile-bump-ptr-allocations",
+    cl::desc("Print the bytes allocated from BumpPtrAllocators per call site"),
+    cl::location(detail::ProfileBumpPtrAllocations), cl::Hidden);
+
+namespace {
+
+/// The allocations recorded per call site. This lives in a ManagedStatic, and
+/// prints the profile when llvm_shutdown destroys it.
+class AllocationProfile {
+public:
+  struct Site {
+    uint64_t Bytes = 0;
+    uint64_t Count = 0;
+  };
+
+  ~AllocationProfile() {
+    if (detail::ProfileBumpPtrAllocations)
+      print(errs());
+  }
+
+  void record(const void *PC, size_t Size) {
+    sys::SmartScopedLock<true> Lock(Mutex);
+    Site &S = Sites[PC];
+    S.Bytes += Size;
+    ++S.Count;
+  }
+
+  void print(raw_ostream &OS);
+
+private:
+  sys::SmartMutex<true> Mutex;
+  DenseMap<const void *, Site> Sites;
+};
+
+} // end anonymous namespace
+
+static ManagedStatic<AllocationProfile> Profile;
+
+#if defined(HAVE_LINK_H) && defined(__ELF__)
+namespace {
+struct FindModulesData {
+  ArrayRef<const void *> PCs;
+  const std::string &MainExecutable;
+  std::vector<std::string> &Modules;
+  std::vector<uintptr_t> &Offsets;
+};
+} // end anonymous namespace
+
+static int findModulesCallback(dl_phdr_info *Info, size_t, void *Arg) {
+  auto *Data = static_cast<FindModulesData *>(Arg);
+  for (int I = 0; I < Info->dlpi_phnum; ++I) {
+    const auto &Phdr = Info->dlpi_phdr[I];
+    if (Phdr.p_type != PT_LOAD)
+      continue;
+    uintptr_t Begin = Info->dlpi_addr + Phdr.p_vaddr;
+    uintptr_t End = Begin + Phdr.p_memsz;
+    for (size_t J = 0, E = Data->PCs.size(); J != E; ++J) {
+      uintptr_t PC = reinterpret_cast<uintptr_t>(Data->PCs[J]);
+      if (Data->Modules[J].empty() && Begin <= PC && PC < End) {
+        // The main executable has no name.
+        Data->Modules[J] =
+            *Info->dlpi_name ? Info->dlpi_name : Data->MainExecutable;
+        Data->Offsets[J] = PC - Info->dlpi_addr;
+      }
+    }
+  }
+  return 0;
+}
+#endif
+
+/// Describe each of \p PCs as a module and offset in it that llvm-symbolizer
+/// understands, or else as an address.
+static std::vector<std::string> describeCallSites(ArrayRef<const void *> PCs) {
+  std::vector<std::string> Modules(PCs.size());
+  std::vector<uintptr_t> Offsets(PCs.size());
+#if defined(HAVE_LINK_H) && defined(__ELF__)
+  std::string MainExecutable = sys::fs::getMainExecutable(
+      "", reinterpret_cast<void *>(&EnableBumpPtrAllocationProfiling));
+  FindModulesData Data = {PCs, MainExecutable, Modules, Offsets};
+  dl_iterate_phdr(findModulesCallback, &Data);
+#endif
+  std::vector<std::string> Descriptions;
+  for (size_t I = 0, E = PCs.size(); I != E; ++I) {
+    std::string Description;
+    raw_string_ostream OS(Description);
+    if (Modules[I].empty())
+      OS << format_hex(reinterpret_cast<uintptr_t>(PCs[I]), 18);
+    else
+      OS << Modules[I] << '+' << format_hex(Offsets[I], 1);
+    Descriptions.push_back(OS.str());
+  }
+  return Descriptions;
+}
+
+void AllocationProfile::print(raw_ostream &OS) {
+  std::vector<std::pair<const void *, Site>> Sorted;
+  {
+    sys::SmartScopedLock<true> Lock(Mutex);
+    Sorted.assign(Sites.begin(), Sites.end());
+  }
+  llvm::sort(Sorted, [](const std::pair<const void *, Site> &A,
+                        const std::pair<const void *, Site> &B) {
+    return A.second.Bytes > B.second.Bytes;
+  });
+  std::vector<const void *> PCs;
+  uint64_t TotalBytes = 0;
+  for (const auto &S : Sorted) {
+    PCs.push_back(S.first);
+    TotalBytes += S.second.Bytes;
+  }
+  std::vector<std::string> Descriptions = describeCallSites(PCs);
+
+  OS << "===" << std::string(73, '-') << "===\n"
+     << "                 BumpPtrAllocator allocations by call site\n"
+     << "===" << std::string(73, '-') << "===\n"
+     << "  Total bytes allocated: " << TotalBytes << "\n\n"
+     << "       Bytes     Allocs  Call site\n";
+  for (size_t I = 0, E = Sorted.size(); I != E; ++I)
+    OS << format("%12llu %10llu  ",
+                 (unsigned long long)Sorted[I].second.Bytes,
+                 (unsigned long long)Sorted[I].second.Count)
+       << Descriptions[I] << '\n';
+  OS << '\n';
+  OS.flush();
+}
+
+void EnableBumpPtrAllocationProfiling() {
+  detail::ProfileBumpPtrAllocations = true;
+}
+
+void PrintBumpPtrAllocationProfile(raw_ostream &OS) { Profile->print(OS); }
+
+namespace detail {
+
+void recordBumpPtrAllocation(size_t Size) {
+#if defined(__GNUC__)
+  const void *PC = __builtin_return_address(0);
+#else
+  const void *PC = nullptr;
+#endif
+  Profile->record(PC, Size);
+}
+
 void printBumpPtrAllocatorStats(unsigned NumSlabs, size_t BytesAllocated,
                                 size_t TotalMemory) {
   errs() << "\nNumber of memory regions: " << NumSlabs << '\n'
@@ -29,6 +192,63 @@ void printBumpPtrAllocatorStats(unsigned NumSlabs, size_t BytesAllocated,
 
 } // End namespace detail.
 
+namespace detail {
+
+LLVM_THREAD_LOCAL ThreadLocalAllocatorCache CurrentThreadAllocator;
+
+} // End namespace detail.
+
+static std::atomic<uint64_t> NextThreadLocalAllocatorID{1};
+
+ThreadLocalBumpPtrAllocator::ThreadLocalBumpPtrAllocator()
+    : ID(NextThreadLocalAllocatorID++) {}
+
+BumpPtrAllocator &ThreadLocalBumpPtrAllocator::getThreadAllocatorSlow() {
+  std::thread::id Self = std::this_thread::get_id();
+  BumpPtrAllocator *Allocator = nullptr;
+  {
+    std::lock_guard<std::mutex> Lock(Mutex);
+    for (auto &Entry : Allocators)
+      if (Entry.first == Self)
+        Allocator = Entry.second.get();
+    if (!Allocator) {
+      Allocators.emplace_back(Self, llvm::make_unique<BumpPtrAllocator>());
+      Allocator = Allocators.back().second.get();
+    }
+  }
+  detail::CurrentThreadAllocator = {ID, Allocator};
+  return *Allocator;
+}
+
+void ThreadLocalBumpPtrAllocator::Reset() {
+  std::lock_guard<std::mutex> Lock(Mutex);
+  for (auto &Entry : Allocators)
+    Entry.second->Reset();
+}
+
+size_t ThreadLocalBumpPtrAllocator::getTotalMemory() const {
+  std::lock_guard<std::mutex> Lock(Mutex);
+  size_t TotalMemory = 0;
+  for (auto &Entry : Allocators)
+    TotalMemory += Entry.second->getTotalMemory();
+  return TotalMemory;
+}
+
+size_t ThreadLocalBumpPtrAllocator::getBytesAllocated() const {
+  std::lock_guard<std::mutex> Lock(Mutex);
+  size_t BytesAllocated = 0;
+  for (auto &Entry : Allocators)
+    BytesAllocated += Entry.second->getBytesAllocated();
+  return BytesAllocated;
+}
+
+void ThreadLocalBumpPtrAllocator::PrintStats() const {
+  std::lock_guard<std::mutex> Lock(Mutex);
+  errs() << "\nNumber of threads: " << Allocators.size() << '\n';
+  for (auto &Entry : Allocators)
+    Entry.second->PrintStats();
+}
+
 void PrintRecyclerStats(size_t Size,
                         size_t Align,
                         size_t FreeListSize) {
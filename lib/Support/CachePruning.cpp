@@ -13,10 +13,13 @@
 
 #include "llvm/Support/CachePruning.h"
 
+#include "llvm/ADT/StringMap.h"
+#include "llvm/Support/Chrono.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/Errc.h"
 #include "llvm/Support/Error.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/raw_ostream.h"
 
@@ -56,6 +59,78 @@ static void writeTimestampFile(StringRef TimestampFile) {
   raw_fd_ostream Out(TimestampFile.str(), EC, sys::fs::F_None);
 }
 
+/// Name of the cache journal. Every line of the journal has the form
+/// "<time of use> <size> <entry name>", with the time in seconds since the
+/// epoch. Lines are only ever appended, and the latest line for an entry wins.
+static const char JournalName[] = "llvmcache.journal";
+
+/// Append the given journal lines to JournalFile. The file is opened for
+/// appending and every write ends on a line boundary, so lines from concurrent
+/// writers are not interleaved.
+static void appendToJournal(const Twine &JournalFile, StringRef Lines,
+                            sys::fs::CreationDisposition Disp) {
+  int FD;
+  if (sys::fs::openFileForWrite(JournalFile, FD, Disp, sys::fs::OF_Append))
+    return;
+  raw_fd_ostream OS(FD, /*shouldClose*/ true, /*unbuffered*/ true);
+  const size_t ChunkSize = 64 * 1024;
+  while (!Lines.empty()) {
+    size_t End = Lines.size() > ChunkSize
+                     ? Lines.rfind('\n', ChunkSize)
+                     : StringRef::npos;
+    StringRef Chunk =
+        End == StringRef::npos ? Lines : Lines.take_front(End + 1);
+    OS << Chunk;
+    Lines = Lines.drop_front(Chunk.size());
+  }
+}
+
+static std::string getJournalLine(sys::TimePoint<> Time, uint64_t Size,
+                                  StringRef EntryName) {
+  return (Twine(uint64_t(sys::toTimeT(Time))) + " " + Twine(Size) + " " +
+          EntryName + "\n")
+      .str();
+}
+
+void llvm::recordCacheEntryUse(StringRef Path, StringRef EntryName,
+                               uint64_t Size) {
+  SmallString<128> JournalFile(Path);
+  sys::path::append(JournalFile, JournalName);
+  appendToJournal(JournalFile,
+                  getJournalLine(std::chrono::system_clock::now(), Size,
+                                 EntryName),
+                  sys::fs::CD_OpenExisting);
+}
+
+/// Read the entries recorded in the journal Buffer for the cache directory
+/// Path into FileInfos.
+static void readJournal(StringRef Buffer, StringRef Path,
+                        std::set<FileInfo> &FileInfos) {
+  StringMap<std::pair<std::time_t, uint64_t>> Entries;
+  SmallVector<StringRef, 0> Lines;
+  Buffer.split(Lines, '\n', /*MaxSplit*/ -1, /*KeepEmpty*/ false);
+  for (StringRef Line : Lines) {
+    StringRef TimeStr, SizeStr, Name;
+    std::tie(TimeStr, Line) = Line.split(' ');
+    std::tie(SizeStr, Name) = Line.split(' ');
+    uint64_t Time, Size;
+    // Skip lines cut short by a crashed writer.
+    if (TimeStr.getAsInteger(10, Time) || SizeStr.getAsInteger(10, Size) ||
+        !Name.startswith("llvmcache-") || Name.contains('/'))
+      continue;
+    auto &Entry = Entries[Name];
+    if (Time >= uint64_t(Entry.first))
+      Entry = {std::time_t(Time), Size};
+  }
+
+  for (auto &Entry : Entries) {
+    SmallString<128> File(Path);
+    sys::path::append(File, Entry.first());
+    FileInfos.insert({sys::toTimePoint(Entry.second.first),
+                      Entry.second.second, File.str()});
+  }
+}
+
 static Expected<std::chrono::seconds> parseDuration(StringRef Duration) {
   if (Duration.empty())
     return make_error<StringError>("Duration must not be empty",
@@ -135,6 +210,12 @@ llvm::parseCachePruningPolicy(StringRef PolicyStr) {
         return make_error<StringError>("'" + Value + "' not an integer",
                                        inconvertibleErrorCode());
       Policy.MaxSizeBytes = Size * Mult;
+    } else if (Key == "cache_journal") {
+      unsigned UseJournal;
+      if (Value.getAsInteger(0, UseJournal) || UseJournal > 1)
+        return make_error<StringError>("'" + Value + "' must be 0 or 1",
+                                       inconvertibleErrorCode());
+      Policy.UseJournal = UseJournal;
     } else if (Key == "cache_size_files") {
       if (Value.getAsInteger(0, Policy.MaxSizeFiles))
         return make_error<StringError>("'" + Value + "' not an integer",
@@ -212,13 +293,48 @@ bool llvm::pruneCache(StringRef Path, CachePruningPolicy Policy) {
   std::set<FileInfo> FileInfos;
   uint64_t TotalSize = 0;
 
-  // Walk the entire directory cache, looking for unused files.
+  // Move the journal out of the way before reading it, and start a new one
+  // that records the entries used while pruning. The surviving entries are
+  // appended to the new journal below.
+  SmallString<128> JournalFile(Path), PrunedJournalFile;
+  sys::path::append(JournalFile, JournalName);
+  bool ReadJournal = false;
+  if (Policy.UseJournal) {
+    PrunedJournalFile = JournalFile;
+    PrunedJournalFile += ".pruning";
+    bool Renamed = !sys::fs::rename(JournalFile, PrunedJournalFile);
+    appendToJournal(JournalFile, "", sys::fs::CD_OpenAlways);
+    if (Renamed) {
+      if (auto BufOrErr = MemoryBuffer::getFile(PrunedJournalFile)) {
+        readJournal((*BufOrErr)->getBuffer(), Path, FileInfos);
+        ReadJournal = true;
+      }
+    }
+  }
+
+  // Walk the entire directory cache, looking for unused files, unless they
+  // were read from the journal.
   std::error_code EC;
   SmallString<128> CachePathNative;
   sys::path::native(Path, CachePathNative);
+  if (ReadJournal) {
+    for (auto I = FileInfos.begin(); I != FileInfos.end();) {
+      auto FileAge = CurrentTime - I->Time;
+      if (Policy.Expiration != seconds(0) && FileAge > Policy.Expiration) {
+        LLVM_DEBUG(dbgs() << "Remove " << I->Path << " ("
+                          << duration_cast<seconds>(FileAge).count()
+                          << "s old)\n");
+        sys::fs::remove(I->Path);
+        I = FileInfos.erase(I);
+        continue;
+      }
+      TotalSize += I->Size;
+      ++I;
+    }
+  }
   // Walk all of the files within this directory.
   for (sys::fs::directory_iterator File(CachePathNative, EC), FileEnd;
-       File != FileEnd && !EC; File.increment(EC)) {
+       !ReadJournal && File != FileEnd && !EC; File.increment(EC)) {
     // Ignore any files not beginning with the string "llvmcache-". This
     // includes the timestamp file as well as any files created by the user.
     // This acts as a safeguard against data loss if the user specifies the
@@ -296,5 +412,15 @@ bool llvm::pruneCache(StringRef Path, CachePruningPolicy Policy) {
     while (TotalSize > TotalSizeTarget && FileInfo != FileInfos.end())
       RemoveCacheFile();
   }
+
+  // Record the surviving entries in the new journal.
+  if (Policy.UseJournal) {
+    std::string Lines;
+    for (auto I = FileInfo, E = FileInfos.end(); I != E; ++I)
+      Lines += getJournalLine(I->Time, I->Size, sys::path::filename(I->Path));
+    appendToJournal(JournalFile, Lines, sys::fs::CD_OpenAlways);
+    if (ReadJournal)
+      sys::fs::remove(PrunedJournalFile);
+  }
   return true;
 }
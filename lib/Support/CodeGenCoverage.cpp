@@ -33,9 +33,12 @@ static sys::SmartMutex<true> OutputMutex;
 CodeGenCoverage::CodeGenCoverage() {}
 
 void CodeGenCoverage::setCovered(uint64_t RuleID) {
-  if (RuleCoverage.size() <= RuleID)
+  if (RuleCoverage.size() <= RuleID) {
     RuleCoverage.resize(RuleID + 1, 0);
+    RuleHits.resize(RuleID + 1, 0);
+  }
   RuleCoverage[RuleID] = true;
+  ++RuleHits[RuleID];
 }
 
 bool CodeGenCoverage::isCovered(uint64_t RuleID) const {
@@ -44,6 +47,12 @@ bool CodeGenCoverage::isCovered(uint64_t RuleID) const {
   return RuleCoverage[RuleID];
 }
 
+uint64_t CodeGenCoverage::getHitCount(uint64_t RuleID) const {
+  if (RuleHits.size() <= RuleID)
+    return 0;
+  return RuleHits[RuleID];
+}
+
 iterator_range<CodeGenCoverage::const_covered_iterator>
 CodeGenCoverage::covered() const {
   return RuleCoverage.set_bits();
@@ -122,4 +131,7 @@ bool CodeGenCoverage::emit(StringRef CoveragePrefix,
   return true;
 }
 
-void CodeGenCoverage::reset() { RuleCoverage.resize(0); }
+void CodeGenCoverage::reset() {
+  RuleCoverage.resize(0);
+  RuleHits.clear();
+}
@@ -115,6 +115,30 @@ public:
   bool ParseCommandLineOptions(int argc, const char *const *argv,
                                StringRef Overview, raw_ostream *Errs = nullptr);
 
+  // Queue Opt for registration. Option constructors run at load time, and
+  // most of a tool's thousands of options are never looked up, so they are
+  // only added to the option maps of their subcommands the first time the
+  // maps are used (see registerPendingOptions).
+  void queueOption(Option *Opt) { PendingOptions.push_back({Opt, None}); }
+
+  void queueLiteralOption(Option &Opt, StringRef Name) {
+    PendingOptions.push_back({&Opt, Name});
+  }
+
+  // Register the queued options, in the order in which they were queued.
+  void registerPendingOptions() {
+    if (PendingOptions.empty())
+      return;
+    std::vector<PendingOption> Pending;
+    Pending.swap(PendingOptions);
+    for (const PendingOption &P : Pending) {
+      if (P.LiteralName)
+        addLiteralOption(*P.Opt, *P.LiteralName);
+      else
+        addOption(P.Opt);
+    }
+  }
+
   void addLiteralOption(Option &Opt, SubCommand *SC, StringRef Name) {
     if (Opt.hasArgStr())
       return;
@@ -225,6 +249,7 @@ public:
   }
 
   void removeOption(Option *O) {
+    registerPendingOptions();
     if (O->Subs.empty())
       removeOption(O, &*TopLevelSubCommand);
     else {
@@ -264,6 +289,7 @@ public:
   }
 
   void updateArgStr(Option *O, StringRef NewName) {
+    registerPendingOptions();
     if (O->Subs.empty())
       updateArgStr(O, NewName, &*TopLevelSubCommand);
     else {
@@ -313,6 +339,7 @@ public:
 
   iterator_range<typename SmallPtrSet<SubCommand *, 4>::iterator>
   getRegisteredSubcommands() {
+    registerPendingOptions();
     return make_range(RegisteredSubCommands.begin(),
                       RegisteredSubCommands.end());
   }
@@ -324,6 +351,7 @@ public:
 
     MoreHelp.clear();
     RegisteredOptionCategories.clear();
+    PendingOptions.clear();
 
     ResetAllOptionOccurrences();
     RegisteredSubCommands.clear();
@@ -337,6 +365,13 @@ public:
 private:
   SubCommand *ActiveSubCommand;
 
+  // An option, or a literal name of an option, waiting to be registered.
+  struct PendingOption {
+    Option *Opt;
+    llvm::Optional<StringRef> LiteralName;
+  };
+  std::vector<PendingOption> PendingOptions;
+
   Option *LookupOption(SubCommand &Sub, StringRef &Arg, StringRef &Value);
   SubCommand *LookupSubCommand(StringRef Name);
 };
@@ -346,7 +381,7 @@ private:
 static ManagedStatic<CommandLineParser> GlobalParser;
 
 void cl::AddLiteralOption(Option &O, StringRef Name) {
-  GlobalParser->addLiteralOption(O, Name);
+  GlobalParser->queueLiteralOption(O, Name);
 }
 
 extrahelp::extrahelp(StringRef Help) : morehelp(Help) {
@@ -354,7 +389,7 @@ extrahelp::extrahelp(StringRef Help) : morehelp(Help) {
 }
 
 void Option::addArgument() {
-  GlobalParser->addOption(this);
+  GlobalParser->queueOption(this);
   FullyInitialized = true;
 }
 
@@ -1086,6 +1121,7 @@ bool cl::ParseCommandLineOptions(int argc, const char *const *argv,
 }
 
 void CommandLineParser::ResetAllOptionOccurrences() {
+  registerPendingOptions();
   // So that we can parse different command lines multiple times in succession
   // we reset all option values to look like they have never been seen before.
   for (auto SC : RegisteredSubCommands) {
@@ -1098,6 +1134,7 @@ bool CommandLineParser::ParseCommandLineOptions(int argc,
                                                 const char *const *argv,
                                                 StringRef Overview,
                                                 raw_ostream *Errs) {
+  registerPendingOptions();
   assert(hasOptions() && "No options specified!");
 
   // Expand response files.
@@ -1861,6 +1898,7 @@ public:
   }
 
   void printHelp() {
+    GlobalParser->registerPendingOptions();
     SubCommand *Sub = GlobalParser->getActiveSubCommand();
     auto &OptionsMap = Sub->OptionsMap;
     auto &PositionalOpts = Sub->PositionalOpts;
@@ -2115,6 +2153,7 @@ void CommandLineParser::printOptionValues() {
   if (!PrintOptions && !PrintAllOptions)
     return;
 
+  registerPendingOptions();
   SmallVector<std::pair<const char *, Option *>, 128> Opts;
   sortOpts(ActiveSubCommand->OptionsMap, Opts, /*ShowHidden*/ true);
 
@@ -2220,6 +2259,7 @@ void cl::AddExtraVersionPrinter(VersionPrinterTy func) {
 }
 
 StringMap<Option *> &cl::getRegisteredOptions(SubCommand &Sub) {
+  GlobalParser->registerPendingOptions();
   auto &Subs = GlobalParser->RegisteredSubCommands;
   (void)Subs;
   assert(is_contained(Subs, &Sub));
@@ -2232,6 +2272,7 @@ cl::getRegisteredSubcommands() {
 }
 
 void cl::HideUnrelatedOptions(cl::OptionCategory &Category, SubCommand &Sub) {
+  GlobalParser->registerPendingOptions();
   for (auto &I : Sub.OptionsMap) {
     if (I.second->Category != &Category &&
         I.second->Category != &GenericCategory)
@@ -2241,6 +2282,7 @@ void cl::HideUnrelatedOptions(cl::OptionCategory &Category, SubCommand &Sub) {
 
 void cl::HideUnrelatedOptions(ArrayRef<const cl::OptionCategory *> Categories,
                               SubCommand &Sub) {
+  GlobalParser->registerPendingOptions();
   auto CategoriesBegin = Categories.begin();
   auto CategoriesEnd = Categories.end();
   for (auto &I : Sub.OptionsMap) {
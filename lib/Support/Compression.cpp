@@ -14,20 +14,31 @@
 #include "llvm/Support/Compression.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/StringRef.h"
+#include "llvm/ADT/Twine.h"
 #include "llvm/Config/config.h"
+#include "llvm/Config/llvm-config.h"
 #include "llvm/Support/Compiler.h"
 #include "llvm/Support/Error.h"
 #include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/Parallel.h"
+#include <vector>
 #if LLVM_ENABLE_ZLIB == 1 && HAVE_ZLIB_H
 #include <zlib.h>
 #endif
+#if LLVM_ENABLE_ZSTD == 1 && HAVE_ZSTD_H
+#include <zstd.h>
+#endif
 
 using namespace llvm;
 
-#if LLVM_ENABLE_ZLIB == 1 && HAVE_LIBZ
-static Error createError(StringRef Err) {
+#if (LLVM_ENABLE_ZLIB == 1 && HAVE_LIBZ) ||                                   \
+    (LLVM_ENABLE_ZSTD == 1 && HAVE_ZSTD_H && HAVE_LIBZSTD)
+static Error createError(const Twine &Err) {
   return make_error<StringError>(Err, inconvertibleErrorCode());
 }
+#endif
+
+#if LLVM_ENABLE_ZLIB == 1 && HAVE_LIBZ
 
 static StringRef convertZlibCodeToString(int Code) {
   switch (Code) {
@@ -61,6 +72,101 @@ Error zlib::compress(StringRef InputBuffer,
   return Res ? createError(convertZlibCodeToString(Res)) : Error::success();
 }
 
+// Deflate Chunk into raw deflate blocks, using Dict as the preceding window.
+// Unless Last is set, the blocks end with a sync flush so that they can be
+// followed by the blocks of the next chunk.
+static int deflateChunk(StringRef Dict, StringRef Chunk, bool Last, int Level,
+                        SmallVectorImpl<char> &Out) {
+  z_stream Stream = {};
+  int Res = ::deflateInit2(&Stream, Level, Z_DEFLATED, -MAX_WBITS, 8,
+                           Z_DEFAULT_STRATEGY);
+  if (Res != Z_OK)
+    return Res;
+  if (!Dict.empty())
+    ::deflateSetDictionary(&Stream, (const Bytef *)Dict.data(), Dict.size());
+
+  Out.resize(::deflateBound(&Stream, Chunk.size()) + 16);
+  Stream.next_in = (Bytef *)Chunk.data();
+  Stream.avail_in = Chunk.size();
+  size_t Written = 0;
+  for (;;) {
+    Stream.next_out = (Bytef *)Out.data() + Written;
+    Stream.avail_out = Out.size() - Written;
+    Res = ::deflate(&Stream, Last ? Z_FINISH : Z_SYNC_FLUSH);
+    Written = Out.size() - Stream.avail_out;
+    // Until the output buffer is left with room, the flush may be incomplete.
+    if (Res == Z_STREAM_END ||
+        (!Last && (Res == Z_OK || Res == Z_BUF_ERROR) && Stream.avail_out)) {
+      Res = Z_OK;
+      break;
+    }
+    if (Res != Z_OK && Res != Z_BUF_ERROR)
+      break;
+    Out.resize(Out.size() * 2);
+  }
+  __msan_unpoison(Out.data(), Written);
+  Out.resize(Written);
+  ::deflateEnd(&Stream);
+  return Res;
+}
+
+Error zlib::compressInChunks(StringRef InputBuffer,
+                             SmallVectorImpl<char> &CompressedBuffer,
+                             size_t ChunkSize, int Level) {
+  assert(ChunkSize > 0 && "empty chunks");
+  const size_t WindowSize = size_t(1) << MAX_WBITS;
+  size_t NumChunks =
+      std::max<size_t>(1, (InputBuffer.size() + ChunkSize - 1) / ChunkSize);
+  std::vector<SmallVector<char, 0>> Chunks(NumChunks);
+  std::vector<uLong> Checksums(NumChunks);
+  std::vector<int> Results(NumChunks);
+
+  auto CompressChunk = [&](size_t I) {
+    size_t Begin = I * ChunkSize;
+    StringRef Chunk = InputBuffer.substr(Begin, ChunkSize);
+    size_t DictBegin = Begin > WindowSize ? Begin - WindowSize : 0;
+    StringRef Dict = InputBuffer.slice(DictBegin, Begin);
+    Results[I] =
+        deflateChunk(Dict, Chunk, I + 1 == NumChunks, Level, Chunks[I]);
+    Checksums[I] =
+        ::adler32(::adler32(0, nullptr, 0), (const Bytef *)Chunk.data(),
+                  Chunk.size());
+  };
+#if LLVM_ENABLE_THREADS
+  parallel::for_each_n(parallel::par, size_t(0), NumChunks, CompressChunk);
+#else
+  for (size_t I = 0; I != NumChunks; ++I)
+    CompressChunk(I);
+#endif
+
+  for (int Res : Results)
+    if (Res != Z_OK)
+      return createError(convertZlibCodeToString(Res));
+
+  // Wrap the raw deflate blocks into a zlib stream: a two byte header with
+  // the same level flags as deflate() would write, and the Adler-32 checksum
+  // of the whole input.
+  unsigned LevelFlags = Level == Z_DEFAULT_COMPRESSION
+                            ? 2
+                            : Level < 2 ? 0 : Level < 6 ? 1 : Level == 6 ? 2 : 3;
+  unsigned Header = (0x78 << 8) | (LevelFlags << 6);
+  Header += 31 - Header % 31;
+  CompressedBuffer.clear();
+  CompressedBuffer.push_back(Header >> 8);
+  CompressedBuffer.push_back(Header & 0xff);
+  uLong Checksum = Checksums[0];
+  for (size_t I = 0; I != NumChunks; ++I) {
+    CompressedBuffer.append(Chunks[I].begin(), Chunks[I].end());
+    if (I != 0)
+      Checksum = ::adler32_combine(Checksum, Checksums[I],
+                                   InputBuffer.substr(I * ChunkSize,
+                                                      ChunkSize).size());
+  }
+  for (int Shift = 24; Shift >= 0; Shift -= 8)
+    CompressedBuffer.push_back((Checksum >> Shift) & 0xff);
+  return Error::success();
+}
+
 Error zlib::uncompress(StringRef InputBuffer, char *UncompressedBuffer,
                        size_t &UncompressedSize) {
   int Res =
@@ -92,6 +198,11 @@ Error zlib::compress(StringRef InputBuffer,
                      SmallVectorImpl<char> &CompressedBuffer, int Level) {
   llvm_unreachable("zlib::compress is unavailable");
 }
+Error zlib::compressInChunks(StringRef InputBuffer,
+                             SmallVectorImpl<char> &CompressedBuffer,
+                             size_t ChunkSize, int Level) {
+  llvm_unreachable("zlib::compressInChunks is unavailable");
+}
 Error zlib::uncompress(StringRef InputBuffer, char *UncompressedBuffer,
                        size_t &UncompressedSize) {
   llvm_unreachable("zlib::uncompress is unavailable");
@@ -105,3 +216,75 @@ uint32_t zlib::crc32(StringRef Buffer) {
   llvm_unreachable("zlib::crc32 is unavailable");
 }
 #endif
+
+bool zstd::isFrame(StringRef Buffer) {
+  // ZSTD_MAGICNUMBER, stored little-endian.
+  return Buffer.startswith(StringRef("\x28\xb5\x2f\xfd", 4));
+}
+
+#if LLVM_ENABLE_ZSTD == 1 && HAVE_ZSTD_H && HAVE_LIBZSTD
+bool zstd::isAvailable() { return true; }
+
+Error zstd::compress(StringRef InputBuffer,
+                     SmallVectorImpl<char> &CompressedBuffer, int Level,
+                     unsigned NumThreads) {
+  ZSTD_CCtx *Ctx = ::ZSTD_createCCtx();
+  if (!Ctx)
+    return createError("zstd error: cannot allocate a compression context");
+  ::ZSTD_CCtx_setParameter(Ctx, ZSTD_c_compressionLevel, Level);
+  // This fails when zstd is built without threads, in which case the input
+  // is compressed on the calling thread.
+  if (NumThreads)
+    ::ZSTD_CCtx_setParameter(Ctx, ZSTD_c_nbWorkers, NumThreads);
+
+  size_t CompressedSize = ::ZSTD_compressBound(InputBuffer.size());
+  CompressedBuffer.reserve(CompressedSize);
+  size_t Res = ::ZSTD_compress2(Ctx, CompressedBuffer.data(), CompressedSize,
+                                InputBuffer.data(), InputBuffer.size());
+  ::ZSTD_freeCCtx(Ctx);
+  if (::ZSTD_isError(Res))
+    return createError(Twine("zstd error: ") + ::ZSTD_getErrorName(Res));
+  // Tell MemorySanitizer that zstd output buffer is fully initialized.
+  __msan_unpoison(CompressedBuffer.data(), Res);
+  CompressedBuffer.set_size(Res);
+  return Error::success();
+}
+
+Error zstd::uncompress(StringRef InputBuffer, char *UncompressedBuffer,
+                       size_t &UncompressedSize) {
+  size_t Res = ::ZSTD_decompress(UncompressedBuffer, UncompressedSize,
+                                 InputBuffer.data(), InputBuffer.size());
+  if (::ZSTD_isError(Res))
+    return createError(Twine("zstd error: ") + ::ZSTD_getErrorName(Res));
+  __msan_unpoison(UncompressedBuffer, Res);
+  UncompressedSize = Res;
+  return Error::success();
+}
+
+Error zstd::uncompress(StringRef InputBuffer,
+                       SmallVectorImpl<char> &UncompressedBuffer,
+                       size_t UncompressedSize) {
+  UncompressedBuffer.resize(UncompressedSize);
+  Error E =
+      uncompress(InputBuffer, UncompressedBuffer.data(), UncompressedSize);
+  UncompressedBuffer.resize(UncompressedSize);
+  return E;
+}
+
+#else
+bool zstd::isAvailable() { return false; }
+Error zstd::compress(StringRef InputBuffer,
+                     SmallVectorImpl<char> &CompressedBuffer, int Level,
+                     unsigned NumThreads) {
+  llvm_unreachable("zstd::compress is unavailable");
+}
+Error zstd::uncompress(StringRef InputBuffer, char *UncompressedBuffer,
+                       size_t &UncompressedSize) {
+  llvm_unreachable("zstd::uncompress is unavailable");
+}
+Error zstd::uncompress(StringRef InputBuffer,
+                       SmallVectorImpl<char> &UncompressedBuffer,
+                       size_t UncompressedSize) {
+  llvm_unreachable("zstd::uncompress is unavailable");
+}
+#endif
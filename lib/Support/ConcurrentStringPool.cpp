@@ -0,0 +1,69 @@
+//===- ConcurrentStringPool.cpp - Concurrent string table -----------------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Support/ConcurrentStringPool.h"
+#include "llvm/ADT/Hashing.h"
+#include "llvm/ADT/STLExtras.h"
+#include <cassert>
+
+using namespace llvm;
+
+const uint64_t ConcurrentStringPool::NotAdded;
+
+ConcurrentStringPool::Shard &ConcurrentStringPool::getShard(StringRef S) {
+  // StringMap hashes the low bits itself, so pick the shard from the high
+  // bits of an independent hash.
+  uint64_t Hash = hash_value(S);
+  return Shards[(Hash >> 32) % NumShards];
+}
+
+StringRef ConcurrentStringPool::intern(StringRef S) {
+  Shard &Sh = getShard(S);
+  std::lock_guard<std::mutex> Lock(Sh.Mutex);
+  return Sh.Strings.insert(std::make_pair(S, EntryValue(NotAdded)))
+      .first->getKey();
+}
+
+const ConcurrentStringPool::Entry &ConcurrentStringPool::add(StringRef S,
+                                                             uint64_t Key) {
+  assert(!IsFinalized && "Adding to a finalized string pool");
+  assert(Key != NotAdded && "Reserved order key");
+  Shard &Sh = getShard(S);
+  std::lock_guard<std::mutex> Lock(Sh.Mutex);
+  Entry &E = *Sh.Strings.insert(std::make_pair(S, EntryValue(Key))).first;
+  if (Key < E.getValue().Key)
+    E.getValue().Key = Key;
+  return E;
+}
+
+uint64_t ConcurrentStringPool::finalize() {
+  assert(!IsFinalized && "String pool finalized twice");
+  IsFinalized = true;
+  std::vector<Entry *> Added;
+  for (Shard &Sh : Shards)
+    for (Entry &E : Sh.Strings)
+      if (E.getValue().Key != NotAdded)
+        Added.push_back(&E);
+
+  // Ties only arise if a client uses one key for several strings; break them
+  // by content so that the layout stays independent of the hashing.
+  llvm::sort(Added, [](const Entry *A, const Entry *B) {
+    if (A->getValue().Key != B->getValue().Key)
+      return A->getValue().Key < B->getValue().Key;
+    return A->getKey() < B->getKey();
+  });
+
+  uint64_t Offset = 0;
+  for (Entry *E : Added) {
+    E->getValue().Offset = Offset;
+    Offset += E->getKeyLength() + 1;
+  }
+  Finalized.assign(Added.begin(), Added.end());
+  return Offset;
+}
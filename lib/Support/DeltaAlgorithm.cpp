@@ -7,6 +7,7 @@
 //===----------------------------------------------------------------------===//
 
 #include "llvm/ADT/DeltaAlgorithm.h"
+#include "llvm/Support/ThreadPool.h"
 #include <algorithm>
 #include <iterator>
 #include <set>
@@ -16,13 +17,12 @@ DeltaAlgorithm::~DeltaAlgorithm() {
 }
 
 bool DeltaAlgorithm::GetTestResult(const changeset_ty &Changes) {
-  if (FailedTestsCache.count(Changes))
-    return false;
+  auto It = TestResultCache.find(Changes);
+  if (It != TestResultCache.end())
+    return It->second;
 
   bool Result = ExecuteOneTest(Changes);
-  if (!Result)
-    FailedTestsCache.insert(Changes);
-
+  TestResultCache.insert(std::make_pair(Changes, Result));
   return Result;
 }
 
@@ -67,10 +67,62 @@ DeltaAlgorithm::Delta(const changeset_ty &Changes,
   return Delta(Changes, SplitSets);
 }
 
+void DeltaAlgorithm::Speculate(const changeset_ty &Changes,
+                               const changesetlist_ty &Sets) {
+  // Collect the subsets and complements that Search tests, in the order it
+  // tests them. While that leaves threads idle, add those of the partition
+  // that Delta tries next if none of them passes. Its sets are also the
+  // halves that Delta tries first if a subset passes.
+  changesetlist_ty Candidates, Level = Sets;
+  std::set<changeset_ty> Seen;
+  auto AddCandidate = [&](changeset_ty S) {
+    if (!TestResultCache.count(S) && Seen.insert(S).second)
+      Candidates.push_back(std::move(S));
+  };
+  while (Candidates.size() < ThreadCount) {
+    for (const changeset_ty &S : Level) {
+      AddCandidate(S);
+      if (Level.size() > 2) {
+        changeset_ty Complement;
+        std::set_difference(
+          Changes.begin(), Changes.end(), S.begin(), S.end(),
+          std::insert_iterator<changeset_ty>(Complement, Complement.begin()));
+        AddCandidate(std::move(Complement));
+      }
+    }
+
+    changesetlist_ty SplitSets;
+    for (const changeset_ty &S : Level)
+      Split(S, SplitSets);
+    if (SplitSets.size() == Level.size())
+      break;
+    Level = std::move(SplitSets);
+  }
+
+  if (Candidates.size() <= 1)
+    return;
+
+  // The tests only write their own result; the cache is updated afterwards.
+  std::vector<char> Results(Candidates.size());
+  {
+    ThreadPool Pool(std::min<size_t>(ThreadCount, Candidates.size()));
+    for (size_t I = 0, E = Candidates.size(); I != E; ++I)
+      Pool.async([this, &Candidates, &Results, I]() {
+        Results[I] = ExecuteOneTest(Candidates[I]);
+      });
+    Pool.wait();
+  }
+  for (size_t I = 0, E = Candidates.size(); I != E; ++I)
+    TestResultCache.insert(std::make_pair(std::move(Candidates[I]),
+                                          Results[I] != 0));
+}
+
 bool DeltaAlgorithm::Search(const changeset_ty &Changes,
                             const changesetlist_ty &Sets,
                             changeset_ty &Res) {
-  // FIXME: Parallelize.
+  if (ThreadCount > 1)
+    Speculate(Changes, Sets);
+
   for (changesetlist_ty::const_iterator it = Sets.begin(),
          ie = Sets.end(); it != ie; ++it) {
     // If the test passes on this subset alone, recurse.
@@ -62,6 +62,7 @@ bool FileCheckPattern::ParsePattern(StringRef PatternStr, StringRef Prefix,
 
   if (CheckTy == Check::CheckEmpty) {
     RegExStr = "(\n$)";
+    CompiledRegEx = std::make_shared<Regex>(RegExStr, Regex::Newline);
     return false;
   }
 
@@ -79,6 +80,11 @@ bool FileCheckPattern::ParsePattern(StringRef PatternStr, StringRef Prefix,
       RegExStr += " *";
   }
 
+  // Remember the fixed text that the pattern starts with, if any, to find the
+  // lines that it can match on.
+  LiteralPrefix = PatternStr.substr(
+      0, std::min(PatternStr.find("{{"), PatternStr.find("[[")));
+
   // Paren value #0 is for the fully matched string.  Any new parenthesized
   // values add from there.
   unsigned CurParen = 1;
@@ -220,6 +226,10 @@ bool FileCheckPattern::ParsePattern(StringRef PatternStr, StringRef Prefix,
     RegExStr += '$';
   }
 
+  // Compile the regex once, unless it depends on the values of variables.
+  if (VariableUses.empty())
+    CompiledRegEx = std::make_shared<Regex>(RegExStr, Regex::Newline);
+
   return false;
 }
 
@@ -288,45 +298,64 @@ size_t FileCheckPattern::Match(StringRef Buffer, size_t &MatchLen,
 
   // Regex match.
 
-  // If there are variable uses, we need to create a temporary string with the
-  // actual value.
-  StringRef RegExToMatch = RegExStr;
-  std::string TmpStr;
-  if (!VariableUses.empty()) {
-    TmpStr = RegExStr;
+  // A match starts on a line where the literal prefix occurs, so skip the
+  // lines before the first occurrence without running the regex on them.
+  StringRef SearchBuffer = Buffer;
+  if (!LiteralPrefix.empty()) {
+    size_t PrefixPos = Buffer.find(LiteralPrefix);
+    if (PrefixPos == StringRef::npos)
+      return StringRef::npos;
+    size_t LineEnd = Buffer.rfind('\n', PrefixPos);
+    if (LineEnd != StringRef::npos)
+      SearchBuffer = Buffer.substr(LineEnd + 1);
+  }
 
-    unsigned InsertOffset = 0;
-    for (const auto &VariableUse : VariableUses) {
-      std::string Value;
+  SmallVector<StringRef, 4> MatchInfo;
+  if (CompiledRegEx) {
+    if (!CompiledRegEx->match(SearchBuffer, &MatchInfo))
+      return StringRef::npos;
+    return MatchSucceeded(Buffer, MatchInfo, MatchLen, VariableTable);
+  }
 
-      if (VariableUse.first[0] == '@') {
-        if (!EvaluateExpression(VariableUse.first, Value))
-          return StringRef::npos;
-      } else {
-        StringMap<StringRef>::iterator it =
-            VariableTable.find(VariableUse.first);
-        // If the variable is undefined, return an error.
-        if (it == VariableTable.end())
-          return StringRef::npos;
+  // The pattern uses variables: create a temporary string with their actual
+  // values.
+  std::string TmpStr = RegExStr;
 
-        // Look up the value and escape it so that we can put it into the regex.
-        Value += Regex::escape(it->second);
-      }
+  unsigned InsertOffset = 0;
+  for (const auto &VariableUse : VariableUses) {
+    std::string Value;
 
-      // Plop it into the regex at the adjusted offset.
-      TmpStr.insert(TmpStr.begin() + VariableUse.second + InsertOffset,
-                    Value.begin(), Value.end());
-      InsertOffset += Value.size();
+    if (VariableUse.first[0] == '@') {
+      if (!EvaluateExpression(VariableUse.first, Value))
+        return StringRef::npos;
+    } else {
+      StringMap<StringRef>::iterator it =
+          VariableTable.find(VariableUse.first);
+      // If the variable is undefined, return an error.
+      if (it == VariableTable.end())
+        return StringRef::npos;
+
+      // Look up the value and escape it so that we can put it into the regex.
+      Value += Regex::escape(it->second);
     }
 
-    // Match the newly constructed regex.
-    RegExToMatch = TmpStr;
+    // Plop it into the regex at the adjusted offset.
+    TmpStr.insert(TmpStr.begin() + VariableUse.second + InsertOffset,
+                  Value.begin(), Value.end());
+    InsertOffset += Value.size();
   }
 
-  SmallVector<StringRef, 4> MatchInfo;
-  if (!Regex(RegExToMatch, Regex::Newline).match(Buffer, &MatchInfo))
+  // Match the newly constructed regex.
+  if (!Regex(TmpStr, Regex::Newline).match(SearchBuffer, &MatchInfo))
     return StringRef::npos;
+  return MatchSucceeded(Buffer, MatchInfo, MatchLen, VariableTable);
+}
 
+size_t
+FileCheckPattern::MatchSucceeded(StringRef Buffer,
+                                 ArrayRef<StringRef> MatchInfo,
+                                 size_t &MatchLen,
+                                 StringMap<StringRef> &VariableTable) const {
   // Successful regex match.
   assert(!MatchInfo.empty() && "Didn't get any match");
   StringRef FullMatch = MatchInfo[0];
@@ -674,6 +703,63 @@ static size_t SkipWord(StringRef Str, size_t Loc) {
   return Loc;
 }
 
+namespace {
+/// Finds the first (longest) check prefix in the check file.
+///
+/// The prefixes are words, so rather than running the prefix regular
+/// expression on the rest of the file for every check, each prefix is found
+/// with StringRef::find. The next occurrence of each prefix is remembered
+/// until the buffer moves past it, as the buffer only ever moves forward.
+class PrefixMatcher {
+  Regex &PrefixRE;
+  ArrayRef<std::string> Prefixes;
+  /// The next occurrence of each prefix, or the end of the buffer if there is
+  /// none, or null if it has not been searched for.
+  std::vector<const char *> NextOccurrence;
+  const char *BufferEnd = nullptr;
+
+public:
+  PrefixMatcher(Regex &PrefixRE, ArrayRef<std::string> Prefixes)
+      : PrefixRE(PrefixRE), Prefixes(Prefixes),
+        NextOccurrence(Prefixes.size()) {}
+
+  /// Returns the first occurrence of a prefix in \p Buffer, or an empty
+  /// StringRef if there is none.
+  StringRef match(StringRef Buffer);
+};
+} // end anonymous namespace
+
+StringRef PrefixMatcher::match(StringRef Buffer) {
+  // Without a list of the prefixes, fall back to the regular expression.
+  if (Prefixes.empty()) {
+    SmallVector<StringRef, 2> Matches;
+    if (!PrefixRE.match(Buffer, &Matches))
+      return StringRef();
+    return Matches[0];
+  }
+
+  if (Buffer.end() != BufferEnd) {
+    std::fill(NextOccurrence.begin(), NextOccurrence.end(), nullptr);
+    BufferEnd = Buffer.end();
+  }
+
+  StringRef First;
+  for (size_t I = 0, E = Prefixes.size(); I != E; ++I) {
+    const char *&Next = NextOccurrence[I];
+    if (!Next || Next < Buffer.begin()) {
+      size_t Loc = Buffer.find(Prefixes[I]);
+      Next = Loc == StringRef::npos ? Buffer.end() : Buffer.begin() + Loc;
+    }
+    if (Next == Buffer.end())
+      continue;
+    // Like the regular expression, prefer the first match, then the longest.
+    if (First.empty() || Next < First.begin() ||
+        (Next == First.begin() && Prefixes[I].size() > First.size()))
+      First = StringRef(Next, Prefixes[I].size());
+  }
+  return First;
+}
+
 /// Search the buffer for the first prefix in the prefix regular expression.
 ///
 /// This searches the buffer using the provided regular expression, however it
@@ -698,19 +784,15 @@ static size_t SkipWord(StringRef Str, size_t Loc) {
 /// If no valid prefix is found, the state of Buffer, LineNumber, and CheckTy
 /// is unspecified.
 static std::pair<StringRef, StringRef>
-FindFirstMatchingPrefix(Regex &PrefixRE, StringRef &Buffer,
+FindFirstMatchingPrefix(PrefixMatcher &Matcher, StringRef &Buffer,
                         unsigned &LineNumber, Check::FileCheckType &CheckTy) {
-  SmallVector<StringRef, 2> Matches;
-
   while (!Buffer.empty()) {
-    // Find the first (longest) match using the RE.
-    if (!PrefixRE.match(Buffer, &Matches))
+    // Find the first (longest) match.
+    StringRef Prefix = Matcher.match(Buffer);
+    if (Prefix.empty())
       // No match at all, bail.
       return {StringRef(), StringRef()};
 
-    StringRef Prefix = Matches[0];
-    Matches.clear();
-
     assert(Prefix.data() >= Buffer.data() &&
            Prefix.data() < Buffer.data() + Buffer.size() &&
            "Prefix doesn't start inside of buffer!");
@@ -771,6 +853,8 @@ bool llvm::FileCheck::ReadCheckFile(SourceMgr &SM, StringRef Buffer,
 
   std::vector<FileCheckPattern> DagNotMatches = ImplicitNegativeChecks;
 
+  PrefixMatcher Matcher(PrefixRE, Req.CheckPrefixes);
+
   // LineNumber keeps track of the line on which CheckPrefix instances are
   // found.
   unsigned LineNumber = 1;
@@ -782,7 +866,7 @@ bool llvm::FileCheck::ReadCheckFile(SourceMgr &SM, StringRef Buffer,
     StringRef UsedPrefix;
     StringRef AfterSuffix;
     std::tie(UsedPrefix, AfterSuffix) =
-        FindFirstMatchingPrefix(PrefixRE, Buffer, LineNumber, CheckTy);
+        FindFirstMatchingPrefix(Matcher, Buffer, LineNumber, CheckTy);
     if (UsedPrefix.empty())
       break;
     assert(UsedPrefix.data() == Buffer.data() &&
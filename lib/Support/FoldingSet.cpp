@@ -179,6 +179,38 @@ FoldingSetNodeID::Intern(BumpPtrAllocator &Allocator) const {
   return FoldingSetNodeIDRef(New, Bits.size());
 }
 
+//===----------------------------------------------------------------------===//
+// FoldingSetHashBuilder Implementation
+
+// MixBlock - Hash the current block, which is full, and make it the previous
+// block.  The first block can only be hashed once it is known that more data
+// follows, because hash_combine_range hashes up to 64 bytes differently.
+void FoldingSetHashBuilder::MixBlock() {
+  const char *Block = reinterpret_cast<const char *>(Buffer + WordsPerBlock);
+  if (NumBlocks == 0)
+    State = hashing::detail::hash_state::create(
+        Block, hashing::detail::get_execution_seed());
+  else
+    State.mix(Block);
+  ++NumBlocks;
+  memcpy(Buffer, Buffer + WordsPerBlock, sizeof(unsigned) * WordsPerBlock);
+  NumWords = 0;
+}
+
+unsigned FoldingSetHashBuilder::ComputeHash() const {
+  size_t Length = (NumBlocks * WordsPerBlock + NumWords) * sizeof(unsigned);
+  const unsigned *End = Buffer + WordsPerBlock + NumWords;
+  if (NumBlocks == 0)
+    return static_cast<unsigned>(hashing::detail::hash_short(
+        reinterpret_cast<const char *>(Buffer + WordsPerBlock), Length,
+        hashing::detail::get_execution_seed()));
+  // Like hash_combine_range, hash the last 64 bytes if the data doesn't end
+  // on a block boundary, which overlap the previous block.
+  hashing::detail::hash_state FinalState = State;
+  FinalState.mix(reinterpret_cast<const char *>(End - WordsPerBlock));
+  return static_cast<unsigned>(FinalState.finalize(Length));
+}
+
 //===----------------------------------------------------------------------===//
 /// Helper functions for FoldingSetBase.
 
@@ -289,11 +321,10 @@ void FoldingSetBase::GrowBucketCount(unsigned NewBucketCount) {
       Probe = NodeInBucket->getNextInBucket();
       NodeInBucket->SetNextInBucket(nullptr);
 
-      // Insert the node into the new bucket, after recomputing the hash.
-      InsertNode(NodeInBucket,
-                 GetBucketFor(ComputeNodeHash(NodeInBucket, TempID),
-                              Buckets, NumBuckets));
-      TempID.clear();
+      // Insert the node into the new bucket.
+      InsertNodeImpl(NodeInBucket,
+                     GetBucketFor(GetCachedNodeHash(NodeInBucket, TempID),
+                                  Buckets, NumBuckets));
     }
   }
 
@@ -322,6 +353,20 @@ FoldingSetBase::Node *
 FoldingSetBase::FindNodeOrInsertPos(const FoldingSetNodeID &ID,
                                     void *&InsertPos) {
   unsigned IDHash = ID.ComputeHash();
+  FoldingSetNodeID TempID;
+  return FindNodeOrInsertPos(IDHash,
+                             [&](Node *N) {
+                               bool Equal = NodeEquals(N, ID, IDHash, TempID);
+                               TempID.clear();
+                               return Equal;
+                             },
+                             InsertPos);
+}
+
+FoldingSetBase::Node *
+FoldingSetBase::FindNodeOrInsertPos(unsigned IDHash,
+                                    function_ref<bool(Node *)> Equals,
+                                    void *&InsertPos) {
   void **Bucket = GetBucketFor(IDHash, Buckets, NumBuckets);
   void *Probe = *Bucket;
 
@@ -329,9 +374,9 @@ FoldingSetBase::FindNodeOrInsertPos(const FoldingSetNodeID &ID,
 
   FoldingSetNodeID TempID;
   while (Node *NodeInBucket = GetNextPtr(Probe)) {
-    if (NodeEquals(NodeInBucket, ID, IDHash, TempID))
+    if (GetCachedNodeHash(NodeInBucket, TempID) == IDHash &&
+        Equals(NodeInBucket))
       return NodeInBucket;
-    TempID.clear();
 
     Probe = NodeInBucket->getNextInBucket();
   }
@@ -345,12 +390,35 @@ FoldingSetBase::FindNodeOrInsertPos(const FoldingSetNodeID &ID,
 /// is not already in the map.  InsertPos must be obtained from
 /// FindNodeOrInsertPos.
 void FoldingSetBase::InsertNode(Node *N, void *InsertPos) {
+  // The node may have been profiled differently in another folding set.
+  N->HasCachedHash = false;
+  InsertNodeImpl(N, InsertPos);
+}
+
+void FoldingSetBase::InsertNode(Node *N, void *InsertPos, unsigned Hash) {
+  N->CachedHash = Hash;
+  N->HasCachedHash = true;
+  InsertNodeImpl(N, InsertPos);
+}
+
+unsigned FoldingSetBase::GetCachedNodeHash(Node *N,
+                                           FoldingSetNodeID &TempID) const {
+  if (!N->HasCachedHash) {
+    N->CachedHash = ComputeNodeHash(N, TempID);
+    N->HasCachedHash = true;
+    TempID.clear();
+  }
+  return N->CachedHash;
+}
+
+void FoldingSetBase::InsertNodeImpl(Node *N, void *InsertPos) {
   assert(!N->getNextInBucket());
   // Do we need to grow the hashtable?
   if (NumNodes+1 > capacity()) {
     GrowHashTable();
     FoldingSetNodeID TempID;
-    InsertPos = GetBucketFor(ComputeNodeHash(N, TempID), Buckets, NumBuckets);
+    InsertPos =
+        GetBucketFor(GetCachedNodeHash(N, TempID), Buckets, NumBuckets);
   }
 
   ++NumNodes;
@@ -417,10 +485,19 @@ bool FoldingSetBase::RemoveNode(Node *N) {
 FoldingSetBase::Node *FoldingSetBase::GetOrInsertNode(FoldingSetBase::Node *N) {
   FoldingSetNodeID ID;
   GetNodeProfile(N, ID);
+  unsigned IDHash = ID.ComputeHash();
+  FoldingSetNodeID TempID;
   void *IP;
-  if (Node *E = FindNodeOrInsertPos(ID, IP))
+  if (Node *E = FindNodeOrInsertPos(IDHash,
+                                    [&](Node *M) {
+                                      bool Equal =
+                                          NodeEquals(M, ID, IDHash, TempID);
+                                      TempID.clear();
+                                      return Equal;
+                                    },
+                                    IP))
     return E;
-  InsertNode(N, IP);
+  InsertNode(N, IP, IDHash);
   return N;
 }
 
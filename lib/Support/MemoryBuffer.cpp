@@ -18,13 +18,17 @@
 #include "llvm/Support/Errno.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/MathExtras.h"
+#include "llvm/Support/Memory.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/Process.h"
 #include "llvm/Support/Program.h"
 #include "llvm/Support/SmallVectorMemoryBuffer.h"
+#include "llvm/Support/ThreadPool.h"
+#include <algorithm>
 #include <cassert>
 #include <cerrno>
 #include <cstring>
+#include <iterator>
 #include <new>
 #include <sys/types.h>
 #include <system_error>
@@ -107,7 +111,8 @@ public:
 template <typename MB>
 static ErrorOr<std::unique_ptr<MB>>
 getFileAux(const Twine &Filename, int64_t FileSize, uint64_t MapSize,
-           uint64_t Offset, bool RequiresNullTerminator, bool IsVolatile);
+           uint64_t Offset, bool RequiresNullTerminator, bool IsVolatile,
+           unsigned Hints = sys::fs::AH_None);
 
 std::unique_ptr<MemoryBuffer>
 MemoryBuffer::getMemBuffer(StringRef InputData, StringRef BufferName,
@@ -184,12 +189,16 @@ class MemoryBufferMMapFile : public MB {
 
 public:
   MemoryBufferMMapFile(bool RequiresNullTerminator, int FD, uint64_t Len,
-                       uint64_t Offset, std::error_code &EC)
+                       uint64_t Offset, std::error_code &EC,
+                       unsigned Hints = sys::fs::AH_None)
       : MFR(FD, MB::Mapmode, getLegalMapSize(Len, Offset),
             getLegalMapOffset(Offset), EC) {
     if (!EC) {
       const char *Start = getStart(Len, Offset);
       MemoryBuffer::init(Start, Start + Len, RequiresNullTerminator);
+      // The hints are only advice, so failing to pass them on is fine.
+      if (Hints != sys::fs::AH_None)
+        (void)MFR.advise(Hints);
     }
   }
 
@@ -228,21 +237,54 @@ getMemoryBufferForStream(int FD, const Twine &BufferName) {
 
 ErrorOr<std::unique_ptr<MemoryBuffer>>
 MemoryBuffer::getFile(const Twine &Filename, int64_t FileSize,
-                      bool RequiresNullTerminator, bool IsVolatile) {
+                      bool RequiresNullTerminator, bool IsVolatile,
+                      unsigned Hints) {
   return getFileAux<MemoryBuffer>(Filename, FileSize, FileSize, 0,
-                                  RequiresNullTerminator, IsVolatile);
+                                  RequiresNullTerminator, IsVolatile, Hints);
+}
+
+std::vector<ErrorOr<std::unique_ptr<MemoryBuffer>>>
+MemoryBuffer::getFiles(ArrayRef<StringRef> Filenames,
+                       bool RequiresNullTerminator, unsigned Hints,
+                       unsigned NumThreads) {
+  // ErrorOr cannot be copied, and std::vector would copy it on reallocation
+  // since its move constructor is not noexcept, so fill a SmallVector first.
+  SmallVector<ErrorOr<std::unique_ptr<MemoryBuffer>>, 0> Results;
+  Results.reserve(Filenames.size());
+  for (size_t I = 0, E = Filenames.size(); I != E; ++I)
+    Results.push_back(std::error_code());
+
+  auto Read = [&](size_t I) {
+    Results[I] =
+        getFile(Filenames[I], -1, RequiresNullTerminator, false, Hints);
+  };
+  NumThreads = std::min<size_t>(NumThreads, Filenames.size());
+  if (NumThreads <= 1) {
+    for (size_t I = 0, E = Filenames.size(); I != E; ++I)
+      Read(I);
+  } else {
+    // Each task writes a different element of Results, which does not move.
+    ThreadPool Pool(NumThreads);
+    for (size_t I = 0, E = Filenames.size(); I != E; ++I)
+      Pool.async(Read, I);
+    Pool.wait();
+  }
+  return std::vector<ErrorOr<std::unique_ptr<MemoryBuffer>>>(
+      std::make_move_iterator(Results.begin()),
+      std::make_move_iterator(Results.end()));
 }
 
 template <typename MB>
 static ErrorOr<std::unique_ptr<MB>>
 getOpenFileImpl(int FD, const Twine &Filename, uint64_t FileSize,
                 uint64_t MapSize, int64_t Offset, bool RequiresNullTerminator,
-                bool IsVolatile);
+                bool IsVolatile, unsigned Hints);
 
 template <typename MB>
 static ErrorOr<std::unique_ptr<MB>>
 getFileAux(const Twine &Filename, int64_t FileSize, uint64_t MapSize,
-           uint64_t Offset, bool RequiresNullTerminator, bool IsVolatile) {
+           uint64_t Offset, bool RequiresNullTerminator, bool IsVolatile,
+           unsigned Hints) {
   int FD;
   std::error_code EC = sys::fs::openFileForRead(Filename, FD, sys::fs::OF_None);
 
@@ -250,7 +292,7 @@ getFileAux(const Twine &Filename, int64_t FileSize, uint64_t MapSize,
     return EC;
 
   auto Ret = getOpenFileImpl<MB>(FD, Filename, FileSize, MapSize, Offset,
-                                 RequiresNullTerminator, IsVolatile);
+                                 RequiresNullTerminator, IsVolatile, Hints);
   close(FD);
   return Ret;
 }
@@ -417,7 +459,7 @@ template <typename MB>
 static ErrorOr<std::unique_ptr<MB>>
 getOpenFileImpl(int FD, const Twine &Filename, uint64_t FileSize,
                 uint64_t MapSize, int64_t Offset, bool RequiresNullTerminator,
-                bool IsVolatile) {
+                bool IsVolatile, unsigned Hints) {
   static int PageSize = sys::Process::getPageSize();
 
   // Default is to map the full file.
@@ -443,12 +485,15 @@ getOpenFileImpl(int FD, const Twine &Filename, uint64_t FileSize,
     MapSize = FileSize;
   }
 
-  if (shouldUseMmap(FD, FileSize, MapSize, Offset, RequiresNullTerminator,
+  // Most file systems cannot back their page cache with huge pages, so a
+  // buffer that should use huge pages is read into anonymous memory instead.
+  if (!(Hints & sys::fs::AH_HugePages) &&
+      shouldUseMmap(FD, FileSize, MapSize, Offset, RequiresNullTerminator,
                     PageSize, IsVolatile)) {
     std::error_code EC;
     std::unique_ptr<MB> Result(
         new (NamedBufferAlloc(Filename)) MemoryBufferMMapFile<MB>(
-            RequiresNullTerminator, FD, MapSize, Offset, EC));
+            RequiresNullTerminator, FD, MapSize, Offset, EC, Hints));
     if (!EC)
       return std::move(Result);
   }
@@ -462,6 +507,13 @@ getOpenFileImpl(int FD, const Twine &Filename, uint64_t FileSize,
 
   char *BufPtr = Buf.get()->getBufferStart();
 
+  // The hints must be given before the reads fault the buffer in and start
+  // reading ahead. They are only advice, so failing to pass them on is fine.
+  if (Hints & sys::fs::AH_HugePages)
+    sys::Memory::adviseHugePages(BufPtr, MapSize);
+  if (Hints != sys::fs::AH_None)
+    (void)sys::fs::adviseFile(FD, Offset, MapSize, Hints);
+
   size_t BytesLeft = MapSize;
 #ifndef HAVE_PREAD
   if (lseek(FD, Offset, SEEK_SET) == -1)
@@ -492,9 +544,10 @@ getOpenFileImpl(int FD, const Twine &Filename, uint64_t FileSize,
 
 ErrorOr<std::unique_ptr<MemoryBuffer>>
 MemoryBuffer::getOpenFile(int FD, const Twine &Filename, uint64_t FileSize,
-                          bool RequiresNullTerminator, bool IsVolatile) {
+                          bool RequiresNullTerminator, bool IsVolatile,
+                          unsigned Hints) {
   return getOpenFileImpl<MemoryBuffer>(FD, Filename, FileSize, FileSize, 0,
-                         RequiresNullTerminator, IsVolatile);
+                         RequiresNullTerminator, IsVolatile, Hints);
 }
 
 ErrorOr<std::unique_ptr<MemoryBuffer>>
@@ -502,7 +555,7 @@ MemoryBuffer::getOpenFileSlice(int FD, const Twine &Filename, uint64_t MapSize,
                                int64_t Offset, bool IsVolatile) {
   assert(MapSize != uint64_t(-1));
   return getOpenFileImpl<MemoryBuffer>(FD, Filename, -1, MapSize, Offset, false,
-                                       IsVolatile);
+                                       IsVolatile, sys::fs::AH_None);
 }
 
 ErrorOr<std::unique_ptr<MemoryBuffer>> MemoryBuffer::getSTDIN() {
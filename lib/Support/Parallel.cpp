@@ -12,11 +12,14 @@
 
 #if LLVM_ENABLE_THREADS
 
+#include "llvm/Support/Compiler.h"
 #include "llvm/Support/Threading.h"
 
 #include <atomic>
-#include <stack>
+#include <deque>
+#include <memory>
 #include <thread>
+#include <vector>
 
 using namespace llvm;
 
@@ -27,6 +30,8 @@ class Executor {
 public:
   virtual ~Executor() = default;
   virtual void add(std::function<void()> func) = 0;
+  /// Blocks until \p L is done.
+  virtual void wait(const parallel::detail::Latch &L) { L.sync(); }
 
   static Executor *getDefaultExecutor();
 };
@@ -59,19 +64,29 @@ Executor *Executor::getDefaultExecutor() {
 }
 
 #else
-/// An implementation of an Executor that runs closures on a thread pool
-///   in filo order.
+/// An implementation of an Executor that runs closures on a thread pool with
+/// work stealing.
+///
+/// Every worker has its own queue. Tasks added by a worker go to the back of
+/// its own queue and are run from there in filo order, while idle workers
+/// steal from the front of the other queues, which holds the oldest and
+/// usually largest tasks. Tasks added from outside the pool are spread over
+/// the queues round-robin. A worker that waits for a TaskGroup keeps running
+/// tasks until the group is done, so nested parallel algorithms can neither
+/// deadlock nor leave cores idle.
 class ThreadPoolExecutor : public Executor {
 public:
   explicit ThreadPoolExecutor(unsigned ThreadCount = hardware_concurrency())
       : Done(ThreadCount) {
+    for (unsigned I = 0; I < ThreadCount; ++I)
+      Queues.emplace_back(new WorkQueue);
     // Spawn all but one of the threads in another thread as spawning threads
     // can take a while.
     std::thread([&, ThreadCount] {
-      for (size_t i = 1; i < ThreadCount; ++i) {
-        std::thread([=] { work(); }).detach();
+      for (unsigned I = 1; I < ThreadCount; ++I) {
+        std::thread([=] { work(I); }).detach();
       }
-      work();
+      work(0);
     }).detach();
   }
 
@@ -84,34 +99,108 @@ public:
   }
 
   void add(std::function<void()> F) override {
-    std::unique_lock<std::mutex> Lock(Mutex);
-    WorkStack.push(F);
-    Lock.unlock();
-    Cond.notify_one();
+    unsigned Index = CurrentWorker != NoWorker
+                         ? CurrentWorker
+                         : NextQueue.fetch_add(1, std::memory_order_relaxed) %
+                               Queues.size();
+    // Pairs with the increment of NumSleeping in work(): either a worker about
+    // to sleep sees this task, or we see the worker and wake it up.
+    ++NumQueued;
+    {
+      WorkQueue &Q = *Queues[Index];
+      std::lock_guard<std::mutex> Lock(Q.Mutex);
+      Q.Tasks.push_back(std::move(F));
+    }
+    if (NumSleeping > 0) {
+      std::lock_guard<std::mutex> Lock(Mutex);
+      Cond.notify_one();
+    }
+  }
+
+  void wait(const parallel::detail::Latch &L) override {
+    if (CurrentWorker == NoWorker)
+      return L.sync();
+    while (!L.isDone())
+      if (!runTask(CurrentWorker))
+        std::this_thread::yield();
   }
 
 private:
-  void work() {
-    while (true) {
+  struct WorkQueue {
+    std::mutex Mutex;
+    std::deque<std::function<void()>> Tasks;
+  };
+
+  /// The index of the worker running on this thread, if any.
+  static constexpr unsigned NoWorker = ~0U;
+  static LLVM_THREAD_LOCAL unsigned CurrentWorker;
+
+  /// Pops a task from the back of queue \p Self or, if it is empty, steals
+  /// one from the front of another queue, and runs it. Returns false if there
+  /// was no task to run.
+  bool runTask(unsigned Self) {
+    std::function<void()> Task;
+    if (!popTask(Self, Task))
+      return false;
+    Task();
+    return true;
+  }
+
+  bool popTask(unsigned Self, std::function<void()> &Task) {
+    if (NumQueued == 0)
+      return false;
+    {
+      WorkQueue &Q = *Queues[Self];
+      std::lock_guard<std::mutex> Lock(Q.Mutex);
+      if (!Q.Tasks.empty()) {
+        Task = std::move(Q.Tasks.back());
+        Q.Tasks.pop_back();
+        --NumQueued;
+        return true;
+      }
+    }
+    for (size_t I = 1, E = Queues.size(); I < E; ++I) {
+      WorkQueue &Q = *Queues[(Self + I) % E];
+      std::lock_guard<std::mutex> Lock(Q.Mutex);
+      if (!Q.Tasks.empty()) {
+        Task = std::move(Q.Tasks.front());
+        Q.Tasks.pop_front();
+        --NumQueued;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void work(unsigned Self) {
+    CurrentWorker = Self;
+    while (!Stop) {
+      if (runTask(Self))
+        continue;
       std::unique_lock<std::mutex> Lock(Mutex);
-      Cond.wait(Lock, [&] { return Stop || !WorkStack.empty(); });
-      if (Stop)
-        break;
-      auto Task = WorkStack.top();
-      WorkStack.pop();
-      Lock.unlock();
-      Task();
+      ++NumSleeping;
+      Cond.wait(Lock, [&] { return Stop || NumQueued > 0; });
+      --NumSleeping;
     }
+    CurrentWorker = NoWorker;
     Done.dec();
   }
 
   std::atomic<bool> Stop{false};
-  std::stack<std::function<void()>> WorkStack;
+  std::vector<std::unique_ptr<WorkQueue>> Queues;
+  std::atomic<unsigned> NextQueue{0};
+  /// The number of tasks in all the queues.
+  std::atomic<size_t> NumQueued{0};
+  /// The number of workers waiting on Cond for tasks.
+  std::atomic<unsigned> NumSleeping{0};
   std::mutex Mutex;
   std::condition_variable Cond;
   parallel::detail::Latch Done;
 };
 
+LLVM_THREAD_LOCAL unsigned ThreadPoolExecutor::CurrentWorker =
+    ThreadPoolExecutor::NoWorker;
+
 Executor *Executor::getDefaultExecutor() {
   static ThreadPoolExecutor exec;
   return &exec;
@@ -126,4 +215,8 @@ void parallel::detail::TaskGroup::spawn(std::function<void()> F) {
     L.dec();
   });
 }
+
+void parallel::detail::TaskGroup::sync() const {
+  Executor::getDefaultExecutor()->wait(L);
+}
 #endif // LLVM_ENABLE_THREADS
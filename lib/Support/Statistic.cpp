@@ -27,6 +27,7 @@
 #include "llvm/Support/Compiler.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/Format.h"
+#include "llvm/Support/JSON.h"
 #include "llvm/Support/ManagedStatic.h"
 #include "llvm/Support/Mutex.h"
 #include "llvm/Support/Timer.h"
@@ -34,6 +35,7 @@
 #include "llvm/Support/raw_ostream.h"
 #include <algorithm>
 #include <cstring>
+#include <mutex>
 using namespace llvm;
 
 /// -stats - Command line option to cause transformations to emit stats about
@@ -89,6 +91,163 @@ public:
 static ManagedStatic<StatisticInfo> StatInfo;
 static ManagedStatic<sys::SmartMutex<true> > StatLock;
 
+//===----------------------------------------------------------------------===//
+// Per-thread counters
+//===----------------------------------------------------------------------===//
+//
+// Updating a single atomic from several threads makes its cache line bounce
+// between the cores running them, which shows in hot statistics once passes
+// run in parallel. Instead, each thread counts in counters of its own, which
+// only it writes. The first statistics to be registered get such a counter in
+// every thread, addressed by their ShardIndex; the others are updated
+// atomically in place.
+//
+// These are guarded by ShardLock rather than StatLock: a thread folds its
+// counters into the statistics when it exits, which may be after llvm_shutdown
+// has destroyed StatLock. ShardLock is taken after StatLock when both are
+// needed.
+
+namespace {
+/// The counters of one thread, allocated a chunk at a time as statistics are
+/// first updated by it.
+struct StatisticShards {
+  static const unsigned ChunkSize = 256;
+  static const unsigned NumChunks = 16;
+
+  /// Written only by the owning thread, read by any thread holding ShardLock.
+  std::atomic<std::atomic<unsigned> *> Chunks[NumChunks];
+  StatisticShards *Prev = nullptr;
+  StatisticShards *Next = nullptr;
+
+  StatisticShards() {
+    for (auto &Chunk : Chunks)
+      Chunk.store(nullptr, std::memory_order_relaxed);
+  }
+  ~StatisticShards() {
+    for (auto &Chunk : Chunks)
+      delete[] Chunk.load(std::memory_order_relaxed);
+  }
+
+  /// Return the counter at \p Index, or null if it was never updated.
+  const std::atomic<unsigned> *lookup(unsigned Index) const {
+    std::atomic<unsigned> *Chunk =
+        Chunks[Index / ChunkSize].load(std::memory_order_acquire);
+    return Chunk ? &Chunk[Index % ChunkSize] : nullptr;
+  }
+
+  /// Return the counter at \p Index. Only called by the owning thread.
+  std::atomic<unsigned> &get(unsigned Index) {
+    std::atomic<unsigned> *Chunk =
+        Chunks[Index / ChunkSize].load(std::memory_order_relaxed);
+    if (LLVM_UNLIKELY(!Chunk)) {
+      Chunk = new std::atomic<unsigned>[ChunkSize]();
+      Chunks[Index / ChunkSize].store(Chunk, std::memory_order_release);
+    }
+    return Chunk[Index % ChunkSize];
+  }
+};
+} // end anonymous namespace
+
+static const unsigned MaxShardedStatistics =
+    StatisticShards::ChunkSize * StatisticShards::NumChunks;
+
+static std::mutex ShardLock;
+/// The counters of all live threads.
+static StatisticShards *AllShards;
+/// The statistic owning each index of the counters.
+static Statistic *ShardedStatistics[MaxShardedStatistics];
+static unsigned NumShardedStatistics;
+static LLVM_THREAD_LOCAL StatisticShards *ThreadShards;
+
+/// Return the sum of the counters at \p Index in all threads. ShardLock must be
+/// held.
+static unsigned sumShards(unsigned Index) {
+  unsigned Sum = 0;
+  for (const StatisticShards *Shards = AllShards; Shards; Shards = Shards->Next)
+    if (const std::atomic<unsigned> *Counter = Shards->lookup(Index))
+      Sum += Counter->load(std::memory_order_relaxed);
+  return Sum;
+}
+
+#if LLVM_ENABLE_THREADS
+namespace {
+/// Folds the counters of a thread into the statistics when it exits.
+struct ThreadShardsReleaser {
+  ~ThreadShardsReleaser() {
+    StatisticShards *Shards = ThreadShards;
+    if (!Shards)
+      return;
+    ThreadShards = nullptr;
+    std::lock_guard<std::mutex> Lock(ShardLock);
+    for (unsigned I = 0; I != NumShardedStatistics; ++I)
+      if (const std::atomic<unsigned> *Counter = Shards->lookup(I))
+        ShardedStatistics[I]->Value.fetch_add(
+            Counter->load(std::memory_order_relaxed),
+            std::memory_order_relaxed);
+    if (Shards->Prev)
+      Shards->Prev->Next = Shards->Next;
+    else
+      AllShards = Shards->Next;
+    if (Shards->Next)
+      Shards->Next->Prev = Shards->Prev;
+    delete Shards;
+  }
+};
+} // end anonymous namespace
+
+static thread_local ThreadShardsReleaser ThreadShardsReleaserInstance;
+#endif
+
+static StatisticShards &getThreadShards() {
+  if (LLVM_LIKELY(ThreadShards))
+    return *ThreadShards;
+  auto *Shards = new StatisticShards();
+  {
+    std::lock_guard<std::mutex> Lock(ShardLock);
+    Shards->Next = AllShards;
+    if (AllShards)
+      AllShards->Prev = Shards;
+    AllShards = Shards;
+  }
+  ThreadShards = Shards;
+#if LLVM_ENABLE_THREADS
+  // Touch the releaser so that it is constructed, and destroyed on exit.
+  (void)&ThreadShardsReleaserInstance;
+#endif
+  return *Shards;
+}
+
+unsigned Statistic::getValue() const {
+  unsigned Index = ShardIndex.load(std::memory_order_relaxed);
+  if (!Index)
+    return Value.load(std::memory_order_relaxed);
+  std::lock_guard<std::mutex> Lock(ShardLock);
+  return Value.load(std::memory_order_relaxed) + sumShards(Index - 1);
+}
+
+unsigned Statistic::add(unsigned V) {
+  unsigned Index = ShardIndex.load(std::memory_order_relaxed);
+  if (!Index)
+    return Value.fetch_add(V, std::memory_order_relaxed);
+  // Only this thread writes its counter, so it needs no read-modify-write.
+  std::atomic<unsigned> &Counter = getThreadShards().get(Index - 1);
+  unsigned Old = Counter.load(std::memory_order_relaxed);
+  Counter.store(Old + V, std::memory_order_relaxed);
+  return Value.load(std::memory_order_relaxed) + Old;
+}
+
+void Statistic::setValue(unsigned V) {
+  unsigned Index = ShardIndex.load(std::memory_order_relaxed);
+  if (!Index) {
+    Value.store(V, std::memory_order_relaxed);
+    return;
+  }
+  // Offset the counters of the threads rather than writing them, which only
+  // their threads may do.
+  std::lock_guard<std::mutex> Lock(ShardLock);
+  Value.store(V - sumShards(Index - 1), std::memory_order_relaxed);
+}
+
 /// RegisterStatistic - The first time a statistic is bumped, this method is
 /// called.
 void Statistic::RegisterStatistic() {
@@ -110,6 +269,15 @@ void Statistic::RegisterStatistic() {
     if (Stats || Enabled)
       SI.addStatistic(this);
 
+    // Give the statistic per-thread counters the first time it registers.
+    if (!ShardIndex.load(std::memory_order_relaxed)) {
+      std::lock_guard<std::mutex> ShardWriter(ShardLock);
+      if (NumShardedStatistics != MaxShardedStatistics) {
+        ShardedStatistics[NumShardedStatistics] = this;
+        ShardIndex.store(++NumShardedStatistics, std::memory_order_relaxed);
+      }
+    }
+
     // Remember we have been registered.
     Initialized.store(true, std::memory_order_release);
   }
@@ -159,7 +327,7 @@ void StatisticInfo::reset() {
     // Value updates to a statistic that complete before this statement in the
     // iteration for that statistic will be lost as intended.
     Stat->Initialized = false;
-    Stat->Value = 0;
+    Stat->setValue(0);
   }
 
   // Clear the registration list and release the lock once we're done. Any
@@ -263,6 +431,15 @@ const std::vector<std::pair<StringRef, unsigned>> llvm::GetStatistics() {
   return ReturnStats;
 }
 
+json::Object llvm::GetStatisticsJSON() {
+  sys::SmartScopedLock<true> Reader(*StatLock);
+  json::Object Result;
+  for (const Statistic *Stat : StatInfo->statistics())
+    Result[(Twine(Stat->getDebugType()) + "." + Stat->getName()).str()] =
+        int64_t(Stat->getValue());
+  return Result;
+}
+
 void llvm::ResetStatistics() {
   StatInfo->reset();
 }
@@ -17,8 +17,38 @@
 #include "llvm/Support/Threading.h"
 #include "llvm/Support/raw_ostream.h"
 
+#include <algorithm>
+
 using namespace llvm;
 
+void ThreadPool::pushTask(QueuedTask Task) {
+  Tasks.push_back(std::move(Task));
+  std::push_heap(Tasks.begin(), Tasks.end());
+}
+
+ThreadPool::QueuedTask ThreadPool::popTask() {
+  std::pop_heap(Tasks.begin(), Tasks.end());
+  QueuedTask Task = std::move(Tasks.back());
+  Tasks.pop_back();
+  return Task;
+}
+
+void ThreadPool::finishTask(ThreadPoolTaskGroup *Group) {
+  if (Group)
+    --Group->Pending;
+}
+
+// Drops the tasks of cancelled groups when they are dequeued.
+static ThreadPool::TaskTy wrapGroupTask(ThreadPool::TaskTy Task,
+                                        const ThreadPoolTaskGroup *Group) {
+  if (!Group)
+    return Task;
+  return [Task, Group] {
+    if (!Group->isCancelled())
+      Task();
+  };
+}
+
 #if LLVM_ENABLE_THREADS
 
 // Default to hardware_concurrency
@@ -32,7 +62,7 @@ ThreadPool::ThreadPool(unsigned ThreadCount)
   for (unsigned ThreadID = 0; ThreadID < ThreadCount; ++ThreadID) {
     Threads.emplace_back([&] {
       while (true) {
-        PackagedTaskTy Task;
+        QueuedTask Task;
         {
           std::unique_lock<std::mutex> LockGuard(QueueLock);
           // Wait for tasks to be pushed in the queue
@@ -50,16 +80,16 @@ ThreadPool::ThreadPool(unsigned ThreadCount)
             std::unique_lock<std::mutex> LockGuard(CompletionLock);
             ++ActiveThreads;
           }
-          Task = std::move(Tasks.front());
-          Tasks.pop();
+          Task = popTask();
         }
         // Run the task we just grabbed
-        Task();
+        Task.Task();
 
         {
           // Adjust `ActiveThreads`, in case someone waits on ThreadPool::wait()
           std::unique_lock<std::mutex> LockGuard(CompletionLock);
           --ActiveThreads;
+          finishTask(Task.Group);
         }
 
         // Notify task completion, in case someone waits on ThreadPool::wait()
@@ -79,10 +109,20 @@ void ThreadPool::wait() {
                            [&] { return !ActiveThreads && Tasks.empty(); });
 }
 
-std::shared_future<void> ThreadPool::asyncImpl(TaskTy Task) {
+void ThreadPool::wait(ThreadPoolTaskGroup &Group) {
+  std::unique_lock<std::mutex> LockGuard(CompletionLock);
+  CompletionCondition.wait(LockGuard, [&] { return !Group.Pending; });
+}
+
+std::shared_future<void> ThreadPool::asyncImpl(TaskTy Task, unsigned Priority,
+                                               ThreadPoolTaskGroup *Group) {
   /// Wrap the Task in a packaged_task to return a future object.
-  PackagedTaskTy PackagedTask(std::move(Task));
+  PackagedTaskTy PackagedTask(wrapGroupTask(std::move(Task), Group));
   auto Future = PackagedTask.get_future();
+  if (Group) {
+    std::unique_lock<std::mutex> LockGuard(CompletionLock);
+    ++Group->Pending;
+  }
   {
     // Lock the queue and push the new task
     std::unique_lock<std::mutex> LockGuard(QueueLock);
@@ -90,7 +130,7 @@ std::shared_future<void> ThreadPool::asyncImpl(TaskTy Task) {
     // Don't allow enqueueing after disabling the pool
     assert(EnableFlag && "Queuing a thread during ThreadPool destruction");
 
-    Tasks.push(std::move(PackagedTask));
+    pushTask({std::move(PackagedTask), Priority, NextSequence++, Group});
   }
   QueueCondition.notify_one();
   return Future.share();
@@ -123,19 +163,33 @@ ThreadPool::ThreadPool(unsigned ThreadCount)
 void ThreadPool::wait() {
   // Sequential implementation running the tasks
   while (!Tasks.empty()) {
-    auto Task = std::move(Tasks.front());
-    Tasks.pop();
-    Task();
+    QueuedTask Task = popTask();
+    Task.Task();
+    finishTask(Task.Group);
+  }
+}
+
+void ThreadPool::wait(ThreadPoolTaskGroup &Group) {
+  // Run tasks until the ones of the group are done.
+  while (Group.Pending) {
+    QueuedTask Task = popTask();
+    Task.Task();
+    finishTask(Task.Group);
   }
 }
 
-std::shared_future<void> ThreadPool::asyncImpl(TaskTy Task) {
+std::shared_future<void> ThreadPool::asyncImpl(TaskTy Task, unsigned Priority,
+                                               ThreadPoolTaskGroup *Group) {
   // Get a Future with launch::deferred execution using std::async
-  auto Future = std::async(std::launch::deferred, std::move(Task)).share();
+  auto Future = std::async(std::launch::deferred,
+                           wrapGroupTask(std::move(Task), Group))
+                    .share();
   // Wrap the future so that both ThreadPool::wait() can operate and the
   // returned future can be sync'ed on.
   PackagedTaskTy PackagedTask([Future]() { Future.get(); });
-  Tasks.push(std::move(PackagedTask));
+  if (Group)
+    ++Group->Pending;
+  pushTask({std::move(PackagedTask), Priority, NextSequence++, Group});
   return Future;
 }
 
@@ -144,3 +198,44 @@ ThreadPool::~ThreadPool() {
 }
 
 #endif
+
+ThreadPoolTaskGraph::TaskID ThreadPoolTaskGraph::addTask(ThreadPool::TaskTy F,
+                                                        unsigned Priority) {
+  Nodes.push_back({std::move(F), Priority, 0, {}});
+  return Nodes.size() - 1;
+}
+
+void ThreadPoolTaskGraph::addDependency(TaskID Before, TaskID After) {
+  assert(Before < Nodes.size() && After < Nodes.size() && "unknown task");
+  Nodes[Before].Successors.push_back(After);
+  ++Nodes[After].NumPredecessors;
+}
+
+void ThreadPoolTaskGraph::run(ThreadPoolTaskGroup &Group) {
+  // The number of unfinished dependencies of each task. A task is submitted
+  // by the last of them to finish.
+  std::unique_ptr<std::atomic<unsigned>[]> Remaining(
+      new std::atomic<unsigned>[Nodes.size()]);
+  for (TaskID ID = 0, E = Nodes.size(); ID != E; ++ID)
+    Remaining[ID] = Nodes[ID].NumPredecessors;
+
+  std::atomic<unsigned> NumStarted{0};
+  std::function<void(TaskID)> Submit = [&](TaskID ID) {
+    Group.async(
+        [&, ID] {
+          ++NumStarted;
+          Nodes[ID].F();
+          for (TaskID Succ : Nodes[ID].Successors)
+            if (--Remaining[Succ] == 0)
+              Submit(Succ);
+        },
+        Nodes[ID].Priority);
+  };
+  for (TaskID ID = 0, E = Nodes.size(); ID != E; ++ID)
+    if (!Nodes[ID].NumPredecessors)
+      Submit(ID);
+  Group.wait();
+  assert((Group.isCancelled() || NumStarted == Nodes.size()) &&
+         "cycle in task graph");
+  (void)NumStarted;
+}
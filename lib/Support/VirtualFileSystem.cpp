@@ -472,6 +472,141 @@ directory_iterator OverlayFileSystem::dir_begin(const Twine &Dir,
       std::make_shared<OverlayFSDirIterImpl>(Dir, *this, EC));
 }
 
+//===-----------------------------------------------------------------------===/
+// CachingFileSystem implementation
+//===-----------------------------------------------------------------------===/
+
+std::error_code CachingFileSystem::getKey(const Twine &Path,
+                                          SmallVectorImpl<char> &Key) const {
+  Path.toVector(Key);
+  if (std::error_code EC = makeAbsolute(Key))
+    return EC;
+  // Only drop "." components: ".." cannot be resolved without knowing
+  // whether the component before it is a symlink.
+  sys::path::remove_dots(Key, /*remove_dot_dot=*/false);
+  return {};
+}
+
+ErrorOr<Status> CachingFileSystem::status(const Twine &Path) {
+  SmallString<256> Key;
+  if (getKey(Path, Key))
+    return getUnderlyingFS().status(Path);
+
+  {
+    std::lock_guard<std::mutex> Lock(Mutex);
+    auto I = StatusCache.find(Key);
+    if (I != StatusCache.end()) {
+      if (!I->second)
+        return I->second.getError();
+      // The underlying file system names the status after the path it was
+      // asked for, which may be spelled differently.
+      return Status::copyWithNewName(*I->second, Path.str());
+    }
+  }
+
+  // Do not hold the lock while asking the underlying file system, so that
+  // lookups of other paths can proceed in the meantime.
+  ErrorOr<Status> Result = getUnderlyingFS().status(Path);
+  std::lock_guard<std::mutex> Lock(Mutex);
+  StatusCache.insert(std::make_pair(Key, Result));
+  return Result;
+}
+
+ErrorOr<std::unique_ptr<File>>
+CachingFileSystem::openFileForRead(const Twine &Path) {
+  SmallString<256> Key;
+  if (!getKey(Path, Key)) {
+    std::lock_guard<std::mutex> Lock(Mutex);
+    auto I = StatusCache.find(Key);
+    if (I != StatusCache.end() && !I->second)
+      return I->second.getError();
+  }
+  return getUnderlyingFS().openFileForRead(Path);
+}
+
+/// Iterates over a directory listing remembered by a CachingFileSystem.
+class CachingFileSystem::CachedDirIterImpl
+    : public llvm::vfs::detail::DirIterImpl {
+  std::string Dir;
+  std::shared_ptr<const DirListing> Listing;
+  size_t Index = 0;
+
+  void setCurrentEntry() {
+    if (Index == Listing->size()) {
+      CurrentEntry = directory_entry();
+      return;
+    }
+    // Name the entries after the directory as the caller spelled it, as the
+    // underlying file system would.
+    const DirEntry &E = (*Listing)[Index];
+    SmallString<256> Path(Dir);
+    sys::path::append(Path, E.Name);
+    CurrentEntry = directory_entry(Path.str(), E.Type);
+  }
+
+public:
+  CachedDirIterImpl(std::string Dir, std::shared_ptr<const DirListing> Listing)
+      : Dir(std::move(Dir)), Listing(std::move(Listing)) {
+    setCurrentEntry();
+  }
+
+  std::error_code increment() override {
+    ++Index;
+    setCurrentEntry();
+    return {};
+  }
+};
+
+directory_iterator CachingFileSystem::dir_begin(const Twine &Dir,
+                                                std::error_code &EC) {
+  SmallString<256> Key;
+  if (getKey(Dir, Key))
+    return getUnderlyingFS().dir_begin(Dir, EC);
+
+  std::shared_ptr<const DirListing> Listing;
+  {
+    std::lock_guard<std::mutex> Lock(Mutex);
+    auto I = DirCache.find(Key);
+    if (I != DirCache.end())
+      Listing = I->second;
+  }
+
+  if (!Listing) {
+    auto NewListing = std::make_shared<DirListing>();
+    directory_iterator End;
+    for (directory_iterator I = getUnderlyingFS().dir_begin(Dir, EC);
+         !EC && I != End; I.increment(EC))
+      NewListing->push_back(
+          {sys::path::filename(I->path()).str(), I->type()});
+    // Listings that could not be read to the end are not remembered.
+    if (EC)
+      return directory_iterator();
+    Listing = NewListing;
+    std::lock_guard<std::mutex> Lock(Mutex);
+    DirCache.insert(std::make_pair(Key, Listing));
+  }
+
+  EC = std::error_code();
+  return directory_iterator(
+      std::make_shared<CachedDirIterImpl>(Dir.str(), std::move(Listing)));
+}
+
+void CachingFileSystem::invalidate(const Twine &Path) {
+  SmallString<256> Key;
+  if (getKey(Path, Key))
+    return;
+  std::lock_guard<std::mutex> Lock(Mutex);
+  StatusCache.erase(Key);
+  DirCache.erase(Key);
+  DirCache.erase(sys::path::parent_path(Key));
+}
+
+void CachingFileSystem::invalidateAll() {
+  std::lock_guard<std::mutex> Lock(Mutex);
+  StatusCache.clear();
+  DirCache.clear();
+}
+
 namespace llvm {
 namespace vfs {
 
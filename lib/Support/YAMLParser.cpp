@@ -985,16 +985,19 @@ void Scanner::saveSimpleKeyCandidate( TokenQueueT::iterator Tok
 }
 
 void Scanner::removeStaleSimpleKeyCandidates() {
-  for (SmallVectorImpl<SimpleKey>::iterator i = SimpleKeys.begin();
-                                            i != SimpleKeys.end();) {
-    if (i->Line != Line || i->Column + 1024 < Column) {
-      if (i->IsRequired)
-        setError( "Could not find expected : for simple key"
-                , i->Tok->Range.begin());
-      i = SimpleKeys.erase(i);
-    } else
-      ++i;
-  }
+  // This runs before every token, so remove the stale candidates in a single
+  // pass rather than shifting the rest of the vector for each of them.
+  auto IsStale = [&](const SimpleKey &SK) {
+    if (SK.Line == Line && SK.Column + 1024 >= Column)
+      return false;
+    if (SK.IsRequired)
+      setError( "Could not find expected : for simple key"
+              , SK.Tok->Range.begin());
+    return true;
+  };
+  SimpleKeys.erase(
+      std::remove_if(SimpleKeys.begin(), SimpleKeys.end(), IsStale),
+      SimpleKeys.end());
 }
 
 void Scanner::removeSimpleKeyCandidatesOnFlowLevel(unsigned Level) {
@@ -1325,6 +1328,21 @@ bool Scanner::scanFlowScalar(bool IsDoubleQuoted) {
   return true;
 }
 
+/// Return true if \p C can appear in a plain scalar without ending it or
+/// needing any further check: printable ASCII other than space, ':' and the
+/// flow indicators. The other characters take the slow path in
+/// scanPlainScalar.
+static bool isPlainScalarSafeChar(char C) {
+  const uint64_t SafeLow = 0x7bffeffe00000000ULL;  // 0x00 - 0x3F
+  const uint64_t SafeHigh = 0x57ffffffd7ffffffULL; // 0x40 - 0x7F
+  uint8_t U = C;
+  if (U < 64)
+    return (SafeLow >> U) & 1;
+  if (U < 128)
+    return (SafeHigh >> (U - 64)) & 1;
+  return false;
+}
+
 bool Scanner::scanPlainScalar() {
   StringRef::iterator Start = Current;
   unsigned ColStart = Column;
@@ -1336,6 +1354,16 @@ bool Scanner::scanPlainScalar() {
       break;
 
     while (!isBlankOrBreak(Current)) {
+      // Consume the run of characters that need none of the checks below.
+      StringRef::iterator SafeEnd = Current;
+      while (SafeEnd != End && isPlainScalarSafeChar(*SafeEnd))
+        ++SafeEnd;
+      if (SafeEnd != Current) {
+        Column += SafeEnd - Current;
+        Current = SafeEnd;
+        continue;
+      }
+
       if (  FlowLevel && *Current == ':'
           && !(isBlankOrBreak(Current + 1) || *(Current + 1) == ',')) {
         setError("Found unexpected ':' while scanning a plain scalar", Current);
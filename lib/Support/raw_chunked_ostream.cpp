@@ -0,0 +1,126 @@
+//===- raw_chunked_ostream.cpp - Output assembled from chunks -------------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements the raw_chunked_ostream class.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Support/raw_chunked_ostream.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/Config/config.h"
+#include "llvm/Support/Errno.h"
+#include "llvm/Support/ErrorHandling.h"
+#include <cassert>
+#include <cerrno>
+#include <utility>
+
+#if defined(HAVE_FCNTL_H)
+#include <fcntl.h>
+#endif
+
+#if defined(HAVE_UNISTD_H)
+#include <unistd.h>
+#endif
+
+using namespace llvm;
+
+raw_chunked_ostream::raw_chunked_ostream(raw_ostream &OS) : OS(OS) {}
+
+raw_chunked_ostream::raw_chunked_ostream(raw_fd_ostream &OS) : OS(OS) {
+#if defined(HAVE_UNISTD_H) && defined(F_GETFL) && defined(O_APPEND)
+  if (!OS.supportsSeeking())
+    return;
+  // pwrite ignores the offset on files opened for appending.
+  int Flags = ::fcntl(OS.get_fd(), F_GETFL);
+  if (Flags == -1 || (Flags & O_APPEND))
+    return;
+  OS.flush();
+  FileOS = &OS;
+  FD = OS.get_fd();
+  StartOffset = OS.tell();
+#endif
+}
+
+raw_chunked_ostream::~raw_chunked_ostream() {
+  if (!Finished)
+    finish();
+}
+
+raw_chunked_ostream::Chunk &raw_chunked_ostream::addChunk() {
+  std::lock_guard<std::mutex> Lock(Mutex);
+  assert(!Finished && "adding a chunk after finish()");
+  Chunks.push_back(llvm::make_unique<Chunk>());
+  return *Chunks.back();
+}
+
+void raw_chunked_ostream::commit(Chunk &C) {
+  SmallVector<std::pair<Chunk *, uint64_t>, 4> ToWrite;
+  {
+    std::lock_guard<std::mutex> Lock(Mutex);
+    assert(!C.Committed && "chunk committed twice");
+    C.Committed = true;
+    // Place all the chunks whose predecessors are now committed. Without a
+    // file descriptor, this is also where they are written, in order.
+    for (; NextToPlace != Chunks.size() && Chunks[NextToPlace]->Committed;
+         ++NextToPlace) {
+      Chunk &Next = *Chunks[NextToPlace];
+      uint64_t Size = Next.Buffer.size();
+      if (FD < 0) {
+        OS << Next.str();
+        SmallVector<char, 0>().swap(Next.Buffer);
+      } else {
+        ToWrite.push_back({&Next, StartOffset + PlacedSize});
+      }
+      PlacedSize += Size;
+    }
+    PendingWrites += ToWrite.size();
+  }
+  if (ToWrite.empty())
+    return;
+
+  for (auto &W : ToWrite)
+    writeChunk(*W.first, W.second);
+
+  std::lock_guard<std::mutex> Lock(Mutex);
+  PendingWrites -= ToWrite.size();
+  if (!PendingWrites)
+    WritesDone.notify_all();
+}
+
+void raw_chunked_ostream::writeChunk(Chunk &C, uint64_t Offset) {
+#if defined(HAVE_UNISTD_H)
+  const char *Ptr = C.Buffer.data();
+  size_t Size = C.Buffer.size();
+  while (Size) {
+    ssize_t Written =
+        sys::RetryAfterSignal(-1, ::pwrite, FD, Ptr, Size, Offset);
+    if (Written < 0) {
+      std::lock_guard<std::mutex> Lock(Mutex);
+      if (!EC)
+        EC = std::error_code(errno, std::generic_category());
+      break;
+    }
+    Ptr += Written;
+    Size -= Written;
+    Offset += Written;
+  }
+#else
+  llvm_unreachable("pwrite is not available");
+#endif
+  SmallVector<char, 0>().swap(C.Buffer);
+}
+
+void raw_chunked_ostream::finish() {
+  std::unique_lock<std::mutex> Lock(Mutex);
+  assert(NextToPlace == Chunks.size() && "some chunks are not committed");
+  WritesDone.wait(Lock, [this]() { return !PendingWrites; });
+  Finished = true;
+  if (FileOS)
+    FileOS->seek(StartOffset + PlacedSize);
+}
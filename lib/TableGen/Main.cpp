@@ -17,16 +17,25 @@
 
 #include "llvm/TableGen/Main.h"
 #include "TGParser.h"
+#include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/StringExtras.h"
+#include "llvm/Config/llvm-config.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Threading.h"
 #include "llvm/Support/ToolOutputFile.h"
 #include "llvm/TableGen/Error.h"
 #include "llvm/TableGen/Record.h"
 #include <algorithm>
+#include <cerrno>
 #include <cstdio>
+#include <map>
 #include <system_error>
+#ifdef LLVM_ON_UNIX
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
 using namespace llvm;
 
 static cl::opt<std::string>
@@ -50,18 +59,41 @@ static cl::list<std::string>
 MacroNames("D", cl::desc("Name of the macro to be defined"),
             cl::value_desc("macro name"), cl::Prefix);
 
+static cl::list<std::string>
+EmitOutputs("emit",
+            cl::desc("Perform <action> and write its output to <file>. May "
+                     "be repeated to perform several actions on one parse of "
+                     "the input"),
+            cl::value_desc("action=file"));
+
+static cl::opt<unsigned>
+EmitJobs("emit-jobs",
+         cl::desc("Number of -emit actions to perform at the same time "
+                  "(default: the number of cores)"),
+         cl::init(0));
+
 static int reportError(const char *ProgName, Twine Msg) {
   errs() << ProgName << ": " << Msg;
   errs().flush();
   return 1;
 }
 
+namespace {
+/// An action of an -emit option, and the file its output is written to.
+struct EmitAction {
+  StringRef Action;
+  StringRef Filename;
+};
+} // end anonymous namespace
+
 /// Create a dependency file for `-d` option.
 ///
 /// This functionality is really only for the benefit of the build system.
 /// It is similar to GCC's `-M*` family of options.
-static int createDependencyFile(const TGParser &Parser, const char *argv0) {
-  if (OutputFilename == "-")
+static int createDependencyFile(const TGParser &Parser,
+                                ArrayRef<StringRef> Outputs,
+                                const char *argv0) {
+  if (is_contained(Outputs, "-"))
     return reportError(argv0, "the option -d must be used together with -o\n");
 
   std::error_code EC;
@@ -69,7 +101,7 @@ static int createDependencyFile(const TGParser &Parser, const char *argv0) {
   if (EC)
     return reportError(argv0, "error opening " + DependFilename + ":" +
                                   EC.message() + "\n");
-  DepOut.os() << OutputFilename << ":";
+  DepOut.os() << join(Outputs.begin(), Outputs.end(), " ") << ":";
   for (const auto &Dep : Parser.getDependencies()) {
     DepOut.os() << ' ' << Dep.first;
   }
@@ -78,9 +110,142 @@ static int createDependencyFile(const TGParser &Parser, const char *argv0) {
   return 0;
 }
 
-int llvm::TableGenMain(char *argv0, TableGenMainFn *MainFn) {
+/// Run MainFn on Records and write its output to Filename.
+static int emitOutput(const char *argv0, StringRef Filename,
+                      TableGenMainFn *MainFn, RecordKeeper &Records) {
+  std::error_code EC;
+  ToolOutputFile Out(Filename, EC, sys::fs::F_Text);
+  if (EC)
+    return reportError(argv0, "error opening " + Filename + ":" +
+                                  EC.message() + "\n");
+
+  if (MainFn(Out.os(), Records))
+    return 1;
+
+  if (ErrorsPrinted > 0)
+    return reportError(argv0, Twine(ErrorsPrinted) + " errors.\n");
+
+  // Declare success.
+  Out.keep();
+  return 0;
+}
+
+static int emitAction(const char *argv0, const EmitAction &A,
+                      TableGenMainFn *MainFn, TableGenSelectFn *SelectFn,
+                      RecordKeeper &Records) {
+  if (SelectFn(A.Action))
+    return 1;
+  return emitOutput(argv0, A.Filename, MainFn, Records);
+}
+
+/// Perform the actions one after the other, and stop at the first one that
+/// fails.
+static int emitSequentially(const char *argv0, ArrayRef<EmitAction> Actions,
+                            TableGenMainFn *MainFn, TableGenSelectFn *SelectFn,
+                            RecordKeeper &Records) {
+  for (const EmitAction &A : Actions)
+    if (int Ret = emitAction(argv0, A, MainFn, SelectFn, Records))
+      return Ret;
+  return 0;
+}
+
+/// Perform each action in a process of its own, at most Jobs at a time.
+///
+/// The records and the Inits they refer to are uniqued in global pools that
+/// the backends keep adding to, so the backends can not share the records
+/// between threads. A forked process instead gets its own copy of the parsed
+/// records for free, and a backend that fails can not affect the others.
+static int emitInParallel(const char *argv0, ArrayRef<EmitAction> Actions,
+                          unsigned Jobs, TableGenMainFn *MainFn,
+                          TableGenSelectFn *SelectFn, RecordKeeper &Records) {
+#ifdef LLVM_ON_UNIX
+  // Do not let the children write out what was buffered before the fork.
+  outs().flush();
+  errs().flush();
+
+  std::map<pid_t, const EmitAction *> Running;
+  int Ret = 0;
+
+  auto WaitForChild = [&]() {
+    int Status;
+    pid_t Pid = wait(&Status);
+    if (Pid == -1) {
+      if (errno == EINTR)
+        return;
+      Ret = reportError(argv0, "could not wait for the -emit actions\n");
+      Running.clear();
+      return;
+    }
+    auto I = Running.find(Pid);
+    if (I == Running.end())
+      return;
+    const EmitAction &A = *I->second;
+    Running.erase(I);
+    if (WIFEXITED(Status) && WEXITSTATUS(Status) == 0)
+      return;
+    if (!WIFEXITED(Status))
+      reportError(argv0, "action '" + A.Action + "' crashed\n");
+    // A backend that exits with a fatal error does not clean up after itself.
+    sys::fs::remove(A.Filename);
+    Ret = 1;
+  };
+
+  for (const EmitAction &A : Actions) {
+    while (Running.size() >= Jobs)
+      WaitForChild();
+
+    pid_t Pid = fork();
+    if (Pid == -1) {
+      // Perform the remaining actions in this process.
+      while (!Running.empty())
+        WaitForChild();
+      if (Ret)
+        return Ret;
+      return emitSequentially(argv0, Actions.drop_front(&A - Actions.data()),
+                              MainFn, SelectFn, Records);
+    }
+
+    if (Pid == 0) {
+      int ChildRet = emitAction(argv0, A, MainFn, SelectFn, Records);
+      outs().flush();
+      errs().flush();
+      _exit(ChildRet);
+    }
+
+    Running[Pid] = &A;
+  }
+
+  while (!Running.empty())
+    WaitForChild();
+  return Ret;
+#else
+  return emitSequentially(argv0, Actions, MainFn, SelectFn, Records);
+#endif
+}
+
+int llvm::TableGenMain(char *argv0, TableGenMainFn *MainFn,
+                       TableGenSelectFn *SelectFn) {
   RecordKeeper Records;
 
+  // Check the -emit options before spending time on the input.
+  std::vector<EmitAction> Actions;
+  if (!EmitOutputs.empty()) {
+    if (!SelectFn)
+      return reportError(argv0, "this tool does not support -emit\n");
+    if (OutputFilename.getNumOccurrences())
+      return reportError(argv0, "the options -o and -emit are exclusive\n");
+    for (StringRef Output : EmitOutputs) {
+      EmitAction A;
+      std::tie(A.Action, A.Filename) = Output.split('=');
+      if (A.Action.empty() || A.Filename.empty() || A.Filename == "-")
+        return reportError(argv0, "-emit expects <action>=<file>, got '" +
+                                      Output + "'\n");
+      if (SelectFn(A.Action))
+        return 1;
+      Actions.push_back(A);
+    }
+  }
+
   // Parse the input file.
   ErrorOr<std::unique_ptr<MemoryBuffer>> FileOrErr =
       MemoryBuffer::getFileOrSTDIN(InputFilename);
@@ -100,23 +265,25 @@ int llvm::TableGenMain(char *argv0, TableGenMainFn *MainFn) {
   if (Parser.ParseFile())
     return 1;
 
-  std::error_code EC;
-  ToolOutputFile Out(OutputFilename, EC, sys::fs::F_Text);
-  if (EC)
-    return reportError(argv0, "error opening " + OutputFilename + ":" +
-                                  EC.message() + "\n");
+  if (Actions.empty()) {
+    if (!DependFilename.empty()) {
+      StringRef Output = OutputFilename;
+      if (int Ret = createDependencyFile(Parser, Output, argv0))
+        return Ret;
+    }
+    return emitOutput(argv0, OutputFilename, MainFn, Records);
+  }
+
   if (!DependFilename.empty()) {
-    if (int Ret = createDependencyFile(Parser, argv0))
+    std::vector<StringRef> Outputs;
+    for (const EmitAction &A : Actions)
+      Outputs.push_back(A.Filename);
+    if (int Ret = createDependencyFile(Parser, Outputs, argv0))
       return Ret;
   }
 
-  if (MainFn(Out.os(), Records))
-    return 1;
-
-  if (ErrorsPrinted > 0)
-    return reportError(argv0, Twine(ErrorsPrinted) + " errors.\n");
-
-  // Declare success.
-  Out.keep();
-  return 0;
+  unsigned Jobs = EmitJobs ? EmitJobs : heavyweight_hardware_concurrency();
+  if (Jobs <= 1 || Actions.size() == 1)
+    return emitSequentially(argv0, Actions, MainFn, SelectFn, Records);
+  return emitInParallel(argv0, Actions, Jobs, MainFn, SelectFn, Records);
 }
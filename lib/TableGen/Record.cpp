@@ -1897,6 +1897,11 @@ void Record::resolveReferences(Resolver &R, const RecordVal *SkipVal) {
       continue;
     if (Init *V = Value.getValue()) {
       Init *VR = V->resolveReferences(R);
+      // Most fields do not refer to anything that is being resolved, and
+      // setting a field to its own value does not change it, unless it is an
+      // unset bits field that setValue splits into bits.
+      if (VR == V && (isa<BitsInit>(V) || !isa<BitsRecTy>(Value.getType())))
+        continue;
       if (Value.setValue(VR)) {
         std::string Type;
         if (TypedInit *VRT = dyn_cast<TypedInit>(VR))
@@ -29,6 +29,7 @@
 #include "llvm/ADT/Triple.h"
 #include "llvm/ADT/Twine.h"
 #include "llvm/BinaryFormat/COFF.h"
+#include "llvm/BinaryFormat/ELF.h"
 #include "llvm/CodeGen/AsmPrinter.h"
 #include "llvm/CodeGen/MachineBasicBlock.h"
 #include "llvm/CodeGen/MachineFunction.h"
@@ -44,6 +45,7 @@
 #include "llvm/MC/MCContext.h"
 #include "llvm/MC/MCInst.h"
 #include "llvm/MC/MCInstBuilder.h"
+#include "llvm/MC/MCSectionELF.h"
 #include "llvm/MC/MCStreamer.h"
 #include "llvm/MC/MCSymbol.h"
 #include "llvm/Support/Casting.h"
@@ -56,6 +58,8 @@
 #include <cstdint>
 #include <map>
 #include <memory>
+#include <utility>
+#include <vector>
 
 using namespace llvm;
 
@@ -92,6 +96,8 @@ public:
   void LowerPATCHPOINT(MCStreamer &OutStreamer, StackMaps &SM,
                        const MachineInstr &MI);
 
+  void LowerHWASAN_CHECK_MEMACCESS(const MachineInstr &MI);
+
   void LowerPATCHABLE_FUNCTION_ENTER(const MachineInstr &MI);
   void LowerPATCHABLE_FUNCTION_EXIT(const MachineInstr &MI);
   void LowerPATCHABLE_TAIL_CALL(const MachineInstr &MI);
@@ -171,6 +177,18 @@ private:
   using MInstToMCSymbol = std::map<const MachineInstr *, MCSymbol *>;
 
   MInstToMCSymbol LOHInstToLabel;
+
+  /// Pagerando calls that the linker may relax to direct calls, see
+  /// EmitPagerandoRelaxSection.
+  std::vector<std::pair<MCSymbol *, const GlobalValue *>> PagerandoRelaxCalls;
+
+  void EmitPagerandoRelaxSection();
+
+  /// The routine called for each pair of pointer register and access info of
+  /// HWASAN_CHECK_MEMACCESS, see EmitHwasanMemaccessSymbols.
+  std::map<std::pair<unsigned, uint32_t>, MCSymbol *> HwasanMemaccessSymbols;
+
+  void EmitHwasanMemaccessSymbols();
 };
 
 } // end anonymous namespace
@@ -241,6 +259,123 @@ void AArch64AsmPrinter::EmitEndOfAsmFile(Module &M) {
     OutStreamer->EmitAssemblerFlag(MCAF_SubsectionsViaSymbols);
     emitStackMaps(SM);
   }
+
+  if (!PagerandoRelaxCalls.empty())
+    EmitPagerandoRelaxSection();
+
+  if (!HwasanMemaccessSymbols.empty())
+    EmitHwasanMemaccessSymbols();
+}
+
+void AArch64AsmPrinter::LowerHWASAN_CHECK_MEMACCESS(const MachineInstr &MI) {
+  unsigned Reg = MI.getOperand(0).getReg();
+  uint32_t AccessInfo = MI.getOperand(1).getImm();
+  MCSymbol *&Sym = HwasanMemaccessSymbols[{Reg, AccessInfo}];
+  if (!Sym) {
+    if (!TM.getTargetTriple().isOSBinFormatELF())
+      report_fatal_error("llvm.hwasan.check.memaccess only supported on ELF");
+    Sym = OutContext.getOrCreateSymbol(
+        Twine("__hwasan_check_") + AArch64InstPrinter::getRegisterName(Reg) +
+        "_" + Twine(AccessInfo));
+  }
+  EmitToStreamer(*OutStreamer,
+                 MCInstBuilder(AArch64::BL)
+                     .addExpr(MCSymbolRefExpr::create(Sym, OutContext)));
+}
+
+// Emit the check routines called by HWASAN_CHECK_MEMACCESS. Each one is a
+// weak hidden function in its own comdat, so that a linked program has one
+// copy of each, and does what the inline check does:
+//
+//   ubfx x16, xN, #4, #52          // shadow offset of the untagged address
+//   ldrb w16, [x9, x16]            // memory tag
+//   cmp x16, xN, lsr #56           // against the pointer tag
+//   b.ne 1f
+//   ret
+// 1:
+//   mov x0, xN
+//   brk #(0x900 + AccessInfo)      // report, as the inline check does
+void AArch64AsmPrinter::EmitHwasanMemaccessSymbols() {
+  const Triple &TT = TM.getTargetTriple();
+  std::unique_ptr<MCSubtargetInfo> STI(
+      TM.getTarget().createMCSubtargetInfo(TT.str(), "", ""));
+
+  for (auto &P : HwasanMemaccessSymbols) {
+    unsigned Reg = P.first.first;
+    uint32_t AccessInfo = P.first.second;
+    MCSymbol *Sym = P.second;
+
+    OutStreamer->SwitchSection(OutContext.getELFSection(
+        ".text.hot", ELF::SHT_PROGBITS,
+        ELF::SHF_EXECINSTR | ELF::SHF_ALLOC | ELF::SHF_GROUP, 0,
+        Sym->getName()));
+    OutStreamer->EmitSymbolAttribute(Sym, MCSA_ELF_TypeFunction);
+    OutStreamer->EmitSymbolAttribute(Sym, MCSA_Weak);
+    OutStreamer->EmitSymbolAttribute(Sym, MCSA_Hidden);
+    OutStreamer->EmitLabel(Sym);
+
+    OutStreamer->EmitInstruction(MCInstBuilder(AArch64::UBFMXri)
+                                     .addReg(AArch64::X16)
+                                     .addReg(Reg)
+                                     .addImm(4)
+                                     .addImm(55),
+                                 *STI);
+    OutStreamer->EmitInstruction(MCInstBuilder(AArch64::LDRBBroX)
+                                     .addReg(AArch64::W16)
+                                     .addReg(AArch64::X9)
+                                     .addReg(AArch64::X16)
+                                     .addImm(0)
+                                     .addImm(0),
+                                 *STI);
+    OutStreamer->EmitInstruction(
+        MCInstBuilder(AArch64::SUBSXrs)
+            .addReg(AArch64::XZR)
+            .addReg(AArch64::X16)
+            .addReg(Reg)
+            .addImm(AArch64_AM::getShifterImm(AArch64_AM::LSR, 56)),
+        *STI);
+    MCSymbol *HandleMismatchSym = OutContext.createTempSymbol();
+    OutStreamer->EmitInstruction(
+        MCInstBuilder(AArch64::Bcc)
+            .addImm(AArch64CC::NE)
+            .addExpr(MCSymbolRefExpr::create(HandleMismatchSym, OutContext)),
+        *STI);
+    OutStreamer->EmitInstruction(
+        MCInstBuilder(AArch64::RET).addReg(AArch64::LR), *STI);
+
+    OutStreamer->EmitLabel(HandleMismatchSym);
+    if (Reg != AArch64::X0)
+      OutStreamer->EmitInstruction(MCInstBuilder(AArch64::ORRXrs)
+                                       .addReg(AArch64::X0)
+                                       .addReg(AArch64::XZR)
+                                       .addReg(Reg)
+                                       .addImm(0),
+                                   *STI);
+    OutStreamer->EmitInstruction(
+        MCInstBuilder(AArch64::BRK).addImm(0x900 + AccessInfo), *STI);
+  }
+  HwasanMemaccessSymbols.clear();
+}
+
+// Emit a pair of (call site, target) addresses for every BLRpagerando. The
+// target is the binned function body created by PagerandoWrappers in the
+// defining module, which the linker may call directly if it ends up in the
+// same segment as the call site. The reference is weak so that a missing body
+// (e.g., a function PagerandoWrappers skipped) only disables the relaxation.
+void AArch64AsmPrinter::EmitPagerandoRelaxSection() {
+  MCSection *Sec = OutContext.getELFSection(".pagerando_relax",
+                                            ELF::SHT_PROGBITS, 0);
+  OutStreamer->SwitchSection(Sec);
+  for (auto &Call : PagerandoRelaxCalls) {
+    // Must match PagerandoWrappers::OrigSuffix
+    MCSymbol *Orig = OutContext.getOrCreateSymbol(
+        getSymbol(Call.second)->getName() + "$$orig");
+    OutStreamer->EmitSymbolAttribute(Orig, MCSA_Weak);
+    OutStreamer->EmitSymbolAttribute(Orig, MCSA_Hidden);
+    OutStreamer->EmitSymbolValue(Call.first, 8);
+    OutStreamer->EmitSymbolValue(Orig, 8);
+  }
+  PagerandoRelaxCalls.clear();
 }
 
 void AArch64AsmPrinter::EmitLOHs() {
@@ -741,6 +876,18 @@ void AArch64AsmPrinter::EmitInstruction(const MachineInstr *MI) {
     EmitToStreamer(*OutStreamer, TmpInst);
     return;
   }
+  case AArch64::BLRpagerando: {
+    MCSymbol *CallSite = createTempSymbol("pagerando_call");
+    OutStreamer->EmitLabel(CallSite);
+    PagerandoRelaxCalls.emplace_back(CallSite, MI->getOperand(1).getGlobal());
+
+    MCInst TmpInst;
+    TmpInst.setOpcode(AArch64::BLR);
+    TmpInst.addOperand(MCOperand::createReg(MI->getOperand(0).getReg()));
+    EmitToStreamer(*OutStreamer, TmpInst);
+    return;
+  }
+
   case AArch64::TLSDESC_CALLSEQ: {
     /// lower this to:
     ///    adrp  x0, :tlsdesc:var
@@ -837,6 +984,10 @@ void AArch64AsmPrinter::EmitInstruction(const MachineInstr *MI) {
     LowerPATCHABLE_FUNCTION_ENTER(*MI);
     return;
 
+  case AArch64::HWASAN_CHECK_MEMACCESS:
+    LowerHWASAN_CHECK_MEMACCESS(*MI);
+    return;
+
   case TargetOpcode::PATCHABLE_FUNCTION_EXIT:
     LowerPATCHABLE_FUNCTION_EXIT(*MI);
     return;
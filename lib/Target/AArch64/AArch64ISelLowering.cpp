@@ -38,6 +38,7 @@
 #include "llvm/CodeGen/MachineInstrBuilder.h"
 #include "llvm/CodeGen/MachineMemOperand.h"
 #include "llvm/CodeGen/MachineRegisterInfo.h"
+#include "llvm/CodeGen/PagerandoBinning.h"
 #include "llvm/CodeGen/RuntimeLibcalls.h"
 #include "llvm/CodeGen/SelectionDAG.h"
 #include "llvm/CodeGen/SelectionDAGNodes.h"
@@ -1091,6 +1092,7 @@ const char *AArch64TargetLowering::getTargetNodeName(unsigned Opcode) const {
   switch ((AArch64ISD::NodeType)Opcode) {
   case AArch64ISD::FIRST_NUMBER:      break;
   case AArch64ISD::CALL:              return "AArch64ISD::CALL";
+  case AArch64ISD::PAGERANDO_CALL:    return "AArch64ISD::PAGERANDO_CALL";
   case AArch64ISD::ADRP:              return "AArch64ISD::ADRP";
   case AArch64ISD::ADR:               return "AArch64ISD::ADR";
   case AArch64ISD::ADDlow:            return "AArch64ISD::ADDlow";
@@ -3506,6 +3508,23 @@ bool AArch64TargetLowering::DoesCalleeRestoreStack(CallingConv::ID CallCC,
   return CallCC == CallingConv::Fast && TailCallOpt;
 }
 
+// A call from a binned function to a function defined in another module that
+// was assigned to the same bin (see applyPagerandoBins) can be turned into a
+// direct call by the linker. This requires that the callee cannot be
+// preempted, since the call bypasses its wrapper, and that the callee is not
+// varargs, since its binned body takes an explicit va_list.
+static bool isRelaxablePagerandoCall(const Function &Caller,
+                                     const Function &Callee,
+                                     const TargetMachine &TM) {
+  if (!Caller.isPagerando() || !Callee.isDeclarationForLinker() ||
+      Callee.isVarArg() ||
+      !TM.shouldAssumeDSOLocal(*Callee.getParent(), &Callee))
+    return false;
+
+  auto Bin = PagerandoBinnerBase::getPresetBin(Caller);
+  return Bin != 0 && PagerandoBinnerBase::getPresetBin(Callee) == Bin;
+}
+
 /// LowerCall - Lower a call to a callseq_start + CALL + callseq_end chain,
 /// and add input and output parameter nodes.
 SDValue
@@ -3774,6 +3793,7 @@ AArch64TargetLowering::LowerCall(CallLoweringInfo &CLI,
   }
 
   bool IsPagerandoCall = false;
+  const Function *RelaxableCallee = nullptr;
 
   // If the callee is a GlobalAddress/ExternalSymbol node (quite common, every
   // direct call is) turn it into a TargetGlobalAddress/TargetExternalSymbol
@@ -3791,6 +3811,9 @@ AArch64TargetLowering::LowerCall(CallLoweringInfo &CLI,
       Subtarget->classifyGlobalFunctionReference(GV, getTargetMachine());
     if (UsePIPAddressing) {
       IsPagerandoCall = true;
+      if (!IsTailCall && F &&
+          isRelaxablePagerandoCall(MF.getFunction(), *F, getTargetMachine()))
+        RelaxableCallee = F;
       Callee = getPOT(G, DAG);
     } else if (OpFlags & AArch64II::MO_GOT) {
       Callee = DAG.getTargetGlobalAddress(GV, DL, PtrVT, 0, AArch64II::MO_GOT);
@@ -3831,6 +3854,8 @@ AArch64TargetLowering::LowerCall(CallLoweringInfo &CLI,
   std::vector<SDValue> Ops;
   Ops.push_back(Chain);
   Ops.push_back(Callee);
+  if (RelaxableCallee)
+    Ops.push_back(DAG.getTargetGlobalAddress(RelaxableCallee, DL, PtrVT));
 
   if (IsTailCall) {
     // Each tail call may have to adjust the stack by a different amount, so
@@ -3885,7 +3910,9 @@ AArch64TargetLowering::LowerCall(CallLoweringInfo &CLI,
   }
 
   // Returns a chain and a flag for retval copy to use.
-  Chain = DAG.getNode(AArch64ISD::CALL, DL, NodeTys, Ops);
+  unsigned CallOpc =
+      RelaxableCallee ? AArch64ISD::PAGERANDO_CALL : AArch64ISD::CALL;
+  Chain = DAG.getNode(CallOpc, DL, NodeTys, Ops);
   InFlag = Chain.getValue(1);
 
   uint64_t CalleePopBytes =
@@ -4843,7 +4870,11 @@ SDValue AArch64TargetLowering::LowerPOT(SDValue Op, SelectionDAG &DAG) const {
   MachineFunction &MF = DAG.getMachineFunction();
   unsigned POTReg = getPOTBaseRegister();
   if (MF.getFunction().isPagerando()) {
-    return DAG.getCopyFromReg(DAG.getEntryNode(), dl, POTReg, PtrVT);
+    // Copy the POT base register only once, in the entry block. A copy next to
+    // every use would make the POT loads that depend on it look loop-variant
+    // to MachineLICM.
+    unsigned VReg = MF.addLiveIn(POTReg, &AArch64::GPR64RegClass);
+    return DAG.getCopyFromReg(DAG.getEntryNode(), dl, VReg, PtrVT);
   } else {
     SDValue POTAddress = DAG.getTargetExternalSymbol("_PAGE_OFFSET_TABLE_", PtrVT,
                                                      AArch64II::MO_GOT);
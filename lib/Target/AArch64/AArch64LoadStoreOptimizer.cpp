@@ -10,12 +10,17 @@
 // This file contains a pass that performs load / store related peephole
 // optimizations. This pass should be run after register allocation.
 //
+// It also contains a pass that runs before register allocation and moves
+// loads / stores of consecutive locations next to each other, so that the
+// first pass can pair them.
+//
 //===----------------------------------------------------------------------===//
 
 #include "AArch64InstrInfo.h"
 #include "AArch64Subtarget.h"
 #include "MCTargetDesc/AArch64AddressingModes.h"
 #include "llvm/ADT/BitVector.h"
+#include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/Statistic.h"
 #include "llvm/ADT/StringRef.h"
@@ -27,6 +32,7 @@
 #include "llvm/CodeGen/MachineInstr.h"
 #include "llvm/CodeGen/MachineInstrBuilder.h"
 #include "llvm/CodeGen/MachineOperand.h"
+#include "llvm/CodeGen/MachineRegisterInfo.h"
 #include "llvm/CodeGen/TargetRegisterInfo.h"
 #include "llvm/IR/DebugLoc.h"
 #include "llvm/MC/MCRegisterInfo.h"
@@ -39,6 +45,7 @@
 #include <cstdint>
 #include <iterator>
 #include <limits>
+#include <tuple>
 
 using namespace llvm;
 
@@ -51,6 +58,7 @@ STATISTIC(NumUnscaledPairCreated,
           "Number of load/store from unscaled generated");
 STATISTIC(NumZeroStoresPromoted, "Number of narrow zero stores promoted");
 STATISTIC(NumLoadsFromStoresPromoted, "Number of loads from stores promoted");
+STATISTIC(NumLdStMoved, "Number of loads / stores moved next to their pair");
 
 // The LdStLimit limits how far we search for load/store pairs.
 static cl::opt<unsigned> LdStLimit("aarch64-load-store-scan-limit",
@@ -61,7 +69,15 @@ static cl::opt<unsigned> LdStLimit("aarch64-load-store-scan-limit",
 static cl::opt<unsigned> UpdateLimit("aarch64-update-scan-limit", cl::init(100),
                                      cl::Hidden);
 
+// The PreRALdStLimit limits how far apart two loads or stores may be for the
+// pre-RA pass to move them together. Moving them further would lengthen the
+// live ranges of their registers and increase register pressure.
+static cl::opt<unsigned> PreRALdStLimit("aarch64-prera-ldst-scan-limit",
+                                        cl::init(16), cl::Hidden);
+
 #define AARCH64_LOAD_STORE_OPT_NAME "AArch64 load / store optimization pass"
+#define AARCH64_PREALLOC_LOAD_STORE_OPT_NAME                                   \
+  "AArch64 pre- register allocation load / store optimization pass"
 
 namespace {
 
@@ -1771,10 +1787,193 @@ bool AArch64LoadStoreOpt::runOnMachineFunction(MachineFunction &Fn) {
   return Modified;
 }
 
-// FIXME: Do we need/want a pre-alloc pass like ARM has to try to keep loads and
-// stores near one another?  Note: The pre-RA instruction scheduler already has
-// hooks to try and schedule pairable loads/stores together to improve pairing
-// opportunities.  Thus, pre-RA pairing pass may not be worth the effort.
+namespace {
+
+/// Pre- register allocation pass that moves loads / stores of consecutive
+/// locations next to each other. The pre-RA scheduler clusters them only
+/// within a scheduling region and when nothing else is more urgent, and once
+/// registers are allocated a reused register between them can keep the
+/// post-RA pass from pairing them.
+struct AArch64PreRALoadStoreOpt : public MachineFunctionPass {
+  static char ID;
+
+  AArch64PreRALoadStoreOpt() : MachineFunctionPass(ID) {
+    initializeAArch64PreRALoadStoreOptPass(*PassRegistry::getPassRegistry());
+  }
+
+  AliasAnalysis *AA;
+  const AArch64InstrInfo *TII;
+  const TargetRegisterInfo *TRI;
+  MachineRegisterInfo *MRI;
+
+  void getAnalysisUsage(AnalysisUsage &AU) const override {
+    AU.addRequired<AAResultsWrapperPass>();
+    AU.setPreservesCFG();
+    MachineFunctionPass::getAnalysisUsage(AU);
+  }
+
+  bool runOnMachineFunction(MachineFunction &Fn) override;
+
+  StringRef getPassName() const override {
+    return AARCH64_PREALLOC_LOAD_STORE_OPT_NAME;
+  }
+
+private:
+  // A load or store that may be paired, with the byte offset it accesses
+  // from its base and its position in the block.
+  struct Candidate {
+    MachineInstr *MI;
+    unsigned PairOpc;
+    bool IsFI;
+    int Base;
+    int Offset;
+    unsigned Loc;
+  };
+
+  bool isSafeToMoveTogether(MachineInstr &First, MachineInstr &Second,
+                            bool IsLoad);
+  bool rescheduleLoadStoreInstrs(MachineBasicBlock &MBB);
+};
+
+char AArch64PreRALoadStoreOpt::ID = 0;
+
+} // end anonymous namespace
+
+INITIALIZE_PASS(AArch64PreRALoadStoreOpt, "aarch64-prera-ldst-opt",
+                AARCH64_PREALLOC_LOAD_STORE_OPT_NAME, false, false)
+
+bool AArch64PreRALoadStoreOpt::runOnMachineFunction(MachineFunction &Fn) {
+  if (skipFunction(Fn.getFunction()))
+    return false;
+
+  auto &Subtarget = static_cast<const AArch64Subtarget &>(Fn.getSubtarget());
+  TII = static_cast<const AArch64InstrInfo *>(Subtarget.getInstrInfo());
+  TRI = Subtarget.getRegisterInfo();
+  MRI = &Fn.getRegInfo();
+  AA = &getAnalysis<AAResultsWrapperPass>().getAAResults();
+
+  bool Modified = false;
+  for (auto &MBB : Fn)
+    Modified |= rescheduleLoadStoreInstrs(MBB);
+
+  return Modified;
+}
+
+// Return true if the load Second can be moved up to First, or the store First
+// down to Second, over the instructions between them.
+bool AArch64PreRALoadStoreOpt::isSafeToMoveTogether(MachineInstr &First,
+                                                    MachineInstr &Second,
+                                                    bool IsLoad) {
+  MachineInstr &Moved = IsLoad ? Second : First;
+  for (MachineBasicBlock::iterator I = std::next(First.getIterator()),
+                                   E = Second.getIterator();
+       I != E; ++I) {
+    if (I->isDebugInstr())
+      continue;
+    if (I->isCall() || I->isTerminator() || I->hasUnmodeledSideEffects() ||
+        I->hasOrderedMemoryRef())
+      return false;
+    // A load can move over the loads, and the stores it does not alias; a
+    // store only over the memory accesses it does not alias.
+    if ((I->mayStore() || (!IsLoad && I->mayLoad())) &&
+        I->mayAlias(AA, Moved, /*UseTBAA*/ false))
+      return false;
+    for (const MachineOperand &MO : I->operands()) {
+      if (!MO.isReg() || !MO.getReg())
+        continue;
+      for (const MachineOperand &MovedMO : Moved.operands())
+        if (MovedMO.isReg() && MovedMO.getReg() &&
+            (MO.isDef() || MovedMO.isDef()) &&
+            TRI->regsOverlap(MO.getReg(), MovedMO.getReg()))
+          return false;
+    }
+  }
+  return true;
+}
+
+bool AArch64PreRALoadStoreOpt::rescheduleLoadStoreInstrs(
+    MachineBasicBlock &MBB) {
+  // Collect the loads / stores that may be paired, from a virtual register or
+  // a frame index with an immediate offset. Pairing suppressed by the
+  // StorePairSuppress pass, which consults the scheduling model, and slow
+  // quad pairs are already rejected by isCandidateToMergeOrPair.
+  SmallVector<Candidate, 16> Candidates;
+  unsigned Loc = 0;
+  for (MachineInstr &MI : MBB) {
+    if (MI.isDebugInstr())
+      continue;
+    ++Loc;
+    if (!TII->isPairableLdStInst(MI) || !TII->isCandidateToMergeOrPair(MI))
+      continue;
+    const MachineOperand &BaseOp = getLdStBaseOp(MI);
+    if (!BaseOp.isFI() &&
+        !TargetRegisterInfo::isVirtualRegister(BaseOp.getReg()))
+      continue;
+    int Offset = getLdStOffsetOp(MI).getImm();
+    if (!TII->isUnscaledLdSt(MI))
+      Offset *= getMemScale(MI);
+    Candidates.push_back({&MI, getMatchingPairOpcode(MI.getOpcode()),
+                          BaseOp.isFI(),
+                          BaseOp.isFI() ? BaseOp.getIndex()
+                                        : int(BaseOp.getReg()),
+                          Offset, Loc});
+  }
+  if (Candidates.size() < 2)
+    return false;
+
+  // Accesses that could form the same kind of pair from the same base end up
+  // next to each other, in order of offset.
+  llvm::sort(Candidates, [](const Candidate &A, const Candidate &B) {
+    return std::tie(A.PairOpc, A.IsFI, A.Base, A.Offset, A.Loc) <
+           std::tie(B.PairOpc, B.IsFI, B.Base, B.Offset, B.Loc);
+  });
+
+  bool Modified = false;
+  for (unsigned I = 0, E = Candidates.size(); I + 1 < E; ++I) {
+    const Candidate &Lo = Candidates[I];
+    const Candidate &Hi = Candidates[I + 1];
+    int Scale = getMemScale(*Lo.MI);
+    if (Lo.PairOpc != Hi.PairOpc || Lo.IsFI != Hi.IsFI || Lo.Base != Hi.Base ||
+        Hi.Offset != Lo.Offset + Scale ||
+        !inBoundsForPair(/*IsUnscaled=*/true, Lo.Offset, Scale))
+      continue;
+
+    const Candidate &First = Lo.Loc < Hi.Loc ? Lo : Hi;
+    const Candidate &Second = Lo.Loc < Hi.Loc ? Hi : Lo;
+    if (Second.Loc - First.Loc > PreRALdStLimit)
+      continue;
+
+    // Each access is in at most one pair.
+    ++I;
+    MachineBasicBlock::iterator Next = skipDebugInstructionsForward(
+        std::next(First.MI->getIterator()), MBB.end());
+    if (&*Next == Second.MI)
+      continue;
+
+    bool IsLoad = First.MI->mayLoad();
+    if (!isSafeToMoveTogether(*First.MI, *Second.MI, IsLoad))
+      continue;
+
+    // Loads move up to the first one, stores down to the last one, so that
+    // no value is needed earlier than before.
+    MachineInstr *Moved = IsLoad ? Second.MI : First.MI;
+    LLVM_DEBUG(dbgs() << "Moving next to its pair: " << *Moved);
+    if (IsLoad)
+      MBB.splice(std::next(First.MI->getIterator()), &MBB, Moved);
+    else
+      MBB.splice(Second.MI->getIterator(), &MBB, Moved);
+
+    // The moved instruction may now read a register after its last use.
+    for (const MachineOperand &MO : Moved->uses())
+      if (MO.isReg() && MO.getReg())
+        MRI->clearKillFlags(MO.getReg());
+
+    ++NumLdStMoved;
+    Modified = true;
+  }
+
+  return Modified;
+}
 
 // FIXME: When pairing store instructions it's very possible for this pass to
 // hoist a store with a KILL marker above another use (without a KILL marker).
@@ -1786,3 +1985,9 @@ bool AArch64LoadStoreOpt::runOnMachineFunction(MachineFunction &Fn) {
 FunctionPass *llvm::createAArch64LoadStoreOptimizationPass() {
   return new AArch64LoadStoreOpt();
 }
+
+/// createAArch64PreRALoadStoreOptimizationPass - returns an instance of the
+/// pre- register allocation load / store optimization pass.
+FunctionPass *llvm::createAArch64PreRALoadStoreOptimizationPass() {
+  return new AArch64PreRALoadStoreOpt();
+}
@@ -46,6 +46,7 @@ public:
     CortexA72,
     CortexA73,
     CortexA75,
+    CortexA76,
     Cyclone,
     ExynosM1,
     ExynosM3,
@@ -169,6 +170,7 @@ protected:
   bool HasFuseCryptoEOR = false;
   bool HasFuseCCSelect = false;
   bool HasFuseLiterals = false;
+  bool HasFuseAdrpAdd = false;
   bool DisableLatencySchedHeuristic = false;
   bool UseRSqrt = false;
   bool Force32BitJumpTables = false;
@@ -314,11 +316,13 @@ public:
   bool hasFuseCryptoEOR() const { return HasFuseCryptoEOR; }
   bool hasFuseCCSelect() const { return HasFuseCCSelect; }
   bool hasFuseLiterals() const { return HasFuseLiterals; }
+  bool hasFuseAdrpAdd() const { return HasFuseAdrpAdd; }
 
   /// Return true if the CPU supports any kind of instruction fusion.
   bool hasFusion() const {
     return hasArithmeticBccFusion() || hasArithmeticCbzFusion() ||
-           hasFuseAES() || hasFuseCCSelect() || hasFuseLiterals();
+           hasFuseAddress() || hasFuseAES() || hasFuseCryptoEOR() ||
+           hasFuseCCSelect() || hasFuseLiterals() || hasFuseAdrpAdd();
   }
 
   bool useRSqrt() const { return UseRSqrt; }
@@ -94,6 +94,11 @@ static cl::opt<bool> EnableLoadStoreOpt("aarch64-enable-ldst-opt",
                                                  " optimization pass"),
                                         cl::init(true), cl::Hidden);
 
+static cl::opt<bool> EnablePreRALoadStoreOpt(
+    "aarch64-enable-prera-ldst-opt",
+    cl::desc("Move pairable loads/stores together before register allocation"),
+    cl::init(false), cl::Hidden);
+
 static cl::opt<bool> EnableAtomicTidy(
     "aarch64-enable-atomic-cfg-tidy", cl::Hidden,
     cl::desc("Run SimplifyCFG after expanding atomic operations"
@@ -169,6 +174,7 @@ extern "C" void LLVMInitializeAArch64Target() {
   initializeAArch64DeadRegisterDefinitionsPass(*PR);
   initializeAArch64ExpandPseudoPass(*PR);
   initializeAArch64LoadStoreOptPass(*PR);
+  initializeAArch64PreRALoadStoreOptPass(*PR);
   initializeAArch64SIMDInstrOptPass(*PR);
   initializeAArch64PreLegalizerCombinerPass(*PR);
   initializeAArch64PromoteConstantPass(*PR);
@@ -287,6 +293,15 @@ AArch64TargetMachine::AArch64TargetMachine(const Target &T, const Triple &TT,
 
   // AArch64 supports default outlining behaviour.
   setSupportsDefaultOutlining(true);
+
+  // Pagerando bins must cover whole pages for every supported translation
+  // granule (4KB, 16KB or 64KB).
+  if (isPagerando()) {
+    unsigned BinSize = Options.PagerandoBinSize;
+    if (BinSize != 4096 && BinSize != 16384 && BinSize != 65536)
+      report_fatal_error("Pagerando bin size must be 4096, 16384 or 65536 on "
+                         "AArch64");
+  }
 }
 
 AArch64TargetMachine::~AArch64TargetMachine() = default;
@@ -527,6 +542,12 @@ void AArch64PassConfig::addPreRegAlloc() {
     addPass(&DeadMachineInstructionElimID);
   }
 
+  // Move loads/stores of consecutive locations together, for the post-RA
+  // load/store optimizer to pair them.
+  if (TM->getOptLevel() != CodeGenOpt::None && EnableLoadStoreOpt &&
+      EnablePreRALoadStoreOpt)
+    addPass(createAArch64PreRALoadStoreOptimizationPass());
+
   // Change dead register definitions to refer to the zero register.
   if (TM->getOptLevel() != CodeGenOpt::None && EnableDeadRegisterElimination)
     addPass(createAArch64DeadRegisterDefinitions());
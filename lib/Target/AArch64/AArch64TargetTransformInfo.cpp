@@ -24,6 +24,52 @@ using namespace llvm;
 static cl::opt<bool> EnableFalkorHWPFUnrollFix("enable-falkor-hwpf-unroll-fix",
                                                cl::init(true), cl::Hidden);
 
+namespace {
+
+using namespace AArch64;
+
+// Entries of the per-CPU cost tables generated from AArch64CostModel.td.
+struct VectorOpInst {
+  unsigned ISD;
+  MVT::SimpleValueType VT;
+  unsigned Inst;
+};
+
+struct InstCost {
+  unsigned CostModel;
+  unsigned Inst;
+  uint8_t Cost;
+};
+
+#define GET_AArch64CostModel_DECL
+#define GET_AArch64VectorOps_IMPL
+#define GET_AArch64InstCosts_DECL
+#define GET_AArch64InstCosts_IMPL
+#include "AArch64GenSystemOperands.inc"
+
+} // end anonymous namespace
+
+unsigned AArch64TTIImpl::getCPUInstrCost(int ISD, MVT VT) const {
+  unsigned CostModel;
+  switch (ST->getProcFamily()) {
+  case AArch64Subtarget::CortexA55:
+    CostModel = CortexA55CostModel;
+    break;
+  case AArch64Subtarget::CortexA76:
+    CostModel = CortexA76CostModel;
+    break;
+  default:
+    return 0;
+  }
+
+  for (const VectorOpInst &Op : AArch64VectorOps)
+    if (Op.ISD == unsigned(ISD) && Op.VT == VT.SimpleTy) {
+      const InstCost *Entry = lookupInstCost(CostModel, Op.Inst);
+      return Entry ? Entry->Cost : 0;
+    }
+  return 0;
+}
+
 bool AArch64TTIImpl::areInlineCompatible(const Function *Caller,
                                          const Function *Callee) const {
   const TargetMachine &TM = getTLI()->getTargetMachine();
@@ -194,6 +240,32 @@ AArch64TTIImpl::getPopcntSupport(unsigned TyWidth) {
   return TTI::PSK_Software;
 }
 
+const AArch64TTIImpl::TTI::MemCmpExpansionOptions *
+AArch64TTIImpl::enableMemCmpExpansion(bool IsZeroCmp) const {
+  // The expansion relies on unaligned loads, and the tail of a compare is
+  // done with a load that overlaps the previous one.
+  if (ST->requiresStrictAlign())
+    return nullptr;
+
+  // Equality compares can also use 16-byte loads, which are done with an LDP
+  // or LDR Q and compared with a CMP/CCMP pair. Three-way compares need the
+  // bytes in memory order, which is a REV per register, so keep them to
+  // 8 bytes.
+  static const auto ThreeWayOptions = []() {
+    TTI::MemCmpExpansionOptions Options;
+    Options.LoadSizes = {8, 4, 2, 1};
+    Options.AllowOverlappingLoads = true;
+    return Options;
+  }();
+  static const auto EqZeroOptions = []() {
+    TTI::MemCmpExpansionOptions Options;
+    Options.LoadSizes = {16, 8, 4, 2, 1};
+    Options.AllowOverlappingLoads = true;
+    return Options;
+  }();
+  return IsZeroCmp ? &EqZeroOptions : &ThreeWayOptions;
+}
+
 bool AArch64TTIImpl::isWideningInstruction(Type *DstTy, unsigned Opcode,
                                            ArrayRef<const Value *> Args) {
 
@@ -493,6 +565,11 @@ int AArch64TTIImpl::getArithmeticInstrCost(
 
   int ISD = TLI->InstructionOpcodeToISD(Opcode);
 
+  // Use the throughput measured on the CPU, if it has a cost table.
+  if (Ty->isVectorTy())
+    if (unsigned CPUCost = getCPUInstrCost(ISD, LT.second))
+      return Cost + CPUCost * LT.first;
+
   switch (ISD) {
   default:
     return Cost + BaseT::getArithmeticInstrCost(Opcode, Ty, Opd1Info, Opd2Info,
@@ -652,6 +729,11 @@ int AArch64TTIImpl::getMemoryOpCost(unsigned Opcode, Type *Ty,
     }
   }
 
+  if (Ty->isVectorTy())
+    if (unsigned CPUCost = getCPUInstrCost(
+            Opcode == Instruction::Load ? ISD::LOAD : ISD::STORE, LT.second))
+      return CPUCost * LT.first;
+
   return LT.first;
 }
 
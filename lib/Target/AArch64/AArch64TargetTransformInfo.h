@@ -60,6 +60,11 @@ class AArch64TTIImpl : public BasicTTIImplBase<AArch64TTIImpl> {
   bool isWideningInstruction(Type *Ty, unsigned Opcode,
                              ArrayRef<const Value *> Args);
 
+  /// Returns the cost of the instruction implementing \p ISD on \p VT from
+  /// the cost table of the subtarget's CPU in AArch64CostModel.td, or 0 if
+  /// the CPU has no table or the table has no entry for it.
+  unsigned getCPUInstrCost(int ISD, MVT VT) const;
+
 public:
   explicit AArch64TTIImpl(const AArch64TargetMachine *TM, const Function &F)
       : BaseT(TM, F.getParent()->getDataLayout()), ST(TM->getSubtargetImpl(F)),
@@ -79,6 +84,9 @@ public:
                     Type *Ty);
   TTI::PopcntSupportKind getPopcntSupport(unsigned TyWidth);
 
+  const TTI::MemCmpExpansionOptions *enableMemCmpExpansion(
+      bool IsZeroCmp) const;
+
   /// @}
 
   /// \name Vector TTI Implementations
@@ -32,6 +32,7 @@
 #include "llvm/CodeGen/MachineFunction.h"
 #include "llvm/CodeGen/MachineInstr.h"
 #include "llvm/CodeGen/MachineInstrBuilder.h"
+#include "llvm/CodeGen/MachineJumpTableInfo.h"
 #include "llvm/CodeGen/MachineMemOperand.h"
 #include "llvm/CodeGen/MachineOperand.h"
 #include "llvm/CodeGen/MachineRegisterInfo.h"
@@ -42,6 +43,7 @@
 #include "llvm/CodeGen/TargetSchedule.h"
 #include "llvm/IR/Attributes.h"
 #include "llvm/IR/Constants.h"
+#include "llvm/IR/DataLayout.h"
 #include "llvm/IR/DebugLoc.h"
 #include "llvm/IR/Function.h"
 #include "llvm/IR/GlobalValue.h"
@@ -766,6 +768,23 @@ unsigned ARMBaseInstrInfo::getInstBundleLength(const MachineInstr &MI) const {
   return Size;
 }
 
+unsigned
+ARMBaseInstrInfo::getInlineDataSizeEstimate(const MachineFunction &MF) const {
+  // Every constant pool entry ends up in at least one island, padded to its
+  // alignment. Jump tables are assumed to stay at 4 bytes per entry, even
+  // though Thumb2 may compress them into TBB / TBH tables.
+  unsigned Size = 0;
+  const DataLayout &DL = MF.getDataLayout();
+  for (const MachineConstantPoolEntry &CPE :
+       MF.getConstantPool()->getConstants())
+    Size = alignTo(Size, CPE.getAlignment()) +
+           DL.getTypeAllocSize(CPE.getType());
+  if (const MachineJumpTableInfo *MJTI = MF.getJumpTableInfo())
+    for (const MachineJumpTableEntry &JTE : MJTI->getJumpTables())
+      Size += 4 * JTE.MBBs.size();
+  return Size;
+}
+
 void ARMBaseInstrInfo::copyFromCPSR(MachineBasicBlock &MBB,
                                     MachineBasicBlock::iterator I,
                                     unsigned DestReg, bool KillSrc,
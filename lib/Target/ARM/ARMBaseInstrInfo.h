@@ -187,6 +187,10 @@ public:
   ///
   unsigned getInstSizeInBytes(const MachineInstr &MI) const override;
 
+  /// Constant pool entries and jump tables are placed in constant islands
+  /// inside the function.
+  unsigned getInlineDataSizeEstimate(const MachineFunction &MF) const override;
+
   unsigned isLoadFromStackSlot(const MachineInstr &MI,
                                int &FrameIndex) const override;
   unsigned isStoreToStackSlot(const MachineInstr &MI,
@@ -28,6 +28,7 @@
 #include "llvm/ADT/Statistic.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/CodeGen/MachineBasicBlock.h"
+#include "llvm/CodeGen/MachineBlockFrequencyInfo.h"
 #include "llvm/CodeGen/MachineConstantPool.h"
 #include "llvm/CodeGen/MachineFunction.h"
 #include "llvm/CodeGen/MachineFunctionPass.h"
@@ -35,6 +36,7 @@
 #include "llvm/CodeGen/MachineJumpTableInfo.h"
 #include "llvm/CodeGen/MachineOperand.h"
 #include "llvm/CodeGen/MachineRegisterInfo.h"
+#include "llvm/CodeGen/PagerandoBinning.h"
 #include "llvm/Config/llvm-config.h"
 #include "llvm/IR/DataLayout.h"
 #include "llvm/IR/DebugLoc.h"
@@ -70,6 +72,7 @@ STATISTIC(NumT2BrShrunk, "Number of Thumb2 immediate branches shrunk");
 STATISTIC(NumCBZ,        "Number of CBZ / CBNZ formed");
 STATISTIC(NumJTMoved,    "Number of jump table destination blocks moved");
 STATISTIC(NumJTInserted, "Number of jump table intermediate blocks inserted");
+STATISTIC(NumIslandBytes, "Number of bytes placed in constant islands");
 
 static cl::opt<bool>
 AdjustJumpTableBlocks("arm-adjust-jump-tables", cl::Hidden, cl::init(true),
@@ -79,6 +82,11 @@ static cl::opt<unsigned>
 CPMaxIteration("arm-constant-island-max-iteration", cl::Hidden, cl::init(30),
           cl::desc("The max number of iteration for converge"));
 
+static cl::opt<bool> ProfileGuidedIslands(
+    "arm-constant-island-profile-guided", cl::Hidden, cl::init(false),
+    cl::desc("Use block frequencies to keep constant islands out of hot "
+             "regions"));
+
 static cl::opt<bool> SynthesizeThumb1TBB(
     "arm-synthesize-thumb-1-tbb", cl::Hidden, cl::init(true),
     cl::desc("Use compressed jump tables in Thumb-1 by synthesizing an "
@@ -218,11 +226,23 @@ namespace {
     bool isThumb2;
     bool isPositionIndependent_ROPI_PIP;
 
+    /// BlockFreqs - The frequencies of the blocks that existed when the pass
+    /// started, for profile-guided island placement. Blocks created by this
+    /// pass are not in the map.
+    DenseMap<const MachineBasicBlock *, uint64_t> BlockFreqs;
+    uint64_t EntryFreq;
+
   public:
     static char ID;
 
     ARMConstantIslands() : MachineFunctionPass(ID) {}
 
+    void getAnalysisUsage(AnalysisUsage &AU) const override {
+      if (ProfileGuidedIslands)
+        AU.addRequired<MachineBlockFrequencyInfo>();
+      MachineFunctionPass::getAnalysisUsage(AU);
+    }
+
     bool runOnMachineFunction(MachineFunction &MF) override;
 
     MachineFunctionProperties getRequiredProperties() const override {
@@ -248,6 +268,8 @@ namespace {
     bool decrementCPEReferenceCount(unsigned CPI, MachineInstr* CPEMI);
     unsigned getCombinedIndex(const MachineInstr *CPEMI);
     int findInRangeCPEntry(CPUser& U, unsigned UserOffset);
+    bool isHotBlock(const MachineBasicBlock *MBB) const;
+    bool isHotWater(MachineBasicBlock *Water) const;
     bool findAvailableWater(CPUser&U, unsigned UserOffset,
                             water_iterator &WaterIter, bool CloserWater);
     void createNewWater(unsigned CPUserIndex, unsigned UserOffset,
@@ -378,6 +400,14 @@ bool ARMConstantIslands::runOnMachineFunction(MachineFunction &mf) {
     MF->RenumberBlocks();
   }
 
+  // Record the block frequencies before any island or split block is added.
+  if (ProfileGuidedIslands) {
+    auto &MBFI = getAnalysis<MachineBlockFrequencyInfo>();
+    EntryFreq = MBFI.getEntryFreq();
+    for (const MachineBasicBlock &MBB : *MF)
+      BlockFreqs[&MBB] = MBFI.getBlockFreq(&MBB).getFrequency();
+  }
+
   // Perform the initial placement of the constant pool entries.  To start with,
   // we put them all at the end of the function.
   std::vector<MachineInstr*> CPEMIs;
@@ -457,18 +487,31 @@ bool ARMConstantIslands::runOnMachineFunction(MachineFunction &mf) {
   if (isThumb && !HasFarJump && AFI->isLRSpilledForFarJump())
     MadeChange |= undoLRSpillRestore();
 
-  // Save the mapping between original and cloned constpool entries.
+  // Save the mapping between original and cloned constpool entries, and
+  // count the bytes of the entries still placed.
+  unsigned IslandBytes = 0;
   for (unsigned i = 0, e = CPEntries.size(); i != e; ++i) {
     for (unsigned j = 0, je = CPEntries[i].size(); j != je; ++j) {
       const CPEntry & CPE = CPEntries[i][j];
+      if (CPE.CPEMI)
+        IslandBytes += CPE.CPEMI->getOperand(2).getImm();
       if (CPE.CPEMI && CPE.CPEMI->getOperand(1).isCPI())
         AFI->recordCPEClone(i, CPE.CPI);
     }
   }
+  NumIslandBytes += IslandBytes;
+
+  // Report the island bytes of Pagerando functions, whose bins were assigned
+  // from an estimate of them.
+  if (MF->getFunction().isPagerando())
+    if (auto *BinReport = getAnalysisIfAvailable<PagerandoBinReport>())
+      if (BinReport->isEnabled())
+        BinReport->recordIslandSize(MF->getFunction(), IslandBytes);
 
   LLVM_DEBUG(dbgs() << '\n'; dumpBBs());
 
   BBInfo.clear();
+  BlockFreqs.clear();
   WaterList.clear();
   CPUsers.clear();
   CPEntries.clear();
@@ -1224,7 +1267,8 @@ static inline unsigned getUnconditionalBrDisp(int Opc) {
 /// introduce padding to water that will.  To ensure that this pass
 /// terminates, the CPE location for a particular CPUser is only allowed to
 /// move to a lower address, so search backward from the end of the list and
-/// prefer the first water that is in range.
+/// prefer the first water that is in range. With profile-guided placement,
+/// water outside hot regions is preferred over water with less padding.
 bool ARMConstantIslands::findAvailableWater(CPUser &U, unsigned UserOffset,
                                             water_iterator &WaterIter,
                                             bool CloserWater) {
@@ -1232,6 +1276,7 @@ bool ARMConstantIslands::findAvailableWater(CPUser &U, unsigned UserOffset,
     return false;
 
   unsigned BestGrowth = ~0u;
+  bool BestHot = true;
   // The nearest water without splitting the UserBB is right after it.
   // If the distance is still large (we have a big BB), then we need to split it
   // if we don't converge after certain iterations. This helps the following
@@ -1263,20 +1308,25 @@ bool ARMConstantIslands::findAvailableWater(CPUser &U, unsigned UserOffset,
     unsigned Growth;
     if (isWaterInRange(UserOffset, WaterBB, U, Growth) &&
         (WaterBB->getNumber() < U.HighWaterMark->getNumber() ||
-         NewWaterList.count(WaterBB) || WaterBB == U.MI->getParent()) &&
-        Growth < BestGrowth) {
-      // This is the least amount of required padding seen so far.
-      BestGrowth = Growth;
-      WaterIter = IP;
-      LLVM_DEBUG(dbgs() << "Found water after " << printMBBReference(*WaterBB)
-                        << " Growth=" << Growth << '\n');
-
-      if (CloserWater && WaterBB == U.MI->getParent())
-        return true;
-      // Keep looking unless it is perfect and we're not looking for the lowest
-      // possible address.
-      if (!CloserWater && BestGrowth == 0)
-        return true;
+         NewWaterList.count(WaterBB) || WaterBB == U.MI->getParent())) {
+      bool Hot = ProfileGuidedIslands && isHotWater(WaterBB);
+      if (Hot < BestHot || (Hot == BestHot && Growth < BestGrowth)) {
+        // This is the least amount of required padding seen so far, in the
+        // coldest region seen so far.
+        BestGrowth = Growth;
+        BestHot = Hot;
+        WaterIter = IP;
+        LLVM_DEBUG(dbgs() << "Found water after "
+                          << printMBBReference(*WaterBB) << " Growth=" << Growth
+                          << (Hot ? " (hot)" : "") << '\n');
+
+        if (CloserWater && WaterBB == U.MI->getParent())
+          return true;
+        // Keep looking unless it is perfect and we're not looking for the
+        // lowest possible address.
+        if (!CloserWater && BestGrowth == 0 && !BestHot)
+          return true;
+      }
     }
     if (IP == B)
       break;
@@ -1284,6 +1334,29 @@ bool ARMConstantIslands::findAvailableWater(CPUser &U, unsigned UserOffset,
   return BestGrowth != ~0u;
 }
 
+/// isHotBlock - Returns true if MBB runs more often than the function entry.
+/// Blocks created by this pass take the frequency of the closest preceding
+/// block that existed before: split blocks are the second half of it and
+/// islands are never executed.
+bool ARMConstantIslands::isHotBlock(const MachineBasicBlock *MBB) const {
+  for (MachineFunction::const_iterator I = MBB->getIterator(),
+                                       B = MF->begin();; --I) {
+    auto F = BlockFreqs.find(&*I);
+    if (F != BlockFreqs.end())
+      return F->second > EntryFreq;
+    if (I == B)
+      return false;
+  }
+}
+
+/// isHotWater - Returns true if an island placed after Water would sit
+/// between two hot blocks, e.g. inside a loop, where it costs instruction
+/// cache and may need a branch around it.
+bool ARMConstantIslands::isHotWater(MachineBasicBlock *Water) const {
+  MachineFunction::const_iterator Next = std::next(Water->getIterator());
+  return isHotBlock(Water) && Next != MF->end() && isHotBlock(&*Next);
+}
+
 /// createNewWater - No existing WaterList entry will work for
 /// CPUsers[CPUserIndex], so create a place to put the CPE.  The end of the
 /// block is used if in range, and the conditional branch munged so control
@@ -3122,7 +3122,14 @@ ARMTargetLowering::LowerPOT(SDValue Op, SelectionDAG &DAG) const {
   MachineFunction &MF = DAG.getMachineFunction();
   unsigned POTReg = getPOTBaseRegister();
   if (MF.getFunction().isPagerando()) {
-    return DAG.getCopyFromReg(DAG.getEntryNode(), dl, POTReg, PtrVT);
+    // Copy the POT base register only once, in the entry block. A copy next to
+    // every use would make the POT loads that depend on it look loop-variant
+    // to MachineLICM.
+    ARMFunctionInfo *AFI = MF.getInfo<ARMFunctionInfo>();
+    const TargetRegisterClass *RC =
+        AFI->isThumb1OnlyFunction() ? &ARM::tGPRRegClass : &ARM::GPRRegClass;
+    unsigned VReg = MF.addLiveIn(POTReg, RC);
+    return DAG.getCopyFromReg(DAG.getEntryNode(), dl, VReg, PtrVT);
   } else {
     // Need to materialize the POT address
     ARMFunctionInfo *AFI = MF.getInfo<ARMFunctionInfo>();
@@ -11,7 +11,10 @@
 #include "llvm/ADT/StringSwitch.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Support/Error.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/YAMLTraits.h"
+#include "llvm/Support/raw_ostream.h"
 #include "llvm/TextAPI/ELF/ELFStub.h"
 
 using namespace llvm;
@@ -48,6 +51,12 @@ template <> struct ScalarTraits<ELFArchMapper> {
     case (ELFArch)ELF::EM_AARCH64:
       Out << "AArch64";
       break;
+    case (ELFArch)ELF::EM_ARM:
+      Out << "ARM";
+      break;
+    case (ELFArch)ELF::EM_386:
+      Out << "x86";
+      break;
     case (ELFArch)ELF::EM_NONE:
     default:
       Out << "Unknown";
@@ -59,6 +68,8 @@ template <> struct ScalarTraits<ELFArchMapper> {
     Value = StringSwitch<ELFArch>(Scalar)
                 .Case("x86_64", ELF::EM_X86_64)
                 .Case("AArch64", ELF::EM_AARCH64)
+                .Case("ARM", ELF::EM_ARM)
+                .Case("x86", ELF::EM_386)
                 .Case("Unknown", ELF::EM_NONE)
                 .Default(ELF::EM_NONE);
 
@@ -113,16 +124,29 @@ template <> struct MappingTraits<ELFSymbol> {
 };
 
 /// YAML traits for set of ELFSymbols.
+///
+/// A versioned symbol is keyed as in symbol version scripts: "name@@version"
+/// for the default version of the name, and "name@version" for the others.
 template <> struct CustomMappingTraits<std::set<ELFSymbol>> {
   static void inputOne(IO &IO, StringRef Key, std::set<ELFSymbol> &Set) {
-    ELFSymbol Sym(Key.str());
+    StringRef Name, Version;
+    std::tie(Name, Version) = Key.split('@');
+    ELFSymbol Sym(Name.str());
     IO.mapRequired(Key.str().c_str(), Sym);
+    if (Key.contains('@')) {
+      Sym.DefaultVersion = Version.consume_front("@");
+      Sym.Version = Version.str();
+    }
     Set.insert(Sym);
   }
 
   static void output(IO &IO, std::set<ELFSymbol> &Set) {
-    for (auto &Sym : Set)
-      IO.mapRequired(Sym.Name.c_str(), const_cast<ELFSymbol &>(Sym));
+    for (auto &Sym : Set) {
+      std::string Key = Sym.Name;
+      if (Sym.Version)
+        Key += (Sym.DefaultVersion ? "@@" : "@") + *Sym.Version;
+      IO.mapRequired(Key.c_str(), const_cast<ELFSymbol &>(Sym));
+    }
   }
 };
 
@@ -158,3 +182,31 @@ Error elfabi::writeTBEToOutputStream(raw_ostream &OS, const ELFStub &Stub) {
   YamlOut << const_cast<ELFStub &>(Stub);
   return Error::success();
 }
+
+Error elfabi::writeTBEToFileIfChanged(StringRef FilePath, const ELFStub &Stub) {
+  std::string Text;
+  raw_string_ostream OS(Text);
+  if (Error Err = writeTBEToOutputStream(OS, Stub))
+    return Err;
+  OS.flush();
+
+  // Symbols are written sorted, so an unchanged interface gives the same text.
+  ErrorOr<std::unique_ptr<MemoryBuffer>> Old =
+      MemoryBuffer::getFile(FilePath, /*FileSize=*/-1,
+                            /*RequiresNullTerminator=*/false);
+  if (Old && (*Old)->getBuffer() == Text)
+    return Error::success();
+
+  std::error_code EC;
+  raw_fd_ostream Out(FilePath, EC, sys::fs::F_Text);
+  if (EC)
+    return createStringError(EC, "cannot open %s", FilePath.str().c_str());
+  Out << Text;
+  Out.close();
+  if (Out.has_error()) {
+    EC = Out.error();
+    Out.clear_error();
+    return createStringError(EC, "cannot write %s", FilePath.str().c_str());
+  }
+  return Error::success();
+}
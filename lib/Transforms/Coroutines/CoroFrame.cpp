@@ -14,7 +14,8 @@
 // GEP + load from the coroutine frame. At the point of the definition we spill
 // the value into the coroutine frame.
 //
-// TODO: pack values tightly using liveness info.
+// Spilled values of the same type share a field when the blocks in which they
+// have to stay in the frame do not overlap.
 //===----------------------------------------------------------------------===//
 
 #include "CoroInternal.h"
@@ -25,6 +26,7 @@
 #include "llvm/IR/Dominators.h"
 #include "llvm/IR/IRBuilder.h"
 #include "llvm/IR/InstIterator.h"
+#include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/MathExtras.h"
 #include "llvm/Support/circular_raw_ostream.h"
@@ -38,6 +40,11 @@ using namespace llvm;
 
 enum { SmallVectorThreshold = 32 };
 
+static cl::opt<bool> ReuseFrameSlots(
+    "coro-reuse-frame-slots", cl::Hidden, cl::init(true),
+    cl::desc("Let spilled values whose lifetimes in the coroutine frame do "
+             "not overlap share a frame field"));
+
 // Provides two way mapping between the blocks and numbers.
 namespace {
 class BlockToIndexMapping {
@@ -131,6 +138,22 @@ struct SuspendCrossingInfo {
   bool isDefinitionAcrossSuspend(Instruction &I, User *U) const {
     return isDefinitionAcrossSuspend(I.getParent(), U);
   }
+
+  // Returns the blocks on a path from DefBB to one of UseBBs. A value spilled
+  // in DefBB and reloaded in UseBBs must stay in its frame field in all of
+  // them, and in no others.
+  BitVector getFrameLiveBlocks(BasicBlock *DefBB,
+                               ArrayRef<BasicBlock *> UseBBs) const {
+    size_t const DefIndex = Mapping.blockToIndex(DefBB);
+    BitVector Result(Block.size());
+    for (BasicBlock *UseBB : UseBBs) {
+      auto const &UseConsumes = Block[Mapping.blockToIndex(UseBB)].Consumes;
+      for (size_t I = 0, E = Block.size(); I != E; ++I)
+        if (UseConsumes[I] && Block[I].Consumes[DefIndex])
+          Result.set(I);
+    }
+    return Result;
+  }
 };
 } // end anonymous namespace
 
@@ -370,7 +393,8 @@ struct PaddingCalculator {
 //     ... spills ...
 //   };
 static StructType *buildFrameType(Function &F, coro::Shape &Shape,
-                                  SpillInfo &Spills) {
+                                  SpillInfo &Spills,
+                                  const SuspendCrossingInfo &Checker) {
   LLVMContext &C = F.getContext();
   const DataLayout &DL = F.getParent()->getDataLayout();
   PaddingCalculator Padder(C, DL);
@@ -393,8 +417,13 @@ static StructType *buildFrameType(Function &F, coro::Shape &Shape,
 
   Padder.addTypes(Types);
 
+  // The fields that hold spilled SSA values, and the blocks in which some
+  // value assigned to them has to stay in the frame.
+  SmallVector<std::pair<unsigned, BitVector>, 8> ValueFields;
+
   // Create an entry for every spilled value.
-  for (auto &S : Spills) {
+  for (auto I = Spills.begin(), E = Spills.end(); I != E; ++I) {
+    Spill &S = *I;
     if (CurrentDef == S.def())
       continue;
 
@@ -403,6 +432,33 @@ static StructType *buildFrameType(Function &F, coro::Shape &Shape,
     if (CurrentDef == Shape.PromiseAlloca)
       continue;
 
+    // Allocas live in the frame for the whole coroutine, but an SSA value only
+    // needs its field between its spill and its last reload. Reuse the field
+    // of a value of the same type if those blocks do not overlap.
+    BitVector LiveBlocks;
+    if (ReuseFrameSlots && !isa<AllocaInst>(CurrentDef)) {
+      BasicBlock *DefBB = isa<Argument>(CurrentDef)
+                              ? &F.getEntryBlock()
+                              : cast<Instruction>(CurrentDef)->getParent();
+      SmallVector<BasicBlock *, 4> UseBBs;
+      for (auto J = I; J != E && J->def() == CurrentDef; ++J)
+        UseBBs.push_back(J->userBlock());
+      LiveBlocks = Checker.getFrameLiveBlocks(DefBB, UseBBs);
+
+      auto Field = llvm::find_if(
+          ValueFields, [&](const std::pair<unsigned, BitVector> &VF) {
+            return Types[VF.first] == CurrentDef->getType() &&
+                   !VF.second.anyCommon(LiveBlocks);
+          });
+      if (Field != ValueFields.end()) {
+        LLVM_DEBUG(dbgs() << "Reusing frame field " << Field->first << " for "
+                          << CurrentDef->getName() << "\n");
+        Field->second |= LiveBlocks;
+        S.setFieldIndex(Field->first);
+        continue;
+      }
+    }
+
     Type *Ty = nullptr;
     if (auto *AI = dyn_cast<AllocaInst>(CurrentDef)) {
       Ty = AI->getAllocatedType();
@@ -416,6 +472,8 @@ static StructType *buildFrameType(Function &F, coro::Shape &Shape,
       }
     } else {
       Ty = CurrentDef->getType();
+      if (!LiveBlocks.empty())
+        ValueFields.emplace_back(Types.size(), std::move(LiveBlocks));
     }
     S.setFieldIndex(Types.size());
     Types.push_back(Ty);
@@ -939,6 +997,6 @@ void coro::buildCoroutineFrame(Function &F, Shape &Shape) {
   }
   LLVM_DEBUG(dump("Spills", Spills));
   moveSpillUsesAfterCoroBegin(F, Spills, Shape.CoroBegin);
-  Shape.FrameTy = buildFrameType(F, Shape, Spills);
+  Shape.FrameTy = buildFrameType(F, Shape, Spills, Checker);
   Shape.FramePtr = insertSpills(Spills, Shape);
 }
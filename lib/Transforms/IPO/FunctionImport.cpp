@@ -17,6 +17,7 @@
 #include "llvm/ADT/SetVector.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/Statistic.h"
+#include "llvm/ADT/StringExtras.h"
 #include "llvm/ADT/StringMap.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/ADT/StringSet.h"
@@ -42,6 +43,11 @@
 #include "llvm/Support/Error.h"
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/LineIterator.h"
+#include "llvm/Support/MD5.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Parallel.h"
+#include "llvm/Support/Path.h"
 #include "llvm/Support/SourceMgr.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Transforms/IPO/Internalize.h"
@@ -51,6 +57,7 @@
 #include <cassert>
 #include <memory>
 #include <set>
+#include <set>
 #include <string>
 #include <system_error>
 #include <tuple>
@@ -72,6 +79,11 @@ STATISTIC(NumImportedFunctions, "Number of functions imported in backend");
 STATISTIC(NumImportedGlobalVars,
           "Number of global variables imported in backend");
 STATISTIC(NumImportedModules, "Number of modules imported from");
+STATISTIC(NumModuleImportsReused,
+          "Number of modules whose import lists were reused from a previous "
+          "link");
+STATISTIC(NumImportsOverBudget,
+          "Number of function imports dropped by -import-budget");
 STATISTIC(NumDeadSymbols, "Number of dead stripped symbols in index");
 STATISTIC(NumLiveSymbols, "Number of live symbols in index");
 
@@ -123,6 +135,26 @@ static cl::opt<bool> PrintImportFailures(
 static cl::opt<bool> ComputeDead("compute-dead", cl::init(true), cl::Hidden,
                                  cl::desc("Compute dead symbols"));
 
+static cl::opt<unsigned> ImportBudget(
+    "import-budget", cl::init(0), cl::Hidden, cl::value_desc("N"),
+    cl::desc("Cap the total number of instructions imported into all modules, "
+             "keeping the imports with the hottest callsites (0 = no cap)"));
+
+static cl::opt<std::string> IncrementalImportDir(
+    "thinlto-incremental-import-dir", cl::Hidden, cl::value_desc("directory"),
+    cl::desc("Save the import and export lists computed for each module in "
+             "this directory, and reuse them in later links if the summaries "
+             "they depend on did not change"));
+
+static cl::opt<bool> ThinLinkParallelism(
+    "thin-link-parallelism", cl::init(true), cl::Hidden,
+    cl::desc("Compute import lists and dead symbols in parallel"));
+
+static cl::opt<unsigned> ParallelLivenessThreshold(
+    "parallel-liveness-threshold", cl::init(1024), cl::Hidden,
+    cl::desc("Minimum number of values in a dead symbol analysis frontier "
+             "that is processed in parallel"));
+
 static cl::opt<bool> EnableImportMetadata(
     "enable-import-metadata", cl::init(
 #if !defined(NDEBUG)
@@ -342,6 +374,24 @@ getFailureName(FunctionImporter::ImportFailureReason Reason) {
   llvm_unreachable("invalid reason");
 }
 
+/// Import priority of a function: the hottest edge through which it is
+/// imported into a module.
+using ImportPriorityMapTy = DenseMap<GlobalValue::GUID, uint64_t>;
+
+/// Priority of importing through a call edge under -import-budget. Edges are
+/// ordered by profile hotness first, then by relative block frequency.
+static uint64_t getImportPriority(const CalleeInfo &CI) {
+  uint64_t Rank;
+  switch (CI.getHotness()) {
+  case CalleeInfo::HotnessType::Cold:     Rank = 0; break;
+  case CalleeInfo::HotnessType::Unknown:
+  case CalleeInfo::HotnessType::None:     Rank = 1; break;
+  case CalleeInfo::HotnessType::Hot:      Rank = 2; break;
+  case CalleeInfo::HotnessType::Critical: Rank = 3; break;
+  }
+  return Rank << 32 | CI.RelBlockFreq;
+}
+
 /// Compute the list of functions to import for a given caller. Mark these
 /// imported functions and the symbols they reference in their source module as
 /// exported from their source module.
@@ -351,7 +401,8 @@ static void computeImportForFunction(
     SmallVectorImpl<EdgeInfo> &Worklist,
     FunctionImporter::ImportMapTy &ImportList,
     StringMap<FunctionImporter::ExportSetTy> *ExportLists,
-    FunctionImporter::ImportThresholdsTy &ImportThresholds) {
+    FunctionImporter::ImportThresholdsTy &ImportThresholds,
+    ImportPriorityMapTy *ImportPriorities) {
   computeImportForReferencedGlobals(Summary, DefinedGVSummaries, ImportList,
                                     ExportLists);
   static int ImportCount = 0;
@@ -400,9 +451,19 @@ static void computeImportForFunction(
     bool IsCriticalCallsite =
         Edge.second.getHotness() == CalleeInfo::HotnessType::Critical;
 
+    // Every edge to an imported function counts towards its priority, even if
+    // it does not raise the import threshold.
+    auto RecordPriority = [&]() {
+      if (ImportPriorities) {
+        uint64_t &Priority = (*ImportPriorities)[VI.getGUID()];
+        Priority = std::max(Priority, getImportPriority(Edge.second));
+      }
+    };
+
     const FunctionSummary *ResolvedCalleeSummary = nullptr;
     if (CalleeSummary) {
       assert(PreviouslyVisited);
+      RecordPriority();
       // Since the traversal of the call graph is DFS, we can revisit a function
       // a second time with a higher threshold. In this case, it is added back
       // to the worklist with the new threshold (so that its own callee chains
@@ -513,7 +574,12 @@ static void computeImportForFunction(
 
     const auto AdjThreshold = GetAdjustedThreshold(Threshold, IsHotCallsite);
 
-    ImportCount++;
+    RecordPriority();
+
+    // Only counted when a cutoff is requested, which disables parallel import
+    // computation.
+    if (ImportCutoff >= 0)
+      ImportCount++;
 
     // Insert the newly imported function to the worklist.
     Worklist.emplace_back(ResolvedCalleeSummary, AdjThreshold, VI.getGUID());
@@ -526,7 +592,8 @@ static void computeImportForFunction(
 static void ComputeImportForModule(
     const GVSummaryMapTy &DefinedGVSummaries, const ModuleSummaryIndex &Index,
     StringRef ModName, FunctionImporter::ImportMapTy &ImportList,
-    StringMap<FunctionImporter::ExportSetTy> *ExportLists = nullptr) {
+    StringMap<FunctionImporter::ExportSetTy> *ExportLists = nullptr,
+    ImportPriorityMapTy *ImportPriorities = nullptr) {
   // Worklist contains the list of function imported in this module, for which
   // we will analyse the callees and may import further down the callgraph.
   SmallVector<EdgeInfo, 128> Worklist;
@@ -552,7 +619,7 @@ static void ComputeImportForModule(
     LLVM_DEBUG(dbgs() << "Initialize import for " << VI << "\n");
     computeImportForFunction(*FuncSummary, Index, ImportInstrLimit,
                              DefinedGVSummaries, Worklist, ImportList,
-                             ExportLists, ImportThresholds);
+                             ExportLists, ImportThresholds, ImportPriorities);
   }
 
   // Process the newly imported functions and add callees to the worklist.
@@ -563,7 +630,7 @@ static void ComputeImportForModule(
 
     computeImportForFunction(*Summary, Index, Threshold, DefinedGVSummaries,
                              Worklist, ImportList, ExportLists,
-                             ImportThresholds);
+                             ImportThresholds, ImportPriorities);
   }
 
   // Print stats about functions considered but rejected for importing
@@ -615,6 +682,256 @@ static unsigned numGlobalVarSummaries(const ModuleSummaryIndex &Index,
 }
 #endif
 
+// The thin-link analyses below run in parallel unless their debugging output
+// or -import-cutoff depend on the order in which modules are processed.
+static bool useParallelThinLinkAnalysis() {
+  if (!ThinLinkParallelism || PrintImportFailures || ImportCutoff >= 0)
+    return false;
+  LLVM_DEBUG(return false);
+  return true;
+}
+
+namespace {
+/// Import and export lists computed for one module by
+/// ComputeCrossModuleImport.
+struct ModuleImports {
+  const StringMapEntry<GVSummaryMapTy> *DefinedGVSummaries;
+  FunctionImporter::ImportMapTy *ImportList;
+  StringMap<FunctionImporter::ExportSetTy> ExportLists;
+  ImportPriorityMapTy Priorities;
+
+  ModuleImports(const StringMapEntry<GVSummaryMapTy> *DefinedGVSummaries,
+                FunctionImporter::ImportMapTy *ImportList)
+      : DefinedGVSummaries(DefinedGVSummaries), ImportList(ImportList) {}
+};
+} // end anonymous namespace
+
+// The import lists of a module are a function of the summaries reached while
+// computing them: the summaries defined in the module and the callees and
+// references of every summary it imports. For incremental thin links, every
+// module records the GUIDs of these summaries along with a fingerprint of the
+// modules that define them. A later link reuses the recorded lists if all
+// fingerprints still match. A fingerprint covers the hash of every module that
+// has a summary for the GUID, which covers the summary contents, as well as
+// the linkage and liveness of each summary, which are updated during the thin
+// link.
+
+/// Fingerprint of the import options. Lists recorded with other options are
+/// not reused.
+static uint64_t getImportOptionsFingerprint(const ModuleSummaryIndex &Index) {
+  std::string Str;
+  raw_string_ostream OS(Str);
+  OS << "v1 " << ImportInstrLimit << ' ' << ImportInstrFactor << ' '
+     << ImportHotInstrFactor << ' ' << ImportHotMultiplier << ' '
+     << ImportCriticalMultiplier << ' ' << ImportColdMultiplier << ' '
+     << Index.withGlobalValueDeadStripping();
+  return MD5Hash(OS.str());
+}
+
+/// Fingerprint of the summaries of GUID. Returns None if one of them comes
+/// from a module without a hash.
+static Optional<uint64_t>
+getSummariesFingerprint(const ModuleSummaryIndex &Index,
+                        GlobalValue::GUID GUID) {
+  SmallVector<const GlobalValueSummary *, 4> Summaries;
+  if (auto VI = Index.getValueInfo(GUID))
+    for (auto &S : VI.getSummaryList())
+      Summaries.push_back(S.get());
+  llvm::sort(Summaries, [](const GlobalValueSummary *A,
+                           const GlobalValueSummary *B) {
+    return A->modulePath() < B->modulePath();
+  });
+
+  MD5 Hasher;
+  for (const GlobalValueSummary *S : Summaries) {
+    const ModuleHash &Hash = Index.getModuleHash(S->modulePath());
+    if (all_of(Hash, [](uint32_t V) { return V == 0; }))
+      return None;
+    Hasher.update(S->modulePath());
+    Hasher.update(ArrayRef<uint8_t>((const uint8_t *)&Hash[0], sizeof(Hash)));
+    uint8_t Flags[] = {uint8_t(S->linkage()), Index.isGlobalValueLive(S),
+                       S->notEligibleToImport(), uint8_t(S->getSummaryKind())};
+    Hasher.update(Flags);
+  }
+  MD5::MD5Result Result;
+  Hasher.final(Result);
+  return Result.low();
+}
+
+static std::string getIncrementalImportFile(StringRef ModulePath) {
+  SmallString<128> Path(IncrementalImportDir);
+  sys::path::append(Path, utohexstr(MD5Hash(ModulePath)) + ".imports");
+  return Path.str();
+}
+
+/// Load the import and export lists recorded for M by a previous link, if
+/// they are still valid.
+static bool loadIncrementalImports(const ModuleSummaryIndex &Index,
+                                   ModuleImports &M) {
+  StringRef ModulePath = M.DefinedGVSummaries->first();
+  auto BufOrErr = MemoryBuffer::getFile(getIncrementalImportFile(ModulePath));
+  if (!BufOrErr)
+    return false;
+
+  FunctionImporter::ImportMapTy ImportList;
+  StringMap<FunctionImporter::ExportSetTy> ExportLists;
+  bool SeenKey = false;
+  for (line_iterator I(**BufOrErr, /*SkipBlanks*/ true), E; I != E; ++I) {
+    StringRef Kind, GUIDStr, Rest;
+    std::tie(Kind, Rest) = I->split(' ');
+    std::tie(GUIDStr, Rest) = Rest.split(' ');
+    uint64_t Value;
+    if (GUIDStr.getAsInteger(10, Value))
+      return false;
+    if (Kind == "key") {
+      // The module path guards against collisions of the file name.
+      if (Value != getImportOptionsFingerprint(Index) || Rest != ModulePath)
+        return false;
+      SeenKey = true;
+    } else if (Kind == "dep") {
+      uint64_t Fingerprint;
+      if (Rest.getAsInteger(10, Fingerprint))
+        return false;
+      auto Current = getSummariesFingerprint(Index, Value);
+      if (!Current || *Current != Fingerprint)
+        return false;
+    } else if (Kind == "import") {
+      ImportList[Rest].insert(Value);
+    } else if (Kind == "export") {
+      ExportLists[Rest].insert(Value);
+    } else {
+      return false;
+    }
+  }
+  if (!SeenKey)
+    return false;
+
+  *M.ImportList = std::move(ImportList);
+  M.ExportLists = std::move(ExportLists);
+  return true;
+}
+
+/// Record the import and export lists computed for M, together with the
+/// fingerprints of the summaries they depend on.
+static void saveIncrementalImports(const ModuleSummaryIndex &Index,
+                                   const ModuleImports &M) {
+  StringRef ModulePath = M.DefinedGVSummaries->first();
+  std::set<GlobalValue::GUID> Deps;
+  auto AddDeps = [&](GlobalValue::GUID GUID, const GlobalValueSummary *S) {
+    Deps.insert(GUID);
+    if (auto *FS = dyn_cast<FunctionSummary>(S->getBaseObject())) {
+      for (auto &Call : FS->calls())
+        Deps.insert(Call.first.getGUID());
+    }
+    for (auto &Ref : S->getBaseObject()->refs())
+      Deps.insert(Ref.getGUID());
+  };
+  for (auto &GVS : M.DefinedGVSummaries->second)
+    AddDeps(GVS.first, GVS.second);
+  for (auto &Src : *M.ImportList)
+    for (auto GUID : Src.second)
+      if (auto *S = Index.findSummaryInModule(GUID, Src.first()))
+        AddDeps(GUID, S);
+
+  std::string Str;
+  raw_string_ostream OS(Str);
+  OS << "key " << getImportOptionsFingerprint(Index) << ' ' << ModulePath
+     << '\n';
+  for (auto GUID : Deps) {
+    auto Fingerprint = getSummariesFingerprint(Index, GUID);
+    if (!Fingerprint)
+      return;
+    OS << "dep " << GUID << ' ' << *Fingerprint << '\n';
+  }
+  for (auto &Src : *M.ImportList)
+    for (auto GUID : Src.second)
+      OS << "import " << GUID << ' ' << Src.first() << '\n';
+  for (auto &Exports : M.ExportLists)
+    for (auto GUID : Exports.second)
+      OS << "export " << GUID << ' ' << Exports.first() << '\n';
+  OS.flush();
+
+  // Write to a temporary file and rename it, so that concurrent links never
+  // see a partial file.
+  std::string Path = getIncrementalImportFile(ModulePath);
+  SmallString<128> TempPath;
+  int FD;
+  if (sys::fs::createUniqueFile(Path + ".%%%%%%.tmp", FD, TempPath))
+    return;
+  {
+    raw_fd_ostream TempOS(FD, /*shouldClose*/ true);
+    TempOS << Str;
+  }
+  if (sys::fs::rename(TempPath, Path))
+    sys::fs::remove(TempPath);
+}
+
+/// Keep the function imports with the highest priority across all modules
+/// whose total instruction count fits within -import-budget, and drop the
+/// others. Remaining functions are still exported by their source modules,
+/// which only costs an unneeded promotion.
+static void applyImportBudget(const ModuleSummaryIndex &Index,
+                              std::vector<ModuleImports> &Modules) {
+  struct Candidate {
+    uint64_t Priority;
+    unsigned InstCount;
+    unsigned Module;
+    StringRef SrcModule;
+    GlobalValue::GUID GUID;
+  };
+  std::vector<Candidate> Candidates;
+  for (unsigned I = 0, E = Modules.size(); I != E; ++I) {
+    auto &M = Modules[I];
+    for (auto &Src : *M.ImportList) {
+      for (auto GUID : Src.second) {
+        auto It = M.Priorities.find(GUID);
+        // Only functions have a priority, global variables are always kept.
+        if (It == M.Priorities.end())
+          continue;
+        auto *Summary = Index.findSummaryInModule(GUID, Src.first());
+        if (!Summary)
+          continue;
+        auto *FS = cast<FunctionSummary>(Summary->getBaseObject());
+        Candidates.push_back(
+            {It->second, FS->instCount(), I, Src.first(), GUID});
+      }
+    }
+  }
+
+  // Sort hottest first and smallest first among equally hot candidates. Ties
+  // are broken by name and GUID so the result does not depend on the order
+  // of the import lists.
+  llvm::sort(Candidates, [&](const Candidate &A, const Candidate &B) {
+    if (A.Priority != B.Priority)
+      return A.Priority > B.Priority;
+    if (A.InstCount != B.InstCount)
+      return A.InstCount < B.InstCount;
+    StringRef AName = Modules[A.Module].DefinedGVSummaries->first();
+    StringRef BName = Modules[B.Module].DefinedGVSummaries->first();
+    if (AName != BName)
+      return AName < BName;
+    if (A.SrcModule != B.SrcModule)
+      return A.SrcModule < B.SrcModule;
+    return A.GUID < B.GUID;
+  });
+
+  uint64_t Used = 0;
+  for (auto &C : Candidates) {
+    if (Used + C.InstCount <= ImportBudget) {
+      Used += C.InstCount;
+      continue;
+    }
+    auto &ImportList = *Modules[C.Module].ImportList;
+    auto Src = ImportList.find(C.SrcModule);
+    Src->second.erase(C.GUID);
+    if (Src->second.empty())
+      ImportList.erase(Src);
+    ++NumImportsOverBudget;
+  }
+  LLVM_DEBUG(dbgs() << "Import budget: kept " << Used << " of " << ImportBudget
+                    << " instructions\n");
+}
+
 /// Compute all the import and export for every module using the Index.
 void llvm::ComputeCrossModuleImport(
     const ModuleSummaryIndex &Index,
@@ -622,14 +939,52 @@ void llvm::ComputeCrossModuleImport(
     StringMap<FunctionImporter::ImportMapTy> &ImportLists,
     StringMap<FunctionImporter::ExportSetTy> &ExportLists) {
   // For each module that has function defined, compute the import/export lists.
-  for (auto &DefinedGVSummaries : ModuleToDefinedGVSummaries) {
-    auto &ImportList = ImportLists[DefinedGVSummaries.first()];
+  // Modules are processed in parallel. Every module records its exports in a
+  // private map and the maps are merged afterwards, so the result does not
+  // depend on the schedule.
+  std::vector<ModuleImports> Modules;
+  Modules.reserve(ModuleToDefinedGVSummaries.size());
+  for (auto &DefinedGVSummaries : ModuleToDefinedGVSummaries)
+    Modules.emplace_back(&DefinedGVSummaries,
+                         &ImportLists[DefinedGVSummaries.first()]);
+
+  // The global import budget depends on all modules, so the lists of single
+  // modules cannot be reused with it.
+  bool Incremental = !IncrementalImportDir.empty() && !ImportBudget;
+  if (Incremental)
+    sys::fs::create_directories(IncrementalImportDir);
+
+  auto ComputeImports = [&](size_t I) {
+    auto &M = Modules[I];
+    if (Incremental && loadIncrementalImports(Index, M)) {
+      LLVM_DEBUG(dbgs() << "Reusing import for Module '"
+                        << M.DefinedGVSummaries->first() << "'\n");
+      ++NumModuleImportsReused;
+      return;
+    }
     LLVM_DEBUG(dbgs() << "Computing import for Module '"
-                      << DefinedGVSummaries.first() << "'\n");
-    ComputeImportForModule(DefinedGVSummaries.second, Index,
-                           DefinedGVSummaries.first(), ImportList,
-                           &ExportLists);
-  }
+                      << M.DefinedGVSummaries->first() << "'\n");
+    ComputeImportForModule(M.DefinedGVSummaries->second, Index,
+                           M.DefinedGVSummaries->first(), *M.ImportList,
+                           &M.ExportLists,
+                           ImportBudget ? &M.Priorities : nullptr);
+    if (Incremental)
+      saveIncrementalImports(Index, M);
+  };
+  if (useParallelThinLinkAnalysis())
+    parallel::for_each_n(parallel::par, size_t(0), Modules.size(),
+                         ComputeImports);
+  else
+    for (size_t I = 0, E = Modules.size(); I != E; ++I)
+      ComputeImports(I);
+
+  if (ImportBudget)
+    applyImportBudget(Index, Modules);
+
+  for (auto &M : Modules)
+    for (auto &ELI : M.ExportLists)
+      ExportLists[ELI.first()].insert(ELI.second.begin(), ELI.second.end());
+  Modules.clear();
 
   // When computing imports we added all GUIDs referenced by anything
   // imported from the module to its ExportList. Now we prune each ExportList
@@ -812,18 +1167,51 @@ void llvm::computeDeadSymbols(
     Worklist.push_back(VI);
   };
 
-  while (!Worklist.empty()) {
-    auto VI = Worklist.pop_back_val();
-    for (auto &Summary : VI.getSummaryList()) {
+  // Propagate liveness one frontier at a time. Collecting the edges of the
+  // frontier only reads the index and runs in parallel. Marking the targets
+  // live runs serially, so the result does not depend on the schedule.
+  std::vector<ValueInfo> Frontier;
+  std::vector<std::vector<ValueInfo>> Targets;
+  auto CollectTargets = [&](size_t I) {
+    auto &T = Targets[I];
+    auto AddTarget = [&](ValueInfo VI) {
+      VI = updateValueInfoForIndirectCalls(Index, VI);
+      if (VI && llvm::none_of(VI.getSummaryList(),
+                              [](const std::unique_ptr<GlobalValueSummary> &S) {
+                                return S->isLive();
+                              }))
+        T.push_back(VI);
+    };
+    for (auto &Summary : Frontier[I].getSummaryList()) {
       GlobalValueSummary *Base = Summary->getBaseObject();
-      // Set base value live in case it is an alias.
-      Base->setLive(true);
       for (auto Ref : Base->refs())
-        visit(Ref);
+        AddTarget(Ref);
       if (auto *FS = dyn_cast<FunctionSummary>(Base))
         for (auto Call : FS->calls())
-          visit(Call.first);
+          AddTarget(Call.first);
     }
+  };
+  bool Parallel = useParallelThinLinkAnalysis();
+  while (!Worklist.empty()) {
+    Frontier.assign(Worklist.begin(), Worklist.end());
+    Worklist.clear();
+    // Set base values live in case of aliases.
+    for (auto VI : Frontier)
+      for (auto &Summary : VI.getSummaryList())
+        Summary->getBaseObject()->setLive(true);
+
+    Targets.clear();
+    Targets.resize(Frontier.size());
+    if (Parallel && Frontier.size() >= ParallelLivenessThreshold)
+      parallel::for_each_n(parallel::par, size_t(0), Frontier.size(),
+                           CollectTargets);
+    else
+      for (size_t I = 0, E = Frontier.size(); I != E; ++I)
+        CollectTargets(I);
+
+    for (auto &T : Targets)
+      for (auto VI : T)
+        visit(VI);
   }
   Index.setWithGlobalValueDeadStripping();
 
@@ -175,8 +175,10 @@ private:
                           BlockFrequencyInfo *BFI, TargetTransformInfo &TTI,
                           DominatorTree &DT, PostDomTree &PDT,
                           OptimizationRemarkEmitter &ORE);
-  Function *extractColdRegion(const BlockSequence &Region, DominatorTree &DT,
-                              BlockFrequencyInfo *BFI, TargetTransformInfo &TTI,
+  Function *extractColdRegion(const BlockSequence &Region,
+                              const CodeExtractorAnalysisCache &CEAC,
+                              DominatorTree &DT, BlockFrequencyInfo *BFI,
+                              TargetTransformInfo &TTI,
                               OptimizationRemarkEmitter &ORE, unsigned Count);
   SmallPtrSet<const Function *, 2> OutlinedFunctions;
   ProfileSummaryInfo *PSI;
@@ -233,12 +235,13 @@ bool HotColdSplitting::shouldOutlineFrom(const Function &F) const {
   return true;
 }
 
-Function *HotColdSplitting::extractColdRegion(const BlockSequence &Region,
-                                              DominatorTree &DT,
-                                              BlockFrequencyInfo *BFI,
-                                              TargetTransformInfo &TTI,
-                                              OptimizationRemarkEmitter &ORE,
-                                              unsigned Count) {
+Function *
+HotColdSplitting::extractColdRegion(const BlockSequence &Region,
+                                    const CodeExtractorAnalysisCache &CEAC,
+                                    DominatorTree &DT, BlockFrequencyInfo *BFI,
+                                    TargetTransformInfo &TTI,
+                                    OptimizationRemarkEmitter &ORE,
+                                    unsigned Count) {
   assert(!Region.empty());
 
   // TODO: Pass BFI and BPI to update profile information.
@@ -258,7 +261,7 @@ Function *HotColdSplitting::extractColdRegion(const BlockSequence &Region,
 
   // TODO: Run MergeBasicBlockIntoOnlyPred on the outlined function.
   Function *OrigF = Region[0]->getParent();
-  if (Function *OutF = CE.extractCodeRegion()) {
+  if (Function *OutF = CE.extractCodeRegion(CEAC)) {
     User *U = *OutF->user_begin();
     CallInst *CI = cast<CallInst>(U);
     CallSite CS(CI);
@@ -521,8 +524,14 @@ bool HotColdSplitting::outlineColdRegions(Function &F, ProfileSummaryInfo &PSI,
     ++NumColdRegionsFound;
   }
 
+  if (OutliningWorklist.empty())
+    return Changed;
+
   // Outline single-entry cold regions, splitting up larger regions as needed.
+  // Summarize the function once for all of them: doing it per region made
+  // the pass quadratic in the size of functions with many cold regions.
   unsigned OutlinedFunctionID = 1;
+  CodeExtractorAnalysisCache CEAC(F);
   while (!OutliningWorklist.empty()) {
     OutliningRegion Region = OutliningWorklist.pop_back_val();
     assert(!Region.empty() && "Empty outlining region in worklist");
@@ -542,8 +551,8 @@ bool HotColdSplitting::outlineColdRegions(Function &F, ProfileSummaryInfo &PSI,
           BB->dump();
       });
 
-      Function *Outlined =
-          extractColdRegion(SubRegion, DT, BFI, TTI, ORE, OutlinedFunctionID);
+      Function *Outlined = extractColdRegion(SubRegion, CEAC, DT, BFI, TTI,
+                                             ORE, OutlinedFunctionID);
       if (Outlined) {
         ++OutlinedFunctionID;
         OutlinedFunctions.insert(Outlined);
@@ -77,6 +77,8 @@ STATISTIC(NumInlined, "Number of functions inlined");
 STATISTIC(NumCallsDeleted, "Number of call sites deleted, not inlined");
 STATISTIC(NumDeleted, "Number of functions deleted because all callers found");
 STATISTIC(NumMergedAllocas, "Number of allocas merged together");
+STATISTIC(NumInlineCostsReused,
+          "Number of inline costs reused from an earlier evaluation");
 
 // This weirdly named statistic tracks the number of times that, when attempting
 // to inline a function A into B, we analyze the callers of B in order to see
@@ -121,6 +123,18 @@ static cl::opt<bool>
                                    " callsites processed by inliner but decided"
                                    " to be not inlined"));
 
+/// Flag to memoize inline costs in the legacy inliner.
+static cl::opt<bool>
+    CacheInlineCosts("inliner-cache-costs", cl::init(false), cl::Hidden,
+                     cl::desc("Reuse the inline cost of a call site while its "
+                              "caller and callee are unchanged"));
+
+/// Flag to share the walk of a callee between its call sites.
+static cl::opt<bool> UseCalleeSummaries(
+    "inline-callee-summaries", cl::init(false), cl::Hidden,
+    cl::desc("Reuse the inline cost analysis of a callee for call sites whose "
+             "arguments enable no simplification in it"));
+
 LegacyInlinerBase::LegacyInlinerBase(char &ID) : CallGraphSCCPass(ID) {}
 
 LegacyInlinerBase::LegacyInlinerBase(char &ID, bool InsertLifetime)
@@ -467,6 +481,61 @@ shouldInline(CallSite CS, function_ref<InlineCost(CallSite CS)> GetInlineCost,
   return IC;
 }
 
+namespace {
+
+/// Memoizes the inline costs computed while inlining one SCC.
+///
+/// The cost of a call site only depends on the bodies and attributes of its
+/// caller and callee and on the number of uses of the callee, so it can be
+/// reused until one of those changes. The legacy inliner revisits every call
+/// site that was not inlined each time it sweeps over the SCC, and evaluates
+/// the callers of a caller again for every call site in that caller when
+/// deciding whether to defer inlining.
+class InlineCostCache {
+  struct Entry {
+    Function *Caller;
+    Function *Callee;
+    unsigned CallerVersion;
+    unsigned CalleeVersion;
+    InlineCost IC;
+  };
+
+  DenseMap<Instruction *, Entry> Costs;
+  DenseMap<Function *, unsigned> Versions;
+
+public:
+  InlineCost get(CallSite CS,
+                 function_ref<InlineCost(CallSite CS)> GetInlineCost) {
+    Function *Caller = CS.getCaller();
+    Function *Callee = CS.getCalledFunction();
+    unsigned CallerVersion = Versions.lookup(Caller);
+    unsigned CalleeVersion = Versions.lookup(Callee);
+    auto I = Costs.find(CS.getInstruction());
+    if (I != Costs.end() && I->second.Caller == Caller &&
+        I->second.Callee == Callee &&
+        I->second.CallerVersion == CallerVersion &&
+        I->second.CalleeVersion == CalleeVersion) {
+      ++NumInlineCostsReused;
+      return I->second.IC;
+    }
+
+    InlineCost IC = GetInlineCost(CS);
+    if (I != Costs.end())
+      Costs.erase(I);
+    Costs.insert({CS.getInstruction(),
+                  {Caller, Callee, CallerVersion, CalleeVersion, IC}});
+    return IC;
+  }
+
+  /// Invalidate the costs of all call sites in or to \p F.
+  void invalidate(Function *F) { ++Versions[F]; }
+
+  /// Forget the cost of the call site \p I, which is about to be removed.
+  void forget(Instruction *I) { Costs.erase(I); }
+};
+
+} // end anonymous namespace
+
 /// Return true if the specified inline history ID
 /// indicates an inline history that includes the specified function.
 static bool InlineHistoryIncludes(
@@ -521,7 +590,8 @@ inlineCallsImpl(CallGraphSCC &SCC, CallGraph &CG,
                 bool InsertLifetime,
                 function_ref<InlineCost(CallSite CS)> GetInlineCost,
                 function_ref<AAResults &(Function &)> AARGetter,
-                ImportedFunctionsInliningStatistics &ImportedFunctionsStats) {
+                ImportedFunctionsInliningStatistics &ImportedFunctionsStats,
+                InlineCostSummaryCache *CalleeSummaries) {
   SmallPtrSet<Function *, 8> SCCFunctions;
   LLVM_DEBUG(dbgs() << "Inliner visiting SCC:");
   for (CallGraphNode *Node : SCC) {
@@ -595,6 +665,12 @@ inlineCallsImpl(CallGraphSCC &SCC, CallGraph &CG,
   InlinedArrayAllocasTy InlinedArrayAllocas;
   InlineFunctionInfo InlineInfo(&CG, &GetAssumptionCache, PSI);
 
+  InlineCostCache CostCache;
+  auto GetCachedInlineCost = [&](CallSite CS) {
+    return CacheInlineCosts ? CostCache.get(CS, GetInlineCost)
+                            : GetInlineCost(CS);
+  };
+
   // Now that we have all of the call sites, loop over them and inline them if
   // it looks profitable to do so.
   bool Changed = false;
@@ -638,7 +714,7 @@ inlineCallsImpl(CallGraphSCC &SCC, CallGraph &CG,
       // just become a regular analysis dependency.
       OptimizationRemarkEmitter ORE(Caller);
 
-      Optional<InlineCost> OIC = shouldInline(CS, GetInlineCost, ORE);
+      Optional<InlineCost> OIC = shouldInline(CS, GetCachedInlineCost, ORE);
       // If the policy determines that we should inline this function,
       // delete the call instead.
       if (!OIC.hasValue()) {
@@ -662,6 +738,11 @@ inlineCallsImpl(CallGraphSCC &SCC, CallGraph &CG,
         // Update the call graph by deleting the edge from Callee to Caller.
         setInlineRemark(CS, "trivially dead");
         CG[Caller]->removeCallEdgeFor(CS);
+        CostCache.forget(Instr);
+        CostCache.invalidate(Caller);
+        CostCache.invalidate(Callee);
+        if (CalleeSummaries)
+          CalleeSummaries->invalidate(*Caller);
         Instr->eraseFromParent();
         ++NumCallsDeleted;
       } else {
@@ -672,6 +753,7 @@ inlineCallsImpl(CallGraphSCC &SCC, CallGraph &CG,
         // Attempt to inline the function.
         using namespace ore;
 
+        CostCache.forget(Instr);
         InlineResult IR = InlineCallIfPossible(
             CS, InlineInfo, InlinedArrayAllocas, InlineHistoryID,
             InsertLifetime, AARGetter, ImportedFunctionsStats);
@@ -689,6 +771,13 @@ inlineCallsImpl(CallGraphSCC &SCC, CallGraph &CG,
 
         emit_inlined_into(ORE, DLoc, Block, *Callee, *Caller, *OIC);
 
+        // The caller has changed, the callee has lost a use and the callees
+        // of the inlined body have gained one.
+        CostCache.invalidate(Caller);
+        CostCache.invalidate(Callee);
+        if (CalleeSummaries)
+          CalleeSummaries->invalidate(*Caller);
+
         // If inlining this function gave us any new call sites, throw them
         // onto our worklist to process.  They are useful inline candidates.
         if (!InlineInfo.InlinedCalls.empty()) {
@@ -697,8 +786,12 @@ inlineCallsImpl(CallGraphSCC &SCC, CallGraph &CG,
           int NewHistoryID = InlineHistory.size();
           InlineHistory.push_back(std::make_pair(Callee, InlineHistoryID));
 
-          for (Value *Ptr : InlineInfo.InlinedCalls)
-            CallSites.push_back(std::make_pair(CallSite(Ptr), NewHistoryID));
+          for (Value *Ptr : InlineInfo.InlinedCalls) {
+            CallSite NewCS(Ptr);
+            if (Function *NewCallee = NewCS.getCalledFunction())
+              CostCache.invalidate(NewCallee);
+            CallSites.push_back(std::make_pair(NewCS, NewHistoryID));
+          }
         }
       }
 
@@ -715,6 +808,11 @@ inlineCallsImpl(CallGraphSCC &SCC, CallGraph &CG,
                           << Callee->getName() << "\n");
         CallGraphNode *CalleeNode = CG[Callee];
 
+        // The callees of the deleted function lose their uses in it.
+        for (const CallGraphNode::CallRecord &CR : *CalleeNode)
+          if (Function *F = CR.second->getFunction())
+            CostCache.invalidate(F);
+
         // Remove any call graph edges from the callee to its callees.
         CalleeNode->removeAllCalledFunctions();
 
@@ -751,9 +849,13 @@ bool LegacyInlinerBase::inlineCalls(CallGraphSCC &SCC) {
   auto GetAssumptionCache = [&](Function &F) -> AssumptionCache & {
     return ACT->getAssumptionCache(F);
   };
+  // Function passes may have changed any function since the last SCC.
+  CalleeSummaryCache.clear();
+  CalleeSummaries = UseCalleeSummaries ? &CalleeSummaryCache : nullptr;
   return inlineCallsImpl(SCC, CG, GetAssumptionCache, PSI, TLI, InsertLifetime,
                          [this](CallSite CS) { return getInlineCost(CS); },
-                         LegacyAARGetter(*this), ImportedFunctionsStats);
+                         LegacyAARGetter(*this), ImportedFunctionsStats,
+                         CalleeSummaries);
 }
 
 /// Remove now-dead linkonce functions at the end of
@@ -899,6 +1001,10 @@ PreservedAnalyses InlinerPass::run(LazyCallGraph::SCC &InitialC,
   // incrementally maknig a single function grow in a super linear fashion.
   SmallVector<std::pair<CallSite, int>, 16> Calls;
 
+  // Summaries of the callees analyzed during this run. Nothing but inlining
+  // changes function bodies until the run ends.
+  InlineCostSummaryCache CalleeSummaries;
+
   FunctionAnalysisManager &FAM =
       AM.getResult<FunctionAnalysisManagerCGSCCProxy>(InitialC, CG)
           .getManager();
@@ -996,7 +1102,8 @@ PreservedAnalyses InlinerPass::run(LazyCallGraph::SCC &InitialC,
       Function &Callee = *CS.getCalledFunction();
       auto &CalleeTTI = FAM.getResult<TargetIRAnalysis>(Callee);
       return getInlineCost(CS, Params, CalleeTTI, GetAssumptionCache, {GetBFI},
-                           PSI, &ORE);
+                           PSI, &ORE,
+                           UseCalleeSummaries ? &CalleeSummaries : nullptr);
     };
 
     // Now process as many calls as we have within this caller in the sequnece.
@@ -1068,6 +1175,7 @@ PreservedAnalyses InlinerPass::run(LazyCallGraph::SCC &InitialC,
       }
       DidInline = true;
       InlinedCallees.insert(&Callee);
+      CalleeSummaries.invalidate(F);
 
       ++NumInlined;
 
@@ -97,6 +97,12 @@ static cl::opt<bool> AvoidReuse(
     cl::desc("Try to avoid reuse of byte array addresses using aliases"),
     cl::Hidden, cl::init(true));
 
+static cl::opt<bool> ClLayoutByHotness(
+    "lowertypetests-layout-by-hotness",
+    cl::desc("Place the jump table entries of functions with the highest entry "
+             "counts first"),
+    cl::Hidden, cl::init(true));
+
 static cl::opt<PassSummaryAction> ClSummaryAction(
     "lowertypetests-summary-action",
     cl::desc("What to do with the summary when running this pass"),
@@ -292,6 +298,15 @@ public:
   ArrayRef<MDNode *> types() const {
     return makeArrayRef(getTrailingObjects<MDNode *>(), NTypes);
   }
+
+  /// For functions with profile data: the entry count. Otherwise 0.
+  uint64_t getEntryCount() const {
+    auto *F = dyn_cast<Function>(GO);
+    if (!F)
+      return 0;
+    Function::ProfileCount Count = F->getEntryCount();
+    return Count.hasValue() ? Count.getCount() : 0;
+  }
 };
 
 struct ICallBranchFunnel final
@@ -1299,9 +1314,18 @@ void LowerTypeTestsModule::createJumpTable(
 
   Triple::ArchType JumpTableArch = selectJumpTableArmEncoding(Functions, Arch);
 
-  for (unsigned I = 0; I != Functions.size(); ++I)
+  uint64_t EntryCount = 0;
+  for (unsigned I = 0; I != Functions.size(); ++I) {
     createJumpTableEntry(AsmOS, ConstraintOS, JumpTableArch, AsmArgs,
                          cast<Function>(Functions[I]->getGlobal()));
+    EntryCount += Functions[I]->getEntryCount();
+  }
+
+  // Every call through the table enters it, so its entry count is the sum of
+  // those of its functions. This lets the code generator place a hot table
+  // in the hot text section next to its callers.
+  if (EntryCount)
+    F->setEntryCount(EntryCount);
 
   // Align the whole table by entry size.
   F->setAlignment(getJumpTableEntrySize());
@@ -2028,6 +2052,16 @@ bool LowerTypeTestsModule::lower() {
         ICallBranchFunnels.push_back(MI->get<ICallBranchFunnel *>());
     }
 
+    // Give the functions with the highest entry counts the lowest indices.
+    // The layout builder keeps each type identifier's members together
+    // whatever their indices are, and otherwise lays them out in index order,
+    // so the jump table entries that are called most often share cache lines.
+    if (ClLayoutByHotness)
+      std::stable_sort(Globals.begin(), Globals.end(),
+                       [](GlobalTypeMember *G1, GlobalTypeMember *G2) {
+                         return G1->getEntryCount() > G2->getEntryCount();
+                       });
+
     // Order type identifiers by unique ID for determinism. This ordering is
     // stable as there is a one-to-one mapping between metadata and unique IDs.
     llvm::sort(TypeIds, [&](Metadata *M1, Metadata *M2) {
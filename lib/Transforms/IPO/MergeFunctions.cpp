@@ -35,6 +35,8 @@
 // is critical to ensuring all possible merging opportunities are exploited.
 // Collisions in the hash affect the speed of the pass but not the correctness
 // or determinism of the resulting transformation.
+// The hashes of the first round can be computed on several threads
+// (-mergefunc-hash-threads).
 //
 // When a match is found the functions are folded. If both functions are
 // overridable, we move the functionality into a new internal function and
@@ -90,6 +92,7 @@
 //===----------------------------------------------------------------------===//
 
 #include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/Statistic.h"
@@ -120,6 +123,7 @@
 #include "llvm/Support/Casting.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
+#include "llvm/Support/ThreadPool.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Transforms/IPO.h"
 #include "llvm/Transforms/Utils/FunctionComparator.h"
@@ -166,6 +170,11 @@ static cl::opt<bool>
                       cl::desc("Preserve debug info in thunk when mergefunc "
                                "transformations are made."));
 
+static cl::opt<unsigned> MergeFunctionsHashThreads(
+    "mergefunc-hash-threads", cl::Hidden, cl::init(0),
+    cl::desc("Number of threads used to hash the functions of a module "
+             "(0 hashes them serially)"));
+
 static cl::opt<bool>
     MergeFunctionsAliases("mergefunc-use-aliases", cl::Hidden,
                           cl::init(false),
@@ -178,9 +187,12 @@ class FunctionNode {
   FunctionComparator::FunctionHash Hash;
 
 public:
-  // Note the hash is recalculated potentially multiple times, but it is cheap.
+  // Note the hash is recalculated potentially multiple times, unless it was
+  // computed up front for the first round.
   FunctionNode(Function *F)
     : F(F), Hash(FunctionComparator::functionHash(*F))  {}
+  FunctionNode(Function *F, FunctionComparator::FunctionHash Hash)
+    : F(F), Hash(Hash) {}
 
   Function *getFunc() const { return F; }
   FunctionComparator::FunctionHash getHash() const { return Hash; }
@@ -298,6 +310,12 @@ private:
   // dangling iterators into FnTree. The invariant that preserves this is that
   // there is exactly one mapping F -> FN for each FunctionNode FN in FnTree.
   DenseMap<AssertingVH<Function>, FnTreeType::iterator> FNodesInTree;
+
+  /// The hashes computed up front for the functions of the first round. An
+  /// entry is dropped when its function is inserted or may have changed, and
+  /// the map is cleared after the first round, before any function it names
+  /// can have been deleted.
+  DenseMap<Function *, FunctionComparator::FunctionHash> InitialHashes;
 };
 
 } // end anonymous namespace
@@ -395,10 +413,26 @@ bool MergeFunctions::runOnModule(Module &M) {
     HashedFuncs;
   for (Function &Func : M) {
     if (!Func.isDeclaration() && !Func.hasAvailableExternallyLinkage()) {
-      HashedFuncs.push_back({FunctionComparator::functionHash(Func), &Func});
+      HashedFuncs.push_back({0, &Func});
     }
   }
 
+  // Hashing only reads the IR, so it can be spread over threads in chunks.
+  auto HashRange = [&](size_t Begin, size_t End) {
+    for (size_t I = Begin; I != End; ++I)
+      HashedFuncs[I].first =
+          FunctionComparator::functionHash(*HashedFuncs[I].second);
+  };
+  if (MergeFunctionsHashThreads > 1) {
+    ThreadPool Pool(MergeFunctionsHashThreads);
+    const size_t ChunkSize = 256;
+    for (size_t I = 0, E = HashedFuncs.size(); I < E; I += ChunkSize)
+      Pool.async(HashRange, I, std::min(I + ChunkSize, E));
+    Pool.wait();
+  } else {
+    HashRange(0, HashedFuncs.size());
+  }
+
   std::stable_sort(
       HashedFuncs.begin(), HashedFuncs.end(),
       [](const std::pair<FunctionComparator::FunctionHash, Function *> &a,
@@ -413,6 +447,7 @@ bool MergeFunctions::runOnModule(Module &M) {
     if ((I != S && std::prev(I)->first == I->first) ||
         (std::next(I) != IE && std::next(I)->first == I->first) ) {
       Deferred.push_back(WeakTrackingVH(I->second));
+      InitialHashes[I->second] = I->first;
     }
   }
 
@@ -435,6 +470,7 @@ bool MergeFunctions::runOnModule(Module &M) {
       }
     }
     LLVM_DEBUG(dbgs() << "size of FnTree: " << FnTree.size() << '\n');
+    InitialHashes.clear();
   } while (!Deferred.empty());
 
   FnTree.clear();
@@ -898,8 +934,14 @@ static bool isFuncOrderCorrect(const Function *F, const Function *G) {
 // Insert a ComparableFunction into the FnTree, or merge it away if equal to one
 // that was already inserted.
 bool MergeFunctions::insert(Function *NewFunction) {
-  std::pair<FnTreeType::iterator, bool> Result =
-      FnTree.insert(FunctionNode(NewFunction));
+  std::pair<FnTreeType::iterator, bool> Result;
+  auto HI = InitialHashes.find(NewFunction);
+  if (HI != InitialHashes.end()) {
+    Result = FnTree.insert(FunctionNode(NewFunction, HI->second));
+    InitialHashes.erase(HI);
+  } else {
+    Result = FnTree.insert(FunctionNode(NewFunction));
+  }
 
   if (Result.second) {
     assert(FNodesInTree.count(NewFunction) == 0);
@@ -930,6 +972,8 @@ bool MergeFunctions::insert(Function *NewFunction) {
 // Remove a function from FnTree. If it was already in FnTree, add
 // it to Deferred so that we'll look at it in the next round.
 void MergeFunctions::remove(Function *F) {
+  // F is about to change, so a hash computed up front no longer applies.
+  InitialHashes.erase(F);
   auto I = FNodesInTree.find(F);
   if (I != FNodesInTree.end()) {
     LLVM_DEBUG(dbgs() << "Deferred " << F->getName() << ".\n");
@@ -0,0 +1,138 @@
+//===-- PagerandoWrapperElimination.cpp - Remove unneeded wrappers --------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This pass removes Pagerando entry wrappers that are no longer needed. The
+// PagerandoWrappers pass creates a wrapper for every function that may be used
+// from outside the module. With full LTO, internalization gives most of these
+// wrappers local linkage, so all of their callers are known. Direct calls to
+// such a wrapper are redirected to the binned function, which moves the POT
+// load from the wrapper into the caller and saves a call and return on every
+// invocation. A wrapper without remaining uses is deleted.
+//
+// Calls from functions optimized for size keep using the wrapper, since a POT
+// load at each call site is larger than a single direct call.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ADT/Statistic.h"
+#include "llvm/IR/CallSite.h"
+#include "llvm/IR/Instructions.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Pass.h"
+#include "llvm/Transforms/IPO.h"
+
+using namespace llvm;
+
+#define DEBUG_TYPE "pagerando"
+
+STATISTIC(NumCallsRedirected, "Number of wrapper calls redirected");
+STATISTIC(NumWrappersDeleted, "Number of wrappers deleted");
+
+namespace {
+class PagerandoWrapperElimination : public ModulePass {
+public:
+  static char ID;
+  explicit PagerandoWrapperElimination() : ModulePass(ID) {
+    initializePagerandoWrapperEliminationPass(
+        *PassRegistry::getPassRegistry());
+  }
+
+  bool runOnModule(Module &M) override;
+
+private:
+  // Must match PagerandoWrappers::OrigSuffix
+  static constexpr const char *OrigSuffix = "$$orig";
+
+  bool processWrapper(Function &Wrapper, Function &Callee);
+};
+} // end anonymous namespace
+
+char PagerandoWrapperElimination::ID = 0;
+INITIALIZE_PASS(PagerandoWrapperElimination, "pagerando-wrapper-elim",
+                "Pagerando wrapper elimination", false, false)
+
+ModulePass *llvm::createPagerandoWrapperEliminationPass() {
+  return new PagerandoWrapperElimination();
+}
+
+// Return the binned function if F is a wrapper created by PagerandoWrappers,
+// i.e., a single block that calls "<name>$$orig" and returns. Vararg wrappers
+// pass an explicit va_list to the binned function and cannot be bypassed.
+static Function *getWrappedFunction(Function &F, StringRef OrigSuffix) {
+  if (F.isDeclaration() || F.isPagerando() || F.isVarArg() ||
+      F.size() != 1)
+    return nullptr;
+
+  Function *Callee = nullptr;
+  for (auto &I : F.getEntryBlock()) {
+    if (isa<ReturnInst>(&I))
+      continue;
+    auto *CI = dyn_cast<CallInst>(&I);
+    if (!CI || Callee)
+      return nullptr;
+    Callee = CI->getCalledFunction();
+  }
+
+  if (!Callee || !Callee->isPagerando() ||
+      Callee->getFunctionType() != F.getFunctionType() ||
+      Callee->getName() != (F.getName() + OrigSuffix).str())
+    return nullptr;
+  return Callee;
+}
+
+bool PagerandoWrapperElimination::runOnModule(Module &M) {
+  if (skipModule(M))
+    return false;
+
+  SmallVector<std::pair<Function*, Function*>, 16> Wrappers;
+  for (auto &F : M) {
+    // Calls to a preemptible wrapper must not bypass it
+    if (!F.hasLocalLinkage() && F.hasDefaultVisibility() && !F.isDSOLocal())
+      continue;
+    if (auto *Callee = getWrappedFunction(F, OrigSuffix))
+      Wrappers.emplace_back(&F, Callee);
+  }
+
+  bool Changed = false;
+  for (auto &W : Wrappers)
+    Changed |= processWrapper(*W.first, *W.second);
+
+  return Changed;
+}
+
+bool PagerandoWrapperElimination::processWrapper(Function &Wrapper,
+                                                 Function &Callee) {
+  SmallVector<Use*, 8> CallUses;
+  for (Use &U : Wrapper.uses()) {
+    CallSite CS(U.getUser());
+    if (!CS || !CS.isCallee(&U))
+      continue;
+    if (CS.getCaller() == &Wrapper || CS.getCaller()->optForSize())
+      continue;
+    CallUses.push_back(&U);
+  }
+
+  for (Use *U : CallUses) {
+    CallSite CS(U->getUser());
+    U->set(&Callee);
+    CS.setCallingConv(Callee.getCallingConv());
+  }
+  NumCallsRedirected += CallUses.size();
+
+  if (!Wrapper.hasLocalLinkage() || !Wrapper.use_empty())
+    return !CallUses.empty();
+
+  // A local binned function can take the original name back.
+  std::string OriginalName = Wrapper.getName();
+  Wrapper.eraseFromParent();
+  if (Callee.hasLocalLinkage())
+    Callee.setName(OriginalName);
+  ++NumWrappersDeleted;
+  return true;
+}
@@ -73,6 +73,11 @@ RunLoopRerolling("reroll-loops", cl::Hidden,
 static cl::opt<bool> RunNewGVN("enable-newgvn", cl::init(false), cl::Hidden,
                                cl::desc("Run the NewGVN pass"));
 
+static cl::opt<unsigned> NewGVNFunctionSizeThreshold(
+    "newgvn-function-size-threshold", cl::init(0), cl::Hidden,
+    cl::desc("Run NewGVN instead of GVN on functions with at least this many "
+             "instructions (0 = never)"));
+
 static cl::opt<bool>
 RunSLPAfterLoopVectorization("run-slp-after-loop-vectorization",
   cl::init(true), cl::Hidden,
@@ -121,6 +126,15 @@ static cl::opt<std::string> RunPGOInstrUse(
     cl::desc("Enable use phase of PGO instrumentation and specify the path "
              "of profile data file"));
 
+static cl::opt<bool> RunPGOCSInstrGen(
+    "cs-profile-generate", cl::init(false), cl::Hidden,
+    cl::desc("Enable context-sensitive PGO instrumentation after inlining."));
+
+static cl::opt<bool> RunPGOCSInstrUse(
+    "cs-profile-use", cl::init(false), cl::Hidden,
+    cl::desc("Enable use phase of context-sensitive PGO instrumentation with "
+             "the profile data file of -profile-use"));
+
 static cl::opt<bool> UseLoopVersioningLICM(
     "enable-loop-versioning-licm", cl::init(false), cl::Hidden,
     cl::desc("Enable the experimental Loop Versioning LICM pass"));
@@ -176,6 +190,8 @@ PassManagerBuilder::PassManagerBuilder() {
     MergeFunctions = false;
     PrepareForLTO = false;
     EnablePGOInstrGen = RunPGOInstrGen;
+    EnablePGOCSInstrGen = RunPGOCSInstrGen;
+    EnablePGOCSInstrUse = RunPGOCSInstrUse;
     PGOInstrGen = PGOOutputFile;
     PGOInstrUse = RunPGOInstrUse;
     PrepareForThinLTO = EnablePrepareForThinLTO;
@@ -252,6 +268,18 @@ void PassManagerBuilder::addInstructionCombiningPass(
   PM.add(createInstructionCombiningPass(ExpensiveCombines));
 }
 
+void PassManagerBuilder::addGVNPasses(legacy::PassManagerBase &PM) const {
+  if (NewGVN) {
+    PM.add(createNewGVNPass());
+    return;
+  }
+  // MemoryDependenceAnalysis gets slow on very large functions, so these can
+  // be handed to NewGVN. Each pass skips the functions meant for the other.
+  PM.add(createGVNPass(DisableGVNLoadPRE, NewGVNFunctionSizeThreshold));
+  if (NewGVNFunctionSizeThreshold)
+    PM.add(createNewGVNPass(NewGVNFunctionSizeThreshold));
+}
+
 void PassManagerBuilder::populateFunctionPassManager(
     legacy::FunctionPassManager &FPM) {
   addExtensionsToPM(EP_EarlyAsPossible, FPM);
@@ -272,13 +300,20 @@ void PassManagerBuilder::populateFunctionPassManager(
 }
 
 // Do PGO instrumentation generation or use pass as the option specified.
-void PassManagerBuilder::addPGOInstrPasses(legacy::PassManagerBase &MPM) {
-  if (!EnablePGOInstrGen && PGOInstrUse.empty() && PGOSampleUse.empty())
+// \p IsCS selects the context-sensitive passes that run after inlining.
+void PassManagerBuilder::addPGOInstrPasses(legacy::PassManagerBase &MPM,
+                                           bool IsCS) {
+  // A module is instrumented at most once: the context-sensitive counts are
+  // collected on top of a profile of the regular instrumentation.
+  bool RunInstrGen =
+      IsCS ? EnablePGOCSInstrGen && !EnablePGOInstrGen : EnablePGOInstrGen;
+  bool RunInstrUse = !PGOInstrUse.empty() && (!IsCS || EnablePGOCSInstrUse);
+  if (!RunInstrGen && !RunInstrUse && (IsCS || PGOSampleUse.empty()))
     return;
   // Perform the preinline and cleanup passes for O1 and above.
   // And avoid doing them if optimizing for size.
   if (OptLevel > 0 && SizeLevel == 0 && !DisablePreInliner &&
-      PGOSampleUse.empty()) {
+      PGOSampleUse.empty() && !IsCS) {
     // Create preinline pass. We construct an InlineParams object and specify
     // the threshold here to avoid the command line options of the regular
     // inliner to influence pre-inlining. The only fields of InlineParams we
@@ -296,8 +331,8 @@ void PassManagerBuilder::addPGOInstrPasses(legacy::PassManagerBase &MPM) {
     MPM.add(createInstructionCombiningPass()); // Combine silly seq's
     addExtensionsToPM(EP_Peephole, MPM);
   }
-  if (EnablePGOInstrGen) {
-    MPM.add(createPGOInstrumentationGenLegacyPass());
+  if (RunInstrGen) {
+    MPM.add(createPGOInstrumentationGenLegacyPass(IsCS));
     // Add the profile lowering pass.
     InstrProfOptions Options;
     if (!PGOInstrGen.empty())
@@ -306,12 +341,12 @@ void PassManagerBuilder::addPGOInstrPasses(legacy::PassManagerBase &MPM) {
     MPM.add(createLoopRotatePass());
     MPM.add(createInstrProfilingLegacyPass(Options));
   }
-  if (!PGOInstrUse.empty())
-    MPM.add(createPGOInstrumentationUseLegacyPass(PGOInstrUse));
+  if (RunInstrUse)
+    MPM.add(createPGOInstrumentationUseLegacyPass(PGOInstrUse, IsCS));
   // Indirect call promotion that promotes intra-module targets only.
   // For ThinLTO this is done earlier due to interactions with globalopt
   // for imported functions. We don't run this at -O0.
-  if (OptLevel > 0)
+  if (OptLevel > 0 && !IsCS)
     MPM.add(
         createPGOIndirectCallPromotionLegacyPass(false, !PGOSampleUse.empty()));
 }
@@ -385,8 +420,7 @@ void PassManagerBuilder::addFunctionSimplificationPasses(
 
   if (OptLevel > 1) {
     MPM.add(createMergedLoadStoreMotionPass()); // Merge ld/st in diamonds
-    MPM.add(NewGVN ? createNewGVNPass()
-                   : createGVNPass(DisableGVNLoadPRE)); // Remove redundancies
+    addGVNPasses(MPM);                          // Remove redundancies
   }
   MPM.add(createMemCpyOptPass());             // Remove memcpy / form memset
   MPM.add(createSCCPPass());                  // Constant prop with SCCP
@@ -565,6 +599,12 @@ void PassManagerBuilder::populateModulePassManager(
     // and saves running remaining passes on the eliminated functions.
     MPM.add(createEliminateAvailableExternallyPass());
 
+  // Context-sensitive PGO instrumentation and use, now that inlining is
+  // over. When preparing for LTO, more inlining happens at link time, and
+  // the passes run there instead.
+  if (!PrepareForLTO && !PrepareForThinLTO)
+    addPGOInstrPasses(MPM, /*IsCS=*/true);
+
   MPM.add(createReversePostOrderFunctionAttrsPass());
 
   // The inliner performs some kind of dead code elimination as it goes,
@@ -842,6 +882,9 @@ void PassManagerBuilder::addLTOOptimizationPasses(legacy::PassManagerBase &PM) {
     PM.add(createGlobalOptimizerPass());
   PM.add(createGlobalDCEPass()); // Remove dead functions.
 
+  // Context-sensitive PGO instrumentation and use after link time inlining.
+  addPGOInstrPasses(PM, /*IsCS=*/true);
+
   // If we didn't decide to inline a function, check to see if we can
   // transform it to pass arguments by value instead of by reference.
   PM.add(createArgumentPromotionPass());
@@ -860,8 +903,7 @@ void PassManagerBuilder::addLTOOptimizationPasses(legacy::PassManagerBase &PM) {
 
   PM.add(createLICMPass());                 // Hoist loop invariants.
   PM.add(createMergedLoadStoreMotionPass()); // Merge ld/st in diamonds.
-  PM.add(NewGVN ? createNewGVNPass()
-                : createGVNPass(DisableGVNLoadPRE)); // Remove redundancies.
+  addGVNPasses(PM);                         // Remove redundancies.
   PM.add(createMemCpyOptPass());            // Remove dead memcpys.
 
   // Nuke dead stores.
@@ -48,6 +48,7 @@
 #include "llvm/ADT/DenseSet.h"
 #include "llvm/ADT/MapVector.h"
 #include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/Statistic.h"
 #include "llvm/ADT/iterator_range.h"
 #include "llvm/Analysis/AliasAnalysis.h"
 #include "llvm/Analysis/BasicAliasAnalysis.h"
@@ -92,6 +93,14 @@ using namespace wholeprogramdevirt;
 
 #define DEBUG_TYPE "wholeprogramdevirt"
 
+STATISTIC(NumSingleImpl, "Number of calls devirtualized to a single impl");
+STATISTIC(NumUniformRetVal, "Number of calls replaced by a uniform ret val");
+STATISTIC(NumUniqueRetVal, "Number of calls replaced by a unique ret val");
+STATISTIC(NumVirtConstProp, "Number of calls replaced by a virtual const");
+STATISTIC(NumBranchFunnel, "Number of calls through a branch funnel");
+STATISTIC(NumDeadSummaryCalls,
+          "Number of summary virtual calls skipped in dead functions");
+
 static cl::opt<PassSummaryAction> ClSummaryAction(
     "wholeprogramdevirt-summary-action",
     cl::desc("What to do with the summary when running this pass"),
@@ -457,7 +466,6 @@ struct DevirtModule {
   void buildTypeIdentifierMap(
       std::vector<VTableBits> &Bits,
       DenseMap<Metadata *, std::set<TypeMemberInfo>> &TypeIdMap);
-  Constant *getPointerAtOffset(Constant *I, uint64_t Offset);
   bool
   tryFindVirtualCallTargets(std::vector<VirtualCallTarget> &TargetsForSlot,
                             const std::set<TypeMemberInfo> &TypeMemberInfos,
@@ -707,38 +715,6 @@ void DevirtModule::buildTypeIdentifierMap(
   }
 }
 
-Constant *DevirtModule::getPointerAtOffset(Constant *I, uint64_t Offset) {
-  if (I->getType()->isPointerTy()) {
-    if (Offset == 0)
-      return I;
-    return nullptr;
-  }
-
-  const DataLayout &DL = M.getDataLayout();
-
-  if (auto *C = dyn_cast<ConstantStruct>(I)) {
-    const StructLayout *SL = DL.getStructLayout(C->getType());
-    if (Offset >= SL->getSizeInBytes())
-      return nullptr;
-
-    unsigned Op = SL->getElementContainingOffset(Offset);
-    return getPointerAtOffset(cast<Constant>(I->getOperand(Op)),
-                              Offset - SL->getElementOffset(Op));
-  }
-  if (auto *C = dyn_cast<ConstantArray>(I)) {
-    ArrayType *VTableTy = C->getType();
-    uint64_t ElemSize = DL.getTypeAllocSize(VTableTy->getElementType());
-
-    unsigned Op = Offset / ElemSize;
-    if (Op >= C->getNumOperands())
-      return nullptr;
-
-    return getPointerAtOffset(cast<Constant>(I->getOperand(Op)),
-                              Offset % ElemSize);
-  }
-  return nullptr;
-}
-
 bool DevirtModule::tryFindVirtualCallTargets(
     std::vector<VirtualCallTarget> &TargetsForSlot,
     const std::set<TypeMemberInfo> &TypeMemberInfos, uint64_t ByteOffset) {
@@ -747,7 +723,7 @@ bool DevirtModule::tryFindVirtualCallTargets(
       return false;
 
     Constant *Ptr = getPointerAtOffset(TM.Bits->GV->getInitializer(),
-                                       TM.Offset + ByteOffset);
+                                       TM.Offset + ByteOffset, M);
     if (!Ptr)
       return false;
 
@@ -776,6 +752,7 @@ void DevirtModule::applySingleImplDevirt(VTableSlotInfo &SlotInfo,
                              TheFn->stripPointerCasts()->getName(), OREGetter);
       VCallSite.CS.setCalledFunction(ConstantExpr::getBitCast(
           TheFn, VCallSite.CS.getCalledValue()->getType()));
+      ++NumSingleImpl;
       // This use is no longer unsafe.
       if (VCallSite.NumUnsafeUses)
         --*VCallSite.NumUnsafeUses;
@@ -954,6 +931,7 @@ void DevirtModule::applyICallBranchFunnel(VTableSlotInfo &SlotInfo,
 
       CS->replaceAllUsesWith(NewCS.getInstruction());
       CS->eraseFromParent();
+      ++NumBranchFunnel;
 
       // This use is no longer unsafe.
       if (VCallSite.NumUnsafeUses)
@@ -1005,6 +983,7 @@ void DevirtModule::applyUniformRetValOpt(CallSiteInfo &CSInfo, StringRef FnName,
     Call.replaceAndErase(
         "uniform-ret-val", FnName, RemarksEnabled, OREGetter,
         ConstantInt::get(cast<IntegerType>(Call.CS.getType()), TheRetVal));
+  NumUniformRetVal += CSInfo.CallSites.size();
   CSInfo.markDevirt();
 }
 
@@ -1118,6 +1097,7 @@ void DevirtModule::applyUniqueRetValOpt(CallSiteInfo &CSInfo, StringRef FnName,
     Call.replaceAndErase("unique-ret-val", FnName, RemarksEnabled, OREGetter,
                          Cmp);
   }
+  NumUniqueRetVal += CSInfo.CallSites.size();
   CSInfo.markDevirt();
 }
 
@@ -1195,6 +1175,7 @@ void DevirtModule::applyVirtualConstProp(CallSiteInfo &CSInfo, StringRef FnName,
                            OREGetter, Val);
     }
   }
+  NumVirtConstProp += CSInfo.CallSites.size();
   CSInfo.markDevirt();
 }
 
@@ -1605,26 +1586,43 @@ bool DevirtModule::run() {
             TypeId);
     }
 
+    // Look up the type identifiers without inserting into MetadataByGUID, as
+    // most GUIDs in a large index name types without vtables in this module.
+    auto TypeIdsFor = [&](GlobalValue::GUID GUID) {
+      auto I = MetadataByGUID.find(GUID);
+      return I == MetadataByGUID.end() ? ArrayRef<Metadata *>()
+                                       : ArrayRef<Metadata *>(I->second);
+    };
+
     for (auto &P : *ExportSummary) {
       for (auto &S : P.second.SummaryList) {
         auto *FS = dyn_cast<FunctionSummary>(S.get());
         if (!FS)
           continue;
-        // FIXME: Only add live functions.
+        // Calls in dead functions must not cause a resolution to be exported:
+        // exporting a single implementation promotes it to external linkage,
+        // and virtual constant propagation rewrites the vtables.
+        if (!ExportSummary->isGlobalValueLive(FS)) {
+          NumDeadSummaryCalls += FS->type_test_assume_vcalls().size() +
+                                 FS->type_checked_load_vcalls().size() +
+                                 FS->type_test_assume_const_vcalls().size() +
+                                 FS->type_checked_load_const_vcalls().size();
+          continue;
+        }
         for (FunctionSummary::VFuncId VF : FS->type_test_assume_vcalls()) {
-          for (Metadata *MD : MetadataByGUID[VF.GUID]) {
+          for (Metadata *MD : TypeIdsFor(VF.GUID)) {
             CallSlots[{MD, VF.Offset}]
                 .CSInfo.markSummaryHasTypeTestAssumeUsers();
           }
         }
         for (FunctionSummary::VFuncId VF : FS->type_checked_load_vcalls()) {
-          for (Metadata *MD : MetadataByGUID[VF.GUID]) {
+          for (Metadata *MD : TypeIdsFor(VF.GUID)) {
             CallSlots[{MD, VF.Offset}].CSInfo.addSummaryTypeCheckedLoadUser(FS);
           }
         }
         for (const FunctionSummary::ConstVCall &VC :
              FS->type_test_assume_const_vcalls()) {
-          for (Metadata *MD : MetadataByGUID[VC.VFunc.GUID]) {
+          for (Metadata *MD : TypeIdsFor(VC.VFunc.GUID)) {
             CallSlots[{MD, VC.VFunc.Offset}]
                 .ConstCSInfo[VC.Args]
                 .markSummaryHasTypeTestAssumeUsers();
@@ -1632,7 +1630,7 @@ bool DevirtModule::run() {
         }
         for (const FunctionSummary::ConstVCall &VC :
              FS->type_checked_load_const_vcalls()) {
-          for (Metadata *MD : MetadataByGUID[VC.VFunc.GUID]) {
+          for (Metadata *MD : TypeIdsFor(VC.VFunc.GUID)) {
             CallSlots[{MD, VC.VFunc.Offset}]
                 .ConstCSInfo[VC.Args]
                 .addSummaryTypeCheckedLoadUser(FS);
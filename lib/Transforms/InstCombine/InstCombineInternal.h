@@ -17,6 +17,7 @@
 #define LLVM_LIB_TRANSFORMS_INSTCOMBINE_INSTCOMBINEINTERNAL_H
 
 #include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/Analysis/AliasAnalysis.h"
 #include "llvm/Analysis/InstructionSimplify.h"
 #include "llvm/Analysis/TargetFolder.h"
@@ -274,6 +275,16 @@ static inline Constant *getSafeVectorConstantForBinop(
   return ConstantVector::get(Out);
 }
 
+/// Telemetry collected by InstCombiner::run() for -instcombine-stats-json.
+struct InstCombineStats {
+  /// Number of instructions visited.
+  unsigned NumVisited = 0;
+
+  /// Time in seconds spent visiting instructions and number of visits, by
+  /// opcode.
+  DenseMap<unsigned, std::pair<double, unsigned>> VisitTime;
+};
+
 /// The core instruction combiner logic.
 ///
 /// This class provides both the logic to recursively visit instructions and
@@ -734,6 +745,9 @@ public:
   /// Maximum size of array considered when transforming.
   uint64_t MaxArraySizeForCombine;
 
+  /// If set, telemetry about the visited instructions is collected here.
+  InstCombineStats *Stats = nullptr;
+
 private:
   /// Performs a few simplifications for operators which are associative
   /// or commutative.
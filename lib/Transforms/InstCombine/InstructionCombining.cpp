@@ -74,8 +74,10 @@
 #include "llvm/IR/Instructions.h"
 #include "llvm/IR/IntrinsicInst.h"
 #include "llvm/IR/Intrinsics.h"
+#include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/LegacyPassManager.h"
 #include "llvm/IR/Metadata.h"
+#include "llvm/IR/Module.h"
 #include "llvm/IR/Operator.h"
 #include "llvm/IR/PassManager.h"
 #include "llvm/IR/PatternMatch.h"
@@ -92,17 +94,23 @@
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/DebugCounter.h"
 #include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/FormatVariadic.h"
+#include "llvm/Support/JSON.h"
 #include "llvm/Support/KnownBits.h"
+#include "llvm/Support/ManagedStatic.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Transforms/InstCombine/InstCombine.h"
 #include "llvm/Transforms/InstCombine/InstCombineWorklist.h"
 #include "llvm/Transforms/Utils/Local.h"
 #include <algorithm>
 #include <cassert>
+#include <chrono>
 #include <cstdint>
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 using namespace llvm;
 using namespace llvm::PatternMatch;
@@ -116,6 +124,10 @@ STATISTIC(NumSunkInst , "Number of instructions sunk");
 STATISTIC(NumExpand,    "Number of expansions");
 STATISTIC(NumFactor   , "Number of factorizations");
 STATISTIC(NumReassoc  , "Number of reassociations");
+STATISTIC(NumWorklistIterations,
+          "Number of instruction combining iterations performed");
+STATISTIC(NumMaxIterationsReached,
+          "Number of functions that reached the iteration limit");
 DEBUG_COUNTER(VisitCounter, "instcombine-visit",
               "Controls which instructions are visited");
 
@@ -138,6 +150,23 @@ MaxArraySize("instcombine-maxarray-size", cl::init(1024),
 // for their entire lifetime. However, passes like DSE and instcombine can
 // delete stores to the alloca, leading to misleading and inaccurate debug
 // information. This flag can be removed when those passes are fixed.
+// With a limit of 1, instructions are only revisited after the first pass over
+// the function when their operands or users changed.
+static cl::opt<unsigned> MaxIterations(
+    "instcombine-max-iterations", cl::Hidden, cl::init(1000),
+    cl::desc("Maximum number of passes over a function, each adding all of "
+             "its instructions to the worklist"));
+
+static cl::opt<std::string> StatsJSONFile(
+    "instcombine-stats-json", cl::Hidden, cl::value_desc("filename"),
+    cl::desc("Write the iterations, visited instructions and visit times of "
+             "instcombine to this file"));
+
+static cl::opt<unsigned> StatsJSONTopTransforms(
+    "instcombine-stats-json-top", cl::Hidden, cl::init(10),
+    cl::desc("Number of opcodes with the longest visit time listed in "
+             "-instcombine-stats-json"));
+
 static cl::opt<unsigned> ShouldLowerDbgDeclare("instcombine-lower-dbg-declare",
                                                cl::Hidden, cl::init(true));
 
@@ -3209,7 +3238,22 @@ bool InstCombiner::run() {
     LLVM_DEBUG(raw_string_ostream SS(OrigI); I->print(SS); OrigI = SS.str(););
     LLVM_DEBUG(dbgs() << "IC: Visiting: " << OrigI << '\n');
 
-    if (Instruction *Result = visit(*I)) {
+    Instruction *Result;
+    if (Stats) {
+      unsigned Opcode = I->getOpcode();
+      auto Start = std::chrono::steady_clock::now();
+      Result = visit(*I);
+      std::chrono::duration<double> Time =
+          std::chrono::steady_clock::now() - Start;
+      auto &OpcodeTime = Stats->VisitTime[Opcode];
+      OpcodeTime.first += Time.count();
+      ++OpcodeTime.second;
+      ++Stats->NumVisited;
+    } else {
+      Result = visit(*I);
+    }
+
+    if (Result) {
       ++NumCombined;
       // Should we replace the old instruction with a new one?
       if (Result != I) {
@@ -3404,6 +3448,67 @@ static bool prepareICWorklistFromFunction(Function &F, const DataLayout &DL,
   return MadeIRChange;
 }
 
+namespace {
+
+/// Telemetry of all the functions combined so far, for
+/// -instcombine-stats-json.
+struct InstCombineReport {
+  struct FunctionRun {
+    std::string Name;
+    SmallVector<unsigned, 4> VisitedPerIteration;
+  };
+
+  std::vector<FunctionRun> Runs;
+  DenseMap<unsigned, std::pair<double, unsigned>> VisitTime;
+
+  Error writeToFile(StringRef Path) const;
+};
+
+} // end anonymous namespace
+
+static ManagedStatic<InstCombineReport> Report;
+
+Error InstCombineReport::writeToFile(StringRef Path) const {
+  std::error_code EC;
+  raw_fd_ostream OS(Path, EC, sys::fs::F_Text);
+  if (EC)
+    return createFileError(Path, errorCodeToError(EC));
+
+  json::Array RunArray;
+  uint64_t NumIterations = 0;
+  for (const FunctionRun &Run : Runs) {
+    json::Array Visited;
+    for (unsigned N : Run.VisitedPerIteration)
+      Visited.push_back(N);
+    NumIterations += Run.VisitedPerIteration.size();
+    RunArray.push_back(json::Object{
+        {"name", Run.Name},
+        {"iterations", int64_t(Run.VisitedPerIteration.size())},
+        {"visited", std::move(Visited)}});
+  }
+
+  using OpcodeTime = std::pair<unsigned, std::pair<double, unsigned>>;
+  std::vector<OpcodeTime> Opcodes(VisitTime.begin(), VisitTime.end());
+  llvm::sort(Opcodes, [](const OpcodeTime &A, const OpcodeTime &B) {
+    return A.second.first > B.second.first ||
+           (A.second.first == B.second.first && A.first < B.first);
+  });
+  if (Opcodes.size() > StatsJSONTopTransforms)
+    Opcodes.resize(StatsJSONTopTransforms);
+  json::Array Transforms;
+  for (const auto &O : Opcodes)
+    Transforms.push_back(
+        json::Object{{"opcode", Instruction::getOpcodeName(O.first)},
+                     {"time_ms", O.second.first * 1000},
+                     {"visits", O.second.second}});
+
+  json::Object Root{{"functions", std::move(RunArray)},
+                    {"num_iterations", int64_t(NumIterations)},
+                    {"top_transforms", std::move(Transforms)}};
+  OS << formatv("{0:2}", json::Value(std::move(Root))) << '\n';
+  return Error::success();
+}
+
 static bool combineInstructionsOverFunction(
     Function &F, InstCombineWorklist &Worklist, AliasAnalysis *AA,
     AssumptionCache &AC, TargetLibraryInfo &TLI, DominatorTree &DT,
@@ -3428,10 +3533,15 @@ static bool combineInstructionsOverFunction(
   if (ShouldLowerDbgDeclare)
     MadeIRChange = LowerDbgDeclare(F);
 
+  bool CollectStats = !StatsJSONFile.empty();
+  InstCombineStats Stats;
+  InstCombineReport::FunctionRun Run;
+
   // Iterate while there is work to do.
-  int Iteration = 0;
+  unsigned Iteration = 0;
   while (true) {
     ++Iteration;
+    ++NumWorklistIterations;
     LLVM_DEBUG(dbgs() << "\n\nINSTCOMBINE ITERATION #" << Iteration << " on "
                       << F.getName() << "\n");
 
@@ -3440,12 +3550,36 @@ static bool combineInstructionsOverFunction(
     InstCombiner IC(Worklist, Builder, F.optForMinSize(), ExpensiveCombines, AA,
                     AC, TLI, DT, ORE, DL, LI);
     IC.MaxArraySizeForCombine = MaxArraySize;
+    IC.Stats = CollectStats ? &Stats : nullptr;
+
+    Stats.NumVisited = 0;
+    bool Changed = IC.run();
+    if (CollectStats)
+      Run.VisitedPerIteration.push_back(Stats.NumVisited);
+    if (!Changed)
+      break;
 
-    if (!IC.run())
+    MadeIRChange = true;
+    if (Iteration >= MaxIterations) {
+      LLVM_DEBUG(dbgs() << "Reached the limit of " << MaxIterations
+                        << " instcombine iterations on " << F.getName()
+                        << "\n");
+      ++NumMaxIterationsReached;
       break;
+    }
   }
 
-  return MadeIRChange || Iteration > 1;
+  if (CollectStats) {
+    Run.Name = F.getName();
+    Report->Runs.push_back(std::move(Run));
+    for (const auto &OpcodeTime : Stats.VisitTime) {
+      auto &Total = Report->VisitTime[OpcodeTime.first];
+      Total.first += OpcodeTime.second.first;
+      Total.second += OpcodeTime.second.second;
+    }
+  }
+
+  return MadeIRChange;
 }
 
 PreservedAnalyses InstCombinePass::run(Function &F,
@@ -3504,6 +3638,15 @@ bool InstructionCombiningPass::runOnFunction(Function &F) {
                                          ExpensiveCombines, LI);
 }
 
+bool InstructionCombiningPass::doFinalization(Module &M) {
+  // Every instance rewrites the report, so it covers all the functions
+  // combined by the time the last instance is finalized.
+  if (!StatsJSONFile.empty() && !Report->Runs.empty())
+    if (Error E = Report->writeToFile(StatsJSONFile))
+      M.getContext().emitError(toString(std::move(E)));
+  return false;
+}
+
 char InstructionCombiningPass::ID = 0;
 
 INITIALIZE_PASS_BEGIN(InstructionCombiningPass, "instcombine",
@@ -16,6 +16,7 @@
 #include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/DepthFirstIterator.h"
+#include "llvm/ADT/MapVector.h"
 #include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/Statistic.h"
@@ -23,6 +24,7 @@
 #include "llvm/ADT/StringRef.h"
 #include "llvm/ADT/Triple.h"
 #include "llvm/ADT/Twine.h"
+#include "llvm/Analysis/LoopInfo.h"
 #include "llvm/Analysis/MemoryBuiltins.h"
 #include "llvm/Analysis/TargetLibraryInfo.h"
 #include "llvm/Transforms/Utils/Local.h"
@@ -80,6 +82,7 @@
 #include <cstdint>
 #include <iomanip>
 #include <limits>
+#include <map>
 #include <memory>
 #include <sstream>
 #include <string>
@@ -334,6 +337,13 @@ static cl::opt<bool> ClOptStack(
     "asan-opt-stack", cl::desc("Don't instrument scalar stack variables"),
     cl::Hidden, cl::init(false));
 
+static cl::opt<bool> ClOptDominating(
+    "asan-opt-dominating",
+    cl::desc("Share checks between accesses: drop accesses checked in a "
+             "single predecessor, merge adjacent accesses into one wider "
+             "check and hoist loop-invariant checks to the preheader"),
+    cl::Hidden, cl::init(false));
+
 static cl::opt<bool> ClDynamicAllocaStack(
     "asan-stack-dynamic-alloca",
     cl::desc("Use dynamic alloca to represent stack variables"), cl::Hidden,
@@ -390,6 +400,11 @@ STATISTIC(NumOptimizedAccessesToGlobalVar,
           "Number of optimized accesses to global vars");
 STATISTIC(NumOptimizedAccessesToStackVar,
           "Number of optimized accesses to stack vars");
+STATISTIC(NumDominatedAccesses,
+          "Number of accesses checked in a single predecessor");
+STATISTIC(NumCombinedChecks, "Number of checks covering adjacent accesses");
+STATISTIC(NumHoistedChecks, "Number of checks hoisted out of loops");
+STATISTIC(NumCoveredAccesses, "Number of accesses covered by a shared check");
 
 namespace {
 
@@ -607,6 +622,18 @@ static size_t RedzoneSizeForScale(int MappingScale) {
 
 namespace {
 
+/// One check that stands for one or more memory accesses: TypeSize bits at
+/// Base + Offset bytes, emitted before InsertBefore.
+struct SharedCheck {
+  Instruction *Access;
+  Instruction *InsertBefore;
+  Value *Base;
+  int64_t Offset;
+  uint64_t TypeSize;
+  unsigned Alignment;
+  bool IsWrite;
+};
+
 /// AddressSanitizer: instrument the code in module to find memory bugs.
 struct AddressSanitizer : public FunctionPass {
   // Pass identification, replacement for typeid
@@ -671,6 +698,10 @@ struct AddressSanitizer : public FunctionPass {
                                  bool IsWrite, size_t AccessSizeIndex,
                                  Value *SizeArgument, uint32_t Exp);
   void instrumentMemIntrinsic(MemIntrinsic *MI);
+  void findSharedChecks(Function &F, ArrayRef<Instruction *> ToInstrument,
+                        DenseMap<Instruction *, SharedCheck> &Checks,
+                        SmallPtrSetImpl<Instruction *> &Covered);
+  void instrumentSharedCheck(const SharedCheck &Check, bool UseCalls);
   Value *memToShadow(Value *Shadow, IRBuilder<> &IRB);
   bool runOnFunction(Function &F) override;
   bool maybeInsertAsanInitAtFunctionEntry(Function &F);
@@ -1459,6 +1490,192 @@ void AddressSanitizer::instrumentMop(ObjectSizeOffsetVisitor &ObjSizeVis,
   }
 }
 
+// Returns the number of checks instrumentAddress or
+// instrumentUnusualSizeOrAlignment emits for one access.
+static unsigned getNumChecks(uint64_t TypeSize, unsigned Alignment,
+                             unsigned Granularity) {
+  if ((TypeSize == 8 || TypeSize == 16 || TypeSize == 32 || TypeSize == 64 ||
+       TypeSize == 128) &&
+      (Alignment >= Granularity || Alignment >= TypeSize / 8))
+    return 1;
+  return 2;
+}
+
+// Returns true if every iteration of L runs to its back edge or exit: no
+// calls, allocas or instructions that may trap or unwind.
+static bool isQuietLoop(const Loop &L) {
+  for (BasicBlock *BB : L.blocks())
+    for (Instruction &I : *BB) {
+      if (isa<DbgInfoIntrinsic>(I))
+        continue;
+      if (isa<AllocaInst>(I) || CallSite(&I) ||
+          !isGuaranteedToTransferExecutionToSuccessor(&I))
+        return false;
+    }
+  return true;
+}
+
+void AddressSanitizer::findSharedChecks(
+    Function &F, ArrayRef<Instruction *> ToInstrument,
+    DenseMap<Instruction *, SharedCheck> &Checks,
+    SmallPtrSetImpl<Instruction *> &Covered) {
+  const DataLayout &DL = F.getParent()->getDataLayout();
+  unsigned Granularity = 1 << Mapping.Scale;
+
+  // Only plain loads and stores of whole bytes take part. Accesses to globals
+  // and stack variables are left to instrumentMop, which may prove them safe.
+  struct Candidate {
+    Instruction *I;
+    Value *Addr;
+    Value *Base;
+    int64_t Offset;
+    uint64_t TypeSize;
+    unsigned Alignment;
+    bool IsWrite;
+  };
+  SmallVector<Candidate, 16> Candidates;
+  DenseMap<Instruction *, unsigned> CandidateIndex;
+  for (Instruction *I : ToInstrument) {
+    if (!(isa<LoadInst>(I) && !cast<LoadInst>(I)->isVolatile()) &&
+        !(isa<StoreInst>(I) && !cast<StoreInst>(I)->isVolatile()))
+      continue;
+    Candidate C;
+    C.I = I;
+    C.Addr = isInterestingMemoryAccess(I, &C.IsWrite, &C.TypeSize,
+                                       &C.Alignment);
+    if (!C.Addr || C.TypeSize % 8 != 0)
+      continue;
+    Value *Obj = GetUnderlyingObject(C.Addr, DL);
+    if ((ClOptGlobals && isa<GlobalVariable>(Obj)) ||
+        (ClOptStack && isa<AllocaInst>(Obj)))
+      continue;
+    if (C.Alignment == 0)
+      C.Alignment = DL.getABITypeAlignment(
+          cast<PointerType>(C.Addr->getType())->getElementType());
+    C.Base = GetPointerBaseWithConstantOffset(C.Addr, C.Offset, DL);
+    CandidateIndex[I] = Candidates.size();
+    Candidates.push_back(C);
+  }
+  if (Candidates.empty())
+    return;
+
+  // Hoist the check of a loop-invariant address to the preheader when the
+  // access runs on the first iteration of a loop that cannot stop early. The
+  // same address, size and direction is then checked once per loop.
+  LoopInfo LI(*DT);
+  DenseMap<Loop *, bool> QuietLoops;
+  std::map<std::tuple<Loop *, Value *, uint64_t, bool>, Instruction *> Hoisted;
+  for (const Candidate &C : Candidates) {
+    BasicBlock *BB = C.I->getParent();
+    Loop *L = LI.getLoopFor(BB);
+    if (!L || !L->getLoopPreheader() || !L->isLoopInvariant(C.Addr))
+      continue;
+    auto Quiet = QuietLoops.insert({L, false});
+    if (Quiet.second)
+      Quiet.first->second = isQuietLoop(*L);
+    if (!Quiet.first->second)
+      continue;
+    SmallVector<BasicBlock *, 4> ExitingBlocks;
+    L->getExitingBlocks(ExitingBlocks);
+    if (ExitingBlocks.empty() ||
+        !all_of(ExitingBlocks, [&](BasicBlock *Exiting) {
+          return DT->dominates(BB, Exiting);
+        }))
+      continue;
+    auto Key = std::make_tuple(L, C.Addr, C.TypeSize, C.IsWrite);
+    if (!Hoisted.insert({Key, C.I}).second) {
+      Covered.insert(C.I);
+      continue;
+    }
+    Checks[C.I] = {C.I, L->getLoopPreheader()->getTerminator(), C.Addr, 0,
+                   C.TypeSize, C.Alignment, C.IsWrite};
+    NumHoistedChecks++;
+  }
+
+  // Merge accesses to overlapping or adjacent bytes of the same base into
+  // one check of up to 16 bytes, placed at the first of them, when that
+  // needs fewer checks. The accesses must be in one block with nothing
+  // between them that can stop execution.
+  using GroupKey = std::pair<Value *, unsigned>;
+  MapVector<GroupKey, SmallVector<unsigned, 4>> Groups;
+  auto Flush = [&]() {
+    for (auto &Group : Groups) {
+      SmallVectorImpl<unsigned> &Members = Group.second;
+      std::stable_sort(Members.begin(), Members.end(),
+                       [&](unsigned A, unsigned B) {
+                         return Candidates[A].Offset < Candidates[B].Offset;
+                       });
+      for (unsigned First = 0, E = Members.size(); First != E;) {
+        const Candidate &Start = Candidates[Members[First]];
+        int64_t End = Start.Offset + Start.TypeSize / 8;
+        unsigned Cost = getNumChecks(Start.TypeSize, Start.Alignment,
+                                     Granularity);
+        unsigned Leader = Members[First];
+        unsigned Last = First + 1;
+        for (; Last != E; ++Last) {
+          const Candidate &Next = Candidates[Members[Last]];
+          int64_t NextEnd = Next.Offset + Next.TypeSize / 8;
+          if (Next.Offset > End || std::max(End, NextEnd) - Start.Offset > 16)
+            break;
+          End = std::max(End, NextEnd);
+          Cost += getNumChecks(Next.TypeSize, Next.Alignment, Granularity);
+          Leader = std::min(Leader, Members[Last]);
+        }
+        uint64_t TypeSize = (End - Start.Offset) * 8;
+        if (Last - First > 1 &&
+            getNumChecks(TypeSize, Start.Alignment, Granularity) < Cost) {
+          Instruction *LeaderI = Candidates[Leader].I;
+          Checks[LeaderI] = {LeaderI, LeaderI, Start.Base, Start.Offset,
+                             TypeSize, Start.Alignment, Start.IsWrite};
+          for (unsigned Member = First; Member != Last; ++Member)
+            if (Members[Member] != Leader)
+              Covered.insert(Candidates[Members[Member]].I);
+          NumCombinedChecks++;
+        }
+        First = Last;
+      }
+    }
+    Groups.clear();
+  };
+  for (BasicBlock &BB : F) {
+    for (Instruction &I : BB) {
+      auto It = CandidateIndex.find(&I);
+      if (It != CandidateIndex.end()) {
+        if (!Checks.count(&I) && !Covered.count(&I)) {
+          const Candidate &C = Candidates[It->second];
+          Groups[{C.Base, C.IsWrite}].push_back(It->second);
+        }
+        continue;
+      }
+      if (isa<DbgInfoIntrinsic>(I))
+        continue;
+      if (CallSite(&I) || !isGuaranteedToTransferExecutionToSuccessor(&I))
+        Flush();
+    }
+    Flush();
+  }
+}
+
+void AddressSanitizer::instrumentSharedCheck(const SharedCheck &Check,
+                                             bool UseCalls) {
+  if (Check.IsWrite)
+    NumInstrumentedWrites++;
+  else
+    NumInstrumentedReads++;
+
+  Value *Addr = Check.Base;
+  if (Check.Offset != 0) {
+    IRBuilder<> IRB(Check.InsertBefore);
+    unsigned AS = cast<PointerType>(Addr->getType())->getAddressSpace();
+    Addr = IRB.CreateConstGEP1_64(
+        IRB.CreatePointerCast(Addr, IRB.getInt8PtrTy(AS)), Check.Offset);
+  }
+  unsigned Granularity = 1 << Mapping.Scale;
+  doInstrumentAddress(this, Check.Access, Check.InsertBefore, Addr,
+                      Check.Alignment, Granularity, Check.TypeSize,
+                      Check.IsWrite, nullptr, UseCalls, ClForceExperiment);
+}
+
 Instruction *AddressSanitizer::generateCrashCode(Instruction *InsertBefore,
                                                  Value *Addr, bool IsWrite,
                                                  size_t AccessSizeIndex,
@@ -2520,8 +2737,11 @@ bool AddressSanitizer::runOnFunction(Function &F) {
   markEscapedLocalAllocas(F);
 
   // We want to instrument every address only once per basic block (unless there
-  // are calls between uses).
+  // are calls between uses). With -asan-opt-dominating, a block also starts
+  // with the addresses checked at the end of its single predecessor.
   SmallPtrSet<Value *, 16> TempsToInstrument;
+  DenseMap<BasicBlock *, SmallPtrSet<Value *, 16>> TempsAtEnd;
+  bool OptDominating = ClOpt && ClOptSameTemp && ClOptDominating;
   SmallVector<Instruction *, 16> ToInstrument;
   SmallVector<Instruction *, 8> NoReturnCalls;
   SmallVector<BasicBlock *, 16> AllBlocks;
@@ -2537,6 +2757,13 @@ bool AddressSanitizer::runOnFunction(Function &F) {
   for (auto &BB : F) {
     AllBlocks.push_back(&BB);
     TempsToInstrument.clear();
+    SmallPtrSet<Value *, 16> Dominating;
+    if (OptDominating)
+      if (BasicBlock *Pred = BB.getSinglePredecessor()) {
+        auto It = TempsAtEnd.find(Pred);
+        if (It != TempsAtEnd.end())
+          Dominating = It->second;
+      }
     int NumInsnsPerBB = 0;
     for (auto &Inst : BB) {
       if (LooksLikeCodeInBug11395(&Inst)) return false;
@@ -2544,6 +2771,10 @@ bool AddressSanitizer::runOnFunction(Function &F) {
       if (Value *Addr = isInterestingMemoryAccess(&Inst, &IsWrite, &TypeSize,
                                                   &Alignment, &MaybeMask)) {
         if (ClOpt && ClOptSameTemp) {
+          if (Dominating.count(Addr)) {
+            NumDominatedAccesses++;
+            continue; // This temp was checked in the single predecessor.
+          }
           // If we have a mask, skip instrumentation if we've already
           // instrumented the full object. But don't add to TempsToInstrument
           // because we might get another load/store with a different mask.
@@ -2567,6 +2798,7 @@ bool AddressSanitizer::runOnFunction(Function &F) {
         if (CS) {
           // A call inside BB.
           TempsToInstrument.clear();
+          Dominating.clear();
           if (CS.doesNotReturn()) NoReturnCalls.push_back(CS.getInstruction());
         }
         if (CallInst *CI = dyn_cast<CallInst>(&Inst))
@@ -2575,7 +2807,16 @@ bool AddressSanitizer::runOnFunction(Function &F) {
       }
       ToInstrument.push_back(&Inst);
       NumInsnsPerBB++;
-      if (NumInsnsPerBB >= ClMaxInsnsToInstrumentPerBB) break;
+      if (NumInsnsPerBB >= ClMaxInsnsToInstrumentPerBB) {
+        // The rest of the block was not scanned for calls.
+        TempsToInstrument.clear();
+        Dominating.clear();
+        break;
+      }
+    }
+    if (OptDominating) {
+      TempsToInstrument.insert(Dominating.begin(), Dominating.end());
+      TempsAtEnd[&BB] = std::move(TempsToInstrument);
     }
   }
 
@@ -2587,12 +2828,22 @@ bool AddressSanitizer::runOnFunction(Function &F) {
   ObjSizeOpts.RoundToAlign = true;
   ObjectSizeOffsetVisitor ObjSizeVis(DL, TLI, F.getContext(), ObjSizeOpts);
 
+  DenseMap<Instruction *, SharedCheck> SharedChecks;
+  SmallPtrSet<Instruction *, 16> CoveredAccesses;
+  if (OptDominating)
+    findSharedChecks(F, ToInstrument, SharedChecks, CoveredAccesses);
+
   // Instrument.
   int NumInstrumented = 0;
   for (auto Inst : ToInstrument) {
     if (ClDebugMin < 0 || ClDebugMax < 0 ||
         (NumInstrumented >= ClDebugMin && NumInstrumented <= ClDebugMax)) {
-      if (isInterestingMemoryAccess(Inst, &IsWrite, &TypeSize, &Alignment))
+      auto Check = SharedChecks.find(Inst);
+      if (Check != SharedChecks.end())
+        instrumentSharedCheck(Check->second, UseCalls);
+      else if (CoveredAccesses.count(Inst))
+        NumCoveredAccesses++;
+      else if (isInterestingMemoryAccess(Inst, &IsWrite, &TypeSize, &Alignment))
         instrumentMop(ObjSizeVis, Inst, UseCalls,
                       F.getParent()->getDataLayout());
       else
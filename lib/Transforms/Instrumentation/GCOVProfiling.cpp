@@ -14,10 +14,12 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include "CFGMST.h"
 #include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/Hashing.h"
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/Sequence.h"
+#include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/Statistic.h"
 #include "llvm/ADT/StringExtras.h"
 #include "llvm/ADT/StringMap.h"
@@ -40,6 +42,7 @@
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Transforms/Instrumentation.h"
 #include "llvm/Transforms/Instrumentation/GCOVProfiler.h"
+#include "llvm/Transforms/Utils/BasicBlockUtils.h"
 #include "llvm/Transforms/Utils/ModuleUtils.h"
 #include <algorithm>
 #include <memory>
@@ -55,6 +58,12 @@ DefaultGCOVVersion("default-gcov-version", cl::init("402*"), cl::Hidden,
 static cl::opt<bool> DefaultExitBlockBeforeBody("gcov-exit-block-before-body",
                                                 cl::init(false), cl::Hidden);
 
+// Only count the arcs that are not on a spanning tree of the CFG, and compute
+// the others from them when the .gcda file is written out.
+static cl::opt<bool> GCOVSpanningTree(
+    "gcov-spanning-tree", cl::init(false), cl::Hidden,
+    cl::desc("Instrument only the arcs not on a spanning tree of the CFG"));
+
 GCOVOptions GCOVOptions::getDefault() {
   GCOVOptions Options;
   Options.EmitNotes = true;
@@ -97,6 +106,16 @@ private:
   // profiling runtime to emit .gcda files when run.
   bool emitProfileArcs();
 
+  // Instrument the arcs of F that are not on a spanning tree of its CFG.
+  // Returns false, without changing F, if some arc cannot be instrumented.
+  bool emitSpanningTreeArcs(
+      Function &F, DISubprogram *SP,
+      SmallVectorImpl<std::pair<GlobalVariable *, MDNode *>> &CountersBySP);
+
+  // Compute the counters of the arcs on the spanning tree from the others.
+  void emitArcReconstruction(IRBuilder<> &Builder,
+                             ArrayRef<std::pair<GlobalVariable *, MDNode *>>);
+
   bool isFunctionInstrumented(const Function &F);
   std::vector<Regex> createRegexesFromString(StringRef RegexesStr);
   static bool doesFilenameMatchARegex(StringRef Filename,
@@ -131,6 +150,22 @@ private:
   const TargetLibraryInfo *TLI;
   LLVMContext *Ctx;
   SmallVector<std::unique_ptr<GCOVFunction>, 16> Funcs;
+
+  // Sets the counter of the arc Target to the sum of the counters of the arcs
+  // in Add minus those in Sub.
+  struct ArcReconstructStep {
+    unsigned Target;
+    SmallVector<unsigned, 4> Add;
+    SmallVector<unsigned, 4> Sub;
+  };
+  // The counters of a function instrumented on a spanning tree. The arcs of
+  // the .gcno are the first NumArcs counters, the rest count fake arcs.
+  struct SpanningTreeCounters {
+    unsigned NumArcs;
+    std::vector<ArcReconstructStep> Steps;
+  };
+  DenseMap<GlobalVariable *, SpanningTreeCounters> SpanningTrees;
+
   std::vector<Regex> FilterRe;
   std::vector<Regex> ExcludeRe;
   StringMap<bool> InstrumentedFiles;
@@ -759,6 +794,169 @@ void GCOVProfiler::emitProfileNotes() {
   }
 }
 
+namespace {
+// An edge of the CFG, or a fake edge into the entry block or out of a block
+// without successors, as used by CFGMST.
+struct GCOVTreeEdge {
+  const BasicBlock *SrcBB;
+  const BasicBlock *DestBB;
+  uint64_t Weight;
+  bool InMST = false;
+  bool Removed = false;
+  bool IsCritical = false;
+  // The index of the counter of this edge, and of the edge in the successors
+  // of SrcBB.
+  unsigned Counter = 0;
+  unsigned SuccNum = 0;
+
+  GCOVTreeEdge(const BasicBlock *Src, const BasicBlock *Dest, uint64_t W = 1)
+      : SrcBB(Src), DestBB(Dest), Weight(W) {}
+};
+
+struct GCOVTreeBBInfo {
+  GCOVTreeBBInfo *Group;
+  uint32_t Index;
+  uint32_t Rank = 0;
+
+  GCOVTreeBBInfo(unsigned IX) : Group(this), Index(IX) {}
+};
+} // end anonymous namespace
+
+bool GCOVProfiler::emitSpanningTreeArcs(
+    Function &F, DISubprogram *SP,
+    SmallVectorImpl<std::pair<GlobalVariable *, MDNode *>> &CountersBySP) {
+  // Number the arcs in the order they are written to the .gcno file.
+  DenseMap<std::pair<const BasicBlock *, const BasicBlock *>,
+           SmallVector<std::pair<unsigned, unsigned>, 2>>
+      ArcsByEdge;
+  unsigned NumArcs = 0;
+  for (auto &BB : F) {
+    Instruction *TI = BB.getTerminator();
+    if (isa<ReturnInst>(TI)) {
+      ArcsByEdge[{&BB, nullptr}].push_back({NumArcs++, 0});
+    } else {
+      for (unsigned I = 0, E = TI->getNumSuccessors(); I != E; ++I)
+        ArcsByEdge[{&BB, TI->getSuccessor(I)}].push_back({NumArcs++, I});
+    }
+  }
+
+  // Give each edge a counter. Fake edges have no arc in the .gcno, so their
+  // counters follow those of the arcs.
+  CFGMST<GCOVTreeEdge, GCOVTreeBBInfo> MST(F);
+  unsigned NumCounters = NumArcs;
+  for (auto &E : MST.AllEdges) {
+    auto It = ArcsByEdge.find({E->SrcBB, E->DestBB});
+    if (E->SrcBB && It != ArcsByEdge.end() && !It->second.empty()) {
+      // Parallel edges are interchangeable, so take their arcs in order.
+      std::tie(E->Counter, E->SuccNum) = It->second.front();
+      It->second.erase(It->second.begin());
+    } else {
+      E->Counter = NumCounters++;
+    }
+
+    // A critical edge is counted in a block split from it, which is not
+    // possible for every kind of edge.
+    if (E->InMST || !E->SrcBB || !E->DestBB || !E->IsCritical)
+      continue;
+    const Instruction *TI = E->SrcBB->getTerminator();
+    if (TI->getNumSuccessors() > 1 &&
+        (isa<IndirectBrInst>(TI) || E->DestBB->isEHPad()))
+      return false;
+  }
+
+  ArrayType *CounterTy = ArrayType::get(Type::getInt64Ty(*Ctx), NumCounters);
+  GlobalVariable *Counters =
+      new GlobalVariable(*M, CounterTy, false, GlobalValue::InternalLinkage,
+                         Constant::getNullValue(CounterTy), "__llvm_gcov_ctr");
+  CountersBySP.push_back(std::make_pair(Counters, SP));
+
+  for (auto &E : MST.AllEdges) {
+    if (E->InMST)
+      continue;
+    BasicBlock *SrcBB = const_cast<BasicBlock *>(E->SrcBB);
+    BasicBlock *DestBB = const_cast<BasicBlock *>(E->DestBB);
+    BasicBlock::iterator InsertPt;
+    if (!SrcBB) {
+      // Count calls after the allocas of the entry block.
+      InsertPt = DestBB->getFirstInsertionPt();
+      while (shouldKeepInEntry(InsertPt))
+        ++InsertPt;
+    } else if (!DestBB || SrcBB->getTerminator()->getNumSuccessors() <= 1) {
+      InsertPt = SrcBB->getTerminator()->getIterator();
+    } else if (!E->IsCritical) {
+      InsertPt = DestBB->getFirstInsertionPt();
+    } else {
+      BasicBlock *InstrBB =
+          SplitCriticalEdge(SrcBB->getTerminator(), E->SuccNum);
+      assert(InstrBB && "Critical edge is not split");
+      InsertPt = InstrBB->getFirstInsertionPt();
+    }
+    IRBuilder<> Builder(&*InsertPt);
+    Value *Counter = Builder.CreateConstInBoundsGEP2_64(Counters, 0, E->Counter);
+    Value *Count = Builder.CreateLoad(Counter);
+    Count = Builder.CreateAdd(Count, Builder.getInt64(1));
+    Builder.CreateStore(Count, Counter);
+  }
+
+  // Flow is conserved at every block and at the fake node, so the counter of
+  // a tree edge is known once it is the only unknown edge of one of its
+  // blocks. Peel the tree from its leaves to order the computations.
+  DenseMap<const BasicBlock *, SmallVector<GCOVTreeEdge *, 4>> EdgesByBB;
+  DenseMap<const BasicBlock *, unsigned> NumUnknown;
+  for (auto &E : MST.AllEdges) {
+    // Self loops leave the flow through their block unchanged.
+    if (E->SrcBB == E->DestBB)
+      continue;
+    EdgesByBB[E->SrcBB].push_back(E.get());
+    EdgesByBB[E->DestBB].push_back(E.get());
+    if (E->InMST) {
+      ++NumUnknown[E->SrcBB];
+      ++NumUnknown[E->DestBB];
+    }
+  }
+
+  SpanningTreeCounters &Tree = SpanningTrees[Counters];
+  Tree.NumArcs = NumArcs;
+  SmallPtrSet<GCOVTreeEdge *, 16> Solved;
+  SmallVector<const BasicBlock *, 16> Worklist;
+  for (const auto &I : NumUnknown)
+    if (I.second == 1)
+      Worklist.push_back(I.first);
+  while (!Worklist.empty()) {
+    const BasicBlock *BB = Worklist.pop_back_val();
+    if (NumUnknown[BB] != 1)
+      continue;
+    auto &Edges = EdgesByBB[BB];
+    auto It = llvm::find_if(Edges, [&](GCOVTreeEdge *E) {
+      return E->InMST && !Solved.count(E);
+    });
+    assert(It != Edges.end() && "No unknown edge left");
+    GCOVTreeEdge *Unknown = *It;
+    bool UnknownIsIncoming = Unknown->DestBB == BB;
+
+    ArcReconstructStep Step;
+    Step.Target = Unknown->Counter;
+    for (GCOVTreeEdge *E : Edges) {
+      if (E == Unknown)
+        continue;
+      if ((E->DestBB == BB) == UnknownIsIncoming)
+        Step.Sub.push_back(E->Counter);
+      else
+        Step.Add.push_back(E->Counter);
+    }
+    Tree.Steps.push_back(std::move(Step));
+
+    Solved.insert(Unknown);
+    --NumUnknown[Unknown->SrcBB];
+    --NumUnknown[Unknown->DestBB];
+    const BasicBlock *Other =
+        UnknownIsIncoming ? Unknown->SrcBB : Unknown->DestBB;
+    if (NumUnknown[Other] == 1)
+      Worklist.push_back(Other);
+  }
+  return true;
+}
+
 bool GCOVProfiler::emitProfileArcs() {
   NamedMDNode *CU_Nodes = M->getNamedMetadata("llvm.dbg.cu");
   if (!CU_Nodes) return false;
@@ -775,6 +973,9 @@ bool GCOVProfiler::emitProfileArcs() {
       if (isUsingScopeBasedEH(F)) continue;
       if (!Result) Result = true;
 
+      if (GCOVSpanningTree && emitSpanningTreeArcs(F, SP, CountersBySP))
+        continue;
+
       DenseMap<std::pair<BasicBlock *, BasicBlock *>, unsigned> EdgeToCounter;
       unsigned Edges = 0;
       for (auto &BB : F) {
@@ -1008,7 +1209,11 @@ Function *GCOVProfiler::insertCounterWriteout(
            Builder.getInt32(CfgChecksum)}));
 
       GlobalVariable *GV = CountersBySP[j].first;
-      unsigned Arcs = cast<ArrayType>(GV->getValueType())->getNumElements();
+      auto Tree = SpanningTrees.find(GV);
+      unsigned Arcs =
+          Tree != SpanningTrees.end()
+              ? Tree->second.NumArcs
+              : cast<ArrayType>(GV->getValueType())->getNumElements();
       EmitArcsCallArgsArray.push_back(ConstantStruct::get(
           EmitArcsCallArgsTy,
           {Builder.getInt32(Arcs), ConstantExpr::getInBoundsGetElementPtr(
@@ -1080,6 +1285,8 @@ Function *GCOVProfiler::insertCounterWriteout(
   auto *FileLoopLatch = BasicBlock::Create(*Ctx, "file.loop.latch", WriteoutF);
   auto *ExitBB = BasicBlock::Create(*Ctx, "exit", WriteoutF);
 
+  emitArcReconstruction(Builder, CountersBySP);
+
   // We always have at least one file, so just branch to the header.
   Builder.CreateBr(FileLoopHeader);
 
@@ -1155,6 +1362,33 @@ Function *GCOVProfiler::insertCounterWriteout(
   return WriteoutF;
 }
 
+void GCOVProfiler::emitArcReconstruction(
+    IRBuilder<> &Builder,
+    ArrayRef<std::pair<GlobalVariable *, MDNode *>> CountersBySP) {
+  for (const auto &I : CountersBySP) {
+    GlobalVariable *GV = I.first;
+    auto Tree = SpanningTrees.find(GV);
+    if (Tree == SpanningTrees.end())
+      continue;
+    auto LoadCounter = [&](unsigned Idx) {
+      return Builder.CreateLoad(Builder.CreateConstInBoundsGEP2_64(GV, 0, Idx));
+    };
+    for (const ArcReconstructStep &Step : Tree->second.Steps) {
+      Value *Count = Builder.getInt64(0);
+      for (unsigned Idx : Step.Add)
+        Count = Builder.CreateAdd(Count, LoadCounter(Idx));
+      for (unsigned Idx : Step.Sub)
+        Count = Builder.CreateSub(Count, LoadCounter(Idx));
+      // A call that does not return breaks flow conservation in its block, so
+      // never write out a negative count.
+      Value *IsNegative = Builder.CreateICmpSLT(Count, Builder.getInt64(0));
+      Count = Builder.CreateSelect(IsNegative, Builder.getInt64(0), Count);
+      Builder.CreateStore(Count,
+                          Builder.CreateConstInBoundsGEP2_64(GV, 0, Step.Target));
+    }
+  }
+}
+
 Function *GCOVProfiler::
 insertFlush(ArrayRef<std::pair<GlobalVariable*, MDNode*> > CountersBySP) {
   FunctionType *FTy = FunctionType::get(Type::getVoidTy(*Ctx), false);
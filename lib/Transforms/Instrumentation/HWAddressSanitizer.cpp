@@ -12,12 +12,14 @@
 /// based on tagged addressing.
 //===----------------------------------------------------------------------===//
 
+#include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/StringExtras.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/ADT/Triple.h"
 #include "llvm/IR/Attributes.h"
 #include "llvm/IR/BasicBlock.h"
+#include "llvm/IR/CallSite.h"
 #include "llvm/IR/Constant.h"
 #include "llvm/IR/Constants.h"
 #include "llvm/IR/DataLayout.h"
@@ -76,6 +78,18 @@ static cl::opt<bool>
                 cl::desc("instrument reads and writes with callbacks"),
                 cl::Hidden, cl::init(false));
 
+static cl::opt<bool> ClOutlinedChecks(
+    "hwasan-outlined-checks",
+    cl::desc("check tags with calls to small routines that the AArch64 "
+             "backend emits for each pointer register"),
+    cl::Hidden, cl::init(false));
+
+static cl::opt<bool> ClOptSamePointer(
+    "hwasan-opt-same-pointer",
+    cl::desc("check each pointer once per basic block unless there are calls "
+             "between accesses"),
+    cl::Hidden, cl::init(false));
+
 static cl::opt<bool> ClInstrumentReads("hwasan-instrument-reads",
                                        cl::desc("instrument read instructions"),
                                        cl::Hidden, cl::init(true));
@@ -182,7 +196,13 @@ public:
   void instrumentMemAccessInline(Value *PtrLong, bool IsWrite,
                                  unsigned AccessSizeIndex,
                                  Instruction *InsertBefore);
-  bool instrumentMemAccess(Instruction *I);
+  bool useOutlinedChecks() const;
+  void instrumentMemAccessOutlined(Value *PtrLong, bool IsWrite,
+                                   unsigned AccessSizeIndex,
+                                   Instruction *InsertBefore);
+  static bool isFastPathAccess(uint64_t TypeSize, unsigned Alignment,
+                               unsigned Granularity);
+  bool instrumentMemAccess(Instruction *I, bool AlreadyChecked);
   Value *isInterestingMemoryAccess(Instruction *I, bool *IsWrite,
                                    uint64_t *TypeSize, unsigned *Alignment,
                                    Value **MaybeMask);
@@ -548,7 +568,45 @@ void HWAddressSanitizer::instrumentMemAccessInline(Value *PtrLong, bool IsWrite,
   IRB.CreateCall(Asm, PtrLong);
 }
 
-bool HWAddressSanitizer::instrumentMemAccess(Instruction *I) {
+// The outlined routines load the shadow through a register and have no
+// recovery path, so they are used on AArch64 ELF targets in abort mode only.
+bool HWAddressSanitizer::useOutlinedChecks() const {
+  int MatchAllTag = ClMatchAllTag.getNumOccurrences() > 0
+                        ? ClMatchAllTag
+                        : (CompileKernel ? 0xFF : -1);
+  return ClOutlinedChecks && TargetTriple.isAArch64() &&
+         TargetTriple.isOSBinFormatELF() && !Recover && MatchAllTag == -1;
+}
+
+void HWAddressSanitizer::instrumentMemAccessOutlined(
+    Value *PtrLong, bool IsWrite, unsigned AccessSizeIndex,
+    Instruction *InsertBefore) {
+  IRBuilder<> IRB(InsertBefore);
+  Module *M = InsertBefore->getModule();
+  Value *ShadowBase =
+      LocalDynamicShadow ? LocalDynamicShadow
+                         : ConstantInt::get(IntptrTy, Mapping.Offset);
+  const int64_t AccessInfo = IsWrite * 0x10 + AccessSizeIndex;
+  IRB.CreateCall(
+      Intrinsic::getDeclaration(M, Intrinsic::hwasan_check_memaccess),
+      {IRB.CreateIntToPtr(ShadowBase, Int8PtrTy),
+       IRB.CreateIntToPtr(PtrLong, Int8PtrTy),
+       ConstantInt::get(IRB.getInt32Ty(), AccessInfo)});
+}
+
+// Returns true if the access is checked by looking at the tag of its first
+// granule only.
+bool HWAddressSanitizer::isFastPathAccess(uint64_t TypeSize,
+                                          unsigned Alignment,
+                                          unsigned Granularity) {
+  return isPowerOf2_64(TypeSize) &&
+         (TypeSize / 8 <= (1UL << (kNumberOfAccessSizes - 1))) &&
+         (Alignment >= Granularity || Alignment == 0 ||
+          Alignment >= TypeSize / 8);
+}
+
+bool HWAddressSanitizer::instrumentMemAccess(Instruction *I,
+                                             bool AlreadyChecked) {
   LLVM_DEBUG(dbgs() << "Instrumenting: " << *I << "\n");
   bool IsWrite = false;
   unsigned Alignment = 0;
@@ -563,16 +621,21 @@ bool HWAddressSanitizer::instrumentMemAccess(Instruction *I) {
   if (MaybeMask)
     return false; //FIXME
 
+  // The same pointer was checked earlier in the block.
+  if (AlreadyChecked) {
+    untagPointerOperand(I, Addr);
+    return true;
+  }
+
   IRBuilder<> IRB(I);
   Value *AddrLong = IRB.CreatePointerCast(Addr, IntptrTy);
-  if (isPowerOf2_64(TypeSize) &&
-      (TypeSize / 8 <= (1UL << (kNumberOfAccessSizes - 1))) &&
-      (Alignment >= (1UL << Mapping.Scale) || Alignment == 0 ||
-       Alignment >= TypeSize / 8)) {
+  if (isFastPathAccess(TypeSize, Alignment, 1U << Mapping.Scale)) {
     size_t AccessSizeIndex = TypeSizeToSizeIndex(TypeSize);
     if (ClInstrumentWithCalls) {
       IRB.CreateCall(HwasanMemoryAccessCallback[IsWrite][AccessSizeIndex],
                      AddrLong);
+    } else if (useOutlinedChecks()) {
+      instrumentMemAccessOutlined(AddrLong, IsWrite, AccessSizeIndex, I);
     } else {
       instrumentMemAccessInline(AddrLong, IsWrite, AccessSizeIndex, I);
     }
@@ -888,7 +951,13 @@ bool HWAddressSanitizer::runOnFunction(Function &F) {
   SmallVector<Instruction*, 16> ToInstrument;
   SmallVector<AllocaInst*, 8> AllocasToInstrument;
   SmallVector<Instruction*, 8> RetVec;
+  // Accesses through a pointer whose tag was checked earlier in the block.
+  // Tags only change in calls, so the check is still valid up to the next
+  // call.
+  SmallPtrSet<Instruction *, 16> AlreadyChecked;
+  SmallPtrSet<Value *, 16> CheckedPointers;
   for (auto &BB : F) {
+    CheckedPointers.clear();
     for (auto &Inst : BB) {
       if (ClInstrumentStack)
         if (AllocaInst *AI = dyn_cast<AllocaInst>(&Inst)) {
@@ -914,6 +983,15 @@ bool HWAddressSanitizer::runOnFunction(Function &F) {
                                               &Alignment, &MaybeMask);
       if (Addr || isa<MemIntrinsic>(Inst))
         ToInstrument.push_back(&Inst);
+      if (!ClOptSamePointer)
+        continue;
+      if (Addr && !MaybeMask &&
+          isFastPathAccess(TypeSize, Alignment, 1U << Mapping.Scale)) {
+        if (!CheckedPointers.insert(Addr).second)
+          AlreadyChecked.insert(&Inst);
+      } else if (CallSite(&Inst) && !isa<DbgInfoIntrinsic>(Inst)) {
+        CheckedPointers.clear();
+      }
     }
   }
 
@@ -941,7 +1019,7 @@ bool HWAddressSanitizer::runOnFunction(Function &F) {
   }
 
   for (auto Inst : ToInstrument)
-    Changed |= instrumentMemAccess(Inst);
+    Changed |= instrumentMemAccess(Inst, AlreadyChecked.count(Inst));
 
   LocalDynamicShadow = nullptr;
 
@@ -14,6 +14,7 @@
 //===----------------------------------------------------------------------===//
 
 #include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/Statistic.h"
@@ -22,9 +23,12 @@
 #include "llvm/Analysis/IndirectCallSiteVisitor.h"
 #include "llvm/Analysis/OptimizationRemarkEmitter.h"
 #include "llvm/Analysis/ProfileSummaryInfo.h"
+#include "llvm/Analysis/TypeMetadataUtils.h"
 #include "llvm/IR/Attributes.h"
 #include "llvm/IR/BasicBlock.h"
 #include "llvm/IR/CallSite.h"
+#include "llvm/IR/Constants.h"
+#include "llvm/IR/DataLayout.h"
 #include "llvm/IR/DerivedTypes.h"
 #include "llvm/IR/DiagnosticInfo.h"
 #include "llvm/IR/Function.h"
@@ -51,6 +55,7 @@
 #include <cassert>
 #include <cstdint>
 #include <memory>
+#include <set>
 #include <string>
 #include <utility>
 #include <vector>
@@ -114,6 +119,22 @@ static cl::opt<bool>
     ICPDUMPAFTER("icp-dumpafter", cl::init(false), cl::Hidden,
                  cl::desc("Dump IR after transformation happens"));
 
+// If the option is set to true, a virtual call is promoted by comparing its
+// vtable pointer with the vtables in the module that hold the target, rather
+// than the loaded function pointer, so the direct call need not wait for the
+// load.
+static cl::opt<bool> ICPCompareVTables(
+    "icp-compare-vtables", cl::init(false), cl::Hidden,
+    cl::desc("Promote virtual calls by comparing vtable pointers"));
+
+// The max number of vtables a vtable pointer is compared with to promote one
+// target. Targets held by more vtables are promoted by comparing the function
+// pointer.
+static cl::opt<unsigned> ICPMaxNumVTableCmps(
+    "icp-max-num-vtable-cmps", cl::init(2), cl::Hidden,
+    cl::desc("Max number of vtables compared to promote one virtual call "
+             "target"));
+
 namespace {
 
 class PGOIndirectCallPromotionLegacyPass : public ModulePass {
@@ -165,6 +186,84 @@ ModulePass *llvm::createPGOIndirectCallPromotionLegacyPass(bool InLTO,
 
 namespace {
 
+// The vtables of a module that are known to the type metadata, indexed by the
+// functions in their slots.
+class VTableSlotIndex {
+public:
+  VTableSlotIndex(Module &M);
+
+  // Return the address points of the vtables holding \p F at \p Offset bytes
+  // past the address point.
+  ArrayRef<Constant *> lookup(const Function *F, uint64_t Offset) const {
+    auto It = Slots.find(std::make_pair(F, Offset));
+    if (It == Slots.end())
+      return None;
+    return It->second;
+  }
+
+private:
+  DenseMap<std::pair<const Function *, uint64_t>, SmallVector<Constant *, 1>>
+      Slots;
+};
+
+} // end anonymous namespace
+
+VTableSlotIndex::VTableSlotIndex(Module &M) {
+  const DataLayout &DL = M.getDataLayout();
+  Type *Int8Ty = Type::getInt8Ty(M.getContext());
+  Type *Int64Ty = Type::getInt64Ty(M.getContext());
+  uint64_t PtrSize = DL.getPointerSize();
+  SmallVector<MDNode *, 2> Types;
+  for (GlobalVariable &GV : M.globals()) {
+    // The vtable contents must be known to hold in the final program.
+    if (!GV.isConstant() || !GV.hasInitializer() || GV.isInterposable())
+      continue;
+    Types.clear();
+    GV.getMetadata(LLVMContext::MD_type, Types);
+    std::set<uint64_t> AddressPointOffsets;
+    for (MDNode *Type : Types)
+      if (auto *Offset = mdconst::dyn_extract<ConstantInt>(Type->getOperand(0)))
+        AddressPointOffsets.insert(Offset->getZExtValue());
+
+    Constant *Init = GV.getInitializer();
+    uint64_t Size = DL.getTypeAllocSize(Init->getType());
+    Constant *Base =
+        ConstantExpr::getBitCast(&GV, Type::getInt8PtrTy(M.getContext()));
+    for (uint64_t AddressPointOffset : AddressPointOffsets) {
+      Constant *AddressPoint = ConstantExpr::getInBoundsGetElementPtr(
+          Int8Ty, Base, ConstantInt::get(Int64Ty, AddressPointOffset));
+      for (uint64_t Offset = 0; AddressPointOffset + Offset + PtrSize <= Size;
+           Offset += PtrSize) {
+        Constant *Ptr =
+            getPointerAtOffset(Init, AddressPointOffset + Offset, M);
+        if (!Ptr)
+          continue;
+        if (auto *F = dyn_cast<Function>(Ptr->stripPointerCasts()))
+          Slots[std::make_pair(F, Offset)].push_back(AddressPoint);
+      }
+    }
+  }
+}
+
+// If \p CS loads its called value from a constant offset into the object
+// pointed to by another value, return that value, the vtable pointer of a
+// virtual call, and set \p Offset to the offset.
+static Value *getVTablePointer(CallSite CS, const DataLayout &DL,
+                               uint64_t &Offset) {
+  auto *Load = dyn_cast<LoadInst>(CS.getCalledValue()->stripPointerCasts());
+  if (!Load || !Load->isSimple())
+    return nullptr;
+  Value *Ptr = Load->getPointerOperand();
+  APInt ConstOffset(DL.getIndexTypeSizeInBits(Ptr->getType()), 0);
+  Value *VTable = Ptr->stripAndAccumulateInBoundsConstantOffsets(DL, ConstOffset);
+  if (isa<Constant>(VTable) || ConstOffset.isNegative())
+    return nullptr;
+  Offset = ConstOffset.getZExtValue();
+  return VTable;
+}
+
+namespace {
+
 // The class for main data structure to promote indirect calls to conditional
 // direct calls.
 class ICallPromotionFunc {
@@ -176,6 +275,10 @@ private:
   // defines.
   InstrProfSymtab *Symtab;
 
+  // The vtables of the module, if virtual calls are promoted by comparing
+  // vtable pointers.
+  const VTableSlotIndex *VTables;
+
   bool SamplePGO;
 
   OptimizationRemarkEmitter &ORE;
@@ -205,8 +308,10 @@ private:
 
 public:
   ICallPromotionFunc(Function &Func, Module *Modu, InstrProfSymtab *Symtab,
-                     bool SamplePGO, OptimizationRemarkEmitter &ORE)
-      : F(Func), M(Modu), Symtab(Symtab), SamplePGO(SamplePGO), ORE(ORE) {}
+                     const VTableSlotIndex *VTables, bool SamplePGO,
+                     OptimizationRemarkEmitter &ORE)
+      : F(Func), M(Modu), Symtab(Symtab), VTables(VTables),
+        SamplePGO(SamplePGO), ORE(ORE) {}
   ICallPromotionFunc(const ICallPromotionFunc &) = delete;
   ICallPromotionFunc &operator=(const ICallPromotionFunc &) = delete;
 
@@ -298,7 +403,9 @@ Instruction *llvm::pgo::promoteIndirectCall(Instruction *Inst,
                                             Function *DirectCallee,
                                             uint64_t Count, uint64_t TotalCount,
                                             bool AttachProfToDirectCall,
-                                            OptimizationRemarkEmitter *ORE) {
+                                            OptimizationRemarkEmitter *ORE,
+                                            Value *VTable,
+                                            ArrayRef<Constant *> AddressPoints) {
 
   uint64_t ElseCount = TotalCount - Count;
   uint64_t MaxCount = (Count >= ElseCount ? Count : ElseCount);
@@ -308,7 +415,10 @@ Instruction *llvm::pgo::promoteIndirectCall(Instruction *Inst,
       scaleBranchCount(Count, Scale), scaleBranchCount(ElseCount, Scale));
 
   Instruction *NewInst =
-      promoteCallWithIfThenElse(CallSite(Inst), DirectCallee, BranchWeights);
+      VTable ? promoteCallWithVTableCmp(CallSite(Inst), DirectCallee, VTable,
+                                        AddressPoints, BranchWeights)
+             : promoteCallWithIfThenElse(CallSite(Inst), DirectCallee,
+                                         BranchWeights);
 
   if (AttachProfToDirectCall) {
     SmallVector<uint32_t, 1> Weights;
@@ -324,7 +434,8 @@ Instruction *llvm::pgo::promoteIndirectCall(Instruction *Inst,
       return OptimizationRemark(DEBUG_TYPE, "Promoted", Inst)
              << "Promote indirect call to " << NV("DirectCallee", DirectCallee)
              << " with count " << NV("Count", Count) << " out of "
-             << NV("TotalCount", TotalCount);
+             << NV("TotalCount", TotalCount)
+             << (VTable ? " by comparing vtables" : "");
     });
   return NewInst;
 }
@@ -334,11 +445,22 @@ uint32_t ICallPromotionFunc::tryToPromote(
     Instruction *Inst, const std::vector<PromotionCandidate> &Candidates,
     uint64_t &TotalCount) {
   uint32_t NumPromoted = 0;
+  uint64_t SlotOffset = 0;
+  Value *VTable = VTables ? getVTablePointer(CallSite(Inst),
+                                             M->getDataLayout(), SlotOffset)
+                          : nullptr;
 
   for (auto &C : Candidates) {
     uint64_t Count = C.Count;
+    ArrayRef<Constant *> AddressPoints;
+    if (VTable)
+      AddressPoints = VTables->lookup(C.TargetFunction, SlotOffset);
+    if (AddressPoints.size() > ICPMaxNumVTableCmps)
+      AddressPoints = None;
     pgo::promoteIndirectCall(Inst, C.TargetFunction, Count, TotalCount,
-                             SamplePGO, &ORE);
+                             SamplePGO, &ORE,
+                             AddressPoints.empty() ? nullptr : VTable,
+                             AddressPoints);
     assert(TotalCount >= Count);
     TotalCount -= Count;
     NumOfPGOICallPromotion++;
@@ -392,6 +514,9 @@ static bool promoteIndirectCalls(Module &M, ProfileSummaryInfo *PSI,
     (void)SymtabFailure;
     return false;
   }
+  std::unique_ptr<VTableSlotIndex> VTables;
+  if (ICPCompareVTables)
+    VTables = llvm::make_unique<VTableSlotIndex>(M);
   bool Changed = false;
   for (auto &F : M) {
     if (F.isDeclaration())
@@ -410,7 +535,8 @@ static bool promoteIndirectCalls(Module &M, ProfileSummaryInfo *PSI,
       ORE = OwnedORE.get();
     }
 
-    ICallPromotionFunc ICallPromotion(F, &M, &Symtab, SamplePGO, *ORE);
+    ICallPromotionFunc ICallPromotion(F, &M, &Symtab, VTables.get(), SamplePGO,
+                                      *ORE);
     bool FuncChanged = ICallPromotion.processFunction(PSI);
     if (ICPDUMPAFTER && FuncChanged) {
       LLVM_DEBUG(dbgs() << "\n== IR Dump After =="; F.print(dbgs()));
@@ -42,6 +42,7 @@
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Error.h"
 #include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/MathExtras.h"
 #include "llvm/Transforms/Utils/BasicBlockUtils.h"
 #include "llvm/Transforms/Utils/ModuleUtils.h"
 #include "llvm/Transforms/Utils/SSAUpdater.h"
@@ -101,6 +102,16 @@ cl::opt<bool> AtomicCounterUpdateAll(
     cl::desc("Make all profile counter updates atomic (for testing only)"),
     cl::init(false));
 
+// Counters of different functions that share a cache line are a source of
+// false sharing when the functions run on different threads. Aligning every
+// counter array to the cache line size keeps the arrays of different
+// functions apart, at the cost of padding in the counter section.
+cl::opt<unsigned> CounterAlignment(
+    "instrprof-counter-alignment", cl::ZeroOrMore, cl::Hidden,
+    cl::desc("Align the profile counters of each function to this many "
+             "bytes, e.g. the cache line size (default: 8)"),
+    cl::init(8));
+
 cl::opt<bool> AtomicCounterUpdatePromoted(
     "atomic-counter-update-promoted", cl::ZeroOrMore,
     cl::desc("Do counter update using atomic fetch add "
@@ -740,7 +751,8 @@ InstrProfiling::getOrCreateRegionCounters(InstrProfIncrementInst *Inc) {
   CounterPtr->setVisibility(NamePtr->getVisibility());
   CounterPtr->setSection(
       getInstrProfSectionName(IPSK_cnts, TT.getObjectFormat()));
-  CounterPtr->setAlignment(8);
+  CounterPtr->setAlignment(
+      std::max<uint64_t>(8, PowerOf2Ceil(CounterAlignment)));
   CounterPtr->setComdat(ProfileVarsComdat);
 
   auto *Int8PtrTy = Type::getInt8PtrTy(Ctx);
@@ -12,6 +12,7 @@
 // value profile metadata is available, a single memory intrinsic is expanded
 // to a sequence of guarded specialized versions that are called with the
 // hottest size(s), for later expansion into more optimal inline sequences.
+// Sizes above the largest one the target expands inline are not versioned.
 //
 //===----------------------------------------------------------------------===//
 
@@ -22,6 +23,7 @@
 #include "llvm/Analysis/BlockFrequencyInfo.h"
 #include "llvm/Analysis/GlobalsModRef.h"
 #include "llvm/Analysis/OptimizationRemarkEmitter.h"
+#include "llvm/Analysis/TargetTransformInfo.h"
 #include "llvm/IR/BasicBlock.h"
 #include "llvm/IR/CallSite.h"
 #include "llvm/IR/DerivedTypes.h"
@@ -91,6 +93,11 @@ static cl::opt<bool>
                     cl::desc("Scale the memop size counts using the basic "
                              " block count value"));
 
+// Only version memory intrinsic calls for sizes the target expands inline.
+static cl::opt<bool> MemOPUseTargetInlineLimit(
+    "pgo-memop-use-target-inline-limit", cl::init(true), cl::Hidden,
+    cl::desc("Skip memop sizes that the target would not expand inline"));
+
 // This option sets the rangge of precise profile memop sizes.
 extern cl::opt<std::string> MemOPSizeRange;
 
@@ -113,6 +120,7 @@ private:
   void getAnalysisUsage(AnalysisUsage &AU) const override {
     AU.addRequired<BlockFrequencyInfoWrapperPass>();
     AU.addRequired<OptimizationRemarkEmitterWrapperPass>();
+    AU.addRequired<TargetTransformInfoWrapperPass>();
     AU.addPreserved<GlobalsAAWrapperPass>();
     AU.addPreserved<DominatorTreeWrapperPass>();
   }
@@ -124,6 +132,7 @@ INITIALIZE_PASS_BEGIN(PGOMemOPSizeOptLegacyPass, "pgo-memop-opt",
                       "Optimize memory intrinsic using its size value profile",
                       false, false)
 INITIALIZE_PASS_DEPENDENCY(BlockFrequencyInfoWrapperPass)
+INITIALIZE_PASS_DEPENDENCY(TargetTransformInfoWrapperPass)
 INITIALIZE_PASS_END(PGOMemOPSizeOptLegacyPass, "pgo-memop-opt",
                     "Optimize memory intrinsic using its size value profile",
                     false, false)
@@ -136,8 +145,9 @@ namespace {
 class MemOPSizeOpt : public InstVisitor<MemOPSizeOpt> {
 public:
   MemOPSizeOpt(Function &Func, BlockFrequencyInfo &BFI,
-               OptimizationRemarkEmitter &ORE, DominatorTree *DT)
-      : Func(Func), BFI(BFI), ORE(ORE), DT(DT), Changed(false) {
+               OptimizationRemarkEmitter &ORE, DominatorTree *DT,
+               const TargetTransformInfo &TTI)
+      : Func(Func), BFI(BFI), ORE(ORE), DT(DT), TTI(TTI), Changed(false) {
     ValueDataArray =
         llvm::make_unique<InstrProfValueData[]>(MemOPMaxVersion + 2);
     // Get the MemOPSize range information from option MemOPSizeRange,
@@ -174,6 +184,7 @@ private:
   BlockFrequencyInfo &BFI;
   OptimizationRemarkEmitter &ORE;
   DominatorTree *DT;
+  const TargetTransformInfo &TTI;
   bool Changed;
   std::vector<MemIntrinsic *> WorkList;
   // Start of the previse range.
@@ -184,6 +195,16 @@ private:
   std::unique_ptr<InstrProfValueData[]> ValueDataArray;
   bool perform(MemIntrinsic *MI);
 
+  // Versioning a call for a size only pays off if the versioned call is
+  // expanded inline, so skip sizes above the target's expansion limit.
+  bool isInlinableSize(const MemIntrinsic *MI, int64_t Size) const {
+    if (!MemOPUseTargetInlineLimit)
+      return true;
+    unsigned Limit =
+        TTI.getMaxInlineSizeForMemIntrinsic(isa<MemSetInst>(MI));
+    return Limit == 0 || uint64_t(Size) <= Limit;
+  }
+
   // This kind shows which group the value falls in. For PreciseValue, we have
   // the profile count for that value. LargeGroup groups the values that are in
   // range [LargeValue, +inf). NonLargeGroup groups the rest of values.
@@ -273,24 +294,31 @@ bool MemOPSizeOpt::perform(MemIntrinsic *MI) {
   uint64_t SavedRemainCount = SavedTotalCount;
   SmallVector<uint64_t, 16> SizeIds;
   SmallVector<uint64_t, 16> CaseCounts;
+  // The values that are not versioned, to be annotated back on the call.
+  SmallVector<InstrProfValueData, 16> RemainVDs;
   uint64_t MaxCount = 0;
   unsigned Version = 0;
   // Default case is in the front -- save the slot here.
   CaseCounts.push_back(0);
-  for (auto &VD : VDs) {
+  for (unsigned I = 0, E = VDs.size(); I != E; ++I) {
+    const InstrProfValueData &VD = VDs[I];
     int64_t V = VD.Value;
     uint64_t C = VD.Count;
     if (MemOPScaleCount)
       C = getScaledCount(C, ActualCount, SavedTotalCount);
 
     // Only care precise value here.
-    if (getMemOPSizeKind(V) != PreciseValue)
+    if (getMemOPSizeKind(V) != PreciseValue || !isInlinableSize(MI, V)) {
+      RemainVDs.push_back(VD);
       continue;
+    }
 
     // ValueCounts are sorted on the count. Break at the first un-profitable
     // value.
-    if (!isProfitable(C, RemainCount))
+    if (!isProfitable(C, RemainCount)) {
+      RemainVDs.append(VDs.begin() + I, VDs.end());
       break;
+    }
 
     SizeIds.push_back(V);
     CaseCounts.push_back(C);
@@ -302,8 +330,10 @@ bool MemOPSizeOpt::perform(MemIntrinsic *MI) {
     assert(SavedRemainCount >= VD.Count);
     SavedRemainCount -= VD.Count;
 
-    if (++Version > MemOPMaxVersion && MemOPMaxVersion != 0)
+    if (++Version > MemOPMaxVersion && MemOPMaxVersion != 0) {
+      RemainVDs.append(VDs.begin() + I + 1, VDs.end());
       break;
+    }
   }
 
   if (Version == 0)
@@ -361,8 +391,8 @@ bool MemOPSizeOpt::perform(MemIntrinsic *MI) {
   // If all promoted, we don't need the MD.prof metadata.
   if (SavedRemainCount > 0 || Version != NumVals)
     // Otherwise we need update with the un-promoted records back.
-    annotateValueSite(*Func.getParent(), *MI, VDs.slice(Version),
-                      SavedRemainCount, IPVK_MemOPSize, NumVals);
+    annotateValueSite(*Func.getParent(), *MI, RemainVDs, SavedRemainCount,
+                      IPVK_MemOPSize, NumVals);
 
   LLVM_DEBUG(dbgs() << "\n\n== Basic Block After==\n");
 
@@ -414,13 +444,14 @@ bool MemOPSizeOpt::perform(MemIntrinsic *MI) {
 
 static bool PGOMemOPSizeOptImpl(Function &F, BlockFrequencyInfo &BFI,
                                 OptimizationRemarkEmitter &ORE,
-                                DominatorTree *DT) {
+                                DominatorTree *DT,
+                                const TargetTransformInfo &TTI) {
   if (DisableMemOPOPT)
     return false;
 
   if (F.hasFnAttribute(Attribute::OptimizeForSize))
     return false;
-  MemOPSizeOpt MemOPSizeOpt(F, BFI, ORE, DT);
+  MemOPSizeOpt MemOPSizeOpt(F, BFI, ORE, DT, TTI);
   MemOPSizeOpt.perform();
   return MemOPSizeOpt.isChanged();
 }
@@ -431,7 +462,8 @@ bool PGOMemOPSizeOptLegacyPass::runOnFunction(Function &F) {
   auto &ORE = getAnalysis<OptimizationRemarkEmitterWrapperPass>().getORE();
   auto *DTWP = getAnalysisIfAvailable<DominatorTreeWrapperPass>();
   DominatorTree *DT = DTWP ? &DTWP->getDomTree() : nullptr;
-  return PGOMemOPSizeOptImpl(F, BFI, ORE, DT);
+  auto &TTI = getAnalysis<TargetTransformInfoWrapperPass>().getTTI(F);
+  return PGOMemOPSizeOptImpl(F, BFI, ORE, DT, TTI);
 }
 
 namespace llvm {
@@ -442,7 +474,8 @@ PreservedAnalyses PGOMemOPSizeOpt::run(Function &F,
   auto &BFI = FAM.getResult<BlockFrequencyAnalysis>(F);
   auto &ORE = FAM.getResult<OptimizationRemarkEmitterAnalysis>(F);
   auto *DT = FAM.getCachedResult<DominatorTreeAnalysis>(F);
-  bool Changed = PGOMemOPSizeOptImpl(F, BFI, ORE, DT);
+  auto &TTI = FAM.getResult<TargetIRAnalysis>(F);
+  bool Changed = PGOMemOPSizeOptImpl(F, BFI, ORE, DT, TTI);
   if (!Changed)
     return PreservedAnalyses::all();
   auto PA = PreservedAnalyses();
@@ -11,7 +11,9 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include "CFGMST.h"
 #include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/Analysis/EHPersonalities.h"
 #include "llvm/Analysis/PostDominators.h"
@@ -38,6 +40,7 @@
 #include "llvm/Transforms/Instrumentation.h"
 #include "llvm/Transforms/Utils/BasicBlockUtils.h"
 #include "llvm/Transforms/Utils/ModuleUtils.h"
+#include <map>
 
 using namespace llvm;
 
@@ -72,10 +75,14 @@ static const char *const SanCovTracePCGuardInitName =
 static const char *const SanCov8bitCountersInitName =
     "__sanitizer_cov_8bit_counters_init";
 static const char *const SanCovPCsInitName = "__sanitizer_cov_pcs_init";
+static const char *const SanCovDerivedCountersInitName =
+    "__sanitizer_cov_8bit_counters_derived_init";
 
 static const char *const SanCovGuardsSectionName = "sancov_guards";
 static const char *const SanCovCountersSectionName = "sancov_cntrs";
 static const char *const SanCovPCsSectionName = "sancov_pcs";
+static const char *const SanCovDerivedCountersSectionName =
+    "sancov_cntrs_derived";
 
 static const char *const SanCovLowestStackName = "__sancov_lowest_stack";
 
@@ -129,6 +136,23 @@ static cl::opt<bool> ClStackDepth("sanitizer-coverage-stack-depth",
                                   cl::desc("max stack depth tracing"),
                                   cl::Hidden, cl::init(false));
 
+// If true, with inline-8bit-counters and edge coverage, only the blocks that
+// count the edges off a spanning tree of the CFG increment their counters.
+// The counters of the other blocks are described by a table of records in
+// the sancov_cntrs_derived section, whose bounds are passed to
+// __sanitizer_cov_8bit_counters_derived_init. Each record is a sequence of
+// pointer-sized words:
+//   { Counter, N, Counter_1, Coefficient_1, ..., Counter_N, Coefficient_N }
+// and the runtime must set *Counter to the sum of Coefficient_i * *Counter_i,
+// modulo 256, before it reads the counters. Like the counts of a PGO
+// profile, the derived counters can be off in functions that a call leaves
+// without returning.
+static cl::opt<bool> ClSpanningTree(
+    "sanitizer-coverage-spanning-tree",
+    cl::desc("increment the 8-bit counters of the edges off a spanning tree "
+             "only, and emit a table to derive the others"),
+    cl::Hidden, cl::init(false));
+
 namespace {
 
 SanitizerCoverageOptions getOptions(int LegacyCoverageLevel) {
@@ -168,12 +192,17 @@ SanitizerCoverageOptions OverrideFromCL(SanitizerCoverageOptions Options) {
   Options.PCTable |= ClCreatePCTable;
   Options.NoPrune |= !ClPruneBlocks;
   Options.StackDepth |= ClStackDepth;
+  Options.SpanningTree |= ClSpanningTree;
   if (!Options.TracePCGuard && !Options.TracePC &&
       !Options.Inline8bitCounters && !Options.StackDepth)
     Options.TracePCGuard = true; // TracePCGuard is default.
   return Options;
 }
 
+// A count as a sum of 8-bit counters times their coefficients, by the index
+// of the counter in the function.
+using CounterSum = std::map<size_t, int>;
+
 class SanitizerCoverageModule : public ModulePass {
 public:
   SanitizerCoverageModule(
@@ -203,11 +232,15 @@ private:
                             ArrayRef<Instruction *> SwitchTraceTargets);
   bool InjectCoverage(Function &F, ArrayRef<BasicBlock *> AllBlocks,
                       bool IsLeafFunc = true);
+  bool InjectSpanningTreeCoverage(Function &F,
+                                  ArrayRef<BasicBlock *> PrunedBlocks);
   GlobalVariable *CreateFunctionLocalArrayInSection(size_t NumElements,
                                                     Function &F, Type *Ty,
                                                     const char *Section);
   GlobalVariable *CreatePCArray(Function &F, ArrayRef<BasicBlock *> AllBlocks);
   void CreateFunctionLocalArrays(Function &F, ArrayRef<BasicBlock *> AllBlocks);
+  void CreateDerivedCountersArray(
+      Function &F, ArrayRef<std::pair<size_t, CounterSum>> Derived);
   void InjectCoverageAtBlock(Function &F, BasicBlock &BB, size_t Idx,
                              bool IsLeafFunc = true);
   Function *CreateInitCallsForSections(Module &M, const char *InitFunctionName,
@@ -243,6 +276,7 @@ private:
   GlobalVariable *FunctionGuardArray;  // for trace-pc-guard.
   GlobalVariable *Function8bitCounterArray;  // for inline-8bit-counters.
   GlobalVariable *FunctionPCsArray;  // for pc-table.
+  bool HasDerivedCounters;  // for spanning-tree.
   SmallVector<GlobalValue *, 20> GlobalsToAppendToUsed;
   SmallVector<GlobalValue *, 20> GlobalsToAppendToCompilerUsed;
 
@@ -326,6 +360,7 @@ bool SanitizerCoverageModule::runOnModule(Module &M) {
   FunctionGuardArray = nullptr;
   Function8bitCounterArray = nullptr;
   FunctionPCsArray = nullptr;
+  HasDerivedCounters = false;
   IntptrTy = Type::getIntNTy(*C, DL->getPointerSizeInBits());
   IntptrPtrTy = PointerType::getUnqual(IntptrTy);
   Type *VoidTy = Type::getVoidTy(*C);
@@ -428,6 +463,14 @@ bool SanitizerCoverageModule::runOnModule(Module &M) {
     IRBuilder<> IRBCtor(Ctor->getEntryBlock().getTerminator());
     IRBCtor.CreateCall(InitFunction, {SecStartEnd.first, SecStartEnd.second});
   }
+  if (Ctor && HasDerivedCounters) {
+    auto SecStartEnd =
+        CreateSecStartEnd(M, SanCovDerivedCountersSectionName, IntptrPtrTy);
+    Function *InitFunction = declareSanitizerInitFunction(
+        M, SanCovDerivedCountersInitName, {IntptrPtrTy, IntptrPtrTy});
+    IRBuilder<> IRBCtor(Ctor->getEntryBlock().getTerminator());
+    IRBCtor.CreateCall(InitFunction, {SecStartEnd.first, SecStartEnd.second});
+  }
   // We don't reference these arrays directly in any of our runtime functions,
   // so we need to prevent them from being dead stripped.
   if (TargetTriple.isOSBinFormatMachO())
@@ -561,7 +604,14 @@ bool SanitizerCoverageModule::runOnFunction(Function &F) {
     }
   }
 
-  InjectCoverage(F, BlocksToInstrument, IsLeafFunc);
+  // The counters of the blocks can only be derived from those of others if
+  // nothing else is done in every block.
+  bool UseSpanningTree =
+      Options.SpanningTree && Options.Inline8bitCounters &&
+      Options.CoverageType >= SanitizerCoverageOptions::SCK_Edge &&
+      !Options.TracePC && !Options.TracePCGuard && !Options.StackDepth;
+  if (!UseSpanningTree || !InjectSpanningTreeCoverage(F, BlocksToInstrument))
+    InjectCoverage(F, BlocksToInstrument, IsLeafFunc);
   InjectCoverageForIndirectCalls(F, IndirCalls);
   InjectTraceForCmp(F, CmpTraceTargets);
   InjectTraceForSwitch(F, SwitchTraceTargets);
@@ -644,6 +694,210 @@ bool SanitizerCoverageModule::InjectCoverage(Function &F,
   return true;
 }
 
+namespace {
+// An edge of the CFG, or a fake edge into the entry block or out of a block
+// without successors, as used by CFGMST.
+struct SanCovTreeEdge {
+  const BasicBlock *SrcBB;
+  const BasicBlock *DestBB;
+  uint64_t Weight;
+  bool InMST = false;
+  bool Removed = false;
+  bool IsCritical = false;
+
+  SanCovTreeEdge(const BasicBlock *Src, const BasicBlock *Dest, uint64_t W = 1)
+      : SrcBB(Src), DestBB(Dest), Weight(W) {}
+};
+
+struct SanCovTreeBBInfo {
+  SanCovTreeBBInfo *Group;
+  uint32_t Index;
+  uint32_t Rank = 0;
+
+  SanCovTreeBBInfo(unsigned IX) : Group(this), Index(IX) {}
+};
+} // namespace
+
+// Returns the block that runs exactly as often as E is taken, or null if
+// there is none that can be instrumented.
+static BasicBlock *getCountingBlock(const SanCovTreeEdge &E) {
+  const BasicBlock *BB;
+  if (!E.SrcBB)
+    BB = E.DestBB;
+  else if (!E.DestBB || E.SrcBB->getTerminator()->getNumSuccessors() == 1)
+    BB = E.SrcBB;
+  else if (E.DestBB->getSinglePredecessor())
+    BB = E.DestBB;
+  else
+    return nullptr;
+  if (isa<UnreachableInst>(BB->getTerminator()) ||
+      BB->getFirstInsertionPt() == BB->end())
+    return nullptr;
+  return const_cast<BasicBlock *>(BB);
+}
+
+// Instruments the blocks that count the edges off a spanning tree of the CFG,
+// and derives the counters of the other blocks that PrunedBlocks keeps from
+// them. Every block count is the sum of the counts of its incoming edges, and
+// those of the tree edges follow from flow conservation. Returns false,
+// without changing F, if an edge that no block counts can not be put on the
+// tree.
+bool SanitizerCoverageModule::InjectSpanningTreeCoverage(
+    Function &F, ArrayRef<BasicBlock *> PrunedBlocks) {
+  CFGMST<SanCovTreeEdge, SanCovTreeBBInfo> MST(F);
+
+  // Give the edges that no block counts the largest weight, so that they go
+  // on the tree first.
+  bool Reweighted = false;
+  for (auto &E : MST.AllEdges)
+    if (!getCountingBlock(*E)) {
+      E->Weight = UINT64_MAX;
+      Reweighted = true;
+    }
+  if (Reweighted) {
+    for (auto &I : MST.BBInfos) {
+      I.second->Group = I.second.get();
+      I.second->Rank = 0;
+    }
+    for (auto &E : MST.AllEdges)
+      E->InMST = false;
+    MST.sortEdgesByWeight();
+    MST.computeMinimumSpanningTree();
+  }
+
+  SmallPtrSet<BasicBlock *, 16> CountingBlocks;
+  for (auto &E : MST.AllEdges) {
+    if (E->InMST)
+      continue;
+    BasicBlock *BB = getCountingBlock(*E);
+    if (!BB)
+      return false;
+    CountingBlocks.insert(BB);
+  }
+
+  // The counting blocks get counters even if pruning would skip them.
+  SmallPtrSet<BasicBlock *, 16> Pruned(PrunedBlocks.begin(),
+                                       PrunedBlocks.end());
+  SmallVector<BasicBlock *, 16> AllBlocks;
+  DenseMap<const BasicBlock *, size_t> CounterIdx;
+  for (BasicBlock &BB : F)
+    if (CountingBlocks.count(&BB) || Pruned.count(&BB)) {
+      CounterIdx[&BB] = AllBlocks.size();
+      AllBlocks.push_back(&BB);
+    }
+
+  DenseMap<const SanCovTreeEdge *, CounterSum> EdgeSums;
+  for (auto &E : MST.AllEdges)
+    if (!E->InMST)
+      EdgeSums[E.get()][CounterIdx[getCountingBlock(*E)]] = 1;
+
+  // A tree edge is known once it is the only unknown edge of one of its
+  // blocks. Peel the tree from its leaves.
+  DenseMap<const BasicBlock *, SmallVector<SanCovTreeEdge *, 4>> EdgesByBB;
+  DenseMap<const BasicBlock *, unsigned> NumUnknown;
+  for (auto &E : MST.AllEdges) {
+    // Self loops leave the flow through their block unchanged.
+    if (E->SrcBB == E->DestBB)
+      continue;
+    EdgesByBB[E->SrcBB].push_back(E.get());
+    EdgesByBB[E->DestBB].push_back(E.get());
+    if (E->InMST) {
+      ++NumUnknown[E->SrcBB];
+      ++NumUnknown[E->DestBB];
+    }
+  }
+  SmallVector<const BasicBlock *, 16> Worklist;
+  for (const auto &I : NumUnknown)
+    if (I.second == 1)
+      Worklist.push_back(I.first);
+  while (!Worklist.empty()) {
+    const BasicBlock *BB = Worklist.pop_back_val();
+    if (NumUnknown[BB] != 1)
+      continue;
+    auto &Edges = EdgesByBB[BB];
+    auto It = llvm::find_if(Edges, [&](SanCovTreeEdge *E) {
+      return E->InMST && !EdgeSums.count(E);
+    });
+    assert(It != Edges.end() && "No unknown edge left");
+    SanCovTreeEdge *Unknown = *It;
+    bool UnknownIsIncoming = Unknown->DestBB == BB;
+
+    CounterSum Sum;
+    for (SanCovTreeEdge *E : Edges) {
+      if (E == Unknown)
+        continue;
+      int Sign = (E->DestBB == BB) == UnknownIsIncoming ? -1 : 1;
+      for (const auto &Term : EdgeSums.find(E)->second)
+        Sum[Term.first] += Sign * Term.second;
+    }
+    EdgeSums[Unknown] = std::move(Sum);
+
+    --NumUnknown[Unknown->SrcBB];
+    --NumUnknown[Unknown->DestBB];
+    const BasicBlock *Other =
+        UnknownIsIncoming ? Unknown->SrcBB : Unknown->DestBB;
+    if (NumUnknown[Other] == 1)
+      Worklist.push_back(Other);
+  }
+
+  DenseMap<const BasicBlock *, CounterSum> BlockSums;
+  for (auto &E : MST.AllEdges) {
+    if (!E->DestBB)
+      continue;
+    auto It = EdgeSums.find(E.get());
+    if (It == EdgeSums.end())
+      return false;
+    CounterSum &Sum = BlockSums[E->DestBB];
+    for (const auto &Term : It->second)
+      if (!(Sum[Term.first] += Term.second))
+        Sum.erase(Term.first);
+  }
+
+  CreateFunctionLocalArrays(F, AllBlocks);
+  std::vector<std::pair<size_t, CounterSum>> Derived;
+  for (size_t i = 0, N = AllBlocks.size(); i < N; i++) {
+    if (CountingBlocks.count(AllBlocks[i]))
+      InjectCoverageAtBlock(F, *AllBlocks[i], i);
+    else
+      Derived.push_back({i, BlockSums[AllBlocks[i]]});
+  }
+  if (!Derived.empty())
+    CreateDerivedCountersArray(F, Derived);
+  return true;
+}
+
+void SanitizerCoverageModule::CreateDerivedCountersArray(
+    Function &F, ArrayRef<std::pair<size_t, CounterSum>> Derived) {
+  auto CounterPtr = [&](size_t Idx) {
+    Constant *Indices[] = {ConstantInt::get(IntptrTy, 0),
+                           ConstantInt::get(IntptrTy, Idx)};
+    return ConstantExpr::getPointerCast(
+        ConstantExpr::getInBoundsGetElementPtr(
+            Function8bitCounterArray->getValueType(), Function8bitCounterArray,
+            Indices),
+        IntptrPtrTy);
+  };
+  auto Word = [&](int64_t Value) {
+    return ConstantExpr::getIntToPtr(
+        ConstantInt::get(IntptrTy, Value, /*isSigned=*/true), IntptrPtrTy);
+  };
+  SmallVector<Constant *, 32> Words;
+  for (const auto &D : Derived) {
+    Words.push_back(CounterPtr(D.first));
+    Words.push_back(Word(D.second.size()));
+    for (const auto &Term : D.second) {
+      Words.push_back(CounterPtr(Term.first));
+      Words.push_back(Word(Term.second));
+    }
+  }
+  auto *Array = CreateFunctionLocalArrayInSection(
+      Words.size(), F, IntptrPtrTy, SanCovDerivedCountersSectionName);
+  Array->setInitializer(
+      ConstantArray::get(ArrayType::get(IntptrPtrTy, Words.size()), Words));
+  Array->setConstant(true);
+  HasDerivedCounters = true;
+}
+
 // On every indirect call we call a run-time function
 // __sanitizer_cov_indir_call* with two parameters:
 //   - callee address,
@@ -838,6 +1092,8 @@ SanitizerCoverageModule::getSectionName(const std::string &Section) const {
       return ".SCOV$CM";
     if (Section == SanCovPCsSectionName)
       return ".SCOVP$M";
+    if (Section == SanCovDerivedCountersSectionName)
+      return ".SCOVD$M";
     return ".SCOV$GM"; // For SanCovGuardsSectionName.
   }
   if (TargetTriple.isOSBinFormatMachO())
@@ -36,12 +36,14 @@
 #include "llvm/Transforms/Scalar/ConstantHoisting.h"
 #include "llvm/ADT/APInt.h"
 #include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/MapVector.h"
 #include "llvm/ADT/None.h"
 #include "llvm/ADT/Optional.h"
 #include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/Statistic.h"
 #include "llvm/Analysis/BlockFrequencyInfo.h"
+#include "llvm/Analysis/OptimizationRemarkEmitter.h"
 #include "llvm/Analysis/TargetTransformInfo.h"
 #include "llvm/Transforms/Utils/Local.h"
 #include "llvm/IR/BasicBlock.h"
@@ -75,6 +77,8 @@ using namespace consthoist;
 
 STATISTIC(NumConstantsHoisted, "Number of constants hoisted");
 STATISTIC(NumConstantsRebased, "Number of constants rebased");
+STATISTIC(NumConstantsRematerialized,
+          "Number of constants rematerialized in their using blocks");
 
 static cl::opt<bool> ConstHoistWithBlockFrequency(
     "consthoist-with-block-frequency", cl::init(true), cl::Hidden,
@@ -86,6 +90,12 @@ static cl::opt<bool> ConstHoistGEP(
     "consthoist-gep", cl::init(false), cl::Hidden,
     cl::desc("Try hoisting constant gep expressions"));
 
+static cl::opt<bool> ConstHoistRemat(
+    "consthoist-remat", cl::init(false), cl::Hidden,
+    cl::desc("Materialize a constant again in each block that uses it instead "
+             "of hoisting it when the estimated register pressure would make "
+             "the hoisted value spill."));
+
 static cl::opt<unsigned>
 MinNumOfDependentToRebase("consthoist-min-num-to-rebase",
     cl::desc("Do not rebase if number of dependent constants of a Base is less "
@@ -111,6 +121,8 @@ public:
     AU.setPreservesCFG();
     if (ConstHoistWithBlockFrequency)
       AU.addRequired<BlockFrequencyInfoWrapperPass>();
+    if (ConstHoistRemat)
+      AU.addRequired<OptimizationRemarkEmitterWrapperPass>();
     AU.addRequired<DominatorTreeWrapperPass>();
     AU.addRequired<TargetTransformInfoWrapperPass>();
   }
@@ -129,6 +141,7 @@ INITIALIZE_PASS_BEGIN(ConstantHoistingLegacyPass, "consthoist",
                       "Constant Hoisting", false, false)
 INITIALIZE_PASS_DEPENDENCY(BlockFrequencyInfoWrapperPass)
 INITIALIZE_PASS_DEPENDENCY(DominatorTreeWrapperPass)
+INITIALIZE_PASS_DEPENDENCY(OptimizationRemarkEmitterWrapperPass)
 INITIALIZE_PASS_DEPENDENCY(TargetTransformInfoWrapperPass)
 INITIALIZE_PASS_END(ConstantHoistingLegacyPass, "consthoist",
                     "Constant Hoisting", false, false)
@@ -151,7 +164,11 @@ bool ConstantHoistingLegacyPass::runOnFunction(Function &Fn) {
                    ConstHoistWithBlockFrequency
                        ? &getAnalysis<BlockFrequencyInfoWrapperPass>().getBFI()
                        : nullptr,
-                   Fn.getEntryBlock());
+                   Fn.getEntryBlock(),
+                   ConstHoistRemat
+                       ? &getAnalysis<OptimizationRemarkEmitterWrapperPass>()
+                              .getORE()
+                       : nullptr);
 
   if (MadeChange) {
     LLVM_DEBUG(dbgs() << "********** Function after Constant Hoisting: "
@@ -816,6 +833,163 @@ void ConstantHoistingPass::emitBaseConstants(Instruction *Base,
   }
 }
 
+/// Estimate the register pressure of \p BB as the largest number of values
+/// live at once in it, counting the values it uses from other blocks as live
+/// from its start.
+unsigned ConstantHoistingPass::estimateRegisterPressure(BasicBlock *BB) {
+  auto It = BlockPressure.find(BB);
+  if (It != BlockPressure.end())
+    return It->second;
+
+  SmallPtrSet<Value *, 32> Live;
+  for (Instruction &I : *BB)
+    for (User *U : I.users())
+      if (cast<Instruction>(U)->getParent() != BB || isa<PHINode>(U)) {
+        Live.insert(&I);
+        break;
+      }
+
+  unsigned MaxLive = Live.size();
+  for (Instruction &I : reverse(*BB)) {
+    Live.erase(&I);
+    if (isa<PHINode>(I))
+      continue;
+    for (Value *Op : I.operands())
+      if ((isa<Instruction>(Op) || isa<Argument>(Op)) &&
+          !Op->getType()->isVoidTy())
+        Live.insert(Op);
+    MaxLive = std::max<unsigned>(MaxLive, Live.size());
+  }
+  return BlockPressure[BB] = MaxLive;
+}
+
+/// Decide whether the base of \p ConstInfo, which would be hoisted to \p IP
+/// for \p Uses, should rather be materialized in each block that uses it.
+///
+/// Hoisting keeps the base live from \p IP to its uses. If a block that the
+/// base is live through has no free register left, the base is spilled and
+/// reloaded in each of its using blocks, which is no cheaper than
+/// materializing it there again. Rematerialization is chosen if its cost, the
+/// frequency of the using blocks, does not exceed that of hoisting and
+/// spilling.
+bool ConstantHoistingPass::shouldRematerialize(
+    const ConstantInfo &ConstInfo, Instruction *IP,
+    ArrayRef<RebasedUse> Uses) {
+  auto getFreq = [&](BasicBlock *BB) -> uint64_t {
+    return BFI ? BFI->getBlockFreq(BB).getFrequency() : 1;
+  };
+
+  BasicBlock *IPBB = IP->getParent();
+  SmallPtrSet<BasicBlock *, 8> UseBBs;
+  for (auto const &R : Uses) {
+    const ConstantUser &U = std::get<2>(R);
+    BasicBlock *BB = findMatInsertPt(U.Inst, U.OpndIdx)->getParent();
+    if (BB != IPBB && BB->isEHPad())
+      return false;
+    UseBBs.insert(BB);
+  }
+  if (UseBBs.size() == 1 && UseBBs.count(IPBB))
+    return false;
+
+  // The base is live through the blocks on the dominator tree paths from IP
+  // to its uses. Find the one with the highest pressure.
+  unsigned NumRegs = TTI->getNumberOfRegisters(false);
+  BasicBlock *MaxBB = IPBB;
+  unsigned MaxPressure = estimateRegisterPressure(IPBB);
+  SmallPtrSet<BasicBlock *, 16> Visited;
+  for (BasicBlock *BB : UseBBs) {
+    for (DomTreeNode *Node = DT->getNode(BB); Node->getBlock() != IPBB;
+         Node = Node->getIDom()) {
+      if (!Visited.insert(Node->getBlock()).second)
+        break;
+      unsigned Pressure = estimateRegisterPressure(Node->getBlock());
+      if (Pressure > MaxPressure) {
+        MaxBB = Node->getBlock();
+        MaxPressure = Pressure;
+      }
+    }
+  }
+
+  uint64_t HoistCost = getFreq(IPBB);
+  uint64_t RematCost = 0;
+  for (BasicBlock *BB : UseBBs)
+    RematCost += getFreq(BB);
+  bool Spills = MaxPressure >= NumRegs;
+  if (Spills) {
+    // A spill after IP and a reload in each using block.
+    HoistCost += getFreq(IPBB);
+    for (BasicBlock *BB : UseBBs)
+      if (BB != IPBB)
+        HoistCost += getFreq(BB);
+  }
+  bool Remat = Spills && RematCost <= HoistCost;
+
+  if (ORE) {
+    Constant *C = ConstInfo.BaseExpr
+                      ? static_cast<Constant *>(ConstInfo.BaseExpr)
+                      : ConstInfo.BaseInt;
+    ORE->emit([&]() {
+      OptimizationRemark R(DEBUG_TYPE,
+                           Remat ? "ConstantRematerialized" : "ConstantHoisted",
+                           IP);
+      R << (Remat ? "rematerialized " : "hoisted ") << ore::NV("Constant", C)
+        << (Remat ? " in each of " : " for ")
+        << ore::NV("NumBlocks", unsigned(UseBBs.size()))
+        << " using blocks: estimated register pressure "
+        << ore::NV("Pressure", MaxPressure) << " in "
+        << ore::NV("Block", MaxBB->getName()) << " of "
+        << ore::NV("NumRegs", NumRegs) << " registers";
+      if (Spills)
+        R << ", rematerialization cost " << ore::NV("RematCost", RematCost)
+          << " vs. hoisting and spilling cost "
+          << ore::NV("HoistCost", HoistCost);
+      return R;
+    });
+  }
+  return Remat;
+}
+
+/// Emit an instance of the base of \p ConstInfo at \p IP, hidden behind a
+/// bitcast, and the materialization code of the rebased constants \p Uses.
+/// Return the number of uses rebased.
+unsigned ConstantHoistingPass::emitBaseConstant(const ConstantInfo &ConstInfo,
+                                                GlobalVariable *BaseGV,
+                                                Instruction *IP,
+                                                ArrayRef<RebasedUse> Uses) {
+  Instruction *Base = nullptr;
+  // Hoist and hide the base constant behind a bitcast.
+  if (ConstInfo.BaseExpr) {
+    assert(BaseGV && "A base constant expression must have an base GV");
+    (void)BaseGV;
+    Type *Ty = ConstInfo.BaseExpr->getType();
+    Base = new BitCastInst(ConstInfo.BaseExpr, Ty, "const", IP);
+  } else {
+    IntegerType *Ty = ConstInfo.BaseInt->getType();
+    Base = new BitCastInst(ConstInfo.BaseInt, Ty, "const", IP);
+  }
+
+  Base->setDebugLoc(IP->getDebugLoc());
+
+  LLVM_DEBUG(dbgs() << "Hoist constant (" << *ConstInfo.BaseInt
+                    << ") to BB " << IP->getParent()->getName() << '\n'
+                    << *Base << '\n');
+
+  // Emit materialization code for rebased constants depending on this IP.
+  for (auto const &R : Uses) {
+    Constant *Off = std::get<0>(R);
+    Type *Ty = std::get<1>(R);
+    ConstantUser U = std::get<2>(R);
+    emitBaseConstants(Base, Off, Ty, U);
+    // Use the same debug location as the last user of the constant.
+    Base->setDebugLoc(DILocation::getMergedLocation(
+        Base->getDebugLoc(), U.Inst->getDebugLoc()));
+  }
+  assert(!Base->use_empty() && "The use list is empty!?");
+  assert(isa<Instruction>(Base->user_back()) &&
+         "All uses should be instructions.");
+  return Uses.size();
+}
+
 /// Hoist and hide the base constant behind a bitcast and emit
 /// materialization code for derived constants.
 bool ConstantHoistingPass::emitBaseConstants(GlobalVariable *BaseGV) {
@@ -832,7 +1006,6 @@ bool ConstantHoistingPass::emitBaseConstants(GlobalVariable *BaseGV) {
     for (Instruction *IP : IPSet) {
       // First, collect constants depending on this IP of the base.
       unsigned Uses = 0;
-      using RebasedUse = std::tuple<Constant *, Type *, ConstantUser>;
       SmallVector<RebasedUse, 4> ToBeRebased;
       for (auto const &RCI : ConstInfo.RebasedConstants) {
         for (auto const &U : RCI.Uses) {
@@ -855,38 +1028,26 @@ bool ConstantHoistingPass::emitBaseConstants(GlobalVariable *BaseGV) {
         continue;
       }
 
-      // Emit an instance of the base at this IP.
-      Instruction *Base = nullptr;
-      // Hoist and hide the base constant behind a bitcast.
-      if (ConstInfo.BaseExpr) {
-        assert(BaseGV && "A base constant expression must have an base GV");
-        Type *Ty = ConstInfo.BaseExpr->getType();
-        Base = new BitCastInst(ConstInfo.BaseExpr, Ty, "const", IP);
-      } else {
-        IntegerType *Ty = ConstInfo.BaseInt->getType();
-        Base = new BitCastInst(ConstInfo.BaseInt, Ty, "const", IP);
+      if (ConstHoistRemat && shouldRematerialize(ConstInfo, IP, ToBeRebased)) {
+        // Emit an instance of the base in each block that uses it.
+        MapVector<BasicBlock *, SmallVector<RebasedUse, 4>> UsesByBlock;
+        for (auto const &R : ToBeRebased) {
+          const ConstantUser &U = std::get<2>(R);
+          UsesByBlock[findMatInsertPt(U.Inst, U.OpndIdx)->getParent()]
+              .push_back(R);
+        }
+        for (auto &Entry : UsesByBlock) {
+          Instruction *BlockIP = Entry.first == IP->getParent()
+                                     ? IP
+                                     : &*Entry.first->getFirstInsertionPt();
+          ReBasesNum +=
+              emitBaseConstant(ConstInfo, BaseGV, BlockIP, Entry.second);
+        }
+        NumConstantsRematerialized++;
+        continue;
       }
 
-      Base->setDebugLoc(IP->getDebugLoc());
-
-      LLVM_DEBUG(dbgs() << "Hoist constant (" << *ConstInfo.BaseInt
-                        << ") to BB " << IP->getParent()->getName() << '\n'
-                        << *Base << '\n');
-
-      // Emit materialization code for rebased constants depending on this IP.
-      for (auto const &R : ToBeRebased) {
-        Constant *Off = std::get<0>(R);
-        Type *Ty = std::get<1>(R);
-        ConstantUser U = std::get<2>(R);
-        emitBaseConstants(Base, Off, Ty, U);
-        ReBasesNum++;
-        // Use the same debug location as the last user of the constant.
-        Base->setDebugLoc(DILocation::getMergedLocation(
-            Base->getDebugLoc(), U.Inst->getDebugLoc()));
-      }
-      assert(!Base->use_empty() && "The use list is empty!?");
-      assert(isa<Instruction>(Base->user_back()) &&
-             "All uses should be instructions.");
+      ReBasesNum += emitBaseConstant(ConstInfo, BaseGV, IP, ToBeRebased);
     }
     (void)UsesNum;
     (void)ReBasesNum;
@@ -917,10 +1078,12 @@ void ConstantHoistingPass::deleteDeadCastInst() const {
 /// Optimize expensive integer constants in the given function.
 bool ConstantHoistingPass::runImpl(Function &Fn, TargetTransformInfo &TTI,
                                    DominatorTree &DT, BlockFrequencyInfo *BFI,
-                                   BasicBlock &Entry) {
+                                   BasicBlock &Entry,
+                                   OptimizationRemarkEmitter *ORE) {
   this->TTI = &TTI;
   this->DT = &DT;
   this->BFI = BFI;
+  this->ORE = ORE;
   this->DL = &Fn.getParent()->getDataLayout();
   this->Ctx = &Fn.getContext();
   this->Entry = &Entry;
@@ -958,7 +1121,10 @@ PreservedAnalyses ConstantHoistingPass::run(Function &F,
   auto BFI = ConstHoistWithBlockFrequency
                  ? &AM.getResult<BlockFrequencyAnalysis>(F)
                  : nullptr;
-  if (!runImpl(F, TTI, DT, BFI, F.getEntryBlock()))
+  auto ORE = ConstHoistRemat
+                 ? &AM.getResult<OptimizationRemarkEmitterAnalysis>(F)
+                 : nullptr;
+  if (!runImpl(F, TTI, DT, BFI, F.getEntryBlock(), ORE))
     return PreservedAnalyses::all();
 
   PreservedAnalyses PA;
@@ -2532,14 +2532,18 @@ class llvm::gvn::GVNLegacyPass : public FunctionPass {
 public:
   static char ID; // Pass identification, replacement for typeid
 
-  explicit GVNLegacyPass(bool NoMemDepAnalysis = !EnableMemDep)
-      : FunctionPass(ID), NoMemDepAnalysis(NoMemDepAnalysis) {
+  explicit GVNLegacyPass(bool NoMemDepAnalysis = !EnableMemDep,
+                         unsigned MaxFunctionSize = 0)
+      : FunctionPass(ID), NoMemDepAnalysis(NoMemDepAnalysis),
+        MaxFunctionSize(MaxFunctionSize) {
     initializeGVNLegacyPassPass(*PassRegistry::getPassRegistry());
   }
 
   bool runOnFunction(Function &F) override {
     if (skipFunction(F))
       return false;
+    if (MaxFunctionSize && F.getInstructionCount() >= MaxFunctionSize)
+      return false;
 
     auto *LIWP = getAnalysisIfAvailable<LoopInfoWrapperPass>();
 
@@ -2570,6 +2574,7 @@ public:
 
 private:
   bool NoMemDepAnalysis;
+  unsigned MaxFunctionSize;
   GVN Impl;
 };
 
@@ -2586,6 +2591,7 @@ INITIALIZE_PASS_DEPENDENCY(OptimizationRemarkEmitterWrapperPass)
 INITIALIZE_PASS_END(GVNLegacyPass, "gvn", "Global Value Numbering", false, false)
 
 // The public interface to this file...
-FunctionPass *llvm::createGVNPass(bool NoMemDepAnalysis) {
-  return new GVNLegacyPass(NoMemDepAnalysis);
+FunctionPass *llvm::createGVNPass(bool NoMemDepAnalysis,
+                                  unsigned MaxFunctionSize) {
+  return new GVNLegacyPass(NoMemDepAnalysis, MaxFunctionSize);
 }
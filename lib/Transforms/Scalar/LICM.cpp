@@ -31,6 +31,7 @@
 //===----------------------------------------------------------------------===//
 
 #include "llvm/Transforms/Scalar/LICM.h"
+#include "llvm/ADT/MapVector.h"
 #include "llvm/ADT/SetOperations.h"
 #include "llvm/ADT/Statistic.h"
 #include "llvm/Analysis/AliasAnalysis.h"
@@ -84,12 +85,21 @@ STATISTIC(NumHoisted, "Number of instructions hoisted out of loop");
 STATISTIC(NumMovedLoads, "Number of load insts hoisted or sunk");
 STATISTIC(NumMovedCalls, "Number of call insts hoisted or sunk");
 STATISTIC(NumPromoted, "Number of memory locations promoted to registers");
+STATISTIC(NumPromotionQueryCapHit,
+          "Number of loops that ran out of promotion alias queries");
 
 /// Memory promotion is enabled by default.
 static cl::opt<bool>
     DisablePromotion("disable-licm-promotion", cl::Hidden, cl::init(false),
                      cl::desc("Disable memory promotion in LICM pass"));
 
+/// With MemorySSA enabled, promotion candidates are found with direct mod/ref
+/// queries instead of the alias set tracker.
+static cl::opt<unsigned> PromotionQueryCap(
+    "licm-promotion-query-cap", cl::Hidden, cl::init(250),
+    cl::desc("Max number of alias queries per loop used to find promotable "
+             "locations when MemorySSA is enabled"));
+
 static cl::opt<bool> ControlFlowHoisting(
     "licm-control-flow-hoisting", cl::Hidden, cl::init(false),
     cl::desc("Enable control flow (and PHI) hoisting in LICM"));
@@ -134,6 +144,9 @@ CloneInstructionInExitBlock(Instruction &I, BasicBlock &ExitBlock, PHINode &PN,
 static void eraseInstruction(Instruction &I, ICFLoopSafetyInfo &SafetyInfo,
                              AliasSetTracker *AST);
 
+static void collectPromotablePointers(Loop *L, AliasAnalysis *AA,
+                                      SmallVectorImpl<Value *> &Pointers);
+
 static void moveInstructionBefore(Instruction &I, Instruction &Dest,
                                   ICFLoopSafetyInfo &SafetyInfo);
 
@@ -328,26 +341,41 @@ bool LoopInvariantCodeMotion::runOnLoop(
 
       bool Promoted = false;
 
-      // Loop over all of the alias sets in the tracker object.
-      for (AliasSet &AS : *CurAST) {
-        // We can promote this alias set if it has a store, if it is a "Must"
-        // alias set, if the pointer is loop invariant, and if we are not
-        // eliminating any volatile loads or stores.
-        if (AS.isForwardingAliasSet() || !AS.isMod() || !AS.isMustAlias() ||
-            !L->isLoopInvariant(AS.begin()->getValue()))
-          continue;
-
-        assert(
-            !AS.empty() &&
-            "Must alias set should have at least one pointer element in it!");
-
-        SmallSetVector<Value *, 8> PointerMustAliases;
-        for (const auto &ASI : AS)
-          PointerMustAliases.insert(ASI.getValue());
-
-        Promoted |= promoteLoopAccessesToScalars(
-            PointerMustAliases, ExitBlocks, InsertPts, PIC, LI, DT, TLI, L,
-            CurAST.get(), &SafetyInfo, ORE);
+      // With MemorySSA, the alias sets are not consulted. Each stored
+      // location is checked against the other accesses of the loop instead,
+      // which is not confused by unrelated may-alias accesses.
+      if (MSSA) {
+        SmallVector<Value *, 8> Pointers;
+        collectPromotablePointers(L, AA, Pointers);
+        for (Value *Ptr : Pointers) {
+          SmallSetVector<Value *, 8> PointerMustAliases;
+          PointerMustAliases.insert(Ptr);
+          Promoted |= promoteLoopAccessesToScalars(
+              PointerMustAliases, ExitBlocks, InsertPts, PIC, LI, DT, TLI, L,
+              CurAST.get(), &SafetyInfo, ORE);
+        }
+      } else {
+        // Loop over all of the alias sets in the tracker object.
+        for (AliasSet &AS : *CurAST) {
+          // We can promote this alias set if it has a store, if it is a "Must"
+          // alias set, if the pointer is loop invariant, and if we are not
+          // eliminating any volatile loads or stores.
+          if (AS.isForwardingAliasSet() || !AS.isMod() || !AS.isMustAlias() ||
+              !L->isLoopInvariant(AS.begin()->getValue()))
+            continue;
+
+          assert(
+              !AS.empty() &&
+              "Must alias set should have at least one pointer element in it!");
+
+          SmallSetVector<Value *, 8> PointerMustAliases;
+          for (const auto &ASI : AS)
+            PointerMustAliases.insert(ASI.getValue());
+
+          Promoted |= promoteLoopAccessesToScalars(
+              PointerMustAliases, ExitBlocks, InsertPts, PIC, LI, DT, TLI, L,
+              CurAST.get(), &SafetyInfo, ORE);
+        }
       }
 
       // Once we have promoted values across the loop body we have to
@@ -1835,6 +1863,51 @@ bool llvm::promoteLoopAccessesToScalars(
   return true;
 }
 
+/// Collect in \p Pointers the loop invariant pointers that are stored to in
+/// \p L and not accessed by any other memory instruction of the loop. At most
+/// PromotionQueryCap alias queries are issued per loop.
+static void collectPromotablePointers(Loop *L, AliasAnalysis *AA,
+                                      SmallVectorImpl<Value *> &Pointers) {
+  SmallVector<Instruction *, 64> MemInsts;
+  MapVector<Value *, MemoryLocation> Candidates;
+  for (BasicBlock *BB : L->blocks())
+    for (Instruction &I : *BB) {
+      if (!I.mayReadOrWriteMemory())
+        continue;
+      MemInsts.push_back(&I);
+      auto *SI = dyn_cast<StoreInst>(&I);
+      if (!SI || !L->isLoopInvariant(SI->getPointerOperand()))
+        continue;
+      // Loads and stores of the location may carry different AA tags.
+      MemoryLocation Loc = MemoryLocation::get(SI);
+      Loc.AATags = AAMDNodes();
+      Candidates.insert({SI->getPointerOperand(), Loc});
+    }
+
+  unsigned NumQueries = 0;
+  for (auto &Candidate : Candidates) {
+    Value *Ptr = Candidate.first;
+    bool MayAlias = false;
+    for (Instruction *I : MemInsts) {
+      // Accesses through the same pointer are checked when promoting.
+      if (getLoadStorePointerOperand(I) == Ptr)
+        continue;
+      if (++NumQueries > PromotionQueryCap) {
+        LLVM_DEBUG(dbgs() << "LICM: Promotion query cap reached in loop "
+                          << L->getHeader()->getName() << "\n");
+        ++NumPromotionQueryCapHit;
+        return;
+      }
+      if (isModOrRefSet(AA->getModRefInfo(I, Candidate.second))) {
+        MayAlias = true;
+        break;
+      }
+    }
+    if (!MayAlias)
+      Pointers.push_back(Ptr);
+  }
+}
+
 /// Returns an owning pointer to an alias set which incorporates aliasing info
 /// from L and all subloops of L.
 /// FIXME: In new pass manager, there is no helper function to handle loop
@@ -77,6 +77,7 @@
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/Module.h"
 #include "llvm/IR/PassManager.h"
+#include "llvm/IR/PatternMatch.h"
 #include "llvm/IR/Type.h"
 #include "llvm/IR/User.h"
 #include "llvm/IR/Value.h"
@@ -102,6 +103,7 @@ using namespace llvm;
 
 STATISTIC(NumMemSet, "Number of memset's formed from loop stores");
 STATISTIC(NumMemCpy, "Number of memcpy's formed from loop load+stores");
+STATISTIC(NumStrLen, "Number of strlen's formed from loops");
 
 static cl::opt<bool> UseLIRCodeSizeHeurs(
     "use-lir-code-size-heurs",
@@ -109,6 +111,10 @@ static cl::opt<bool> UseLIRCodeSizeHeurs(
              "with -Os/-Oz"),
     cl::init(true), cl::Hidden);
 
+static cl::opt<bool> EnableStrLenIdiom(
+    "loop-idiom-strlen", cl::init(false), cl::Hidden,
+    cl::desc("Replace loops scanning for a terminating null byte with strlen"));
+
 namespace {
 
 class LoopIdiomRecognize {
@@ -192,6 +198,7 @@ private:
                                 PHINode *CntPhi, Value *Var, Instruction *DefX,
                                 const DebugLoc &DL, bool ZeroCheck,
                                 bool IsCntPhiUsedOutsideLoop);
+  bool recognizeStrLen();
 
   /// @}
 };
@@ -279,7 +286,7 @@ bool LoopIdiomRecognize::runOnLoop(Loop *L) {
 
   // Disable loop idiom recognition if the function's name is a common idiom.
   StringRef Name = L->getHeader()->getParent()->getName();
-  if (Name == "memset" || Name == "memcpy")
+  if (Name == "memset" || Name == "memcpy" || Name == "strlen")
     return false;
 
   // Determine if code size heuristics need to be applied.
@@ -1107,7 +1114,7 @@ bool LoopIdiomRecognize::avoidLIRForMultiBlockLoop(bool IsMemset,
 }
 
 bool LoopIdiomRecognize::runOnNoncountableLoop() {
-  return recognizePopcount() || recognizeAndInsertCTLZ();
+  return recognizePopcount() || recognizeAndInsertCTLZ() || recognizeStrLen();
 }
 
 /// Check if the given conditional branch is based on the comparison between
@@ -1755,3 +1762,100 @@ void LoopIdiomRecognize::transformLoopToPopcount(BasicBlock *PreCondBB,
   //   loop. The loop would otherwise not be deleted even if it becomes empty.
   SE->forgetLoop(CurLoop);
 }
+
+/// Recognize a loop that scans a string for its terminating null byte, e.g.,
+/// \code
+///   for (n = 0; s[n]; ++n)
+///     ;
+/// \endcode
+/// The values live out of the loop are then computed from strlen(s), and the
+/// loop is made to exit on its first iteration so that it is cleaned up later.
+bool LoopIdiomRecognize::recognizeStrLen() {
+  using namespace PatternMatch;
+
+  if (!EnableStrLenIdiom || !TLI->has(LibFunc_strlen))
+    return false;
+  if (CurLoop->getNumBlocks() != 1)
+    return false;
+
+  BasicBlock *Body = CurLoop->getHeader();
+  BasicBlock *Preheader = CurLoop->getLoopPreheader();
+  BasicBlock *ExitBB = CurLoop->getExitBlock();
+  if (!ExitBB || ExitBB->getSinglePredecessor() != Body)
+    return false;
+
+  // The loop must exit exactly when the loaded byte is zero.
+  auto *BI = dyn_cast<BranchInst>(Body->getTerminator());
+  if (!BI || !BI->isConditional())
+    return false;
+  ICmpInst::Predicate Pred;
+  Value *Byte;
+  if (!match(BI->getCondition(), m_ICmp(Pred, m_Value(Byte), m_Zero())))
+    return false;
+  bool ExitOnTrue = BI->getSuccessor(0) == ExitBB;
+  if (!(Pred == ICmpInst::ICMP_EQ && ExitOnTrue) &&
+      !(Pred == ICmpInst::ICMP_NE && !ExitOnTrue))
+    return false;
+
+  // The byte is loaded from consecutive addresses, one per iteration.
+  auto *Load = dyn_cast<LoadInst>(Byte);
+  if (!Load || !Load->isSimple() || Load->getParent() != Body ||
+      !Load->getType()->isIntegerTy(8))
+    return false;
+  auto *Ptr = dyn_cast<SCEVAddRecExpr>(SE->getSCEV(Load->getPointerOperand()));
+  if (!Ptr || Ptr->getLoop() != CurLoop || !Ptr->isAffine())
+    return false;
+  auto *Step = dyn_cast<SCEVConstant>(Ptr->getStepRecurrence(*SE));
+  if (!Step || !Step->getValue()->isOne())
+    return false;
+
+  for (Instruction &I : *Body)
+    if (&I != Load && (I.mayReadOrWriteMemory() || I.mayHaveSideEffects()))
+      return false;
+
+  // Each live-out value must be a recurrence whose value in the exiting
+  // iteration follows from the string length.
+  SmallVector<std::pair<PHINode *, const SCEVAddRecExpr *>, 4> LiveOuts;
+  for (PHINode &PN : ExitBB->phis()) {
+    auto *I = dyn_cast<Instruction>(PN.getIncomingValue(0));
+    if (!I || !CurLoop->contains(I))
+      continue;
+    auto *AR = dyn_cast<SCEVAddRecExpr>(SE->getSCEV(I));
+    if (!AR || AR->getLoop() != CurLoop || !AR->isAffine())
+      return false;
+    LiveOuts.push_back({&PN, AR});
+  }
+
+  LLVM_DEBUG(dbgs() << "LIR: Found strlen idiom in loop "
+                    << Body->getName() << "\n");
+
+  Instruction *InsertPt = Preheader->getTerminator();
+  IRBuilder<> Builder(InsertPt);
+  SCEVExpander Expander(*SE, *DL, "loop-idiom");
+  Value *Base = Expander.expandCodeFor(
+      Ptr->getStart(), Load->getPointerOperand()->getType(), InsertPt);
+  Value *Len = emitStrLen(Base, Builder, *DL, TLI);
+  if (!Len)
+    return false;
+  const SCEV *LenSCEV = SE->getSCEV(Len);
+
+  for (auto &LiveOut : LiveOuts) {
+    PHINode *PN = LiveOut.first;
+    const SCEVAddRecExpr *AR = LiveOut.second;
+    const SCEV *Iteration = SE->getTruncateOrZeroExtend(
+        LenSCEV, SE->getEffectiveSCEVType(AR->getType()));
+    Value *ExitValue = Expander.expandCodeFor(
+        AR->evaluateAtIteration(Iteration, *SE), PN->getType(), InsertPt);
+    PN->replaceAllUsesWith(ExitValue);
+    PN->eraseFromParent();
+  }
+
+  // Leave the loop on its first iteration. Nothing uses its values anymore.
+  Value *OldCond = BI->getCondition();
+  BI->setCondition(ExitOnTrue ? Builder.getTrue() : Builder.getFalse());
+  RecursivelyDeleteTriviallyDeadInstructions(OldCond, TLI);
+
+  SE->forgetLoop(CurLoop);
+  ++NumStrLen;
+  return true;
+}
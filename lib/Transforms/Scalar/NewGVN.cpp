@@ -4200,7 +4200,8 @@ public:
   // Pass identification, replacement for typeid.
   static char ID;
 
-  NewGVNLegacyPass() : FunctionPass(ID) {
+  explicit NewGVNLegacyPass(unsigned MinFunctionSize = 0)
+      : FunctionPass(ID), MinFunctionSize(MinFunctionSize) {
     initializeNewGVNLegacyPassPass(*PassRegistry::getPassRegistry());
   }
 
@@ -4216,6 +4217,8 @@ private:
     AU.addPreserved<DominatorTreeWrapperPass>();
     AU.addPreserved<GlobalsAAWrapperPass>();
   }
+
+  unsigned MinFunctionSize;
 };
 
 } // end anonymous namespace
@@ -4223,6 +4226,8 @@ private:
 bool NewGVNLegacyPass::runOnFunction(Function &F) {
   if (skipFunction(F))
     return false;
+  if (F.getInstructionCount() < MinFunctionSize)
+    return false;
   return NewGVN(F, &getAnalysis<DominatorTreeWrapperPass>().getDomTree(),
                 &getAnalysis<AssumptionCacheTracker>().getAssumptionCache(F),
                 &getAnalysis<TargetLibraryInfoWrapperPass>().getTLI(),
@@ -4246,7 +4251,9 @@ INITIALIZE_PASS_END(NewGVNLegacyPass, "newgvn", "Global Value Numbering", false,
                     false)
 
 // createGVNPass - The public interface to this file.
-FunctionPass *llvm::createNewGVNPass() { return new NewGVNLegacyPass(); }
+FunctionPass *llvm::createNewGVNPass(unsigned MinFunctionSize) {
+  return new NewGVNLegacyPass(MinFunctionSize);
+}
 
 PreservedAnalyses NewGVNPass::run(Function &F, AnalysisManager<Function> &AM) {
   // Apparently the order in which we get these results matter for
@@ -107,6 +107,9 @@ using namespace llvm::sroa;
 STATISTIC(NumAllocasAnalyzed, "Number of allocas analyzed for replacement");
 STATISTIC(NumAllocaPartitions, "Number of alloca partitions formed");
 STATISTIC(MaxPartitionsPerAlloca, "Maximum number of partitions per alloca");
+STATISTIC(MaxSlicesPerAlloca, "Maximum number of slices per alloca");
+STATISTIC(MaxSplitTailsPerPartition,
+          "Maximum number of split slice tails overlapping a partition");
 STATISTIC(NumAllocaPartitionUses, "Number of alloca partition uses rewritten");
 STATISTIC(MaxUsesPerAllocaPartition, "Maximum number of uses of a partition");
 STATISTIC(NumNewAllocas, "Number of new, smaller allocas introduced");
@@ -450,6 +453,10 @@ class AllocaSlices::partition_iterator
   /// FIXME: Do we really?
   uint64_t MaxSplitSliceEndOffset = 0;
 
+  /// The minimum end offset of the split slices, so that they are only
+  /// scanned when at least one of them has ended.
+  uint64_t MinSplitSliceEndOffset = UINT64_MAX;
+
   /// Sets the partition to be empty at given iterator, and sets the
   /// end iterator.
   partition_iterator(AllocaSlices::iterator SI, AllocaSlices::iterator SE)
@@ -473,7 +480,8 @@ class AllocaSlices::partition_iterator
         // If we've finished all splits, this is easy.
         P.SplitTails.clear();
         MaxSplitSliceEndOffset = 0;
-      } else {
+        MinSplitSliceEndOffset = UINT64_MAX;
+      } else if (P.EndOffset >= MinSplitSliceEndOffset) {
         // Remove the uses which have ended in the prior partition. This
         // cannot change the max split slice end because we just checked that
         // the prior partition ended prior to that max.
@@ -483,6 +491,10 @@ class AllocaSlices::partition_iterator
                                                     P.EndOffset;
                                            }),
                            P.SplitTails.end());
+        MinSplitSliceEndOffset = UINT64_MAX;
+        for (Slice *S : P.SplitTails)
+          MinSplitSliceEndOffset =
+              std::min(S->endOffset(), MinSplitSliceEndOffset);
         assert(llvm::any_of(P.SplitTails,
                             [&](Slice *S) {
                               return S->endOffset() == MaxSplitSliceEndOffset;
@@ -513,7 +525,10 @@ class AllocaSlices::partition_iterator
           P.SplitTails.push_back(&S);
           MaxSplitSliceEndOffset =
               std::max(S.endOffset(), MaxSplitSliceEndOffset);
+          MinSplitSliceEndOffset =
+              std::min(S.endOffset(), MinSplitSliceEndOffset);
         }
+      MaxSplitTailsPerPartition.updateMax(P.SplitTails.size());
 
       // Start from the end of the previous partition.
       P.SI = P.SJ;
@@ -4207,12 +4222,25 @@ bool SROA::splitAlloca(AllocaInst &AI, AllocaSlices &AS) {
   const uint64_t MaxBitVectorSize = 1024;
   if (AllocaSize <= MaxBitVectorSize) {
     // If a byte boundary is included in any load or store, a slice starting or
-    // ending at the boundary is not splittable.
+    // ending at the boundary is not splittable. Count the slices covering
+    // each boundary with a difference array, so that this is linear in the
+    // number of slices rather than in the sum of their sizes.
+    SmallVector<int, 64> Coverage(AllocaSize + 1, 0);
+    for (Slice &S : AS) {
+      uint64_t Begin = S.beginOffset() + 1;
+      uint64_t End = std::min(S.endOffset(), AllocaSize);
+      if (Begin >= End)
+        continue;
+      ++Coverage[Begin];
+      --Coverage[End];
+    }
     SmallBitVector SplittableOffset(AllocaSize + 1, true);
-    for (Slice &S : AS)
-      for (unsigned O = S.beginOffset() + 1;
-           O < S.endOffset() && O < AllocaSize; O++)
+    int Covered = 0;
+    for (uint64_t O = 0; O < AllocaSize; ++O) {
+      Covered += Coverage[O];
+      if (Covered)
         SplittableOffset.reset(O);
+    }
 
     for (Slice &S : AS) {
       if (!S.isSplittable())
@@ -4391,6 +4419,7 @@ bool SROA::runOnAlloca(AllocaInst &AI) {
   LLVM_DEBUG(AS.print(dbgs()));
   if (AS.isEscaped())
     return Changed;
+  MaxSlicesPerAlloca.updateMax(std::distance(AS.begin(), AS.end()));
 
   // Delete all the dead users of this alloca before splitting and rewriting it.
   for (Instruction *DeadUser : AS.getDeadUsers()) {
@@ -13,6 +13,7 @@
 //===----------------------------------------------------------------------===//
 
 #include "llvm/Transforms/Utils/CallPromotionUtils.h"
+#include "llvm/ADT/STLExtras.h"
 #include "llvm/IR/IRBuilder.h"
 #include "llvm/Transforms/Utils/BasicBlockUtils.h"
 
@@ -190,10 +191,10 @@ static void createRetBitCast(CallSite CS, Type *RetTy, CastInst **RetBitCast) {
 /// Predicate and clone the given call site.
 ///
 /// This function creates an if-then-else structure at the location of the call
-/// site. The "if" condition compares the call site's called value to the given
-/// callee. The original call site is moved into the "else" block, and a clone
-/// of the call site is placed in the "then" block. The cloned instruction is
-/// returned.
+/// site. The "if" condition is \p Cond, which usually compares the call site's
+/// called value to the callee. The original call site is moved into the "else"
+/// block, and a clone of the call site is placed in the "then" block. The
+/// cloned instruction is returned.
 ///
 /// For example, the call instruction below:
 ///
@@ -254,19 +255,13 @@ static void createRetBitCast(CallSite CS, Type *RetTy, CastInst **RetBitCast) {
 ///     %t2 = phi i32 [ %t0, %else_bb ], [ %t1, %then_bb ]
 ///     br %normal_dst
 ///
-static Instruction *versionCallSite(CallSite CS, Value *Callee,
+static Instruction *versionCallSite(CallSite CS, Value *Cond,
                                     MDNode *BranchWeights) {
 
   IRBuilder<> Builder(CS.getInstruction());
   Instruction *OrigInst = CS.getInstruction();
   BasicBlock *OrigBlock = OrigInst->getParent();
 
-  // Create the compare. The called value and callee must have the same type to
-  // be compared.
-  if (CS.getCalledValue()->getType() != Callee->getType())
-    Callee = Builder.CreateBitCast(Callee, CS.getCalledValue()->getType());
-  auto *Cond = Builder.CreateICmpEQ(CS.getCalledValue(), Callee);
-
   // Create an if-then-else structure. The original instruction is moved into
   // the "else" block, and a clone of the original instruction is placed in the
   // "then" block.
@@ -440,13 +435,90 @@ Instruction *llvm::promoteCall(CallSite CS, Function *Callee,
 Instruction *llvm::promoteCallWithIfThenElse(CallSite CS, Function *Callee,
                                              MDNode *BranchWeights) {
 
+  // Create the compare. The called value and callee must have the same type to
+  // be compared.
+  IRBuilder<> Builder(CS.getInstruction());
+  Value *CastedCallee = Callee;
+  if (CS.getCalledValue()->getType() != Callee->getType())
+    CastedCallee =
+        Builder.CreateBitCast(Callee, CS.getCalledValue()->getType());
+  Value *Cond = Builder.CreateICmpEQ(CS.getCalledValue(), CastedCallee);
+
   // Version the indirect call site. If the called value is equal to the given
   // callee, 'NewInst' will be executed, otherwise the original call site will
   // be executed.
-  Instruction *NewInst = versionCallSite(CS, Callee, BranchWeights);
+  Instruction *NewInst = versionCallSite(CS, Cond, BranchWeights);
 
   // Promote 'NewInst' so that it directly calls the desired function.
   return promoteCall(CallSite(NewInst), Callee);
 }
 
+/// Collect the instructions that compute the called value of \p CS from
+/// \p VTable, innermost first, if only \p CS uses them and they can be moved
+/// down to it. Otherwise leave \p Insts empty.
+static void collectSinkableCalleeInsts(CallSite CS, Value *VTable,
+                                       SmallVectorImpl<Instruction *> &Insts) {
+  Instruction *Call = CS.getInstruction();
+  Value *V = CS.getCalledValue();
+  bool SeenLoad = false;
+  while (V != VTable) {
+    auto *I = dyn_cast<Instruction>(V);
+    if (!I || I->getParent() != Call->getParent() || !I->hasOneUse()) {
+      Insts.clear();
+      return;
+    }
+    if (auto *Load = dyn_cast<LoadInst>(I)) {
+      if (SeenLoad || !Load->isSimple()) {
+        Insts.clear();
+        return;
+      }
+      SeenLoad = true;
+      V = Load->getPointerOperand();
+    } else if (isa<BitCastInst>(I) ||
+               (isa<GetElementPtrInst>(I) &&
+                cast<GetElementPtrInst>(I)->hasAllConstantIndices())) {
+      V = I->getOperand(0);
+    } else {
+      Insts.clear();
+      return;
+    }
+    Insts.push_back(I);
+  }
+
+  // The load must not move across a store that may change the loaded value.
+  for (Instruction *I : Insts)
+    if (isa<LoadInst>(I))
+      for (auto It = std::next(I->getIterator()); &*It != Call; ++It)
+        if (It->mayWriteToMemory()) {
+          Insts.clear();
+          return;
+        }
+}
+
+Instruction *llvm::promoteCallWithVTableCmp(CallSite CS, Function *Callee,
+                                            Value *VTable,
+                                            ArrayRef<Constant *> AddressPoints,
+                                            MDNode *BranchWeights) {
+  assert(!AddressPoints.empty() && "No vtable to compare with");
+  SmallVector<Instruction *, 4> CalleeInsts;
+  collectSinkableCalleeInsts(CS, VTable, CalleeInsts);
+
+  IRBuilder<> Builder(CS.getInstruction());
+  Value *Cond = nullptr;
+  for (Constant *AddressPoint : AddressPoints) {
+    Value *Cmp = Builder.CreateICmpEQ(
+        VTable, ConstantExpr::getBitCast(AddressPoint, VTable->getType()));
+    Cond = Cond ? Builder.CreateOr(Cond, Cmp) : Cmp;
+  }
+
+  Instruction *NewInst = versionCallSite(CS, Cond, BranchWeights);
+  Instruction *Promoted = promoteCall(CallSite(NewInst), Callee);
+
+  // Only the original call site in the "else" block uses the called value
+  // now, so compute it there.
+  for (Instruction *I : reverse(CalleeInsts))
+    I->moveBefore(CS.getInstruction());
+  return Promoted;
+}
+
 #undef DEBUG_TYPE
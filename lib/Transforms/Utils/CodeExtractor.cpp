@@ -298,53 +298,94 @@ static BasicBlock *getCommonExitBlock(const SetVector<BasicBlock *> &Blocks) {
   return CommonExitBlock;
 }
 
-bool CodeExtractor::isLegalToShrinkwrapLifetimeMarkers(
-    Instruction *Addr) const {
-  AllocaInst *AI = cast<AllocaInst>(Addr->stripInBoundsConstantOffsets());
-  Function *Func = (*Blocks.begin())->getParent();
-  for (BasicBlock &BB : *Func) {
-    if (Blocks.count(&BB))
+/// Find the allocas accessed by the loads and stores of \p BB, and whether it
+/// has instructions that may access other memory.
+static void summarizeBlock(BasicBlock &BB, SmallPtrSetImpl<AllocaInst *> &Addrs,
+                           bool &SideEffecting) {
+  SideEffecting = false;
+  for (Instruction &II : BB) {
+    if (isa<DbgInfoIntrinsic>(II))
       continue;
-    for (Instruction &II : BB) {
-      if (isa<DbgInfoIntrinsic>(II))
-        continue;
 
-      unsigned Opcode = II.getOpcode();
-      Value *MemAddr = nullptr;
-      switch (Opcode) {
-      case Instruction::Store:
-      case Instruction::Load: {
-        if (Opcode == Instruction::Store) {
-          StoreInst *SI = cast<StoreInst>(&II);
-          MemAddr = SI->getPointerOperand();
-        } else {
-          LoadInst *LI = cast<LoadInst>(&II);
-          MemAddr = LI->getPointerOperand();
-        }
-        // Global variable can not be aliased with locals.
-        if (dyn_cast<Constant>(MemAddr))
-          break;
-        Value *Base = MemAddr->stripInBoundsConstantOffsets();
-        if (!dyn_cast<AllocaInst>(Base) || Base == AI)
-          return false;
+    unsigned Opcode = II.getOpcode();
+    Value *MemAddr = nullptr;
+    switch (Opcode) {
+    case Instruction::Store:
+    case Instruction::Load: {
+      if (Opcode == Instruction::Store) {
+        StoreInst *SI = cast<StoreInst>(&II);
+        MemAddr = SI->getPointerOperand();
+      } else {
+        LoadInst *LI = cast<LoadInst>(&II);
+        MemAddr = LI->getPointerOperand();
+      }
+      // Global variable can not be aliased with locals.
+      if (dyn_cast<Constant>(MemAddr))
+        break;
+      Value *Base = MemAddr->stripInBoundsConstantOffsets();
+      if (auto *AI = dyn_cast<AllocaInst>(Base)) {
+        Addrs.insert(AI);
         break;
       }
-      default: {
-        IntrinsicInst *IntrInst = dyn_cast<IntrinsicInst>(&II);
-        if (IntrInst) {
-          if (IntrInst->getIntrinsicID() == Intrinsic::lifetime_start ||
-              IntrInst->getIntrinsicID() == Intrinsic::lifetime_end)
-            break;
-          return false;
-        }
-        // Treat all the other cases conservatively if it has side effects.
-        if (II.mayHaveSideEffects())
-          return false;
+      SideEffecting = true;
+      return;
+    }
+    default: {
+      IntrinsicInst *IntrInst = dyn_cast<IntrinsicInst>(&II);
+      if (IntrInst) {
+        if (IntrInst->getIntrinsicID() == Intrinsic::lifetime_start ||
+            IntrInst->getIntrinsicID() == Intrinsic::lifetime_end)
+          break;
+        SideEffecting = true;
+        return;
       }
+      // Treat all the other cases conservatively if it has side effects.
+      if (II.mayHaveSideEffects()) {
+        SideEffecting = true;
+        return;
       }
     }
+    }
+  }
+}
+
+CodeExtractorAnalysisCache::CodeExtractorAnalysisCache(Function &F) {
+  for (BasicBlock &BB : F) {
+    for (Instruction &II : BB)
+      if (auto *AI = dyn_cast<AllocaInst>(&II))
+        Allocas.push_back(AI);
+
+    bool SideEffecting;
+    summarizeBlock(BB, BaseMemAddrs[&BB], SideEffecting);
+    if (SideEffecting)
+      SideEffectingBlocks.insert(&BB);
   }
+}
 
+bool CodeExtractorAnalysisCache::doesBlockContainClobberOfAddr(
+    BasicBlock &BB, AllocaInst *Addr) const {
+  auto It = BaseMemAddrs.find(&BB);
+  if (It != BaseMemAddrs.end())
+    return SideEffectingBlocks.count(&BB) || It->second.count(Addr);
+
+  // The block was split off a summarized one by an earlier extraction, and
+  // may hold part of its instructions.
+  SmallPtrSet<AllocaInst *, 2> Addrs;
+  bool SideEffecting;
+  summarizeBlock(BB, Addrs, SideEffecting);
+  return SideEffecting || Addrs.count(Addr);
+}
+
+bool CodeExtractor::isLegalToShrinkwrapLifetimeMarkers(
+    const CodeExtractorAnalysisCache &CEAC, Instruction *Addr) const {
+  AllocaInst *AI = cast<AllocaInst>(Addr->stripInBoundsConstantOffsets());
+  Function *Func = (*Blocks.begin())->getParent();
+  for (BasicBlock &BB : *Func) {
+    if (Blocks.count(&BB))
+      continue;
+    if (CEAC.doesBlockContainClobberOfAddr(BB, AI))
+      return false;
+  }
   return true;
 }
 
@@ -402,110 +443,110 @@ CodeExtractor::findOrCreateBlockForHoisting(BasicBlock *CommonExitBlock) {
   return CommonExitBlock;
 }
 
-void CodeExtractor::findAllocas(ValueSet &SinkCands, ValueSet &HoistCands,
+void CodeExtractor::findAllocas(const CodeExtractorAnalysisCache &CEAC,
+                                ValueSet &SinkCands, ValueSet &HoistCands,
                                 BasicBlock *&ExitBlock) const {
   Function *Func = (*Blocks.begin())->getParent();
   ExitBlock = getCommonExitBlock(Blocks);
 
-  for (BasicBlock &BB : *Func) {
-    if (Blocks.count(&BB))
+  for (AllocaInst *AI : CEAC.getAllocas()) {
+    BasicBlock *BB = AI->getParent();
+    if (Blocks.count(BB))
+      continue;
+    // An earlier extraction may have moved the alloca out of the function.
+    if (BB->getParent() != Func)
       continue;
-    for (Instruction &II : BB) {
-      auto *AI = dyn_cast<AllocaInst>(&II);
-      if (!AI)
-        continue;
 
-      // Find the pair of life time markers for address 'Addr' that are either
-      // defined inside the outline region or can legally be shrinkwrapped into
-      // the outline region. If there are not other untracked uses of the
-      // address, return the pair of markers if found; otherwise return a pair
-      // of nullptr.
-      auto GetLifeTimeMarkers =
-          [&](Instruction *Addr, bool &SinkLifeStart,
-              bool &HoistLifeEnd) -> std::pair<Instruction *, Instruction *> {
-        Instruction *LifeStart = nullptr, *LifeEnd = nullptr;
-
-        for (User *U : Addr->users()) {
-          IntrinsicInst *IntrInst = dyn_cast<IntrinsicInst>(U);
-          if (IntrInst) {
-            if (IntrInst->getIntrinsicID() == Intrinsic::lifetime_start) {
-              // Do not handle the case where AI has multiple start markers.
-              if (LifeStart)
-                return std::make_pair<Instruction *>(nullptr, nullptr);
-              LifeStart = IntrInst;
-            }
-            if (IntrInst->getIntrinsicID() == Intrinsic::lifetime_end) {
-              if (LifeEnd)
-                return std::make_pair<Instruction *>(nullptr, nullptr);
-              LifeEnd = IntrInst;
-            }
-            continue;
+    // Find the pair of life time markers for address 'Addr' that are either
+    // defined inside the outline region or can legally be shrinkwrapped into
+    // the outline region. If there are not other untracked uses of the
+    // address, return the pair of markers if found; otherwise return a pair
+    // of nullptr.
+    auto GetLifeTimeMarkers =
+        [&](Instruction *Addr, bool &SinkLifeStart,
+            bool &HoistLifeEnd) -> std::pair<Instruction *, Instruction *> {
+      Instruction *LifeStart = nullptr, *LifeEnd = nullptr;
+
+      for (User *U : Addr->users()) {
+        IntrinsicInst *IntrInst = dyn_cast<IntrinsicInst>(U);
+        if (IntrInst) {
+          if (IntrInst->getIntrinsicID() == Intrinsic::lifetime_start) {
+            // Do not handle the case where AI has multiple start markers.
+            if (LifeStart)
+              return std::make_pair<Instruction *>(nullptr, nullptr);
+            LifeStart = IntrInst;
           }
-          // Find untracked uses of the address, bail.
-          if (!definedInRegion(Blocks, U))
-            return std::make_pair<Instruction *>(nullptr, nullptr);
+          if (IntrInst->getIntrinsicID() == Intrinsic::lifetime_end) {
+            if (LifeEnd)
+              return std::make_pair<Instruction *>(nullptr, nullptr);
+            LifeEnd = IntrInst;
+          }
+          continue;
         }
-
-        if (!LifeStart || !LifeEnd)
+        // Find untracked uses of the address, bail.
+        if (!definedInRegion(Blocks, U))
           return std::make_pair<Instruction *>(nullptr, nullptr);
+      }
 
-        SinkLifeStart = !definedInRegion(Blocks, LifeStart);
-        HoistLifeEnd = !definedInRegion(Blocks, LifeEnd);
-        // Do legality Check.
-        if ((SinkLifeStart || HoistLifeEnd) &&
-            !isLegalToShrinkwrapLifetimeMarkers(Addr))
-          return std::make_pair<Instruction *>(nullptr, nullptr);
+      if (!LifeStart || !LifeEnd)
+        return std::make_pair<Instruction *>(nullptr, nullptr);
 
-        // Check to see if we have a place to do hoisting, if not, bail.
-        if (HoistLifeEnd && !ExitBlock)
-          return std::make_pair<Instruction *>(nullptr, nullptr);
+      SinkLifeStart = !definedInRegion(Blocks, LifeStart);
+      HoistLifeEnd = !definedInRegion(Blocks, LifeEnd);
+      // Do legality Check.
+      if ((SinkLifeStart || HoistLifeEnd) &&
+          !isLegalToShrinkwrapLifetimeMarkers(CEAC, Addr))
+        return std::make_pair<Instruction *>(nullptr, nullptr);
 
-        return std::make_pair(LifeStart, LifeEnd);
-      };
+      // Check to see if we have a place to do hoisting, if not, bail.
+      if (HoistLifeEnd && !ExitBlock)
+        return std::make_pair<Instruction *>(nullptr, nullptr);
 
-      bool SinkLifeStart = false, HoistLifeEnd = false;
-      auto Markers = GetLifeTimeMarkers(AI, SinkLifeStart, HoistLifeEnd);
+      return std::make_pair(LifeStart, LifeEnd);
+    };
 
-      if (Markers.first) {
-        if (SinkLifeStart)
-          SinkCands.insert(Markers.first);
-        SinkCands.insert(AI);
-        if (HoistLifeEnd)
-          HoistCands.insert(Markers.second);
-        continue;
-      }
+    bool SinkLifeStart = false, HoistLifeEnd = false;
+    auto Markers = GetLifeTimeMarkers(AI, SinkLifeStart, HoistLifeEnd);
 
-      // Follow the bitcast.
-      Instruction *MarkerAddr = nullptr;
-      for (User *U : AI->users()) {
-        if (U->stripInBoundsConstantOffsets() == AI) {
-          SinkLifeStart = false;
-          HoistLifeEnd = false;
-          Instruction *Bitcast = cast<Instruction>(U);
-          Markers = GetLifeTimeMarkers(Bitcast, SinkLifeStart, HoistLifeEnd);
-          if (Markers.first) {
-            MarkerAddr = Bitcast;
-            continue;
-          }
-        }
+    if (Markers.first) {
+      if (SinkLifeStart)
+        SinkCands.insert(Markers.first);
+      SinkCands.insert(AI);
+      if (HoistLifeEnd)
+        HoistCands.insert(Markers.second);
+      continue;
+    }
 
-        // Found unknown use of AI.
-        if (!definedInRegion(Blocks, U)) {
-          MarkerAddr = nullptr;
-          break;
+    // Follow the bitcast.
+    Instruction *MarkerAddr = nullptr;
+    for (User *U : AI->users()) {
+      if (U->stripInBoundsConstantOffsets() == AI) {
+        SinkLifeStart = false;
+        HoistLifeEnd = false;
+        Instruction *Bitcast = cast<Instruction>(U);
+        Markers = GetLifeTimeMarkers(Bitcast, SinkLifeStart, HoistLifeEnd);
+        if (Markers.first) {
+          MarkerAddr = Bitcast;
+          continue;
         }
       }
 
-      if (MarkerAddr) {
-        if (SinkLifeStart)
-          SinkCands.insert(Markers.first);
-        if (!definedInRegion(Blocks, MarkerAddr))
-          SinkCands.insert(MarkerAddr);
-        SinkCands.insert(AI);
-        if (HoistLifeEnd)
-          HoistCands.insert(Markers.second);
+      // Found unknown use of AI.
+      if (!definedInRegion(Blocks, U)) {
+        MarkerAddr = nullptr;
+        break;
       }
     }
+
+    if (MarkerAddr) {
+      if (SinkLifeStart)
+        SinkCands.insert(Markers.first);
+      if (!definedInRegion(Blocks, MarkerAddr))
+        SinkCands.insert(MarkerAddr);
+      SinkCands.insert(AI);
+      if (HoistLifeEnd)
+        HoistCands.insert(Markers.second);
+    }
   }
 }
 
@@ -1180,6 +1221,14 @@ void CodeExtractor::calculateNewCallTerminatorWeights(
 }
 
 Function *CodeExtractor::extractCodeRegion() {
+  if (!isEligible())
+    return nullptr;
+  CodeExtractorAnalysisCache CEAC(*(*Blocks.begin())->getParent());
+  return extractCodeRegion(CEAC);
+}
+
+Function *
+CodeExtractor::extractCodeRegion(const CodeExtractorAnalysisCache &CEAC) {
   if (!isEligible())
     return nullptr;
 
@@ -1275,7 +1324,7 @@ Function *CodeExtractor::extractCodeRegion() {
   }
   newFuncRoot->getInstList().push_back(BranchI);
 
-  findAllocas(SinkingCands, HoistingCands, CommonExit);
+  findAllocas(CEAC, SinkingCands, HoistingCands, CommonExit);
   assert(HoistingCands.empty() || CommonExit);
 
   // Find inputs to, outputs from the code region.
@@ -906,20 +906,69 @@ public:
 
 } // end anonymous namespace
 
-// A function hash is calculated by considering only the number of arguments and
-// whether a function is varargs, the order of basic blocks (given by the
-// successors of each basic block in depth first order), and the order of
-// opcodes of each instruction within each of these basic blocks. This mirrors
-// the strategy compare() uses to compare functions by walking the BBs in depth
-// first order and comparing each instruction in sequence. Because this hash
-// does not look at the operands, it is insensitive to things such as the
-// target of calls and the constants used in the function, which makes it useful
-// when possibly merging functions which are the same modulo constants and call
-// targets.
+// Hash the parts of a type that cmpTypes() compares at the top level. Pointers
+// in address space 0 compare equal to integers of the pointer size, so they are
+// hashed as such. This does not create types, so that functions in the same
+// context can be hashed concurrently.
+static void hashType(HashAccumulator64 &H, Type *Ty, const DataLayout &DL) {
+  if (auto *PTy = dyn_cast<PointerType>(Ty))
+    if (PTy->getAddressSpace() == 0) {
+      H.add(Type::IntegerTyID);
+      H.add(DL.getPointerSizeInBits(0));
+      return;
+    }
+
+  H.add(Ty->getTypeID());
+  if (auto *ITy = dyn_cast<IntegerType>(Ty))
+    H.add(ITy->getBitWidth());
+  else if (auto *PTy = dyn_cast<PointerType>(Ty))
+    H.add(PTy->getAddressSpace());
+  else if (auto *STy = dyn_cast<SequentialType>(Ty))
+    H.add(STy->getNumElements());
+  else
+    H.add(Ty->getNumContainedTypes());
+}
+
+// Hash an operand the way cmpValues() tells operands apart without looking at
+// the rest of the function: constants only equal constants, all null values
+// are equal, and otherwise constants of different kinds or integers of
+// different values differ.
+static void hashOperand(HashAccumulator64 &H, const Value *V) {
+  const auto *C = dyn_cast<Constant>(V);
+  if (!C) {
+    H.add(isa<InlineAsm>(V));
+    return;
+  }
+  if (C->isNullValue()) {
+    H.add(2);
+    return;
+  }
+  H.add(3);
+  H.add(C->getValueID());
+  if (const auto *CI = dyn_cast<ConstantInt>(C))
+    H.add(hash_value(CI->getValue()));
+}
+
+// A function hash is calculated by considering the signature of the function,
+// the order of basic blocks (given by the successors of each basic block in
+// depth first order), and the opcode, type and operands of each instruction
+// within each of these basic blocks. This mirrors the strategy compare() uses
+// to compare functions by walking the BBs in depth first order and comparing
+// each instruction in sequence, and only includes what compare() requires to
+// be equal: the types as cmpTypes() sees them, and of the operands only
+// whether they are null, integer or other constants. Values and globals are
+// not hashed, as compare() numbers them in order of appearance, so the hash
+// stays insensitive to call targets. Getting the operands into the hash keeps
+// the number of functions compare() has to order with the same hash low in
+// large modules, where many small functions share their opcode sequence.
 FunctionComparator::FunctionHash FunctionComparator::functionHash(Function &F) {
+  const DataLayout &DL = F.getParent()->getDataLayout();
   HashAccumulator64 H;
   H.add(F.isVarArg());
   H.add(F.arg_size());
+  hashType(H, F.getReturnType(), DL);
+  for (const Argument &A : F.args())
+    hashType(H, A.getType(), DL);
 
   SmallVector<const BasicBlock *, 8> BBs;
   SmallPtrSet<const BasicBlock *, 16> VisitedBBs;
@@ -935,6 +984,19 @@ FunctionComparator::FunctionHash FunctionComparator::functionHash(Function &F) {
     H.add(45798);
     for (auto &Inst : *BB) {
       H.add(Inst.getOpcode());
+      // GEPs with the same constant offset compare equal regardless of their
+      // indices and result type; see cmpGEPs().
+      if (isa<GetElementPtrInst>(Inst))
+        continue;
+      H.add(Inst.getNumOperands());
+      H.add(Inst.getRawSubclassOptionalData());
+      hashType(H, Inst.getType(), DL);
+      if (const auto *CI = dyn_cast<CmpInst>(&Inst))
+        H.add(CI->getPredicate());
+      for (const Value *Op : Inst.operands()) {
+        hashType(H, Op->getType(), DL);
+        hashOperand(H, Op);
+      }
     }
     const Instruction *Term = BB->getTerminator();
     for (unsigned i = 0, e = Term->getNumSuccessors(); i != e; ++i) {
@@ -19,6 +19,7 @@
 #include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/StringRef.h"
+#include "llvm/IR/CallSite.h"
 #include "llvm/IR/Comdat.h"
 #include "llvm/IR/Constant.h"
 #include "llvm/IR/Constants.h"
@@ -33,6 +34,7 @@
 #include "llvm/IR/User.h"
 #include "llvm/IR/Value.h"
 #include "llvm/Support/Casting.h"
+#include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/MD5.h"
@@ -59,6 +61,11 @@ using ClusterIDMapType = DenseMap<const GlobalValue *, unsigned>;
 
 } // end anonymous namespace
 
+static cl::opt<bool> SplitByCallAffinity(
+    "split-module-call-affinity", cl::init(false), cl::Hidden,
+    cl::desc("Partition modules along the call graph, keeping functions "
+             "connected by hot calls together"));
+
 static void addNonConstUser(ClusterMapType &GVtoClusterMap,
                             const GlobalValue *GV, const User *U) {
   assert((!isa<Constant>(U) || isa<GlobalValue>(U)) && "Bad user");
@@ -92,18 +99,9 @@ static void addAllGlobalValueUsers(ClusterMapType &GVtoClusterMap,
   }
 }
 
-// Find partitions for module in the way that no locals need to be
-// globalized.
-// Try to balance pack those partitions into N files since this roughly equals
-// thread balancing for the backend codegen step.
-static void findPartitions(Module *M, ClusterIDMapType &ClusterIDMap,
-                           unsigned N) {
-  // At this point module should have the proper mix of globals and locals.
-  // As we attempt to partition this module, we must not change any
-  // locals to globals.
-  LLVM_DEBUG(dbgs() << "Partition module with (" << M->size()
-                    << ")functions\n");
-  ClusterMapType GVtoClusterMap;
+// Group the global values of M that must not be separated: members of a
+// comdat, aliases and their aliasees, and locals and their users.
+static void findClusters(Module *M, ClusterMapType &GVtoClusterMap) {
   ComdatMembersType ComdatMembers;
 
   auto recordGVSet = [&GVtoClusterMap, &ComdatMembers](GlobalValue &GV) {
@@ -148,6 +146,21 @@ static void findPartitions(Module *M, ClusterIDMapType &ClusterIDMap,
   llvm::for_each(M->functions(), recordGVSet);
   llvm::for_each(M->globals(), recordGVSet);
   llvm::for_each(M->aliases(), recordGVSet);
+}
+
+// Find partitions for module in the way that no locals need to be
+// globalized.
+// Try to balance pack those partitions into N files since this roughly equals
+// thread balancing for the backend codegen step.
+static void findPartitions(Module *M, ClusterIDMapType &ClusterIDMap,
+                           unsigned N) {
+  // At this point module should have the proper mix of globals and locals.
+  // As we attempt to partition this module, we must not change any
+  // locals to globals.
+  LLVM_DEBUG(dbgs() << "Partition module with (" << M->size()
+                    << ")functions\n");
+  ClusterMapType GVtoClusterMap;
+  findClusters(M, GVtoClusterMap);
 
   // Assigned all GVs to merged clusters while balancing number of objects in
   // each.
@@ -213,6 +226,141 @@ static void findPartitions(Module *M, ClusterIDMapType &ClusterIDMap,
   }
 }
 
+// Estimated code generation cost of a global value.
+static uint64_t getCodeGenCost(const GlobalValue &GV) {
+  if (auto *F = dyn_cast<Function>(&GV))
+    return F->getInstructionCount() + 1;
+  return 1;
+}
+
+// Estimated execution count of the calls from Caller to Callee.
+static uint64_t getCallWeight(const Function &Caller, const Function &Callee) {
+  auto CallerCount = Caller.getEntryCount();
+  auto CalleeCount = Callee.getEntryCount();
+  if (!CallerCount.hasValue() || !CalleeCount.hasValue())
+    return 1;
+  return 1 + std::min(CallerCount.getCount(), CalleeCount.getCount());
+}
+
+// Assign every defined global value of the module to one of N partitions.
+// Clusters that must not be separated are merged along their hottest call
+// edges as long as the merged group stays close to the average partition cost,
+// then the groups are packed into the least loaded partitions, largest first.
+// This keeps hot call chains within one partition while balancing the
+// estimated instruction counts.
+static void findAffinityPartitions(Module *M, ClusterIDMapType &ClusterIDMap,
+                                   unsigned N) {
+  ClusterMapType GVtoClusterMap;
+  findClusters(M, GVtoClusterMap);
+
+  // Number the clusters in module order, so that the result is deterministic.
+  DenseMap<const GlobalValue *, unsigned> LeaderIDs;
+  std::vector<const GlobalValue *> Leaders;
+  std::vector<uint64_t> Costs;
+  auto getClusterID = [&](const GlobalValue *GV) {
+    const GlobalValue *Leader =
+        *GVtoClusterMap.findLeader(GVtoClusterMap.insert(GV));
+    auto Insert = LeaderIDs.insert({Leader, Leaders.size()});
+    if (Insert.second) {
+      Leaders.push_back(Leader);
+      Costs.push_back(0);
+    }
+    return Insert.first->second;
+  };
+
+  uint64_t TotalCost = 0;
+  for (GlobalValue &GV : M->global_values()) {
+    if (GV.isDeclaration())
+      continue;
+    uint64_t Cost = getCodeGenCost(GV);
+    Costs[getClusterID(&GV)] += Cost;
+    TotalCost += Cost;
+  }
+
+  DenseMap<std::pair<unsigned, unsigned>, uint64_t> EdgeWeights;
+  for (const Function &F : *M) {
+    if (F.isDeclaration())
+      continue;
+    unsigned CallerID = getClusterID(&F);
+    for (const BasicBlock &BB : F)
+      for (const Instruction &I : BB) {
+        ImmutableCallSite CS(&I);
+        if (!CS)
+          continue;
+        auto *Callee = dyn_cast<Function>(
+            CS.getCalledValue()->stripPointerCastsNoFollowAliases());
+        if (!Callee || Callee->isDeclaration())
+          continue;
+        unsigned CalleeID = getClusterID(Callee);
+        if (CallerID == CalleeID)
+          continue;
+        auto Key = std::make_pair(std::min(CallerID, CalleeID),
+                                  std::max(CallerID, CalleeID));
+        EdgeWeights[Key] += getCallWeight(F, *Callee);
+      }
+  }
+
+  using EdgeType = std::pair<std::pair<unsigned, unsigned>, uint64_t>;
+  std::vector<EdgeType> Edges(EdgeWeights.begin(), EdgeWeights.end());
+  llvm::sort(Edges, [](const EdgeType &A, const EdgeType &B) {
+    if (A.second != B.second)
+      return A.second > B.second;
+    return A.first < B.first;
+  });
+
+  // Merge clusters into groups along the hottest edges first.
+  EquivalenceClasses<unsigned> Groups;
+  for (unsigned I = 0, E = Leaders.size(); I != E; ++I)
+    Groups.insert(I);
+  std::vector<uint64_t> GroupCosts = Costs;
+  // Allow groups somewhat above the average partition cost, so that a hot
+  // pair is not separated only because the average is not a multiple of it.
+  uint64_t MaxGroupCost = (TotalCost * 5 + 4 * N - 1) / (4 * N);
+  for (const EdgeType &Edge : Edges) {
+    unsigned A = Groups.getLeaderValue(Edge.first.first);
+    unsigned B = Groups.getLeaderValue(Edge.first.second);
+    if (A == B || GroupCosts[A] + GroupCosts[B] > MaxGroupCost)
+      continue;
+    uint64_t Cost = GroupCosts[A] + GroupCosts[B];
+    unsigned Leader = *Groups.unionSets(A, B);
+    GroupCosts[Leader] = Cost;
+    LLVM_DEBUG(dbgs() << "Merge " << Leaders[A]->getName() << " and "
+                      << Leaders[B]->getName() << " (weight " << Edge.second
+                      << ", cost " << Cost << ")\n");
+  }
+
+  // Pack the groups into partitions, largest first.
+  std::vector<unsigned> GroupLeaders;
+  for (unsigned I = 0, E = Leaders.size(); I != E; ++I)
+    if (Groups.getLeaderValue(I) == I)
+      GroupLeaders.push_back(I);
+  llvm::sort(GroupLeaders, [&](unsigned A, unsigned B) {
+    if (GroupCosts[A] != GroupCosts[B])
+      return GroupCosts[A] > GroupCosts[B];
+    return A < B;
+  });
+
+  using LoadType = std::pair<uint64_t, unsigned>;
+  std::priority_queue<LoadType, std::vector<LoadType>, std::greater<LoadType>>
+      Loads;
+  for (unsigned I = 0; I < N; ++I)
+    Loads.push({0, I});
+  std::vector<unsigned> GroupPartition(Leaders.size());
+  for (unsigned G : GroupLeaders) {
+    LoadType Load = Loads.top();
+    Loads.pop();
+    GroupPartition[G] = Load.second;
+    Loads.push({Load.first + GroupCosts[G], Load.second});
+  }
+
+  for (GlobalValue &GV : M->global_values()) {
+    if (GV.isDeclaration())
+      continue;
+    unsigned Group = Groups.getLeaderValue(getClusterID(&GV));
+    ClusterIDMap[&GV] = GroupPartition[Group];
+  }
+}
+
 static void externalize(GlobalValue *GV) {
   if (GV->hasLocalLinkage()) {
     GV->setLinkage(GlobalValue::ExternalLinkage);
@@ -265,7 +413,10 @@ void llvm::SplitModule(
   // This performs splitting without a need for externalization, which might not
   // always be possible.
   ClusterIDMapType ClusterIDMap;
-  findPartitions(M.get(), ClusterIDMap, N);
+  if (SplitByCallAffinity)
+    findAffinityPartitions(M.get(), ClusterIDMap, N);
+  else
+    findPartitions(M.get(), ClusterIDMap, N);
 
   // FIXME: We should be able to reuse M as the last partition instead of
   // cloning it.
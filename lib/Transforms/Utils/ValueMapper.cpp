@@ -19,6 +19,7 @@
 #include "llvm/ADT/None.h"
 #include "llvm/ADT/Optional.h"
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SetVector.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/IR/Argument.h"
 #include "llvm/IR/BasicBlock.h"
@@ -119,6 +120,7 @@ class Mapper {
   SmallVector<WorklistEntry, 4> Worklist;
   SmallVector<DelayedBasicBlock, 1> DelayedBBs;
   SmallVector<Constant *, 16> AppendingInits;
+  SmallSetVector<Constant *, 2> StaleAppendingInits;
 
 public:
   Mapper(ValueToValueMapTy &VM, RemapFlags Flags,
@@ -845,6 +847,8 @@ void Mapper::flush() {
                            E.AppendingGVIsOldCtorDtor,
                            makeArrayRef(AppendingInits).slice(PrefixSize));
       AppendingInits.resize(PrefixSize);
+      if (auto *Prefix = E.Data.AppendingGV.InitPrefix)
+        StaleAppendingInits.insert(Prefix);
       break;
     }
     case WorklistEntry::MapGlobalAliasee:
@@ -858,6 +862,14 @@ void Mapper::flush() {
   }
   CurrentMCID = 0;
 
+  // The initializer of an appending variable is replaced by a copy with the
+  // new members every time a module is linked in. Drop the previous arrays,
+  // otherwise linking N modules keeps O(N^2) elements alive in the context.
+  for (Constant *C : StaleAppendingInits)
+    if (isa<ConstantArray>(C) && C->use_empty())
+      C->destroyConstant();
+  StaleAppendingInits.clear();
+
   // Finish logic for block addresses now that all global values have been
   // handled.
   while (!DelayedBBs.empty()) {
@@ -15,6 +15,7 @@
 // is a need (but D45420 needs to happen first).
 //
 #include "llvm/Transforms/Vectorize/LoopVectorizationLegality.h"
+#include "llvm/Analysis/Loads.h"
 #include "llvm/Analysis/VectorUtils.h"
 #include "llvm/IR/IntrinsicInst.h"
 
@@ -517,6 +518,16 @@ bool LoopVectorizationLegality::canVectorizeOuterLoop() {
       return false;
   }
 
+  // Check whether the instructions of the loop nest can be widened.
+  if (!canVectorizeOuterLoopInstrs()) {
+    LLVM_DEBUG(dbgs() << "LV: Not vectorizing: Unsupported instruction in the "
+                         "outer loop nest.\n");
+    if (DoExtraAnalysis)
+      Result = false;
+    else
+      return false;
+  }
+
   // Check whether we are able to set up outer loop induction.
   if (!setupOuterLoopInductions()) {
     LLVM_DEBUG(
@@ -532,6 +543,59 @@ bool LoopVectorizationLegality::canVectorizeOuterLoop() {
   return Result;
 }
 
+bool LoopVectorizationLegality::canVectorizeOuterLoopInstrs() {
+  // The VPlan-native path widens every instruction of the loop nest, so
+  // calls, memory accesses and types are checked as for inner loops. Memory
+  // dependences are not checked: outer loops are only vectorized when that
+  // is explicitly requested.
+  for (BasicBlock *BB : TheLoop->blocks()) {
+    for (Instruction &I : *BB) {
+      auto *CI = dyn_cast<CallInst>(&I);
+      if (CI && !getVectorIntrinsicIDForCall(CI, TLI) &&
+          !isa<DbgInfoIntrinsic>(CI) &&
+          !(CI->getCalledFunction() && TLI &&
+            TLI->isFunctionVectorizable(CI->getCalledFunction()->getName()))) {
+        ORE->emit(createMissedAnalysis("CantVectorizeCall", CI)
+                  << "call instruction cannot be vectorized");
+        LLVM_DEBUG(
+            dbgs() << "LV: Found a non-intrinsic, non-libfunc callsite.\n");
+        return false;
+      }
+
+      if ((isa<LoadInst>(I) && !cast<LoadInst>(I).isSimple()) ||
+          (isa<StoreInst>(I) && !cast<StoreInst>(I).isSimple()) ||
+          I.isAtomic()) {
+        ORE->emit(createMissedAnalysis("NonSimpleMemoryAccess", &I)
+                  << "volatile or atomic memory access cannot be vectorized");
+        LLVM_DEBUG(dbgs() << "LV: Found a non-simple memory access.\n");
+        return false;
+      }
+
+      Type *T = I.getType();
+      if (auto *SI = dyn_cast<StoreInst>(&I))
+        T = SI->getValueOperand()->getType();
+      if ((!VectorType::isValidElementType(T) && !T->isVoidTy()) ||
+          isa<ExtractElementInst>(I)) {
+        ORE->emit(createMissedAnalysis("CantVectorizeInstructionReturnType", &I)
+                  << "instruction return type cannot be vectorized");
+        LLVM_DEBUG(dbgs() << "LV: Found unvectorizable type.\n");
+        return false;
+      }
+
+      // Live-out values of the outer loop are not supported yet.
+      if (!isa<PHINode>(I) && any_of(I.users(), [&](User *U) {
+            return !TheLoop->contains(cast<Instruction>(U));
+          })) {
+        ORE->emit(createMissedAnalysis("ValueUsedOutsideLoop", &I)
+                  << "value cannot be used outside the loop");
+        LLVM_DEBUG(dbgs() << "LV: Found an outer loop live-out.\n");
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
 void LoopVectorizationLegality::addInductionPhi(
     PHINode *Phi, const InductionDescriptor &ID,
     SmallPtrSetImpl<Value *> &AllowedExit) {
@@ -1134,7 +1198,44 @@ bool LoopVectorizationLegality::canVectorize(bool UseVPlanNativePath) {
   return Result;
 }
 
-bool LoopVectorizationLegality::canFoldTailByMasking() {
+void LoopVectorizationLegality::collectPaddedSafePointers(
+    uint64_t NumIterations, SmallPtrSetImpl<Value *> &SafePointers) {
+  BasicBlock *Preheader = TheLoop->getLoopPreheader();
+  if (!Preheader)
+    return;
+  const DataLayout &DL = Preheader->getModule()->getDataLayout();
+  for (BasicBlock *BB : TheLoop->blocks())
+    for (Instruction &I : *BB) {
+      auto *LI = dyn_cast<LoadInst>(&I);
+      if (!LI || !LI->isSimple())
+        continue;
+      Value *Ptr = LI->getPointerOperand();
+      if (isConsecutivePtr(Ptr) != 1)
+        continue;
+      // The accessed range starts at the address of the first iteration,
+      // which must be loop invariant.
+      auto *AR = dyn_cast<SCEVAddRecExpr>(PSE.getSCEV(Ptr));
+      if (!AR || AR->getLoop() != TheLoop)
+        continue;
+      auto *Start = dyn_cast<SCEVUnknown>(AR->getStart());
+      if (!Start)
+        continue;
+      Type *Ty = LI->getType();
+      unsigned Align = LI->getAlignment();
+      if (!Align)
+        Align = DL.getABITypeAlignment(Ty);
+      APInt Size(DL.getIndexTypeSizeInBits(Ptr->getType()),
+                 NumIterations * DL.getTypeAllocSize(Ty));
+      if (isDereferenceableAndAlignedPointer(Start->getValue(), Align, Size, DL,
+                                             Preheader->getTerminator(), DT)) {
+        LLVM_DEBUG(dbgs() << "LV: Load can be padded: " << *LI << '\n');
+        SafePointers.insert(Ptr);
+      }
+    }
+}
+
+bool LoopVectorizationLegality::canFoldTailByMasking(
+    SmallPtrSetImpl<Value *> &SafePointers) {
 
   LLVM_DEBUG(dbgs() << "LV: checking if tail can be folded by masking.\n");
 
@@ -1171,9 +1272,6 @@ bool LoopVectorizationLegality::canFoldTailByMasking() {
     }
   }
 
-  // The list of pointers that we can safely read and write to remains empty.
-  SmallPtrSet<Value *, 8> SafePointers;
-
   // Check and mark all blocks for predication, including those that ordinarily
   // do not need predication such as the header block.
   for (BasicBlock *BB : TheLoop->blocks()) {
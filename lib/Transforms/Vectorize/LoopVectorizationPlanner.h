@@ -222,8 +222,10 @@ public:
                            LoopVectorizationCostModel &CM)
       : OrigLoop(L), LI(LI), TLI(TLI), TTI(TTI), Legal(Legal), CM(CM) {}
 
-  /// Plan how to best vectorize, return the best VF and its cost.
-  VectorizationFactor plan(bool OptForSize, unsigned UserVF);
+  /// Plan how to best vectorize, return the best VF and its cost. If
+  /// \p MaxVFLimit is not zero, no VF above it is considered.
+  VectorizationFactor plan(bool OptForSize, unsigned UserVF,
+                           unsigned MaxVFLimit = 0);
 
   /// Use the VPlan-native path to plan how to best vectorize, return the best
   /// VF and its cost.
@@ -260,6 +262,11 @@ protected:
   void buildVPlans(unsigned MinVF, unsigned MaxVF);
 
 private:
+  /// Select the VF of an outer loop without a user VF in the VPlan-native
+  /// path. Returns 1 if vectorizing the loop is not expected to be
+  /// profitable.
+  unsigned selectOuterLoopVF(bool OptForSize);
+
   /// Build a VPlan according to the information gathered by Legal. \return a
   /// VPlan for vectorization factors \p Range.Start and up to \p Range.End
   /// exclusive, possibly decreasing \p Range.End.
@@ -228,6 +228,22 @@ static cl::opt<bool> LoopVectorizeWithBlockFrequency(
              "aggressive in hot regions."));
 
 // Runtime interleave loops for load/store throughput.
+static cl::opt<bool> VectorizeEpilogues(
+    "vectorize-epilogues", cl::init(false), cl::Hidden,
+    cl::desc("Vectorize the remainder loops of vectorized loops at a smaller "
+             "VF."));
+
+static cl::opt<unsigned> EpilogueVectorizationMinVF(
+    "epilogue-vectorization-min-vf", cl::init(16), cl::Hidden,
+    cl::desc("Only vectorize the remainder of loops that are vectorized with "
+             "at least this VF times interleave count."));
+
+static cl::opt<bool> VectorizePaddedTailLoads(
+    "vectorize-padded-tail-loads", cl::init(false), cl::Hidden,
+    cl::desc("When folding the tail by masking, widen loads that are known "
+             "to be dereferenceable up to the padded trip count without a "
+             "mask."));
+
 static cl::opt<bool> EnableLoadStoreRuntimeInterleave(
     "enable-loadstore-runtime-interleave", cl::init(true), cl::Hidden,
     cl::desc(
@@ -260,6 +276,13 @@ cl::opt<bool> EnableVPlanNativePath(
 // VPlan-native vectorization path. It must be used in conjuction with
 // -enable-vplan-native-path. -vplan-verify-hcfg can also be used to enable the
 // verification of the H-CFGs built.
+// This flag lets the VPlan-native path select the VF of outer loops that are
+// explicitly marked for vectorization without a vector width.
+static cl::opt<bool> VPlanOuterLoopSelectVF(
+    "vplan-outer-loop-select-vf", cl::init(false), cl::Hidden,
+    cl::desc("Select the VF of outer loops without a user vector width in the "
+             "VPlan-native vectorization path."));
+
 static cl::opt<bool> VPlanBuildStressTest(
     "vplan-build-stress-test", cl::init(false), cl::Hidden,
     cl::desc(
@@ -1365,7 +1388,7 @@ static bool isExplicitVecOuterLoop(Loop *OuterLp,
     return false;
   }
 
-  if (!Hints.getWidth()) {
+  if (!Hints.getWidth() && !VPlanOuterLoopSelectVF) {
     LLVM_DEBUG(dbgs() << "LV: Not vectorizing: No user vector width.\n");
     Hints.emitRemarkWithHints();
     return false;
@@ -4698,7 +4721,12 @@ Optional<unsigned> LoopVectorizationCostModel::computeMaxVF(bool OptForSize) {
   // found modulo the vectorization factor is not zero, try to fold the tail
   // by masking.
   // FIXME: look for a smaller MaxVF that does divide TC rather than masking.
-  if (Legal->canFoldTailByMasking()) {
+  // Loads that stay in bounds for the padded trip count are widened without
+  // a mask, which saves scalarizing them on targets without masked loads.
+  SmallPtrSet<Value *, 8> SafePointers;
+  if (VectorizePaddedTailLoads && TC > 0)
+    Legal->collectPaddedSafePointers(alignTo(TC, MaxVF), SafePointers);
+  if (Legal->canFoldTailByMasking(SafePointers)) {
     FoldTailByMasking = true;
     return MaxVF;
   }
@@ -6077,9 +6105,17 @@ LoopVectorizationPlanner::planInVPlanNativePath(bool OptForSize,
       UserVF = 4;
 
     assert(EnableVPlanNativePath && "VPlan-native path is not enabled.");
-    assert(UserVF && "Expected UserVF for outer loop vectorization.");
+    if (!UserVF) {
+      assert(VPlanOuterLoopSelectVF && "Expected UserVF for outer loop "
+                                       "vectorization.");
+      UserVF = selectOuterLoopVF(OptForSize);
+      if (UserVF == 1)
+        return NoVectorization;
+      LLVM_DEBUG(dbgs() << "LV: Selected outer loop VF " << UserVF << ".\n");
+    } else {
+      LLVM_DEBUG(dbgs() << "LV: Using user VF " << UserVF << ".\n");
+    }
     assert(isPowerOf2_32(UserVF) && "VF needs to be a power of two");
-    LLVM_DEBUG(dbgs() << "LV: Using user VF " << UserVF << ".\n");
     buildVPlans(UserVF, UserVF);
 
     // For VPlan build stress testing, we bail out after VPlan construction.
@@ -6095,8 +6131,54 @@ LoopVectorizationPlanner::planInVPlanNativePath(bool OptForSize,
   return NoVectorization;
 }
 
+unsigned LoopVectorizationPlanner::selectOuterLoopVF(bool OptForSize) {
+  if (OptForSize) {
+    LLVM_DEBUG(dbgs() << "LV: Not vectorizing outer loop: Optimizing for "
+                         "size.\n");
+    return 1;
+  }
+
+  // The VPlan-native path widens every memory access of the loop nest into a
+  // gather or a scatter. Only vectorize if these are legal at the selected
+  // VF, so that they are not scalarized again, and size the VF by the widest
+  // accessed type.
+  const DataLayout &DL = OrigLoop->getHeader()->getModule()->getDataLayout();
+  unsigned WidestType = 0;
+  for (BasicBlock *BB : OrigLoop->blocks())
+    for (Instruction &I : *BB)
+      if (isa<LoadInst>(I) || isa<StoreInst>(I))
+        WidestType = std::max<unsigned>(
+            WidestType, DL.getTypeSizeInBits(getMemInstValueType(&I)));
+  if (!WidestType) {
+    LLVM_DEBUG(dbgs() << "LV: Not vectorizing outer loop: No memory "
+                         "accesses.\n");
+    return 1;
+  }
+
+  unsigned VF = PowerOf2Floor(TTI->getRegisterBitWidth(true) / WidestType);
+  for (; VF > 1; VF /= 2) {
+    bool Legal = true;
+    for (BasicBlock *BB : OrigLoop->blocks())
+      for (Instruction &I : *BB) {
+        if (!isa<LoadInst>(I) && !isa<StoreInst>(I))
+          continue;
+        Type *VecTy = VectorType::get(getMemInstValueType(&I), VF);
+        if (isa<LoadInst>(I) ? !TTI->isLegalMaskedGather(VecTy)
+                             : !TTI->isLegalMaskedScatter(VecTy))
+          Legal = false;
+      }
+    if (Legal)
+      break;
+  }
+  if (VF == 1)
+    LLVM_DEBUG(dbgs() << "LV: Not vectorizing outer loop: Gathers and "
+                         "scatters are not legal.\n");
+  return VF;
+}
+
 VectorizationFactor
-LoopVectorizationPlanner::plan(bool OptForSize, unsigned UserVF) {
+LoopVectorizationPlanner::plan(bool OptForSize, unsigned UserVF,
+                               unsigned MaxVFLimit) {
   assert(OrigLoop->empty() && "Inner loop expected.");
   // Width 1 means no vectorization, cost 0 means uncomputed cost.
   const VectorizationFactor NoVectorization = {1U, 0U};
@@ -6127,6 +6209,8 @@ LoopVectorizationPlanner::plan(bool OptForSize, unsigned UserVF) {
 
   unsigned MaxVF = MaybeMaxVF.getValue();
   assert(MaxVF != 0 && "MaxVF is zero.");
+  if (MaxVFLimit)
+    MaxVF = std::min(MaxVF, MaxVFLimit);
 
   for (unsigned VF = 1; VF <= MaxVF; VF *= 2) {
     // Collect Uniform and Scalar instructions after vectorization with VF.
@@ -7114,12 +7198,12 @@ static bool processLoopInVPlanNativePath(
 
   // If we are stress testing VPlan builds, do not attempt to generate vector
   // code.
-  if (VPlanBuildStressTest)
+  if (VPlanBuildStressTest || VF.Width == 1)
     return false;
 
   LVP.setBestPlan(VF.Width, 1);
 
-  InnerLoopVectorizer LB(L, PSE, LI, DT, TLI, TTI, AC, ORE, UserVF, 1, LVL,
+  InnerLoopVectorizer LB(L, PSE, LI, DT, TLI, TTI, AC, ORE, VF.Width, 1, LVL,
                          &CM);
   LLVM_DEBUG(dbgs() << "Vectorizing outer loop in \""
                     << L->getHeader()->getParent()->getName() << "\"\n");
@@ -7175,10 +7259,32 @@ bool LoopVectorizePass::processLoop(Loop *L) {
 
   PredicatedScalarEvolution PSE(*SE, *L);
 
+  // Check whether this is the remainder loop of a vectorized loop, queued to
+  // vectorize the epilogue.
+  unsigned MaxEpilogueVF = 0;
+  auto EpilogueIt = EpilogueMaxVF.find(L);
+  if (EpilogueIt != EpilogueMaxVF.end()) {
+    MaxEpilogueVF = EpilogueIt->second;
+    EpilogueMaxVF.erase(EpilogueIt);
+    LLVM_DEBUG(dbgs() << "LV: Vectorizing the epilogue with VF up to "
+                      << MaxEpilogueVF << ".\n");
+  }
+
+  // The cached access info of a vectorized loop describes its accesses before
+  // vectorization, so its remainder loop is analyzed again.
+  std::unique_ptr<LoopAccessInfo> EpilogueLAI;
+  std::function<const LoopAccessInfo &(Loop &)> GetEpilogueLAA =
+      [&](Loop &RemainderL) -> const LoopAccessInfo & {
+    EpilogueLAI =
+        llvm::make_unique<LoopAccessInfo>(&RemainderL, SE, TLI, AA, DT, LI);
+    return *EpilogueLAI;
+  };
+
   // Check if it is legal to vectorize the loop.
   LoopVectorizationRequirements Requirements(*ORE);
-  LoopVectorizationLegality LVL(L, PSE, DT, TLI, AA, F, GetLAA, LI, ORE,
-                                &Requirements, &Hints, DB, AC);
+  LoopVectorizationLegality LVL(L, PSE, DT, TLI, AA, F,
+                                MaxEpilogueVF ? &GetEpilogueLAA : GetLAA, LI,
+                                ORE, &Requirements, &Hints, DB, AC);
   if (!LVL.canVectorize(EnableVPlanNativePath)) {
     LLVM_DEBUG(dbgs() << "LV: Not vectorizing: Cannot prove legality.\n");
     Hints.emitRemarkWithHints();
@@ -7297,10 +7403,20 @@ bool LoopVectorizePass::processLoop(Loop *L) {
   unsigned UserVF = Hints.getWidth();
 
   // Plan how to best vectorize, return the best VF and its cost.
-  VectorizationFactor VF = LVP.plan(OptForSize, UserVF);
+  VectorizationFactor VF = LVP.plan(OptForSize, UserVF, MaxEpilogueVF);
+
+  // Epilogues are only vectorized, not interleaved.
+  if (MaxEpilogueVF && VF.Width == 1) {
+    LLVM_DEBUG(dbgs() << "LV: Not vectorizing the epilogue: Vectorization is "
+                         "not beneficial.\n");
+    Hints.setAlreadyVectorized();
+    return false;
+  }
 
   // Select the interleave count.
-  unsigned IC = CM.selectInterleaveCount(OptForSize, VF.Width, VF.Cost);
+  unsigned IC = MaxEpilogueVF
+                    ? 1
+                    : CM.selectInterleaveCount(OptForSize, VF.Width, VF.Cost);
 
   // Get user interleave count.
   unsigned UserIC = Hints.getInterleave();
@@ -7433,6 +7549,12 @@ bool LoopVectorizePass::processLoop(Loop *L) {
                                       LLVMLoopVectorizeFollowupEpilogue});
   if (RemainderLoopID.hasValue()) {
     L->setLoopID(RemainderLoopID.getValue());
+  } else if (VectorizeEpilogues && VectorizeLoop && !MaxEpilogueVF &&
+             !UserVF && !CM.foldTailByMasking() && VF.Width >= 4 &&
+             VF.Width * IC >= EpilogueVectorizationMinVF) {
+    // Leave the remainder loop unmarked, so that it can be vectorized again
+    // at a smaller VF with its own minimum iteration check.
+    EpilogueMaxVF[L] = VF.Width / 2;
   } else {
     if (DisableRuntimeUnroll)
       AddRuntimeUnrollDisableMetaData(L);
@@ -7502,7 +7624,15 @@ bool LoopVectorizePass::runImpl(
     Changed |= formLCSSARecursively(*L, *DT, LI, SE);
 
     Changed |= processLoop(L);
+
+    // The vectorized loop exits to the exit block of its remainder loop, so
+    // the remainder loop needs dedicated exits again before it is processed.
+    if (EpilogueMaxVF.count(L)) {
+      simplifyLoop(L, DT, LI, SE, AC, false /* PreserveLCSSA */);
+      Worklist.push_back(L);
+    }
   }
+  EpilogueMaxVF.clear();
 
   // Process each loop nest in the function.
   return Changed;
@@ -144,6 +144,16 @@ static cl::opt<unsigned> MinTreeSize(
     "slp-min-tree-size", cl::init(3), cl::Hidden,
     cl::desc("Only vectorize small trees if they are fully vectorizable"));
 
+static cl::opt<bool> CrossBlockReductions(
+    "slp-cross-block-reductions", cl::init(false), cl::Hidden,
+    cl::desc("Match horizontal reductions whose operations are placed in "
+             "blocks dominating the reduction root in the same loop"));
+
+static cl::opt<bool> MixedReducedValues(
+    "slp-mixed-reduced-values", cl::init(false), cl::Hidden,
+    cl::desc("Allow the reduced values of a horizontal reduction to be "
+             "binary operations with different opcodes"));
+
 static cl::opt<bool>
     ViewSLPTree("view-slp-tree", cl::Hidden,
                 cl::desc("Display the SLP trees with Graphviz"));
@@ -5225,16 +5235,18 @@ class HorizontalReduction {
       llvm_unreachable("Reduction kind is not set");
     }
 
-    /// Checks if the operation has the same parent as \p P.
-    bool hasSameParent(Instruction *I, Value *P, bool IsRedOp) const {
+    /// Checks if the operation is placed in a block accepted by \p IsValid.
+    bool hasValidParent(Instruction *I,
+                        function_ref<bool(const BasicBlock *)> IsValid,
+                        bool IsRedOp) const {
       assert(Kind != RK_None && !!*this && LHS && RHS &&
              "Expected reduction operation.");
       if (!IsRedOp)
-        return I->getParent() == P;
+        return IsValid(I->getParent());
       switch (Kind) {
       case RK_Arithmetic:
         // Arithmetic reduction operation must be used once only.
-        return I->getParent() == P;
+        return IsValid(I->getParent());
       case RK_Min:
       case RK_UMin:
       case RK_Max:
@@ -5242,7 +5254,7 @@ class HorizontalReduction {
         // SelectInst must be used twice while the condition op must have single
         // use only.
         auto *Cmp = cast<Instruction>(cast<SelectInst>(I)->getCondition());
-        return I->getParent() == P && Cmp && Cmp->getParent() == P;
+        return IsValid(I->getParent()) && Cmp && IsValid(Cmp->getParent());
       }
       case RK_None:
         break;
@@ -5597,7 +5609,13 @@ public:
   HorizontalReduction() = default;
 
   /// Try to find a reduction tree.
-  bool matchAssociativeReduction(PHINode *Phi, Instruction *B) {
+  /// If \p DT and \p LI are provided, the reduction operations and reduced
+  /// values may also be placed in blocks that dominate the block of \p B and
+  /// belong to the same loop, so that the vectorized reduction at \p B
+  /// computes the same value with the same trip count.
+  bool matchAssociativeReduction(PHINode *Phi, Instruction *B,
+                                 const DominatorTree *DT = nullptr,
+                                 const LoopInfo *LI = nullptr) {
     assert((!Phi || is_contained(Phi->operands(), B)) &&
            "Thi phi needs to use the binary operator");
 
@@ -5630,6 +5648,23 @@ public:
     ReducedValueData.clear();
     ReductionRoot = B;
 
+    const BasicBlock *RootBB = B->getParent();
+    auto IsValidParent = [RootBB, DT, LI](const BasicBlock *BB) {
+      if (BB == RootBB)
+        return true;
+      return DT && LI && DT->dominates(BB, RootBB) &&
+             LI->getLoopFor(BB) == LI->getLoopFor(RootBB);
+    };
+    // Reduced values are binary operations that may differ from the first
+    // one found if mixed reduced values are allowed. The tree builder then
+    // vectorizes them as alternate operations or gathers them.
+    auto IsCompatibleReducedValue = [this](const OperationData &OpData) {
+      if (!ReducedValueData || ReducedValueData == OpData)
+        return true;
+      return MixedReducedValues && OpData.getKind() == RK_Arithmetic &&
+             ReducedValueData.getKind() == RK_Arithmetic;
+    };
+
     // Post order traverse the reduction tree starting at B. We only handle true
     // trees containing only binary operators.
     SmallVector<std::pair<Instruction *, unsigned>, 32> Stack;
@@ -5676,12 +5711,13 @@ public:
         // (possibly) a reduced value. If the reduced value opcode is not set,
         // the first met operation != reduction operation is considered as the
         // reduced value class.
-        if (I && (!ReducedValueData || OpData == ReducedValueData ||
+        if (I && (IsCompatibleReducedValue(OpData) ||
                   OpData == ReductionData)) {
           const bool IsReductionOperation = OpData == ReductionData;
-          // Only handle trees in the current basic block.
-          if (!ReductionData.hasSameParent(I, B->getParent(),
-                                           IsReductionOperation)) {
+          // Only handle trees in the current basic block, or in the blocks
+          // dominating it if cross-block reductions are allowed.
+          if (!ReductionData.hasValidParent(I, IsValidParent,
+                                            IsReductionOperation)) {
             // I is an extra argument for TreeN (its parent operation).
             markExtraArg(Stack.back(), I);
             continue;
@@ -5704,8 +5740,7 @@ public:
               markExtraArg(Stack.back(), I);
               continue;
             }
-          } else if (ReducedValueData &&
-                     ReducedValueData != OpData) {
+          } else if (!IsCompatibleReducedValue(OpData)) {
             // Make sure that the opcodes of the operations that we are going to
             // reduce match.
             // I is an extra argument for TreeN (its parent operation).
@@ -6077,7 +6112,7 @@ static Value *getReductionValue(const DominatorTree *DT, PHINode *P,
 /// performed.
 static bool tryToVectorizeHorReductionOrInstOperands(
     PHINode *P, Instruction *Root, BasicBlock *BB, BoUpSLP &R,
-    TargetTransformInfo *TTI,
+    TargetTransformInfo *TTI, const DominatorTree *DT, const LoopInfo *LI,
     const function_ref<bool(Instruction *, BoUpSLP &)> Vectorize) {
   if (!ShouldVectorizeHor)
     return false;
@@ -6112,7 +6147,10 @@ static bool tryToVectorizeHorReductionOrInstOperands(
     auto *SI = dyn_cast<SelectInst>(Inst);
     if (BI || SI) {
       HorizontalReduction HorRdx;
-      if (HorRdx.matchAssociativeReduction(P, Inst)) {
+      bool Matched = CrossBlockReductions
+                         ? HorRdx.matchAssociativeReduction(P, Inst, DT, LI)
+                         : HorRdx.matchAssociativeReduction(P, Inst);
+      if (Matched) {
         if (HorRdx.tryToReduce(R, TTI)) {
           Res = true;
           // Set P to nullptr to avoid re-analysis of phi node in
@@ -6169,7 +6207,7 @@ bool SLPVectorizerPass::vectorizeRootInstruction(PHINode *P, Value *V,
   auto &&ExtraVectorization = [this](Instruction *I, BoUpSLP &R) -> bool {
     return tryToVectorize(I, R);
   };
-  return tryToVectorizeHorReductionOrInstOperands(P, I, BB, R, TTI,
+  return tryToVectorizeHorReductionOrInstOperands(P, I, BB, R, TTI, DT, LI,
                                                   ExtraVectorization);
 }
 
@@ -30,8 +30,7 @@ Profile::Profile(const Profile &O) {
     Blocks.push_back({Block.Thread, {}});
     auto &B = Blocks.back();
     for (const auto &PathData : Block.PathData)
-      B.PathData.push_back({internPath(cantFail(O.expandPath(PathData.first))),
-                            PathData.second});
+      B.PathData.push_back({internPath(O, PathData.first), PathData.second});
   }
 }
 
@@ -130,95 +129,100 @@ Error Profile::addBlock(Block &&B) {
 }
 
 Expected<std::vector<Profile::FuncID>> Profile::expandPath(PathID P) const {
-  auto It = PathIDMap.find(P);
-  if (It == PathIDMap.end())
+  if (P == 0 || P > PathNodes.size())
     return make_error<StringError>(
         Twine("PathID not found: ") + Twine(P),
         std::make_error_code(std::errc::invalid_argument));
   std::vector<Profile::FuncID> Path;
-  for (auto Node = It->second; Node; Node = Node->Caller)
+  for (auto Node = PathNodes[P - 1]; Node; Node = Node->Caller)
     Path.push_back(Node->Func);
   return std::move(Path);
 }
 
+Profile::TrieNode *Profile::getNode(TrieNode *Caller, FuncID Func) {
+  auto &Node = Nodes[{Caller, Func}];
+  if (!Node)
+    Node = new (NodeAllocator.Allocate<TrieNode>()) TrieNode{Func, Caller, 0};
+  return Node;
+}
+
 Profile::PathID Profile::internPath(ArrayRef<FuncID> P) {
   if (P.empty())
     return 0;
 
-  auto RootToLeafPath = reverse(P);
-
-  // Find the root.
-  auto It = RootToLeafPath.begin();
-  auto PathRoot = *It++;
-  auto RootIt =
-      find_if(Roots, [PathRoot](TrieNode *N) { return N->Func == PathRoot; });
-
-  // If we've not seen this root before, remember it.
+  // Traverse the path from the root, re-creating nodes if necessary.
   TrieNode *Node = nullptr;
-  if (RootIt == Roots.end()) {
-    NodeStorage.emplace_back();
-    Node = &NodeStorage.back();
-    Node->Func = PathRoot;
-    Roots.push_back(Node);
-  } else {
-    Node = *RootIt;
-  }
-
-  // Now traverse the path, re-creating if necessary.
-  while (It != RootToLeafPath.end()) {
-    auto NodeFuncID = *It++;
-    auto CalleeIt = find_if(Node->Callees, [NodeFuncID](TrieNode *N) {
-      return N->Func == NodeFuncID;
-    });
-    if (CalleeIt == Node->Callees.end()) {
-      NodeStorage.emplace_back();
-      auto NewNode = &NodeStorage.back();
-      NewNode->Func = NodeFuncID;
-      NewNode->Caller = Node;
-      Node->Callees.push_back(NewNode);
-      Node = NewNode;
-    } else {
-      Node = *CalleeIt;
-    }
-  }
+  for (auto Func : reverse(P))
+    Node = getNode(Node, Func);
 
   // At this point, Node *must* be pointing at the leaf.
   assert(Node->Func == P.front());
   if (Node->ID == 0) {
-    Node->ID = NextID++;
-    PathIDMap.insert({Node->ID, Node});
+    PathNodes.push_back(Node);
+    Node->ID = PathNodes.size();
   }
   return Node->ID;
 }
 
-Profile mergeProfilesByThread(const Profile &L, const Profile &R) {
+Profile::PathID Profile::internPath(const Profile &O, PathID P) {
+  assert(P != 0 && P <= O.PathNodes.size() && "PathID not found");
+  SmallVector<FuncID, 16> Path;
+  for (auto Node = O.PathNodes[P - 1]; Node; Node = Node->Caller)
+    Path.push_back(Node->Func);
+  return internPath(Path);
+}
+
+namespace {
+
+using PathDataMap = DenseMap<Profile::PathID, Profile::Data>;
+using PathDataVector = decltype(Profile::Block::PathData);
+
+// Interns the paths of every profile in |Profiles| into |Merged|, and calls
+// |Callback| with each block of the inputs and each of its path data entries
+// translated into |Merged|. Every path is only copied once per input profile,
+// however many of its blocks it appears in.
+template <class CallbackT>
+void mergePaths(Profile &Merged, ArrayRef<const Profile *> Profiles,
+                CallbackT Callback) {
+  DenseMap<Profile::PathID, Profile::PathID> PathMap;
+  for (const Profile *P : Profiles) {
+    PathMap.clear();
+    for (const auto &Block : *P)
+      for (const auto &PathAndData : Block.PathData) {
+        auto &NewPathID = PathMap[PathAndData.first];
+        if (NewPathID == 0)
+          NewPathID = Merged.internPath(*P, PathAndData.first);
+        Callback(Block, NewPathID, PathAndData.second);
+      }
+  }
+}
+
+void accumulate(PathDataMap &PathData, Profile::PathID PathID,
+                const Profile::Data &Data) {
+  PathDataMap::iterator PathDataIt;
+  bool Inserted;
+  std::tie(PathDataIt, Inserted) = PathData.insert({PathID, Data});
+  if (!Inserted) {
+    auto &ExistingData = PathDataIt->second;
+    ExistingData.CallCount += Data.CallCount;
+    ExistingData.CumulativeLocalTime += Data.CumulativeLocalTime;
+  }
+}
+
+Profile mergeByThread(ArrayRef<const Profile *> Profiles) {
   Profile Merged;
-  using PathDataMap = DenseMap<Profile::PathID, Profile::Data>;
   using PathDataMapPtr = std::unique_ptr<PathDataMap>;
-  using PathDataVector = decltype(Profile::Block::PathData);
   using ThreadProfileIndexMap = DenseMap<Profile::ThreadID, PathDataMapPtr>;
   ThreadProfileIndexMap ThreadProfileIndex;
 
-  for (const auto &P : {std::ref(L), std::ref(R)})
-    for (const auto &Block : P.get()) {
-      ThreadProfileIndexMap::iterator It;
-      std::tie(It, std::ignore) = ThreadProfileIndex.insert(
-          {Block.Thread, PathDataMapPtr{new PathDataMap()}});
-      for (const auto &PathAndData : Block.PathData) {
-        auto &PathID = PathAndData.first;
-        auto &Data = PathAndData.second;
-        auto NewPathID =
-            Merged.internPath(cantFail(P.get().expandPath(PathID)));
-        PathDataMap::iterator PathDataIt;
-        bool Inserted;
-        std::tie(PathDataIt, Inserted) = It->second->insert({NewPathID, Data});
-        if (!Inserted) {
-          auto &ExistingData = PathDataIt->second;
-          ExistingData.CallCount += Data.CallCount;
-          ExistingData.CumulativeLocalTime += Data.CumulativeLocalTime;
-        }
-      }
-    }
+  mergePaths(Merged, Profiles,
+             [&](const Profile::Block &Block, Profile::PathID PathID,
+                 const Profile::Data &Data) {
+               auto &PathData = ThreadProfileIndex[Block.Thread];
+               if (!PathData)
+                 PathData.reset(new PathDataMap());
+               accumulate(*PathData, PathID, Data);
+             });
 
   for (const auto &IndexedThreadBlock : ThreadProfileIndex) {
     PathDataVector PathAndData;
@@ -230,27 +234,14 @@ Profile mergeProfilesByThread(const Profile &L, const Profile &R) {
   return Merged;
 }
 
-Profile mergeProfilesByStack(const Profile &L, const Profile &R) {
+Profile mergeByStack(ArrayRef<const Profile *> Profiles) {
   Profile Merged;
-  using PathDataMap = DenseMap<Profile::PathID, Profile::Data>;
   PathDataMap PathData;
-  using PathDataVector = decltype(Profile::Block::PathData);
-  for (const auto &P : {std::ref(L), std::ref(R)})
-    for (const auto &Block : P.get())
-      for (const auto &PathAndData : Block.PathData) {
-        auto &PathId = PathAndData.first;
-        auto &Data = PathAndData.second;
-        auto NewPathID =
-            Merged.internPath(cantFail(P.get().expandPath(PathId)));
-        PathDataMap::iterator PathDataIt;
-        bool Inserted;
-        std::tie(PathDataIt, Inserted) = PathData.insert({NewPathID, Data});
-        if (!Inserted) {
-          auto &ExistingData = PathDataIt->second;
-          ExistingData.CallCount += Data.CallCount;
-          ExistingData.CumulativeLocalTime += Data.CumulativeLocalTime;
-        }
-      }
+  mergePaths(Merged, Profiles,
+             [&](const Profile::Block &, Profile::PathID PathID,
+                 const Profile::Data &Data) {
+               accumulate(PathData, PathID, Data);
+             });
 
   // In the end there's a single Block, for thread 0.
   PathDataVector Block;
@@ -260,6 +251,34 @@ Profile mergeProfilesByStack(const Profile &L, const Profile &R) {
   return Merged;
 }
 
+std::vector<const Profile *> getPointers(ArrayRef<Profile> Profiles) {
+  std::vector<const Profile *> Pointers;
+  Pointers.reserve(Profiles.size());
+  for (const auto &P : Profiles)
+    Pointers.push_back(&P);
+  return Pointers;
+}
+
+} // namespace
+
+Profile mergeProfilesByThread(const Profile &L, const Profile &R) {
+  const Profile *Profiles[] = {&L, &R};
+  return mergeByThread(Profiles);
+}
+
+Profile mergeProfilesByStack(const Profile &L, const Profile &R) {
+  const Profile *Profiles[] = {&L, &R};
+  return mergeByStack(Profiles);
+}
+
+Profile mergeAllProfilesByThread(ArrayRef<Profile> Profiles) {
+  return mergeByThread(getPointers(Profiles));
+}
+
+Profile mergeAllProfilesByStack(ArrayRef<Profile> Profiles) {
+  return mergeByStack(getPointers(Profiles));
+}
+
 Expected<Profile> loadProfile(StringRef Filename) {
   int Fd;
   if (auto EC = sys::fs::openFileForRead(Filename, Fd))
@@ -11,10 +11,13 @@
 //
 //===----------------------------------------------------------------------===//
 #include "llvm/XRay/Trace.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/Optional.h"
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/Support/DataExtractor.h"
 #include "llvm/Support/Error.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/ThreadPool.h"
 #include "llvm/XRay/BlockIndexer.h"
 #include "llvm/XRay/BlockVerifier.h"
 #include "llvm/XRay/FDRRecordConsumer.h"
@@ -23,7 +26,9 @@
 #include "llvm/XRay/FDRTraceExpander.h"
 #include "llvm/XRay/FileHeaderReader.h"
 #include "llvm/XRay/YAMLXRayRecord.h"
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <vector>
 
 using namespace llvm;
@@ -204,6 +209,20 @@ Error loadNaiveFormatLog(StringRef Data, bool IsLittleEndian,
   return Error::success();
 }
 
+// The location of a block in the log, and what we need to know to read it
+// again: the bytes left in the buffer where it starts, and its wallclock time
+// for sorting.
+struct BlockLocation {
+  uint64_t Begin;
+  uint64_t End;
+  uint32_t BufferBytes;
+  uint64_t Seconds;
+  uint32_t Nanos;
+};
+
+using BlockLocationIndex =
+    DenseMap<std::pair<uint64_t, int32_t>, std::vector<BlockLocation>>;
+
 /// Reads a log in FDR mode for version 1 of this binary format. FDR mode is
 /// defined as part of the compiler-rt project in xray_fdr_logging.h, and such
 /// a log consists of the familiar 32 bit XRayHeader, followed by sequences of
@@ -258,9 +277,14 @@ Error loadNaiveFormatLog(StringRef Data, bool IsLittleEndian,
 /// what FunctionRecord instances use, and we no longer need to include the CPU
 /// id in the CustomEventRecord.
 ///
-Error loadFDRLog(StringRef Data, bool IsLittleEndian,
-                 XRayFileHeader &FileHeader, std::vector<XRayRecord> &Records) {
-
+/// The log is read twice so that it never has to be held in memory. The first
+/// pass only remembers where each block starts and ends, grouped by process
+/// and thread like the BlockIndexer does. The second pass reads the blocks of
+/// each thread again in wallclock order, and verifies and expands their records
+/// one at a time. The threads are independent in the second pass, so it can
+/// expand several of them concurrently.
+Error indexFDRLog(StringRef Data, bool IsLittleEndian,
+                  XRayFileHeader &FileHeader, BlockLocationIndex &Index) {
   if (Data.size() < 32)
     return createStringError(std::make_error_code(std::errc::invalid_argument),
                              "Not enough bytes for an XRay FDR log.");
@@ -272,72 +296,187 @@ Error loadFDRLog(StringRef Data, bool IsLittleEndian,
     return FileHeaderOrError.takeError();
   FileHeader = std::move(FileHeaderOrError.get());
 
-  // First we load the records into memory.
-  std::vector<std::unique_ptr<Record>> FDRRecords;
+  // A block starts at each NewBuffer record, and ends where the next one
+  // starts. DataExtractor offsets are 32 bits, so we read through a window that
+  // we move forward as we go to support logs larger than 4GB.
+  uint64_t Base = 0;
+  Optional<DataExtractor> WindowDE;
+  Optional<FileBasedRecordProducer> P;
+  WindowDE.emplace(Data, IsLittleEndian, 8);
+  P.emplace(FileHeader, *WindowDE, OffsetPtr);
+
+  BlockLocation Current = {OffsetPtr, 0, 0, 0, 0};
+  uint64_t ProcessID = 0;
+  int32_t ThreadID = 0;
+  bool HasRecords = false;
+  auto AddBlock = [&](uint64_t End) {
+    Current.End = End;
+    Index[{ProcessID, ThreadID}].push_back(Current);
+  };
+
+  while (WindowDE->isValidOffsetForDataOfSize(OffsetPtr, 1)) {
+    uint64_t RecordBegin = Base + OffsetPtr;
+    uint32_t BufferBytes = P->currentBufferBytes();
+    auto R = P->produce();
+    if (!R)
+      return R.takeError();
+
+    if (auto *NB = dyn_cast<NewBufferRecord>(R->get())) {
+      if (HasRecords)
+        AddBlock(RecordBegin);
+      Current = {RecordBegin, 0, BufferBytes, 0, 0};
+      ProcessID = 0;
+      ThreadID = NB->tid();
+    } else if (auto *PR = dyn_cast<PIDRecord>(R->get())) {
+      ProcessID = PR->pid();
+    } else if (auto *WR = dyn_cast<WallclockRecord>(R->get())) {
+      Current.Seconds = WR->seconds();
+      Current.Nanos = WR->nanos();
+    } else if (isa<BufferExtents>(R->get())) {
+      // Buffer extents are not part of any block.
+      continue;
+    }
+    HasRecords = true;
+
+    if (OffsetPtr >= (1U << 30)) {
+      Base += OffsetPtr;
+      BufferBytes = P->currentBufferBytes();
+      OffsetPtr = 0;
+      P.reset();
+      WindowDE.emplace(Data.drop_front(Base), IsLittleEndian, 8);
+      P.emplace(FileHeader, *WindowDE, OffsetPtr, BufferBytes);
+    }
+  }
+  if (HasRecords)
+    AddBlock(Data.size());
+  return Error::success();
+}
 
-  {
-    FileBasedRecordProducer P(FileHeader, DE, OffsetPtr);
-    LogBuilderConsumer C(FDRRecords);
-    while (DE.isValidOffsetForDataOfSize(OffsetPtr, 1)) {
+// Expands the blocks of one process+thread pair, after sorting them by their
+// wallclock time.
+Error expandFDRBlocks(StringRef Data, bool IsLittleEndian,
+                      const XRayFileHeader &FileHeader,
+                      std::vector<BlockLocation> &Blocks,
+                      function_ref<Error(const XRayRecord &)> Callback) {
+  // Here we sort the blocks according to the Walltime record in each of the
+  // blocks for the same thread. This allows us to more consistently recreate
+  // the execution trace in temporal order. After the sort, we then read each
+  // block again, verify its consistency, and reconstitute `Trace` records using
+  // a stateful visitor associated with a single process+thread pair.
+  llvm::sort(Blocks, [](const BlockLocation &L, const BlockLocation &R) {
+    return (L.Seconds < R.Seconds && L.Nanos < R.Nanos);
+  });
+  Error CallbackErr = Error::success();
+  auto Adder = [&](const XRayRecord &R) {
+    if (!CallbackErr)
+      CallbackErr = Callback(R);
+  };
+  TraceExpander Expander(Adder, FileHeader.Version);
+  for (auto &B : Blocks) {
+    DataExtractor BlockDE(Data.slice(B.Begin, B.End), IsLittleEndian, 8);
+    uint32_t OffsetPtr = 0;
+    FileBasedRecordProducer P(FileHeader, BlockDE, OffsetPtr, B.BufferBytes);
+    BlockVerifier Verifier;
+    while (BlockDE.isValidOffsetForDataOfSize(OffsetPtr, 1)) {
       auto R = P.produce();
       if (!R)
-        return R.takeError();
-      if (auto E = C.consume(std::move(R.get())))
-        return E;
+        return joinErrors(std::move(CallbackErr), R.takeError());
+      if (isa<BufferExtents>(R->get()))
+        continue;
+      if (auto E = R.get()->apply(Verifier))
+        return joinErrors(std::move(CallbackErr), std::move(E));
+      if (auto E = R.get()->apply(Expander))
+        return joinErrors(std::move(CallbackErr), std::move(E));
+      if (CallbackErr)
+        return CallbackErr;
     }
+    if (auto E = Verifier.verify())
+      return joinErrors(std::move(CallbackErr), std::move(E));
   }
+  if (auto E = Expander.flush())
+    return joinErrors(std::move(CallbackErr), std::move(E));
+  return CallbackErr;
+}
 
-  // Next we index the records into blocks.
-  BlockIndexer::Index Index;
-  {
-    BlockIndexer Indexer(Index);
-    for (auto &R : FDRRecords)
-      if (auto E = R->apply(Indexer))
-        return E;
-    if (auto E = Indexer.flush())
+Error streamFDRLog(StringRef Data, bool IsLittleEndian,
+                   XRayFileHeader &FileHeader,
+                   function_ref<Error(const XRayRecord &)> Callback) {
+  BlockLocationIndex Index;
+  if (auto E = indexFDRLog(Data, IsLittleEndian, FileHeader, Index))
+    return E;
+  for (auto &PTB : Index)
+    if (auto E = expandFDRBlocks(Data, IsLittleEndian, FileHeader, PTB.second,
+                                 Callback))
       return E;
-  }
-
-  // Then we verify the consistency of the blocks.
-  {
-    for (auto &PTB : Index) {
-      auto &Blocks = PTB.second;
-      for (auto &B : Blocks) {
-        BlockVerifier Verifier;
-        for (auto *R : B.Records)
-          if (auto E = R->apply(Verifier))
-            return E;
-        if (auto E = Verifier.verify())
-          return E;
-      }
-    }
-  }
+  return Error::success();
+}
 
-  // This is now the meat of the algorithm. Here we sort the blocks according to
-  // the Walltime record in each of the blocks for the same thread. This allows
-  // us to more consistently recreate the execution trace in temporal order.
-  // After the sort, we then reconstitute `Trace` records using a stateful
-  // visitor associated with a single process+thread pair.
-  {
-    for (auto &PTB : Index) {
-      auto &Blocks = PTB.second;
-      llvm::sort(Blocks, [](const BlockIndexer::Block &L,
-                            const BlockIndexer::Block &R) {
-        return (L.WallclockTime->seconds() < R.WallclockTime->seconds() &&
-                L.WallclockTime->nanos() < R.WallclockTime->nanos());
-      });
-      auto Adder = [&](const XRayRecord &R) { Records.push_back(R); };
-      TraceExpander Expander(Adder, FileHeader.Version);
-      for (auto &B : Blocks) {
-        for (auto *R : B.Records)
-          if (auto E = R->apply(Expander))
-            return E;
+// Like streamFDRLog, but expands the process+thread pairs on \p Threads
+// workers. \p Callback is called with the position of the pair in the index,
+// and the worker expanding it. \p Start is called with the number of pairs
+// before any records are expanded.
+Error streamFDRLogInParallel(
+    StringRef Data, bool IsLittleEndian, XRayFileHeader &FileHeader,
+    unsigned Threads, function_ref<void(size_t)> Start,
+    function_ref<Error(size_t, unsigned, const XRayRecord &)> Callback) {
+  BlockLocationIndex Index;
+  if (auto E = indexFDRLog(Data, IsLittleEndian, FileHeader, Index))
+    return E;
+  std::vector<std::vector<BlockLocation> *> Groups;
+  for (auto &PTB : Index)
+    Groups.push_back(&PTB.second);
+  Start(Groups.size());
+
+  // Each worker takes the next pair until there are none left, or one of the
+  // workers failed.
+  std::atomic<size_t> NextGroup(0);
+  std::atomic<bool> Failed(false);
+  Error Result = Error::success();
+  std::mutex ResultMutex;
+  ThreadPool Pool(Threads);
+  for (unsigned Worker = 0; Worker != Threads; ++Worker)
+    Pool.async([&, Worker] {
+      while (!Failed) {
+        size_t Group = NextGroup++;
+        if (Group >= Groups.size())
+          break;
+        if (auto E = expandFDRBlocks(Data, IsLittleEndian, FileHeader,
+                                     *Groups[Group], [&](const XRayRecord &R) {
+                                       return Callback(Group, Worker, R);
+                                     })) {
+          Failed = true;
+          std::lock_guard<std::mutex> Lock(ResultMutex);
+          Result = joinErrors(std::move(Result), std::move(E));
+        }
       }
-      if (auto E = Expander.flush())
-        return E;
-    }
-  }
+    });
+  Pool.wait();
+  return Result;
+}
 
+Error loadFDRLog(StringRef Data, bool IsLittleEndian,
+                 XRayFileHeader &FileHeader, std::vector<XRayRecord> &Records,
+                 unsigned Threads) {
+  if (Threads <= 1)
+    return streamFDRLog(Data, IsLittleEndian, FileHeader,
+                        [&](const XRayRecord &R) {
+                          Records.push_back(R);
+                          return Error::success();
+                        });
+
+  // Expand each process+thread pair on its own, then put them together in the
+  // order of the serial expansion.
+  std::vector<std::vector<XRayRecord>> GroupRecords;
+  auto Start = [&](size_t NumGroups) { GroupRecords.resize(NumGroups); };
+  auto Adder = [&](size_t Group, unsigned, const XRayRecord &R) {
+    GroupRecords[Group].push_back(R);
+    return Error::success();
+  };
+  if (auto E = streamFDRLogInParallel(Data, IsLittleEndian, FileHeader,
+                                      Threads, Start, Adder))
+    return E;
+  for (auto &G : GroupRecords)
+    Records.insert(Records.end(), G.begin(), G.end());
   return Error::success();
 }
 
@@ -369,9 +508,19 @@ Error loadYAMLLog(StringRef Data, XRayFileHeader &FileHeader,
                  });
   return Error::success();
 }
-} // namespace
+enum BinaryFormatType { NAIVE_FORMAT = 0, FLIGHT_DATA_RECORDER_FORMAT = 1 };
 
-Expected<Trace> llvm::xray::loadTraceFile(StringRef Filename, bool Sort) {
+// Returns whether the data starts like an FDR mode log of a supported version.
+bool isFDRLog(const DataExtractor &DE) {
+  DataExtractor HeaderExtractor(DE.getData(), DE.isLittleEndian(), 8);
+  uint32_t OffsetPtr = 0;
+  uint16_t Version = HeaderExtractor.getU16(&OffsetPtr);
+  uint16_t Type = HeaderExtractor.getU16(&OffsetPtr);
+  return Type == FLIGHT_DATA_RECORDER_FORMAT && Version >= 1 && Version <= 5;
+}
+
+Expected<std::unique_ptr<sys::fs::mapped_file_region>>
+mapTraceFile(StringRef Filename) {
   int Fd;
   if (auto EC = sys::fs::openFileForRead(Filename, Fd)) {
     return make_error<StringError>(
@@ -391,25 +540,36 @@ Expected<Trace> llvm::xray::loadTraceFile(StringRef Filename, bool Sort) {
 
   // Map the opened file into memory and use a StringRef to access it later.
   std::error_code EC;
-  sys::fs::mapped_file_region MappedFile(
+  auto MappedFile = llvm::make_unique<sys::fs::mapped_file_region>(
       Fd, sys::fs::mapped_file_region::mapmode::readonly, FileSize, 0, EC);
   if (EC) {
     return make_error<StringError>(
         Twine("Cannot read log from '") + Filename + "'", EC);
   }
-  auto Data = StringRef(MappedFile.data(), MappedFile.size());
+  return std::move(MappedFile);
+}
+} // namespace
+
+Expected<Trace> llvm::xray::loadTraceFile(StringRef Filename, bool Sort,
+                                          unsigned Threads) {
+  auto MappedFileOrErr = mapTraceFile(Filename);
+  if (!MappedFileOrErr)
+    return MappedFileOrErr.takeError();
+  auto &MappedFile = *MappedFileOrErr;
+  auto Data = StringRef(MappedFile->data(), MappedFile->size());
 
   // TODO: Lift the endianness and implementation selection here.
   DataExtractor LittleEndianDE(Data, true, 8);
-  auto TraceOrError = loadTrace(LittleEndianDE, Sort);
+  auto TraceOrError = loadTrace(LittleEndianDE, Sort, Threads);
   if (!TraceOrError) {
     DataExtractor BigEndianDE(Data, false, 8);
-    TraceOrError = loadTrace(BigEndianDE, Sort);
+    TraceOrError = loadTrace(BigEndianDE, Sort, Threads);
   }
   return TraceOrError;
 }
 
-Expected<Trace> llvm::xray::loadTrace(const DataExtractor &DE, bool Sort) {
+Expected<Trace> llvm::xray::loadTrace(const DataExtractor &DE, bool Sort,
+                                      unsigned Threads) {
   // Attempt to detect the file type using file magic. We have a slight bias
   // towards the binary format, and we do this by making sure that the first 4
   // bytes of the binary file is some combination of the following byte
@@ -429,8 +589,6 @@ Expected<Trace> llvm::xray::loadTrace(const DataExtractor &DE, bool Sort) {
   uint16_t Version = HeaderExtractor.getU16(&OffsetPtr);
   uint16_t Type = HeaderExtractor.getU16(&OffsetPtr);
 
-  enum BinaryFormatType { NAIVE_FORMAT = 0, FLIGHT_DATA_RECORDER_FORMAT = 1 };
-
   Trace T;
   switch (Type) {
   case NAIVE_FORMAT:
@@ -448,7 +606,7 @@ Expected<Trace> llvm::xray::loadTrace(const DataExtractor &DE, bool Sort) {
   case FLIGHT_DATA_RECORDER_FORMAT:
     if (Version >= 1 && Version <= 5) {
       if (auto E = loadFDRLog(DE.getData(), DE.isLittleEndian(), T.FileHeader,
-                              T.Records))
+                              T.Records, Threads))
         return std::move(E);
     } else {
       return make_error<StringError>(
@@ -469,3 +627,103 @@ Expected<Trace> llvm::xray::loadTrace(const DataExtractor &DE, bool Sort) {
 
   return std::move(T);
 }
+
+Error llvm::xray::streamTraceFile(
+    StringRef Filename, XRayFileHeader &FileHeader,
+    function_ref<Error(const XRayRecord &)> Callback) {
+  auto MappedFileOrErr = mapTraceFile(Filename);
+  if (!MappedFileOrErr)
+    return MappedFileOrErr.takeError();
+  auto &MappedFile = *MappedFileOrErr;
+  auto Data = StringRef(MappedFile->data(), MappedFile->size());
+
+  // Records may already have been handed out when an FDR log fails to load,
+  // so we pick the endianness up front rather than retrying on errors.
+  DataExtractor LittleEndianDE(Data, true, 8);
+  if (isFDRLog(LittleEndianDE))
+    return streamTrace(LittleEndianDE, FileHeader, Callback);
+  DataExtractor BigEndianDE(Data, false, 8);
+  if (isFDRLog(BigEndianDE))
+    return streamTrace(BigEndianDE, FileHeader, Callback);
+
+  auto TraceOrErr = loadTrace(LittleEndianDE);
+  if (!TraceOrErr) {
+    consumeError(TraceOrErr.takeError());
+    TraceOrErr = loadTrace(BigEndianDE);
+  }
+  if (!TraceOrErr)
+    return TraceOrErr.takeError();
+  FileHeader = TraceOrErr->getFileHeader();
+  for (const auto &R : *TraceOrErr)
+    if (auto E = Callback(R))
+      return E;
+  return Error::success();
+}
+
+Error llvm::xray::streamTrace(
+    const DataExtractor &DE, XRayFileHeader &FileHeader,
+    function_ref<Error(const XRayRecord &)> Callback) {
+  if (isFDRLog(DE))
+    return streamFDRLog(DE.getData(), DE.isLittleEndian(), FileHeader,
+                        Callback);
+
+  auto TraceOrErr = loadTrace(DE);
+  if (!TraceOrErr)
+    return TraceOrErr.takeError();
+  FileHeader = TraceOrErr->getFileHeader();
+  for (const auto &R : *TraceOrErr)
+    if (auto E = Callback(R))
+      return E;
+  return Error::success();
+}
+
+Error llvm::xray::streamTraceFile(
+    StringRef Filename, XRayFileHeader &FileHeader, unsigned Threads,
+    function_ref<Error(unsigned, const XRayRecord &)> Callback) {
+  auto MappedFileOrErr = mapTraceFile(Filename);
+  if (!MappedFileOrErr)
+    return MappedFileOrErr.takeError();
+  auto &MappedFile = *MappedFileOrErr;
+  auto Data = StringRef(MappedFile->data(), MappedFile->size());
+
+  DataExtractor LittleEndianDE(Data, true, 8);
+  if (isFDRLog(LittleEndianDE))
+    return streamTrace(LittleEndianDE, FileHeader, Threads, Callback);
+  DataExtractor BigEndianDE(Data, false, 8);
+  if (isFDRLog(BigEndianDE))
+    return streamTrace(BigEndianDE, FileHeader, Threads, Callback);
+
+  auto TraceOrErr = loadTrace(LittleEndianDE);
+  if (!TraceOrErr) {
+    consumeError(TraceOrErr.takeError());
+    TraceOrErr = loadTrace(BigEndianDE);
+  }
+  if (!TraceOrErr)
+    return TraceOrErr.takeError();
+  FileHeader = TraceOrErr->getFileHeader();
+  for (const auto &R : *TraceOrErr)
+    if (auto E = Callback(0, R))
+      return E;
+  return Error::success();
+}
+
+Error llvm::xray::streamTrace(
+    const DataExtractor &DE, XRayFileHeader &FileHeader, unsigned Threads,
+    function_ref<Error(unsigned, const XRayRecord &)> Callback) {
+  if (isFDRLog(DE))
+    return streamFDRLogInParallel(
+        DE.getData(), DE.isLittleEndian(), FileHeader, std::max(Threads, 1U),
+        [](size_t) {},
+        [&](size_t, unsigned Worker, const XRayRecord &R) {
+          return Callback(Worker, R);
+        });
+
+  auto TraceOrErr = loadTrace(DE);
+  if (!TraceOrErr)
+    return TraceOrErr.takeError();
+  FileHeader = TraceOrErr->getFileHeader();
+  for (const auto &R : *TraceOrErr)
+    if (auto E = Callback(0, R))
+      return E;
+  return Error::success();
+}
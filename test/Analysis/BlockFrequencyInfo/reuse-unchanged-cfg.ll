@@ -0,0 +1,44 @@
+; RUN: opt < %s -disable-output -debug-pass-manager \
+; RUN:     -passes='require<block-freq>,invalidate<block-freq>,invalidate<branch-prob>,require<block-freq>' 2>&1 \
+; RUN:   | FileCheck %s --check-prefix=DEFAULT
+; RUN: opt < %s -disable-output -debug-pass-manager -reuse-unchanged-cfg-analyses \
+; RUN:     -passes='require<block-freq>,invalidate<block-freq>,invalidate<branch-prob>,require<block-freq>' 2>&1 \
+; RUN:   | FileCheck %s --check-prefix=REUSE
+; RUN: opt < %s -disable-output -debug-pass-manager -reuse-unchanged-cfg-analyses \
+; RUN:     -passes='require<block-freq>,lower-expect,require<block-freq>' 2>&1 \
+; RUN:   | FileCheck %s --check-prefix=CHANGED
+
+; DEFAULT:     Running analysis: BlockFrequencyAnalysis
+; DEFAULT:     Running analysis: BlockFrequencyAnalysis
+
+; Invalidating the results without touching the function keeps them.
+
+; REUSE:       Running analysis: BlockFrequencyAnalysis
+; REUSE:       Running analysis: BranchProbabilityAnalysis
+; REUSE-NOT:   Running analysis: BlockFrequencyAnalysis
+; REUSE-NOT:   Running analysis: BranchProbabilityAnalysis
+; REUSE:       Finished llvm::Function pass manager run
+
+; Lowering the expect intrinsic adds branch weights, so the probabilities
+; are computed again.
+
+; CHANGED:     Running analysis: BlockFrequencyAnalysis
+; CHANGED:     Running pass: LowerExpectIntrinsicPass
+; CHANGED:     Running analysis: BranchProbabilityAnalysis
+; CHANGED:     Running analysis: BlockFrequencyAnalysis
+
+define i32 @f(i32 %x) {
+entry:
+  %c = icmp sgt i32 %x, 0
+  %e = call i1 @llvm.expect.i1(i1 %c, i1 true)
+  br i1 %e, label %then, label %exit
+
+then:
+  br label %exit
+
+exit:
+  %r = phi i32 [ 1, %then ], [ 0, %entry ]
+  ret i32 %r
+}
+
+declare i1 @llvm.expect.i1(i1, i1)
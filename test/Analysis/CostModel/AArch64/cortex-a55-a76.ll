@@ -0,0 +1,54 @@
+; RUN: opt < %s -cost-model -analyze | FileCheck %s --check-prefix=GENERIC
+; RUN: opt < %s -cost-model -analyze -mcpu=cortex-a55 | FileCheck %s --check-prefix=A55
+; RUN: opt < %s -cost-model -analyze -mcpu=cortex-a76 | FileCheck %s --check-prefix=A76
+
+target datalayout = "e-m:e-i64:64-i128:128-n32:64-S128"
+target triple = "aarch64--linux-gnu"
+
+; GENERIC-LABEL: vectorArith
+; A55-LABEL: vectorArith
+; A76-LABEL: vectorArith
+define void @vectorArith(<2 x i32> %a, <4 x i32> %b, <4 x float> %c,
+                         <2 x double> %d) {
+    ; Cortex-A55 issues 128-bit operations at half the rate of 64-bit ones.
+    ;
+    ; GENERIC: cost of 1 {{.*}} add <2 x i32>
+    ; A55: cost of 1 {{.*}} add <2 x i32>
+    ; A76: cost of 1 {{.*}} add <2 x i32>
+    %t1 = add <2 x i32> %a, %a
+    ; GENERIC: cost of 1 {{.*}} add <4 x i32>
+    ; A55: cost of 2 {{.*}} add <4 x i32>
+    ; A76: cost of 1 {{.*}} add <4 x i32>
+    %t2 = add <4 x i32> %b, %b
+    ; A55: cost of 4 {{.*}} mul <4 x i32>
+    ; A76: cost of 2 {{.*}} mul <4 x i32>
+    %t3 = mul <4 x i32> %b, %b
+    ; A55: cost of 2 {{.*}} fadd <4 x float>
+    ; A76: cost of 1 {{.*}} fadd <4 x float>
+    %t4 = fadd <4 x float> %c, %c
+    ; A55: cost of 38 {{.*}} fdiv <2 x double>
+    ; A76: cost of 14 {{.*}} fdiv <2 x double>
+    %t5 = fdiv <2 x double> %d, %d
+
+    ; Illegal types are split into legal ones first.
+    ;
+    ; A55: cost of 4 {{.*}} add <8 x i32>
+    ; A76: cost of 2 {{.*}} add <8 x i32>
+    %t6 = add <8 x i32> undef, undef
+    ret void
+}
+
+; GENERIC-LABEL: vectorMemory
+; A55-LABEL: vectorMemory
+; A76-LABEL: vectorMemory
+define void @vectorMemory(<4 x i32>* %p) {
+    ; GENERIC: cost of 1 {{.*}} load <4 x i32>
+    ; A55: cost of 2 {{.*}} load <4 x i32>
+    ; A76: cost of 1 {{.*}} load <4 x i32>
+    %v = load <4 x i32>, <4 x i32>* %p, align 16
+    ; GENERIC: cost of 1 {{.*}} store <4 x i32>
+    ; A55: cost of 2 {{.*}} store <4 x i32>
+    ; A76: cost of 2 {{.*}} store <4 x i32>
+    store <4 x i32> %v, <4 x i32>* %p, align 16
+    ret void
+}
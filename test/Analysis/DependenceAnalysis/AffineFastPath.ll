@@ -0,0 +1,76 @@
+; RUN: opt < %s -analyze -basicaa -da | FileCheck %s
+; RUN: opt < %s -analyze -basicaa -da -da-affine-fast-path=false | FileCheck %s
+; RUN: opt < %s -analyze -basicaa -da -stats 2>&1 | FileCheck %s --check-prefix=STATS
+; REQUIRES: asserts
+
+; The fast path gives the same answers as the strong SIV test.
+
+; STATS: 9 da - Array pairs answered by the affine fast path
+
+target datalayout = "e-p:64:64:64-i1:8:8-i8:8:8-i16:16:16-i32:32:32-i64:64:64-f32:32:32-f64:64:64-v64:64:64-v128:128:128-a0:0:64-s0:64:64-f80:128:128-n8:16:32:64-S128"
+target triple = "x86_64-unknown-linux-gnu"
+
+;;  for (long i = 0; i < n; i++) {
+;;    A[i + 2] = i;
+;;    ... = A[i];
+;;    ... = A[i - 1];
+
+; CHECK-LABEL: 'Dependence Analysis' for function 'distance'
+; CHECK: da analyze - none!
+; CHECK: da analyze - consistent flow [2]!
+; CHECK: da analyze - consistent flow [3]!
+; CHECK: da analyze - none!
+; CHECK: da analyze - consistent input [1]!
+; CHECK: da analyze - none!
+
+define void @distance(i32* noalias %A, i64 %n) {
+entry:
+  br label %for.body
+
+for.body:
+  %i = phi i64 [ 0, %entry ], [ %i.next, %for.body ]
+  %add = add nsw i64 %i, 2
+  %p0 = getelementptr inbounds i32, i32* %A, i64 %add
+  %t = trunc i64 %i to i32
+  store i32 %t, i32* %p0, align 4
+  %p1 = getelementptr inbounds i32, i32* %A, i64 %i
+  %v1 = load i32, i32* %p1, align 4
+  %sub = add nsw i64 %i, -1
+  %p2 = getelementptr inbounds i32, i32* %A, i64 %sub
+  %v2 = load i32, i32* %p2, align 4
+  %i.next = add nuw nsw i64 %i, 1
+  %cmp = icmp slt i64 %i.next, %n
+  br i1 %cmp, label %for.body, label %for.end
+
+for.end:
+  ret void
+}
+
+;;  for (long i = 0; i < 4; i++)
+;;    A[i + 8] = A[i];
+
+; The distance exceeds the trip count.
+
+; CHECK-LABEL: 'Dependence Analysis' for function 'trip_count'
+; CHECK: da analyze - none!
+; CHECK: da analyze - none!
+; CHECK: da analyze - none!
+
+define void @trip_count(i32* noalias %A) {
+entry:
+  br label %for.body
+
+for.body:
+  %i = phi i64 [ 0, %entry ], [ %i.next, %for.body ]
+  %p0 = getelementptr inbounds i32, i32* %A, i64 %i
+  %v = load i32, i32* %p0, align 4
+  %add = add nsw i64 %i, 8
+  %p1 = getelementptr inbounds i32, i32* %A, i64 %add
+  store i32 %v, i32* %p1, align 4
+  %i.next = add nuw nsw i64 %i, 1
+  %cmp = icmp slt i64 %i.next, 4
+  br i1 %cmp, label %for.body, label %for.end
+
+for.end:
+  ret void
+}
@@ -0,0 +1,47 @@
+; RUN: opt -basicaa -print-memoryssa -verify-memoryssa -analyze < %s 2>&1 | FileCheck %s --check-prefix=EAGER
+; RUN: opt -basicaa -print-memoryssa -verify-memoryssa -analyze \
+; RUN:     -memssa-lazy-use-optimization < %s 2>&1 | FileCheck %s --check-prefix=LAZY
+; RUN: opt -basicaa -early-cse-memssa -memssa-lazy-use-optimization -S < %s \
+; RUN:   | FileCheck %s --check-prefix=CSE
+; RUN: opt -basicaa -early-cse-memssa -memssa-lazy-use-optimization \
+; RUN:     -memssa-walk-limit=1 -S < %s | FileCheck %s --check-prefix=LIMIT
+; RUN: opt -basicaa -early-cse-memssa -memssa-lazy-use-optimization \
+; RUN:     -stats -disable-output < %s 2>&1 | FileCheck %s --check-prefix=STATS
+; REQUIRES: asserts
+
+; With lazy use optimization, uses keep their nearest dominating def until the
+; walker is asked for their clobber.
+
+; EAGER-LABEL: define i32 @f(
+; EAGER:       ; 2 = MemoryDef(1)
+; EAGER-NEXT:  store i32 2, i32* %c
+; EAGER:       ; MemoryUse(liveOnEntry)
+; EAGER-NEXT:  %v2 = load i32, i32* %a
+
+; LAZY-LABEL: define i32 @f(
+; LAZY:       ; 2 = MemoryDef(1)
+; LAZY-NEXT:  store i32 2, i32* %c
+; LAZY:       ; MemoryUse(2)
+; LAZY-NEXT:  %v2 = load i32, i32* %a
+
+; CSE-LABEL: @f(
+; CSE:         %v1 = load i32, i32* %a
+; CSE-NOT:     load
+; CSE:         ret i32
+
+; The walk gives up at the store to %b and treats it as the clobber.
+
+; LIMIT-LABEL: @f(
+; LIMIT:         %v1 = load i32, i32* %a
+; LIMIT:         %v2 = load i32, i32* %a
+
+; STATS: memoryssa - Number of defs visited by clobber walks
+
+define i32 @f(i32* noalias %a, i32* noalias %b, i32* noalias %c) {
+  %v1 = load i32, i32* %a
+  store i32 1, i32* %b
+  store i32 2, i32* %c
+  %v2 = load i32, i32* %a
+  %r = add i32 %v1, %v2
+  ret i32 %r
+}
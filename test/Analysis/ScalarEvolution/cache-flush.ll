@@ -0,0 +1,37 @@
+; RUN: opt < %s -analyze -scalar-evolution | FileCheck %s
+; RUN: opt < %s -analyze -scalar-evolution -scev-max-cached-values=2 \
+; RUN:   | FileCheck %s
+; RUN: opt < %s -analyze -scalar-evolution -scev-max-cached-values=2 \
+; RUN:     -scev-cache-report 2>&1 >/dev/null | FileCheck %s --check-prefix=REPORT
+; RUN: opt < %s -analyze -scalar-evolution -scev-cache-report 2>&1 >/dev/null \
+; RUN:   | FileCheck %s --check-prefix=NOFLUSH
+
+; Flushing the caches must not change any of the results.
+
+; CHECK-LABEL: Classifying expressions for: @sum
+; CHECK:       %i = phi i64 [ 0, %entry ], [ %i.next, %loop ]
+; CHECK-NEXT:  -->  {0,+,1}<nuw><nsw><%loop> U: [0,100) S: [0,100)
+; CHECK:       %p = getelementptr inbounds i32, i32* %a, i64 %i
+; CHECK-NEXT:  -->  {%a,+,4}<nuw><%loop>
+; CHECK:       Loop %loop: backedge-taken count is 99
+
+; REPORT:  SCEV cache report for 'sum': {{[0-9]+}} nodes, {{[0-9]+}} cached values, {{[0-9]+}} queries, {{[0-9]+}} hits ({{[0-9.]+}}%), {{[1-9][0-9]*}} flushes, {{[0-9]+}} bytes
+; NOFLUSH: SCEV cache report for 'sum': {{.*}}, 0 flushes,
+
+define i32 @sum(i32* %a) {
+entry:
+  br label %loop
+
+loop:
+  %i = phi i64 [ 0, %entry ], [ %i.next, %loop ]
+  %s = phi i32 [ 0, %entry ], [ %s.next, %loop ]
+  %p = getelementptr inbounds i32, i32* %a, i64 %i
+  %v = load i32, i32* %p
+  %s.next = add i32 %s, %v
+  %i.next = add nuw nsw i64 %i, 1
+  %c = icmp eq i64 %i.next, 100
+  br i1 %c, label %exit, label %loop
+
+exit:
+  ret i32 %s.next
+}
@@ -0,0 +1,56 @@
+; RUN: llvm-as < %s | llvm-dis > %t.serial.ll
+; RUN: llvm-as < %s | llvm-dis -asm-writer-threads=3 > %t.parallel.ll
+; RUN: diff %t.serial.ll %t.parallel.ll
+; RUN: FileCheck %s < %t.parallel.ll
+
+; Function local metadata and call site attribute sets are numbered in
+; function order, whichever worker prints the function.
+
+; CHECK: define void @f0() {
+; CHECK: call void @g() #1, !dbg !{{[0-9]+}}
+; CHECK: define <4 x i32> @f1(<4 x i32> %v) {
+; CHECK: add <4 x i32> %v, <i32 1, i32 2, i32 3, i32 4>
+; CHECK: define i16 @f2(i32 %i) {
+; CHECK: extractelement <2 x i16> <i16 7, i16 8>, i32 %i
+; CHECK: define i32 @f3() {
+; CHECK: call void @g() #2
+; CHECK: attributes #1 = { nounwind }
+; CHECK: attributes #2 = { cold }
+
+declare void @g() #0
+
+define void @f0() {
+  call void @g() #1, !dbg !4
+  ret void
+}
+
+define <4 x i32> @f1(<4 x i32> %v) {
+  %r = add <4 x i32> %v, <i32 1, i32 2, i32 3, i32 4>
+  ret <4 x i32> %r
+}
+
+define i16 @f2(i32 %i) {
+  %e = extractelement <2 x i16> <i16 7, i16 8>, i32 %i
+  ret i16 %e
+}
+
+define i32 @f3() {
+  %a = alloca [2 x i32], !md !10
+  store [2 x i32] [i32 5, i32 6], [2 x i32]* %a
+  call void @g() #2
+  ret i32 0
+}
+
+attributes #0 = { noinline }
+attributes #1 = { nounwind }
+attributes #2 = { cold }
+
+!llvm.dbg.cu = !{!0}
+!llvm.module.flags = !{!3}
+
+!0 = distinct !DICompileUnit(language: DW_LANG_C99, file: !1, emissionKind: FullDebug)
+!1 = !DIFile(filename: "t.c", directory: "/")
+!2 = distinct !DISubprogram(name: "f0", scope: !1, file: !1, line: 1, unit: !0)
+!3 = !{i32 2, !"Debug Info Version", i32 3}
+!4 = !DILocation(line: 2, scope: !2)
+!10 = !{!"f3"}
@@ -0,0 +1,65 @@
+; RUN: llvm-as -bitcode-mdindex-threshold=0 < %s -o %t.bc
+; RUN: llvm-extract -func=f1 -lazy-load-module-metadata %t.bc -S -o - \
+; RUN:   | FileCheck %s
+; REQUIRES: asserts
+
+; The type of the arguments of @f2 and @f3 is shared by both functions, so it
+; is written in the module-level metadata block. Extracting @f1 does not load
+; it.
+
+; RUN: llvm-extract -func=f1 -lazy-load-module-metadata -stats %t.bc \
+; RUN:   -o /dev/null 2>&1 | FileCheck %s -check-prefix=LAZY
+; LAZY: {{[0-9]+}} bitcode-reader  - Number of Metadata records loaded
+; RUN: llvm-extract -func=f1 -stats %t.bc -o /dev/null 2>&1 \
+; RUN:   | FileCheck %s -check-prefix=NOTLAZY
+; NOTLAZY: {{[0-9]+}} bitcode-reader  - Number of Metadata records loaded
+
+; CHECK: define void @f1(i32 %a) !dbg [[F1:![0-9]+]]
+; CHECK: [[F1]] = distinct !DISubprogram(name: "f1"
+; CHECK-NOT: name: "f2"
+; CHECK-NOT: name: "f3"
+; CHECK-NOT: name: "S"
+
+target triple = "x86_64-unknown-linux-gnu"
+
+define void @f1(i32 %a) !dbg !6 {
+  call void @llvm.dbg.value(metadata i32 %a, metadata !9, metadata !DIExpression()), !dbg !10
+  ret void, !dbg !10
+}
+
+define void @f2(i32 %a) !dbg !11 {
+  call void @llvm.dbg.value(metadata i32 %a, metadata !16, metadata !DIExpression()), !dbg !18
+  ret void, !dbg !18
+}
+
+define void @f3(i32 %a) !dbg !19 {
+  call void @llvm.dbg.value(metadata i32 %a, metadata !20, metadata !DIExpression()), !dbg !21
+  ret void, !dbg !21
+}
+
+declare void @llvm.dbg.value(metadata, metadata, metadata)
+
+!llvm.dbg.cu = !{!0}
+!llvm.module.flags = !{!3, !4}
+
+!0 = distinct !DICompileUnit(language: DW_LANG_C99, file: !1, producer: "clang", isOptimized: true, runtimeVersion: 0, emissionKind: FullDebug, enums: !2)
+!1 = !DIFile(filename: "t.c", directory: "/tmp")
+!2 = !{}
+!3 = !{i32 2, !"Dwarf Version", i32 4}
+!4 = !{i32 2, !"Debug Info Version", i32 3}
+!5 = !DIBasicType(name: "int", size: 32, encoding: DW_ATE_signed)
+!6 = distinct !DISubprogram(name: "f1", scope: !1, file: !1, line: 1, type: !7, isLocal: false, isDefinition: true, scopeLine: 1, isOptimized: true, unit: !0, retainedNodes: !2)
+!7 = !DISubroutineType(types: !8)
+!8 = !{null, !5}
+!9 = !DILocalVariable(name: "a", arg: 1, scope: !6, file: !1, line: 1, type: !5)
+!10 = !DILocation(line: 1, column: 1, scope: !6)
+!11 = distinct !DISubprogram(name: "f2", scope: !1, file: !1, line: 2, type: !12, isLocal: false, isDefinition: true, scopeLine: 2, isOptimized: true, unit: !0, retainedNodes: !2)
+!12 = !DISubroutineType(types: !13)
+!13 = !{null, !14}
+!14 = !DIDerivedType(tag: DW_TAG_pointer_type, baseType: !15, size: 64)
+!15 = !DICompositeType(tag: DW_TAG_structure_type, name: "S", file: !1, line: 2, size: 32, elements: !2)
+!16 = !DILocalVariable(name: "a", arg: 1, scope: !11, file: !1, line: 2, type: !14)
+!18 = !DILocation(line: 2, column: 1, scope: !11)
+!19 = distinct !DISubprogram(name: "f3", scope: !1, file: !1, line: 3, type: !12, isLocal: false, isDefinition: true, scopeLine: 3, isOptimized: true, unit: !0, retainedNodes: !2)
+!20 = !DILocalVariable(name: "a", arg: 1, scope: !19, file: !1, line: 3, type: !14)
+!21 = !DILocation(line: 3, column: 1, scope: !19)
@@ -0,0 +1,41 @@
+; Test that the promotion candidates of a hot indirect call get hot edges.
+; RUN: opt -module-summary %s -o %t.o
+; RUN: llvm-dis %t.o -o - | FileCheck %s
+; RUN: opt -module-summary -summary-hot-icall-targets=false %s -o %t2.o
+; RUN: llvm-dis %t2.o -o - | FileCheck %s --check-prefix=OFF
+
+target datalayout = "e-m:e-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-unknown-linux-gnu"
+
+; The call is hot, but neither target is on its own.
+; CHECK: (name: "caller", {{.*}} calls: ((callee: ^{{[0-9]+}}, hotness: hot), (callee: ^{{[0-9]+}}, hotness: hot))
+; OFF: (name: "caller", {{.*}} calls: ((callee: ^{{[0-9]+}}, hotness: none), (callee: ^{{[0-9]+}}, hotness: none))
+
+define void @caller(void ()* %f) !prof !20 {
+entry:
+  call void %f(), !prof !21
+  ret void
+}
+
+declare void @target1()
+declare void @target2()
+
+!llvm.module.flags = !{!1}
+!20 = !{!"function_entry_count", i64 100}
+; target1 and target2
+!21 = !{!"VP", i32 0, i64 100, i64 16427248391210141612, i64 60, i64 1832005761847989729, i64 40}
+
+!1 = !{i32 1, !"ProfileSummary", !2}
+!2 = !{!3, !4, !5, !6, !7, !8, !9, !10}
+!3 = !{!"ProfileFormat", !"InstrProf"}
+!4 = !{!"TotalCount", i64 10000}
+!5 = !{!"MaxCount", i64 10}
+!6 = !{!"MaxInternalCount", i64 1}
+!7 = !{!"MaxFunctionCount", i64 1000}
+!8 = !{!"NumCounts", i64 3}
+!9 = !{!"NumFunctions", i64 3}
+!10 = !{!"DetailedSummary", !11}
+!11 = !{!12, !13, !14}
+!12 = !{i32 10000, i64 100, i32 1}
+!13 = !{i32 999000, i64 100, i32 1}
+!14 = !{i32 999999, i64 1, i32 2}
@@ -0,0 +1,101 @@
+; Encoding the function blocks in parallel produces the same bitcode as
+; encoding them serially.
+; RUN: llvm-as < %s -o %t.serial.bc
+; RUN: llvm-as -bitcode-writer-threads=3 < %s -o %t.parallel.bc
+; RUN: cmp %t.serial.bc %t.parallel.bc
+; RUN: llvm-as -preserve-bc-uselistorder=false < %s -o %t.serial.bc
+; RUN: llvm-as -preserve-bc-uselistorder=false -bitcode-writer-threads=2 \
+; RUN:   < %s -o %t.parallel.bc
+; RUN: cmp %t.serial.bc %t.parallel.bc
+; RUN: opt -module-summary -module-hash %s -o %t.serial.bc
+; RUN: opt -module-summary -module-hash -bitcode-writer-threads=4 %s \
+; RUN:   -o %t.parallel.bc
+; RUN: cmp %t.serial.bc %t.parallel.bc
+; RUN: llvm-dis < %t.parallel.bc | FileCheck %s
+
+; CHECK: define i32 @f1(
+; CHECK: define void @f2(
+; CHECK: define i8* @f3(
+; CHECK: define void @f4(
+
+@g = global i32 0
+@s = private constant [4 x i8] c"abc\00"
+
+define i32 @f1(i32 %a) !dbg !5 {
+entry:
+  %v = load i32, i32* @g, align 4, !tbaa !9
+  call void @llvm.dbg.value(metadata i32 %a, metadata !8, metadata !DIExpression()), !dbg !13
+  %cmp = icmp sgt i32 %a, %v
+  br i1 %cmp, label %then, label %else, !prof !14
+
+then:
+  %add = add nsw i32 %a, 42
+  br label %exit
+
+else:
+  %mul = mul i32 %v, 7
+  br label %exit
+
+exit:
+  %r = phi i32 [ %add, %then ], [ %mul, %else ]
+  ret i32 %r, !dbg !13
+}
+
+define void @f2(i32 %x) {
+entry:
+  switch i32 %x, label %default [
+    i32 1, label %one
+    i32 2, label %two
+  ]
+
+one:
+  store i32 1, i32* @g
+  br label %default
+
+two:
+  store i32 2, i32* @g
+  br label %default
+
+default:
+  ret void
+}
+
+define i8* @f3(i1 %c) {
+entry:
+  br i1 %c, label %a, label %b
+
+a:
+  ret i8* blockaddress(@f3, %b)
+
+b:
+  ret i8* getelementptr ([4 x i8], [4 x i8]* @s, i64 0, i64 1)
+}
+
+define void @f4(float %f) {
+  %d = fpext float %f to double
+  %i = fptosi double %d to i32
+  %old = atomicrmw add i32* @g, i32 %i seq_cst
+  call void @f2(i32 %old)
+  ret void
+}
+
+declare void @llvm.dbg.value(metadata, metadata, metadata)
+
+!llvm.dbg.cu = !{!0}
+!llvm.module.flags = !{!3, !4}
+
+!0 = distinct !DICompileUnit(language: DW_LANG_C99, file: !1, producer: "clang", isOptimized: true, runtimeVersion: 0, emissionKind: FullDebug, enums: !2)
+!1 = !DIFile(filename: "t.c", directory: "/tmp")
+!2 = !{}
+!3 = !{i32 2, !"Dwarf Version", i32 4}
+!4 = !{i32 2, !"Debug Info Version", i32 3}
+!5 = distinct !DISubprogram(name: "f1", scope: !1, file: !1, line: 1, type: !6, isLocal: false, isDefinition: true, scopeLine: 1, isOptimized: true, unit: !0, retainedNodes: !2)
+!6 = !DISubroutineType(types: !7)
+!7 = !{!12, !12}
+!8 = !DILocalVariable(name: "a", arg: 1, scope: !5, file: !1, line: 1, type: !12)
+!9 = !{!10, !10, i64 0}
+!10 = !{!"int", !11, i64 0}
+!11 = !{!"tbaa root"}
+!12 = !DIBasicType(name: "int", size: 32, encoding: DW_ATE_signed)
+!13 = !DILocation(line: 1, column: 1, scope: !5)
+!14 = !{!"branch_weights", i32 10, i32 1}
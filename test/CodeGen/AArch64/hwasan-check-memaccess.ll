@@ -0,0 +1,66 @@
+; RUN: llc < %s | FileCheck %s
+
+target triple = "aarch64--linux-android"
+
+define i8* @f1(i8* %x0, i8* %x1) {
+  ; CHECK-LABEL: f1:
+  ; CHECK: str x30, [sp, #-16]!
+  ; CHECK: mov x9, x0
+  ; CHECK-NEXT: bl __hwasan_check_x1_18
+  ; CHECK-NEXT: mov x0, x1
+  ; CHECK-NEXT: ldr x30, [sp], #16
+  ; CHECK-NEXT: ret
+  call void @llvm.hwasan.check.memaccess(i8* %x0, i8* %x1, i32 18)
+  ret i8* %x1
+}
+
+define i8* @f2(i8* %x0, i8* %x1) {
+  ; CHECK-LABEL: f2:
+  ; CHECK: mov x9, x1
+  ; CHECK-NEXT: bl __hwasan_check_x0_2
+  call void @llvm.hwasan.check.memaccess(i8* %x1, i8* %x0, i32 2)
+  ret i8* %x0
+}
+
+define void @f3(i8* %x0, i8* %x1) {
+  ; CHECK-LABEL: f3:
+  ; CHECK: bl __hwasan_check_x0_2
+  ; CHECK-NOT: bl __hwasan_check_x0_2
+  ; CHECK: ret
+  call void @llvm.hwasan.check.memaccess(i8* %x1, i8* %x0, i32 2)
+  call void @llvm.hwasan.check.memaccess(i8* %x1, i8* %x0, i32 2)
+  ret void
+}
+
+declare void @llvm.hwasan.check.memaccess(i8*, i8*, i32)
+
+; Each routine is emitted once, in its own comdat.
+
+; CHECK:      .section .text.hot,"axG",@progbits,__hwasan_check_x0_2,comdat
+; CHECK-NEXT: .type __hwasan_check_x0_2,@function
+; CHECK-NEXT: .weak __hwasan_check_x0_2
+; CHECK-NEXT: .hidden __hwasan_check_x0_2
+; CHECK-NEXT: __hwasan_check_x0_2:
+; CHECK-NEXT: ubfx x16, x0, #4, #52
+; CHECK-NEXT: ldrb w16, [x9, x16]
+; CHECK-NEXT: cmp x16, x0, lsr #56
+; CHECK-NEXT: b.ne [[MISMATCH0:.Ltmp[0-9]+]]
+; CHECK-NEXT: ret
+; CHECK-NEXT: [[MISMATCH0]]:
+; CHECK-NEXT: brk #0x902
+
+; CHECK:      .section .text.hot,"axG",@progbits,__hwasan_check_x1_18,comdat
+; CHECK-NEXT: .type __hwasan_check_x1_18,@function
+; CHECK-NEXT: .weak __hwasan_check_x1_18
+; CHECK-NEXT: .hidden __hwasan_check_x1_18
+; CHECK-NEXT: __hwasan_check_x1_18:
+; CHECK-NEXT: ubfx x16, x1, #4, #52
+; CHECK-NEXT: ldrb w16, [x9, x16]
+; CHECK-NEXT: cmp x16, x1, lsr #56
+; CHECK-NEXT: b.ne [[MISMATCH1:.Ltmp[0-9]+]]
+; CHECK-NEXT: ret
+; CHECK-NEXT: [[MISMATCH1]]:
+; CHECK-NEXT: mov x0, x1
+; CHECK-NEXT: brk #0x912
+
+; CHECK-NOT: __hwasan_check_
@@ -0,0 +1,41 @@
+; RUN: llc -verify-machineinstrs -enable-machine-outliner \
+; RUN:     -mtriple=aarch64-linux-gnu -outliner-shard-size=12 < %s | FileCheck %s
+
+; @a and @b end up in the first shard, @c and @d in the second one. The
+; sequence found in both shards is outlined once for all four functions.
+
+; CHECK-LABEL: a:
+; CHECK:       b OUTLINED_FUNCTION_0
+; CHECK-LABEL: b:
+; CHECK:       b OUTLINED_FUNCTION_0
+; CHECK-LABEL: c:
+; CHECK:       b OUTLINED_FUNCTION_0
+; CHECK-LABEL: d:
+; CHECK:       b OUTLINED_FUNCTION_0
+; CHECK-NOT:   OUTLINED_FUNCTION_1
+
+define void @a() {
+entry:
+  tail call void @z(i32 1, i32 2, i32 3, i32 4)
+  ret void
+}
+
+define void @b() {
+entry:
+  tail call void @z(i32 1, i32 2, i32 3, i32 4)
+  ret void
+}
+
+define void @c() {
+entry:
+  tail call void @z(i32 1, i32 2, i32 3, i32 4)
+  ret void
+}
+
+define void @d() {
+entry:
+  tail call void @z(i32 1, i32 2, i32 3, i32 4)
+  ret void
+}
+
+declare void @z(i32, i32, i32, i32)
@@ -0,0 +1,28 @@
+; REQUIRES: asserts
+; RUN: llc < %s -mtriple=aarch64-linux-gnu -mcpu=cortex-a57 \
+; RUN:     -enable-aa-sched-mi -sched-reuse-alias-queries -o /dev/null \
+; RUN:     -stats 2>&1 | FileCheck %s
+; RUN: llc < %s -mtriple=aarch64-linux-gnu -mcpu=cortex-a57 \
+; RUN:     -enable-aa-sched-mi -o - | FileCheck --check-prefix=ASM %s
+; RUN: llc < %s -mtriple=aarch64-linux-gnu -mcpu=cortex-a57 \
+; RUN:     -enable-aa-sched-mi -sched-reuse-alias-queries -o - \
+; RUN:   | FileCheck --check-prefix=ASM %s
+
+; The post-RA scheduler reuses the alias queries of the pre-RA scheduler for
+; the same memory operands, and the schedule does not change.
+
+; CHECK: {{[0-9]+}} machine-scheduler - Number of memory dependences reused
+
+; ASM-LABEL: f:
+; ASM:       ret
+
+define i32 @f(i32* noalias %p, i32* noalias %q, i32* noalias %r) {
+  %a = load i32, i32* %p
+  store i32 %a, i32* %q
+  %b = load i32, i32* %r
+  %p1 = getelementptr i32, i32* %p, i64 1
+  %c = load i32, i32* %p1
+  store i32 %c, i32* %r
+  %s = add i32 %b, %c
+  ret i32 %s
+}
@@ -0,0 +1,59 @@
+; RUN: llc < %s -mtriple=aarch64-linux -relocation-model=pip -o /dev/null \
+; RUN:     -pagerando-bin-report=%t.json
+; RUN: FileCheck %s < %t.json
+; RUN: llc < %s -mtriple=aarch64-linux -relocation-model=pip -o /dev/null \
+; RUN:     -pagerando-binning-strategy=pgo -pagerando-bin-report=%t.pgo.json
+; RUN: FileCheck %s < %t.pgo.json
+
+; The call from @caller to @callee crosses a bin boundary, the call from
+; @callee to @leaf does not.
+
+; CHECK:      "bin_size": 4096,
+; CHECK-NEXT: "bins": [
+; CHECK:        "cross_bin_calls": 1,
+; CHECK-NEXT:   "cross_bin_weight": 1000,
+; CHECK-NEXT:   "estimated_size": {{[0-9]+}},
+; CHECK-NEXT:   "fill_ratio": {{[0-9.e+-]+}},
+; CHECK-NEXT:   "final_size": {{[0-9]+}},
+; CHECK-NEXT:   "functions": [
+; CHECK:          "name": "caller"
+; CHECK:        "name": ".bin_1"
+; CHECK:        "cross_bin_calls": 0,
+; CHECK-NEXT:   "cross_bin_weight": 0,
+; CHECK:          "name": "callee"
+; CHECK:          "name": "leaf"
+; CHECK:        "name": ".bin_2"
+; CHECK-NOT:  "legacy"
+
+define void @legacy() { ret void }
+
+define hidden void @caller() pagerando "pagerando-bin"="1" !prof !16 {
+  call void @callee()
+  ret void
+}
+
+define hidden void @callee() pagerando "pagerando-bin"="2" !prof !16 {
+  call void @leaf()
+  ret void
+}
+
+define hidden void @leaf() pagerando "pagerando-bin"="2" !prof !16 {
+  ret void
+}
+
+!llvm.module.flags = !{!1}
+!1 = !{i32 1, !"ProfileSummary", !2}
+!2 = !{!3, !4, !5, !6, !7, !8, !9, !10}
+!3 = !{!"ProfileFormat", !"InstrProf"}
+!4 = !{!"TotalCount", i64 10000}
+!5 = !{!"MaxCount", i64 1000}
+!6 = !{!"MaxInternalCount", i64 1}
+!7 = !{!"MaxFunctionCount", i64 1000}
+!8 = !{!"NumCounts", i64 3}
+!9 = !{!"NumFunctions", i64 3}
+!10 = !{!"DetailedSummary", !11}
+!11 = !{!12, !13, !14}
+!12 = !{i32 10000, i64 1000, i32 1}
+!13 = !{i32 999000, i64 1000, i32 3}
+!14 = !{i32 999999, i64 5, i32 3}
+!16 = !{!"function_entry_count", i64 1000}
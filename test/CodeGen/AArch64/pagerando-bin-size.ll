@@ -0,0 +1,24 @@
+; RUN: echo "a 3000" > %t.feedback
+; RUN: echo "b 3000" >> %t.feedback
+; RUN: llc < %s -mtriple=aarch64-linux -relocation-model=pip -o - \
+; RUN:     -pagerando-size-feedback=%t.feedback | FileCheck %s --check-prefix=4K
+; RUN: llc < %s -mtriple=aarch64-linux -relocation-model=pip -o - \
+; RUN:     -pagerando-size-feedback=%t.feedback -pagerando-bin-size=16384 \
+; RUN:   | FileCheck %s --check-prefix=16K
+; RUN: not llc < %s -mtriple=aarch64-linux -relocation-model=pip -o /dev/null \
+; RUN:     -pagerando-bin-size=8192 2>&1 | FileCheck %s --check-prefix=ERROR
+
+; 4K-LABEL: .section .text.bin_1
+; 4K-LABEL: a:
+; 4K-LABEL: .section .text.bin_2
+; 4K-LABEL: b:
+
+; 16K-LABEL: .section .text.bin_1
+; 16K-LABEL: a:
+; 16K-NOT:   .section
+; 16K-LABEL: b:
+
+; ERROR: Pagerando bin size must be 4096, 16384 or 65536 on AArch64
+
+define hidden void @a() pagerando { ret void }
+define hidden void @b() pagerando { ret void }
@@ -0,0 +1,56 @@
+; RUN: llc < %s -mtriple=aarch64-linux -relocation-model=pip -o - \
+; RUN:     -pagerando-binning-strategy=hotcold | FileCheck %s
+
+; Hot, normal and cold functions never share a bin. Code outlined by
+; HotColdSplitting (coldcc) is binned with the never-executed functions.
+
+; CHECK:       .section .text.bin_1
+; CHECK-LABEL: hot:
+; CHECK:       .section .text.bin_2
+; CHECK-LABEL: warm:
+; CHECK:       .section .text.bin_3
+; CHECK-LABEL: never:
+; CHECK:       .section .text.bin_3
+; CHECK-LABEL: outlined:
+
+define void @legacy() { ret void }
+
+define hidden void @hot() pagerando !prof !15 {
+  ret void
+}
+
+define hidden void @warm() pagerando !prof !16 {
+  ret void
+}
+
+define hidden void @never() pagerando !prof !17 {
+  ret void
+}
+
+define internal coldcc void @outlined() minsize pagerando {
+  ret void
+}
+
+define hidden void @caller() pagerando !prof !15 {
+  call coldcc void @outlined()
+  ret void
+}
+
+!llvm.module.flags = !{!1}
+!1 = !{i32 1, !"ProfileSummary", !2}
+!2 = !{!3, !4, !5, !6, !7, !8, !9, !10}
+!3 = !{!"ProfileFormat", !"InstrProf"}
+!4 = !{!"TotalCount", i64 10000}
+!5 = !{!"MaxCount", i64 1000}
+!6 = !{!"MaxInternalCount", i64 1}
+!7 = !{!"MaxFunctionCount", i64 1000}
+!8 = !{!"NumCounts", i64 3}
+!9 = !{!"NumFunctions", i64 3}
+!10 = !{!"DetailedSummary", !11}
+!11 = !{!12, !13, !14}
+!12 = !{i32 10000, i64 1000, i32 1}
+!13 = !{i32 999000, i64 1000, i32 3}
+!14 = !{i32 999999, i64 5, i32 3}
+!15 = !{!"function_entry_count", i64 1000}
+!16 = !{!"function_entry_count", i64 100}
+!17 = !{!"function_entry_count", i64 0}
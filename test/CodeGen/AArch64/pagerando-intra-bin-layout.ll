@@ -0,0 +1,53 @@
+; RUN: llc < %s -mtriple=aarch64-linux -relocation-model=pip -o - \
+; RUN:     -pagerando-binning-strategy=pgo | FileCheck %s
+; RUN: llc < %s -mtriple=aarch64-linux -relocation-model=pip -o - \
+; RUN:     -pagerando-binning-strategy=pgo -pagerando-intra-bin-layout=false \
+; RUN:   | FileCheck %s --check-prefix=NOLAYOUT
+
+; The hot caller is placed at the start of its cluster, directly followed by
+; its hot callee. Cluster entries are aligned to a cache line.
+
+; CHECK:       .section .text.bin_1
+; CHECK:       .p2align 6
+; CHECK-LABEL: caller:
+; CHECK:       .p2align 2
+; CHECK-LABEL: callee:
+; CHECK:       .p2align 6
+; CHECK-LABEL: cold:
+
+; NOLAYOUT-LABEL: cold:
+; NOLAYOUT-LABEL: callee:
+; NOLAYOUT-LABEL: caller:
+
+define void @legacy() { ret void }
+
+define hidden void @cold() pagerando !prof !15 {
+  ret void
+}
+
+define hidden void @callee() pagerando !prof !16 {
+  ret void
+}
+
+define hidden void @caller() pagerando !prof !16 {
+  call void @callee()
+  ret void
+}
+
+!llvm.module.flags = !{!1}
+!1 = !{i32 1, !"ProfileSummary", !2}
+!2 = !{!3, !4, !5, !6, !7, !8, !9, !10}
+!3 = !{!"ProfileFormat", !"InstrProf"}
+!4 = !{!"TotalCount", i64 10000}
+!5 = !{!"MaxCount", i64 1000}
+!6 = !{!"MaxInternalCount", i64 1}
+!7 = !{!"MaxFunctionCount", i64 1000}
+!8 = !{!"NumCounts", i64 3}
+!9 = !{!"NumFunctions", i64 3}
+!10 = !{!"DetailedSummary", !11}
+!11 = !{!12, !13, !14}
+!12 = !{i32 10000, i64 1000, i32 1}
+!13 = !{i32 999000, i64 1000, i32 3}
+!14 = !{i32 999999, i64 5, i32 3}
+!15 = !{!"function_entry_count", i64 1}
+!16 = !{!"function_entry_count", i64 1000}
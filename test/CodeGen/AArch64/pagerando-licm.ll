@@ -0,0 +1,37 @@
+; RUN: llc < %s -mtriple=aarch64-linux -relocation-model=pip -o - \
+; RUN:     -stop-after=early-machinelicm | FileCheck %s
+
+; The POT base is copied from x20 once in the entry block, so the POT load of
+; an inter-bin callee is hoisted out of the loop.
+
+; CHECK-LABEL: name: loop
+; CHECK:       bb.0.entry:
+; CHECK:         [[POT:%[0-9]+]]:gpr64 = COPY $x20
+; CHECK:         LOADpot [[POT]], target-flags(aarch64-pot) @callee
+; CHECK:         MOVaddrBIN
+; CHECK:       bb.1.body:
+; CHECK-NOT:     COPY $x20
+; CHECK-NOT:     LOADpot
+; CHECK-NOT:     MOVaddrBIN
+; CHECK:         BLR
+; CHECK:       bb.2.exit:
+
+define hidden void @callee() pagerando #1 { ret void }
+
+define hidden void @loop(i32 %n) pagerando #0 {
+entry:
+  br label %body
+
+body:
+  %i = phi i32 [ 0, %entry ], [ %inc, %body ]
+  call void @callee()
+  %inc = add i32 %i, 1
+  %cmp = icmp ult i32 %inc, %n
+  br i1 %cmp, label %body, label %exit
+
+exit:
+  ret void
+}
+
+attributes #0 = { "pagerando-bin"="1" }
+attributes #1 = { "pagerando-bin"="2" }
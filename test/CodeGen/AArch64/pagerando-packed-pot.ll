@@ -0,0 +1,38 @@
+; RUN: llc < %s -mtriple=aarch64-linux -relocation-model=pip -o - \
+; RUN:     -pagerando-packed-pot | FileCheck %s
+; RUN: llc < %s -mtriple=aarch64-linux -relocation-model=pip \
+; RUN:     -pagerando-packed-pot -filetype=obj -o - \
+; RUN:   | llvm-readobj -r | FileCheck %s --check-prefix=RELOCS
+
+; The bin entries of the POT are zero and described by self-relative offsets
+; in .pot.packed instead.
+
+; CHECK-LABEL: .section .pot
+; CHECK-LABEL: _PAGE_OFFSET_TABLE_:
+; CHECK-NEXT:  .xword _GLOBAL_OFFSET_TABLE_
+; CHECK-NEXT:  .zero 16
+; CHECK-NEXT:  _PAGE_OFFSET_TABLE_END_:
+; CHECK:       .section .pot.packed,"a",@progbits
+; CHECK-NEXT:  .p2align 2
+; CHECK-NEXT:  .word 2
+; CHECK-NEXT:  [[E1:.Ltmp[0-9]+]]:
+; CHECK-NEXT:  .word {{.+}}-[[E1]]
+; CHECK-NEXT:  [[E2:.Ltmp[0-9]+]]:
+; CHECK-NEXT:  .word {{.+}}-[[E2]]
+
+; RELOCS:      Section {{.*}} .rela.pot {
+; RELOCS-NEXT:   R_AARCH64_{{[A-Z0-9]+}} _GLOBAL_OFFSET_TABLE_
+; RELOCS-NEXT: }
+; RELOCS:      Section {{.*}} .rela.pot.packed {
+; RELOCS-NEXT:   R_AARCH64_PREL32 .text.bin_1
+; RELOCS-NEXT:   R_AARCH64_PREL32 .text.bin_2
+; RELOCS-NEXT: }
+
+define hidden void @a() pagerando "pagerando-bin"="1" { ret void }
+define hidden void @b() pagerando "pagerando-bin"="2" { ret void }
+
+define void @c() {
+  call void @a()
+  call void @b()
+  ret void
+}
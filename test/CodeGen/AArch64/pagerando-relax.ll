@@ -0,0 +1,31 @@
+; RUN: llc < %s -mtriple=aarch64-linux -relocation-model=pip -o - | FileCheck %s
+
+; Calls to functions that were assigned to the caller's bin in another module
+; are recorded in .pagerando_relax, so the linker can make them direct calls.
+
+; CHECK-LABEL: caller:
+; CHECK:       [[SAME:.Lpagerando_call[0-9_]+]]:
+; CHECK-NEXT:  blr
+; CHECK-NOT:   .Lpagerando_call
+; CHECK:       .section .pagerando_relax,"",@progbits
+; CHECK-NEXT:  .weak same$$orig
+; CHECK-NEXT:  .hidden same$$orig
+; CHECK-NEXT:  .xword [[SAME]]
+; CHECK-NEXT:  .xword same$$orig
+; CHECK-NOT:   .xword
+
+declare hidden void @same() #0
+declare hidden void @other() #1
+declare void @preemptible() #0
+declare hidden void @varargs(i32, ...) #0
+
+define hidden void @caller() pagerando #0 {
+  call void @same()
+  call void @other()
+  call void @preemptible()
+  call void (i32, ...) @varargs(i32 0)
+  ret void
+}
+
+attributes #0 = { "pagerando-bin"="1" }
+attributes #1 = { "pagerando-bin"="2" }
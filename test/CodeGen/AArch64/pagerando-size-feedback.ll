@@ -0,0 +1,33 @@
+; RUN: llc < %s -mtriple=aarch64-linux -relocation-model=pip -o /dev/null \
+; RUN:     -pagerando-size-feedback-output=%t.sizes
+; RUN: FileCheck --check-prefix=SIZES %s < %t.sizes
+
+; RUN: echo "a 3000" > %t.feedback
+; RUN: echo "b 3000" >> %t.feedback
+; RUN: echo "c 1000" >> %t.feedback
+; RUN: llc < %s -mtriple=aarch64-linux -relocation-model=pip -o - \
+; RUN:     -pagerando-size-feedback=%t.feedback | FileCheck %s
+
+; RUN: echo "a" > %t.malformed
+; RUN: not llc < %s -mtriple=aarch64-linux -relocation-model=pip -o /dev/null \
+; RUN:     -pagerando-size-feedback=%t.malformed 2>&1 \
+; RUN:   | FileCheck --check-prefix=ERROR %s
+
+; SIZES:      a {{[0-9]+}}
+; SIZES-NEXT: b {{[0-9]+}}
+; SIZES-NEXT: c {{[0-9]+}}
+; SIZES-NOT:  legacy
+
+; CHECK-LABEL: .section .text.bin_1
+; CHECK-LABEL: a:
+; CHECK-LABEL: .section .text.bin_2
+; CHECK-LABEL: b:
+; CHECK-LABEL: .section .text.bin_1
+; CHECK-LABEL: c:
+
+; ERROR: malformed size feedback entry 'a'
+
+define void @legacy() { ret void }
+define hidden void @a() pagerando { ret void }
+define hidden void @b() pagerando { ret void }
+define hidden void @c() pagerando { ret void }
@@ -0,0 +1,34 @@
+; RUN: llc -mtriple arm-unknown -global-isel -global-isel-abort=0 \
+; RUN:     -global-isel-report=%t.json %s -o /dev/null
+; RUN: FileCheck %s < %t.json
+
+; The report lists every function with its GlobalISel time, and the failing
+; pass and reason for the functions that fell back to SelectionDAG.
+
+; CHECK:      "functions": [
+; CHECK-NEXT:   {
+; CHECK-NEXT:     "fallback": false,
+; CHECK-NEXT:     "name": "test_i32",
+; CHECK-NEXT:     "time_ms": {{[0-9.e+-]+}}
+; CHECK-NEXT:   },
+; CHECK-NEXT:   {
+; CHECK-NEXT:     "fallback": true,
+; CHECK-NEXT:     "name": "test_i64",
+; CHECK-NEXT:     "pass": "gisel-irtranslator",
+; CHECK-NEXT:     "reason": "unable to lower arguments: i64 (i64, i64)* (in function: test_i64)",
+; CHECK-NEXT:     "time_ms": {{[0-9.e+-]+}}
+; CHECK-NEXT:   }
+; CHECK-NEXT: ],
+; CHECK-NEXT: "num_fallbacks": 1,
+; CHECK-NEXT: "num_functions": 2,
+; CHECK-NEXT: "total_time_ms": {{[0-9.e+-]+}}
+
+define i32 @test_i32(i32 %a, i32 %b) {
+  %res = add i32 %a, %b
+  ret i32 %res
+}
+
+define i64 @test_i64(i64 %a, i64 %b) {
+  %res = add i64 %a, %b
+  ret i64 %res
+}
@@ -0,0 +1,29 @@
+; RUN: llc < %s -mtriple=armv7-linux -relocation-model=pip -o /dev/null \
+; RUN:     -pagerando-bin-report=%t.json
+; RUN: FileCheck %s < %t.json
+; RUN: llc < %s -mtriple=armv7-linux -relocation-model=pip -o /dev/null \
+; RUN:     -arm-constant-island-profile-guided -pagerando-bin-report=%t.pgo.json
+; RUN: FileCheck %s < %t.pgo.json
+
+; The address of @global_var is loaded from a constant island in @user, which
+; is reported with the function. @leaf has no islands.
+
+; CHECK:          "functions": [
+; CHECK:              "estimated_size": {{[0-9]+}},
+; CHECK-NEXT:         "final_size": {{[0-9]+}},
+; CHECK-NEXT:         "name": "leaf"
+; CHECK:              "estimated_size": {{[0-9]+}},
+; CHECK-NEXT:         "final_size": {{[0-9]+}},
+; CHECK-NEXT:         "island_bytes": {{[1-9][0-9]*}},
+; CHECK-NEXT:         "name": "user"
+
+@global_var = global i32 0
+
+define hidden void @leaf() pagerando "pagerando-bin"="1" {
+  ret void
+}
+
+define hidden i32 @user() pagerando "pagerando-bin"="1" {
+  %v = load i32, i32* @global_var
+  ret i32 %v
+}
@@ -0,0 +1,88 @@
+; RUN: llc < %s -mtriple=x86_64-linux -enable-ext-tsp-block-placement \
+; RUN:   | FileCheck %s
+; RUN: llc < %s -mtriple=x86_64-linux | FileCheck %s
+
+; The hot path through both diamonds falls through, and the cold blocks are
+; moved after it. @attr is reordered because of its attribute, @prof because
+; of its profile.
+
+; CHECK-LABEL: attr:
+; CHECK:       callq hot1
+; CHECK-NOT:   callq cold
+; CHECK:       callq hot2
+; CHECK-NOT:   callq cold
+; CHECK:       callq exit
+; CHECK:       callq cold
+
+; CHECK-LABEL: prof:
+; CHECK:       callq hot1
+; CHECK-NOT:   callq cold
+; CHECK:       callq hot2
+; CHECK-NOT:   callq cold
+; CHECK:       callq exit
+; CHECK:       callq cold
+
+declare void @hot1()
+declare void @hot2()
+declare void @cold1()
+declare void @cold2()
+declare void @exit()
+
+define void @attr(i1 %a, i1 %b) "ext-tsp-block-placement" {
+entry:
+  br i1 %a, label %cold1, label %hot1, !prof !1
+
+hot1:
+  call void @hot1()
+  br label %mid
+
+cold1:
+  call void @cold1()
+  br label %mid
+
+mid:
+  br i1 %b, label %cold2, label %hot2, !prof !1
+
+hot2:
+  call void @hot2()
+  br label %exit
+
+cold2:
+  call void @cold2()
+  br label %exit
+
+exit:
+  call void @exit()
+  ret void
+}
+
+define void @prof(i1 %a, i1 %b) !prof !0 {
+entry:
+  br i1 %a, label %cold1, label %hot1, !prof !1
+
+hot1:
+  call void @hot1()
+  br label %mid
+
+cold1:
+  call void @cold1()
+  br label %mid
+
+mid:
+  br i1 %b, label %cold2, label %hot2, !prof !1
+
+hot2:
+  call void @hot2()
+  br label %exit
+
+cold2:
+  call void @cold2()
+  br label %exit
+
+exit:
+  call void @exit()
+  ret void
+}
+
+!0 = !{!"function_entry_count", i64 1000}
+!1 = !{!"branch_weights", i32 1, i32 1000}
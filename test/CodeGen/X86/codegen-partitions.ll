@@ -0,0 +1,43 @@
+; RUN: llc < %s -mtriple=x86_64-unknown-linux -codegen-partitions=2 \
+; RUN:     -split-module-call-affinity -o %t.s
+; RUN: FileCheck --check-prefix=CHECK0 %s < %t.s
+; RUN: FileCheck --check-prefix=CHECK1 %s < %t.s.1
+; RUN: not llc < %s -mtriple=x86_64-unknown-linux -codegen-partitions=2 \
+; RUN:     -o - 2>&1 | FileCheck --check-prefix=ERR %s
+
+; Each partition is compiled into its own output file. Functions connected by
+; hot calls end up in the same partition.
+
+; CHECK0-LABEL: a:
+; CHECK0:       callq b
+; CHECK0-LABEL: b:
+; CHECK0-NOT:   {{^}}c:
+; CHECK0-NOT:   {{^}}d:
+
+; CHECK1-LABEL: c:
+; CHECK1:       callq d
+; CHECK1-LABEL: d:
+; CHECK1-NOT:   {{^}}a:
+; CHECK1-NOT:   {{^}}b:
+
+; ERR: -codegen-partitions requires IR input and a named output file
+
+define void @a() !prof !0 {
+  call void @b()
+  ret void
+}
+
+define void @b() !prof !0 {
+  ret void
+}
+
+define void @c() !prof !0 {
+  call void @d()
+  ret void
+}
+
+define void @d() !prof !0 {
+  ret void
+}
+
+!0 = !{!"function_entry_count", i64 1000}
@@ -0,0 +1,26 @@
+; RUN: llc < %s -mtriple=x86_64-unknown-linux | FileCheck %s
+; RUN: llc < %s -mtriple=x86_64-unknown-linux -combiner-skip-unchanged \
+; RUN:   | FileCheck %s
+; RUN: llc < %s -mtriple=x86_64-unknown-linux -combiner-skip-unchanged \
+; RUN:     -o /dev/null -stats 2>&1 | FileCheck --check-prefix=STATS %s
+; REQUIRES: asserts
+
+; Folding the multiplication by one puts the add back on the worklist, but
+; nothing the add depends on changed, so it is not combined again.
+
+; CHECK-LABEL: f:
+; CHECK:       leal
+; CHECK-NOT:   imull
+
+; STATS: {{[0-9]+}} dagcombine - Number of dag nodes visited by the combiner
+; STATS: {{[0-9]+}} dagcombine - Number of unchanged dag nodes not revisited
+; STATS: {{[0-9]+}} dagcombine - Number of dag nodes combined
+
+define i32 @f(i32 %a, i32 %b, i32* %p) {
+  %x = add i32 %a, %b
+  %m = mul i32 %x, 1
+  store i32 %x, i32* %p
+  %r = xor i32 %m, %x
+  %s = or i32 %r, %x
+  ret i32 %s
+}
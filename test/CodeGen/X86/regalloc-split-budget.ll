@@ -0,0 +1,47 @@
+; RUN: llc < %s -mtriple=x86_64-unknown-linux -regalloc-split-budget=1 \
+; RUN:     -o /dev/null -stats 2>&1 | FileCheck %s
+; RUN: llc < %s -mtriple=x86_64-unknown-linux -o /dev/null -stats 2>&1 \
+; RUN:   | FileCheck --check-prefix=NOBUDGET %s
+; REQUIRES: asserts
+
+; Once the split budget is used up, the remaining live ranges are spilled
+; without trying to split them.
+
+; CHECK: 1 regalloc - Number of functions over the split budget
+; NOBUDGET-NOT: over the split budget
+
+declare void @g()
+
+define i64 @f(i64* %p, i64 %n) {
+entry:
+  %a0 = load volatile i64, i64* %p
+  %a1 = load volatile i64, i64* %p
+  %a2 = load volatile i64, i64* %p
+  %a3 = load volatile i64, i64* %p
+  %a4 = load volatile i64, i64* %p
+  %a5 = load volatile i64, i64* %p
+  %a6 = load volatile i64, i64* %p
+  %a7 = load volatile i64, i64* %p
+  br label %loop
+
+loop:
+  %i = phi i64 [ 0, %entry ], [ %i.next, %loop ]
+  call void @g()
+  store volatile i64 %a0, i64* %p
+  store volatile i64 %a1, i64* %p
+  store volatile i64 %a2, i64* %p
+  store volatile i64 %a3, i64* %p
+  %i.next = add i64 %i, 1
+  %c = icmp ult i64 %i.next, %n
+  br i1 %c, label %loop, label %exit
+
+exit:
+  %s0 = add i64 %a0, %a4
+  %s1 = add i64 %a1, %a5
+  %s2 = add i64 %a2, %a6
+  %s3 = add i64 %a3, %a7
+  %t0 = add i64 %s0, %s1
+  %t1 = add i64 %s2, %s3
+  %r = add i64 %t0, %t1
+  ret i64 %r
+}
@@ -0,0 +1,29 @@
+; RUN: llc < %s -mtriple=x86_64-unknown-linux -o /dev/null -stats 2>&1 \
+; RUN:   | FileCheck %s
+; REQUIRES: asserts
+
+; Operand lists of the first block's DAG are reused by the following blocks.
+
+; CHECK: {{[0-9]+}} selectiondag - Maximum bytes allocated for SDNode operands
+; CHECK: {{[0-9]+}} selectiondag - Maximum number of SDNodes in a block
+; CHECK: {{[0-9]+}} selectiondag - Number of SDNode operand lists allocated
+; CHECK: {{[0-9]+}} selectiondag - Number of SDNode operand lists reused
+; CHECK: {{[0-9]+}} selectiondag - Number of SDNodes created
+
+define i32 @f(i32 %a, i32 %b, i1 %c) {
+entry:
+  %x = add i32 %a, %b
+  br i1 %c, label %then, label %else
+
+then:
+  %y = mul i32 %x, %a
+  br label %exit
+
+else:
+  %z = sub i32 %x, %b
+  br label %exit
+
+exit:
+  %r = phi i32 [ %y, %then ], [ %z, %else ]
+  ret i32 %r
+}
@@ -0,0 +1,49 @@
+; RUN: llc < %s -mtriple=x86_64-linux -pass-remarks-analysis=sdagisel \
+; RUN:     -o /dev/null 2>&1 | FileCheck %s
+
+; The dominant case is peeled, and the remaining cases form a jump table.
+
+; CHECK: remark: {{.*}} peeled switch case 5 with probability {{[0-9]+}}%
+; CHECK: remark: {{.*}} lowered switch to 1 jump tables, 0 bit tests and 0 ranges
+
+define i32 @dispatch(i32 %op) {
+entry:
+  switch i32 %op, label %def [
+    i32 0, label %bb0
+    i32 1, label %bb1
+    i32 2, label %bb2
+    i32 3, label %bb3
+    i32 4, label %bb4
+    i32 5, label %bb5
+  ], !prof !0
+
+bb0:
+  %r0 = call i32 @f0()
+  ret i32 %r0
+bb1:
+  %r1 = call i32 @f1()
+  ret i32 %r1
+bb2:
+  %r2 = call i32 @f2()
+  ret i32 %r2
+bb3:
+  %r3 = call i32 @f3()
+  ret i32 %r3
+bb4:
+  %r4 = call i32 @f4()
+  ret i32 %r4
+bb5:
+  %r5 = call i32 @f5()
+  ret i32 %r5
+def:
+  ret i32 0
+}
+
+declare i32 @f0()
+declare i32 @f1()
+declare i32 @f2()
+declare i32 @f3()
+declare i32 @f4()
+declare i32 @f5()
+
+!0 = !{!"branch_weights", i32 1, i32 2, i32 2, i32 2, i32 2, i32 1, i32 90}
@@ -0,0 +1,30 @@
+; RUN: llvm-as %s -o %t.bc
+; RUN: lli -jit-kind=orc-lazy -orc-lazy-debug=funcs-to-stdout %t.bc \
+; RUN:   | FileCheck --check-prefix=CHECK-PER-FUNCTION %s
+; RUN: lli -jit-kind=orc-lazy -per-module-lazy -orc-lazy-debug=funcs-to-stdout \
+; RUN:   %t.bc | FileCheck --check-prefix=CHECK-WHOLE-MODULE %s
+;
+; Checks that bitcode, which lli loads lazily, runs both when only the called
+; functions are read and when the whole module is.
+;
+; CHECK-PER-FUNCTION-NOT: unused
+; CHECK-PER-FUNCTION-DAG: main
+; CHECK-PER-FUNCTION-DAG: foo
+; CHECK-PER-FUNCTION-NOT: unused
+; CHECK-WHOLE-MODULE: unused
+
+define i32 @unused() {
+entry:
+  ret i32 1
+}
+
+define i32 @foo() {
+entry:
+  ret i32 0
+}
+
+define i32 @main(i32 %argc, i8** nocapture readnone %argv) {
+entry:
+  %0 = call i32() @foo()
+  ret i32 %0
+}
@@ -0,0 +1,20 @@
+; RUN: rm -rf %t.cache
+; RUN: lli -jit-kind=orc-lazy -enable-cache-manager -object-cache-dir=%t.cache %s
+; RUN: ls %t.cache | FileCheck %s
+; RUN: lli -jit-kind=orc-lazy -enable-cache-manager -object-cache-dir=%t.cache %s
+;
+; Checks that the objects compiled by the lazy JIT are stored in the cache
+; directory, and that a second run can use them.
+;
+; CHECK: llvmcache-{{[0-9a-f]+}}
+
+define i32 @foo() {
+entry:
+  ret i32 0
+}
+
+define i32 @main(i32 %argc, i8** nocapture readnone %argv) {
+entry:
+  %0 = call i32 @foo()
+  ret i32 %0
+}
@@ -0,0 +1,100 @@
+; Test that -asan-opt-dominating shares checks between accesses.
+; RUN: opt < %s -asan -asan-module -asan-opt-dominating -asan-instrumentation-with-call-threshold=0 -S | FileCheck %s
+; RUN: opt < %s -asan -asan-module -asan-instrumentation-with-call-threshold=0 -S | FileCheck %s -check-prefix=NOOPT
+
+target datalayout = "e-p:64:64:64-i1:8:8-i8:8:8-i16:16:16-i32:32:32-i64:64:64-f32:32:32-f64:64:64-v64:64:64-v128:128:128-a0:0:64-s0:64:64-f80:128:128-n8:16:32:64"
+target triple = "x86_64-unknown-linux-gnu"
+
+%struct.S = type { i32, i32, i64 }
+
+; The three adjacent fields are checked as one aligned 16-byte access.
+define void @fields(%struct.S* %s) sanitize_address {
+entry:
+  %a = getelementptr inbounds %struct.S, %struct.S* %s, i64 0, i32 0
+  %b = getelementptr inbounds %struct.S, %struct.S* %s, i64 0, i32 1
+  %c = getelementptr inbounds %struct.S, %struct.S* %s, i64 0, i32 2
+  store i32 1, i32* %a, align 8
+  store i32 2, i32* %b, align 4
+  store i64 3, i64* %c, align 8
+  ret void
+}
+; CHECK-LABEL: @fields
+; CHECK: call void @__asan_store16
+; CHECK-NEXT: store i32 1
+; CHECK-NEXT: store i32 2
+; CHECK-NEXT: store i64 3
+; CHECK-NOT: __asan_store
+; CHECK: ret void
+; NOOPT-LABEL: @fields
+; NOOPT: call void @__asan_store4
+; NOOPT: call void @__asan_store4
+; NOOPT: call void @__asan_store8
+; NOOPT: ret void
+
+; A call between the two accesses keeps them apart.
+define void @fields_call(%struct.S* %s) sanitize_address {
+entry:
+  %a = getelementptr inbounds %struct.S, %struct.S* %s, i64 0, i32 0
+  %b = getelementptr inbounds %struct.S, %struct.S* %s, i64 0, i32 1
+  store i32 1, i32* %a, align 8
+  call void @f()
+  store i32 2, i32* %b, align 4
+  ret void
+}
+; CHECK-LABEL: @fields_call
+; CHECK: call void @__asan_store4
+; CHECK: call void @f()
+; CHECK-NEXT: call void @__asan_store4
+; CHECK: ret void
+
+; The load in %then has been checked in its single predecessor.
+define i32 @dominated(i32* %p, i1 %c) sanitize_address {
+entry:
+  %x = load i32, i32* %p, align 4
+  br i1 %c, label %then, label %exit
+
+then:
+  %y = load i32, i32* %p, align 4
+  br label %exit
+
+exit:
+  %r = phi i32 [ %x, %entry ], [ %y, %then ]
+  ret i32 %r
+}
+; CHECK-LABEL: @dominated
+; CHECK: call void @__asan_load4
+; CHECK-NOT: __asan_load
+; CHECK: ret i32
+; NOOPT-LABEL: @dominated
+; NOOPT: call void @__asan_load4
+; NOOPT: call void @__asan_load4
+; NOOPT: ret i32
+
+; The store to a loop-invariant address is checked once in the preheader.
+define void @invariant(i32* %p, i32 %n) sanitize_address {
+entry:
+  br label %loop
+
+loop:
+  %i = phi i32 [ 0, %entry ], [ %i.next, %loop ]
+  store i32 %i, i32* %p, align 4
+  %i.next = add i32 %i, 1
+  %done = icmp eq i32 %i.next, %n
+  br i1 %done, label %exit, label %loop
+
+exit:
+  ret void
+}
+; CHECK-LABEL: @invariant
+; CHECK: entry:
+; CHECK-NEXT: [[P:%[0-9]+]] = ptrtoint i32* %p to i64
+; CHECK-NEXT: call void @__asan_store4(i64 [[P]])
+; CHECK-NEXT: br label %loop
+; CHECK: loop:
+; CHECK-NOT: __asan_store
+; CHECK: ret void
+; NOOPT-LABEL: @invariant
+; NOOPT: loop:
+; NOOPT: call void @__asan_store4
+
+declare void @f()
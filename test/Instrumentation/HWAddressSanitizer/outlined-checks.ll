@@ -0,0 +1,50 @@
+; Test -hwasan-outlined-checks and -hwasan-opt-same-pointer.
+;
+; RUN: opt < %s -hwasan -hwasan-outlined-checks -hwasan-recover=0 -hwasan-mapping-offset=0 -S | FileCheck %s --check-prefixes=CHECK,OUTLINED
+; RUN: opt < %s -hwasan -hwasan-outlined-checks -hwasan-recover=1 -hwasan-mapping-offset=0 -S | FileCheck %s --check-prefixes=CHECK,RECOVER
+; RUN: opt < %s -hwasan -hwasan-opt-same-pointer -hwasan-recover=0 -hwasan-mapping-offset=0 -S | FileCheck %s --check-prefixes=CHECK,SAME
+
+target datalayout = "e-m:e-i8:8:32-i16:16:32-i64:64-i128:128-n32:64-S128"
+target triple = "aarch64--linux-android"
+
+define i32 @load_store(i32* %a) sanitize_hwaddress {
+entry:
+  %x = load i32, i32* %a, align 4
+  %y = add i32 %x, 1
+  store i32 %y, i32* %a, align 4
+  ret i32 %x
+}
+; CHECK-LABEL: @load_store
+
+; OUTLINED: %[[A:[^ ]*]] = ptrtoint i32* %a to i64
+; OUTLINED-NEXT: %[[P:[^ ]*]] = inttoptr i64 %[[A]] to i8*
+; OUTLINED-NEXT: call void @llvm.hwasan.check.memaccess(i8* null, i8* %[[P]], i32 2)
+; OUTLINED-NEXT: %x = load i32, i32* %a, align 4
+; OUTLINED: call void @llvm.hwasan.check.memaccess(i8* null, i8* %{{.*}}, i32 18)
+; OUTLINED-NEXT: store i32 %y, i32* %a, align 4
+
+; The outlined routines cannot recover.
+; RECOVER-NOT: @llvm.hwasan.check.memaccess
+; RECOVER: "brk #2338"
+; RECOVER: "brk #2354"
+
+; The store goes through the pointer the load checked.
+; SAME: "brk #2306"
+; SAME-NOT: "brk #2322"
+
+; CHECK: ret i32 %x
+
+define void @call_between(i32* %a) sanitize_hwaddress {
+entry:
+  store i32 0, i32* %a, align 4
+  call void @g()
+  store i32 1, i32* %a, align 4
+  ret void
+}
+; CHECK-LABEL: @call_between
+; SAME: "brk #2322"
+; SAME: call void @g()
+; SAME: "brk #2322"
+; CHECK: ret void
+
+declare void @g()
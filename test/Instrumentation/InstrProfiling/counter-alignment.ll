@@ -0,0 +1,27 @@
+; RUN: opt < %s -S -instrprof | FileCheck %s --check-prefix=DEFAULT
+; RUN: opt < %s -S -instrprof -instrprof-counter-alignment=64 | FileCheck %s
+
+; Aligning the counters of each function to a cache line keeps functions
+; that run on different threads from sharing counter cache lines.
+
+target triple = "x86_64-unknown-linux-gnu"
+
+@__profn_foo = hidden constant [3 x i8] c"foo"
+@__profn_bar = hidden constant [3 x i8] c"bar"
+
+; DEFAULT: @__profc_foo = {{.*}} section "__llvm_prf_cnts", align 8
+; DEFAULT: @__profc_bar = {{.*}} section "__llvm_prf_cnts", align 8
+; CHECK: @__profc_foo = {{.*}} section "__llvm_prf_cnts", align 64
+; CHECK: @__profc_bar = {{.*}} section "__llvm_prf_cnts", align 64
+
+define void @foo() {
+  call void @llvm.instrprof.increment(i8* getelementptr inbounds ([3 x i8], [3 x i8]* @__profn_foo, i32 0, i32 0), i64 0, i32 1, i32 0)
+  ret void
+}
+
+define void @bar() {
+  call void @llvm.instrprof.increment(i8* getelementptr inbounds ([3 x i8], [3 x i8]* @__profn_bar, i32 0, i32 0), i64 0, i32 2, i32 1)
+  ret void
+}
+
+declare void @llvm.instrprof.increment(i8*, i64, i32, i32)
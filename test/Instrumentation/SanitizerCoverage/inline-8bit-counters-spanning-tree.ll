@@ -0,0 +1,38 @@
+; Test -sanitizer-coverage-spanning-tree with -sanitizer-coverage-inline-8bit-counters
+; RUN: opt < %s -sancov -sanitizer-coverage-level=3 -sanitizer-coverage-inline-8bit-counters=1 -sanitizer-coverage-spanning-tree -S | FileCheck %s
+
+target datalayout = "e-m:e-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-unknown-linux-gnu"
+
+; The entry block runs as often as %a and %b together, so only those two
+; increment their counters.
+; CHECK: @__sancov_gen_ = private global [3 x i8] zeroinitializer, section "__sancov_cntrs", comdat($foo)
+; CHECK: @__sancov_gen_.1 = private constant [6 x i64*] [i64* bitcast ([3 x i8]* @__sancov_gen_ to i64*), i64* inttoptr (i64 2 to i64*), i64* bitcast (i8* getelementptr inbounds ([3 x i8], [3 x i8]* @__sancov_gen_, i64 0, i64 1) to i64*), i64* inttoptr (i64 1 to i64*), i64* bitcast (i8* getelementptr inbounds ([3 x i8], [3 x i8]* @__sancov_gen_, i64 0, i64 2) to i64*), i64* inttoptr (i64 1 to i64*)], section "__sancov_cntrs_derived", comdat($foo)
+define void @foo(i1 %c) {
+; CHECK-LABEL: define void @foo
+; CHECK-NEXT: entry:
+; CHECK-NEXT: br i1 %c, label %a, label %b
+entry:
+  br i1 %c, label %a, label %b
+
+; CHECK: a:
+; CHECK-NEXT: load i8, i8* getelementptr inbounds ([3 x i8], [3 x i8]* @__sancov_gen_, i64 0, i64 1), !nosanitize
+a:
+  call void @bar()
+  br label %exit
+
+; CHECK: b:
+; CHECK-NEXT: load i8, i8* getelementptr inbounds ([3 x i8], [3 x i8]* @__sancov_gen_, i64 0, i64 2), !nosanitize
+b:
+  br label %exit
+
+; CHECK: exit:
+; CHECK-NEXT: ret void
+exit:
+  ret void
+}
+
+declare void @bar()
+
+; CHECK: call void @__sanitizer_cov_8bit_counters_init(
+; CHECK-NEXT: call void @__sanitizer_cov_8bit_counters_derived_init({{.*}}@__start___sancov_cntrs_derived{{.*}}@__stop___sancov_cntrs_derived
@@ -0,0 +1,15 @@
+; Test that appending variables are linked correctly across several modules,
+; including one whose initializer is identical to the accumulated array.
+
+; RUN: echo "@X = appending global [1 x i32] [i32 8] " | \
+; RUN:   llvm-as > %t.2.bc
+; RUN: echo "@X = appending global [1 x i32] [i32 9] " | \
+; RUN:   llvm-as > %t.3.bc
+; RUN: echo "@X = appending global [3 x i32] [i32 7, i32 4, i32 8] " | \
+; RUN:   llvm-as > %t.4.bc
+; RUN: llvm-as < %s > %t.1.bc
+; RUN: llvm-link %t.1.bc %t.2.bc %t.3.bc %t.4.bc -S | FileCheck %s
+; CHECK: @X = appending global [7 x i32] [i32 7, i32 4, i32 8, i32 9, i32 7, i32 4, i32 8]
+
+@X = appending global [2 x i32] [ i32 7, i32 4 ]
+@Y = global i32* getelementptr ([2 x i32], [2 x i32]* @X, i64 0, i64 0)
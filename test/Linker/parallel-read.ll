@@ -0,0 +1,20 @@
+; Reading the inputs on several threads links them in the same order.
+; RUN: llvm-as %S/Inputs/basiclink.a.ll -o %t.a.bc
+; RUN: llvm-as %S/Inputs/basiclink.b.ll -o %t.b.bc
+; RUN: llvm-link -j 4 %s %t.a.bc %t.b.bc -S | FileCheck %s
+; RUN: llvm-link %s %t.a.bc %t.b.bc -S | FileCheck %s
+; RUN: not llvm-link -j 4 %s %t.missing.bc %t.a.bc -S 2>&1 \
+; RUN:   | FileCheck --check-prefix=MISSING %s
+
+; CHECK: @baz = global i32 0
+; CHECK-LABEL: define i32 @main
+; CHECK-LABEL: define i32* @foo(i32 %x)
+; CHECK-NEXT: ret i32* @baz
+; CHECK-LABEL: define i32* @bar()
+
+; MISSING: missing.bc: error: Could not open input file
+; MISSING: error:  loading file '{{.*}}missing.bc'
+
+define i32 @main() {
+  ret i32 0
+}
@@ -0,0 +1,30 @@
+// RUN: llvm-mc -filetype=obj -triple x86_64-pc-linux %s -o %t
+// RUN: llvm-mc -filetype=obj -triple x86_64-pc-linux %s -o %t.compact \
+// RUN:   -mc-compact-fragments
+// RUN: cmp %t %t.compact
+
+// Data is appended to a data fragment again after a subsection switch.
+
+	.text
+f:
+	.fill 100, 1, 0x90
+	callq g
+	.p2align 4
+	.fill 40, 1, 0x90
+	jmp f
+
+	.text 1
+g:
+	movq d(%rip), %rax
+	retq
+
+	.text 0
+	callq f
+	.quad d
+
+	.data
+d:
+	.quad f
+	.quad g
+	.p2align 3
+	.fill 70, 1, 0
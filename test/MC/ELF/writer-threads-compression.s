@@ -0,0 +1,37 @@
+// REQUIRES: zlib
+// RUN: llvm-mc -filetype=obj -triple x86_64-pc-linux %s -o %t.zserial \
+// RUN:   -compress-debug-sections=zlib
+// RUN: llvm-mc -filetype=obj -triple x86_64-pc-linux %s -o %t.zparallel \
+// RUN:   -compress-debug-sections=zlib -elf-writer-threads=3
+// RUN: cmp %t.zserial %t.zparallel
+// RUN: llvm-readobj -sections %t.zparallel | FileCheck %s
+
+// CHECK:      Name: .debug_str
+// CHECK-NEXT: Type: SHT_PROGBITS
+// CHECK-NEXT: Flags [
+// CHECK-NEXT:   SHF_COMPRESSED
+
+	.section .text.f,"ax",@progbits
+f:
+	.p2align 4
+	callq g
+	jmp f
+	retq
+
+	.section .text.g,"axG",@progbits,g,comdat
+g:
+	.fill 100, 1, 0x90
+	retq
+
+	.section .data.d,"aw",@progbits
+d:
+	.quad f
+	.quad g
+
+	.bss
+	.zero 64
+
+	.section .debug_str,"MS",@progbits,1
+	.rept 64
+	.asciz "a debug string that compresses well"
+	.endr
@@ -0,0 +1,29 @@
+// RUN: llvm-mc -filetype=obj -triple x86_64-pc-linux %s -o %t.serial
+// RUN: llvm-mc -filetype=obj -triple x86_64-pc-linux %s -o %t.parallel \
+// RUN:   -elf-writer-threads=3
+// RUN: cmp %t.serial %t.parallel
+
+	.section .text.f,"ax",@progbits
+f:
+	.p2align 4
+	callq g
+	jmp f
+	retq
+
+	.section .text.g,"axG",@progbits,g,comdat
+g:
+	.fill 100, 1, 0x90
+	retq
+
+	.section .data.d,"aw",@progbits
+d:
+	.quad f
+	.quad g
+
+	.bss
+	.zero 64
+
+	.section .debug_str,"MS",@progbits,1
+	.rept 64
+	.asciz "a debug string that compresses well"
+	.endr
@@ -0,0 +1,31 @@
+; REQUIRES: asserts
+; RUN: env LLVM_OVERRIDE_PRODUCER=producer opt -o %t.bc %s
+; RUN: rm -rf %t.cache
+
+; A different producer requires an upgrade, which is stored in the cache.
+; RUN: env LLVM_OVERRIDE_PRODUCER=consumer llvm-lto2 run %t.bc -o %t.o \
+; RUN:   -r %t.bc,foo,px -irsymtab-cache-dir=%t.cache -stats 2>&1 \
+; RUN:   | FileCheck --check-prefix=MISS %s
+; RUN: ls %t.cache | count 1
+
+; The second link reads the upgraded symbol table from the cache.
+; RUN: env LLVM_OVERRIDE_PRODUCER=consumer llvm-lto2 run %t.bc -o %t2.o \
+; RUN:   -r %t.bc,foo,px -irsymtab-cache-dir=%t.cache -stats 2>&1 \
+; RUN:   | FileCheck --check-prefix=HIT %s
+; RUN: cmp %t.o.0 %t2.o.0
+
+; A matching producer does not need an upgrade and leaves the cache alone.
+; RUN: rm -rf %t.cache
+; RUN: env LLVM_OVERRIDE_PRODUCER=producer llvm-lto2 run %t.bc -o %t3.o \
+; RUN:   -r %t.bc,foo,px -irsymtab-cache-dir=%t.cache
+; RUN: not ls %t.cache
+
+; MISS-NOT: irsymtab
+; HIT: 1 irsymtab - Number of upgraded symbol tables read from the cache
+
+target datalayout = "e-m:e-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-unknown-linux-gnu"
+
+define void @foo() {
+  ret void
+}
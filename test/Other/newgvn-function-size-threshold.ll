@@ -0,0 +1,24 @@
+; RUN: opt -O2 -debug-pass=Structure < %s -o /dev/null 2>&1 \
+; RUN:   | FileCheck %s --check-prefix=DEFAULT
+; RUN: opt -O2 -newgvn-function-size-threshold=1000 -debug-pass=Structure \
+; RUN:     < %s -o /dev/null 2>&1 | FileCheck %s
+
+; With a size threshold, GVN is followed by NewGVN, which handles the
+; functions GVN skips.
+
+; DEFAULT:      MergedLoadStoreMotion
+; DEFAULT:      Memory Dependence Analysis
+; DEFAULT:      Global Value Numbering
+; DEFAULT-NOT:  Global Value Numbering
+; DEFAULT:      MemCpy Optimization
+
+; CHECK:        MergedLoadStoreMotion
+; CHECK:        Memory Dependence Analysis
+; CHECK:        Global Value Numbering
+; CHECK:        Memory SSA
+; CHECK-NEXT:   Global Value Numbering
+; CHECK:        MemCpy Optimization
+
+define void @f() {
+  ret void
+}
@@ -0,0 +1,27 @@
+; Optimize several modules listed in a file in one opt process.
+; RUN: rm -rf %t && mkdir -p %t
+; RUN: echo "%s %t/a.ll" > %t/list
+; RUN: echo "# The same module again." >> %t/list
+; RUN: echo "" >> %t/list
+; RUN: echo "%s %t/b.ll" >> %t/list
+; RUN: opt -batch %t/list -instsimplify -S
+; RUN: FileCheck %s < %t/a.ll
+; RUN: FileCheck %s < %t/b.ll
+; RUN: rm %t/a.ll %t/b.ll
+; RUN: opt -batch %t/list -batch-threads=2 -instsimplify -S
+; RUN: FileCheck %s < %t/a.ll
+; RUN: FileCheck %s < %t/b.ll
+
+; RUN: not opt -batch %t/list %s -S 2>&1 | FileCheck --check-prefix=ARGS %s
+; ARGS: -batch takes the input and output files from its list
+
+; RUN: echo "%s" > %t/bad-list
+; RUN: not opt -batch %t/bad-list -S 2>&1 | FileCheck --check-prefix=BAD %s
+; BAD: bad-list: no output file for '{{.*}}opt-batch.ll'
+
+; CHECK-LABEL: define i32 @f(
+; CHECK-NEXT: ret i32 %x
+define i32 @f(i32 %x) {
+  %y = add i32 %x, 0
+  ret i32 %y
+}
@@ -0,0 +1,26 @@
+; RUN: opt < %s -disable-output -passes='function(instcombine),globaldce' \
+; RUN:     -pass-trace=%t.json
+; RUN: FileCheck %s < %t.json
+; RUN: FileCheck %s --check-prefix=ARGS < %t.json
+
+; CHECK:      "traceEvents": [
+; CHECK:          "name": "InstCombinePass",
+; CHECK-NEXT:     "ph": "X",
+; CHECK-NEXT:     "pid": 1,
+; CHECK-NEXT:     "tid": 0,
+; CHECK-NEXT:     "ts": {{[0-9]+}}
+; CHECK:          "name": "GlobalDCEPass",
+
+; ARGS:      "args": {
+; ARGS-NEXT:   "instructions": 3,
+; ARGS-NEXT:   "malloc_after": {{[0-9]+}},
+; ARGS-NEXT:   "malloc_before": {{[0-9]+}},
+; ARGS-NEXT:   "malloc_peak": {{[0-9]+}}
+; ARGS-NEXT: },
+; ARGS-NEXT: "dur": {{[0-9]+}},
+
+define i32 @f(i32 %x) {
+  %a = add i32 %x, 0
+  %b = mul i32 %a, 1
+  ret i32 %b
+}
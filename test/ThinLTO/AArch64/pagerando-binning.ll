@@ -0,0 +1,40 @@
+; Check that ThinLTO assigns Pagerando bins across modules during the thin link
+; and that the backends receive the assignment.
+; RUN: opt -module-summary %s -o %t1.bc
+; RUN: opt -module-summary %p/Inputs/pagerando-binning.ll -o %t2.bc
+; RUN: llvm-lto2 run %t1.bc %t2.bc -o %t3.o -relocation-model=pip \
+; RUN:   -save-temps \
+; RUN:   -r=%t1.bc,a,px \
+; RUN:   -r=%t1.bc,b, \
+; RUN:   -r=%t2.bc,b,px
+; RUN: llvm-dis %t3.o.1.3.import.bc -o - | FileCheck %s --check-prefix=MOD1
+; RUN: llvm-dis %t3.o.2.3.import.bc -o - | FileCheck %s --check-prefix=MOD2
+
+; RUN: llvm-lto2 run %t1.bc %t2.bc -o %t4.o -relocation-model=pip \
+; RUN:   -pagerando-thinlto-binning=false -save-temps \
+; RUN:   -r=%t1.bc,a,px \
+; RUN:   -r=%t1.bc,b, \
+; RUN:   -r=%t2.bc,b,px
+; RUN: llvm-dis %t4.o.1.3.import.bc -o - | FileCheck %s --check-prefix=DISABLED
+; RUN: llvm-dis %t4.o.2.3.import.bc -o - | FileCheck %s --check-prefix=DISABLED
+
+; RUN: llvm-dis %t1.bc -o - | FileCheck %s --check-prefix=SUMMARY
+; SUMMARY: funcFlags: ({{.*}}pagerando: 1)
+
+; MOD1: define hidden void @a() #[[A:[0-9]+]]
+; MOD1: attributes #[[A]] = { {{.*}}"pagerando-bin"="1"
+
+; MOD2: define hidden void @b() #[[B:[0-9]+]]
+; MOD2: attributes #[[B]] = { {{.*}}"pagerando-bin"="1"
+
+; DISABLED-NOT: pagerando-bin
+
+target datalayout = "e-m:e-i8:8:32-i16:16:32-i64:64-i128:128-n32:64-S128"
+target triple = "aarch64-unknown-linux-gnu"
+
+define hidden void @a() pagerando {
+  call void @b()
+  ret void
+}
+
+declare hidden void @b()
@@ -0,0 +1,38 @@
+; REQUIRES: asserts
+; Check that backends are started largest first, and that a memory budget
+; keeps backends that do not fit together from running at the same time.
+; RUN: opt -module-summary %s -o %t1.bc
+; RUN: opt -module-summary %p/Inputs/backend-memory-budget.ll -o %t2.bc
+
+; RUN: llvm-lto2 run %t2.bc %t1.bc -o %t.o -thinlto-threads=2 \
+; RUN:   -thinlto-backend-memory-budget=1 \
+; RUN:   -thinlto-backend-memory-factor=1000000 -debug-only=lto \
+; RUN:   -r %t1.bc,big1,plx -r %t1.bc,big2,plx -r %t1.bc,big3,plx \
+; RUN:   -r %t2.bc,small,plx 2>&1 | FileCheck %s
+; CHECK:      Starting backend for {{.*}}1.bc (estimated [[BIG:[0-9]+]] MB, [[BIG]] MB in use)
+; CHECK-NEXT: Starting backend for {{.*}}2.bc (estimated [[SMALL:[0-9]+]] MB, [[SMALL]] MB in use)
+; RUN: llvm-nm %t.o.1 | FileCheck %s --check-prefix=NM1
+; RUN: llvm-nm %t.o.2 | FileCheck %s --check-prefix=NM2
+; NM1: T small
+; NM2: T big1
+
+target datalayout = "e-m:e-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-unknown-linux-gnu"
+
+define i32 @big1(i32 %a) {
+  %b = add i32 %a, 1
+  %c = mul i32 %b, %a
+  ret i32 %c
+}
+
+define i32 @big2(i32 %a) {
+  %b = add i32 %a, 2
+  %c = mul i32 %b, %a
+  ret i32 %c
+}
+
+define i32 @big3(i32 %a) {
+  %b = add i32 %a, 3
+  %c = mul i32 %b, %a
+  ret i32 %c
+}
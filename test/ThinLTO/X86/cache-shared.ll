@@ -0,0 +1,34 @@
+; RUN: opt -module-hash -module-summary %s -o %t.bc
+; RUN: opt -module-hash -module-summary %p/Inputs/cache.ll -o %t2.bc
+
+; Objects are stored in a sharded content-addressed store.
+; RUN: rm -Rf %t.cache
+; RUN: llvm-lto2 run -o %t.o %t2.bc %t.bc -shared-cache-dir %t.cache \
+; RUN:  -r=%t2.bc,_main,plx \
+; RUN:  -r=%t2.bc,_globalfunc,lx \
+; RUN:  -r=%t.bc,_globalfunc,plx
+; RUN: ls %t.cache/*/* | count 2
+; RUN: find %t.cache -name '*.tmp.o' | count 0
+
+; A second link, e.g., on another machine, reuses the stored objects.
+; RUN: rm -f %t.o.1 %t.o.2
+; RUN: llvm-lto2 run -o %t.o %t2.bc %t.bc -shared-cache-dir %t.cache \
+; RUN:  -r=%t2.bc,_main,plx \
+; RUN:  -r=%t2.bc,_globalfunc,lx \
+; RUN:  -r=%t.bc,_globalfunc,plx
+; RUN: ls %t.o.1 %t.o.2
+; RUN: ls %t.cache/*/* | count 2
+
+; RUN: not llvm-lto2 run -o %t.o %t2.bc %t.bc -cache-dir %t.cache \
+; RUN:  -shared-cache-dir %t.cache -r=%t2.bc,_main,plx \
+; RUN:  -r=%t2.bc,_globalfunc,lx \
+; RUN:  -r=%t.bc,_globalfunc,plx 2>&1 | FileCheck %s --check-prefix=EXCLUSIVE
+; EXCLUSIVE: -cache-dir and -shared-cache-dir are mutually exclusive
+
+target datalayout = "e-m:o-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-apple-macosx10.11.0"
+
+define void @globalfunc() #0 {
+entry:
+  ret void
+}
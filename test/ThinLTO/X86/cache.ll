@@ -36,6 +36,15 @@
 ; RUN: not ls %t.cache/llvmcache-foo
 ; RUN: ls %t.cache/llvmcache-* | count 2
 
+; Verify that objects kept in memory are identical to those mapped from the
+; cache, and that the cache is still populated.
+; RUN: mv %t.bc.thinlto.o %t.reloaded.o
+; RUN: rm -Rf %t.cache && mkdir %t.cache
+; RUN: llvm-lto -thinlto-action=run -exported-symbol=globalfunc %t2.bc %t.bc -thinlto-cache-dir %t.cache \
+; RUN:   -thinlto-reload-objects-from-cache=false
+; RUN: ls %t.cache/llvmcache-* | count 2
+; RUN: cmp %t.bc.thinlto.o %t.reloaded.o
+
 ; Verify that enabling caching is working with llvm-lto2
 ; RUN: rm -Rf %t.cache
 ; RUN: llvm-lto2 run -o %t.o %t2.bc %t.bc -cache-dir %t.cache \
@@ -0,0 +1,67 @@
+; Check that -import-budget keeps the imports with the hottest callsites.
+; RUN: opt -module-summary %s -o %t.bc
+; RUN: opt -module-summary %p/Inputs/import-budget.ll -o %t2.bc
+; RUN: llvm-lto -thinlto-action=thinlink -o %t3.bc %t.bc %t2.bc
+
+; RUN: llvm-lto -thinlto-action=import %t.bc -thinlto-index=%t3.bc -o - \
+; RUN:     -import-cold-multiplier=1 \
+; RUN:   | llvm-dis -o - | FileCheck %s --check-prefix=NOBUDGET
+; NOBUDGET-DAG: define available_externally void @hot()
+; NOBUDGET-DAG: define available_externally void @warm()
+; NOBUDGET-DAG: define available_externally void @cold()
+
+; Only @hot fits within a budget of one instruction.
+; RUN: llvm-lto -thinlto-action=import %t.bc -thinlto-index=%t3.bc -o - \
+; RUN:     -import-budget=1 -import-cold-multiplier=1 \
+; RUN:   | llvm-dis -o - | FileCheck %s --check-prefix=BUDGET1
+; BUDGET1: define available_externally void @hot()
+; BUDGET1-NOT: define available_externally
+
+; A callsite without profile data is preferred over a cold one.
+; RUN: llvm-lto -thinlto-action=import %t.bc -thinlto-index=%t3.bc -o - \
+; RUN:     -import-budget=2 -import-cold-multiplier=1 \
+; RUN:   | llvm-dis -o - | FileCheck %s --check-prefix=BUDGET2
+; BUDGET2-DAG: define available_externally void @hot()
+; BUDGET2-DAG: define available_externally void @warm()
+; BUDGET2-NOT: define available_externally void @cold()
+
+target datalayout = "e-m:e-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-unknown-linux-gnu"
+
+define void @hot_caller() !prof !20 {
+  call void @hot()
+  ret void
+}
+
+define void @cold_caller() !prof !21 {
+  call void @cold()
+  ret void
+}
+
+define void @caller() {
+  call void @warm()
+  ret void
+}
+
+declare void @hot()
+declare void @warm()
+declare void @cold()
+
+!llvm.module.flags = !{!1}
+!20 = !{!"function_entry_count", i64 110}
+!21 = !{!"function_entry_count", i64 1}
+
+!1 = !{i32 1, !"ProfileSummary", !2}
+!2 = !{!3, !4, !5, !6, !7, !8, !9, !10}
+!3 = !{!"ProfileFormat", !"InstrProf"}
+!4 = !{!"TotalCount", i64 10000}
+!5 = !{!"MaxCount", i64 10}
+!6 = !{!"MaxInternalCount", i64 1}
+!7 = !{!"MaxFunctionCount", i64 1000}
+!8 = !{!"NumCounts", i64 3}
+!9 = !{!"NumFunctions", i64 3}
+!10 = !{!"DetailedSummary", !11}
+!11 = !{!12, !13, !14}
+!12 = !{i32 10000, i64 100, i32 1}
+!13 = !{i32 999000, i64 100, i32 1}
+!14 = !{i32 999999, i64 1, i32 2}
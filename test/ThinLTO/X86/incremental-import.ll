@@ -0,0 +1,52 @@
+; REQUIRES: asserts
+; Check that -thinlto-incremental-import-dir reuses the import lists of
+; modules whose summaries did not change.
+; RUN: opt -module-hash -module-summary %s -o %t1.bc
+; RUN: opt -module-hash -module-summary %p/Inputs/incremental-import-b.ll -o %t2.bc
+; RUN: opt -module-hash -module-summary %p/Inputs/incremental-import-c.ll -o %t3.bc
+; RUN: rm -rf %t.dir
+
+; RUN: llvm-lto2 run %t1.bc %t2.bc %t3.bc -o %t.o -thinlto-distributed-indexes \
+; RUN:   -thinlto-incremental-import-dir=%t.dir -stats \
+; RUN:   -r %t1.bc,main,plx -r %t1.bc,foo, -r %t2.bc,foo,pl -r %t3.bc,bar,plx \
+; RUN:   2>&1 | FileCheck %s --check-prefix=FIRST --allow-empty
+; RUN: ls %t.dir | count 3
+; FIRST-NOT: import lists were reused
+; RUN: llvm-dis %t1.bc.thinlto.bc -o - | FileCheck %s --check-prefix=IMPORT
+; IMPORT: path: "{{.*}}2.bc"
+
+; RUN: rm %t1.bc.thinlto.bc
+; RUN: llvm-lto2 run %t1.bc %t2.bc %t3.bc -o %t.o -thinlto-distributed-indexes \
+; RUN:   -thinlto-incremental-import-dir=%t.dir -stats \
+; RUN:   -r %t1.bc,main,plx -r %t1.bc,foo, -r %t2.bc,foo,pl -r %t3.bc,bar,plx \
+; RUN:   2>&1 | FileCheck %s --check-prefix=SAME
+; SAME: 3 function-import - Number of modules whose import lists were reused
+; RUN: llvm-dis %t1.bc.thinlto.bc -o - | FileCheck %s --check-prefix=IMPORT
+
+; Changing the module that defines @bar does not affect the other modules.
+; RUN: sed -e 's/i32 1/i32 2/' %p/Inputs/incremental-import-c.ll \
+; RUN:   | opt -module-hash -module-summary -o %t3.bc
+; RUN: llvm-lto2 run %t1.bc %t2.bc %t3.bc -o %t.o -thinlto-distributed-indexes \
+; RUN:   -thinlto-incremental-import-dir=%t.dir -stats \
+; RUN:   -r %t1.bc,main,plx -r %t1.bc,foo, -r %t2.bc,foo,pl -r %t3.bc,bar,plx \
+; RUN:   2>&1 | FileCheck %s --check-prefix=CHANGEC
+; CHANGEC: 2 function-import - Number of modules whose import lists were reused
+
+; Changing the module that defines @foo invalidates the importing module too.
+; RUN: sed -e 's/i32 1/i32 2/' %p/Inputs/incremental-import-b.ll \
+; RUN:   | opt -module-hash -module-summary -o %t2.bc
+; RUN: llvm-lto2 run %t1.bc %t2.bc %t3.bc -o %t.o -thinlto-distributed-indexes \
+; RUN:   -thinlto-incremental-import-dir=%t.dir -stats \
+; RUN:   -r %t1.bc,main,plx -r %t1.bc,foo, -r %t2.bc,foo,pl -r %t3.bc,bar,plx \
+; RUN:   2>&1 | FileCheck %s --check-prefix=CHANGEB
+; CHANGEB: 1 function-import - Number of modules whose import lists were reused
+
+target datalayout = "e-m:e-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-unknown-linux-gnu"
+
+define i32 @main() {
+  %r = call i32 @foo()
+  ret i32 %r
+}
+
+declare i32 @foo()
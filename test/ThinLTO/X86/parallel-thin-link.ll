@@ -0,0 +1,36 @@
+; Check that the parallel thin-link analyses produce the same imports and
+; liveness as the serial ones.
+
+; RUN: opt -thinlto-bc %s -o %t1.bc
+; RUN: opt -thinlto-bc %p/Inputs/distributed_import.ll -o %t2.bc
+
+; RUN: llvm-lto2 run %t1.bc %t2.bc -o %t.o -thinlto-distributed-indexes \
+; RUN:     -thin-link-parallelism=false \
+; RUN:     -r=%t1.bc,g, -r=%t1.bc,analias, -r=%t1.bc,f,px \
+; RUN:     -r=%t2.bc,g,px -r=%t2.bc,analias,px -r=%t2.bc,aliasee,px
+; RUN: mv %t1.bc.thinlto.bc %t1.serial.thinlto.bc
+; RUN: mv %t2.bc.thinlto.bc %t2.serial.thinlto.bc
+
+; RUN: llvm-lto2 run %t1.bc %t2.bc -o %t.o -thinlto-distributed-indexes \
+; RUN:     -parallel-liveness-threshold=1 \
+; RUN:     -r=%t1.bc,g, -r=%t1.bc,analias, -r=%t1.bc,f,px \
+; RUN:     -r=%t2.bc,g,px -r=%t2.bc,analias,px -r=%t2.bc,aliasee,px
+; RUN: cmp %t1.bc.thinlto.bc %t1.serial.thinlto.bc
+; RUN: cmp %t2.bc.thinlto.bc %t2.serial.thinlto.bc
+
+; RUN: llvm-dis -o - %t1.bc.thinlto.bc | FileCheck %s
+; CHECK-DAG: name: "g"
+; CHECK-DAG: name: "analias"
+
+target triple = "x86_64-unknown-linux-gnu"
+target datalayout = "e-m:e-i64:64-f80:128-n8:16:32:64-S128"
+
+declare i32 @g(...)
+declare void @analias(...)
+
+define void @f() {
+entry:
+  call i32 (...) @g()
+  call void (...) @analias()
+  ret void
+}
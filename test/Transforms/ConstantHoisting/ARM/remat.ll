@@ -0,0 +1,82 @@
+; RUN: opt -consthoist -consthoist-remat -pass-remarks=consthoist -S < %s 2>%t | FileCheck %s
+; RUN: FileCheck --check-prefix=REMARK %s < %t
+target triple = "thumbv6m-none-eabi"
+
+; The constant is hoisted to the common dominator of its uses as long as the
+; blocks it would be live through have a free register.
+define i32 @hoist(i32 %a, i1 %c) {
+; CHECK-LABEL: @hoist
+; CHECK: entry:
+; CHECK-NEXT: [[CONST:%.*]] = bitcast i32 305419896 to i32
+; CHECK: xor i32 %a, [[CONST]]
+; CHECK: add i32 %a, [[CONST]]
+entry:
+  br i1 %c, label %then, label %else
+
+then:
+  %t = xor i32 %a, 305419896
+  br label %exit
+
+else:
+  %e = add i32 %a, 305419896
+  br label %exit
+
+exit:
+  %r = phi i32 [ %t, %then ], [ %e, %else ]
+  ret i32 %r
+}
+
+; The loads in %then leave no Thumb1 register for the hoisted constant, so it
+; is materialized in each block that uses it instead.
+define i32 @remat(i32* %p, i32 %a, i1 %c) {
+; CHECK-LABEL: @remat
+; CHECK: entry:
+; CHECK-NOT: bitcast i32 305419896
+; CHECK: then:
+; CHECK-NEXT: [[CONST1:%.*]] = bitcast i32 305419896 to i32
+; CHECK: xor i32 %a, [[CONST1]]
+; CHECK: else:
+; CHECK-NEXT: [[CONST2:%.*]] = bitcast i32 305419896 to i32
+; CHECK: add i32 %a, [[CONST2]]
+entry:
+  br i1 %c, label %then, label %else
+
+then:
+  %p1 = getelementptr i32, i32* %p, i32 1
+  %p2 = getelementptr i32, i32* %p, i32 2
+  %p3 = getelementptr i32, i32* %p, i32 3
+  %p4 = getelementptr i32, i32* %p, i32 4
+  %p5 = getelementptr i32, i32* %p, i32 5
+  %p6 = getelementptr i32, i32* %p, i32 6
+  %p7 = getelementptr i32, i32* %p, i32 7
+  %v0 = load volatile i32, i32* %p
+  %v1 = load volatile i32, i32* %p1
+  %v2 = load volatile i32, i32* %p2
+  %v3 = load volatile i32, i32* %p3
+  %v4 = load volatile i32, i32* %p4
+  %v5 = load volatile i32, i32* %p5
+  %v6 = load volatile i32, i32* %p6
+  %v7 = load volatile i32, i32* %p7
+  %s1 = add i32 %v0, %v1
+  %s2 = add i32 %s1, %v2
+  %s3 = add i32 %s2, %v3
+  %s4 = add i32 %s3, %v4
+  %s5 = add i32 %s4, %v5
+  %s6 = add i32 %s5, %v6
+  %s7 = add i32 %s6, %v7
+  %t = xor i32 %s7, 305419896
+  %t1 = xor i32 %a, 305419896
+  %t2 = add i32 %t, %t1
+  br label %exit
+
+else:
+  %e = add i32 %a, 305419896
+  br label %exit
+
+exit:
+  %r = phi i32 [ %t2, %then ], [ %e, %else ]
+  ret i32 %r
+}
+
+; REMARK: remark: <unknown>:0:0: hoisted 305419896 for 2 using blocks: estimated register pressure {{[0-9]+}} in entry of 8 registers
+; REMARK: remark: <unknown>:0:0: rematerialized 305419896 in each of 2 using blocks: estimated register pressure {{[0-9]+}} in then of 8 registers, rematerialization cost {{[0-9]+}} vs. hoisting and spilling cost {{[0-9]+}}
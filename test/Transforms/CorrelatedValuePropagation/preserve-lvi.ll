@@ -0,0 +1,30 @@
+; RUN: opt < %s -correlated-propagation -jump-threading -debug-pass=Structure \
+; RUN:     -disable-output 2>&1 | FileCheck %s
+; RUN: opt < %s -passes='correlated-propagation,jump-threading' \
+; RUN:     -debug-pass-manager -disable-output 2>&1 \
+; RUN:   | FileCheck %s --check-prefix=NEWPM
+
+; The LVI results computed for CVP are reused by jump threading.
+
+; CHECK:      Lazy Value Information Analysis
+; CHECK-NEXT: Value Propagation
+; CHECK-NOT:  Lazy Value Information Analysis
+; CHECK:      Jump Threading
+
+; NEWPM:     Running analysis: LazyValueAnalysis
+; NEWPM:     Running pass: JumpThreadingPass
+; NEWPM-NOT: Running analysis: LazyValueAnalysis
+
+define i32 @f(i32 %x) {
+entry:
+  %c = icmp ult i32 %x, 10
+  br i1 %c, label %small, label %big
+
+small:
+  %d = icmp ult i32 %x, 20
+  %r = select i1 %d, i32 1, i32 2
+  ret i32 %r
+
+big:
+  ret i32 0
+}
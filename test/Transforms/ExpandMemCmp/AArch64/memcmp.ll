@@ -0,0 +1,84 @@
+; RUN: opt -S -expandmemcmp -mtriple=aarch64-unknown-unknown < %s | FileCheck %s
+; RUN: opt -S -expandmemcmp -mtriple=aarch64-unknown-unknown -mattr=+strict-align < %s | FileCheck %s --check-prefix=STRICT
+
+declare i32 @memcmp(i8* nocapture, i8* nocapture, i64)
+
+; The tail of a three-way compare is done with a load that overlaps the
+; previous one, instead of 2-byte and 1-byte loads.
+define i32 @cmp7(i8* nocapture readonly %x, i8* nocapture readonly %y) {
+; CHECK-LABEL: @cmp7(
+; CHECK:       loadbb:
+; CHECK:         [[X0:%.*]] = bitcast i8* [[X:%.*]] to i32*
+; CHECK:         [[Y0:%.*]] = bitcast i8* [[Y:%.*]] to i32*
+; CHECK:         load i32, i32* [[X0]]
+; CHECK:         load i32, i32* [[Y0]]
+; CHECK:       loadbb1:
+; CHECK-NEXT:    [[X3:%.*]] = getelementptr i8, i8* [[X]], i64 3
+; CHECK-NEXT:    [[X1:%.*]] = bitcast i8* [[X3]] to i32*
+; CHECK-NEXT:    [[Y3:%.*]] = getelementptr i8, i8* [[Y]], i64 3
+; CHECK-NEXT:    [[Y1:%.*]] = bitcast i8* [[Y3]] to i32*
+; CHECK-NEXT:    load i32, i32* [[X1]]
+; CHECK-NEXT:    load i32, i32* [[Y1]]
+; CHECK-NOT:     loadbb2:
+; CHECK:       endblock:
+; STRICT-LABEL: @cmp7(
+; STRICT:         call i32 @memcmp
+  %call = tail call i32 @memcmp(i8* %x, i8* %y, i64 7)
+  ret i32 %call
+}
+
+; Equality compares use 16-byte loads.
+define i1 @cmp_eq24(i8* nocapture readonly %x, i8* nocapture readonly %y) {
+; CHECK-LABEL: @cmp_eq24(
+; CHECK:       loadbb:
+; CHECK:         load i128, i128*
+; CHECK:         load i128, i128*
+; CHECK:         icmp ne i128
+; CHECK:       loadbb1:
+; CHECK:         getelementptr i64, i64* {{%.*}}, i64 2
+; CHECK:         getelementptr i64, i64* {{%.*}}, i64 2
+; CHECK:         load i64, i64*
+; CHECK:         load i64, i64*
+; CHECK:         icmp ne i64
+; CHECK-NOT:     loadbb2:
+; CHECK:       endblock:
+  %call = tail call i32 @memcmp(i8* %x, i8* %y, i64 24)
+  %cmp = icmp eq i32 %call, 0
+  ret i1 %cmp
+}
+
+define i1 @cmp_eq31(i8* nocapture readonly %x, i8* nocapture readonly %y) {
+; CHECK-LABEL: @cmp_eq31(
+; CHECK:       loadbb:
+; CHECK:         load i128, i128*
+; CHECK:         load i128, i128*
+; CHECK:         icmp ne i128
+; CHECK:       loadbb1:
+; CHECK:         getelementptr i8, i8* {{%.*}}, i64 15
+; CHECK:         getelementptr i8, i8* {{%.*}}, i64 15
+; CHECK:         load i128, i128*
+; CHECK:         load i128, i128*
+; CHECK:         icmp ne i128
+; CHECK-NOT:     loadbb2:
+; CHECK:       endblock:
+  %call = tail call i32 @memcmp(i8* %x, i8* %y, i64 31)
+  %cmp = icmp eq i32 %call, 0
+  ret i1 %cmp
+}
+
+define i1 @cmp_eq40(i8* nocapture readonly %x, i8* nocapture readonly %y) {
+; CHECK-LABEL: @cmp_eq40(
+; CHECK:       loadbb1:
+; CHECK:         getelementptr i128, i128* {{%.*}}, i128 1
+; CHECK:         getelementptr i128, i128* {{%.*}}, i128 1
+; CHECK:       loadbb2:
+; CHECK:         getelementptr i64, i64* {{%.*}}, i64 4
+; CHECK:         getelementptr i64, i64* {{%.*}}, i64 4
+; CHECK-NOT:     loadbb3:
+; CHECK:       endblock:
+; STRICT-LABEL: @cmp_eq40(
+; STRICT:         call i32 @memcmp
+  %call = tail call i32 @memcmp(i8* %x, i8* %y, i64 40)
+  %cmp = icmp eq i32 %call, 0
+  ret i1 %cmp
+}
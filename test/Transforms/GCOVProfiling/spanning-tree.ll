@@ -0,0 +1,51 @@
+; RUN: rm -rf %t && mkdir -p %t
+; RUN: echo '!9 = !{!"%/t/spanning-tree.gcno", !"%/t/spanning-tree.gcda", !0}' > %t/1
+; RUN: cat %s %t/1 > %t/2
+; RUN: opt -insert-gcov-profiling -gcov-spanning-tree -S < %t/2 | FileCheck %s
+
+; The function has six arcs in the .gcno and one fake arc into the entry
+; block. Only the two arcs off the spanning tree are counted; the counters of
+; the other five are computed when the .gcda file is written.
+
+; CHECK: @__llvm_gcov_ctr = internal global [7 x i64] zeroinitializer
+; CHECK: { i32 6, i64* getelementptr inbounds ([7 x i64], [7 x i64]* @__llvm_gcov_ctr, i32 0, i32 0) }
+
+define void @foo(i1 %c) !dbg !4 {
+entry:
+  br i1 %c, label %then, label %else, !dbg !7
+
+; CHECK-LABEL: then:
+; CHECK-NEXT:    load i64, i64* getelementptr inbounds ([7 x i64], [7 x i64]* @__llvm_gcov_ctr, i64 0, i64 1)
+then:
+  br label %end, !dbg !8
+
+; CHECK-LABEL: else:
+; CHECK-NEXT:    load i64, i64* getelementptr inbounds ([7 x i64], [7 x i64]* @__llvm_gcov_ctr, i64 0, i64 4)
+else:
+  br label %end, !dbg !8
+
+; CHECK-LABEL: end:
+; CHECK-NOT:     @__llvm_gcov_ctr
+; CHECK:         ret void
+end:
+  ret void, !dbg !8
+}
+
+; CHECK-LABEL: define internal void @__llvm_gcov_writeout()
+; CHECK-COUNT-5: store i64 %{{.*}}, i64* getelementptr inbounds ([7 x i64], [7 x i64]* @__llvm_gcov_ctr
+; CHECK-NOT:     store i64 %{{.*}}, i64* getelementptr inbounds ([7 x i64], [7 x i64]* @__llvm_gcov_ctr
+; CHECK:         br label %file.loop.header
+
+!llvm.dbg.cu = !{!0}
+!llvm.module.flags = !{!3}
+!llvm.gcov = !{!9}
+
+!0 = distinct !DICompileUnit(language: DW_LANG_C99, file: !1, producer: "clang", isOptimized: false, emissionKind: FullDebug, enums: !2)
+!1 = !DIFile(filename: "spanning-tree.c", directory: "/tmp")
+!2 = !{}
+!3 = !{i32 2, !"Debug Info Version", i32 3}
+!4 = distinct !DISubprogram(name: "foo", scope: !1, file: !1, line: 1, type: !5, scopeLine: 1, spFlags: DISPFlagDefinition, unit: !0, retainedNodes: !2)
+!5 = !DISubroutineType(types: !6)
+!6 = !{null}
+!7 = !DILocation(line: 2, scope: !4)
+!8 = !DILocation(line: 3, scope: !4)
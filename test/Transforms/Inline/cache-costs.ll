@@ -0,0 +1,39 @@
+; RUN: opt < %s -inline -inliner-cache-costs -S | FileCheck %s
+; RUN: opt < %s -inline -inliner-cache-costs -stats -disable-output 2>&1 \
+; RUN:   | FileCheck %s --check-prefix=STATS
+; RUN: opt < %s -inline -stats -disable-output 2>&1 \
+; RUN:   | FileCheck %s --check-prefix=NOCACHE
+; REQUIRES: asserts
+
+; Inlining @small into @a makes the inliner sweep over the SCC {@a, @b} a
+; second time. Neither @b nor @big has changed by then, so the cost of the
+; call from @b to @big is reused.
+
+; CHECK-LABEL: define void @a(
+; CHECK-NOT:     call void @small
+; CHECK:         call void @b()
+; CHECK-LABEL: define void @b(
+; CHECK:         call void @big()
+; CHECK:         call void @a()
+; STATS: 1 inline - Number of inline costs reused from an earlier evaluation
+; NOCACHE-NOT: Number of inline costs reused
+
+define void @small() {
+  ret void
+}
+
+define void @big() noinline {
+  ret void
+}
+
+define void @a() {
+  call void @small()
+  call void @b() noinline
+  ret void
+}
+
+define void @b() {
+  call void @big()
+  call void @a() noinline
+  ret void
+}
@@ -0,0 +1,48 @@
+; RUN: opt < %s -inline -inline-threshold=5 -inline-callee-summaries -S \
+; RUN:   | FileCheck %s
+; RUN: opt < %s -passes=inline -inline-threshold=5 -inline-callee-summaries -S \
+; RUN:   | FileCheck %s
+; RUN: opt < %s -inline -inline-threshold=5 -inline-callee-summaries -stats \
+; RUN:     -disable-output 2>&1 | FileCheck %s --check-prefix=STATS
+; RUN: opt < %s -passes=inline -inline-threshold=5 -inline-callee-summaries \
+; RUN:     -stats -disable-output 2>&1 | FileCheck %s --check-prefix=STATS
+; REQUIRES: asserts
+
+; The second call in @a reuses the walk of @callee done for the first one.
+; The constant argument in @b can fold the branch in @callee, so that call
+; site is analyzed on its own.
+
+; CHECK-LABEL: define i32 @a(
+; CHECK:         call i32 @callee(i32 %x)
+; CHECK:         call i32 @callee(i32 %y)
+; CHECK-LABEL: define i32 @b(
+; STATS: 1 inline-cost - Number of call sites analyzed with a cached callee summary
+
+define i32 @callee(i32 %n) {
+entry:
+  %c = icmp eq i32 %n, 0
+  br i1 %c, label %zero, label %nonzero
+
+zero:
+  ret i32 0
+
+nonzero:
+  %m1 = mul i32 %n, %n
+  %m2 = mul i32 %m1, %n
+  %m3 = mul i32 %m2, %n
+  %m4 = mul i32 %m3, %n
+  %m5 = mul i32 %m4, %n
+  ret i32 %m5
+}
+
+define i32 @a(i32 %x, i32 %y) {
+  %r1 = call i32 @callee(i32 %x)
+  %r2 = call i32 @callee(i32 %y)
+  %r = add i32 %r1, %r2
+  ret i32 %r
+}
+
+define i32 @b() {
+  %r = call i32 @callee(i32 0)
+  ret i32 %r
+}
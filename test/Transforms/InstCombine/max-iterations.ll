@@ -0,0 +1,36 @@
+; RUN: opt < %s -instcombine -S -debug-only=instcombine 2>&1 \
+; RUN:   | FileCheck %s --check-prefix=DEFAULT
+; RUN: opt < %s -instcombine -instcombine-max-iterations=1 -S \
+; RUN:     -debug-only=instcombine 2>&1 | FileCheck %s --check-prefix=LIMIT
+; RUN: opt < %s -instcombine -instcombine-stats-json=%t.json -disable-output
+; RUN: FileCheck %s --check-prefix=JSON < %t.json
+; REQUIRES: asserts
+
+; DEFAULT: INSTCOMBINE ITERATION #1
+; DEFAULT: INSTCOMBINE ITERATION #2
+
+; LIMIT: INSTCOMBINE ITERATION #1
+; LIMIT-NOT: INSTCOMBINE ITERATION #2
+; LIMIT: Reached the limit of 1 instcombine iterations on f
+
+; JSON:      "functions": [
+; JSON-NEXT:   {
+; JSON-NEXT:     "iterations": 2,
+; JSON-NEXT:     "name": "f",
+; JSON-NEXT:     "visited": [
+; JSON-NEXT:       {{[0-9]+}},
+; JSON-NEXT:       {{[0-9]+}}
+; JSON-NEXT:     ]
+; JSON-NEXT:   }
+; JSON-NEXT: ],
+; JSON-NEXT: "num_iterations": 2,
+; JSON-NEXT: "top_transforms": [
+; JSON:          "opcode": "{{[a-z]+}}",
+; JSON-NEXT:     "time_ms": {{[0-9.e+-]+}},
+; JSON-NEXT:     "visits": {{[0-9]+}}
+
+define i32 @f(i32 %x) {
+  %a = add i32 %x, 0
+  %b = mul i32 %a, 1
+  ret i32 %b
+}
@@ -0,0 +1,52 @@
+; RUN: opt -basicaa -licm -alias-set-saturation-threshold=1 -S < %s \
+; RUN:   | FileCheck %s --check-prefix=AST
+; RUN: opt -basicaa -licm -alias-set-saturation-threshold=1 \
+; RUN:     -enable-mssa-loop-dependency -S < %s | FileCheck %s
+; RUN: opt -basicaa -licm -alias-set-saturation-threshold=1 \
+; RUN:     -enable-mssa-loop-dependency -licm-promotion-query-cap=1 -S < %s \
+; RUN:   | FileCheck %s --check-prefix=CAP
+
+; A saturated alias set tracker merges every access into a single may-alias
+; set and nothing is promoted. With MemorySSA enabled, each stored location is
+; checked with alias queries and both @g and @k are promoted, unless the query
+; cap is reached.
+
+@g = global i32 0
+@h = global i32 0
+@k = global i32 0
+
+; AST-LABEL: @f(
+; AST:       loop:
+; AST:         store i32 %{{.*}}, i32* @g
+
+; CHECK-LABEL: @f(
+; CHECK:       entry:
+; CHECK:         load i32, i32* @g
+; CHECK:       loop:
+; CHECK-NOT:     store
+; CHECK:       exit:
+; CHECK-DAG:     store i32 %{{.*}}, i32* @g
+; CHECK-DAG:     store i32 %{{.*}}, i32* @k
+
+; CAP-LABEL: @f(
+; CAP:       loop:
+; CAP:         store i32 %{{.*}}, i32* @g
+
+define void @f(i32 %n) {
+entry:
+  br label %loop
+
+loop:
+  %i = phi i32 [ 0, %entry ], [ %i.next, %loop ]
+  %v = load i32, i32* @g
+  %add = add i32 %v, %i
+  store i32 %add, i32* @g
+  %w = load i32, i32* @h
+  store i32 %w, i32* @k
+  %i.next = add i32 %i, 1
+  %cmp = icmp slt i32 %i.next, %n
+  br i1 %cmp, label %loop, label %exit
+
+exit:
+  ret void
+}
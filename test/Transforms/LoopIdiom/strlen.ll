@@ -0,0 +1,81 @@
+; RUN: opt -loop-idiom -loop-idiom-strlen -S < %s | FileCheck %s
+; RUN: opt -loop-idiom -S < %s | FileCheck %s --check-prefix=DISABLED
+
+target datalayout = "e-m:e-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-unknown-linux-gnu"
+
+; CHECK-LABEL: @count(
+; CHECK:       entry:
+; CHECK-NEXT:    [[LEN:%.*]] = call i64 @strlen(i8* %s)
+; CHECK:       loop:
+; CHECK:         br i1 true, label %exit, label %loop
+; CHECK:       exit:
+; CHECK-NEXT:    ret i64 [[LEN]]
+; DISABLED-LABEL: @count(
+; DISABLED-NOT:   strlen
+
+define i64 @count(i8* %s) {
+entry:
+  br label %loop
+
+loop:
+  %n = phi i64 [ 0, %entry ], [ %n.next, %loop ]
+  %p = getelementptr inbounds i8, i8* %s, i64 %n
+  %c = load i8, i8* %p
+  %z = icmp eq i8 %c, 0
+  %n.next = add nuw nsw i64 %n, 1
+  br i1 %z, label %exit, label %loop
+
+exit:
+  %len = phi i64 [ %n, %loop ]
+  ret i64 %len
+}
+
+; The end pointer is computed from the length.
+
+; CHECK-LABEL: @end(
+; CHECK:       entry:
+; CHECK-NEXT:    [[LEN:%.*]] = call i64 @strlen(i8* %s)
+; CHECK-NEXT:    [[END:%.*]] = getelementptr i8, i8* %s, i64 [[LEN]]
+; CHECK:       exit:
+; CHECK-NEXT:    ret i8* [[END]]
+
+define i8* @end(i8* %s) {
+entry:
+  br label %loop
+
+loop:
+  %p = phi i8* [ %s, %entry ], [ %p.next, %loop ]
+  %c = load i8, i8* %p
+  %p.next = getelementptr inbounds i8, i8* %p, i64 1
+  %nz = icmp ne i8 %c, 0
+  br i1 %nz, label %loop, label %exit
+
+exit:
+  %r = phi i8* [ %p, %loop ]
+  ret i8* %r
+}
+
+; A loop that stores is left alone.
+
+; CHECK-LABEL: @store(
+; CHECK-NOT:   strlen
+; CHECK:       ret
+
+define i64 @store(i8* %s, i8* %d) {
+entry:
+  br label %loop
+
+loop:
+  %n = phi i64 [ 0, %entry ], [ %n.next, %loop ]
+  %p = getelementptr inbounds i8, i8* %s, i64 %n
+  %c = load i8, i8* %p
+  store i8 %c, i8* %d
+  %z = icmp eq i8 %c, 0
+  %n.next = add nuw nsw i64 %n, 1
+  br i1 %z, label %exit, label %loop
+
+exit:
+  %len = phi i64 [ %n, %loop ]
+  ret i64 %len
+}
@@ -0,0 +1,67 @@
+; RUN: opt < %s -loop-vectorize -force-vector-width=4 -S \
+; RUN:     -vectorize-padded-tail-loads | FileCheck %s
+; RUN: opt < %s -loop-vectorize -force-vector-width=4 -S \
+; RUN:   | FileCheck %s --check-prefix=DEFAULT
+
+; NEON has no masked loads. When the tail is folded, a load that stays in
+; bounds for the trip count padded to the VF is widened without a mask.
+
+target datalayout = "e-m:e-p:32:32-i64:64-v128:64:128-a:0:32-n32-S64"
+target triple = "armv7-unknown-linux-gnueabihf"
+
+@a = global [100 x i32] zeroinitializer, align 4
+@b = global [100 x i32] zeroinitializer, align 4
+@c = global [99 x i32] zeroinitializer, align 4
+
+; CHECK-LABEL: @padded(
+; CHECK:       vector.body:
+; CHECK-NOT:   pred.load
+; CHECK:         load <4 x i32>
+; CHECK:       pred.store.if:
+; DEFAULT-LABEL: @padded(
+; DEFAULT:       vector.body:
+; DEFAULT:       pred.load.if:
+
+define void @padded() optsize {
+entry:
+  br label %loop
+
+loop:
+  %i = phi i32 [ 0, %entry ], [ %i.next, %loop ]
+  %pb = getelementptr inbounds [100 x i32], [100 x i32]* @b, i32 0, i32 %i
+  %v = load i32, i32* %pb, align 4
+  %add = add i32 %v, 1
+  %pa = getelementptr inbounds [100 x i32], [100 x i32]* @a, i32 0, i32 %i
+  store i32 %add, i32* %pa, align 4
+  %i.next = add nuw nsw i32 %i, 1
+  %cmp = icmp eq i32 %i.next, 99
+  br i1 %cmp, label %exit, label %loop
+
+exit:
+  ret void
+}
+
+; @c has no room for the padded iteration, so its load stays predicated.
+
+; CHECK-LABEL: @not_padded(
+; CHECK:       vector.body:
+; CHECK:       pred.load.if:
+
+define void @not_padded() optsize {
+entry:
+  br label %loop
+
+loop:
+  %i = phi i32 [ 0, %entry ], [ %i.next, %loop ]
+  %pc = getelementptr inbounds [99 x i32], [99 x i32]* @c, i32 0, i32 %i
+  %v = load i32, i32* %pc, align 4
+  %add = add i32 %v, 1
+  %pa = getelementptr inbounds [100 x i32], [100 x i32]* @a, i32 0, i32 %i
+  store i32 %add, i32* %pa, align 4
+  %i.next = add nuw nsw i32 %i, 1
+  %cmp = icmp eq i32 %i.next, 99
+  br i1 %cmp, label %exit, label %loop
+
+exit:
+  ret void
+}
@@ -0,0 +1,89 @@
+; RUN: opt -S -loop-vectorize -enable-vplan-native-path \
+; RUN:     -vplan-outer-loop-select-vf -mattr=+avx512f < %s | FileCheck %s
+; RUN: opt -S -loop-vectorize -enable-vplan-native-path \
+; RUN:     -vplan-outer-loop-select-vf -mattr=+avx2 < %s \
+; RUN:   | FileCheck %s --check-prefix=NOSCATTER
+; RUN: opt -S -loop-vectorize -enable-vplan-native-path -mattr=+avx512f < %s \
+; RUN:   | FileCheck %s --check-prefix=NOSCATTER
+
+; The outer loop is marked for vectorization without a vector width. The VF
+; fills a vector register with i32 elements, as long as scatters are legal.
+
+; CHECK-LABEL: @foo(
+; CHECK: vector.body:
+; CHECK: call void @llvm.masked.scatter.v16i32.v16p0i32(
+
+; CHECK-LABEL: @call(
+; CHECK-NOT: vector.body:
+
+; NOSCATTER-NOT: vector.body:
+
+target datalayout = "e-m:e-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-unknown-linux-gnu"
+
+@arr2 = external global [64 x i32], align 16
+@arr = external global [8 x [64 x i32]], align 16
+
+define void @foo(i32 %n) {
+entry:
+  br label %for.body
+
+for.body:
+  %iv.outer = phi i64 [ 0, %entry ], [ %iv.outer.next, %for.inc ]
+  %arrayidx = getelementptr inbounds [64 x i32], [64 x i32]* @arr2, i64 0, i64 %iv.outer
+  %0 = trunc i64 %iv.outer to i32
+  store i32 %0, i32* %arrayidx, align 4
+  %add = add nsw i32 %0, %n
+  br label %for.body3
+
+for.body3:
+  %iv.inner = phi i64 [ 0, %for.body ], [ %iv.inner.next, %for.body3 ]
+  %arrayidx7 = getelementptr inbounds [8 x [64 x i32]], [8 x [64 x i32]]* @arr, i64 0, i64 %iv.inner, i64 %iv.outer
+  store i32 %add, i32* %arrayidx7, align 4
+  %iv.inner.next = add nuw nsw i64 %iv.inner, 1
+  %exitcond = icmp eq i64 %iv.inner.next, 8
+  br i1 %exitcond, label %for.inc, label %for.body3
+
+for.inc:
+  %iv.outer.next = add nuw nsw i64 %iv.outer, 1
+  %exitcond23 = icmp eq i64 %iv.outer.next, 64
+  br i1 %exitcond23, label %for.end, label %for.body, !llvm.loop !0
+
+for.end:
+  ret void
+}
+
+; Calls without a vector version cannot be widened.
+
+declare i32 @g(i32)
+
+define void @call(i32 %n) {
+entry:
+  br label %for.body
+
+for.body:
+  %iv.outer = phi i64 [ 0, %entry ], [ %iv.outer.next, %for.inc ]
+  %0 = trunc i64 %iv.outer to i32
+  %add = call i32 @g(i32 %0)
+  br label %for.body3
+
+for.body3:
+  %iv.inner = phi i64 [ 0, %for.body ], [ %iv.inner.next, %for.body3 ]
+  %arrayidx7 = getelementptr inbounds [8 x [64 x i32]], [8 x [64 x i32]]* @arr, i64 0, i64 %iv.inner, i64 %iv.outer
+  store i32 %add, i32* %arrayidx7, align 4
+  %iv.inner.next = add nuw nsw i64 %iv.inner, 1
+  %exitcond = icmp eq i64 %iv.inner.next, 8
+  br i1 %exitcond, label %for.inc, label %for.body3
+
+for.inc:
+  %iv.outer.next = add nuw nsw i64 %iv.outer, 1
+  %exitcond23 = icmp eq i64 %iv.outer.next, 64
+  br i1 %exitcond23, label %for.end, label %for.body, !llvm.loop !2
+
+for.end:
+  ret void
+}
+
+!0 = distinct !{!0, !1}
+!1 = !{!"llvm.loop.vectorize.enable", i1 true}
+!2 = distinct !{!2, !1}
@@ -0,0 +1,40 @@
+; RUN: opt < %s -loop-vectorize -vectorize-epilogues \
+; RUN:     -epilogue-vectorization-min-vf=8 -force-vector-interleave=1 -S \
+; RUN:   | FileCheck %s
+; RUN: opt < %s -loop-vectorize -force-vector-interleave=1 -S \
+; RUN:   | FileCheck %s --check-prefix=NOEPILOGUE
+
+; The main loop is vectorized with VF 8, and its remainder loop with VF 4.
+; The remainder of the epilogue stays scalar.
+
+; CHECK-LABEL: @add(
+; CHECK-DAG:   load <8 x i32>
+; CHECK-DAG:   load <4 x i32>
+; CHECK:       !{!"llvm.loop.isvectorized", i32 1}
+
+; NOEPILOGUE-LABEL: @add(
+; NOEPILOGUE:       load <8 x i32>
+; NOEPILOGUE-NOT:   load <4 x i32>
+
+target datalayout = "e-m:e-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-unknown-linux-gnu"
+
+define void @add(i32* noalias %a, i32* noalias %b, i64 %n) "target-features"="+avx2" {
+entry:
+  br label %loop
+
+loop:
+  %i = phi i64 [ 0, %entry ], [ %i.next, %loop ]
+  %pb = getelementptr inbounds i32, i32* %b, i64 %i
+  %vb = load i32, i32* %pb, align 4
+  %pa = getelementptr inbounds i32, i32* %a, i64 %i
+  %va = load i32, i32* %pa, align 4
+  %sum = add i32 %va, %vb
+  store i32 %sum, i32* %pa, align 4
+  %i.next = add nuw nsw i64 %i, 1
+  %done = icmp eq i64 %i.next, %n
+  br i1 %done, label %exit, label %loop
+
+exit:
+  ret void
+}
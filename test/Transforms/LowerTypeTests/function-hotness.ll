@@ -0,0 +1,43 @@
+; RUN: opt -S -lowertypetests -mtriple=x86_64-unknown-linux-gnu < %s | FileCheck %s
+; RUN: opt -S -lowertypetests -lowertypetests-layout-by-hotness=false -mtriple=x86_64-unknown-linux-gnu < %s | FileCheck --check-prefix=NOHOT %s
+
+; Tests that the jump table entries of the functions with the highest entry
+; counts come first, and that the jump table gets the sum of their counts.
+
+target datalayout = "e-p:64:64"
+
+; CHECK: @g = alias void (), void ()* @[[JT:.*]]
+; CHECK: @f = alias void (), bitcast ([8 x i8]* getelementptr inbounds ([3 x [8 x i8]], [3 x [8 x i8]]* bitcast (void ()* @[[JT]] to [3 x [8 x i8]]*), i64 0, i64 1) to void ()*)
+; CHECK: @h = alias void (), bitcast ([8 x i8]* getelementptr inbounds ([3 x [8 x i8]], [3 x [8 x i8]]* bitcast (void ()* @[[JT]] to [3 x [8 x i8]]*), i64 0, i64 2) to void ()*)
+
+; NOHOT: @f = alias void (), void ()* @[[JT:.*]]
+; NOHOT: @g = alias void (), bitcast ([8 x i8]* getelementptr inbounds ([3 x [8 x i8]], [3 x [8 x i8]]* bitcast (void ()* @[[JT]] to [3 x [8 x i8]]*), i64 0, i64 1) to void ()*)
+
+define void @f() !type !0 !prof !1 {
+  ret void
+}
+
+define void @g() !type !0 !prof !2 {
+  ret void
+}
+
+define void @h() !type !0 {
+  ret void
+}
+
+!0 = !{i32 0, !"typeid1"}
+!1 = !{!"function_entry_count", i64 10}
+!2 = !{!"function_entry_count", i64 1000}
+
+declare i1 @llvm.type.test(i8* %ptr, metadata %bitset) nounwind readnone
+
+define i1 @foo(i8* %p) {
+  %x = call i1 @llvm.type.test(i8* %p, metadata !"typeid1")
+  ret i1 %x
+}
+
+; CHECK: define private void @[[JT]]() #{{[0-9]+}} align 8 !prof ![[PROF:[0-9]+]] {
+; CHECK: jmp ${0:c}@plt
+; CHECK: ![[PROF]] = !{!"function_entry_count", i64 1010}
+
+; NOHOT: define private void @[[JT]]() #{{[0-9]+}} align 8 !prof
@@ -0,0 +1,50 @@
+; RUN: opt -S -mergefunc -mergefunc-hash-threads=4 < %s | FileCheck %s
+
+; Hashing the functions on several threads must find the same candidates as
+; hashing them serially. Functions that only differ in a constant operand get
+; different hashes and are not merged.
+
+; CHECK-LABEL: define i32 @a(
+; CHECK: add i32 %x, 1
+define i32 @a(i32 %x) {
+  %y = add i32 %x, 1
+  %z = xor i32 %y, %x
+  %r = add i32 %z, 1
+  ret i32 %r
+}
+
+define i32 @b(i32 %x) {
+  %y = add i32 %x, 1
+  %z = xor i32 %y, %x
+  %r = add i32 %z, 1
+  ret i32 %r
+}
+
+; CHECK-LABEL: define i32 @c(
+; CHECK: add i32 %x, 2
+define i32 @c(i32 %x) {
+  %y = add i32 %x, 2
+  %z = xor i32 %y, %x
+  %r = add i32 %z, 2
+  ret i32 %r
+}
+
+; CHECK-LABEL: define i64 @d(
+; CHECK: mul i64 %x, 3
+
+; The order of the thunks at the end of the module depends on the hashes.
+; CHECK-DAG: tail call i32 @a(
+; CHECK-DAG: tail call i64 @d(
+define i64 @d(i64 %x) {
+  %y = mul i64 %x, 3
+  %z = xor i64 %y, %x
+  %r = mul i64 %z, 3
+  ret i64 %r
+}
+
+define i64 @e(i64 %x) {
+  %y = mul i64 %x, 3
+  %z = xor i64 %y, %x
+  %r = mul i64 %z, 3
+  ret i64 %r
+}
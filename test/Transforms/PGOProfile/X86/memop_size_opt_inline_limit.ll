@@ -0,0 +1,44 @@
+; RUN: opt < %s -pgo-memop-opt -memop-size-range=0:256 -pgo-memop-scale-count=false \
+; RUN:     -pgo-memop-count-threshold=90 -pgo-memop-percent-threshold=15 -S \
+; RUN:   | FileCheck %s
+; RUN: opt < %s -passes=pgo-memop-opt -memop-size-range=0:256 -pgo-memop-scale-count=false \
+; RUN:     -pgo-memop-count-threshold=90 -pgo-memop-percent-threshold=15 -S \
+; RUN:   | FileCheck %s
+; RUN: opt < %s -pgo-memop-opt -memop-size-range=0:256 -pgo-memop-scale-count=false \
+; RUN:     -pgo-memop-count-threshold=90 -pgo-memop-percent-threshold=15 -S \
+; RUN:     -pgo-memop-use-target-inline-limit=false | FileCheck %s --check-prefix=NOLIMIT
+
+; The hottest size, 200, is above the number of bytes x86-64 expands a memcpy
+; inline, so only the smaller hot sizes are versioned.
+
+target datalayout = "e-m:e-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-unknown-linux-gnu"
+
+define void @foo(i8* %dst, i8* %src, i64 %n) {
+entry:
+  call void @llvm.memcpy.p0i8.p0i8.i64(i8* %dst, i8* %src, i64 %n, i1 false), !prof !0
+  ret void
+}
+
+; CHECK-LABEL: @foo(
+; CHECK:       switch i64 %n, label %[[DEFAULT:.*]] [
+; CHECK-NEXT:    i64 16, label
+; CHECK-NEXT:    i64 4, label
+; CHECK-NEXT:  ]
+; CHECK:       [[DEFAULT]]:
+; CHECK-NEXT:    call void @llvm.memcpy.p0i8.p0i8.i64(i8* %dst, i8* %src, i64 %n, i1 false), !prof [[NEWVP:![0-9]+]]
+; CHECK:       [[NEWVP]] = !{!"VP", i32 1, i64 300, i64 200, i64 300}
+
+; NOLIMIT-LABEL: @foo(
+; NOLIMIT:       switch i64 %n, label %[[DEFAULT:.*]] [
+; NOLIMIT-NEXT:    i64 200, label
+; NOLIMIT-NEXT:    i64 16, label
+; NOLIMIT-NEXT:    i64 4, label
+; NOLIMIT-NEXT:  ]
+; NOLIMIT:       [[DEFAULT]]:
+; NOLIMIT-NEXT:    call void @llvm.memcpy.p0i8.p0i8.i64(i8* %dst, i8* %src, i64 %n, i1 false)
+; NOLIMIT-NOT:     !prof
+
+declare void @llvm.memcpy.p0i8.p0i8.i64(i8* nocapture writeonly, i8* nocapture readonly, i64, i1)
+
+!0 = !{!"VP", i32 1, i64 600, i64 200, i64 300, i64 16, i64 200, i64 4, i64 100}
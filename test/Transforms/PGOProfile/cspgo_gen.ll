@@ -0,0 +1,35 @@
+; RUN: opt < %s -passes=cspgo-instr-gen -S | FileCheck %s --check-prefix=GEN
+; RUN: opt < %s -O2 -cs-profile-generate -S | FileCheck %s --check-prefix=PIPELINE
+; RUN: opt < %s -O2 -profile-generate -cs-profile-generate -S \
+; RUN:   | FileCheck %s --check-prefix=REGULAR
+
+target datalayout = "e-m:e-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-unknown-linux-gnu"
+
+; The raw profile is flagged as holding context-sensitive records, and so is
+; the hash of each record.
+; GEN: @__llvm_profile_raw_version = constant i64 216172782113783812, comdat
+; PIPELINE: @__llvm_profile_raw_version = {{.*}}constant i64 216172782113783812, comdat
+; PIPELINE: @__profc_test_br_1 = private global [{{[0-9]+}} x i64]
+
+; A module is instrumented once, by the regular instrumentation if both are
+; requested.
+; REGULAR: @__llvm_profile_raw_version = {{.*}}constant i64 72057594037927940, comdat
+
+define i32 @test_br_1(i32 %i) {
+entry:
+; GEN: entry:
+; GEN: call void @llvm.instrprof.increment(i8* getelementptr inbounds ([9 x i8], [9 x i8]* @__profn_test_br_1, i32 0, i32 0), i64 1152921530178146050, i32 2, i32 0)
+  %cmp = icmp sgt i32 %i, 0
+  br i1 %cmp, label %if.then, label %if.end
+
+if.then:
+; GEN: if.then:
+; GEN: call void @llvm.instrprof.increment(i8* getelementptr inbounds ([9 x i8], [9 x i8]* @__profn_test_br_1, i32 0, i32 0), i64 1152921530178146050, i32 2, i32 1)
+  %add = add nsw i32 %i, 2
+  br label %if.end
+
+if.end:
+  %retv = phi i32 [ %add, %if.then ], [ %i, %entry ]
+  ret i32 %retv
+}
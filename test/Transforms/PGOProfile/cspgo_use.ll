@@ -0,0 +1,42 @@
+; RUN: llvm-profdata merge %S/Inputs/cspgo_use.proftext -o %t.profdata
+; RUN: opt < %s -passes=pgo-instr-use -pgo-test-profile-file=%t.profdata -S \
+; RUN:   | FileCheck %s --check-prefix=USE
+; RUN: opt < %s -passes=pgo-instr-use,cspgo-instr-use \
+; RUN:   -pgo-test-profile-file=%t.profdata -S \
+; RUN:   | FileCheck %s --check-prefix=CSUSE
+
+; The context-sensitive annotation needs a profile with such records.
+; RUN: llvm-profdata merge %S/Inputs/branch1.proftext -o %t.ir.profdata
+; RUN: not opt < %s -passes=cspgo-instr-use -pgo-test-profile-file=%t.ir.profdata \
+; RUN:   -S 2>&1 | FileCheck %s --check-prefix=DIAG
+; DIAG: Not a context-sensitive IR level instrumentation profile
+
+target datalayout = "e-m:e-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-unknown-linux-gnu"
+
+; The regular records are read by the regular annotation, and the
+; context-sensitive ones replace them afterwards.
+
+define i32 @test_br_1(i32 %i) {
+; USE-LABEL: @test_br_1
+; USE-SAME: !prof ![[ENTRY:[0-9]+]]
+; CSUSE-LABEL: @test_br_1
+; CSUSE-SAME: !prof ![[ENTRY:[0-9]+]]
+entry:
+  %cmp = icmp sgt i32 %i, 0
+  br i1 %cmp, label %if.then, label %if.end
+; USE: br i1 %cmp, label %if.then, label %if.end, !prof ![[BW:[0-9]+]]
+; CSUSE: br i1 %cmp, label %if.then, label %if.end, !prof ![[BW:[0-9]+]]
+
+if.then:
+  %add = add nsw i32 %i, 2
+  br label %if.end
+
+if.end:
+  %retv = phi i32 [ %add, %if.then ], [ %i, %entry ]
+  ret i32 %retv
+}
+; USE-DAG: ![[ENTRY]] = !{!"function_entry_count", i64 3}
+; USE-DAG: ![[BW]] = !{!"branch_weights", i32 2, i32 1}
+; CSUSE-DAG: ![[ENTRY]] = !{!"function_entry_count", i64 10}
+; CSUSE-DAG: ![[BW]] = !{!"branch_weights", i32 1, i32 9}
@@ -0,0 +1,45 @@
+; RUN: opt < %s -pgo-icall-prom -icp-compare-vtables -S | FileCheck %s
+; RUN: opt < %s -pgo-icall-prom -S | FileCheck %s --check-prefix=FUNC
+
+; A virtual call is promoted by comparing the vtable pointer with the address
+; point of the vtable holding the target, and the load of the function pointer
+; is only done on the fallback path.
+
+target datalayout = "e-m:e-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-unknown-linux-gnu"
+
+%struct.A = type { i32 (...)** }
+
+@_ZTV1A = constant { [3 x i8*] } { [3 x i8*] [i8* null, i8* null, i8* bitcast (i32 (%struct.A*)* @_ZN1A1fEv to i8*)] }, !type !0
+
+define i32 @_ZN1A1fEv(%struct.A* %this) {
+entry:
+  ret i32 1
+}
+
+; CHECK-LABEL: @call(
+; CHECK:         %vtable = load
+; CHECK-NEXT:    [[CMP:%.*]] = icmp eq i32 (%struct.A*)** %vtable, bitcast (i8* getelementptr inbounds (i8, i8* bitcast ({ [3 x i8*] }* @_ZTV1A to i8*), i64 16) to i32 (%struct.A*)**)
+; CHECK-NEXT:    br i1 [[CMP]], label %if.true.direct_targ, label %if.false.orig_indirect
+; CHECK:       if.true.direct_targ:
+; CHECK-NEXT:    call i32 @_ZN1A1fEv(
+; CHECK:       if.false.orig_indirect:
+; CHECK-NEXT:    %fptr = load i32 (%struct.A*)*, i32 (%struct.A*)** %vtable
+; CHECK-NEXT:    call i32 %fptr(
+
+; FUNC-LABEL: @call(
+; FUNC:         %fptr = load
+; FUNC-NEXT:    icmp eq i32 (%struct.A*)* %fptr, @_ZN1A1fEv
+
+define i32 @call(%struct.A* %a) {
+entry:
+  %0 = bitcast %struct.A* %a to i32 (%struct.A*)***
+  %vtable = load i32 (%struct.A*)**, i32 (%struct.A*)*** %0
+  %fptr = load i32 (%struct.A*)*, i32 (%struct.A*)** %vtable
+  %call = call i32 %fptr(%struct.A* %a), !prof !1
+  ret i32 %call
+}
+
+!0 = !{i64 16, !"_ZTS1A"}
+; _ZN1A1fEv
+!1 = !{!"VP", i32 0, i64 1600, i64 10489283440387718362, i64 1500}
@@ -0,0 +1,67 @@
+; RUN: opt < %s -pagerando-wrapper-elim -S | FileCheck %s
+
+; Internalized wrapper with only direct calls: deleted, and the binned function
+; gets its name back.
+; CHECK-LABEL: define internal void @local()
+; CHECK-NEXT:    ret void
+define internal void @local() #0 {
+  call void @"local$$orig"()
+  ret void
+}
+define internal void @"local$$orig"() #1 { ret void }
+
+; Wrapper whose address escapes: calls are redirected, the wrapper stays.
+; CHECK-LABEL: define internal void @local_addr()
+; CHECK-NEXT:    call void @"local_addr$$orig"()
+; CHECK-LABEL: define internal void @"local_addr$$orig"()
+define internal void @local_addr() #0 {
+  call void @"local_addr$$orig"()
+  ret void
+}
+define internal void @"local_addr$$orig"() #1 { ret void }
+
+; Preemptible wrapper: calls must keep going through it.
+; CHECK-LABEL: define void @exported()
+define void @exported() #0 {
+  call void @"exported$$orig"()
+  ret void
+}
+define hidden void @"exported$$orig"() #1 { ret void }
+
+; Non-preemptible, but may be called from other modules: calls in this module
+; are redirected, the wrapper stays.
+; CHECK-LABEL: define hidden void @hidden()
+; CHECK-NEXT:    call void @"hidden$$orig"()
+; CHECK-LABEL: define hidden void @"hidden$$orig"()
+define hidden void @hidden() #0 {
+  call void @"hidden$$orig"()
+  ret void
+}
+define hidden void @"hidden$$orig"() #1 { ret void }
+
+@table = global void ()* @local_addr
+
+; CHECK-LABEL: define void @user()
+; CHECK-NEXT:    call void @local()
+; CHECK-NEXT:    call void @"local_addr$$orig"()
+; CHECK-NEXT:    call void @exported()
+; CHECK-NEXT:    call void @"hidden$$orig"()
+define void @user() #1 {
+  call void @local()
+  call void @local_addr()
+  call void @exported()
+  call void @hidden()
+  ret void
+}
+
+; The POT load at the call site is larger than a direct call to the wrapper.
+; CHECK-LABEL: define void @small_user()
+; CHECK-NEXT:    call void @local_addr()
+define void @small_user() #2 {
+  call void @local_addr()
+  ret void
+}
+
+attributes #0 = { noinline optsize }
+attributes #1 = { pagerando }
+attributes #2 = { pagerando minsize optsize }
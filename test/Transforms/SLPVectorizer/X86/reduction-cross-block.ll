@@ -0,0 +1,83 @@
+; RUN: opt -slp-vectorizer -S < %s -mtriple=x86_64-unknown-linux-gnu -mcpu=corei7-avx | FileCheck %s --check-prefix=DEFAULT
+; RUN: opt -slp-vectorizer -S < %s -mtriple=x86_64-unknown-linux-gnu -mcpu=corei7-avx \
+; RUN:     -slp-cross-block-reductions -slp-mixed-reduced-values | FileCheck %s
+
+; The first six additions of the reduction are placed in the entry block,
+; which dominates the block of the reduction root.
+
+; DEFAULT-LABEL: @cross_block(
+; DEFAULT-NOT:   bin.rdx
+; DEFAULT:       ret i32
+
+; CHECK-LABEL: @cross_block(
+; CHECK:       entry:
+; CHECK:         load <8 x i32>
+; CHECK:       next:
+; CHECK:         bin.rdx
+; CHECK:         ret i32
+
+define i32 @cross_block(i32* %p) {
+entry:
+  %p1 = getelementptr inbounds i32, i32* %p, i64 1
+  %p2 = getelementptr inbounds i32, i32* %p, i64 2
+  %p3 = getelementptr inbounds i32, i32* %p, i64 3
+  %p4 = getelementptr inbounds i32, i32* %p, i64 4
+  %p5 = getelementptr inbounds i32, i32* %p, i64 5
+  %p6 = getelementptr inbounds i32, i32* %p, i64 6
+  %p7 = getelementptr inbounds i32, i32* %p, i64 7
+  %l0 = load i32, i32* %p, align 4
+  %l1 = load i32, i32* %p1, align 4
+  %l2 = load i32, i32* %p2, align 4
+  %l3 = load i32, i32* %p3, align 4
+  %l4 = load i32, i32* %p4, align 4
+  %l5 = load i32, i32* %p5, align 4
+  %l6 = load i32, i32* %p6, align 4
+  %l7 = load i32, i32* %p7, align 4
+  %a1 = add i32 %l1, %l0
+  %a2 = add i32 %a1, %l2
+  %a3 = add i32 %a2, %l3
+  %a4 = add i32 %a3, %l4
+  %a5 = add i32 %a4, %l5
+  br label %next
+
+next:
+  %a6 = add i32 %a5, %l6
+  %a7 = add i32 %a6, %l7
+  ret i32 %a7
+}
+
+; The reduced values alternate between additions and subtractions.
+
+; DEFAULT-LABEL: @mixed(
+; DEFAULT-NOT:   bin.rdx
+; DEFAULT:       ret i32
+
+; CHECK-LABEL: @mixed(
+; CHECK:         bin.rdx
+; CHECK:         ret i32
+
+define i32 @mixed(i32* %x, i32* %y) {
+entry:
+  %x1 = getelementptr inbounds i32, i32* %x, i64 1
+  %x2 = getelementptr inbounds i32, i32* %x, i64 2
+  %x3 = getelementptr inbounds i32, i32* %x, i64 3
+  %y1 = getelementptr inbounds i32, i32* %y, i64 1
+  %y2 = getelementptr inbounds i32, i32* %y, i64 2
+  %y3 = getelementptr inbounds i32, i32* %y, i64 3
+  %lx0 = load i32, i32* %x, align 4
+  %lx1 = load i32, i32* %x1, align 4
+  %lx2 = load i32, i32* %x2, align 4
+  %lx3 = load i32, i32* %x3, align 4
+  %ly0 = load i32, i32* %y, align 4
+  %ly1 = load i32, i32* %y1, align 4
+  %ly2 = load i32, i32* %y2, align 4
+  %ly3 = load i32, i32* %y3, align 4
+  %v0 = add i32 %lx0, %ly0
+  %v1 = sub i32 %lx1, %ly1
+  %v2 = add i32 %lx2, %ly2
+  %v3 = sub i32 %lx3, %ly3
+  %r1 = xor i32 %v0, %v1
+  %r2 = xor i32 %r1, %v2
+  %r3 = xor i32 %r2, %v3
+  ret i32 %r3
+}
@@ -0,0 +1,31 @@
+; RUN: opt < %s -sroa -stats -disable-output 2>&1 | FileCheck %s
+; REQUIRES: asserts
+
+; The memcpy of the whole alloca is split across all four partitions.
+
+; CHECK-DAG: 4 sroa - Maximum number of partitions per alloca
+; CHECK-DAG: 5 sroa - Maximum number of slices per alloca
+; CHECK-DAG: 1 sroa - Maximum number of split slice tails overlapping a partition
+
+target datalayout = "e-p:64:64:64-i8:8:8-i32:32:32-i64:64:64-n8:16:32:64"
+
+declare void @llvm.memcpy.p0i8.p0i8.i64(i8* nocapture, i8* nocapture readonly, i64, i1)
+
+define i32 @f(i8* %src) {
+entry:
+  %a = alloca [4 x i32]
+  %a.i8 = bitcast [4 x i32]* %a to i8*
+  call void @llvm.memcpy.p0i8.p0i8.i64(i8* %a.i8, i8* %src, i64 16, i1 false)
+  %p0 = getelementptr [4 x i32], [4 x i32]* %a, i64 0, i64 0
+  %p1 = getelementptr [4 x i32], [4 x i32]* %a, i64 0, i64 1
+  %p2 = getelementptr [4 x i32], [4 x i32]* %a, i64 0, i64 2
+  %p3 = getelementptr [4 x i32], [4 x i32]* %a, i64 0, i64 3
+  %v0 = load i32, i32* %p0
+  %v1 = load i32, i32* %p1
+  %v2 = load i32, i32* %p2
+  %v3 = load i32, i32* %p3
+  %s1 = add i32 %v0, %v1
+  %s2 = add i32 %s1, %v2
+  %s3 = add i32 %s2, %v3
+  ret i32 %s3
+}
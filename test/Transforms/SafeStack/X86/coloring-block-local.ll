@@ -0,0 +1,54 @@
+; RUN: opt -safe-stack -S -mtriple=x86_64-pc-linux-gnu < %s -o - | FileCheck %s
+
+; Without -safe-stack-coloring, allocas whose lifetime and uses are confined
+; to one basic block still share stack slots: %x and %y are at the same
+; offset, and %z, which is used after its lifetime.end, is not.
+
+; CHECK-LABEL: define void @f(
+; CHECK: %[[USP:.*]] = load i8*, i8** @__safestack_unsafe_stack_ptr
+; CHECK-NEXT: getelementptr i8, i8* %[[USP]], i32 -16
+; CHECK: getelementptr i8, i8* %[[USP]], i32 -4
+; CHECK-NEXT: bitcast
+; CHECK-NEXT: call void @capture(
+
+; CHECK: then:
+; CHECK-NEXT: getelementptr i8, i8* %[[USP]], i32 -4
+; CHECK-NEXT: bitcast
+; CHECK-NEXT: call void @capture(
+
+; CHECK: exit:
+; CHECK-NEXT: getelementptr i8, i8* %[[USP]], i32 -8
+; CHECK-NEXT: bitcast
+; CHECK-NEXT: call void @capture(
+; CHECK-NEXT: getelementptr i8, i8* %[[USP]], i32 -8
+
+define void @f(i1 %c) safestack {
+entry:
+  %x = alloca i32, align 4
+  %y = alloca i32, align 4
+  %z = alloca i32, align 4
+  %x0 = bitcast i32* %x to i8*
+  %y0 = bitcast i32* %y to i8*
+  %z0 = bitcast i32* %z to i8*
+  call void @llvm.lifetime.start.p0i8(i64 4, i8* %x0)
+  call void @capture(i32* %x)
+  call void @llvm.lifetime.end.p0i8(i64 4, i8* %x0)
+  br i1 %c, label %then, label %exit
+
+then:
+  call void @llvm.lifetime.start.p0i8(i64 4, i8* %y0)
+  call void @capture(i32* %y)
+  call void @llvm.lifetime.end.p0i8(i64 4, i8* %y0)
+  br label %exit
+
+exit:
+  call void @llvm.lifetime.start.p0i8(i64 4, i8* %z0)
+  call void @capture(i32* %z)
+  call void @llvm.lifetime.end.p0i8(i64 4, i8* %z0)
+  call void @capture(i32* %z)
+  ret void
+}
+
+declare void @capture(i32*)
+declare void @llvm.lifetime.start.p0i8(i64, i8* nocapture)
+declare void @llvm.lifetime.end.p0i8(i64, i8* nocapture)
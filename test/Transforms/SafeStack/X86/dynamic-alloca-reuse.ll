@@ -0,0 +1,66 @@
+; RUN: opt -safe-stack -S -mtriple=x86_64-pc-linux-gnu < %s -o - | FileCheck %s
+
+; The unsafe stack pointer is loaded once: each dynamic alloca and stacksave
+; after that uses the value last stored to it, also across the edge to a
+; block with a single predecessor.
+
+define void @f(i32 %n, i1 %c) safestack {
+; CHECK-LABEL: define void @f(
+entry:
+; CHECK: %[[USP:.*]] = load i8*, i8** @__safestack_unsafe_stack_ptr
+; CHECK-NOT: load i8*, i8** @__safestack_unsafe_stack_ptr
+; CHECK: ptrtoint i8* %[[USP]] to i64
+; CHECK: %[[A:.*]] = inttoptr i64 {{.*}} to i8*
+; CHECK-NEXT: store i8* %[[A]], i8** @__safestack_unsafe_stack_ptr
+  %a = alloca i8, i32 %n
+  call void @capture(i8* %a)
+; CHECK-NOT: load i8*, i8** @__safestack_unsafe_stack_ptr
+; CHECK: ptrtoint i8* %[[A]] to i64
+; CHECK: %[[B:.*]] = inttoptr i64 {{.*}} to i8*
+; CHECK-NEXT: store i8* %[[B]], i8** @__safestack_unsafe_stack_ptr
+  %b = alloca i8, i32 %n
+  call void @capture(i8* %b)
+  br i1 %c, label %then, label %exit
+
+then:
+; CHECK: then:
+; CHECK-NOT: load i8*, i8** @__safestack_unsafe_stack_ptr
+; CHECK: ptrtoint i8* %[[B]] to i64
+; CHECK: %[[D:.*]] = inttoptr i64 {{.*}} to i8*
+; CHECK-NEXT: store i8* %[[D]], i8** @__safestack_unsafe_stack_ptr
+; CHECK: store i8* %[[B]], i8** @__safestack_unsafe_stack_ptr
+  %s = call i8* @llvm.stacksave()
+  %d = alloca i8, i32 %n
+  call void @capture(i8* %d)
+  call void @llvm.stackrestore(i8* %s)
+  br label %exit
+
+exit:
+; CHECK: exit:
+; CHECK-NEXT: store i8* %[[USP]], i8** @__safestack_unsafe_stack_ptr
+; CHECK-NEXT: ret void
+  ret void
+}
+
+; After a call that may return twice, the next dynamic alloca uses the value
+; the unsafe stack pointer is restored to.
+
+define void @g(i32 %n) safestack {
+; CHECK-LABEL: define void @g(
+entry:
+; CHECK: %[[USP:.*]] = load i8*, i8** @__safestack_unsafe_stack_ptr
+; CHECK: call i32 @setjmp(
+; CHECK-NEXT: %[[TOP:.*]] = load i8*, i8** %unsafe_stack_dynamic_ptr
+; CHECK-NEXT: store i8* %[[TOP]], i8** @__safestack_unsafe_stack_ptr
+; CHECK-NOT: load i8*, i8** @__safestack_unsafe_stack_ptr
+; CHECK: ptrtoint i8* %[[TOP]] to i64
+  %call = call i32 @setjmp(i8* null) returns_twice
+  %a = alloca i8, i32 %n
+  call void @capture(i8* %a)
+  ret void
+}
+
+declare void @capture(i8*)
+declare i32 @setjmp(i8*) returns_twice
+declare i8* @llvm.stacksave()
+declare void @llvm.stackrestore(i8*)
@@ -0,0 +1,49 @@
+; Computing the function summaries in parallel produces the same index as
+; computing them serially.
+; RUN: opt -thinlto-bc -o %t.serial.bc %s
+; RUN: opt -thinlto-bc -module-summary-threads=4 -o %t.parallel.bc %s
+; RUN: llvm-dis -o %t.serial.ll %t.serial.bc
+; RUN: llvm-dis -o %t.parallel.ll %t.parallel.bc
+; RUN: diff %t.serial.ll %t.parallel.ll
+; RUN: FileCheck %s < %t.parallel.ll
+
+; CHECK-DAG: gv: (name: "hot", summaries: (function: {{.*}}calls: ((callee: ^{{[0-9]+}}, hotness: hot), (callee: ^{{[0-9]+}}, hotness: hot))
+; CHECK-DAG: gv: (name: "leaf", summaries: (function: {{.*}}refs: (^{{[0-9]+}})
+; CHECK-DAG: gv: (name: "local", summaries: (function: (module: ^0, flags: (linkage: internal,{{.*}}calls: ((callee: ^{{[0-9]+}}{{.*}}
+
+target triple = "x86_64-unknown-linux-gnu"
+
+@g = global i32 0
+
+define void @leaf() {
+  store i32 1, i32* @g
+  ret void
+}
+
+define internal void @local() {
+  call void @leaf()
+  ret void
+}
+
+define void @hot() !prof !15 {
+  call void @leaf()
+  call void @local()
+  ret void
+}
+
+!llvm.module.flags = !{!1}
+!1 = !{i32 1, !"ProfileSummary", !2}
+!2 = !{!3, !4, !5, !6, !7, !8, !9, !10}
+!3 = !{!"ProfileFormat", !"InstrProf"}
+!4 = !{!"TotalCount", i64 10000}
+!5 = !{!"MaxCount", i64 10}
+!6 = !{!"MaxInternalCount", i64 1}
+!7 = !{!"MaxFunctionCount", i64 1000}
+!8 = !{!"NumCounts", i64 3}
+!9 = !{!"NumFunctions", i64 3}
+!10 = !{!"DetailedSummary", !11}
+!11 = !{!12, !13, !14}
+!12 = !{i32 10000, i64 100, i32 1}
+!13 = !{i32 999000, i64 100, i32 1}
+!14 = !{i32 999999, i64 1, i32 2}
+!15 = !{!"function_entry_count", i64 1000}
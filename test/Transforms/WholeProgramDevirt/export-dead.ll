@@ -0,0 +1,49 @@
+; RUN: opt -wholeprogramdevirt -wholeprogramdevirt-summary-action=export -wholeprogramdevirt-read-summary=%S/Inputs/export-dead.yaml -wholeprogramdevirt-write-summary=%t -S -o - %s | FileCheck %s
+; RUN: FileCheck --check-prefix=SUMMARY %s < %t
+
+; Virtual calls that only appear in dead functions must not cause resolutions
+; to be exported.
+
+; SUMMARY:      TypeIdMap:
+; SUMMARY-NEXT:   typeid1:
+; SUMMARY-NEXT:     TTRes:
+; SUMMARY-NEXT:       Kind:            Unsat
+; SUMMARY-NEXT:       SizeM1BitWidth:  0
+; SUMMARY-NEXT:       AlignLog2:       0
+; SUMMARY-NEXT:       SizeM1:          0
+; SUMMARY-NEXT:       BitMask:         0
+; SUMMARY-NEXT:       InlineBits:      0
+; SUMMARY-NEXT:     WPDRes:
+; SUMMARY-NEXT:       0:
+; SUMMARY-NEXT:         Kind:            SingleImpl
+; SUMMARY-NEXT:         SingleImplName:  'vf1$merged'
+; SUMMARY-NEXT:         ResByArg:
+; SUMMARY-NEXT: WithGlobalValueDeadStripping: true
+; SUMMARY-NEXT: ...
+
+; CHECK: @vt1 = constant void (i8*)* @"vf1$merged"
+@vt1 = constant void (i8*)* @vf1, !type !0
+
+; CHECK: @vt2 = constant void (i8*)* @vf2
+@vt2 = constant void (i8*)* @vf2, !type !1
+
+; CHECK: @vt3 = constant i32 (i8*, i32, i32)* @vf3
+@vt3 = constant i32 (i8*, i32, i32)* @vf3, !type !2
+
+; CHECK: define hidden void @"vf1$merged"(i8*)
+define internal void @vf1(i8*) {
+  ret void
+}
+
+; CHECK: define internal void @vf2(i8*)
+define internal void @vf2(i8*) {
+  ret void
+}
+
+define internal i32 @vf3(i8*, i32 %a, i32 %b) readnone {
+  ret i32 1
+}
+
+!0 = !{i32 0, !"typeid1"}
+!1 = !{i32 0, !"typeid2"}
+!2 = !{i32 0, !"typeid3"}
@@ -0,0 +1,56 @@
+; RUN: not llvm-as < %s -o /dev/null 2>&1 | FileCheck %s
+; RUN: not llvm-as -verifier-threads=4 < %s -o /dev/null 2>&1 | FileCheck %s
+; RUN: not llvm-as -verify-dominance=false < %s -o /dev/null 2>&1 \
+; RUN:   | FileCheck %s --check-prefix=STRUCTURAL
+
+; The failures found by different threads are printed in function order. @sp1
+; and @sp2 are verified by different threads.
+
+; CHECK:      Instruction does not dominate all uses!
+; CHECK-NEXT:   %z = add i32 %x, 1
+; CHECK-NEXT:   %y = add i32 %z, 1
+; CHECK:      isvolatile argument of memory intrinsics must be a constant int
+; CHECK:      DISubprogram attached to more than one function
+; CHECK-NEXT: !{{[0-9]+}} = distinct !DISubprogram(name: "f"
+; CHECK-NEXT: void ()* @sp2
+
+; STRUCTURAL-NOT: Instruction does not dominate all uses!
+; STRUCTURAL:     isvolatile argument of memory intrinsics must be a constant int
+; STRUCTURAL:     DISubprogram attached to more than one function
+
+define i32 @dominance(i32 %x) {
+  %y = add i32 %z, 1
+  %z = add i32 %x, 1
+  ret i32 %y
+}
+
+define void @valid1() {
+  ret void
+}
+
+declare void @llvm.memcpy.p0i8.p0i8.i64(i8*, i8*, i64, i1)
+
+define void @memcpy(i8* %d, i8* %s, i1 %v) {
+  call void @llvm.memcpy.p0i8.p0i8.i64(i8* %d, i8* %s, i64 8, i1 %v)
+  ret void
+}
+
+define void @sp1() !dbg !4 {
+  ret void
+}
+
+define void @valid2() {
+  ret void
+}
+
+define void @sp2() !dbg !4 {
+  ret void
+}
+
+!llvm.dbg.cu = !{!0}
+!llvm.module.flags = !{!3}
+
+!0 = distinct !DICompileUnit(language: DW_LANG_C99, file: !1, emissionKind: FullDebug)
+!1 = !DIFile(filename: "t.c", directory: "/")
+!3 = !{i32 2, !"Debug Info Version", i32 3}
+!4 = distinct !DISubprogram(name: "f", scope: !1, file: !1, line: 1, unit: !0)
@@ -0,0 +1,48 @@
+# RUN: llvm-mca -mtriple=x86_64-unknown-unknown -mcpu=btver2 -iterations=1 -instruction-info=false -resource-pressure=false -j=2 < %s | FileCheck %s
+# RUN: llvm-mca -mtriple=x86_64-unknown-unknown -mcpu=btver2 -iterations=1 -instruction-info=false -resource-pressure=false -json < %s | FileCheck %s --check-prefix=JSON
+# RUN: llvm-mca -mtriple=x86_64-unknown-unknown -mcpu=btver2 -iterations=1 -instruction-info=false -resource-pressure=false -json -j=2 < %s | FileCheck %s --check-prefix=JSON
+
+# LLVM-MCA-BEGIN first
+  add %edi, %esi
+# LLVM-MCA-END
+
+# LLVM-MCA-BEGIN second
+  add %edi, %esi
+  add %esi, %eax
+# LLVM-MCA-END
+
+# LLVM-MCA-BEGIN third
+  imul %edi, %esi
+# LLVM-MCA-END
+
+# The reports of regions simulated in parallel are printed in program order.
+
+# CHECK:      [0] Code Region - first
+# CHECK:      Instructions:      1
+# CHECK:      [1] Code Region - second
+# CHECK:      Instructions:      2
+# CHECK:      [2] Code Region - third
+# CHECK:      Instructions:      1
+
+# JSON:      "CodeRegions": [
+# JSON-NEXT:   {
+# JSON-NEXT:     "Name": "first",
+# JSON-NEXT:     "SummaryView": {
+# JSON-NEXT:       "BlockRThroughput": 0.5,
+# JSON-NEXT:       "DispatchWidth": 2,
+# JSON-NEXT:       "IPC": 0.25,
+# JSON-NEXT:       "Instructions": 1,
+# JSON-NEXT:       "Iterations": 1,
+# JSON-NEXT:       "TotalCycles": 4,
+# JSON-NEXT:       "TotaluOps": 1,
+# JSON-NEXT:       "uOpsPerCycle": 0.25
+# JSON-NEXT:     }
+# JSON-NEXT:   },
+# JSON-NEXT:   {
+# JSON-NEXT:     "Name": "second",
+# JSON:            "Instructions": 2,
+# JSON:          "Name": "third",
+# JSON:        "TargetInfo": {
+# JSON-NEXT:     "CPUName": "btver2",
+# JSON-NEXT:     "TargetTriple": "x86_64-unknown-unknown"
+# JSON-NEXT:   }
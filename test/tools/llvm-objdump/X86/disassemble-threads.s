@@ -0,0 +1,35 @@
+# Disassembling the symbols of a section on several threads prints the same
+# output, with the relocations in place.
+# RUN: llvm-mc -filetype=obj -triple=x86_64-pc-linux %s -o %t.o
+# RUN: llvm-objdump -d -r %t.o > %t.serial
+# RUN: llvm-objdump -d -r --disassemble-threads=4 %t.o > %t.threads
+# RUN: diff %t.serial %t.threads
+# RUN: FileCheck %s < %t.threads
+
+# CHECK:      f1:
+# CHECK-NEXT:   0: 89 f8 movl %edi, %eax
+# CHECK-NEXT:   2: e8 00 00 00 00 callq 0 <f1+0x7>
+# CHECK-NEXT:     R_X86_64_PLT32 ext-4
+# CHECK-NEXT:   7: c3 retq
+# CHECK:      f2:
+# CHECK-NEXT:   8: 48 8d 05 00 00 00 00 leaq (%rip), %rax
+# CHECK-NEXT:     R_X86_64_PC32 data-4
+# CHECK-NEXT:   f: eb ef jmp -17 <f1>
+# CHECK:      f3:
+# CHECK-NEXT:  11: 31 c0 xorl %eax, %eax
+# CHECK-NEXT:  13: c3 retq
+
+  .text
+  .globl f1
+f1:
+  movl %edi, %eax
+  callq ext
+  retq
+  .globl f2
+f2:
+  leaq data(%rip), %rax
+  jmp f1
+  .globl f3
+f3:
+  xorl %eax, %eax
+  retq
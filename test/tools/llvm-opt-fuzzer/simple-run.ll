@@ -7,6 +7,12 @@
 ; RUN: llvm-opt-fuzzer %t -ignore_remaining_args=1 -mtriple x86_64 -passes instcombine 2>&1 | FileCheck %s
 ; CHECK: Running
 
+; RUN: llvm-opt-fuzzer %t -ignore_remaining_args=1 -mtriple x86_64 -passes instcombine -reuse-context=2 -time-phases 2>&1 | FileCheck %s --check-prefix=TIME
+; TIME: llvm-opt-fuzzer: 1 inputs run, {{.*}} execs/sec
+; TIME: llvm-opt-fuzzer phases
+; TIME-DAG: Parse and verify
+; TIME-DAG: Optimize
+
 define i32 @test(i32 %n) {
 entry:
   ret i32 0
@@ -0,0 +1,42 @@
+; RUN: llvm-split -split-module-call-affinity -o %t %s
+; RUN: llvm-dis -o - %t0 | FileCheck --check-prefix=CHECK0 %s
+; RUN: llvm-dis -o - %t1 | FileCheck --check-prefix=CHECK1 %s
+
+; The hot calls from a to b and from c to d stay within a partition, one of
+; the cold calls from e crosses partitions.
+
+; CHECK0: define void @a
+; CHECK0: define void @b
+; CHECK0: define void @e
+; CHECK0-NOT: define
+
+; CHECK1: define void @c
+; CHECK1: define void @d
+; CHECK1-NOT: define
+
+define void @a() !prof !0 {
+  call void @b()
+  ret void
+}
+
+define void @b() !prof !0 {
+  ret void
+}
+
+define void @c() !prof !0 {
+  call void @d()
+  ret void
+}
+
+define void @d() !prof !0 {
+  ret void
+}
+
+define void @e() !prof !1 {
+  call void @b()
+  call void @d()
+  ret void
+}
+
+!0 = !{!"function_entry_count", i64 1000}
+!1 = !{!"function_entry_count", i64 1}
@@ -2373,8 +2373,22 @@ bool DwarfLinker::link(const DebugMap &Map) {
       updateAccelKind(*LC.DwarfContext);
   }
 
-  // This Dwarf string pool which is only used for uniquing. This one should
-  // never be used for offsets as its not thread-safe or predictable.
+  // Reading in the debug info of the objects below is serial because loading
+  // the clang modules they reference must happen in order, but parsing their
+  // DIEs is independent for every unit. With several threads, do it for the
+  // units of all objects up front.
+  if (Options.Threads > 1) {
+    std::vector<DWARFContext *> Contexts;
+    for (LinkContext &LC : ObjectContexts)
+      if (LC.ObjectFile && LC.DwarfContext &&
+          LC.DMO.getType() != MachO::N_AST)
+        Contexts.push_back(LC.DwarfContext.get());
+    DWARFContext::extractAllDIEs(Contexts, Options.Threads);
+  }
+
+  // This Dwarf string pool which is only used for uniquing. It is
+  // thread-safe, but should never be used for offsets as its layout isn't
+  // predictable.
   UniquingStringPool UniquingStringPool;
 
   // This Dwarf string pool which is used for emission. It must be used
@@ -14,6 +14,7 @@
 #include "llvm/ADT/StringRef.h"
 #include "llvm/CodeGen/DwarfStringPoolEntry.h"
 #include "llvm/Support/Allocator.h"
+#include "llvm/Support/ConcurrentStringPool.h"
 #include <cstdint>
 #include <vector>
 
@@ -74,11 +75,20 @@ public:
 /// It's very easy to introduce bugs by passing the wrong string pool in the
 /// dwarf linker. By using strong types the interface enforces that the right
 /// kind of pool is used.
-struct UniqueTag {};
 struct OffsetsTag {};
-using UniquingStringPool = StrongType<NonRelocatableStringpool, UniqueTag>;
 using OffsetsStringPool = StrongType<NonRelocatableStringpool, OffsetsTag>;
 
+/// The pool used to unique the names of the ODR declaration contexts. Only
+/// the permanent storage of its strings matters, so it is safe to use from
+/// several threads at once.
+class UniquingStringPool {
+public:
+  StringRef internString(StringRef S) { return Pool.intern(S); }
+
+private:
+  ConcurrentStringPool Pool;
+};
+
 } // end namespace dsymutil
 } // end namespace llvm
 
@@ -14,6 +14,7 @@
 //===----------------------------------------------------------------------===//
 
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/StringExtras.h"
 #include "llvm/ADT/Triple.h"
 #include "llvm/Analysis/TargetLibraryInfo.h"
 #include "llvm/CodeGen/CommandFlags.inc"
@@ -22,6 +23,7 @@
 #include "llvm/CodeGen/MIRParser/MIRParser.h"
 #include "llvm/CodeGen/MachineFunctionPass.h"
 #include "llvm/CodeGen/MachineModuleInfo.h"
+#include "llvm/CodeGen/ParallelCG.h"
 #include "llvm/CodeGen/TargetPassConfig.h"
 #include "llvm/CodeGen/TargetSubtargetInfo.h"
 #include "llvm/IR/AutoUpgrade.h"
@@ -35,6 +37,7 @@
 #include "llvm/IR/Verifier.h"
 #include "llvm/IRReader/IRReader.h"
 #include "llvm/MC/SubtargetFeature.h"
+#include "llvm/OptRemarks/BinaryRemarks.h"
 #include "llvm/Pass.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
@@ -145,9 +148,26 @@ static cl::opt<unsigned> PassRemarksHotnessThreshold(
 
 static cl::opt<std::string>
     RemarksFilename("pass-remarks-output",
-                    cl::desc("YAML output filename for pass remarks"),
+                    cl::desc("Output filename for pass remarks"),
                     cl::value_desc("filename"));
 
+namespace {
+enum class RemarksFormatKind { YAML, Binary };
+} // end anonymous namespace
+
+static cl::opt<RemarksFormatKind> RemarksFormat(
+    "pass-remarks-format",
+    cl::desc("The format of the file given to -pass-remarks-output"),
+    cl::values(clEnumValN(RemarksFormatKind::YAML, "yaml", "YAML (default)"),
+               clEnumValN(RemarksFormatKind::Binary, "binary",
+                          "Compact binary format with a string table")),
+    cl::init(RemarksFormatKind::YAML));
+
+static cl::opt<unsigned> CodeGenPartitions(
+    "codegen-partitions", cl::Hidden, cl::init(1), cl::value_desc("N"),
+    cl::desc("Split the module into N partitions and generate code for them "
+             "in parallel. Partition I > 0 is written to <output>.I"));
+
 namespace {
 static ManagedStatic<std::vector<std::string>> RunPassNames;
 
@@ -334,8 +354,12 @@ int main(int argc, char **argv) {
       WithColor::error(errs(), argv[0]) << EC.message() << '\n';
       return 1;
     }
-    Context.setDiagnosticsOutputFile(
-        llvm::make_unique<yaml::Output>(YamlFile->os()));
+    if (RemarksFormat == RemarksFormatKind::Binary)
+      Context.setDiagnosticsBinaryOutputFile(
+          llvm::make_unique<remarks::BinaryRemarkWriter>(YamlFile->os()));
+    else
+      Context.setDiagnosticsOutputFile(
+          llvm::make_unique<yaml::Output>(YamlFile->os()));
   }
 
   if (InputLanguage != "" && InputLanguage != "ir" &&
@@ -519,6 +543,53 @@ static int compileModule(char **argv, LLVMContext &Context) {
     WithColor::warning(errs(), argv[0])
         << ": warning: ignoring -mc-relax-all because filetype != obj";
 
+  // Split code generation runs the backend for each partition in its own
+  // thread and LLVMContext, so it only supports the default pipeline.
+  if (CodeGenPartitions > 1) {
+    if (MIR || !RunPassNames->empty() || CompileTwice || DwoOut ||
+        OutputFilename == "-") {
+      WithColor::error(errs(), argv[0])
+          << "-codegen-partitions requires IR input and a named output file, "
+             "and cannot be combined with -run-pass, -compile-twice or "
+             "-split-dwarf-output\n";
+      return 1;
+    }
+
+    sys::fs::OpenFlags OpenFlags = sys::fs::F_None;
+    if (FileType == TargetMachine::CGFT_AssemblyFile)
+      OpenFlags |= sys::fs::F_Text;
+
+    std::vector<std::unique_ptr<ToolOutputFile>> PartOuts;
+    SmallVector<raw_pwrite_stream *, 8> OSs;
+    OSs.push_back(&Out->os());
+    for (unsigned I = 1; I != CodeGenPartitions; ++I) {
+      std::error_code EC;
+      PartOuts.push_back(llvm::make_unique<ToolOutputFile>(
+          OutputFilename + "." + utostr(I), EC, OpenFlags));
+      if (EC) {
+        WithColor::error(errs(), argv[0]) << EC.message() << '\n';
+        return 1;
+      }
+      OSs.push_back(&PartOuts.back()->os());
+    }
+
+    cl::PrintOptionValues();
+
+    splitCodeGen(
+        std::move(M), OSs, {},
+        [&]() {
+          return std::unique_ptr<TargetMachine>(TheTarget->createTargetMachine(
+              TheTriple.getTriple(), CPUStr, FeaturesStr, Options,
+              getRelocModel(), getCodeModel(), OLvl));
+        },
+        FileType);
+
+    Out->keep();
+    for (auto &PartOut : PartOuts)
+      PartOut->keep();
+    return 0;
+  }
+
   {
     raw_pwrite_stream *OS = &Out->os();
 
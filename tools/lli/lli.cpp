@@ -28,6 +28,7 @@
 #include "llvm/ExecutionEngine/Orc/ExecutionUtils.h"
 #include "llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h"
 #include "llvm/ExecutionEngine/Orc/LLJIT.h"
+#include "llvm/ExecutionEngine/Orc/LocalObjectCache.h"
 #include "llvm/ExecutionEngine/Orc/OrcRemoteTargetClient.h"
 #include "llvm/ExecutionEngine/OrcMCJITReplacement.h"
 #include "llvm/ExecutionEngine/SectionMemoryManager.h"
@@ -756,16 +757,39 @@ static orc::IRTransformLayer::TransformFunction createDebugDumper() {
 
 static void exitOnLazyCallThroughFailure() { exit(1); }
 
+// Bitcode is loaded lazily, so that only the bodies of the functions that get
+// called are ever read. Textual IR is parsed whole.
+static orc::ThreadSafeModule loadOrcLazyModule(StringRef Path,
+                                               orc::ThreadSafeContext &TSCtx,
+                                               const char *ProgName) {
+  SMDiagnostic Err;
+  auto Buffer = MemoryBuffer::getFileOrSTDIN(Path);
+  if (!Buffer) {
+    Err = SMDiagnostic(Path, SourceMgr::DK_Error,
+                       "Could not open input file: " +
+                           Buffer.getError().message());
+    reportError(Err, ProgName);
+  }
+
+  const unsigned char *Start =
+      reinterpret_cast<const unsigned char *>((*Buffer)->getBufferStart());
+  const unsigned char *End =
+      reinterpret_cast<const unsigned char *>((*Buffer)->getBufferEnd());
+  if (isBitcode(Start, End))
+    return ExitOnErr(orc::loadLazyBitcodeModule(std::move(*Buffer), TSCtx));
+
+  auto M = parseIR((*Buffer)->getMemBufferRef(), Err, *TSCtx.getContext());
+  if (!M)
+    reportError(Err, ProgName);
+  return orc::ThreadSafeModule(std::move(M), TSCtx);
+}
+
 int runOrcLazyJIT(const char *ProgName) {
   // Start setting up the JIT environment.
 
   // Parse the main module.
   orc::ThreadSafeContext TSCtx(llvm::make_unique<LLVMContext>());
-  SMDiagnostic Err;
-  auto MainModule = orc::ThreadSafeModule(
-      parseIRFile(InputFile, Err, *TSCtx.getContext()), TSCtx);
-  if (!MainModule)
-    reportError(Err, ProgName);
+  auto MainModule = loadOrcLazyModule(InputFile, TSCtx, ProgName);
 
   const auto &TT = MainModule.getModule()->getTargetTriple();
   orc::JITTargetMachineBuilder JTMB =
@@ -786,10 +810,23 @@ int runOrcLazyJIT(const char *ProgName) {
 
   DataLayout DL = ExitOnErr(JTMB.getDefaultDataLayoutForTarget());
 
+  // Keep the objects of every function across runs.
+  std::unique_ptr<orc::LocalObjectCache> CacheManager;
+  if (EnableCacheManager) {
+    if (ObjectCacheDir.empty()) {
+      errs() << ProgName
+             << ": -enable-cache-manager with -jit-kind=orc-lazy requires "
+                "-object-cache-dir\n";
+      exit(1);
+    }
+    CacheManager =
+        ExitOnErr(orc::LocalObjectCache::Create(ObjectCacheDir, JTMB));
+  }
+
   auto J = ExitOnErr(orc::LLLazyJIT::Create(
       std::move(JTMB), DL,
       pointerToJITTargetAddress(exitOnLazyCallThroughFailure),
-      LazyJITCompileThreads));
+      LazyJITCompileThreads, CacheManager.get()));
 
   if (PerModuleLazy)
     J->setPartitionFunction(orc::CompileOnDemandLayer::compileWholeModule);
@@ -829,16 +866,13 @@ int runOrcLazyJIT(const char *ProgName) {
 
     for (auto EMItr = ExtraModules.begin(), EMEnd = ExtraModules.end();
          EMItr != EMEnd; ++EMItr) {
-      auto M = parseIRFile(*EMItr, Err, *TSCtx.getContext());
-      if (!M)
-        reportError(Err, ProgName);
+      auto M = loadOrcLazyModule(*EMItr, TSCtx, ProgName);
 
       auto EMIdx = ExtraModules.getPosition(EMItr - ExtraModules.begin());
       assert(EMIdx != 0 && "ExtraModule should have index > 0");
       auto JDItr = std::prev(IdxToDylib.lower_bound(EMIdx));
       auto &JD = *JDItr->second;
-      ExitOnErr(
-          J->addLazyIRModule(JD, orc::ThreadSafeModule(std::move(M), TSCtx)));
+      ExitOnErr(J->addLazyIRModule(JD, std::move(M)));
     }
   }
 
@@ -352,8 +352,14 @@ std::unique_ptr<CoverageMapping> CodeCoverageTool::load() {
     if (modifiedTimeGT(ObjectFilename, PGOFilename))
       warning("profile data may be out of date - object is newer",
               ObjectFilename);
-  auto CoverageOrErr =
-      CoverageMapping::load(ObjectFilenames, PGOFilename, CoverageArches);
+  // If NumThreads is not specified, auto-detect a good default.
+  unsigned NumThreads = ViewOpts.NumThreads;
+  if (NumThreads == 0)
+    NumThreads =
+        std::max(1U, std::min(llvm::heavyweight_hardware_concurrency(),
+                              unsigned(ObjectFilenames.size())));
+  auto CoverageOrErr = CoverageMapping::load(ObjectFilenames, PGOFilename,
+                                             CoverageArches, NumThreads);
   if (Error E = CoverageOrErr.takeError()) {
     error("Failed to load coverage: " + toString(std::move(E)),
           join(ObjectFilenames.begin(), ObjectFilenames.end(), ", "));
@@ -0,0 +1,66 @@
+//===- CoverageExporter.cpp - Code coverage exporter ----------------------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements the parts of code coverage export shared by all
+// export formats.
+//
+//===----------------------------------------------------------------------===//
+
+#include "CoverageExporter.h"
+#include "llvm/Support/Threading.h"
+#include "llvm/Support/ThreadPool.h"
+#include <string>
+#include <vector>
+
+using namespace llvm;
+
+/// The number of files rendered per thread before a batch is written out.
+static const unsigned FilesPerThreadInBatch = 16;
+
+void CoverageExporter::renderFilesInOrder(
+    unsigned NumFiles, StringRef Separator,
+    function_ref<void(raw_ostream &FileOS, unsigned I)> RenderFile) {
+  unsigned NumThreads = Options.NumThreads;
+  // If NumThreads is not specified, auto-detect a good default.
+  if (NumThreads == 0)
+    NumThreads = std::max(
+        1U, std::min(llvm::heavyweight_hardware_concurrency(), NumFiles));
+
+  if (NumThreads == 1 || NumFiles < 2) {
+    for (unsigned I = 0; I < NumFiles; ++I) {
+      if (I)
+        OS << Separator;
+      RenderFile(OS, I);
+    }
+    return;
+  }
+
+  // Render a batch of files into separate buffers, then write the buffers in
+  // order so the output does not depend on the number of threads.
+  unsigned BatchSize = NumThreads * FilesPerThreadInBatch;
+  std::vector<std::string> Buffers(std::min(BatchSize, NumFiles));
+  ThreadPool Pool(NumThreads);
+  for (unsigned Begin = 0; Begin < NumFiles; Begin += BatchSize) {
+    unsigned End = std::min(NumFiles, Begin + BatchSize);
+    for (unsigned I = Begin; I < End; ++I)
+      Pool.async([&, I]() {
+        raw_string_ostream FileOS(Buffers[I - Begin]);
+        RenderFile(FileOS, I);
+      });
+    Pool.wait();
+    for (unsigned I = Begin; I < End; ++I) {
+      if (I)
+        OS << Separator;
+      std::string &Buffer = Buffers[I - Begin];
+      OS << Buffer;
+      // Release the memory of the file, not just its contents.
+      std::string().swap(Buffer);
+    }
+  }
+}
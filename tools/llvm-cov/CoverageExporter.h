@@ -17,6 +17,7 @@
 #include "CoverageFilters.h"
 #include "CoverageSummaryInfo.h"
 #include "CoverageViewOptions.h"
+#include "llvm/ADT/STLExtras.h"
 #include "llvm/ProfileData/Coverage/CoverageMapping.h"
 
 namespace llvm {
@@ -37,6 +38,14 @@ protected:
                    const CoverageViewOptions &Options, raw_ostream &OS)
       : Coverage(CoverageMapping), Options(Options), OS(OS) {}
 
+  /// Call \p RenderFile for each of the \p NumFiles files and write what it
+  /// renders to OS in file order, separated by \p Separator. Files are
+  /// rendered in parallel in bounded batches, so at most a few files per
+  /// thread are held in memory at once.
+  void renderFilesInOrder(
+      unsigned NumFiles, StringRef Separator,
+      function_ref<void(raw_ostream &FileOS, unsigned I)> RenderFile);
+
 public:
   virtual ~CoverageExporter(){};
 
@@ -39,6 +39,10 @@
 //     -- InstantiationCoverage: dict => Object summarizing inst. coverage
 //     -- RegionCoverage: dict => Object summarizing region coverage
 //
+// The root and export objects are written out piece by piece, and only one
+// file or function is held as a json::Value at a time, so the memory used
+// does not grow with the size of the project.
+//
 //===----------------------------------------------------------------------===//
 
 #include "CoverageExporterJson.h"
@@ -140,27 +144,11 @@ json::Object renderFile(const coverage::CoverageMapping &Coverage,
   return File;
 }
 
-json::Array renderFiles(const coverage::CoverageMapping &Coverage,
-                        ArrayRef<std::string> SourceFiles,
-                        ArrayRef<FileCoverageSummary> FileReports,
-                        bool ExportSummaryOnly) {
-  json::Array FileArray;
-  for (unsigned I = 0, E = SourceFiles.size(); I < E; ++I)
-    FileArray.push_back(renderFile(Coverage, SourceFiles[I], FileReports[I],
-                                   ExportSummaryOnly));
-  return FileArray;
-}
-
-json::Array renderFunctions(
-    const iterator_range<coverage::FunctionRecordIterator> &Functions) {
-  json::Array FunctionArray;
-  for (const auto &F : Functions)
-    FunctionArray.push_back(
-        json::Object({{"name", F.Name},
-                      {"count", int64_t(F.ExecutionCount)},
-                      {"regions", renderRegions(F.CountedRegions)},
-                      {"filenames", json::Array(F.Filenames)}}));
-  return FunctionArray;
+json::Object renderFunction(const coverage::FunctionRecord &F) {
+  return json::Object({{"name", F.Name},
+                       {"count", int64_t(F.ExecutionCount)},
+                       {"regions", renderRegions(F.CountedRegions)},
+                       {"filenames", json::Array(F.Filenames)}});
 }
 
 } // end anonymous namespace
@@ -178,17 +166,31 @@ void CoverageExporterJson::renderRoot(ArrayRef<std::string> SourceFiles) {
   FileCoverageSummary Totals = FileCoverageSummary("Totals");
   auto FileReports = CoverageReport::prepareFileReports(Coverage, Totals,
                                                         SourceFiles, Options);
-  auto Export =
-      json::Object({{"files", renderFiles(Coverage, SourceFiles, FileReports,
-                                          Options.ExportSummaryOnly)},
-                    {"totals", renderSummary(Totals)}});
-  // Skip functions-level information for summary-only export mode.
-  if (!Options.ExportSummaryOnly)
-    Export["functions"] = renderFunctions(Coverage.getCoveredFunctions());
 
-  auto ExportArray = json::Array({std::move(Export)});
+  // Keys are written in sorted order, as json::Object would print them.
+  OS << "{\"data\":[{\"files\":[";
+  renderFilesInOrder(SourceFiles.size(), ",",
+                     [&](raw_ostream &FileOS, unsigned I) {
+                       FileOS << renderFile(Coverage, SourceFiles[I],
+                                            FileReports[I],
+                                            Options.ExportSummaryOnly);
+                     });
+  OS << "]";
+
+  // Skip functions-level information for summary-only export mode.
+  if (!Options.ExportSummaryOnly) {
+    OS << ",\"functions\":[";
+    bool First = true;
+    for (const auto &F : Coverage.getCoveredFunctions()) {
+      if (!First)
+        OS << ",";
+      First = false;
+      OS << renderFunction(F);
+    }
+    OS << "]";
+  }
 
-  OS << json::Object({{"version", LLVM_COVERAGE_EXPORT_JSON_STR},
-                      {"type", LLVM_COVERAGE_EXPORT_JSON_TYPE_STR},
-                      {"data", std::move(ExportArray)}});
+  OS << ",\"totals\":" << renderSummary(Totals) << "}]";
+  OS << ",\"type\":" << json::Value(LLVM_COVERAGE_EXPORT_JSON_TYPE_STR)
+     << ",\"version\":" << json::Value(LLVM_COVERAGE_EXPORT_JSON_STR) << "}";
 }
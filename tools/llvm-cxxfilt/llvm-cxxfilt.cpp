@@ -52,31 +52,28 @@ static cl::alias TypesShort("t", cl::desc("alias for --types"),
 static cl::list<std::string>
 Decorated(cl::Positional, cl::desc("<mangled>"), cl::ZeroOrMore);
 
-static void demangle(llvm::raw_ostream &OS, const std::string &Mangled) {
-  int Status;
-
+static void demangle(llvm::raw_ostream &OS, ItaniumDemangleContext &Demangler,
+                     const std::string &Mangled) {
   const char *Decorated = Mangled.c_str();
   if (StripUnderscore)
     if (Decorated[0] == '_')
       ++Decorated;
   size_t DecoratedLength = strlen(Decorated);
 
-  char *Undecorated = nullptr;
+  const char *Undecorated = nullptr;
 
   if (Types || ((DecoratedLength >= 2 && strncmp(Decorated, "_Z", 2) == 0) ||
                 (DecoratedLength >= 4 && strncmp(Decorated, "___Z", 4) == 0)))
-    Undecorated = itaniumDemangle(Decorated, nullptr, nullptr, &Status);
+    Undecorated = Demangler.demangle(Decorated);
 
   if (!Undecorated &&
       (DecoratedLength > 6 && strncmp(Decorated, "__imp_", 6) == 0)) {
     OS << "import thunk for ";
-    Undecorated = itaniumDemangle(Decorated + 6, nullptr, nullptr, &Status);
+    Undecorated = Demangler.demangle(Decorated + 6);
   }
 
   OS << (Undecorated ? Undecorated : Mangled) << '\n';
   OS.flush();
-
-  free(Undecorated);
 }
 
 int main(int argc, char **argv) {
@@ -84,12 +81,13 @@ int main(int argc, char **argv) {
 
   cl::ParseCommandLineOptions(argc, argv, "llvm symbol undecoration tool\n");
 
+  ItaniumDemangleContext Demangler;
   if (Decorated.empty())
     for (std::string Mangled; std::getline(std::cin, Mangled);)
-      demangle(llvm::outs(), Mangled);
+      demangle(llvm::outs(), Demangler, Mangled);
   else
     for (const auto &Symbol : Decorated)
-      demangle(llvm::outs(), Symbol);
+      demangle(llvm::outs(), Demangler, Symbol);
 
   return EXIT_SUCCESS;
 }
@@ -211,6 +211,11 @@ static opt<bool> Verify("verify", desc("Verify the DWARF debug info."),
                         cat(DwarfDumpCategory));
 static opt<bool> Quiet("quiet", desc("Use with -verify to not emit to STDOUT."),
                        cat(DwarfDumpCategory));
+static opt<unsigned>
+    Threads("threads",
+            desc("Number of threads used to extract the DIEs of all units "
+                 "before -verify or -statistics (0 extracts them lazily)."),
+            init(0), cat(DwarfDumpCategory));
 static opt<bool> DumpUUID("uuid", desc("Show the UUID for each architecture."),
                           cat(DwarfDumpCategory));
 static alias DumpUUIDAlias("u", desc("Alias for -uuid."), aliasopt(DumpUUID));
@@ -404,6 +409,13 @@ static bool lookup(DWARFContext &DICtx, uint64_t Address, raw_ostream &OS) {
 bool collectStatsForObjectFile(ObjectFile &Obj, DWARFContext &DICtx,
                                Twine Filename, raw_ostream &OS);
 
+static bool collectStats(ObjectFile &Obj, DWARFContext &DICtx, Twine Filename,
+                         raw_ostream &OS) {
+  if (Threads)
+    DICtx.extractAllDIEs(Threads);
+  return collectStatsForObjectFile(Obj, DICtx, Filename, OS);
+}
+
 static bool dumpObjectFile(ObjectFile &Obj, DWARFContext &DICtx, Twine Filename,
                            raw_ostream &OS) {
   logAllUnhandledErrors(DICtx.loadRegisterInfo(Obj), errs(),
@@ -445,6 +457,8 @@ static bool verifyObjectFile(ObjectFile &Obj, DWARFContext &DICtx,
   raw_ostream &stream = Quiet ? nulls() : OS;
   stream << "Verifying " << Filename.str() << ":\tfile format "
   << Obj.getFileFormatName() << "\n";
+  if (Threads)
+    DICtx.extractAllDIEs(Threads);
   bool Result = DICtx.verify(stream, getDumpOpts());
   if (Result)
     stream << "No errors.\n";
@@ -638,7 +652,7 @@ int main(int argc, char **argv) {
       exit(1);
   } else if (Statistics)
     for (auto Object : Objects)
-      handleFile(Object, collectStatsForObjectFile, OS);
+      handleFile(Object, collectStats, OS);
   else
     for (auto Object : Objects)
       handleFile(Object, dumpObjectFile, OS);
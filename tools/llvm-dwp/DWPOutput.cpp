@@ -0,0 +1,118 @@
+#include "DWPOutput.h"
+#include "llvm/ADT/Optional.h"
+#include "llvm/BinaryFormat/ELF.h"
+#include "llvm/MC/MCSectionELF.h"
+#include "llvm/Object/ELFTypes.h"
+#include "llvm/Support/FileOutputBuffer.h"
+#include "llvm/Support/MathExtras.h"
+#include "llvm/Support/ThreadPool.h"
+#include <algorithm>
+#include <cstring>
+
+using namespace llvm;
+
+void DWPFileOutput::emitBytes(MCSection *Sec, StringRef Data) {
+  if (Data.empty())
+    return addSection(Sec);
+  char *Copy = Alloc.Allocate<char>(Data.size());
+  std::copy(Data.begin(), Data.end(), Copy);
+  Sections[Sec].push_back(StringRef(Copy, Data.size()));
+}
+
+Error DWPFileOutput::finish() {
+  using Ehdr = object::ELF64LE::Ehdr;
+  using Shdr = object::ELF64LE::Shdr;
+
+  // The file holds the ELF header, the section contents, the section name
+  // table and finally the section headers.
+  std::string Names(1, '\0');
+  std::vector<Shdr> Headers(Sections.size() + 2);
+  uint64_t Offset = sizeof(Ehdr);
+  size_t Idx = 1;
+  for (const auto &S : Sections) {
+    const auto *ELFSec = cast<MCSectionELF>(S.first);
+    Shdr &H = Headers[Idx++];
+    H.sh_name = Names.size();
+    Names += ELFSec->getSectionName();
+    Names += '\0';
+    H.sh_type = ELFSec->getType();
+    H.sh_flags = ELFSec->getFlags();
+    H.sh_addralign = ELFSec->getAlignment();
+    H.sh_entsize = ELFSec->getEntrySize();
+    Offset = alignTo(Offset, ELFSec->getAlignment());
+    H.sh_offset = Offset;
+    uint64_t Size = 0;
+    for (StringRef Piece : S.second)
+      Size += Piece.size();
+    H.sh_size = Size;
+    Offset += Size;
+  }
+  Shdr &NamesHeader = Headers[Idx];
+  NamesHeader.sh_name = Names.size();
+  Names += ".shstrtab";
+  Names += '\0';
+  NamesHeader.sh_type = ELF::SHT_STRTAB;
+  NamesHeader.sh_addralign = 1;
+  NamesHeader.sh_offset = Offset;
+  NamesHeader.sh_size = Names.size();
+  uint64_t HeadersOffset = alignTo(Offset + Names.size(), 8);
+  uint64_t FileSize = HeadersOffset + Headers.size() * sizeof(Shdr);
+
+  Expected<std::unique_ptr<FileOutputBuffer>> BufferOrErr =
+      FileOutputBuffer::create(Path, FileSize);
+  if (!BufferOrErr)
+    return BufferOrErr.takeError();
+  std::unique_ptr<FileOutputBuffer> Buffer = std::move(*BufferOrErr);
+  uint8_t *Start = Buffer->getBufferStart();
+
+  Ehdr EH;
+  memset(&EH, 0, sizeof(EH));
+  memcpy(EH.e_ident, ELF::ElfMagic, strlen(ELF::ElfMagic));
+  EH.e_ident[ELF::EI_CLASS] = ELF::ELFCLASS64;
+  EH.e_ident[ELF::EI_DATA] = ELF::ELFDATA2LSB;
+  EH.e_ident[ELF::EI_VERSION] = ELF::EV_CURRENT;
+  EH.e_type = ELF::ET_REL;
+  EH.e_machine = Machine;
+  EH.e_version = ELF::EV_CURRENT;
+  EH.e_shoff = HeadersOffset;
+  EH.e_ehsize = sizeof(Ehdr);
+  EH.e_shentsize = sizeof(Shdr);
+  EH.e_shnum = Headers.size();
+  EH.e_shstrndx = Idx;
+  memcpy(Start, &EH, sizeof(EH));
+
+  // Copy the contributions in batches of a similar size, which may run in
+  // parallel as they never overlap.
+  const uint64_t BatchSize = 16 << 20;
+  Optional<ThreadPool> Pool;
+  if (NumThreads > 1)
+    Pool.emplace(NumThreads);
+  Idx = 1;
+  for (const auto &S : Sections) {
+    uint8_t *Dst = Start + Headers[Idx++].sh_offset;
+    ArrayRef<StringRef> Pieces = S.second;
+    while (!Pieces.empty()) {
+      size_t N = 0;
+      uint64_t Bytes = 0;
+      while (N != Pieces.size() && Bytes < BatchSize)
+        Bytes += Pieces[N++].size();
+      auto CopyBatch = [=] {
+        uint8_t *P = Dst;
+        for (StringRef Piece : Pieces.take_front(N))
+          P = std::copy(Piece.bytes_begin(), Piece.bytes_end(), P);
+      };
+      if (Pool)
+        Pool->async(CopyBatch);
+      else
+        CopyBatch();
+      Dst += Bytes;
+      Pieces = Pieces.drop_front(N);
+    }
+  }
+  if (Pool)
+    Pool->wait();
+
+  std::copy(Names.begin(), Names.end(), Start + NamesHeader.sh_offset);
+  memcpy(Start + HeadersOffset, Headers.data(), Headers.size() * sizeof(Shdr));
+  return Buffer->commit();
+}
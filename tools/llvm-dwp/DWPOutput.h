@@ -0,0 +1,83 @@
+#ifndef TOOLS_LLVM_DWP_DWPOUTPUT
+#define TOOLS_LLVM_DWP_DWPOUTPUT
+
+#include "llvm/ADT/MapVector.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/MC/MCSection.h"
+#include "llvm/MC/MCStreamer.h"
+#include "llvm/Support/Allocator.h"
+#include "llvm/Support/Error.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace llvm {
+
+/// The sections of the package being written.
+class DWPOutput {
+public:
+  virtual ~DWPOutput() = default;
+
+  /// Make \p Sec part of the output, even if nothing is emitted into it.
+  virtual void addSection(MCSection *Sec) = 0;
+
+  /// Append a copy of \p Data to \p Sec.
+  virtual void emitBytes(MCSection *Sec, StringRef Data) = 0;
+
+  /// Append \p Data to \p Sec. \p Data must stay valid until finish().
+  virtual void emitInputBytes(MCSection *Sec, StringRef Data) = 0;
+
+  /// Write the output file.
+  virtual Error finish() = 0;
+};
+
+/// Emits the package through an MCStreamer, which keeps all contributions in
+/// memory until the object file is written.
+class DWPStreamerOutput : public DWPOutput {
+  MCStreamer &Out;
+
+public:
+  DWPStreamerOutput(MCStreamer &Out) : Out(Out) {}
+
+  void addSection(MCSection *Sec) override { Out.SwitchSection(Sec); }
+  void emitBytes(MCSection *Sec, StringRef Data) override {
+    Out.SwitchSection(Sec);
+    Out.EmitBytes(Data);
+  }
+  void emitInputBytes(MCSection *Sec, StringRef Data) override {
+    emitBytes(Sec, Data);
+  }
+  Error finish() override {
+    Out.Finish();
+    return Error::success();
+  }
+};
+
+/// Writes the package as an ELF relocatable file directly into the output
+/// file. Contributions of the inputs are only referenced until finish()
+/// copies them, so memory use does not grow with the size of the inputs.
+class DWPFileOutput : public DWPOutput {
+  std::string Path;
+  uint16_t Machine;
+  unsigned NumThreads;
+  /// The pieces of each section, in the order the sections were added.
+  MapVector<MCSection *, std::vector<StringRef>> Sections;
+  BumpPtrAllocator Alloc;
+
+public:
+  DWPFileOutput(StringRef Path, uint16_t Machine, unsigned NumThreads)
+      : Path(Path), Machine(Machine), NumThreads(NumThreads) {}
+
+  void addSection(MCSection *Sec) override { Sections[Sec]; }
+  void emitBytes(MCSection *Sec, StringRef Data) override;
+  void emitInputBytes(MCSection *Sec, StringRef Data) override {
+    if (!Data.empty())
+      Sections[Sec].push_back(Data);
+    else
+      addSection(Sec);
+  }
+  Error finish() override;
+};
+}
+
+#endif
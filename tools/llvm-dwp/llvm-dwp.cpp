@@ -12,9 +12,10 @@
 //
 //===----------------------------------------------------------------------===//
 #include "DWPError.h"
-#include "DWPStringPool.h"
+#include "DWPOutput.h"
 #include "llvm/ADT/MapVector.h"
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/BinaryFormat/ELF.h"
 #include "llvm/DebugInfo/DWARF/DWARFContext.h"
 #include "llvm/DebugInfo/DWARF/DWARFFormValue.h"
 #include "llvm/DebugInfo/DWARF/DWARFUnitIndex.h"
@@ -30,7 +31,9 @@
 #include "llvm/MC/MCTargetOptionsCommandFlags.inc"
 #include "llvm/Object/Decompressor.h"
 #include "llvm/Object/ObjectFile.h"
+#include "llvm/Support/ConcurrentStringPool.h"
 #include "llvm/Support/DataExtractor.h"
+#include "llvm/Support/EndianStream.h"
 #include "llvm/Support/Error.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/InitLLVM.h"
@@ -39,6 +42,7 @@
 #include "llvm/Support/Path.h"
 #include "llvm/Support/TargetRegistry.h"
 #include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/ThreadPool.h"
 #include "llvm/Support/raw_ostream.h"
 
 using namespace llvm;
@@ -59,36 +63,83 @@ static cl::opt<std::string> OutputFilename(cl::Required, "o",
                                            cl::value_desc("filename"),
                                            cl::cat(DwpCategory));
 
-static void writeStringsAndOffsets(MCStreamer &Out, DWPStringPool &Strings,
+static cl::opt<unsigned> NumThreads(
+    "num-threads", cl::init(1),
+    cl::desc("Number of threads used to merge the string tables and to copy "
+             "the contributions. The output does not depend on it."),
+    cl::value_desc("n"), cl::cat(DwpCategory));
+static cl::alias NumThreadsA("j", cl::desc("Alias for --num-threads"),
+                             cl::aliasopt(NumThreads));
+
+static cl::opt<bool> Streaming(
+    "streaming",
+    cl::desc("Write the contributions straight to the output file instead of "
+             "buffering the whole package in memory."),
+    cl::cat(DwpCategory));
+
+namespace {
+/// The string sections of one input.
+struct StringContribution {
+  StringRef Str;
+  StringRef StrOffsets;
+};
+} // end anonymous namespace
+
+/// Merge the string tables of all inputs and emit the merged table, followed
+/// by the string offsets of each input rewritten against it.
+///
+/// Each string is added with the key (input, offset in the input), so the
+/// merged table lists the strings in the order of their first occurrence no
+/// matter how the inputs were spread over the threads.
+static void writeStringsAndOffsets(DWPOutput &Out, MCSection *StrSection,
                                    MCSection *StrOffsetSection,
-                                   StringRef CurStrSection,
-                                   StringRef CurStrOffsetSection) {
-  // Could possibly produce an error or warning if one of these was non-null but
-  // the other was null.
-  if (CurStrSection.empty() || CurStrOffsetSection.empty())
+                                   ArrayRef<StringContribution> Contributions) {
+  if (Contributions.empty())
     return;
 
-  DenseMap<uint32_t, uint32_t> OffsetRemapping;
-
-  DataExtractor Data(CurStrSection, true, 0);
-  uint32_t LocalOffset = 0;
-  uint32_t PrevOffset = 0;
-  while (const char *s = Data.getCStr(&LocalOffset)) {
-    OffsetRemapping[PrevOffset] =
-        Strings.getOffset(s, LocalOffset - PrevOffset);
-    PrevOffset = LocalOffset;
+  ConcurrentStringPool Strings;
+  std::vector<DenseMap<uint32_t, const ConcurrentStringPool::Entry *>>
+      OffsetRemappings(Contributions.size());
+
+  auto AddStrings = [&](size_t I) {
+    DataExtractor Data(Contributions[I].Str, true, 0);
+    uint32_t LocalOffset = 0;
+    uint32_t PrevOffset = 0;
+    while (const char *s = Data.getCStr(&LocalOffset)) {
+      OffsetRemappings[I][PrevOffset] = &Strings.add(
+          StringRef(s, LocalOffset - PrevOffset - 1),
+          (uint64_t(I) << 32) | PrevOffset);
+      PrevOffset = LocalOffset;
+    }
+  };
+  if (NumThreads > 1 && Contributions.size() > 1) {
+    ThreadPool Pool(NumThreads);
+    for (size_t I = 0, E = Contributions.size(); I != E; ++I)
+      Pool.async(AddStrings, I);
+  } else {
+    for (size_t I = 0, E = Contributions.size(); I != E; ++I)
+      AddStrings(I);
   }
-
-  Data = DataExtractor(CurStrOffsetSection, true, 0);
-
-  Out.SwitchSection(StrOffsetSection);
-
-  uint32_t Offset = 0;
-  uint64_t Size = CurStrOffsetSection.size();
-  while (Offset < Size) {
-    auto OldOffset = Data.getU32(&Offset);
-    auto NewOffset = OffsetRemapping[OldOffset];
-    Out.EmitIntValue(NewOffset, 4);
+  std::string Table;
+  Table.reserve(Strings.finalize());
+  for (const ConcurrentStringPool::Entry *E : Strings.getEntriesInOrder())
+    Table.append(E->getKeyData(), E->getKeyLength() + 1);
+  Out.emitBytes(StrSection, Table);
+
+  SmallString<0> Buffer;
+  for (size_t I = 0, E = Contributions.size(); I != E; ++I) {
+    Buffer.clear();
+    raw_svector_ostream OS(Buffer);
+    support::endian::Writer W(OS, support::little);
+    DataExtractor Data(Contributions[I].StrOffsets, true, 0);
+    uint32_t Offset = 0;
+    uint64_t Size = Contributions[I].StrOffsets.size();
+    while (Offset < Size) {
+      auto OldOffset = Data.getU32(&Offset);
+      auto NewOffset = OffsetRemappings[I].lookup(OldOffset);
+      W.write<uint32_t>(NewOffset ? NewOffset->getValue().Offset : 0);
+    }
+    Out.emitBytes(StrOffsetSection, Buffer);
   }
 }
 
@@ -208,10 +259,10 @@ static StringRef getSubsection(StringRef Section,
 }
 
 static void addAllTypesFromDWP(
-    MCStreamer &Out, MapVector<uint64_t, UnitIndexEntry> &TypeIndexEntries,
+    DWPOutput &Out, MapVector<uint64_t, UnitIndexEntry> &TypeIndexEntries,
     const DWARFUnitIndex &TUIndex, MCSection *OutputTypes, StringRef Types,
     const UnitIndexEntry &TUEntry, uint32_t &TypesOffset) {
-  Out.SwitchSection(OutputTypes);
+  Out.addSection(OutputTypes);
   for (const DWARFUnitIndex::Entry &E : TUIndex.getRows()) {
     auto *I = E.getOffsets();
     if (!I)
@@ -229,21 +280,24 @@ static void addAllTypesFromDWP(
       ++I;
     }
     auto &C = Entry.Contributions[DW_SECT_TYPES - DW_SECT_INFO];
-    Out.EmitBytes(Types.substr(
-        C.Offset - TUEntry.Contributions[DW_SECT_TYPES - DW_SECT_INFO].Offset,
-        C.Length));
+    Out.emitInputBytes(
+        OutputTypes,
+        Types.substr(C.Offset -
+                         TUEntry.Contributions[DW_SECT_TYPES - DW_SECT_INFO]
+                             .Offset,
+                     C.Length));
     C.Offset = TypesOffset;
     TypesOffset += C.Length;
   }
 }
 
-static void addAllTypes(MCStreamer &Out,
+static void addAllTypes(DWPOutput &Out,
                         MapVector<uint64_t, UnitIndexEntry> &TypeIndexEntries,
                         MCSection *OutputTypes,
                         const std::vector<StringRef> &TypesSections,
                         const UnitIndexEntry &CUEntry, uint32_t &TypesOffset) {
   for (StringRef Types : TypesSections) {
-    Out.SwitchSection(OutputTypes);
+    Out.addSection(OutputTypes);
     uint32_t Offset = 0;
     DataExtractor Data(Types, true, 0);
     while (Data.isValidOffset(Offset)) {
@@ -266,24 +320,25 @@ static void addAllTypes(MCStreamer &Out,
       if (!P.second)
         continue;
 
-      Out.EmitBytes(Types.substr(PrevOffset, C.Length));
+      Out.emitInputBytes(OutputTypes, Types.substr(PrevOffset, C.Length));
       TypesOffset += C.Length;
     }
   }
 }
 
 static void
-writeIndexTable(MCStreamer &Out, ArrayRef<unsigned> ContributionOffsets,
+writeIndexTable(support::endian::Writer &W,
+                ArrayRef<unsigned> ContributionOffsets,
                 const MapVector<uint64_t, UnitIndexEntry> &IndexEntries,
                 uint32_t DWARFUnitIndex::Entry::SectionContribution::*Field) {
   for (const auto &E : IndexEntries)
     for (size_t i = 0; i != array_lengthof(E.second.Contributions); ++i)
       if (ContributionOffsets[i])
-        Out.EmitIntValue(E.second.Contributions[i].*Field, 4);
+        W.write<uint32_t>(E.second.Contributions[i].*Field);
 }
 
 static void
-writeIndex(MCStreamer &Out, MCSection *Section,
+writeIndex(DWPOutput &Out, MCSection *Section,
            ArrayRef<unsigned> ContributionOffsets,
            const MapVector<uint64_t, UnitIndexEntry> &IndexEntries) {
   if (IndexEntries.empty())
@@ -310,32 +365,36 @@ writeIndex(MCStreamer &Out, MCSection *Section,
     ++i;
   }
 
-  Out.SwitchSection(Section);
-  Out.EmitIntValue(2, 4);                   // Version
-  Out.EmitIntValue(Columns, 4);             // Columns
-  Out.EmitIntValue(IndexEntries.size(), 4); // Num Units
-  Out.EmitIntValue(Buckets.size(), 4);      // Num Buckets
+  SmallString<0> Buffer;
+  raw_svector_ostream OS(Buffer);
+  support::endian::Writer W(OS, support::little);
+  W.write<uint32_t>(2);                   // Version
+  W.write<uint32_t>(Columns);             // Columns
+  W.write<uint32_t>(IndexEntries.size()); // Num Units
+  W.write<uint32_t>(Buckets.size());      // Num Buckets
 
   // Write the signatures.
   for (const auto &I : Buckets)
-    Out.EmitIntValue(I ? IndexEntries.begin()[I - 1].first : 0, 8);
+    W.write<uint64_t>(I ? IndexEntries.begin()[I - 1].first : 0);
 
   // Write the indexes.
   for (const auto &I : Buckets)
-    Out.EmitIntValue(I, 4);
+    W.write<uint32_t>(I);
 
   // Write the column headers (which sections will appear in the table)
   for (size_t i = 0; i != ContributionOffsets.size(); ++i)
     if (ContributionOffsets[i])
-      Out.EmitIntValue(i + DW_SECT_INFO, 4);
+      W.write<uint32_t>(i + DW_SECT_INFO);
 
   // Write the offsets.
-  writeIndexTable(Out, ContributionOffsets, IndexEntries,
+  writeIndexTable(W, ContributionOffsets, IndexEntries,
                   &DWARFUnitIndex::Entry::SectionContribution::Offset);
 
   // Write the lengths.
-  writeIndexTable(Out, ContributionOffsets, IndexEntries,
+  writeIndexTable(W, ContributionOffsets, IndexEntries,
                   &DWARFUnitIndex::Entry::SectionContribution::Length);
+
+  Out.emitBytes(Section, Buffer);
 }
 
 std::string buildDWODescription(StringRef Name, StringRef DWPName, StringRef DWOName) {
@@ -387,7 +446,7 @@ static Error handleSection(
     const StringMap<std::pair<MCSection *, DWARFSectionKind>> &KnownSections,
     const MCSection *StrSection, const MCSection *StrOffsetSection,
     const MCSection *TypesSection, const MCSection *CUIndexSection,
-    const MCSection *TUIndexSection, const SectionRef &Section, MCStreamer &Out,
+    const MCSection *TUIndexSection, const SectionRef &Section, DWPOutput &Out,
     std::deque<SmallString<32>> &UncompressedSections,
     uint32_t (&ContributionOffsets)[8], UnitIndexEntry &CurEntry,
     StringRef &CurStrSection, StringRef &CurStrOffsetSection,
@@ -449,8 +508,7 @@ static Error handleSection(
   else if (OutSection == TUIndexSection)
     CurTUIndexSection = Contents;
   else {
-    Out.SwitchSection(OutSection);
-    Out.EmitBytes(Contents);
+    Out.emitInputBytes(OutSection, Contents);
   }
   return Error::success();
 }
@@ -494,8 +552,10 @@ getDWOFilenames(StringRef ExecFilename) {
   return std::move(DWOPaths);
 }
 
-static Error write(MCStreamer &Out, ArrayRef<std::string> Inputs) {
-  const auto &MCOFI = *Out.getContext().getObjectFileInfo();
+/// Write the package of \p Inputs to \p Out. The contributions are emitted
+/// straight from the inputs, which stay open until the output is finished.
+static Error write(DWPOutput &Out, const MCObjectFileInfo &MCOFI,
+                   ArrayRef<std::string> Inputs) {
   MCSection *const StrSection = MCOFI.getDwarfStrDWOSection();
   MCSection *const StrOffsetSection = MCOFI.getDwarfStrOffDWOSection();
   MCSection *const TypesSection = MCOFI.getDwarfTypesDWOSection();
@@ -517,7 +577,7 @@ static Error write(MCStreamer &Out, ArrayRef<std::string> Inputs) {
 
   uint32_t ContributionOffsets[8] = {};
 
-  DWPStringPool Strings(Out, StrSection);
+  std::vector<StringContribution> StringContributions;
 
   SmallVector<OwningBinary<object::ObjectFile>, 128> Objects;
   Objects.reserve(Inputs.size());
@@ -554,8 +614,17 @@ static Error write(MCStreamer &Out, ArrayRef<std::string> Inputs) {
     if (InfoSection.empty())
       continue;
 
-    writeStringsAndOffsets(Out, Strings, StrOffsetSection, CurStrSection,
-                           CurStrOffsetSection);
+    // Could possibly produce an error or warning if one of these was non-null
+    // but the other was null.
+    if (!CurStrSection.empty() && !CurStrOffsetSection.empty()) {
+      // The strings are merged once all inputs are read. Create their
+      // sections now to keep the section order of the output.
+      if (StringContributions.empty()) {
+        Out.addSection(StrSection);
+        Out.addSection(StrOffsetSection);
+      }
+      StringContributions.push_back({CurStrSection, CurStrOffsetSection});
+    }
 
     if (CurCUIndexSection.empty()) {
       Expected<CompileUnitIdentifiers> EID = getCUIdentifiers(
@@ -618,6 +687,9 @@ static Error write(MCStreamer &Out, ArrayRef<std::string> Inputs) {
     }
   }
 
+  writeStringsAndOffsets(Out, StrSection, StrOffsetSection,
+                         StringContributions);
+
   // Lie about there being no info contributions so the TU index only includes
   // the type unit contribution
   ContributionOffsets[0] = 0;
@@ -632,7 +704,7 @@ static Error write(MCStreamer &Out, ArrayRef<std::string> Inputs) {
   writeIndex(Out, MCOFI.getDwarfCUIndexSection(), ContributionOffsets,
              IndexEntries);
 
-  return Error::success();
+  return Out.finish();
 }
 
 static int error(const Twine &Error, const Twine &Context) {
@@ -676,6 +748,27 @@ int main(int argc, char **argv) {
   MCContext MC(MAI.get(), MRI.get(), &MOFI);
   MOFI.InitMCObjectFileInfo(TheTriple, /*PIC*/ false, MC);
 
+  std::vector<std::string> DWOFilenames = InputFiles;
+  for (const auto &ExecFilename : ExecFilenames) {
+    auto DWOs = getDWOFilenames(ExecFilename);
+    if (!DWOs) {
+      logAllUnhandledErrors(DWOs.takeError(), errs(), "error: ");
+      return 1;
+    }
+    DWOFilenames.insert(DWOFilenames.end(),
+                        std::make_move_iterator(DWOs->begin()),
+                        std::make_move_iterator(DWOs->end()));
+  }
+
+  if (Streaming) {
+    DWPFileOutput Output(OutputFilename, ELF::EM_X86_64, NumThreads);
+    if (auto Err = write(Output, MOFI, DWOFilenames)) {
+      logAllUnhandledErrors(std::move(Err), errs(), "error: ");
+      return 1;
+    }
+    return 0;
+  }
+
   std::unique_ptr<MCSubtargetInfo> MSTI(
       TheTarget->createMCSubtargetInfo(TripleName, "", ""));
   if (!MSTI)
@@ -717,22 +810,9 @@ int main(int argc, char **argv) {
   if (!MS)
     return error("no object streamer for target " + TripleName, Context);
 
-  std::vector<std::string> DWOFilenames = InputFiles;
-  for (const auto &ExecFilename : ExecFilenames) {
-    auto DWOs = getDWOFilenames(ExecFilename);
-    if (!DWOs) {
-      logAllUnhandledErrors(DWOs.takeError(), errs(), "error: ");
-      return 1;
-    }
-    DWOFilenames.insert(DWOFilenames.end(),
-                        std::make_move_iterator(DWOs->begin()),
-                        std::make_move_iterator(DWOs->end()));
-  }
-
-  if (auto Err = write(*MS, DWOFilenames)) {
+  DWPStreamerOutput Output(*MS);
+  if (auto Err = write(Output, MOFI, DWOFilenames)) {
     logAllUnhandledErrors(std::move(Err), errs(), "error: ");
     return 1;
   }
-
-  MS->Finish();
 }
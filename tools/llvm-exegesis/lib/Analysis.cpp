@@ -12,6 +12,7 @@
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/MC/MCAsmInfo.h"
 #include "llvm/Support/FormatVariadic.h"
+#include <cmath>
 #include <limits>
 #include <unordered_set>
 #include <vector>
@@ -651,23 +652,8 @@ llvm::Error Analysis::run<Analysis::PrintSchedClassInconsistencies>(
   for (const auto &RSCAndPoints : makePointsPerSchedClass()) {
     if (!RSCAndPoints.RSC.SCDesc)
       continue;
-    // Bucket sched class points into sched class clusters.
-    std::vector<SchedClassCluster> SchedClassClusters;
-    for (const size_t PointId : RSCAndPoints.PointIds) {
-      const auto &ClusterId = Clustering_.getClusterIdForPoint(PointId);
-      if (!ClusterId.isValid())
-        continue; // Ignore noise and errors. FIXME: take noise into account ?
-      auto SchedClassClusterIt =
-          std::find_if(SchedClassClusters.begin(), SchedClassClusters.end(),
-                       [ClusterId](const SchedClassCluster &C) {
-                         return C.id() == ClusterId;
-                       });
-      if (SchedClassClusterIt == SchedClassClusters.end()) {
-        SchedClassClusters.emplace_back();
-        SchedClassClusterIt = std::prev(SchedClassClusters.end());
-      }
-      SchedClassClusterIt->addPoint(PointId, Clustering_);
-    }
+    const std::vector<SchedClassCluster> SchedClassClusters =
+        makeSchedClassClusters(RSCAndPoints);
 
     // Print any scheduling class that has at least one cluster that does not
     // match the checked-in data.
@@ -697,6 +683,140 @@ llvm::Error Analysis::run<Analysis::PrintSchedClassInconsistencies>(
   return llvm::Error::success();
 }
 
+std::vector<Analysis::SchedClassCluster> Analysis::makeSchedClassClusters(
+    const ResolvedSchedClassAndPoints &RSCAndPoints) const {
+  std::vector<SchedClassCluster> SchedClassClusters;
+  for (const size_t PointId : RSCAndPoints.PointIds) {
+    const auto &ClusterId = Clustering_.getClusterIdForPoint(PointId);
+    if (!ClusterId.isValid())
+      continue; // Ignore noise and errors. FIXME: take noise into account ?
+    auto SchedClassClusterIt =
+        std::find_if(SchedClassClusters.begin(), SchedClassClusters.end(),
+                     [ClusterId](const SchedClassCluster &C) {
+                       return C.id() == ClusterId;
+                     });
+    if (SchedClassClusterIt == SchedClassClusters.end()) {
+      SchedClassClusters.emplace_back();
+      SchedClassClusterIt = std::prev(SchedClassClusters.end());
+    }
+    SchedClassClusterIt->addPoint(PointId, Clustering_);
+  }
+  return SchedClassClusters;
+}
+
+// Prints a SchedWriteRes with the measured characteristics of `Cluster`, and
+// an InstRW that maps the opcodes of the cluster to it. Characteristics that
+// were not measured are taken from the model.
+void Analysis::printSchedModelPatch(const SchedClassCluster &Cluster,
+                                    const ResolvedSchedClass &RSC,
+                                    unsigned WriteId,
+                                    llvm::raw_ostream &OS) const {
+  const auto &SM = SubtargetInfo_->getSchedModel();
+  const auto &Points = Clustering_.getPoints();
+  const InstructionBenchmark::ModeE Mode = Points[0].Mode;
+
+  unsigned Latency = 0;
+  for (unsigned I = 0; I < RSC.SCDesc->NumWriteLatencyEntries; ++I)
+    Latency = std::max<unsigned>(
+        Latency, SubtargetInfo_->getWriteLatencyEntry(RSC.SCDesc, I)->Cycles);
+  unsigned NumMicroOps = RSC.SCDesc->NumMicroOps;
+  // (ProcResIdx, Cycles), sorted by ProcResIdx.
+  std::vector<std::pair<unsigned, unsigned>> Resources;
+  for (const llvm::MCWriteProcResEntry &WPR : RSC.NonRedundantWriteProcRes)
+    Resources.emplace_back(WPR.ProcResourceIdx, WPR.Cycles);
+  llvm::sort(Resources);
+
+  const auto roundMeasurement = [](double Value) {
+    return static_cast<unsigned>(std::lround(std::max(Value, 0.0)));
+  };
+  for (const PerInstructionStats &Stats : Cluster.getRepresentative()) {
+    if (Mode == InstructionBenchmark::Latency) {
+      Latency = roundMeasurement(Stats.avg());
+    } else if (Stats.key() == "NumMicroOps") {
+      NumMicroOps = roundMeasurement(Stats.avg());
+    } else if (const unsigned ProcResIdx =
+                   findProcResIdx(*SubtargetInfo_, Stats.key())) {
+      // A measured resource replaces the model's entry for it.
+      auto It = std::lower_bound(Resources.begin(), Resources.end(),
+                                 std::make_pair(ProcResIdx, 0u));
+      if (It == Resources.end() || It->first != ProcResIdx)
+        It = Resources.emplace(It, ProcResIdx, 0u);
+      It->second = roundMeasurement(Stats.avg());
+    }
+  }
+  Resources.erase(std::remove_if(Resources.begin(), Resources.end(),
+                                 [](const std::pair<unsigned, unsigned> &R) {
+                                   return R.second == 0;
+                                 }),
+                  Resources.end());
+
+  std::vector<llvm::StringRef> Opcodes;
+  for (const size_t PointId : Cluster.getPointIds())
+    Opcodes.push_back(
+        InstrInfo_->getName(Points[PointId].Key.Instructions[0].getOpcode()));
+  llvm::sort(Opcodes);
+  Opcodes.erase(std::unique(Opcodes.begin(), Opcodes.end()), Opcodes.end());
+
+  OS << "def ExegesisWrite" << WriteId << " : SchedWriteRes<[";
+  for (size_t I = 0, E = Resources.size(); I < E; ++I)
+    OS << (I ? ", " : "") << SM.getProcResource(Resources[I].first)->Name;
+  OS << "]> {\n";
+  OS << "  let Latency = " << Latency << ";\n";
+  OS << "  let NumMicroOps = " << NumMicroOps << ";\n";
+  if (llvm::any_of(Resources, [](const std::pair<unsigned, unsigned> &R) {
+        return R.second != 1;
+      })) {
+    OS << "  let ResourceCycles = [";
+    for (size_t I = 0, E = Resources.size(); I < E; ++I)
+      OS << (I ? ", " : "") << Resources[I].second;
+    OS << "];\n";
+  }
+  OS << "}\n";
+  OS << "def : InstRW<[ExegesisWrite" << WriteId << "], (instrs ";
+  for (size_t I = 0, E = Opcodes.size(); I < E; ++I)
+    OS << (I ? ", " : "") << Opcodes[I];
+  OS << ")>;\n";
+}
+
+template <>
+llvm::Error Analysis::run<Analysis::PrintSchedModelPatches>(
+    llvm::raw_ostream &OS) const {
+  const auto &FirstPoint = Clustering_.getPoints()[0];
+  OS << "// Scheduling model changes measured by llvm-exegesis for cpu "
+     << FirstPoint.CpuName << " (" << FirstPoint.LLVMTriple << ").\n";
+  OS << "// Add them to the SchedModel of the cpu.\n";
+  unsigned NumWrites = 0;
+  for (const auto &RSCAndPoints : makePointsPerSchedClass()) {
+    const ResolvedSchedClass &RSC = RSCAndPoints.RSC;
+    if (!RSC.SCDesc || !RSC.SCDesc->isValid())
+      continue;
+    for (const SchedClassCluster &Cluster :
+         makeSchedClassClusters(RSCAndPoints)) {
+      if (Cluster.measurementsMatch(*SubtargetInfo_, RSC, Clustering_))
+        continue;
+      OS << "\n// Sched class ";
+#if !defined(NDEBUG) || defined(LLVM_ENABLE_DUMP)
+      OS << RSC.SCDesc->Name;
+#else
+      OS << RSC.SchedClassId;
+#endif
+      OS << ", measured";
+      for (const PerInstructionStats &Stats : Cluster.getRepresentative())
+        OS << " " << Stats.key() << "="
+           << llvm::formatv("{0:F2}", Stats.avg());
+      OS << ".\n";
+      // Overriding a variant class with InstRW would drop its predicates.
+      if (RSC.WasVariant) {
+        OS << "// This class is variant, update the matching variant by "
+              "hand.\n";
+        continue;
+      }
+      printSchedModelPatch(Cluster, RSC, NumWrites++, OS);
+    }
+  }
+  return llvm::Error::success();
+}
+
 // Distributes a pressure budget as evenly as possible on the provided subunits
 // given the already existing port pressure distribution.
 //
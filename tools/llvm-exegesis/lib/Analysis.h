@@ -43,6 +43,9 @@ public:
   struct PrintClusters {};
   // Find potential errors in the scheduling information given measurements.
   struct PrintSchedClassInconsistencies {};
+  // Print TableGen definitions that make the scheduling model match the
+  // measurements of inconsistent sched classes.
+  struct PrintSchedModelPatches {};
 
   template <typename Pass> llvm::Error run(llvm::raw_ostream &OS) const;
 
@@ -113,6 +116,14 @@ private:
   // Builds a list of ResolvedSchedClassAndPoints.
   std::vector<ResolvedSchedClassAndPoints> makePointsPerSchedClass() const;
 
+  // Buckets the valid points of a sched class by cluster.
+  std::vector<SchedClassCluster>
+  makeSchedClassClusters(const ResolvedSchedClassAndPoints &RSCAndPoints) const;
+
+  void printSchedModelPatch(const SchedClassCluster &Cluster,
+                            const ResolvedSchedClass &RSC, unsigned WriteId,
+                            llvm::raw_ostream &OS) const;
+
   template <typename EscapeTag, EscapeTag Tag>
   void writeSnippet(llvm::raw_ostream &OS, llvm::ArrayRef<uint8_t> Bytes,
                     const char *Separator) const;
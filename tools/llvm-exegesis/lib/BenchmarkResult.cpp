@@ -69,10 +69,15 @@ struct YamlContext {
   }
 
   unsigned getRegNo(llvm::StringRef RegName) {
-    const llvm::MCRegisterInfo &RegInfo = State->getRegInfo();
-    for (unsigned E = RegInfo.getNumRegs(), I = 0; I < E; ++I)
-      if (RegInfo.getName(I) == RegName)
-        return I;
+    // Files hold many instructions, build the reverse map once.
+    if (RegNameToRegNo.empty()) {
+      const llvm::MCRegisterInfo &RegInfo = State->getRegInfo();
+      for (unsigned E = RegInfo.getNumRegs(), I = 0; I < E; ++I)
+        RegNameToRegNo.try_emplace(RegInfo.getName(I), I);
+    }
+    const auto It = RegNameToRegNo.find(RegName);
+    if (It != RegNameToRegNo.end())
+      return It->second;
     ErrorStream << "No register with name " << RegName;
     return 0;
   }
@@ -137,15 +142,21 @@ private:
   }
 
   unsigned getInstrOpcode(llvm::StringRef InstrName) {
-    const llvm::MCInstrInfo &InstrInfo = State->getInstrInfo();
-    for (unsigned E = InstrInfo.getNumOpcodes(), I = 0; I < E; ++I)
-      if (InstrInfo.getName(I) == InstrName)
-        return I;
+    if (OpcodeNameToOpcode.empty()) {
+      const llvm::MCInstrInfo &InstrInfo = State->getInstrInfo();
+      for (unsigned E = InstrInfo.getNumOpcodes(), I = 0; I < E; ++I)
+        OpcodeNameToOpcode.try_emplace(InstrInfo.getName(I), I);
+    }
+    const auto It = OpcodeNameToOpcode.find(InstrName);
+    if (It != OpcodeNameToOpcode.end())
+      return It->second;
     ErrorStream << "No opcode with name " << InstrName;
     return 0;
   }
 
   const llvm::exegesis::LLVMState *State;
+  llvm::StringMap<unsigned> RegNameToRegNo;
+  llvm::StringMap<unsigned> OpcodeNameToOpcode;
   std::string LastError;
   llvm::raw_string_ostream ErrorStream;
 };
@@ -322,21 +333,35 @@ InstructionBenchmark::readYaml(const LLVMState &State,
 llvm::Expected<std::vector<InstructionBenchmark>>
 InstructionBenchmark::readYamls(const LLVMState &State,
                                 llvm::StringRef Filename) {
+  std::vector<InstructionBenchmark> Benchmarks;
+  if (llvm::Error E =
+          readYamls(State, Filename, [&Benchmarks](InstructionBenchmark &&B) {
+            Benchmarks.push_back(std::move(B));
+            return llvm::Error::success();
+          }))
+    return std::move(E);
+  return Benchmarks;
+}
+
+llvm::Error InstructionBenchmark::readYamls(
+    const LLVMState &State, llvm::StringRef Filename,
+    llvm::function_ref<llvm::Error(InstructionBenchmark &&)> Callback) {
   if (auto ExpectedMemoryBuffer =
           llvm::errorOrToExpected(llvm::MemoryBuffer::getFile(Filename))) {
     llvm::yaml::Input Yin(*ExpectedMemoryBuffer.get());
     YamlContext Context(State);
-    std::vector<InstructionBenchmark> Benchmarks;
     while (Yin.setCurrentDocument()) {
-      Benchmarks.emplace_back();
-      yamlize(Yin, Benchmarks.back(), /*unused*/ true, Context);
+      InstructionBenchmark Benchmark;
+      yamlize(Yin, Benchmark, /*unused*/ true, Context);
       if (Yin.error())
         return llvm::errorCodeToError(Yin.error());
       if (!Context.getLastError().empty())
         return llvm::make_error<BenchmarkFailure>(Context.getLastError());
+      if (llvm::Error E = Callback(std::move(Benchmark)))
+        return E;
       Yin.nextDocument();
     }
-    return Benchmarks;
+    return llvm::Error::success();
   } else {
     return ExpectedMemoryBuffer.takeError();
   }
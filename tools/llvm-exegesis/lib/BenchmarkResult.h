@@ -18,6 +18,7 @@
 
 #include "BenchmarkCode.h"
 #include "LlvmState.h"
+#include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/StringMap.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/MC/MCInst.h"
@@ -78,6 +79,13 @@ struct InstructionBenchmark {
   static llvm::Expected<std::vector<InstructionBenchmark>>
   readYamls(const LLVMState &State, llvm::StringRef Filename);
 
+  // Reads the benchmarks of `Filename` one document at a time and passes each
+  // of them to `Callback`, so that large result files need not be held in
+  // memory twice. Stops at the first error returned by `Callback`.
+  static llvm::Error
+  readYamls(const LLVMState &State, llvm::StringRef Filename,
+            llvm::function_ref<llvm::Error(InstructionBenchmark &&)> Callback);
+
   void readYamlFrom(const LLVMState &State, llvm::StringRef InputContent);
 
   // Write functions, non-const because of YAML traits.
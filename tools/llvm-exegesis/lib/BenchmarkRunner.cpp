@@ -8,6 +8,7 @@
 //===----------------------------------------------------------------------===//
 
 #include <array>
+#include <mutex>
 #include <string>
 
 #include "Assembler.h"
@@ -47,6 +48,32 @@ GenerateInstructions(const BenchmarkCode &BC, const size_t MinInstructions) {
 }
 
 namespace {
+// CrashRecoveryContext::Enable() and Disable() install and remove process-wide
+// signal handlers, so they must stay installed while any thread runs a snippet.
+class ScopedCrashRecovery {
+public:
+  ScopedCrashRecovery() {
+    std::lock_guard<std::mutex> Lock(getMutex());
+    if (getUsers()++ == 0)
+      llvm::CrashRecoveryContext::Enable();
+  }
+  ~ScopedCrashRecovery() {
+    std::lock_guard<std::mutex> Lock(getMutex());
+    if (--getUsers() == 0)
+      llvm::CrashRecoveryContext::Disable();
+  }
+
+private:
+  static std::mutex &getMutex() {
+    static std::mutex M;
+    return M;
+  }
+  static unsigned &getUsers() {
+    static unsigned Users = 0;
+    return Users;
+  }
+};
+
 class FunctionExecutorImpl : public BenchmarkRunner::FunctionExecutor {
 public:
   FunctionExecutorImpl(const LLVMState &State,
@@ -73,13 +100,12 @@ private:
       Scratch->clear();
       {
         llvm::CrashRecoveryContext CRC;
-        llvm::CrashRecoveryContext::Enable();
+        const ScopedCrashRecovery Recovery;
         const bool Crashed = !CRC.RunSafely([this, &Counter, ScratchPtr]() {
           Counter.start();
           this->Function(ScratchPtr);
           Counter.stop();
         });
-        llvm::CrashRecoveryContext::Disable();
         // FIXME: Better diagnosis.
         if (Crashed)
           return llvm::make_error<BenchmarkFailure>(
@@ -136,8 +162,13 @@ BenchmarkRunner::runConfiguration(const BenchmarkCode &BC,
     InstrBenchmark.Error = llvm::toString(std::move(E));
     return InstrBenchmark;
   }
-  llvm::outs() << "Check generated assembly with: /usr/bin/objdump -d "
-               << *ObjectFilePath << "\n";
+  {
+    // Runners on several threads share the output stream.
+    static std::mutex OutputMutex;
+    std::lock_guard<std::mutex> Lock(OutputMutex);
+    llvm::outs() << "Check generated assembly with: /usr/bin/objdump -d "
+                 << *ObjectFilePath << "\n";
+  }
   const FunctionExecutorImpl Executor(State, getObjectFromFile(*ObjectFilePath),
                                       Scratch.get());
   auto Measurements = runMeasurements(Executor);
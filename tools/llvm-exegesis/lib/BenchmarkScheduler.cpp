@@ -0,0 +1,214 @@
+//===-- BenchmarkScheduler.cpp ----------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "BenchmarkScheduler.h"
+#include "BenchmarkRunner.h"
+#include "Target.h"
+#include "llvm/ADT/Optional.h"
+#include "llvm/ADT/Twine.h"
+#include "llvm/Config/llvm-config.h"
+#include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/raw_ostream.h"
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+namespace llvm {
+namespace exegesis {
+
+bool isNoisy(const InstructionBenchmark &A, const InstructionBenchmark &B,
+             double Threshold) {
+  if (A.Measurements.size() != B.Measurements.size())
+    return true;
+  for (size_t I = 0, E = A.Measurements.size(); I < E; ++I) {
+    const double X = A.Measurements[I].PerInstructionValue;
+    const double Y = B.Measurements[I].PerInstructionValue;
+    const double Max = std::max(std::fabs(X), std::fabs(Y));
+    if (Max > 0.0 && std::fabs(X - Y) > Threshold * Max)
+      return true;
+  }
+  return false;
+}
+
+// Binds the calling thread to core `CPU`. Returns false on failure.
+static bool pinToCPU(unsigned CPU) {
+#ifdef __linux__
+  cpu_set_t Set;
+  CPU_ZERO(&Set);
+  CPU_SET(CPU, &Set);
+  return sched_setaffinity(0, sizeof(Set), &Set) == 0;
+#else
+  return false;
+#endif
+}
+
+namespace {
+
+class Scheduler {
+public:
+  Scheduler(const LLVMState &State, InstructionBenchmark::ModeE Mode,
+            llvm::ArrayRef<BenchmarkCode> Configurations,
+            const BenchmarkSchedulerOptions &Options,
+            llvm::function_ref<void(InstructionBenchmark &)> OnResult)
+      : State(State), Mode(Mode), Configurations(Configurations),
+        Options(Options), OnResult(OnResult),
+        Results(Configurations.size()), Remaining(Configurations.size()),
+        ActiveWorkers(Options.CPUs.size()) {
+    for (size_t I = 0, E = Configurations.size(); I < E; ++I)
+      Queue.push_back({I, 0});
+  }
+
+  void run() {
+#if LLVM_ENABLE_THREADS
+    std::vector<std::thread> Workers;
+    for (const unsigned CPU : Options.CPUs)
+      Workers.emplace_back([this, CPU]() { runWorker(CPU); });
+    for (std::thread &Worker : Workers)
+      Worker.join();
+#else
+    // Without threads, all the work happens on the first core.
+    ActiveWorkers = 1;
+    runWorker(Options.CPUs.front());
+#endif
+  }
+
+private:
+  // A configuration to measure, and how many noisy results it already had.
+  struct WorkItem {
+    size_t Index;
+    unsigned NoisyAttempts;
+  };
+
+  // A core is considered noisy once most of its results are noisy, over a
+  // minimum number of samples.
+  static constexpr unsigned kMinSamplesForNoisyCore = 8;
+
+  void runWorker(unsigned CPU) {
+    if (!pinToCPU(CPU))
+      llvm::report_fatal_error(
+          llvm::Twine("cannot pin benchmark thread to cpu ").concat(
+              llvm::Twine(CPU)));
+    const std::unique_ptr<BenchmarkRunner> Runner =
+        State.getExegesisTarget().createBenchmarkRunner(Mode, State);
+    if (!Runner)
+      llvm::report_fatal_error("cannot create benchmark runner");
+
+    unsigned NumSamples = 0;
+    unsigned NumNoisy = 0;
+    WorkItem Item;
+    while (getWork(Item)) {
+      const BenchmarkCode &BC = Configurations[Item.Index];
+      InstructionBenchmark Result =
+          Runner->runConfiguration(BC, Options.NumRepetitions);
+      if (Options.NoiseThreshold > 0.0 && Result.Error.empty()) {
+        const InstructionBenchmark Check =
+            Runner->runConfiguration(BC, Options.NumRepetitions);
+        ++NumSamples;
+        if (isNoisy(Result, Check, Options.NoiseThreshold)) {
+          ++NumNoisy;
+          if (Item.NoisyAttempts < Options.MaxNoisyRetries) {
+            retry({Item.Index, Item.NoisyAttempts + 1});
+            if (shouldRetire(CPU, NumSamples, NumNoisy))
+              return;
+            continue;
+          }
+        }
+      }
+      finish(Item.Index, std::move(Result));
+      if (shouldRetire(CPU, NumSamples, NumNoisy))
+        return;
+    }
+  }
+
+  // Blocks until there is work to do. Returns false once all configurations
+  // have a result.
+  bool getWork(WorkItem &Item) {
+    std::unique_lock<std::mutex> Lock(Mutex);
+    WorkAvailable.wait(Lock, [this]() { return !Queue.empty() || !Remaining; });
+    if (!Remaining)
+      return false;
+    Item = Queue.front();
+    Queue.pop_front();
+    return true;
+  }
+
+  void retry(WorkItem Item) {
+    {
+      std::lock_guard<std::mutex> Lock(Mutex);
+      Queue.push_back(Item);
+    }
+    WorkAvailable.notify_one();
+  }
+
+  // Records the result for configuration `Index` and reports all the results
+  // that are now complete in order.
+  void finish(size_t Index, InstructionBenchmark Result) {
+    std::lock_guard<std::mutex> Lock(Mutex);
+    Results[Index] = std::move(Result);
+    for (; NextToReport < Results.size() && Results[NextToReport];
+         ++NextToReport) {
+      OnResult(*Results[NextToReport]);
+      Results[NextToReport].reset();
+    }
+    if (--Remaining == 0)
+      WorkAvailable.notify_all();
+  }
+
+  // Returns true if the worker on `CPU` should stop taking work because its
+  // results are mostly noisy. The last active worker never retires.
+  bool shouldRetire(unsigned CPU, unsigned NumSamples, unsigned NumNoisy) {
+    if (NumSamples < kMinSamplesForNoisyCore || 2 * NumNoisy <= NumSamples)
+      return false;
+    std::lock_guard<std::mutex> Lock(Mutex);
+    if (ActiveWorkers == 1)
+      return false;
+    --ActiveWorkers;
+    llvm::errs() << "cpu " << CPU << ": " << NumNoisy << " of " << NumSamples
+                 << " measurements were noisy, no longer using this cpu\n";
+    return true;
+  }
+
+  const LLVMState &State;
+  const InstructionBenchmark::ModeE Mode;
+  const llvm::ArrayRef<BenchmarkCode> Configurations;
+  const BenchmarkSchedulerOptions &Options;
+  const llvm::function_ref<void(InstructionBenchmark &)> OnResult;
+
+  // Everything below is guarded by Mutex.
+  std::mutex Mutex;
+  std::condition_variable WorkAvailable;
+  std::deque<WorkItem> Queue;
+  std::vector<llvm::Optional<InstructionBenchmark>> Results;
+  size_t NextToReport = 0;
+  size_t Remaining;
+  size_t ActiveWorkers;
+};
+
+} // namespace
+
+void runBenchmarksOnCPUs(
+    const LLVMState &State, InstructionBenchmark::ModeE Mode,
+    llvm::ArrayRef<BenchmarkCode> Configurations,
+    const BenchmarkSchedulerOptions &Options,
+    llvm::function_ref<void(InstructionBenchmark &)> OnResult) {
+  assert(!Options.CPUs.empty() && "no cpu to run benchmarks on");
+  if (Configurations.empty())
+    return;
+  Scheduler(State, Mode, Configurations, Options, OnResult).run();
+}
+
+} // namespace exegesis
+} // namespace llvm
@@ -0,0 +1,61 @@
+//===-- BenchmarkScheduler.h ------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// Runs independent benchmark configurations concurrently, one worker thread
+/// pinned to each of a set of cores.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_TOOLS_LLVM_EXEGESIS_BENCHMARKSCHEDULER_H
+#define LLVM_TOOLS_LLVM_EXEGESIS_BENCHMARKSCHEDULER_H
+
+#include "BenchmarkCode.h"
+#include "BenchmarkResult.h"
+#include "LlvmState.h"
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/STLExtras.h"
+#include <vector>
+
+namespace llvm {
+namespace exegesis {
+
+struct BenchmarkSchedulerOptions {
+  // The cores to run on. Each gets a worker thread pinned to it, with its own
+  // BenchmarkRunner and perf counters.
+  std::vector<unsigned> CPUs;
+  unsigned NumRepetitions = 10000;
+  // If non-zero, every configuration is measured twice, and the pair is noisy
+  // when a measurement differs by more than this fraction between the runs.
+  double NoiseThreshold = 0.0;
+  // How many times a noisy configuration is measured again before its last
+  // result is kept anyway.
+  unsigned MaxNoisyRetries = 3;
+};
+
+// Returns true if two runs of the same configuration disagree by more than
+// `Threshold` (relative to the larger value) on any measurement.
+bool isNoisy(const InstructionBenchmark &A, const InstructionBenchmark &B,
+             double Threshold);
+
+// Measures `Configurations` on the cores in `Options.CPUs`. Noisy results are
+// queued again, so that they are likely to be retried on another core, and a
+// core that keeps producing noisy results stops taking work. `OnResult` is
+// called with the results in the order of `Configurations`, as soon as all
+// previous ones are known.
+void runBenchmarksOnCPUs(
+    const LLVMState &State, InstructionBenchmark::ModeE Mode,
+    llvm::ArrayRef<BenchmarkCode> Configurations,
+    const BenchmarkSchedulerOptions &Options,
+    llvm::function_ref<void(InstructionBenchmark &)> OnResult);
+
+} // namespace exegesis
+} // namespace llvm
+
+#endif // LLVM_TOOLS_LLVM_EXEGESIS_BENCHMARKSCHEDULER_H
@@ -8,9 +8,15 @@
 //===----------------------------------------------------------------------===//
 
 #include "Clustering.h"
+#include "llvm/ADT/Hashing.h"
+#include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/SetVector.h"
 #include "llvm/ADT/SmallVector.h"
+#include <array>
+#include <cmath>
+#include <limits>
 #include <string>
+#include <unordered_map>
 
 namespace llvm {
 namespace exegesis {
@@ -18,7 +24,8 @@ namespace exegesis {
 // The clustering problem has the following characteristics:
 //  (A) - Low dimension (dimensions are typically proc resource units,
 //    typically < 10).
-//  (B) - Number of points : ~thousands (points are measurements of an MCInst)
+//  (B) - Number of points : ~thousands to ~hundreds of thousands (points are
+//    measurements of an MCInst)
 //  (C) - Number of clusters: ~tens.
 //  (D) - The number of clusters is not known /a priory/.
 //  (E) - The amount of noise is relatively small.
@@ -26,28 +33,114 @@ namespace exegesis {
 // k-means and makes algorithms such as DBSCAN[1] or OPTICS[2] more applicable.
 //
 // We've used DBSCAN here because it's simple to implement. This is a pretty
-// straightforward and inefficient implementation of the pseudocode in [2].
+// straightforward implementation of the pseudocode in [2].
+//
+// Because of (B), range queries must not look at all points. Points are
+// bucketed in a uniform grid of cells of size Epsilon, over the few
+// dimensions that have the largest spread (most dimensions only take values
+// close to zero). Two points within Epsilon of each other are also within
+// Epsilon in any projection, so the neighbors of a point are in its cell or
+// in directly adjacent ones.
 //
 // [1] https://en.wikipedia.org/wiki/DBSCAN
 // [2] https://en.wikipedia.org/wiki/OPTICS_algorithm
 
+class InstructionBenchmarkClustering::Grid {
+public:
+  // Indexing more dimensions would not prune much more, and there are 3^N
+  // cells to look at for each query.
+  static constexpr const size_t kMaxDims = 3;
+
+  Grid(const std::vector<InstructionBenchmark> &Points,
+       const std::vector<ClusterId> &ClusterIdForPoint, size_t NumDimensions,
+       double Epsilon)
+      : Points(Points), Epsilon(Epsilon) {
+    // Error points are not clustered.
+    std::vector<size_t> ValidPoints;
+    for (size_t P = 0, E = Points.size(); P < E; ++P)
+      if (!ClusterIdForPoint[P].isError() && !Points[P].Measurements.empty())
+        ValidPoints.push_back(P);
+    if (Epsilon > 0.0 && !ValidPoints.empty()) {
+      // Pick the dimensions with the largest spread. Dimensions that span
+      // less than a cell do not split the points.
+      std::vector<std::pair<double, size_t>> Spreads;
+      for (size_t D = 0; D < NumDimensions; ++D) {
+        double Min = std::numeric_limits<double>::max();
+        double Max = std::numeric_limits<double>::lowest();
+        for (const size_t P : ValidPoints) {
+          const double V = Points[P].Measurements[D].PerInstructionValue;
+          Min = std::min(Min, V);
+          Max = std::max(Max, V);
+        }
+        if (Max - Min > Epsilon)
+          Spreads.emplace_back(Max - Min, D);
+      }
+      llvm::sort(Spreads, [](const std::pair<double, size_t> &A,
+                             const std::pair<double, size_t> &B) {
+        return A.first > B.first;
+      });
+      for (size_t I = 0; I < Spreads.size() && I < kMaxDims; ++I)
+        Dims.push_back(Spreads[I].second);
+    }
+    for (const size_t P : ValidPoints)
+      Cells[getCell(P)].push_back(P);
+  }
+
+  // Calls `F` on every point that is in the cell of `Q` or in an adjacent
+  // one.
+  template <typename Fn> void forEachCandidate(size_t Q, Fn F) const {
+    const Cell Center = getCell(Q);
+    size_t NumNeighborCells = 1;
+    for (size_t I = 0; I < Dims.size(); ++I)
+      NumNeighborCells *= 3;
+    for (size_t Offset = 0; Offset < NumNeighborCells; ++Offset) {
+      Cell C = Center;
+      for (size_t I = 0, Rest = Offset; I < Dims.size(); ++I, Rest /= 3)
+        C[I] += static_cast<int64_t>(Rest % 3) - 1;
+      const auto It = Cells.find(C);
+      if (It == Cells.end())
+        continue;
+      for (const size_t P : It->second)
+        F(P);
+    }
+  }
+
+private:
+  using Cell = std::array<int64_t, kMaxDims>;
+  struct CellHash {
+    size_t operator()(const Cell &C) const {
+      return llvm::hash_combine_range(C.begin(), C.end());
+    }
+  };
+
+  Cell getCell(size_t P) const {
+    Cell C = {};
+    for (size_t I = 0; I < Dims.size(); ++I)
+      C[I] = static_cast<int64_t>(std::floor(
+          Points[P].Measurements[Dims[I]].PerInstructionValue / Epsilon));
+    return C;
+  }
+
+  const std::vector<InstructionBenchmark> &Points;
+  const double Epsilon;
+  // The indexed dimensions.
+  llvm::SmallVector<size_t, kMaxDims> Dims;
+  std::unordered_map<Cell, std::vector<size_t>, CellHash> Cells;
+};
+
 // Finds the points at distance less than sqrt(EpsilonSquared) of Q (not
 // including Q).
 void InstructionBenchmarkClustering::rangeQuery(
-    const size_t Q, std::vector<size_t> &Neighbors) const {
+    const size_t Q, const Grid &G, std::vector<size_t> &Neighbors) const {
   Neighbors.clear();
-  Neighbors.reserve(Points_.size() - 1); // The Q itself isn't a neighbor.
   const auto &QMeasurements = Points_[Q].Measurements;
-  for (size_t P = 0, NumPoints = Points_.size(); P < NumPoints; ++P) {
-    if (P == Q)
-      continue;
-    const auto &PMeasurements = Points_[P].Measurements;
-    if (PMeasurements.empty()) // Error point.
-      continue;
-    if (isNeighbour(PMeasurements, QMeasurements)) {
+  G.forEachCandidate(Q, [this, Q, &QMeasurements, &Neighbors](size_t P) {
+    if (P != Q && isNeighbour(Points_[P].Measurements, QMeasurements))
       Neighbors.push_back(P);
-    }
-  }
+  });
+  // Keep the order of a linear scan so that clusters list their points in
+  // the same order.
+  llvm::sort(Neighbors);
 }
 
 InstructionBenchmarkClustering::InstructionBenchmarkClustering(
@@ -92,11 +185,13 @@ llvm::Error InstructionBenchmarkClustering::validateAndSetup() {
 }
 
 void InstructionBenchmarkClustering::dbScan(const size_t MinPts) {
+  const Grid G(Points_, ClusterIdForPoint_, NumDimensions_,
+               std::sqrt(EpsilonSquared_));
   std::vector<size_t> Neighbors; // Persistent buffer to avoid allocs.
   for (size_t P = 0, NumPoints = Points_.size(); P < NumPoints; ++P) {
     if (!ClusterIdForPoint_[P].isUndef())
       continue; // Previously processed in inner loop.
-    rangeQuery(P, Neighbors);
+    rangeQuery(P, G, Neighbors);
     if (Neighbors.size() + 1 < MinPts) { // Density check.
       // The region around P is not dense enough to create a new cluster, mark
       // as noise for now.
@@ -131,15 +226,12 @@ void InstructionBenchmarkClustering::dbScan(const size_t MinPts) {
       ClusterIdForPoint_[Q] = CurrentCluster.Id;
       CurrentCluster.PointIndices.push_back(Q);
       // And extend to the neighbors of Q if the region is dense enough.
-      rangeQuery(Q, Neighbors);
+      rangeQuery(Q, G, Neighbors);
       if (Neighbors.size() + 1 >= MinPts) {
         ToProcess.insert(Neighbors.begin(), Neighbors.end());
       }
     }
   }
-  // assert(Neighbors.capacity() == (Points_.size() - 1));
-  // ^ True, but it is not quaranteed to be true in all the cases.
-
   // Add noisy points to noise cluster.
   for (size_t P = 0, NumPoints = Points_.size(); P < NumPoints; ++P) {
     if (ClusterIdForPoint_[P].isNoise()) {
@@ -100,11 +100,15 @@ public:
   }
 
 private:
+  // A spatial index for range queries, see the cc file.
+  class Grid;
+
   InstructionBenchmarkClustering(
       const std::vector<InstructionBenchmark> &Points, double EpsilonSquared);
   llvm::Error validateAndSetup();
   void dbScan(size_t MinPts);
-  void rangeQuery(size_t Q, std::vector<size_t> &Scratchpad) const;
+  void rangeQuery(size_t Q, const Grid &G,
+                  std::vector<size_t> &Scratchpad) const;
 
   const std::vector<InstructionBenchmark> &Points_;
   const double EpsilonSquared_;
@@ -89,13 +89,14 @@ llvm::StringRef PerfEvent::getPfmEventString() const {
 }
 
 #ifdef HAVE_LIBPFM
-Counter::Counter(const PerfEvent &Event) {
+Counter::Counter(const PerfEvent &Event, bool IncludeChildren) {
   assert(Event.valid());
   const pid_t Pid = 0;    // measure current process/thread.
   const int Cpu = -1;     // measure any processor.
   const int GroupFd = -1; // no grouping of counters.
   const uint32_t Flags = 0;
   perf_event_attr AttrCopy = *Event.attribute();
+  AttrCopy.inherit = IncludeChildren;
   FileDescriptor = perf_event_open(&AttrCopy, Pid, Cpu, GroupFd, Flags);
   if (FileDescriptor == -1) {
     llvm::errs() << "Unable to open event, make sure your kernel allows user "
@@ -123,7 +124,7 @@ int64_t Counter::read() const {
 
 #else
 
-Counter::Counter(const PerfEvent &Event) {}
+Counter::Counter(const PerfEvent &Event, bool IncludeChildren) {}
 
 Counter::~Counter() = default;
 
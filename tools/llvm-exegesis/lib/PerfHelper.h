@@ -66,7 +66,9 @@ private:
 // underlying event.
 struct Counter {
   // event: the PerfEvent to measure.
-  explicit Counter(const PerfEvent &event);
+  // IncludeChildren: also count the events of the processes created by this
+  // one after the counter is opened; their counts are added when they exit.
+  explicit Counter(const PerfEvent &event, bool IncludeChildren = false);
 
   Counter(const Counter &) = delete;
   Counter(Counter &&other) = default;
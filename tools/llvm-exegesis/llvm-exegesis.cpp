@@ -15,6 +15,7 @@
 #include "lib/Analysis.h"
 #include "lib/BenchmarkResult.h"
 #include "lib/BenchmarkRunner.h"
+#include "lib/BenchmarkScheduler.h"
 #include "lib/Clustering.h"
 #include "lib/LlvmState.h"
 #include "lib/PerfHelper.h"
@@ -93,6 +94,11 @@ static cl::opt<std::string>
 static cl::opt<std::string>
     AnalysisInconsistenciesOutputFile("analysis-inconsistencies-output-file",
                                       cl::desc(""), cl::init("-"));
+static cl::opt<std::string> AnalysisSchedModelPatchesOutputFile(
+    "analysis-sched-model-patches-output-file",
+    cl::desc("file to print TableGen definitions that make the scheduling "
+             "model match the measurements to"),
+    cl::init(""));
 
 static cl::opt<std::string>
     CpuName("mcpu",
@@ -100,6 +106,22 @@ static cl::opt<std::string>
                 "cpu name to use for pfm counters, leave empty to autodetect"),
             cl::init(""));
 
+static cl::list<unsigned> BenchmarkCPUs(
+    "benchmark-cpus",
+    cl::desc("comma-separated list of cpus to run benchmarks on in parallel, "
+             "one pinned thread per cpu"),
+    cl::CommaSeparated);
+
+static cl::opt<double> NoiseThreshold(
+    "noise-threshold",
+    cl::desc("with -benchmark-cpus, measure each snippet twice and run it "
+             "again when the measurements differ by more than this fraction"),
+    cl::init(0.0));
+
+static cl::opt<unsigned> MaxNoisyRetries(
+    "max-noisy-retries",
+    cl::desc("number of times a noisy measurement is run again"),
+    cl::init(3));
 
 static ExitOnError ExitOnErr;
 
@@ -356,12 +378,6 @@ void benchmarkMain() {
     Configurations = ExitOnErr(readSnippets(State, SnippetsFile));
   }
 
-  const std::unique_ptr<BenchmarkRunner> Runner =
-      State.getExegesisTarget().createBenchmarkRunner(BenchmarkMode, State);
-  if (!Runner) {
-    llvm::report_fatal_error("cannot create benchmark runner");
-  }
-
   if (NumRepetitions == 0)
     llvm::report_fatal_error("--num-repetitions must be greater than zero");
 
@@ -369,6 +385,26 @@ void benchmarkMain() {
   if (BenchmarkFile.empty())
     BenchmarkFile = "-";
 
+  if (!BenchmarkCPUs.empty()) {
+    BenchmarkSchedulerOptions Options;
+    Options.CPUs.assign(BenchmarkCPUs.begin(), BenchmarkCPUs.end());
+    Options.NumRepetitions = NumRepetitions;
+    Options.NoiseThreshold = NoiseThreshold;
+    Options.MaxNoisyRetries = MaxNoisyRetries;
+    runBenchmarksOnCPUs(State, BenchmarkMode, Configurations, Options,
+                        [&State](InstructionBenchmark &Result) {
+                          ExitOnErr(Result.writeYaml(State, BenchmarkFile));
+                        });
+    exegesis::pfm::pfmTerminate();
+    return;
+  }
+
+  const std::unique_ptr<BenchmarkRunner> Runner =
+      State.getExegesisTarget().createBenchmarkRunner(BenchmarkMode, State);
+  if (!Runner) {
+    llvm::report_fatal_error("cannot create benchmark runner");
+  }
+
   for (const BenchmarkCode &Conf : Configurations) {
     InstructionBenchmark Result =
         Runner->runConfiguration(Conf, NumRepetitions);
@@ -434,6 +470,8 @@ static void analysisMain() {
   maybeRunAnalysis<Analysis::PrintSchedClassInconsistencies>(
       Analyzer, "sched class consistency analysis",
       AnalysisInconsistenciesOutputFile);
+  maybeRunAnalysis<Analysis::PrintSchedModelPatches>(
+      Analyzer, "sched model patches", AnalysisSchedModelPatchesOutputFile);
 }
 
 } // namespace exegesis
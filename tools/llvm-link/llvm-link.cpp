@@ -27,15 +27,19 @@
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/InitLLVM.h"
+#include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/SourceMgr.h"
 #include "llvm/Support/SystemUtils.h"
+#include "llvm/Support/ThreadPool.h"
 #include "llvm/Support/ToolOutputFile.h"
 #include "llvm/Support/WithColor.h"
 #include "llvm/Transforms/IPO/FunctionImport.h"
 #include "llvm/Transforms/IPO/Internalize.h"
 #include "llvm/Transforms/Utils/FunctionImportUtils.h"
 
+#include <deque>
+#include <future>
 #include <memory>
 #include <utility>
 using namespace llvm;
@@ -86,6 +90,10 @@ static cl::opt<bool>
     DisableLazyLoad("disable-lazy-loading",
                     cl::desc("Disable lazy module loading"));
 
+static cl::opt<unsigned>
+    Threads("j", cl::desc("Number of threads to read the input files with"),
+            cl::init(1));
+
 static cl::opt<bool>
     OutputAssembly("S", cl::desc("Write output as LLVM assembly"), cl::Hidden);
 
@@ -112,17 +120,27 @@ static cl::opt<bool> PreserveAssemblyUseListOrder(
 static ExitOnError ExitOnErr;
 
 // Read the specified bitcode file in and return it. This routine searches the
-// link path for the specified file to try to find it...
+// link path for the specified file to try to find it... If \p Buffer is given,
+// it holds the contents of the file, which have been read already.
 //
-static std::unique_ptr<Module> loadFile(const char *argv0,
-                                        const std::string &FN,
-                                        LLVMContext &Context,
-                                        bool MaterializeMetadata = true) {
+static std::unique_ptr<Module>
+loadFile(const char *argv0, const std::string &FN, LLVMContext &Context,
+         bool MaterializeMetadata = true,
+         ErrorOr<std::unique_ptr<MemoryBuffer>> *Buffer = nullptr) {
   SMDiagnostic Err;
   if (Verbose)
     errs() << "Loading '" << FN << "'\n";
   std::unique_ptr<Module> Result;
-  if (DisableLazyLoad)
+  if (Buffer && !*Buffer)
+    Err = SMDiagnostic(FN, SourceMgr::DK_Error,
+                       "Could not open input file: " +
+                           Buffer->getError().message());
+  else if (Buffer && DisableLazyLoad)
+    Result = parseIR((**Buffer)->getMemBufferRef(), Err, Context);
+  else if (Buffer)
+    Result = getLazyIRModule(std::move(**Buffer), Err, Context,
+                             !MaterializeMetadata);
+  else if (DisableLazyLoad)
     Result = parseIRFile(FN, Err, Context);
   else
     Result = getLazyIRFileModule(FN, Err, Context, !MaterializeMetadata);
@@ -183,6 +201,61 @@ Module &ModuleLazyLoaderCache::operator()(const char *argv0,
 } // anonymous namespace
 
 namespace {
+
+/// Reads the input files on a thread pool, ahead of the linker, which takes
+/// them in the order they were added. Parsing and linking stay on the main
+/// thread, since the modules must all be in the context they are linked into;
+/// the reads of hundreds of inputs then overlap with linking the first ones.
+class InputFileReader {
+  struct InputFile {
+    std::string Name;
+    ErrorOr<std::unique_ptr<MemoryBuffer>> Buffer = std::error_code();
+    std::shared_future<void> Read;
+  };
+
+  std::deque<InputFile> Files;
+  /// Destroyed first, so that it waits for the reads still in flight.
+  std::unique_ptr<ThreadPool> Pool;
+
+public:
+  /// Starts reading \p FileNames on \p Threads threads.
+  InputFileReader(ArrayRef<std::string> FileNames, unsigned Threads) {
+    if (Threads <= 1 || FileNames.empty())
+      return;
+    Pool = llvm::make_unique<ThreadPool>(
+        std::min<size_t>(Threads, FileNames.size()));
+    for (const std::string &Name : FileNames) {
+      Files.emplace_back();
+      InputFile &File = Files.back();
+      File.Name = Name;
+      // Read the file rather than mapping it, so that the I/O happens here
+      // instead of when the bitcode reader first touches the pages.
+      File.Read = Pool->async([&File]() {
+        if (File.Name == "-")
+          File.Buffer = MemoryBuffer::getSTDIN();
+        else
+          File.Buffer = MemoryBuffer::getFile(File.Name, /*FileSize=*/-1,
+                                              /*RequiresNullTerminator=*/true,
+                                              /*IsVolatile=*/true);
+      });
+    }
+  }
+
+  /// Loads the next input file, which must be \p FN, from the contents read
+  /// for it, or from disk if the files are not read ahead.
+  std::unique_ptr<Module> loadNext(const char *argv0, const std::string &FN,
+                                   LLVMContext &Context) {
+    if (Files.empty())
+      return loadFile(argv0, FN, Context);
+    assert(Files.front().Name == FN && "input files taken out of order");
+    Files.front().Read.wait();
+    ErrorOr<std::unique_ptr<MemoryBuffer>> Buffer =
+        std::move(Files.front().Buffer);
+    Files.pop_front();
+    return loadFile(argv0, FN, Context, /*MaterializeMetadata=*/true, &Buffer);
+  }
+};
+
 struct LLVMLinkDiagnosticHandler : public DiagnosticHandler {
   bool handleDiagnostics(const DiagnosticInfo &DI) override {
     unsigned Severity = DI.getSeverity();
@@ -275,13 +348,13 @@ static bool importFunctions(const char *argv0, Module &DestModule) {
 
 static bool linkFiles(const char *argv0, LLVMContext &Context, Linker &L,
                       const cl::list<std::string> &Files,
-                      unsigned Flags) {
+                      InputFileReader &Reader, unsigned Flags) {
   // Filter out flags that don't apply to the first file we load.
   unsigned ApplicableFlags = Flags & Linker::Flags::OverrideFromSrc;
   // Similar to some flags, internalization doesn't apply to the first file.
   bool InternalizeLinkedSymbols = false;
   for (const auto &File : Files) {
-    std::unique_ptr<Module> M = loadFile(argv0, File, Context);
+    std::unique_ptr<Module> M = Reader.loadNext(argv0, File, Context);
     if (!M.get()) {
       errs() << argv0 << ": ";
       WithColor::error() << " loading file '" << File << "'\n";
@@ -365,12 +438,18 @@ int main(int argc, char **argv) {
   if (OnlyNeeded)
     Flags |= Linker::Flags::LinkOnlyNeeded;
 
+  std::vector<std::string> AllInputs(InputFilenames.begin(),
+                                     InputFilenames.end());
+  AllInputs.insert(AllInputs.end(), OverridingInputs.begin(),
+                   OverridingInputs.end());
+  InputFileReader Reader(AllInputs, Threads);
+
   // First add all the regular input files
-  if (!linkFiles(argv[0], Context, L, InputFilenames, Flags))
+  if (!linkFiles(argv[0], Context, L, InputFilenames, Reader, Flags))
     return 1;
 
   // Next the -override ones.
-  if (!linkFiles(argv[0], Context, L, OverridingInputs,
+  if (!linkFiles(argv[0], Context, L, OverridingInputs, Reader,
                  Flags | Linker::Flags::OverrideFromSrc))
     return 1;
 
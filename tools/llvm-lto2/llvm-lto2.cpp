@@ -50,6 +50,12 @@ static cl::opt<std::string> OutputFilename("o", cl::Required,
 static cl::opt<std::string> CacheDir("cache-dir", cl::desc("Cache Directory"),
                                      cl::value_desc("directory"));
 
+static cl::opt<std::string>
+    SharedCacheDir("shared-cache-dir",
+                   cl::desc("Content-addressed object store shared with other "
+                            "machines"),
+                   cl::value_desc("directory"));
+
 static cl::opt<std::string> OptPipeline("opt-pipeline",
                                         cl::desc("Optimizer Pipeline"),
                                         cl::value_desc("pipeline"));
@@ -258,9 +264,15 @@ static int run(int argc, char **argv) {
     Backend = createInProcessThinBackend(Threads);
   LTO Lto(std::move(Conf), std::move(Backend));
 
+  // Read all the inputs up front, several at once, so that the latency of
+  // slow storage overlaps.
+  std::vector<StringRef> Names(InputFilenames.begin(), InputFilenames.end());
+  auto Buffers = MemoryBuffer::getFiles(Names);
+
   bool HasErrors = false;
-  for (std::string F : InputFilenames) {
-    std::unique_ptr<MemoryBuffer> MB = check(MemoryBuffer::getFile(F), F);
+  for (size_t I = 0, E = InputFilenames.size(); I != E; ++I) {
+    std::string F = InputFilenames[I];
+    std::unique_ptr<MemoryBuffer> MB = check(std::move(Buffers[I]), F);
     std::unique_ptr<InputFile> Input =
         check(InputFile::create(MB->getMemBufferRef()), F);
 
@@ -311,8 +323,18 @@ static int run(int argc, char **argv) {
   };
 
   NativeObjectCache Cache;
+  if (!CacheDir.empty() && !SharedCacheDir.empty()) {
+    llvm::errs() << argv[0] << ": -cache-dir and -shared-cache-dir are "
+                               "mutually exclusive\n";
+    return 1;
+  }
   if (!CacheDir.empty())
     Cache = check(localCache(CacheDir, AddBuffer), "failed to create cache");
+  if (!SharedCacheDir.empty()) {
+    auto Backend = check(createSharedDirectoryCacheBackend(SharedCacheDir),
+                         "failed to create cache");
+    Cache = backendCache(std::move(Backend), AddBuffer);
+  }
 
   check(Lto.run(AddStream, Cache), "LTO::run failed");
   return 0;
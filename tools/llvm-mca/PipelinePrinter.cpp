@@ -22,5 +22,13 @@ void PipelinePrinter::printReport(llvm::raw_ostream &OS) const {
   for (const auto &V : Views)
     V->printView(OS);
 }
+
+void PipelinePrinter::printReport(json::Object &JO) const {
+  for (const auto &V : Views) {
+    json::Value JV = V->toJSON();
+    if (JV.kind() != json::Value::Null)
+      JO[V->getNameAsString()] = std::move(JV);
+  }
+}
 } // namespace mca.
 } // namespace llvm
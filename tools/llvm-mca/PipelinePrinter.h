@@ -47,6 +47,9 @@ public:
   }
 
   void printReport(llvm::raw_ostream &OS) const;
+
+  /// Adds the JSON form of every view that has one to \p JO.
+  void printReport(llvm::json::Object &JO) const;
 };
 } // namespace mca
 } // namespace llvm
@@ -16,7 +16,9 @@
 #ifndef LLVM_TOOLS_LLVM_MCA_VIEW_H
 #define LLVM_TOOLS_LLVM_MCA_VIEW_H
 
+#include "llvm/ADT/StringRef.h"
 #include "llvm/MCA/HWEventListener.h"
+#include "llvm/Support/JSON.h"
 #include "llvm/Support/raw_ostream.h"
 
 namespace llvm {
@@ -25,6 +27,14 @@ namespace mca {
 class View : public HWEventListener {
 public:
   virtual void printView(llvm::raw_ostream &OS) const = 0;
+
+  /// The key of this view in the JSON report.
+  virtual llvm::StringRef getNameAsString() const { return ""; }
+
+  /// Returns the statistics of this view for the JSON report, or null if the
+  /// view has no JSON form.
+  virtual llvm::json::Value toJSON() const { return nullptr; }
+
   virtual ~View() = default;
   void anchor() override;
 };
@@ -40,19 +40,26 @@
 #include "llvm/MCA/Pipeline.h"
 #include "llvm/MCA/Stages/EntryStage.h"
 #include "llvm/MCA/Stages/InstructionTables.h"
+#include "llvm/MCA/Stages/MemoryModelStage.h"
 #include "llvm/MCA/Support.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/ErrorOr.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/FormatVariadic.h"
 #include "llvm/Support/Host.h"
 #include "llvm/Support/InitLLVM.h"
+#include "llvm/Support/JSON.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/SourceMgr.h"
 #include "llvm/Support/TargetRegistry.h"
 #include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/ThreadPool.h"
+#include "llvm/Support/Threading.h"
 #include "llvm/Support/ToolOutputFile.h"
 #include "llvm/Support/WithColor.h"
+#include <atomic>
+#include <mutex>
 
 using namespace llvm;
 
@@ -159,6 +166,27 @@ static cl::opt<unsigned>
                    cl::desc("Size of the store queue"),
                    cl::cat(ToolOptions), cl::init(0));
 
+static cl::opt<unsigned>
+    L1Latency("l1-latency",
+              cl::desc("Latency of loads that hit the L1 cache (defaults to "
+                       "the load latency of the scheduling model)"),
+              cl::cat(ToolOptions), cl::init(0));
+
+static cl::opt<unsigned>
+    L2Latency("l2-latency",
+              cl::desc("Latency of loads that miss the L1 cache"),
+              cl::cat(ToolOptions), cl::init(0));
+
+static cl::opt<unsigned> L1MissInterval(
+    "l1-miss-interval",
+    cl::desc("Make one in every N iterations of each load miss the L1 cache"),
+    cl::cat(ToolOptions), cl::init(0));
+
+static cl::opt<unsigned> StoreForwardLatency(
+    "store-forward-latency",
+    cl::desc("Latency of loads from the address of an older store"),
+    cl::cat(ToolOptions), cl::init(0));
+
 static cl::opt<bool>
     PrintInstructionTables("instruction-tables",
                            cl::desc("Print instruction tables"),
@@ -178,6 +206,15 @@ static cl::opt<bool>
                    cl::desc("Print all views including hardware statistics"),
                    cl::cat(ViewOptions), cl::init(false));
 
+static cl::opt<unsigned>
+    NumThreads("j", cl::desc("Number of threads to simulate code regions with "
+                             "(0 = one per hardware thread)"),
+               cl::cat(ToolOptions), cl::init(1));
+
+static cl::opt<bool>
+    PrintJson("json", cl::desc("Print the report in JSON format"),
+              cl::cat(ViewOptions), cl::init(false));
+
 namespace {
 
 const Target *getTarget(const char *ProgName) {
@@ -237,17 +274,6 @@ static void processViewOptions() {
   processOptionImpl(PrintRetireStats, Default);
 }
 
-// Returns true on success.
-static bool runPipeline(mca::Pipeline &P) {
-  // Handle pipeline errors here.
-  Expected<unsigned> Cycles = P.run();
-  if (!Cycles) {
-    WithColor::error() << toString(Cycles.takeError());
-    return false;
-  }
-  return true;
-}
-
 int main(int argc, char **argv) {
   InitLLVM X(argc, argv);
 
@@ -377,40 +403,32 @@ int main(int argc, char **argv) {
   if (DispatchWidth)
     Width = DispatchWidth;
 
-  // Create an instruction builder.
-  mca::InstrBuilder IB(*STI, *MCII, *MRI, MCIA.get());
-
-  // Create a context to control ownership of the pipeline hardware.
-  mca::Context MCA(*MRI, *STI);
-
   mca::PipelineOptions PO(Width, RegisterFileSize, LoadQueueSize,
                           StoreQueueSize, AssumeNoAlias);
 
-  // Number each region in the sequence.
-  unsigned RegionIdx = 0;
-
-  for (const std::unique_ptr<mca::CodeRegion> &Region : Regions) {
-    // Skip empty code regions.
-    if (Region->empty())
-      continue;
-
-    // Don't print the header of this region if it is the default region, and
-    // it doesn't have an end location.
-    if (Region->startLoc().isValid() || Region->endLoc().isValid()) {
-      TOF->os() << "\n[" << RegionIdx++ << "] Code Region";
-      StringRef Desc = Region->getDescription();
-      if (!Desc.empty())
-        TOF->os() << " - " << Desc;
-      TOF->os() << "\n\n";
-    }
+  // Regions are simulated independently, each with its own instruction
+  // builder, context and pipeline, and only read the target descriptions. Reports and
+  // diagnostics use the instruction printer, so they are only printed under
+  // this lock.
+  std::mutex PrinterMutex;
+
+  // Simulate |Region| and write its report to |OS|, or to |JO| in JSON mode.
+  // Returns true on success.
+  auto SimulateRegion = [&](const mca::CodeRegion &Region, raw_ostream &OS,
+                            json::Object &JO) {
+    // Create an instruction builder, and a context to control ownership of
+    // the pipeline hardware.
+    mca::InstrBuilder IB(*STI, *MCII, *MRI, MCIA.get());
+    mca::Context MCA(*MRI, *STI);
 
     // Lower the MCInst sequence into an mca::Instruction sequence.
-    ArrayRef<MCInst> Insts = Region->getInstructions();
+    ArrayRef<MCInst> Insts = Region.getInstructions();
     std::vector<std::unique_ptr<mca::Instruction>> LoweredSequence;
     for (const MCInst &MCI : Insts) {
       Expected<std::unique_ptr<mca::Instruction>> Inst =
           IB.createInstruction(MCI);
       if (!Inst) {
+        std::lock_guard<std::mutex> Lock(PrinterMutex);
         if (auto NewE = handleErrors(
                 Inst.takeError(),
                 [&IP, &STI](const mca::InstructionError<MCInst> &IE) {
@@ -425,7 +443,7 @@ int main(int argc, char **argv) {
           // Default case.
           WithColor::error() << toString(std::move(NewE));
         }
-        return 1;
+        return false;
       }
 
       LoweredSequence.emplace_back(std::move(Inst.get()));
@@ -433,72 +451,164 @@ int main(int argc, char **argv) {
 
     mca::SourceMgr S(LoweredSequence, PrintInstructionTables ? 1 : Iterations);
 
+    std::unique_ptr<mca::Pipeline> P;
+    std::unique_ptr<mca::PipelinePrinter> Printer;
     if (PrintInstructionTables) {
       //  Create a pipeline, stages, and a printer.
-      auto P = llvm::make_unique<mca::Pipeline>();
+      P = llvm::make_unique<mca::Pipeline>();
       P->appendStage(llvm::make_unique<mca::EntryStage>(S));
       P->appendStage(llvm::make_unique<mca::InstructionTables>(SM));
-      mca::PipelinePrinter Printer(*P);
+      Printer = llvm::make_unique<mca::PipelinePrinter>(*P);
 
       // Create the views for this pipeline, execute, and emit a report.
       if (PrintInstructionInfoView) {
-        Printer.addView(llvm::make_unique<mca::InstructionInfoView>(
+        Printer->addView(llvm::make_unique<mca::InstructionInfoView>(
             *STI, *MCII, Insts, *IP));
       }
-      Printer.addView(
+      Printer->addView(
           llvm::make_unique<mca::ResourcePressureView>(*STI, *IP, Insts));
+    } else {
+      // Model the memory hierarchy if any of its parameters is set.
+      std::unique_ptr<mca::Stage> MemoryStage;
+      if (L1Latency || L2Latency || StoreForwardLatency) {
+        mca::MemoryModelOptions MMO;
+        MMO.L1Latency = L1Latency;
+        MMO.L2Latency = L2Latency;
+        MMO.L1MissInterval = L1MissInterval;
+        MMO.StoreForwardLatency = StoreForwardLatency;
+        MemoryStage = llvm::make_unique<mca::MemoryModelStage>(MMO, SM, Insts,
+                                                               *MCII, *MRI);
+      }
 
-      if (!runPipeline(*P))
-        return 1;
-
-      Printer.printReport(TOF->os());
-      continue;
-    }
-
-    // Create a basic pipeline simulating an out-of-order backend.
-    auto P = MCA.createDefaultPipeline(PO, IB, S);
-    mca::PipelinePrinter Printer(*P);
+      // Create a basic pipeline simulating an out-of-order backend.
+      P = MCA.createDefaultPipeline(PO, IB, S, std::move(MemoryStage));
+      Printer = llvm::make_unique<mca::PipelinePrinter>(*P);
 
-    if (PrintSummaryView)
-      Printer.addView(llvm::make_unique<mca::SummaryView>(SM, Insts, Width));
+      if (PrintSummaryView)
+        Printer->addView(
+            llvm::make_unique<mca::SummaryView>(SM, Insts, Width));
 
-    if (PrintInstructionInfoView)
-      Printer.addView(
-          llvm::make_unique<mca::InstructionInfoView>(*STI, *MCII, Insts, *IP));
+      if (PrintInstructionInfoView)
+        Printer->addView(llvm::make_unique<mca::InstructionInfoView>(
+            *STI, *MCII, Insts, *IP));
 
-    if (PrintDispatchStats)
-      Printer.addView(llvm::make_unique<mca::DispatchStatistics>());
+      if (PrintDispatchStats)
+        Printer->addView(llvm::make_unique<mca::DispatchStatistics>());
 
-    if (PrintSchedulerStats)
-      Printer.addView(llvm::make_unique<mca::SchedulerStatistics>(*STI));
+      if (PrintSchedulerStats)
+        Printer->addView(llvm::make_unique<mca::SchedulerStatistics>(*STI));
 
-    if (PrintRetireStats)
-      Printer.addView(llvm::make_unique<mca::RetireControlUnitStatistics>(SM));
+      if (PrintRetireStats)
+        Printer->addView(
+            llvm::make_unique<mca::RetireControlUnitStatistics>(SM));
 
-    if (PrintRegisterFileStats)
-      Printer.addView(llvm::make_unique<mca::RegisterFileStatistics>(*STI));
+      if (PrintRegisterFileStats)
+        Printer->addView(
+            llvm::make_unique<mca::RegisterFileStatistics>(*STI));
 
-    if (PrintResourcePressureView)
-      Printer.addView(
-          llvm::make_unique<mca::ResourcePressureView>(*STI, *IP, Insts));
+      if (PrintResourcePressureView)
+        Printer->addView(
+            llvm::make_unique<mca::ResourcePressureView>(*STI, *IP, Insts));
 
-    if (PrintTimelineView) {
-      unsigned TimelineIterations =
-          TimelineMaxIterations ? TimelineMaxIterations : 10;
-      Printer.addView(llvm::make_unique<mca::TimelineView>(
-          *STI, *IP, Insts, std::min(TimelineIterations, S.getNumIterations()),
-          TimelineMaxCycles));
+      if (PrintTimelineView) {
+        unsigned TimelineIterations =
+            TimelineMaxIterations ? TimelineMaxIterations : 10;
+        Printer->addView(llvm::make_unique<mca::TimelineView>(
+            *STI, *IP, Insts,
+            std::min(TimelineIterations, S.getNumIterations()),
+            TimelineMaxCycles));
+      }
     }
 
-    if (!runPipeline(*P))
-      return 1;
+    // Handle pipeline errors here.
+    Expected<unsigned> Cycles = P->run();
+    std::lock_guard<std::mutex> Lock(PrinterMutex);
+    if (!Cycles) {
+      WithColor::error() << toString(Cycles.takeError());
+      return false;
+    }
 
-    Printer.printReport(TOF->os());
+    if (PrintJson)
+      Printer->printReport(JO);
+    else
+      Printer->printReport(OS);
+    return true;
+  };
+
+  // Skip empty code regions, and number the others in the sequence. Don't
+  // print the header of a region if it is the default region, and it doesn't
+  // have an end location.
+  std::vector<const mca::CodeRegion *> NonEmptyRegions;
+  for (const std::unique_ptr<mca::CodeRegion> &Region : Regions)
+    if (!Region->empty())
+      NonEmptyRegions.push_back(Region.get());
+  auto HasHeader = [](const mca::CodeRegion &Region) {
+    return Region.startLoc().isValid() || Region.endLoc().isValid();
+  };
+  auto PrintHeader = [](raw_ostream &OS, unsigned RegionIdx,
+                        const mca::CodeRegion &Region) {
+    OS << "\n[" << RegionIdx << "] Code Region";
+    StringRef Desc = Region.getDescription();
+    if (!Desc.empty())
+      OS << " - " << Desc;
+    OS << "\n\n";
+  };
+
+  unsigned Threads = NumThreads ? NumThreads : hardware_concurrency();
+  std::vector<std::string> Reports(NonEmptyRegions.size());
+  std::vector<json::Object> JSONReports(NonEmptyRegions.size());
+  bool Failed = false;
+  if (Threads <= 1 || NonEmptyRegions.size() <= 1) {
+    // Stream the reports as the regions are simulated.
+    unsigned RegionIdx = 0;
+    for (unsigned I = 0, E = NonEmptyRegions.size(); I != E; ++I) {
+      const mca::CodeRegion &Region = *NonEmptyRegions[I];
+      if (!PrintJson && HasHeader(Region))
+        PrintHeader(TOF->os(), RegionIdx++, Region);
+      if (!SimulateRegion(Region, TOF->os(), JSONReports[I]))
+        return 1;
+    }
+  } else {
+    // Simulate the regions in parallel, and print the reports in their
+    // original order once all of them are done.
+    std::atomic<bool> AnyFailed(false);
+    ThreadPool Pool(Threads);
+    for (unsigned I = 0, E = NonEmptyRegions.size(); I != E; ++I)
+      Pool.async([&, I] {
+        if (AnyFailed)
+          return;
+        raw_string_ostream OS(Reports[I]);
+        if (!SimulateRegion(*NonEmptyRegions[I], OS, JSONReports[I]))
+          AnyFailed = true;
+      });
+    Pool.wait();
+    Failed = AnyFailed;
+
+    unsigned RegionIdx = 0;
+    for (unsigned I = 0, E = NonEmptyRegions.size(); I != E && !PrintJson;
+         ++I) {
+      if (HasHeader(*NonEmptyRegions[I]))
+        PrintHeader(TOF->os(), RegionIdx++, *NonEmptyRegions[I]);
+      TOF->os() << Reports[I];
+    }
+  }
 
-    // Clear the InstrBuilder internal state in preparation for another round.
-    IB.clear();
+  if (PrintJson) {
+    json::Array JSONRegions;
+    for (unsigned I = 0, E = NonEmptyRegions.size(); I != E; ++I) {
+      JSONReports[I]["Name"] = NonEmptyRegions[I]->getDescription();
+      JSONRegions.push_back(std::move(JSONReports[I]));
+    }
+    json::Object JSONReport{
+        {"TargetInfo",
+         json::Object{{"CPUName", MCPU}, {"TargetTriple", TripleName}}},
+        {"CodeRegions", std::move(JSONRegions)}};
+    TOF->os() << formatv("{0:2}", json::Value(std::move(JSONReport))) << '\n';
   }
 
+  if (Failed)
+    return 1;
+
   TOF->keep();
   return 0;
 }
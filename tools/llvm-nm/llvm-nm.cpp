@@ -38,8 +38,10 @@
 #include "llvm/Support/Program.h"
 #include "llvm/Support/Signals.h"
 #include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/ThreadPool.h"
 #include "llvm/Support/WithColor.h"
 #include "llvm/Support/raw_ostream.h"
+#include <atomic>
 #include <vector>
 
 using namespace llvm;
@@ -135,7 +137,7 @@ cl::opt<bool> PrintSize("print-size",
                         cl::desc("Show symbol size instead of address"));
 cl::alias PrintSizeS("S", cl::desc("Alias for --print-size"),
                      cl::aliasopt(PrintSize), cl::Grouping);
-bool MachOPrintSizeWarning = false;
+std::atomic<bool> MachOPrintSizeWarning(false);
 
 cl::opt<bool> SizeSort("size-sort", cl::desc("Sort symbols by size"));
 
@@ -184,20 +186,31 @@ cl::opt<bool> DyldInfoOnly("dyldinfo-only",
 cl::opt<bool> NoLLVMBitcode("no-llvm-bc",
                             cl::desc("Disable LLVM bitcode reader"));
 
+cl::opt<unsigned>
+    Threads("threads",
+            cl::desc("Number of input files to process concurrently "
+                     "(0 processes them one at a time)"),
+            cl::init(0));
+
 cl::extrahelp HelpResponse("\nPass @FILE as argument to read options from FILE.\n");
 
 bool PrintAddress = true;
 
 bool MultipleFiles = false;
 
-bool HadError = false;
+std::atomic<bool> HadError(false);
 
 std::string ToolName;
 } // anonymous namespace
 
+// The streams that the output and the diagnostics for the current input file
+// are written to.
+static raw_ostream &out();
+static raw_ostream &err();
+
 static void error(Twine Message, Twine Path = Twine()) {
   HadError = true;
-  WithColor::error(errs(), ToolName) << Path << ": " << Message << ".\n";
+  WithColor::error(err(), ToolName) << Path << ": " << Message << ".\n";
 }
 
 static bool error(std::error_code EC, Twine Path = Twine()) {
@@ -214,7 +227,7 @@ static bool error(std::error_code EC, Twine Path = Twine()) {
 static void error(llvm::Error E, StringRef FileName, const Archive::Child &C,
                   StringRef ArchitectureName = StringRef()) {
   HadError = true;
-  WithColor::error(errs(), ToolName) << FileName;
+  WithColor::error(err(), ToolName) << FileName;
 
   Expected<StringRef> NameOrErr = C.getName();
   // TODO: if we have a error getting the name then it would be nice to print
@@ -222,18 +235,18 @@ static void error(llvm::Error E, StringRef FileName, const Archive::Child &C,
   // archive instead of "???" as the name.
   if (!NameOrErr) {
     consumeError(NameOrErr.takeError());
-    errs() << "(" << "???" << ")";
+    err() << "(" << "???" << ")";
   } else
-    errs() << "(" << NameOrErr.get() << ")";
+    err() << "(" << NameOrErr.get() << ")";
 
   if (!ArchitectureName.empty())
-    errs() << " (for architecture " << ArchitectureName << ") ";
+    err() << " (for architecture " << ArchitectureName << ") ";
 
   std::string Buf;
   raw_string_ostream OS(Buf);
   logAllUnhandledErrors(std::move(E), OS);
   OS.flush();
-  errs() << " " << Buf << "\n";
+  err() << " " << Buf << "\n";
 }
 
 // This version of error() prints the file name and which architecture slice it
@@ -243,16 +256,16 @@ static void error(llvm::Error E, StringRef FileName, const Archive::Child &C,
 static void error(llvm::Error E, StringRef FileName,
                   StringRef ArchitectureName = StringRef()) {
   HadError = true;
-  WithColor::error(errs(), ToolName) << FileName;
+  WithColor::error(err(), ToolName) << FileName;
 
   if (!ArchitectureName.empty())
-    errs() << " (for architecture " << ArchitectureName << ") ";
+    err() << " (for architecture " << ArchitectureName << ") ";
 
   std::string Buf;
   raw_string_ostream OS(Buf);
   logAllUnhandledErrors(std::move(E), OS);
   OS.flush();
-  errs() << " " << Buf << "\n";
+  err() << " " << Buf << "\n";
 }
 
 namespace {
@@ -313,9 +326,35 @@ static char isSymbolList64Bit(SymbolicFile &Obj) {
   return cast<ELFObjectFileBase>(Obj).getBytesInAddress() == 8;
 }
 
-static StringRef CurrentFilename;
 typedef std::vector<NMSymbol> SymbolListT;
-static SymbolListT SymbolList;
+
+namespace {
+/// The state of the file being dumped. With --threads, every input file is
+/// dumped on a worker with its own context, and the output buffered in the
+/// context is flushed in input order.
+struct DumpContext {
+  SymbolListT SymbolList;
+  StringRef CurrentFilename;
+  std::string Out, Err;
+  raw_string_ostream OutOS{Out};
+  raw_string_ostream ErrOS{Err};
+};
+} // anonymous namespace
+
+static DumpContext SerialContext;
+static LLVM_THREAD_LOCAL DumpContext *WorkerContext = nullptr;
+
+static DumpContext &context() {
+  return WorkerContext ? *WorkerContext : SerialContext;
+}
+
+static raw_ostream &out() {
+  return WorkerContext ? WorkerContext->OutOS : outs();
+}
+
+static raw_ostream &err() {
+  return WorkerContext ? WorkerContext->ErrOS : errs();
+}
 
 static char getSymbolNMTypeChar(IRObjectFile &Obj, basic_symbol_iterator I);
 
@@ -404,31 +443,31 @@ static void darwinPrintSymbol(SymbolicFile &Obj, SymbolListT::iterator I,
   if (FormatMachOasHex) {
     char Str[18] = "";
     format(printFormat, NValue).print(Str, sizeof(Str));
-    outs() << Str << ' ';
+    out() << Str << ' ';
     format("%02x", NType).print(Str, sizeof(Str));
-    outs() << Str << ' ';
+    out() << Str << ' ';
     format("%02x", NSect).print(Str, sizeof(Str));
-    outs() << Str << ' ';
+    out() << Str << ' ';
     format("%04x", NDesc).print(Str, sizeof(Str));
-    outs() << Str << ' ';
+    out() << Str << ' ';
     format("%08x", NStrx).print(Str, sizeof(Str));
-    outs() << Str << ' ';
-    outs() << I->Name;
+    out() << Str << ' ';
+    out() << I->Name;
     if ((NType & MachO::N_TYPE) == MachO::N_INDR) {
-      outs() << " (indirect for ";
+      out() << " (indirect for ";
       format(printFormat, NValue).print(Str, sizeof(Str));
-      outs() << Str << ' ';
+      out() << Str << ' ';
       StringRef IndirectName;
       if (I->Sym.getRawDataRefImpl().p) {
         if (MachO->getIndirectName(I->Sym.getRawDataRefImpl(), IndirectName))
-          outs() << "?)";
+          out() << "?)";
         else
-          outs() << IndirectName << ")";
+          out() << IndirectName << ")";
       }
       else
-        outs() << I->IndirectName << ")";
+        out() << I->IndirectName << ")";
     }
-    outs() << "\n";
+    out() << "\n";
     return;
   }
 
@@ -437,51 +476,51 @@ static void darwinPrintSymbol(SymbolicFile &Obj, SymbolListT::iterator I,
       strcpy(SymbolAddrStr, printBlanks);
     if (Obj.isIR() && (NType & MachO::N_TYPE) == MachO::N_TYPE)
       strcpy(SymbolAddrStr, printDashes);
-    outs() << SymbolAddrStr << ' ';
+    out() << SymbolAddrStr << ' ';
   }
 
   switch (NType & MachO::N_TYPE) {
   case MachO::N_UNDF:
     if (NValue != 0) {
-      outs() << "(common) ";
+      out() << "(common) ";
       if (MachO::GET_COMM_ALIGN(NDesc) != 0)
-        outs() << "(alignment 2^" << (int)MachO::GET_COMM_ALIGN(NDesc) << ") ";
+        out() << "(alignment 2^" << (int)MachO::GET_COMM_ALIGN(NDesc) << ") ";
     } else {
       if ((NType & MachO::N_TYPE) == MachO::N_PBUD)
-        outs() << "(prebound ";
+        out() << "(prebound ";
       else
-        outs() << "(";
+        out() << "(";
       if ((NDesc & MachO::REFERENCE_TYPE) ==
           MachO::REFERENCE_FLAG_UNDEFINED_LAZY)
-        outs() << "undefined [lazy bound]) ";
+        out() << "undefined [lazy bound]) ";
       else if ((NDesc & MachO::REFERENCE_TYPE) ==
                MachO::REFERENCE_FLAG_PRIVATE_UNDEFINED_LAZY)
-        outs() << "undefined [private lazy bound]) ";
+        out() << "undefined [private lazy bound]) ";
       else if ((NDesc & MachO::REFERENCE_TYPE) ==
                MachO::REFERENCE_FLAG_PRIVATE_UNDEFINED_NON_LAZY)
-        outs() << "undefined [private]) ";
+        out() << "undefined [private]) ";
       else
-        outs() << "undefined) ";
+        out() << "undefined) ";
     }
     break;
   case MachO::N_ABS:
-    outs() << "(absolute) ";
+    out() << "(absolute) ";
     break;
   case MachO::N_INDR:
-    outs() << "(indirect) ";
+    out() << "(indirect) ";
     break;
   case MachO::N_SECT: {
     if (Obj.isIR()) {
       // For llvm bitcode files print out a fake section name using the values
       // use 1, 2 and 3 for section numbers as set above.
       if (NSect == 1)
-        outs() << "(LTO,CODE) ";
+        out() << "(LTO,CODE) ";
       else if (NSect == 2)
-        outs() << "(LTO,DATA) ";
+        out() << "(LTO,DATA) ";
       else if (NSect == 3)
-        outs() << "(LTO,RODATA) ";
+        out() << "(LTO,RODATA) ";
       else
-        outs() << "(?,?) ";
+        out() << "(?,?) ";
       break;
     }
     section_iterator Sec = SectionRef();
@@ -490,12 +529,12 @@ static void darwinPrintSymbol(SymbolicFile &Obj, SymbolListT::iterator I,
         MachO->getSymbolSection(I->Sym.getRawDataRefImpl());
       if (!SecOrErr) {
         consumeError(SecOrErr.takeError());
-        outs() << "(?,?) ";
+        out() << "(?,?) ";
         break;
       }
       Sec = *SecOrErr;
       if (Sec == MachO->section_end()) {
-        outs() << "(?,?) ";
+        out() << "(?,?) ";
         break;
       }
     } else {
@@ -505,73 +544,73 @@ static void darwinPrintSymbol(SymbolicFile &Obj, SymbolListT::iterator I,
     StringRef SectionName;
     MachO->getSectionName(Ref, SectionName);
     StringRef SegmentName = MachO->getSectionFinalSegmentName(Ref);
-    outs() << "(" << SegmentName << "," << SectionName << ") ";
+    out() << "(" << SegmentName << "," << SectionName << ") ";
     break;
   }
   default:
-    outs() << "(?) ";
+    out() << "(?) ";
     break;
   }
 
   if (NType & MachO::N_EXT) {
     if (NDesc & MachO::REFERENCED_DYNAMICALLY)
-      outs() << "[referenced dynamically] ";
+      out() << "[referenced dynamically] ";
     if (NType & MachO::N_PEXT) {
       if ((NDesc & MachO::N_WEAK_DEF) == MachO::N_WEAK_DEF)
-        outs() << "weak private external ";
+        out() << "weak private external ";
       else
-        outs() << "private external ";
+        out() << "private external ";
     } else {
       if ((NDesc & MachO::N_WEAK_REF) == MachO::N_WEAK_REF ||
           (NDesc & MachO::N_WEAK_DEF) == MachO::N_WEAK_DEF) {
         if ((NDesc & (MachO::N_WEAK_REF | MachO::N_WEAK_DEF)) ==
             (MachO::N_WEAK_REF | MachO::N_WEAK_DEF))
-          outs() << "weak external automatically hidden ";
+          out() << "weak external automatically hidden ";
         else
-          outs() << "weak external ";
+          out() << "weak external ";
       } else
-        outs() << "external ";
+        out() << "external ";
     }
   } else {
     if (NType & MachO::N_PEXT)
-      outs() << "non-external (was a private external) ";
+      out() << "non-external (was a private external) ";
     else
-      outs() << "non-external ";
+      out() << "non-external ";
   }
 
   if (Filetype == MachO::MH_OBJECT &&
       (NDesc & MachO::N_NO_DEAD_STRIP) == MachO::N_NO_DEAD_STRIP)
-    outs() << "[no dead strip] ";
+    out() << "[no dead strip] ";
 
   if (Filetype == MachO::MH_OBJECT &&
       ((NType & MachO::N_TYPE) != MachO::N_UNDF) &&
       (NDesc & MachO::N_SYMBOL_RESOLVER) == MachO::N_SYMBOL_RESOLVER)
-    outs() << "[symbol resolver] ";
+    out() << "[symbol resolver] ";
 
   if (Filetype == MachO::MH_OBJECT &&
       ((NType & MachO::N_TYPE) != MachO::N_UNDF) &&
       (NDesc & MachO::N_ALT_ENTRY) == MachO::N_ALT_ENTRY)
-    outs() << "[alt entry] ";
+    out() << "[alt entry] ";
 
   if ((NDesc & MachO::N_ARM_THUMB_DEF) == MachO::N_ARM_THUMB_DEF)
-    outs() << "[Thumb] ";
+    out() << "[Thumb] ";
 
   if ((NType & MachO::N_TYPE) == MachO::N_INDR) {
-    outs() << I->Name << " (for ";
+    out() << I->Name << " (for ";
     StringRef IndirectName;
     if (MachO) {
       if (I->Sym.getRawDataRefImpl().p) {
         if (MachO->getIndirectName(I->Sym.getRawDataRefImpl(), IndirectName))
-          outs() << "?)";
+          out() << "?)";
         else
-          outs() << IndirectName << ")";
+          out() << IndirectName << ")";
       }
       else
-        outs() << I->IndirectName << ")";
+        out() << I->IndirectName << ")";
     } else
-      outs() << "?)";
+      out() << "?)";
   } else
-    outs() << I->Name;
+    out() << I->Name;
 
   if ((Flags & MachO::MH_TWOLEVEL) == MachO::MH_TWOLEVEL &&
       (((NType & MachO::N_TYPE) == MachO::N_UNDF && NValue == 0) ||
@@ -579,21 +618,21 @@ static void darwinPrintSymbol(SymbolicFile &Obj, SymbolListT::iterator I,
     uint32_t LibraryOrdinal = MachO::GET_LIBRARY_ORDINAL(NDesc);
     if (LibraryOrdinal != 0) {
       if (LibraryOrdinal == MachO::EXECUTABLE_ORDINAL)
-        outs() << " (from executable)";
+        out() << " (from executable)";
       else if (LibraryOrdinal == MachO::DYNAMIC_LOOKUP_ORDINAL)
-        outs() << " (dynamically looked up)";
+        out() << " (dynamically looked up)";
       else {
         StringRef LibraryName;
         if (!MachO ||
             MachO->getLibraryShortNameByIndex(LibraryOrdinal - 1, LibraryName))
-          outs() << " (from bad library ordinal " << LibraryOrdinal << ")";
+          out() << " (from bad library ordinal " << LibraryOrdinal << ")";
         else
-          outs() << " (from " << LibraryName << ")";
+          out() << " (from " << LibraryName << ")";
       }
     }
   }
 
-  outs() << "\n";
+  out() << "\n";
 }
 
 // Table that maps Darwin's Mach-O stab constants to strings to allow printing.
@@ -666,14 +705,14 @@ static void darwinPrintStab(MachOObjectFile *MachO, SymbolListT::iterator I) {
 
   char Str[18] = "";
   format("%02x", NSect).print(Str, sizeof(Str));
-  outs() << ' ' << Str << ' ';
+  out() << ' ' << Str << ' ';
   format("%04x", NDesc).print(Str, sizeof(Str));
-  outs() << Str << ' ';
+  out() << Str << ' ';
   if (const char *stabString = getDarwinStabString(NType))
     format("%5.5s", stabString).print(Str, sizeof(Str));
   else
     format("   %02x", NType).print(Str, sizeof(Str));
-  outs() << Str;
+  out() << Str;
 }
 
 static Optional<std::string> demangle(StringRef Name, bool StripUnderscore) {
@@ -683,15 +722,13 @@ static Optional<std::string> demangle(StringRef Name, bool StripUnderscore) {
   if (!Name.startswith("_Z"))
     return None;
 
-  int Status;
-  char *Undecorated =
-      itaniumDemangle(Name.str().c_str(), nullptr, nullptr, &Status);
-  if (Status != 0)
+  // llvm-nm demangles every symbol it prints, so keep the demangler's memory
+  // from one to the next.
+  static ItaniumDemangleContext Demangler;
+  const char *Undecorated = Demangler.demangle(Name.str().c_str());
+  if (!Undecorated)
     return None;
-
-  std::string S(Undecorated);
-  free(Undecorated);
-  return S;
+  return std::string(Undecorated);
 }
 
 static bool symbolIsDefined(const NMSymbol &Sym) {
@@ -701,6 +738,8 @@ static bool symbolIsDefined(const NMSymbol &Sym) {
 static void sortAndPrintSymbolList(SymbolicFile &Obj, bool printName,
                                    const std::string &ArchiveName,
                                    const std::string &ArchitectureName) {
+  SymbolListT &SymbolList = context().SymbolList;
+  StringRef CurrentFilename = context().CurrentFilename;
   if (!NoSort) {
     std::function<bool(const NMSymbol &, const NMSymbol &)> Cmp;
     if (NumericSort)
@@ -717,17 +756,17 @@ static void sortAndPrintSymbolList(SymbolicFile &Obj, bool printName,
 
   if (!PrintFileName) {
     if (OutputFormat == posix && MultipleFiles && printName) {
-      outs() << '\n' << CurrentFilename << ":\n";
+      out() << '\n' << CurrentFilename << ":\n";
     } else if (OutputFormat == bsd && MultipleFiles && printName) {
-      outs() << "\n" << CurrentFilename << ":\n";
+      out() << "\n" << CurrentFilename << ":\n";
     } else if (OutputFormat == sysv) {
-      outs() << "\n\nSymbols from " << CurrentFilename << ":\n\n";
+      out() << "\n\nSymbols from " << CurrentFilename << ":\n\n";
       if (isSymbolList64Bit(Obj))
-        outs() << "Name                  Value           Class        Type"
-               << "         Size             Line  Section\n";
+        out() << "Name                  Value           Class        Type"
+              << "         Size             Line  Section\n";
       else
-        outs() << "Name                  Value   Class        Type"
-               << "         Size     Line  Section\n";
+        out() << "Name                  Value   Class        Type"
+              << "         Size     Line  Section\n";
     }
   }
 
@@ -774,8 +813,8 @@ static void sortAndPrintSymbolList(SymbolicFile &Obj, bool printName,
 
   if (SymbolList.empty()) {
     if (PrintFileName)
-      writeFileName(errs());
-    errs() << "no symbols\n";
+      writeFileName(err());
+    err() << "no symbols\n";
   }
 
   for (SymbolListT::iterator I = SymbolList.begin(), E = SymbolList.end();
@@ -800,11 +839,11 @@ static void sortAndPrintSymbolList(SymbolicFile &Obj, bool printName,
         (Weak && NoWeakSymbols))
       continue;
     if (PrintFileName)
-      writeFileName(outs());
+      writeFileName(out());
     if ((JustSymbolName ||
          (UndefinedOnly && MachO && OutputFormat != darwin)) &&
         OutputFormat != posix) {
-      outs() << Name << "\n";
+      out() << Name << "\n";
       continue;
     }
 
@@ -845,40 +884,40 @@ static void sortAndPrintSymbolList(SymbolicFile &Obj, bool printName,
       darwinPrintSymbol(Obj, I, SymbolAddrStr, printBlanks, printDashes,
                         printFormat);
     } else if (OutputFormat == posix) {
-      outs() << Name << " " << I->TypeChar << " ";
+      out() << Name << " " << I->TypeChar << " ";
       if (MachO)
-        outs() << SymbolAddrStr << " " << "0" /* SymbolSizeStr */ << "\n";
+        out() << SymbolAddrStr << " " << "0" /* SymbolSizeStr */ << "\n";
       else
-        outs() << SymbolAddrStr << " " << SymbolSizeStr << "\n";
+        out() << SymbolAddrStr << " " << SymbolSizeStr << "\n";
     } else if (OutputFormat == bsd || (OutputFormat == darwin && !MachO)) {
       if (PrintAddress)
-        outs() << SymbolAddrStr << ' ';
+        out() << SymbolAddrStr << ' ';
       if (PrintSize) {
-        outs() << SymbolSizeStr;
-        outs() << ' ';
+        out() << SymbolSizeStr;
+        out() << ' ';
       }
-      outs() << I->TypeChar;
+      out() << I->TypeChar;
       if (I->TypeChar == '-' && MachO)
         darwinPrintStab(MachO, I);
-      outs() << " " << Name;
+      out() << " " << Name;
       if (I->TypeChar == 'I' && MachO) {
-        outs() << " (indirect for ";
+        out() << " (indirect for ";
         if (I->Sym.getRawDataRefImpl().p) {
           StringRef IndirectName;
           if (MachO->getIndirectName(I->Sym.getRawDataRefImpl(), IndirectName))
-            outs() << "?)";
+            out() << "?)";
           else
-            outs() << IndirectName << ")";
+            out() << IndirectName << ")";
         } else
-          outs() << I->IndirectName << ")";
+          out() << I->IndirectName << ")";
       }
-      outs() << "\n";
+      out() << "\n";
     } else if (OutputFormat == sysv) {
       std::string PaddedName(Name);
       while (PaddedName.length() < 20)
         PaddedName += " ";
-      outs() << PaddedName << "|" << SymbolAddrStr << "|   " << I->TypeChar
-             << "  |                  |" << SymbolSizeStr << "|     |\n";
+      out() << PaddedName << "|" << SymbolAddrStr << "|   " << I->TypeChar
+            << "  |                  |" << SymbolSizeStr << "|     |\n";
     }
   }
 
@@ -1146,6 +1185,7 @@ static void
 dumpSymbolNamesFromObject(SymbolicFile &Obj, bool printName,
                           const std::string &ArchiveName = std::string(),
                           const std::string &ArchitectureName = std::string()) {
+  SymbolListT &SymbolList = context().SymbolList;
   auto Symbols = Obj.symbols();
   if (DynamicSyms) {
     const auto *E = dyn_cast<ELFObjectFileBase>(&Obj);
@@ -1169,8 +1209,19 @@ dumpSymbolNamesFromObject(SymbolicFile &Obj, bool printName,
     if (Nsect == 0)
       return;
   }
+  // Read the addresses, sizes and names of ELF symbols in a single pass over
+  // the symbol table.
+  std::vector<ELFSymbolEntry> ELFSymbols;
+  StringRef ELFStringTable;
+  if (const auto *E = dyn_cast<ELFObjectFileBase>(&Obj))
+    if (Error Err = E->readSymbolTable(DynamicSyms, ELFSymbols, ELFStringTable))
+      consumeError(std::move(Err));
+  size_t SymIndex = 0;
   if (!MachO || !DyldInfoOnly) {
     for (BasicSymbolRef Sym : Symbols) {
+      const ELFSymbolEntry *ELFSym =
+          SymIndex < ELFSymbols.size() ? &ELFSymbols[SymIndex] : nullptr;
+      ++SymIndex;
       uint32_t SymFlags = Sym.getFlags();
       if (!DebugSyms && (SymFlags & SymbolRef::SF_FormatSpecific))
         continue;
@@ -1184,11 +1235,13 @@ dumpSymbolNamesFromObject(SymbolicFile &Obj, bool printName,
       NMSymbol S = {};
       S.Size = 0;
       S.Address = 0;
-      if (PrintSize) {
-        if (isa<ELFObjectFileBase>(&Obj))
-          S.Size = ELFSymbolRef(Sym).getSize();
-      }
-      if (PrintAddress && isa<ObjectFile>(Obj)) {
+      if (PrintSize && ELFSym)
+        S.Size = ELFSym->Size;
+      else if (PrintSize && isa<ELFObjectFileBase>(&Obj))
+        S.Size = ELFSymbolRef(Sym).getSize();
+      if (PrintAddress && ELFSym) {
+        S.Address = ELFSym->Address;
+      } else if (PrintAddress && isa<ObjectFile>(Obj)) {
         SymbolRef SymRef(Sym);
         Expected<uint64_t> AddressOrErr = SymRef.getAddress();
         if (!AddressOrErr) {
@@ -1198,11 +1251,17 @@ dumpSymbolNamesFromObject(SymbolicFile &Obj, bool printName,
         S.Address = *AddressOrErr;
       }
       S.TypeChar = getNMTypeChar(Obj, Sym);
-      std::error_code EC = Sym.printName(OS);
-      if (EC && MachO)
-        OS << "bad string index";
-      else
-        error(EC);
+      // Unnamed section symbols take the name of their section.
+      if (ELFSym && ELFSym->NameOffset < ELFStringTable.size() &&
+          (ELFSym->NameOffset != 0 || ELFSym->Type != ELF::STT_SECTION)) {
+        OS << ELFStringTable.data() + ELFSym->NameOffset;
+      } else {
+        std::error_code EC = Sym.printName(OS);
+        if (EC && MachO)
+          OS << "bad string index";
+        else
+          error(EC);
+      }
       OS << '\0';
       S.Sym = Sym;
       SymbolList.push_back(S);
@@ -1688,7 +1747,7 @@ dumpSymbolNamesFromObject(SymbolicFile &Obj, bool printName,
     }
   }
 
-  CurrentFilename = Obj.getFileName();
+  context().CurrentFilename = Obj.getFileName();
   sortAndPrintSymbolList(Obj, printName, ArchiveName, ArchitectureName);
 }
 
@@ -1746,7 +1805,7 @@ static void dumpSymbolNamesFromFile(std::string &Filename) {
       Archive::symbol_iterator I = A->symbol_begin();
       Archive::symbol_iterator E = A->symbol_end();
       if (I != E) {
-        outs() << "Archive map\n";
+        out() << "Archive map\n";
         for (; I != E; ++I) {
           Expected<Archive::Child> C = I->getMember();
           if (!C) {
@@ -1759,9 +1818,9 @@ static void dumpSymbolNamesFromFile(std::string &Filename) {
             break;
           }
           StringRef SymName = I->getName();
-          outs() << SymName << " in " << FileNameOrErr.get() << "\n";
+          out() << SymName << " in " << FileNameOrErr.get() << "\n";
         }
-        outs() << "\n";
+        out() << "\n";
       }
     }
 
@@ -1775,20 +1834,20 @@ static void dumpSymbolNamesFromFile(std::string &Filename) {
           continue;
         }
         if (SymbolicFile *O = dyn_cast<SymbolicFile>(&*ChildOrErr.get())) {
-          if (!MachOPrintSizeWarning && PrintSize &&  isa<MachOObjectFile>(O)) {
-            WithColor::warning(errs(), ToolName)
+          if (PrintSize && isa<MachOObjectFile>(O) &&
+              !MachOPrintSizeWarning.exchange(true)) {
+            WithColor::warning(err(), ToolName)
                 << "sizes with -print-size for Mach-O files are always zero.\n";
-            MachOPrintSizeWarning = true;
           }
           if (!checkMachOAndArchFlags(O, Filename))
             return;
           if (!PrintFileName) {
-            outs() << "\n";
+            out() << "\n";
             if (isa<MachOObjectFile>(O)) {
-              outs() << Filename << "(" << O->getFileName() << ")";
+              out() << Filename << "(" << O->getFileName() << ")";
             } else
-              outs() << O->getFileName();
-            outs() << ":\n";
+              out() << O->getFileName();
+            out() << ":\n";
           }
           dumpSymbolNamesFromObject(*O, false, Filename);
         }
@@ -1822,9 +1881,9 @@ static void dumpSymbolNamesFromFile(std::string &Filename) {
                 if (PrintFileName)
                   ArchitectureName = I->getArchFlagName();
                 else
-                  outs() << "\n" << Obj.getFileName() << " (for architecture "
-                         << I->getArchFlagName() << ")"
-                         << ":\n";
+                  out() << "\n" << Obj.getFileName() << " (for architecture "
+                        << I->getArchFlagName() << ")"
+                        << ":\n";
               }
               dumpSymbolNamesFromObject(Obj, false, ArchiveName,
                                         ArchitectureName);
@@ -1855,13 +1914,13 @@ static void dumpSymbolNamesFromFile(std::string &Filename) {
                     if (ArchFlags.size() > 1)
                       ArchitectureName = I->getArchFlagName();
                   } else {
-                    outs() << "\n" << A->getFileName();
-                    outs() << "(" << O->getFileName() << ")";
+                    out() << "\n" << A->getFileName();
+                    out() << "(" << O->getFileName() << ")";
                     if (ArchFlags.size() > 1) {
-                      outs() << " (for architecture " << I->getArchFlagName()
-                             << ")";
+                      out() << " (for architecture " << I->getArchFlagName()
+                            << ")";
                     }
-                    outs() << ":\n";
+                    out() << ":\n";
                   }
                   dumpSymbolNamesFromObject(*O, false, ArchiveName,
                                             ArchitectureName);
@@ -1922,9 +1981,9 @@ static void dumpSymbolNamesFromFile(std::string &Filename) {
                 if (PrintFileName)
                   ArchiveName = A->getFileName();
                 else
-                  outs() << "\n" << A->getFileName() << "(" << O->getFileName()
-                         << ")"
-                         << ":\n";
+                  out() << "\n" << A->getFileName() << "(" << O->getFileName()
+                        << ")"
+                        << ":\n";
                 dumpSymbolNamesFromObject(*O, false, ArchiveName);
               }
             }
@@ -1959,11 +2018,11 @@ static void dumpSymbolNamesFromFile(std::string &Filename) {
             ArchitectureName = I->getArchFlagName();
         } else {
           if (moreThanOneArch)
-            outs() << "\n";
-          outs() << Obj.getFileName();
+            out() << "\n";
+          out() << Obj.getFileName();
           if (isa<MachOObjectFile>(Obj) && moreThanOneArch)
-            outs() << " (for architecture " << I->getArchFlagName() << ")";
-          outs() << ":\n";
+            out() << " (for architecture " << I->getArchFlagName() << ")";
+          out() << ":\n";
         }
         dumpSymbolNamesFromObject(Obj, false, ArchiveName, ArchitectureName);
       } else if (auto E = isNotObjectErrorInvalidFileType(
@@ -1991,15 +2050,15 @@ static void dumpSymbolNamesFromFile(std::string &Filename) {
               if (isa<MachOObjectFile>(O) && moreThanOneArch)
                 ArchitectureName = I->getArchFlagName();
             } else {
-              outs() << "\n" << A->getFileName();
+              out() << "\n" << A->getFileName();
               if (isa<MachOObjectFile>(O)) {
-                outs() << "(" << O->getFileName() << ")";
+                out() << "(" << O->getFileName() << ")";
                 if (moreThanOneArch)
-                  outs() << " (for architecture " << I->getArchFlagName()
-                         << ")";
+                  out() << " (for architecture " << I->getArchFlagName()
+                        << ")";
               } else
-                outs() << ":" << O->getFileName();
-              outs() << ":\n";
+                out() << ":" << O->getFileName();
+              out() << ":\n";
             }
             dumpSymbolNamesFromObject(*O, false, ArchiveName, ArchitectureName);
           }
@@ -2017,10 +2076,10 @@ static void dumpSymbolNamesFromFile(std::string &Filename) {
     return;
   }
   if (SymbolicFile *O = dyn_cast<SymbolicFile>(&Bin)) {
-    if (!MachOPrintSizeWarning && PrintSize &&  isa<MachOObjectFile>(O)) {
-      WithColor::warning(errs(), ToolName)
+    if (PrintSize && isa<MachOObjectFile>(O) &&
+        !MachOPrintSizeWarning.exchange(true)) {
+      WithColor::warning(err(), ToolName)
           << "sizes with -print-size for Mach-O files are always zero.\n";
-      MachOPrintSizeWarning = true;
     }
     if (!checkMachOAndArchFlags(O, Filename))
       return;
@@ -2028,6 +2087,36 @@ static void dumpSymbolNamesFromFile(std::string &Filename) {
   }
 }
 
+/// Dump all input files. With --threads, the files are dumped concurrently
+/// and the output of each file is written out in input order once it and all
+/// the files before it are done, so it matches the serial output.
+static void dumpInputFiles() {
+  if (Threads == 0 || InputFilenames.size() < 2) {
+    llvm::for_each(InputFilenames, dumpSymbolNamesFromFile);
+    return;
+  }
+
+  std::vector<std::unique_ptr<DumpContext>> Contexts;
+  std::vector<std::shared_future<void>> Done;
+  ThreadPool Pool(Threads);
+  for (std::string &Filename : InputFilenames) {
+    Contexts.push_back(llvm::make_unique<DumpContext>());
+    DumpContext *C = Contexts.back().get();
+    Done.push_back(Pool.async([C, &Filename] {
+      WorkerContext = C;
+      dumpSymbolNamesFromFile(Filename);
+      WorkerContext = nullptr;
+    }));
+  }
+
+  for (size_t I = 0, E = Contexts.size(); I != E; ++I) {
+    Done[I].wait();
+    outs() << Contexts[I]->OutOS.str();
+    errs() << Contexts[I]->ErrOS.str();
+    Contexts[I].reset();
+  }
+}
+
 int main(int argc, char **argv) {
   InitLLVM X(argc, argv);
   cl::ParseCommandLineOptions(argc, argv, "llvm symbol table dumper\n");
@@ -2078,7 +2167,7 @@ int main(int argc, char **argv) {
   if (NoDyldInfo && (AddDyldInfo || DyldInfoOnly))
     error("-no-dyldinfo can't be used with -add-dyldinfo or -dyldinfo-only");
 
-  llvm::for_each(InputFilenames, dumpSymbolNamesFromFile);
+  dumpInputFiles();
 
   if (HadError)
     return 1;
@@ -277,12 +277,18 @@ DriverConfig parseObjcopyOptions(ArrayRef<const char *> ArgsArr) {
               InputArgs.getLastArgValue(OBJCOPY_compress_debug_sections_eq))
               .Case("zlib-gnu", DebugCompressionType::GNU)
               .Case("zlib", DebugCompressionType::Z)
+              .Case("zstd", DebugCompressionType::Zstd)
               .Default(DebugCompressionType::None);
       if (Config.CompressionType == DebugCompressionType::None)
         error("Invalid or unsupported --compress-debug-sections format: " +
               InputArgs.getLastArgValue(OBJCOPY_compress_debug_sections_eq));
-      if (!zlib::isAvailable())
+      if (Config.CompressionType == DebugCompressionType::Zstd) {
+        if (!zstd::isAvailable())
+          error("LLVM was not compiled with LLVM_ENABLE_ZSTD: can not "
+                "compress.");
+      } else if (!zlib::isAvailable()) {
         error("LLVM was not compiled with LLVM_ENABLE_ZLIB: can not compress.");
+      }
     }
   }
 
@@ -325,6 +331,7 @@ DriverConfig parseObjcopyOptions(ArrayRef<const char *> ArgsArr) {
   Config.StripAllGNU = InputArgs.hasArg(OBJCOPY_strip_all_gnu);
   Config.StripDebug = InputArgs.hasArg(OBJCOPY_strip_debug);
   Config.StripDWO = InputArgs.hasArg(OBJCOPY_strip_dwo);
+  Config.FastPath = InputArgs.hasArg(OBJCOPY_fast_path);
   Config.StripSections = InputArgs.hasArg(OBJCOPY_strip_sections);
   Config.StripNonAlloc = InputArgs.hasArg(OBJCOPY_strip_non_alloc);
   Config.StripUnneeded = InputArgs.hasArg(OBJCOPY_strip_unneeded);
@@ -363,7 +370,8 @@ DriverConfig parseObjcopyOptions(ArrayRef<const char *> ArgsArr) {
           "--decompress-debug-sections at the same time");
   }
 
-  if (Config.DecompressDebugSections && !zlib::isAvailable())
+  if (Config.DecompressDebugSections && !zlib::isAvailable() &&
+      !zstd::isAvailable())
     error("LLVM was not compiled with LLVM_ENABLE_ZLIB: cannot decompress.");
 
   DriverConfig DC;
@@ -410,6 +418,7 @@ DriverConfig parseStripOptions(ArrayRef<const char *> ArgsArr) {
 
   CopyConfig Config;
   Config.StripDebug = InputArgs.hasArg(STRIP_strip_debug);
+  Config.FastPath = InputArgs.hasArg(STRIP_fast_path);
 
   Config.DiscardAll = InputArgs.hasArg(STRIP_discard_all);
   Config.StripUnneeded = InputArgs.hasArg(STRIP_strip_unneeded);
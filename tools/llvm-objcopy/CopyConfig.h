@@ -78,6 +78,7 @@ struct CopyConfig {
   bool DeterministicArchives = true;
   bool DiscardAll = false;
   bool ExtractDWO = false;
+  bool FastPath = false;
   bool KeepFileSymbols = false;
   bool LocalizeHidden = false;
   bool OnlyKeepDebug = false;
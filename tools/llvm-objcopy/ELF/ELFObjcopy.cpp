@@ -38,6 +38,7 @@
 #include <algorithm>
 #include <cassert>
 #include <cstdlib>
+#include <cstring>
 #include <functional>
 #include <iterator>
 #include <memory>
@@ -523,6 +524,201 @@ static void handleArgs(const CopyConfig &Config, Object &Obj,
     Obj.addSection<GnuDebugLinkSection>(Config.AddGnuDebugLink);
 }
 
+// The fast path only handles --strip-debug on its own: any other option needs
+// the object model.
+static bool canUseFastPath(const CopyConfig &Config) {
+  return Config.FastPath && Config.StripDebug && Config.OutputFormat.empty() &&
+         Config.AddGnuDebugLink.empty() && Config.BuildIdLinkDir.empty() &&
+         Config.SplitDWO.empty() && Config.SymbolsPrefix.empty() &&
+         Config.AddSection.empty() && Config.DumpSection.empty() &&
+         Config.KeepSection.empty() && Config.OnlySection.empty() &&
+         Config.SymbolsToGlobalize.empty() && Config.SymbolsToKeep.empty() &&
+         Config.SymbolsToLocalize.empty() && Config.SymbolsToRemove.empty() &&
+         Config.SymbolsToWeaken.empty() && Config.ToRemove.empty() &&
+         Config.SymbolsToKeepGlobal.empty() &&
+         Config.SectionsToRename.empty() && Config.SymbolsToRename.empty() &&
+         !Config.DiscardAll && !Config.ExtractDWO && !Config.LocalizeHidden &&
+         !Config.OnlyKeepDebug && !Config.StripAll && !Config.StripAllGNU &&
+         !Config.StripDWO && !Config.StripNonAlloc && !Config.StripSections &&
+         !Config.StripUnneeded && !Config.Weaken &&
+         !Config.DecompressDebugSections &&
+         Config.CompressionType == DebugCompressionType::None;
+}
+
+static bool isDebugSectionName(StringRef Name) {
+  return Name.startswith(".debug") || Name.startswith(".zdebug") ||
+         Name == ".gdb_index";
+}
+
+/// Strip the debug sections of an executable or shared object by copying the
+/// bytes of the input directly into the output buffer. The contents covered by
+/// the program headers are copied as they are, the non-allocated sections that
+/// follow them are packed, and a new section header table is written at the
+/// end. Returns false, without touching \p Out, if the layout of the file needs
+/// the full rewrite: when a debug section lies inside the loaded part of the
+/// file, or when a section or symbol that is kept refers to a section whose
+/// index changes.
+template <class ELFT>
+static bool stripDebugInPlace(const ELFFile<ELFT> &EF, Buffer &Out) {
+  using Elf_Ehdr = typename ELFT::Ehdr;
+  using Elf_Shdr = typename ELFT::Shdr;
+
+  const Elf_Ehdr &Ehdr = *EF.getHeader();
+  if (Ehdr.e_type == ET_REL || Ehdr.e_shnum == 0 ||
+      Ehdr.e_shstrndx == SHN_XINDEX)
+    return false;
+  auto SectionsOrErr = EF.sections();
+  if (!SectionsOrErr) {
+    consumeError(SectionsOrErr.takeError());
+    return false;
+  }
+  ArrayRef<Elf_Shdr> Sections = *SectionsOrErr;
+  size_t NumSections = Sections.size();
+
+  // Find the debug sections and the new index of every section that is kept.
+  std::vector<uint32_t> NewIndex(NumSections, 0);
+  uint32_t FirstRemoved = NumSections;
+  uint32_t NumKept = 1;
+  for (size_t I = 1; I != NumSections; ++I) {
+    const Elf_Shdr &Sec = Sections[I];
+    if (Sec.sh_type == SHT_GROUP || Sec.sh_type == SHT_SYMTAB_SHNDX)
+      return false;
+    auto NameOrErr = EF.getSectionName(&Sec);
+    if (!NameOrErr) {
+      consumeError(NameOrErr.takeError());
+      return false;
+    }
+    if (!(Sec.sh_flags & SHF_ALLOC) && isDebugSectionName(*NameOrErr)) {
+      FirstRemoved = std::min<uint32_t>(FirstRemoved, I);
+      continue;
+    }
+    NewIndex[I] = NumKept++;
+  }
+  if (FirstRemoved == NumSections || FirstRemoved == Ehdr.e_shstrndx)
+    return false;
+
+  auto IsRemoved = [&](uint32_t Index) {
+    return Index != 0 && Index < NumSections && NewIndex[Index] == 0;
+  };
+  for (size_t I = 1; I != NumSections; ++I) {
+    const Elf_Shdr &Sec = Sections[I];
+    if (NewIndex[I] == 0)
+      continue;
+    if (IsRemoved(Sec.sh_link))
+      return false;
+    bool InfoIsIndex = Sec.sh_type == SHT_REL || Sec.sh_type == SHT_RELA ||
+                       (Sec.sh_flags & SHF_INFO_LINK);
+    if (InfoIsIndex && IsRemoved(Sec.sh_info))
+      return false;
+    if (Sec.sh_type != SHT_SYMTAB && Sec.sh_type != SHT_DYNSYM)
+      continue;
+    auto SymbolsOrErr = EF.symbols(&Sec);
+    if (!SymbolsOrErr) {
+      consumeError(SymbolsOrErr.takeError());
+      return false;
+    }
+    for (const auto &Sym : *SymbolsOrErr)
+      if (Sym.st_shndx >= FirstRemoved && Sym.st_shndx < SHN_LORESERVE)
+        return false;
+  }
+
+  // Everything up to the end of the loaded contents is copied as it is.
+  uint64_t PrefixEnd = std::max<uint64_t>(
+      sizeof(Elf_Ehdr), Ehdr.e_phoff + Ehdr.e_phnum * Ehdr.e_phentsize);
+  auto ProgramHeadersOrErr = EF.program_headers();
+  if (!ProgramHeadersOrErr) {
+    consumeError(ProgramHeadersOrErr.takeError());
+    return false;
+  }
+  for (const auto &Phdr : *ProgramHeadersOrErr)
+    PrefixEnd = std::max<uint64_t>(PrefixEnd, Phdr.p_offset + Phdr.p_filesz);
+
+  std::vector<uint32_t> ByOffset;
+  for (size_t I = 1; I != NumSections; ++I) {
+    const Elf_Shdr &Sec = Sections[I];
+    if (Sec.sh_type == SHT_NOBITS || Sec.sh_size == 0)
+      continue;
+    if (Sec.sh_offset + Sec.sh_size > EF.getBufSize())
+      return false;
+    ByOffset.push_back(I);
+  }
+  std::stable_sort(ByOffset.begin(), ByOffset.end(),
+                   [&](uint32_t A, uint32_t B) {
+                     return Sections[A].sh_offset < Sections[B].sh_offset;
+                   });
+  for (uint32_t I : ByOffset) {
+    const Elf_Shdr &Sec = Sections[I];
+    if (NewIndex[I] != 0 &&
+        ((Sec.sh_flags & SHF_ALLOC) || Sec.sh_offset < PrefixEnd))
+      PrefixEnd = std::max<uint64_t>(PrefixEnd, Sec.sh_offset + Sec.sh_size);
+  }
+
+  // Pack the non-allocated sections that follow, then the section headers.
+  std::vector<uint64_t> NewOffset(NumSections, 0);
+  uint64_t Offset = PrefixEnd;
+  for (uint32_t I : ByOffset) {
+    const Elf_Shdr &Sec = Sections[I];
+    if (Sec.sh_offset < PrefixEnd) {
+      if (NewIndex[I] == 0)
+        return false;
+      continue;
+    }
+    if (NewIndex[I] == 0)
+      continue;
+    Offset = alignTo(Offset, std::max<uint64_t>(Sec.sh_addralign, 1));
+    NewOffset[I] = Offset;
+    Offset += Sec.sh_size;
+  }
+  uint64_t SHOffset = alignTo(Offset, sizeof(typename ELFT::Addr));
+  uint64_t Size = SHOffset + NumKept * sizeof(Elf_Shdr);
+  if (PrefixEnd > EF.getBufSize())
+    return false;
+
+  Out.allocate(Size);
+  uint8_t *Buf = Out.getBufferStart();
+  const uint8_t *Src = EF.base();
+  std::memcpy(Buf, Src, PrefixEnd);
+  std::memset(Buf + PrefixEnd, 0, Size - PrefixEnd);
+  Elf_Shdr *Shdrs = reinterpret_cast<Elf_Shdr *>(Buf + SHOffset);
+  Shdrs[0] = Sections[0];
+  for (size_t I = 1; I != NumSections; ++I) {
+    if (NewIndex[I] == 0)
+      continue;
+    const Elf_Shdr &Sec = Sections[I];
+    Elf_Shdr &NewSec = Shdrs[NewIndex[I]];
+    NewSec = Sec;
+    if (NewOffset[I] != 0) {
+      std::memcpy(Buf + NewOffset[I], Src + Sec.sh_offset, Sec.sh_size);
+      NewSec.sh_offset = NewOffset[I];
+    }
+    if (Sec.sh_link < NumSections)
+      NewSec.sh_link = NewIndex[Sec.sh_link];
+    if ((Sec.sh_type == SHT_REL || Sec.sh_type == SHT_RELA ||
+         (Sec.sh_flags & SHF_INFO_LINK)) &&
+        Sec.sh_info < NumSections)
+      NewSec.sh_info = NewIndex[Sec.sh_info];
+  }
+  Elf_Ehdr &NewEhdr = *reinterpret_cast<Elf_Ehdr *>(Buf);
+  NewEhdr.e_shoff = SHOffset;
+  NewEhdr.e_shnum = NumKept;
+  NewEhdr.e_shstrndx = NewIndex[Ehdr.e_shstrndx];
+  if (auto E = Out.commit())
+    reportError(Out.getName(), errorToErrorCode(std::move(E)));
+  return true;
+}
+
+static bool stripDebugInPlace(const ELFObjectFileBase &In, Buffer &Out) {
+  if (auto *O = dyn_cast<ELFObjectFile<ELF32LE>>(&In))
+    return stripDebugInPlace(*O->getELFFile(), Out);
+  if (auto *O = dyn_cast<ELFObjectFile<ELF64LE>>(&In))
+    return stripDebugInPlace(*O->getELFFile(), Out);
+  if (auto *O = dyn_cast<ELFObjectFile<ELF32BE>>(&In))
+    return stripDebugInPlace(*O->getELFFile(), Out);
+  if (auto *O = dyn_cast<ELFObjectFile<ELF64BE>>(&In))
+    return stripDebugInPlace(*O->getELFFile(), Out);
+  llvm_unreachable("Invalid ELFType");
+}
+
 void executeObjcopyOnRawBinary(const CopyConfig &Config, MemoryBuffer &In,
                                Buffer &Out) {
   BinaryReader Reader(Config.BinaryArch, &In);
@@ -538,6 +734,9 @@ void executeObjcopyOnRawBinary(const CopyConfig &Config, MemoryBuffer &In,
 
 void executeObjcopyOnBinary(const CopyConfig &Config,
                             object::ELFObjectFileBase &In, Buffer &Out) {
+  if (canUseFastPath(Config) && stripDebugInPlace(In, Out))
+    return;
+
   ELFReader Reader(&In);
   std::unique_ptr<Object> Obj = Reader.create();
   const ElfType OutputElfType = getOutputElfType(In);
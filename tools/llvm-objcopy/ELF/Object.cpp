@@ -21,6 +21,7 @@
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/FileOutputBuffer.h"
 #include "llvm/Support/Path.h"
+#include "llvm/Support/Threading.h"
 #include <algorithm>
 #include <cstddef>
 #include <cstdint>
@@ -135,12 +136,17 @@ template <class ELFT>
 void ELFSectionWriter<ELFT>::visit(const DecompressedSection &Sec) {
   uint8_t *Buf = Out.getBufferStart() + Sec.Offset;
 
-  if (!zlib::isAvailable()) {
+  const bool IsGnuDebug = isDataGnuCompressed(Sec.OriginalData);
+  const bool IsZstd =
+      !IsGnuDebug &&
+      reinterpret_cast<const Elf_Chdr_Impl<ELFT> *>(Sec.OriginalData.data())
+              ->ch_type == ELF::ELFCOMPRESS_ZSTD;
+  if (IsZstd ? !zstd::isAvailable() : !zlib::isAvailable()) {
     std::copy(Sec.OriginalData.begin(), Sec.OriginalData.end(), Buf);
     return;
   }
 
-  const size_t DataOffset = isDataGnuCompressed(Sec.OriginalData)
+  const size_t DataOffset = IsGnuDebug
                                 ? (ZlibGnuMagic.size() + sizeof(Sec.Size))
                                 : sizeof(Elf_Chdr_Impl<ELFT>);
 
@@ -149,8 +155,12 @@ void ELFSectionWriter<ELFT>::visit(const DecompressedSection &Sec) {
       Sec.OriginalData.size() - DataOffset);
 
   SmallVector<char, 128> DecompressedContent;
-  if (Error E = zlib::uncompress(CompressedContent, DecompressedContent,
-                                 static_cast<size_t>(Sec.Size)))
+  if (Error E = IsZstd ? zstd::uncompress(CompressedContent,
+                                          DecompressedContent,
+                                          static_cast<size_t>(Sec.Size))
+                       : zlib::uncompress(CompressedContent,
+                                          DecompressedContent,
+                                          static_cast<size_t>(Sec.Size)))
     reportError(Sec.Name, std::move(E));
 
   std::copy(DecompressedContent.begin(), DecompressedContent.end(), Buf);
@@ -192,7 +202,9 @@ void ELFSectionWriter<ELFT>::visit(const CompressedSection &Sec) {
     Buf += sizeof(DecompressedSize);
   } else {
     Elf_Chdr_Impl<ELFT> Chdr;
-    Chdr.ch_type = ELF::ELFCOMPRESS_ZLIB;
+    Chdr.ch_type = Sec.CompressionType == DebugCompressionType::Zstd
+                       ? ELF::ELFCOMPRESS_ZSTD
+                       : ELF::ELFCOMPRESS_ZLIB;
     Chdr.ch_size = Sec.DecompressedSize;
     Chdr.ch_addralign = Sec.DecompressedAlign;
     memcpy(Buf, &Chdr, sizeof(Chdr));
@@ -207,15 +219,25 @@ CompressedSection::CompressedSection(const SectionBase &Sec,
     : SectionBase(Sec), CompressionType(CompressionType),
       DecompressedSize(Sec.OriginalData.size()), DecompressedAlign(Sec.Align) {
 
-  if (!zlib::isAvailable()) {
+  const bool IsZstd = CompressionType == DebugCompressionType::Zstd;
+  if (IsZstd ? !zstd::isAvailable() : !zlib::isAvailable()) {
     CompressionType = DebugCompressionType::None;
     return;
   }
 
-  if (Error E = zlib::compress(
-          StringRef(reinterpret_cast<const char *>(OriginalData.data()),
-                    OriginalData.size()),
-          CompressedData))
+  // Large sections are compressed in chunks, in parallel. zstd does this by
+  // itself with its worker threads.
+  const size_t ChunkSize = 1 << 20;
+  StringRef Data(reinterpret_cast<const char *>(OriginalData.data()),
+                 OriginalData.size());
+  const bool IsLarge = Data.size() > ChunkSize;
+  if (Error E =
+          IsZstd ? zstd::compress(Data, CompressedData,
+                                  zstd::DefaultCompression,
+                                  IsLarge ? hardware_concurrency() : 0)
+                 : IsLarge ? zlib::compressInChunks(Data, CompressedData,
+                                                    ChunkSize)
+                           : zlib::compress(Data, CompressedData))
     reportError(Name, std::move(E));
 
   size_t ChdrSize;
@@ -59,11 +59,15 @@
 #include "llvm/Support/StringSaver.h"
 #include "llvm/Support/TargetRegistry.h"
 #include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/ThreadPool.h"
 #include "llvm/Support/WithColor.h"
 #include "llvm/Support/raw_ostream.h"
 #include <algorithm>
 #include <cctype>
 #include <cstring>
+#include <deque>
+#include <future>
+#include <mutex>
 #include <system_error>
 #include <unordered_map>
 #include <utility>
@@ -267,6 +271,12 @@ cl::opt<unsigned long long>
 cl::opt<unsigned long long>
     StopAddress("stop-address", cl::desc("Stop disassembly at address"),
                 cl::value_desc("address"), cl::init(UINT64_MAX));
+
+static cl::opt<unsigned> DisassembleThreads(
+    "disassemble-threads",
+    cl::desc("Number of threads to disassemble each section with. Ignored "
+             "with --source and --line-numbers"),
+    cl::init(1));
 static StringRef ToolName;
 
 typedef std::vector<std::tuple<uint64_t, StringRef, uint8_t>> SectionSymbolsTy;
@@ -1280,6 +1290,51 @@ static void addPltEntries(const ObjectFile *Obj,
   }
 }
 
+namespace {
+/// A disassembler and an instruction printer, with the context that the
+/// disassembler creates its symbols in: everything that is not safe to share
+/// between the threads that disassemble a section.
+struct DisassemblerInstance {
+  MCObjectFileInfo MOFI;
+  MCContext Ctx;
+  std::unique_ptr<MCDisassembler> DisAsm;
+  std::unique_ptr<const MCInstrAnalysis> MIA;
+  std::unique_ptr<MCInstPrinter> IP;
+  SmallString<40> Comments;
+  raw_svector_ostream CommentStream;
+  raw_null_ostream NullStream;
+
+  DisassemblerInstance(const MCAsmInfo *AsmInfo, const MCRegisterInfo *MRI)
+      : Ctx(AsmInfo, MRI, &MOFI), CommentStream(Comments) {}
+};
+} // end anonymous namespace
+
+static std::unique_ptr<DisassemblerInstance>
+createDisassemblerInstance(const ObjectFile *Obj, const Target *TheTarget,
+                           const MCAsmInfo &AsmInfo, const MCRegisterInfo &MRI,
+                           const MCSubtargetInfo &STI,
+                           const MCInstrInfo &MII) {
+  auto D = llvm::make_unique<DisassemblerInstance>(&AsmInfo, &MRI);
+  // FIXME: for now initialize MCObjectFileInfo with default values
+  D->MOFI.InitMCObjectFileInfo(Triple(TripleName), false, D->Ctx);
+
+  D->DisAsm.reset(TheTarget->createMCDisassembler(STI, D->Ctx));
+  if (!D->DisAsm)
+    report_error(Obj->getFileName(), "no disassembler for target " +
+                 TripleName);
+
+  D->MIA.reset(TheTarget->createMCInstrAnalysis(&MII));
+
+  int AsmPrinterVariant = AsmInfo.getAssemblerDialect();
+  D->IP.reset(TheTarget->createMCInstPrinter(
+      Triple(TripleName), AsmPrinterVariant, AsmInfo, MII, MRI));
+  if (!D->IP)
+    report_error(Obj->getFileName(), "no instruction printer for target " +
+                 TripleName);
+  D->IP->setPrintImmHex(PrintImmHex);
+  return D;
+}
+
 static void DisassembleObject(const ObjectFile *Obj, bool InlineRelocs) {
   if (StartAddress > StopAddress)
     error("Start address should be less than stop address");
@@ -1314,27 +1369,18 @@ static void DisassembleObject(const ObjectFile *Obj, bool InlineRelocs) {
   if (!MII)
     report_error(Obj->getFileName(), "no instruction info for target " +
                  TripleName);
-  MCObjectFileInfo MOFI;
-  MCContext Ctx(AsmInfo.get(), MRI.get(), &MOFI);
-  // FIXME: for now initialize MCObjectFileInfo with default values
-  MOFI.InitMCObjectFileInfo(Triple(TripleName), false, Ctx);
 
-  std::unique_ptr<MCDisassembler> DisAsm(
-    TheTarget->createMCDisassembler(*STI, Ctx));
-  if (!DisAsm)
-    report_error(Obj->getFileName(), "no disassembler for target " +
-                 TripleName);
-
-  std::unique_ptr<const MCInstrAnalysis> MIA(
-      TheTarget->createMCInstrAnalysis(MII.get()));
+  // One disassembler for each thread. The source printer keeps the lines it
+  // printed last, so sections with source or line numbers are disassembled
+  // on one thread.
+  unsigned NumThreads = 1;
+  if (!PrintSource && !PrintLines)
+    NumThreads = std::max(1u, unsigned(DisassembleThreads));
+  std::vector<std::unique_ptr<DisassemblerInstance>> Disassemblers;
+  for (unsigned I = 0; I != NumThreads; ++I)
+    Disassemblers.push_back(
+        createDisassemblerInstance(Obj, TheTarget, *AsmInfo, *MRI, *STI, *MII));
 
-  int AsmPrinterVariant = AsmInfo->getAssemblerDialect();
-  std::unique_ptr<MCInstPrinter> IP(TheTarget->createMCInstPrinter(
-      Triple(TripleName), AsmPrinterVariant, *AsmInfo, *MII, *MRI));
-  if (!IP)
-    report_error(Obj->getFileName(), "no instruction printer for target " +
-                 TripleName);
-  IP->setPrintImmHex(PrintImmHex);
   PrettyPrinter &PIP = selectPrettyPrinter(Triple(TripleName));
 
   StringRef Fmt = Obj->getBytesInAddress() > 4 ? "\t\t%016" PRIx64 ":  " :
@@ -1431,6 +1477,7 @@ static void DisassembleObject(const ObjectFile *Obj, bool InlineRelocs) {
   for (std::pair<const SectionRef, SectionSymbolsTy> &SecSyms : AllSymbols)
     array_pod_sort(SecSyms.second.begin(), SecSyms.second.end());
   array_pod_sort(AbsoluteSymbols.begin(), AbsoluteSymbols.end());
+  const SectionSymbolsTy NoSymbols;
 
   for (const SectionRef &Section : ToolSectionFilter(*Obj)) {
     if (!DisassembleAll && (!Section.isText() || Section.isVirtual()))
@@ -1465,13 +1512,16 @@ static void DisassembleObject(const ObjectFile *Obj, bool InlineRelocs) {
 
     if (Obj->isELF() && Obj->getArch() == Triple::amdgcn) {
       // AMDGPU disassembler uses symbolizer for printing labels
-      std::unique_ptr<MCRelocationInfo> RelInfo(
-        TheTarget->createMCRelocationInfo(TripleName, Ctx));
-      if (RelInfo) {
-        std::unique_ptr<MCSymbolizer> Symbolizer(
-          TheTarget->createMCSymbolizer(
-            TripleName, nullptr, nullptr, &Symbols, &Ctx, std::move(RelInfo)));
-        DisAsm->setSymbolizer(std::move(Symbolizer));
+      for (auto &D : Disassemblers) {
+        std::unique_ptr<MCRelocationInfo> RelInfo(
+          TheTarget->createMCRelocationInfo(TripleName, D->Ctx));
+        if (RelInfo) {
+          std::unique_ptr<MCSymbolizer> Symbolizer(
+            TheTarget->createMCSymbolizer(TripleName, nullptr, nullptr,
+                                          &Symbols, &D->Ctx,
+                                          std::move(RelInfo)));
+          D->DisAsm->setSymbolizer(std::move(Symbolizer));
+        }
       }
     }
 
@@ -1504,21 +1554,19 @@ static void DisassembleObject(const ObjectFile *Obj, bool InlineRelocs) {
                           Section.isText() ? ELF::STT_FUNC : ELF::STT_OBJECT));
     }
 
-    SmallString<40> Comments;
-    raw_svector_ostream CommentStream(Comments);
-
     StringRef BytesStr;
     error(Section.getContents(BytesStr));
     ArrayRef<uint8_t> Bytes(reinterpret_cast<const uint8_t *>(BytesStr.data()),
                             BytesStr.size());
 
-    uint64_t Size;
-    uint64_t Index;
     bool PrintedSection = false;
 
-    std::vector<RelocationRef>::const_iterator rel_cur = Rels.begin();
-    std::vector<RelocationRef>::const_iterator rel_end = Rels.end();
-    // Disassemble symbol by symbol.
+    // The symbols to disassemble, with their ranges in the section.
+    struct SymbolRange {
+      unsigned Index;
+      uint64_t Start, End;
+    };
+    std::vector<SymbolRange> Ranges;
     for (unsigned si = 0, se = Symbols.size(); si != se; ++si) {
       uint64_t Start = std::get<0>(Symbols[si]) - SectionAddr;
       // The end is either the section end or the beginning of the next
@@ -1573,8 +1621,48 @@ static void DisassembleObject(const ObjectFile *Obj, bool InlineRelocs) {
         }
       }
 
-      auto PrintSymbol = [](StringRef Name) {
-        outs() << '\n' << Name << ":\n";
+      Ranges.push_back({si, Start, End});
+    }
+
+    std::vector<RelocationRef>::const_iterator rel_cur = Rels.begin();
+    std::vector<RelocationRef>::const_iterator rel_end = Rels.end();
+    // Print the relocations that precede the end of the last instruction,
+    // \p InstEnd.
+    auto PrintRelocations = [&](raw_ostream &OS, uint64_t InstEnd) {
+      // Hexagon does this in pretty printer
+      if (Obj->getArch() == Triple::hexagon)
+        return;
+      // Print relocation for instruction.
+      while (rel_cur != rel_end) {
+        bool hidden = getHidden(*rel_cur);
+        uint64_t addr = rel_cur->getOffset();
+        SmallString<16> name;
+        SmallString<32> val;
+
+        // If this relocation is hidden, skip it.
+        if (hidden || ((SectionAddr + addr) < StartAddress)) {
+          ++rel_cur;
+          continue;
+        }
+
+        // Stop when rel_cur's address is past the current instruction.
+        if (addr >= InstEnd) break;
+        rel_cur->getTypeName(name);
+        error(getRelocationValueString(*rel_cur, val));
+        OS << format(Fmt.data(), SectionAddr + addr) << name
+           << "\t" << val << "\n";
+        ++rel_cur;
+      }
+    };
+
+    // Disassemble the symbol Symbols[si], from Start to End, to \p OS with
+    // \p D, calling \p InstDone with the end of each instruction after it is
+    // printed.
+    auto DisassembleSymbol = [&](unsigned si, uint64_t Start, uint64_t End,
+                                 DisassemblerInstance &D, raw_ostream &OS,
+                                 function_ref<void(uint64_t)> InstDone) {
+      auto PrintSymbol = [&OS](StringRef Name) {
+        OS << '\n' << Name << ":\n";
       };
       StringRef SymbolName = std::get<1>(Symbols[si]);
       if (Demangle) {
@@ -1601,16 +1689,18 @@ static void DisassembleObject(const ObjectFile *Obj, bool InlineRelocs) {
       // Don't print raw contents of a virtual section. A virtual section
       // doesn't have any contents in the file.
       if (Section.isVirtual()) {
-        outs() << "...\n";
-        continue;
+        OS << "...\n";
+        return;
       }
 
 #ifndef NDEBUG
-      raw_ostream &DebugOut = DebugFlag ? dbgs() : nulls();
+      raw_ostream &DebugOut = DebugFlag ? dbgs() : D.NullStream;
 #else
-      raw_ostream &DebugOut = nulls();
+      raw_ostream &DebugOut = D.NullStream;
 #endif
 
+      uint64_t Size;
+      uint64_t Index;
       for (Index = Start; Index < End; Index += Size) {
         MCInst Inst;
 
@@ -1633,12 +1723,12 @@ static void DisassembleObject(const ObjectFile *Obj, bool InlineRelocs) {
           if (DAI != DataMappingSymsAddr.end() && *DAI == Index) {
             // Switch to data.
             while (Index < End) {
-              outs() << format("%8" PRIx64 ":", SectionAddr + Index);
-              outs() << "\t";
+              OS << format("%8" PRIx64 ":", SectionAddr + Index);
+              OS << "\t";
               if (Index + 4 <= End) {
                 Stride = 4;
-                dumpBytes(Bytes.slice(Index, 4), outs());
-                outs() << "\t.word\t";
+                dumpBytes(Bytes.slice(Index, 4), OS);
+                OS << "\t.word\t";
                 uint32_t Data = 0;
                 if (Obj->isLittleEndian()) {
                   const auto Word =
@@ -1650,11 +1740,11 @@ static void DisassembleObject(const ObjectFile *Obj, bool InlineRelocs) {
                       Bytes.data() + Index);
                   Data = *Word;
                 }
-                outs() << "0x" << format("%08" PRIx32, Data);
+                OS << "0x" << format("%08" PRIx32, Data);
               } else if (Index + 2 <= End) {
                 Stride = 2;
-                dumpBytes(Bytes.slice(Index, 2), outs());
-                outs() << "\t\t.short\t";
+                dumpBytes(Bytes.slice(Index, 2), OS);
+                OS << "\t\t.short\t";
                 uint16_t Data = 0;
                 if (Obj->isLittleEndian()) {
                   const auto Short =
@@ -1667,15 +1757,15 @@ static void DisassembleObject(const ObjectFile *Obj, bool InlineRelocs) {
                                                                   Index);
                   Data = *Short;
                 }
-                outs() << "0x" << format("%04" PRIx16, Data);
+                OS << "0x" << format("%04" PRIx16, Data);
               } else {
                 Stride = 1;
-                dumpBytes(Bytes.slice(Index, 1), outs());
-                outs() << "\t\t.byte\t";
-                outs() << "0x" << format("%02" PRIx8, Bytes.slice(Index, 1)[0]);
+                dumpBytes(Bytes.slice(Index, 1), OS);
+                OS << "\t\t.byte\t";
+                OS << "0x" << format("%02" PRIx8, Bytes.slice(Index, 1)[0]);
               }
               Index += Stride;
-              outs() << "\n";
+              OS << "\n";
               auto TAI = std::lower_bound(TextMappingSymsAddr.begin(),
                                           TextMappingSymsAddr.end(), Index);
               if (TAI != TextMappingSymsAddr.end() && *TAI == Index)
@@ -1700,11 +1790,11 @@ static void DisassembleObject(const ObjectFile *Obj, bool InlineRelocs) {
                 ((SectionAddr + Index) > StopAddress))
               continue;
             if (NumBytes == 0) {
-              outs() << format("%8" PRIx64 ":", SectionAddr + Index);
-              outs() << "\t";
+              OS << format("%8" PRIx64 ":", SectionAddr + Index);
+              OS << "\t";
             }
             Byte = Bytes.slice(Index)[0];
-            outs() << format(" %02x", Byte);
+            OS << format(" %02x", Byte);
             AsciiData[NumBytes] = isPrint(Byte) ? Byte : '.';
 
             uint8_t IndentOffset = 0;
@@ -1719,9 +1809,9 @@ static void DisassembleObject(const ObjectFile *Obj, bool InlineRelocs) {
             }
             if (NumBytes == 8) {
               AsciiData[8] = '\0';
-              outs() << std::string(IndentOffset, ' ') << "         ";
-              outs() << reinterpret_cast<char *>(AsciiData);
-              outs() << '\n';
+              OS << std::string(IndentOffset, ' ') << "         ";
+              OS << reinterpret_cast<char *>(AsciiData);
+              OS << '\n';
               NumBytes = 0;
             }
           }
@@ -1731,24 +1821,25 @@ static void DisassembleObject(const ObjectFile *Obj, bool InlineRelocs) {
 
         // Disassemble a real instruction or a data when disassemble all is
         // provided
-        bool Disassembled = DisAsm->getInstruction(Inst, Size, Bytes.slice(Index),
-                                                   SectionAddr + Index, DebugOut,
-                                                   CommentStream);
+        bool Disassembled = D.DisAsm->getInstruction(
+            Inst, Size, Bytes.slice(Index), SectionAddr + Index, DebugOut,
+            D.CommentStream);
         if (Size == 0)
           Size = 1;
 
-        PIP.printInst(*IP, Disassembled ? &Inst : nullptr,
-                      Bytes.slice(Index, Size), SectionAddr + Index, outs(), "",
+        PIP.printInst(*D.IP, Disassembled ? &Inst : nullptr,
+                      Bytes.slice(Index, Size), SectionAddr + Index, OS, "",
                       *STI, &SP, &Rels);
-        outs() << CommentStream.str();
-        Comments.clear();
+        OS << D.CommentStream.str();
+        D.Comments.clear();
 
         // Try to resolve the target of a call, tail call, etc. to a specific
         // symbol.
-        if (MIA && (MIA->isCall(Inst) || MIA->isUnconditionalBranch(Inst) ||
-                    MIA->isConditionalBranch(Inst))) {
+        if (D.MIA &&
+            (D.MIA->isCall(Inst) || D.MIA->isUnconditionalBranch(Inst) ||
+             D.MIA->isConditionalBranch(Inst))) {
           uint64_t Target;
-          if (MIA->evaluateBranch(Inst, SectionAddr + Index, Size, Target)) {
+          if (D.MIA->evaluateBranch(Inst, SectionAddr + Index, Size, Target)) {
             // In a relocatable object, the target's section must reside in
             // the same section as the call instruction or it is accessed
             // through a relocation.
@@ -1756,7 +1847,7 @@ static void DisassembleObject(const ObjectFile *Obj, bool InlineRelocs) {
             // In a non-relocatable object, the target may be in any section.
             //
             // N.B. We don't walk the relocations in the relocatable case yet.
-            auto *TargetSectionSymbols = &Symbols;
+            const SectionSymbolsTy *TargetSectionSymbols = &Symbols;
             if (!Obj->isRelocatableObject()) {
               auto SectionAddress = std::upper_bound(
                   SectionAddresses.begin(), SectionAddresses.end(), Target,
@@ -1766,7 +1857,9 @@ static void DisassembleObject(const ObjectFile *Obj, bool InlineRelocs) {
                   });
               if (SectionAddress != SectionAddresses.begin()) {
                 --SectionAddress;
-                TargetSectionSymbols = &AllSymbols[SectionAddress->second];
+                auto SecSyms = AllSymbols.find(SectionAddress->second);
+                TargetSectionSymbols =
+                    SecSyms != AllSymbols.end() ? &SecSyms->second : &NoSymbols;
               } else {
                 TargetSectionSymbols = &AbsoluteSymbols;
               }
@@ -1794,40 +1887,89 @@ static void DisassembleObject(const ObjectFile *Obj, bool InlineRelocs) {
               --TargetSym;
               uint64_t TargetAddress = std::get<0>(*TargetSym);
               StringRef TargetName = std::get<1>(*TargetSym);
-              outs() << " <" << TargetName;
+              OS << " <" << TargetName;
               uint64_t Disp = Target - TargetAddress;
               if (Disp)
-                outs() << "+0x" << Twine::utohexstr(Disp);
-              outs() << '>';
+                OS << "+0x" << Twine::utohexstr(Disp);
+              OS << '>';
             }
           }
         }
-        outs() << "\n";
-
-        // Hexagon does this in pretty printer
-        if (Obj->getArch() != Triple::hexagon)
-          // Print relocation for instruction.
-          while (rel_cur != rel_end) {
-            bool hidden = getHidden(*rel_cur);
-            uint64_t addr = rel_cur->getOffset();
-            SmallString<16> name;
-            SmallString<32> val;
-
-            // If this relocation is hidden, skip it.
-            if (hidden || ((SectionAddr + addr) < StartAddress)) {
-              ++rel_cur;
-              continue;
-            }
+        OS << "\n";
+        InstDone(Index + Size);
+      }
+    };
 
-            // Stop when rel_cur's address is past the current instruction.
-            if (addr >= Index + Size) break;
-            rel_cur->getTypeName(name);
-            error(getRelocationValueString(*rel_cur, val));
-            outs() << format(Fmt.data(), SectionAddr + addr) << name
-                   << "\t" << val << "\n";
-            ++rel_cur;
-          }
+    if (Disassemblers.size() == 1 || Ranges.size() <= 1) {
+      for (const SymbolRange &R : Ranges)
+        DisassembleSymbol(R.Index, R.Start, R.End, *Disassemblers[0], outs(),
+                          [&](uint64_t InstEnd) {
+                            PrintRelocations(outs(), InstEnd);
+                          });
+      continue;
+    }
+
+    // Otherwise, disassemble runs of symbols of about the same size on the
+    // threads, each run with a free disassembler, and print their output in
+    // order. The relocations are printed in between here, since they too are
+    // printed in order.
+    struct RunOutput {
+      std::string Text;
+      // The end of each instruction and the size of the text at that point.
+      std::vector<std::pair<uint64_t, size_t>> InstEnds;
+      std::shared_future<void> Done;
+    };
+    uint64_t TotalSize = 0;
+    for (const SymbolRange &R : Ranges)
+      TotalSize += R.End - R.Start;
+    uint64_t RunSize =
+        std::max<uint64_t>(TotalSize / (Disassemblers.size() * 16), 1);
+
+    std::mutex FreeDisassemblersMutex;
+    std::vector<DisassemblerInstance *> FreeDisassemblers;
+    for (auto &D : Disassemblers)
+      FreeDisassemblers.push_back(D.get());
+
+    std::deque<RunOutput> Runs;
+    ThreadPool Pool(Disassemblers.size());
+    for (size_t First = 0, E = Ranges.size(); First != E;) {
+      size_t Last = First;
+      for (uint64_t Size = 0; Last != E && Size < RunSize; ++Last)
+        Size += Ranges[Last].End - Ranges[Last].Start;
+
+      Runs.emplace_back();
+      RunOutput *Run = &Runs.back();
+      Run->Done = Pool.async([&, First, Last, Run]() {
+        DisassemblerInstance *D;
+        {
+          std::lock_guard<std::mutex> Lock(FreeDisassemblersMutex);
+          D = FreeDisassemblers.back();
+          FreeDisassemblers.pop_back();
+        }
+        raw_string_ostream OS(Run->Text);
+        for (size_t I = First; I != Last; ++I)
+          DisassembleSymbol(Ranges[I].Index, Ranges[I].Start, Ranges[I].End,
+                            *D, OS, [&](uint64_t InstEnd) {
+                              Run->InstEnds.emplace_back(InstEnd, OS.tell());
+                            });
+        OS.flush();
+        std::lock_guard<std::mutex> Lock(FreeDisassemblersMutex);
+        FreeDisassemblers.push_back(D);
+      });
+      First = Last;
+    }
+
+    for (RunOutput &Run : Runs) {
+      Run.Done.wait();
+      StringRef Text = Run.Text;
+      size_t Pos = 0;
+      for (const auto &InstEnd : Run.InstEnds) {
+        outs() << Text.slice(Pos, InstEnd.second);
+        Pos = InstEnd.second;
+        PrintRelocations(outs(), InstEnd.first);
       }
+      outs() << Text.substr(Pos);
+      std::string().swap(Run.Text);
     }
   }
 }
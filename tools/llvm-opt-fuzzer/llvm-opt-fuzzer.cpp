@@ -18,9 +18,12 @@
 #include "llvm/FuzzMutate/IRMutator.h"
 #include "llvm/IR/Verifier.h"
 #include "llvm/Passes/PassBuilder.h"
+#include "llvm/Support/Format.h"
 #include "llvm/Support/SourceMgr.h"
 #include "llvm/Support/TargetRegistry.h"
 #include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/Timer.h"
+#include <cstring>
 
 using namespace llvm;
 
@@ -32,9 +35,75 @@ static cl::opt<std::string> PassPipeline(
     "passes",
     cl::desc("A textual description of the pass pipeline for testing"));
 
+static cl::opt<unsigned> ReuseContext(
+    "reuse-context",
+    cl::desc("Parse up to N inputs into the same LLVMContext, and run the "
+             "module that checked a mutation instead of parsing its output "
+             "again (0 uses a fresh context for every input)"),
+    cl::init(0));
+
+static cl::opt<bool> TimePhases(
+    "time-phases",
+    cl::desc("Time the parsing, mutation, optimization and serialization of "
+             "the inputs, and print a report at exit"));
+
 static std::unique_ptr<IRMutator> Mutator;
 static std::unique_ptr<TargetMachine> TM;
 
+namespace {
+/// The time spent in each phase of running the inputs, for -time-phases.
+struct PhaseTimers {
+  TimerGroup Group{"llvm-opt-fuzzer", "llvm-opt-fuzzer phases"};
+  Timer Parse{"parse", "Parse and verify", Group};
+  Timer Mutate{"mutate", "Mutate", Group};
+  Timer Optimize{"optimize", "Optimize", Group};
+  Timer Serialize{"serialize", "Serialize", Group};
+  double StartTime = TimeRecord::getCurrentTime(true).getWallTime();
+  unsigned NumInputs = 0;
+
+  ~PhaseTimers() {
+    double Elapsed = TimeRecord::getCurrentTime(false).getWallTime() -
+                     StartTime;
+    errs() << "llvm-opt-fuzzer: " << NumInputs << " inputs run, "
+           << format("%.1f", Elapsed > 0 ? NumInputs / Elapsed : 0.0)
+           << " execs/sec\n";
+  }
+};
+} // end anonymous namespace
+
+static std::unique_ptr<PhaseTimers> Timers;
+
+static Timer *getTimer(Timer PhaseTimers::*Phase) {
+  return Timers ? &(Timers.get()->*Phase) : nullptr;
+}
+
+// The context shared by the inputs with -reuse-context, and the number of
+// inputs parsed into it so far.
+static std::unique_ptr<LLVMContext> SharedContext;
+static unsigned SharedContextUses = 0;
+
+// The module the mutator re-read its last output into, with that output.
+static std::unique_ptr<Module> MutatedModule;
+static std::string MutatedBitcode;
+
+/// Returns the context to parse the next input into. Without -reuse-context
+/// this is a new context, which \p Fresh takes ownership of.
+static LLVMContext &getContext(std::unique_ptr<LLVMContext> &Fresh) {
+  if (!ReuseContext) {
+    Fresh = llvm::make_unique<LLVMContext>();
+    return *Fresh;
+  }
+  if (!SharedContext || SharedContextUses == ReuseContext) {
+    // Start over once in a while, so that the types and constants that the
+    // mutations and passes created don't pile up in the context.
+    MutatedModule.reset();
+    SharedContext = llvm::make_unique<LLVMContext>();
+    SharedContextUses = 0;
+  }
+  ++SharedContextUses;
+  return *SharedContext;
+}
+
 std::unique_ptr<IRMutator> createOptMutator() {
   std::vector<TypeGetter> Types{
       Type::getInt1Ty,  Type::getInt8Ty,  Type::getInt16Ty, Type::getInt32Ty,
@@ -56,16 +125,25 @@ extern "C" LLVM_ATTRIBUTE_USED size_t LLVMFuzzerCustomMutator(
   assert(Mutator &&
       "IR mutator should have been created during fuzzer initialization");
 
-  LLVMContext Context;
-  auto M = parseAndVerify(Data, Size, Context);
+  std::unique_ptr<LLVMContext> FreshContext;
+  LLVMContext &Context = getContext(FreshContext);
+  std::unique_ptr<Module> M;
+  {
+    TimeRegion T(getTimer(&PhaseTimers::Parse));
+    M = parseAndVerify(Data, Size, Context);
+  }
   if (!M) {
     errs() << "error: mutator input module is broken!\n";
     return 0;
   }
 
-  Mutator->mutateModule(*M, Seed, Size, MaxSize);
-
-  if (verifyModule(*M, &errs())) {
+  bool Broken;
+  {
+    TimeRegion T(getTimer(&PhaseTimers::Mutate));
+    Mutator->mutateModule(*M, Seed, Size, MaxSize);
+    Broken = verifyModule(*M, &errs());
+  }
+  if (Broken) {
     errs() << "mutation result doesn't pass verification\n";
 #ifndef NDEBUG
     M->dump();
@@ -76,6 +154,7 @@ extern "C" LLVM_ATTRIBUTE_USED size_t LLVMFuzzerCustomMutator(
   
   std::string Buf;
   {
+    TimeRegion T(getTimer(&PhaseTimers::Serialize));
     raw_string_ostream OS(Buf);
     WriteBitcodeToFile(*M, OS);
   }
@@ -88,8 +167,12 @@ extern "C" LLVM_ATTRIBUTE_USED size_t LLVMFuzzerCustomMutator(
   // we want to check for them explicitly. Otherwise we will add incorrect input
   // to the corpus and this is going to confuse the fuzzer which will start 
   // exploration of the bitcode reader error handling code.
-  auto NewM = parseAndVerify(
-      reinterpret_cast<const uint8_t*>(Buf.data()), Buf.size(), Context);
+  std::unique_ptr<Module> NewM;
+  {
+    TimeRegion T(getTimer(&PhaseTimers::Parse));
+    NewM = parseAndVerify(reinterpret_cast<const uint8_t *>(Buf.data()),
+                          Buf.size(), Context);
+  }
   if (!NewM) {
     errs() << "mutator failed to re-read the module\n";
 #ifndef NDEBUG
@@ -98,6 +181,13 @@ extern "C" LLVM_ATTRIBUTE_USED size_t LLVMFuzzerCustomMutator(
     return 0;
   }
 
+  // The fuzzer runs the output next. The module just read from it is what
+  // parsing it again would give, so keep it for that run.
+  if (ReuseContext) {
+    MutatedModule = std::move(NewM);
+    MutatedBitcode = Buf;
+  }
+
   memcpy(Data, Buf.data(), Buf.size());
   return Buf.size();
 }
@@ -112,8 +202,20 @@ extern "C" int LLVMFuzzerTestOneInput(const uint8_t *Data, size_t Size) {
   // Parse module
   //
 
-  LLVMContext Context;
-  auto M = parseAndVerify(Data, Size, Context);
+  if (Timers)
+    ++Timers->NumInputs;
+
+  std::unique_ptr<LLVMContext> FreshContext;
+  std::unique_ptr<Module> M;
+  if (MutatedModule && Size == MutatedBitcode.size() &&
+      memcmp(Data, MutatedBitcode.data(), Size) == 0) {
+    M = std::move(MutatedModule);
+  } else {
+    MutatedModule.reset();
+    LLVMContext &Context = getContext(FreshContext);
+    TimeRegion T(getTimer(&PhaseTimers::Parse));
+    M = parseAndVerify(Data, Size, Context);
+  }
   if (!M) {
     errs() << "error: input module is broken!\n";
     return 0;
@@ -152,10 +254,15 @@ extern "C" int LLVMFuzzerTestOneInput(const uint8_t *Data, size_t Size) {
   // Run passes which we need to test
   //
 
-  MPM.run(*M, MAM);
+  bool Broken;
+  {
+    TimeRegion T(getTimer(&PhaseTimers::Optimize));
+    MPM.run(*M, MAM);
+    Broken = verifyModule(*M, &errs());
+  }
 
   // Check that passes resulted in a correct code
-  if (verifyModule(*M, &errs())) {
+  if (Broken) {
     errs() << "Transformation resulted in an invalid module\n";
     abort();
   }
@@ -246,5 +353,8 @@ extern "C" LLVM_ATTRIBUTE_USED int LLVMFuzzerInitialize(
 
   Mutator = createOptMutator();
 
+  if (TimePhases)
+    Timers = llvm::make_unique<PhaseTimers>();
+
   return 0;
 }
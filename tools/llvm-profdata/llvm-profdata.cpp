@@ -226,7 +226,9 @@ static void loadInput(const WeightedFile &Input, SymbolRemapper *Remapper,
 
   auto Reader = std::move(ReaderOrErr.get());
   bool IsIRProfile = Reader->isIRLevelProfile();
-  if (WC->Writer.setIsIRLevelProfile(IsIRProfile)) {
+  bool HasCSIRProfile = Reader->hasCSIRLevelProfile();
+  if (Error E = WC->Writer.setIsIRLevelProfile(IsIRProfile, HasCSIRProfile)) {
+    consumeError(std::move(E));
     WC->Err = make_error<StringError>(
         "Merge IR generated profile with Clang generated profile.",
         std::error_code());
@@ -279,6 +281,29 @@ static void mergeWriterContexts(WriterContext *Dst, WriterContext *Src) {
   });
 }
 
+/// Merge shard \p Shard of \p NumShards of the writers in \p Srcs into
+/// \p Dst. The shards partition the function names, so all shards are merged
+/// concurrently, and each function is merged in the order of \p Srcs
+/// whatever the thread timing.
+static void mergeWriterShard(WriterContext *Dst,
+                             ArrayRef<InstrProfWriter *> Srcs, unsigned Shard,
+                             unsigned NumShards) {
+  if (Dst->Err)
+    return;
+
+  bool Reported = false;
+  for (InstrProfWriter *Src : Srcs)
+    Dst->Writer.mergeRecordShardFromWriter(*Src, Shard, NumShards,
+                                           [&](Error E) {
+                                             if (Reported) {
+                                               consumeError(std::move(E));
+                                               return;
+                                             }
+                                             Reported = true;
+                                             Dst->Err = std::move(E);
+                                           });
+}
+
 static void mergeInstrProfile(const WeightedFileVector &Inputs,
                               SymbolRemapper *Remapper,
                               StringRef OutputFilename,
@@ -324,23 +349,54 @@ static void mergeInstrProfile(const WeightedFileVector &Inputs,
     }
     Pool.wait();
 
-    // Merge the writer contexts together (~ lg(NumThreads) serial steps).
-    unsigned Mid = Contexts.size() / 2;
-    unsigned End = Contexts.size();
-    assert(Mid > 0 && "Expected more than one context");
-    do {
-      for (unsigned I = 0; I < Mid; ++I)
-        Pool.async(mergeWriterContexts, Contexts[I].get(),
-                   Contexts[I + Mid].get());
-      Pool.wait();
-      if (End & 1) {
-        Pool.async(mergeWriterContexts, Contexts[0].get(),
-                   Contexts[End - 1].get());
-        Pool.wait();
+    // Merge the writer contexts shard by shard, with one shard of function
+    // names per thread (one parallel step, without locking). Contexts with a
+    // hard error are reported below and left out of the output.
+    SmallVector<InstrProfWriter *, 4> Srcs;
+    for (std::unique_ptr<WriterContext> &WC : Contexts)
+      if (!WC->Err)
+        Srcs.push_back(&WC->Writer);
+    SmallVector<std::unique_ptr<WriterContext>, 4> Shards;
+    for (unsigned I = 0; I < NumThreads; ++I)
+      Shards.emplace_back(llvm::make_unique<WriterContext>(
+          OutputSparse, ErrorLock, WriterErrorCodes));
+    for (unsigned I = 0; I < NumThreads; ++I)
+      Pool.async([&, I] {
+        mergeWriterShard(Shards[I].get(), Srcs, I, NumThreads);
+      });
+    Pool.wait();
+
+    // The shards hold disjoint functions, so gathering them into one writer
+    // only moves records. Keep the profile kind of the inputs and diagnose
+    // mixed kinds loaded by different threads.
+    auto Merged = llvm::make_unique<WriterContext>(OutputSparse, ErrorLock,
+                                                   WriterErrorCodes);
+    for (InstrProfWriter *Src : Srcs) {
+      InstrProfWriter::ProfKind Kind = Src->getProfileKind();
+      if (Kind == InstrProfWriter::PF_Unknown)
+        continue;
+      if (Error E = Merged->Writer.setIsIRLevelProfile(
+              Kind != InstrProfWriter::PF_FE,
+              Kind == InstrProfWriter::PF_IRLevelWithCS)) {
+        consumeError(std::move(E));
+        consumeError(std::move(Merged->Err));
+        Merged->Err = make_error<StringError>(
+            "Merge IR generated profile with Clang generated profile.",
+            std::error_code());
+        break;
       }
-      End = Mid;
-      Mid /= 2;
-    } while (Mid > 0);
+    }
+    for (std::unique_ptr<WriterContext> &Shard : Shards) {
+      if (Merged->Err)
+        break;
+      mergeWriterContexts(Merged.get(), Shard.get());
+    }
+
+    // Report the errors of the shards and of the merged writer as well, and
+    // write the merged writer.
+    for (std::unique_ptr<WriterContext> &Shard : Shards)
+      Contexts.push_back(std::move(Shard));
+    Contexts.insert(Contexts.begin(), std::move(Merged));
   }
 
   // Handle deferred hard errors encountered during merging.
@@ -777,7 +833,10 @@ static int showInstrProfile(const std::string &Filename, bool ShowCounts,
     return 0;
   std::unique_ptr<ProfileSummary> PS(Builder.getSummary());
   OS << "Instrumentation level: "
-     << (Reader->isIRLevelProfile() ? "IR" : "Front-end") << "\n";
+     << (Reader->isIRLevelProfile() ? "IR" : "Front-end");
+  if (Reader->hasCSIRLevelProfile())
+    OS << " (with context-sensitive records)";
+  OS << "\n";
   if (ShowAllFunctions || !ShowFunction.empty())
     OS << "Functions shown: " << ShownFunctions << "\n";
   OS << "Total functions: " << PS->getNumFunctions() << "\n";
@@ -25,8 +25,10 @@
 #include "llvm/Support/Format.h"
 #include "llvm/Support/InitLLVM.h"
 #include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/ThreadPool.h"
 #include "llvm/Support/raw_ostream.h"
 #include <algorithm>
+#include <atomic>
 #include <string>
 #include <system_error>
 
@@ -50,10 +52,10 @@ static cl::opt<OutputFormatTy> OutputFormatShort(
 
 static bool BerkeleyHeaderPrinted = false;
 static bool MoreThanOneFile = false;
-static uint64_t TotalObjectText = 0;
-static uint64_t TotalObjectData = 0;
-static uint64_t TotalObjectBss = 0;
-static uint64_t TotalObjectTotal = 0;
+static std::atomic<uint64_t> TotalObjectText(0);
+static std::atomic<uint64_t> TotalObjectData(0);
+static std::atomic<uint64_t> TotalObjectBss(0);
+static std::atomic<uint64_t> TotalObjectTotal(0);
 
 cl::opt<bool>
 DarwinLongFormat("l", cl::desc("When format is darwin, use long format "
@@ -92,28 +94,79 @@ static cl::opt<bool>
 static cl::alias TotalSizesShort("t", cl::desc("Short for --totals"),
                                  cl::aliasopt(TotalSizes));
 
+static cl::opt<unsigned>
+    Threads("threads",
+            cl::desc("Number of input files to process concurrently "
+                     "(0 processes them one at a time)"),
+            cl::init(0));
+
 static cl::list<std::string>
 InputFilenames(cl::Positional, cl::desc("<input files>"), cl::ZeroOrMore);
 
-static bool HadError = false;
+static std::atomic<bool> HadError(false);
 
 static std::string ToolName;
 
+namespace {
+/// The output of an input file processed on a --threads worker. It is
+/// flushed in input order once the file is done.
+struct OutputContext {
+  std::string Out, Err;
+  raw_string_ostream OutOS{Out};
+  raw_string_ostream ErrOS{Err};
+  /// The range of Out that holds the Berkeley header, if one was printed. It
+  /// is dropped if an earlier input printed the header already.
+  bool HeaderPrinted = false;
+  size_t HeaderBegin = 0;
+  size_t HeaderEnd = 0;
+};
+} // end anonymous namespace
+
+static LLVM_THREAD_LOCAL OutputContext *WorkerContext = nullptr;
+
+// The streams that the output and the diagnostics for the current input file
+// are written to.
+static raw_ostream &out() {
+  return WorkerContext ? WorkerContext->OutOS : outs();
+}
+
+static raw_ostream &err() {
+  return WorkerContext ? WorkerContext->ErrOS : errs();
+}
+
+/// Print the Berkeley format \p Header unless it was printed for an earlier
+/// object already.
+static void printBerkeleyHeader(const Twine &Header) {
+  if (OutputContext *C = WorkerContext) {
+    if (C->HeaderPrinted)
+      return;
+    C->HeaderBegin = C->OutOS.str().size();
+    C->OutOS << Header;
+    C->HeaderEnd = C->OutOS.str().size();
+    C->HeaderPrinted = true;
+    return;
+  }
+  if (!BerkeleyHeaderPrinted) {
+    outs() << Header;
+    BerkeleyHeaderPrinted = true;
+  }
+}
+
 /// If ec is not success, print the error and return true.
 static bool error(std::error_code ec) {
   if (!ec)
     return false;
 
   HadError = true;
-  errs() << ToolName << ": error reading file: " << ec.message() << ".\n";
-  errs().flush();
+  err() << ToolName << ": error reading file: " << ec.message() << ".\n";
+  err().flush();
   return true;
 }
 
 static bool error(Twine Message) {
   HadError = true;
-  errs() << ToolName << ": " << Message << ".\n";
-  errs().flush();
+  err() << ToolName << ": " << Message << ".\n";
+  err().flush();
   return true;
 }
 
@@ -123,7 +176,7 @@ static bool error(Twine Message) {
 static void error(llvm::Error E, StringRef FileName, const Archive::Child &C,
                   StringRef ArchitectureName = StringRef()) {
   HadError = true;
-  errs() << ToolName << ": " << FileName;
+  err() << ToolName << ": " << FileName;
 
   Expected<StringRef> NameOrErr = C.getName();
   // TODO: if we have a error getting the name then it would be nice to print
@@ -131,18 +184,18 @@ static void error(llvm::Error E, StringRef FileName, const Archive::Child &C,
   // archive instead of "???" as the name.
   if (!NameOrErr) {
     consumeError(NameOrErr.takeError());
-    errs() << "(" << "???" << ")";
+    err() << "(" << "???" << ")";
   } else
-    errs() << "(" << NameOrErr.get() << ")";
+    err() << "(" << NameOrErr.get() << ")";
 
   if (!ArchitectureName.empty())
-    errs() << " (for architecture " << ArchitectureName << ") ";
+    err() << " (for architecture " << ArchitectureName << ") ";
 
   std::string Buf;
   raw_string_ostream OS(Buf);
   logAllUnhandledErrors(std::move(E), OS);
   OS.flush();
-  errs() << " " << Buf << "\n";
+  err() << " " << Buf << "\n";
 }
 
 // This version of error() prints the file name and which architecture slice it // is from, for example: "foo.o (for architecture i386)" after the ToolName
@@ -151,16 +204,16 @@ static void error(llvm::Error E, StringRef FileName, const Archive::Child &C,
 static void error(llvm::Error E, StringRef FileName,
                   StringRef ArchitectureName = StringRef()) {
   HadError = true;
-  errs() << ToolName << ": " << FileName;
+  err() << ToolName << ": " << FileName;
 
   if (!ArchitectureName.empty())
-    errs() << " (for architecture " << ArchitectureName << ") ";
+    err() << " (for architecture " << ArchitectureName << ") ";
 
   std::string Buf;
   raw_string_ostream OS(Buf);
   logAllUnhandledErrors(std::move(E), OS);
   OS.flush();
-  errs() << " " << Buf << "\n";
+  err() << " " << Buf << "\n";
 }
 
 /// Get the length of the string that represents @p num in Radix including the
@@ -227,61 +280,61 @@ static void printDarwinSectionSizes(MachOObjectFile *MachO) {
   for (const auto &Load : MachO->load_commands()) {
     if (Load.C.cmd == MachO::LC_SEGMENT_64) {
       MachO::segment_command_64 Seg = MachO->getSegment64LoadCommand(Load);
-      outs() << "Segment " << Seg.segname << ": "
-             << format(fmt.str().c_str(), Seg.vmsize);
+      out() << "Segment " << Seg.segname << ": "
+            << format(fmt.str().c_str(), Seg.vmsize);
       if (DarwinLongFormat)
-        outs() << " (vmaddr 0x" << format("%" PRIx64, Seg.vmaddr) << " fileoff "
-               << Seg.fileoff << ")";
-      outs() << "\n";
+        out() << " (vmaddr 0x" << format("%" PRIx64, Seg.vmaddr) << " fileoff "
+              << Seg.fileoff << ")";
+      out() << "\n";
       total += Seg.vmsize;
       uint64_t sec_total = 0;
       for (unsigned J = 0; J < Seg.nsects; ++J) {
         MachO::section_64 Sec = MachO->getSection64(Load, J);
         if (Filetype == MachO::MH_OBJECT)
-          outs() << "\tSection (" << format("%.16s", &Sec.segname) << ", "
-                 << format("%.16s", &Sec.sectname) << "): ";
+          out() << "\tSection (" << format("%.16s", &Sec.segname) << ", "
+                << format("%.16s", &Sec.sectname) << "): ";
         else
-          outs() << "\tSection " << format("%.16s", &Sec.sectname) << ": ";
-        outs() << format(fmt.str().c_str(), Sec.size);
+          out() << "\tSection " << format("%.16s", &Sec.sectname) << ": ";
+        out() << format(fmt.str().c_str(), Sec.size);
         if (DarwinLongFormat)
-          outs() << " (addr 0x" << format("%" PRIx64, Sec.addr) << " offset "
-                 << Sec.offset << ")";
-        outs() << "\n";
+          out() << " (addr 0x" << format("%" PRIx64, Sec.addr) << " offset "
+                << Sec.offset << ")";
+        out() << "\n";
         sec_total += Sec.size;
       }
       if (Seg.nsects != 0)
-        outs() << "\ttotal " << format(fmt.str().c_str(), sec_total) << "\n";
+        out() << "\ttotal " << format(fmt.str().c_str(), sec_total) << "\n";
     } else if (Load.C.cmd == MachO::LC_SEGMENT) {
       MachO::segment_command Seg = MachO->getSegmentLoadCommand(Load);
       uint64_t Seg_vmsize = Seg.vmsize;
-      outs() << "Segment " << Seg.segname << ": "
-             << format(fmt.str().c_str(), Seg_vmsize);
+      out() << "Segment " << Seg.segname << ": "
+            << format(fmt.str().c_str(), Seg_vmsize);
       if (DarwinLongFormat)
-        outs() << " (vmaddr 0x" << format("%" PRIx32, Seg.vmaddr) << " fileoff "
-               << Seg.fileoff << ")";
-      outs() << "\n";
+        out() << " (vmaddr 0x" << format("%" PRIx32, Seg.vmaddr) << " fileoff "
+              << Seg.fileoff << ")";
+      out() << "\n";
       total += Seg.vmsize;
       uint64_t sec_total = 0;
       for (unsigned J = 0; J < Seg.nsects; ++J) {
         MachO::section Sec = MachO->getSection(Load, J);
         if (Filetype == MachO::MH_OBJECT)
-          outs() << "\tSection (" << format("%.16s", &Sec.segname) << ", "
-                 << format("%.16s", &Sec.sectname) << "): ";
+          out() << "\tSection (" << format("%.16s", &Sec.segname) << ", "
+                << format("%.16s", &Sec.sectname) << "): ";
         else
-          outs() << "\tSection " << format("%.16s", &Sec.sectname) << ": ";
+          out() << "\tSection " << format("%.16s", &Sec.sectname) << ": ";
         uint64_t Sec_size = Sec.size;
-        outs() << format(fmt.str().c_str(), Sec_size);
+        out() << format(fmt.str().c_str(), Sec_size);
         if (DarwinLongFormat)
-          outs() << " (addr 0x" << format("%" PRIx32, Sec.addr) << " offset "
-                 << Sec.offset << ")";
-        outs() << "\n";
+          out() << " (addr 0x" << format("%" PRIx32, Sec.addr) << " offset "
+                << Sec.offset << ")";
+        out() << "\n";
         sec_total += Sec.size;
       }
       if (Seg.nsects != 0)
-        outs() << "\ttotal " << format(fmt.str().c_str(), sec_total) << "\n";
+        out() << "\ttotal " << format(fmt.str().c_str(), sec_total) << "\n";
     }
   }
-  outs() << "total " << format(fmt.str().c_str(), total) << "\n";
+  out() << "total " << format(fmt.str().c_str(), total) << "\n";
 }
 
 /// Print the summary sizes of the standard Mach-O segments in @p MachO.
@@ -350,13 +403,10 @@ static void printDarwinSegmentSizes(MachOObjectFile *MachO) {
   }
   uint64_t total = total_text + total_data + total_objc + total_others;
 
-  if (!BerkeleyHeaderPrinted) {
-    outs() << "__TEXT\t__DATA\t__OBJC\tothers\tdec\thex\n";
-    BerkeleyHeaderPrinted = true;
-  }
-  outs() << total_text << "\t" << total_data << "\t" << total_objc << "\t"
-         << total_others << "\t" << total << "\t" << format("%" PRIx64, total)
-         << "\t";
+  printBerkeleyHeader("__TEXT\t__DATA\t__OBJC\tothers\tdec\thex\n");
+  out() << total_text << "\t" << total_data << "\t" << total_objc << "\t"
+        << total_others << "\t" << total << "\t" << format("%" PRIx64, total)
+        << "\t";
 }
 
 /// Print the size of each section in @p Obj.
@@ -410,7 +460,7 @@ static void printObjectSectionSizes(ObjectFile *Obj) {
         << "%" << max_addr_len << "s\n";
 
     // Print header
-    outs() << format(fmt.str().c_str(), static_cast<const char *>("section"),
+    out() << format(fmt.str().c_str(), static_cast<const char *>("section"),
                      static_cast<const char *>("size"),
                      static_cast<const char *>("addr"));
     fmtbuf.clear();
@@ -431,13 +481,13 @@ static void printObjectSectionSizes(ObjectFile *Obj) {
       uint64_t addr = Section.getAddress();
       std::string namestr = name;
 
-      outs() << format(fmt.str().c_str(), namestr.c_str(), size, addr);
+      out() << format(fmt.str().c_str(), namestr.c_str(), size, addr);
     }
 
     if (ELFCommons) {
       uint64_t CommonSize = getCommonSize(Obj);
       total += CommonSize;
-      outs() << format(fmt.str().c_str(), std::string("*COM*").c_str(),
+      out() << format(fmt.str().c_str(), std::string("*COM*").c_str(),
                        CommonSize, static_cast<uint64_t>(0));
     }
 
@@ -445,7 +495,7 @@ static void printObjectSectionSizes(ObjectFile *Obj) {
     fmtbuf.clear();
     fmt << "%-" << max_name_len << "s "
         << "%#" << max_size_len << radix_fmt << "\n";
-    outs() << format(fmt.str().c_str(), static_cast<const char *>("Total"),
+    out() << format(fmt.str().c_str(), static_cast<const char *>("Total"),
                      total);
   } else {
     // The Berkeley format does not display individual section sizes. It
@@ -480,27 +530,24 @@ static void printObjectSectionSizes(ObjectFile *Obj) {
       TotalObjectTotal += total;
     }
 
-    if (!BerkeleyHeaderPrinted) {
-      outs() << "   text\t"
-                "   data\t"
-                "    bss\t"
-                "    "
-             << (Radix == octal ? "oct" : "dec")
-             << "\t"
-                "    hex\t"
-                "filename\n";
-      BerkeleyHeaderPrinted = true;
-    }
+    printBerkeleyHeader(Twine("   text\t"
+                              "   data\t"
+                              "    bss\t"
+                              "    ") +
+                        (Radix == octal ? "oct" : "dec") +
+                        "\t"
+                        "    hex\t"
+                        "filename\n");
 
     // Print result.
     fmt << "%#7" << radix_fmt << "\t"
         << "%#7" << radix_fmt << "\t"
         << "%#7" << radix_fmt << "\t";
-    outs() << format(fmt.str().c_str(), total_text, total_data, total_bss);
+    out() << format(fmt.str().c_str(), total_text, total_data, total_bss);
     fmtbuf.clear();
     fmt << "%7" << (Radix == octal ? PRIo64 : PRIu64) << "\t"
         << "%7" PRIx64 "\t";
-    outs() << format(fmt.str().c_str(), total, total);
+    out() << format(fmt.str().c_str(), total, total);
   }
 }
 
@@ -561,15 +608,15 @@ static void printFileSectionSizes(StringRef file) {
         if (!checkMachOAndArchFlags(o, file))
           return;
         if (OutputFormat == sysv)
-          outs() << o->getFileName() << "   (ex " << a->getFileName() << "):\n";
+          out() << o->getFileName() << "   (ex " << a->getFileName() << "):\n";
         else if (MachO && OutputFormat == darwin)
-          outs() << a->getFileName() << "(" << o->getFileName() << "):\n";
+          out() << a->getFileName() << "(" << o->getFileName() << "):\n";
         printObjectSectionSizes(o);
         if (OutputFormat == berkeley) {
           if (MachO)
-            outs() << a->getFileName() << "(" << o->getFileName() << ")\n";
+            out() << a->getFileName() << "(" << o->getFileName() << ")\n";
           else
-            outs() << o->getFileName() << " (ex " << a->getFileName() << ")\n";
+            out() << o->getFileName() << " (ex " << a->getFileName() << ")\n";
         }
       }
     }
@@ -593,18 +640,18 @@ static void printFileSectionSizes(StringRef file) {
               if (ObjectFile *o = dyn_cast<ObjectFile>(&*UO.get())) {
                 MachOObjectFile *MachO = dyn_cast<MachOObjectFile>(o);
                 if (OutputFormat == sysv)
-                  outs() << o->getFileName() << "  :\n";
+                  out() << o->getFileName() << "  :\n";
                 else if (MachO && OutputFormat == darwin) {
                   if (MoreThanOneFile || ArchFlags.size() > 1)
-                    outs() << o->getFileName() << " (for architecture "
-                           << I->getArchFlagName() << "): \n";
+                    out() << o->getFileName() << " (for architecture "
+                          << I->getArchFlagName() << "): \n";
                 }
                 printObjectSectionSizes(o);
                 if (OutputFormat == berkeley) {
                   if (!MachO || MoreThanOneFile || ArchFlags.size() > 1)
-                    outs() << o->getFileName() << " (for architecture "
-                           << I->getArchFlagName() << ")";
-                  outs() << "\n";
+                    out() << o->getFileName() << " (for architecture "
+                          << I->getArchFlagName() << ")";
+                  out() << "\n";
                 }
               }
             } else if (auto E = isNotObjectErrorInvalidFileType(
@@ -631,25 +678,25 @@ static void printFileSectionSizes(StringRef file) {
                 if (ObjectFile *o = dyn_cast<ObjectFile>(&*ChildOrErr.get())) {
                   MachOObjectFile *MachO = dyn_cast<MachOObjectFile>(o);
                   if (OutputFormat == sysv)
-                    outs() << o->getFileName() << "   (ex " << UA->getFileName()
-                           << "):\n";
+                    out() << o->getFileName() << "   (ex " << UA->getFileName()
+                          << "):\n";
                   else if (MachO && OutputFormat == darwin)
-                    outs() << UA->getFileName() << "(" << o->getFileName()
-                           << ")"
-                           << " (for architecture " << I->getArchFlagName()
-                           << "):\n";
+                    out() << UA->getFileName() << "(" << o->getFileName()
+                          << ")"
+                          << " (for architecture " << I->getArchFlagName()
+                          << "):\n";
                   printObjectSectionSizes(o);
                   if (OutputFormat == berkeley) {
                     if (MachO) {
-                      outs() << UA->getFileName() << "(" << o->getFileName()
-                             << ")";
+                      out() << UA->getFileName() << "(" << o->getFileName()
+                            << ")";
                       if (ArchFlags.size() > 1)
-                        outs() << " (for architecture " << I->getArchFlagName()
-                               << ")";
-                      outs() << "\n";
+                        out() << " (for architecture " << I->getArchFlagName()
+                              << ")";
+                      out() << "\n";
                     } else
-                      outs() << o->getFileName() << " (ex " << UA->getFileName()
-                             << ")\n";
+                      out() << o->getFileName() << " (ex " << UA->getFileName()
+                            << ")\n";
                   }
                 }
               }
@@ -664,8 +711,8 @@ static void printFileSectionSizes(StringRef file) {
           }
         }
         if (!ArchFound) {
-          errs() << ToolName << ": file: " << file
-                 << " does not contain architecture" << ArchFlags[i] << ".\n";
+          err() << ToolName << ": file: " << file
+                << " does not contain architecture" << ArchFlags[i] << ".\n";
           return;
         }
       }
@@ -684,18 +731,18 @@ static void printFileSectionSizes(StringRef file) {
             if (ObjectFile *o = dyn_cast<ObjectFile>(&*UO.get())) {
               MachOObjectFile *MachO = dyn_cast<MachOObjectFile>(o);
               if (OutputFormat == sysv)
-                outs() << o->getFileName() << "  :\n";
+                out() << o->getFileName() << "  :\n";
               else if (MachO && OutputFormat == darwin) {
                 if (MoreThanOneFile)
-                  outs() << o->getFileName() << " (for architecture "
-                         << I->getArchFlagName() << "):\n";
+                  out() << o->getFileName() << " (for architecture "
+                        << I->getArchFlagName() << "):\n";
               }
               printObjectSectionSizes(o);
               if (OutputFormat == berkeley) {
                 if (!MachO || MoreThanOneFile)
-                  outs() << o->getFileName() << " (for architecture "
-                         << I->getArchFlagName() << ")";
-                outs() << "\n";
+                  out() << o->getFileName() << " (for architecture "
+                        << I->getArchFlagName() << ")";
+                out() << "\n";
               }
             }
           } else if (auto E = isNotObjectErrorInvalidFileType(UO.takeError())) {
@@ -718,20 +765,20 @@ static void printFileSectionSizes(StringRef file) {
               if (ObjectFile *o = dyn_cast<ObjectFile>(&*ChildOrErr.get())) {
                 MachOObjectFile *MachO = dyn_cast<MachOObjectFile>(o);
                 if (OutputFormat == sysv)
-                  outs() << o->getFileName() << "   (ex " << UA->getFileName()
-                         << "):\n";
+                  out() << o->getFileName() << "   (ex " << UA->getFileName()
+                        << "):\n";
                 else if (MachO && OutputFormat == darwin)
-                  outs() << UA->getFileName() << "(" << o->getFileName() << ")"
-                         << " (for architecture " << I->getArchFlagName()
-                         << "):\n";
+                  out() << UA->getFileName() << "(" << o->getFileName() << ")"
+                        << " (for architecture " << I->getArchFlagName()
+                        << "):\n";
                 printObjectSectionSizes(o);
                 if (OutputFormat == berkeley) {
                   if (MachO)
-                    outs() << UA->getFileName() << "(" << o->getFileName()
-                           << ")\n";
+                    out() << UA->getFileName() << "(" << o->getFileName()
+                          << ")\n";
                   else
-                    outs() << o->getFileName() << " (ex " << UA->getFileName()
-                           << ")\n";
+                    out() << o->getFileName() << " (ex " << UA->getFileName()
+                          << ")\n";
                 }
               }
             }
@@ -758,19 +805,19 @@ static void printFileSectionSizes(StringRef file) {
         if (ObjectFile *o = dyn_cast<ObjectFile>(&*UO.get())) {
           MachOObjectFile *MachO = dyn_cast<MachOObjectFile>(o);
           if (OutputFormat == sysv)
-            outs() << o->getFileName() << "  :\n";
+            out() << o->getFileName() << "  :\n";
           else if (MachO && OutputFormat == darwin) {
             if (MoreThanOneFile || MoreThanOneArch)
-              outs() << o->getFileName() << " (for architecture "
-                     << I->getArchFlagName() << "):";
-            outs() << "\n";
+              out() << o->getFileName() << " (for architecture "
+                    << I->getArchFlagName() << "):";
+            out() << "\n";
           }
           printObjectSectionSizes(o);
           if (OutputFormat == berkeley) {
             if (!MachO || MoreThanOneFile || MoreThanOneArch)
-              outs() << o->getFileName() << " (for architecture "
-                     << I->getArchFlagName() << ")";
-            outs() << "\n";
+              out() << o->getFileName() << " (for architecture "
+                    << I->getArchFlagName() << ")";
+            out() << "\n";
           }
         }
       } else if (auto E = isNotObjectErrorInvalidFileType(UO.takeError())) {
@@ -794,20 +841,20 @@ static void printFileSectionSizes(StringRef file) {
           if (ObjectFile *o = dyn_cast<ObjectFile>(&*ChildOrErr.get())) {
             MachOObjectFile *MachO = dyn_cast<MachOObjectFile>(o);
             if (OutputFormat == sysv)
-              outs() << o->getFileName() << "   (ex " << UA->getFileName()
-                     << "):\n";
+              out() << o->getFileName() << "   (ex " << UA->getFileName()
+                    << "):\n";
             else if (MachO && OutputFormat == darwin)
-              outs() << UA->getFileName() << "(" << o->getFileName() << ")"
-                     << " (for architecture " << I->getArchFlagName() << "):\n";
+              out() << UA->getFileName() << "(" << o->getFileName() << ")"
+                    << " (for architecture " << I->getArchFlagName() << "):\n";
             printObjectSectionSizes(o);
             if (OutputFormat == berkeley) {
               if (MachO)
-                outs() << UA->getFileName() << "(" << o->getFileName() << ")"
-                       << " (for architecture " << I->getArchFlagName()
-                       << ")\n";
+                out() << UA->getFileName() << "(" << o->getFileName() << ")"
+                      << " (for architecture " << I->getArchFlagName()
+                      << ")\n";
               else
-                outs() << o->getFileName() << " (ex " << UA->getFileName()
-                       << ")\n";
+                out() << o->getFileName() << " (ex " << UA->getFileName()
+                      << ")\n";
             }
           }
         }
@@ -825,22 +872,22 @@ static void printFileSectionSizes(StringRef file) {
       return;
     MachOObjectFile *MachO = dyn_cast<MachOObjectFile>(o);
     if (OutputFormat == sysv)
-      outs() << o->getFileName() << "  :\n";
+      out() << o->getFileName() << "  :\n";
     else if (MachO && OutputFormat == darwin && MoreThanOneFile)
-      outs() << o->getFileName() << ":\n";
+      out() << o->getFileName() << ":\n";
     printObjectSectionSizes(o);
     if (OutputFormat == berkeley) {
       if (!MachO || MoreThanOneFile)
-        outs() << o->getFileName();
-      outs() << "\n";
+        out() << o->getFileName();
+      out() << "\n";
     }
   } else {
-    errs() << ToolName << ": " << file << ": "
-           << "Unrecognized file type.\n";
+    err() << ToolName << ": " << file << ": "
+          << "Unrecognized file type.\n";
   }
   // System V adds an extra newline at the end of each file.
   if (OutputFormat == sysv)
-    outs() << "\n";
+    out() << "\n";
 }
 
 static void printBerkelyTotals() {
@@ -850,15 +897,53 @@ static void printBerkelyTotals() {
   fmt << "%#7" << radix_fmt << "\t"
       << "%#7" << radix_fmt << "\t"
       << "%#7" << radix_fmt << "\t";
-  outs() << format(fmt.str().c_str(), TotalObjectText, TotalObjectData,
-                   TotalObjectBss);
+  outs() << format(fmt.str().c_str(), TotalObjectText.load(),
+                   TotalObjectData.load(), TotalObjectBss.load());
   fmtbuf.clear();
   fmt << "%7" << (Radix == octal ? PRIo64 : PRIu64) << "\t"
       << "%7" PRIx64 "\t";
-  outs() << format(fmt.str().c_str(), TotalObjectTotal, TotalObjectTotal)
+  outs() << format(fmt.str().c_str(), TotalObjectTotal.load(),
+                   TotalObjectTotal.load())
          << "(TOTALS)\n";
 }
 
+/// Print the sizes of all input files. With --threads, the files are processed
+/// concurrently and the output of each file is written out in input order once
+/// it and all the files before it are done, so it matches the serial output.
+static void printInputFiles() {
+  if (Threads == 0 || InputFilenames.size() < 2) {
+    llvm::for_each(InputFilenames, printFileSectionSizes);
+    return;
+  }
+
+  std::vector<std::unique_ptr<OutputContext>> Contexts;
+  std::vector<std::shared_future<void>> Done;
+  ThreadPool Pool(Threads);
+  for (const std::string &Filename : InputFilenames) {
+    Contexts.push_back(llvm::make_unique<OutputContext>());
+    OutputContext *C = Contexts.back().get();
+    Done.push_back(Pool.async([C, &Filename] {
+      WorkerContext = C;
+      printFileSectionSizes(Filename);
+      WorkerContext = nullptr;
+    }));
+  }
+
+  for (size_t I = 0, E = Contexts.size(); I != E; ++I) {
+    Done[I].wait();
+    OutputContext &C = *Contexts[I];
+    std::string &Out = C.OutOS.str();
+    if (C.HeaderPrinted) {
+      if (BerkeleyHeaderPrinted)
+        Out.erase(C.HeaderBegin, C.HeaderEnd - C.HeaderBegin);
+      BerkeleyHeaderPrinted = true;
+    }
+    outs() << Out;
+    errs() << C.ErrOS.str();
+    Contexts[I].reset();
+  }
+}
+
 int main(int argc, char **argv) {
   InitLLVM X(argc, argv);
   cl::ParseCommandLineOptions(argc, argv, "llvm object size dumper\n");
@@ -874,8 +959,8 @@ int main(int argc, char **argv) {
       ArchAll = true;
     } else {
       if (!MachOObjectFile::isValidArch(Arch)) {
-        outs() << ToolName << ": for the -arch option: Unknown architecture "
-               << "named '" << Arch << "'";
+        out() << ToolName << ": for the -arch option: Unknown architecture "
+              << "named '" << Arch << "'";
         return 1;
       }
     }
@@ -885,7 +970,7 @@ int main(int argc, char **argv) {
     InputFilenames.push_back("a.out");
 
   MoreThanOneFile = InputFilenames.size() > 1;
-  llvm::for_each(InputFilenames, printFileSectionSizes);
+  printInputFiles();
   if (OutputFormat == berkeley && TotalSizes)
     printBerkelyTotals();
 
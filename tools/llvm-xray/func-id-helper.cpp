@@ -18,7 +18,8 @@
 using namespace llvm;
 using namespace xray;
 
-std::string FuncIdConversionHelper::SymbolOrNumber(int32_t FuncId) const {
+const std::string &
+FuncIdConversionHelper::SymbolOrNumber(int32_t FuncId) const {
   auto CacheIt = CachedNames.find(FuncId);
   if (CacheIt != CachedNames.end())
     return CacheIt->second;
@@ -27,7 +28,7 @@ std::string FuncIdConversionHelper::SymbolOrNumber(int32_t FuncId) const {
   auto It = FunctionAddresses.find(FuncId);
   if (It == FunctionAddresses.end()) {
     F << "#" << FuncId;
-    return F.str();
+    return CachedNames[FuncId] = F.str();
   }
 
   if (auto ResOrErr = Symbolizer.symbolizeCode(BinaryInstrMap, It->second)) {
@@ -41,26 +42,29 @@ std::string FuncIdConversionHelper::SymbolOrNumber(int32_t FuncId) const {
       F << "@(" << std::hex << It->second << ")";
     });
 
-  auto S = F.str();
-  CachedNames[FuncId] = S;
-  return S;
+  return CachedNames[FuncId] = F.str();
 }
 
-std::string FuncIdConversionHelper::FileLineAndColumn(int32_t FuncId) const {
+const std::string &
+FuncIdConversionHelper::FileLineAndColumn(int32_t FuncId) const {
+  auto CacheIt = CachedLocations.find(FuncId);
+  if (CacheIt != CachedLocations.end())
+    return CacheIt->second;
+
   auto It = FunctionAddresses.find(FuncId);
   if (It == FunctionAddresses.end())
-    return "(unknown)";
+    return CachedLocations[FuncId] = "(unknown)";
 
   std::ostringstream F;
   auto ResOrErr = Symbolizer.symbolizeCode(BinaryInstrMap, It->second);
   if (!ResOrErr) {
     consumeError(ResOrErr.takeError());
-    return "(unknown)";
+    return CachedLocations[FuncId] = "(unknown)";
   }
 
   auto &DI = *ResOrErr;
   F << sys::path::filename(DI.FileName).str() << ":" << DI.Line << ":"
     << DI.Column;
 
-  return F.str();
+  return CachedLocations[FuncId] = F.str();
 }
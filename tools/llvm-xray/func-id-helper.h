@@ -29,7 +29,10 @@ private:
   std::string BinaryInstrMap;
   symbolize::LLVMSymbolizer &Symbolizer;
   const FunctionAddressMap &FunctionAddresses;
-  mutable llvm::DenseMap<int32_t, std::string> CachedNames;
+  // The names are kept in node-based maps, so that references to them stay
+  // valid.
+  mutable std::unordered_map<int32_t, std::string> CachedNames;
+  mutable std::unordered_map<int32_t, std::string> CachedLocations;
 
 public:
   FuncIdConversionHelper(std::string BinaryInstrMap,
@@ -38,11 +41,12 @@ public:
       : BinaryInstrMap(std::move(BinaryInstrMap)), Symbolizer(Symbolizer),
         FunctionAddresses(FunctionAddresses) {}
 
-  // Returns the symbol or a string representation of the function id.
-  std::string SymbolOrNumber(int32_t FuncId) const;
+  // Returns the symbol or a string representation of the function id. Each
+  // function is only symbolized once.
+  const std::string &SymbolOrNumber(int32_t FuncId) const;
 
   // Returns the file and column from debug info for the given function id.
-  std::string FileLineAndColumn(int32_t FuncId) const;
+  const std::string &FileLineAndColumn(int32_t FuncId) const;
 };
 
 } // namespace xray
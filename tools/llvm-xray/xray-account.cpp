@@ -12,7 +12,9 @@
 //===----------------------------------------------------------------------===//
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <mutex>
 #include <numeric>
 #include <system_error>
 #include <utility>
@@ -121,6 +123,15 @@ static cl::alias AccountInstrMap2("m", cl::aliasopt(AccountInstrMap),
                                   cl::desc("Alias for -instr_map"),
                                   cl::sub(Account));
 
+static cl::opt<unsigned>
+    AccountThreads("threads",
+                   cl::desc("number of threads to account the threads of an "
+                            "FDR mode log on"),
+                   cl::value_desc("N"), cl::sub(Account), cl::init(1));
+static cl::alias AccountThreads2("j", cl::aliasopt(AccountThreads),
+                                 cl::desc("Alias for -threads"),
+                                 cl::sub(Account));
+
 namespace {
 
 template <class T, class U> void setMinMax(std::pair<T, T> &MM, U &&V) {
@@ -219,6 +230,25 @@ bool LatencyAccountant::accountRecord(const XRayRecord &Record) {
   return true;
 }
 
+void LatencyAccountant::merge(const LatencyAccountant &Other) {
+  for (const auto &FL : Other.FunctionLatencies) {
+    auto &Latencies = FunctionLatencies[FL.first];
+    Latencies.insert(Latencies.end(), FL.second.begin(), FL.second.end());
+  }
+  for (const auto &MM : Other.PerThreadMinMaxTSC) {
+    setMinMax(PerThreadMinMaxTSC[MM.first], MM.second.first);
+    setMinMax(PerThreadMinMaxTSC[MM.first], MM.second.second);
+  }
+  for (const auto &MM : Other.PerCPUMinMaxTSC) {
+    setMinMax(PerCPUMinMaxTSC[MM.first], MM.second.first);
+    setMinMax(PerCPUMinMaxTSC[MM.first], MM.second.second);
+  }
+  for (const auto &TS : Other.PerThreadFunctionStack) {
+    auto &Stack = PerThreadFunctionStack[TS.first];
+    Stack.insert(Stack.end(), TS.second.begin(), TS.second.end());
+  }
+}
+
 namespace {
 
 // We consolidate the data into a struct which we can output in various forms.
@@ -434,18 +464,19 @@ static CommandRegistration Unused(&Account, []() -> Error {
   llvm::xray::FuncIdConversionHelper FuncIdHelper(AccountInstrMap, Symbolizer,
                                                   FunctionAddresses);
   xray::LatencyAccountant FCA(FuncIdHelper, AccountDeduceSiblingCalls);
-  auto TraceOrErr = loadTraceFile(AccountInput);
-  if (!TraceOrErr)
-    return joinErrors(
-        make_error<StringError>(
-            Twine("Failed loading input file '") + AccountInput + "'",
-            std::make_error_code(std::errc::executable_format_error)),
-        TraceOrErr.takeError());
 
-  auto &T = *TraceOrErr;
-  for (const auto &Record : T) {
+  // The records are accounted as they are read, so that the trace is never
+  // held in memory as a whole. With more than one thread, each worker accounts
+  // the threads of the log it is handed with its own accountant, and the
+  // accountants are merged at the end.
+  XRayFileHeader Header;
+  std::atomic<bool> AccountingFailed(false);
+  std::mutex ReportMutex;
+  auto AccountRecord = [&](LatencyAccountant &FCA,
+                           const XRayRecord &Record) -> Error {
     if (FCA.accountRecord(Record))
-      continue;
+      return Error::success();
+    std::lock_guard<std::mutex> Lock(ReportMutex);
     errs()
         << "Error processing record: "
         << llvm::formatv(
@@ -464,18 +495,49 @@ static CommandRegistration Unused(&Account, []() -> Error {
         errs() << "  #" << Level-- << "\t"
                << FuncIdHelper.SymbolOrNumber(Entry.first) << '\n';
     }
-    if (!AccountKeepGoing)
+    if (!AccountKeepGoing) {
+      AccountingFailed = true;
       return make_error<StringError>(
           Twine("Failed accounting function calls in file '") + AccountInput +
               "'.",
           std::make_error_code(std::errc::executable_format_error));
+    }
+    return Error::success();
+  };
+  auto AccountTrace = [&]() -> Error {
+    if (AccountThreads <= 1)
+      return streamTraceFile(AccountInput, Header,
+                             [&](const XRayRecord &Record) {
+                               return AccountRecord(FCA, Record);
+                             });
+    std::vector<std::unique_ptr<LatencyAccountant>> Workers;
+    for (unsigned I = 0; I != AccountThreads; ++I)
+      Workers.push_back(llvm::make_unique<LatencyAccountant>(
+          FuncIdHelper, AccountDeduceSiblingCalls));
+    auto E = streamTraceFile(AccountInput, Header, AccountThreads,
+                             [&](unsigned Worker, const XRayRecord &Record) {
+                               return AccountRecord(*Workers[Worker], Record);
+                             });
+    for (const auto &W : Workers)
+      FCA.merge(*W);
+    return E;
+  };
+  if (auto E = AccountTrace()) {
+    if (AccountingFailed)
+      return E;
+    return joinErrors(
+        make_error<StringError>(
+            Twine("Failed loading input file '") + AccountInput + "'",
+            std::make_error_code(std::errc::executable_format_error)),
+        std::move(E));
   }
+
   switch (AccountOutputFormat) {
   case AccountOutputFormats::TEXT:
-    FCA.exportStatsAsText(OS, T.getFileHeader());
+    FCA.exportStatsAsText(OS, Header);
     break;
   case AccountOutputFormats::CSV:
-    FCA.exportStatsAsCSV(OS, T.getFileHeader());
+    FCA.exportStatsAsCSV(OS, Header);
     break;
   }
 
@@ -78,6 +78,10 @@ public:
   ///
   bool accountRecord(const XRayRecord &Record);
 
+  /// Adds the latencies and time ranges accounted by \p Other, which must have
+  /// accounted the records of other threads, to this accountant.
+  void merge(const LatencyAccountant &Other);
+
   const FunctionStack *getThreadFunctionStack(llvm::sys::procid_t TId) const {
     auto I = PerThreadFunctionStack.find(TId);
     if (I == PerThreadFunctionStack.end())
@@ -19,6 +19,7 @@
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/FormatVariadic.h"
 #include "llvm/Support/JSON.h"
+#include "llvm/Support/LEB128.h"
 #include "llvm/Support/ScopedPrinter.h"
 #include "llvm/Support/YAMLTraits.h"
 #include "llvm/Support/raw_ostream.h"
@@ -35,14 +36,17 @@ static cl::SubCommand Convert("convert", "Trace Format Conversion");
 static cl::opt<std::string> ConvertInput(cl::Positional,
                                          cl::desc("<xray log file>"),
                                          cl::Required, cl::sub(Convert));
-enum class ConvertFormats { BINARY, YAML, CHROME_TRACE_EVENT };
+enum class ConvertFormats { BINARY, YAML, CHROME_TRACE_EVENT, PERFETTO };
 static cl::opt<ConvertFormats> ConvertOutputFormat(
     "output-format", cl::desc("output format"),
     cl::values(clEnumValN(ConvertFormats::BINARY, "raw", "output in binary"),
                clEnumValN(ConvertFormats::YAML, "yaml", "output in yaml"),
                clEnumValN(ConvertFormats::CHROME_TRACE_EVENT, "trace_event",
                           "Output in chrome's trace event format. "
-                          "May be visualized with the Catapult trace viewer.")),
+                          "May be visualized with the Catapult trace viewer."),
+               clEnumValN(ConvertFormats::PERFETTO, "perfetto",
+                          "Output in the Perfetto protobuf trace format. The "
+                          "log is converted as it is read, without sorting.")),
     cl::sub(Convert));
 static cl::alias ConvertOutputFormat2("f", cl::aliasopt(ConvertOutputFormat),
                                       cl::desc("Alias for -output-format"),
@@ -79,6 +83,14 @@ static cl::opt<bool> ConvertSortInput(
 static cl::alias ConvertSortInput2("s", cl::aliasopt(ConvertSortInput),
                                    cl::desc("Alias for -sort"),
                                    cl::sub(Convert));
+static cl::opt<unsigned>
+    ConvertThreads("threads",
+                   cl::desc("number of threads to expand the threads of an FDR "
+                            "mode log on"),
+                   cl::sub(Convert), cl::init(1));
+static cl::alias ConvertThreads2("j", cl::aliasopt(ConvertThreads),
+                                 cl::desc("Alias for -threads"),
+                                 cl::sub(Convert));
 
 using llvm::yaml::Output;
 
@@ -350,6 +362,141 @@ void TraceConverter::exportAsChromeTraceEventFormat(const Trace &Records,
   OS << formatv("{0:2}", json::Value(std::move(TraceJSON)));
 }
 
+namespace {
+
+// The field numbers of the Perfetto trace protos that we write.
+enum PerfettoField : uint32_t {
+  Trace_Packet = 1,
+  TracePacket_Timestamp = 8,
+  TracePacket_TrustedPacketSequenceId = 10,
+  TracePacket_TrackEvent = 11,
+  TracePacket_InternedData = 12,
+  TracePacket_SequenceFlags = 13,
+  TracePacket_TrackDescriptor = 60,
+  TrackEvent_Type = 9,
+  TrackEvent_NameIid = 10,
+  TrackEvent_TrackUuid = 11,
+  InternedData_EventNames = 2,
+  EventName_Iid = 1,
+  EventName_Name = 2,
+  TrackDescriptor_Uuid = 1,
+  TrackDescriptor_Thread = 4,
+  ThreadDescriptor_Pid = 1,
+  ThreadDescriptor_Tid = 2,
+};
+
+enum : uint64_t {
+  SeqIncrementalStateCleared = 1,
+  SeqNeedsIncrementalState = 2,
+  TrackEventSliceBegin = 1,
+  TrackEventSliceEnd = 2,
+  // All packets come from one sequence, which owns the interned names.
+  SequenceId = 1,
+};
+
+void writeVarint(raw_ostream &OS, uint32_t Field, uint64_t Value) {
+  encodeULEB128(Field << 3, OS);
+  encodeULEB128(Value, OS);
+}
+
+void writeBytes(raw_ostream &OS, uint32_t Field, StringRef Bytes) {
+  encodeULEB128((Field << 3) | 2, OS);
+  encodeULEB128(Bytes.size(), OS);
+  OS << Bytes;
+}
+
+// Interned ids must not be zero.
+uint64_t getNameIid(int32_t FuncId) { return uint64_t(uint32_t(FuncId)) + 1; }
+
+} // namespace
+
+void PerfettoTraceWriter::writePacket() {
+  writeBytes(OS, Trace_Packet, Packet);
+  Packet.clear();
+}
+
+void PerfettoTraceWriter::add(const XRayFileHeader &Header,
+                              const XRayRecord &R) {
+  // TODO: Support custom and typed events as instant events.
+  if (R.Type == RecordTypes::CUSTOM_EVENT ||
+      R.Type == RecordTypes::TYPED_EVENT)
+    return;
+
+  uint32_t PId = Header.Version >= 3 ? R.PId : 1;
+  uint64_t TrackUuid = (uint64_t(PId) << 32) | R.TId;
+  uint64_t Timestamp =
+      Header.CycleFrequency
+          ? uint64_t(double(R.TSC) * 1e9 / double(Header.CycleFrequency))
+          : R.TSC;
+  raw_svector_ostream PacketOS(Packet);
+
+  auto Inserted = Stacks.try_emplace({PId, R.TId});
+  auto &Stack = Inserted.first->second;
+  if (Inserted.second) {
+    SmallString<16> Thread, Track;
+    raw_svector_ostream ThreadOS(Thread), TrackOS(Track);
+    writeVarint(ThreadOS, ThreadDescriptor_Pid, PId);
+    writeVarint(ThreadOS, ThreadDescriptor_Tid, R.TId);
+    writeVarint(TrackOS, TrackDescriptor_Uuid, TrackUuid);
+    writeBytes(TrackOS, TrackDescriptor_Thread, Thread);
+    writeVarint(PacketOS, TracePacket_TrustedPacketSequenceId, SequenceId);
+    if (!Started)
+      writeVarint(PacketOS, TracePacket_SequenceFlags,
+                  SeqIncrementalStateCleared);
+    Started = true;
+    writeBytes(PacketOS, TracePacket_TrackDescriptor, Track);
+    writePacket();
+  }
+
+  auto WriteSlice = [&](uint64_t Type, int32_t FuncId) {
+    SmallString<32> Event;
+    raw_svector_ostream EventOS(Event);
+    writeVarint(EventOS, TrackEvent_Type, Type);
+    writeVarint(EventOS, TrackEvent_TrackUuid, TrackUuid);
+    writeVarint(PacketOS, TracePacket_Timestamp, Timestamp);
+    writeVarint(PacketOS, TracePacket_TrustedPacketSequenceId, SequenceId);
+    writeVarint(PacketOS, TracePacket_SequenceFlags, SeqNeedsIncrementalState);
+    if (Type == TrackEventSliceBegin) {
+      writeVarint(EventOS, TrackEvent_NameIid, getNameIid(FuncId));
+      // The first slice of a function carries its name.
+      if (InternedNames.insert(FuncId).second) {
+        SmallString<64> Name, Interned;
+        raw_svector_ostream NameOS(Name), InternedOS(Interned);
+        writeVarint(NameOS, EventName_Iid, getNameIid(FuncId));
+        writeBytes(NameOS, EventName_Name,
+                   Symbolize ? FuncIdHelper.SymbolOrNumber(FuncId)
+                             : llvm::to_string(FuncId));
+        writeBytes(InternedOS, InternedData_EventNames, Name);
+        writeBytes(PacketOS, TracePacket_InternedData, Interned);
+      }
+    }
+    writeBytes(PacketOS, TracePacket_TrackEvent, Event);
+    writePacket();
+  };
+
+  switch (R.Type) {
+  case RecordTypes::CUSTOM_EVENT:
+  case RecordTypes::TYPED_EVENT:
+    break;
+  case RecordTypes::ENTER:
+  case RecordTypes::ENTER_ARG:
+    Stack.push_back(R.FuncId);
+    WriteSlice(TrackEventSliceBegin, R.FuncId);
+    break;
+  case RecordTypes::EXIT:
+  case RecordTypes::TAIL_EXIT:
+    // Like for the trace event format, an exit closes the functions entered
+    // after the one that is exited.
+    while (!Stack.empty()) {
+      int32_t FuncId = Stack.pop_back_val();
+      WriteSlice(TrackEventSliceEnd, FuncId);
+      if (FuncId == R.FuncId)
+        break;
+    }
+    break;
+  }
+}
+
 namespace llvm {
 namespace xray {
 
@@ -376,14 +523,33 @@ static CommandRegistration Unused(&Convert, []() -> Error {
   llvm::xray::TraceConverter TC(FuncIdHelper, ConvertSymbolize);
   std::error_code EC;
   raw_fd_ostream OS(ConvertOutput, EC,
-                    ConvertOutputFormat == ConvertFormats::BINARY
+                    ConvertOutputFormat == ConvertFormats::BINARY ||
+                            ConvertOutputFormat == ConvertFormats::PERFETTO
                         ? sys::fs::OpenFlags::F_None
                         : sys::fs::OpenFlags::F_Text);
   if (EC)
     return make_error<StringError>(
         Twine("Cannot open file '") + ConvertOutput + "' for writing.", EC);
 
-  auto TraceOrErr = loadTraceFile(ConvertInput, ConvertSortInput);
+  // Perfetto sorts the events itself, so we need not hold the trace in memory.
+  if (ConvertOutputFormat == ConvertFormats::PERFETTO) {
+    PerfettoTraceWriter Writer(FuncIdHelper, ConvertSymbolize, OS);
+    XRayFileHeader Header;
+    if (auto E = streamTraceFile(ConvertInput, Header,
+                                 [&](const XRayRecord &R) {
+                                   Writer.add(Header, R);
+                                   return Error::success();
+                                 }))
+      return joinErrors(
+          make_error<StringError>(
+              Twine("Failed loading input file '") + ConvertInput + "'.",
+              std::make_error_code(std::errc::executable_format_error)),
+          std::move(E));
+    return Error::success();
+  }
+
+  auto TraceOrErr =
+      loadTraceFile(ConvertInput, ConvertSortInput, ConvertThreads);
   if (!TraceOrErr)
     return joinErrors(
         make_error<StringError>(
@@ -402,6 +568,8 @@ static CommandRegistration Unused(&Convert, []() -> Error {
   case ConvertFormats::CHROME_TRACE_EVENT:
     TC.exportAsChromeTraceEventFormat(T, OS);
     break;
+  case ConvertFormats::PERFETTO:
+    llvm_unreachable("Perfetto traces are streamed");
   }
   return Error::success();
 });
@@ -15,6 +15,11 @@
 #define LLVM_TOOLS_LLVM_XRAY_XRAY_CONVERTER_H
 
 #include "func-id-helper.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/DenseSet.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/Support/raw_ostream.h"
 #include "llvm/XRay/Trace.h"
 #include "llvm/XRay/XRayRecord.h"
 
@@ -38,6 +43,36 @@ public:
   void exportAsChromeTraceEventFormat(const Trace &Records, raw_ostream &OS);
 };
 
+/// Writes records as a Perfetto protobuf trace, with a track for each thread
+/// and slices for the function calls on it. Function names are interned, so
+/// each is only symbolized and written once. Records are written as they are
+/// added, so a trace can be converted while it is streamed; the records of
+/// each thread must be in TSC order, but threads may be interleaved.
+class PerfettoTraceWriter {
+  FuncIdConversionHelper &FuncIdHelper;
+  bool Symbolize;
+  raw_ostream &OS;
+
+  // The process+thread pairs that have a track descriptor, and the functions
+  // entered on each of them that have not been exited yet.
+  DenseMap<std::pair<uint32_t, uint32_t>, SmallVector<int32_t, 8>> Stacks;
+
+  // The functions whose names were interned.
+  DenseSet<int32_t> InternedNames;
+
+  SmallString<64> Packet;
+  bool Started = false;
+
+  void writePacket();
+
+public:
+  PerfettoTraceWriter(FuncIdConversionHelper &FuncIdHelper, bool Symbolize,
+                      raw_ostream &OS)
+      : FuncIdHelper(FuncIdHelper), Symbolize(Symbolize), OS(OS) {}
+
+  void add(const XRayFileHeader &Header, const XRayRecord &R);
+};
+
 } // namespace xray
 } // namespace llvm
 
@@ -15,7 +15,9 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <atomic>
 #include <forward_list>
+#include <mutex>
 #include <numeric>
 
 #include "func-id-helper.h"
@@ -111,6 +113,14 @@ static cl::opt<AggregationType> RequestedAggregation(
                    "of all callees.")),
     cl::sub(Stack), cl::init(AggregationType::TOTAL_TIME));
 
+static cl::opt<unsigned>
+    StackThreads("threads",
+                 cl::desc("Number of threads to account the threads of FDR "
+                          "mode logs on."),
+                 cl::sub(Stack), cl::init(1));
+static cl::alias StackThreads2("j", cl::aliasopt(StackThreads),
+                               cl::desc("Alias for -threads"), cl::sub(Stack));
+
 /// A helper struct to work with formatv and XRayRecords. Makes it easier to
 /// use instrumentation map names or addresses in formatted output.
 struct format_xray_record : public FormatAdapter<XRayRecord> {
@@ -448,6 +458,27 @@ public:
 
   bool isEmpty() const { return Roots.empty(); }
 
+  /// Moves the stacks of \p Other, which must have accounted the records of
+  /// other threads, into this trie. The roots of the same thread id are merged.
+  void merge(StackTrie &Other) {
+    for (auto &ThreadRoots : Other.Roots) {
+      auto &MyRoots = Roots[ThreadRoots.first];
+      for (auto *Node : ThreadRoots.second) {
+        auto I = find_if(MyRoots, [Node](StackTrieNode *N) {
+          return N->FuncId == Node->FuncId;
+        });
+        if (I == MyRoots.end())
+          MyRoots.push_back(Node);
+        else
+          *I = mergeTrieNodes(**I, *Node, nullptr, NodeStore,
+                              mergeStackDuration);
+      }
+    }
+    NodeStore.splice_after(NodeStore.before_begin(), Other.NodeStore);
+    Other.Roots.clear();
+    Other.ThreadStackMap.clear();
+  }
+
   void printStack(raw_ostream &OS, const StackTrieNode *Top,
                   FuncIdConversionHelper &FN) {
     // Traverse the pointers up to the parent, noting the sums, then print
@@ -729,29 +760,58 @@ static CommandRegistration Unused(&Stack, []() -> Error {
   // TODO: Someday, support output to files instead of just directly to
   // standard output.
   for (const auto &Filename : StackInputs) {
-    auto TraceOrErr = loadTraceFile(Filename);
-    if (!TraceOrErr) {
-      if (!StackKeepGoing)
-        return joinErrors(
-            make_error<StringError>(
-                Twine("Failed loading input file '") + Filename + "'",
-                std::make_error_code(std::errc::invalid_argument)),
-            TraceOrErr.takeError());
-      logAllUnhandledErrors(TraceOrErr.takeError(), errs());
-      continue;
-    }
-    auto &T = *TraceOrErr;
-    StackTrie::AccountRecordState AccountRecordState =
-        StackTrie::AccountRecordState::CreateInitialState();
-    for (const auto &Record : T) {
-      auto error = ST.accountRecord(Record, &AccountRecordState);
+    // The records are accounted as they are read, so that the trace is never
+    // held in memory as a whole. With more than one thread, each worker
+    // accounts the threads of the log it is handed in its own trie, and the
+    // tries are merged at the end.
+    XRayFileHeader Header;
+    std::atomic<bool> AccountingFailed(false);
+    std::mutex ReportMutex;
+    auto AccountRecord = [&](StackTrie &T, StackTrie::AccountRecordState &State,
+                             const XRayRecord &Record) -> Error {
+      auto error = T.accountRecord(Record, &State);
       if (error != StackTrie::AccountRecordStatus::OK) {
-        if (!StackKeepGoing)
+        std::lock_guard<std::mutex> Lock(ReportMutex);
+        if (!StackKeepGoing) {
+          AccountingFailed = true;
           return make_error<StringError>(
               CreateErrorMessage(error, Record, FuncIdHelper),
               make_error_code(errc::illegal_byte_sequence));
+        }
         errs() << CreateErrorMessage(error, Record, FuncIdHelper);
       }
+      return Error::success();
+    };
+    auto AccountTrace = [&]() -> Error {
+      if (StackThreads <= 1) {
+        StackTrie::AccountRecordState State =
+            StackTrie::AccountRecordState::CreateInitialState();
+        return streamTraceFile(Filename, Header, [&](const XRayRecord &R) {
+          return AccountRecord(ST, State, R);
+        });
+      }
+      std::vector<StackTrie> Tries(StackThreads);
+      std::vector<StackTrie::AccountRecordState> States(
+          StackThreads, StackTrie::AccountRecordState::CreateInitialState());
+      auto E = streamTraceFile(Filename, Header, StackThreads,
+                               [&](unsigned Worker, const XRayRecord &R) {
+                                 return AccountRecord(Tries[Worker],
+                                                      States[Worker], R);
+                               });
+      for (auto &T : Tries)
+        ST.merge(T);
+      return E;
+    };
+    if (auto E = AccountTrace()) {
+      if (AccountingFailed)
+        return E;
+      if (!StackKeepGoing)
+        return joinErrors(
+            make_error<StringError>(
+                Twine("Failed loading input file '") + Filename + "'",
+                std::make_error_code(std::errc::invalid_argument)),
+            std::move(E));
+      logAllUnhandledErrors(std::move(E), errs());
     }
   }
   if (ST.isEmpty()) {
@@ -26,6 +26,7 @@ class ELFDumper {
   typedef typename ELFT::Word Elf_Word;
   typedef typename ELFT::Rel Elf_Rel;
   typedef typename ELFT::Rela Elf_Rela;
+  typedef typename ELFT::Relr Elf_Relr;
 
   ArrayRef<Elf_Shdr> Sections;
 
@@ -59,6 +60,7 @@ class ELFDumper {
   ErrorOr<ELFYAML::NoBitsSection *> dumpNoBitsSection(const Elf_Shdr *Shdr);
   ErrorOr<ELFYAML::Group *> dumpGroup(const Elf_Shdr *Shdr);
   ErrorOr<ELFYAML::MipsABIFlags *> dumpMipsABIFlags(const Elf_Shdr *Shdr);
+  ErrorOr<ELFYAML::RelrSection *> dumpRelrSection(const Elf_Shdr *Shdr);
 
 public:
   ELFDumper(const object::ELFFile<ELFT> &O);
@@ -175,6 +177,14 @@ template <class ELFT> ErrorOr<ELFYAML::Object *> ELFDumper<ELFT>::dump() {
       Y->Sections.push_back(std::unique_ptr<ELFYAML::Section>(G.get()));
       break;
     }
+    case ELF::SHT_RELR:
+    case ELF::SHT_ANDROID_RELR: {
+      ErrorOr<ELFYAML::RelrSection *> S = dumpRelrSection(&Sec);
+      if (std::error_code EC = S.getError())
+        return EC;
+      Y->Sections.push_back(std::unique_ptr<ELFYAML::Section>(S.get()));
+      break;
+    }
     case ELF::SHT_NOBITS: {
       ErrorOr<ELFYAML::NoBitsSection *> S = dumpNoBitsSection(&Sec);
       if (std::error_code EC = S.getError())
@@ -439,6 +449,54 @@ ELFDumper<ELFT>::dumpNoBitsSection(const Elf_Shdr *Shdr) {
   return S.release();
 }
 
+template <class ELFT>
+ErrorOr<ELFYAML::RelrSection *>
+ELFDumper<ELFT>::dumpRelrSection(const Elf_Shdr *Shdr) {
+  auto S = make_unique<ELFYAML::RelrSection>();
+
+  if (std::error_code EC = dumpCommonSection(Shdr, *S))
+    return EC;
+
+  auto RelrsOrErr = Obj.relrs(Shdr);
+  if (!RelrsOrErr)
+    return errorToErrorCode(RelrsOrErr.takeError());
+  auto RelasOrErr = Obj.decode_relrs(*RelrsOrErr);
+  if (!RelasOrErr)
+    return errorToErrorCode(RelasOrErr.takeError());
+
+  // Describe the section by its offsets if encoding them again gives back the
+  // same contents, and keep the raw contents otherwise.
+  std::vector<typename ELFT::uint> Offsets;
+  bool IsCanonical = true;
+  for (const Elf_Rela &Rela : *RelasOrErr) {
+    if (Rela.r_offset % sizeof(typename ELFT::uint) != 0 ||
+        (!Offsets.empty() && Offsets.back() >= Rela.r_offset))
+      IsCanonical = false;
+    Offsets.push_back(Rela.r_offset);
+  }
+  if (IsCanonical) {
+    std::vector<Elf_Relr> Encoded =
+        object::ELFFile<ELFT>::encode_relrs(Offsets);
+    IsCanonical = Encoded.size() == RelrsOrErr->size() &&
+                  std::equal(Encoded.begin(), Encoded.end(),
+                             RelrsOrErr->begin(), [](Elf_Relr A, Elf_Relr B) {
+                               return A == B;
+                             });
+  }
+
+  if (IsCanonical) {
+    for (typename ELFT::uint Offset : Offsets)
+      S->Offsets.push_back(Offset);
+  } else {
+    auto ContentOrErr = Obj.getSectionContents(Shdr);
+    if (!ContentOrErr)
+      return errorToErrorCode(ContentOrErr.takeError());
+    S->Content = yaml::BinaryRef(*ContentOrErr);
+  }
+
+  return S.release();
+}
+
 template <class ELFT>
 ErrorOr<ELFYAML::Group *> ELFDumper<ELFT>::dumpGroup(const Elf_Shdr *Shdr) {
   auto S = make_unique<ELFYAML::Group>();
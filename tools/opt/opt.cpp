@@ -16,6 +16,7 @@
 #include "Debugify.h"
 #include "NewPMDriver.h"
 #include "PassPrinters.h"
+#include "llvm/ADT/StringExtras.h"
 #include "llvm/ADT/Triple.h"
 #include "llvm/Analysis/CallGraph.h"
 #include "llvm/Analysis/CallGraphSCCPass.h"
@@ -40,15 +41,18 @@
 #include "llvm/LinkAllIR.h"
 #include "llvm/LinkAllPasses.h"
 #include "llvm/MC/SubtargetFeature.h"
+#include "llvm/OptRemarks/BinaryRemarks.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/Host.h"
 #include "llvm/Support/InitLLVM.h"
+#include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/PluginLoader.h"
 #include "llvm/Support/SourceMgr.h"
 #include "llvm/Support/SystemUtils.h"
 #include "llvm/Support/TargetRegistry.h"
 #include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/ThreadPool.h"
 #include "llvm/Support/ToolOutputFile.h"
 #include "llvm/Support/YAMLTraits.h"
 #include "llvm/Target/TargetMachine.h"
@@ -57,6 +61,7 @@
 #include "llvm/Transforms/IPO/PassManagerBuilder.h"
 #include "llvm/Transforms/Utils/Cloning.h"
 #include <algorithm>
+#include <atomic>
 #include <memory>
 using namespace llvm;
 using namespace opt_tool;
@@ -268,9 +273,32 @@ static cl::opt<unsigned> PassRemarksHotnessThreshold(
 
 static cl::opt<std::string>
     RemarksFilename("pass-remarks-output",
-                    cl::desc("YAML output filename for pass remarks"),
+                    cl::desc("Output filename for pass remarks"),
                     cl::value_desc("filename"));
 
+namespace {
+enum class RemarksFormatKind { YAML, Binary };
+} // end anonymous namespace
+
+static cl::opt<RemarksFormatKind> RemarksFormat(
+    "pass-remarks-format",
+    cl::desc("The format of the file given to -pass-remarks-output"),
+    cl::values(clEnumValN(RemarksFormatKind::YAML, "yaml", "YAML (default)"),
+               clEnumValN(RemarksFormatKind::Binary, "binary",
+                          "Compact binary format with a string table")),
+    cl::init(RemarksFormatKind::YAML));
+
+static cl::opt<std::string> BatchFilename(
+    "batch",
+    cl::desc("Optimize each pair of input and output files listed in this "
+             "file, one pair per line, with the same options"),
+    cl::value_desc("filename"));
+
+static cl::opt<unsigned>
+    BatchThreads("batch-threads",
+                 cl::desc("Number of modules to optimize at once with -batch"),
+                 cl::init(1));
+
 class OptCustomPassManager : public legacy::PassManager {
   DebugifyStatsMap DIStatsMap;
 
@@ -413,79 +441,8 @@ static TargetMachine* GetTargetMachine(Triple TheTriple, StringRef CPUStr,
                                         getCodeModel(), GetCodeGenOptLevel());
 }
 
-#ifdef LINK_POLLY_INTO_TOOLS
-namespace polly {
-void initializePollyPasses(llvm::PassRegistry &Registry);
-}
-#endif
-
-//===----------------------------------------------------------------------===//
-// main for opt
-//
-int main(int argc, char **argv) {
-  InitLLVM X(argc, argv);
-
-  // Enable debug stream buffering.
-  EnableDebugBuffering = true;
-
-  LLVMContext Context;
-
-  InitializeAllTargets();
-  InitializeAllTargetMCs();
-  InitializeAllAsmPrinters();
-  InitializeAllAsmParsers();
-
-  // Initialize passes
-  PassRegistry &Registry = *PassRegistry::getPassRegistry();
-  initializeCore(Registry);
-  initializeCoroutines(Registry);
-  initializeScalarOpts(Registry);
-  initializeObjCARCOpts(Registry);
-  initializeVectorization(Registry);
-  initializeIPO(Registry);
-  initializeAnalysis(Registry);
-  initializeTransformUtils(Registry);
-  initializeInstCombine(Registry);
-  initializeAggressiveInstCombine(Registry);
-  initializeInstrumentation(Registry);
-  initializeTarget(Registry);
-  // For codegen passes, only passes that do IR to IR transformation are
-  // supported.
-  initializeExpandMemCmpPassPass(Registry);
-  initializeScalarizeMaskedMemIntrinPass(Registry);
-  initializeCodeGenPreparePass(Registry);
-  initializeAtomicExpandPass(Registry);
-  initializeRewriteSymbolsLegacyPassPass(Registry);
-  initializeWinEHPreparePass(Registry);
-  initializeDwarfEHPreparePass(Registry);
-  initializeSafeStackLegacyPassPass(Registry);
-  initializeSjLjEHPreparePass(Registry);
-  initializePreISelIntrinsicLoweringLegacyPassPass(Registry);
-  initializeGlobalMergePass(Registry);
-  initializeIndirectBrExpandPassPass(Registry);
-  initializeInterleavedLoadCombinePass(Registry);
-  initializeInterleavedAccessPass(Registry);
-  initializeEntryExitInstrumenterPass(Registry);
-  initializePostInlineEntryExitInstrumenterPass(Registry);
-  initializeUnreachableBlockElimLegacyPassPass(Registry);
-  initializeExpandReductionsPass(Registry);
-  initializeWasmEHPreparePass(Registry);
-  initializeWriteBitcodePassPass(Registry);
-
-#ifdef LINK_POLLY_INTO_TOOLS
-  polly::initializePollyPasses(Registry);
-#endif
-
-  cl::ParseCommandLineOptions(argc, argv,
-    "llvm .bc -> .bc modular optimizer and analysis printer\n");
-
-  if (AnalyzeOnly && NoOutput) {
-    errs() << argv[0] << ": analyze mode conflicts with no-output mode.\n";
-    return 1;
-  }
-
-  SMDiagnostic Err;
-
+// Sets up \p Context as the options say.
+static void configureContext(LLVMContext &Context) {
   Context.setDiscardValueNames(DiscardValueNames);
   if (!DisableDITypeMap)
     Context.enableDebugTypeODRUniquing();
@@ -495,26 +452,26 @@ int main(int argc, char **argv) {
 
   if (PassRemarksHotnessThreshold)
     Context.setDiagnosticsHotnessThreshold(PassRemarksHotnessThreshold);
+}
 
-  std::unique_ptr<ToolOutputFile> OptRemarkFile;
-  if (RemarksFilename != "") {
-    std::error_code EC;
-    OptRemarkFile =
-        llvm::make_unique<ToolOutputFile>(RemarksFilename, EC, sys::fs::F_None);
-    if (EC) {
-      errs() << EC.message() << '\n';
-      return 1;
-    }
-    Context.setDiagnosticsOutputFile(
-        llvm::make_unique<yaml::Output>(OptRemarkFile->os()));
-  }
+// Optimizes the module in \p InputFile, which is read into \p Context, and
+// writes the result to \p OutputFile, as the options say. Returns the exit
+// code of opt.
+static int optimizeModule(const char *argv0, LLVMContext &Context,
+                          StringRef InputFile, std::string OutputFile,
+                          ToolOutputFile *OptRemarkFile) {
+  SMDiagnostic Err;
+  bool SkipOutput = NoOutput;
+  bool AddStdLinkOpts = StandardLinkOpts;
+  bool AddO0 = OptLevelO0, AddO1 = OptLevelO1, AddO2 = OptLevelO2,
+       AddOs = OptLevelOs, AddOz = OptLevelOz, AddO3 = OptLevelO3;
 
   // Load the input module...
   std::unique_ptr<Module> M =
-      parseIRFile(InputFilename, Err, Context, !NoVerify, ClDataLayout);
+      parseIRFile(InputFile, Err, Context, !NoVerify, ClDataLayout);
 
   if (!M) {
-    Err.print(argv[0], errs());
+    Err.print(argv0, errs());
     return 1;
   }
 
@@ -538,7 +495,7 @@ int main(int argc, char **argv) {
   // pass pipelines.  Otherwise we can crash on broken code during
   // doInitialization().
   if (!NoVerify && verifyModule(*M, &errs())) {
-    errs() << argv[0] << ": " << InputFilename
+    errs() << argv0 << ": " << InputFile
            << ": error: input module is broken!\n";
     return 1;
   }
@@ -546,17 +503,17 @@ int main(int argc, char **argv) {
   // Figure out what stream we are supposed to write to...
   std::unique_ptr<ToolOutputFile> Out;
   std::unique_ptr<ToolOutputFile> ThinLinkOut;
-  if (NoOutput) {
-    if (!OutputFilename.empty())
+  if (SkipOutput) {
+    if (!OutputFile.empty())
       errs() << "WARNING: The -o (output filename) option is ignored when\n"
                 "the --disable-output option is used.\n";
   } else {
     // Default to standard output.
-    if (OutputFilename.empty())
-      OutputFilename = "-";
+    if (OutputFile.empty())
+      OutputFile = "-";
 
     std::error_code EC;
-    Out.reset(new ToolOutputFile(OutputFilename, EC, sys::fs::F_None));
+    Out.reset(new ToolOutputFile(OutputFile, EC, sys::fs::F_None));
     if (EC) {
       errs() << EC.message() << '\n';
       return 1;
@@ -592,13 +549,13 @@ int main(int argc, char **argv) {
   // If the output is set to be emitted to standard out, and standard out is a
   // console, print out a warning message and refuse to do it.  We don't
   // impress anyone by spewing tons of binary goo to a terminal.
-  if (!Force && !NoOutput && !AnalyzeOnly && !OutputAssembly)
+  if (!Force && !SkipOutput && !AnalyzeOnly && !OutputAssembly)
     if (CheckBitcodeOutputToConsole(Out->os(), !Quiet))
-      NoOutput = true;
+      SkipOutput = true;
 
   if (PassPipeline.getNumOccurrences() > 0) {
     OutputKind OK = OK_NoOutput;
-    if (!NoOutput)
+    if (!SkipOutput)
       OK = OutputAssembly
                ? OK_OutputAssembly
                : (OutputThinLTOBC ? OK_OutputThinLTOBitcode : OK_OutputBitcode);
@@ -612,8 +569,8 @@ int main(int argc, char **argv) {
     // The user has asked to use the new pass manager and provided a pipeline
     // string. Hand off the rest of the functionality to the new code for that
     // layer.
-    return runPassPipeline(argv[0], *M, TM.get(), Out.get(), ThinLinkOut.get(),
-                           OptRemarkFile.get(), PassPipeline, OK, VK,
+    return runPassPipeline(argv0, *M, TM.get(), Out.get(), ThinLinkOut.get(),
+                           OptRemarkFile, PassPipeline, OK, VK,
                            PreserveAssemblyUseListOrder,
                            PreserveBitcodeUseListOrder, EmitSummaryIndex,
                            EmitModuleHash, EnableDebugify)
@@ -642,8 +599,7 @@ int main(int argc, char **argv) {
     Passes.add(createDebugifyModulePass());
 
   std::unique_ptr<legacy::FunctionPassManager> FPasses;
-  if (OptLevelO0 || OptLevelO1 || OptLevelO2 || OptLevelOs || OptLevelOz ||
-      OptLevelO3) {
+  if (AddO0 || AddO1 || AddO2 || AddOs || AddOz || AddO3) {
     FPasses.reset(new legacy::FunctionPassManager(M.get()));
     FPasses->add(createTargetTransformInfoWrapperPass(
         TM ? TM->getTargetIRAnalysis() : TargetIRAnalysis()));
@@ -652,11 +608,11 @@ int main(int argc, char **argv) {
   if (PrintBreakpoints) {
     // Default to standard output.
     if (!Out) {
-      if (OutputFilename.empty())
-        OutputFilename = "-";
+      if (OutputFile.empty())
+        OutputFile = "-";
 
       std::error_code EC;
-      Out = llvm::make_unique<ToolOutputFile>(OutputFilename, EC,
+      Out = llvm::make_unique<ToolOutputFile>(OutputFile, EC,
                                               sys::fs::F_None);
       if (EC) {
         errs() << EC.message() << '\n';
@@ -664,7 +620,7 @@ int main(int argc, char **argv) {
       }
     }
     Passes.add(createBreakpointPrinter(Out->os()));
-    NoOutput = true;
+    SkipOutput = true;
   }
 
   if (TM) {
@@ -676,40 +632,40 @@ int main(int argc, char **argv) {
 
   // Create a new optimization pass for each one specified on the command line
   for (unsigned i = 0; i < PassList.size(); ++i) {
-    if (StandardLinkOpts &&
+    if (AddStdLinkOpts &&
         StandardLinkOpts.getPosition() < PassList.getPosition(i)) {
       AddStandardLinkPasses(Passes);
-      StandardLinkOpts = false;
+      AddStdLinkOpts = false;
     }
 
-    if (OptLevelO0 && OptLevelO0.getPosition() < PassList.getPosition(i)) {
+    if (AddO0 && OptLevelO0.getPosition() < PassList.getPosition(i)) {
       AddOptimizationPasses(Passes, *FPasses, TM.get(), 0, 0);
-      OptLevelO0 = false;
+      AddO0 = false;
     }
 
-    if (OptLevelO1 && OptLevelO1.getPosition() < PassList.getPosition(i)) {
+    if (AddO1 && OptLevelO1.getPosition() < PassList.getPosition(i)) {
       AddOptimizationPasses(Passes, *FPasses, TM.get(), 1, 0);
-      OptLevelO1 = false;
+      AddO1 = false;
     }
 
-    if (OptLevelO2 && OptLevelO2.getPosition() < PassList.getPosition(i)) {
+    if (AddO2 && OptLevelO2.getPosition() < PassList.getPosition(i)) {
       AddOptimizationPasses(Passes, *FPasses, TM.get(), 2, 0);
-      OptLevelO2 = false;
+      AddO2 = false;
     }
 
-    if (OptLevelOs && OptLevelOs.getPosition() < PassList.getPosition(i)) {
+    if (AddOs && OptLevelOs.getPosition() < PassList.getPosition(i)) {
       AddOptimizationPasses(Passes, *FPasses, TM.get(), 2, 1);
-      OptLevelOs = false;
+      AddOs = false;
     }
 
-    if (OptLevelOz && OptLevelOz.getPosition() < PassList.getPosition(i)) {
+    if (AddOz && OptLevelOz.getPosition() < PassList.getPosition(i)) {
       AddOptimizationPasses(Passes, *FPasses, TM.get(), 2, 2);
-      OptLevelOz = false;
+      AddOz = false;
     }
 
-    if (OptLevelO3 && OptLevelO3.getPosition() < PassList.getPosition(i)) {
+    if (AddO3 && OptLevelO3.getPosition() < PassList.getPosition(i)) {
       AddOptimizationPasses(Passes, *FPasses, TM.get(), 3, 0);
-      OptLevelO3 = false;
+      AddO3 = false;
     }
 
     const PassInfo *PassInf = PassList[i];
@@ -717,7 +673,7 @@ int main(int argc, char **argv) {
     if (PassInf->getNormalCtor())
       P = PassInf->getNormalCtor()();
     else
-      errs() << argv[0] << ": cannot create pass: "
+      errs() << argv0 << ": cannot create pass: "
              << PassInf->getPassName() << "\n";
     if (P) {
       PassKind Kind = P->getPassKind();
@@ -752,27 +708,27 @@ int main(int argc, char **argv) {
           createPrintModulePass(errs(), "", PreserveAssemblyUseListOrder));
   }
 
-  if (StandardLinkOpts) {
+  if (AddStdLinkOpts) {
     AddStandardLinkPasses(Passes);
-    StandardLinkOpts = false;
+    AddStdLinkOpts = false;
   }
 
-  if (OptLevelO0)
+  if (AddO0)
     AddOptimizationPasses(Passes, *FPasses, TM.get(), 0, 0);
 
-  if (OptLevelO1)
+  if (AddO1)
     AddOptimizationPasses(Passes, *FPasses, TM.get(), 1, 0);
 
-  if (OptLevelO2)
+  if (AddO2)
     AddOptimizationPasses(Passes, *FPasses, TM.get(), 2, 0);
 
-  if (OptLevelOs)
+  if (AddOs)
     AddOptimizationPasses(Passes, *FPasses, TM.get(), 2, 1);
 
-  if (OptLevelOz)
+  if (AddOz)
     AddOptimizationPasses(Passes, *FPasses, TM.get(), 2, 2);
 
-  if (OptLevelO3)
+  if (AddO3)
     AddOptimizationPasses(Passes, *FPasses, TM.get(), 3, 0);
 
   if (FPasses) {
@@ -799,7 +755,7 @@ int main(int argc, char **argv) {
   raw_ostream *OS = nullptr;
 
   // Write bitcode or assembly to the output as the last step...
-  if (!NoOutput && !AnalyzeOnly) {
+  if (!SkipOutput && !AnalyzeOnly) {
     assert(Out);
     OS = &Out->os();
     if (RunTwice) {
@@ -860,7 +816,7 @@ int main(int argc, char **argv) {
     exportDebugifyStats(DebugifyExport, Passes.getDebugifyStatsMap());
 
   // Declare success.
-  if (!NoOutput || PrintBreakpoints)
+  if (!SkipOutput || PrintBreakpoints)
     Out->keep();
 
   if (OptRemarkFile)
@@ -871,3 +827,161 @@ int main(int argc, char **argv) {
 
   return 0;
 }
+
+// Optimizes the modules listed in the -batch file, each in a context of its
+// own, with the targets, passes and options that this process has set up.
+static int optimizeModules(const char *argv0) {
+  if (InputFilename.getNumOccurrences() || !OutputFilename.empty() ||
+      !RemarksFilename.empty() || !ThinLinkBitcodeFile.empty()) {
+    errs() << argv0 << ": -batch takes the input and output files from its "
+                       "list; they and -pass-remarks-output and "
+                       "-thin-link-bitcode-file can not be given.\n";
+    return 1;
+  }
+  if (BatchThreads > 1 && TimePassesIsEnabled) {
+    errs() << argv0 << ": -time-passes can not be used with -batch-threads.\n";
+    return 1;
+  }
+
+  ErrorOr<std::unique_ptr<MemoryBuffer>> ListOrErr =
+      MemoryBuffer::getFileOrSTDIN(BatchFilename);
+  if (std::error_code EC = ListOrErr.getError()) {
+    errs() << argv0 << ": " << BatchFilename << ": " << EC.message() << '\n';
+    return 1;
+  }
+
+  // Each line names an input file and the output file for it. Empty lines
+  // and lines starting with '#' are skipped.
+  std::vector<std::pair<std::string, std::string>> Files;
+  SmallVector<StringRef, 16> Lines;
+  (*ListOrErr)->getBuffer().split(Lines, '\n', -1, false);
+  for (StringRef Line : Lines) {
+    Line = Line.trim();
+    if (Line.empty() || Line.startswith("#"))
+      continue;
+    std::pair<StringRef, StringRef> InputAndOutput = getToken(Line);
+    StringRef Output = InputAndOutput.second.trim();
+    if (Output.empty()) {
+      errs() << argv0 << ": " << BatchFilename << ": no output file for '"
+             << InputAndOutput.first << "'\n";
+      return 1;
+    }
+    Files.emplace_back(InputAndOutput.first, Output);
+  }
+
+  std::atomic<bool> Failed(false);
+  auto Optimize = [&](const std::pair<std::string, std::string> &InAndOut) {
+    LLVMContext Context;
+    configureContext(Context);
+    if (optimizeModule(argv0, Context, InAndOut.first, InAndOut.second,
+                       nullptr))
+      Failed = true;
+  };
+
+  if (BatchThreads <= 1) {
+    for (const auto &InAndOut : Files)
+      Optimize(InAndOut);
+  } else {
+    ThreadPool Pool(BatchThreads);
+    for (const auto &InAndOut : Files)
+      Pool.async([&Optimize, &InAndOut]() { Optimize(InAndOut); });
+    Pool.wait();
+  }
+  return Failed ? 1 : 0;
+}
+
+#ifdef LINK_POLLY_INTO_TOOLS
+namespace polly {
+void initializePollyPasses(llvm::PassRegistry &Registry);
+}
+#endif
+
+//===----------------------------------------------------------------------===//
+// main for opt
+//
+int main(int argc, char **argv) {
+  InitLLVM X(argc, argv);
+
+  // Enable debug stream buffering.
+  EnableDebugBuffering = true;
+
+  InitializeAllTargets();
+  InitializeAllTargetMCs();
+  InitializeAllAsmPrinters();
+  InitializeAllAsmParsers();
+
+  // Initialize passes
+  PassRegistry &Registry = *PassRegistry::getPassRegistry();
+  initializeCore(Registry);
+  initializeCoroutines(Registry);
+  initializeScalarOpts(Registry);
+  initializeObjCARCOpts(Registry);
+  initializeVectorization(Registry);
+  initializeIPO(Registry);
+  initializeAnalysis(Registry);
+  initializeTransformUtils(Registry);
+  initializeInstCombine(Registry);
+  initializeAggressiveInstCombine(Registry);
+  initializeInstrumentation(Registry);
+  initializeTarget(Registry);
+  // For codegen passes, only passes that do IR to IR transformation are
+  // supported.
+  initializeExpandMemCmpPassPass(Registry);
+  initializeScalarizeMaskedMemIntrinPass(Registry);
+  initializeCodeGenPreparePass(Registry);
+  initializeAtomicExpandPass(Registry);
+  initializeRewriteSymbolsLegacyPassPass(Registry);
+  initializeWinEHPreparePass(Registry);
+  initializeDwarfEHPreparePass(Registry);
+  initializeSafeStackLegacyPassPass(Registry);
+  initializeSjLjEHPreparePass(Registry);
+  initializePreISelIntrinsicLoweringLegacyPassPass(Registry);
+  initializeGlobalMergePass(Registry);
+  initializeIndirectBrExpandPassPass(Registry);
+  initializeInterleavedLoadCombinePass(Registry);
+  initializeInterleavedAccessPass(Registry);
+  initializeEntryExitInstrumenterPass(Registry);
+  initializePostInlineEntryExitInstrumenterPass(Registry);
+  initializeUnreachableBlockElimLegacyPassPass(Registry);
+  initializeExpandReductionsPass(Registry);
+  initializeWasmEHPreparePass(Registry);
+  initializeWriteBitcodePassPass(Registry);
+
+#ifdef LINK_POLLY_INTO_TOOLS
+  polly::initializePollyPasses(Registry);
+#endif
+
+  cl::ParseCommandLineOptions(argc, argv,
+    "llvm .bc -> .bc modular optimizer and analysis printer\n");
+
+  if (AnalyzeOnly && NoOutput) {
+    errs() << argv[0] << ": analyze mode conflicts with no-output mode.\n";
+    return 1;
+  }
+
+  if (!BatchFilename.empty())
+    return optimizeModules(argv[0]);
+
+  LLVMContext Context;
+  configureContext(Context);
+
+  std::unique_ptr<ToolOutputFile> OptRemarkFile;
+  if (RemarksFilename != "") {
+    std::error_code EC;
+    OptRemarkFile =
+        llvm::make_unique<ToolOutputFile>(RemarksFilename, EC, sys::fs::F_None);
+    if (EC) {
+      errs() << EC.message() << '\n';
+      return 1;
+    }
+    if (RemarksFormat == RemarksFormatKind::Binary)
+      Context.setDiagnosticsBinaryOutputFile(
+          llvm::make_unique<remarks::BinaryRemarkWriter>(OptRemarkFile->os()));
+    else
+      Context.setDiagnosticsOutputFile(
+          llvm::make_unique<yaml::Output>(OptRemarkFile->os()));
+  }
+
+  return optimizeModule(argv[0], Context, InputFilename, OutputFilename,
+                        OptRemarkFile.get());
+}
@@ -0,0 +1,77 @@
+//===- ConcurrentStringMapTest.cpp - ConcurrentStringMap unit tests -------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ADT/ConcurrentStringMap.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/Config/llvm-config.h"
+#include "gtest/gtest.h"
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace llvm;
+
+namespace {
+
+TEST(ConcurrentStringMapTest, Basic) {
+  ConcurrentStringMap<int> Map;
+  EXPECT_TRUE(Map.empty());
+  auto R = Map.try_emplace("a", 1);
+  EXPECT_TRUE(R.second);
+  EXPECT_EQ("a", R.first->getKey());
+  EXPECT_FALSE(Map.try_emplace("a", 2).second);
+  EXPECT_EQ(1, Map.lookup("a"));
+  EXPECT_EQ(R.first, Map.find("a"));
+  EXPECT_EQ(nullptr, Map.find("b"));
+  EXPECT_EQ(1u, Map.size());
+  EXPECT_TRUE(Map.erase("a"));
+  EXPECT_FALSE(Map.erase("a"));
+  EXPECT_TRUE(Map.empty());
+}
+
+TEST(ConcurrentStringMapTest, ForEach) {
+  ConcurrentStringMap<int, 4> Map;
+  for (int I = 0; I < 100; ++I)
+    Map.try_emplace(std::to_string(I), I);
+  int Sum = 0;
+  Map.forEach([&](StringMapEntry<int> &E) {
+    EXPECT_EQ(std::to_string(E.second), E.getKey());
+    Sum += E.second;
+  });
+  EXPECT_EQ(99 * 100 / 2, Sum);
+  Map.clear();
+  EXPECT_EQ(0u, Map.size());
+}
+
+#if LLVM_ENABLE_THREADS
+TEST(ConcurrentStringMapTest, Threads) {
+  // Every thread inserts the same keys; each key must be inserted once.
+  ConcurrentStringMap<std::atomic<int>> Map;
+  std::atomic<int> Inserted{0};
+  std::vector<std::thread> Threads;
+  for (int T = 0; T < 4; ++T)
+    Threads.emplace_back([&] {
+      for (int I = 0; I < 1000; ++I) {
+        auto R = Map.try_emplace("key" + std::to_string(I), 0);
+        if (R.second)
+          ++Inserted;
+        ++R.first->second;
+      }
+    });
+  for (std::thread &T : Threads)
+    T.join();
+  EXPECT_EQ(1000, Inserted);
+  EXPECT_EQ(1000u, Map.size());
+  Map.forEach(
+      [](StringMapEntry<std::atomic<int>> &E) { EXPECT_EQ(4, E.second); });
+}
+#endif
+
+} // end anonymous namespace
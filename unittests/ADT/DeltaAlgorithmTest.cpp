@@ -11,6 +11,8 @@
 #include "gtest/gtest.h"
 #include <algorithm>
 #include <cstdarg>
+#include <memory>
+#include <mutex>
 using namespace llvm;
 
 namespace std {
@@ -35,10 +37,14 @@ namespace {
 class FixedDeltaAlgorithm final : public DeltaAlgorithm {
   changeset_ty FailingSet;
   unsigned NumTests;
+  std::shared_ptr<std::mutex> TestsMutex = std::make_shared<std::mutex>();
+  std::set<changeset_ty> TestedSets;
 
 protected:
   bool ExecuteOneTest(const changeset_ty &Changes) override {
+    std::lock_guard<std::mutex> Lock(*TestsMutex);
     ++NumTests;
+    TestedSets.insert(Changes);
     return std::includes(Changes.begin(), Changes.end(),
                          FailingSet.begin(), FailingSet.end());
   }
@@ -49,6 +55,7 @@ public:
       NumTests(0) {}
 
   unsigned getNumTests() const { return NumTests; }
+  unsigned getNumDistinctTests() const { return TestedSets.size(); }
 };
 
 std::set<unsigned> fixed_set(unsigned N, ...) {
@@ -96,5 +103,22 @@ TEST(DeltaAlgorithmTest, Basic) {
   EXPECT_EQ(11U, FDA.getNumTests());  
 }
 
+TEST(DeltaAlgorithmTest, Parallel) {
+  // Every thread count finds the same result as the serial search, running
+  // each test only once.
+  std::set<unsigned> Fails = fixed_set(4, 2, 11, 12, 29);
+  FixedDeltaAlgorithm Serial(Fails);
+  std::set<unsigned> Expected = Serial.Run(range(32));
+  EXPECT_EQ(Fails, Expected);
+
+  for (unsigned Threads : {2U, 4U, 16U}) {
+    FixedDeltaAlgorithm FDA(Fails);
+    FDA.setThreadCount(Threads);
+    EXPECT_EQ(Expected, FDA.Run(range(32)));
+    EXPECT_LE(Serial.getNumTests(), FDA.getNumTests());
+    EXPECT_EQ(FDA.getNumTests(), FDA.getNumDistinctTests());
+  }
+}
+
 }
 
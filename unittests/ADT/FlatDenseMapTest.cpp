@@ -0,0 +1,154 @@
+//===- llvm/unittest/ADT/FlatDenseMapTest.cpp - FlatDenseMap unit tests ---===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ADT/FlatDenseMap.h"
+#include "gtest/gtest.h"
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+
+using namespace llvm;
+
+namespace {
+
+TEST(FlatDenseMapTest, EmptyMap) {
+  FlatDenseMap<unsigned, unsigned> M;
+  EXPECT_TRUE(M.empty());
+  EXPECT_EQ(0u, M.size());
+  EXPECT_TRUE(M.begin() == M.end());
+  EXPECT_EQ(0u, M.count(1));
+  EXPECT_TRUE(M.find(1) == M.end());
+  EXPECT_EQ(0u, M.lookup(1));
+  EXPECT_FALSE(M.erase(1));
+  M.clear();
+  EXPECT_TRUE(M.empty());
+}
+
+TEST(FlatDenseMapTest, InsertFindErase) {
+  FlatDenseMap<unsigned, unsigned> M;
+  EXPECT_TRUE(M.insert(std::make_pair(1u, 2u)).second);
+  EXPECT_FALSE(M.insert(std::make_pair(1u, 3u)).second);
+  EXPECT_EQ(1u, M.size());
+  EXPECT_EQ(2u, M.lookup(1));
+  EXPECT_EQ(2u, M.find(1)->second);
+  M[4] = 5;
+  EXPECT_EQ(5u, M[4]);
+  EXPECT_EQ(2u, M.size());
+  EXPECT_TRUE(M.erase(1));
+  EXPECT_EQ(0u, M.count(1));
+  M.erase(M.find(4));
+  EXPECT_TRUE(M.empty());
+}
+
+// The keys DenseMap reserves for empty and tombstone buckets are ordinary
+// keys here.
+TEST(FlatDenseMapTest, ReservedDenseMapKeys) {
+  FlatDenseMap<unsigned, unsigned> M;
+  M[DenseMapInfo<unsigned>::getEmptyKey()] = 1;
+  M[DenseMapInfo<unsigned>::getTombstoneKey()] = 2;
+  EXPECT_EQ(2u, M.size());
+  EXPECT_EQ(1u, M.lookup(DenseMapInfo<unsigned>::getEmptyKey()));
+  EXPECT_EQ(2u, M.lookup(DenseMapInfo<unsigned>::getTombstoneKey()));
+}
+
+TEST(FlatDenseMapTest, Iteration) {
+  FlatDenseMap<int, int> M;
+  for (int I = 0; I < 100; ++I)
+    M[I] = I * 2;
+  int Sum = 0;
+  unsigned Count = 0;
+  for (const auto &KV : M) {
+    EXPECT_EQ(KV.first * 2, KV.second);
+    Sum += KV.first;
+    ++Count;
+  }
+  EXPECT_EQ(100u, Count);
+  EXPECT_EQ(99 * 100 / 2, Sum);
+
+  const FlatDenseMap<int, int> &CM = M;
+  FlatDenseMap<int, int>::const_iterator CI = M.begin();
+  EXPECT_TRUE(CI == CM.begin());
+}
+
+TEST(FlatDenseMapTest, CopyAndMove) {
+  FlatDenseMap<int, std::string> M;
+  for (int I = 0; I < 50; ++I)
+    M[I] = std::to_string(I);
+  FlatDenseMap<int, std::string> Copy(M);
+  EXPECT_EQ(50u, Copy.size());
+  EXPECT_EQ("17", Copy.lookup(17));
+  FlatDenseMap<int, std::string> Moved(std::move(Copy));
+  EXPECT_EQ(50u, Moved.size());
+  EXPECT_TRUE(Copy.empty());
+  Copy = Moved;
+  EXPECT_EQ("42", Copy.lookup(42));
+  Moved = std::move(M);
+  EXPECT_EQ("3", Moved.lookup(3));
+}
+
+TEST(FlatDenseMapTest, MoveOnlyValues) {
+  FlatDenseMap<int, std::unique_ptr<int>> M;
+  for (int I = 0; I < 100; ++I)
+    M.try_emplace(I, new int(I));
+  for (int I = 0; I < 100; I += 2)
+    M.erase(I);
+  EXPECT_EQ(50u, M.size());
+  EXPECT_EQ(51, *M.find(51)->second);
+}
+
+TEST(FlatDenseMapTest, Reserve) {
+  FlatDenseMap<int, int> M;
+  M.reserve(1000);
+  size_t Size = M.getMemorySize();
+  for (int I = 0; I < 1000; ++I)
+    M[I] = I;
+  EXPECT_EQ(Size, M.getMemorySize());
+}
+
+// Inserting and erasing keys must reclaim erased buckets instead of growing
+// forever.
+TEST(FlatDenseMapTest, Churn) {
+  FlatDenseMap<int, int> M;
+  for (int I = 0; I < 100000; ++I) {
+    M[I] = I;
+    if (I >= 10) {
+      EXPECT_TRUE(M.erase(I - 10));
+    }
+  }
+  EXPECT_EQ(10u, M.size());
+  EXPECT_GE(64u * sizeof(std::pair<int, int>) * 2, M.getMemorySize());
+}
+
+TEST(FlatDenseMapTest, MatchesStdMap) {
+  std::mt19937 Rng(0);
+  std::uniform_int_distribution<unsigned> Key(0, 5000);
+  FlatDenseMap<unsigned, unsigned> M;
+  std::map<unsigned, unsigned> Expected;
+  for (unsigned I = 0; I < 100000; ++I) {
+    unsigned K = Key(Rng);
+    if (I % 3 == 0) {
+      EXPECT_EQ(Expected.erase(K), unsigned(M.erase(K)));
+    } else {
+      M[K] = I;
+      Expected[K] = I;
+    }
+  }
+  EXPECT_EQ(Expected.size(), M.size());
+  for (const auto &KV : Expected)
+    EXPECT_EQ(KV.second, M.lookup(KV.first));
+  unsigned Count = 0;
+  for (const auto &KV : M) {
+    EXPECT_EQ(Expected[KV.first], KV.second);
+    ++Count;
+  }
+  EXPECT_EQ(Expected.size(), Count);
+}
+
+} // end anonymous namespace
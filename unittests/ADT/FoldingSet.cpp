@@ -12,8 +12,11 @@
 //===----------------------------------------------------------------------===//
 
 #include "llvm/ADT/FoldingSet.h"
+#include "llvm/ADT/STLExtras.h"
 #include "gtest/gtest.h"
+#include <memory>
 #include <string>
+#include <vector>
 
 using namespace llvm;
 
@@ -189,5 +192,104 @@ TEST(FoldingSetTest, SmallReserveChangesNothing) {
   EXPECT_EQ(Trivial.capacity(), OldCapacity);
 }
 
+TEST(FoldingSetTest, HashBuilderMatchesID) {
+  int Object;
+  // Cover data that fits in one block, ends on a block boundary and ends in
+  // the middle of a block.
+  for (unsigned Size = 0; Size != 100; ++Size) {
+    FoldingSetNodeID ID;
+    FoldingSetHashBuilder Builder;
+    for (unsigned I = 0; I != Size; ++I) {
+      switch (I % 4) {
+      case 0:
+        ID.AddInteger(I * 7919);
+        Builder.AddInteger(I * 7919);
+        break;
+      case 1:
+        ID.AddPointer(&Object + I);
+        Builder.AddPointer(&Object + I);
+        break;
+      case 2:
+        ID.AddInteger(-1LL - I);
+        Builder.AddInteger(-1LL - I);
+        break;
+      case 3:
+        ID.AddBoolean(I & 8);
+        Builder.AddBoolean(I & 8);
+        break;
+      }
+    }
+    EXPECT_EQ(ID.ComputeHash(), Builder.ComputeHash()) << "size " << Size;
+  }
+}
+
+struct CountingPair : public TrivialPair {
+  static unsigned NumProfiles;
+
+  CountingPair(unsigned K, unsigned V) : TrivialPair(K, V) {}
+
+  void Profile(FoldingSetNodeID &ID) const {
+    ++NumProfiles;
+    TrivialPair::Profile(ID);
+  }
+};
+unsigned CountingPair::NumProfiles = 0;
+
+TEST(FoldingSetTest, FindWithHash) {
+  CountingPair::NumProfiles = 0;
+  FoldingSet<CountingPair> Set;
+  std::vector<std::unique_ptr<CountingPair>> Nodes;
+  for (unsigned I = 0; I != 1000; ++I) {
+    FoldingSetHashBuilder Builder;
+    Builder.AddInteger(I);
+    Builder.AddInteger(I + 1);
+    unsigned Hash = Builder.ComputeHash();
+    void *InsertPos;
+    auto Equals = [&](CountingPair *N) {
+      return N->Key == I && N->Value == I + 1;
+    };
+    EXPECT_EQ(nullptr, Set.FindNodeOrInsertPos(Hash, Equals, InsertPos));
+    Nodes.push_back(llvm::make_unique<CountingPair>(I, I + 1));
+    Set.InsertNode(Nodes.back().get(), InsertPos, Hash);
+  }
+  // The hashes are known, so neither the lookups nor growing the table
+  // profiled a node.
+  EXPECT_EQ(0U, CountingPair::NumProfiles);
+
+  for (unsigned I = 0; I != 1000; ++I) {
+    FoldingSetNodeID ID;
+    ID.AddInteger(I);
+    ID.AddInteger(I + 1);
+    void *InsertPos;
+    EXPECT_EQ(Nodes[I].get(), Set.FindNodeOrInsertPos(ID, InsertPos));
+  }
+  // Lookups by ID only profile the node they find.
+  EXPECT_EQ(1000U, CountingPair::NumProfiles);
+}
+
+TEST(FoldingSetTest, HashIsCachedAfterInsert) {
+  CountingPair::NumProfiles = 0;
+  FoldingSet<CountingPair> Set;
+  std::vector<std::unique_ptr<CountingPair>> Nodes;
+  for (unsigned I = 0; I != 1000; ++I) {
+    Nodes.push_back(llvm::make_unique<CountingPair>(I, 0));
+    Set.InsertNode(Nodes.back().get());
+  }
+  // Each node was profiled once when it was inserted, but not again when the
+  // table grew.
+  EXPECT_EQ(1000U, CountingPair::NumProfiles);
+  CountingPair::NumProfiles = 0;
+
+  // A node may be profiled differently after it is removed and inserted
+  // again.
+  Set.RemoveNode(Nodes[0].get());
+  Nodes[0]->Value = 1;
+  Set.InsertNode(Nodes[0].get());
+  FoldingSetNodeID ID;
+  Nodes[0]->Profile(ID);
+  void *InsertPos;
+  EXPECT_EQ(Nodes[0].get(), Set.FindNodeOrInsertPos(ID, InsertPos));
+}
+
 }
 
@@ -13,6 +13,7 @@
 
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/STLExtras.h"
 #include "llvm/Support/Compiler.h"
 #include "gtest/gtest.h"
 #include <list>
@@ -995,4 +996,51 @@ TEST(SmallVectorTest, InitializerList) {
   EXPECT_TRUE(makeArrayRef(V2).equals({4, 5, 3, 2}));
 }
 
+// Counts how often it is moved and destroyed, which growing a vector of
+// trivially relocatable elements should never do.
+struct Relocatable {
+  static int NumMoves, NumDestroys;
+  int Value;
+  explicit Relocatable(int Value) : Value(Value) {}
+  Relocatable(Relocatable &&R) : Value(R.Value) { ++NumMoves; }
+  ~Relocatable() { ++NumDestroys; }
+};
+int Relocatable::NumMoves, Relocatable::NumDestroys;
+
+} // end namespace
+
+namespace llvm {
+template <> struct isTriviallyRelocatable<Relocatable> {
+  static const bool value = true;
+};
+} // end namespace llvm
+
+namespace {
+
+static_assert(isTriviallyRelocatable<int>::value, "pod-like is relocatable");
+static_assert(isTriviallyRelocatable<std::unique_ptr<int>>::value,
+              "unique_ptr is relocatable");
+static_assert(!isTriviallyRelocatable<SmallVector<int, 1>>::value,
+              "SmallVector points into its inline storage");
+
+TEST(SmallVectorTest, GrowTriviallyRelocatable) {
+  Relocatable::NumMoves = Relocatable::NumDestroys = 0;
+  {
+    SmallVector<Relocatable, 2> V;
+    for (int I = 0; I != 100; ++I)
+      V.emplace_back(I);
+    for (int I = 0; I != 100; ++I)
+      EXPECT_EQ(I, V[I].Value);
+    EXPECT_EQ(0, Relocatable::NumMoves);
+    EXPECT_EQ(0, Relocatable::NumDestroys);
+  }
+  EXPECT_EQ(100, Relocatable::NumDestroys);
+
+  SmallVector<std::unique_ptr<int>, 1> Ptrs;
+  for (int I = 0; I != 100; ++I)
+    Ptrs.push_back(llvm::make_unique<int>(I));
+  for (int I = 0; I != 100; ++I)
+    EXPECT_EQ(I, *Ptrs[I]);
+}
+
 } // end namespace
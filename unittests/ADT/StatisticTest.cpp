@@ -8,8 +8,10 @@
 //===----------------------------------------------------------------------===//
 
 #include "llvm/ADT/Statistic.h"
+#include "llvm/Support/JSON.h"
 #include "llvm/Support/raw_ostream.h"
 #include "gtest/gtest.h"
+#include <thread>
 using namespace llvm;
 
 using OptionalStatistic = Optional<std::pair<StringRef, unsigned>>;
@@ -157,4 +159,40 @@ TEST(StatisticTest, API) {
 #endif
 }
 
+#if LLVM_ENABLE_STATS && LLVM_ENABLE_THREADS
+TEST(StatisticTest, Threads) {
+  EnableStatistics();
+  ResetStatistics();
+
+  Counter = 5;
+  std::vector<std::thread> Threads;
+  for (unsigned I = 0; I != 4; ++I)
+    Threads.emplace_back([] {
+      for (unsigned J = 0; J != 1000; ++J)
+        ++Counter;
+      Counter2 += 3;
+      --Counter2;
+    });
+  for (std::thread &T : Threads)
+    T.join();
+  EXPECT_EQ(Counter, 4005u);
+  EXPECT_EQ(Counter2, 8u);
+
+  // Assigning accounts for the counts of the threads, exited or not.
+  Counter2++;
+  Counter2 = 1;
+  EXPECT_EQ(Counter2, 1u);
+
+  json::Object Stats = GetStatisticsJSON();
+  EXPECT_EQ(Stats.size(), 2u);
+  EXPECT_EQ(Stats.getInteger("unittest.Counter"), int64_t(4005));
+  EXPECT_EQ(Stats.getInteger("unittest.Counter2"), int64_t(1));
+
+  ResetStatistics();
+  EXPECT_EQ(Counter, 0u);
+  EXPECT_EQ(Counter2, 0u);
+  EXPECT_TRUE(GetStatisticsJSON().empty());
+}
+#endif
+
 } // end anonymous namespace
@@ -532,4 +532,20 @@ TEST(StringMapCustomTest, StringMapEntrySize) {
   EXPECT_EQ(LargeValue, Key.size());
 }
 
+TEST(StringMapCustomTest, PrecomputedHash) {
+  StringMap<int> Map;
+  uint32_t Hash = StringMapImpl::hash("abc");
+  EXPECT_TRUE(Map.try_emplace_with_hash("abc", Hash, 1).second);
+  EXPECT_FALSE(Map.try_emplace_with_hash("abc", Hash, 2).second);
+  EXPECT_EQ(1, Map.find("abc", Hash)->second);
+  EXPECT_EQ(1u, Map.count("abc", Hash));
+  // The entry is found by the keyed lookups as well.
+  EXPECT_EQ(1, Map.lookup("abc"));
+  Map["def"] = 3;
+  EXPECT_EQ(3, Map.find("def", StringMapImpl::hash("def"))->second);
+  const StringMap<int> &ConstMap = Map;
+  EXPECT_TRUE(ConstMap.find("ghi", StringMapImpl::hash("ghi")) ==
+              ConstMap.end());
+}
+
 } // end anonymous namespace
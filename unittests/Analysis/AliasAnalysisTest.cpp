@@ -205,6 +205,37 @@ TEST_F(AliasAnalysisTest, getModRefInfo) {
   EXPECT_EQ(AA.getModRefInfo(AtomicRMW, None), ModRefInfo::ModRef);
 }
 
+TEST_F(AliasAnalysisTest, BatchAAResults) {
+  // Setup function.
+  FunctionType *FTy =
+      FunctionType::get(Type::getVoidTy(C), std::vector<Type *>(), false);
+  auto *F = cast<Function>(M.getOrInsertFunction("f", FTy));
+  auto *BB = BasicBlock::Create(C, "entry", F);
+  auto IntType = Type::getInt32Ty(C);
+  auto *Value = ConstantInt::get(IntType, 42);
+  auto *A1 = new AllocaInst(IntType, 0, "a1", BB);
+  auto *A2 = new AllocaInst(IntType, 0, "a2", BB);
+  auto *Store1 = new StoreInst(Value, A1, BB);
+  ReturnInst::Create(C, nullptr, BB);
+
+  auto &AA = getAAResults(*F);
+  BatchAAResults BatchAA(AA);
+
+  MemoryLocation Loc1(A1, LocationSize::precise(4));
+  MemoryLocation Loc2(A2, LocationSize::precise(4));
+
+  // Cached results must match the uncached ones, in both query orders.
+  for (int I = 0; I != 2; ++I) {
+    EXPECT_EQ(BatchAA.alias(Loc1, Loc2), NoAlias);
+    EXPECT_EQ(BatchAA.alias(Loc2, Loc1), NoAlias);
+    EXPECT_EQ(BatchAA.alias(Loc1, Loc1), MustAlias);
+    EXPECT_EQ(BatchAA.getModRefInfo(Store1, Loc1),
+              AA.getModRefInfo(Store1, Loc1));
+    EXPECT_EQ(BatchAA.getModRefInfo(Store1, Loc2), ModRefInfo::NoModRef);
+    EXPECT_EQ(BatchAA.getModRefInfo(Store1, None), ModRefInfo::Mod);
+  }
+}
+
 class AAPassInfraTest : public testing::Test {
 protected:
   LLVMContext C;
@@ -0,0 +1,42 @@
+//===- PagerandoTest.cpp --------------------------------------------------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/BinaryFormat/Pagerando.h"
+#include "gtest/gtest.h"
+
+using namespace llvm;
+
+namespace {
+
+TEST(PagerandoTest, ExpandPackedPOT) {
+  char Bins[64];
+  int32_t Packed[5];
+  auto Offset = [&](unsigned Entry, unsigned BinOffset) {
+    return static_cast<int32_t>(reinterpret_cast<intptr_t>(Bins + BinOffset) -
+                                reinterpret_cast<intptr_t>(&Packed[Entry]));
+  };
+
+  // Two modules with two and one bins
+  Packed[0] = 2;
+  Packed[1] = Offset(1, 0);
+  Packed[2] = Offset(2, 16);
+  Packed[3] = 1;
+  Packed[4] = Offset(4, 32);
+
+  uintptr_t POT[5] = {42, 0, 0, 43, 0};
+  uintptr_t *End = pagerando::expandPackedPOT(POT, Packed, Packed + 5);
+  EXPECT_EQ(POT + 5, End);
+  EXPECT_EQ(42u, POT[0]);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(Bins), POT[1]);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(Bins + 16), POT[2]);
+  EXPECT_EQ(43u, POT[3]);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(Bins + 32), POT[4]);
+}
+
+} // end anonymous namespace
@@ -16,20 +16,21 @@ namespace {
 
 struct PagerandoBinningFirstFitTest : public testing::Test {
   PagerandoBinnerBase::FirstFitAlgo Algo;
+  unsigned BinSize = 4096;
 
   void ASSERT_ASSIGNMENTS(
       std::initializer_list<std::pair<unsigned, unsigned>> Assignments) {
     for (auto &A : Assignments) {
       unsigned FnSize, ExpectedBin;
       std::tie(FnSize, ExpectedBin) = A;
-      unsigned Bin = Algo.assignToBin(FnSize);
+      unsigned Bin = Algo.assignToBin(FnSize, BinSize);
       ASSERT_EQ(Bin, ExpectedBin);
     }
   }
 };
 
 TEST_F(PagerandoBinningFirstFitTest, NeverReturnsDefaultBin) {
-  ASSERT_NE(Algo.assignToBin(100), 0u);
+  ASSERT_NE(Algo.assignToBin(100, BinSize), 0u);
 }
 
 TEST_F(PagerandoBinningFirstFitTest, UsesGreedyAlgorithm) {
@@ -85,4 +86,14 @@ TEST_F(PagerandoBinningFirstFitTest, LargeFunctionsAreStillPacked) {
   });
 }
 
+TEST_F(PagerandoBinningFirstFitTest, HonorsBinSize) {
+  BinSize = 16384;
+  ASSERT_ASSIGNMENTS({
+     {4096, 1},
+     {8192, 1},
+     {4096, 1},
+     {   1, 2},
+  });
+}
+
 } // end anonymous namespace
@@ -0,0 +1,126 @@
+//===- llvm/unittest/DebugInfo/CodeView/TypeStreamMergerTest.cpp ----------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/DebugInfo/CodeView/TypeStreamMerger.h"
+#include "llvm/DebugInfo/CodeView/AppendingTypeTableBuilder.h"
+#include "llvm/DebugInfo/CodeView/GlobalTypeTableBuilder.h"
+#include "llvm/DebugInfo/CodeView/TypeHashing.h"
+#include "llvm/Support/BinaryStreamReader.h"
+#include "llvm/Testing/Support/Error.h"
+
+#include "gtest/gtest.h"
+
+using namespace llvm;
+using namespace llvm::codeview;
+
+namespace {
+
+struct Source {
+  std::vector<uint8_t> Buffer;
+  CVTypeArray IdsAndTypes;
+  std::vector<GloballyHashedType> Hashes;
+
+  void init(AppendingTypeTableBuilder &Builder) {
+    for (ArrayRef<uint8_t> Record : Builder.records())
+      Buffer.insert(Buffer.end(), Record.begin(), Record.end());
+    BinaryStreamReader Reader(BinaryStreamRef(Buffer, support::little));
+    cantFail(Reader.readArray(IdsAndTypes, Reader.getLength()));
+    Hashes = GloballyHashedType::hashTypes(Builder.records());
+  }
+};
+
+TypeIndex addPointer(AppendingTypeTableBuilder &Builder, TypeIndex TI) {
+  PointerRecord PR(TypeRecordKind::Pointer);
+  PR.setAttrs(PointerKind::Near32, PointerMode::Pointer, PointerOptions::None,
+              4);
+  PR.ReferentType = TI;
+  return Builder.writeLeafType(PR);
+}
+
+TypeIndex addProcedure(AppendingTypeTableBuilder &Builder, TypeIndex Return,
+                       TypeIndex Arg) {
+  ArgListRecord AR(TypeRecordKind::ArgList);
+  AR.ArgIndices.push_back(Arg);
+  ProcedureRecord PR(TypeRecordKind::Procedure);
+  PR.ArgumentList = Builder.writeLeafType(AR);
+  PR.CallConv = CallingConvention::NearC;
+  PR.Options = FunctionOptions::None;
+  PR.ParameterCount = 1;
+  PR.ReturnType = Return;
+  return Builder.writeLeafType(PR);
+}
+
+TypeIndex addFuncId(AppendingTypeTableBuilder &Builder, TypeIndex Proc,
+                    StringRef Name) {
+  FuncIdRecord FR(TypeIndex(), Proc, Name);
+  return Builder.writeLeafType(FR);
+}
+
+TEST(TypeStreamMergerTest, ParallelGlobalHashMergeMatchesSerial) {
+  TypeIndex CharP(SimpleTypeKind::SignedCharacter, SimpleTypeMode::NearPointer);
+  TypeIndex IntP(SimpleTypeKind::Int32, SimpleTypeMode::NearPointer);
+
+  BumpPtrAllocator Alloc;
+  Source Sources[3];
+  {
+    AppendingTypeTableBuilder B(Alloc);
+    TypeIndex CharPP = addPointer(B, CharP);
+    TypeIndex IntPP = addPointer(B, IntP);
+    addFuncId(B, addProcedure(B, IntPP, CharPP), "f");
+    Sources[0].init(B);
+  }
+  {
+    // The same types in another order, plus new ones referring to them.
+    AppendingTypeTableBuilder B(Alloc);
+    TypeIndex IntPP = addPointer(B, IntP);
+    TypeIndex CharPP = addPointer(B, CharP);
+    TypeIndex Proc = addProcedure(B, IntPP, CharPP);
+    addFuncId(B, Proc, "f");
+    addFuncId(B, Proc, "g");
+    addPointer(B, addPointer(B, IntPP));
+    Sources[1].init(B);
+  }
+  {
+    AppendingTypeTableBuilder B(Alloc);
+    TypeIndex IntPPP = addPointer(B, addPointer(B, IntP));
+    addFuncId(B, addProcedure(B, IntPPP, IntPPP), "h");
+    Sources[2].init(B);
+  }
+
+  GlobalTypeTableBuilder SerialIds(Alloc), SerialTypes(Alloc);
+  SmallVector<TypeIndex, 0> SerialMaps[3];
+  for (unsigned I = 0; I != 3; ++I) {
+    Optional<EndPrecompRecord> EP;
+    ASSERT_THAT_ERROR(mergeTypeAndIdRecords(SerialIds, SerialTypes,
+                                            SerialMaps[I],
+                                            Sources[I].IdsAndTypes,
+                                            Sources[I].Hashes, EP),
+                      Succeeded());
+  }
+
+  for (unsigned NumThreads : {1, 4}) {
+    GlobalTypeTableBuilder Ids(Alloc), Types(Alloc);
+    SmallVector<TypeIndex, 0> Maps[3];
+    std::vector<GloballyHashedTypeSource> Inputs;
+    for (const Source &S : Sources)
+      Inputs.push_back({&S.IdsAndTypes, S.Hashes});
+    ASSERT_THAT_ERROR(
+        mergeTypeAndIdRecords(Ids, Types, Maps, Inputs, NumThreads),
+        Succeeded());
+
+    EXPECT_EQ(SerialIds.records(), Ids.records());
+    EXPECT_EQ(SerialTypes.records(), Types.records());
+    for (unsigned I = 0; I != 3; ++I)
+      EXPECT_EQ(SerialMaps[I], Maps[I]);
+  }
+  EXPECT_EQ(3u, SerialIds.size());
+  EXPECT_EQ(8u, SerialTypes.size());
+}
+
+} // end anonymous namespace
@@ -664,4 +664,73 @@ TEST_F(DebugLineBasicFixture, ParserIgnoresNonPrologueErrorsWhenSkipping) {
   EXPECT_FALSE(Unrecoverable);
 }
 
+TEST(DWARFDebugLineTable, LookupAddressWithCursor) {
+  DWARFDebugLine::LineTable LT;
+  auto AddSequence = [&](ArrayRef<uint64_t> Addresses) {
+    DWARFDebugLine::Sequence Seq;
+    Seq.FirstRowIndex = LT.Rows.size();
+    for (uint64_t Address : Addresses) {
+      DWARFDebugLine::Row Row;
+      Row.Address = Address;
+      Row.Line = LT.Rows.size() + 1;
+      LT.appendRow(Row);
+    }
+    LT.Rows.back().EndSequence = true;
+    Seq.LowPC = Addresses.front();
+    Seq.HighPC = Addresses.back();
+    Seq.LastRowIndex = LT.Rows.size();
+    Seq.Empty = false;
+    LT.appendSequence(Seq);
+  };
+  AddSequence({0x1000, 0x1004, 0x1004, 0x1008, 0x1010});
+  AddSequence({0x2000, 0x2008});
+
+  // Lookups through a cursor must agree with independent lookups.
+  DWARFDebugLine::LineTable::Cursor C;
+  for (uint64_t Address : {0x0, 0x1000, 0x1000, 0x1002, 0x1004, 0x1006, 0x1008,
+                           0x100f, 0x1010, 0x1800, 0x2000, 0x2007, 0x2008})
+    EXPECT_EQ(LT.lookupAddress(Address), LT.lookupAddress(Address, C))
+        << "address 0x" << utohexstr(Address);
+}
+
+TEST(DWARFDebugLineTable, LookupAddressMatchesLinearSearch) {
+  DWARFDebugLine::LineTable LT;
+  // Sequences of different lengths, to exercise incomplete levels of the
+  // search trees, with some rows sharing an address.
+  for (unsigned NumRows = 1; NumRows != 20; ++NumRows) {
+    DWARFDebugLine::Sequence Seq;
+    Seq.FirstRowIndex = LT.Rows.size();
+    Seq.LowPC = 0x1000 * NumRows;
+    for (unsigned I = 0; I != NumRows; ++I) {
+      DWARFDebugLine::Row Row;
+      Row.Address = Seq.LowPC + 4 * (I - I % 3);
+      LT.appendRow(Row);
+    }
+    Seq.HighPC = LT.Rows.back().Address + 4;
+    LT.Rows.back().EndSequence = true;
+    Seq.LastRowIndex = LT.Rows.size();
+    Seq.Empty = false;
+    LT.appendSequence(Seq);
+  }
+
+  for (uint64_t Address = 0; Address != 0x14000; Address += 2) {
+    // The first row at the address, or else the last row before it, of the
+    // sequence containing the address.
+    uint32_t Expected = LT.UnknownRowIndex;
+    for (const DWARFDebugLine::Sequence &Seq : LT.Sequences) {
+      if (!Seq.containsPC(Address))
+        continue;
+      for (uint32_t I = Seq.FirstRowIndex; I != Seq.LastRowIndex; ++I) {
+        if (LT.Rows[I].Address > Address)
+          break;
+        if (Expected == LT.UnknownRowIndex ||
+            LT.Rows[Expected].Address != Address)
+          Expected = I;
+      }
+    }
+    EXPECT_EQ(Expected, LT.lookupAddress(Address))
+        << "address 0x" << utohexstr(Address);
+  }
+}
+
 } // end anonymous namespace
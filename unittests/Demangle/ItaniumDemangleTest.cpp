@@ -8,10 +8,12 @@
 //===----------------------------------------------------------------------===//
 
 #include "llvm/Demangle/ItaniumDemangle.h"
+#include "llvm/Demangle/Demangle.h"
 #include "llvm/Support/Allocator.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include <cstdlib>
+#include <string>
 #include <vector>
 
 using namespace llvm;
@@ -52,3 +54,36 @@ TEST(ItaniumDemangle, MethodOverride) {
   ASSERT_NE(nullptr, Parser.parse());
   EXPECT_THAT(Parser.Types, testing::ElementsAre('i', 'j', 'l'));
 }
+
+TEST(ItaniumDemangle, Context) {
+  // A name whose AST does not fit in one block of the allocator, so that the
+  // following names reuse the blocks it allocated.
+  std::string Long = "_Z1f";
+  for (unsigned I = 0; I != 400; ++I)
+    Long += "PFvPiE";
+
+  const char *Names[] = {"_Z1fv", Long.c_str(), "_ZN1a1bIiEEvT_", "not_mangled",
+                         "_ZNSt6vectorIiSaIiEE9push_backERKi"};
+  ItaniumDemangleContext Demangler;
+  ASSERT_NE(nullptr, Demangler.demangle(Long.c_str()));
+  for (const char *Name : Names) {
+    int Status;
+    char *Expected = itaniumDemangle(Name, nullptr, nullptr, &Status);
+    const char *Demangled = Demangler.demangle(Name);
+    if (Expected)
+      EXPECT_STREQ(Expected, Demangled);
+    else
+      EXPECT_EQ(nullptr, Demangled);
+    std::free(Expected);
+  }
+
+  size_t Offsets[array_lengthof(Names)];
+  const char *Buf = Demangler.demangle(Names, array_lengthof(Names), Offsets);
+  EXPECT_STREQ("f()", Buf + Offsets[0]);
+  EXPECT_EQ(0u, Offsets[0]);
+  EXPECT_EQ(4u, Offsets[1]);
+  EXPECT_STREQ("void a::b<int>(int)", Buf + Offsets[2]);
+  EXPECT_STREQ("not_mangled", Buf + Offsets[3]);
+  EXPECT_STREQ("std::vector<int, std::allocator<int> >::push_back(int const&)",
+               Buf + Offsets[4]);
+}
@@ -0,0 +1,99 @@
+//===--- CompileOnDemandLayerTest.cpp - Unit tests for the lazy CODLayer --===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "OrcTestCommon.h"
+#include "llvm/Bitcode/BitcodeWriter.h"
+#include "llvm/ExecutionEngine/Orc/CompileOnDemandLayer.h"
+#include "llvm/ExecutionEngine/Orc/CompileUtils.h"
+#include "llvm/ExecutionEngine/Orc/IRCompileLayer.h"
+#include "llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h"
+#include "llvm/ExecutionEngine/Orc/RTDyldObjectLinkingLayer.h"
+#include "llvm/ExecutionEngine/SectionMemoryManager.h"
+#include "llvm/IR/IRBuilder.h"
+#include "gtest/gtest.h"
+
+using namespace llvm;
+using namespace llvm::orc;
+
+namespace {
+
+TEST(CompileOnDemandLayerTest, ReadsOnlyCalledFunctionsOfLazyModule) {
+  OrcNativeTarget::initialize();
+
+  auto JTMB = JITTargetMachineBuilder::detectHost();
+
+  // Bail out if we can not detect the host.
+  if (!JTMB) {
+    consumeError(JTMB.takeError());
+    return;
+  }
+
+  const Triple &TT = JTMB->getTargetTriple();
+  if (TT.getArch() != Triple::x86_64 || TT.isOSWindows())
+    return;
+
+  auto TM = JTMB->createTargetMachine();
+  if (!TM) {
+    consumeError(TM.takeError());
+    return;
+  }
+
+  // Write a module with "int used()" and "int unused()" functions to bitcode.
+  SmallVector<char, 0> Bitcode;
+  {
+    LLVMContext Ctx;
+    ModuleBuilder MB(Ctx, TT.str(), "lazy");
+    MB.getModule()->setDataLayout((*TM)->createDataLayout());
+    for (auto &NameAndValue : {std::make_pair("used", 42),
+                               std::make_pair("unused", 7)}) {
+      Function *F = MB.createFunctionDecl<int()>(NameAndValue.first);
+      IRBuilder<> B(BasicBlock::Create(Ctx, "entry", F));
+      B.CreateRet(B.getInt32(NameAndValue.second));
+    }
+    raw_svector_ostream OS(Bitcode);
+    WriteBitcodeToFile(*MB.getModule(), OS);
+  }
+
+  ThreadSafeContext TSCtx(llvm::make_unique<LLVMContext>());
+  auto TSM = cantFail(loadLazyBitcodeModule(
+      MemoryBuffer::getMemBuffer(StringRef(Bitcode.data(), Bitcode.size()),
+                                 "lazy", false),
+      TSCtx));
+  Module *SrcM = TSM.getModule();
+  EXPECT_TRUE(SrcM->getFunction("used")->isMaterializable());
+  EXPECT_TRUE(SrcM->getFunction("unused")->isMaterializable());
+
+  ExecutionSession ES;
+  auto &JD = ES.createJITDylib("main");
+
+  auto LCTM = createLocalLazyCallThroughManager(TT, ES, 0);
+  if (!LCTM) {
+    consumeError(LCTM.takeError());
+    return;
+  }
+
+  RTDyldObjectLinkingLayer ObjLayer(
+      ES, []() { return llvm::make_unique<SectionMemoryManager>(); });
+  IRCompileLayer CompileLayer(ES, ObjLayer, SimpleCompiler(**TM));
+  CompileOnDemandLayer CODLayer(ES, CompileLayer, **LCTM,
+                                createLocalIndirectStubsManagerBuilder(TT));
+
+  cantFail(CODLayer.add(JD, std::move(TSM), ES.allocateVModule()));
+
+  MangleAndInterner Mangle(ES, (*TM)->createDataLayout());
+  auto UsedSym = cantFail(ES.lookup({&JD}, Mangle("used")));
+  auto *Used = jitTargetAddressToPointer<int (*)()>(UsedSym.getAddress());
+  EXPECT_EQ(Used(), 42);
+
+  // The rest of the module stays with the layer, and the body of the
+  // function that was never called has not been read.
+  EXPECT_TRUE(SrcM->getFunction("unused")->isMaterializable());
+}
+
+} // end anonymous namespace
@@ -0,0 +1,105 @@
+//===----- LocalObjectCacheTest.cpp - Unit tests for LocalObjectCache -----===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ExecutionEngine/Orc/LocalObjectCache.h"
+#include "llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h"
+#include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Path.h"
+#include "gtest/gtest.h"
+
+using namespace llvm;
+using namespace llvm::orc;
+
+namespace {
+
+class LocalObjectCacheTest : public testing::Test {
+protected:
+  void SetUp() override {
+    ASSERT_FALSE(
+        sys::fs::createUniqueDirectory("LocalObjectCacheTest", CacheDir));
+  }
+
+  void TearDown() override { sys::fs::remove_directories(CacheDir); }
+
+  // Build a module with an "int f()" function returning Value.
+  std::unique_ptr<Module> createModule(int Value) {
+    auto M = llvm::make_unique<Module>("M", Ctx);
+    auto *F = Function::Create(
+        FunctionType::get(Type::getInt32Ty(Ctx), false),
+        GlobalValue::ExternalLinkage, "f", M.get());
+    IRBuilder<> B(BasicBlock::Create(Ctx, "entry", F));
+    B.CreateRet(B.getInt32(Value));
+    return M;
+  }
+
+  std::unique_ptr<LocalObjectCache> createCache(StringRef CPU = "") {
+    JITTargetMachineBuilder JTMB(Triple("x86_64-unknown-linux-gnu"));
+    JTMB.setCPU(CPU);
+    auto Cache = LocalObjectCache::Create(CacheDir, JTMB);
+    EXPECT_TRUE(!!Cache);
+    return Cache ? std::move(*Cache) : nullptr;
+  }
+
+  unsigned countEntries() {
+    unsigned Entries = 0;
+    std::error_code EC;
+    for (sys::fs::directory_iterator I(CacheDir, EC), E; I != E && !EC;
+         I.increment(EC))
+      if (sys::path::filename(I->path()).startswith("llvmcache-"))
+        ++Entries;
+    return Entries;
+  }
+
+  LLVMContext Ctx;
+  SmallString<128> CacheDir;
+};
+
+TEST_F(LocalObjectCacheTest, StoreAndLoad) {
+  auto Cache = createCache();
+  ASSERT_TRUE(!!Cache);
+
+  auto M = createModule(1);
+  EXPECT_EQ(Cache->getObject(M.get()), nullptr);
+  // Code generation modifies the module before the object is stored.
+  M->getFunction("f")->setName("g");
+  Cache->notifyObjectCompiled(M.get(), MemoryBufferRef("object", "M"));
+  EXPECT_EQ(countEntries(), 1U);
+
+  // A second cache on the directory, as after a restart, finds the object
+  // for an identical module.
+  auto RestartedCache = createCache();
+  ASSERT_TRUE(!!RestartedCache);
+  auto SameM = createModule(1);
+  auto Obj = RestartedCache->getObject(SameM.get());
+  ASSERT_NE(Obj, nullptr);
+  EXPECT_EQ(Obj->getBuffer(), "object");
+
+  auto OtherM = createModule(2);
+  EXPECT_EQ(RestartedCache->getObject(OtherM.get()), nullptr);
+}
+
+TEST_F(LocalObjectCacheTest, KeyDependsOnTarget) {
+  auto GenericCache = createCache();
+  auto HaswellCache = createCache("haswell");
+  ASSERT_TRUE(GenericCache && HaswellCache);
+
+  auto M = createModule(1);
+  EXPECT_EQ(GenericCache->getKey(*M), GenericCache->getKey(*createModule(1)));
+  EXPECT_NE(GenericCache->getKey(*M), HaswellCache->getKey(*M));
+
+  EXPECT_EQ(GenericCache->getObject(M.get()), nullptr);
+  GenericCache->notifyObjectCompiled(M.get(), MemoryBufferRef("object", "M"));
+  EXPECT_EQ(HaswellCache->getObject(M.get()), nullptr);
+  EXPECT_NE(GenericCache->getObject(M.get()), nullptr);
+}
+
+} // end anonymous namespace
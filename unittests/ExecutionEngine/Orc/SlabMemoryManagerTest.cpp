@@ -0,0 +1,137 @@
+//===---- SlabMemoryManagerTest.cpp - Unit tests for SlabMemoryManager ----===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ExecutionEngine/Orc/SlabMemoryManager.h"
+#include "llvm/ExecutionEngine/JITSymbol.h"
+#include "llvm/Support/Process.h"
+#include "gtest/gtest.h"
+#include <cstring>
+#include <set>
+
+using namespace llvm;
+using namespace llvm::orc;
+
+namespace {
+
+using AllocationPurpose = SlabMemoryPool::AllocationPurpose;
+
+TEST(SlabMemoryManagerTest, PacksSectionsOfManyObjects) {
+  SlabMemoryPool Pool;
+  std::vector<std::unique_ptr<SlabMemoryManager>> MemMgrs;
+  std::set<uint64_t> TargetAddrs;
+  bool DualMapped = true;
+  for (unsigned I = 0; I != 100; ++I) {
+    MemMgrs.push_back(llvm::make_unique<SlabMemoryManager>(Pool));
+    uint8_t *Code = MemMgrs.back()->allocateCodeSection(64, 16, 0, ".text");
+    ASSERT_NE(Code, nullptr);
+    uint64_t TargetAddr = MemMgrs.back()->getTargetAddress(Code);
+    EXPECT_EQ(TargetAddr % 16, 0U);
+    EXPECT_TRUE(TargetAddrs.insert(TargetAddr).second);
+    DualMapped &= TargetAddr != pointerToJITTargetAddress(Code);
+    EXPECT_FALSE(MemMgrs.back()->finalizeMemory());
+  }
+
+  // All the sections fit in one slab. Without a second mapping, they are
+  // padded to whole pages.
+  auto Stats = Pool.getStatistics(AllocationPurpose::Code);
+  EXPECT_EQ(Stats.NumSlabs, 1U);
+  EXPECT_EQ(Stats.AllocatedBytes,
+            DualMapped ? 100U * 64 : 100U * sys::Process::getPageSize());
+  EXPECT_EQ(Stats.AllocatedBytes + Stats.FreeBytes, Stats.MappedBytes);
+  EXPECT_EQ(Stats.NumFreeRanges, 1U);
+  EXPECT_EQ(Pool.getStatistics(AllocationPurpose::RWData).NumSlabs, 0U);
+}
+
+TEST(SlabMemoryManagerTest, ReusesFreedSections) {
+  SlabMemoryPool Pool;
+  auto MemMgr1 = llvm::make_unique<SlabMemoryManager>(Pool);
+  auto MemMgr2 = llvm::make_unique<SlabMemoryManager>(Pool);
+  auto MemMgr3 = llvm::make_unique<SlabMemoryManager>(Pool);
+  uint8_t *Data1 = MemMgr1->allocateDataSection(256, 8, 0, ".data", false);
+  uint8_t *Data2 = MemMgr2->allocateDataSection(256, 8, 0, ".data", false);
+  ASSERT_NE(MemMgr3->allocateDataSection(256, 8, 0, ".data", false), nullptr);
+  EXPECT_EQ(Data1 + 256, Data2);
+
+  // Freeing the middle section leaves a hole.
+  MemMgr2.reset();
+  auto Stats = Pool.getStatistics(AllocationPurpose::RWData);
+  EXPECT_EQ(Stats.AllocatedBytes, 512U);
+  EXPECT_EQ(Stats.NumFreeRanges, 2U);
+  EXPECT_GT(Stats.getFragmentation(), 0.0);
+
+  // The hole is reused first.
+  auto MemMgr4 = llvm::make_unique<SlabMemoryManager>(Pool);
+  EXPECT_EQ(MemMgr4->allocateDataSection(128, 8, 0, ".data", false), Data2);
+
+  // Free ranges are merged again once the sections are gone.
+  MemMgr1.reset();
+  MemMgr3.reset();
+  MemMgr4.reset();
+  Stats = Pool.getStatistics(AllocationPurpose::RWData);
+  EXPECT_EQ(Stats.AllocatedBytes, 0U);
+  EXPECT_EQ(Stats.NumFreeRanges, 1U);
+  EXPECT_EQ(Stats.FreeBytes, Stats.MappedBytes);
+  EXPECT_EQ(Stats.getFragmentation(), 0.0);
+}
+
+TEST(SlabMemoryManagerTest, LargeSectionGetsItsOwnSlab) {
+  SlabMemoryPool::Options Opts;
+  Opts.SlabSize = 64 * 1024;
+  SlabMemoryPool Pool(Opts);
+  SlabMemoryManager MemMgr(Pool);
+  ASSERT_NE(MemMgr.allocateDataSection(16, 8, 0, ".rodata", true), nullptr);
+  ASSERT_NE(MemMgr.allocateDataSection(100 * 1024, 8, 1, ".rodata", true),
+            nullptr);
+  auto Stats = Pool.getStatistics(AllocationPurpose::ROData);
+  EXPECT_EQ(Stats.NumSlabs, 2U);
+  EXPECT_GE(Stats.MappedBytes, 64U * 1024 + 100 * 1024);
+}
+
+#if defined(__x86_64__) && !defined(_WIN32)
+TEST(SlabMemoryManagerTest, RunsFinalizedCode) {
+  // mov eax, 42; ret
+  const uint8_t Return42[] = {0xb8, 0x2a, 0x00, 0x00, 0x00, 0xc3};
+
+  SlabMemoryPool Pool;
+  SlabMemoryManager MemMgr(Pool);
+  uint8_t *Code =
+      MemMgr.allocateCodeSection(sizeof(Return42), 16, 0, ".text");
+  ASSERT_NE(Code, nullptr);
+  memcpy(Code, Return42, sizeof(Return42));
+  std::string ErrMsg;
+  ASSERT_FALSE(MemMgr.finalizeMemory(&ErrMsg)) << ErrMsg;
+
+  auto *F = jitTargetAddressToPointer<int (*)()>(MemMgr.getTargetAddress(Code));
+  EXPECT_EQ(F(), 42);
+}
+
+TEST(SlabMemoryManagerTest, RunsPaddedCodeWithoutDualMapping) {
+  // mov eax, 42; ret
+  const uint8_t Return42[] = {0xb8, 0x2a, 0x00, 0x00, 0x00, 0xc3};
+
+  SlabMemoryPool::Options Opts;
+  Opts.UseDualMapping = false;
+  SlabMemoryPool Pool(Opts);
+  SlabMemoryManager MemMgr(Pool);
+  uint8_t *Code =
+      MemMgr.allocateCodeSection(sizeof(Return42), 16, 0, ".text");
+  ASSERT_NE(Code, nullptr);
+  EXPECT_EQ(MemMgr.getTargetAddress(Code), pointerToJITTargetAddress(Code));
+  EXPECT_EQ(Pool.getStatistics(AllocationPurpose::Code).AllocatedBytes,
+            sys::Process::getPageSize());
+  memcpy(Code, Return42, sizeof(Return42));
+  std::string ErrMsg;
+  ASSERT_FALSE(MemMgr.finalizeMemory(&ErrMsg)) << ErrMsg;
+
+  auto *F = reinterpret_cast<int (*)()>(Code);
+  EXPECT_EQ(F(), 42);
+}
+#endif
+
+} // end anonymous namespace
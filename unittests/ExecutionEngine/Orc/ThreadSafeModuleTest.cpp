@@ -55,6 +55,25 @@ TEST(ThreadSafeModuleTest, ContextOwnershipSharedWithClient) {
   ThreadSafeModule TSM2(std::move(M2), std::move(TSCtx));
 }
 
+TEST(ThreadSafeModuleTest, ContextSharing) {
+  // Test that a context is only shared while more than one ThreadSafeContext,
+  // ThreadSafeModule or lock refers to it.
+  ThreadSafeContext TSCtx(llvm::make_unique<LLVMContext>());
+  EXPECT_FALSE(TSCtx.isShared());
+
+  auto M = llvm::make_unique<Module>("M", *TSCtx.getContext());
+  ThreadSafeModule TSM(std::move(M), TSCtx);
+  EXPECT_TRUE(TSM.getContext().isShared());
+
+  TSCtx = ThreadSafeContext();
+  EXPECT_FALSE(TSM.getContext().isShared());
+  {
+    auto Lock = TSM.getContextLock();
+    EXPECT_TRUE(TSM.getContext().isShared());
+  }
+  EXPECT_FALSE(TSM.getContext().isShared());
+}
+
 TEST(ThreadSafeModuleTest, ThreadSafeModuleMoveAssignment) {
   // Move assignment needs to move the module before the context (opposite
   // to the field order) to ensure that overwriting with an empty
@@ -0,0 +1,117 @@
+//===---- TieredCompileLayerTest.cpp - Unit tests for tiered compilation --===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "OrcTestCommon.h"
+#include "llvm/ExecutionEngine/Orc/CompileUtils.h"
+#include "llvm/ExecutionEngine/Orc/IRCompileLayer.h"
+#include "llvm/ExecutionEngine/Orc/IRTransformLayer.h"
+#include "llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h"
+#include "llvm/ExecutionEngine/Orc/RTDyldObjectLinkingLayer.h"
+#include "llvm/ExecutionEngine/Orc/TieredCompileLayer.h"
+#include "llvm/ExecutionEngine/SectionMemoryManager.h"
+#include "llvm/IR/IRBuilder.h"
+#include "gtest/gtest.h"
+
+using namespace llvm;
+using namespace llvm::orc;
+
+namespace {
+
+TEST(TieredCompileLayerTest, RecompilesHotFunction) {
+  OrcNativeTarget::initialize();
+
+  auto JTMB = JITTargetMachineBuilder::detectHost();
+
+  // Bail out if we can not detect the host.
+  if (!JTMB) {
+    consumeError(JTMB.takeError());
+    return;
+  }
+
+  const Triple &TT = JTMB->getTargetTriple();
+  if (TT.getArch() != Triple::x86_64 || TT.isOSWindows())
+    return;
+
+  auto TM1 = JTMB->setCodeGenOptLevel(CodeGenOpt::None).createTargetMachine();
+  auto TM2 =
+      JTMB->setCodeGenOptLevel(CodeGenOpt::Aggressive).createTargetMachine();
+  if (!TM1 || !TM2) {
+    consumeError(TM1.takeError());
+    consumeError(TM2.takeError());
+    return;
+  }
+
+  ExecutionSession ES;
+  auto &JD = ES.createJITDylib("main");
+
+  auto LCTM = createLocalLazyCallThroughManager(TT, ES, 0);
+  if (!LCTM) {
+    consumeError(LCTM.takeError());
+    return;
+  }
+
+  RTDyldObjectLinkingLayer ObjLayer(
+      ES, []() { return llvm::make_unique<SectionMemoryManager>(); });
+  IRCompileLayer Tier1Layer(ES, ObjLayer, SimpleCompiler(**TM1));
+  IRCompileLayer CompileLayer2(ES, ObjLayer, SimpleCompiler(**TM2));
+
+  // Count the modules that reach the tier 2 compiler.
+  unsigned Tier2Modules = 0;
+  IRTransformLayer Tier2Layer(
+      ES, CompileLayer2,
+      [&](ThreadSafeModule TSM, const MaterializationResponsibility &R) {
+        ++Tier2Modules;
+        return std::move(TSM);
+      });
+
+  TieredCompileLayer TieredLayer(ES, Tier1Layer, Tier2Layer, **LCTM,
+                                 createLocalIndirectStubsManagerBuilder(TT),
+                                 /*HotThreshold=*/10);
+
+  // Create a module with an "int inc(int)" function, called through
+  // "int call_inc(int)".
+  ThreadSafeContext TSCtx(llvm::make_unique<LLVMContext>());
+  ThreadSafeModule M;
+  {
+    ModuleBuilder MB(*TSCtx.getContext(), TT.str(), "dummy");
+    MB.getModule()->setDataLayout((*TM1)->createDataLayout());
+
+    Function *Inc = MB.createFunctionDecl<int(int)>("inc");
+    IRBuilder<> B1(BasicBlock::Create(*TSCtx.getContext(), "entry", Inc));
+    B1.CreateRet(B1.CreateAdd(&*Inc->arg_begin(), B1.getInt32(1)));
+
+    Function *CallInc = MB.createFunctionDecl<int(int)>("call_inc");
+    IRBuilder<> B2(BasicBlock::Create(*TSCtx.getContext(), "entry", CallInc));
+    B2.CreateRet(B2.CreateCall(Inc, {&*CallInc->arg_begin()}));
+
+    M = ThreadSafeModule(MB.takeModule(), std::move(TSCtx));
+  }
+
+  cantFail(TieredLayer.add(JD, std::move(M), ES.allocateVModule()));
+
+  MangleAndInterner Mangle(ES, (*TM1)->createDataLayout());
+  auto CallIncSym = cantFail(ES.lookup({&JD}, Mangle("call_inc")));
+  auto *CallInc =
+      jitTargetAddressToPointer<int (*)(int)>(CallIncSym.getAddress());
+
+  // Both functions get hot at the tenth call.
+  for (int I = 0; I != 9; ++I)
+    EXPECT_EQ(CallInc(I), I + 1);
+  EXPECT_EQ(TieredLayer.getNumRecompiledFunctions(), 0U);
+  EXPECT_EQ(CallInc(9), 10);
+  EXPECT_EQ(TieredLayer.getNumRecompiledFunctions(), 2U);
+  EXPECT_EQ(Tier2Modules, 2U);
+
+  // The tier 2 code does not count its calls, and computes the same results.
+  for (int I = 10; I != 30; ++I)
+    EXPECT_EQ(CallInc(I), I + 1);
+  EXPECT_EQ(TieredLayer.getNumRecompiledFunctions(), 2U);
+}
+
+} // end anonymous namespace
@@ -476,5 +476,38 @@ TEST(ConstantsTest, BitcastToGEP) {
   ASSERT_EQ(cast<ConstantExpr>(C)->getOpcode(), Instruction::BitCast);
 }
 
+TEST(ConstantsTest, SweepUnusedConstants) {
+  LLVMContext Context;
+  std::unique_ptr<Module> M(new Module("MyModule", Context));
+  auto *Int32Ty = Type::getInt32Ty(Context);
+  auto *ArrayTy = ArrayType::get(Int32Ty, 2);
+
+  // Referenced by a global initializer and by metadata.
+  Constant *Elts[] = {ConstantInt::get(Int32Ty, 42), UndefValue::get(Int32Ty)};
+  auto *GV = new GlobalVariable(*M, ArrayTy, false,
+                                GlobalValue::ExternalLinkage,
+                                ConstantArray::get(ArrayTy, Elts));
+  auto *MD = ConstantAsMetadata::get(ConstantInt::get(Int32Ty, 77));
+  Context.sweepUnusedConstants();
+  size_t NumConstants = Context.getNumUniquedConstants();
+
+  // Not referenced at all.
+  Constant *DeadElts[] = {ConstantInt::get(Int32Ty, 1000),
+                          ConstantInt::get(Int32Ty, 1001)};
+  ConstantArray::get(ArrayTy, DeadElts);
+  ConstantExpr::getAdd(ConstantInt::get(Int32Ty, 1002),
+                       ConstantExpr::getPtrToInt(GV, Int32Ty));
+  ConstantDataArray::getString(Context, "dead");
+  EXPECT_EQ(NumConstants + 7, Context.getNumUniquedConstants());
+
+  EXPECT_EQ(7u, Context.sweepUnusedConstants());
+  EXPECT_EQ(NumConstants, Context.getNumUniquedConstants());
+  EXPECT_EQ(0u, Context.sweepUnusedConstants());
+
+  auto *Init = cast<ConstantArray>(GV->getInitializer());
+  EXPECT_EQ(42u, cast<ConstantInt>(Init->getOperand(0))->getZExtValue());
+  EXPECT_EQ(77u, cast<ConstantInt>(MD->getValue())->getZExtValue());
+}
+
 }  // end anonymous namespace
 }  // end namespace llvm
@@ -9,6 +9,7 @@
 
 #include "llvm/IR/Value.h"
 #include "llvm/AsmParser/Parser.h"
+#include "llvm/IR/Constants.h"
 #include "llvm/IR/Function.h"
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/Module.h"
@@ -223,6 +224,50 @@ TEST(ValueTest, getLocalSlots) {
   EXPECT_EQ(MST.getLocalSlot(BB2), 2);
 }
 
+TEST(ValueTest, RAUWUseListOrder) {
+  const char *ModuleString =
+      "@a = global [2 x i32] zeroinitializer\n"
+      "@b = global [2 x i32] zeroinitializer\n"
+      "define void @f() {\n"
+      "  %b1 = load [2 x i32], [2 x i32]* @b\n"
+      "  %a1 = load [2 x i32], [2 x i32]* @a\n"
+      "  %a2 = load i32, i32* getelementptr ([2 x i32], [2 x i32]* @a, i32 0, "
+      "i32 1)\n"
+      "  %a3 = load [2 x i32], [2 x i32]* @a\n"
+      "  %a4 = load [2 x i32], [2 x i32]* @a\n"
+      "  %b2 = load [2 x i32], [2 x i32]* @b\n"
+      "  ret void\n"
+      "}\n";
+
+  // Replaces the uses of @a in \p M with @b and returns the users of @b.
+  auto GetUsersAfterRAUW = [&](bool OneAtATime) {
+    LLVMContext C;
+    SMDiagnostic Err;
+    std::unique_ptr<Module> M = parseAssemblyString(ModuleString, Err, C);
+    GlobalVariable *A = M->getNamedGlobal("a");
+    GlobalVariable *B = M->getNamedGlobal("b");
+    if (OneAtATime) {
+      while (!A->use_empty()) {
+        Use &U = *A->use_begin();
+        if (auto *CE = dyn_cast<ConstantExpr>(U.getUser()))
+          CE->handleOperandChange(A, B);
+        else
+          U.set(B);
+      }
+    } else {
+      A->replaceAllUsesWith(B);
+    }
+    std::vector<std::string> Users;
+    for (User *U : B->users())
+      Users.push_back(isa<Instruction>(U) ? U->getName().str() : "constant");
+    return Users;
+  };
+
+  std::vector<std::string> Users = GetUsersAfterRAUW(false);
+  EXPECT_EQ(6u, Users.size());
+  EXPECT_EQ(GetUsersAfterRAUW(true), Users);
+}
+
 #if defined(GTEST_HAS_DEATH_TEST) && !defined(NDEBUG)
 TEST(ValueTest, getLocalSlotDeath) {
   LLVMContext C;
@@ -8,6 +8,8 @@
 //===----------------------------------------------------------------------===//
 
 #include "llvm-c/OptRemarks.h"
+#include "llvm/OptRemarks/BinaryRemarks.h"
+#include "llvm/Support/raw_ostream.h"
 #include "gtest/gtest.h"
 
 using namespace llvm;
@@ -431,3 +433,115 @@ TEST(OptRemarks, OptRemarksGoodStruct) {
   EXPECT_FALSE(LLVMOptRemarkParserHasError(Parser));
   LLVMOptRemarkParserDispose(Parser);
 }
+
+TEST(OptRemarks, OptRemarksBinaryRoundTrip) {
+  remarks::RemarkArg Args[3];
+  Args[0].Key = "Callee";
+  Args[0].Value = "bar";
+  Args[1].Key = "String";
+  Args[1].Value = " will not be inlined into ";
+  Args[2].Key = "Caller";
+  Args[2].Value = "foo";
+  remarks::RemarkLocation ArgLoc;
+  ArgLoc.File = "file.c";
+  ArgLoc.Line = 2;
+  Args[2].Loc = ArgLoc;
+
+  remarks::Remark First;
+  First.Type = "!Missed";
+  First.PassName = "inline";
+  First.RemarkName = "NoDefinition";
+  First.FunctionName = "foo";
+  remarks::RemarkLocation Loc;
+  Loc.File = "file.c";
+  Loc.Line = 3;
+  Loc.Column = 12;
+  First.Loc = Loc;
+  First.Hotness = 300;
+  First.Args = Args;
+
+  // The second remark only uses strings defined for the first one.
+  remarks::Remark Second;
+  Second.Type = "!Passed";
+  Second.PassName = "inline";
+  Second.RemarkName = "foo";
+  Second.FunctionName = "bar";
+
+  std::string Buf;
+  {
+    raw_string_ostream OS(Buf);
+    remarks::BinaryRemarkWriter Writer(OS);
+    Writer.write(First);
+    Writer.write(Second);
+  }
+
+  LLVMOptRemarkParserRef Parser =
+      LLVMOptRemarkParserCreate(Buf.data(), Buf.size());
+  LLVMOptRemarkEntry *Remark = LLVMOptRemarkParserGetNext(Parser);
+  ASSERT_FALSE(Remark == nullptr);
+  EXPECT_EQ(StringRef(Remark->RemarkType.Str, Remark->RemarkType.Len),
+            "!Missed");
+  EXPECT_EQ(StringRef(Remark->PassName.Str, Remark->PassName.Len), "inline");
+  EXPECT_EQ(StringRef(Remark->RemarkName.Str, Remark->RemarkName.Len),
+            "NoDefinition");
+  EXPECT_EQ(StringRef(Remark->FunctionName.Str, Remark->FunctionName.Len),
+            "foo");
+  EXPECT_EQ(StringRef(Remark->DebugLoc.SourceFile.Str,
+                      Remark->DebugLoc.SourceFile.Len),
+            "file.c");
+  EXPECT_EQ(Remark->DebugLoc.SourceLineNumber, 3U);
+  EXPECT_EQ(Remark->DebugLoc.SourceColumnNumber, 12U);
+  EXPECT_EQ(Remark->Hotness, 300U);
+  ASSERT_EQ(Remark->NumArgs, 3U);
+  {
+    LLVMOptRemarkArg &Arg = Remark->Args[1];
+    EXPECT_EQ(StringRef(Arg.Key.Str, Arg.Key.Len), "String");
+    EXPECT_EQ(StringRef(Arg.Value.Str, Arg.Value.Len),
+              " will not be inlined into ");
+    EXPECT_EQ(Arg.DebugLoc.SourceFile.Len, 0U);
+  }
+  {
+    LLVMOptRemarkArg &Arg = Remark->Args[2];
+    EXPECT_EQ(StringRef(Arg.Key.Str, Arg.Key.Len), "Caller");
+    EXPECT_EQ(StringRef(Arg.Value.Str, Arg.Value.Len), "foo");
+    EXPECT_EQ(
+        StringRef(Arg.DebugLoc.SourceFile.Str, Arg.DebugLoc.SourceFile.Len),
+        "file.c");
+    EXPECT_EQ(Arg.DebugLoc.SourceLineNumber, 2U);
+    EXPECT_EQ(Arg.DebugLoc.SourceColumnNumber, 0U);
+  }
+
+  Remark = LLVMOptRemarkParserGetNext(Parser);
+  ASSERT_FALSE(Remark == nullptr);
+  EXPECT_EQ(StringRef(Remark->RemarkType.Str, Remark->RemarkType.Len),
+            "!Passed");
+  EXPECT_EQ(StringRef(Remark->RemarkName.Str, Remark->RemarkName.Len), "foo");
+  EXPECT_EQ(StringRef(Remark->FunctionName.Str, Remark->FunctionName.Len),
+            "bar");
+  EXPECT_EQ(Remark->DebugLoc.SourceFile.Len, 0U);
+  EXPECT_EQ(Remark->Hotness, 0U);
+  EXPECT_EQ(Remark->NumArgs, 0U);
+
+  EXPECT_TRUE(LLVMOptRemarkParserGetNext(Parser) == nullptr);
+  EXPECT_FALSE(LLVMOptRemarkParserHasError(Parser));
+  LLVMOptRemarkParserDispose(Parser);
+}
+
+TEST(OptRemarks, OptRemarksBinaryErrors) {
+  auto ExpectError = [](StringRef Buf, StringRef Error) {
+    LLVMOptRemarkParserRef Parser =
+        LLVMOptRemarkParserCreate(Buf.data(), Buf.size());
+    EXPECT_TRUE(LLVMOptRemarkParserGetNext(Parser) == nullptr);
+    EXPECT_TRUE(LLVMOptRemarkParserHasError(Parser));
+    EXPECT_TRUE(
+        StringRef(LLVMOptRemarkParserGetErrorMessage(Parser)).contains(Error));
+    LLVMOptRemarkParserDispose(Parser);
+  };
+
+  ExpectError(StringRef("RMRK\x07", 5), "unsupported version 7");
+  // A remark using string 0 before it is defined.
+  ExpectError(StringRef("RMRK\x00\x02\x00", 7), "string ID 0 is not defined");
+  ExpectError(StringRef("RMRK\x00\x01\x05" "ab", 8),
+              "string extends past the end of the buffer");
+  ExpectError(StringRef("RMRK\x00\x09", 6), "unknown record kind 9");
+}
@@ -273,6 +273,42 @@ TEST_P(MaybeSparseInstrProfTest, get_icall_data_read_write) {
   ASSERT_EQ(StringRef((const char *)VD[2].Value, 7), StringRef("callee1"));
 }
 
+TEST_P(MaybeSparseInstrProfTest, get_instr_prof_record_ref) {
+  NamedInstrProfRecord Record("foo", 0x1234, {1, 2});
+  Record.reserveSites(IPVK_IndirectCallTarget, 1);
+  InstrProfValueData VD[] = {{(uint64_t)callee1, 1}, {(uint64_t)callee2, 2}};
+  Record.addValueData(IPVK_IndirectCallTarget, 0, VD, 2, nullptr);
+  Writer.addRecord(std::move(Record), Err);
+  Writer.addRecord({"foo", 0x1235, {3, 4, 5}}, Err);
+  auto Profile = Writer.writeBuffer();
+  readProfile(std::move(Profile));
+
+  InstrProfRecordRef Ref;
+  EXPECT_THAT_ERROR(Reader->getInstrProfRecordRef("foo", 0x1234, Ref),
+                    Succeeded());
+  ASSERT_EQ(2U, Ref.Counts.size());
+  ASSERT_EQ(1U, Ref.Counts[0]);
+  ASSERT_EQ(2U, Ref.Counts[1]);
+  InstrProfRecord R;
+  EXPECT_THAT_ERROR(Reader->readValueProfData(Ref, R), Succeeded());
+  ASSERT_EQ(1U, R.getNumValueSites(IPVK_IndirectCallTarget));
+  ASSERT_EQ(2U, R.getNumValueDataForSite(IPVK_IndirectCallTarget, 0));
+
+  EXPECT_THAT_ERROR(Reader->getInstrProfRecordRef("foo", 0x1235, Ref),
+                    Succeeded());
+  ASSERT_EQ(3U, Ref.Counts.size());
+  ASSERT_EQ(5U, Ref.Counts[2]);
+  InstrProfRecord R2;
+  EXPECT_THAT_ERROR(Reader->readValueProfData(Ref, R2), Succeeded());
+  ASSERT_EQ(0U, R2.getNumValueSites(IPVK_IndirectCallTarget));
+
+  Error E1 = Reader->getInstrProfRecordRef("foo", 0x5678, Ref);
+  ASSERT_TRUE(ErrorEquals(instrprof_error::hash_mismatch, std::move(E1)));
+
+  Error E2 = Reader->getInstrProfRecordRef("bar", 0x1234, Ref);
+  ASSERT_TRUE(ErrorEquals(instrprof_error::unknown_function, std::move(E2)));
+}
+
 TEST_P(MaybeSparseInstrProfTest, annotate_vp_data) {
   NamedInstrProfRecord Record("caller", 0x1234, {1, 2});
   Record.reserveSites(IPVK_IndirectCallTarget, 1);
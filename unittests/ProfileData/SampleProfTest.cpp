@@ -212,6 +212,45 @@ TEST_F(SampleProfTest, roundtrip_compact_binary_profile) {
   testRoundTrip(SampleProfileFormat::SPF_Compact_Binary, false);
 }
 
+TEST_F(SampleProfTest, compact_binary_reads_used_functions_only) {
+  SmallVector<char, 128> ProfilePath;
+  ASSERT_TRUE(
+      NoError(llvm::sys::fs::createTemporaryFile("profile", "", ProfilePath)));
+  StringRef Profile(ProfilePath.data(), ProfilePath.size());
+  createWriter(SampleProfileFormat::SPF_Compact_Binary, Profile);
+
+  StringMap<FunctionSamples> Profiles;
+  for (StringRef Name : {"_Z3fooi", "_Z3bari", "_Z3bazi"}) {
+    FunctionSamples Samples;
+    Samples.setName(Name);
+    Samples.addTotalSamples(100);
+    Samples.addHeadSamples(10);
+    Samples.addBodySamples(1, 0, 10);
+    Profiles[Name] = std::move(Samples);
+  }
+  ASSERT_TRUE(NoError(Writer->write(Profiles)));
+  Writer->getOutputStream().flush();
+
+  // Only the functions of the module are read.
+  Module M("my_module", Context);
+  M.getOrInsertFunction("_Z3bari",
+                        FunctionType::get(Type::getVoidTy(Context), {}, false));
+  readProfile(M, Profile);
+  ASSERT_TRUE(NoError(Reader->read()));
+  ASSERT_EQ(1u, Reader->getProfiles().size());
+  FunctionSamples *BarSamples = Reader->getSamplesFor("_Z3bari");
+  ASSERT_TRUE(BarSamples != nullptr);
+  ASSERT_EQ(100u, BarSamples->getTotalSamples());
+  ASSERT_TRUE(Reader->getSamplesFor("_Z3fooi") == nullptr);
+
+  // Without a module, all the functions are read.
+  auto ReaderOrErr = SampleProfileReader::create(Profile, Context);
+  ASSERT_TRUE(NoError(ReaderOrErr.getError()));
+  Reader = std::move(ReaderOrErr.get());
+  ASSERT_TRUE(NoError(Reader->read()));
+  ASSERT_EQ(3u, Reader->getProfiles().size());
+}
+
 TEST_F(SampleProfTest, remap_text_profile) {
   testRoundTrip(SampleProfileFormat::SPF_Text, true);
 }
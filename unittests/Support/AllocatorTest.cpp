@@ -8,8 +8,14 @@
 //===----------------------------------------------------------------------===//
 
 #include "llvm/Support/Allocator.h"
+#include "llvm/Config/llvm-config.h"
+#include "llvm/Support/ThreadLocalBumpPtrAllocator.h"
+#include "llvm/Support/raw_ostream.h"
 #include "gtest/gtest.h"
 #include <cstdlib>
+#include <set>
+#include <thread>
+#include <vector>
 
 using namespace llvm;
 
@@ -185,4 +191,69 @@ TEST(AllocatorTest, TestBigAlignment) {
   EXPECT_GT(MockSlabAllocator::GetLastSlabSize(), 4096u);
 }
 
+TEST(AllocatorTest, AllocationProfile) {
+  EnableBumpPtrAllocationProfiling();
+  BumpPtrAllocator Alloc;
+  Alloc.Allocate(1000, 8);
+  Alloc.Allocate(234, 8);
+  detail::ProfileBumpPtrAllocations = false;
+
+  std::string Report;
+  raw_string_ostream OS(Report);
+  PrintBumpPtrAllocationProfile(OS);
+  EXPECT_NE(Report.find("BumpPtrAllocator allocations by call site"),
+            std::string::npos);
+  size_t Total = Report.find("Total bytes allocated: ");
+  ASSERT_NE(Total, std::string::npos);
+  EXPECT_GE(std::stoull(Report.substr(Total + 23)), 1234u);
+}
+
+TEST(ThreadLocalBumpPtrAllocatorTest, SameThread) {
+  ThreadLocalBumpPtrAllocator Alloc;
+  BumpPtrAllocator *First = &Alloc.getThreadAllocator();
+  EXPECT_EQ(First, &Alloc.getThreadAllocator());
+  int *A = Alloc.Allocate<int>();
+  *A = 42;
+  EXPECT_EQ(sizeof(int), Alloc.getBytesAllocated());
+
+  // A second allocator must not reuse the cached allocator of the first.
+  ThreadLocalBumpPtrAllocator Other;
+  EXPECT_NE(First, &Other.getThreadAllocator());
+  EXPECT_EQ(First, &Alloc.getThreadAllocator());
+  EXPECT_EQ(42, *A);
+
+  Alloc.Reset();
+  EXPECT_EQ(0u, Alloc.getBytesAllocated());
+}
+
+#if LLVM_ENABLE_THREADS
+TEST(ThreadLocalBumpPtrAllocatorTest, ManyThreads) {
+  const unsigned NumThreads = 4, NumAllocs = 1000;
+  ThreadLocalBumpPtrAllocator Alloc;
+  std::vector<BumpPtrAllocator *> ThreadAllocators(NumThreads);
+  std::vector<std::vector<unsigned *>> Ptrs(NumThreads);
+  std::vector<std::thread> Threads;
+  for (unsigned T = 0; T != NumThreads; ++T)
+    Threads.emplace_back([&, T]() {
+      ThreadAllocators[T] = &Alloc.getThreadAllocator();
+      for (unsigned I = 0; I != NumAllocs; ++I) {
+        unsigned *P = Alloc.Allocate<unsigned>();
+        *P = T * NumAllocs + I;
+        Ptrs[T].push_back(P);
+      }
+    });
+  for (std::thread &Thread : Threads)
+    Thread.join();
+
+  std::set<BumpPtrAllocator *> Distinct(ThreadAllocators.begin(),
+                                        ThreadAllocators.end());
+  EXPECT_EQ(NumThreads, Distinct.size());
+  for (unsigned T = 0; T != NumThreads; ++T)
+    for (unsigned I = 0; I != NumAllocs; ++I)
+      EXPECT_EQ(T * NumAllocs + I, *Ptrs[T][I]);
+  EXPECT_EQ(NumThreads * NumAllocs * sizeof(unsigned),
+            Alloc.getBytesAllocated());
+}
+#endif
+
 }  // anonymous namespace
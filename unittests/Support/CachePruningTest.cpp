@@ -8,7 +8,12 @@
 //===----------------------------------------------------------------------===//
 
 #include "llvm/Support/CachePruning.h"
+#include "llvm/ADT/SmallString.h"
 #include "llvm/Support/Error.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/raw_ostream.h"
 #include "gtest/gtest.h"
 
 using namespace llvm;
@@ -73,6 +78,13 @@ TEST(CachePruningPolicyParser, Multiple) {
   EXPECT_EQ(50u, P->MaxSizePercentageOfAvailableSpace);
 }
 
+TEST(CachePruningPolicyParser, Journal) {
+  auto P = parseCachePruningPolicy("cache_journal=1");
+  ASSERT_TRUE(bool(P));
+  EXPECT_TRUE(P->UseJournal);
+  EXPECT_FALSE(parseCachePruningPolicy("")->UseJournal);
+}
+
 TEST(CachePruningPolicyParser, Errors) {
   EXPECT_EQ("Duration must not be empty",
             toString(parseCachePruningPolicy("prune_interval=").takeError()));
@@ -94,4 +106,53 @@ TEST(CachePruningPolicyParser, Errors) {
       toString(parseCachePruningPolicy("cache_size_bytes=foom").takeError()));
   EXPECT_EQ("Unknown key: 'foo'",
             toString(parseCachePruningPolicy("foo=bar").takeError()));
+  EXPECT_EQ("'2' must be 0 or 1",
+            toString(parseCachePruningPolicy("cache_journal=2").takeError()));
+}
+
+static void writeFile(const Twine &Path, StringRef Contents) {
+  std::error_code EC;
+  raw_fd_ostream OS(Path.str(), EC, sys::fs::F_None);
+  ASSERT_FALSE(EC);
+  OS << Contents;
+}
+
+TEST(CachePruning, Journal) {
+  SmallString<128> Dir;
+  ASSERT_FALSE(sys::fs::createUniqueDirectory("cache-pruning", Dir));
+  for (const char *Name :
+       {"llvmcache-a", "llvmcache-b", "llvmcache-c", "llvmcache-d"})
+    writeFile(Dir + "/" + Name, "x");
+  // llvmcache-d is not in the journal and must not be looked at.
+  writeFile(Dir + "/llvmcache.journal", "100 1 llvmcache-a\n"
+                                        "300 1 llvmcache-b\n"
+                                        "200 1 llvmcache-c\n"
+                                        "400 1 llvmcache-a\n"
+                                        "50 1 llvm");
+
+  CachePruningPolicy Policy;
+  Policy.Interval = std::chrono::seconds(0);
+  Policy.Expiration = std::chrono::seconds(0);
+  Policy.MaxSizePercentageOfAvailableSpace = 0;
+  Policy.MaxSizeFiles = 2;
+  Policy.UseJournal = true;
+  EXPECT_TRUE(pruneCache(Dir, Policy));
+
+  EXPECT_TRUE(sys::fs::exists(Dir + "/llvmcache-a"));
+  EXPECT_TRUE(sys::fs::exists(Dir + "/llvmcache-b"));
+  EXPECT_FALSE(sys::fs::exists(Dir + "/llvmcache-c"));
+  EXPECT_TRUE(sys::fs::exists(Dir + "/llvmcache-d"));
+
+  auto Journal = MemoryBuffer::getFile(Dir + "/llvmcache.journal");
+  ASSERT_TRUE(bool(Journal));
+  EXPECT_EQ("300 1 llvmcache-b\n400 1 llvmcache-a\n",
+            (*Journal)->getBuffer());
+
+  // Entries used from now on are recorded in the journal.
+  recordCacheEntryUse(Dir, "llvmcache-d", 1);
+  Journal = MemoryBuffer::getFile(Dir + "/llvmcache.journal");
+  ASSERT_TRUE(bool(Journal));
+  EXPECT_TRUE((*Journal)->getBuffer().endswith(" 1 llvmcache-d\n"));
+
+  ASSERT_FALSE(sys::fs::remove_directories(Dir));
 }
@@ -822,6 +822,27 @@ TEST(CommandLineTest, PositionalEatArgsError) {
   EXPECT_TRUE(Errs.empty());
 }
 
+TEST(CommandLineTest, ModifyPendingOption) {
+  cl::ResetCommandLineParser();
+
+  // Options are only added to the option map when it is first used, so these
+  // are renamed and removed before being registered.
+  StackOption<bool> Renamed("pending-option");
+  Renamed.setArgStr("renamed-pending-option");
+  { StackOption<bool> Removed("removed-pending-option"); }
+
+  const char *args[] = {"prog", "-renamed-pending-option"};
+  EXPECT_TRUE(
+      cl::ParseCommandLineOptions(2, args, StringRef(), &llvm::nulls()));
+  EXPECT_TRUE(Renamed);
+
+  StringMap<cl::Option *> &Map =
+      cl::getRegisteredOptions(*cl::TopLevelSubCommand);
+  EXPECT_EQ(1u, Map.count("renamed-pending-option"));
+  EXPECT_EQ(0u, Map.count("pending-option"));
+  EXPECT_EQ(0u, Map.count("removed-pending-option"));
+}
+
 #ifdef _WIN32
 TEST(CommandLineTest, GetCommandLineArguments) {
   int argc = __argc;
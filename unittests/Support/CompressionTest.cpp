@@ -17,6 +17,7 @@
 #include "llvm/Config/config.h"
 #include "llvm/Support/Error.h"
 #include "gtest/gtest.h"
+#include <string>
 
 using namespace llvm;
 
@@ -66,6 +67,36 @@ TEST(CompressionTest, Zlib) {
   TestZlibCompression(BinaryDataStr, zlib::DefaultCompression);
 }
 
+TEST(CompressionTest, ZlibChunks) {
+  std::string Input;
+  for (unsigned I = 0; I != 100000; ++I)
+    Input += "abcdefghij"[(I * 7 + I / 13) % 10];
+
+  for (size_t ChunkSize : {size_t(100), size_t(1000), size_t(1) << 20}) {
+    SmallString<32> Compressed;
+    SmallString<32> Uncompressed;
+    Error E = zlib::compressInChunks(Input, Compressed, ChunkSize);
+    EXPECT_FALSE(E);
+    consumeError(std::move(E));
+
+    E = zlib::uncompress(Compressed, Uncompressed, Input.size());
+    EXPECT_FALSE(E);
+    consumeError(std::move(E));
+    EXPECT_EQ(Input, Uncompressed);
+  }
+
+  // A single chunk is the same stream as compress() produces.
+  SmallString<32> Chunked;
+  SmallString<32> Whole;
+  Error E = zlib::compressInChunks(Input, Chunked, Input.size());
+  EXPECT_FALSE(E);
+  consumeError(std::move(E));
+  E = zlib::compress(Input, Whole);
+  EXPECT_FALSE(E);
+  consumeError(std::move(E));
+  EXPECT_EQ(Whole, Chunked);
+}
+
 TEST(CompressionTest, ZlibCRC32) {
   EXPECT_EQ(
       0x414FA339U,
@@ -74,4 +105,56 @@ TEST(CompressionTest, ZlibCRC32) {
 
 #endif
 
+TEST(CompressionTest, ZstdIsFrame) {
+  EXPECT_TRUE(zstd::isFrame(StringRef("\x28\xb5\x2f\xfd\x20\x00", 6)));
+  EXPECT_FALSE(zstd::isFrame(StringRef("\x28\xb5\x2f", 3)));
+  EXPECT_FALSE(zstd::isFrame("x\x9c"));
+}
+
+#if LLVM_ENABLE_ZSTD == 1 && HAVE_ZSTD_H && HAVE_LIBZSTD
+
+void TestZstdCompression(StringRef Input, int Level, unsigned NumThreads) {
+  SmallString<32> Compressed;
+  SmallString<32> Uncompressed;
+
+  Error E = zstd::compress(Input, Compressed, Level, NumThreads);
+  EXPECT_FALSE(E);
+  consumeError(std::move(E));
+  EXPECT_TRUE(zstd::isFrame(Compressed));
+
+  E = zstd::uncompress(Compressed, Uncompressed, Input.size());
+  EXPECT_FALSE(E);
+  consumeError(std::move(E));
+  EXPECT_EQ(Input, Uncompressed);
+
+  if (Input.size() > 0) {
+    // Uncompression fails if expected length is too short.
+    E = zstd::uncompress(Compressed, Uncompressed, Input.size() - 1);
+    EXPECT_TRUE(bool(E));
+    consumeError(std::move(E));
+  }
+}
+
+TEST(CompressionTest, Zstd) {
+  TestZstdCompression("", zstd::DefaultCompression, 0);
+
+  TestZstdCompression("hello, world!", zstd::BestSpeedCompression, 0);
+  TestZstdCompression("hello, world!", zstd::BestSizeCompression, 0);
+
+  const size_t kSize = 1024;
+  char BinaryData[kSize];
+  for (size_t i = 0; i < kSize; ++i)
+    BinaryData[i] = i & 255;
+  StringRef BinaryDataStr(BinaryData, kSize);
+  TestZstdCompression(BinaryDataStr, zstd::DefaultCompression, 0);
+
+  // Worker threads are ignored if zstd is built without them.
+  std::string Large;
+  for (size_t I = 0; I != 1 << 16; ++I)
+    Large += "line " + std::to_string(I % 1000) + "\n";
+  TestZstdCompression(Large, zstd::DefaultCompression, 4);
+}
+
+#endif
+
 }
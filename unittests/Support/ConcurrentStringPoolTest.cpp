@@ -0,0 +1,85 @@
+//===- ConcurrentStringPoolTest.cpp - ConcurrentStringPool tests ----------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Support/ConcurrentStringPool.h"
+#include "llvm/Support/ThreadPool.h"
+#include "gtest/gtest.h"
+#include <string>
+#include <vector>
+
+using namespace llvm;
+
+namespace {
+
+TEST(ConcurrentStringPoolTest, Intern) {
+  ConcurrentStringPool Pool;
+  std::string S = "foo";
+  StringRef A = Pool.intern(S);
+  S = "bar";
+  EXPECT_EQ("foo", A);
+  EXPECT_EQ(A.data(), Pool.intern("foo").data());
+  // Interned strings are not part of the table.
+  EXPECT_EQ(0u, Pool.finalize());
+  EXPECT_TRUE(Pool.getEntriesInOrder().empty());
+}
+
+TEST(ConcurrentStringPoolTest, OrderedBySmallestKey) {
+  ConcurrentStringPool Pool;
+  const auto &B = Pool.add("b", 2);
+  const auto &A = Pool.add("a", 5);
+  Pool.add("a", 1);
+  const auto &C = Pool.add("cc", 3);
+  Pool.intern("unused");
+  EXPECT_EQ(7u, Pool.finalize());
+  EXPECT_EQ(0u, A.getValue().Offset);
+  EXPECT_EQ(2u, B.getValue().Offset);
+  EXPECT_EQ(4u, C.getValue().Offset);
+  ArrayRef<const ConcurrentStringPool::Entry *> Entries =
+      Pool.getEntriesInOrder();
+  ASSERT_EQ(3u, Entries.size());
+  EXPECT_EQ("a", Entries[0]->getKey());
+  EXPECT_EQ("b", Entries[1]->getKey());
+  EXPECT_EQ("cc", Entries[2]->getKey());
+}
+
+TEST(ConcurrentStringPoolTest, ParallelMatchesSerial) {
+  const unsigned NumStrings = 2000;
+  std::vector<std::string> Strings;
+  for (unsigned I = 0; I != NumStrings; ++I)
+    Strings.push_back("string" + std::to_string(I % 700));
+
+  ConcurrentStringPool Serial;
+  for (unsigned I = 0; I != NumStrings; ++I)
+    Serial.add(Strings[I], I);
+  uint64_t SerialSize = Serial.finalize();
+
+  ConcurrentStringPool Parallel;
+  {
+    ThreadPool Threads(4);
+    // Add the strings from the back so that no thread sees them in order.
+    for (unsigned T = 0; T != 4; ++T)
+      Threads.async([&, T] {
+        for (int I = NumStrings - 1 - T; I >= 0; I -= 4)
+          Parallel.add(Strings[I], I);
+      });
+  }
+  EXPECT_EQ(SerialSize, Parallel.finalize());
+
+  auto SerialEntries = Serial.getEntriesInOrder();
+  auto ParallelEntries = Parallel.getEntriesInOrder();
+  ASSERT_EQ(700u, SerialEntries.size());
+  ASSERT_EQ(SerialEntries.size(), ParallelEntries.size());
+  for (size_t I = 0; I != SerialEntries.size(); ++I) {
+    EXPECT_EQ(SerialEntries[I]->getKey(), ParallelEntries[I]->getKey());
+    EXPECT_EQ(SerialEntries[I]->getValue().Offset,
+              ParallelEntries[I]->getValue().Offset);
+  }
+}
+
+} // end anonymous namespace
@@ -89,6 +89,72 @@ TEST_F(MemoryBufferTest, NullTerminator4K) {
   EXPECT_EQ('\0', BufData[4096]);
 }
 
+TEST_F(MemoryBufferTest, getFileWithHints) {
+  // Large enough to be mapped without hints, and to hold a whole huge page.
+  int TestFD;
+  SmallString<64> TestPath;
+  sys::fs::createTemporaryFile("MemoryBufferTest_Hints", "temp", TestFD,
+                               TestPath);
+  FileRemover Cleanup(TestPath);
+  raw_fd_ostream OF(TestFD, true, /*unbuffered=*/true);
+  for (unsigned i = 0; i < 5 * 1024 * 1024 / 16; ++i)
+    OF << "0123456789abcdef";
+  OF << "end";
+  OF.close();
+  const size_t Size = 5 * 1024 * 1024 + 3;
+
+  const unsigned Hints[] = {
+      sys::fs::AH_Sequential, sys::fs::AH_Random, sys::fs::AH_WillNeed,
+      sys::fs::AH_HugePages, sys::fs::AH_Sequential | sys::fs::AH_WillNeed};
+  for (unsigned H : Hints) {
+    ErrorOr<OwningBuffer> MB =
+        MemoryBuffer::getFile(TestPath, -1, true, false, H);
+    ASSERT_FALSE(MB.getError());
+    ASSERT_EQ(Size, (*MB)->getBufferSize());
+    EXPECT_EQ("0123456789abcdef", (*MB)->getBuffer().substr(1024 * 1024, 16));
+    EXPECT_EQ("end", (*MB)->getBuffer().take_back(3));
+    EXPECT_EQ('\0', (*MB)->getBufferEnd()[0]);
+    if (H & sys::fs::AH_HugePages)
+      EXPECT_EQ(MemoryBuffer::MemoryBuffer_Malloc, (*MB)->getBufferKind());
+    else
+      EXPECT_EQ(MemoryBuffer::MemoryBuffer_MMap, (*MB)->getBufferKind());
+  }
+}
+
+TEST_F(MemoryBufferTest, getFiles) {
+  SmallVector<SmallString<64>, 8> Paths;
+  SmallVector<std::unique_ptr<FileRemover>, 8> Cleanups;
+  for (unsigned i = 0; i < 8; ++i) {
+    int FD;
+    Paths.emplace_back();
+    sys::fs::createTemporaryFile("MemoryBufferTest_GetFiles", "temp", FD,
+                                 Paths.back());
+    Cleanups.push_back(llvm::make_unique<FileRemover>(Paths.back()));
+    raw_fd_ostream OF(FD, true, /*unbuffered=*/true);
+    OF << "file " << i;
+  }
+  SmallString<64> Missing = Paths[3];
+  Missing += ".missing";
+
+  std::vector<StringRef> Names(Paths.begin(), Paths.end());
+  Names.insert(Names.begin() + 3, Missing);
+  for (unsigned Threads : {1u, 4u}) {
+    auto Buffers = MemoryBuffer::getFiles(Names, true, sys::fs::AH_None,
+                                          Threads);
+    ASSERT_EQ(Names.size(), Buffers.size());
+    for (unsigned i = 0; i < Names.size(); ++i) {
+      if (i == 3) {
+        EXPECT_EQ(std::errc::no_such_file_or_directory,
+                  Buffers[i].getError());
+        continue;
+      }
+      ASSERT_FALSE(Buffers[i].getError());
+      EXPECT_EQ(("file " + Twine(i < 3 ? i : i - 1)).str(),
+                (*Buffers[i])->getBuffer());
+    }
+  }
+}
+
 TEST_F(MemoryBufferTest, copy) {
   // copy with no name
   OwningBuffer MBC1(MemoryBuffer::getMemBufferCopy(data));
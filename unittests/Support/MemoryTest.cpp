@@ -415,4 +415,28 @@ INSTANTIATE_TEST_CASE_P(AllocationTests,
                         MappedMemoryTest,
                         ::testing::ValuesIn(MemoryFlags),);
 
+TEST(DualMappedMemoryTest, WritesAreVisibleInTarget) {
+  const size_t Alignment = 64 * 1024;
+  MemoryBlock Writable, Target;
+  std::error_code EC = Memory::allocateDualMappedMemory(
+      100, Alignment, Memory::MF_READ, Writable, Target);
+  if (EC == std::errc::not_supported)
+    return;
+  ASSERT_EQ(std::error_code(), EC);
+
+  ASSERT_NE((void *)nullptr, Writable.base());
+  ASSERT_NE((void *)nullptr, Target.base());
+  EXPECT_NE(Writable.base(), Target.base());
+  EXPECT_EQ(Writable.size(), Target.size());
+  EXPECT_LE(100U, Target.size());
+  EXPECT_EQ(0U, reinterpret_cast<uintptr_t>(Writable.base()) % Alignment);
+  EXPECT_EQ(0U, reinterpret_cast<uintptr_t>(Target.base()) % Alignment);
+
+  static_cast<int *>(Writable.base())[3] = 42;
+  EXPECT_EQ(42, static_cast<volatile int *>(Target.base())[3]);
+
+  EXPECT_FALSE(Memory::releaseMappedMemory(Writable));
+  EXPECT_FALSE(Memory::releaseMappedMemory(Target));
+}
+
 }  // anonymous namespace
@@ -15,6 +15,7 @@
 #include "llvm/Support/Parallel.h"
 #include "gtest/gtest.h"
 #include <array>
+#include <atomic>
 #include <random>
 
 uint32_t array[1024 * 1024];
@@ -50,4 +51,27 @@ TEST(Parallel, parallel_for) {
   ASSERT_EQ(range[2049], 1u);
 }
 
+TEST(Parallel, nested_for_each_n) {
+  std::atomic<uint32_t> Count{0};
+  for_each_n(parallel::par, 0, 64, [&](size_t) {
+    for_each_n(parallel::par, 0, 1024, [&](size_t) { ++Count; });
+  });
+  ASSERT_EQ(Count, 64u * 1024u);
+}
+
+// Waits on task groups from every level of a deep tree of tasks, which would
+// deadlock if waiting tasks held on to their worker threads.
+static uint32_t countLeaves(unsigned Depth) {
+  if (Depth == 0)
+    return 1;
+  uint32_t Left = 0;
+  {
+    parallel::detail::TaskGroup TG;
+    TG.spawn([&] { Left = countLeaves(Depth - 1); });
+  }
+  return Left + countLeaves(Depth - 1);
+}
+
+TEST(Parallel, nested_task_groups) { ASSERT_EQ(countLeaves(12), 4096u); }
+
 #endif
@@ -164,3 +164,97 @@ TEST_F(ThreadPoolTest, PoolDestruction) {
   }
   ASSERT_EQ(5, checked_in);
 }
+
+TEST_F(ThreadPoolTest, Priorities) {
+  CHECK_UNSUPPORTED();
+  std::vector<int> Order;
+  {
+    ThreadPool Pool(1);
+    // Keep the only thread busy until all the tasks are queued.
+    Pool.async([this] { waitForMainThread(); });
+    Pool.async([&Order] { Order.push_back(0); });
+    Pool.asyncWithPriority(2, [&Order] { Order.push_back(2); });
+    Pool.asyncWithPriority(1, [&Order] { Order.push_back(1); });
+    Pool.asyncWithPriority(2, [&Order] { Order.push_back(3); });
+    setMainThreadReady();
+  }
+  ASSERT_EQ(std::vector<int>({2, 3, 1, 0}), Order);
+}
+
+TEST_F(ThreadPoolTest, GroupWait) {
+  CHECK_UNSUPPORTED();
+  ThreadPool Pool(2);
+  std::atomic_int Checked{0};
+  // A task outside of the group, that the group does not wait for.
+  Pool.async([this] { waitForMainThread(); });
+  {
+    ThreadPoolTaskGroup Group(Pool);
+    for (size_t I = 0; I < 5; ++I)
+      Group.async([&Checked] { ++Checked; });
+    Group.wait();
+    ASSERT_EQ(5, Checked);
+  }
+  setMainThreadReady();
+  Pool.wait();
+}
+
+TEST_F(ThreadPoolTest, GroupCancel) {
+  CHECK_UNSUPPORTED();
+  std::atomic_int Checked{0};
+  ThreadPool Pool(1);
+  ThreadPoolTaskGroup Group(Pool);
+  Group.async([this] { waitForMainThread(); });
+  for (size_t I = 0; I < 5; ++I)
+    Group.async([&Checked] { ++Checked; });
+  Group.cancel();
+  setMainThreadReady();
+  Group.wait();
+  ASSERT_TRUE(Group.isCancelled());
+  ASSERT_EQ(0, Checked);
+}
+
+TEST_F(ThreadPoolTest, TaskGraph) {
+  CHECK_UNSUPPORTED();
+  std::mutex Lock;
+  std::vector<ThreadPoolTaskGraph::TaskID> Order;
+  ThreadPoolTaskGraph Graph;
+  // A diamond: 0 -> {1, 2} -> 3, with 3 also after 4.
+  SmallVector<ThreadPoolTaskGraph::TaskID, 5> IDs;
+  for (unsigned I = 0; I < 5; ++I)
+    IDs.push_back(Graph.addTask([&, I] {
+      std::lock_guard<std::mutex> LockGuard(Lock);
+      Order.push_back(I);
+    }));
+  Graph.addDependency(IDs[0], IDs[1]);
+  Graph.addDependency(IDs[0], IDs[2]);
+  Graph.addDependency(IDs[1], IDs[3]);
+  Graph.addDependency(IDs[2], IDs[3]);
+  Graph.addDependency(IDs[4], IDs[3]);
+
+  ThreadPool Pool;
+  ThreadPoolTaskGroup Group(Pool);
+  Graph.run(Group);
+  ASSERT_EQ(5u, Order.size());
+  auto Position = [&](unsigned I) {
+    return find(Order, I) - Order.begin();
+  };
+  ASSERT_LT(Position(0), Position(1));
+  ASSERT_LT(Position(0), Position(2));
+  ASSERT_LT(Position(1), Position(3));
+  ASSERT_LT(Position(2), Position(3));
+  ASSERT_LT(Position(4), Position(3));
+}
+
+TEST_F(ThreadPoolTest, TaskGraphCancel) {
+  CHECK_UNSUPPORTED();
+  std::atomic_int Checked{0};
+  ThreadPool Pool;
+  ThreadPoolTaskGroup Group(Pool);
+  ThreadPoolTaskGraph Graph;
+  // The first task fails, so the ones depending on it never run.
+  ThreadPoolTaskGraph::TaskID First = Graph.addTask([&] { Group.cancel(); });
+  for (unsigned I = 0; I < 3; ++I)
+    Graph.addDependency(First, Graph.addTask([&Checked] { ++Checked; }));
+  Graph.run(Group);
+  ASSERT_EQ(0, Checked);
+}
@@ -780,6 +780,94 @@ TEST(ProxyFileSystemTest, Basic) {
   ASSERT_EQ(false, Local);
 }
 
+namespace {
+// Counts the queries that reach the file system below a CachingFileSystem.
+class CountingFileSystem : public DummyFileSystem {
+public:
+  unsigned StatusCalls = 0;
+  unsigned OpenCalls = 0;
+  unsigned DirCalls = 0;
+
+  ErrorOr<vfs::Status> status(const Twine &Path) override {
+    ++StatusCalls;
+    return DummyFileSystem::status(Path);
+  }
+  ErrorOr<std::unique_ptr<vfs::File>>
+  openFileForRead(const Twine &Path) override {
+    ++OpenCalls;
+    return DummyFileSystem::openFileForRead(Path);
+  }
+  vfs::directory_iterator dir_begin(const Twine &Dir,
+                                    std::error_code &EC) override {
+    ++DirCalls;
+    return DummyFileSystem::dir_begin(Dir, EC);
+  }
+};
+} // end anonymous namespace
+
+TEST(CachingFileSystemTest, Status) {
+  IntrusiveRefCntPtr<CountingFileSystem> D(new CountingFileSystem());
+  D->addRegularFile("/foo");
+  IntrusiveRefCntPtr<vfs::CachingFileSystem> C(new vfs::CachingFileSystem(D));
+
+  ErrorOr<vfs::Status> Status = C->status("/foo");
+  ASSERT_FALSE(Status.getError());
+  EXPECT_TRUE(Status->isRegularFile());
+  Status = C->status("/./foo");
+  ASSERT_FALSE(Status.getError());
+  EXPECT_EQ("/./foo", Status->getName());
+  EXPECT_EQ(1u, D->StatusCalls);
+
+  // Failed lookups are remembered, and files known not to exist are not
+  // opened.
+  EXPECT_TRUE(C->status("/bar").getError());
+  EXPECT_TRUE(C->status("/bar").getError());
+  EXPECT_TRUE(C->openFileForRead("/bar").getError());
+  EXPECT_EQ(2u, D->StatusCalls);
+  EXPECT_EQ(0u, D->OpenCalls);
+
+  // Changes are seen after invalidation only.
+  D->addRegularFile("/bar");
+  EXPECT_TRUE(C->status("/bar").getError());
+  C->invalidate("/bar");
+  EXPECT_FALSE(C->status("/bar").getError());
+  EXPECT_EQ(3u, D->StatusCalls);
+  EXPECT_FALSE(C->openFileForRead("/bar").getError());
+  EXPECT_EQ(1u, D->OpenCalls);
+
+  C->invalidateAll();
+  D->StatusCalls = 0;
+  EXPECT_FALSE(C->status("/foo").getError());
+  EXPECT_EQ(1u, D->StatusCalls);
+}
+
+TEST(CachingFileSystemTest, DirectoryIteration) {
+  IntrusiveRefCntPtr<CountingFileSystem> D(new CountingFileSystem());
+  D->addDirectory("/dir");
+  D->addRegularFile("/dir/a");
+  D->addDirectory("/dir/b");
+  IntrusiveRefCntPtr<vfs::CachingFileSystem> C(new vfs::CachingFileSystem(D));
+
+  std::error_code EC;
+  checkContents(C->dir_begin("/dir", EC), {"/dir/a", "/dir/b"});
+  ASSERT_FALSE(EC);
+  vfs::directory_iterator I = C->dir_begin("/dir/", EC);
+  ASSERT_FALSE(EC);
+  EXPECT_EQ("/dir/a", I->path());
+  EXPECT_EQ(sys::fs::file_type::regular_file, I->type());
+  I.increment(EC);
+  EXPECT_EQ("/dir/b", I->path());
+  EXPECT_EQ(sys::fs::file_type::directory_file, I->type());
+  EXPECT_EQ(1u, D->DirCalls);
+
+  // Adding or removing an entry invalidates the listing of its parent.
+  D->addRegularFile("/dir/c");
+  checkContents(C->dir_begin("/dir", EC), {"/dir/a", "/dir/b"});
+  C->invalidate("/dir/c");
+  checkContents(C->dir_begin("/dir", EC), {"/dir/a", "/dir/b", "/dir/c"});
+  EXPECT_EQ(2u, D->DirCalls);
+}
+
 class InMemoryFileSystemTest : public ::testing::Test {
 protected:
   llvm::vfs::InMemoryFileSystem FS;
@@ -8,6 +8,7 @@
 //===----------------------------------------------------------------------===//
 
 #include "llvm/Support/YAMLParser.h"
+#include "llvm/ADT/SmallString.h"
 #include "llvm/ADT/Twine.h"
 #include "llvm/Support/Casting.h"
 #include "llvm/Support/MemoryBuffer.h"
@@ -168,6 +169,35 @@ TEST(YAMLParser, NullTerminatedBlockScalars) {
   EXPECT_EQ(Value.data()[Value.size()], '\0');
 }
 
+TEST(YAMLParser, PlainScalars) {
+  SourceMgr SM;
+  yaml::Stream Stream("a: x[0]{1},y?z\n"
+                      "b: [ p q, r/s, \xc3\xa9t\xc3\xa9 ]\n"
+                      "c: one two # comment\n",
+                      SM);
+  yaml::MappingNode *Map = cast<yaml::MappingNode>(Stream.begin()->getRoot());
+  SmallString<32> Storage;
+  auto GetValue = [&](yaml::Node *N) {
+    Storage.clear();
+    return cast<yaml::ScalarNode>(N)->getValue(Storage).str();
+  };
+
+  auto KV = Map->begin();
+  EXPECT_EQ(GetValue(KV->getValue()), "x[0]{1},y?z");
+  ++KV;
+  auto *Seq = cast<yaml::SequenceNode>(KV->getValue());
+  auto Entry = Seq->begin();
+  EXPECT_EQ(GetValue(&*Entry), "p q");
+  ++Entry;
+  EXPECT_EQ(GetValue(&*Entry), "r/s");
+  ++Entry;
+  EXPECT_EQ(GetValue(&*Entry), "\xc3\xa9t\xc3\xa9");
+  EXPECT_TRUE(++Entry == Seq->end());
+  ++KV;
+  EXPECT_EQ(GetValue(KV->getValue()), "one two");
+  EXPECT_FALSE(Stream.failed());
+}
+
 TEST(YAMLParser, HandlesEndOfFileGracefully) {
   ExpectParseError("In string starting with EOF", "[\"");
   ExpectParseError("In string hitting EOF", "[\"   ");
@@ -0,0 +1,142 @@
+//===- raw_chunked_ostream_test.cpp - raw_chunked_ostream tests -----------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Support/raw_chunked_ostream.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/Twine.h"
+#include "llvm/Config/llvm-config.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/FileUtilities.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "gtest/gtest.h"
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace llvm;
+
+namespace {
+
+// The text chunk I is expected to hold.
+static std::string chunkText(unsigned I) {
+  return ("chunk " + Twine(I) + std::string(I % 7 * 100, '.') + "\n").str();
+}
+
+static std::string expectedText(unsigned NumChunks) {
+  std::string Text;
+  for (unsigned I = 0; I != NumChunks; ++I)
+    Text += chunkText(I);
+  return Text;
+}
+
+// Fill the chunks, and commit them from several threads if possible, in an
+// order that is not the order of the chunks.
+static void fillChunks(raw_chunked_ostream &OS, unsigned NumChunks) {
+  std::vector<raw_chunked_ostream::Chunk *> Chunks;
+  for (unsigned I = 0; I != NumChunks; ++I)
+    Chunks.push_back(&OS.addChunk());
+  auto Fill = [&](unsigned Begin, unsigned Step) {
+    for (unsigned I = NumChunks - 1 - Begin; I < NumChunks; I -= Step) {
+      *Chunks[I] << chunkText(I);
+      OS.commit(*Chunks[I]);
+    }
+  };
+#if LLVM_ENABLE_THREADS
+  const unsigned NumThreads = 4;
+  std::vector<std::thread> Threads;
+  for (unsigned T = 0; T != NumThreads; ++T)
+    Threads.emplace_back(Fill, T, NumThreads);
+  for (std::thread &Thread : Threads)
+    Thread.join();
+#else
+  Fill(0, 1);
+#endif
+}
+
+TEST(raw_chunked_ostreamTest, Ordered) {
+  std::string Out;
+  raw_string_ostream StrOS(Out);
+  StrOS << "header\n";
+  {
+    raw_chunked_ostream OS(StrOS);
+    fillChunks(OS, 100);
+  }
+  StrOS << "trailer\n";
+  EXPECT_EQ("header\n" + expectedText(100) + "trailer\n", StrOS.str());
+}
+
+TEST(raw_chunked_ostreamTest, Empty) {
+  std::string Out;
+  raw_string_ostream StrOS(Out);
+  raw_chunked_ostream OS(StrOS);
+  OS.commit(OS.addChunk());
+  OS.finish();
+  EXPECT_EQ("", StrOS.str());
+}
+
+TEST(raw_chunked_ostreamTest, PwriteInChunk) {
+  std::string Out;
+  raw_string_ostream StrOS(Out);
+  raw_chunked_ostream OS(StrOS);
+  raw_chunked_ostream::Chunk &C = OS.addChunk();
+  raw_pwrite_stream &PS = C;
+  PS << "size=????, data";
+  PS.pwrite("0015", 4, 5);
+  OS.commit(C);
+  OS.finish();
+  EXPECT_EQ("size=0015, data", StrOS.str());
+}
+
+TEST(raw_chunked_ostreamTest, File) {
+  SmallString<64> Path;
+  int FD;
+  ASSERT_FALSE(sys::fs::createTemporaryFile("raw_chunked_ostream", "txt", FD,
+                                            Path));
+  FileRemover Cleanup(Path);
+  {
+    raw_fd_ostream FileOS(FD, /*shouldClose=*/true);
+    ASSERT_TRUE(FileOS.supportsSeeking());
+    FileOS << "header\n";
+    raw_chunked_ostream OS(FileOS);
+    fillChunks(OS, 1000);
+    OS.finish();
+    EXPECT_FALSE(OS.error());
+    FileOS << "trailer\n";
+    EXPECT_EQ(7 + expectedText(1000).size() + 8, FileOS.tell());
+  }
+  auto Buffer = MemoryBuffer::getFile(Path);
+  ASSERT_TRUE(bool(Buffer));
+  EXPECT_EQ("header\n" + expectedText(1000) + "trailer\n",
+            (*Buffer)->getBuffer());
+}
+
+TEST(raw_chunked_ostreamTest, AppendFile) {
+  SmallString<64> Path;
+  int FD;
+  ASSERT_FALSE(sys::fs::createTemporaryFile("raw_chunked_ostream", "txt", FD,
+                                            Path));
+  FileRemover Cleanup(Path);
+  {
+    raw_fd_ostream FileOS(FD, /*shouldClose=*/true);
+    FileOS << "header\n";
+  }
+  {
+    // The chunks are written in order when pwrite cannot be used.
+    std::error_code EC;
+    raw_fd_ostream FileOS(Path, EC, sys::fs::OF_Append);
+    ASSERT_FALSE(EC);
+    raw_chunked_ostream OS(FileOS);
+    fillChunks(OS, 100);
+  }
+  auto Buffer = MemoryBuffer::getFile(Path);
+  ASSERT_TRUE(bool(Buffer));
+  EXPECT_EQ("header\n" + expectedText(100), (*Buffer)->getBuffer());
+}
+
+} // end anonymous namespace
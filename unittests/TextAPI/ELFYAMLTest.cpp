@@ -7,10 +7,15 @@
 //
 //===-----------------------------------------------------------------------===/
 
+#include "llvm/ADT/SmallString.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/TextAPI/ELF/ELFStub.h"
 #include "llvm/TextAPI/ELF/TBEHandler.h"
 #include "llvm/Support/Error.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/FileUtilities.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Process.h"
 #include "llvm/Testing/Support/Error.h"
 #include "gtest/gtest.h"
 #include <string>
@@ -209,3 +214,121 @@ TEST(ElfYamlTextAPI, YAMLWritesNoTBESyms) {
   Result = OS.str();
   compareByLine(Result.c_str(), Expected);
 }
+
+TEST(ElfYamlTextAPI, YAMLReadsVersionedTBESymbols) {
+  const char Data[] = "--- !tapi-tbe\n"
+                      "TbeVersion: 1.0\n"
+                      "SoName: libc.so\n"
+                      "Arch: ARM\n"
+                      "Symbols:\n"
+                      "  foo: { Type: Func }\n"
+                      "  foo@@LIBC_N: { Type: Func }\n"
+                      "  foo@LIBC: { Type: Func }\n"
+                      "...\n";
+  Expected<std::unique_ptr<ELFStub>> StubOrErr = readTBEFromBuffer(Data);
+  ASSERT_THAT_ERROR(StubOrErr.takeError(), Succeeded());
+  std::unique_ptr<ELFStub> Stub = std::move(StubOrErr.get());
+  EXPECT_EQ(Stub->Arch, (uint16_t)llvm::ELF::EM_ARM);
+  EXPECT_EQ(Stub->Symbols.size(), 3u);
+
+  auto Iterator = Stub->Symbols.begin();
+  ELFSymbol const &SymFoo = *Iterator++;
+  EXPECT_STREQ(SymFoo.Name.c_str(), "foo");
+  EXPECT_FALSE(SymFoo.Version.hasValue());
+  EXPECT_FALSE(SymFoo.DefaultVersion);
+
+  ELFSymbol const &SymFooLibc = *Iterator++;
+  EXPECT_STREQ(SymFooLibc.Name.c_str(), "foo");
+  EXPECT_TRUE(SymFooLibc.Version.hasValue());
+  EXPECT_STREQ(SymFooLibc.Version->c_str(), "LIBC");
+  EXPECT_FALSE(SymFooLibc.DefaultVersion);
+
+  ELFSymbol const &SymFooLibcN = *Iterator++;
+  EXPECT_STREQ(SymFooLibcN.Name.c_str(), "foo");
+  EXPECT_TRUE(SymFooLibcN.Version.hasValue());
+  EXPECT_STREQ(SymFooLibcN.Version->c_str(), "LIBC_N");
+  EXPECT_TRUE(SymFooLibcN.DefaultVersion);
+}
+
+TEST(ElfYamlTextAPI, YAMLWritesVersionedTBESymbols) {
+  const char Expected[] =
+      "--- !tapi-tbe\n"
+      "TbeVersion:      1.0\n"
+      "Arch:            x86\n"
+      "Symbols:         \n"
+      "  bar@LIBC:        { Type: Object, Size: 4 }\n"
+      "  bar@@LIBC_N:     { Type: Object, Size: 8 }\n"
+      "...\n";
+  ELFStub Stub;
+  Stub.TbeVersion = VersionTuple(1, 0);
+  Stub.Arch = ELF::EM_386;
+
+  ELFSymbol SymBarN("bar");
+  SymBarN.Size = 8u;
+  SymBarN.Type = ELFSymbolType::Object;
+  SymBarN.Undefined = false;
+  SymBarN.Version = std::string("LIBC_N");
+  SymBarN.DefaultVersion = true;
+
+  ELFSymbol SymBar("bar");
+  SymBar.Size = 4u;
+  SymBar.Type = ELFSymbolType::Object;
+  SymBar.Undefined = false;
+  SymBar.Version = std::string("LIBC");
+
+  Stub.Symbols.insert(SymBarN);
+  Stub.Symbols.insert(SymBar);
+
+  std::string Result;
+  raw_string_ostream OS(Result);
+  ASSERT_THAT_ERROR(writeTBEToOutputStream(OS, Stub), Succeeded());
+  Result = OS.str();
+  compareByLine(Result.c_str(), Expected);
+}
+
+TEST(ElfYamlTextAPI, WritesTBEFileOnlyIfChanged) {
+  SmallString<128> Path;
+  ASSERT_FALSE(sys::fs::createTemporaryFile("stub", "tbe", Path));
+  FileRemover Cleanup(Path);
+
+  ELFStub Stub;
+  Stub.TbeVersion = VersionTuple(1, 0);
+  Stub.SoName = "libfoo.so";
+  Stub.Arch = ELF::EM_AARCH64;
+  ELFSymbol SymFoo("foo");
+  SymFoo.Type = ELFSymbolType::Func;
+  SymFoo.Undefined = false;
+  Stub.Symbols.insert(SymFoo);
+  ASSERT_THAT_ERROR(writeTBEToFileIfChanged(Path, Stub), Succeeded());
+
+  // Backdate the file, so that a rewrite would show in its modification time.
+  auto Past = sys::TimePoint<>(std::chrono::hours(24));
+  {
+    int FD;
+    ASSERT_FALSE(sys::fs::openFileForWrite(Path, FD, sys::fs::CD_OpenExisting,
+                                           sys::fs::OF_Append));
+    ASSERT_FALSE(sys::fs::setLastAccessAndModificationTime(FD, Past));
+    sys::Process::SafelyCloseFileDescriptor(FD);
+  }
+  sys::fs::file_status Status;
+  ASSERT_FALSE(sys::fs::status(Path, Status));
+  ASSERT_EQ(Status.getLastModificationTime(), Past);
+
+  // The same interface leaves the file alone.
+  ASSERT_THAT_ERROR(writeTBEToFileIfChanged(Path, Stub), Succeeded());
+  ASSERT_FALSE(sys::fs::status(Path, Status));
+  EXPECT_EQ(Status.getLastModificationTime(), Past);
+
+  // A new symbol rewrites it.
+  ELFSymbol SymBar("bar");
+  SymBar.Type = ELFSymbolType::Func;
+  SymBar.Undefined = false;
+  Stub.Symbols.insert(SymBar);
+  ASSERT_THAT_ERROR(writeTBEToFileIfChanged(Path, Stub), Succeeded());
+  ErrorOr<std::unique_ptr<MemoryBuffer>> Buf = MemoryBuffer::getFile(Path);
+  ASSERT_TRUE(bool(Buf));
+  Expected<std::unique_ptr<ELFStub>> StubOrErr =
+      readTBEFromBuffer((*Buf)->getBuffer());
+  ASSERT_THAT_ERROR(StubOrErr.takeError(), Succeeded());
+  EXPECT_EQ((*StubOrErr)->Symbols.size(), 2u);
+}
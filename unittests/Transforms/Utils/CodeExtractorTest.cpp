@@ -195,4 +195,67 @@ TEST(CodeExtractor, StoreOutputInvokeResultAfterEHPad) {
   EXPECT_FALSE(verifyFunction(*Func, &errs()));
 }
 
+TEST(CodeExtractor, ExtractSeveralRegionsWithCache) {
+  LLVMContext Ctx;
+  SMDiagnostic Err;
+  std::unique_ptr<Module> M(parseAssemblyString(R"invalid(
+    declare void @llvm.lifetime.start.p0i8(i64, i8* nocapture)
+    declare void @llvm.lifetime.end.p0i8(i64, i8* nocapture)
+
+    define void @foo(i1 %c1, i1 %c2) {
+    entry:
+      %a = alloca i8
+      %b = alloca i8
+      br i1 %c1, label %region1, label %join
+
+    region1:
+      call void @llvm.lifetime.start.p0i8(i64 1, i8* %a)
+      store i8 0, i8* %a
+      br label %join
+
+    join:
+      call void @llvm.lifetime.end.p0i8(i64 1, i8* %a)
+      br i1 %c2, label %region2, label %exit
+
+    region2:
+      call void @llvm.lifetime.start.p0i8(i64 1, i8* %b)
+      store i8 0, i8* %b
+      br label %exit
+
+    exit:
+      call void @llvm.lifetime.end.p0i8(i64 1, i8* %b)
+      ret void
+    }
+  )invalid",
+                                                Err, Ctx));
+
+  Function *Func = M->getFunction("foo");
+  AllocaInst *A = nullptr, *B = nullptr;
+  for (Instruction &I : Func->getEntryBlock())
+    if (auto *AI = dyn_cast<AllocaInst>(&I))
+      (A ? B : A) = AI;
+  ASSERT_TRUE(A && B);
+
+  DominatorTree DT(*Func);
+  CodeExtractorAnalysisCache CEAC(*Func);
+
+  // Nothing else accesses %a, so it moves to the outlined function along with
+  // its lifetime markers.
+  CodeExtractor CE1({getBlockByName(Func, "region1")}, &DT);
+  Function *Outlined1 = CE1.extractCodeRegion(CEAC);
+  ASSERT_TRUE(Outlined1);
+  EXPECT_EQ(Outlined1, A->getFunction());
+
+  // The call to the first outlined function, which the summary does not know
+  // of, may access %b, so it stays.
+  CodeExtractor CE2({getBlockByName(Func, "region2")}, &DT);
+  Function *Outlined2 = CE2.extractCodeRegion(CEAC);
+  ASSERT_TRUE(Outlined2);
+  EXPECT_EQ(Func, B->getFunction());
+
+  EXPECT_FALSE(verifyFunction(*Outlined1, &errs()));
+  EXPECT_FALSE(verifyFunction(*Outlined2, &errs()));
+  EXPECT_FALSE(verifyFunction(*Func, &errs()));
+}
+
 } // end anonymous namespace
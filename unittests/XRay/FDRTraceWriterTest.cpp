@@ -178,6 +178,110 @@ TEST(FDRTraceWriterTest, WriteToStringBufferVersion1) {
                           Field(&XRayRecord::Type, Eq(RecordTypes::EXIT))));
 }
 
+// Streaming a log must produce the same records as loading it, with the blocks
+// of each thread expanded together.
+TEST(FDRTraceWriterTest, StreamMatchesLoad) {
+  std::string Data;
+  raw_string_ostream OS(Data);
+  XRayFileHeader H;
+  H.Version = 3;
+  H.Type = 1;
+  H.ConstantTSC = true;
+  H.NonstopTSC = true;
+  H.CycleFrequency = 3e9;
+  FDRTraceWriter Writer(OS, H);
+  auto L = LogBuilder()
+               .add<BufferExtents>(80)
+               .add<NewBufferRecord>(1)
+               .add<WallclockRecord>(1, 1)
+               .add<PIDRecord>(1)
+               .add<NewCPUIDRecord>(1, 2)
+               .add<FunctionRecord>(RecordTypes::ENTER, 1, 1)
+               .add<FunctionRecord>(RecordTypes::EXIT, 1, 100)
+               .add<BufferExtents>(80)
+               .add<NewBufferRecord>(2)
+               .add<WallclockRecord>(1, 2)
+               .add<PIDRecord>(1)
+               .add<NewCPUIDRecord>(1, 2)
+               .add<FunctionRecord>(RecordTypes::ENTER, 2, 1)
+               .add<FunctionRecord>(RecordTypes::EXIT, 2, 100)
+               .add<BufferExtents>(80)
+               .add<NewBufferRecord>(1)
+               .add<WallclockRecord>(2, 3)
+               .add<PIDRecord>(1)
+               .add<NewCPUIDRecord>(1, 200)
+               .add<FunctionRecord>(RecordTypes::ENTER, 3, 1)
+               .add<FunctionRecord>(RecordTypes::EXIT, 3, 100)
+               .consume();
+  for (auto &P : L)
+    ASSERT_FALSE(errorToBool(P->apply(Writer)));
+  OS.flush();
+
+  DataExtractor DE(Data, sys::IsLittleEndianHost, 8);
+  auto TraceOrErr = loadTrace(DE);
+  if (!TraceOrErr)
+    FAIL() << TraceOrErr.takeError();
+  auto &Trace = TraceOrErr.get();
+
+  XRayFileHeader StreamedHeader;
+  std::vector<XRayRecord> Streamed;
+  ASSERT_FALSE(errorToBool(
+      streamTrace(DE, StreamedHeader, [&](const XRayRecord &R) {
+        Streamed.push_back(R);
+        return Error::success();
+      })));
+  EXPECT_EQ(StreamedHeader.Version, 3);
+  ASSERT_EQ(Streamed.size(), Trace.size());
+  // The two blocks of thread 1 are expanded one after the other.
+  size_t First = Streamed[0].TId == 1 ? 0 : 2;
+  EXPECT_EQ(Streamed[First].FuncId, 1);
+  EXPECT_EQ(Streamed[First + 1].FuncId, 1);
+  EXPECT_EQ(Streamed[First + 2].FuncId, 3);
+  EXPECT_EQ(Streamed[First + 3].FuncId, 3);
+  for (size_t I = 0, E = Trace.size(); I != E; ++I) {
+    const XRayRecord &Loaded = *(Trace.begin() + I);
+    EXPECT_EQ(Streamed[I].FuncId, Loaded.FuncId);
+    EXPECT_EQ(Streamed[I].TSC, Loaded.TSC);
+    EXPECT_EQ(Streamed[I].TId, Loaded.TId);
+    EXPECT_EQ(Streamed[I].Type, Loaded.Type);
+  }
+
+  // An error from the callback stops the stream.
+  unsigned NumSeen = 0;
+  Error E = streamTrace(DE, StreamedHeader, [&](const XRayRecord &) {
+    ++NumSeen;
+    return createStringError(std::make_error_code(std::errc::invalid_argument),
+                             "stop");
+  });
+  EXPECT_TRUE(errorToBool(std::move(E)));
+  EXPECT_EQ(NumSeen, 1u);
+
+  // Expanding the threads concurrently gives the records of each thread in the
+  // same order, and loads them in the same order as a serial load.
+  std::vector<XRayRecord> ByWorker[2];
+  ASSERT_FALSE(errorToBool(streamTrace(
+      DE, StreamedHeader, 2, [&](unsigned Worker, const XRayRecord &R) {
+        EXPECT_LT(Worker, 2u);
+        ByWorker[Worker].push_back(R);
+        return Error::success();
+      })));
+  EXPECT_EQ(ByWorker[0].size() + ByWorker[1].size(), Trace.size());
+  for (auto &Records : ByWorker)
+    for (size_t I = 1; I < Records.size(); ++I)
+      if (Records[I].TId == Records[I - 1].TId)
+        EXPECT_GE(Records[I].TSC, Records[I - 1].TSC);
+
+  auto ParallelTraceOrErr = loadTrace(DE, false, 2);
+  if (!ParallelTraceOrErr)
+    FAIL() << ParallelTraceOrErr.takeError();
+  auto &ParallelTrace = ParallelTraceOrErr.get();
+  ASSERT_EQ(ParallelTrace.size(), Trace.size());
+  for (size_t I = 0, N = Trace.size(); I != N; ++I) {
+    EXPECT_EQ((Trace.begin() + I)->FuncId, (ParallelTrace.begin() + I)->FuncId);
+    EXPECT_EQ((Trace.begin() + I)->TSC, (ParallelTrace.begin() + I)->TSC);
+  }
+}
+
 } // namespace
 } // namespace xray
 } // namespace llvm
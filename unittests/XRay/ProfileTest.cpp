@@ -259,6 +259,70 @@ TEST(ProfileTest, MergeProfilesByThreadAccumulate) {
                                      Field(&Profile::Data::CumulativeLocalTime,
                                            Eq(1000u)))))))));
 }
+
+TEST(ProfileTest, MergeManyProfiles) {
+  std::vector<Profile> Profiles(3);
+  for (unsigned I = 0; I != Profiles.size(); ++I) {
+    auto &P = Profiles[I];
+    // Intern the paths in a different order in each profile, so that their
+    // PathIDs differ between the profiles.
+    if (I % 2)
+      P.internPath({3, 1});
+    EXPECT_FALSE(errorToBool(P.addBlock(Profile::Block{
+        Profile::ThreadID{1},
+        {{P.internPath({2, 1}), Profile::Data{1, 1000}},
+         {P.internPath({3, 1}), Profile::Data{I, 100}}}})));
+    EXPECT_FALSE(errorToBool(P.addBlock(Profile::Block{
+        Profile::ThreadID{I}, {{P.internPath({2, 1}), Profile::Data{1, 10}}}})));
+  }
+
+  Profile ByThread = mergeAllProfilesByThread(Profiles);
+  EXPECT_THAT(
+      ByThread,
+      UnorderedElementsAre(
+          AllOf(Field(&Profile::Block::Thread, Eq(Profile::ThreadID{0})),
+                Field(&Profile::Block::PathData,
+                      ElementsAre(Pair(
+                          ByThread.internPath({2, 1}),
+                          AllOf(Field(&Profile::Data::CallCount, Eq(1u)),
+                                Field(&Profile::Data::CumulativeLocalTime,
+                                      Eq(10u))))))),
+          AllOf(Field(&Profile::Block::Thread, Eq(Profile::ThreadID{1})),
+                Field(&Profile::Block::PathData,
+                      UnorderedElementsAre(
+                          Pair(ByThread.internPath({2, 1}),
+                               AllOf(Field(&Profile::Data::CallCount, Eq(4u)),
+                                     Field(&Profile::Data::CumulativeLocalTime,
+                                           Eq(3010u)))),
+                          Pair(ByThread.internPath({3, 1}),
+                               AllOf(Field(&Profile::Data::CallCount, Eq(3u)),
+                                     Field(&Profile::Data::CumulativeLocalTime,
+                                           Eq(300u))))))),
+          AllOf(Field(&Profile::Block::Thread, Eq(Profile::ThreadID{2})),
+                Field(&Profile::Block::PathData,
+                      ElementsAre(Pair(
+                          ByThread.internPath({2, 1}),
+                          AllOf(Field(&Profile::Data::CallCount, Eq(1u)),
+                                Field(&Profile::Data::CumulativeLocalTime,
+                                      Eq(10u)))))))));
+
+  Profile ByStack = mergeAllProfilesByStack(Profiles);
+  EXPECT_THAT(
+      ByStack,
+      ElementsAre(AllOf(
+          Field(&Profile::Block::Thread, Eq(Profile::ThreadID{0})),
+          Field(&Profile::Block::PathData,
+                UnorderedElementsAre(
+                    Pair(ByStack.internPath({2, 1}),
+                         AllOf(Field(&Profile::Data::CallCount, Eq(6u)),
+                               Field(&Profile::Data::CumulativeLocalTime,
+                                     Eq(3030u)))),
+                    Pair(ByStack.internPath({3, 1}),
+                         AllOf(Field(&Profile::Data::CallCount, Eq(3u)),
+                               Field(&Profile::Data::CumulativeLocalTime,
+                                     Eq(300u)))))))));
+}
+
 // FIXME: Add a test creating a Trace and generating a Profile
 // FIXME: Add tests for ranking/sorting profile blocks by dimension
 
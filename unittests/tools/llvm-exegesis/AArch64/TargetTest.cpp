@@ -75,6 +75,15 @@ TEST_F(AArch64TargetTest, DefaultPfmCounters) {
             Expected);
 }
 
+TEST_F(AArch64TargetTest, CortexA57PfmCounters) {
+  const PfmCountersInfo &PCI = ExegesisTarget_->getPfmCounters("cortex-a57");
+  EXPECT_EQ(PCI.CycleCounter, std::string("CPU_CYCLES"));
+  EXPECT_EQ(PCI.UopsCounter, std::string("INST_SPEC"));
+  ASSERT_EQ(PCI.NumIssueCounters, 3u);
+  EXPECT_EQ(PCI.IssueCounters[1].ProcResName, std::string("A57UnitL"));
+  EXPECT_EQ(PCI.IssueCounters[1].Counter, std::string("LD_SPEC"));
+}
+
 } // namespace
 } // namespace exegesis
 } // namespace llvm
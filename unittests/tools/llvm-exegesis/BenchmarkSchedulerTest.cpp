@@ -0,0 +1,39 @@
+//===-- BenchmarkSchedulerTest.cpp ------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "BenchmarkScheduler.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace llvm {
+namespace exegesis {
+
+namespace {
+
+InstructionBenchmark makeBenchmark(double Cycles, double Uops) {
+  InstructionBenchmark Result;
+  Result.Measurements.push_back(BenchmarkMeasure::Create("cycles", Cycles));
+  Result.Measurements.push_back(BenchmarkMeasure::Create("uops", Uops));
+  return Result;
+}
+
+TEST(BenchmarkSchedulerTest, IsNoisy) {
+  const InstructionBenchmark Base = makeBenchmark(4.0, 2.0);
+  EXPECT_FALSE(isNoisy(Base, makeBenchmark(4.0, 2.0), 0.05));
+  EXPECT_FALSE(isNoisy(Base, makeBenchmark(4.1, 2.0), 0.05));
+  EXPECT_TRUE(isNoisy(Base, makeBenchmark(4.0, 2.2), 0.05));
+  EXPECT_TRUE(isNoisy(makeBenchmark(4.0, 2.2), Base, 0.05));
+  EXPECT_FALSE(isNoisy(makeBenchmark(0.0, 0.0), makeBenchmark(0.0, 0.0), 0.05));
+  // Runs that do not measure the same things cannot be compared.
+  EXPECT_TRUE(isNoisy(Base, InstructionBenchmark(), 0.05));
+}
+
+} // namespace
+} // namespace exegesis
+} // namespace llvm
@@ -89,6 +89,47 @@ TEST(ClusteringTest, Clusters3D_InvalidOrder) {
   consumeError(std::move(Error));
 }
 
+// Clusters with many points in more dimensions than the index uses.
+TEST(ClusteringTest, ManyPoints) {
+  constexpr const size_t kPointsPerCluster = 1000;
+  std::vector<InstructionBenchmark> Points(3 * kPointsPerCluster);
+  for (size_t I = 0; I < Points.size(); ++I) {
+    const double Center = 10.0 * (I % 3);
+    const double Jitter = 0.001 * (I % 7);
+    Points[I].Measurements = {{"a", Center + Jitter, 0.0},
+                              {"b", 0.0, 0.0},
+                              {"c", Center - Jitter, 0.0},
+                              {"d", 2 * Center, 0.0},
+                              {"e", 0.01 * (I % 2), 0.0}};
+  }
+  auto Clustering = InstructionBenchmarkClustering::create(Points, 2, 0.25);
+  ASSERT_TRUE((bool)Clustering);
+  ASSERT_EQ(Clustering.get().getValidClusters().size(), 3u);
+  for (const auto &Cluster : Clustering.get().getValidClusters()) {
+    EXPECT_EQ(Cluster.PointIndices.size(), kPointsPerCluster);
+    for (const int P : Cluster.PointIndices)
+      EXPECT_EQ(P % 3, Cluster.PointIndices.front() % 3);
+  }
+  EXPECT_TRUE(
+      Clustering.get()
+          .getCluster(InstructionBenchmarkClustering::ClusterId::noise())
+          .PointIndices.empty());
+}
+
+TEST(ClusteringTest, ZeroEpsilon) {
+  std::vector<InstructionBenchmark> Points(3);
+  Points[0].Measurements = {{"x", 1.0, 0.0}};
+  Points[1].Measurements = {{"x", 2.0, 0.0}};
+  Points[2].Measurements = {{"x", 1.0, 0.0}};
+  auto Clustering = InstructionBenchmarkClustering::create(Points, 2, 0.0);
+  ASSERT_TRUE((bool)Clustering);
+  EXPECT_EQ(Clustering.get().getValidClusters().size(), 1u);
+  EXPECT_EQ(Clustering.get().getClusterIdForPoint(0),
+            Clustering.get().getClusterIdForPoint(2));
+  EXPECT_EQ(Clustering.get().getClusterIdForPoint(1),
+            InstructionBenchmarkClustering::ClusterId::noise());
+}
+
 TEST(ClusteringTest, Ordering) {
   ASSERT_LT(InstructionBenchmarkClustering::ClusterId::makeValid(1),
             InstructionBenchmarkClustering::ClusterId::makeValid(2));
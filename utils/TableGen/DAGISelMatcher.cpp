@@ -148,6 +148,10 @@ void MoveParentMatcher::printImpl(raw_ostream &OS, unsigned indent) const {
   OS.indent(indent) << "MoveParent\n";
 }
 
+void MoveSiblingMatcher::printImpl(raw_ostream &OS, unsigned indent) const {
+  OS.indent(indent) << "MoveSibling " << SiblingNo << '\n';
+}
+
 void CheckSameMatcher::printImpl(raw_ostream &OS, unsigned indent) const {
   OS.indent(indent) << "CheckSame " << MatchNumber << '\n';
 }
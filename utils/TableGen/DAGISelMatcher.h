@@ -53,6 +53,7 @@ public:
     CaptureGlueInput,     // If the current node has an input glue, save it.
     MoveChild,            // Move current node to specified child.
     MoveParent,           // Move current node to parent.
+    MoveSibling,          // Move current node to specified sibling.
 
     // Predicate checking.
     CheckSame,            // Fail if not same as prev match.
@@ -341,6 +342,28 @@ private:
   bool isEqualImpl(const Matcher *M) const override { return true; }
 };
 
+/// MoveSiblingMatcher - This tells the interpreter to move to the specified
+/// child of the parent of the current node.  This is logically equivalent to:
+///    MoveParent + MoveChild N.
+class MoveSiblingMatcher : public Matcher {
+  unsigned SiblingNo;
+public:
+  MoveSiblingMatcher(unsigned siblingNo)
+    : Matcher(MoveSibling), SiblingNo(siblingNo) {}
+
+  unsigned getSiblingNo() const { return SiblingNo; }
+
+  static bool classof(const Matcher *N) {
+    return N->getKind() == MoveSibling;
+  }
+
+private:
+  void printImpl(raw_ostream &OS, unsigned indent) const override;
+  bool isEqualImpl(const Matcher *M) const override {
+    return cast<MoveSiblingMatcher>(M)->getSiblingNo() == getSiblingNo();
+  }
+};
+
 /// CheckSameMatcher - This checks to see if this node is exactly the same
 /// node as the specified match that was recorded with 'Record'.  This is used
 /// when patterns have the same name in them, like '(mul GPR:$in, GPR:$in)'.
@@ -476,6 +499,17 @@ public:
   Matcher *getCaseMatcher(unsigned i) { return Cases[i].second; }
   const Matcher *getCaseMatcher(unsigned i) const { return Cases[i].second; }
 
+  void resetCaseMatcher(unsigned i, Matcher *N) {
+    delete Cases[i].second;
+    Cases[i].second = N;
+  }
+
+  Matcher *takeCaseMatcher(unsigned i) {
+    Matcher *Res = Cases[i].second;
+    Cases[i].second = nullptr;
+    return Res;
+  }
+
 private:
   void printImpl(raw_ostream &OS, unsigned indent) const override;
   bool isEqualImpl(const Matcher *M) const override { return false; }
@@ -526,6 +560,17 @@ public:
   Matcher *getCaseMatcher(unsigned i) { return Cases[i].second; }
   const Matcher *getCaseMatcher(unsigned i) const { return Cases[i].second; }
 
+  void resetCaseMatcher(unsigned i, Matcher *N) {
+    delete Cases[i].second;
+    Cases[i].second = N;
+  }
+
+  Matcher *takeCaseMatcher(unsigned i) {
+    Matcher *Res = Cases[i].second;
+    Cases[i].second = nullptr;
+    return Res;
+  }
+
 private:
   void printImpl(raw_ostream &OS, unsigned indent) const override;
   bool isEqualImpl(const Matcher *M) const override { return false; }
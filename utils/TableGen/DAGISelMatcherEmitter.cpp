@@ -80,8 +80,20 @@ class MatcherTableEmitter {
   }
 
 public:
-  MatcherTableEmitter(const CodeGenDAGPatterns &cgp)
-    : CGP(cgp) {}
+  MatcherTableEmitter(const Matcher *TheMatcher, const CodeGenDAGPatterns &cgp)
+    : CGP(cgp) {
+    // Number the predicates from the most to the least commonly checked one,
+    // so that most checks can use the compact OPC_CheckPatternPredicate0...7
+    // and OPC_CheckPredicate0...7 forms.
+    MapVector<StringRef, unsigned> PatternPredicateUses;
+    MapVector<TreePattern *, unsigned> NodePredicateUses;
+    countPredicateUses(TheMatcher, PatternPredicateUses, NodePredicateUses);
+
+    for (const auto &Use : sortByUses(PatternPredicateUses.takeVector()))
+      getPatternPredicate(Use.first);
+    for (const auto &Use : sortByUses(NodePredicateUses.takeVector()))
+      getNodePredicate(TreePredicateFn(Use.first));
+  }
 
   unsigned EmitMatcherList(const Matcher *N, unsigned Indent,
                            unsigned StartIdx, raw_ostream &OS);
@@ -93,6 +105,22 @@ public:
   void EmitPatternMatchTable(raw_ostream &OS);
 
 private:
+  static void
+  countPredicateUses(const Matcher *N,
+                     MapVector<StringRef, unsigned> &PatternPredicateUses,
+                     MapVector<TreePattern *, unsigned> &NodePredicateUses);
+
+  template <typename KeyT>
+  static std::vector<std::pair<KeyT, unsigned>>
+  sortByUses(std::vector<std::pair<KeyT, unsigned>> Uses) {
+    std::stable_sort(Uses.begin(), Uses.end(),
+                     [](const std::pair<KeyT, unsigned> &A,
+                        const std::pair<KeyT, unsigned> &B) {
+                       return A.second > B.second;
+                     });
+    return Uses;
+  }
+
   void EmitNodePredicatesFunction(const std::vector<TreePredicateFn> &Preds,
                                   StringRef Decl, raw_ostream &OS);
 
@@ -158,6 +186,33 @@ private:
 };
 } // end anonymous namespace.
 
+void MatcherTableEmitter::countPredicateUses(
+    const Matcher *N, MapVector<StringRef, unsigned> &PatternPredicateUses,
+    MapVector<TreePattern *, unsigned> &NodePredicateUses) {
+  for (; N; N = N->getNext()) {
+    if (const auto *CPPM = dyn_cast<CheckPatternPredicateMatcher>(N))
+      ++PatternPredicateUses[CPPM->getPredicate()];
+    else if (const auto *CPM = dyn_cast<CheckPredicateMatcher>(N))
+      ++NodePredicateUses[CPM->getPredicate().getOrigPatFragRecord()];
+
+    // Handle recursive nodes.
+    if (const ScopeMatcher *SM = dyn_cast<ScopeMatcher>(N)) {
+      for (unsigned i = 0, e = SM->getNumChildren(); i != e; ++i)
+        countPredicateUses(SM->getChild(i), PatternPredicateUses,
+                           NodePredicateUses);
+    } else if (const SwitchOpcodeMatcher *SOM =
+                   dyn_cast<SwitchOpcodeMatcher>(N)) {
+      for (unsigned i = 0, e = SOM->getNumCases(); i != e; ++i)
+        countPredicateUses(SOM->getCaseMatcher(i), PatternPredicateUses,
+                           NodePredicateUses);
+    } else if (const SwitchTypeMatcher *STM = dyn_cast<SwitchTypeMatcher>(N)) {
+      for (unsigned i = 0, e = STM->getNumCases(); i != e; ++i)
+        countPredicateUses(STM->getCaseMatcher(i), PatternPredicateUses,
+                           NodePredicateUses);
+    }
+  }
+}
+
 static std::string GetPatFromTreePatternNode(const TreePatternNode *N) {
   std::string str;
   raw_string_ostream Stream(str);
@@ -387,6 +442,17 @@ EmitMatcher(const Matcher *N, unsigned Indent, unsigned CurrentIdx,
     OS << "OPC_MoveParent,\n";
     return 1;
 
+  case Matcher::MoveSibling: {
+    const auto *MSM = cast<MoveSiblingMatcher>(N);
+
+    OS << "OPC_MoveSibling";
+    // Handle the specialized forms.
+    if (MSM->getSiblingNo() >= 8)
+      OS << ", ";
+    OS << MSM->getSiblingNo() << ",\n";
+    return (MSM->getSiblingNo() >= 8) ? 2 : 1;
+  }
+
   case Matcher::CheckSame:
     OS << "OPC_CheckSame, "
        << cast<CheckSameMatcher>(N)->getMatchNumber() << ",\n";
@@ -400,31 +466,42 @@ EmitMatcher(const Matcher *N, unsigned Indent, unsigned CurrentIdx,
 
   case Matcher::CheckPatternPredicate: {
     StringRef Pred =cast<CheckPatternPredicateMatcher>(N)->getPredicate();
-    OS << "OPC_CheckPatternPredicate, " << getPatternPredicate(Pred) << ',';
+    unsigned PredNo = getPatternPredicate(Pred);
+    // Handle the specialized forms.
+    if (PredNo < 8)
+      OS << "OPC_CheckPatternPredicate" << PredNo << ',';
+    else
+      OS << "OPC_CheckPatternPredicate, " << PredNo << ',';
     if (!OmitComments)
       OS << " // " << Pred;
     OS << '\n';
-    return 2;
+    return PredNo < 8 ? 1 : 2;
   }
   case Matcher::CheckPredicate: {
     TreePredicateFn Pred = cast<CheckPredicateMatcher>(N)->getPredicate();
-    unsigned OperandBytes = 0;
+    unsigned PredNo = getNodePredicate(Pred);
+    unsigned Bytes;
 
     if (Pred.usesOperands()) {
       unsigned NumOps = cast<CheckPredicateMatcher>(N)->getNumOperands();
       OS << "OPC_CheckPredicateWithOperands, " << NumOps << "/*#Ops*/, ";
       for (unsigned i = 0; i < NumOps; ++i)
         OS << cast<CheckPredicateMatcher>(N)->getOperandNo(i) << ", ";
-      OperandBytes = 1 + NumOps;
+      OS << PredNo << ',';
+      Bytes = 3 + NumOps;
+    } else if (PredNo < 8) {
+      // Handle the specialized forms.
+      OS << "OPC_CheckPredicate" << PredNo << ',';
+      Bytes = 1;
     } else {
-      OS << "OPC_CheckPredicate, ";
+      OS << "OPC_CheckPredicate, " << PredNo << ',';
+      Bytes = 2;
     }
 
-    OS << getNodePredicate(Pred) << ',';
     if (!OmitComments)
       OS << " // " << Pred.getFnName();
     OS << '\n';
-    return 2 + OperandBytes;
+    return Bytes;
   }
 
   case Matcher::CheckOpcode:
@@ -983,6 +1060,7 @@ static StringRef getOpcodeString(Matcher::KindTy Kind) {
   case Matcher::CaptureGlueInput: return "OPC_CaptureGlueInput"; break;
   case Matcher::MoveChild: return "OPC_MoveChild"; break;
   case Matcher::MoveParent: return "OPC_MoveParent"; break;
+  case Matcher::MoveSibling: return "OPC_MoveSibling"; break;
   case Matcher::CheckSame: return "OPC_CheckSame"; break;
   case Matcher::CheckChildSame: return "OPC_CheckChildSame"; break;
   case Matcher::CheckPatternPredicate:
@@ -1068,7 +1146,7 @@ void llvm::EmitMatcherTable(const Matcher *TheMatcher,
   OS << "#endif\n\n";
 
   BeginEmitFunction(OS, "void", "SelectCode(SDNode *N)", false/*AddOverride*/);
-  MatcherTableEmitter MatcherEmitter(CGP);
+  MatcherTableEmitter MatcherEmitter(TheMatcher, CGP);
 
   OS << "{\n";
   OS << "  // Some target values are emitted as 2 bytes, TARGET_VAL handles\n";
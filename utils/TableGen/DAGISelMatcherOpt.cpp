@@ -459,9 +459,54 @@ static void FactorNodes(std::unique_ptr<Matcher> &InputMatcherPtr) {
     Scope->resetChild(i, NewOptionsToMatch[i]);
 }
 
+/// FormMoveSiblings - Turn 'MoveParent+MoveChild' into MoveSibling.  This is
+/// done after factoring, which only knows how to move MoveChild and
+/// MoveParent nodes around.
+static void FormMoveSiblings(std::unique_ptr<Matcher> &MatcherPtr) {
+  // If we reached the end of the chain, we're done.
+  Matcher *N = MatcherPtr.get();
+  if (!N) return;
+
+  // Walk down all the children of the nodes that have them.
+  if (ScopeMatcher *Scope = dyn_cast<ScopeMatcher>(N)) {
+    for (unsigned i = 0, e = Scope->getNumChildren(); i != e; ++i) {
+      std::unique_ptr<Matcher> Child(Scope->takeChild(i));
+      FormMoveSiblings(Child);
+      Scope->resetChild(i, Child.release());
+    }
+    return;
+  }
+  if (SwitchOpcodeMatcher *SOM = dyn_cast<SwitchOpcodeMatcher>(N)) {
+    for (unsigned i = 0, e = SOM->getNumCases(); i != e; ++i) {
+      std::unique_ptr<Matcher> Case(SOM->takeCaseMatcher(i));
+      FormMoveSiblings(Case);
+      SOM->resetCaseMatcher(i, Case.release());
+    }
+    return;
+  }
+  if (SwitchTypeMatcher *STM = dyn_cast<SwitchTypeMatcher>(N)) {
+    for (unsigned i = 0, e = STM->getNumCases(); i != e; ++i) {
+      std::unique_ptr<Matcher> Case(STM->takeCaseMatcher(i));
+      FormMoveSiblings(Case);
+      STM->resetCaseMatcher(i, Case.release());
+    }
+    return;
+  }
+
+  if (isa<MoveParentMatcher>(N))
+    if (auto *MC = dyn_cast_or_null<MoveChildMatcher>(N->getNext())) {
+      Matcher *MS = new MoveSiblingMatcher(MC->getChildNo());
+      MS->setNext(MC->takeNext());
+      MatcherPtr.reset(MS);
+    }
+
+  FormMoveSiblings(MatcherPtr->getNextPtr());
+}
+
 void
 llvm::OptimizeMatcher(std::unique_ptr<Matcher> &MatcherPtr,
                       const CodeGenDAGPatterns &CGP) {
   ContractNodes(MatcherPtr, CGP);
   FactorNodes(MatcherPtr);
+  FormMoveSiblings(MatcherPtr);
 }
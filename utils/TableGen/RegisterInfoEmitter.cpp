@@ -39,6 +39,7 @@
 #include <cstdint>
 #include <deque>
 #include <iterator>
+#include <map>
 #include <set>
 #include <string>
 #include <vector>
@@ -52,11 +53,18 @@ static cl::opt<bool>
                       cl::desc("Dump register information to help debugging"),
                       cl::cat(RegisterInfoCat));
 
+static cl::opt<unsigned> MaxSubRegDeltaTableEntries(
+    "max-subreg-delta-table-entries", cl::init(32768),
+    cl::desc("Largest table to emit for direct sub-register lookups"),
+    cl::cat(RegisterInfoCat));
+
 namespace {
 
 class RegisterInfoEmitter {
   CodeGenTarget Target;
   RecordKeeper &Records;
+  // Whether runMCDesc emitted the SubRegDeltas table.
+  bool HasSubRegDeltas = false;
 
 public:
   RegisterInfoEmitter(RecordKeeper &R) : Target(R), Records(R) {
@@ -91,6 +99,7 @@ private:
                             bool isCtor);
   void EmitRegUnitPressure(raw_ostream &OS, const CodeGenRegBank &RegBank,
                            const std::string &ClassName);
+  void emitSubRegDeltaTable(raw_ostream &OS, CodeGenRegBank &RegBank);
   void emitComposeSubRegIndices(raw_ostream &OS, CodeGenRegBank &RegBank,
                                 const std::string &ClassName);
   void emitComposeSubRegIndexLaneMask(raw_ostream &OS, CodeGenRegBank &RegBank,
@@ -689,6 +698,61 @@ static bool combine(const CodeGenSubRegIndex *Idx,
   return true;
 }
 
+// Emit a table that maps a register and a sub-register index directly to the
+// sub-register, so that MCRegisterInfo::getSubReg does not have to walk the
+// sub-register lists. Each row holds the distances from a register to its
+// sub-registers, indexed by sub-register index, with 0 where the register has
+// no such sub-register. Registers with the same distances share a row.
+void RegisterInfoEmitter::emitSubRegDeltaTable(raw_ostream &OS,
+                                               CodeGenRegBank &RegBank) {
+  const std::string &TargetName = Target.getName();
+  const auto &Regs = RegBank.getRegisters();
+  unsigned NumSubRegIndices =
+      std::distance(RegBank.getSubRegIndices().begin(),
+                    RegBank.getSubRegIndices().end()) + 1;
+
+  // Row 0, used by the registers without sub-registers, is all zeros.
+  std::map<std::vector<uint16_t>, unsigned> RowNumbers;
+  // The row of each register, the first being NoRegister.
+  std::vector<const std::vector<uint16_t> *> Rows;
+  std::vector<unsigned> RegRows(1, 0);
+  std::vector<uint16_t> Deltas(NumSubRegIndices);
+  Rows.push_back(&RowNumbers.insert({Deltas, 0}).first->first);
+  for (const auto &Reg : Regs) {
+    std::fill(Deltas.begin(), Deltas.end(), 0);
+    for (const auto &SubReg : Reg.getSubRegs())
+      Deltas[SubReg.first->EnumValue] =
+          uint16_t(SubReg.second->EnumValue - Reg.EnumValue);
+    auto Ins = RowNumbers.insert({Deltas, Rows.size()});
+    if (Ins.second)
+      Rows.push_back(&Ins.first->first);
+    RegRows.push_back(Ins.first->second);
+  }
+
+  // Targets with many sub-register structures, such as those with register
+  // tuples, would need too large a table: they keep walking the lists. The
+  // row offsets must also fit in 16 bits.
+  uint64_t NumEntries = uint64_t(Rows.size()) * NumSubRegIndices;
+  HasSubRegDeltas =
+      NumEntries <= MaxSubRegDeltaTableEntries && NumEntries <= 0x10000;
+  if (!HasSubRegDeltas)
+    return;
+
+  OS << "extern const MCPhysReg " << TargetName << "SubRegDeltas[] = {\n";
+  for (const std::vector<uint16_t> *Row : Rows) {
+    OS << " ";
+    for (uint16_t Delta : *Row)
+      OS << " " << Delta << ",";
+    OS << "\n";
+  }
+  OS << "};\n\n";
+
+  OS << "extern const uint16_t " << TargetName << "SubRegDeltaRows[] = {\n";
+  for (unsigned Row : RegRows)
+    OS << "  " << Row * NumSubRegIndices << ",\n";
+  OS << "};\n\n";
+}
+
 void
 RegisterInfoEmitter::emitComposeSubRegIndices(raw_ostream &OS,
                                               CodeGenRegBank &RegBank,
@@ -1027,6 +1091,8 @@ RegisterInfoEmitter::runMCDesc(raw_ostream &OS, CodeGenTarget &Target,
   }
   OS << "};\n\n";
 
+  emitSubRegDeltaTable(OS, RegBank);
+
   const auto &RegisterClasses = RegBank.getRegClasses();
 
   // Loop over all of the register classes... emitting each one.
@@ -1117,7 +1183,11 @@ RegisterInfoEmitter::runMCDesc(raw_ostream &OS, CodeGenTarget &Target,
      << TargetName << "RegClassStrings, " << TargetName << "SubRegIdxLists, "
      << (std::distance(SubRegIndices.begin(), SubRegIndices.end()) + 1) << ",\n"
      << TargetName << "SubRegIdxRanges, " << TargetName
-     << "RegEncodingTable);\n\n";
+     << "RegEncodingTable";
+  if (HasSubRegDeltas)
+    OS << ", " << TargetName << "SubRegDeltas, " << TargetName
+       << "SubRegDeltaRows";
+  OS << ");\n\n";
 
   EmitRegMapping(OS, Regs, false);
 
@@ -1501,6 +1571,10 @@ RegisterInfoEmitter::runTargetDesc(raw_ostream &OS, CodeGenTarget &Target,
   OS << "extern const MCRegisterInfo::SubRegCoveredBits "
      << TargetName << "SubRegIdxRanges[];\n";
   OS << "extern const uint16_t " << TargetName << "RegEncodingTable[];\n";
+  if (HasSubRegDeltas) {
+    OS << "extern const MCPhysReg " << TargetName << "SubRegDeltas[];\n";
+    OS << "extern const uint16_t " << TargetName << "SubRegDeltaRows[];\n";
+  }
 
   EmitRegMappingTables(OS, Regs, true);
 
@@ -1525,7 +1599,11 @@ RegisterInfoEmitter::runTargetDesc(raw_ostream &OS, CodeGenTarget &Target,
      << "                     " << TargetName << "SubRegIdxLists,\n"
      << "                     " << SubRegIndicesSize + 1 << ",\n"
      << "                     " << TargetName << "SubRegIdxRanges,\n"
-     << "                     " << TargetName << "RegEncodingTable);\n\n";
+     << "                     " << TargetName << "RegEncodingTable";
+  if (HasSubRegDeltas)
+    OS << ",\n                     " << TargetName << "SubRegDeltas,\n"
+       << "                     " << TargetName << "SubRegDeltaRows";
+  OS << ");\n\n";
 
   EmitRegMapping(OS, Regs, true);
 
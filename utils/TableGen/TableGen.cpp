@@ -243,6 +243,14 @@ bool LLVMTableGenMain(raw_ostream &OS, RecordKeeper &Records) {
 }
 }
 
+static bool LLVMTableGenSelect(StringRef Name) {
+  ActionType A;
+  if (Action.getParser().parse(Action, Name, "", A))
+    return true;
+  Action = A;
+  return false;
+}
+
 int main(int argc, char **argv) {
   sys::PrintStackTraceOnErrorSignal(argv[0]);
   PrettyStackTraceProgram X(argc, argv);
@@ -250,7 +258,7 @@ int main(int argc, char **argv) {
 
   llvm_shutdown_obj Y;
 
-  return TableGenMain(argv[0], &LLVMTableGenMain);
+  return TableGenMain(argv[0], &LLVMTableGenMain, &LLVMTableGenSelect);
 }
 
 #ifdef __has_feature
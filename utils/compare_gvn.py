@@ -0,0 +1,81 @@
+#!/usr/bin/env python
+#
+# Compare GVN and NewGVN on a set of IR files.
+#
+# For every input file, the script runs opt once with each of the given pass
+# pipelines, by default "-gvn" and "-newgvn", and reports the wall time of the
+# run and the number of instructions and loads left in the output. This gives
+# a quick overview of the compile time and the code quality of both passes,
+# e.g., to choose a value for -newgvn-function-size-threshold.
+#
+# Example usage:
+#    > ./compare_gvn.py --opt=bin/opt --runs=3 big1.bc big2.bc
+#    file         pipeline  time(s)  insts  loads
+#    big1.bc      -gvn        12.40  81234  10321
+#    big1.bc      -newgvn      3.10  81410  10876
+#    ...
+#
+from __future__ import print_function
+
+import argparse
+import re
+import subprocess
+import sys
+import time
+
+INST_RE = re.compile(r'^\s+(%\S+ = )?[a-z]')
+LOAD_RE = re.compile(r'^\s+%\S+ = load ')
+
+
+def count(ir):
+    insts = 0
+    loads = 0
+    for line in ir.splitlines():
+        if INST_RE.match(line):
+            insts += 1
+            if LOAD_RE.match(line):
+                loads += 1
+    return insts, loads
+
+
+def run(opt, pipeline, path, runs):
+    best = None
+    out = None
+    for _ in range(runs):
+        start = time.time()
+        out = subprocess.check_output([opt, '-S'] + pipeline.split() + [path])
+        elapsed = time.time() - start
+        best = elapsed if best is None else min(best, elapsed)
+    return best, count(out.decode('utf-8', 'replace'))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('--opt', default='opt', help='path to opt')
+    parser.add_argument('--runs', type=int, default=1,
+                        help='runs per file and pipeline, the best is shown')
+    parser.add_argument('--pipeline', action='append',
+                        help='pass pipeline to compare (may be repeated)')
+    parser.add_argument('files', nargs='+', help='IR files to compile')
+    args = parser.parse_args()
+
+    pipelines = args.pipeline or ['-gvn', '-newgvn']
+    width = max(len(f) for f in args.files)
+    pwidth = max(len(p) for p in pipelines)
+    print('%-*s  %-*s  %8s  %8s  %8s' %
+          (width, 'file', pwidth, 'pipeline', 'time(s)', 'insts', 'loads'))
+    for path in args.files:
+        for pipeline in pipelines:
+            try:
+                elapsed, (insts, loads) = run(args.opt, pipeline, path,
+                                              args.runs)
+            except subprocess.CalledProcessError as e:
+                print('%s: %s failed with exit code %d' %
+                      (path, pipeline, e.returncode), file=sys.stderr)
+                continue
+            print('%-*s  %-*s  %8.2f  %8d  %8d' %
+                  (width, path, pwidth, pipeline, elapsed, insts, loads))
+
+
+if __name__ == '__main__':
+    main()
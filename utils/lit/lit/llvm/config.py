@@ -80,6 +80,8 @@ class LLVMConfig(object):
 
         have_zlib = getattr(config, 'have_zlib', None)
         features.add(binary_feature(have_zlib, 'zlib', 'no'))
+        have_zstd = getattr(config, 'have_zstd', None)
+        features.add(binary_feature(have_zstd, 'zstd', 'no'))
 
         # Check if we should run long running tests.
         long_tests = lit_config.params.get('run_long_tests', None)